@@ -14,6 +14,7 @@
 #include <queue>
 #include <set>
 #include <atomic>
+#include <thread>
 
 #include <glog/logging.h>
 #include <boost/bind.hpp>
@@ -102,6 +103,22 @@ DEFINE_bool(
     stop_on_empty_read, true,
     "Stop reading if we get an empty set of rows on a read operation");
 
+DEFINE_double(
+    target_write_ops_per_sec, 0,
+    "If positive, the writers run open-loop: writes are started at this total rate whatever their "
+    "latency, and their latencies include the time they wait to start, like the latencies seen by "
+    "clients sending requests at a fixed rate. 0 means closed-loop writers.");
+
+DEFINE_double(
+    target_read_ops_per_sec, 0,
+    "If positive, the readers run open-loop at this total rate, see target_write_ops_per_sec. "
+    "0 means closed-loop readers.");
+
+DEFINE_bool(
+    mixed_cql_redis, false,
+    "Run the CQL and the Redis load at the same time, against the table of the masters and the "
+    "redis proxy servers both specified.");
+
 using strings::Substitute;
 using std::atomic_long;
 using std::atomic_bool;
@@ -143,7 +160,8 @@ using yb::load_generator::FormatHexForLoadTestKey;
 
 // ------------------------------------------------------------------------------------------------
 
-void CreateTable(const YBTableName &table_name, const shared_ptr<YBClient> &client);
+void CreateTable(
+    const YBTableName &table_name, const shared_ptr<YBClient> &client, bool redis_table);
 void CreateRedisTable(const YBTableName &table_name, const shared_ptr<YBClient> &client);
 void CreateYBTable(const YBTableName &table_name, const shared_ptr<YBClient> &client);
 
@@ -151,7 +169,10 @@ void LaunchYBLoadTest(SessionFactory *session_factory);
 
 shared_ptr<YBClient> CreateYBClient();
 
-void SetupYBTable(const shared_ptr<YBClient> &client);
+void SetupYBTable(const shared_ptr<YBClient> &client, bool redis_table);
+
+void LaunchMixedYBLoadTest(SessionFactory *cql_session_factory,
+                           SessionFactory *redis_session_factory);
 
 bool DropTableIfNecessary(const shared_ptr<YBClient> &client, const YBTableName &table_name);
 
@@ -177,14 +198,32 @@ int main(int argc, char *argv[]) {
   bool use_redis_table =
       !FLAGS_target_redis_server_addresses.empty() || FLAGS_create_redis_table_and_exit;
 
+  if (FLAGS_mixed_cql_redis &&
+      (FLAGS_target_redis_server_addresses.empty() || FLAGS_reads_only || FLAGS_noop_only ||
+       FLAGS_create_redis_table_and_exit)) {
+    LOG(FATAL) << "Mixed CQL and Redis load needs target_redis_server_addresses, and cannot be "
+               << "combined with reads only, noop only or create redis table and exit.";
+  }
+
   if (!FLAGS_reads_only)
     LOG(INFO) << "num_keys = " << FLAGS_num_rows;
 
   for (int i = 0; i < FLAGS_num_iter; ++i) {
-    if (!use_redis_table) {
+    if (FLAGS_mixed_cql_redis) {
       const YBTableName table_name("my_keyspace", FLAGS_table_name);
       shared_ptr<YBClient> client = CreateYBClient();
-      SetupYBTable(client);
+      SetupYBTable(client, false /* redis_table */);
+      SetupYBTable(client, true /* redis_table */);
+
+      yb::client::TableHandle table;
+      CHECK_OK(table.Open(table_name, client.get()));
+      YBSessionFactory cql_session_factory(client.get(), &table);
+      RedisSessionFactory redis_session_factory(FLAGS_target_redis_server_addresses);
+      LaunchMixedYBLoadTest(&cql_session_factory, &redis_session_factory);
+    } else if (!use_redis_table) {
+      const YBTableName table_name("my_keyspace", FLAGS_table_name);
+      shared_ptr<YBClient> client = CreateYBClient();
+      SetupYBTable(client, false /* redis_table */);
 
       yb::client::TableHandle table;
       CHECK_OK(table.Open(table_name, client.get()));
@@ -201,7 +240,7 @@ int main(int argc, char *argv[]) {
         LaunchYBLoadTest(&session_factory);
       }
     } else {
-      SetupYBTable(CreateYBClient());
+      SetupYBTable(CreateYBClient(), true /* redis_table */);
       if (FLAGS_create_redis_table_and_exit) {
         LOG(INFO) << "Done creating redis table";
         return 0;
@@ -239,19 +278,20 @@ shared_ptr<YBClient> CreateYBClient() {
   return client;
 }
 
-void SetupYBTable(const shared_ptr<YBClient> &client) {
+void SetupYBTable(const shared_ptr<YBClient> &client, bool redis_table) {
   string keyspace = "my_keyspace";
-  if (!FLAGS_target_redis_server_addresses.empty() || FLAGS_create_redis_table_and_exit) {
+  string name = FLAGS_table_name;
+  if (redis_table) {
     LOG(INFO) << "Ignoring FLAGS_table_name. Redis proxy expects table name to be "
               << yb::common::kRedisKeyspaceName << '.' << yb::common::kRedisTableName;
-    FLAGS_table_name = yb::common::kRedisTableName;
+    name = yb::common::kRedisTableName;
     keyspace = yb::common::kRedisKeyspaceName;
   }
-  const YBTableName table_name(keyspace, FLAGS_table_name);
+  const YBTableName table_name(keyspace, name);
   CHECK_OK(client->CreateNamespaceIfNotExists(table_name.namespace_name()));
 
   if (!YBTableExistsAlready(client, table_name) || DropTableIfNecessary(client, table_name)) {
-    CreateTable(table_name, client);
+    CreateTable(table_name, client, redis_table);
   }
 }
 
@@ -269,8 +309,9 @@ vector<const YBPartialRow *> GetSplitsForTable(const YBSchema *schema) {
   return splits;
 }
 
-void CreateTable(const YBTableName &table_name, const shared_ptr<YBClient> &client) {
-  if (!FLAGS_target_redis_server_addresses.empty() || FLAGS_create_redis_table_and_exit) {
+void CreateTable(
+    const YBTableName &table_name, const shared_ptr<YBClient> &client, bool redis_table) {
+  if (redis_table) {
     CreateRedisTable(table_name, client);
   } else {
     CreateYBTable(table_name, client);
@@ -361,6 +402,7 @@ void LaunchYBLoadTest(SessionFactory *session_factory) {
         FLAGS_num_rows, 0, FLAGS_num_writer_threads, session_factory, &stop_flag,
         FLAGS_value_size_bytes, FLAGS_max_num_write_errors);
 
+    writer.set_target_ops_per_sec(FLAGS_target_write_ops_per_sec);
     writer.Start();
     writer.WaitForCompletion();
   } else {
@@ -368,12 +410,14 @@ void LaunchYBLoadTest(SessionFactory *session_factory) {
         FLAGS_num_rows, 0, FLAGS_num_writer_threads, session_factory, &stop_flag,
         FLAGS_value_size_bytes, FLAGS_max_num_write_errors);
 
+    writer.set_target_ops_per_sec(FLAGS_target_write_ops_per_sec);
     writer.Start();
     MultiThreadedReader reader(FLAGS_num_rows, FLAGS_num_reader_threads, session_factory,
                                writer.InsertionPoint(), writer.InsertedKeys(), writer.FailedKeys(),
                                &stop_flag, FLAGS_value_size_bytes, FLAGS_max_num_read_errors,
                                FLAGS_stop_on_empty_read);
 
+    reader.set_target_ops_per_sec(FLAGS_target_read_ops_per_sec);
     reader.Start();
 
     writer.WaitForCompletion();
@@ -383,3 +427,11 @@ void LaunchYBLoadTest(SessionFactory *session_factory) {
     reader.WaitForCompletion();
   }
 }
+
+void LaunchMixedYBLoadTest(SessionFactory *cql_session_factory,
+                           SessionFactory *redis_session_factory) {
+  LOG(INFO) << "Starting mixed CQL and Redis load test";
+  std::thread cql_thread(std::bind(&LaunchYBLoadTest, cql_session_factory));
+  LaunchYBLoadTest(redis_session_factory);
+  cql_thread.join();
+}
@@ -30,20 +30,24 @@
 // these metrics are used not only in Redis service.
 METRIC_DEFINE_histogram(
     server, handler_latency_yb_client_write_remote, "yb.client.Write remote call time",
-    yb::MetricUnit::kMicroseconds, "Microseconds spent in the remote Write call ", 60000000LU, 2);
+    yb::MetricUnit::kMicroseconds, "Microseconds spent in the remote Write call ", 60000000LU, 2,
+    yb::STRIPED);
 METRIC_DEFINE_histogram(
     server, handler_latency_yb_client_read_remote, "yb.client.Read remote call time",
-    yb::MetricUnit::kMicroseconds, "Microseconds spent in the remote Read call ", 60000000LU, 2);
+    yb::MetricUnit::kMicroseconds, "Microseconds spent in the remote Read call ", 60000000LU, 2,
+    yb::STRIPED);
 METRIC_DEFINE_histogram(
     server, handler_latency_yb_client_write_local, "yb.client.Write local call time",
-    yb::MetricUnit::kMicroseconds, "Microseconds spent in the local Write call ", 60000000LU, 2);
+    yb::MetricUnit::kMicroseconds, "Microseconds spent in the local Write call ", 60000000LU, 2,
+    yb::STRIPED);
 METRIC_DEFINE_histogram(
     server, handler_latency_yb_client_read_local, "yb.client.Read local call time",
-    yb::MetricUnit::kMicroseconds, "Microseconds spent in the local Read call ", 60000000LU, 2);
+    yb::MetricUnit::kMicroseconds, "Microseconds spent in the local Read call ", 60000000LU, 2,
+    yb::STRIPED);
 METRIC_DEFINE_histogram(
     server, handler_latency_yb_client_time_to_send,
     "Time taken for a Write/Read rpc to be sent to the server", yb::MetricUnit::kMicroseconds,
-    "Microseconds spent before sending the request to the server", 60000000LU, 2);
+    "Microseconds spent before sending the request to the server", 60000000LU, 2, yb::STRIPED);
 DECLARE_bool(rpc_dump_all_traces);
 DECLARE_bool(collect_end_to_end_traces);
 
@@ -96,6 +100,9 @@ AsyncRpc::AsyncRpc(
   if (Trace::CurrentTrace()) {
     Trace::CurrentTrace()->AddChildTrace(trace_.get());
   }
+  // The batch may be flushed from a thread other than the one that added the operations, so the
+  // trace id is taken from the operations themselves.
+  trace_->set_trace_id(ops_.front()->trace_id);
 }
 
 AsyncRpc::~AsyncRpc() {
@@ -177,12 +184,19 @@ bool AsyncRpc::IsLocalCall() const {
 
 namespace {
 
-void SetTransactionMetadata(const TransactionMetadata& metadata, tserver::WriteRequestPB* req) {
-  metadata.ToPB(req->mutable_write_batch()->mutable_transaction());
+void SetTransactionMetadata(const TransactionPrepareData& data, tserver::WriteRequestPB* req) {
+  auto& write_batch = *req->mutable_write_batch();
+  data.metadata.ToPB(write_batch.mutable_transaction());
+  if (data.single_shard) {
+    write_batch.set_single_shard_transaction(true);
+  }
+  if (data.parallel_commit) {
+    write_batch.set_parallel_commit(true);
+  }
 }
 
-void SetTransactionMetadata(const TransactionMetadata& metadata, tserver::ReadRequestPB* req) {
-  metadata.ToPB(req->mutable_transaction());
+void SetTransactionMetadata(const TransactionPrepareData& data, tserver::ReadRequestPB* req) {
+  data.metadata.ToPB(req->mutable_transaction());
 }
 
 } // namespace
@@ -215,7 +229,7 @@ AsyncRpcBase<Req, Resp>::AsyncRpcBase(const scoped_refptr<Batcher>& batcher,
     read_time.AddToPB(&req_);
   }
   if (!transaction_data.metadata.transaction_id.is_nil()) {
-    SetTransactionMetadata(transaction_data.metadata, &req_);
+    SetTransactionMetadata(transaction_data, &req_);
   }
 }
 
@@ -327,6 +341,9 @@ WriteRpc::~WriteRpc() {
                                               async_rpc_metrics_->remote_write_rpc_time;
     write_rpc_time->Increment(end_time.GetDeltaSince(start_).ToMicroseconds());
   }
+  if (PREDICT_FALSE(trace_->sampled())) {
+    RecordTraceStage("client.write_rpc", end_time - start_);
+  }
 }
 
 void WriteRpc::CallRemoteMethod() {
@@ -418,6 +435,14 @@ ReadRpc::ReadRpc(
   TRACE_TO(trace_, "ReadRpc initiated to $0", tablet->tablet_id());
   req_.set_consistency_level(yb_consistency_level);
 
+  // The ops of a batch could come with different staleness bounds, the strictest one applies.
+  auto add_max_staleness_ms = [this, yb_consistency_level](uint64_t max_staleness_ms) {
+    if (yb_consistency_level == YBConsistencyLevel::CONSISTENT_PREFIX && max_staleness_ms != 0 &&
+        (!req_.has_max_staleness_ms() || max_staleness_ms < req_.max_staleness_ms())) {
+      req_.set_max_staleness_ms(max_staleness_ms);
+    }
+  };
+
   int ctr = 0;
   for (auto& op : ops_) {
     switch (op->yb_op->type()) {
@@ -427,6 +452,7 @@ ReadRpc::ReadRpc(
         // in ProcessResponseFromTserver.
         auto* redis_op = down_cast<YBRedisReadOp*>(op->yb_op.get());
         req_.add_redis_batch()->Swap(redis_op->mutable_request());
+        add_max_staleness_ms(redis_op->max_staleness_ms());
         break;
       }
       case YBOperation::Type::QL_READ: {
@@ -438,6 +464,7 @@ ReadRpc::ReadRpc(
         if (ql_op->read_time()) {
           ql_op->read_time().AddToPB(&req_);
         }
+        add_max_staleness_ms(ql_op->max_staleness_ms());
         break;
       }
       case YBOperation::Type::REDIS_WRITE: FALLTHROUGH_INTENDED;
@@ -452,6 +479,14 @@ ReadRpc::ReadRpc(
     VLOG(4) << ++ctr << ". Encoded row " << op->yb_op->ToString();
   }
 
+  // Only a replica that has the previous writes of the session may serve the read.
+  if (yb_consistency_level == YBConsistencyLevel::CONSISTENT_PREFIX) {
+    const uint64_t read_after_hybrid_time = batcher->read_after_hybrid_time();
+    if (read_after_hybrid_time != YBClient::kNoHybridTime) {
+      req_.set_read_after_hybrid_time(read_after_hybrid_time);
+    }
+  }
+
   if (VLOG_IS_ON(3)) {
     VLOG(3) << "Created batch for " << tablet->tablet_id() << ":\n" << req_.ShortDebugString();
   }
@@ -465,6 +500,9 @@ ReadRpc::~ReadRpc() {
                                              async_rpc_metrics_->remote_read_rpc_time;
     read_rpc_time->Increment(end_time.GetDeltaSince(start_).ToMicroseconds());
   }
+  if (PREDICT_FALSE(trace_->sampled())) {
+    RecordTraceStage("client.read_rpc", end_time - start_);
+  }
 }
 
 void ReadRpc::CallRemoteMethod() {
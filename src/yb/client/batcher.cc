@@ -60,6 +60,7 @@
 
 #include "yb/util/debug-util.h"
 #include "yb/util/logging.h"
+#include "yb/util/trace.h"
 
 using std::pair;
 using std::set;
@@ -230,10 +231,14 @@ void Batcher::FlushAsync(YBStatusCallback* cb) {
 Status Batcher::Add(shared_ptr<YBOperation> yb_op) {
   // As soon as we get the op, start looking up where it belongs,
   // so that when the user calls Flush, we are ready to go.
-  auto in_flight_op = std::make_shared<InFlightOp>();
+  auto in_flight_op = MakeInFlightOp();
   RETURN_NOT_OK(yb_op->GetPartitionKey(&in_flight_op->partition_key));
   in_flight_op->yb_op = yb_op;
   in_flight_op->state = InFlightOpState::kLookingUpTablet;
+  in_flight_op->trace_id = Trace::CurrentTraceId();
+  if (in_flight_op->trace_id) {
+    in_flight_op->lookup_start = MonoTime::Now();
+  }
 
   if (yb_op->type() == YBOperation::Type::QL_READ) {
     if (!in_flight_op->partition_key.empty()) {
@@ -303,6 +308,10 @@ void Batcher::TabletLookupFinished(InFlightOpPtr op, const Status& s) {
   // Acquire the batcher lock early to atomically:
   // 1. Test if the batcher was aborted, and
   // 2. Change the op state.
+  if (PREDICT_FALSE(op->trace_id)) {
+    RecordTraceStage("client.tablet_lookup", MonoTime::Now() - op->lookup_start);
+  }
+
   std::unique_lock<simple_spinlock> l(lock_);
   --outstanding_lookups_;
 
@@ -366,6 +375,11 @@ OpGroup GetOpGroup(const InFlightOpPtr& op) {
           YBConsistencyLevel::CONSISTENT_PREFIX) {
     return OpGroup::kConsistentPrefixRead;
   }
+  if (op->yb_op->type() == YBOperation::Type::REDIS_READ &&
+      std::static_pointer_cast<YBRedisReadOp>(op->yb_op)->yb_consistency_level() ==
+          YBConsistencyLevel::CONSISTENT_PREFIX) {
+    return OpGroup::kConsistentPrefixRead;
+  }
 
   return OpGroup::kLeaderRead;
 }
@@ -450,6 +464,11 @@ YBTransactionPtr Batcher::transaction() const {
   return transaction_;
 }
 
+uint64_t Batcher::read_after_hybrid_time() const {
+  auto session_data = weak_session_data_.lock();
+  return session_data ? session_data->read_after_hybrid_time() : YBClient::kNoHybridTime;
+}
+
 void Batcher::FlushBuffer(RemoteTablet* tablet,
                           InFlightOps::const_iterator begin,
                           InFlightOps::const_iterator end) {
@@ -536,6 +555,12 @@ void Batcher::ProcessWriteResponse(const WriteRpc &rpc, const Status &s) {
 
   if (s.ok() && rpc.resp().has_propagated_hybrid_time()) {
     client_->data_->UpdateLatestObservedHybridTime(rpc.resp().propagated_hybrid_time());
+    // The propagated hybrid time is taken after the write, so a replica that caught up to it has
+    // the write.
+    auto session_data = weak_session_data_.lock();
+    if (session_data) {
+      session_data->UpdateReadAfterHybridTime(rpc.resp().propagated_hybrid_time());
+    }
   }
 
   // Check individual row errors.
@@ -137,6 +137,9 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
 
   YBTransactionPtr transaction() const;
 
+  // The read after hybrid time of the session, see YBSession::GetReadAfterHybridTime.
+  uint64_t read_after_hybrid_time() const;
+
   const TransactionPrepareData& transaction_prepare_data() const {
     return transaction_prepare_data_;
   }
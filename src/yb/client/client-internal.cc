@@ -830,13 +830,16 @@ namespace internal {
 // method as to enable code sharing.
 class GetTableSchemaRpc : public Rpc {
  public:
+  // out_name and out_indexes may be null.
   GetTableSchemaRpc(YBClient* client,
                     StatusCallback user_cb,
-                    YBTableName table_name,
+                    master::TableIdentifierPB table_identifier,
                     YBSchema* out_schema,
                     PartitionSchema* out_partition_schema,
                     string* out_id,
                     string* out_indexed_table_id,
+                    YBTableName* out_name,
+                    std::vector<YBIndexInfo>* out_indexes,
                     const MonoTime& deadline,
                     const shared_ptr<rpc::Messenger>& messenger);
 
@@ -855,31 +858,37 @@ class GetTableSchemaRpc : public Rpc {
 
   YBClient* client_;
   StatusCallback user_cb_;
-  const YBTableName table_name_;
+  const master::TableIdentifierPB table_identifier_;
   YBSchema* out_schema_;
   PartitionSchema* out_partition_schema_;
   string* out_id_;
   string* out_indexed_table_id_;
+  YBTableName* out_name_;
+  std::vector<YBIndexInfo>* out_indexes_;
   GetTableSchemaResponsePB resp_;
 };
 
 GetTableSchemaRpc::GetTableSchemaRpc(YBClient* client,
                                      StatusCallback user_cb,
-                                     YBTableName table_name,
+                                     master::TableIdentifierPB table_identifier,
                                      YBSchema* out_schema,
                                      PartitionSchema* out_partition_schema,
                                      string* out_id,
                                      string* out_indexed_table_id,
+                                     YBTableName* out_name,
+                                     std::vector<YBIndexInfo>* out_indexes,
                                      const MonoTime& deadline,
                                      const shared_ptr<rpc::Messenger>& messenger)
     : Rpc(deadline, messenger),
       client_(DCHECK_NOTNULL(client)),
       user_cb_(std::move(user_cb)),
-      table_name_(std::move(table_name)),
+      table_identifier_(std::move(table_identifier)),
       out_schema_(DCHECK_NOTNULL(out_schema)),
       out_partition_schema_(DCHECK_NOTNULL(out_partition_schema)),
       out_id_(DCHECK_NOTNULL(out_id)),
-      out_indexed_table_id_(DCHECK_NOTNULL(out_indexed_table_id)) {
+      out_indexed_table_id_(DCHECK_NOTNULL(out_indexed_table_id)),
+      out_name_(out_name),
+      out_indexes_(out_indexes) {
 }
 
 GetTableSchemaRpc::~GetTableSchemaRpc() {
@@ -899,15 +908,15 @@ void GetTableSchemaRpc::SendRpc() {
       MonoTime::Earliest(rpc_deadline, retrier().deadline()));
 
   GetTableSchemaRequestPB req;
-  table_name_.SetIntoTableIdentifierPB(req.mutable_table());
+  req.mutable_table()->CopyFrom(table_identifier_);
   client_->data_->master_proxy()->GetTableSchemaAsync(
       req, &resp_, mutable_retrier()->mutable_controller(),
       std::bind(&GetTableSchemaRpc::SendRpcCb, this, Status::OK()));
 }
 
 string GetTableSchemaRpc::ToString() const {
-  return Substitute("GetTableSchemaRpc(table_name: $0, num_attempts: $1)",
-                    table_name_.ToString(), num_attempts());
+  return Substitute("GetTableSchemaRpc(table: $0, num_attempts: $1)",
+                    table_identifier_.ShortDebugString(), num_attempts());
 }
 
 void GetTableSchemaRpc::ResetLeaderMasterAndRetry() {
@@ -998,6 +1007,24 @@ void GetTableSchemaRpc::SendRpcCb(const Status& status) {
       if (resp_.has_indexed_table_id()) {
         *out_indexed_table_id_ = resp_.indexed_table_id();
       }
+      if (out_name_ != nullptr) {
+        out_name_->GetFromTableIdentifierPB(resp_.identifier());
+      }
+      if (out_indexes_ != nullptr) {
+        out_indexes_->clear();
+        for (const auto& index_pb : resp_.indexes()) {
+          out_indexes_->emplace_back();
+          YBIndexInfo& index = out_indexes_->back();
+          index.table_id = index_pb.table_id();
+          index.hash_column_ids.assign(index_pb.hash_column_ids().begin(),
+                                       index_pb.hash_column_ids().end());
+          index.range_column_ids.assign(index_pb.range_column_ids().begin(),
+                                        index_pb.range_column_ids().end());
+          index.covering_column_ids.assign(index_pb.covering_column_ids().begin(),
+                                           index_pb.covering_column_ids().end());
+          index.is_readable = index_pb.is_readable();
+        }
+      }
       CHECK_GT(out_id_->size(), 0) << "Running against a too-old master";
     }
   }
@@ -1015,16 +1042,48 @@ Status YBClient::Data::GetTableSchema(YBClient* client,
                                       YBSchema* schema,
                                       PartitionSchema* partition_schema,
                                       string* table_id,
-                                      string* indexed_table_id) {
+                                      string* indexed_table_id,
+                                      std::vector<YBIndexInfo>* indexes) {
+  master::TableIdentifierPB table_identifier;
+  table_name.SetIntoTableIdentifierPB(&table_identifier);
   Synchronizer sync;
   auto rpc = rpc::StartRpc<GetTableSchemaRpc>(
       client,
       sync.AsStatusCallback(),
-      table_name,
+      std::move(table_identifier),
       schema,
       partition_schema,
       table_id,
       indexed_table_id,
+      nullptr /* out_name */,
+      indexes,
+      deadline,
+      messenger_);
+  return sync.Wait();
+}
+
+Status YBClient::Data::GetTableSchemaById(YBClient* client,
+                                          const TableId& table_id,
+                                          const MonoTime& deadline,
+                                          YBSchema* schema,
+                                          PartitionSchema* partition_schema,
+                                          YBTableName* table_name,
+                                          string* indexed_table_id,
+                                          std::vector<YBIndexInfo>* indexes) {
+  master::TableIdentifierPB table_identifier;
+  table_identifier.set_table_id(table_id);
+  string table_id_ignored;
+  Synchronizer sync;
+  auto rpc = rpc::StartRpc<GetTableSchemaRpc>(
+      client,
+      sync.AsStatusCallback(),
+      std::move(table_identifier),
+      schema,
+      partition_schema,
+      &table_id_ignored,
+      indexed_table_id,
+      table_name,
+      indexes,
       deadline,
       messenger_);
   return sync.Wait();
@@ -145,7 +145,18 @@ class YBClient::Data {
                                 YBSchema* schema,
                                 PartitionSchema* partition_schema,
                                 std::string* table_id,
-                                std::string* indexed_table_id);
+                                std::string* indexed_table_id,
+                                std::vector<YBIndexInfo>* indexes = nullptr);
+
+  // Same as above, looking the table up by its id. Also finds index tables.
+  CHECKED_STATUS GetTableSchemaById(YBClient* client,
+                                    const TableId& table_id,
+                                    const MonoTime& deadline,
+                                    YBSchema* schema,
+                                    PartitionSchema* partition_schema,
+                                    YBTableName* table_name,
+                                    std::string* indexed_table_id,
+                                    std::vector<YBIndexInfo>* indexes);
 
   CHECKED_STATUS InitLocalHostNames();
 
@@ -44,6 +44,7 @@
 #include "yb/client/client-internal.h"
 #include "yb/client/client-test-util.h"
 #include "yb/client/meta_cache.h"
+#include "yb/client/meta_data_cache.h"
 #include "yb/client/row_result.h"
 #include "yb/client/scanner-internal.h"
 #include "yb/client/table_handle.h"
@@ -81,11 +82,16 @@
 #include "yb/util/tostring.h"
 
 DECLARE_bool(enable_data_block_fsync);
+DECLARE_int32(client_background_flush_linger_usec);
+DECLARE_int32(client_background_flush_max_ops);
+DECLARE_int32(client_prefetch_table_locations_batch_size);
 DECLARE_bool(log_inject_latency);
 DECLARE_int32(heartbeat_interval_ms);
 DECLARE_int32(log_inject_latency_ms_mean);
 DECLARE_int32(log_inject_latency_ms_stddev);
 DECLARE_int32(master_inject_latency_on_tablet_lookups_ms);
+DECLARE_int32(metadata_cache_negative_ttl_ms);
+DECLARE_int32(metadata_cache_refresh_interval_ms);
 DECLARE_int32(max_create_tablets_per_ts);
 DECLARE_int32(scanner_gc_check_interval_us);
 DECLARE_int32(scanner_inject_latency_on_each_batch_ms);
@@ -501,6 +507,49 @@ TEST_F(ClientTest, TestBadTable) {
   ASSERT_STR_CONTAINS(s.ToString(false), "Not found: The table does not exist");
 }
 
+TEST_F(ClientTest, TestMetaDataCacheNegativeEntries) {
+  FLAGS_metadata_cache_negative_ttl_ms = 60000;
+  YBMetaDataCache cache(client_);
+  const YBTableName missing(kKeyspaceName, "xxx-does-not-exist");
+  shared_ptr<YBTable> table;
+  bool cache_used = true;
+  ASSERT_TRUE(cache.GetTable(missing, &table, &cache_used).IsNotFound());
+  ASSERT_FALSE(cache_used);
+
+  // The second lookup is answered from the cache.
+  ASSERT_TRUE(cache.GetTable(missing, &table, &cache_used).IsNotFound());
+  ASSERT_TRUE(cache_used);
+
+  // Removing the entry, as is done once the table is created, forces a new lookup.
+  cache.RemoveCachedTable(missing);
+  ASSERT_TRUE(cache.GetTable(missing, &table, &cache_used).IsNotFound());
+  ASSERT_FALSE(cache_used);
+
+  ASSERT_OK(cache.GetTable(kTableName, &table, &cache_used));
+  ASSERT_FALSE(cache_used);
+  ASSERT_OK(cache.GetTable(kTableName, &table, &cache_used));
+  ASSERT_TRUE(cache_used);
+}
+
+TEST_F(ClientTest, TestMetaDataCacheBackgroundRefresh) {
+  FLAGS_metadata_cache_refresh_interval_ms = 100;
+  YBMetaDataCache cache(client_);
+  shared_ptr<YBTable> table;
+  bool cache_used = false;
+  ASSERT_OK(cache.GetTable(kTableName, &table, &cache_used));
+  const auto old_version = table->schema().version();
+
+  gscoped_ptr<YBTableAlterer> table_alterer(client_->NewTableAlterer(kTableName));
+  ASSERT_OK(table_alterer->DropColumn("int_val")->Alter());
+
+  // Lookups keep using the cached table until the background refresh swaps in the new schema.
+  ASSERT_OK(WaitFor([&]() -> bool {
+    EXPECT_OK(cache.GetTable(kTableName, &table, &cache_used));
+    EXPECT_TRUE(cache_used);
+    return table->schema().version() != old_version;
+  }, MonoDelta::FromSeconds(30), "Wait for cached table refresh"));
+}
+
 // Test that, if the master is down, we experience a network error talking
 // to it (no "find the new leader master" since there's only one master).
 TEST_F(ClientTest, TestMasterDown) {
@@ -2146,6 +2195,54 @@ TEST_F(ClientTest, TestMasterLookupPermits) {
             client_->data_->meta_cache_->master_lookup_sem_.GetValue());
 }
 
+TEST_F(ClientTest, TestPrefetchTableLocations) {
+  google::FlagSaver saver;
+  FLAGS_client_prefetch_table_locations_batch_size = 1;
+  constexpr int kPrefetchTablets = 5;
+  TableHandle table;
+  ASSERT_NO_FATALS(CreateTable(YBTableName("prefetch"), 1, kPrefetchTablets, &table));
+
+  auto& meta_cache = *client_->data_->meta_cache_;
+  Synchronizer sync;
+  meta_cache.PrefetchTableLocations(table->id(), MonoTime::Max(), sync.AsStatusCallback());
+  ASSERT_OK(sync.Wait());
+
+  // Locations are fetched one by one, so each batch should continue from the end of previous one.
+  std::string partition_key;
+  for (int i = 0; i != kPrefetchTablets; ++i) {
+    auto tablet = meta_cache.LookupTabletByKeyFastPath(table.get(), partition_key);
+    ASSERT_TRUE(tablet != nullptr) << "Tablet " << i << " was not prefetched";
+    partition_key = tablet->partition().partition_key_end();
+  }
+  ASSERT_TRUE(partition_key.empty());
+}
+
+TEST_F(ClientTest, TestAutoFlushBackground) {
+  google::FlagSaver saver;
+  FLAGS_client_background_flush_max_ops = 7;
+  constexpr int kNumRows = 100;
+  auto session = client_->NewSession();
+  ASSERT_OK(session->SetFlushMode(YBSession::AUTO_FLUSH_BACKGROUND));
+  session->SetTimeout(10s);
+
+  // Rows are flushed in batches of max ops, while the rest should be flushed by Flush.
+  for (int i = 0; i != kNumRows; ++i) {
+    ASSERT_OK(session->Apply(BuildTestRow(client_table_, i)));
+  }
+  ASSERT_OK(session->Flush());
+  ASSERT_EQ(0, session->CountPendingErrors());
+  ASSERT_FALSE(session->HasPendingOperations());
+  ASSERT_EQ(kNumRows, CountRowsFromClient(client_table_));
+
+  // Row that does not reach any threshold is flushed after linger time passes.
+  FLAGS_client_background_flush_linger_usec = 10000;
+  ASSERT_OK(session->Apply(BuildTestRow(client_table_, kNumRows)));
+  ASSERT_OK(WaitFor([session] { return !session->HasPendingOperations(); },
+                    10s, "Linger flush"));
+  ASSERT_EQ(kNumRows + 1, CountRowsFromClient(client_table_));
+  ASSERT_OK(session->Flush());
+}
+
 // Define callback for deadlock simulation, as well as various helper methods.
 namespace {
 class DLSCallback : public YBStatusCallback {
@@ -2549,5 +2646,35 @@ TEST_F(ClientTest, TestReadFromFollower) {
   }
 }
 
+TEST_F(ClientTest, TestReadAfterHybridTime) {
+  const YBTableName kReadAfterHybridTimeTable("TestReadAfterHybridTime");
+  TableHandle table;
+  ASSERT_NO_FATALS(CreateTable(kReadAfterHybridTimeTable, 3, 1, &table));
+
+  // The writes of a session advance its read after hybrid time.
+  auto write_session = CreateSession();
+  ASSERT_EQ(YBClient::kNoHybridTime, write_session->GetReadAfterHybridTime());
+  ASSERT_OK(write_session->Apply(BuildTestRow(table, 1)));
+  FlushSessionOrDie(write_session);
+  const uint64_t read_after_hybrid_time = write_session->GetReadAfterHybridTime();
+  ASSERT_NE(YBClient::kNoHybridTime, read_after_hybrid_time);
+
+  // Another session given the token reads the row at CONSISTENT_PREFIX right away, whichever
+  // replica ends up serving the read.
+  auto read_session = CreateSession();
+  read_session->SetReadAfterHybridTime(read_after_hybrid_time);
+  auto op = table.NewReadOp();
+  op->set_yb_consistency_level(YBConsistencyLevel::CONSISTENT_PREFIX);
+  QLAddInt32HashValue(op->mutable_request(), 1);
+  table.AddColumns({"key", "int_val"}, op->mutable_request());
+  ASSERT_OK(read_session->Apply(op));
+  ASSERT_OK(read_session->Flush());
+  ASSERT_EQ(QLResponsePB::YQL_STATUS_OK, op->response().status());
+  auto rowblock = ql::RowsResult(op.get()).GetRowBlock();
+  ASSERT_EQ(1, rowblock->row_count());
+  ASSERT_EQ(2, rowblock->row(0).column(1).int32_value());
+  ASSERT_EQ(read_after_hybrid_time, read_session->GetReadAfterHybridTime());
+}
+
 }  // namespace client
 }  // namespace yb
@@ -33,12 +33,15 @@
 
 #include <functional>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <gtest/gtest.h>
 
 #include "yb/client/client.h"
 #include "yb/client/client-internal.h"
+#include "yb/client/completion_queue.h"
+#include "yb/util/test_macros.h"
 
 namespace yb {
 namespace client {
@@ -180,6 +183,48 @@ Status TestFunc(const MonoTime& deadline, bool* retry, int* counter) {
 }
 } // anonymous namespace
 
+TEST(ClientUnitTest, TestCompletionQueue) {
+  YBCompletionQueue queue;
+  std::vector<YBCompletionQueue::Completion> completions;
+  ASSERT_EQ(0, queue.Poll(&completions, 10, MonoDelta::FromMilliseconds(1)));
+
+  YBStatusCallback* first = queue.StartFlush(1);
+  YBStatusCallback* second = queue.StartFlush(2);
+  YBStatusCallback* third = queue.StartFlush(3);
+  ASSERT_EQ(3, queue.pending());
+  std::thread([first, second] {
+    second->Run(Status::OK());
+    first->Run(STATUS(TimedOut, "Flush timed out"));
+  }).join();
+
+  ASSERT_EQ(1, queue.Poll(&completions, 1, MonoDelta::FromSeconds(1)));
+  ASSERT_EQ(2, completions[0].tag);
+  ASSERT_OK(completions[0].status);
+
+  // The callbacks of the finished flushes are reused.
+  YBStatusCallback* fourth = queue.StartFlush(4);
+  ASSERT_TRUE(fourth == first || fourth == second);
+
+  std::thread waker([third] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    third->Run(Status::OK());
+  });
+  ASSERT_EQ(1, queue.Poll(&completions, 10, MonoDelta::FromSeconds(10)));
+  ASSERT_EQ(1, completions[1].tag);
+  ASSERT_TRUE(completions[1].status.IsTimedOut());
+  while (completions.size() != 3) {
+    queue.Poll(&completions, 10, MonoDelta::FromSeconds(10));
+  }
+  ASSERT_EQ(3, completions[2].tag);
+  waker.join();
+
+  fourth->Run(Status::OK());
+  ASSERT_EQ(1, queue.pending());
+  ASSERT_EQ(1, queue.Poll(&completions, 10, MonoDelta::FromSeconds(10)));
+  ASSERT_EQ(4, completions[3].tag);
+  ASSERT_EQ(0, queue.pending());
+}
+
 TEST(ClientUnitTest, TestRetryFunc) {
   MonoTime deadline = MonoTime::Now();
   deadline.AddDelta(MonoDelta::FromMilliseconds(100));
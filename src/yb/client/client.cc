@@ -44,6 +44,7 @@
 #include "yb/client/callbacks.h"
 #include "yb/client/client-internal.h"
 #include "yb/client/client_builder-internal.h"
+#include "yb/client/completion_queue.h"
 #include "yb/client/error-internal.h"
 #include "yb/client/error_collector.h"
 #include "yb/client/meta_cache.h"
@@ -704,6 +705,10 @@ const std::shared_ptr<rpc::Messenger>& YBClient::messenger() const {
   return data_->messenger_;
 }
 
+const CloudInfoPB& YBClient::cloud_info() const {
+  return data_->cloud_info_pb_;
+}
+
 void YBClient::LookupTabletByKey(const YBTable* table,
                                  const std::string& partition_key,
                                  const MonoTime& deadline,
@@ -850,67 +855,12 @@ Status YBClient::TableExists(const YBTableName& table_name, bool* exists) {
   return Status::OK();
 }
 
-Status YBMetaDataCache::GetTable(
-    const YBTableName& table_name, shared_ptr<YBTable>* table, bool* cache_used) {
-  {
-    std::lock_guard<std::mutex> lock(cached_tables_mutex_);
-    auto itr = cached_tables_.find(table_name);
-    if (itr != cached_tables_.end()) {
-      *table = itr->second;
-      *cache_used = true;
-      return Status::OK();
-    }
-  }
-
-  RETURN_NOT_OK(client_->OpenTable(table_name, table));
-  {
-    std::lock_guard<std::mutex> lock(cached_tables_mutex_);
-    cached_tables_[table_name] = *table;
-  }
-  *cache_used = false;
-  return Status::OK();
-}
-
-void YBMetaDataCache::RemoveCachedTable(const YBTableName& table_name) {
-  std::lock_guard<std::mutex> lock(cached_tables_mutex_);
-  cached_tables_.erase(table_name);
-}
-
-Status YBMetaDataCache::GetUDType(const string &keyspace_name,
-                                  const string &type_name,
-                                  shared_ptr<QLType> *type,
-                                  bool *cache_used) {
-  auto type_path = std::make_pair(keyspace_name, type_name);
-  {
-    std::lock_guard<std::mutex> lock(cached_types_mutex_);
-    auto itr = cached_types_.find(type_path);
-    if (itr != cached_types_.end()) {
-      *type = itr->second;
-      *cache_used = true;
-      return Status::OK();
-    }
-  }
-
-  RETURN_NOT_OK(client_->GetUDType(keyspace_name, type_name, type));
-  {
-    std::lock_guard<std::mutex> lock(cached_types_mutex_);
-    cached_types_[type_path] = *type;
-  }
-  *cache_used = false;
-  return Status::OK();
-}
-
-void YBMetaDataCache::RemoveCachedUDType(const string& keyspace_name,
-                                         const string& type_name) {
-  std::lock_guard<std::mutex> lock(cached_types_mutex_);
-  cached_types_.erase(std::make_pair(keyspace_name, type_name));
-}
-
 Status YBClient::OpenTable(const YBTableName& table_name, shared_ptr<YBTable>* table) {
   YBSchema schema;
   string table_id;
   string indexed_table_id;
   PartitionSchema partition_schema;
+  std::vector<YBIndexInfo> indexes;
   MonoTime deadline = MonoTime::Now();
   deadline.AddDelta(default_admin_operation_timeout());
   RETURN_NOT_OK(data_->GetTableSchema(this,
@@ -919,7 +869,8 @@ Status YBClient::OpenTable(const YBTableName& table_name, shared_ptr<YBTable>* t
                                       &schema,
                                       &partition_schema,
                                       &table_id,
-                                      &indexed_table_id));
+                                      &indexed_table_id,
+                                      &indexes));
   // Verify it is not an index table.
   if (!indexed_table_id.empty()) {
     return STATUS(NotFound, "The table does not exist");
@@ -931,8 +882,41 @@ Status YBClient::OpenTable(const YBTableName& table_name, shared_ptr<YBTable>* t
                                            table_name,
                                            table_id,
                                            schema,
-                                           partition_schema));
+                                           partition_schema,
+                                           std::move(indexes)));
+  RETURN_NOT_OK(ret->data_->Open());
+  // So the first operations on this table would not look up its tablets one by one.
+  data_->meta_cache_->StartPrefetchingTableLocations(table_id);
+  table->swap(ret);
+  return Status::OK();
+}
+
+Status YBClient::OpenTableById(const TableId& table_id, shared_ptr<YBTable>* table) {
+  YBSchema schema;
+  YBTableName table_name;
+  string indexed_table_id;
+  PartitionSchema partition_schema;
+  std::vector<YBIndexInfo> indexes;
+  MonoTime deadline = MonoTime::Now();
+  deadline.AddDelta(default_admin_operation_timeout());
+  RETURN_NOT_OK(data_->GetTableSchemaById(this,
+                                          table_id,
+                                          deadline,
+                                          &schema,
+                                          &partition_schema,
+                                          &table_name,
+                                          &indexed_table_id,
+                                          &indexes));
+
+  std::shared_ptr<YBTable> ret(new YBTable(shared_from_this(),
+                                           table_name,
+                                           table_id,
+                                           schema,
+                                           partition_schema,
+                                           std::move(indexes),
+                                           indexed_table_id));
   RETURN_NOT_OK(ret->data_->Open());
+  data_->meta_cache_->StartPrefetchingTableLocations(table_id);
   table->swap(ret);
   return Status::OK();
 }
@@ -1192,8 +1176,11 @@ YBTable::YBTable(
     const YBTableName& name,
     const string& table_id,
     const YBSchema& schema,
-    const PartitionSchema& partition_schema)
-  : data_(new YBTable::Data(client, name, table_id, schema, partition_schema)) {
+    const PartitionSchema& partition_schema,
+    std::vector<YBIndexInfo> indexes,
+    const string& indexed_table_id)
+  : data_(new YBTable::Data(client, name, table_id, schema, partition_schema, std::move(indexes),
+                            indexed_table_id)) {
 }
 
 YBTable::~YBTable() {
@@ -1252,6 +1239,14 @@ const PartitionSchema& YBTable::partition_schema() const {
   return data_->partition_schema_;
 }
 
+const std::vector<YBIndexInfo>& YBTable::indexes() const {
+  return data_->indexes_;
+}
+
+const string& YBTable::indexed_table_id() const {
+  return data_->indexed_table_id_;
+}
+
 YBPredicate* YBTable::NewComparisonPredicate(const Slice& col_name,
                                              YBPredicate::ComparisonOp op,
                                              YBValue* value) {
@@ -1334,6 +1329,10 @@ void YBSession::FlushAsync(YBStatusCallback* user_callback) {
   data_->FlushAsync(user_callback);
 }
 
+void YBSession::FlushAsync(YBCompletionQueue* queue, uint64_t tag) {
+  data_->FlushAsync(queue->StartFlush(tag));
+}
+
 bool YBSession::HasPendingOperations() const {
   return data_->HasPendingOperations();
 }
@@ -1351,6 +1350,13 @@ void YBSession::ReadAsync(std::shared_ptr<YBOperation> yb_op, YBStatusCallback*
   FlushAsync(cb);
 }
 
+void YBSession::ReadAsync(
+    std::shared_ptr<YBOperation> yb_op, YBCompletionQueue* queue, uint64_t tag) {
+  CHECK(yb_op->read_only());
+  CHECK_OK(Apply(yb_op));
+  FlushAsync(queue, tag);
+}
+
 Status YBSession::Apply(std::shared_ptr<YBOperation> yb_op) {
   return data_->Apply(std::move(yb_op));
 }
@@ -1371,6 +1377,14 @@ YBClient* YBSession::client() const {
   return data_->client();
 }
 
+uint64_t YBSession::GetReadAfterHybridTime() const {
+  return data_->read_after_hybrid_time();
+}
+
+void YBSession::SetReadAfterHybridTime(uint64_t ht_hybrid_time) {
+  data_->SetReadAfterHybridTime(ht_hybrid_time);
+}
+
 ////////////////////////////////////////////////////////////
 // YBTableAlterer
 ////////////////////////////////////////////////////////////
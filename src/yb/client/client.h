@@ -36,6 +36,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <utility>
 #include <mutex>
@@ -366,6 +367,9 @@ class YBClient : public std::enable_shared_from_this<YBClient> {
   CHECKED_STATUS OpenTable(const YBTableName& table_name,
                            std::shared_ptr<YBTable>* table);
 
+  // Open the table with the given id. Unlike OpenTable, this also opens index tables.
+  CHECKED_STATUS OpenTableById(const TableId& table_id, std::shared_ptr<YBTable>* table);
+
   // Create a new session for interacting with the cluster.
   // User is responsible for destroying the session object.
   // This is a fully local operation (no RPCs or blocking).
@@ -439,6 +443,9 @@ class YBClient : public std::enable_shared_from_this<YBClient> {
 
   const std::shared_ptr<rpc::Messenger>& messenger() const;
 
+  // The placement of the node this client runs on, as set by YBClientBuilder::set_cloud_info_pb.
+  const CloudInfoPB& cloud_info() const;
+
  private:
   class Data;
 
@@ -481,48 +488,6 @@ class YBClient : public std::enable_shared_from_this<YBClient> {
   DISALLOW_COPY_AND_ASSIGN(YBClient);
 };
 
-class YBMetaDataCache {
- public:
-  explicit YBMetaDataCache(std::shared_ptr<YBClient> client) : client_(client) {}
-
-  // Opens the table with the given name. If the table has been opened before, returns the
-  // previously opened table from cached_tables_. If the table has not been opened before
-  // in this client, this will do an RPC to ensure that the table exists and look up its schema.
-  CHECKED_STATUS GetTable(
-      const YBTableName& table_name, std::shared_ptr<YBTable>* table, bool* cache_used);
-
-  // Remove the table from cached_tables_ if it is in the cache.
-  void RemoveCachedTable(const YBTableName& table_name);
-
-  // Opens the type with the given name. If the type has been opened before, returns the
-  // previously opened type from cached_types_. If the type has not been opened before
-  // in this client, this will do an RPC to ensure that the type exists and look up its info.
-  CHECKED_STATUS GetUDType(const string &keyspace_name,
-                           const string &type_name,
-                           std::shared_ptr<QLType> *ql_type,
-                           bool *cache_used);
-
-  // Remove the type from cached_types_ if it is in the cache.
-  void RemoveCachedUDType(const string& keyspace_name, const string& type_name);
-
- private:
-  std::shared_ptr<YBClient> client_;
-
-  // Map from table-name to YBTable instances.
-  typedef std::unordered_map<YBTableName,
-                             std::shared_ptr<YBTable>,
-                             boost::hash<YBTableName>> YBTableMap;
-  YBTableMap cached_tables_;
-  std::mutex cached_tables_mutex_;
-
-  // Map from type-name to QLType instances.
-  typedef std::unordered_map<std::pair<string, string>,
-                             std::shared_ptr<QLType>,
-                             boost::hash<std::pair<string, string>>> YBTypeMap;
-  YBTypeMap cached_types_;
-  std::mutex cached_types_mutex_;
-};
-
 // Creates a new table with the desired options.
 class YBTableCreator {
  public:
@@ -628,6 +593,17 @@ class YBTableCreator {
   DISALLOW_COPY_AND_ASSIGN(YBTableCreator);
 };
 
+// A secondary index of a table. The index table has the columns of the indexed table with the
+// given ids: first the hash columns, then the range columns and then the covered columns.
+struct YBIndexInfo {
+  TableId table_id;
+  std::vector<int32_t> hash_column_ids;
+  std::vector<int32_t> range_column_ids;
+  std::vector<int32_t> covering_column_ids;
+  // Whether the index has been backfilled with the rows that existed when it was created.
+  bool is_readable = true;
+};
+
 // A YBTable represents a table on a particular cluster. It holds the current
 // schema of the table. Any given YBTable instance belongs to a specific YBClient
 // instance.
@@ -684,6 +660,12 @@ class YBTable : public std::enable_shared_from_this<YBTable> {
 
   const PartitionSchema& partition_schema() const;
 
+  // Secondary indexes of this table, as of when the table was opened.
+  const std::vector<YBIndexInfo>& indexes() const;
+
+  // For an index table, the id of the indexed table. Empty otherwise.
+  const std::string& indexed_table_id() const;
+
  private:
   class Data;
 
@@ -693,7 +675,9 @@ class YBTable : public std::enable_shared_from_this<YBTable> {
           const YBTableName& name,
           const std::string& table_id,
           const YBSchema& schema,
-          const PartitionSchema& partition_schema);
+          const PartitionSchema& partition_schema,
+          std::vector<YBIndexInfo> indexes = std::vector<YBIndexInfo>(),
+          const std::string& indexed_table_id = std::string());
 
   // Owned.
   Data* data_;
@@ -867,8 +851,10 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
 
     // Apply() calls will return immediately, but the writes will be sent in
     // the background, potentially batched together with other writes from
-    // the same session. If there is not sufficient buffer space, then Apply()
-    // may block for buffer space to be available.
+    // the same session. Buffered writes are flushed once their number or total
+    // request size reaches --client_background_flush_max_ops or
+    // --client_background_flush_max_bytes, or --client_background_flush_linger_usec
+    // after the first of them was applied, whichever happens first.
     //
     // Because writes are applied in the background, any errors will be stored
     // in a session-local buffer. Call CountPendingErrors() or GetPendingErrors()
@@ -878,9 +864,8 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
     // TODO: specify which threads the background activity runs on (probably the
     // messenger IO threads?)
     //
-    // NOTE: This is not implemented yet, see KUDU-456.
-    //
-    // The Flush() call can be used to block until the buffer is empty.
+    // The Flush() call can be used to block until the buffer is empty and all
+    // writes flushed in the background are finished.
     AUTO_FLUSH_BACKGROUND,
 
     // Apply() calls will return immediately, and the writes will not be
@@ -911,10 +896,23 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
   // Set the timeout for writes made in this session.
   void SetTimeout(MonoDelta timeout);
 
+  // Returns the hybrid time, encoded in the HybridTime format, that the replica serving a
+  // CONSISTENT_PREFIX read of this session must have caught up to. It is advanced by every write
+  // of the session, so that the session reads its own writes from followers too.
+  // Passing it to another session, e.g. one used by another proxy on behalf of the same user,
+  // with SetReadAfterHybridTime extends this guarantee to the reads of that session.
+  uint64_t GetReadAfterHybridTime() const;
+
+  // Replaces the hybrid time returned by GetReadAfterHybridTime. YBClient::kNoHybridTime lets
+  // any replica serve the following reads again.
+  void SetReadAfterHybridTime(uint64_t ht_hybrid_time);
+
   CHECKED_STATUS ReadSync(std::shared_ptr<YBOperation> yb_op) WARN_UNUSED_RESULT;
 
   void ReadAsync(std::shared_ptr<YBOperation> yb_op, YBStatusCallback* cb);
 
+  void ReadAsync(std::shared_ptr<YBOperation> yb_op, YBCompletionQueue* queue, uint64_t tag);
+
   // TODO: add "doAs" ability here for proxy servers to be able to act on behalf of
   // other users, assuming access rights.
 
@@ -977,6 +975,10 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
   CHECKED_STATUS Flush() WARN_UNUSED_RESULT;
   void FlushAsync(YBStatusCallback* cb);
 
+  // Same as above, except that instead of running a callback, a completion with the given tag and
+  // the status of the flush is added to the queue, which has to outlive the flush.
+  void FlushAsync(YBCompletionQueue* queue, uint64_t tag);
+
   // Abort the unflushed or in-flight operations in the session.
   void Abort();
 
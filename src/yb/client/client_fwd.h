@@ -28,6 +28,8 @@ namespace client {
 class YBClient;
 typedef std::shared_ptr<YBClient> YBClientPtr;
 
+class YBCompletionQueue;
+
 class YBTransaction;
 typedef std::shared_ptr<YBTransaction> YBTransactionPtr;
 
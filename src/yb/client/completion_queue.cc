@@ -0,0 +1,101 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/client/completion_queue.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include <glog/logging.h>
+
+namespace yb {
+namespace client {
+
+class YBCompletionQueue::FlushCallback : public YBStatusCallback {
+ public:
+  explicit FlushCallback(YBCompletionQueue* queue) : queue_(queue) {}
+
+  void Run(const Status& status) override {
+    queue_->FlushDone(this, status);
+  }
+
+  uint64_t tag = 0;
+
+ private:
+  YBCompletionQueue* const queue_;
+};
+
+YBCompletionQueue::YBCompletionQueue() {
+}
+
+YBCompletionQueue::~YBCompletionQueue() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  DCHECK_EQ(free_callbacks_.size(), callbacks_.size()) << "Flushes are still in progress";
+}
+
+YBStatusCallback* YBCompletionQueue::StartFlush(uint64_t tag) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++pending_;
+  FlushCallback* callback;
+  if (free_callbacks_.empty()) {
+    callbacks_.emplace_back(new FlushCallback(this));
+    callback = callbacks_.back().get();
+  } else {
+    callback = free_callbacks_.back();
+    free_callbacks_.pop_back();
+  }
+  callback->tag = tag;
+  return callback;
+}
+
+void YBCompletionQueue::FlushDone(FlushCallback* callback, const Status& status) {
+  bool notify;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    completions_.push_back(Completion{callback->tag, status});
+    free_callbacks_.push_back(callback);
+    notify = waiters_ != 0;
+  }
+  if (notify) {
+    cond_.notify_one();
+  }
+}
+
+size_t YBCompletionQueue::Poll(
+    std::vector<Completion>* completions, size_t max_completions, MonoDelta timeout) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (completions_.empty()) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    ++waiters_;
+    cond_.wait_until(lock, deadline, [this] { return !completions_.empty(); });
+    --waiters_;
+  }
+  const size_t result = std::min(max_completions, completions_.size());
+  auto end = completions_.begin() + result;
+  std::move(completions_.begin(), end, std::back_inserter(*completions));
+  completions_.erase(completions_.begin(), end);
+  pending_ -= result;
+  if (waiters_ != 0 && !completions_.empty()) {
+    // Completions left by a bounded poll are handed to the next waiter.
+    cond_.notify_one();
+  }
+  return result;
+}
+
+size_t YBCompletionQueue::pending() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pending_;
+}
+
+} // namespace client
+} // namespace yb
@@ -0,0 +1,85 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CLIENT_COMPLETION_QUEUE_H
+#define YB_CLIENT_COMPLETION_QUEUE_H
+
+#include <stdint.h>
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <gtest/gtest_prod.h>
+
+#include "yb/client/callbacks.h"
+#include "yb/util/monotime.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace client {
+
+// A queue of the results of asynchronous session flushes, an alternative to a callback per flush
+// for the applications that drive many sessions at once. A flush started with
+// YBSession::FlushAsync(queue, tag) adds a completion with its tag and status to the queue once
+// it is done, and the application obtains the completions in bulk with Poll().
+//
+// The callbacks passed to the batchers are reused, so completing a flush does not allocate
+// memory once the queue is warmed up, and no application code runs on the reactor threads.
+//
+// This class is thread-safe. It should outlive the flushes that use it.
+class YBCompletionQueue {
+ public:
+  struct Completion {
+    uint64_t tag;
+    Status status;
+  };
+
+  YBCompletionQueue();
+  ~YBCompletionQueue();
+
+  // Moves up to max_completions completions to the end of *completions, waiting up to timeout
+  // until there is at least one. Returns the number of moved completions.
+  size_t Poll(std::vector<Completion>* completions, size_t max_completions, MonoDelta timeout);
+
+  // Number of flushes that were started and whose completions were not polled yet.
+  size_t pending() const;
+
+ private:
+  friend class YBSession;
+  FRIEND_TEST(ClientUnitTest, TestCompletionQueue);
+  class FlushCallback;
+
+  // Returns a callback that adds a completion with the tag to the queue when it is run.
+  YBStatusCallback* StartFlush(uint64_t tag);
+
+  void FlushDone(FlushCallback* callback, const Status& status);
+
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<Completion> completions_;
+  // Callbacks of the flushes in progress and the ones that could be reused.
+  std::vector<std::unique_ptr<FlushCallback>> callbacks_;
+  std::vector<FlushCallback*> free_callbacks_;
+  size_t pending_ = 0;
+  size_t waiters_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(YBCompletionQueue);
+};
+
+} // namespace client
+} // namespace yb
+
+#endif // YB_CLIENT_COMPLETION_QUEUE_H
@@ -12,6 +12,9 @@
 //
 
 #include <string>
+
+#include <boost/lockfree/stack.hpp>
+
 #include "yb/client/in_flight_op.h"
 #include "yb/client/meta_cache.h"
 #include "yb/client/yb_op.h"
@@ -21,6 +24,80 @@ namespace yb {
 namespace client {
 namespace internal {
 
+namespace {
+
+// Maximum number of memory blocks of destroyed in-flight operations kept for reuse.
+constexpr size_t kMaxPooledBlocks = 16384;
+
+// Memory blocks of destroyed in-flight operations, reused by the new ones. The operations are
+// usually created by the application threads and destroyed by the reactor threads, so one pool is
+// shared by all threads.
+template <size_t kSize>
+class BlockPool {
+ public:
+  static BlockPool& Instance() {
+    // Never destroyed, because operations could outlive static objects.
+    static BlockPool* const instance = new BlockPool();
+    return *instance;
+  }
+
+  void* Take() {
+    void* block;
+    return blocks_.pop(block) ? block : ::operator new(kSize);
+  }
+
+  void Release(void* block) {
+    if (!blocks_.bounded_push(block)) {
+      ::operator delete(block);
+    }
+  }
+
+ private:
+  BlockPool() : blocks_(kMaxPooledBlocks) {}
+
+  boost::lockfree::stack<void*> blocks_;
+};
+
+// Allocates the single objects from the BlockPool of their size, which is the case for the
+// objects allocated by std::allocate_shared.
+template <class T>
+class PooledAllocator {
+ public:
+  typedef T value_type;
+
+  PooledAllocator() = default;
+
+  template <class U>
+  PooledAllocator(const PooledAllocator<U>&) {} // NOLINT
+
+  T* allocate(size_t n) {
+    if (n != 1) {
+      return std::allocator<T>().allocate(n);
+    }
+    return static_cast<T*>(BlockPool<sizeof(T)>::Instance().Take());
+  }
+
+  void deallocate(T* p, size_t n) {
+    if (n != 1) {
+      std::allocator<T>().deallocate(p, n);
+      return;
+    }
+    BlockPool<sizeof(T)>::Instance().Release(p);
+  }
+
+  template <class U>
+  bool operator==(const PooledAllocator<U>&) const { return true; }
+
+  template <class U>
+  bool operator!=(const PooledAllocator<U>&) const { return false; }
+};
+
+} // namespace
+
+InFlightOpPtr MakeInFlightOp() {
+  return std::allocate_shared<InFlightOp>(PooledAllocator<InFlightOp>());
+}
+
 std::string InFlightOp::ToString() const {
   return strings::Substitute("op[state=$0, yb_op=$1]",
                              internal::ToString(state),
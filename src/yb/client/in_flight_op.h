@@ -14,10 +14,13 @@
 #ifndef YB_CLIENT_IN_FLIGHT_OP_H
 #define YB_CLIENT_IN_FLIGHT_OP_H
 
+#include "yb/client/client_fwd.h"
+
 #include "yb/gutil/gscoped_ptr.h"
 
 #include "yb/util/locks.h"
 #include "yb/util/enums.h"
+#include "yb/util/monotime.h"
 
 namespace yb {
 namespace client {
@@ -113,9 +116,19 @@ struct InFlightOp {
   // order of operations. This is important when multiple operations act on the same row.
   int sequence_number_;
 
+  // Trace id of the sampled request that added this operation, 0 if it was not sampled.
+  uint64_t trace_id = 0;
+
+  // Time when the tablet lookup for this operation was started, set only for sampled operations.
+  MonoTime lookup_start;
+
   std::string ToString() const;
 };
 
+// Creates an in-flight operation, reusing the memory of the destroyed ones, so that applying an
+// operation to a session does not allocate memory for its in-flight state.
+InFlightOpPtr MakeInFlightOp();
+
 } // namespace internal
 } // namespace client
 } // namespace yb
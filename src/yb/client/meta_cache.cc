@@ -30,6 +30,7 @@
 // under the License.
 //
 
+#include <algorithm>
 #include <mutex>
 
 #include <boost/bind.hpp>
@@ -39,6 +40,7 @@
 
 #include "yb/client/client.h"
 #include "yb/client/client-internal.h"
+#include "yb/common/partition.h"
 #include "yb/common/schema.h"
 #include "yb/common/wire_protocol.h"
 #include "yb/gutil/map-util.h"
@@ -48,15 +50,33 @@
 #include "yb/master/master.proxy.h"
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc.h"
+#include "yb/rpc/scheduler.h"
 #include "yb/tserver/tserver_service.proxy.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/net/dns_resolver.h"
 #include "yb/util/net/net_util.h"
+#include "yb/util/threadlocal.h"
+#include "yb/yql/redis/redisserver/redis_constants.h"
 
 using std::string;
 using std::map;
 using std::shared_ptr;
 using strings::Substitute;
 
+DEFINE_bool(client_prefetch_table_locations, true,
+            "Whether locations of all tablets of a table are prefetched when table is opened.");
+TAG_FLAG(client_prefetch_table_locations, advanced);
+
+DEFINE_int32(client_prefetch_table_locations_batch_size, 1000,
+             "Max number of tablet locations requested by one GetTableLocations call, when "
+             "locations of all tablets of a table are prefetched.");
+TAG_FLAG(client_prefetch_table_locations_batch_size, advanced);
+
+DEFINE_int32(client_table_locations_refresh_interval_ms, 300000,
+             "Interval of refreshing prefetched locations of table tablets in the background. "
+             "Non positive value disables refreshing.");
+TAG_FLAG(client_table_locations_refresh_interval_ms, advanced);
+
 namespace yb {
 
 using consensus::RaftPeerPB;
@@ -318,8 +338,16 @@ std::string RemoteTablet::ReplicasAsStringUnlocked() const {
 
 ////////////////////////////////////////////////////////////
 
+namespace {
+
+std::atomic<uint64_t> next_meta_cache_id{1};
+
+} // namespace
+
 MetaCache::MetaCache(YBClient* client)
   : client_(client),
+    id_(next_meta_cache_id.fetch_add(1, std::memory_order_relaxed)),
+    partition_maps_(std::make_shared<PartitionMaps>()),
     master_lookup_sem_(50) {
 }
 
@@ -328,6 +356,10 @@ MetaCache::~MetaCache() {
 }
 
 void MetaCache::Shutdown() {
+  {
+    std::lock_guard<std::mutex> lock(prefetched_tables_mutex_);
+    shutdown_ = true;
+  }
   rpcs_.Shutdown();
 }
 
@@ -559,15 +591,22 @@ void LookupRpc::DoSendRpcCb(const Status& status,
 }
 
 RemoteTabletPtr MetaCache::ProcessTabletLocations(
-    const google::protobuf::RepeatedPtrField<master::TabletLocationsPB>& locations) {
+    const google::protobuf::RepeatedPtrField<master::TabletLocationsPB>& locations,
+    bool redis_table) {
   VLOG(2) << "Processing master response " << ToString(locations);
 
   RemoteTabletPtr result;
   bool first = true;
+  std::vector<const std::string*> updated_tables;
 
   std::lock_guard<rw_spinlock> l(lock_);
   for (const TabletLocationsPB& loc : locations) {
     TabletMap& tablets_by_key = tablets_by_table_and_key_[loc.table_id()];
+    if (redis_table && redis_tables_.insert(loc.table_id()).second &&
+        (updated_tables.empty() || *updated_tables.back() != loc.table_id())) {
+      // The slots are mapped for the tablets that were cached before as well.
+      updated_tables.push_back(&loc.table_id());
+    }
     // First, update the tserver cache, needed for the Refresh calls below.
     for (const TabletLocationsPB_ReplicaPB& r : loc.replicas()) {
       UpdateTabletServer(r.ts_info());
@@ -591,6 +630,9 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
 
       CHECK(tablets_by_id_.emplace(tablet_id, remote).second);
       CHECK(tablets_by_key.emplace(partition.partition_key_start(), remote).second);
+      if (updated_tables.empty() || *updated_tables.back() != loc.table_id()) {
+        updated_tables.push_back(&loc.table_id());
+      }
     }
     remote->Refresh(ts_cache_, loc.replicas());
 
@@ -600,10 +642,65 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
     }
   }
 
+  // Usually all locations belong to the same table.
+  std::sort(updated_tables.begin(), updated_tables.end(),
+            [](const std::string* lhs, const std::string* rhs) { return *lhs < *rhs; });
+  for (auto it = updated_tables.begin(); it != updated_tables.end(); ++it) {
+    if (it == updated_tables.begin() || **it != **std::prev(it)) {
+      UpdatePartitionMap(**it);
+    }
+  }
+
   CHECK_NOTNULL(result.get());
   return result;
 }
 
+void MetaCache::UpdatePartitionMap(const std::string& table_id) {
+  DCHECK(lock_.is_write_locked());
+  auto table_map = std::make_shared<TablePartitionMap>();
+  const TabletMap& tablets = tablets_by_table_and_key_[table_id];
+  table_map->partition_key_starts.reserve(tablets.size());
+  table_map->tablets.reserve(tablets.size());
+  for (const auto& entry : tablets) {
+    table_map->partition_key_starts.push_back(entry.first);
+    table_map->tablets.push_back(entry.second);
+  }
+  if (redis_tables_.count(table_id)) {
+    auto& slot_tablets = table_map->redis_slot_tablets;
+    slot_tablets.resize(kRedisClusterSlots);
+    for (const auto& tablet : table_map->tablets) {
+      const auto& partition = tablet->partition();
+      const size_t begin = partition.partition_key_start().empty() ? 0 :
+          PartitionSchema::DecodeMultiColumnHashValue(partition.partition_key_start());
+      const size_t end = partition.partition_key_end().empty() ? slot_tablets.size() :
+          std::min<size_t>(
+              PartitionSchema::DecodeMultiColumnHashValue(partition.partition_key_end()),
+              slot_tablets.size());
+      for (size_t slot = begin; slot < end; ++slot) {
+        slot_tablets[slot] = tablet.get();
+      }
+    }
+  }
+
+  // Maps of other tables are shared with the previous version.
+  auto maps = std::make_shared<PartitionMaps>(*partition_maps_);
+  (*maps)[table_id] = std::move(table_map);
+  partition_maps_ = std::move(maps);
+  partition_maps_version_.fetch_add(1, std::memory_order_release);
+}
+
+const MetaCache::PartitionMaps& MetaCache::ThreadPartitionMaps() {
+  BLOCK_STATIC_THREAD_LOCAL(ThreadPartitionMapsCache, cache);
+  if (PREDICT_FALSE(cache->meta_cache_id != id_ ||
+                    cache->version != partition_maps_version_.load(std::memory_order_acquire))) {
+    shared_lock<rw_spinlock> l(lock_);
+    cache->meta_cache_id = id_;
+    cache->version = partition_maps_version_.load(std::memory_order_relaxed);
+    cache->maps = partition_maps_;
+  }
+  return *cache->maps;
+}
+
 class LookupByIdRpc : public LookupRpc {
  public:
   LookupByIdRpc(const scoped_refptr<MetaCache>& meta_cache,
@@ -692,7 +789,8 @@ class LookupByKeyRpc : public LookupRpc {
  private:
   void SendRpcCb(const Status& status) override {
     DoSendRpcCb(status, resp_, [this] {
-      return meta_cache()->ProcessTabletLocations(resp_.tablet_locations());
+      return meta_cache()->ProcessTabletLocations(
+          resp_.tablet_locations(), resp_.table_type() == TableType::REDIS_TABLE_TYPE);
     });
   }
 
@@ -709,20 +807,112 @@ class LookupByKeyRpc : public LookupRpc {
   GetTableLocationsResponsePB resp_;
 };
 
+// Fetches locations of all tablets of a table, in batches of
+// client_prefetch_table_locations_batch_size locations. Batches are sent one after another, using
+// the same master lookup permit.
+class PrefetchTableLocationsRpc : public LookupRpc {
+ public:
+  PrefetchTableLocationsRpc(const scoped_refptr<MetaCache>& meta_cache,
+                            StatusCallback user_cb,
+                            std::string table_id,
+                            const MonoTime& deadline,
+                            const shared_ptr<Messenger>& messenger)
+      : LookupRpc(meta_cache, std::move(user_cb), nullptr /* remote_tablet */, deadline,
+                  messenger),
+        table_id_(std::move(table_id)) {}
+
+  std::string ToString() const override {
+    return Format("PrefetchTableLocations($0, $1, $2)",
+                  table_id_, Slice(partition_key_start_).ToDebugHexString(), num_attempts());
+  }
+
+  RemoteTabletPtr FastLookup() override {
+    return nullptr;
+  }
+
+  void DoSendRpc() override {
+    // Fill out the request.
+    req_.mutable_table()->set_table_id(table_id_);
+    req_.set_partition_key_start(partition_key_start_);
+    req_.set_max_returned_locations(
+        std::max(FLAGS_client_prefetch_table_locations_batch_size, 1));
+
+    master_proxy()->GetTableLocationsAsync(
+        req_, &resp_, mutable_retrier()->mutable_controller(),
+        std::bind(&PrefetchTableLocationsRpc::SendRpcCb, this, Status::OK()));
+  }
+
+ private:
+  void SendRpcCb(const Status& status) override {
+    if (status.ok() && retrier().controller().status().ok() && !resp_.has_error() &&
+        resp_.tablet_locations_size() != 0) {
+      const auto& last = resp_.tablet_locations(resp_.tablet_locations_size() - 1);
+      const auto& partition_key_end = last.partition().partition_key_end();
+      if (!partition_key_end.empty() && MonoTime::Now().ComesBefore(retrier().deadline())) {
+        meta_cache()->ProcessTabletLocations(
+            resp_.tablet_locations(), resp_.table_type() == TableType::REDIS_TABLE_TYPE);
+        VLOG(2) << ToString() << ": fetched " << resp_.tablet_locations_size() << " locations";
+
+        // Request the next batch.
+        partition_key_start_ = partition_key_end;
+        req_.Clear();
+        resp_.Clear();
+        MonoTime rpc_deadline = MonoTime::Now();
+        rpc_deadline.AddDelta(client()->default_rpc_timeout());
+        mutable_retrier()->mutable_controller()->Reset();
+        mutable_retrier()->mutable_controller()->set_deadline(
+            MonoTime::Earliest(rpc_deadline, retrier().deadline()));
+        DoSendRpc();
+        return;
+      }
+    }
+
+    DoSendRpcCb(status, resp_, [this] {
+      return meta_cache()->ProcessTabletLocations(
+          resp_.tablet_locations(), resp_.table_type() == TableType::REDIS_TABLE_TYPE);
+    });
+  }
+
+  // Table to prefetch.
+  std::string table_id_;
+
+  // Start partition key of the batch in flight.
+  std::string partition_key_start_;
+
+  // Request body.
+  GetTableLocationsRequestPB req_;
+
+  // Response body.
+  GetTableLocationsResponsePB resp_;
+};
+
 RemoteTabletPtr MetaCache::LookupTabletByKeyFastPath(const YBTable* table,
                                                      const string& partition_key) {
-  shared_lock<rw_spinlock> l(lock_);
-  const TabletMap* tablets = FindOrNull(tablets_by_table_and_key_, table->id());
-  if (PREDICT_FALSE(!tablets)) {
+  // Does not take lock_, unless tablets were added since the previous lookup of this thread.
+  const PartitionMaps& maps = ThreadPartitionMaps();
+  auto it = maps.find(table->id());
+  if (PREDICT_FALSE(it == maps.end())) {
     // No cache available for this table.
     return nullptr;
   }
 
-  const scoped_refptr<RemoteTablet>* r = FindFloorOrNull(*tablets, partition_key);
-  if (PREDICT_FALSE(!r)) {
+  const auto& slot_tablets = it->second->redis_slot_tablets;
+  if (!slot_tablets.empty() && partition_key.size() == PartitionSchema::kPartitionKeySize) {
+    const auto slot = PartitionSchema::DecodeMultiColumnHashValue(partition_key);
+    if (slot < slot_tablets.size()) {
+      RemoteTablet* tablet = slot_tablets[slot];
+      // Stale entries must be re-fetched.
+      return tablet != nullptr && !tablet->stale() ? tablet : nullptr;
+    }
+  }
+
+  const auto& keys = it->second->partition_key_starts;
+  auto key_it = std::upper_bound(keys.begin(), keys.end(), partition_key);
+  if (PREDICT_FALSE(key_it == keys.begin())) {
     // No tablets with a start partition key lower than 'partition_key'.
     return nullptr;
   }
+  const RemoteTabletPtr* r = &it->second->tablets[key_it - keys.begin() - 1];
 
   // Stale entries must be re-fetched.
   if ((*r)->stale()) {
@@ -773,6 +963,68 @@ void MetaCache::LookupTabletById(const string& tablet_id,
                                client_->data_->messenger_);
 }
 
+void MetaCache::PrefetchTableLocations(const std::string& table_id,
+                                       const MonoTime& deadline,
+                                       const StatusCallback& callback) {
+  rpc::StartRpc<PrefetchTableLocationsRpc>(this,
+                                           callback,
+                                           table_id,
+                                           deadline,
+                                           client_->data_->messenger_);
+}
+
+void MetaCache::StartPrefetchingTableLocations(const std::string& table_id) {
+  if (!FLAGS_client_prefetch_table_locations) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(prefetched_tables_mutex_);
+    if (shutdown_ || !prefetched_tables_.insert(table_id).second) {
+      return;
+    }
+  }
+  MonoTime deadline = MonoTime::Now();
+  deadline.AddDelta(client_->default_admin_operation_timeout());
+  // Started rpc keeps this meta cache alive until the callback is invoked.
+  PrefetchTableLocations(
+      table_id, deadline,
+      Bind(&MetaCache::TableLocationsPrefetched, Unretained(this), table_id));
+}
+
+void MetaCache::TableLocationsPrefetched(const std::string& table_id, const Status& status) {
+  if (!status.ok()) {
+    // Lookups of the missing tablets would fetch them on demand.
+    LOG(WARNING) << "Failed to prefetch locations of table " << table_id << ": " << status;
+  }
+
+  const auto refresh_interval_ms = FLAGS_client_table_locations_refresh_interval_ms;
+  {
+    std::lock_guard<std::mutex> lock(prefetched_tables_mutex_);
+    if (shutdown_ || refresh_interval_ms <= 0) {
+      prefetched_tables_.erase(table_id);
+      return;
+    }
+  }
+
+  scoped_refptr<MetaCache> self(this);
+  client_->data_->messenger_->scheduler().Schedule(
+      [self, table_id](const Status& status) {
+        {
+          std::lock_guard<std::mutex> lock(self->prefetched_tables_mutex_);
+          if (!status.ok() || self->shutdown_) {
+            self->prefetched_tables_.erase(table_id);
+            return;
+          }
+        }
+        MonoTime deadline = MonoTime::Now();
+        deadline.AddDelta(self->client_->default_admin_operation_timeout());
+        self->PrefetchTableLocations(
+            table_id, deadline,
+            Bind(&MetaCache::TableLocationsPrefetched, Unretained(self.get()), table_id));
+      },
+      std::chrono::milliseconds(refresh_interval_ms));
+}
+
 void MetaCache::MarkTSFailed(RemoteTabletServer* ts,
                              const Status& status) {
   LOG(INFO) << "Marking tablet server " << ts->ToString() << " as failed.";
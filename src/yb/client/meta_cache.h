@@ -33,10 +33,13 @@
 #ifndef YB_CLIENT_META_CACHE_H
 #define YB_CLIENT_META_CACHE_H
 
+#include <atomic>
 #include <map>
+#include <mutex>
 #include <string>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "yb/client/client_fwd.h"
@@ -77,6 +80,7 @@ class TSInfoPB;
 namespace client {
 
 class ClientTest_TestMasterLookupPermits_Test;
+class ClientTest_TestPrefetchTableLocations_Test;
 class YBClient;
 class YBTable;
 
@@ -264,6 +268,17 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
                         RemoteTabletPtr* remote_tablet,
                         const StatusCallback& callback);
 
+  // Fetches locations of all tablets of the table from the master, using a few large
+  // GetTableLocations calls instead of one lookup per tablet, and caches them.
+  void PrefetchTableLocations(const std::string& table_id,
+                              const MonoTime& deadline,
+                              const StatusCallback& callback);
+
+  // Prefetches locations of all tablets of the table in the background, unless it was already
+  // started for this table or client_prefetch_table_locations is not set. Locations are then refreshed every
+  // client_table_locations_refresh_interval_ms.
+  void StartPrefetchingTableLocations(const std::string& table_id);
+
   // Mark any replicas of any tablets hosted by 'ts' as failed. They will
   // not be returned in future cache lookups.
   void MarkTSFailed(RemoteTabletServer* ts, const Status& status);
@@ -279,13 +294,17 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   friend class LookupRpc;
   friend class LookupByKeyRpc;
   friend class LookupByIdRpc;
+  friend class PrefetchTableLocationsRpc;
 
   FRIEND_TEST(client::ClientTest, TestMasterLookupPermits);
+  FRIEND_TEST(client::ClientTest, TestPrefetchTableLocations);
 
   // Called on the slow LookupTablet path when the master responds. Populates
-  // the tablet caches and returns a reference to the first one.
+  // the tablet caches and returns a reference to the first one. redis_table is set when the
+  // locations are known to belong to a Redis table.
   RemoteTabletPtr ProcessTabletLocations(
-      const google::protobuf::RepeatedPtrField<master::TabletLocationsPB>& locations);
+      const google::protobuf::RepeatedPtrField<master::TabletLocationsPB>& locations,
+      bool redis_table = false);
 
   // Lookup the given tablet by key, only consulting local information.
   // Returns true and sets *remote_tablet if successful.
@@ -294,6 +313,8 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
 
   RemoteTabletPtr LookupTabletByIdFastPath(const std::string& tablet_id);
 
+  void TableLocationsPrefetched(const std::string& table_id, const Status& status);
+
   // Update our information about the given tablet server.
   //
   // This is called when we get some response from the master which contains
@@ -302,8 +323,40 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   // NOTE: Must be called with lock_ held.
   void UpdateTabletServer(const master::TSInfoPB& pb);
 
+  // Tablets of a table sorted by start partition key, i.e. the contents of TabletMap in a form
+  // that could be searched without locking. Immutable once published.
+  struct TablePartitionMap {
+    std::vector<std::string> partition_key_starts;
+    std::vector<RemoteTabletPtr> tablets;
+    // Tablet of each Redis cluster slot, so that routing a Redis key is an array lookup. The
+    // tablets are owned by 'tablets', the slots of tablets that are not cached are null. Empty for
+    // the tables of other types.
+    std::vector<RemoteTablet*> redis_slot_tablets;
+  };
+
+  typedef std::unordered_map<std::string, std::shared_ptr<const TablePartitionMap>> PartitionMaps;
+
+  struct ThreadPartitionMapsCache {
+    uint64_t meta_cache_id = 0;
+    uint64_t version = 0;
+    std::shared_ptr<const PartitionMaps> maps;
+  };
+
+  // Rebuilds partition map of the table and publishes a new version of partition maps.
+  //
+  // NOTE: Must be called with lock_ held.
+  void UpdatePartitionMap(const std::string& table_id);
+
+  // Returns partition maps cached by the calling thread, refreshing them if a new version was
+  // published.
+  const PartitionMaps& ThreadPartitionMaps();
+
   YBClient* client_;
 
+  // Distinguishes partition maps of this meta cache from the ones of other meta caches, in thread
+  // local caches.
+  const uint64_t id_;
+
   rw_spinlock lock_;
 
   // Cache of Tablet Server locations: TS UUID -> RemoteTabletServer*.
@@ -321,6 +374,18 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   typedef std::map<std::string, RemoteTabletPtr> TabletMap;
   std::unordered_map<std::string, TabletMap> tablets_by_table_and_key_;
 
+  // Redis tables, whose partition maps also map the cluster slots to tablets.
+  //
+  // Protected by lock_.
+  std::unordered_set<std::string> redis_tables_;
+
+  // Published partition maps, replaced when tablets are added to tablets_by_table_and_key_.
+  // Routing threads cache them and only take lock_ when partition_maps_version_ changes.
+  //
+  // Protected by lock_.
+  std::shared_ptr<const PartitionMaps> partition_maps_;
+  std::atomic<uint64_t> partition_maps_version_{1};
+
   // Cache of tablets, keyed by tablet ID.
   //
   // Protected by lock_
@@ -330,6 +395,11 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   // permits have been acquired.
   Semaphore master_lookup_sem_;
 
+  // Tables whose locations are prefetched and refreshed in the background.
+  std::mutex prefetched_tables_mutex_;
+  std::unordered_set<std::string> prefetched_tables_;
+  bool shutdown_ = false;
+
   rpc::Rpcs rpcs_;
 
   DISALLOW_COPY_AND_ASSIGN(MetaCache);
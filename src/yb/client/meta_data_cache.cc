@@ -0,0 +1,196 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/client/meta_data_cache.h"
+
+#include "yb/client/client.h"
+
+#include "yb/common/ql_type.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/logging.h"
+#include "yb/util/threadpool.h"
+
+DEFINE_int32(metadata_cache_negative_ttl_ms, 1000,
+             "How long the CQL metadata cache remembers that a table or type does not exist, "
+             "in milliseconds. 0 disables negative caching.");
+TAG_FLAG(metadata_cache_negative_ttl_ms, advanced);
+TAG_FLAG(metadata_cache_negative_ttl_ms, runtime);
+
+DEFINE_int32(metadata_cache_refresh_interval_ms, 10000,
+             "How often a cached table that is in use is reopened in the background to pick up "
+             "schema changes, in milliseconds. 0 disables background refresh.");
+TAG_FLAG(metadata_cache_refresh_interval_ms, advanced);
+TAG_FLAG(metadata_cache_refresh_interval_ms, runtime);
+
+namespace yb {
+namespace client {
+
+using std::shared_ptr;
+using std::string;
+
+namespace {
+
+MonoDelta RefreshInterval() {
+  const auto interval_ms = FLAGS_metadata_cache_refresh_interval_ms;
+  return interval_ms > 0 ? MonoDelta::FromMilliseconds(interval_ms) : MonoDelta();
+}
+
+MonoTime After(MonoTime now, MonoDelta delta) {
+  if (!delta) {
+    return MonoTime::Max();
+  }
+  now.AddDelta(delta);
+  return now;
+}
+
+// Whether 'fresh' differs from 'cached' in a way that statements can observe.
+bool TableChanged(const YBTable& cached, const YBTable& fresh) {
+  return cached.id() != fresh.id() ||
+         cached.schema().version() != fresh.schema().version() ||
+         cached.indexes().size() != fresh.indexes().size();
+}
+
+} // namespace
+
+YBMetaDataCache::YBMetaDataCache(std::shared_ptr<YBClient> client) : client_(std::move(client)) {
+  CHECK_OK(ThreadPoolBuilder("metadata_cache_refresh")
+               .set_min_threads(0)
+               .set_max_threads(1)
+               .Build(&refresh_pool_));
+}
+
+YBMetaDataCache::~YBMetaDataCache() {
+  refresh_pool_->Shutdown();
+}
+
+template <class Map, class Key, class Value>
+void YBMetaDataCache::CacheResult(
+    Map* map, const Key& key, const Status& status, const Value& value) {
+  const auto now = MonoTime::Now();
+  if (status.ok()) {
+    map->InsertFound(key, value, After(now, RefreshInterval()));
+  } else if (status.IsNotFound() && FLAGS_metadata_cache_negative_ttl_ms > 0) {
+    map->InsertNotFound(
+        key, status, After(now, MonoDelta::FromMilliseconds(FLAGS_metadata_cache_negative_ttl_ms)));
+  }
+}
+
+template <class Map, class Key>
+void YBMetaDataCache::ScheduleRefresh(
+    Map* map, Key key, shared_ptr<YBTable> table,
+    std::function<Status(const Key&, shared_ptr<YBTable>*)> open) {
+  auto refresh = [map, key, table, open]() {
+    shared_ptr<YBTable> fresh;
+    Status s = open(key, &fresh);
+    if (s.IsNotFound()) {
+      // The table is gone. Drop the entry so the next lookup finds out from the master.
+      map->ReplaceIf(key, table, nullptr, MonoTime::Max());
+    } else if (!s.ok()) {
+      VLOG(1) << "Failed to refresh cached table " << table->name().ToString() << ": " << s;
+    } else if (TableChanged(*table, *fresh)) {
+      VLOG(1) << "Refreshed cached table " << table->name().ToString() << " to schema version "
+              << fresh->schema().version();
+      map->ReplaceIf(key, table, std::move(fresh), After(MonoTime::Now(), RefreshInterval()));
+    }
+  };
+  Status s = refresh_pool_->SubmitFunc(refresh);
+  if (!s.ok()) {
+    VLOG(1) << "Failed to schedule refresh of cached table " << table->name().ToString() << ": "
+            << s;
+  }
+}
+
+Status YBMetaDataCache::GetTable(
+    const YBTableName& table_name, shared_ptr<YBTable>* table, bool* cache_used) {
+  Status status;
+  bool refresh_due = false;
+  if (cached_tables_.Find(
+          table_name, MonoTime::Now(), RefreshInterval(), table, &status, &refresh_due)) {
+    if (refresh_due) {
+      auto client = client_;
+      ScheduleRefresh<YBTableMap, YBTableName>(
+          &cached_tables_, table_name, *table,
+          [client](const YBTableName& name, shared_ptr<YBTable>* fresh) {
+            return client->OpenTable(name, fresh);
+          });
+    }
+    *cache_used = true;
+    return status;
+  }
+
+  status = client_->OpenTable(table_name, table);
+  CacheResult(&cached_tables_, table_name, status, *table);
+  *cache_used = false;
+  return status;
+}
+
+Status YBMetaDataCache::GetTableById(
+    const TableId& table_id, shared_ptr<YBTable>* table, bool* cache_used) {
+  Status status;
+  bool refresh_due = false;
+  if (cached_tables_by_id_.Find(
+          table_id, MonoTime::Now(), RefreshInterval(), table, &status, &refresh_due)) {
+    if (refresh_due) {
+      auto client = client_;
+      ScheduleRefresh<YBTableByIdMap, TableId>(
+          &cached_tables_by_id_, table_id, *table,
+          [client](const TableId& id, shared_ptr<YBTable>* fresh) {
+            return client->OpenTableById(id, fresh);
+          });
+    }
+    *cache_used = true;
+    return status;
+  }
+
+  status = client_->OpenTableById(table_id, table);
+  CacheResult(&cached_tables_by_id_, table_id, status, *table);
+  *cache_used = false;
+  return status;
+}
+
+void YBMetaDataCache::RemoveCachedTable(const YBTableName& table_name) {
+  cached_tables_.Erase(table_name);
+}
+
+void YBMetaDataCache::RemoveCachedTableById(const TableId& table_id) {
+  cached_tables_by_id_.Erase(table_id);
+}
+
+Status YBMetaDataCache::GetUDType(const string &keyspace_name,
+                                  const string &type_name,
+                                  shared_ptr<QLType> *ql_type,
+                                  bool *cache_used) {
+  auto type_path = std::make_pair(keyspace_name, type_name);
+  Status status;
+  bool refresh_due = false;
+  // Types cannot be altered, so there is nothing to refresh them for.
+  if (cached_types_.Find(type_path, MonoTime::Now(), MonoDelta(), ql_type, &status,
+                         &refresh_due)) {
+    *cache_used = true;
+    return status;
+  }
+
+  status = client_->GetUDType(keyspace_name, type_name, ql_type);
+  CacheResult(&cached_types_, type_path, status, *ql_type);
+  *cache_used = false;
+  return status;
+}
+
+void YBMetaDataCache::RemoveCachedUDType(const string& keyspace_name,
+                                         const string& type_name) {
+  cached_types_.Erase(std::make_pair(keyspace_name, type_name));
+}
+
+}  // namespace client
+}  // namespace yb
@@ -0,0 +1,225 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CLIENT_META_DATA_CACHE_H
+#define YB_CLIENT_META_DATA_CACHE_H
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <boost/functional/hash/hash.hpp>
+#include <boost/thread/shared_mutex.hpp>
+
+#include "yb/client/client_fwd.h"
+#include "yb/client/yb_table_name.h"
+
+#include "yb/common/entity_ids.h"
+
+#include "yb/util/locks.h"
+#include "yb/util/monotime.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+class QLType;
+class ThreadPool;
+
+namespace client {
+
+namespace internal {
+
+// A map from a metadata key to the entity opened for it, split into independently locked shards
+// so that concurrent lookups of different keys do not contend. Besides positive entries, it keeps
+// negative ones: the key was not found and that status is returned until the entry expires.
+template <class Key, class Value, class Hash = std::hash<Key>>
+class MetaDataCacheMap {
+ public:
+  // Looks up 'key'. Returns false on a miss or an expired negative entry. Otherwise sets 'value'
+  // for a positive entry or 'status' for a negative one. 'refresh_due' is set when a positive
+  // entry is due for a background refresh; only one caller per refresh interval sees it set.
+  bool Find(const Key& key, MonoTime now, MonoDelta refresh_interval, Value* value,
+            Status* status, bool* refresh_due) {
+    auto& shard = ShardFor(key);
+    {
+      boost::shared_lock<rw_spinlock> lock(shard.mutex);
+      auto it = shard.map.find(key);
+      if (it == shard.map.end()) {
+        return false;
+      }
+      const Entry& entry = it->second;
+      if (!entry.value) {
+        if (entry.deadline.ComesBefore(now)) {
+          return false;
+        }
+        *status = entry.status;
+        return true;
+      }
+      *value = entry.value;
+      *status = Status::OK();
+      *refresh_due = false;
+      if (!refresh_interval.Initialized() || now.ComesBefore(entry.deadline)) {
+        return true;
+      }
+    }
+    // Claim the refresh while holding the exclusive lock so that only one caller schedules it.
+    std::lock_guard<rw_spinlock> lock(shard.mutex);
+    auto it = shard.map.find(key);
+    if (it != shard.map.end() && it->second.value == *value &&
+        !now.ComesBefore(it->second.deadline)) {
+      it->second.deadline = now;
+      it->second.deadline.AddDelta(refresh_interval);
+      *refresh_due = true;
+    }
+    return true;
+  }
+
+  void InsertFound(const Key& key, Value value, MonoTime refresh_at) {
+    auto& shard = ShardFor(key);
+    std::lock_guard<rw_spinlock> lock(shard.mutex);
+    shard.map[key] = Entry{std::move(value), Status::OK(), refresh_at};
+  }
+
+  void InsertNotFound(const Key& key, Status status, MonoTime expire_at) {
+    auto& shard = ShardFor(key);
+    std::lock_guard<rw_spinlock> lock(shard.mutex);
+    shard.map[key] = Entry{Value(), std::move(status), expire_at};
+  }
+
+  // Replaces the entry for 'key' with 'fresh', but only if it still holds 'old', so that a
+  // background refresh never resurrects an entry that was removed or replaced meanwhile.
+  // A null 'fresh' just removes the entry.
+  void ReplaceIf(const Key& key, const Value& old, Value fresh, MonoTime refresh_at) {
+    auto& shard = ShardFor(key);
+    std::lock_guard<rw_spinlock> lock(shard.mutex);
+    auto it = shard.map.find(key);
+    if (it == shard.map.end() || it->second.value != old) {
+      return;
+    }
+    if (fresh) {
+      it->second = Entry{std::move(fresh), Status::OK(), refresh_at};
+    } else {
+      shard.map.erase(it);
+    }
+  }
+
+  void Erase(const Key& key) {
+    auto& shard = ShardFor(key);
+    std::lock_guard<rw_spinlock> lock(shard.mutex);
+    shard.map.erase(key);
+  }
+
+ private:
+  static constexpr size_t kNumShards = 16;
+
+  struct Entry {
+    // Null for a negative entry.
+    Value value;
+    // The not-found status of a negative entry.
+    Status status;
+    // When a negative entry expires, or when a positive entry is next due for refresh.
+    MonoTime deadline;
+  };
+
+  struct Shard {
+    rw_spinlock mutex;
+    std::unordered_map<Key, Entry, Hash> map;
+  };
+
+  Shard& ShardFor(const Key& key) {
+    return shards_[Hash()(key) % kNumShards];
+  }
+
+  std::array<Shard, kNumShards> shards_;
+};
+
+} // namespace internal
+
+// Caches the tables and user-defined types opened by the CQL layer, so that statements do not
+// need a master RPC to look up their metadata. Lookups of names that do not exist are cached for
+// a short time too, and entries that are in use are periodically refreshed in the background so
+// that schema changes are picked up without another RPC on the query path.
+//
+// This class is thread-safe.
+class YBMetaDataCache {
+ public:
+  explicit YBMetaDataCache(std::shared_ptr<YBClient> client);
+  ~YBMetaDataCache();
+
+  // Opens the table with the given name. If the table has been opened before, returns the
+  // previously opened table from cached_tables_. If the table has not been opened before
+  // in this client, this will do an RPC to ensure that the table exists and look up its schema.
+  CHECKED_STATUS GetTable(
+      const YBTableName& table_name, std::shared_ptr<YBTable>* table, bool* cache_used);
+
+  // Same as above, for the table with the given id. Also opens index tables.
+  CHECKED_STATUS GetTableById(
+      const TableId& table_id, std::shared_ptr<YBTable>* table, bool* cache_used);
+
+  // Remove the table from cached_tables_ if it is in the cache.
+  void RemoveCachedTable(const YBTableName& table_name);
+
+  // Remove the table from cached_tables_by_id_ if it is in the cache.
+  void RemoveCachedTableById(const TableId& table_id);
+
+  // Opens the type with the given name. If the type has been opened before, returns the
+  // previously opened type from cached_types_. If the type has not been opened before
+  // in this client, this will do an RPC to ensure that the type exists and look up its info.
+  CHECKED_STATUS GetUDType(const std::string &keyspace_name,
+                           const std::string &type_name,
+                           std::shared_ptr<QLType> *ql_type,
+                           bool *cache_used);
+
+  // Remove the type from cached_types_ if it is in the cache.
+  void RemoveCachedUDType(const std::string& keyspace_name, const std::string& type_name);
+
+ private:
+  typedef internal::MetaDataCacheMap<YBTableName,
+                                     std::shared_ptr<YBTable>,
+                                     boost::hash<YBTableName>> YBTableMap;
+  typedef internal::MetaDataCacheMap<TableId, std::shared_ptr<YBTable>> YBTableByIdMap;
+  typedef internal::MetaDataCacheMap<std::pair<std::string, std::string>,
+                                     std::shared_ptr<QLType>,
+                                     boost::hash<std::pair<std::string, std::string>>> YBTypeMap;
+
+  // Caches the outcome of opening an entity: the entity itself, or a negative entry if it was
+  // not found.
+  template <class Map, class Key, class Value>
+  void CacheResult(Map* map, const Key& key, const Status& status, const Value& value);
+
+  // Schedules a background reopen of 'table' and swaps it into 'map' if its metadata changed.
+  template <class Map, class Key>
+  void ScheduleRefresh(
+      Map* map, Key key, std::shared_ptr<YBTable> table,
+      std::function<Status(const Key&, std::shared_ptr<YBTable>*)> open);
+
+  std::shared_ptr<YBClient> client_;
+
+  // Map from table-name to YBTable instances.
+  YBTableMap cached_tables_;
+  YBTableByIdMap cached_tables_by_id_;
+
+  // Map from type-name to QLType instances.
+  YBTypeMap cached_types_;
+
+  // Runs the background refreshes. Destroyed first so no refresh outlives the maps.
+  std::unique_ptr<ThreadPool> refresh_pool_;
+};
+
+}  // namespace client
+}  // namespace yb
+
+#endif // YB_CLIENT_META_DATA_CACHE_H
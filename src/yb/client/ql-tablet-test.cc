@@ -23,11 +23,20 @@
 #include "yb/client/ql-dml-test-base.h"
 #include "yb/client/table_handle.h"
 
+#include "yb/common/wire_protocol.h"
+
 #include "yb/consensus/consensus.pb.h"
 
+#include "yb/docdb/docdb_rocksdb_util.h"
+
 #include "yb/master/catalog_manager.h"
 #include "yb/master/master.h"
 
+#include "yb/rocksdb/db.h"
+#include "yb/rocksdb/sst_file_writer.h"
+
+#include "yb/tablet/tablet_options.h"
+
 #include "yb/yql/cql/ql/util/statement_result.h"
 
 #include "yb/tserver/mini_tablet_server.h"
@@ -273,6 +282,80 @@ class QLTabletTest : public QLDmlTestBase {
     return Status::OK();
   }
 
+  // Writes the data of the RocksDB in 'db_dir' to an SST file at 'path', as an external bulk load
+  // tool would. Sets 'num_entries' to the number of entries written.
+  CHECKED_STATUS WriteSSTFile(const std::string& db_dir, const std::string& path,
+                              size_t* num_entries) {
+    rocksdb::Options options;
+    docdb::InitRocksDBOptions(&options, "ingest", nullptr, tablet::TabletOptions());
+    rocksdb::DB* raw_db = nullptr;
+    RETURN_NOT_OK(rocksdb::DB::OpenForReadOnly(options, db_dir, &raw_db));
+    std::unique_ptr<rocksdb::DB> db(raw_db);
+
+    rocksdb::SstFileWriter writer(
+        rocksdb::EnvOptions(), rocksdb::ImmutableCFOptions(options), options.comparator);
+    RETURN_NOT_OK(writer.Open(path));
+    *num_entries = 0;
+    std::unique_ptr<rocksdb::Iterator> iter(db->NewIterator(rocksdb::ReadOptions()));
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      RETURN_NOT_OK(writer.Add(iter->key(), iter->value()));
+      ++*num_entries;
+    }
+    RETURN_NOT_OK(iter->status());
+    return *num_entries != 0 ? writer.Finish() : Status::OK();
+  }
+
+  // Builds SST files from the tablets of the first table and ingests them into the tablets of the
+  // second one through their leaders.
+  CHECKED_STATUS IngestSSTFiles() {
+    std::this_thread::sleep_for(1s); // Wait until all tablets a synced and flushed.
+    cluster_->FlushTablets();
+
+    auto source_infos = GetTabletInfos(kTable1Name);
+    auto dest_infos = GetTabletInfos(kTable2Name);
+    EXPECT_EQ(source_infos.size(), dest_infos.size());
+    auto* tablet_manager = cluster_->mini_tablet_server(0)->server()->tablet_manager();
+    for (size_t i = 0; i != source_infos.size(); ++i) {
+      tablet::TabletPeerPtr source_peer;
+      if (!tablet_manager->LookupTablet(source_infos[i]->id(), &source_peer)) {
+        return STATUS_FORMAT(NotFound, "Tablet $0 not found", source_infos[i]->id());
+      }
+      const auto path = JoinPathSegments(GetTestDataDirectory(), Format("ingest-$0.sst", i));
+      size_t num_entries = 0;
+      RETURN_NOT_OK(WriteSSTFile(
+          source_peer->tablet()->metadata()->rocksdb_dir(), path, &num_entries));
+      if (num_entries == 0) {
+        continue;
+      }
+
+      tserver::IngestSSTFilesRequestPB req;
+      req.set_tablet_id(dest_infos[i]->id());
+      req.add_file_paths(path);
+      RETURN_NOT_OK(WaitFor([this, &req]() -> Result<bool> {
+        for (int j = 0; j != cluster_->num_tablet_servers(); ++j) {
+          auto* server = cluster_->mini_tablet_server(j)->server();
+          tablet::TabletPeerPtr peer;
+          if (!server->tablet_manager()->LookupTablet(req.tablet_id(), &peer) ||
+              peer->LeaderStatus() != consensus::Consensus::LeaderStatus::LEADER_AND_READY) {
+            continue;
+          }
+          tserver::TabletServerServiceProxy proxy(
+              server->messenger(), server->rpc_server()->GetBoundAddresses().front());
+          tserver::IngestSSTFilesResponsePB resp;
+          rpc::RpcController controller;
+          controller.set_timeout(MonoDelta::FromSeconds(30));
+          RETURN_NOT_OK(proxy.IngestSSTFiles(req, &resp, &controller));
+          if (resp.has_error()) {
+            return StatusFromPB(resp.error().status());
+          }
+          return true;
+        }
+        return false;
+      }, 30s, "Ingest SST files"));
+    }
+    return Status::OK();
+  }
+
   scoped_refptr<master::TableInfo> GetTableInfo(const YBTableName& table_name) {
     auto* catalog_manager = cluster_->leader_mini_master()->master()->catalog_manager();
     std::vector<scoped_refptr<master::TableInfo>> all_tables;
@@ -307,6 +390,18 @@ TEST_F(QLTabletTest, ImportToEmpty) {
   VerifyTable(0, kTotalKeys, &table2_);
 }
 
+TEST_F(QLTabletTest, IngestSSTFiles) {
+  CreateTables(0, kBigSeqNo);
+
+  FillTable(0, kTotalKeys, &table1_);
+  ASSERT_OK(IngestSSTFiles());
+  VerifyTable(0, kTotalKeys, &table2_);
+
+  // The ingested files are in the RocksDB of every replica, and are not replayed on restart.
+  ASSERT_OK(cluster_->RestartSync());
+  VerifyTable(0, kTotalKeys, &table2_);
+}
+
 TEST_F(QLTabletTest, ImportToNonEmpty) {
   CreateTables(0, kBigSeqNo);
 
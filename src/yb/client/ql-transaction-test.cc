@@ -49,6 +49,8 @@ DECLARE_uint64(transaction_check_interval_usec);
 DECLARE_uint64(max_clock_skew_usec);
 DECLARE_bool(transaction_allow_rerequest_status_in_tests);
 DECLARE_bool(use_test_clock);
+DECLARE_bool(enable_transaction_wait_queues);
+DECLARE_int32(transaction_wait_queue_max_wait_ms);
 
 namespace yb {
 namespace client {
@@ -339,6 +341,46 @@ void QLTransactionTest::TestReadRestart(bool commit) {
   ASSERT_OK(cluster_->RestartSync());
 }
 
+TEST_F(QLTransactionTest, SingleShard) {
+  auto txn = std::make_shared<YBTransaction>(transaction_manager_.get_ptr(), SNAPSHOT_ISOLATION);
+  auto session = CreateSession(txn);
+  ASSERT_OK(session->SetFlushMode(YBSession::MANUAL_FLUSH));
+  // Both operations belong to the same row, so they are written to the same tablet.
+  ASSERT_OK(WriteRow(session, 1, 2));
+  ASSERT_OK(UpdateRow(session, 1, 3));
+  ASSERT_OK(txn->FlushAndCommitFuture(session.get()).get());
+  // Transaction was never registered at the status tablet.
+  ASSERT_EQ(0, CountTransactions());
+  VERIFY_ROW(CreateSession(), 1, 3);
+
+  // Nothing could be written in context of committed transaction.
+  ASSERT_OK(WriteRow(session, 2, 4));
+  ASSERT_NOK(session->Flush());
+}
+
+TEST_F(QLTransactionTest, FlushAndCommitMultipleShards) {
+  auto txn = std::make_shared<YBTransaction>(transaction_manager_.get_ptr(), SNAPSHOT_ISOLATION);
+  auto session = CreateSession(txn);
+  ASSERT_OK(session->SetFlushMode(YBSession::MANUAL_FLUSH));
+  WriteRows(session);
+  ASSERT_OK(txn->FlushAndCommitFuture(session.get()).get());
+  VerifyData();
+}
+
+TEST_F(QLTransactionTest, ParallelCommit) {
+  auto txn = std::make_shared<YBTransaction>(transaction_manager_.get_ptr(), SNAPSHOT_ISOLATION);
+  auto session = CreateSession(txn);
+  ASSERT_OK(session->SetFlushMode(YBSession::MANUAL_FLUSH));
+  WriteRows(session);
+  ASSERT_OK(session->Flush());
+  // Transaction is already registered at the status tablet, so commit is sent together with the
+  // last writes.
+  WriteRows(session, 0 /* transaction */, WriteOpType::UPDATE);
+  ASSERT_OK(txn->FlushAndCommitFuture(session.get()).get());
+  VerifyData(1 /* num_transactions */, WriteOpType::UPDATE);
+  ASSERT_NOK(txn->CommitFuture().get());
+}
+
 TEST_F(QLTransactionTest, ReadRestart) {
   TestReadRestart();
 }
@@ -477,6 +519,22 @@ TEST_F(QLTransactionTest, Heartbeat) {
   VerifyData();
 }
 
+// Heartbeats of all these transactions are sent together, since they have the same status tablet.
+TEST_F(QLTransactionTest, HeartbeatSeveralTransactions) {
+  constexpr size_t kTransactions = 5;
+  std::vector<YBTransactionPtr> transactions;
+  for (size_t i = 0; i != kTransactions; ++i) {
+    transactions.push_back(std::make_shared<YBTransaction>(
+        transaction_manager_.get_ptr(), SNAPSHOT_ISOLATION));
+    WriteRows(CreateSession(transactions.back()), i);
+  }
+  std::this_thread::sleep_for(std::chrono::microseconds(FLAGS_transaction_timeout_usec * 2));
+  for (const auto& transaction : transactions) {
+    ASSERT_OK(transaction->CommitFuture().get());
+  }
+  VerifyData(kTransactions);
+}
+
 TEST_F(QLTransactionTest, Expire) {
   google::FlagSaver flag_saver;
   SetDisableHeartbeatInTests(true);
@@ -606,6 +664,44 @@ TEST_F(QLTransactionTest, SimpleWriteConflict) {
   ASSERT_NOK(transaction->CommitFuture().get());
 }
 
+TEST_F(QLTransactionTest, WaitQueue) {
+  google::FlagSaver flag_saver;
+  FLAGS_enable_transaction_wait_queues = true;
+  FLAGS_transaction_wait_queue_max_wait_ms = 30000;
+
+  for (bool commit : {true, false}) {
+    SCOPED_TRACE(Format("Commit: $0", commit));
+    auto holder = std::make_shared<YBTransaction>(transaction_manager_.get_ptr(),
+                                                  SNAPSHOT_ISOLATION);
+    auto holder_session = CreateSession(holder);
+    ASSERT_OK(WriteRow(holder_session, 1, 1));
+
+    auto waiter = std::make_shared<YBTransaction>(transaction_manager_.get_ptr(),
+                                                  SNAPSHOT_ISOLATION);
+    auto waiter_session = CreateSession(waiter);
+    ASSERT_OK(waiter_session->SetFlushMode(YBSession::FlushMode::MANUAL_FLUSH));
+    ASSERT_OK(WriteRow(waiter_session, 1, 2));
+    std::promise<Status> flush_promise;
+    waiter_session->FlushAsync(MakeYBStatusFunctorCallback([&flush_promise](const Status& status) {
+      flush_promise.set_value(status);
+    }));
+    auto flush_future = flush_promise.get_future();
+    // Waiter neither fails nor aborts holder, until holder completes.
+    ASSERT_EQ(std::future_status::timeout, flush_future.wait_for(1s));
+
+    if (commit) {
+      ASSERT_OK(holder->CommitFuture().get());
+      // Holder committed after start of waiter.
+      ASSERT_NOK(flush_future.get());
+    } else {
+      holder->Abort();
+      ASSERT_OK(flush_future.get());
+      ASSERT_OK(waiter->CommitFuture().get());
+      VERIFY_ROW(CreateSession(), 1, 2);
+    }
+  }
+}
+
 TEST_F(QLTransactionTest, ResolveIntentsWriteReadUpdateRead) {
   google::FlagSaver flag_saver;
   DisableApplyingIntents();
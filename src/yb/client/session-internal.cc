@@ -40,6 +40,26 @@
 #include "yb/client/error_collector.h"
 #include "yb/client/yb_op.h"
 
+#include "yb/rpc/messenger.h"
+#include "yb/rpc/scheduler.h"
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(client_background_flush_max_ops, 100,
+             "Number of operations applied in AUTO_FLUSH_BACKGROUND mode, after which buffered "
+             "operations are flushed.");
+TAG_FLAG(client_background_flush_max_ops, advanced);
+
+DEFINE_int32(client_background_flush_max_bytes, 1024 * 1024,
+             "Size of requests applied in AUTO_FLUSH_BACKGROUND mode, after which buffered "
+             "operations are flushed. Non positive value disables this limit.");
+TAG_FLAG(client_background_flush_max_bytes, advanced);
+
+DEFINE_int32(client_background_flush_linger_usec, 1000,
+             "Max time the first operation applied in AUTO_FLUSH_BACKGROUND mode waits for other "
+             "operations to be batched with, before buffered operations are flushed.");
+TAG_FLAG(client_background_flush_linger_usec, advanced);
+
 MAKE_ENUM_LIMITS(yb::client::YBSession::FlushMode,
                  yb::client::YBSession::AUTO_FLUSH_SYNC,
                  yb::client::YBSession::MANUAL_FLUSH);
@@ -69,7 +89,10 @@ YBSessionData::~YBSessionData() {
 void YBSessionData::SetTransaction(YBTransactionPtr transaction) {
   transaction_ = std::move(transaction);
   internal::BatcherPtr old_batcher;
-  old_batcher.swap(batcher_);
+  {
+    std::lock_guard<std::mutex> lock(batcher_mutex_);
+    old_batcher.swap(batcher_);
+  }
   if (old_batcher) {
     LOG_IF(DFATAL, old_batcher->HasPendingOperations()) << "SetTransaction with non empty batcher";
     old_batcher->Abort(STATUS(Aborted, "Transaction changed"));
@@ -77,11 +100,33 @@ void YBSessionData::SetTransaction(YBTransactionPtr transaction) {
 }
 
 void YBSessionData::FlushFinished(internal::BatcherPtr batcher) {
-  std::lock_guard<simple_spinlock> l(lock_);
+  std::unique_lock<simple_spinlock> l(lock_);
   CHECK_EQ(flushed_batchers_.erase(batcher), 1);
+  if (flushed_batchers_.empty()) {
+    NotifyFlushWaiters(&l);
+  }
+}
+
+void YBSessionData::NotifyFlushWaiters(std::unique_lock<simple_spinlock>* lock) {
+  std::vector<YBStatusCallback*> waiters;
+  waiters.swap(flush_waiters_);
+  lock->unlock();
+  if (waiters.empty()) {
+    return;
+  }
+
+  // Errors of batchers flushed in the background are reported to the first Flush after them.
+  Status status;
+  if (error_collector_->CountErrors() > 0) {
+    status = STATUS(IOError, "Some errors occurred");
+  }
+  for (auto* waiter : waiters) {
+    waiter->Run(status);
+  }
 }
 
 void YBSessionData::Abort() {
+  std::lock_guard<std::mutex> lock(batcher_mutex_);
   if (batcher_ && batcher_->HasPendingOperations()) {
     batcher_->Abort(STATUS(Aborted, "Batch aborted"));
     batcher_.reset();
@@ -89,6 +134,7 @@ void YBSessionData::Abort() {
 }
 
 Status YBSessionData::Close(bool force) {
+  std::lock_guard<std::mutex> lock(batcher_mutex_);
   if (batcher_) {
     if (batcher_->HasPendingOperations() && !force) {
       return STATUS(IllegalState, "Could not close. There are pending operations.");
@@ -99,9 +145,29 @@ Status YBSessionData::Close(bool force) {
   return Status::OK();
 }
 
-void YBSessionData::FlushAsync(YBStatusCallback* callback) {
-  CHECK_NE(flush_mode_, YBSession::AUTO_FLUSH_BACKGROUND) << "TODO: handle flush background mode";
+void YBSessionData::FlushInBackground(internal::BatcherPtr batcher) {
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    flushed_batchers_.insert(batcher);
+  }
+  // The outcome of each operation is reported through its error collector, so flush status is
+  // checked only by the Flush calls waiting for this batcher.
+  batcher->FlushAsync(MakeYBStatusFunctorCallback([](const Status&) {}));
+}
 
+void YBSessionData::LingerExpired(const internal::BatcherPtr& batcher) {
+  {
+    std::lock_guard<std::mutex> lock(batcher_mutex_);
+    if (batcher_.get() != batcher.get()) {
+      // Batcher was already flushed, because of reaching some threshold or explicit Flush.
+      return;
+    }
+    batcher_.reset();
+  }
+  FlushInBackground(batcher);
+}
+
+void YBSessionData::FlushAsync(YBStatusCallback* callback) {
   // Swap in a new batcher to start building the next batch.
   // Save off the old batcher.
   //
@@ -110,7 +176,24 @@ void YBSessionData::FlushAsync(YBStatusCallback* callback) {
   // the batch fails "inline" on the same thread.
 
   internal::BatcherPtr old_batcher;
-  old_batcher.swap(batcher_);
+  {
+    std::lock_guard<std::mutex> lock(batcher_mutex_);
+    old_batcher.swap(batcher_);
+  }
+
+  if (flush_mode_ == YBSession::AUTO_FLUSH_BACKGROUND) {
+    // Wait for this batcher and all batchers that were flushed in the background before it.
+    if (old_batcher) {
+      FlushInBackground(old_batcher);
+    }
+    std::unique_lock<simple_spinlock> l(lock_);
+    flush_waiters_.push_back(callback);
+    if (flushed_batchers_.empty()) {
+      NotifyFlushWaiters(&l);
+    }
+    return;
+  }
+
   if (old_batcher) {
     {
       std::lock_guard<simple_spinlock> l(lock_);
@@ -123,17 +206,55 @@ void YBSessionData::FlushAsync(YBStatusCallback* callback) {
 }
 
 Status YBSessionData::Apply(std::shared_ptr<YBOperation> yb_op) {
-  if (!batcher_) {
-    batcher_.reset(new Batcher(client_.get(), error_collector_.get(), shared_from_this(),
-                               transaction_));
-    if (timeout_.Initialized()) {
-      batcher_->SetTimeout(timeout_);
+  const bool background = flush_mode_ == YBSession::AUTO_FLUSH_BACKGROUND;
+  // Size of the request is computed only when it is limited.
+  const size_t request_size =
+      background && FLAGS_client_background_flush_max_bytes > 0 ? yb_op->request_size() : 0;
+  internal::BatcherPtr full_batcher;
+  internal::BatcherPtr started_batcher;
+  {
+    std::lock_guard<std::mutex> lock(batcher_mutex_);
+    if (!batcher_) {
+      batcher_.reset(new Batcher(client_.get(), error_collector_.get(), shared_from_this(),
+                                 transaction_));
+      if (timeout_.Initialized()) {
+        batcher_->SetTimeout(timeout_);
+      }
+      batcher_ops_ = 0;
+      batcher_bytes_ = 0;
+    }
+    Status s = batcher_->Add(yb_op);
+    if (!PREDICT_FALSE(s.ok())) {
+      error_collector_->AddError(yb_op, s);
+      return s;
+    }
+
+    if (background) {
+      ++batcher_ops_;
+      batcher_bytes_ += request_size;
+      if (batcher_ops_ >= static_cast<size_t>(FLAGS_client_background_flush_max_ops) ||
+          (FLAGS_client_background_flush_max_bytes > 0 &&
+           batcher_bytes_ >= static_cast<size_t>(FLAGS_client_background_flush_max_bytes))) {
+        full_batcher.swap(batcher_);
+      } else if (batcher_ops_ == 1) {
+        started_batcher = batcher_;
+      }
     }
   }
-  Status s = batcher_->Add(yb_op);
-  if (!PREDICT_FALSE(s.ok())) {
-    error_collector_->AddError(yb_op, s);
-    return s;
+
+  if (full_batcher) {
+    FlushInBackground(std::move(full_batcher));
+  } else if (started_batcher) {
+    std::weak_ptr<YBSessionData> weak_self = shared_from_this();
+    client_->messenger()->scheduler().Schedule(
+        [weak_self, started_batcher](const Status& status) {
+          // Buffered operations are flushed by the next Flush, if the messenger is shutting down.
+          auto self = weak_self.lock();
+          if (status.ok() && self) {
+            self->LingerExpired(started_batcher);
+          }
+        },
+        std::chrono::microseconds(FLAGS_client_background_flush_linger_usec));
   }
 
   if (flush_mode_ == YBSession::AUTO_FLUSH_SYNC) {
@@ -151,10 +272,7 @@ Status YBSessionData::Flush() {
 }
 
 Status YBSessionData::SetFlushMode(YBSession::FlushMode mode) {
-  if (mode == YBSession::AUTO_FLUSH_BACKGROUND) {
-    return STATUS(NotSupported, "AUTO_FLUSH_BACKGROUND has not been implemented in the"
-        " c++ client (see KUDU-456).");
-  }
+  std::lock_guard<std::mutex> lock(batcher_mutex_);
   if (batcher_ && batcher_->HasPendingOperations()) {
     // TODO: there may be a more reasonable behavior here.
     return STATUS(IllegalState, "Cannot change flush mode when writes are buffered");
@@ -171,6 +289,7 @@ Status YBSessionData::SetFlushMode(YBSession::FlushMode mode) {
 void YBSessionData::SetTimeout(MonoDelta timeout) {
   CHECK_GE(timeout, MonoDelta::kZero);
   timeout_ = timeout;
+  std::lock_guard<std::mutex> lock(batcher_mutex_);
   if (batcher_) {
     batcher_->SetTimeout(timeout);
   }
@@ -178,12 +297,16 @@ void YBSessionData::SetTimeout(MonoDelta timeout) {
 
 int YBSessionData::CountBufferedOperations() const {
   CHECK_EQ(flush_mode_, YBSession::MANUAL_FLUSH);
+  std::lock_guard<std::mutex> lock(batcher_mutex_);
   return batcher_ ? batcher_->CountBufferedOperations() : 0;
 }
 
 bool YBSessionData::HasPendingOperations() const {
-  if (batcher_ && batcher_->HasPendingOperations()) {
-    return true;
+  {
+    std::lock_guard<std::mutex> lock(batcher_mutex_);
+    if (batcher_ && batcher_->HasPendingOperations()) {
+      return true;
+    }
   }
   std::lock_guard<simple_spinlock> l(lock_);
   for (const auto& b : flushed_batchers_) {
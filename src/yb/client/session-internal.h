@@ -32,9 +32,11 @@
 #ifndef YB_CLIENT_SESSION_INTERNAL_H_
 #define YB_CLIENT_SESSION_INTERNAL_H_
 
+#include <mutex>
 #include <unordered_set>
 
 #include "yb/client/async_rpc.h"
+#include "yb/util/atomic.h"
 #include "yb/util/locks.h"
 
 namespace yb {
@@ -68,6 +70,10 @@ class YBSessionData : public std::enable_shared_from_this<YBSessionData> {
   // Called by Batcher when a flush has finished.
   void FlushFinished(internal::BatcherPtr b);
 
+  // Invoked when the max linger time of batcher, that was started in AUTO_FLUSH_BACKGROUND mode,
+  // passes.
+  void LingerExpired(const internal::BatcherPtr& batcher);
+
   // Abort the unflushed or in-flight operations.
   void Abort();
 
@@ -95,21 +101,52 @@ class YBSessionData : public std::enable_shared_from_this<YBSessionData> {
     return async_rpc_metrics_;
   }
 
+  uint64_t read_after_hybrid_time() const {
+    return read_after_hybrid_time_.Load();
+  }
+
+  void SetReadAfterHybridTime(uint64_t hybrid_time) {
+    read_after_hybrid_time_.Store(hybrid_time);
+  }
+
+  // Called by Batcher when a write of the session has been done by the given hybrid time.
+  void UpdateReadAfterHybridTime(uint64_t hybrid_time) {
+    read_after_hybrid_time_.StoreMax(hybrid_time);
+  }
+
  private:
+  // Flushes batcher that was swapped out of batcher_ in AUTO_FLUSH_BACKGROUND mode.
+  void FlushInBackground(internal::BatcherPtr batcher);
+
+  // Invokes callbacks of FlushAsync calls in AUTO_FLUSH_BACKGROUND mode, when there are no
+  // flushed batchers anymore.
+  void NotifyFlushWaiters(std::unique_lock<simple_spinlock>* lock);
+
   // The client that this session is associated with.
   const std::shared_ptr<YBClient> client_;
 
   YBTransactionPtr transaction_;
 
-  // Lock protecting flushed_batchers_.
+  // Lock protecting flushed_batchers_ and flush_waiters_.
   mutable simple_spinlock lock_;
 
+  // Lock protecting batcher_ and the size of its buffered operations.
+  mutable std::mutex batcher_mutex_;
+
   // Buffer for errors.
   scoped_refptr<internal::ErrorCollector> error_collector_;
 
   // The current batcher being prepared.
   scoped_refptr<internal::Batcher> batcher_;
 
+  // Number and size of operations added to batcher_ in AUTO_FLUSH_BACKGROUND mode.
+  size_t batcher_ops_ = 0;
+  size_t batcher_bytes_ = 0;
+
+  // Callbacks of FlushAsync calls in AUTO_FLUSH_BACKGROUND mode, that wait until all flushed
+  // batchers are finished.
+  std::vector<YBStatusCallback*> flush_waiters_;
+
   // Any batchers which have been flushed but not yet finished.
   //
   // Upon a batch finishing, it will call FlushFinished(), which removes the batcher from
@@ -126,6 +163,9 @@ class YBSessionData : public std::enable_shared_from_this<YBSessionData> {
   MonoDelta timeout_;
 
   internal::AsyncRpcMetricsPtr async_rpc_metrics_;
+
+  // See YBSession::GetReadAfterHybridTime.
+  AtomicInt<uint64_t> read_after_hybrid_time_{YBClient::kNoHybridTime};
 };
 
 }  // namespace client
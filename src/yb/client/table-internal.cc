@@ -76,14 +76,18 @@ YBTable::Data::Data(
     YBTableName name,
     string id,
     const YBSchema& schema,
-    PartitionSchema partition_schema)
+    PartitionSchema partition_schema,
+    std::vector<YBIndexInfo> indexes,
+    string indexed_table_id)
   : client_(std::move(client)),
     name_(std::move(name)),
     // The table type is set after the table is opened.
     table_type_(YBTableType::UNKNOWN_TABLE_TYPE),
     id_(std::move(id)),
     schema_(schema),
-    partition_schema_(std::move(partition_schema)) {
+    partition_schema_(std::move(partition_schema)),
+    indexes_(std::move(indexes)),
+    indexed_table_id_(std::move(indexed_table_id)) {
 }
 
 YBTable::Data::~Data() {
@@ -47,7 +47,9 @@ class YBTable::Data {
        YBTableName name,
        std::string table_id,
        const YBSchema& schema,
-       PartitionSchema partition_schema);
+       PartitionSchema partition_schema,
+       std::vector<YBIndexInfo> indexes,
+       std::string indexed_table_id);
   ~Data();
 
   CHECKED_STATUS Open();
@@ -63,6 +65,8 @@ class YBTable::Data {
   // a new YBTable instance (which would simplify the object lifecycle a little?)
   const YBSchema schema_;
   const PartitionSchema partition_schema_;
+  const std::vector<YBIndexInfo> indexes_;
+  const std::string indexed_table_id_;
 
  private:
   DISALLOW_COPY_AND_ASSIGN(Data);
@@ -43,10 +43,15 @@ TabletInvoker::TabletInvoker(bool consistent_prefix,
         consistent_prefix_(consistent_prefix) {}
 
 void TabletInvoker::SelectTabletServerWithConsistentPrefix() {
+  // Skip the replicas that rejected the read, e.g. because they are too stale.
+  std::set<std::string> blacklist;
+  for (const auto* follower : followers_) {
+    blacklist.insert(follower->permanent_uuid());
+  }
   std::vector<RemoteTabletServer*> candidates;
   current_ts_ = client_->data_->SelectTServer(tablet_.get(),
-                                              YBClient::ReplicaSelection::CLOSEST_REPLICA, {},
-                                              &candidates);
+                                              YBClient::ReplicaSelection::CLOSEST_REPLICA,
+                                              blacklist, &candidates);
   VLOG(1) << "Using tserver: " << yb::ToString(current_ts_);
 }
 
@@ -216,19 +221,25 @@ bool TabletInvoker::Done(Status* status) {
   if (status->IsIllegalState() || status->IsServiceUnavailable() || status->IsAborted() ||
       status->IsLeaderNotReadyToServe() || status->IsLeaderHasNoLease() ||
       TabletNotFoundOnTServer(rpc_->response_error(), *status)) {
+    const auto error_code = ErrorCode(rpc_->response_error());
+    const bool throttled = error_code == tserver::TabletServerErrorPB::WRITE_THROTTLED ||
+                           error_code == tserver::TabletServerErrorPB::QUOTA_EXCEEDED;
     const bool leader_is_not_ready =
-        ErrorCode(rpc_->response_error()) ==
-            tserver::TabletServerErrorPB::LEADER_NOT_READY_TO_SERVE ||
+        error_code == tserver::TabletServerErrorPB::LEADER_NOT_READY_TO_SERVE ||
         status->IsLeaderNotReadyToServe();
 
-    // If the leader just is not ready - let's retry the same tserver.
+    // If the leader just is not ready or throttles requests - let's retry the same tserver.
     // Else the leader became a follower and must be reset on retry.
-    if (!leader_is_not_ready) {
+    if (!leader_is_not_ready && !throttled) {
       followers_.insert(current_ts_);
     }
 
     if (status->IsIllegalState() || TabletNotFoundOnTServer(rpc_->response_error(), *status)) {
       FailToNewReplica(*status);
+    } else if (throttled) {
+      retrier_->DelayedRetry(
+          command_, *status,
+          MonoDelta::FromMilliseconds(rpc_->response_error()->retry_after_ms()));
     } else {
       retrier_->DelayedRetry(command_, *status);
     }
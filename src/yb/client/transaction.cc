@@ -15,6 +15,7 @@
 
 #include "yb/client/transaction.h"
 
+#include <algorithm>
 #include <unordered_set>
 #include "yb/rpc/rpc.h"
 #include "yb/rpc/scheduler.h"
@@ -26,6 +27,7 @@
 #include "yb/common/transaction.h"
 
 #include "yb/client/async_rpc.h"
+#include "yb/client/callbacks.h"
 #include "yb/client/client.h"
 #include "yb/client/in_flight_op.h"
 #include "yb/client/meta_cache.h"
@@ -93,30 +95,71 @@ class YBTransaction::Impl final {
     VLOG_WITH_PREFIX(1) << "Prepare";
 
     bool has_tablets_without_parameters = false;
+    bool single_shard = false;
+    std::vector<TabletId> parallel_commit_tablets;
     {
       std::lock_guard<std::mutex> lock(mutex_);
-      if (!ready_) {
-        RequestStatusTablet();
-        waiters_.push_back(std::move(waiter));
-        VLOG_WITH_PREFIX(1) << "Prepare, rejected";
+      if (single_shard_state_ == SingleShardState::kCandidate) {
+        single_shard = IsSingleShard(ops);
+        single_shard_state_ = single_shard ? SingleShardState::kSingleShard
+                                           : SingleShardState::kNone;
+        VLOG_WITH_PREFIX(1) << "Prepare, single shard: " << single_shard;
+      } else if (single_shard_state_ == SingleShardState::kSingleShard) {
+        // The single shard write commits the transaction, so it cannot have other operations.
+        // Waiter should not be invoked from Prepare, so it is notified asynchronously.
+        manager_->client()->messenger()->scheduler().Schedule(
+            [waiter = std::move(waiter)](const Status&) {
+              waiter(STATUS(IllegalState, "Transaction committed by single shard write"));
+            },
+            std::chrono::steady_clock::duration::zero());
+        VLOG_WITH_PREFIX(1) << "Prepare, rejected after single shard write";
         return false;
       }
 
-      for (const auto& op : ops) {
-        VLOG_WITH_PREFIX(1) << "Prepare, op: " << op->ToString();
-        DCHECK(op->tablet != nullptr);
-        auto it = tablets_.find(op->tablet->tablet_id());
-        if (it == tablets_.end()) {
-          tablets_.emplace(op->tablet->tablet_id(), TabletState());
-          has_tablets_without_parameters = true;
-        } else if (!has_tablets_without_parameters) {
-          has_tablets_without_parameters = !it->second.has_parameters;
+      if (!single_shard) {
+        if (!ready_) {
+          RequestStatusTablet();
+          waiters_.push_back(std::move(waiter));
+          VLOG_WITH_PREFIX(1) << "Prepare, rejected";
+          return false;
+        }
+
+        for (const auto& op : ops) {
+          VLOG_WITH_PREFIX(1) << "Prepare, op: " << op->ToString();
+          DCHECK(op->tablet != nullptr);
+          auto it = tablets_.find(op->tablet->tablet_id());
+          if (it == tablets_.end()) {
+            tablets_.emplace(op->tablet->tablet_id(), TabletState());
+            has_tablets_without_parameters = true;
+          } else if (!has_tablets_without_parameters) {
+            has_tablets_without_parameters = !it->second.has_parameters;
+          }
+        }
+
+        if (parallel_commit_state_ == ParallelCommitState::kArmed) {
+          parallel_commit_tablets = WriteTablets(ops);
+          if (parallel_commit_tablets.empty()) {
+            // Nothing to wait for, so the transaction is committed after the flush.
+            parallel_commit_state_ = ParallelCommitState::kNone;
+          } else {
+            parallel_commit_state_ = ParallelCommitState::kSent;
+            complete_.store(true, std::memory_order_release);
+          }
         }
       }
     }
 
+    if (!parallel_commit_tablets.empty()) {
+      VLOG_WITH_PREFIX(1) << "Prepare, parallel commit: " << yb::ToString(parallel_commit_tablets);
+      SendCommit(parallel_commit_tablets, transaction_->shared_from_this());
+    }
+
     prepare_data->propagated_ht = manager_->Now();
-    if (has_tablets_without_parameters) {
+    prepare_data->single_shard = single_shard;
+    prepare_data->parallel_commit = !parallel_commit_tablets.empty();
+    // Tablet applying single shard write does not know about this transaction, so it should
+    // receive full metadata.
+    if (single_shard || has_tablets_without_parameters) {
       prepare_data->metadata = metadata_;
     } else {
       prepare_data->metadata.transaction_id = metadata_.transaction_id;
@@ -134,6 +177,10 @@ class YBTransaction::Impl final {
     if (status.ok()) {
       manager_->UpdateClock(propagated_hybrid_time);
       std::lock_guard<std::mutex> lock(mutex_);
+      // Tablets of single shard write are not tracked, since nothing has to be applied there.
+      if (single_shard_state_ == SingleShardState::kSingleShard) {
+        return;
+      }
       TabletStates::iterator it = tablets_.end();
       for (const auto& op : ops) {
         if (op->yb_op->succeeded()) {
@@ -177,6 +224,29 @@ class YBTransaction::Impl final {
     DoCommit(Status::OK(), transaction);
   }
 
+  void FlushAndCommit(YBSession* session, CommitCallback callback) {
+    auto transaction = transaction_->shared_from_this();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      // Single shard write is possible only when nothing was flushed before, otherwise other
+      // tablets could already have intents of this transaction.
+      if (single_shard_state_ == SingleShardState::kNone && !requested_status_tablet_ &&
+          tablets_.empty() && !complete_.load(std::memory_order_acquire)) {
+        single_shard_state_ = SingleShardState::kCandidate;
+      } else if (single_shard_state_ == SingleShardState::kNone && ready_ &&
+                 parallel_commit_state_ == ParallelCommitState::kNone &&
+                 !complete_.load(std::memory_order_acquire)) {
+        // Status tablet is already known, so commit could be sent together with the writes.
+        parallel_commit_state_ = ParallelCommitState::kArmed;
+        commit_callback_ = callback;
+      }
+    }
+    session->FlushAsync(MakeYBStatusFunctorCallback(
+        [this, transaction, callback](const Status& status) {
+          FlushForCommitDone(status, callback);
+        }));
+  }
+
   void Abort() {
     auto transaction = transaction_->shared_from_this();
     {
@@ -242,6 +312,78 @@ class YBTransaction::Impl final {
   }
 
  private:
+  // Returns true if ops contain writes and all of them belong to the same tablet.
+  static bool IsSingleShard(const std::unordered_set<internal::InFlightOpPtr>& ops) {
+    const std::string* tablet_id = nullptr;
+    bool has_writes = false;
+    for (const auto& op : ops) {
+      DCHECK(op->tablet != nullptr);
+      if (tablet_id == nullptr) {
+        tablet_id = &op->tablet->tablet_id();
+      } else if (*tablet_id != op->tablet->tablet_id()) {
+        return false;
+      }
+      has_writes = has_writes || !op->yb_op->read_only();
+    }
+    return has_writes;
+  }
+
+  // Returns tablets of write operations from ops.
+  static std::vector<TabletId> WriteTablets(
+      const std::unordered_set<internal::InFlightOpPtr>& ops) {
+    std::vector<TabletId> result;
+    for (const auto& op : ops) {
+      if (!op->yb_op->read_only()) {
+        const auto& tablet_id = op->tablet->tablet_id();
+        if (std::find(result.begin(), result.end(), tablet_id) == result.end()) {
+          result.push_back(tablet_id);
+        }
+      }
+    }
+    return result;
+  }
+
+  void FlushForCommitDone(const Status& status, const CommitCallback& callback) {
+    VLOG_WITH_PREFIX(1) << "Flush for commit done: " << status;
+
+    bool single_shard = false;
+    auto parallel_commit_state = ParallelCommitState::kNone;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::swap(parallel_commit_state, parallel_commit_state_);
+      // Still being a candidate means that nothing was flushed, so there is nothing to commit.
+      if (single_shard_state_ != SingleShardState::kNone) {
+        single_shard_state_ = SingleShardState::kSingleShard;
+        complete_.store(true, std::memory_order_release);
+        single_shard = true;
+      }
+    }
+    if (single_shard) {
+      // Single shard write is atomic, so its status is the status of the commit.
+      callback(status);
+      return;
+    }
+
+    if (parallel_commit_state == ParallelCommitState::kSent) {
+      // Result of the commit is passed to commit_callback_ by CommitDone. Failed writes don't
+      // report written intents, so the commit would wait for them until the transaction expires,
+      // abort it right away instead.
+      if (!status.ok()) {
+        DoAbort(Status::OK(), transaction_->shared_from_this());
+      }
+      return;
+    }
+
+    if (!status.ok()) {
+      if (!complete_.load(std::memory_order_acquire)) {
+        Abort();
+      }
+      callback(status);
+      return;
+    }
+    Commit(callback);
+  }
+
   void DoCommit(const Status& status, const YBTransactionPtr& transaction) {
     VLOG_WITH_PREFIX(1) << Format("Commit, tablets: $0, status: $1", tablets_, status);
 
@@ -258,6 +400,13 @@ class YBTransaction::Impl final {
       return;
     }
 
+    SendCommit({} /* pending_tablets */, transaction);
+  }
+
+  // Sends commit request to the status tablet. When pending_tablets is not empty, the status
+  // tablet waits until those tablets report that the last intents of this transaction are written.
+  void SendCommit(const std::vector<TabletId>& pending_tablets,
+                  const YBTransactionPtr& transaction) {
     tserver::UpdateTransactionRequestPB req;
     req.set_tablet_id(status_tablet_->tablet_id());
     req.set_propagated_hybrid_time(manager_->Now().ToUint64());
@@ -267,6 +416,9 @@ class YBTransaction::Impl final {
     for (const auto& tablet : tablets_) {
       state.add_tablets(tablet.first);
     }
+    for (const auto& tablet : pending_tablets) {
+      state.add_pending_tablets(tablet);
+    }
 
     manager_->rpcs().RegisterAndStart(
         UpdateTransaction(
@@ -365,12 +517,6 @@ class YBTransaction::Impl final {
       return;
     }
 
-    if (status != TransactionStatus::CREATED &&
-        GetAtomicFlag(&FLAGS_transaction_disable_heartbeat_in_tests)) {
-      HeartbeatDone(Status::OK(), HybridTime::kInvalidHybridTime, status, transaction);
-      return;
-    }
-
     tserver::UpdateTransactionRequestPB req;
     req.set_tablet_id(status_tablet_->tablet_id());
     req.set_propagated_hybrid_time(manager_->Now().ToUint64());
@@ -407,10 +553,24 @@ class YBTransaction::Impl final {
           waiter(Status::OK());
         }
       }
+      // Further heartbeats are sent by transaction manager, together with heartbeats of other
+      // transactions of the same status tablet.
       std::weak_ptr<YBTransaction> weak_transaction(transaction);
-      manager_->client()->messenger()->scheduler().Schedule(
-          std::bind(&Impl::SendHeartbeat, this, TransactionStatus::PENDING, weak_transaction),
-          std::chrono::microseconds(FLAGS_transaction_heartbeat_usec));
+      manager_->RegisterHeartbeat(
+          status_tablet_,
+          metadata_.transaction_id,
+          TransactionHeartbeatCallbacks{
+              [this, weak_transaction] {
+                auto transaction = weak_transaction.lock();
+                return transaction && !complete_.load(std::memory_order_acquire);
+              },
+              [this, weak_transaction](const Status& status) {
+                auto transaction = weak_transaction.lock();
+                if (transaction) {
+                  LOG_WITH_PREFIX(WARNING) << "Heartbeat failed: " << status;
+                  SetError(status);
+                }
+              }});
     } else {
       LOG_WITH_PREFIX(WARNING) << "Send heartbeat failed: " << status;
       if (status.IsExpired()) {
@@ -445,6 +605,28 @@ class YBTransaction::Impl final {
   internal::RemoteTabletPtr status_tablet_;
   internal::RemoteTabletPtr status_tablet_holder_;
   std::atomic<bool> complete_{false};
+
+  enum class SingleShardState {
+    // Transaction is committed through the status tablet.
+    kNone,
+    // FlushAndCommit was invoked, and its flush could be sent as a single shard write.
+    kCandidate,
+    // Flush was sent as a single shard write, that also commits the transaction.
+    kSingleShard,
+  };
+
+  SingleShardState single_shard_state_ = SingleShardState::kNone;
+
+  enum class ParallelCommitState {
+    // Commit is sent after all writes are flushed.
+    kNone,
+    // FlushAndCommit was invoked, and commit could be sent together with its flush.
+    kArmed,
+    // Commit was sent together with the flush.
+    kSent,
+  };
+
+  ParallelCommitState parallel_commit_state_ = ParallelCommitState::kNone;
   // Transaction is successfully initialized and ready to process intents.
   bool ready_ = false;
   CommitCallback commit_callback_;
@@ -509,6 +691,16 @@ std::future<Status> YBTransaction::CommitFuture() {
   return MakeFuture<Status>([this](auto callback) { impl_->Commit(callback); });
 }
 
+void YBTransaction::FlushAndCommit(YBSession* session, CommitCallback callback) {
+  impl_->FlushAndCommit(session, std::move(callback));
+}
+
+std::future<Status> YBTransaction::FlushAndCommitFuture(YBSession* session) {
+  return MakeFuture<Status>([this, session](auto callback) {
+    impl_->FlushAndCommit(session, callback);
+  });
+}
+
 void YBTransaction::Abort() {
   impl_->Abort();
 }
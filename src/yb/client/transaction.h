@@ -53,6 +53,14 @@ struct TransactionPrepareData {
 
   // Local limits for separate tablets, pointed object alive while transaction is alive.
   const std::unordered_map<TabletId, HybridTime>* local_limits;
+
+  // Those operations are all the writes of the transaction and belong to the same tablet, so they
+  // are applied by that tablet as a single write and the transaction is committed with them.
+  bool single_shard = false;
+
+  // Those operations are the last writes of the transaction, that is committed in parallel with
+  // them. So tablets should notify the status tablet when their intents are written.
+  bool parallel_commit = false;
 };
 
 // YBTransaction is a representation of a single transaction.
@@ -80,6 +88,20 @@ class YBTransaction : public std::enable_shared_from_this<YBTransaction> {
   // Utility function for Commit.
   std::future<Status> CommitFuture();
 
+  // Flushes session, that should be bound to this transaction and should not have other flushes
+  // in progress, and commits this transaction.
+  // When nothing was flushed in context of this transaction before and all flushed operations
+  // belong to the same tablet, they are written to that tablet by a single atomic write, without
+  // registering the transaction at a status tablet and without writing intents.
+  // When the transaction was already registered at its status tablet, the commit request is sent
+  // in parallel with the flushed writes, and the status tablet commits the transaction once all
+  // tablets that receive those writes report that their intents are written.
+  // Otherwise it is the same as flushing the session and calling Commit.
+  void FlushAndCommit(YBSession* session, CommitCallback callback);
+
+  // Utility function for FlushAndCommit.
+  std::future<Status> FlushAndCommitFuture(YBSession* session);
+
   // Aborts this transaction.
   void Abort();
 
@@ -15,18 +15,35 @@
 
 #include "yb/client/transaction_manager.h"
 
+#include <condition_variable>
+#include <unordered_map>
+
+#include "yb/master/master.pb.h"
+
+#include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc.h"
+#include "yb/rpc/scheduler.h"
 #include "yb/rpc/thread_pool.h"
 #include "yb/rpc/tasks_pool.h"
 
+#include "yb/tserver/tserver_service.pb.h"
+
+#include "yb/util/atomic.h"
 #include "yb/util/random_util.h"
 
 #include "yb/client/client.h"
+#include "yb/client/meta_cache.h"
+#include "yb/client/transaction_rpc.h"
 
 DEFINE_uint64(transaction_table_default_num_tablets, 24,
               "Automatically create transaction table with specified number of tablets if missing. "
               "0 to disable.");
 
+DECLARE_uint64(transaction_heartbeat_usec);
+DECLARE_bool(transaction_disable_heartbeat_in_tests);
+
+using namespace std::placeholders;
+
 namespace yb {
 namespace client {
 
@@ -51,10 +68,11 @@ class PickStatusTabletTask {
     }
 
     // TODO(dtxn) async
-    // TODO(dtxn) prefer tablets with leader on the local node
     // TODO(dtxn) prevent deletion of picked tablet
     std::vector<std::string> tablets;
-    status = client_->GetTablets(kTransactionTableName, 0, &tablets, /* ranges */ nullptr);
+    std::vector<master::TabletLocationsPB> locations;
+    status = client_->GetTablets(
+        kTransactionTableName, 0, &tablets, /* ranges */ nullptr, &locations);
     if (!status.ok()) {
       callback_(status);
       return;
@@ -63,7 +81,10 @@ class PickStatusTabletTask {
       callback_(STATUS_FORMAT(IllegalState, "No tablets in table $0", kTransactionTableName));
       return;
     }
-    callback_(RandomElement(tablets));
+    // Prefer tablets led from the region of this client, so that the status of transactions
+    // started in a region is written and read without cross region round trips.
+    auto local_tablets = LocalLeaderTablets(locations);
+    callback_(RandomElement(local_tablets.empty() ? tablets : local_tablets));
   }
 
   void Done(const Status& status) {
@@ -75,6 +96,29 @@ class PickStatusTabletTask {
   }
 
  private:
+  std::vector<std::string> LocalLeaderTablets(
+      const std::vector<master::TabletLocationsPB>& locations) {
+    std::vector<std::string> result;
+    const auto& cloud_info = client_->cloud_info();
+    if (cloud_info.placement_region().empty()) {
+      return result;
+    }
+    for (const auto& tablet : locations) {
+      for (const auto& replica : tablet.replicas()) {
+        if (replica.role() != consensus::RaftPeerPB::LEADER) {
+          continue;
+        }
+        const auto& leader_cloud_info = replica.ts_info().cloud_info();
+        if (leader_cloud_info.placement_cloud() == cloud_info.placement_cloud() &&
+            leader_cloud_info.placement_region() == cloud_info.placement_region()) {
+          result.push_back(tablet.tablet_id());
+        }
+        break;
+      }
+    }
+    return result;
+  }
+
   CHECKED_STATUS EnsureStatusTableExists() {
     if (status_table_exists_->load(std::memory_order_acquire)) {
       return Status::OK();
@@ -128,6 +172,20 @@ class TransactionManager::Impl {
         thread_pool_("TransactionManager", kQueueLimit, kMaxWorkers),
         tasks_pool_(kQueueLimit) {}
 
+  ~Impl() {
+    {
+      std::unique_lock<std::mutex> lock(heartbeat_mutex_);
+      closing_ = true;
+      if (heartbeat_task_id_ != rpc::kUninitializedScheduledTaskId) {
+        client_->messenger()->scheduler().Abort(heartbeat_task_id_);
+      }
+      heartbeat_cond_.wait(lock, [this] {
+        return heartbeat_task_id_ == rpc::kUninitializedScheduledTaskId;
+      });
+    }
+    rpcs_.Shutdown();
+  }
+
   void PickStatusTablet(PickStatusTabletCallback callback) {
     if (!tasks_pool_.Enqueue(&thread_pool_, client_, &status_table_exists_, std::move(callback))) {
       callback(STATUS_FORMAT(ServiceUnavailable, "Tasks overflow, exists: $0", tasks_pool_.size()));
@@ -150,7 +208,142 @@ class TransactionManager::Impl {
     clock_->Update(time);
   }
 
+  void RegisterHeartbeat(const internal::RemoteTabletPtr& status_tablet,
+                         const TransactionId& id,
+                         TransactionHeartbeatCallbacks callbacks) {
+    std::lock_guard<std::mutex> lock(heartbeat_mutex_);
+    if (closing_) {
+      return;
+    }
+    auto& tablet = heartbeat_tablets_[status_tablet->tablet_id()];
+    if (!tablet.tablet) {
+      tablet.tablet = status_tablet;
+    }
+    tablet.transactions.emplace(id, std::move(callbacks));
+    if (heartbeat_task_id_ == rpc::kUninitializedScheduledTaskId) {
+      ScheduleHeartbeats();
+    }
+  }
+
  private:
+  struct HeartbeatTablet {
+    internal::RemoteTabletPtr tablet;
+    std::unordered_map<TransactionId, TransactionHeartbeatCallbacks, TransactionIdHash>
+        transactions;
+    // Whether heartbeats RPC to this tablet is in flight. Next heartbeats are not sent until it
+    // completes.
+    bool in_flight = false;
+  };
+
+  void ScheduleHeartbeats() {
+    heartbeat_task_id_ = client_->messenger()->scheduler().Schedule(
+        std::bind(&Impl::SendHeartbeats, this, _1),
+        std::chrono::microseconds(FLAGS_transaction_heartbeat_usec));
+  }
+
+  void SendHeartbeats(const Status& status) {
+    std::vector<rpc::Rpcs::Handle> handles;
+    {
+      std::lock_guard<std::mutex> lock(heartbeat_mutex_);
+      heartbeat_task_id_ = rpc::kUninitializedScheduledTaskId;
+      if (!status.ok() || closing_) {
+        heartbeat_cond_.notify_all();
+        return;
+      }
+      const bool disabled = GetAtomicFlag(&FLAGS_transaction_disable_heartbeat_in_tests);
+      for (auto it = heartbeat_tablets_.begin(); it != heartbeat_tablets_.end();) {
+        auto& tablet = it->second;
+        for (auto transaction = tablet.transactions.begin();
+             transaction != tablet.transactions.end();) {
+          if (transaction->second.active()) {
+            ++transaction;
+          } else {
+            transaction = tablet.transactions.erase(transaction);
+          }
+        }
+        if (tablet.transactions.empty() && !tablet.in_flight) {
+          it = heartbeat_tablets_.erase(it);
+          continue;
+        }
+        if (!disabled && !tablet.in_flight && !tablet.transactions.empty()) {
+          auto handle = PrepareHeartbeats(it->first, &tablet);
+          if (handle != rpcs_.InvalidHandle()) {
+            handles.push_back(handle);
+          }
+        }
+        ++it;
+      }
+      if (!heartbeat_tablets_.empty()) {
+        ScheduleHeartbeats();
+      }
+    }
+    for (const auto& handle : handles) {
+      (**handle).SendRpc();
+    }
+  }
+
+  rpc::Rpcs::Handle PrepareHeartbeats(const TabletId& tablet_id, HeartbeatTablet* tablet) {
+    auto handle = rpcs_.Prepare();
+    if (handle == rpcs_.InvalidHandle()) {
+      return handle;
+    }
+    tserver::UpdateTransactionRequestPB req;
+    req.set_tablet_id(tablet_id);
+    req.set_propagated_hybrid_time(Now().ToUint64());
+    for (const auto& transaction : tablet->transactions) {
+      req.add_heartbeat_transaction_ids(transaction.first.begin(), transaction.first.size());
+    }
+    tablet->in_flight = true;
+    *handle = TransactionHeartbeats(
+        TransactionRpcDeadline(),
+        tablet->tablet.get(),
+        client_.get(),
+        &req,
+        std::bind(&Impl::HeartbeatsDone, this, tablet_id, handle, _1, _2));
+    return handle;
+  }
+
+  void HeartbeatsDone(const TabletId& tablet_id,
+                      rpc::Rpcs::Handle handle,
+                      const Status& status,
+                      const tserver::UpdateTransactionResponsePB& response) {
+    rpcs_.Unregister(handle);
+    if (response.has_propagated_hybrid_time()) {
+      UpdateClock(HybridTime(response.propagated_hybrid_time()));
+    }
+
+    std::vector<TransactionHeartbeatCallbacks> expired;
+    {
+      std::lock_guard<std::mutex> lock(heartbeat_mutex_);
+      auto it = heartbeat_tablets_.find(tablet_id);
+      if (it == heartbeat_tablets_.end()) {
+        return;
+      }
+      it->second.in_flight = false;
+      if (!status.ok()) {
+        // Heartbeats are just sent again on the next round.
+        LOG(WARNING) << "Send heartbeats to " << tablet_id << " failed: " << status;
+        return;
+      }
+      auto& transactions = it->second.transactions;
+      for (const auto& transaction_id : response.expired_transaction_ids()) {
+        auto id = FullyDecodeTransactionId(transaction_id);
+        if (!id.ok()) {
+          LOG(DFATAL) << "Bad expired transaction id: " << id.status();
+          continue;
+        }
+        auto transaction = transactions.find(*id);
+        if (transaction != transactions.end()) {
+          expired.push_back(std::move(transaction->second));
+          transactions.erase(transaction);
+        }
+      }
+    }
+    for (const auto& callbacks : expired) {
+      callbacks.expired(STATUS(Expired, "Transaction expired"));
+    }
+  }
+
   YBClientPtr client_;
   scoped_refptr<ClockBase> clock_;
   std::atomic<bool> status_table_exists_{false};
@@ -158,6 +351,12 @@ class TransactionManager::Impl {
   yb::rpc::ThreadPool thread_pool_; // TODO async operations instead of pool
   yb::rpc::TasksPool<PickStatusTabletTask> tasks_pool_;
   yb::rpc::Rpcs rpcs_;
+
+  std::mutex heartbeat_mutex_;
+  std::condition_variable heartbeat_cond_;
+  bool closing_ = false;
+  rpc::ScheduledTaskId heartbeat_task_id_ = rpc::kUninitializedScheduledTaskId;
+  std::unordered_map<TabletId, HeartbeatTablet> heartbeat_tablets_;
 };
 
 TransactionManager::TransactionManager(
@@ -171,6 +370,12 @@ void TransactionManager::PickStatusTablet(PickStatusTabletCallback callback) {
   impl_->PickStatusTablet(std::move(callback));
 }
 
+void TransactionManager::RegisterHeartbeat(const internal::RemoteTabletPtr& status_tablet,
+                                           const TransactionId& id,
+                                           TransactionHeartbeatCallbacks callbacks) {
+  impl_->RegisterHeartbeat(status_tablet, id, std::move(callbacks));
+}
+
 const YBClientPtr& TransactionManager::client() const {
   return impl_->client();
 }
@@ -23,6 +23,7 @@
 
 #include "yb/common/clock.h"
 #include "yb/common/hybrid_time.h"
+#include "yb/common/transaction.h"
 
 #include "yb/rpc/rpc_fwd.h"
 
@@ -33,6 +34,16 @@ namespace client {
 
 typedef std::function<void(const Result<std::string>&)> PickStatusTabletCallback;
 
+// Used by TransactionManager to send heartbeats of a transaction.
+struct TransactionHeartbeatCallbacks {
+  // Returns false when transaction does not need heartbeats anymore, i.e. it is completed
+  // or destroyed.
+  std::function<bool()> active;
+
+  // Invoked when status tablet reports that transaction is expired or aborted.
+  std::function<void(const Status&)> expired;
+};
+
 // TransactionManager manages multiple transactions. It lives at the YQL engine layer.
 class TransactionManager {
  public:
@@ -41,6 +52,13 @@ class TransactionManager {
 
   void PickStatusTablet(PickStatusTabletCallback callback);
 
+  // Starts sending heartbeats of transaction id, that was created at status_tablet, every
+  // transaction_heartbeat_usec until callbacks.active returns false.
+  // Heartbeats of all transactions of the same status tablet are sent by a single RPC.
+  void RegisterHeartbeat(const internal::RemoteTabletPtr& status_tablet,
+                         const TransactionId& id,
+                         TransactionHeartbeatCallbacks callbacks);
+
   rpc::Rpcs& rpcs();
   const YBClientPtr& client() const;
 
@@ -152,6 +152,29 @@ struct UpdateTransactionTraits {
 
 constexpr const char* UpdateTransactionTraits::kName;
 
+struct TransactionHeartbeatsTraits {
+  static constexpr const char* kName = "TransactionHeartbeats";
+
+  typedef tserver::UpdateTransactionRequestPB Request;
+  typedef tserver::UpdateTransactionResponsePB Response;
+  typedef TransactionHeartbeatsCallback Callback;
+
+  static void CallCallback(
+      const Callback& callback, const Status& status, const Response& response) {
+    callback(status, response);
+  }
+
+  static void InvokeAsync(tserver::TabletServerServiceProxy* proxy,
+                          const Request& request,
+                          Response* response,
+                          rpc::RpcController* controller,
+                          rpc::ResponseCallback callback) {
+    proxy->UpdateTransactionAsync(request, response, controller, std::move(callback));
+  }
+};
+
+constexpr const char* TransactionHeartbeatsTraits::kName;
+
 struct GetTransactionStatusTraits {
   static constexpr const char* kName = "GetTransactionStatus";
 
@@ -210,6 +233,16 @@ rpc::RpcCommandPtr UpdateTransaction(
       deadline, tablet, client, req, std::move(callback));
 }
 
+rpc::RpcCommandPtr TransactionHeartbeats(
+    const MonoTime& deadline,
+    internal::RemoteTablet* tablet,
+    YBClient* client,
+    tserver::UpdateTransactionRequestPB* req,
+    TransactionHeartbeatsCallback callback) {
+  return std::make_shared<TransactionRpc<TransactionHeartbeatsTraits>>(
+      deadline, tablet, client, req, std::move(callback));
+}
+
 rpc::RpcCommandPtr GetTransactionStatus(
     const MonoTime& deadline,
     internal::RemoteTablet* tablet,
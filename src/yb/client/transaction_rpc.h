@@ -36,6 +36,7 @@ class AbortTransactionResponsePB;
 class GetTransactionStatusRequestPB;
 class GetTransactionStatusResponsePB;
 class UpdateTransactionRequestPB;
+class UpdateTransactionResponsePB;
 
 }
 
@@ -58,6 +59,17 @@ MUST_USE_RESULT rpc::RpcCommandPtr UpdateTransaction(
     tserver::UpdateTransactionRequestPB* req,
     UpdateTransactionCallback callback);
 
+typedef std::function<void(const Status&, const tserver::UpdateTransactionResponsePB&)>
+    TransactionHeartbeatsCallback;
+
+// Sends heartbeats of several transactions, listed in req->heartbeat_transaction_ids.
+MUST_USE_RESULT rpc::RpcCommandPtr TransactionHeartbeats(
+    const MonoTime& deadline,
+    internal::RemoteTablet* tablet,
+    YBClient* client,
+    tserver::UpdateTransactionRequestPB* req,
+    TransactionHeartbeatsCallback callback);
+
 typedef std::function<void(const Status&, const tserver::GetTransactionStatusResponsePB&)>
     GetTransactionStatusCallback;
 
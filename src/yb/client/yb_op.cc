@@ -90,6 +90,10 @@ std::string YBRedisWriteOp::ToString() const {
   return "REDIS_WRITE " + redis_write_request_->key_value().key();
 }
 
+size_t YBRedisWriteOp::request_size() const {
+  return redis_write_request_->ByteSize();
+}
+
 void YBRedisWriteOp::SetHashCode(uint16_t hash_code) {
   redis_write_request_->mutable_key_value()->set_hash_code(hash_code);
 }
@@ -115,6 +119,10 @@ std::string YBRedisReadOp::ToString() const {
   return "REDIS_READ " + redis_read_request_->key_value().key();
 }
 
+size_t YBRedisReadOp::request_size() const {
+  return redis_read_request_->ByteSize();
+}
+
 void YBRedisReadOp::SetHashCode(uint16_t hash_code) {
   redis_read_request_->mutable_key_value()->set_hash_code(hash_code);
 }
@@ -124,6 +132,12 @@ const std::string& YBRedisReadOp::GetKey() const {
 }
 
 Status YBRedisReadOp::GetPartitionKey(std::string *partition_key) const {
+  if (redis_read_request_->has_scan_request()) {
+    // A scan reads the tablet of the hash code it starts from.
+    *partition_key = PartitionSchema::EncodeMultiColumnHashValue(
+        redis_read_request_->key_value().hash_code());
+    return Status::OK();
+  }
   const Slice& slice(redis_read_request_->key_value().key());
   return table_->partition_schema().EncodeRedisKey(slice, partition_key);
 }
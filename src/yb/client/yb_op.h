@@ -104,6 +104,9 @@ class YBOperation {
   // Returns the partition key of the operation.
   virtual CHECKED_STATUS GetPartitionKey(std::string* partition_key) const = 0;
 
+  // Returns the size of the serialized request, used to limit the size of batches.
+  virtual size_t request_size() const = 0;
+
  protected:
   explicit YBOperation(const std::shared_ptr<YBTable>& table);
 
@@ -146,6 +149,8 @@ class YBRedisWriteOp : public YBRedisOp {
 
   RedisWriteRequestPB* mutable_request() { return redis_write_request_.get(); }
 
+  size_t request_size() const override;
+
   std::string ToString() const override;
 
   bool read_only() override { return false; }
@@ -182,6 +187,8 @@ class YBRedisReadOp : public YBRedisOp {
 
   RedisReadRequestPB* mutable_request() { return redis_read_request_.get(); }
 
+  size_t request_size() const override;
+
   std::string ToString() const override;
 
   bool read_only() override { return true; }
@@ -194,12 +201,32 @@ class YBRedisReadOp : public YBRedisOp {
 
   CHECKED_STATUS GetPartitionKey(std::string* partition_key) const override;
 
+  YBConsistencyLevel yb_consistency_level() const {
+    return yb_consistency_level_;
+  }
+
+  void set_yb_consistency_level(YBConsistencyLevel yb_consistency_level) {
+    yb_consistency_level_ = yb_consistency_level;
+  }
+
+  // With CONSISTENT_PREFIX, a follower serves the read only if its data is at most this stale.
+  // 0 means no bound.
+  uint64_t max_staleness_ms() const {
+    return max_staleness_ms_;
+  }
+
+  void set_max_staleness_ms(uint64_t max_staleness_ms) {
+    max_staleness_ms_ = max_staleness_ms;
+  }
+
  protected:
   virtual Type type() const override { return REDIS_READ; }
 
  private:
   friend class YBTable;
   std::unique_ptr<RedisReadRequestPB> redis_read_request_;
+  YBConsistencyLevel yb_consistency_level_ = YBConsistencyLevel::STRONG;
+  uint64_t max_staleness_ms_ = 0;
 };
 
 class YBqlOp : public YBOperation {
@@ -237,6 +264,8 @@ class YBqlWriteOp : public YBqlOp {
 
   QLWriteRequestPB* mutable_request() { return ql_write_request_.get(); }
 
+  size_t request_size() const override { return ql_write_request_->ByteSize(); }
+
   std::string ToString() const override;
 
   bool read_only() override { return false; };
@@ -271,6 +300,8 @@ class YBqlReadOp : public YBqlOp {
 
   QLReadRequestPB* mutable_request() { return ql_read_request_.get(); }
 
+  size_t request_size() const override { return ql_read_request_->ByteSize(); }
+
   virtual std::string ToString() const override;
 
   virtual bool read_only() override { return true; };
@@ -289,6 +320,16 @@ class YBqlReadOp : public YBqlOp {
     yb_consistency_level_ = yb_consistency_level;
   }
 
+  // With CONSISTENT_PREFIX, a follower serves the read only if its data is at most this stale.
+  // 0 means no bound.
+  uint64_t max_staleness_ms() const {
+    return max_staleness_ms_;
+  }
+
+  void set_max_staleness_ms(uint64_t max_staleness_ms) {
+    max_staleness_ms_ = max_staleness_ms;
+  }
+
   std::vector<ColumnSchema> MakeColumnSchemasFromRequest() const;
   Result<QLRowBlock> MakeRowBlock() const;
 
@@ -303,6 +344,7 @@ class YBqlReadOp : public YBqlOp {
   explicit YBqlReadOp(const std::shared_ptr<YBTable>& table);
   std::unique_ptr<QLReadRequestPB> ql_read_request_;
   YBConsistencyLevel yb_consistency_level_;
+  uint64_t max_staleness_ms_ = 0;
   ReadHybridTime read_time_;
 };
 
@@ -0,0 +1,169 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/common/ql_compiled_condition.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+namespace {
+
+constexpr int kColumn1 = 10;
+constexpr int kColumn2 = 11;
+constexpr int kBoolColumn = 12;
+
+QLConditionPB* AddCondition(QLConditionPB* condition, QLOperator op) {
+  QLConditionPB* result = condition->add_operands()->mutable_condition();
+  result->set_op(op);
+  return result;
+}
+
+void AddColumn(QLConditionPB* condition, int column_id) {
+  condition->add_operands()->set_column_id(column_id);
+}
+
+void AddInt32(QLConditionPB* condition, int32_t value) {
+  condition->add_operands()->mutable_value()->set_int32_value(value);
+}
+
+void AddInt32List(QLConditionPB* condition, const std::vector<int32_t>& values) {
+  QLSeqValuePB* list = condition->add_operands()->mutable_value()->mutable_list_value();
+  for (int32_t value : values) {
+    list->add_elems()->set_int32_value(value);
+  }
+}
+
+QLConditionPB MakeCondition(QLOperator op) {
+  QLConditionPB condition;
+  condition.set_op(op);
+  return condition;
+}
+
+} // namespace
+
+class QLCompiledConditionTest : public YBTest {
+};
+
+TEST_F(QLCompiledConditionTest, MatchesInterpreter) {
+  std::vector<QLConditionPB> conditions;
+  std::vector<bool> fully_compiled;
+
+  // c1 = 5
+  conditions.push_back(MakeCondition(QL_OP_EQUAL));
+  AddColumn(&conditions.back(), kColumn1);
+  AddInt32(&conditions.back(), 5);
+  fully_compiled.push_back(true);
+
+  // 3 >= c1
+  conditions.push_back(MakeCondition(QL_OP_GREATER_THAN_EQUAL));
+  AddInt32(&conditions.back(), 3);
+  AddColumn(&conditions.back(), kColumn1);
+  fully_compiled.push_back(true);
+
+  // c1 < c2
+  conditions.push_back(MakeCondition(QL_OP_LESS_THAN));
+  AddColumn(&conditions.back(), kColumn1);
+  AddColumn(&conditions.back(), kColumn2);
+  fully_compiled.push_back(true);
+
+  // c1 IN (1, 3, 5) and c1 NOT IN (1, 3, 5)
+  for (QLOperator op : {QL_OP_IN, QL_OP_NOT_IN}) {
+    conditions.push_back(MakeCondition(op));
+    AddColumn(&conditions.back(), kColumn1);
+    AddInt32List(&conditions.back(), {1, 3, 5});
+    fully_compiled.push_back(true);
+  }
+
+  // c2 IS NULL
+  conditions.push_back(MakeCondition(QL_OP_IS_NULL));
+  AddColumn(&conditions.back(), kColumn2);
+  fully_compiled.push_back(true);
+
+  // c1 BETWEEN 2 AND 6
+  conditions.push_back(MakeCondition(QL_OP_BETWEEN));
+  AddColumn(&conditions.back(), kColumn1);
+  AddInt32(&conditions.back(), 2);
+  AddInt32(&conditions.back(), 6);
+  fully_compiled.push_back(true);
+
+  // c1 > 1 AND (c2 = 3 OR NOT c1 = 4)
+  conditions.push_back(MakeCondition(QL_OP_AND));
+  {
+    QLConditionPB* greater = AddCondition(&conditions.back(), QL_OP_GREATER_THAN);
+    AddColumn(greater, kColumn1);
+    AddInt32(greater, 1);
+    QLConditionPB* disjunction = AddCondition(&conditions.back(), QL_OP_OR);
+    QLConditionPB* equal = AddCondition(disjunction, QL_OP_EQUAL);
+    AddColumn(equal, kColumn2);
+    AddInt32(equal, 3);
+    QLConditionPB* negation = AddCondition(disjunction, QL_OP_NOT);
+    QLConditionPB* negated = AddCondition(negation, QL_OP_EQUAL);
+    AddColumn(negated, kColumn1);
+    AddInt32(negated, 4);
+  }
+  fully_compiled.push_back(true);
+
+  // EXISTS
+  conditions.push_back(MakeCondition(QL_OP_EXISTS));
+  fully_compiled.push_back(true);
+
+  // c1 != 2 AND b IS TRUE, where IS TRUE is left to the interpreter.
+  conditions.push_back(MakeCondition(QL_OP_AND));
+  {
+    QLConditionPB* not_equal = AddCondition(&conditions.back(), QL_OP_NOT_EQUAL);
+    AddColumn(not_equal, kColumn1);
+    AddInt32(not_equal, 2);
+    QLConditionPB* is_true = AddCondition(&conditions.back(), QL_OP_IS_TRUE);
+    AddColumn(is_true, kBoolColumn);
+  }
+  fully_compiled.push_back(false);
+
+  QLExprExecutor executor;
+  for (size_t i = 0; i != conditions.size(); ++i) {
+    QLCompiledCondition compiled(conditions[i]);
+    ASSERT_EQ(fully_compiled[i], compiled.fully_compiled()) << conditions[i].ShortDebugString();
+
+    // Rows with all combinations of values, including missing (null) ones.
+    for (int c1 = -1; c1 <= 7; ++c1) {
+      for (int c2 = -1; c2 <= 4; ++c2) {
+        for (int b = -1; b <= 1; ++b) {
+          auto row = std::make_shared<QLTableRow>();
+          if (c1 >= 0) {
+            row->AllocColumn(kColumn1).value.set_int32_value(c1);
+          }
+          if (c2 >= 0) {
+            row->AllocColumn(kColumn2).value.set_int32_value(c2);
+          }
+          if (b >= 0) {
+            row->AllocColumn(kBoolColumn).value.set_bool_value(b == 1);
+          }
+
+          bool expected = false;
+          const Status expected_status = executor.EvalCondition(conditions[i], row, &expected);
+          bool result = false;
+          const Status status = compiled.Eval(&executor, row, &result);
+          ASSERT_EQ(expected_status.ok(), status.ok())
+              << conditions[i].ShortDebugString() << ": " << expected_status << " vs " << status;
+          if (status.ok()) {
+            ASSERT_EQ(expected, result) << conditions[i].ShortDebugString()
+                                        << " c1: " << c1 << " c2: " << c2 << " b: " << b;
+          }
+        }
+      }
+    }
+  }
+}
+
+} // namespace yb
@@ -0,0 +1,259 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/common/ql_compiled_condition.h"
+
+#include <glog/logging.h>
+
+#include "yb/gutil/macros.h"
+
+namespace yb {
+
+namespace {
+
+const QLValuePB& OperandValue(const QLValuePB* value, ColumnIdRep column_id,
+                              const QLTableRow* table_row) {
+  static const QLValuePB kNullValue;
+  if (value != nullptr) {
+    return *value;
+  }
+  if (table_row != nullptr) {
+    const QLTableColumn* column = table_row->GetColumn(column_id);
+    if (column != nullptr) {
+      return column->value;
+    }
+  }
+  return kNullValue;
+}
+
+} // namespace
+
+QLCompiledCondition::QLCompiledCondition(const QLConditionPB& condition) {
+  Compile(condition);
+}
+
+bool QLCompiledCondition::CompileOperand(const QLExpressionPB& expr, Operand* operand) {
+  switch (expr.expr_case()) {
+    case QLExpressionPB::ExprCase::kValue:
+      operand->value = &expr.value();
+      return true;
+    case QLExpressionPB::ExprCase::kColumnId:
+      operand->column_id = expr.column_id();
+      return true;
+    default:
+      return false;
+  }
+}
+
+void QLCompiledCondition::Compile(const QLConditionPB& condition) {
+  const size_t index = nodes_.size();
+  nodes_.emplace_back();
+  Node node;
+  node.type = NodeType::kInterpreted;
+  node.op = condition.op();
+  node.condition = &condition;
+
+  const auto& operands = condition.operands();
+  switch (condition.op()) {
+    case QL_OP_AND: FALLTHROUGH_INTENDED;
+    case QL_OP_OR: FALLTHROUGH_INTENDED;
+    case QL_OP_NOT: {
+      bool all_conditions = operands.size() > 0 &&
+                            (condition.op() != QL_OP_NOT || operands.size() == 1);
+      for (const auto& operand : operands) {
+        all_conditions = all_conditions &&
+                         operand.expr_case() == QLExpressionPB::ExprCase::kCondition;
+      }
+      if (all_conditions) {
+        node.type = condition.op() == QL_OP_AND ? NodeType::kAnd :
+                    condition.op() == QL_OP_OR ? NodeType::kOr : NodeType::kNot;
+      }
+      break;
+    }
+
+    case QL_OP_EQUAL: FALLTHROUGH_INTENDED;
+    case QL_OP_LESS_THAN: FALLTHROUGH_INTENDED;
+    case QL_OP_LESS_THAN_EQUAL: FALLTHROUGH_INTENDED;
+    case QL_OP_GREATER_THAN: FALLTHROUGH_INTENDED;
+    case QL_OP_GREATER_THAN_EQUAL: FALLTHROUGH_INTENDED;
+    case QL_OP_NOT_EQUAL:
+      if (operands.size() == 2 &&
+          CompileOperand(operands.Get(0), &node.operands[0]) &&
+          CompileOperand(operands.Get(1), &node.operands[1])) {
+        node.type = NodeType::kCompare;
+      }
+      break;
+
+    case QL_OP_BETWEEN:
+      if (operands.size() == 3 &&
+          CompileOperand(operands.Get(0), &node.operands[0]) &&
+          CompileOperand(operands.Get(1), &node.operands[1]) &&
+          CompileOperand(operands.Get(2), &node.operands[2])) {
+        node.type = NodeType::kBetween;
+      }
+      break;
+
+    case QL_OP_IN: FALLTHROUGH_INTENDED;
+    case QL_OP_NOT_IN:
+      // The list of values must be a constant.
+      if (operands.size() == 2 &&
+          CompileOperand(operands.Get(0), &node.operands[0]) &&
+          operands.Get(1).has_value()) {
+        node.operands[1].value = &operands.Get(1).value();
+        node.type = condition.op() == QL_OP_IN ? NodeType::kIn : NodeType::kNotIn;
+      }
+      break;
+
+    case QL_OP_IS_NULL: FALLTHROUGH_INTENDED;
+    case QL_OP_IS_NOT_NULL:
+      if (operands.size() == 1 && CompileOperand(operands.Get(0), &node.operands[0])) {
+        node.type = condition.op() == QL_OP_IS_NULL ? NodeType::kIsNull : NodeType::kIsNotNull;
+      }
+      break;
+
+    case QL_OP_EXISTS:
+      node.type = NodeType::kExists;
+      break;
+
+    case QL_OP_NOT_EXISTS:
+      node.type = NodeType::kNotExists;
+      break;
+
+    default:
+      break;
+  }
+
+  nodes_[index] = node;
+  if (node.type == NodeType::kAnd || node.type == NodeType::kOr || node.type == NodeType::kNot) {
+    for (const auto& operand : operands) {
+      Compile(operand.condition());
+    }
+  }
+  nodes_[index].end = nodes_.size();
+}
+
+bool QLCompiledCondition::fully_compiled() const {
+  for (const Node& node : nodes_) {
+    if (node.type == NodeType::kInterpreted) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Status QLCompiledCondition::Eval(QLExprExecutor* executor,
+                                 const QLTableRow::SharedPtrConst& table_row,
+                                 bool* result) const {
+  return EvalNode(0, executor, table_row, result);
+}
+
+Status QLCompiledCondition::EvalNode(size_t index,
+                                     QLExprExecutor* executor,
+                                     const QLTableRow::SharedPtrConst& table_row,
+                                     bool* result) const {
+  const Node& node = nodes_[index];
+  auto operand = [&node, &table_row](size_t i) -> const QLValuePB& {
+    return OperandValue(node.operands[i].value, node.operands[i].column_id, table_row.get());
+  };
+
+  switch (node.type) {
+    case NodeType::kAnd: FALLTHROUGH_INTENDED;
+    case NodeType::kOr: {
+      // Stop at the first false operand of AND, or the first true one of OR.
+      const bool stop_at = node.type == NodeType::kOr;
+      for (size_t child = index + 1; child < node.end; child = nodes_[child].end) {
+        RETURN_NOT_OK(EvalNode(child, executor, table_row, result));
+        if (*result == stop_at) {
+          break;
+        }
+      }
+      return Status::OK();
+    }
+
+    case NodeType::kNot:
+      RETURN_NOT_OK(EvalNode(index + 1, executor, table_row, result));
+      *result = !*result;
+      return Status::OK();
+
+    case NodeType::kCompare: {
+      const QLValuePB& lhs = operand(0);
+      const QLValuePB& rhs = operand(1);
+      if (!Comparable(lhs, rhs)) {
+        return STATUS(RuntimeError, "values not comparable");
+      }
+      switch (node.op) {
+        case QL_OP_EQUAL: *result = lhs == rhs; break;
+        case QL_OP_LESS_THAN: *result = lhs < rhs; break;
+        case QL_OP_LESS_THAN_EQUAL: *result = lhs <= rhs; break;
+        case QL_OP_GREATER_THAN: *result = lhs > rhs; break;
+        case QL_OP_GREATER_THAN_EQUAL: *result = lhs >= rhs; break;
+        case QL_OP_NOT_EQUAL: *result = lhs != rhs; break;
+        default:
+          LOG(FATAL) << "Unexpected comparison operator " << node.op;
+      }
+      return Status::OK();
+    }
+
+    case NodeType::kBetween: {
+      const QLValuePB& value = operand(0);
+      const QLValuePB& lower = operand(1);
+      const QLValuePB& upper = operand(2);
+      if (!Comparable(value, lower) || !Comparable(value, upper)) {
+        return STATUS(RuntimeError, "values not comparable");
+      }
+      *result = value >= lower && value <= upper;
+      return Status::OK();
+    }
+
+    case NodeType::kIn: FALLTHROUGH_INTENDED;
+    case NodeType::kNotIn: {
+      const QLValuePB& value = operand(0);
+      bool found = false;
+      for (const QLValuePB& elem : operand(1).list_value().elems()) {
+        if (!Comparable(elem, value)) {
+          return STATUS(RuntimeError, "values not comparable");
+        }
+        if (elem == value) {
+          found = true;
+          break;
+        }
+      }
+      *result = found == (node.type == NodeType::kIn);
+      return Status::OK();
+    }
+
+    case NodeType::kIsNull:
+      *result = IsNull(operand(0));
+      return Status::OK();
+
+    case NodeType::kIsNotNull:
+      *result = !IsNull(operand(0));
+      return Status::OK();
+
+    // The row exists if and only if it is not empty, see QLExprExecutor::EvalCondition.
+    case NodeType::kExists:
+      *result = table_row != nullptr && !table_row->IsEmpty();
+      return Status::OK();
+
+    case NodeType::kNotExists:
+      *result = table_row == nullptr || table_row->IsEmpty();
+      return Status::OK();
+
+    case NodeType::kInterpreted:
+      return executor->EvalCondition(*node.condition, table_row, result);
+  }
+  LOG(FATAL) << "Unexpected condition node type " << static_cast<int>(node.type);
+  return Status::OK();
+}
+
+} // namespace yb
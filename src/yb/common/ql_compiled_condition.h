@@ -0,0 +1,91 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_COMMON_QL_COMPILED_CONDITION_H
+#define YB_COMMON_QL_COMPILED_CONDITION_H
+
+#include <vector>
+
+#include "yb/common/ql_expr.h"
+#include "yb/common/ql_protocol.pb.h"
+
+namespace yb {
+
+// A QL condition compiled once into a flat list of typed nodes, to be evaluated against many rows.
+//
+// Comparisons, IN lists, null checks, BETWEEN, EXISTS and their AND / OR / NOT combinations with
+// operands that are columns or constants are compiled. Operands are compared in place, without
+// copying the column values and constants into QLValues for every row as QLExprExecutor does.
+// Anything else, e.g. builtin function calls, is evaluated by the given QLExprExecutor.
+//
+// The compiled condition refers to the condition, which must outlive it.
+class QLCompiledCondition {
+ public:
+  explicit QLCompiledCondition(const QLConditionPB& condition);
+
+  // Evaluates the condition for the given row. Matches QLExprExecutor::EvalCondition.
+  CHECKED_STATUS Eval(QLExprExecutor* executor,
+                      const QLTableRow::SharedPtrConst& table_row,
+                      bool* result) const;
+
+  // Whether no part of the condition needs the QLExprExecutor. For testing.
+  bool fully_compiled() const;
+
+ private:
+  enum class NodeType {
+    kAnd,
+    kOr,
+    kNot,
+    kCompare,
+    kBetween,
+    kIn,
+    kNotIn,
+    kIsNull,
+    kIsNotNull,
+    kExists,
+    kNotExists,
+    kInterpreted,
+  };
+
+  // A column of the row, or a constant when value is set.
+  struct Operand {
+    const QLValuePB* value = nullptr;
+    ColumnIdRep column_id = 0;
+  };
+
+  // The nodes are in pre-order. The operands of AND, OR and NOT are the nodes that follow them up
+  // to their end.
+  struct Node {
+    NodeType type;
+    QLOperator op = QL_OP_NOOP;
+    Operand operands[3];
+    const QLConditionPB* condition = nullptr;
+    size_t end = 0;
+  };
+
+  void Compile(const QLConditionPB& condition);
+
+  // Compiles the expression into an operand when it is a column or a constant.
+  static bool CompileOperand(const QLExpressionPB& expr, Operand* operand);
+
+  CHECKED_STATUS EvalNode(size_t index,
+                          QLExprExecutor* executor,
+                          const QLTableRow::SharedPtrConst& table_row,
+                          bool* result) const;
+
+  std::vector<Node> nodes_;
+};
+
+} // namespace yb
+
+#endif // YB_COMMON_QL_COMPILED_CONDITION_H
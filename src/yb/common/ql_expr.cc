@@ -3,6 +3,9 @@
 //--------------------------------------------------------------------------------------------------
 
 #include "yb/common/ql_expr.h"
+
+#include <algorithm>
+
 #include "yb/common/ql_bfunc.h"
 
 namespace yb {
@@ -315,9 +318,31 @@ CHECKED_STATUS QLExprExecutor::EvalCondition(const QLConditionPB& condition,
 
 //--------------------------------------------------------------------------------------------------
 
+namespace {
+
+// Returns the first of the columns, sorted by id, whose id is not less than col_id.
+template <class Columns>
+auto ColumnLowerBound(Columns* columns, ColumnIdRep col_id) -> decltype(columns->begin()) {
+  return std::lower_bound(
+      columns->begin(), columns->end(), col_id,
+      [](const typename Columns::value_type& column, ColumnIdRep id) { return column.first < id; });
+}
+
+} // namespace
+
+QLTableRow::Columns::const_iterator QLTableRow::FindColumn(ColumnIdRep col_id) const {
+  auto it = ColumnLowerBound(&columns_, col_id);
+  return it != columns_.end() && it->first == col_id ? it : columns_.end();
+}
+
+const QLTableColumn* QLTableRow::GetColumn(ColumnIdRep col_id) const {
+  const auto& col_iter = FindColumn(col_id);
+  return col_iter == columns_.end() ? nullptr : &col_iter->second;
+}
+
 CHECKED_STATUS QLTableRow::ReadColumn(ColumnIdRep col_id, QLValue *col_value) const {
-  const auto& col_iter = col_map_.find(col_id);
-  if (col_iter == col_map_.end()) {
+  const auto& col_iter = FindColumn(col_id);
+  if (col_iter == columns_.end()) {
     col_value->SetNull();
     return Status::OK();
   }
@@ -331,8 +356,8 @@ CHECKED_STATUS QLTableRow::ReadSubscriptedColumn(const QLSubscriptedColPB& subco
                                                  QLValue *col_value) const {
   col_value->SetNull();
 
-  const auto& col_iter = col_map_.find(subcol.column_id());
-  if (col_iter == col_map_.end()) {
+  const auto& col_iter = FindColumn(subcol.column_id());
+  if (col_iter == columns_.end()) {
     // Not exists.
     return Status::OK();
   } else if (col_iter->second.value.has_map_value()) {
@@ -358,8 +383,8 @@ CHECKED_STATUS QLTableRow::ReadSubscriptedColumn(const QLSubscriptedColPB& subco
 }
 
 CHECKED_STATUS QLTableRow::GetTTL(ColumnIdRep col_id, int64_t *ttl_seconds) const {
-  const auto& col_iter = col_map_.find(col_id);
-  if (col_iter == col_map_.end()) {
+  const auto& col_iter = FindColumn(col_id);
+  if (col_iter == columns_.end()) {
     // Not exists.
     return STATUS(InternalError, "Column unexpectedly not found in cache");
   }
@@ -368,8 +393,8 @@ CHECKED_STATUS QLTableRow::GetTTL(ColumnIdRep col_id, int64_t *ttl_seconds) cons
 }
 
 CHECKED_STATUS QLTableRow::GetWriteTime(ColumnIdRep col_id, int64_t *write_time) const {
-  const auto& col_iter = col_map_.find(col_id);
-  if (col_iter == col_map_.end()) {
+  const auto& col_iter = FindColumn(col_id);
+  if (col_iter == columns_.end()) {
     // Not exists.
     return STATUS(InternalError, "Column unexpectedly not found in cache");
   }
@@ -378,8 +403,8 @@ CHECKED_STATUS QLTableRow::GetWriteTime(ColumnIdRep col_id, int64_t *write_time)
 }
 
 CHECKED_STATUS QLTableRow::GetValue(ColumnIdRep col_id, QLValue *column) const {
-  const auto& col_iter = col_map_.find(col_id);
-  if (col_iter == col_map_.end()) {
+  const auto& col_iter = FindColumn(col_id);
+  if (col_iter == columns_.end()) {
     // Not exists.
     return STATUS(InternalError, "Column unexpectedly not found in cache");
   }
@@ -388,31 +413,40 @@ CHECKED_STATUS QLTableRow::GetValue(ColumnIdRep col_id, QLValue *column) const {
 }
 
 bool QLTableRow::MatchColumn(ColumnIdRep col_id, const QLTableRow::SharedPtrConst& source) const {
-  auto this_iter = col_map_.find(col_id);
-  auto source_iter = source->col_map_.find(col_id);
-  if (this_iter != col_map_.end() && source_iter != source->col_map_.end()) {
+  auto this_iter = FindColumn(col_id);
+  auto source_iter = source->FindColumn(col_id);
+  if (this_iter != columns_.end() && source_iter != source->columns_.end()) {
     return this_iter->second.value == source_iter->second.value;
   }
-  if (this_iter != col_map_.end() || source_iter != source->col_map_.end()) {
+  if (this_iter != columns_.end() || source_iter != source->columns_.end()) {
     return false;
   }
   return true;
 }
 
 QLTableColumn& QLTableRow::AllocColumn(ColumnIdRep col_id) {
-  return col_map_[col_id];
+  if (columns_.empty() || columns_.back().first < col_id) {
+    columns_.emplace_back(col_id, QLTableColumn());
+    return columns_.back().second;
+  }
+  auto it = ColumnLowerBound(&columns_, col_id);
+  if (it == columns_.end() || it->first != col_id) {
+    it = columns_.emplace(it, col_id, QLTableColumn());
+  }
+  return it->second;
 }
 
 QLTableColumn& QLTableRow::AllocColumn(ColumnIdRep col_id, const QLValue& ql_value) {
-  col_map_[col_id].value = ql_value.value();
-  return col_map_[col_id];
+  QLTableColumn& column = AllocColumn(col_id);
+  column.value = ql_value.value();
+  return column;
 }
 
 CHECKED_STATUS QLTableRow::CopyColumn(ColumnIdRep col_id,
                                       const QLTableRow::SharedPtrConst& source) {
-  auto col_iter = source->col_map_.find(col_id);
-  if (col_iter != source->col_map_.end()) {
-    col_map_[col_id] = col_iter->second;
+  auto col_iter = source->FindColumn(col_id);
+  if (col_iter != source->columns_.end()) {
+    AllocColumn(col_id) = col_iter->second;
   }
   return Status::OK();
 }
@@ -7,6 +7,9 @@
 #ifndef YB_COMMON_QL_EXPR_H_
 #define YB_COMMON_QL_EXPR_H_
 
+#include <utility>
+#include <vector>
+
 #include "yb/common/ql_value.h"
 #include "yb/common/schema.h"
 #include "yb/common/ql_bfunc.h"
@@ -40,16 +43,16 @@ class QLTableRow {
 
   // Check if row is empty (no column).
   bool IsEmpty() const {
-    return col_map_.empty();
+    return columns_.empty();
   }
 
   // Get column count.
   size_t ColumnCount() const {
-    return col_map_.size();
+    return columns_.size();
   }
 
-  // Clear the row.
-  void Clear() { col_map_.clear(); }
+  // Clear the row. The memory for the columns is kept for the next row read into it.
+  void Clear() { columns_.clear(); }
 
   // Compare column value between two rows.
   bool MatchColumn(ColumnIdRep col_id, const QLTableRow::SharedPtrConst& source) const;
@@ -84,6 +87,10 @@ class QLTableRow {
     return GetValue(col.rep(), column);
   }
 
+  // Get the cached column entry without copying its value. Returns nullptr if the column is not
+  // in the row.
+  const QLTableColumn* GetColumn(ColumnIdRep col_id) const;
+
   // Get the column value in PB format.
   CHECKED_STATUS ReadColumn(ColumnIdRep col_id, QLValue *col_value) const;
   CHECKED_STATUS ReadSubscriptedColumn(const QLSubscriptedColPB& subcol,
@@ -92,14 +99,21 @@ class QLTableRow {
 
   // For testing only (no status check).
   const QLTableColumn& TestValue(ColumnIdRep col_id) const {
-    return col_map_.at(col_id);
+    return *CHECK_NOTNULL(GetColumn(col_id));
   }
   const QLTableColumn& TestValue(const ColumnId& col) const {
-    return col_map_.at(col.rep());
+    return TestValue(col.rep());
   }
 
  private:
-  std::unordered_map<ColumnIdRep, QLTableColumn> col_map_;
+  typedef std::vector<std::pair<ColumnIdRep, QLTableColumn>> Columns;
+
+  Columns::const_iterator FindColumn(ColumnIdRep col_id) const;
+
+  // The columns sorted by id. A row is read in column id order, so allocating a column usually
+  // appends it, and reusing a cleared row for the next one does not allocate a node per column
+  // like a hash map does.
+  Columns columns_;
 };
 
 class QLExprExecutor {
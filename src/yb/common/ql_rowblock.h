@@ -98,6 +98,8 @@ class QLRowBlock {
   // Return the row by index
   QLRow& row(size_t idx) { return rows_[idx]; }
 
+  const QLRow& row(size_t idx) const { return rows_[idx]; }
+
   // Extend row block by 1 emtpy row and return the new row.
   QLRow& Extend();
 
@@ -31,8 +31,8 @@ class QLRowwiseIteratorIf : public RowwiseIterator {
   // Init QL read scan.
   virtual CHECKED_STATUS Init(const QLScanSpec& spec) = 0;
 
-  // This may return one row at a time in the initial implementation, even though Kudu's scanning
-  // interface supports returning multiple rows at a time.
+  // Returns up to dst->row_capacity() rows. Implementations may return fewer rows than the block
+  // capacity even if there are more rows to read.
   virtual CHECKED_STATUS NextBlock(RowBlock *dst) override = 0;
 
   // Is the next row column to read a static column?
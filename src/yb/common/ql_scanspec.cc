@@ -298,12 +298,15 @@ QLScanSpec::QLScanSpec(const QLConditionPB* condition,
   if (executor_ == nullptr) {
     executor_ = std::make_shared<QLExprExecutor>();
   }
+  if (condition_ != nullptr) {
+    compiled_condition_ = std::make_unique<QLCompiledCondition>(*condition_);
+  }
 }
 
 // Evaluate the WHERE condition for the given row.
 CHECKED_STATUS QLScanSpec::Match(const QLTableRow::SharedPtr& table_row, bool* match) const {
-  if (condition_ != nullptr) {
-    return executor_->EvalCondition(*condition_, table_row, match);
+  if (compiled_condition_ != nullptr) {
+    return compiled_condition_->Eval(executor_.get(), table_row, match);
   }
   *match = true;
   return Status::OK();
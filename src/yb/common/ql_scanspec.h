@@ -17,8 +17,10 @@
 #define YB_COMMON_QL_SCANSPEC_H
 
 #include <map>
+#include <memory>
 
 #include "yb/common/schema.h"
+#include "yb/common/ql_compiled_condition.h"
 #include "yb/common/ql_protocol.pb.h"
 #include "yb/common/ql_rowblock.h"
 #include "yb/common/ql_expr.h"
@@ -83,6 +85,9 @@ class QLScanSpec {
   const QLConditionPB* condition_;
   const bool is_forward_scan_;
   QLExprExecutor::SharedPtr executor_;
+
+  // The condition compiled for matching many rows against it.
+  std::unique_ptr<QLCompiledCondition> compiled_condition_;
 };
 
 } // namespace common
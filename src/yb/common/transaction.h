@@ -99,6 +99,15 @@ class TransactionStatusManager {
   // 4. Any kind of network/timeout errors would be reflected in error passed to callback.
   virtual void RequestStatusAt(const StatusRequest& request) = 0;
 
+  // Returns the final status of a transaction that was resolved by one of the previous reads:
+  // commit time if it is committed, HybridTime::kMin if it is aborted, or invalid time if its
+  // final status is not known.
+  virtual HybridTime ResolvedCommitTime(const TransactionId& id) = 0;
+
+  // Shares the final status of a transaction, resolved by a read, with the following reads.
+  // commit_time is HybridTime::kMin for aborted transactions.
+  virtual void TransactionResolved(const TransactionId& id, HybridTime commit_time) = 0;
+
   virtual boost::optional<TransactionMetadata> Metadata(const TransactionId& id) = 0;
 
   virtual void Abort(const TransactionId& id, TransactionStatusCallback callback) = 0;
@@ -106,14 +115,19 @@ class TransactionStatusManager {
 
 struct TransactionOperationContext {
   TransactionOperationContext(
-      const TransactionId& transaction_id_, TransactionStatusManager* txn_status_manager_)
+      const TransactionId& transaction_id_, TransactionStatusManager* txn_status_manager_,
+      rocksdb::DB* intents_db_ = nullptr)
       : transaction_id(transaction_id_),
-        txn_status_manager(*(DCHECK_NOTNULL(txn_status_manager_))) {}
+        txn_status_manager(*(DCHECK_NOTNULL(txn_status_manager_))),
+        intents_db(intents_db_) {}
 
   bool transactional() const;
 
   TransactionId transaction_id;
   TransactionStatusManager& txn_status_manager;
+  // RocksDB that keeps the intents when they are stored separately from the regular records,
+  // nullptr when intents are stored in the same RocksDB as the regular records.
+  rocksdb::DB* intents_db;
 };
 
 typedef boost::optional<TransactionOperationContext> TransactionOperationContextOpt;
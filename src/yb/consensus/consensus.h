@@ -347,6 +347,15 @@ class Consensus : public RefCountedThreadSafe<Consensus> {
     return STATUS(NotFound, "Not implemented.");
   }
 
+  // Reads the committed operations that follow 'from', for change data capture. Reads at most
+  // 'max_size_bytes' of operations, but at least one if there is any. The operations no longer in
+  // the log cache are read back from the log.
+  virtual CHECKED_STATUS ReadReplicatedMessagesForCDC(const OpId& from,
+                                                      int max_size_bytes,
+                                                      ReplicateMsgs* msgs) {
+    return STATUS(NotSupported, "Not implemented.");
+  }
+
   // Assuming we are the leader, wait until we have a valid leader lease (i.e. the old leader's
   // lease has expired, and we have replicated a new lease that has not expired yet).
   virtual CHECKED_STATUS WaitForLeaderLeaseImprecise(MonoTime deadline) = 0;
@@ -506,6 +515,11 @@ class ReplicaOperationFactory {
  public:
   virtual CHECKED_STATUS StartReplicaOperation(const ConsensusRoundPtr& context) = 0;
 
+  // Invoked before and after the replication of a sequence of operations is reported to have
+  // finished as they are committed, so that their changes could be applied together.
+  virtual void StartApplyingCommittedOperations() {}
+  virtual void FinishApplyingCommittedOperations() {}
+
   virtual ~ReplicaOperationFactory() {}
 };
 
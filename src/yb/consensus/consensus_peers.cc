@@ -33,6 +33,7 @@
 #include "yb/consensus/consensus_peers.h"
 
 #include <algorithm>
+#include <map>
 #include <mutex>
 #include <string>
 #include <utility>
@@ -50,7 +51,9 @@
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/rpc/messenger.h"
 #include "yb/tserver/tserver.pb.h"
+#include "yb/util/atomic.h"
 #include "yb/util/fault_injection.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
@@ -63,6 +66,38 @@ DEFINE_int32(consensus_rpc_timeout_ms, 2000,
              "Timeout used for all consensus internal RPC communications.");
 TAG_FLAG(consensus_rpc_timeout_ms, advanced);
 
+DEFINE_int32(consensus_max_in_flight_requests_per_peer, 1,
+             "Maximum number of UpdateConsensus requests that the leader may have outstanding "
+             "to a single follower. Values above 1 pipeline replication: new operations are "
+             "sent to a follower that is in sync without waiting for the previous response.");
+TAG_FLAG(consensus_max_in_flight_requests_per_peer, advanced);
+
+DEFINE_int32(consensus_heartbeat_batch_window_ms, 0,
+             "If positive, the heartbeats that the leaders of different tablets send to the same "
+             "tablet server within this many milliseconds are sent as one MultiUpdateConsensus "
+             "RPC. Only enable it when all tablet servers support that RPC.");
+TAG_FLAG(consensus_heartbeat_batch_window_ms, advanced);
+TAG_FLAG(consensus_heartbeat_batch_window_ms, runtime);
+
+DEFINE_int32(consensus_heartbeat_max_batch_size, 256,
+             "Maximum number of heartbeats sent in one MultiUpdateConsensus RPC.");
+TAG_FLAG(consensus_heartbeat_max_batch_size, advanced);
+TAG_FLAG(consensus_heartbeat_max_batch_size, runtime);
+
+DEFINE_int32(consensus_vote_batch_window_ms, 0,
+             "If positive, the vote requests that the candidates of different tablets send to the "
+             "same tablet server within this many milliseconds are sent as one "
+             "MultiRequestConsensusVote RPC, so that the elections that follow the failure of a "
+             "server do not flood the voters with RPCs. Only enable it when all tablet servers "
+             "support that RPC.");
+TAG_FLAG(consensus_vote_batch_window_ms, advanced);
+TAG_FLAG(consensus_vote_batch_window_ms, runtime);
+
+DEFINE_int32(consensus_vote_max_batch_size, 64,
+             "Maximum number of vote requests sent in one MultiRequestConsensusVote RPC.");
+TAG_FLAG(consensus_vote_max_batch_size, advanced);
+TAG_FLAG(consensus_vote_max_batch_size, runtime);
+
 DECLARE_int32(raft_heartbeat_interval_ms);
 
 DEFINE_test_flag(double, fault_crash_on_leader_request_fraction, 0.0,
@@ -116,16 +151,24 @@ Peer::Peer(
       proxy_(proxy.Pass()),
       queue_(queue),
       failed_attempts_(0),
-      sem_(1),
+      sem_(std::max(FLAGS_consensus_max_in_flight_requests_per_peer, 1)),
       heartbeater_(
           peer_pb.permanent_uuid(), MonoDelta::FromMilliseconds(FLAGS_raft_heartbeat_interval_ms),
-          std::bind(&Peer::SignalRequest, this, RequestTriggerMode::ALWAYS_SEND)),
+          std::bind(&Peer::Heartbeat, this)),
       thread_pool_(thread_pool),
       state_(kPeerCreated),
-      consensus_(consensus) {}
+      consensus_(consensus) {
+  const int num_calls = std::max(FLAGS_consensus_max_in_flight_requests_per_peer, 1);
+  calls_.reserve(num_calls);
+  free_calls_.reserve(num_calls);
+  for (int i = 0; i != num_calls; ++i) {
+    calls_.emplace_back(new UpdateCall);
+    free_calls_.push_back(calls_.back().get());
+  }
+}
 
 void Peer::SetTermForTest(int term) {
-  response_.set_responder_term(term);
+  calls_.front()->response.set_responder_term(term);
 }
 
 Status Peer::Init() {
@@ -136,12 +179,23 @@ Status Peer::Init() {
   return Status::OK();
 }
 
+Status Peer::Heartbeat() {
+  {
+    std::lock_guard<simple_spinlock> l(peer_lock_);
+    if (quiescent_until_ && MonoTime::Now() < quiescent_until_) {
+      return Status::OK();
+    }
+  }
+  return SignalRequest(RequestTriggerMode::ALWAYS_SEND);
+}
+
 Status Peer::SignalRequest(RequestTriggerMode trigger_mode) {
-  // If the peer is currently sending, return Status::OK().
+  // If the peer already has as many requests outstanding as allowed, return Status::OK().
   // If there are new requests in the queue we'll get them on ProcessResponse().
   if (!sem_.TryAcquire()) {
     return Status::OK();
   }
+  UpdateCall* call = nullptr;
   {
     std::lock_guard<simple_spinlock> l(peer_lock_);
 
@@ -150,6 +204,13 @@ Status Peer::SignalRequest(RequestTriggerMode trigger_mode) {
       return STATUS(IllegalState, "Peer was closed.");
     }
 
+    // Another request is outstanding, so this one is only worth sending if it carries new
+    // operations. Heartbeats are not pipelined.
+    const bool pipelined = free_calls_.size() < calls_.size();
+    if (pipelined) {
+      trigger_mode = RequestTriggerMode::NON_EMPTY_ONLY;
+    }
+
     // For the first request sent by the peer, we send it even if the queue is empty, which it will
     // always appear to be for the first request, since this is the negotiation round.
     if (PREDICT_FALSE(state_ == kPeerStarted)) {
@@ -170,53 +231,83 @@ Status Peer::SignalRequest(RequestTriggerMode trigger_mode) {
       sem_.Release();
       return Status::OK();
     }
+
+    call = free_calls_.back();
+    free_calls_.pop_back();
   }
 
   auto status = thread_pool_->SubmitClosure(
-      Bind(&Peer::SendNextRequest, Unretained(this), trigger_mode));
+      Bind(&Peer::SendNextRequest, Unretained(this), trigger_mode, call));
   if (!status.ok()) {
-    sem_.Release();
+    ReleaseCall(call);
   }
   return status;
 }
 
-void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
-  DCHECK_LE(sem_.GetValue(), 0) << "Cannot send request";
+void Peer::ReleaseCall(UpdateCall* call) {
+  {
+    std::lock_guard<simple_spinlock> l(peer_lock_);
+    free_calls_.push_back(call);
+  }
+  sem_.Release();
+}
+
+void Peer::SendNextRequest(RequestTriggerMode trigger_mode, UpdateCall* call) {
+  DCHECK_LT(sem_.GetValue(), static_cast<int>(calls_.size())) << "Cannot send request";
+
+  std::unique_lock<std::mutex> send_lock(send_mutex_);
+
+  // Whether other requests to the peer are outstanding.
+  bool pipelined;
+  {
+    std::lock_guard<simple_spinlock> l(peer_lock_);
+    pipelined = free_calls_.size() + 1 < calls_.size();
+  }
+  if (pipelined) {
+    trigger_mode = RequestTriggerMode::NON_EMPTY_ONLY;
+  }
 
-  // The peer has no pending request nor is sending: send the request.
+  ConsensusRequestPB& request = call->request;
   bool needs_remote_bootstrap = false;
   bool last_exchange_successful = false;
   RaftPeerPB::MemberType member_type = RaftPeerPB::UNKNOWN_MEMBER_TYPE;
-  int64_t commit_index_before = request_.has_committed_index() ?
-      request_.committed_index().index() : kMinimumOpIdIndex;
-  Status s = queue_->RequestForPeer(peer_pb_.permanent_uuid(), &request_,
-      &replicate_msg_refs_, &needs_remote_bootstrap, &member_type, &last_exchange_successful);
-  int64_t commit_index_after = request_.has_committed_index() ?
-      request_.committed_index().index() : kMinimumOpIdIndex;
+  int64_t commit_index_before = last_sent_committed_index_;
+  Status s = queue_->RequestForPeer(peer_pb_.permanent_uuid(), &request,
+      &call->msg_refs, &needs_remote_bootstrap, &member_type, &last_exchange_successful,
+      pipelined);
+  int64_t commit_index_after = request.has_committed_index() ?
+      request.committed_index().index() : kMinimumOpIdIndex;
+  last_sent_committed_index_ = commit_index_after;
 
   if (PREDICT_FALSE(!s.ok())) {
     LOG_WITH_PREFIX_UNLOCKED(INFO) << "Could not obtain request from queue for peer: "
         << peer_pb_.permanent_uuid() << ". Status: " << s.ToString();
-    sem_.Release();
+    ReleaseCall(call);
     return;
   }
 
   if (PREDICT_FALSE(needs_remote_bootstrap)) {
-    Status s = SendRemoteBootstrapRequest();
+    // Remote bootstrap is only initiated when there is no other request outstanding.
+    if (pipelined) {
+      ReleaseCall(call);
+      return;
+    }
+    Status s = SendRemoteBootstrapRequest(call);
     if (!s.ok()) {
       LOG_WITH_PREFIX_UNLOCKED(WARNING) << "Unable to generate remote bootstrap request for peer: "
                                         << s.ToString();
-      sem_.Release();
+      ReleaseCall(call);
     }
     return;
   }
 
   // If the peer doesn't need remote bootstrap, but it is a PRE_VOTER or PRE_OBSERVER in the config,
   // we need to promote it.
-  if (last_exchange_successful &&
+  if (last_exchange_successful && !pipelined &&
       (member_type == RaftPeerPB::PRE_VOTER || member_type == RaftPeerPB::PRE_OBSERVER)) {
     if (PREDICT_TRUE(consensus_)) {
-      sem_.Release();
+      send_lock.unlock();
+      ReleaseCall(call);
       consensus::ChangeConfigRequestPB req;
       consensus::ChangeConfigResponsePB resp;
 
@@ -244,16 +335,19 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
     }
   }
 
-  request_.set_tablet_id(tablet_id_);
-  request_.set_caller_uuid(leader_uuid_);
-  request_.set_dest_uuid(peer_pb_.permanent_uuid());
+  request.set_tablet_id(tablet_id_);
+  request.set_caller_uuid(leader_uuid_);
+  request.set_dest_uuid(peer_pb_.permanent_uuid());
 
-  const bool req_has_ops = (request_.ops_size() > 0) || (commit_index_after > commit_index_before);
+  const bool req_has_ops = (request.ops_size() > 0) ||
+                           (!pipelined && commit_index_after > commit_index_before);
 
   // If the queue is empty, check if we were told to send a status-only message (which is what
   // happens during heartbeats). If not, just return.
   if (PREDICT_FALSE(!req_has_ops && trigger_mode == RequestTriggerMode::NON_EMPTY_ONLY)) {
-    sem_.Release();
+    request.mutable_ops()->ExtractSubrange(0, request.ops_size(), nullptr);
+    call->msg_refs.clear();
+    ReleaseCall(call);
     return;
   }
 
@@ -263,18 +357,42 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
   }
 
   MAYBE_FAULT(FLAGS_fault_crash_on_leader_request_fraction);
-  controller_.Reset();
+  call->controller.Reset();
+  queue_->RequestSent(peer_pb_.permanent_uuid(), request);
 
-  proxy_->UpdateAsync(&request_, &response_, &controller_, std::bind(&Peer::ProcessResponse, this));
+  {
+    std::lock_guard<simple_spinlock> l(peer_lock_);
+    call->sequence_number = ++last_sequence_number_;
+    // Until the peer accepts a quiescent heartbeat, it expects regular heartbeats again.
+    quiescent_until_ = MonoTime();
+  }
+  call->quiescent_until = MonoTime();
+  if (request.has_quiescent_heartbeat_interval_ms()) {
+    call->quiescent_until = MonoTime::Now() +
+        MonoDelta::FromMilliseconds(request.quiescent_heartbeat_interval_ms());
+  }
+
+  if (req_has_ops) {
+    proxy_->UpdateAsync(&request, &call->response, &call->controller, [this, call] {
+      ProcessResponse(call, call->controller.status());
+    });
+  } else {
+    proxy_->HeartbeatAsync(&request, &call->response, &call->controller,
+                           [this, call](const Status& status) {
+      ProcessResponse(call, status);
+    });
+  }
 }
 
-void Peer::ProcessResponse() {
+void Peer::ProcessResponse(UpdateCall* call, const Status& status) {
   // Note: This method runs on the reactor thread.
 
-  DCHECK_LE(sem_.GetValue(), 0) << "Got a response when nothing was pending";
+  DCHECK_LT(sem_.GetValue(), static_cast<int>(calls_.size()))
+      << "Got a response when nothing was pending";
 
-  if (!controller_.status().ok()) {
-    if (controller_.status().IsRemoteError()) {
+  const ConsensusResponsePB& response = call->response;
+  if (!status.ok()) {
+    if (status.IsRemoteError()) {
       // Most controller errors are caused by network issues or corner cases like shutdown and
       // failure to serialize a protobuf. Therefore, we generally consider these errors to indicate
       // an unreachable peer.  However, a RemoteError wraps some other error propagated from the
@@ -282,63 +400,73 @@ void Peer::ProcessResponse() {
       // remote is responsive.
       queue_->NotifyPeerIsResponsiveDespiteError(peer_pb_.permanent_uuid());
     }
-    ProcessResponseError(controller_.status());
+    ProcessResponseError(status, call);
     return;
   }
 
   // We should try to evict a follower which returns a WRONG UUID error.
-  if (response_.has_error() &&
-      response_.error().code() == tserver::TabletServerErrorPB::WRONG_SERVER_UUID) {
+  if (response.has_error() &&
+      response.error().code() == tserver::TabletServerErrorPB::WRONG_SERVER_UUID) {
     queue_->NotifyObserversOfFailedFollower(
         peer_pb_.permanent_uuid(),
         Substitute("Leader communication with peer $0 received error $1, will try to "
                    "evict peer", peer_pb_.permanent_uuid(),
-                   response_.error().ShortDebugString()));
-    ProcessResponseError(StatusFromPB(response_.error().status()));
+                   response.error().ShortDebugString()));
+    ProcessResponseError(StatusFromPB(response.error().status()), call);
     return;
   }
 
   // Pass through errors we can respond to, like not found, since in that case
   // we will need to remotely bootstrap. TODO: Handle DELETED response once implemented.
-  if ((response_.has_error() &&
-      response_.error().code() != tserver::TabletServerErrorPB::TABLET_NOT_FOUND) ||
-      (response_.status().has_error() &&
-          response_.status().error().code() == consensus::ConsensusErrorPB::CANNOT_PREPARE)) {
+  if ((response.has_error() &&
+      response.error().code() != tserver::TabletServerErrorPB::TABLET_NOT_FOUND) ||
+      (response.status().has_error() &&
+          response.status().error().code() == consensus::ConsensusErrorPB::CANNOT_PREPARE)) {
     // Again, let the queue know that the remote is still responsive, since we will not be sending
     // this error response through to the queue.
     queue_->NotifyPeerIsResponsiveDespiteError(peer_pb_.permanent_uuid());
-    ProcessResponseError(StatusFromPB(response_.error().status()));
+    ProcessResponseError(StatusFromPB(response.error().status()), call);
     return;
   }
 
   // The queue's handling of the peer response may generate IO (reads against the WAL) and
   // SendNextRequest() may do the same thing. So we run the rest of the response handling logic on
   // our thread pool and not on the reactor thread.
-  Status s = thread_pool_->SubmitClosure(Bind(&Peer::DoProcessResponse, Unretained(this)));
+  Status s = thread_pool_->SubmitClosure(Bind(&Peer::DoProcessResponse, Unretained(this), call));
   if (PREDICT_FALSE(!s.ok())) {
     LOG_WITH_PREFIX_UNLOCKED(WARNING) << "Unable to process peer response: " << s.ToString()
-        << ": " << response_.ShortDebugString();
-    sem_.Release();
+        << ": " << response.ShortDebugString();
+    queue_->RequestFailed(peer_pb_.permanent_uuid());
+    ReleaseCall(call);
   }
 }
 
-void Peer::DoProcessResponse() {
+void Peer::DoProcessResponse(UpdateCall* call) {
   failed_attempts_ = 0;
 
+  if (call->quiescent_until && !call->response.has_error() &&
+      !call->response.status().has_error()) {
+    std::lock_guard<simple_spinlock> l(peer_lock_);
+    // A later request could have told the peer that the leader is no longer quiescent.
+    if (call->sequence_number == last_sequence_number_) {
+      quiescent_until_ = call->quiescent_until;
+    }
+  }
+
   bool more_pending;
-  queue_->ResponseFromPeer(peer_pb_.permanent_uuid(), response_, &more_pending);
+  queue_->ResponseFromPeer(peer_pb_.permanent_uuid(), call->response, &more_pending);
 
   // We're OK to read the state_ without a lock here -- if we get a race,
   // the worst thing that could happen is that we'll make one more request before
   // noticing a close.
   if (more_pending && ANNOTATE_UNPROTECTED_READ(state_) != kPeerClosed) {
-    SendNextRequest(RequestTriggerMode::ALWAYS_SEND);
+    SendNextRequest(RequestTriggerMode::ALWAYS_SEND, call);
   } else {
-    sem_.Release();
+    ReleaseCall(call);
   }
 }
 
-Status Peer::SendRemoteBootstrapRequest() {
+Status Peer::SendRemoteBootstrapRequest(UpdateCall* call) {
   if (!FLAGS_enable_remote_bootstrap) {
     failed_attempts_++;
     return STATUS(NotSupported, "remote bootstrap is disabled");
@@ -346,29 +474,30 @@ Status Peer::SendRemoteBootstrapRequest() {
 
   LOG_WITH_PREFIX_UNLOCKED(INFO) << "Sending request to remotely bootstrap";
   RETURN_NOT_OK(queue_->GetRemoteBootstrapRequestForPeer(peer_pb_.permanent_uuid(), &rb_request_));
-  controller_.Reset();
+  call->controller.Reset();
   proxy_->StartRemoteBootstrap(
-      &rb_request_, &rb_response_, &controller_,
-      std::bind(&Peer::ProcessRemoteBootstrapResponse, this));
+      &rb_request_, &rb_response_, &call->controller,
+      std::bind(&Peer::ProcessRemoteBootstrapResponse, this, call));
   return Status::OK();
 }
 
-void Peer::ProcessRemoteBootstrapResponse() {
+void Peer::ProcessRemoteBootstrapResponse(UpdateCall* call) {
   // We treat remote bootstrap as fire-and-forget.
   if (rb_response_.has_error()) {
     LOG_WITH_PREFIX_UNLOCKED(WARNING) << "Unable to begin remote bootstrap on peer: "
                                       << rb_response_.ShortDebugString();
   }
-  sem_.Release();
+  ReleaseCall(call);
 }
 
-void Peer::ProcessResponseError(const Status& status) {
+void Peer::ProcessResponseError(const Status& status, UpdateCall* call) {
   failed_attempts_++;
   LOG_WITH_PREFIX_UNLOCKED(WARNING) << "Couldn't send request to peer " << peer_pb_.permanent_uuid()
       << " for tablet " << tablet_id_
       << " Status: " << status.ToString() << ". Retrying in the next heartbeat period."
       << " Already tried " << failed_attempts_ << " times.";
-  sem_.Release();
+  queue_->RequestFailed(peer_pb_.permanent_uuid());
+  ReleaseCall(call);
 }
 
 string Peer::LogPrefixUnlocked() const {
@@ -389,24 +518,233 @@ void Peer::Close() {
   }
   LOG_WITH_PREFIX_UNLOCKED(INFO) << "Closing peer: " << peer_pb_.permanent_uuid();
 
-  // Acquire the semaphore to wait for any concurrent request to finish.  They will see the state_
-  // == kPeerClosed and not start any new requests, but we can't currently cancel the already-sent
-  // ones. (see KUDU-699)
-  std::lock_guard<Semaphore> l(sem_);
+  // Acquire the whole semaphore to wait for any concurrent request to finish.  They will see the
+  // state_ == kPeerClosed and not start any new requests, but we can't currently cancel the
+  // already-sent ones. (see KUDU-699)
+  for (size_t i = 0; i != calls_.size(); ++i) {
+    sem_.Acquire();
+  }
   queue_->UntrackPeer(peer_pb_.permanent_uuid());
-  // We don't own the ops (the queue does).
-  request_.mutable_ops()->ExtractSubrange(0, request_.ops_size(), nullptr);
-  replicate_msg_refs_.clear();
+  for (const auto& call : calls_) {
+    // We don't own the ops (the queue does).
+    call->request.mutable_ops()->ExtractSubrange(0, call->request.ops_size(), nullptr);
+    call->msg_refs.clear();
+  }
+  for (size_t i = 0; i != calls_.size(); ++i) {
+    sem_.Release();
+  }
 }
 
 Peer::~Peer() {
   Close();
 }
 
+// The RPC used by a RequestBatcher, and the flags that limit its batches.
+struct HeartbeatBatchTraits {
+  typedef ConsensusRequestPB Request;
+  typedef ConsensusResponsePB Response;
+  typedef MultiConsensusRequestPB MultiRequest;
+  typedef MultiConsensusResponsePB MultiResponse;
+
+  static const char* Name() { return "heartbeats"; }
+
+  static int BatchWindowMs() { return GetAtomicFlag(&FLAGS_consensus_heartbeat_batch_window_ms); }
+  static int MaxBatchSize() { return GetAtomicFlag(&FLAGS_consensus_heartbeat_max_batch_size); }
+
+  template <class... Args>
+  static void Send(ConsensusServiceProxy* proxy, Args&&... args) {
+    proxy->MultiUpdateConsensusAsync(std::forward<Args>(args)...);
+  }
+};
+
+struct VoteBatchTraits {
+  typedef VoteRequestPB Request;
+  typedef VoteResponsePB Response;
+  typedef MultiVoteRequestPB MultiRequest;
+  typedef MultiVoteResponsePB MultiResponse;
+
+  static const char* Name() { return "vote requests"; }
+
+  static int BatchWindowMs() { return GetAtomicFlag(&FLAGS_consensus_vote_batch_window_ms); }
+  static int MaxBatchSize() { return GetAtomicFlag(&FLAGS_consensus_vote_max_batch_size); }
+
+  template <class... Args>
+  static void Send(ConsensusServiceProxy* proxy, Args&&... args) {
+    proxy->MultiRequestConsensusVoteAsync(std::forward<Args>(args)...);
+  }
+};
+
+// Sends the requests to a server that are added within Traits::BatchWindowMs() of each other as
+// one RPC.
+template <class Traits>
+class RequestBatcher : public std::enable_shared_from_this<RequestBatcher<Traits>> {
+ public:
+  typedef typename Traits::Request Request;
+  typedef typename Traits::Response Response;
+
+  RequestBatcher(shared_ptr<Messenger> messenger, const Endpoint& endpoint)
+      : messenger_(std::move(messenger)), proxy_(messenger_, endpoint) {}
+
+  // The batch is sent with the smallest timeout of the controllers of its requests, or
+  // consensus_rpc_timeout_ms if none has one.
+  void Add(const Request* request,
+           Response* response,
+           const rpc::RpcController* controller,
+           std::function<void(const Status&)> callback);
+
+ private:
+  struct Entry {
+    const Request* request;
+    Response* response;
+    MonoDelta timeout;
+    std::function<void(const Status&)> callback;
+  };
+
+  struct Batch {
+    std::vector<Entry> entries;
+    typename Traits::MultiRequest request;
+    typename Traits::MultiResponse response;
+    RpcController controller;
+  };
+
+  void Flush();
+  void Send(std::vector<Entry> entries);
+  static void Finished(const std::shared_ptr<Batch>& batch);
+
+  const shared_ptr<Messenger> messenger_;
+  ConsensusServiceProxy proxy_;
+
+  std::mutex mutex_;
+  // Requests waiting for the flush. Protected by mutex_.
+  std::vector<Entry> pending_;
+  // Whether a flush of pending_ is scheduled. Protected by mutex_.
+  bool flush_scheduled_ = false;
+};
+
+template <class Traits>
+void RequestBatcher<Traits>::Add(const Request* request,
+                                 Response* response,
+                                 const rpc::RpcController* controller,
+                                 std::function<void(const Status&)> callback) {
+  std::vector<Entry> full_batch;
+  bool schedule_flush = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.push_back(Entry{request, response, controller->timeout(), std::move(callback)});
+    const size_t max_batch_size = std::max(Traits::MaxBatchSize(), 1);
+    if (pending_.size() >= max_batch_size) {
+      full_batch.swap(pending_);
+    } else if (!flush_scheduled_) {
+      flush_scheduled_ = true;
+      schedule_flush = true;
+    }
+  }
+  if (!full_batch.empty()) {
+    Send(std::move(full_batch));
+  }
+  if (schedule_flush) {
+    // The requests are flushed even if the task is aborted, so that their callers get a response.
+    auto self = this->shared_from_this();
+    messenger_->ScheduleOnReactor(
+        [self](const Status& status) { self->Flush(); },
+        MonoDelta::FromMilliseconds(Traits::BatchWindowMs()));
+  }
+}
+
+template <class Traits>
+void RequestBatcher<Traits>::Flush() {
+  std::vector<Entry> entries;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    flush_scheduled_ = false;
+    entries.swap(pending_);
+  }
+  if (!entries.empty()) {
+    Send(std::move(entries));
+  }
+}
+
+template <class Traits>
+void RequestBatcher<Traits>::Send(std::vector<Entry> entries) {
+  auto batch = std::make_shared<Batch>();
+  batch->entries = std::move(entries);
+  MonoDelta timeout;
+  for (const auto& entry : batch->entries) {
+    // Heartbeats carry no operations and vote requests are small, so copying them is cheap.
+    *batch->request.add_requests() = *entry.request;
+    if (entry.timeout.Initialized() && (!timeout.Initialized() || entry.timeout < timeout)) {
+      timeout = entry.timeout;
+    }
+  }
+  batch->controller.set_timeout(
+      timeout.Initialized() ? timeout : MonoDelta::FromMilliseconds(FLAGS_consensus_rpc_timeout_ms));
+  Traits::Send(&proxy_, batch->request, &batch->response, &batch->controller,
+               std::bind(&RequestBatcher::Finished, batch));
+}
+
+template <class Traits>
+void RequestBatcher<Traits>::Finished(const std::shared_ptr<Batch>& batch) {
+  Status status = batch->controller.status();
+  if (status.ok() &&
+      static_cast<size_t>(batch->response.responses_size()) != batch->entries.size()) {
+    status = STATUS_FORMAT(IllegalState, "$0 responses received for $1 $2",
+                           batch->response.responses_size(), batch->entries.size(), Traits::Name());
+  }
+  for (size_t i = 0; i != batch->entries.size(); ++i) {
+    const auto& entry = batch->entries[i];
+    if (status.ok()) {
+      entry.response->Swap(batch->response.mutable_responses(i));
+    }
+    entry.callback(status);
+  }
+}
+
+namespace {
+
+// The batchers of the servers that the tablets of this process send to, by messenger and server
+// address.
+template <class Batcher>
+class RequestBatchers {
+ public:
+  std::shared_ptr<Batcher> Get(const shared_ptr<Messenger>& messenger, const Endpoint& endpoint) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& weak_batcher = batchers_[std::make_pair(messenger.get(), endpoint)];
+    auto result = weak_batcher.lock();
+    if (!result) {
+      result = std::make_shared<Batcher>(messenger, endpoint);
+      weak_batcher = result;
+      // Drop the batchers of the servers that are no longer sent to.
+      for (auto it = batchers_.begin(); it != batchers_.end();) {
+        if (it->second.expired()) {
+          it = batchers_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+    return result;
+  }
+
+  static RequestBatchers& Instance() {
+    static RequestBatchers* instance = new RequestBatchers;
+    return *instance;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::map<std::pair<const Messenger*, Endpoint>, std::weak_ptr<Batcher>> batchers_;
+};
+
+} // namespace
+
 RpcPeerProxy::RpcPeerProxy(gscoped_ptr<HostPort> hostport,
-                           gscoped_ptr<ConsensusServiceProxy> consensus_proxy)
+                           gscoped_ptr<ConsensusServiceProxy> consensus_proxy,
+                           std::shared_ptr<HeartbeatBatcher> heartbeat_batcher,
+                           std::shared_ptr<VoteBatcher> vote_batcher)
     : hostport_(hostport.Pass()),
-      consensus_proxy_(consensus_proxy.Pass()) {
+      consensus_proxy_(consensus_proxy.Pass()),
+      heartbeat_batcher_(std::move(heartbeat_batcher)),
+      vote_batcher_(std::move(vote_batcher)) {
 }
 
 void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB* request,
@@ -417,6 +755,17 @@ void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB* request,
   consensus_proxy_->UpdateConsensusAsync(*request, response, controller, callback);
 }
 
+void RpcPeerProxy::HeartbeatAsync(const ConsensusRequestPB* request,
+                                  ConsensusResponsePB* response,
+                                  rpc::RpcController* controller,
+                                  const std::function<void(const Status&)>& callback) {
+  if (GetAtomicFlag(&FLAGS_consensus_heartbeat_batch_window_ms) <= 0) {
+    PeerProxy::HeartbeatAsync(request, response, controller, callback);
+    return;
+  }
+  heartbeat_batcher_->Add(request, response, controller, callback);
+}
+
 void RpcPeerProxy::RequestConsensusVoteAsync(const VoteRequestPB* request,
                                              VoteResponsePB* response,
                                              rpc::RpcController* controller,
@@ -424,6 +773,17 @@ void RpcPeerProxy::RequestConsensusVoteAsync(const VoteRequestPB* request,
   consensus_proxy_->RequestConsensusVoteAsync(*request, response, controller, callback);
 }
 
+void RpcPeerProxy::VoteAsync(const VoteRequestPB* request,
+                             VoteResponsePB* response,
+                             rpc::RpcController* controller,
+                             const std::function<void(const Status&)>& callback) {
+  if (GetAtomicFlag(&FLAGS_consensus_vote_batch_window_ms) <= 0) {
+    PeerProxy::VoteAsync(request, response, controller, callback);
+    return;
+  }
+  vote_batcher_->Add(request, response, controller, callback);
+}
+
 void RpcPeerProxy::RunLeaderElectionAsync(const RunLeaderElectionRequestPB* request,
                                           RunLeaderElectionResponsePB* response,
                                           rpc::RpcController* controller,
@@ -452,7 +812,8 @@ namespace {
 
 Status CreateConsensusServiceProxyForHost(const shared_ptr<Messenger>& messenger,
                                           const HostPort& hostport,
-                                          gscoped_ptr<ConsensusServiceProxy>* new_proxy) {
+                                          gscoped_ptr<ConsensusServiceProxy>* new_proxy,
+                                          Endpoint* endpoint = nullptr) {
   std::vector<Endpoint> addrs;
   RETURN_NOT_OK(hostport.ResolveAddresses(&addrs));
   if (addrs.size() > 1) {
@@ -461,6 +822,9 @@ Status CreateConsensusServiceProxyForHost(const shared_ptr<Messenger>& messenger
                  << addrs[0];
   }
   new_proxy->reset(new ConsensusServiceProxy(messenger, addrs[0]));
+  if (endpoint) {
+    *endpoint = addrs[0];
+  }
   return Status::OK();
 }
 
@@ -474,8 +838,12 @@ Status RpcPeerProxyFactory::NewProxy(const RaftPeerPB& peer_pb,
   gscoped_ptr<HostPort> hostport(new HostPort);
   RETURN_NOT_OK(HostPortFromPB(peer_pb.last_known_addr(), hostport.get()));
   gscoped_ptr<ConsensusServiceProxy> new_proxy;
-  RETURN_NOT_OK(CreateConsensusServiceProxyForHost(messenger_, *hostport, &new_proxy));
-  proxy->reset(new RpcPeerProxy(hostport.Pass(), new_proxy.Pass()));
+  Endpoint endpoint;
+  RETURN_NOT_OK(CreateConsensusServiceProxyForHost(messenger_, *hostport, &new_proxy, &endpoint));
+  proxy->reset(new RpcPeerProxy(
+      hostport.Pass(), new_proxy.Pass(),
+      RequestBatchers<HeartbeatBatcher>::Instance().Get(messenger_, endpoint),
+      RequestBatchers<VoteBatcher>::Instance().Get(messenger_, endpoint)));
   return Status::OK();
 }
 
@@ -33,7 +33,10 @@
 #ifndef YB_CONSENSUS_CONSENSUS_PEERS_H_
 #define YB_CONSENSUS_CONSENSUS_PEERS_H_
 
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -60,6 +63,11 @@ class Log;
 
 namespace consensus {
 class ConsensusServiceProxy;
+struct HeartbeatBatchTraits;
+template <class Traits> class RequestBatcher;
+struct VoteBatchTraits;
+typedef RequestBatcher<HeartbeatBatchTraits> HeartbeatBatcher;
+typedef RequestBatcher<VoteBatchTraits> VoteBatcher;
 class PeerProxy;
 class PeerProxyFactory;
 class PeerMessageQueue;
@@ -81,6 +89,10 @@ class VoteResponsePB;
 //
 // ProcessResponse() Called a response from a peer is received.
 //
+// Up to --consensus_max_in_flight_requests_per_peer requests can be processing at a time. A request
+// sent while others are processing is "pipelined": it only carries operations that follow the ones
+// already sent, so the diagrams below apply to each in-flight request.
+//
 // The following state diagrams describe what happens when a state changing method is called.
 //
 //                        +
@@ -157,28 +169,58 @@ class Peer {
        gscoped_ptr<PeerProxy> proxy, PeerMessageQueue* queue,
        ThreadPool* thread_pool, Consensus* consensus);
 
-  void SendNextRequest(RequestTriggerMode trigger_mode);
+  // The state of a single UpdateConsensus call to the peer.
+  struct UpdateCall {
+    ConsensusRequestPB request;
+    ConsensusResponsePB response;
+    rpc::RpcController controller;
+
+    // Reference-counted pointers to any ReplicateMsgs which are in-flight to the peer. We may have
+    // loaded these messages from the LogCache, in which case we are potentially sharing the same
+    // object as other peers. Since the PB request itself can't hold reference counts, this holds
+    // them.
+    ReplicateMsgs msg_refs;
+
+    // Number of the request among the ones sent to the peer.
+    uint64_t sequence_number = 0;
+
+    // Set when the request tells the peer that the leader is quiescent, to the time until which
+    // heartbeats are not needed if the peer accepts the request.
+    MonoTime quiescent_until;
+  };
+
+  // Called by the heartbeater. Sends a status-only request unless the peer is quiescent.
+  CHECKED_STATUS Heartbeat();
+
+  void SendNextRequest(RequestTriggerMode trigger_mode, UpdateCall* call);
 
-  // Signals that a response was received from the peer.  This method is called from the reactor
-  // thread and calls DoProcessResponse() on thread_pool_ to do any work that requires IO or
-  // lock-taking.
-  void ProcessResponse();
+  // Signals that a response was received from the peer, `status` is the status of the RPC.  This
+  // method is called from the reactor thread and calls DoProcessResponse() on thread_pool_ to do
+  // any work that requires IO or lock-taking.
+  void ProcessResponse(UpdateCall* call, const Status& status);
 
   // Run on 'thread_pool'. Does response handling that requires IO or may block.
-  void DoProcessResponse();
+  void DoProcessResponse(UpdateCall* call);
 
   // Fetch the desired remote bootstrap request from the queue and send it to the peer. The callback
   // goes to ProcessRemoteBootstrapResponse().
   //
   // Returns a bad Status if remote bootstrap is disabled, or if the request cannot be generated for
   // some reason.
-  CHECKED_STATUS SendRemoteBootstrapRequest();
+  CHECKED_STATUS SendRemoteBootstrapRequest(UpdateCall* call);
 
   // Handle RPC callback from initiating remote bootstrap.
-  void ProcessRemoteBootstrapResponse();
+  void ProcessRemoteBootstrapResponse(UpdateCall* call);
 
   // Signals there was an error sending the request to the peer.
-  void ProcessResponseError(const Status& status);
+  void ProcessResponseError(const Status& status, UpdateCall* call);
+
+  // Takes a call that is not in use, or returns nullptr if the peer is closed. Must hold a unit of
+  // sem_.
+  UpdateCall* AcquireCall(bool* pipelined);
+
+  // Returns the call to the free list and releases its unit of sem_.
+  void ReleaseCall(UpdateCall* call);
 
   std::string LogPrefixUnlocked() const;
 
@@ -192,26 +234,27 @@ class Peer {
   gscoped_ptr<PeerProxy> proxy_;
 
   PeerMessageQueue* queue_;
-  uint64_t failed_attempts_;
-
-  // The latest consensus update request and response.
-  ConsensusRequestPB request_;
-  ConsensusResponsePB response_;
+  std::atomic<uint64_t> failed_attempts_;
 
   // The latest remote bootstrap request and response.
   StartRemoteBootstrapRequestPB rb_request_;
   StartRemoteBootstrapResponsePB rb_response_;
 
-  // Reference-counted pointers to any ReplicateMsgs which are in-flight to the peer. We may have
-  // loaded these messages from the LogCache, in which case we are potentially sharing the same
-  // object as other peers. Since the PB request_ itself can't hold reference counts, this holds
-  // them.
-  ReplicateMsgs replicate_msg_refs_;
+  // One call per request that may be outstanding at a time, and the ones that are not in use.
+  // free_calls_ is protected by peer_lock_.
+  std::vector<std::unique_ptr<UpdateCall>> calls_;
+  std::vector<UpdateCall*> free_calls_;
 
-  rpc::RpcController controller_;
+  // Serializes assembling and sending requests, so that the queue sees them in the order they are
+  // sent.
+  std::mutex send_mutex_;
 
-  // Held if there is an outstanding request.  This is used in order to ensure that we only have a
-  // single request oustanding at a time, and to wait for the outstanding requests at Close().
+  // The committed index of the latest request assembled. Protected by send_mutex_.
+  int64_t last_sent_committed_index_ = kMinimumOpIdIndex;
+
+  // A unit is held for each outstanding request.  This is used in order to limit the number of
+  // requests outstanding at a time (see --consensus_max_in_flight_requests_per_peer), and to wait
+  // for the outstanding requests at Close().
   Semaphore sem_;
 
   // Heartbeater for remote peer implementations.  This will send status only requests to the remote
@@ -232,6 +275,13 @@ class Peer {
   // holding peer_lock_.
   mutable simple_spinlock peer_lock_;
   State state_;
+
+  // Sequence number of the last request sent. Protected by peer_lock_.
+  uint64_t last_sequence_number_ = 0;
+
+  // Heartbeats are skipped until this time, because the last request sent told the peer that the
+  // leader is quiescent and the peer accepted it. Protected by peer_lock_.
+  MonoTime quiescent_until_;
   Consensus* consensus_ = nullptr;
 };
 
@@ -246,12 +296,34 @@ class PeerProxy {
                            rpc::RpcController* controller,
                            const rpc::ResponseCallback& callback) = 0;
 
+  // Sends a status-only request, asynchronously, to a remote peer. Implementations may batch the
+  // requests to the same server, so `callback` gets the status of the RPC instead of `controller`.
+  virtual void HeartbeatAsync(const ConsensusRequestPB* request,
+                              ConsensusResponsePB* response,
+                              rpc::RpcController* controller,
+                              const std::function<void(const Status&)>& callback) {
+    UpdateAsync(request, response, controller, [controller, callback] {
+      callback(controller->status());
+    });
+  }
+
   // Sends a RequestConsensusVote to a remote peer.
   virtual void RequestConsensusVoteAsync(const VoteRequestPB* request,
                                          VoteResponsePB* response,
                                          rpc::RpcController* controller,
                                          const rpc::ResponseCallback& callback) = 0;
 
+  // Sends a RequestConsensusVote, asynchronously, to a remote peer. Implementations may batch the
+  // requests to the same server, so `callback` gets the status of the RPC instead of `controller`.
+  virtual void VoteAsync(const VoteRequestPB* request,
+                         VoteResponsePB* response,
+                         rpc::RpcController* controller,
+                         const std::function<void(const Status&)>& callback) {
+    RequestConsensusVoteAsync(request, response, controller, [controller, callback] {
+      callback(controller->status());
+    });
+  }
+
   // Instructs a peer to begin a remote bootstrap session.
   virtual void StartRemoteBootstrap(const StartRemoteBootstrapRequestPB* request,
                                     StartRemoteBootstrapResponsePB* response,
@@ -293,18 +365,30 @@ class PeerProxyFactory {
 class RpcPeerProxy : public PeerProxy {
  public:
   RpcPeerProxy(gscoped_ptr<HostPort> hostport,
-               gscoped_ptr<ConsensusServiceProxy> consensus_proxy);
+               gscoped_ptr<ConsensusServiceProxy> consensus_proxy,
+               std::shared_ptr<HeartbeatBatcher> heartbeat_batcher,
+               std::shared_ptr<VoteBatcher> vote_batcher);
 
   virtual void UpdateAsync(const ConsensusRequestPB* request,
                            ConsensusResponsePB* response,
                            rpc::RpcController* controller,
                            const rpc::ResponseCallback& callback) override;
 
+  virtual void HeartbeatAsync(const ConsensusRequestPB* request,
+                              ConsensusResponsePB* response,
+                              rpc::RpcController* controller,
+                              const std::function<void(const Status&)>& callback) override;
+
   virtual void RequestConsensusVoteAsync(const VoteRequestPB* request,
                                          VoteResponsePB* response,
                                          rpc::RpcController* controller,
                                          const rpc::ResponseCallback& callback) override;
 
+  virtual void VoteAsync(const VoteRequestPB* request,
+                         VoteResponsePB* response,
+                         rpc::RpcController* controller,
+                         const std::function<void(const Status&)>& callback) override;
+
   virtual void StartRemoteBootstrap(const StartRemoteBootstrapRequestPB* request,
                                     StartRemoteBootstrapResponsePB* response,
                                     rpc::RpcController* controller,
@@ -325,6 +409,9 @@ class RpcPeerProxy : public PeerProxy {
  private:
   gscoped_ptr<HostPort> hostport_;
   gscoped_ptr<ConsensusServiceProxy> consensus_proxy_;
+  // Shared by the proxies to the same server.
+  std::shared_ptr<HeartbeatBatcher> heartbeat_batcher_;
+  std::shared_ptr<VoteBatcher> vote_batcher_;
 };
 
 // PeerProxyFactory implementation that generates RPCPeerProxies
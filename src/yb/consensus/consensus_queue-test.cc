@@ -50,6 +50,7 @@
 
 DECLARE_bool(enable_data_block_fsync);
 DECLARE_int32(consensus_max_batch_size_bytes);
+DECLARE_int32(raft_quiescent_heartbeat_interval_ms);
 
 METRIC_DECLARE_entity(tablet);
 
@@ -257,6 +258,54 @@ TEST_F(ConsensusQueueTest, TestStartTrackingAfterStart) {
 
 // Tests that the peers gets the messages pages, with the size of a page
 // being 'consensus_max_batch_size_bytes'
+// Tests that a peer is told that the leader is quiescent only while it has all operations and
+// knows that they are committed.
+TEST_F(ConsensusQueueTest, TestQuiescentPeer) {
+  FLAGS_raft_quiescent_heartbeat_interval_ms = 5000;
+  queue_->Init(MinimumOpId());
+  queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), BuildRaftConfigPBForTests(2));
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 1, 10);
+  WaitForLocalPeerToAckIndex(10);
+
+  ConsensusRequestPB request;
+  ConsensusResponsePB response;
+  bool more_pending = false;
+  const OpId last_op = MakeOpId(1, 10);
+  UpdatePeerWatermarkToOp(&request, &response, last_op, last_op, MinimumOpId().index(),
+                          &more_pending);
+
+  ReplicateMsgs refs;
+  bool needs_remote_bootstrap;
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_EQ(0, request.ops_size());
+  ASSERT_FALSE(request.has_quiescent_heartbeat_interval_ms());
+
+  // The peer has all operations, but does not know yet that they are committed.
+  SetLastReceivedAndLastCommitted(&response, last_op, MinimumOpId().index());
+  queue_->ResponseFromPeer(response.responder_uuid(), response, &more_pending);
+  queue_->observers_pool_->Wait();
+  ASSERT_OPID_EQ(last_op, queue_->GetCommittedIndexForTests());
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_EQ(0, request.ops_size());
+  ASSERT_FALSE(request.has_quiescent_heartbeat_interval_ms());
+
+  SetLastReceivedAndLastCommitted(&response, last_op);
+  queue_->ResponseFromPeer(response.responder_uuid(), response, &more_pending);
+  ASSERT_FALSE(more_pending);
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_EQ(0, request.ops_size());
+  ASSERT_EQ(5000, request.quiescent_heartbeat_interval_ms());
+
+  // A new operation ends the quiescence.
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 11, 1);
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_EQ(1, request.ops_size());
+  ASSERT_FALSE(request.has_quiescent_heartbeat_interval_ms());
+
+  // extract the ops from the request to avoid double free
+  request.mutable_ops()->ExtractSubrange(0, request.ops_size(), nullptr);
+}
+
 TEST_F(ConsensusQueueTest, TestGetPagedMessages) {
   queue_->Init(MinimumOpId());
   queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), BuildRaftConfigPBForTests(2));
@@ -334,6 +383,92 @@ TEST_F(ConsensusQueueTest, TestGetPagedMessages) {
   request.mutable_ops()->ExtractSubrange(0, request.ops_size(), nullptr);
 }
 
+// Tests that a pipelined request continues after the operations of the requests in flight, and
+// that it is only filled once the peer is in sync.
+TEST_F(ConsensusQueueTest, TestPipelinedRequests) {
+  queue_->Init(MinimumOpId());
+  queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), BuildRaftConfigPBForTests(2));
+
+  const int kOpsPerRequest = 9;
+  int32_t page_size_estimate;
+  {
+    ConsensusRequestPB page_size_estimator;
+    page_size_estimator.set_caller_term(14);
+    page_size_estimator.mutable_committed_index()->CopyFrom(MinimumOpId());
+    page_size_estimator.mutable_preceding_id()->CopyFrom(MinimumOpId());
+    page_size_estimator.set_leader_lease_duration_ms(kDefaultLeaderLeaseDurationMs);
+    page_size_estimator.set_ht_lease_expiration(1000);
+    ReplicateMsgs replicates;
+    for (int i = 0; i < kOpsPerRequest; i++) {
+      replicates.push_back(CreateDummyReplicate(0, 0, clock_->Now(), 0));
+      page_size_estimator.mutable_ops()->AddAllocated(replicates.back().get());
+    }
+    page_size_estimate = page_size_estimator.ByteSize();
+    page_size_estimator.mutable_ops()->ExtractSubrange(0,
+                                                       page_size_estimator.ops_size(),
+                                                       /* elements */ nullptr);
+  }
+  google::FlagSaver saver;
+  FLAGS_consensus_max_batch_size_bytes = page_size_estimate;
+
+  ConsensusRequestPB request;
+  ConsensusResponsePB response;
+  response.set_responder_uuid(kPeerUuid);
+  bool more_pending = false;
+
+  UpdatePeerWatermarkToOp(&request, &response, MinimumOpId(), MinimumOpId(), &more_pending);
+  ASSERT_TRUE(more_pending);
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 1, 100);
+
+  // The last exchange failed, so a pipelined request carries no operations.
+  ReplicateMsgs refs;
+  bool needs_remote_bootstrap;
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap,
+                                   nullptr /* member_type */,
+                                   nullptr /* last_exchange_successful */,
+                                   true /* pipelined */));
+  ASSERT_EQ(0, request.ops_size());
+
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_EQ(kOpsPerRequest, request.ops_size());
+  queue_->RequestSent(kPeerUuid, request);
+  SetLastReceivedAndLastCommitted(&response, request.ops(kOpsPerRequest - 1).id());
+  queue_->ResponseFromPeer(response.responder_uuid(), response, &more_pending);
+  ASSERT_TRUE(more_pending);
+
+  // The peer is in sync now, so the second request is pipelined after the first one.
+  ConsensusRequestPB pipelined_request;
+  ReplicateMsgs pipelined_refs;
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_EQ(kOpsPerRequest, request.ops_size());
+  ASSERT_EQ(kOpsPerRequest + 1, request.ops(0).id().index());
+  queue_->RequestSent(kPeerUuid, request);
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &pipelined_request, &pipelined_refs,
+                                   &needs_remote_bootstrap,
+                                   nullptr /* member_type */,
+                                   nullptr /* last_exchange_successful */,
+                                   true /* pipelined */));
+  ASSERT_EQ(kOpsPerRequest, pipelined_request.ops_size());
+  ASSERT_EQ(2 * kOpsPerRequest + 1, pipelined_request.ops(0).id().index());
+  queue_->RequestSent(kPeerUuid, pipelined_request);
+  ASSERT_EQ(2, queue_->GetTrackedPeerForTests(kPeerUuid).in_flight_requests.size());
+
+  SetLastReceivedAndLastCommitted(&response, request.ops(kOpsPerRequest - 1).id());
+  queue_->ResponseFromPeer(response.responder_uuid(), response, &more_pending);
+  SetLastReceivedAndLastCommitted(&response, pipelined_request.ops(kOpsPerRequest - 1).id());
+  queue_->ResponseFromPeer(response.responder_uuid(), response, &more_pending);
+  ASSERT_TRUE(more_pending);
+
+  auto peer = queue_->GetTrackedPeerForTests(kPeerUuid);
+  ASSERT_EQ(3 * kOpsPerRequest, peer.last_received.index());
+  ASSERT_EQ(3 * kOpsPerRequest + 1, peer.next_index);
+  ASSERT_TRUE(peer.in_flight_requests.empty());
+
+  // extract the ops from the requests to avoid double free
+  request.mutable_ops()->ExtractSubrange(0, request.ops_size(), nullptr);
+  pipelined_request.mutable_ops()->ExtractSubrange(0, pipelined_request.ops_size(), nullptr);
+}
+
 TEST_F(ConsensusQueueTest, TestPeersDontAckBeyondWatermarks) {
   queue_->Init(MinimumOpId());
   queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), BuildRaftConfigPBForTests(3));
@@ -842,5 +977,59 @@ TEST_F(ConsensusQueueTest, TestTriggerRemoteBootstrapIfTabletNotFound) {
             rb_req.bootstrap_peer_addr().ShortDebugString());
 }
 
+// Test that a new peer is remote bootstrapped from an up-to-date follower in its zone.
+TEST_F(ConsensusQueueTest, TestRemoteBootstrapFromClosestPeer) {
+  const char* kFollowerUuid = "peer-2";
+  RaftConfigPB config = BuildRaftConfigPBForTests(3);
+  for (int i = 0; i < config.peers_size(); ++i) {
+    CloudInfoPB* cloud_info = config.mutable_peers(i)->mutable_cloud_info();
+    cloud_info->set_placement_cloud("cloud");
+    cloud_info->set_placement_region("region");
+    // The leader is the only peer in zone-0.
+    cloud_info->set_placement_zone(i == 0 ? "zone-0" : "zone-1");
+  }
+
+  queue_->Init(MinimumOpId());
+  queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), config);
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 1, 100);
+
+  ConsensusRequestPB request;
+  ConsensusResponsePB response;
+  ReplicateMsgs refs;
+  bool needs_remote_bootstrap;
+  bool more_pending = false;
+
+  // The follower acks all the operations.
+  queue_->TrackPeer(kFollowerUuid);
+  ASSERT_OK(queue_->RequestForPeer(kFollowerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_FALSE(needs_remote_bootstrap);
+  response.set_responder_uuid(kFollowerUuid);
+  SetLastReceivedAndLastCommitted(&response, MakeOpId(14, 100));
+  queue_->ResponseFromPeer(kFollowerUuid, response, &more_pending);
+
+  // The new peer doesn't have the tablet.
+  queue_->TrackPeer(kPeerUuid);
+  request.Clear();
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  response.Clear();
+  response.set_responder_uuid(kPeerUuid);
+  response.mutable_error()->set_code(tserver::TabletServerErrorPB::TABLET_NOT_FOUND);
+  StatusToPB(STATUS(NotFound, "No such tablet"), response.mutable_error()->mutable_status());
+  queue_->ResponseFromPeer(kPeerUuid, response, &more_pending);
+  request.Clear();
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_TRUE(needs_remote_bootstrap);
+
+  StartRemoteBootstrapRequestPB rb_req;
+  ASSERT_OK(queue_->GetRemoteBootstrapRequestForPeer(kPeerUuid, &rb_req));
+  ASSERT_EQ(kFollowerUuid, rb_req.bootstrap_peer_uuid());
+  ASSERT_EQ(config.peers(2).last_known_addr().ShortDebugString(),
+            rb_req.bootstrap_peer_addr().ShortDebugString());
+  ASSERT_EQ(kLeaderUuid, rb_req.leader_uuid());
+  ASSERT_EQ(FakeRaftPeerPB(kLeaderUuid).last_known_addr().ShortDebugString(),
+            rb_req.leader_addr().ShortDebugString());
+  request.mutable_ops()->ExtractSubrange(0, request.ops_size(), nullptr);
+}
+
 }  // namespace consensus
 }  // namespace yb
@@ -92,7 +92,14 @@ DEFINE_int32(consensus_inject_latency_ms_in_notifications, 0,
 TAG_FLAG(consensus_inject_latency_ms_in_notifications, hidden);
 TAG_FLAG(consensus_inject_latency_ms_in_notifications, unsafe);
 
+DEFINE_bool(remote_bootstrap_from_closest_peer, true,
+            "When set, the leader asks new peers to remote bootstrap from an up-to-date follower "
+            "placed closer to them than the leader, e.g. in the same zone. The new peer then only "
+            "catches up the log tail from the leader.");
+TAG_FLAG(remote_bootstrap_from_closest_peer, advanced);
+
 DECLARE_int32(rpc_max_message_size);
+DECLARE_int32(raft_quiescent_heartbeat_interval_ms);
 
 namespace yb {
 namespace consensus {
@@ -103,6 +110,21 @@ using rpc::Messenger;
 using util::to_underlying;
 using strings::Substitute;
 
+namespace {
+
+// Returns how close two placements are: 2 for the same zone, 1 for the same region and 0
+// otherwise, including when the placement is unknown.
+int PlacementProximity(const CloudInfoPB& lhs, const CloudInfoPB& rhs) {
+  if (lhs.placement_region().empty() ||
+      lhs.placement_cloud() != rhs.placement_cloud() ||
+      lhs.placement_region() != rhs.placement_region()) {
+    return 0;
+  }
+  return lhs.placement_zone() == rhs.placement_zone() ? 2 : 1;
+}
+
+} // namespace
+
 METRIC_DEFINE_gauge_int64(tablet, majority_done_ops, "Leader Operations Acked by Majority",
                           MetricUnit::kOperations,
                           "Number of operations in the leader queue ack'd by a majority but "
@@ -169,6 +191,7 @@ void PeerMessageQueue::SetLeaderMode(const OpId& committed_index,
       << queue_state_.active_config->ShortDebugString();
   queue_state_.majority_size_ = MajoritySize(CountVoters(*queue_state_.active_config));
   queue_state_.mode = Mode::LEADER;
+  log_cache_.SetIsLeader(true);
 
   LOG_WITH_PREFIX_UNLOCKED(INFO) << "Queue going to LEADER mode. State: "
       << queue_state_.ToString();
@@ -187,6 +210,7 @@ void PeerMessageQueue::SetNonLeaderMode() {
   queue_state_.active_config.reset();
   queue_state_.mode = Mode::NON_LEADER;
   queue_state_.majority_size_ = -1;
+  log_cache_.SetIsLeader(false);
   LOG_WITH_PREFIX_UNLOCKED(INFO) << "Queue going to NON_LEADER mode. State: "
       << queue_state_.ToString();
 }
@@ -310,10 +334,13 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
                                         ReplicateMsgs* msg_refs,
                                         bool* needs_remote_bootstrap,
                                         RaftPeerPB::MemberType* member_type,
-                                        bool* last_exchange_successful) {
+                                        bool* last_exchange_successful,
+                                        bool pipelined) {
   TrackedPeer* peer = nullptr;
   OpId preceding_id;
   MonoDelta unreachable_time = MonoDelta::kMin;
+  // The index of the first operation to send, or kInvalidOpIdIndex for a status-only request.
+  int64_t next_index = kInvalidOpIdIndex;
   {
     LockGuard lock(queue_lock_);
     DCHECK_EQ(queue_state_.state, State::kQueueOpen);
@@ -343,6 +370,30 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     request->set_caller_term(queue_state_.current_term);
     unreachable_time =
         MonoTime::Now().GetDeltaSince(peer->last_successful_communication_time);
+
+    // If we've never communicated with the peer, we don't know what messages to send, so we'll
+    // send a status-only request. The same goes for a pipelined request to a peer we are not in
+    // sync with, as its entries would most likely be rejected.
+    if (!peer->is_new && (!pipelined || peer->is_last_exchange_successful)) {
+      next_index = peer->next_index;
+      if (pipelined && !peer->in_flight_requests.empty()) {
+        next_index = std::max(next_index, peer->in_flight_requests.back().next_index);
+      }
+    }
+
+    // A peer is quiescent when it has all operations and knows that they are committed, so that
+    // only the leader lease would change with the next request.
+    const auto quiescent_heartbeat_interval_ms =
+        GetAtomicFlag(&FLAGS_raft_quiescent_heartbeat_interval_ms);
+    if (quiescent_heartbeat_interval_ms > 0 && !pipelined && !peer->is_new &&
+        peer->is_last_exchange_successful && peer->in_flight_requests.empty() &&
+        OpIdEquals(peer->last_received, queue_state_.last_appended) &&
+        OpIdEquals(queue_state_.committed_index, queue_state_.last_appended) &&
+        peer->last_known_committed_idx == queue_state_.committed_index.index()) {
+      request->set_quiescent_heartbeat_interval_ms(quiescent_heartbeat_interval_ms);
+    } else {
+      request->clear_quiescent_heartbeat_interval_ms();
+    }
   }
 
   if (unreachable_time.ToSeconds() > FLAGS_follower_unavailable_considered_failed_sec) {
@@ -367,17 +418,15 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
   }
   *needs_remote_bootstrap = false;
 
-  // If we've never communicated with the peer, we don't know what messages to
-  // send, so we'll send a status-only request. Otherwise, we grab requests
-  // from the log starting at the last_received point.
-  if (!peer->is_new) {
+  // Grab requests from the log starting at the peer's next index.
+  if (next_index != kInvalidOpIdIndex) {
     DCHECK_LT(FLAGS_consensus_max_batch_size_bytes + 1_KB, FLAGS_rpc_max_message_size);
     // The batch of messages to send to the peer.
     ReplicateMsgs messages;
     int max_batch_size = FLAGS_consensus_max_batch_size_bytes - request->ByteSize();
 
     // We try to get the follower's next_index from our log.
-    Status s = log_cache_.ReadOps(peer->next_index - 1,
+    Status s = log_cache_.ReadOps(next_index - 1,
                                   max_batch_size,
                                   &messages,
                                   &preceding_id);
@@ -434,6 +483,28 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
   return Status::OK();
 }
 
+void PeerMessageQueue::RequestSent(const std::string& uuid, const ConsensusRequestPB& request) {
+  LockGuard lock(queue_lock_);
+  TrackedPeer* peer = FindPtrOrNull(peers_map_, uuid);
+  if (PREDICT_FALSE(peer == nullptr)) {
+    return;
+  }
+  const auto& last_id = request.ops_size() > 0 ? request.ops(request.ops_size() - 1).id()
+                                               : request.preceding_id();
+  peer->in_flight_requests.push_back(TrackedPeer::InFlightRequest{
+      last_id.index() + 1,
+      peer->last_leader_lease_expiration_sent_to_follower,
+      peer->last_ht_lease_expiration_sent_to_follower});
+}
+
+void PeerMessageQueue::RequestFailed(const std::string& uuid) {
+  LockGuard lock(queue_lock_);
+  TrackedPeer* peer = FindPtrOrNull(peers_map_, uuid);
+  if (PREDICT_TRUE(peer != nullptr) && !peer->in_flight_requests.empty()) {
+    peer->in_flight_requests.pop_front();
+  }
+}
+
 Status PeerMessageQueue::GetRemoteBootstrapRequestForPeer(const string& uuid,
                                                           StartRemoteBootstrapRequestPB* req) {
   TrackedPeer* peer = nullptr;
@@ -459,13 +530,71 @@ Status PeerMessageQueue::GetRemoteBootstrapRequestForPeer(const string& uuid,
   req->Clear();
   req->set_dest_uuid(uuid);
   req->set_tablet_id(tablet_id_);
-  req->set_bootstrap_peer_uuid(local_peer_pb_.permanent_uuid());
-  *req->mutable_bootstrap_peer_addr() = local_peer_pb_.last_known_addr();
-  req->set_caller_term(queue_state_.current_term);
+  {
+    LockGuard lock(queue_lock_);
+    const RaftPeerPB* source = SelectRemoteBootstrapSourceUnlocked(uuid);
+    if (source != nullptr) {
+      LOG_WITH_PREFIX_UNLOCKED(INFO) << "Remote bootstrapping peer " << uuid
+                                     << " from the closer peer " << source->permanent_uuid();
+      req->set_bootstrap_peer_uuid(source->permanent_uuid());
+      *req->mutable_bootstrap_peer_addr() = source->last_known_addr();
+      req->set_leader_uuid(local_peer_pb_.permanent_uuid());
+      *req->mutable_leader_addr() = local_peer_pb_.last_known_addr();
+    } else {
+      req->set_bootstrap_peer_uuid(local_peer_pb_.permanent_uuid());
+      *req->mutable_bootstrap_peer_addr() = local_peer_pb_.last_known_addr();
+    }
+    req->set_caller_term(queue_state_.current_term);
+  }
   peer->needs_remote_bootstrap = false; // Now reset the flag.
   return Status::OK();
 }
 
+const RaftPeerPB* PeerMessageQueue::SelectRemoteBootstrapSourceUnlocked(
+    const string& uuid) const {
+  if (!FLAGS_remote_bootstrap_from_closest_peer || !queue_state_.active_config) {
+    return nullptr;
+  }
+  const RaftConfigPB& config = *queue_state_.active_config;
+  const RaftPeerPB* target = nullptr;
+  const RaftPeerPB* leader = nullptr;
+  for (const RaftPeerPB& peer_pb : config.peers()) {
+    if (peer_pb.permanent_uuid() == uuid) {
+      target = &peer_pb;
+    } else if (peer_pb.permanent_uuid() == local_peer_pb_.permanent_uuid()) {
+      leader = &peer_pb;
+    }
+  }
+  if (target == nullptr || !target->has_cloud_info()) {
+    return nullptr;
+  }
+
+  // The leader is only skipped for a peer that is strictly closer to the target.
+  int best_proximity = leader != nullptr && leader->has_cloud_info()
+      ? PlacementProximity(target->cloud_info(), leader->cloud_info()) : 0;
+  const RaftPeerPB* best = nullptr;
+  for (const RaftPeerPB& peer_pb : config.peers()) {
+    if (&peer_pb == target || &peer_pb == leader || peer_pb.member_type() != RaftPeerPB::VOTER ||
+        !peer_pb.has_last_known_addr()) {
+      continue;
+    }
+    const int proximity = PlacementProximity(target->cloud_info(), peer_pb.cloud_info());
+    if (proximity <= best_proximity) {
+      continue;
+    }
+    // The source must have all the committed operations, the rest is replicated by the leader.
+    const TrackedPeer* tracked = FindPtrOrNull(peers_map_, peer_pb.permanent_uuid());
+    if (tracked == nullptr || !tracked->is_last_exchange_successful ||
+        tracked->needs_remote_bootstrap ||
+        tracked->last_received.index() < queue_state_.committed_index.index()) {
+      continue;
+    }
+    best = &peer_pb;
+    best_proximity = proximity;
+  }
+  return best;
+}
+
 void PeerMessageQueue::UpdateAllReplicatedOpId(OpId* result) {
   OpId new_op_id = MaximumOpId();
 
@@ -638,6 +767,17 @@ void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
       return;
     }
 
+    // Responses are matched with requests in the order the requests were sent. If there is no
+    // such request, fall back to the leases sent last, as it was done before pipelining.
+    TrackedPeer::InFlightRequest completed_request{
+        kInvalidOpIdIndex,
+        peer->last_leader_lease_expiration_sent_to_follower,
+        peer->last_ht_lease_expiration_sent_to_follower};
+    if (!peer->in_flight_requests.empty()) {
+      completed_request = peer->in_flight_requests.front();
+      peer->in_flight_requests.pop_front();
+    }
+
     // Remotely bootstrap the peer if the tablet is not found or deleted.
     if (response.has_error()) {
       // We only let special types of errors through to this point from the peer.
@@ -696,8 +836,12 @@ void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
 
     bool peer_has_prefix_of_log = IsOpInLog(status.last_received());
     if (peer_has_prefix_of_log) {
-      // If the latest thing in their log is in our log, we are in sync.
-      peer->last_received = status.last_received();
+      // If the latest thing in their log is in our log, we are in sync. A late response to a
+      // pipelined request must not move the peer back past what a newer response reported.
+      if (status.has_error() || previous.is_new || peer->in_flight_requests.empty() ||
+          status.last_received().index() >= previous.last_received.index()) {
+        peer->last_received = status.last_received();
+      }
       peer->next_index = peer->last_received.index() + 1;
 
     } else if (!OpIdEquals(status.last_received_current_leader(), MinimumOpId())) {
@@ -785,11 +929,13 @@ void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
       }
       majority_replicated.op_id = queue_state_.majority_replicated_opid;
 
-      peer->last_leader_lease_expiration_received_by_follower =
-          peer->last_leader_lease_expiration_sent_to_follower;
+      peer->last_leader_lease_expiration_received_by_follower = std::max(
+          peer->last_leader_lease_expiration_received_by_follower,
+          completed_request.leader_lease_expiration);
 
-      peer->last_ht_lease_expiration_received_by_follower =
-          peer->last_ht_lease_expiration_sent_to_follower;
+      peer->last_ht_lease_expiration_received_by_follower = std::max(
+          peer->last_ht_lease_expiration_received_by_follower,
+          completed_request.ht_lease_expiration);
 
       majority_replicated.leader_lease_expiration = LeaderLeaseExpirationWatermark();
 
@@ -814,6 +960,23 @@ PeerMessageQueue::TrackedPeer PeerMessageQueue::GetTrackedPeerForTests(string uu
   return *tracked;
 }
 
+Status PeerMessageQueue::ReadReplicatedMessagesForCDC(int64_t after_op_index,
+                                                      int64_t up_to_index,
+                                                      int max_size_bytes,
+                                                      ReplicateMsgs* msgs) {
+  msgs->clear();
+  if (after_op_index >= up_to_index) {
+    return Status::OK();
+  }
+  OpId preceding_id;
+  RETURN_NOT_OK(log_cache_.ReadOps(after_op_index, max_size_bytes, msgs, &preceding_id));
+  // The cache also has the operations that are appended, but not committed yet.
+  while (!msgs->empty() && msgs->back()->id().index() > up_to_index) {
+    msgs->pop_back();
+  }
+  return Status::OK();
+}
+
 OpId PeerMessageQueue::GetAllReplicatedIndexForTests() const {
   LockGuard lock(queue_lock_);
   return queue_state_.all_replicated_opid;
@@ -33,6 +33,7 @@
 #ifndef YB_CONSENSUS_CONSENSUS_QUEUE_H_
 #define YB_CONSENSUS_CONSENSUS_QUEUE_H_
 
+#include <deque>
 #include <iosfwd>
 #include <map>
 #include <string>
@@ -151,6 +152,20 @@ class PeerMessageQueue {
     // Member type of this peer in the config.
     RaftPeerPB::MemberType member_type = RaftPeerPB::UNKNOWN_MEMBER_TYPE;
 
+    // A request that was sent to the peer and has not completed yet.
+    struct InFlightRequest {
+      // The index following the last operation included in the request.
+      int64_t next_index;
+
+      // The leader lease expirations that were sent to the follower with the request.
+      MonoTime leader_lease_expiration;
+      MicrosTime ht_lease_expiration;
+    };
+
+    // Requests sent to the peer that have not completed yet, oldest first. There can be more than
+    // one when requests are pipelined (see --consensus_max_in_flight_requests_per_peer).
+    std::deque<InFlightRequest> in_flight_requests;
+
    private:
     // The last term we saw from a given peer.
     // This is only used for sanity checking that a peer doesn't
@@ -229,17 +244,39 @@ class PeerMessageQueue {
   // not delete the entries. The simplest way is to pass the same instance of ConsensusRequestPB to
   // RequestForPeer(): the buffer will replace the old entries with new ones without de-allocating
   // the old ones if they are still required.
+  //
+  // If 'pipelined' is true, the request is meant to be sent while other requests to the peer are
+  // still in flight, so its entries start right after the ones of the last request sent. No entries
+  // are added if the peer is not known to be in sync, so that pipelining only happens once the
+  // peer accepts our entries.
   virtual CHECKED_STATUS RequestForPeer(
       const std::string& uuid,
       ConsensusRequestPB* request,
       ReplicateMsgs* msg_refs,
       bool* needs_remote_bootstrap,
       RaftPeerPB::MemberType* member_type = nullptr,
-      bool* last_exchange_successful = nullptr);
+      bool* last_exchange_successful = nullptr,
+      bool pipelined = false);
+
+  // Reads the operations after 'after_op_index' and up to 'up_to_index' for change data capture.
+  // Reads at most 'max_size_bytes', unless that would return nothing, see LogCache::ReadOps().
+  CHECKED_STATUS ReadReplicatedMessagesForCDC(int64_t after_op_index,
+                                              int64_t up_to_index,
+                                              int max_size_bytes,
+                                              ReplicateMsgs* msgs);
+
+  // Records that 'request', as last assembled by RequestForPeer() for the peer, is being sent. Each
+  // sent request must be completed later by either ResponseFromPeer() or RequestFailed().
+  void RequestSent(const std::string& uuid, const ConsensusRequestPB& request);
+
+  // Records that the oldest request in flight to the peer completed without a response that could
+  // be passed to ResponseFromPeer(), e.g. because of a network error.
+  void RequestFailed(const std::string& uuid);
 
   // Fill in a StartRemoteBootstrapRequest for the specified peer.  If that peer should not remotely
   // bootstrap, returns a non-OK status.  On success, also internally resets
-  // peer->needs_remote_bootstrap to false.
+  // peer->needs_remote_bootstrap to false. The bootstrap source is an up-to-date follower closer to
+  // the peer than this leader when there is one, see FLAGS_remote_bootstrap_from_closest_peer.
   CHECKED_STATUS GetRemoteBootstrapRequestForPeer(
       const std::string& uuid,
       StartRemoteBootstrapRequestPB* req);
@@ -297,6 +334,7 @@ class PeerMessageQueue {
 
  private:
   FRIEND_TEST(ConsensusQueueTest, TestQueueAdvancesCommittedIndex);
+  FRIEND_TEST(ConsensusQueueTest, TestQuiescentPeer);
 
   // Mode specifies how the queue currently behaves:
   //
@@ -400,6 +438,10 @@ class PeerMessageQueue {
   // mode, does nothing.
   void CheckPeersInActiveConfigIfLeaderUnlocked() const;
 
+  // Returns the follower in the active config that the peer with the given uuid should remote
+  // bootstrap from, or nullptr if it should bootstrap from this leader.
+  const RaftPeerPB* SelectRemoteBootstrapSourceUnlocked(const std::string& uuid) const;
+
   // Callback when a REPLICATE message has finished appending to the local log.
   void LocalPeerAppendFinished(const OpId& id,
                                const StatusCallback& callback,
@@ -261,12 +261,13 @@ void LeaderElection::Run() {
 
     LeaderElectionPtr retained_self = this;
     if (!suppress_vote_request_) {
-      state->proxy->RequestConsensusVoteAsync(
+      state->proxy->VoteAsync(
           &state->request, &state->response, &state->rpc,
-          std::bind(&LeaderElection::VoteResponseRpcCallback, this, voter_uuid, retained_self));
+          std::bind(&LeaderElection::VoteResponseRpcCallback, this, voter_uuid, retained_self,
+                    std::placeholders::_1));
     } else {
       state->response.set_responder_uuid(voter_uuid);
-      VoteResponseRpcCallback(voter_uuid, retained_self);
+      VoteResponseRpcCallback(voter_uuid, retained_self, Status::OK());
     }
   }
 }
@@ -303,7 +304,8 @@ void LeaderElection::CheckForDecision() {
 }
 
 void LeaderElection::VoteResponseRpcCallback(const std::string& voter_uuid,
-                                             const LeaderElectionPtr& self) {
+                                             const LeaderElectionPtr& self,
+                                             const Status& rpc_status) {
   {
     std::lock_guard<Lock> guard(lock_);
     auto it = voter_state_.find(voter_uuid);
@@ -311,9 +313,9 @@ void LeaderElection::VoteResponseRpcCallback(const std::string& voter_uuid,
     VoterState* state = it->second.get();
 
     // Check for RPC errors.
-    if (!state->rpc.status().ok()) {
+    if (!rpc_status.ok()) {
       LOG_WITH_PREFIX(WARNING) << "RPC error from VoteRequest() call to peer " << voter_uuid
-                  << ": " << state->rpc.status().ToString();
+                  << ": " << rpc_status.ToString();
       RecordVoteUnlocked(voter_uuid, VOTE_DENIED);
 
     // Check for tablet errors.
@@ -380,7 +382,12 @@ void LeaderElection::HandleHigherTermUnlocked(const string& voter_uuid, const Vo
 
 void LeaderElection::HandleVoteGrantedUnlocked(const string& voter_uuid, const VoterState& state) {
   DCHECK(lock_.is_locked());
-  DCHECK_EQ(state.response.responder_term(), election_term());
+  // Voters do not advance their term for a pre-vote.
+  if (request_.preelection()) {
+    DCHECK_LE(state.response.responder_term(), election_term());
+  } else {
+    DCHECK_EQ(state.response.responder_term(), election_term());
+  }
   DCHECK(state.response.vote_granted());
   if (state.response.has_remaining_leader_lease_duration_ms()) {
     old_leader_lease_expiration_.MakeAtLeast(MonoTime::Now() +
@@ -413,10 +420,11 @@ void LeaderElection::HandleVoteDeniedUnlocked(const string& voter_uuid, const Vo
 }
 
 std::string LeaderElection::LogPrefix() const {
-  return Substitute("T $0 P $1 [CANDIDATE]: Term $2 election: ",
+  return Substitute("T $0 P $1 [CANDIDATE]: Term $2 $3election: ",
                     request_.tablet_id(),
                     request_.candidate_uuid(),
-                    request_.candidate_term());
+                    request_.candidate_term(),
+                    request_.preelection() ? "pre-" : "");
 }
 
 } // namespace consensus
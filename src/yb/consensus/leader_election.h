@@ -215,8 +215,9 @@ class LeaderElection : public RefCountedThreadSafe<LeaderElection> {
   // Calls the callback outside of holding a lock.
   void CheckForDecision();
 
-  // Callback called when the RPC responds.
-  void VoteResponseRpcCallback(const std::string& voter_uuid, const LeaderElectionPtr& self);
+  // Callback called when the RPC responds with rpc_status.
+  void VoteResponseRpcCallback(const std::string& voter_uuid, const LeaderElectionPtr& self,
+                               const Status& rpc_status);
 
   // Record vote from specified peer.
   void RecordVoteUnlocked(const std::string& voter_uuid, ElectionVote vote);
@@ -48,11 +48,16 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/tablet/mvcc.h"
 #include "yb/util/random.h"
+#include "yb/util/size_literals.h"
 
 DEFINE_int32(num_batches, 10000,
              "Number of batches to write to/read from the Log in TestWriteManyBatches");
 
 DECLARE_int32(log_min_segments_to_retain);
+DECLARE_int32(group_commit_window_us);
+DECLARE_int32(log_recycled_segments_per_disk);
+
+METRIC_DECLARE_histogram(log_fsync_latency);
 DECLARE_bool(never_fsync);
 DECLARE_bool(writable_file_use_fsync);
 DECLARE_int32(o_direct_block_alignment_bytes);
@@ -223,6 +228,30 @@ TEST_F(LogTest, TestFsync) {
   ASSERT_OK(log_->Close());
 }
 
+// Tests that entry batches appended within the group commit window share a single fsync.
+TEST_F(LogTest, TestGroupCommitWindow) {
+  FLAGS_group_commit_window_us = 200000;
+  options_.durable_wal_write = true;
+  BuildLog();
+
+  static constexpr int kNumBatches = 5;
+  for (int i = 1; i <= kNumBatches; i++) {
+    AppendReplicateBatch(MakeOpId(1, i), MakeOpId(0, 0), {}, APPEND_ASYNC);
+  }
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+
+  // The batches may be split across two groups at most, if the append thread was already busy
+  // with the first one when the rest were appended.
+  ASSERT_LE(METRIC_log_fsync_latency.Instantiate(metric_entity_)->TotalCount(), 2);
+
+  SegmentSequence segments;
+  ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+  ASSERT_OK(segments[0]->ReadEntries(&entries_));
+  ASSERT_EQ(kNumBatches, entries_.size());
+  ASSERT_OK(log_->Close());
+  FLAGS_group_commit_window_us = 0;
+}
+
 // Tests interval for durable wal write
 TEST_F(LogTest, TestFsyncInterval) {
   options_.interval_durable_wal_write = MonoDelta::FromMilliseconds(1);
@@ -768,6 +797,61 @@ TEST_F(LogTest, TestLogReopenAndGC) {
   ASSERT_OK(log_anchor_registry_->Unregister(anchors[3]));
 }
 
+// Tests that GCed segments are zeroed and reused as new segments, up to the size of the pool.
+TEST_F(LogTest, TestRecycleSegments) {
+  FLAGS_log_recycled_segments_per_disk = 1;
+  options_.segment_size_bytes = 1_MB;
+  BuildLog();
+
+  vector<LogAnchor*> anchors;
+  ElementDeleter deleter(&anchors);
+  SegmentSequence segments;
+  int num_gced_segments;
+  OpId op_id = MakeOpId(1, 1);
+  int64_t anchored_index = -1;
+
+  auto recycled_files = [this]() {
+    vector<string> files;
+    CHECK_OK(env_->GetChildren(tablet_wal_path_, &files));
+    vector<string> result;
+    for (const string& file : files) {
+      if (HasPrefixString(file, ".recycled.segment-")) {
+        result.push_back(JoinPathSegments(tablet_wal_path_, file));
+      }
+    }
+    return result;
+  };
+
+  ASSERT_OK(AppendMultiSegmentSequence(4, 5, &op_id, &anchors));
+  ASSERT_OK(log_anchor_registry_->Unregister(anchors[0]));
+  ASSERT_OK(log_anchor_registry_->Unregister(anchors[1]));
+  ASSERT_OK(log_anchor_registry_->GetEarliestRegisteredLogIndex(&anchored_index));
+  ASSERT_OK(log_->GC(anchored_index, &num_gced_segments));
+  ASSERT_EQ(2, num_gced_segments);
+
+  // The pool has room for one of the GCed segments, the other one is deleted.
+  auto recycled = recycled_files();
+  ASSERT_EQ(1, recycled.size());
+  uint64_t size = 0;
+  ASSERT_OK(env_->GetFileSize(recycled[0], &size));
+  ASSERT_EQ(1_MB, size);
+  faststring contents;
+  ASSERT_OK(ReadFileToString(env_.get(), recycled[0], &contents));
+  ASSERT_EQ(string(size, '\0'), contents.ToString());
+
+  // The next segment reuses the recycled one, and the log still reads back what is written to it.
+  ASSERT_OK(RollLog());
+  ASSERT_EQ(0, recycled_files().size());
+  ASSERT_OK(AppendNoOps(&op_id, 5));
+  ASSERT_OK(log_->Close());
+  CheckRightNumberOfSegmentFiles(3);
+
+  BuildLog();
+  ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+  ASSERT_EQ(4, segments.size()) << DumpSegmentsToString(segments);
+  ASSERT_OK(log_->Close());
+}
+
 // Helper to measure the performance of the log.
 TEST_F(LogTest, TestWriteManyBatches) {
   uint64_t num_batches = 10;
@@ -864,6 +948,17 @@ TEST_F(LogTest, TestLogReader) {
 
   segment = reader.GetSegmentBySequenceNumber(5);
   ASSERT_TRUE(segment.get() == nullptr);
+
+  ASSERT_EQ(10, reader.GetMinReplicateIndex());
+
+  // The first segment is GCed.
+  ASSERT_OK(reader.TrimSegmentsUpToAndIncluding(2));
+  ASSERT_EQ(20, reader.GetMinReplicateIndex());
+  ASSERT_OK(reader.GetSegmentPrefixNotIncluding(30, &segments));
+  ASSERT_EQ(segments.size(), 1);
+  ASSERT_EQ(segments[0]->header().sequence_number(), 3);
+  ASSERT_OK(reader.GetSegmentPrefixNotIncluding(1000, &segments));
+  ASSERT_EQ(segments.size(), 2);
 }
 
 // Test that, even if the LogReader's index is empty because no segments
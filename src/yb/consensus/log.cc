@@ -33,6 +33,8 @@
 #include "yb/consensus/log.h"
 
 #include <algorithm>
+#include <deque>
+#include <map>
 #include <mutex>
 
 #include <boost/thread/shared_mutex.hpp>
@@ -46,6 +48,7 @@
 #include "yb/gutil/ref_counted.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/strings/util.h"
 #include "yb/gutil/walltime.h"
 #include "yb/util/coding.h"
 #include "yb/util/countdown_latch.h"
@@ -87,12 +90,26 @@ DEFINE_int32(log_min_seconds_to_retain, 300,
 TAG_FLAG(log_min_seconds_to_retain, runtime);
 TAG_FLAG(log_min_seconds_to_retain, advanced);
 
+DEFINE_int32(log_recycled_segments_per_disk, 0,
+             "How many garbage collected log segments are kept per WAL disk, zero filled, to be "
+             "reused as new segments by the logs of the tablets on that disk instead of creating "
+             "and allocating new files. 0 disables recycling, and garbage collected segments are "
+             "deleted.");
+TAG_FLAG(log_recycled_segments_per_disk, advanced);
+
 // Group commit configuration.
 // -----------------------------
 DEFINE_int32(group_commit_queue_size_bytes, 4_MB,
              "Maximum size of the group commit queue in bytes");
 TAG_FLAG(group_commit_queue_size_bytes, advanced);
 
+DEFINE_int32(group_commit_window_us, 0,
+             "When WAL writes are durable, how long in microseconds the log append thread keeps "
+             "collecting entry batches after the first one arrives, so that they are written and "
+             "fsynced as a single group. 0 disables the wait.");
+TAG_FLAG(group_commit_window_us, advanced);
+TAG_FLAG(group_commit_window_us, runtime);
+
 // Fault/latency injection flags.
 // -----------------------------
 DEFINE_bool(log_inject_latency, false,
@@ -122,6 +139,8 @@ static bool dummy = google::RegisterFlagValidator(
     &FLAGS_log_min_segments_to_retain, &ValidateLogsToRetain);
 
 static const char kSegmentPlaceholderFileTemplate[] = ".tmp.newsegmentXXXXXX";
+static const char kRecycledSegmentFilePrefix[] = ".recycled.segment-";
+static const char kReusedSegmentFilePrefix[] = ".tmp.newsegment-reused-";
 
 namespace yb {
 namespace log {
@@ -131,6 +150,56 @@ using env_util::OpenFileForRandom;
 using std::shared_ptr;
 using strings::Substitute;
 
+namespace {
+
+// Garbage collected segment files of the logs on one WAL disk, zero filled and ready to be reused
+// as new segments. See --log_recycled_segments_per_disk.
+class RecycledSegmentPool {
+ public:
+  // Returns the pool of the disk of the given tablet WAL directory, i.e. <wal root>/table/tablet.
+  static RecycledSegmentPool& ForLogDir(const std::string& log_dir) {
+    static std::mutex pools_mutex;
+    static auto* pools = new std::map<std::string, std::unique_ptr<RecycledSegmentPool>>();
+    std::lock_guard<std::mutex> lock(pools_mutex);
+    auto& pool = (*pools)[DirName(DirName(log_dir))];
+    if (!pool) {
+      pool.reset(new RecycledSegmentPool());
+    }
+    return *pool;
+  }
+
+  bool HasRoom() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return paths_.size() < static_cast<size_t>(FLAGS_log_recycled_segments_per_disk);
+  }
+
+  // Returns false if the pool is full, in which case the caller keeps the file.
+  bool Add(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (paths_.size() >= static_cast<size_t>(FLAGS_log_recycled_segments_per_disk)) {
+      return false;
+    }
+    paths_.push_back(path);
+    return true;
+  }
+
+  bool Take(std::string* path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (paths_.empty()) {
+      return false;
+    }
+    *path = std::move(paths_.front());
+    paths_.pop_front();
+    return true;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::deque<std::string> paths_;
+};
+
+} // namespace
+
 // This class is responsible for managing the thread that appends to the log file.
 class Log::AppendThread {
  public:
@@ -189,6 +258,21 @@ void Log::AppendThread::RunThread() {
       shutting_down = true;
     }
 
+    // Keep collecting entry batches for the group commit window so that they share one fsync.
+    const int32_t group_commit_window_us = FLAGS_group_commit_window_us;
+    if (group_commit_window_us > 0 && log_->durable_wal_write_ && !shutting_down &&
+        !entry_batches.empty()) {
+      const MonoTime window_deadline =
+          MonoTime::Now() + MonoDelta::FromMicroseconds(group_commit_window_us);
+      while (MonoTime::Now() < window_deadline) {
+        if (PREDICT_FALSE(!log_->entry_queue()->BlockingDrainTo(&entry_batches,
+                                                                window_deadline))) {
+          shutting_down = true;
+          break;
+        }
+      }
+    }
+
     if (log_->metrics_) {
       log_->metrics_->entry_batches_per_group->Increment(entry_batches.size());
     }
@@ -232,6 +316,9 @@ void Log::AppendThread::RunThread() {
       VLOG(2) << "Synchronized " << entry_batches.size() << " entry batches";
       SCOPED_WATCH_STACK(100);
       for (LogEntryBatch* entry_batch : entry_batches) {
+        if (PREDICT_FALSE(entry_batch->trace_id_)) {
+          RecordTraceStage("log.append_and_sync", MonoTime::Now() - entry_batch->append_start_);
+        }
         if (PREDICT_TRUE(!entry_batch->failed_to_append() && !entry_batch->callback().is_null())) {
           entry_batch->callback().Run(Status::OK());
         }
@@ -333,6 +420,10 @@ Status Log::Init() {
                                 metric_entity_.get(),
                                 &reader_));
 
+  // Segment files that were recycled or being reused when the process stopped are not referenced
+  // by any pool anymore.
+  DeleteRecycledSegmentFiles();
+
   // The case where we are continuing an existing log.  We must pick up where the previous WAL left
   // off in terms of sequence numbers.
   if (reader_->num_segments() != 0) {
@@ -441,6 +532,10 @@ Status Log::AsyncAppend(LogEntryBatch* entry_batch, const StatusCallback& callba
   }
 
   entry_batch->set_callback(callback);
+  entry_batch->trace_id_ = Trace::CurrentTraceId();
+  if (entry_batch->trace_id_) {
+    entry_batch->append_start_ = MonoTime::Now();
+  }
   entry_batch->MarkReady();
 
   if (PREDICT_FALSE(!entry_batch_queue_.BlockingPut(entry_batch))) {
@@ -629,7 +724,8 @@ Status Log::Sync() {
       periodic_sync_needed_.store(false);
       periodic_sync_unsynced_bytes_ = 0;
       LOG_SLOW_EXECUTION(WARNING, 50, "Fsync log took a long time") {
-            RETURN_NOT_OK(active_segment_->Sync());
+        SCOPED_LATENCY_METRIC(metrics_, fsync_latency);
+        RETURN_NOT_OK(active_segment_->Sync());
 
         if (log_hooks_) {
           RETURN_NOT_OK_PREPEND(log_hooks_->PostSyncIfFsyncEnabled(),
@@ -754,6 +850,11 @@ Status Log::GC(int64_t min_op_idx, int32_t* num_gced) {
     // Now that they are no longer referenced by the Log, delete the files.
     *num_gced = 0;
     for (const scoped_refptr<ReadableLogSegment>& segment : segments_to_delete) {
+      if (FLAGS_log_recycled_segments_per_disk > 0 &&
+          RecycleSegmentFile(segment->path(), segment->header().sequence_number())) {
+        (*num_gced)++;
+        continue;
+      }
       LOG(INFO) << "Deleting log segment in path: " << segment->path()
                 << " (GCed ops < " << min_op_idx << ")";
       RETURN_NOT_OK(fs_manager_->env()->DeleteFile(segment->path()));
@@ -874,14 +975,19 @@ Status Log::PreAllocateNewSegment() {
   WritableFileOptions opts;
   opts.sync_on_close = durable_wal_write_;
   opts.o_direct = durable_wal_write_;
-  RETURN_NOT_OK(CreatePlaceholderSegment(opts, &next_segment_path_, &next_segment_file_));
+  // Space that the segment file already has, when it is a recycled one.
+  uint64_t allocated_size = 0;
+  if (FLAGS_log_recycled_segments_per_disk == 0 ||
+      !ReuseRecycledSegment(opts, &next_segment_path_, &next_segment_file_, &allocated_size)) {
+    RETURN_NOT_OK(CreatePlaceholderSegment(opts, &next_segment_path_, &next_segment_file_));
+  }
 
   if (options_.preallocate_segments) {
     uint64_t next_segment_size = NextSegmentDesiredSize();
-    TRACE("Preallocating $0 byte segment in $1", next_segment_size, next_segment_path_);
-    // TODO (perf) zero the new segments -- this could result in additional performance
-    // improvements.
-    RETURN_NOT_OK(next_segment_file_->PreAllocate(next_segment_size));
+    if (next_segment_size > allocated_size) {
+      TRACE("Preallocating $0 byte segment in $1", next_segment_size, next_segment_path_);
+      RETURN_NOT_OK(next_segment_file_->PreAllocate(next_segment_size - allocated_size));
+    }
   }
 
   {
@@ -989,6 +1095,107 @@ Status Log::CreatePlaceholderSegment(const WritableFileOptions& opts,
   return Status::OK();
 }
 
+bool Log::ReuseRecycledSegment(const WritableFileOptions& opts,
+                               string* result_path,
+                               shared_ptr<WritableFile>* out,
+                               uint64_t* allocated_size) {
+  Env* env = fs_manager_->env();
+  auto& pool = RecycledSegmentPool::ForLogDir(log_dir_);
+  string recycled_path;
+  while (pool.Take(&recycled_path)) {
+    // The sequence number is only used to give the placeholder a unique name in this directory.
+    const string path = JoinPathSegments(
+        log_dir_,
+        Substitute("$0$1", kReusedSegmentFilePrefix, active_segment_sequence_number_ + 1));
+    Status s = env->RenameFile(recycled_path, path);
+    if (!s.ok()) {
+      // The file may have been deleted when its log was reopened or removed.
+      LOG(WARNING) << "Failed to take recycled log segment " << recycled_path << ": " << s;
+      continue;
+    }
+    WritableFileOptions reuse_opts = opts;
+    reuse_opts.mode = Env::OPEN_EXISTING;
+    reuse_opts.reuse_allocated_space = true;
+    gscoped_ptr<WritableFile> segment_file;
+    s = env->GetFileSize(path, allocated_size);
+    if (s.ok()) {
+      s = env->NewWritableFile(reuse_opts, path, &segment_file);
+    }
+    if (s.ok()) {
+      VLOG(1) << "Reusing recycled log segment " << recycled_path << " as " << path;
+      *result_path = path;
+      out->reset(segment_file.release());
+      return true;
+    }
+    LOG(WARNING) << "Failed to reuse recycled log segment " << path << ": " << s;
+    WARN_NOT_OK(env->DeleteFile(path), "Failed to delete recycled log segment");
+  }
+  *allocated_size = 0;
+  return false;
+}
+
+bool Log::RecycleSegmentFile(const string& path, int64_t sequence_number) {
+  auto& pool = RecycledSegmentPool::ForLogDir(log_dir_);
+  if (!pool.HasRoom()) {
+    return false;
+  }
+  Env* env = fs_manager_->env();
+  const string recycled_path = JoinPathSegments(
+      log_dir_, Substitute("$0$1", kRecycledSegmentFilePrefix, sequence_number));
+  Status s = env->RenameFile(path, recycled_path);
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to recycle log segment " << path << ": " << s;
+    return false;
+  }
+  LOG(INFO) << "Recycling log segment in path: " << path << " as " << recycled_path;
+  s = ZeroSegmentFile(recycled_path);
+  if (s.ok() && pool.Add(recycled_path)) {
+    return true;
+  }
+  WARN_NOT_OK(s, "Failed to zero recycled log segment " + recycled_path);
+  WARN_NOT_OK(env->DeleteFile(recycled_path), "Failed to delete recycled log segment");
+  return true;
+}
+
+Status Log::ZeroSegmentFile(const string& path) {
+  static const string kZeros(1_MB, '\0');
+  Env* env = fs_manager_->env();
+  uint64_t size = 0;
+  RETURN_NOT_OK(env->GetFileSize(path, &size));
+  size = std::max(size, max_segment_size_);
+
+  // Zeros are synced on close, so that the old entries of the segment could never be read back as
+  // the entries of the log that reuses it.
+  WritableFileOptions opts;
+  opts.mode = Env::OPEN_EXISTING;
+  opts.reuse_allocated_space = true;
+  opts.sync_on_close = true;
+  gscoped_ptr<WritableFile> file;
+  RETURN_NOT_OK(env->NewWritableFile(opts, path, &file));
+  for (uint64_t written = 0; written < size; written += kZeros.size()) {
+    RETURN_NOT_OK(file->Append(Slice(kZeros.data(), std::min<uint64_t>(kZeros.size(),
+                                                                       size - written))));
+  }
+  return file->Close();
+}
+
+void Log::DeleteRecycledSegmentFiles() {
+  Env* env = fs_manager_->env();
+  vector<string> children;
+  Status s = env->GetChildren(log_dir_, &children);
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to list " << log_dir_ << ": " << s;
+    return;
+  }
+  for (const string& child : children) {
+    if (HasPrefixString(child, kRecycledSegmentFilePrefix) ||
+        HasPrefixString(child, kReusedSegmentFilePrefix)) {
+      WARN_NOT_OK(env->DeleteFile(JoinPathSegments(log_dir_, child)),
+                  "Failed to delete recycled log segment");
+    }
+  }
+}
+
 Log::~Log() {
   WARN_NOT_OK(Close(), "Error closing log");
 }
@@ -273,6 +273,24 @@ class Log : public RefCountedThreadSafe<Log> {
                                           std::string* result_path,
                                           std::shared_ptr<WritableFile>* out);
 
+  // Takes a zero filled segment file from the recycled segments of this disk and opens it as the
+  // next placeholder segment, setting 'allocated_size' to the space the file already has. Returns
+  // false if there is no recycled segment to reuse.
+  bool ReuseRecycledSegment(const WritableFileOptions& opts,
+                            std::string* result_path,
+                            std::shared_ptr<WritableFile>* out,
+                            uint64_t* allocated_size);
+
+  // Moves a garbage collected segment file to the recycled segments of this disk, zero filling it.
+  // Returns false if the caller should delete the file at 'path' instead.
+  bool RecycleSegmentFile(const std::string& path, int64_t sequence_number);
+
+  // Overwrites the whole segment file at 'path' with zeros, extending it to max_segment_size_.
+  CHECKED_STATUS ZeroSegmentFile(const std::string& path);
+
+  // Deletes the recycled segment files left in log_dir_ by a previous run.
+  void DeleteRecycledSegmentFiles();
+
   // Creates a new WAL segment on disk, writes the next_segment_header_ to disk as the header, and
   // sets active_segment_ to point to this new segment.
   CHECKED_STATUS SwitchToAllocatedSegment();
@@ -510,6 +528,12 @@ class LogEntryBatch {
   // Callback to be invoked upon the entries being written and synced to disk.
   StatusCallback callback_;
 
+  // Trace id of the sampled request that appended this batch, 0 if it was not sampled.
+  uint64_t trace_id_ = 0;
+
+  // Time when the batch was passed to AsyncAppend, set only for sampled batches.
+  MonoTime append_start_;
+
   // Buffer to which 'phys_entries_' are serialized by call to 'Serialize()'
   faststring buffer_;
 
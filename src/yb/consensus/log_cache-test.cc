@@ -303,6 +303,50 @@ TEST_F(LogCacheTest, TestGlobalMemoryLimit) {
   ASSERT_LE(cache_->BytesUsed(), 1024 * 1024);
 }
 
+// Test that when the global limit is reached, the operations that no peer needs are evicted from
+// the caches of other tablets, instead of the operations of this tablet that lagging peers need.
+TEST_F(LogCacheTest, TestGlobalMemoryLimitEvictsOtherTablets) {
+  FLAGS_global_log_cache_size_limit_mb = 4;
+  CloseAndReopenCache(MinimumOpId());
+
+  const int kPayloadSize = 768 * 1024;
+
+  // The cache of another tablet, whose local peer is a follower.
+  const std::string kOtherTablet = "other-tablet";
+  scoped_refptr<log::Log> other_log;
+  ASSERT_OK(log::Log::Open(log::LogOptions(),
+                           fs_manager_.get(),
+                           kOtherTablet,
+                           fs_manager_->GetFirstTabletWalDirOrDie(kTestTable, kOtherTablet),
+                           schema_,
+                           0, // schema_version
+                           NULL,
+                           &other_log));
+  LogCache other_cache(METRIC_ENTITY_tablet.Instantiate(&metric_registry_, "LogCacheTestOther"),
+                       other_log.get(),
+                       kPeerUuid,
+                       kOtherTablet);
+  other_cache.Init(MinimumOpId());
+  for (int index = 1; index <= 3; ++index) {
+    ReplicateMsgs msgs = { CreateDummyReplicate(0, index, clock_->Now(), kPayloadSize) };
+    ASSERT_OK(other_cache.AppendOperations(msgs, Bind(&FatalOnError)));
+  }
+  ASSERT_OK(other_log->WaitUntilAllFlushed());
+  ASSERT_EQ(3, other_cache.num_cached_ops());
+
+  // The operations of the leader are not replicated to all peers yet, so they are kept, and the
+  // memory for the last one is taken from the other tablet.
+  cache_->SetIsLeader(true);
+  ASSERT_OK(AppendReplicateMessagesToCache(1, 3, kPayloadSize));
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+  ASSERT_EQ(3, cache_->num_cached_ops());
+  ASSERT_EQ(2, other_cache.num_cached_ops());
+
+  // Once they are replicated to all peers, they are evicted.
+  cache_->EvictThroughOp(3);
+  ASSERT_EQ(0, cache_->num_cached_ops());
+}
+
 // Test that the log cache properly replaces messages when an index
 // is reused. This is a regression test for a bug where the memtracker's
 // consumption wasn't properly managed when messages were replaced.
@@ -35,6 +35,7 @@
 #include <algorithm>
 #include <map>
 #include <mutex>
+#include <unordered_set>
 #include <vector>
 
 #include <gflags/gflags.h>
@@ -82,8 +83,40 @@ METRIC_DEFINE_gauge_int64(tablet, log_cache_size, "Log Cache Memory Usage",
 
 static const char kParentMemTrackerId[] = "log_cache";
 
+// All log caches of this server, so that the memory needed by one tablet could be taken from the
+// operations of other tablets that no peer needs anymore.
+struct LogCache::Registry {
+  std::mutex mutex;
+  std::unordered_set<LogCache*> caches;
+
+  static Registry& Instance() {
+    static Registry* instance = new Registry();
+    return *instance;
+  }
+};
+
 typedef vector<const ReplicateMsg*>::const_iterator MsgIter;
 
+namespace {
+// Calculate the total byte size that will be used on the wire to replicate
+// this message as part of a consensus update request. This accounts for the
+// length delimiting and tagging of the message.
+int64_t TotalByteSizeForMessage(const ReplicateMsg& msg) {
+  int msg_size = google::protobuf::internal::WireFormatLite::LengthDelimitedSize(
+    msg.ByteSize());
+  msg_size += 1; // for the type tag
+  return msg_size;
+}
+} // anonymous namespace
+
+std::shared_ptr<MemTracker> LogCache::GetGlobalMemTracker() {
+  const int64_t global_max_ops_size_bytes = FLAGS_global_log_cache_size_limit_mb * 1024 * 1024;
+
+  // Set up (or reuse) a tracker with the global limit. It is parented directly
+  // to the root tracker so that it's always global.
+  return MemTracker::FindOrCreateTracker(global_max_ops_size_bytes, kParentMemTrackerId);
+}
+
 LogCache::LogCache(const scoped_refptr<MetricEntity>& metric_entity,
                    const scoped_refptr<log::Log>& log,
                    const string& local_uuid,
@@ -97,12 +130,8 @@ LogCache::LogCache(const scoped_refptr<MetricEntity>& metric_entity,
 
 
   const int64_t max_ops_size_bytes = FLAGS_log_cache_size_limit_mb * 1024 * 1024;
-  const int64_t global_max_ops_size_bytes = FLAGS_global_log_cache_size_limit_mb * 1024 * 1024;
 
-  // Set up (or reuse) a tracker with the global limit. It is parented directly
-  // to the root tracker so that it's always global.
-  parent_tracker_ = MemTracker::FindOrCreateTracker(global_max_ops_size_bytes,
-                                                    kParentMemTrackerId);
+  parent_tracker_ = GetGlobalMemTracker();
 
   // And create a child tracker with the per-tablet limit.
   tracker_ = MemTracker::CreateTracker(
@@ -114,10 +143,20 @@ LogCache::LogCache(const scoped_refptr<MetricEntity>& metric_entity,
   // code paths elsewhere.
   auto zero_op = std::make_shared<ReplicateMsg>();
   *zero_op->mutable_id() = MinimumOpId();
-  InsertOrDie(&cache_, 0, zero_op);
+  InsertOrDie(&cache_, 0, CacheEntry{zero_op, 0, TotalByteSizeForMessage(*zero_op)});
+
+  auto& registry = Registry::Instance();
+  std::lock_guard<std::mutex> registry_lock(registry.mutex);
+  registry.caches.insert(this);
 }
 
 LogCache::~LogCache() {
+  {
+    auto& registry = Registry::Instance();
+    std::lock_guard<std::mutex> registry_lock(registry.mutex);
+    registry.caches.erase(this);
+  }
+
   tracker_->Release(tracker_->consumption());
   cache_.clear();
 
@@ -155,45 +194,44 @@ Status LogCache::AppendOperations(const ReplicateMsgs& msgs,
     for (int64_t i = first_idx_in_batch; i < next_sequential_op_index_; ++i) {
       auto it = cache_.find(i);
       if (it != cache_.end()) {
-        ReplicateMsgPtr msg = it->second;
+        AccountForMessageRemovalUnlocked(it->second);
         cache_.erase(it);
-        AccountForMessageRemovalUnlocked(msg);
       }
     }
   }
 
 
+  std::vector<CacheEntry> entries;
+  entries.reserve(msgs.size());
   int64_t mem_required = 0;
   for (const auto& msg : msgs) {
-    mem_required += msg->SpaceUsed();
+    entries.push_back(CacheEntry{msg, msg->SpaceUsed(), TotalByteSizeForMessage(*msg)});
+    mem_required += entries.back().mem_usage;
   }
 
   // Try to consume the memory. If it can't be consumed, we may need to evict.
   bool borrowed_memory = false;
   if (!tracker_->TryConsume(mem_required)) {
-    int spare = tracker_->SpareCapacity();
-    int need_to_free = mem_required - spare;
+    int64_t spare = tracker_->SpareCapacity();
     VLOG_WITH_PREFIX_UNLOCKED(1) << "Memory limit would be exceeded trying to append "
                         << HumanReadableNumBytes::ToString(mem_required)
                         << " to log cache (available="
                         << HumanReadableNumBytes::ToString(spare)
                         << "): attempting to evict some operations...";
 
-    // TODO: we should also try to evict from other tablets - probably better to
-    // evict really old ops from another tablet than evict recent ops from this one.
-    EvictSomeUnlocked(min_pinned_op_index_, need_to_free);
+    EvictForMemoryUnlocked(mem_required);
 
-    // Force consuming, so that we don't refuse appending data. We might
-    // blow past our limit a little bit (as much as the number of tablets times
-    // the amount of in-flight data in the log), but until implementing the above TODO,
-    // it's difficult to solve this issue.
+    // Force consuming, so that we don't refuse appending data. We might blow past our limit a
+    // little bit (as much as the number of tablets times the amount of in-flight or in-use data
+    // in the log), when there is not enough to evict.
     tracker_->Consume(mem_required);
 
     borrowed_memory = parent_tracker_->LimitExceeded();
   }
 
-  for (const auto& msg : msgs) {
-    InsertOrDie(&cache_,  msg->id().index(), msg);
+  for (auto& entry : entries) {
+    const int64_t index = entry.msg->id().index();
+    InsertOrDie(&cache_, index, std::move(entry));
   }
 
   // We drop the lock during the AsyncAppendReplicates call, since it may block
@@ -235,11 +273,8 @@ void LogCache::LogCallback(int64_t last_idx_in_batch,
 
     // If we went over the global limit in order to log this batch, evict some to
     // get back down under the limit.
-    if (borrowed_memory) {
-      int64_t spare_capacity = parent_tracker_->SpareCapacity();
-      if (spare_capacity < 0) {
-        EvictSomeUnlocked(min_pinned_op_index_, -spare_capacity);
-      }
+    if (borrowed_memory && parent_tracker_->SpareCapacity() < 0) {
+      EvictForMemoryUnlocked(0);
     }
   }
   user_callback.Run(log_status);
@@ -266,7 +301,7 @@ Status LogCache::LookupOpId(int64_t op_index, OpId* op_id) const {
     }
     auto iter = cache_.find(op_index);
     if (iter != cache_.end()) {
-      *op_id = iter->second->id();
+      *op_id = iter->second.msg->id();
       return Status::OK();
     }
   }
@@ -275,18 +310,6 @@ Status LogCache::LookupOpId(int64_t op_index, OpId* op_id) const {
   return log_->GetLogReader()->LookupOpId(op_index, op_id);
 }
 
-namespace {
-// Calculate the total byte size that will be used on the wire to replicate
-// this message as part of a consensus update request. This accounts for the
-// length delimiting and tagging of the message.
-int64_t TotalByteSizeForMessage(const ReplicateMsg& msg) {
-  int msg_size = google::protobuf::internal::WireFormatLite::LengthDelimitedSize(
-    msg.ByteSize());
-  msg_size += 1; // for the type tag
-  return msg_size;
-}
-} // anonymous namespace
-
 Status LogCache::ReadOps(int64_t after_op_index,
                          int max_size_bytes,
                          ReplicateMsgs* messages,
@@ -338,18 +361,18 @@ Status LogCache::ReadOps(int64_t after_op_index,
     } else {
       // Pull contiguous messages from the cache until the size limit is achieved.
       for (; iter != cache_.end(); ++iter) {
-        const ReplicateMsgPtr& msg = iter->second;
-        int64_t index = msg->id().index();
+        const CacheEntry& entry = iter->second;
+        int64_t index = entry.msg->id().index();
         if (index != next_index) {
           continue;
         }
 
-        remaining_space -= TotalByteSizeForMessage(*msg);
+        remaining_space -= entry.wire_size;
         if (remaining_space < 0 && !messages->empty()) {
           break;
         }
 
-        messages->push_back(msg);
+        messages->push_back(entry.msg);
         next_index++;
       }
     }
@@ -361,10 +384,74 @@ Status LogCache::ReadOps(int64_t after_op_index,
 void LogCache::EvictThroughOp(int64_t index) {
   std::lock_guard<simple_spinlock> lock(lock_);
 
+  all_replicated_op_index_ = std::max(all_replicated_op_index_, index);
   EvictSomeUnlocked(index, MathLimits<int64_t>::kMax);
 }
 
-void LogCache::EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evict) {
+void LogCache::SetIsLeader(bool is_leader) {
+  std::lock_guard<simple_spinlock> lock(lock_);
+
+  is_leader_ = is_leader;
+  // The new leader does not know yet what its peers have.
+  all_replicated_op_index_ = 0;
+}
+
+int64_t LogCache::EvictUnneededUnlocked(int64_t bytes_to_evict) {
+  // Cached operations at or above min_pinned_op_index_ are never evicted.
+  return EvictSomeUnlocked(
+      is_leader_ ? all_replicated_op_index_ : MathLimits<int64_t>::kMax, bytes_to_evict);
+}
+
+int64_t LogCache::EvictUnneededFromOtherCaches(int64_t bytes_to_evict) {
+  auto& registry = Registry::Instance();
+  std::lock_guard<std::mutex> registry_lock(registry.mutex);
+  int64_t bytes_evicted = 0;
+  for (LogCache* cache : registry.caches) {
+    if (cache == this) {
+      continue;
+    }
+    // The other cache could be evicting from this one at the same time, so its lock is only
+    // tried, to avoid a deadlock.
+    std::unique_lock<simple_spinlock> lock(cache->lock_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+      continue;
+    }
+    bytes_evicted += cache->EvictUnneededUnlocked(bytes_to_evict - bytes_evicted);
+    if (bytes_evicted >= bytes_to_evict) {
+      break;
+    }
+  }
+  return bytes_evicted;
+}
+
+void LogCache::EvictForMemoryUnlocked(int64_t mem_required) {
+  DCHECK(lock_.is_locked());
+  int64_t tablet_excess = tracker_->has_limit()
+      ? mem_required + tracker_->consumption() - tracker_->limit() : 0;
+  int64_t global_excess = mem_required - parent_tracker_->SpareCapacity();
+
+  const int64_t excess = std::max(tablet_excess, global_excess);
+  if (excess > 0) {
+    const int64_t bytes_evicted = EvictUnneededUnlocked(excess);
+    tablet_excess -= bytes_evicted;
+    global_excess -= bytes_evicted;
+  }
+
+  if (global_excess > 0) {
+    const int64_t other_bytes_evicted = EvictUnneededFromOtherCaches(global_excess);
+    VLOG_WITH_PREFIX_UNLOCKED(1) << "Evicted "
+                                 << HumanReadableNumBytes::ToString(other_bytes_evicted)
+                                 << " from the log caches of other tablets";
+    global_excess -= other_bytes_evicted;
+  }
+
+  const int64_t remaining_excess = std::max(tablet_excess, global_excess);
+  if (remaining_excess > 0) {
+    EvictSomeUnlocked(min_pinned_op_index_, remaining_excess);
+  }
+}
+
+int64_t LogCache::EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evict) {
   DCHECK(lock_.is_locked());
   VLOG_WITH_PREFIX_UNLOCKED(2) << "Evicting log cache index <= "
                       << stop_after_index
@@ -373,7 +460,8 @@ void LogCache::EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evic
 
   int64_t bytes_evicted = 0;
   for (auto iter = cache_.begin(); iter != cache_.end();) {
-    const ReplicateMsgPtr& msg = iter->second;
+    const CacheEntry& entry = iter->second;
+    const ReplicateMsgPtr& msg = entry.msg;
     VLOG_WITH_PREFIX_UNLOCKED(2) << "considering for eviction: " << msg->id();
     int64_t msg_index = msg->id().index();
     if (msg_index == 0) {
@@ -394,8 +482,8 @@ void LogCache::EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evic
     }
 
     VLOG_WITH_PREFIX_UNLOCKED(2) << "Evicting cache. Removing: " << msg->id();
-    AccountForMessageRemovalUnlocked(msg);
-    bytes_evicted += msg->SpaceUsed();
+    AccountForMessageRemovalUnlocked(entry);
+    bytes_evicted += entry.mem_usage;
     cache_.erase(iter++);
 
     if (bytes_evicted >= bytes_to_evict) {
@@ -403,11 +491,12 @@ void LogCache::EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evic
     }
   }
   VLOG_WITH_PREFIX_UNLOCKED(1) << "Evicting log cache: after state: " << ToStringUnlocked();
+  return bytes_evicted;
 }
 
-void LogCache::AccountForMessageRemovalUnlocked(const ReplicateMsgPtr& msg) {
-  tracker_->Release(msg->SpaceUsed());
-  metrics_.log_cache_size->DecrementBy(msg->SpaceUsed());
+void LogCache::AccountForMessageRemovalUnlocked(const CacheEntry& entry) {
+  tracker_->Release(entry.mem_usage);
+  metrics_.log_cache_size->DecrementBy(entry.mem_usage);
   metrics_.log_cache_num_ops->Decrement();
 }
 
@@ -457,12 +546,12 @@ void LogCache::DumpToStrings(vector<string>* lines) const {
   lines->push_back(ToStringUnlocked());
   lines->push_back("Messages:");
   for (const MessageCache::value_type& entry : cache_) {
-    const ReplicateMsg* msg = entry.second.get();
+    const ReplicateMsg* msg = entry.second.msg.get();
     lines->push_back(
       Substitute("Message[$0] $1.$2 : REPLICATE. Type: $3, Size: $4",
                  counter++, msg->id().term(), msg->id().index(),
                  OperationType_Name(msg->op_type()),
-                 msg->ByteSize()));
+                 entry.second.wire_size));
   }
 }
 
@@ -476,12 +565,12 @@ void LogCache::DumpToHtml(std::ostream& out) const {
 
   int counter = 0;
   for (const MessageCache::value_type& entry : cache_) {
-    const ReplicateMsg* msg = entry.second.get();
+    const ReplicateMsg* msg = entry.second.msg.get();
     out << Substitute("<tr><th>$0</th><th>$1.$2</th><td>REPLICATE $3</td>"
                       "<td>$4</td><td>$5</td></tr>",
                       counter++, msg->id().term(), msg->id().index(),
                       OperationType_Name(msg->op_type()),
-                      msg->ByteSize(), msg->id().ShortDebugString()) << endl;
+                      entry.second.wire_size, msg->id().ShortDebugString()) << endl;
   }
   out << "</table>";
 }
@@ -75,6 +75,10 @@ class LogCache {
            const std::string& tablet_id);
   ~LogCache();
 
+  // Returns the tracker, shared by all log caches on this server, that enforces
+  // FLAGS_global_log_cache_size_limit_mb. Creates it if no log cache exists yet.
+  static std::shared_ptr<MemTracker> GetGlobalMemTracker();
+
   // Initialize the cache.
   //
   // 'preceding_op' is the current latest op. The next AppendOperation() call
@@ -117,9 +121,15 @@ class LogCache {
   // en route to the log.
   bool HasOpBeenWritten(int64_t log_index) const;
 
-  // Evict any operations with op index <= 'index'.
+  // Evict any operations with op index <= 'index'. Called by the leader with the index of the
+  // last operation replicated to all peers.
   void EvictThroughOp(int64_t index);
 
+  // Tells the cache whether the local peer is the leader. Other peers do not read the operations
+  // of a follower from its cache, so they are evicted first when the memory is short, while the
+  // leader first evicts the operations replicated to all peers.
+  void SetIsLeader(bool is_leader);
+
   // Return the number of bytes of memory currently in use by the cache.
   int64_t BytesUsed() const;
 
@@ -157,11 +167,29 @@ class LogCache {
   // Try to evict the oldest operations from the queue, stopping either when
   // 'bytes_to_evict' bytes have been evicted, or the op with index
   // 'stop_after_index' has been evicted, whichever comes first.
-  void EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evict);
+  // Returns the number of bytes evicted.
+  int64_t EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evict);
+
+  // Evicts up to 'bytes_to_evict' bytes of the oldest operations that no peer needs to read from
+  // the cache. Returns the number of bytes evicted.
+  int64_t EvictUnneededUnlocked(int64_t bytes_to_evict);
+
+  // Evicts the operations that no peer needs from the caches of the other tablets of this server,
+  // until 'bytes_to_evict' bytes are evicted. Returns the number of bytes evicted.
+  int64_t EvictUnneededFromOtherCaches(int64_t bytes_to_evict);
+
+  // Makes room for 'mem_required' more bytes under both the per-tablet and the server-wide limit.
+  // The operations no peer needs are evicted first, from this cache and then from the caches of
+  // the other tablets. Only if that is not enough, the oldest operations that lagging peers still
+  // need are evicted from this cache.
+  void EvictForMemoryUnlocked(int64_t mem_required);
+
+  struct CacheEntry;
+  struct Registry;
 
   // Update metrics and MemTracker to account for the removal of the
-  // given message.
-  void AccountForMessageRemovalUnlocked(const ReplicateMsgPtr& msg);
+  // given cache entry.
+  void AccountForMessageRemovalUnlocked(const CacheEntry& entry);
 
   // Return a string with stats
   std::string StatsStringUnlocked() const;
@@ -185,9 +213,21 @@ class LogCache {
 
   mutable simple_spinlock lock_;
 
+  // A cached message along with its sizes, which are computed once when the message is added so
+  // that reading it for each peer and evicting it do not need to walk the whole message again.
+  struct CacheEntry {
+    ReplicateMsgPtr msg;
+
+    // Memory used by the message, as charged to the mem trackers.
+    int64_t mem_usage;
+
+    // Bytes the message takes on the wire as part of a consensus update request.
+    int64_t wire_size;
+  };
+
   // An ordered map that serves as the buffer for the cached messages.
-  // Maps from log index -> ReplicateMsg
-  typedef std::map<uint64_t, ReplicateMsgPtr> MessageCache;
+  // Maps from log index -> CacheEntry
+  typedef std::map<uint64_t, CacheEntry> MessageCache;
   MessageCache cache_;
 
   // The next log index to append. Each append operation must either
@@ -200,6 +240,13 @@ class LogCache {
   // Protected by lock_.
   int64_t min_pinned_op_index_;
 
+  // Whether the local peer is the leader, see SetIsLeader.
+  bool is_leader_ = false;
+
+  // The index of the last operation replicated to all peers, as passed to EvictThroughOp by the
+  // leader.
+  int64_t all_replicated_op_index_ = 0;
+
   // Pointer to a parent memtracker for all log caches. This
   // exists to compute server-wide cache size and enforce a
   // server-wide memory limit.  When the first instance of a log
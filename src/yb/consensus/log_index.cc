@@ -153,14 +153,16 @@ Status LogIndex::IndexChunk::Open() {
 
   int err;
   RETRY_ON_EINTR(err, ftruncate(fd_, kChunkFileSize));
-  RETURN_NOT_OK(CheckError(fd_, "truncate"));
+  RETURN_NOT_OK(CheckError(err, "truncate"));
 
-  mapping_ = static_cast<uint8_t*>(mmap(nullptr, kChunkFileSize, PROT_READ | PROT_WRITE,
-                                        MAP_SHARED, fd_, 0));
-  if (mapping_ == nullptr) {
+  // The file is sparse and the mapping is populated on demand, so only the pages of the entries
+  // that are actually written or looked up get loaded.
+  void* mapping = mmap(nullptr, kChunkFileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if (mapping == MAP_FAILED) {
     int err = errno;
     return STATUS(IOError, "Unable to mmap()", ErrnoToString(err), err);
   }
+  mapping_ = static_cast<uint8_t*>(mapping);
 
   return Status::OK();
 }
@@ -43,6 +43,12 @@ METRIC_DEFINE_histogram(tablet, log_sync_latency, "Log Sync Latency",
                         "Microseconds spent on synchronizing the log segment file",
                         60000000LU, 2);
 
+METRIC_DEFINE_histogram(tablet, log_fsync_latency, "Log Fsync Latency",
+                        yb::MetricUnit::kMicroseconds,
+                        "Microseconds spent on fsyncing the log segment file, only counting the "
+                        "syncs that actually reached the disk",
+                        60000000LU, 2);
+
 METRIC_DEFINE_histogram(tablet, log_append_latency, "Log Append Latency",
                         yb::MetricUnit::kMicroseconds,
                         "Microseconds spent on appending to the log segment file",
@@ -70,6 +76,7 @@ namespace log {
 LogMetrics::LogMetrics(const scoped_refptr<MetricEntity>& metric_entity)
     : MINIT(bytes_logged),
       MINIT(sync_latency),
+      MINIT(fsync_latency),
       MINIT(append_latency),
       MINIT(group_commit_latency),
       MINIT(roll_latency),
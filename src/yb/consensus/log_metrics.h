@@ -52,6 +52,7 @@ struct LogMetrics {
 
   // Per-group group commit stats
   scoped_refptr<Histogram> sync_latency;
+  scoped_refptr<Histogram> fsync_latency;
   scoped_refptr<Histogram> append_latency;
   scoped_refptr<Histogram> group_commit_latency;
   scoped_refptr<Histogram> roll_latency;
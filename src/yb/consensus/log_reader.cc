@@ -216,34 +216,47 @@ Status LogReader::GetSegmentPrefixNotIncluding(int64_t index,
   std::lock_guard<simple_spinlock> lock(lock_);
   CHECK_EQ(state_, kLogReaderReading);
 
-  for (const scoped_refptr<ReadableLogSegment>& segment : segments_) {
-    // The last segment doesn't have a footer. Never include that one.
-    if (!segment->HasFooter()) {
-      break;
-    }
-    if (segment->footer().max_replicate_index() >= index) {
-      break;
-    }
-    // TODO: tests for edge cases here with backwards ordered replicates.
-    segments->push_back(segment);
-  }
+  // The prefix ends at the first segment whose replicates, or the ones of a segment before it,
+  // reach 'index'. The last segment doesn't have a footer, it is never included.
+  // TODO: tests for edge cases here with backwards ordered replicates.
+  auto end = std::lower_bound(
+      max_replicate_index_prefix_.begin(), max_replicate_index_prefix_.end(), index);
+  segments->assign(segments_.begin(),
+                   segments_.begin() + (end - max_replicate_index_prefix_.begin()));
 
   return Status::OK();
 }
 
 int64_t LogReader::GetMinReplicateIndex() const {
   std::lock_guard<simple_spinlock> lock(lock_);
-  int64_t min_remaining_op_idx = -1;
+  return min_replicate_index_;
+}
 
-  for (const scoped_refptr<ReadableLogSegment>& segment : segments_) {
-    if (!segment->HasFooter()) continue;
-    if (!segment->footer().has_min_replicate_index()) continue;
-    if (min_remaining_op_idx == -1 ||
-        segment->footer().min_replicate_index() < min_remaining_op_idx) {
-      min_remaining_op_idx = segment->footer().min_replicate_index();
-    }
+void LogReader::UpdateSegmentIndexUnlocked(size_t segment_idx) {
+  const ReadableLogSegment& segment = *segments_[segment_idx];
+  if (!segment.HasFooter()) {
+    return;
+  }
+  const LogSegmentFooterPB& footer = segment.footer();
+  // Only the segments in the prefix of segments with footers are searched.
+  if (max_replicate_index_prefix_.size() == segment_idx) {
+    max_replicate_index_prefix_.push_back(
+        max_replicate_index_prefix_.empty()
+            ? footer.max_replicate_index()
+            : std::max(max_replicate_index_prefix_.back(), footer.max_replicate_index()));
+  }
+  if (footer.has_min_replicate_index() &&
+      (min_replicate_index_ == -1 || footer.min_replicate_index() < min_replicate_index_)) {
+    min_replicate_index_ = footer.min_replicate_index();
+  }
+}
+
+void LogReader::RebuildSegmentIndexUnlocked() {
+  max_replicate_index_prefix_.clear();
+  min_replicate_index_ = -1;
+  for (size_t i = 0; i != segments_.size(); ++i) {
+    UpdateSegmentIndexUnlocked(i);
   }
-  return min_remaining_op_idx;
 }
 
 void LogReader::GetMaxIndexesToSegmentSizeMap(int64_t min_op_idx, int32_t segments_count,
@@ -428,6 +441,7 @@ Status LogReader::TrimSegmentsUpToAndIncluding(int64_t segment_sequence_number)
     }
     break;
   }
+  RebuildSegmentIndexUnlocked();
   LOG(INFO) << "T " << tablet_id_ << ": removed " << num_deleted_segments
             << " log segments from log reader";
   return Status::OK();
@@ -454,6 +468,12 @@ Status LogReader::ReplaceLastSegment(const scoped_refptr<ReadableLogSegment>& se
   CHECK(!segments_.empty());
   CHECK_EQ(segment->header().sequence_number(), segments_.back()->header().sequence_number());
   segments_[segments_.size() - 1] = segment;
+  if (max_replicate_index_prefix_.size() == segments_.size()) {
+    // The replaced segment already had a footer.
+    RebuildSegmentIndexUnlocked();
+  } else {
+    UpdateSegmentIndexUnlocked(segments_.size() - 1);
+  }
 
   return Status::OK();
 }
@@ -476,6 +496,7 @@ Status LogReader::AppendSegmentUnlocked(const scoped_refptr<ReadableLogSegment>&
              segment->header().sequence_number());
   }
   segments_.push_back(segment);
+  UpdateSegmentIndexUnlocked(segments_.size() - 1);
   return Status::OK();
 }
 
@@ -488,6 +509,7 @@ Status LogReader::AppendEmptySegment(const scoped_refptr<ReadableLogSegment>& se
              segment->header().sequence_number());
   }
   segments_.push_back(segment);
+  UpdateSegmentIndexUnlocked(segments_.size() - 1);
   return Status::OK();
 }
 
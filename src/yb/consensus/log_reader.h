@@ -182,6 +182,13 @@ class LogReader {
   // written to.
   void UpdateLastSegmentOffset(int64_t readable_to_offset);
 
+  // Adds segments_[segment_idx] to max_replicate_index_prefix_ and min_replicate_index_, the
+  // segments before it must have been added already.
+  void UpdateSegmentIndexUnlocked(size_t segment_idx);
+
+  // Recomputes max_replicate_index_prefix_ and min_replicate_index_ from segments_.
+  void RebuildSegmentIndexUnlocked();
+
   // Read the LogEntryBatch pointed to by the provided index entry.
   // 'tmp_buf' is used as scratch space to avoid extra allocation.
   CHECKED_STATUS ReadBatchUsingIndexEntry(const LogIndexEntry& index_entry,
@@ -211,6 +218,14 @@ class LogReader {
   // order.
   SegmentSequence segments_;
 
+  // For each segment in the prefix of segments_ that have footers, the maximum replicate index in
+  // it and the segments before it. This is non-decreasing, so GetSegmentPrefixNotIncluding() can
+  // binary search it even if truncation left a segment with a lower maximum than its predecessor.
+  std::vector<int64_t> max_replicate_index_prefix_;
+
+  // The minimum replicate index in the segments with footers, or -1 if there is none.
+  int64_t min_replicate_index_ = -1;
+
   mutable simple_spinlock lock_;
 
   State state_;
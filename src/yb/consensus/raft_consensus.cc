@@ -53,6 +53,7 @@
 #include "yb/server/clock.h"
 #include "yb/server/metadata.h"
 #include "yb/tserver/tserver.pb.h"
+#include "yb/util/atomic.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/enums.h"
 #include "yb/util/flag_tags.h"
@@ -74,6 +75,23 @@ DEFINE_int32(raft_heartbeat_interval_ms, yb::NonTsanVsTsan(500, 1000),
              "and consider a leader to have failed if it misses several in a row.");
 TAG_FLAG(raft_heartbeat_interval_ms, advanced);
 
+DEFINE_int32(raft_quiescent_heartbeat_interval_ms, 0,
+             "If positive, the leader heartbeats at this interval instead of "
+             "raft_heartbeat_interval_ms to the followers that have all of its operations and "
+             "know that they are committed, and its followers wait correspondingly longer before "
+             "they consider it failed. The leader lease then expires between heartbeats, the "
+             "first read or write after that wakes the leader up.");
+TAG_FLAG(raft_quiescent_heartbeat_interval_ms, advanced);
+TAG_FLAG(raft_quiescent_heartbeat_interval_ms, runtime);
+
+DEFINE_bool(raft_enable_pre_vote, false,
+            "Whether a follower that detects the failure of its leader first asks the voters "
+            "whether they would vote for it, and only increments its term and starts the election "
+            "if a majority would. This keeps partitioned or lagging followers from inflating the "
+            "term and disrupting a live leader. Only enable it when all servers support pre-votes.");
+TAG_FLAG(raft_enable_pre_vote, advanced);
+TAG_FLAG(raft_enable_pre_vote, runtime);
+
 // Defaults to be the same value as the leader heartbeat interval.
 DEFINE_int32(leader_failure_monitor_check_mean_ms, -1,
              "The mean failure-checking interval of the randomized failure monitor. If this "
@@ -481,50 +499,13 @@ Status RaftConsensus::DoStartElection(
             << "Triggering leader election, mode=" << mode;
       }
 
-      // Increment the term.
-      RETURN_NOT_OK(IncrementTermUnlocked());
-
-      // Snooze to avoid the election timer firing again as much as possible.
-      // We do not disable the election timer while running an election.
-      RETURN_NOT_OK(EnsureFailureDetectorEnabledUnlocked());
-
-      MonoDelta timeout = LeaderElectionExpBackoffDeltaUnlocked();
-      RETURN_NOT_OK(SnoozeFailureDetectorUnlocked(timeout, ALLOW_LOGGING));
-
-      const RaftConfigPB& active_config = state_->GetActiveConfigUnlocked();
-      LOG_WITH_PREFIX_UNLOCKED(INFO) << "Starting election with config: "
-                                     << active_config.ShortDebugString();
-
-      // Initialize the VoteCounter.
-      int num_voters = CountVoters(active_config);
-      int majority_size = MajoritySize(num_voters);
-      auto counter = std::make_unique<VoteCounter>(num_voters, majority_size);
-
-      // Vote for ourselves.
-      // TODO: Consider using a separate Mutex for voting, which must sync to disk.
-      RETURN_NOT_OK(state_->SetVotedForCurrentTermUnlocked(state_->GetPeerUuid()));
-      bool duplicate;
-      RETURN_NOT_OK(counter->RegisterVote(state_->GetPeerUuid(), VOTE_GRANTED, &duplicate));
-      CHECK(!duplicate) << state_->LogPrefixUnlocked()
-                        << "Inexplicable duplicate self-vote for term "
-                        << state_->GetCurrentTermUnlocked();
-
-      VoteRequestPB request;
-      request.set_ignore_live_leader(mode == ELECT_EVEN_IF_LEADER_IS_ALIVE);
-      request.set_candidate_uuid(state_->GetPeerUuid());
-      request.set_candidate_term(state_->GetCurrentTermUnlocked());
-      request.set_tablet_id(state_->GetOptions().tablet_id);
-      *request.mutable_candidate_status()->mutable_last_received() =
-        state_->GetLastReceivedOpIdUnlocked();
-
-      election.reset(new LeaderElection(
-          active_config,
-          peer_proxy_factory_.get(),
-          request,
-          std::move(counter),
-          timeout,
-          suppress_vote_request,
-          Bind(&RaftConsensus::ElectionCallback, this, originator_uuid)));
+      // Elections that hand off leadership from a live leader skip the pre-vote, it would only
+      // delay them.
+      const PreElection preelection(
+          GetAtomicFlag(&FLAGS_raft_enable_pre_vote) && mode == NORMAL_ELECTION &&
+          !suppress_vote_request);
+      RETURN_NOT_OK(CreateElectionUnlocked(
+          mode, preelection, originator_uuid, suppress_vote_request, &election));
 
       // Clear the pending election op id so that we won't start the same pending election again.
       state_->ClearPendingElectionOpIdUnlocked();
@@ -545,6 +526,65 @@ Status RaftConsensus::DoStartElection(
   return Status::OK();
 }
 
+Status RaftConsensus::CreateElectionUnlocked(ElectionMode mode,
+                                             PreElection preelection,
+                                             const std::string& originator_uuid,
+                                             TEST_SuppressVoteRequest suppress_vote_request,
+                                             LeaderElectionPtr* election) {
+  // A pre-election asks for the votes of the next term without incrementing ours.
+  if (!preelection) {
+    RETURN_NOT_OK(IncrementTermUnlocked());
+  }
+  const ConsensusTerm election_term =
+      state_->GetCurrentTermUnlocked() + (preelection ? 1 : 0);
+
+  // Snooze to avoid the election timer firing again as much as possible.
+  // We do not disable the election timer while running an election.
+  RETURN_NOT_OK(EnsureFailureDetectorEnabledUnlocked());
+
+  MonoDelta timeout = LeaderElectionExpBackoffDeltaUnlocked();
+  RETURN_NOT_OK(SnoozeFailureDetectorUnlocked(timeout, ALLOW_LOGGING));
+
+  const RaftConfigPB& active_config = state_->GetActiveConfigUnlocked();
+  LOG_WITH_PREFIX_UNLOCKED(INFO) << "Starting " << (preelection ? "pre-" : "")
+                                 << "election with config: " << active_config.ShortDebugString();
+
+  // Initialize the VoteCounter.
+  int num_voters = CountVoters(active_config);
+  int majority_size = MajoritySize(num_voters);
+  auto counter = std::make_unique<VoteCounter>(num_voters, majority_size);
+
+  // Vote for ourselves. A pre-vote is not persisted, since it does not bind us to anything.
+  // TODO: Consider using a separate Mutex for voting, which must sync to disk.
+  if (!preelection) {
+    RETURN_NOT_OK(state_->SetVotedForCurrentTermUnlocked(state_->GetPeerUuid()));
+  }
+  bool duplicate;
+  RETURN_NOT_OK(counter->RegisterVote(state_->GetPeerUuid(), VOTE_GRANTED, &duplicate));
+  CHECK(!duplicate) << state_->LogPrefixUnlocked()
+                    << "Inexplicable duplicate self-vote for term " << election_term;
+
+  VoteRequestPB request;
+  request.set_ignore_live_leader(mode == ELECT_EVEN_IF_LEADER_IS_ALIVE);
+  request.set_candidate_uuid(state_->GetPeerUuid());
+  request.set_candidate_term(election_term);
+  request.set_tablet_id(state_->GetOptions().tablet_id);
+  request.set_preelection(preelection);
+  *request.mutable_candidate_status()->mutable_last_received() =
+    state_->GetLastReceivedOpIdUnlocked();
+
+  election->reset(new LeaderElection(
+      active_config,
+      peer_proxy_factory_.get(),
+      request,
+      std::move(counter),
+      timeout,
+      suppress_vote_request,
+      preelection ? Bind(&RaftConsensus::PreElectionCallback, this, mode, originator_uuid)
+                  : Bind(&RaftConsensus::ElectionCallback, this, originator_uuid)));
+  return Status::OK();
+}
+
 Status RaftConsensus::WaitUntilLeaderForTests(const MonoDelta& timeout) {
   MonoTime deadline = MonoTime::Now();
   deadline.AddDelta(timeout);
@@ -792,6 +832,7 @@ Status RaftConsensus::BecomeLeaderUnlocked() {
   withhold_votes_until_ = MonoTime::Max();
 
   leader_no_op_committed_ = false;
+  leader_ready_until_.store(0, std::memory_order_release);
   queue_->RegisterObserver(this);
   RETURN_NOT_OK(RefreshConsensusQueueAndPeersUnlocked());
 
@@ -828,6 +869,7 @@ Status RaftConsensus::BecomeReplicaUnlocked() {
     WithholdElectionAfterStepDown(std::string());
   }
 
+  leader_ready_until_.store(0, std::memory_order_release);
   state_->ClearLeaderUnlocked();
 
   // FD should be running while we are a follower.
@@ -1489,6 +1531,17 @@ Status RaftConsensus::UpdateReplica(ConsensusRequestPB* request,
     // We are guaranteed to be acting as a FOLLOWER at this point by the above
     // sanity check.
     RETURN_NOT_OK(SnoozeFailureDetectorUnlocked());
+    if (request->has_quiescent_heartbeat_interval_ms()) {
+      // The leader may not heartbeat again before the quiescent interval.
+      const int64_t quiescent_timeout_ms = request->quiescent_heartbeat_interval_ms() *
+                                           FLAGS_leader_failure_max_missed_heartbeat_periods;
+      const int64_t additional_ms = quiescent_timeout_ms -
+                                    MinimumElectionTimeout().ToMilliseconds();
+      if (additional_ms > 0) {
+        RETURN_NOT_OK(SnoozeFailureDetectorUnlocked(MonoDelta::FromMilliseconds(additional_ms),
+                                                    DO_NOT_LOG));
+      }
+    }
 
     // Update the expiration time of the current leader's lease, so that when this follower becomes
     // a leader, it can wait out the time interval while the old leader might still be active.
@@ -1816,7 +1869,8 @@ Status RaftConsensus::RequestVote(const VoteRequestPB* request, VoteResponsePB*
     return RequestVoteRespondInvalidTerm(request, response);
   }
 
-  // We already voted this term.
+  // We already voted this term. This also answers a pre-vote for our current term, which comes
+  // from a candidate that is behind us.
   if (request->candidate_term() == state_->GetCurrentTermUnlocked() &&
       state_->HasVotedCurrentTermUnlocked()) {
 
@@ -1829,8 +1883,9 @@ Status RaftConsensus::RequestVote(const VoteRequestPB* request, VoteResponsePB*
     return RequestVoteRespondAlreadyVotedForOther(request, response);
   }
 
-  // The term advanced.
-  if (request->candidate_term() > state_->GetCurrentTermUnlocked()) {
+  // The term advanced. A pre-vote leaves our term alone, the candidate advances it with the real
+  // election.
+  if (!request->preelection() && request->candidate_term() > state_->GetCurrentTermUnlocked()) {
     RETURN_NOT_OK_PREPEND(HandleTermAdvanceUnlocked(request->candidate_term()),
         Substitute("Could not step down in RequestVote. Current term: $0, candidate term: $1",
                    state_->GetCurrentTermUnlocked(), request->candidate_term()));
@@ -1842,6 +1897,10 @@ Status RaftConsensus::RequestVote(const VoteRequestPB* request, VoteResponsePB*
     return RequestVoteRespondLastOpIdTooOld(local_last_logged_opid, request, response);
   }
 
+  if (request->preelection()) {
+    return RequestVoteRespondPreVoteGranted(request, response);
+  }
+
   // Clear the pending election op id if any before granting the vote. If another peer jumps in
   // before we can catch up and start the election, let's not disrupt the quorum with another
   // election.
@@ -2312,6 +2371,17 @@ Status RaftConsensus::RequestVoteRespondIsBusy(const VoteRequestPB* request,
   return Status::OK();
 }
 
+Status RaftConsensus::RequestVoteRespondPreVoteGranted(const VoteRequestPB* request,
+                                                       VoteResponsePB* response) {
+  // Nothing to persist or snooze for: the candidate still has to win the real election.
+  FillVoteResponseVoteGranted(response);
+  LOG(INFO) << Substitute("$0: Granting yes pre-vote for candidate $1 in term $2.",
+                          GetRequestVoteLogPrefixUnlocked(),
+                          request->candidate_uuid(),
+                          request->candidate_term());
+  return Status::OK();
+}
+
 Status RaftConsensus::RequestVoteRespondVoteGranted(const VoteRequestPB* request,
                                                     VoteResponsePB* response) {
   // We know our vote will be "yes", so avoid triggering an election while we
@@ -2348,6 +2418,13 @@ RaftPeerPB::Role RaftConsensus::role() const {
 }
 
 Consensus::LeaderStatus RaftConsensus::leader_status() const {
+  // The old leader lease has expired and the no-op has been committed before the lease was
+  // recorded. Both of those never change back while the lease lasts, see leader_ready_until_.
+  const auto leader_ready_until = leader_ready_until_.load(std::memory_order_acquire);
+  if (leader_ready_until != 0 && MonoTime::Now().ToUint64() < leader_ready_until) {
+    return LeaderStatus::LEADER_AND_READY;
+  }
+
   ReplicaState::UniqueLock lock;
   CHECK_OK(state_->LockForRead(&lock));
 
@@ -2370,10 +2447,18 @@ Consensus::LeaderStatus RaftConsensus::leader_status() const {
       return LeaderStatus::LEADER_BUT_NOT_READY;
 
     case LeaderLeaseStatus::NO_MAJORITY_REPLICATED_LEASE:
+      if (GetAtomicFlag(&FLAGS_raft_quiescent_heartbeat_interval_ms) > 0) {
+        // The lease of a quiescent leader expires between heartbeats. Heartbeat right away to
+        // extend it, and let the client retry on this server.
+        peer_manager_->SignalRequest(RequestTriggerMode::ALWAYS_SEND);
+        return LeaderStatus::LEADER_BUT_NOT_READY;
+      }
       // Will retry to look up the leader, because it might have changed.
       return LeaderStatus::NOT_LEADER;
 
     case LeaderLeaseStatus::HAS_LEASE:
+      leader_ready_until_.store(state_->majority_replicated_lease_expiration().ToUint64(),
+                                std::memory_order_release);
       return LeaderStatus::LEADER_AND_READY;
   }
 
@@ -2517,6 +2602,60 @@ void RaftConsensus::ElectionCallback(const std::string& originator_uuid,
               state_->LogPrefixThreadSafe() + "Unable to run election callback");
 }
 
+void RaftConsensus::PreElectionCallback(ElectionMode mode,
+                                        const std::string& originator_uuid,
+                                        const ElectionResult& result) {
+  // Runs on a reactor thread, like ElectionCallback.
+  WARN_NOT_OK(thread_pool_->SubmitClosure(
+              Bind(&RaftConsensus::DoPreElectionCallback, this, mode, originator_uuid, result)),
+              state_->LogPrefixThreadSafe() + "Unable to run pre-election callback");
+}
+
+void RaftConsensus::DoPreElectionCallback(ElectionMode mode,
+                                          const std::string& originator_uuid,
+                                          const ElectionResult& result) {
+  LeaderElectionPtr election;
+  {
+    ReplicaState::UniqueLock lock;
+    Status s = state_->LockForConfigChange(&lock);
+    if (PREDICT_FALSE(!s.ok())) {
+      LOG_WITH_PREFIX(INFO) << "Received pre-election callback for term "
+                            << result.election_term << " while not running: " << s.ToString();
+      return;
+    }
+
+    if (result.decision == VOTE_DENIED) {
+      // Our term is unchanged, so the election timer retries with a backoff.
+      ignore_result(SnoozeFailureDetectorUnlocked(LeaderElectionExpBackoffDeltaUnlocked(),
+                                                  ALLOW_LOGGING));
+      LOG_WITH_PREFIX_UNLOCKED(INFO) << "Pre-election lost for term " << result.election_term
+                                     << ". Reason: "
+                                     << (!result.message.empty() ? result.message : "None given");
+      return;
+    }
+
+    // Someone else started an election, or we heard from a leader, while the pre-votes were
+    // in flight.
+    if (result.election_term != state_->GetCurrentTermUnlocked() + 1 ||
+        state_->GetActiveRoleUnlocked() != RaftPeerPB::FOLLOWER) {
+      LOG_WITH_PREFIX_UNLOCKED(INFO) << "Pre-election decision for defunct term "
+                                     << result.election_term;
+      return;
+    }
+
+    LOG_WITH_PREFIX_UNLOCKED(INFO) << "Pre-election won for term " << result.election_term;
+    s = CreateElectionUnlocked(
+        mode, PreElection::kFalse, originator_uuid, TEST_SuppressVoteRequest::kFalse, &election);
+    if (!s.ok()) {
+      LOG_WITH_PREFIX_UNLOCKED(WARNING) << "Failed to start election after pre-election: "
+                                        << s.ToString();
+      return;
+    }
+  }
+
+  election->Run();
+}
+
 void RaftConsensus::NotifyOriginatorAboutLostElection(const std::string& originator_uuid) {
   if (originator_uuid.empty()) {
     return;
@@ -2654,6 +2793,15 @@ Status RaftConsensus::GetLastOpId(OpIdType type, OpId* id) {
   return Status::OK();
 }
 
+Status RaftConsensus::ReadReplicatedMessagesForCDC(const OpId& from,
+                                                   int max_size_bytes,
+                                                   ReplicateMsgs* msgs) {
+  OpId committed_op_id;
+  RETURN_NOT_OK(GetLastOpId(COMMITTED_OPID, &committed_op_id));
+  return queue_->ReadReplicatedMessagesForCDC(
+      from.index(), committed_op_id.index(), max_size_bytes, msgs);
+}
+
 void RaftConsensus::MarkDirty(std::shared_ptr<StateChangeContext> context) {
   LOG(INFO) << "Calling mark dirty synchronously for reason code " << context->reason;
   mark_dirty_clbk_.Run(context);
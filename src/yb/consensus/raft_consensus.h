@@ -69,6 +69,7 @@ class Clock;
 
 namespace consensus {
 class ConsensusMetadata;
+class LeaderElection;
 class Peer;
 class PeerProxyFactory;
 class PeerManager;
@@ -76,6 +77,9 @@ class ReplicaState;
 struct ElectionResult;
 
 typedef std::function<void()> LostLeadershipListener;
+typedef scoped_refptr<LeaderElection> LeaderElectionPtr;
+
+YB_STRONGLY_TYPED_BOOL(PreElection);
 
 constexpr int32_t kDefaultLeaderLeaseDurationMs = 2000;
 
@@ -208,6 +212,10 @@ class RaftConsensus : public Consensus,
 
   CHECKED_STATUS GetLastOpId(OpIdType type, OpId* id) override;
 
+  CHECKED_STATUS ReadReplicatedMessagesForCDC(const OpId& from,
+                                              int max_size_bytes,
+                                              ReplicateMsgs* msgs) override;
+
  protected:
   // Trigger that a non-Operation ConsensusRound has finished replication.
   // If the replication was successful, an status will be OK. Otherwise, it
@@ -409,10 +417,29 @@ class RaftConsensus : public Consensus,
   CHECKED_STATUS RequestVoteRespondVoteGranted(const VoteRequestPB* request,
                                        VoteResponsePB* response);
 
+  // Respond to a pre-vote VoteRequest that the vote would be granted for candidate.
+  CHECKED_STATUS RequestVoteRespondPreVoteGranted(const VoteRequestPB* request,
+                                                  VoteResponsePB* response);
+
+  // Creates the election of the next term, to be run outside the lock. The real election
+  // increments the term and votes for this peer first. A pre-election leaves both alone and, when
+  // won, creates the real one.
+  CHECKED_STATUS CreateElectionUnlocked(ElectionMode mode,
+                                        PreElection preelection,
+                                        const std::string& originator_uuid,
+                                        TEST_SuppressVoteRequest suppress_vote_request,
+                                        LeaderElectionPtr* election);
+
   // Callback for leader election driver. ElectionCallback is run on the
   // reactor thread, so it simply defers its work to DoElectionCallback.
   void ElectionCallback(const std::string& originator_uuid, const ElectionResult& result);
   void DoElectionCallback(const std::string& originator_uuid, const ElectionResult& result);
+
+  // Callback for the pre-election driver. Runs the real election if the pre-election was won.
+  void PreElectionCallback(ElectionMode mode, const std::string& originator_uuid,
+                           const ElectionResult& result);
+  void DoPreElectionCallback(ElectionMode mode, const std::string& originator_uuid,
+                             const ElectionResult& result);
   void NotifyOriginatorAboutLostElection(const std::string& originator_uuid);
 
   // Helper struct that tracks the RunLeaderElection as part of leadership transferral.
@@ -565,6 +592,12 @@ class RaftConsensus : public Consensus,
   // after the new leader successful election.
   bool leader_no_op_committed_ = false;
 
+  // Time (in the MonoTime's uint64 representation) until which this leader holds a majority
+  // replicated lease, as seen by the last leader_status() call that found the lease. Until then
+  // leader_status() reports the leader as ready without taking the replica state lock, so that reads
+  // on hot tablets don't contend with replication. 0 when unknown, reset on each role change.
+  mutable std::atomic<uint64_t> leader_ready_until_{0};
+
   // UUID of new desired leader during stepdown.
   TabletServerId protege_leader_uuid_;
 
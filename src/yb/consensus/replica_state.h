@@ -387,6 +387,11 @@ class ReplicaState {
     return majority_replicated_ht_lease_expiration_.load(std::memory_order_acquire);
   }
 
+  // The update_lock_ must be held.
+  MonoTime majority_replicated_lease_expiration() const {
+    return majority_replicated_lease_expiration_;
+  }
+
  private:
 
   template <class Policy>
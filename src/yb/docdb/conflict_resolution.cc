@@ -13,6 +13,8 @@
 
 #include "yb/docdb/conflict_resolution.h"
 
+#include <condition_variable>
+
 #include <boost/scope_exit.hpp>
 
 #include "yb/common/hybrid_time.h"
@@ -22,12 +24,29 @@
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/intent_filter.h"
 #include "yb/docdb/shared_lock_manager.h"
 
 #include "yb/util/countdown_latch.h"
+#include "yb/util/flag_tags.h"
 
 using namespace std::placeholders;
 
+DEFINE_bool(enable_transaction_wait_queues, false,
+            "Whether transaction waits for completion of conflicting transactions, instead of "
+            "aborting them or failing right away.");
+TAG_FLAG(enable_transaction_wait_queues, advanced);
+
+DEFINE_int32(transaction_wait_queue_max_wait_ms, 1000,
+             "Max time that transaction waits for conflicting transactions. After it conflicts "
+             "are resolved using transaction priorities.");
+TAG_FLAG(transaction_wait_queue_max_wait_ms, advanced);
+
+DEFINE_int32(transaction_wait_queue_poll_interval_ms, 20,
+             "Interval of rechecking statuses of conflicting transactions, while waiting for "
+             "them.");
+TAG_FLAG(transaction_wait_queue_poll_interval_ms, advanced);
+
 namespace yb {
 namespace docdb {
 
@@ -35,6 +54,110 @@ namespace {
 
 using TransactionIdSet = std::unordered_set<TransactionId, TransactionIdHash>;
 
+// Transactions that wait for completion of conflicting transactions, in all tablets of this
+// process. Wakes up waiters when conflicting transaction completes, and detects deadlocks between
+// waiting transactions.
+class WaitQueue {
+ public:
+  static WaitQueue& Instance() {
+    static WaitQueue instance;
+    return instance;
+  }
+
+  // Registers that waiter waits for holders. Returns false if one of holders waits for waiter,
+  // directly or through other transactions, i.e. waiting would cause a deadlock.
+  // Otherwise fills generation that should be passed to Wait.
+  template <class Holders>
+  bool Start(const TransactionId& waiter, const Holders& holders, int64_t* generation) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& holder : holders) {
+      if (Reaches(holder.id, waiter)) {
+        return false;
+      }
+    }
+    RemoveUnlocked(waiter);
+    auto& edges = waits_for_[waiter];
+    for (const auto& holder : holders) {
+      edges.push_back(holder.id);
+      ++waited_[holder.id];
+    }
+    *generation = generation_;
+    return true;
+  }
+
+  void Finish(const TransactionId& waiter) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    RemoveUnlocked(waiter);
+  }
+
+  // Waits until one of waited transactions completes after Start returned generation, or until
+  // deadline.
+  void Wait(int64_t generation, std::chrono::steady_clock::time_point deadline) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait_until(lock, deadline, [this, generation] { return generation_ != generation; });
+  }
+
+  void Completed(const TransactionId& id) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (waited_.count(id) == 0) {
+        return;
+      }
+      ++generation_;
+    }
+    cond_.notify_all();
+  }
+
+ private:
+  // Checks whether from waits for to, directly or transitively.
+  bool Reaches(const TransactionId& from, const TransactionId& to) {
+    if (from == to) {
+      return true;
+    }
+    std::vector<const TransactionId*> queue = { &from };
+    TransactionIdSet visited = { from };
+    while (!queue.empty()) {
+      auto it = waits_for_.find(*queue.back());
+      queue.pop_back();
+      if (it == waits_for_.end()) {
+        continue;
+      }
+      for (const auto& id : it->second) {
+        if (id == to) {
+          return true;
+        }
+        if (visited.insert(id).second) {
+          queue.push_back(&id);
+        }
+      }
+    }
+    return false;
+  }
+
+  void RemoveUnlocked(const TransactionId& waiter) {
+    auto it = waits_for_.find(waiter);
+    if (it == waits_for_.end()) {
+      return;
+    }
+    for (const auto& holder : it->second) {
+      auto waited_it = waited_.find(holder);
+      if (--waited_it->second == 0) {
+        waited_.erase(waited_it);
+      }
+    }
+    waits_for_.erase(it);
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  // Incremented every time a waited transaction completes.
+  int64_t generation_ = 0;
+  // Maps waiting transaction to transactions that it waits for.
+  std::unordered_map<TransactionId, std::vector<TransactionId>, TransactionIdHash> waits_for_;
+  // Number of waiters for each waited transaction.
+  std::unordered_map<TransactionId, size_t, TransactionIdHash> waited_;
+};
+
 struct TransactionData {
   TransactionId id;
   TransactionStatus status;
@@ -75,6 +198,10 @@ class ConflictResolverContext {
 
   virtual HybridTime GetHybridTime() = 0;
 
+  // Id of transaction that could wait for completion of conflicting transactions, or nullptr if
+  // conflicts should be always resolved right away.
+  virtual const TransactionId* WaiterId() = 0;
+
  protected:
   ~ConflictResolverContext() {}
 };
@@ -82,9 +209,18 @@ class ConflictResolverContext {
 class ConflictResolver {
  public:
   ConflictResolver(rocksdb::DB* db,
+                   rocksdb::DB* intents_db,
+                   const IntentFilter* intent_filter,
                    TransactionStatusManager* status_manager,
                    ConflictResolverContext* context)
-    : db_(db), status_manager_(*status_manager), context_(*context) {}
+    : db_(db), intents_db_(intents_db), intent_filter_(intent_filter),
+      status_manager_(*status_manager), context_(*context) {}
+
+  ~ConflictResolver() {
+    if (wait_state_ == WaitState::kWaiting) {
+      WaitQueue::Instance().Finish(*context_.WaiterId());
+    }
+  }
 
   TransactionStatusManager& status_manager() {
     return status_manager_;
@@ -105,6 +241,10 @@ class ConflictResolver {
 
   // Reads conflicts for specified intent from DB.
   CHECKED_STATUS ReadIntentConflicts(IntentType type, KeyBytes* intent_key_prefix) {
+    // Most keys have no intents, the filter lets us skip the seek for them.
+    if (intent_filter_ && !intent_filter_->MayContain(intent_key_prefix->AsSlice())) {
+      return Status::OK();
+    }
     EnsureIntentIteratorCreated();
 
     const auto& conflicting_intent_types = kIntentConflicts[static_cast<size_t>(type)];
@@ -162,7 +302,7 @@ class ConflictResolver {
   void EnsureIntentIteratorCreated() {
     if (!intent_iter_) {
       intent_iter_ = CreateRocksDBIterator(
-          db_,
+          intents_db_,
           BloomFilterMode::DONT_USE_BLOOM_FILTER,
           boost::none /* user_key_for_filter */,
           rocksdb::kDefaultQueryId);
@@ -180,6 +320,10 @@ class ConflictResolver {
         return Status::OK();
       }
 
+      if (WaitForTransactions()) {
+        continue;
+      }
+
       RETURN_NOT_OK(context_.CheckPriority(this, &transactions_));
 
       AbortTransactions();
@@ -192,6 +336,42 @@ class ConflictResolver {
     }
   }
 
+  // Waits for completion of conflicting transactions, when wait queues are enabled.
+  // Returns false if conflicts should be resolved using priorities instead: waiting is not
+  // allowed, max wait time was exceeded or waiting would cause a deadlock.
+  bool WaitForTransactions() {
+    if (wait_state_ == WaitState::kResolve) {
+      return false;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (wait_state_ == WaitState::kNone) {
+      if (!FLAGS_enable_transaction_wait_queues || context_.WaiterId() == nullptr) {
+        wait_state_ = WaitState::kResolve;
+        return false;
+      }
+      wait_deadline_ = now + std::chrono::milliseconds(FLAGS_transaction_wait_queue_max_wait_ms);
+    }
+    auto& queue = WaitQueue::Instance();
+    const auto& waiter = *context_.WaiterId();
+    int64_t generation = 0;
+    if (now >= wait_deadline_ || !queue.Start(waiter, transactions_, &generation)) {
+      VLOG(1) << waiter << " stopped waiting, "
+              << (now >= wait_deadline_ ? "timed out" : "deadlock detected");
+      if (wait_state_ == WaitState::kWaiting) {
+        queue.Finish(waiter);
+      }
+      wait_state_ = WaitState::kResolve;
+      return false;
+    }
+    wait_state_ = WaitState::kWaiting;
+    // Status tablet does not notify us about completion of conflicting transaction, so statuses
+    // are rechecked periodically.
+    queue.Wait(generation, std::min(
+        wait_deadline_,
+        now + std::chrono::milliseconds(FLAGS_transaction_wait_queue_poll_interval_ms)));
+    return true;
+  }
+
   CHECKED_STATUS CheckLocalCommits() {
     auto write_iterator = transactions_.begin();
     for (const auto& transaction : transactions_) {
@@ -277,11 +457,25 @@ class ConflictResolver {
   }
 
   rocksdb::DB* db_;
+  rocksdb::DB* intents_db_;
+  const IntentFilter* intent_filter_;
   std::unique_ptr<rocksdb::Iterator> intent_iter_;
   TransactionStatusManager& status_manager_;
   ConflictResolverContext& context_;
   TransactionIdSet conflicts_;
   std::vector<TransactionData> transactions_;
+
+  enum class WaitState {
+    // Did not wait yet.
+    kNone,
+    // Registered in wait queue.
+    kWaiting,
+    // Conflicts are resolved using priorities.
+    kResolve,
+  };
+
+  WaitState wait_state_ = WaitState::kNone;
+  std::chrono::steady_clock::time_point wait_deadline_;
 };
 
 // Utility class for ResolveTransactionConflicts implementation.
@@ -393,6 +587,10 @@ class TransactionConflictResolverContext : public ConflictResolverContext {
     return hybrid_time_;
   }
 
+  const TransactionId* WaiterId() override {
+    return &*transaction_id_;
+  }
+
   const KeyValueWriteBatchPB& write_batch_;
   HybridTime hybrid_time_;
   Result<TransactionId> transaction_id_;
@@ -446,6 +644,11 @@ class OperationConflictResolverContext : public ConflictResolverContext {
     return hybrid_time_;
   }
 
+  // Non transactional operations do not wait, they have no id to detect deadlocks with.
+  const TransactionId* WaiterId() override {
+    return nullptr;
+  }
+
   CHECKED_STATUS CheckConflictWithCommitted(
       const TransactionId& id, HybridTime commit_time) override {
     hybrid_time_.MakeAtLeast(commit_time);
@@ -462,23 +665,31 @@ class OperationConflictResolverContext : public ConflictResolverContext {
 Status ResolveTransactionConflicts(const KeyValueWriteBatchPB& write_batch,
                                    HybridTime hybrid_time,
                                    rocksdb::DB* db,
+                                   rocksdb::DB* intents_db,
+                                   const IntentFilter* intent_filter,
                                    TransactionStatusManager* status_manager) {
   DCHECK(hybrid_time.is_valid());
   TransactionConflictResolverContext context(write_batch, hybrid_time);
-  ConflictResolver resolver(db, status_manager, &context);
+  ConflictResolver resolver(db, intents_db, intent_filter, status_manager, &context);
   return resolver.Resolve();
 }
 
 Result<HybridTime> ResolveOperationConflicts(const DocOperations& doc_ops,
                                              HybridTime hybrid_time,
                                              rocksdb::DB* db,
+                                             rocksdb::DB* intents_db,
+                                             const IntentFilter* intent_filter,
                                              TransactionStatusManager* status_manager) {
   OperationConflictResolverContext context(&doc_ops, hybrid_time);
-  ConflictResolver resolver(db, status_manager, &context);
+  ConflictResolver resolver(db, intents_db, intent_filter, status_manager, &context);
   RETURN_NOT_OK(resolver.Resolve());
   return context.GetHybridTime();
 }
 
+void TransactionCompleted(const TransactionId& id) {
+  WaitQueue::Instance().Completed(id);
+}
+
 #define INTENT_KEY_SCHECK(lhs, op, rhs, msg) \
   BOOST_PP_CAT(SCHECK_, op)(lhs, \
                             rhs, \
@@ -14,6 +14,8 @@
 #ifndef YB_DOCDB_CONFLICT_RESOLUTION_H
 #define YB_DOCDB_CONFLICT_RESOLUTION_H
 
+#include "yb/common/transaction.h"
+
 #include "yb/docdb/doc_operation.h"
 #include "yb/docdb/value_type.h"
 
@@ -33,21 +35,29 @@ class TransactionStatusManager;
 
 namespace docdb {
 
+class IntentFilter;
 class KeyValueWriteBatchPB;
 
 // Resolves conflicts for write batch of transaction.
 // Read all intents that could conflict with intents generated by provided write_batch.
 // Forms set of conflicting transactions.
+// When enable_transaction_wait_queues is set, waits for completion of conflicting transactions,
+// until transaction_wait_queue_max_wait_ms passes or a deadlock is detected.
 // Tries to abort transactions with lower priority.
 // If it conflicts with transaction with higher priority or committed one then error is returned.
 //
 // write_batch - values that would be written as part of transaction.
 // hybrid_time - current hybrid time.
 // db - db that contains tablet data.
+// intents_db - db that contains transaction intents, the same as db when they are not separated.
+// intent_filter - filter of the intents in intents_db, so keys without them are not sought, could
+//                 be null.
 // status_manager - status manager that should be used during this conflict resolution.
 CHECKED_STATUS ResolveTransactionConflicts(const KeyValueWriteBatchPB& write_batch,
                                            HybridTime hybrid_time,
                                            rocksdb::DB* db,
+                                           rocksdb::DB* intents_db,
+                                           const IntentFilter* intent_filter,
                                            TransactionStatusManager* status_manager);
 
 // Resolves conflicts for doc operations.
@@ -61,12 +71,21 @@ CHECKED_STATUS ResolveTransactionConflicts(const KeyValueWriteBatchPB& write_bat
 // doc_ops - doc operations that would be applied as part of operation.
 // hybrid_time - current hybrid time.
 // db - db that contains tablet data.
+// intents_db - db that contains transaction intents, the same as db when they are not separated.
+// intent_filter - filter of the intents in intents_db, so keys without them are not sought, could
+//                 be null.
 // status_manager - status manager that should be used during this conflict resolution.
 Result<HybridTime> ResolveOperationConflicts(const DocOperations& doc_ops,
                                              HybridTime hybrid_time,
                                              rocksdb::DB* db,
+                                             rocksdb::DB* intents_db,
+                                             const IntentFilter* intent_filter,
                                              TransactionStatusManager* status_manager);
 
+// Notifies transactions that wait for completion of transaction id in conflict resolution, that
+// it is completed, i.e. committed or aborted.
+void TransactionCompleted(const TransactionId& id);
+
 struct ParsedIntent {
   // Intent DocPath.
   Slice doc_path;
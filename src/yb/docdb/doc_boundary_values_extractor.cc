@@ -13,9 +13,29 @@
 //
 //
 
+#include <limits>
+#include <vector>
+
+#include "yb/rocksdb/db/compaction.h"
 #include "yb/rocksdb/db/dbformat.h"
+#include "yb/rocksdb/db/version_edit.h"
 
 #include "yb/docdb/doc_key.h"
+#include "yb/docdb/doc_kv_util.h"
+#include "yb/docdb/doc_ql_scanspec.h"
+#include "yb/docdb/packed_row.h"
+#include "yb/docdb/value.h"
+
+#include "yb/gutil/endian.h"
+#include "yb/util/flag_tags.h"
+
+DEFINE_bool(docdb_column_zone_maps, false,
+            "Record the smallest and largest values of each regular column in the boundary values "
+            "of the SST files written by flushes and compactions, and skip the scans whose "
+            "conditions on regular columns no file can satisfy. For analytics tables, whose scans "
+            "filter on regular columns.");
+TAG_FLAG(docdb_column_zone_maps, advanced);
+TAG_FLAG(docdb_column_zone_maps, runtime);
 
 namespace yb {
 namespace docdb {
@@ -29,9 +49,16 @@ Status GetPrimitiveValue(const rocksdb::UserBoundaryValues& values,
 namespace {
 
 constexpr rocksdb::UserBoundaryTag kDocHybridTimeTag = 1;
+constexpr rocksdb::UserBoundaryTag kValueTtlTag = 2;
+// Whether the column zone maps of a file cover all its records, see ZoneMapsMarkerValue.
+constexpr rocksdb::UserBoundaryTag kColumnZoneMapsTag = 3;
+// Present in the files that have range tombstone records, see RangeTombstonesMarkerValue.
+constexpr rocksdb::UserBoundaryTag kRangeTombstonesTag = 4;
 // Here we reserve some tags for future use.
 // Because Tag is persistent.
 constexpr rocksdb::UserBoundaryTag kRangeComponentsStart = 10;
+// The values of the regular column with id N are tagged kColumnValuesStart + N.
+constexpr rocksdb::UserBoundaryTag kColumnValuesStart = 1 << 16;
 
 // Wrapper for UserBoundaryValue that stores DocHybridTime.
 class DocHybridTimeValue : public rocksdb::UserBoundaryValue {
@@ -79,17 +106,165 @@ class DocHybridTimeValue : public rocksdb::UserBoundaryValue {
   Slice encoded_;
 };
 
-// Wrapper for UserBoundaryValue that stores PrimitiveValue with index.
+// Wrapper for UserBoundaryValue that stores the TTL of a value in milliseconds, so the largest one
+// is the maximum TTL of the values in a file. Values without TTL, that expire with the table TTL,
+// are stored as 0, and values that never expire as kNoExpiration.
+class ValueTtlValue : public rocksdb::UserBoundaryValue {
+ public:
+  static constexpr uint64_t kNoExpiration = std::numeric_limits<uint64_t>::max();
+
+  explicit ValueTtlValue(uint64_t ttl_ms) {
+    BigEndian::Store64(buffer_, ttl_ms);
+  }
+
+  static CHECKED_STATUS Create(Slice data, rocksdb::UserBoundaryValuePtr* value) {
+    CHECK_NOTNULL(value);
+    if (data.size() != sizeof(uint64_t)) {
+      return STATUS_SUBSTITUTE(Corruption, "Wrong size of encoded value TTL: $0", data.size());
+    }
+
+    *value = std::make_shared<ValueTtlValue>(BigEndian::Load64(data.data()));
+    return Status::OK();
+  }
+
+  static uint64_t ToMilliseconds(const MonoDelta& ttl) {
+    if (ttl.Equals(Value::kMaxTtl)) {
+      return 0;
+    }
+    const int64_t ttl_ms = ttl.ToMilliseconds();
+    return ttl_ms == kResetTTL ? kNoExpiration : std::max<int64_t>(ttl_ms, 0);
+  }
+
+  static uint64_t Decode(Slice data) {
+    return BigEndian::Load64(data.data());
+  }
+
+  virtual ~ValueTtlValue() {}
+
+  rocksdb::UserBoundaryTag Tag() override {
+    return kValueTtlTag;
+  }
+
+  Slice Encode() override {
+    return Slice(buffer_, sizeof(buffer_));
+  }
+
+  int CompareTo(const UserBoundaryValue& pre_rhs) override {
+    const auto* rhs = down_cast<const ValueTtlValue*>(&pre_rhs);
+    return memcmp(buffer_, rhs->buffer_, sizeof(buffer_));
+  }
+
+ private:
+  char buffer_[sizeof(uint64_t)];
+};
+
+// Wrapper for UserBoundaryValue that stores a flag, whose smallest value over the records of a file
+// is kept. Every record is extracted with kCovered when FLAGS_docdb_column_zone_maps is set and
+// its column value, if any, is recorded, so the column zone maps of a file are complete when its
+// smallest marker is kCovered. Files written before the marker existed have no marker at all.
+class ZoneMapsMarkerValue : public rocksdb::UserBoundaryValue {
+ public:
+  static constexpr uint8_t kNotCovered = 0;
+  static constexpr uint8_t kCovered = 1;
+
+  explicit ZoneMapsMarkerValue(uint8_t marker) : marker_(marker) {}
+
+  static CHECKED_STATUS Create(Slice data, rocksdb::UserBoundaryValuePtr* value) {
+    CHECK_NOTNULL(value);
+    if (data.size() != 1) {
+      return STATUS_SUBSTITUTE(Corruption, "Wrong size of column zone maps marker: $0",
+                               data.size());
+    }
+
+    *value = Instance(data[0]);
+    return Status::OK();
+  }
+
+  // The markers are shared, so extracting them does not allocate.
+  static const rocksdb::UserBoundaryValuePtr& Instance(uint8_t marker) {
+    static const rocksdb::UserBoundaryValuePtr not_covered =
+        std::make_shared<ZoneMapsMarkerValue>(kNotCovered);
+    static const rocksdb::UserBoundaryValuePtr covered =
+        std::make_shared<ZoneMapsMarkerValue>(kCovered);
+    return marker == kCovered ? covered : not_covered;
+  }
+
+  virtual ~ZoneMapsMarkerValue() {}
+
+  rocksdb::UserBoundaryTag Tag() override {
+    return kColumnZoneMapsTag;
+  }
+
+  Slice Encode() override {
+    return Slice(&marker_, 1);
+  }
+
+  int CompareTo(const UserBoundaryValue& pre_rhs) override {
+    const auto* rhs = down_cast<const ZoneMapsMarkerValue*>(&pre_rhs);
+    return static_cast<int>(marker_) - rhs->marker_;
+  }
+
+ private:
+  uint8_t marker_;
+};
+
+// Wrapper for UserBoundaryValue that is only extracted from range tombstone records. A range
+// tombstone covers rows whose range components are not in the boundary values of its file, so the
+// files that have it are not skipped by the range components of a scan, see RangeBasedFileFilter.
+class RangeTombstonesMarkerValue : public rocksdb::UserBoundaryValue {
+ public:
+  static CHECKED_STATUS Create(Slice data, rocksdb::UserBoundaryValuePtr* value) {
+    CHECK_NOTNULL(value);
+    *value = Instance();
+    return Status::OK();
+  }
+
+  static const rocksdb::UserBoundaryValuePtr& Instance() {
+    static const rocksdb::UserBoundaryValuePtr instance =
+        std::make_shared<RangeTombstonesMarkerValue>();
+    return instance;
+  }
+
+  virtual ~RangeTombstonesMarkerValue() {}
+
+  rocksdb::UserBoundaryTag Tag() override {
+    return kRangeTombstonesTag;
+  }
+
+  Slice Encode() override {
+    static const char kMarker = 1;
+    return Slice(&kMarker, 1);
+  }
+
+  int CompareTo(const UserBoundaryValue& pre_rhs) override {
+    return 0;
+  }
+};
+
+bool IsRangeTombstoneRecord(Slice user_key) {
+  auto doc_key_size = DocKey::EncodedSize(user_key, DocKeyPart::WHOLE_DOC_KEY);
+  if (!doc_key_size.ok() || *doc_key_size >= user_key.size() ||
+      user_key[*doc_key_size] != static_cast<char>(ValueType::kSystemColumnId)) {
+    return false;
+  }
+  user_key.remove_prefix(*doc_key_size);
+  PrimitiveValue column;
+  return column.DecodeFromKey(&user_key).ok() &&
+         column == PrimitiveValue::SystemColumnId(SystemColumnIds::kRangeTombstones);
+}
+
+// Wrapper for UserBoundaryValue that stores PrimitiveValue encoded as a key, either a range
+// component with index or a value of a regular column.
 class PrimitiveBoundaryValue : public rocksdb::UserBoundaryValue {
  public:
-  explicit PrimitiveBoundaryValue(size_t index, Slice slice) : index_(index) {
+  explicit PrimitiveBoundaryValue(rocksdb::UserBoundaryTag tag, Slice slice) : tag_(tag) {
     buffer_.assign(slice.data(), slice.end());
   }
 
   static CHECKED_STATUS Create(size_t index, Slice data, rocksdb::UserBoundaryValuePtr* value) {
     CHECK_NOTNULL(value);
 
-    *value = std::make_shared<PrimitiveBoundaryValue>(index, data);
+    *value = std::make_shared<PrimitiveBoundaryValue>(TagForIndex(index), data);
     return Status::OK();
   }
 
@@ -99,8 +274,12 @@ class PrimitiveBoundaryValue : public rocksdb::UserBoundaryValue {
     return static_cast<uint32_t>(kRangeComponentsStart + index);
   }
 
+  static rocksdb::UserBoundaryTag TagForColumn(ColumnId column_id) {
+    return static_cast<uint32_t>(kColumnValuesStart + column_id.rep());
+  }
+
   rocksdb::UserBoundaryTag Tag() override {
-    return TagForIndex(index_);
+    return tag_;
   }
 
   Slice Encode() override {
@@ -131,10 +310,120 @@ class PrimitiveBoundaryValue : public rocksdb::UserBoundaryValue {
     return Encode().compare(rhs->Encode());
   }
  private:
-  size_t index_; // Index of corresponding range component.
+  rocksdb::UserBoundaryTag tag_;
   boost::container::small_vector<uint8_t, 128> buffer_;
 };
 
+// Whether the key encodings of the values of this type compare as the values, so the column
+// predicates can be checked against the zone maps.
+bool IsZoneMapValueType(ValueType value_type) {
+  switch (value_type) {
+    case ValueType::kFalse: FALLTHROUGH_INTENDED;
+    case ValueType::kTrue: FALLTHROUGH_INTENDED;
+    case ValueType::kInt32: FALLTHROUGH_INTENDED;
+    case ValueType::kInt64: FALLTHROUGH_INTENDED;
+    case ValueType::kFloat: FALLTHROUGH_INTENDED;
+    case ValueType::kDouble: FALLTHROUGH_INTENDED;
+    case ValueType::kDecimal: FALLTHROUGH_INTENDED;
+    case ValueType::kString: FALLTHROUGH_INTENDED;
+    case ValueType::kTimestamp:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Longer values are recorded as the range of the values with the same prefix, so that the zone
+// maps of columns with large values do not bloat the manifest.
+constexpr size_t kMaxZoneMapValueSize = 64;
+
+// Adds the value of a regular column to the zone maps. Returns false when the value cannot be
+// recorded, i.e. is neither a comparable primitive value nor a tombstone.
+bool AddColumnValue(const PrimitiveValue& column, const PrimitiveValue& value,
+                    rocksdb::UserBoundaryValues* values) {
+  if (value.value_type() == ValueType::kTombstone) {
+    // Deleted values never satisfy a predicate.
+    return true;
+  }
+  if (column.value_type() != ValueType::kColumnId || !IsZoneMapValueType(value.value_type())) {
+    return false;
+  }
+  const auto tag = PrimitiveBoundaryValue::TagForColumn(column.GetColumnId());
+  KeyBytes encoded;
+  value.AppendToKey(&encoded);
+  Slice slice = encoded.AsSlice();
+  if (slice.size() <= kMaxZoneMapValueSize) {
+    values->push_back(std::make_shared<PrimitiveBoundaryValue>(tag, slice));
+    return true;
+  }
+  // Both bounds have the same tag, the smallest one ends up in the smallest boundary values of the
+  // file and the largest one in the largest.
+  std::string prefix(slice.cdata(), kMaxZoneMapValueSize);
+  values->push_back(std::make_shared<PrimitiveBoundaryValue>(tag, prefix));
+  // The successor of the prefix is larger than all the values with it.
+  while (!prefix.empty() && static_cast<uint8_t>(prefix.back()) == 0xff) {
+    prefix.pop_back();
+  }
+  if (prefix.empty()) {
+    return false;
+  }
+  ++prefix.back();
+  values->push_back(std::make_shared<PrimitiveBoundaryValue>(tag, prefix));
+  return true;
+}
+
+// Adds the value of the record to the column zone maps, and returns the marker of the record.
+uint8_t ExtractColumnValues(Slice user_key, Slice value, rocksdb::UserBoundaryValues* values) {
+  auto doc_key_size = DocKey::EncodedSize(user_key, DocKeyPart::WHOLE_DOC_KEY);
+  if (!doc_key_size.ok()) {
+    return ZoneMapsMarkerValue::kNotCovered;
+  }
+  Slice subkeys(user_key.data() + *doc_key_size, user_key.end());
+  ValueType value_type;
+  if (!Value::DecodePrimitiveValueType(value, &value_type).ok()) {
+    return ZoneMapsMarkerValue::kNotCovered;
+  }
+  if (value_type == ValueType::kPackedRow) {
+    Value doc_value;
+    PackedColumns columns;
+    if (!doc_value.Decode(value).ok() ||
+        !DecodePackedRow(doc_value.primitive_value().GetPackedRow(), &columns).ok()) {
+      return ZoneMapsMarkerValue::kNotCovered;
+    }
+    for (const auto& column : columns) {
+      if (!AddColumnValue(column.first, column.second, values)) {
+        return ZoneMapsMarkerValue::kNotCovered;
+      }
+    }
+    return ZoneMapsMarkerValue::kCovered;
+  }
+  // Only the records of a whole regular column carry values the predicates compare, the others
+  // are row liveness markers, collection elements and such.
+  if (subkeys.empty() || subkeys[0] != static_cast<char>(ValueType::kColumnId)) {
+    return ZoneMapsMarkerValue::kCovered;
+  }
+  PrimitiveValue column;
+  if (!column.DecodeFromKey(&subkeys).ok() || subkeys.empty()) {
+    return ZoneMapsMarkerValue::kNotCovered;
+  }
+  if (subkeys[0] != static_cast<char>(ValueType::kHybridTime)) {
+    // An element of a collection column.
+    return ZoneMapsMarkerValue::kCovered;
+  }
+  if (value_type == ValueType::kTombstone) {
+    return ZoneMapsMarkerValue::kCovered;
+  }
+  if (!IsZoneMapValueType(value_type)) {
+    return ZoneMapsMarkerValue::kNotCovered;
+  }
+  Value doc_value;
+  if (!doc_value.Decode(value).ok()) {
+    return ZoneMapsMarkerValue::kNotCovered;
+  }
+  return AddColumnValue(column, doc_value.primitive_value(), values)
+      ? ZoneMapsMarkerValue::kCovered : ZoneMapsMarkerValue::kNotCovered;
+}
+
 class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
  public:
   virtual ~DocBoundaryValuesExtractor() {}
@@ -146,6 +435,19 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
     if (tag == kDocHybridTimeTag) {
       return DocHybridTimeValue::Create(data, value);
     }
+    if (tag == kValueTtlTag) {
+      return ValueTtlValue::Create(data, value);
+    }
+    if (tag == kColumnZoneMapsTag) {
+      return ZoneMapsMarkerValue::Create(data, value);
+    }
+    if (tag == kRangeTombstonesTag) {
+      return RangeTombstonesMarkerValue::Create(data, value);
+    }
+    if (tag >= kColumnValuesStart) {
+      *value = std::make_shared<PrimitiveBoundaryValue>(tag, data);
+      return Status::OK();
+    }
     if (tag >= kRangeComponentsStart) {
       return PrimitiveBoundaryValue::Create(tag - kRangeComponentsStart, data, value);
     }
@@ -162,6 +464,16 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
       return Status::OK();
     }
 
+    // Every record carries the marker, so that files written without the zone maps are not
+    // covered even when they are compacted with files written with them.
+    if (!FLAGS_docdb_column_zone_maps || user_key.empty() ||
+        static_cast<ValueType>(user_key[0]) == ValueType::kIntentPrefix) {
+      values->push_back(ZoneMapsMarkerValue::Instance(ZoneMapsMarkerValue::kNotCovered));
+    } else {
+      values->push_back(ZoneMapsMarkerValue::Instance(
+          ExtractColumnValues(user_key, value, values)));
+    }
+
     CHECK_NOTNULL(values);
     boost::container::small_vector<Slice, 20> slices;
     auto user_key_copy = user_key;
@@ -177,6 +489,10 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
     RETURN_NOT_OK(DocHybridTimeValue::Create(slices.back(), &temp));
     values->push_back(std::move(temp));
 
+    MonoDelta ttl;
+    RETURN_NOT_OK(Value::DecodeTTLSkippingIntentDocHT(value, &ttl));
+    values->push_back(std::make_shared<ValueTtlValue>(ValueTtlValue::ToMilliseconds(ttl)));
+
     for (size_t i = 0; i != size; ++i) {
       RETURN_NOT_OK(PrimitiveBoundaryValue::Create(i, slices[i], &temp));
       values->push_back(std::move(temp));
@@ -184,6 +500,11 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
 
     DCHECK(PerformSanityCheck(user_key, slices, *values));
 
+    // Range tombstones are stored in the static rows, which have no range components.
+    if (size == 0 && IsRangeTombstoneRecord(user_key)) {
+      values->push_back(RangeTombstonesMarkerValue::Instance());
+    }
+
     return Status::OK();
   }
 
@@ -219,6 +540,83 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
   }
 };
 
+// Skips the SST files without records written in [min_hybrid_time, max_hybrid_time], using the
+// boundary hybrid times recorded by DocBoundaryValuesExtractor. Files written without boundary
+// values are never skipped.
+class HybridTimeFileFilter : public rocksdb::ReadFileFilter {
+ public:
+  HybridTimeFileFilter(HybridTime min_hybrid_time, HybridTime max_hybrid_time,
+                       std::shared_ptr<rocksdb::ReadFileFilter> next)
+      : min_hybrid_time_(min_hybrid_time), max_hybrid_time_(max_hybrid_time),
+        next_(std::move(next)) {}
+
+  bool Filter(const rocksdb::FdWithBoundaries& file) const override {
+    if (next_ && !next_->Filter(file)) {
+      return false;
+    }
+    DocHybridTime doc_ht;
+    if (max_hybrid_time_ != HybridTime::kMax &&
+        DecodeHybridTime(file.smallest, &doc_ht) && doc_ht.hybrid_time() > max_hybrid_time_) {
+      return false;
+    }
+    if (min_hybrid_time_ != HybridTime::kMin &&
+        DecodeHybridTime(file.largest, &doc_ht) && doc_ht.hybrid_time() < min_hybrid_time_) {
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  static bool DecodeHybridTime(const rocksdb::LightweightBoundaries& boundaries,
+                               DocHybridTime* out) {
+    const Slice* encoded = boundaries.user_value_with_tag(kDocHybridTimeTag);
+    return encoded != nullptr && out->FullyDecodeFrom(*encoded).ok();
+  }
+
+  const HybridTime min_hybrid_time_;
+  const HybridTime max_hybrid_time_;
+  const std::shared_ptr<rocksdb::ReadFileFilter> next_;
+};
+
+// Hybrid times and expiration of the records of a file, based on its boundary values.
+struct FileExpiration {
+  explicit FileExpiration(const rocksdb::FileMetaData& file) {
+    auto min_ht = rocksdb::UserValueWithTag(file.smallest.user_values, kDocHybridTimeTag);
+    auto max_ht = rocksdb::UserValueWithTag(file.largest.user_values, kDocHybridTimeTag);
+    auto max_ttl = rocksdb::UserValueWithTag(file.largest.user_values, kValueTtlTag);
+    if (!min_ht || !max_ht || !max_ttl) {
+      return;
+    }
+    DocHybridTime doc_ht;
+    if (!down_cast<DocHybridTimeValue*>(min_ht.get())->value(&doc_ht).ok()) {
+      return;
+    }
+    min_hybrid_time = doc_ht.hybrid_time();
+    if (!down_cast<DocHybridTimeValue*>(max_ht.get())->value(&doc_ht).ok()) {
+      return;
+    }
+    max_hybrid_time = doc_ht.hybrid_time();
+    max_value_ttl_ms = ValueTtlValue::Decode(max_ttl->Encode());
+    has_boundaries = true;
+  }
+
+  // Whether all the records of the file expire by history_cutoff.
+  bool Expired(HybridTime history_cutoff, MonoDelta table_ttl) const {
+    if (!has_boundaries || max_value_ttl_ms == ValueTtlValue::kNoExpiration) {
+      return false;
+    }
+    const auto ttl = std::max(table_ttl, MonoDelta::FromMilliseconds(max_value_ttl_ms));
+    bool has_expired = false;
+    return HasExpiredTTL(max_hybrid_time, ttl, history_cutoff, &has_expired).ok() && has_expired;
+  }
+
+  bool has_boundaries = false;
+  // Without boundaries, the file could contain records written at any hybrid time.
+  HybridTime min_hybrid_time = HybridTime::kMin;
+  HybridTime max_hybrid_time = HybridTime::kMax;
+  uint64_t max_value_ttl_ms = ValueTtlValue::kNoExpiration;
+};
+
 } // namespace
 
 std::shared_ptr<rocksdb::BoundaryValuesExtractor> DocBoundaryValuesExtractorInstance() {
@@ -248,9 +646,103 @@ Status GetDocHybridTime(const rocksdb::UserBoundaryValues& values, DocHybridTime
   return time_value->value(out);
 }
 
+std::shared_ptr<rocksdb::ReadFileFilter> CreateHybridTimeFileFilter(
+    HybridTime min_hybrid_time, HybridTime max_hybrid_time,
+    std::shared_ptr<rocksdb::ReadFileFilter> next) {
+  if (min_hybrid_time == HybridTime::kMin && max_hybrid_time == HybridTime::kMax) {
+    return next;
+  }
+  return std::make_shared<HybridTimeFileFilter>(min_hybrid_time, max_hybrid_time, std::move(next));
+}
+
+size_t NumExpiredOldestFiles(const std::vector<rocksdb::FileMetaData*>& files,
+                             HybridTime history_cutoff, MonoDelta table_ttl) {
+  if (table_ttl.Equals(Value::kMaxTtl) || files.empty()) {
+    return 0;
+  }
+  std::vector<FileExpiration> expirations;
+  expirations.reserve(files.size());
+  // min_retained_hybrid_time[i] is the minimal hybrid time of the records in files newer than
+  // files[i].
+  std::vector<HybridTime> min_retained_hybrid_time(files.size(), HybridTime::kMax);
+  for (size_t i = 0; i != files.size(); ++i) {
+    expirations.emplace_back(*files[i]);
+    if (i + 1 != files.size()) {
+      min_retained_hybrid_time[i + 1] =
+          std::min(min_retained_hybrid_time[i], expirations.back().min_hybrid_time);
+    }
+  }
+
+  // A deleted record could still hide an older record of the same key from the files that are
+  // kept, so the deleted files should be older in hybrid time than all the remaining ones.
+  size_t result = 0;
+  HybridTime max_deleted_hybrid_time = HybridTime::kMin;
+  for (size_t i = files.size(); i-- > 0;) {
+    const auto& expiration = expirations[i];
+    if (!expiration.Expired(history_cutoff, table_ttl)) {
+      break;
+    }
+    max_deleted_hybrid_time = std::max(max_deleted_hybrid_time, expiration.max_hybrid_time);
+    if (max_deleted_hybrid_time < min_retained_hybrid_time[i]) {
+      result = files.size() - i;
+    }
+  }
+  return result;
+}
+
+bool ColumnValuesMayExist(rocksdb::DB* rocksdb, const std::vector<ColumnValueBounds>& bounds) {
+  if (bounds.empty()) {
+    return true;
+  }
+  // A memtable switch moves the records of the active memtable to the immutable ones, and a flush
+  // moves them to a file, so checking in this order does not miss the records moved in between.
+  for (const auto* property : { &rocksdb::DB::Properties::kNumEntriesActiveMemTable,
+                                &rocksdb::DB::Properties::kNumEntriesImmMemTables }) {
+    uint64_t num_entries = 0;
+    if (!rocksdb->GetIntProperty(*property, &num_entries) || num_entries != 0) {
+      return true;
+    }
+  }
+  std::vector<rocksdb::LiveFileMetaData> files;
+  rocksdb->GetLiveFilesMetaData(&files);
+  for (const auto& file : files) {
+    auto marker = rocksdb::UserValueWithTag(file.smallest.user_values, kColumnZoneMapsTag);
+    if (!marker || marker->Encode()[0] != ZoneMapsMarkerValue::kCovered) {
+      return true;
+    }
+  }
+  for (const auto& column_bounds : bounds) {
+    const auto tag = PrimitiveBoundaryValue::TagForColumn(column_bounds.column_id);
+    bool may_exist = false;
+    for (const auto& file : files) {
+      auto smallest = rocksdb::UserValueWithTag(file.smallest.user_values, tag);
+      auto largest = rocksdb::UserValueWithTag(file.largest.user_values, tag);
+      if (!smallest || !largest) {
+        // The file has no value of the column.
+        continue;
+      }
+      if ((column_bounds.upper.size() == 0 ||
+           smallest->Encode().compare(column_bounds.upper.AsSlice()) <= 0) &&
+          (column_bounds.lower.size() == 0 ||
+           largest->Encode().compare(column_bounds.lower.AsSlice()) >= 0)) {
+        may_exist = true;
+        break;
+      }
+    }
+    if (!may_exist) {
+      return false;
+    }
+  }
+  return true;
+}
+
 rocksdb::UserBoundaryTag TagForRangeComponent(size_t index) {
   return PrimitiveBoundaryValue::TagForIndex(index);
 }
 
+rocksdb::UserBoundaryTag TagForRangeTombstones() {
+  return kRangeTombstonesTag;
+}
+
 } // namespace docdb
 } // namespace yb
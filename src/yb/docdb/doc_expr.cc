@@ -46,33 +46,38 @@ CHECKED_STATUS DocExprExecutor::EvalTSCall(const QLBCallPB& tscall,
       return Status::OK();
     }
 
-    case TSOpcode::kCount:
+    case TSOpcode::kCount: {
+      // CQL does not count NULL value of a column.
       if (tscall.operands(0).has_column_id()) {
-        // Check if column value is NULL. CQL does not count NULL value of a column.
-        QLValue arg_result;
-        RETURN_NOT_OK(EvalExpr(tscall.operands(0), table_row, &arg_result));
-        if (arg_result.IsNull()) {
+        QLValue buffer;
+        const QLValuePB* arg_result = nullptr;
+        RETURN_NOT_OK(EvalAggregateArg(tscall.operands(0), table_row, &buffer, &arg_result));
+        if (IsNull(*arg_result)) {
           return Status::OK();
         }
       }
       return EvalCount(result);
+    }
 
     case TSOpcode::kSum: {
-      QLValue arg_result;
-      RETURN_NOT_OK(EvalExpr(tscall.operands(0), table_row, &arg_result));
-      return EvalSum(arg_result, result);
+      QLValue buffer;
+      const QLValuePB* arg_result = nullptr;
+      RETURN_NOT_OK(EvalAggregateArg(tscall.operands(0), table_row, &buffer, &arg_result));
+      return EvalSum(*arg_result, result);
     }
 
     case TSOpcode::kMin: {
-      QLValue arg_result;
-      RETURN_NOT_OK(EvalExpr(tscall.operands(0), table_row, &arg_result));
-      return EvalMin(arg_result, result);
+      QLValue buffer;
+      const QLValuePB* arg_result = nullptr;
+      RETURN_NOT_OK(EvalAggregateArg(tscall.operands(0), table_row, &buffer, &arg_result));
+      return EvalMin(*arg_result, result);
     }
 
     case TSOpcode::kMax: {
-      QLValue arg_result;
-      RETURN_NOT_OK(EvalExpr(tscall.operands(0), table_row, &arg_result));
-      return EvalMax(arg_result, result);
+      QLValue buffer;
+      const QLValuePB* arg_result = nullptr;
+      RETURN_NOT_OK(EvalAggregateArg(tscall.operands(0), table_row, &buffer, &arg_result));
+      return EvalMax(*arg_result, result);
     }
 
     case TSOpcode::kAvg:
@@ -122,6 +127,26 @@ CHECKED_STATUS DocExprExecutor::EvalTSCall(const QLBCallPB& tscall,
   return Status::OK();
 }
 
+CHECKED_STATUS DocExprExecutor::EvalAggregateArg(const QLExpressionPB& arg,
+                                                 const QLTableRow::SharedPtrConst& table_row,
+                                                 QLValue* buffer,
+                                                 const QLValuePB** value) {
+  if (arg.has_column_id()) {
+    const QLTableColumn* column = table_row->GetColumn(arg.column_id());
+    if (column != nullptr) {
+      *value = &column->value;
+      return Status::OK();
+    }
+    // Column is not in the row, so its value is null.
+    buffer->SetNull();
+    *value = &buffer->value();
+    return Status::OK();
+  }
+  RETURN_NOT_OK(EvalExpr(arg, table_row, buffer));
+  *value = &buffer->value();
+  return Status::OK();
+}
+
 CHECKED_STATUS DocExprExecutor::EvalCount(QLValue *aggr_count) {
   if (aggr_count->IsNull()) {
     aggr_count->set_int64_value(1);
@@ -131,8 +156,8 @@ CHECKED_STATUS DocExprExecutor::EvalCount(QLValue *aggr_count) {
   return Status::OK();
 }
 
-CHECKED_STATUS DocExprExecutor::EvalSum(const QLValue& val, QLValue *aggr_sum) {
-  if (val.IsNull()) {
+CHECKED_STATUS DocExprExecutor::EvalSum(const QLValuePB& val, QLValue *aggr_sum) {
+  if (IsNull(val)) {
     return Status::OK();
   }
 
@@ -160,21 +185,35 @@ CHECKED_STATUS DocExprExecutor::EvalSum(const QLValue& val, QLValue *aggr_sum) {
     case InternalType::kDoubleValue:
       aggr_sum->set_double_value(aggr_sum->double_value() + val.double_value());
       break;
+    case InternalType::kDecimalValue: {
+      util::Decimal sum, value;
+      RETURN_NOT_OK(sum.DecodeFromComparable(aggr_sum->decimal_value()));
+      RETURN_NOT_OK(value.DecodeFromComparable(val.decimal_value()));
+      aggr_sum->set_decimal_value((sum + value).EncodeToComparable());
+      break;
+    }
+    case InternalType::kVarintValue: {
+      util::VarInt value;
+      size_t num_decoded_bytes = 0;
+      RETURN_NOT_OK(value.DecodeFromComparable(val.varint_value(), &num_decoded_bytes));
+      aggr_sum->set_varint_value(aggr_sum->varint_value() + value);
+      break;
+    }
     default:
       return STATUS(RuntimeError, "Cannot find SUM of this column");
   }
   return Status::OK();
 }
 
-CHECKED_STATUS DocExprExecutor::EvalMax(const QLValue& val, QLValue *aggr_max) {
-  if (!val.IsNull() && (aggr_max->IsNull() || *aggr_max < val)) {
+CHECKED_STATUS DocExprExecutor::EvalMax(const QLValuePB& val, QLValue *aggr_max) {
+  if (!IsNull(val) && (aggr_max->IsNull() || val > *aggr_max)) {
     *aggr_max = val;
   }
   return Status::OK();
 }
 
-CHECKED_STATUS DocExprExecutor::EvalMin(const QLValue& val, QLValue *aggr_min) {
-  if (!val.IsNull() && (aggr_min->IsNull() || *aggr_min > val)) {
+CHECKED_STATUS DocExprExecutor::EvalMin(const QLValuePB& val, QLValue *aggr_min) {
+  if (!IsNull(val) && (aggr_min->IsNull() || val < *aggr_min)) {
     *aggr_min = val;
   }
   return Status::OK();
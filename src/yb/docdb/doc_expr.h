@@ -33,9 +33,18 @@ class DocExprExecutor : public QLExprExecutor {
 
   // Evaluate aggregate functions for each row.
   CHECKED_STATUS EvalCount(QLValue *aggr_count);
-  CHECKED_STATUS EvalSum(const QLValue& val, QLValue *aggr_sum);
-  CHECKED_STATUS EvalMax(const QLValue& val, QLValue *aggr_max);
-  CHECKED_STATUS EvalMin(const QLValue& val, QLValue *aggr_min);
+  CHECKED_STATUS EvalSum(const QLValuePB& val, QLValue *aggr_sum);
+  CHECKED_STATUS EvalMax(const QLValuePB& val, QLValue *aggr_max);
+  CHECKED_STATUS EvalMin(const QLValuePB& val, QLValue *aggr_min);
+
+ private:
+  // Evaluates the argument of an aggregate function. When the argument is a column reference, the
+  // value cached in the row is returned without being copied, so that partial aggregation of a
+  // scan does not copy every column value. Otherwise, the argument is evaluated into 'buffer'.
+  CHECKED_STATUS EvalAggregateArg(const QLExpressionPB& arg,
+                                  const QLTableRow::SharedPtrConst& table_row,
+                                  QLValue* buffer,
+                                  const QLValuePB** value);
 
  protected:
   vector<QLValue> aggr_result_;
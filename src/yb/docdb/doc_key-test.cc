@@ -399,6 +399,41 @@ TEST(DocKeyTest, TestKeyMatching) {
   ASSERT_FALSE(may_match(EncodeSimpleSubDocKey(absent_key))) << "Key: " << absent_key;
 }
 
+TEST(DocKeyTest, TestIntentKeyMatching) {
+  DocDbAwareFilterPolicy policy(rocksdb::FilterPolicy::kDefaultFixedSizeFilterBits, nullptr);
+  std::string keys[] = { "foo", "bar", "test" };
+  std::string absent_key = "fake";
+
+  auto intent_key = [](const std::string& encoded_sub_doc_key) {
+    std::string result;
+    result.push_back(static_cast<char>(ValueType::kIntentPrefix));
+    result.append(encoded_sub_doc_key);
+    return result;
+  };
+
+  std::unique_ptr<FilterBitsBuilder> builder(policy.GetFilterBitsBuilder());
+  ASSERT_NE(builder, nullptr);
+  for (const auto& key : keys) {
+    builder->AddKey(policy.GetKeyTransformer()->Transform(intent_key(EncodeSimpleSubDocKey(key))));
+  }
+  std::unique_ptr<const char[]> buf;
+  rocksdb::Slice filter = builder->Finish(&buf);
+
+  std::unique_ptr<FilterBitsReader> reader(policy.GetFilterBitsReader(filter));
+
+  auto may_match = [&](const std::string& sub_doc_key_str) {
+    return reader->MayMatch(policy.GetKeyTransformer()->Transform(sub_doc_key_str));
+  };
+
+  // Intents for other range components of the same hashed components should match, because
+  // IntentAwareIterator checks intent files using kIntentPrefix + lower bound of the scan.
+  for (const auto &key : keys) {
+    ASSERT_TRUE(may_match(intent_key(EncodeSimpleSubDocKeyWithDifferentNonHashPart(key))))
+        << "Key: " << key;
+  }
+  ASSERT_FALSE(may_match(intent_key(EncodeSimpleSubDocKey(absent_key)))) << "Key: " << absent_key;
+}
+
 TEST(DocKeyTest, TestWriteId) {
   SubDocKey subdoc_key(DocKey({PrimitiveValue("a"), PrimitiveValue(135)}),
                        DocHybridTime(1000000, 4091, 135));
@@ -185,6 +185,18 @@ yb::Status DocKey::PartiallyDecode(rocksdb::Slice *slice,
   return DoDecode(slice, DocKeyPart::WHOLE_DOC_KEY, DecodeDocKeyCallback(out));
 }
 
+bool DocKey::DecodeHash(Slice slice, DocKeyHash* hash) {
+  if (!slice.empty() && slice[0] == static_cast<uint8_t>(ValueType::kIntentPrefix)) {
+    slice.consume_byte();
+  }
+  if (slice.size() < sizeof(DocKeyHash) + 1 ||
+      slice[0] != static_cast<uint8_t>(ValueType::kUInt16Hash)) {
+    return false;
+  }
+  *hash = BigEndian::Load16(slice.data() + 1);
+  return true;
+}
+
 Result<size_t> DocKey::EncodedSize(Slice slice, DocKeyPart part) {
   auto initial_begin = slice.cdata();
   RETURN_NOT_OK(DoDecode(&slice, part, DummyCallback()));
@@ -118,6 +118,10 @@ class DocKey {
 
   static Result<size_t> EncodedSize(Slice slice, DocKeyPart part);
 
+  // Reads the hash of the document key that the given RocksDB key starts with. Returns false if the
+  // document key has no hash.
+  static bool DecodeHash(Slice slice, DocKeyHash* hash);
+
   // Decode the current document key from the given slice, but expect all bytes to be consumed, and
   // return an error status if that is not the case.
   CHECKED_STATUS FullyDecodeFrom(const rocksdb::Slice& slice);
@@ -505,9 +509,12 @@ std::string BestEffortDocDBKeyToStr(const rocksdb::Slice &slice);
 // This filter policy only takes into account hashed components of keys for filtering.
 class DocDbAwareFilterPolicy : public rocksdb::FilterPolicy {
  public:
-  explicit DocDbAwareFilterPolicy(size_t filter_block_size_bits, rocksdb::Logger* logger) {
+  // lane_blocked: see rocksdb::NewFixedSizeFilterPolicy.
+  DocDbAwareFilterPolicy(
+      size_t filter_block_size_bits, rocksdb::Logger* logger, bool lane_blocked = false) {
     builtin_policy_.reset(rocksdb::NewFixedSizeFilterPolicy(
-        filter_block_size_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterErrorRate, logger));
+        filter_block_size_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterErrorRate, logger,
+        lane_blocked));
   }
 
   const char* Name() const override { return "DocKeyHashedComponentsFilter"; }
@@ -34,6 +34,7 @@
 DECLARE_uint64(rocksdb_max_file_size_for_compaction);
 DECLARE_int32(rocksdb_level0_slowdown_writes_trigger);
 DECLARE_int32(rocksdb_level0_stop_writes_trigger);
+DECLARE_bool(docdb_range_tombstones);
 
 using namespace std::literals; // NOLINT
 
@@ -210,8 +211,10 @@ SubDocKey(DocKey(0x0000, [1], []), [ColumnId(3); HT{ <max> w: 2 }]) -> 4
     QLRocksDBStorage ql_storage(rocksdb());
     QLResultSet resultset;
     HybridTime read_restart_ht;
+    auto projections = QLReadProjections::Create(schema, ql_read_req.column_refs());
+    EXPECT_OK(projections);
     EXPECT_OK(read_op.Execute(
-        ql_storage, ReadHybridTime::SingleTime(read_time), schema, query_schema, &resultset,
+        ql_storage, ReadHybridTime::SingleTime(read_time), schema, **projections, &resultset,
         &read_restart_ht));
     EXPECT_FALSE(read_restart_ht.is_valid());
 
@@ -632,6 +635,82 @@ TEST_F_EX(DocOperationTest, TestQLDescAscScan, DocOperationRangeFilterTest) {
   TestWithSortingType(ColumnSchema::kDescending, false);
 }
 
+TEST_F(DocOperationTest, TestQLRangeDelete) {
+  FLAGS_docdb_range_tombstones = true;
+  ASSERT_OK(DisableCompactions());
+
+  ColumnSchema hash_column("k", INT32, false, true);
+  ColumnSchema range_column("r", INT32, false, false, false, false, ColumnSchema::kAscending);
+  ColumnSchema value_column("v", INT32, false, false);
+  auto columns = { hash_column, range_column, value_column };
+  Schema schema(columns, CreateColumnIds(columns.size()), 2);
+
+  const auto t1 = HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(1000, 0);
+  const auto t2 = HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(2000, 0);
+  const auto t3 = HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(3000, 0);
+  constexpr int64_t kTtlMs = 1000000;
+  for (int32_t r = 1; r <= 10; ++r) {
+    WriteQLRow(QLWriteRequestPB_QLStmtType_QL_STMT_INSERT, schema, { 1, r, r * 10 }, kTtlMs, t1);
+  }
+  ASSERT_OK(FlushRocksDB());
+
+  // DELETE FROM t WHERE k = 1 AND r > 5, written as a single range tombstone.
+  QLWriteRequestPB delete_req;
+  QLResponsePB delete_resp;
+  delete_req.set_type(QLWriteRequestPB::QL_STMT_DELETE);
+  delete_req.set_hash_code(0);
+  AddPrimaryKeyColumn(&delete_req, 1);
+  auto* condition = delete_req.mutable_where_expr()->mutable_condition();
+  condition->set_op(QL_OP_GREATER_THAN);
+  condition->add_operands()->set_column_id(1_ColId);
+  condition->add_operands()->mutable_value()->set_int32_value(5);
+  WriteQL(&delete_req, schema, &delete_resp, t2);
+  ASSERT_OK(FlushRocksDB());
+
+  WriteQLRow(QLWriteRequestPB_QLStmtType_QL_STMT_INSERT, schema, { 1, 7, 77 }, kTtlMs, t3);
+
+  auto read_rows = [this, &schema](uint64_t read_time_micros, bool is_forward_scan) {
+    std::vector<PrimitiveValue> hashed_components = { PrimitiveValue::Int32(1) };
+    DocQLScanSpec ql_scan_spec(schema, -1, -1, hashed_components, /* condition = */ nullptr,
+                               rocksdb::kDefaultQueryId, is_forward_scan);
+    DocRowwiseIterator ql_iter(schema, schema, kNonTransactionalOperationContext, rocksdb(),
+                               ReadHybridTime::FromMicros(read_time_micros));
+    EXPECT_OK(ql_iter.Init(ql_scan_spec));
+    std::vector<RowData> result;
+    while (ql_iter.HasNext()) {
+      QLTableRow::SharedPtr value_map = std::make_shared<QLTableRow>();
+      EXPECT_OK(ql_iter.NextRow(schema, value_map));
+      result.push_back({ value_map->TestValue(0_ColId).value.int32_value(),
+                         value_map->TestValue(1_ColId).value.int32_value(),
+                         value_map->TestValue(2_ColId).value.int32_value() });
+    }
+    if (!is_forward_scan) {
+      std::reverse(result.begin(), result.end());
+    }
+    return result;
+  };
+
+  std::vector<RowData> all_rows;
+  for (int32_t r = 1; r <= 10; ++r) {
+    all_rows.push_back({ 1, r, r * 10 });
+  }
+  const std::vector<RowData> remaining_rows = {
+      { 1, 1, 10 }, { 1, 2, 20 }, { 1, 3, 30 }, { 1, 4, 40 }, { 1, 5, 50 }, { 1, 7, 77 } };
+
+  ASSERT_EQ(all_rows, read_rows(1500, true));
+  ASSERT_EQ(all_rows, read_rows(1500, false));
+  ASSERT_EQ(remaining_rows, read_rows(4000, true));
+  ASSERT_EQ(remaining_rows, read_rows(4000, false));
+
+  // The compaction removes the range tombstone together with the rows it covers.
+  CompactHistoryBefore(t3);
+  const auto dump = DocDBDebugDumpToStr();
+  ASSERT_EQ(std::string::npos, dump.find("SystemColumnId(1)")) << dump;
+  ASSERT_EQ(std::string::npos, dump.find("[6]")) << dump;
+  ASSERT_EQ(std::string::npos, dump.find("-> 70;")) << dump;
+  ASSERT_EQ(remaining_rows, read_rows(4000, true));
+}
+
 TEST_F(DocOperationTest, TestQLCompactions) {
   yb::QLWriteRequestPB ql_writereq_pb;
   yb::QLResponsePB ql_writeresp_pb;
@@ -23,12 +23,20 @@
 #include "yb/docdb/doc_expr.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/doc_ql_scanspec.h"
+#include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/packed_row.h"
+#include "yb/docdb/range_tombstone.h"
 #include "yb/docdb/subdocument.h"
 #include "yb/server/hybrid_clock.h"
+#include "yb/gutil/strings/numbers.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/util/bfql/directory.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/stol_utils.h"
 #include "yb/util/trace.h"
 
 DECLARE_bool(trace_docdb_calls);
+DECLARE_bool(docdb_range_tombstones);
 
 using strings::Substitute;
 using yb::bfql::TSOpcode;
@@ -40,6 +48,24 @@ DEFINE_bool(emulate_redis_responses,
     "and HDEL. If emulate_redis_responses is true, we read the required records to compute the "
     "response as specified by the official Redis API documentation. https://redis.io/commands");
 
+DEFINE_bool(docdb_pack_rows, false,
+            "Write a QL insert that sets every non-key column of a row to a scalar, without TTL, "
+            "user timestamp or transaction, as a single packed row record instead of one record "
+            "per column.");
+TAG_FLAG(docdb_pack_rows, advanced);
+
+DEFINE_bool(docdb_blind_counter_updates, false,
+            "Write a QL update that only increments or decrements counter columns by constants, "
+            "outside of a transaction, as counter deltas that are folded on read instead of "
+            "reading the current counter values.");
+TAG_FLAG(docdb_blind_counter_updates, advanced);
+
+DEFINE_bool(redis_tailing_time_series_reads, false,
+            "Read the Redis time series ranges that have no upper bound, i.e. the polls for the "
+            "newest points, with tailing iterators that are kept between the reads.");
+TAG_FLAG(redis_tailing_time_series_reads, advanced);
+TAG_FLAG(redis_tailing_time_series_reads, runtime);
+
 namespace yb {
 namespace docdb {
 
@@ -188,13 +214,16 @@ Result<RedisValue> GetRedisValue(
     const ReadHybridTime& read_time,
     const RedisKeyValuePB &key_value_pb,
     rocksdb::QueryId redis_query_id,
-    int subkey_index = -1) {
+    int subkey_index = -1,
+    DocRowCache* row_cache = nullptr) {
   if (!key_value_pb.has_key()) {
     return STATUS(Corruption, "Expected KeyValuePB");
   }
   SubDocKey doc_key(DocKey::FromRedisKey(key_value_pb.hash_code(), key_value_pb.key()));
 
+  // Only whole documents are cached.
   if (!key_value_pb.subkey().empty()) {
+    row_cache = nullptr;
     if (key_value_pb.subkey().size() != 1 && subkey_index == -1) {
       return STATUS_SUBSTITUTE(Corruption,
                                "Expected at most one subkey, got $0", key_value_pb.subkey().size());
@@ -209,11 +238,23 @@ Result<RedisValue> GetRedisValue(
   SubDocument doc;
   bool doc_found = false;
 
-  // TODO(dtxn) - pass correct transaction context when we implement cross-shard transactions
-  // support for Redis.
-  GetSubDocumentData data = { &doc_key, &doc, &doc_found };
-  RETURN_NOT_OK(GetSubDocument(
-      rocksdb, data, redis_query_id, boost::none /* txn_op_context */, read_time));
+  KeyBytes encoded_doc_key;
+  DocRowCache::Ticket ticket;
+  if (row_cache) {
+    encoded_doc_key = doc_key.doc_key().Encode();
+  }
+  if (!row_cache || !row_cache->Lookup(encoded_doc_key.AsSlice(), read_time.read, redis_query_id,
+                                       &doc, &doc_found, &ticket)) {
+    // TODO(dtxn) - pass correct transaction context when we implement cross-shard transactions
+    // support for Redis.
+    GetSubDocumentData data = { &doc_key, &doc, &doc_found };
+    RETURN_NOT_OK(GetSubDocument(
+        rocksdb, data, redis_query_id, boost::none /* txn_op_context */, read_time));
+    if (row_cache) {
+      row_cache->Insert(encoded_doc_key.AsSlice(), ticket, read_time.read, redis_query_id, doc,
+                        doc_found);
+    }
+  }
 
   if (!doc_found) {
     return RedisValue{REDIS_TYPE_NONE};
@@ -238,6 +279,50 @@ Result<RedisValue> GetRedisValue(
   return RedisValue{REDIS_TYPE_STRING, doc.GetString()};
 }
 
+// Returns the values of all the subkeys of key_value_pb in one pass over the document, seeking
+// only to the requested subkeys instead of reading the whole document or every subkey separately.
+Result<std::vector<RedisValue>> GetRedisSubKeyValues(
+    rocksdb::DB *rocksdb,
+    const ReadHybridTime& read_time,
+    const RedisKeyValuePB &key_value_pb,
+    rocksdb::QueryId redis_query_id) {
+  if (!key_value_pb.has_key()) {
+    return STATUS(Corruption, "Expected KeyValuePB");
+  }
+  SubDocKey doc_key(DocKey::FromRedisKey(key_value_pb.hash_code(), key_value_pb.key()));
+
+  std::vector<PrimitiveValue> subkeys(key_value_pb.subkey_size());
+  for (int i = 0; i < key_value_pb.subkey_size(); i++) {
+    RETURN_NOT_OK(PrimitiveValueFromSubKey(key_value_pb.subkey(i), &subkeys[i]));
+  }
+  // GetSubDocument seeks forward through the projection, so it has to be sorted.
+  std::vector<PrimitiveValue> projection(subkeys);
+  std::sort(projection.begin(), projection.end());
+  projection.erase(std::unique(projection.begin(), projection.end()), projection.end());
+
+  SubDocument doc;
+  bool doc_found = false;
+  auto iter = CreateIntentAwareIterator(
+      rocksdb, BloomFilterMode::USE_BLOOM_FILTER, doc_key.doc_key().Encode().AsSlice(),
+      redis_query_id, boost::none /* txn_op_context */, read_time);
+  GetSubDocumentData data = { &doc_key, &doc, &doc_found };
+  RETURN_NOT_OK(GetSubDocument(iter.get(), data, &projection, false /* is_iter_valid */));
+
+  std::vector<RedisValue> values;
+  values.reserve(subkeys.size());
+  for (const auto& subkey : subkeys) {
+    const SubDocument* value = doc_found ? doc.GetChild(subkey) : nullptr;
+    if (value == nullptr || value->value_type() == ValueType::kInvalidValueType) {
+      values.push_back(RedisValue{REDIS_TYPE_NONE});
+    } else if (!value->IsPrimitive()) {
+      values.push_back(RedisValue{REDIS_TYPE_HASH});
+    } else {
+      values.push_back(RedisValue{REDIS_TYPE_STRING, value->GetString()});
+    }
+  }
+  return values;
+}
+
 YB_STRONGLY_TYPED_BOOL(VerifySuccessIfMissing);
 
 // Set response based on the type match. Return whether the type matches what's expected.
@@ -394,6 +479,21 @@ CHECKED_STATUS GetCardinality(rocksdb::DB *rocksdb,
   return Status::OK();
 }
 
+// Reads the subdocument between the bounds of data, with a tailing iterator if tailing is set.
+CHECKED_STATUS GetSubDocumentRange(
+    rocksdb::DB* rocksdb,
+    const GetSubDocumentData& data,
+    rocksdb::QueryId query_id,
+    const ReadHybridTime& read_time,
+    bool tailing) {
+  if (!tailing) {
+    return GetSubDocument(rocksdb, data, query_id, boost::none /* txn_op_context */, read_time);
+  }
+  auto iter = CreateTailingIntentAwareIterator(
+      rocksdb, query_id, boost::none /* txn_op_context */, read_time);
+  return GetSubDocument(iter.get(), data, nullptr /* projection */, false /* is_iter_valid */);
+}
+
 template <typename AddResponseValues>
 CHECKED_STATUS GetAndPopulateResponseValues(
     rocksdb::DB* rocksdb,
@@ -406,15 +506,14 @@ CHECKED_STATUS GetAndPopulateResponseValues(
     const SubDocKeyBound& high_subkey,
     const RedisReadRequestPB& request,
     RedisResponsePB* response,
-    bool add_keys, bool add_values, bool reverse) {
+    bool add_keys, bool add_values, bool reverse, bool tailing = false) {
 
   SubDocument doc;
   bool doc_found = false;
   GetSubDocumentData data = { &doc_key, &doc, &doc_found };
   data.low_subkey = &low_subkey;
   data.high_subkey = &high_subkey;
-  RETURN_NOT_OK(GetSubDocument(
-  rocksdb, data, query_id, boost::none /* txn_op_context */, hybrid_time));
+  RETURN_NOT_OK(GetSubDocumentRange(rocksdb, data, query_id, hybrid_time, tailing));
 
   // Validate and populate response.
   response->set_allocated_array_response(new RedisArrayPB());
@@ -431,6 +530,308 @@ CHECKED_STATUS GetAndPopulateResponseValues(
   return Status::OK();
 }
 
+// Accumulates the points of one bucket of a time series aggregation.
+class TimeSeriesBucket {
+ public:
+  explicit TimeSeriesBucket(RedisTimeSeriesAggregationPB::AggregationType type) : type_(type) {}
+
+  bool empty() const { return count_ == 0; }
+  int64_t start() const { return start_; }
+
+  void Reset(int64_t start) {
+    start_ = start;
+    count_ = 0;
+    sum_ = 0;
+  }
+
+  // Returns false if the value is not a number, which only COUNT accepts.
+  bool Add(const std::string& value) {
+    if (type_ != RedisTimeSeriesAggregationPB::COUNT) {
+      auto number = util::CheckedStold(value);
+      if (!number.ok()) {
+        return false;
+      }
+      const double number_value = static_cast<double>(*number);
+      const bool is_extreme =
+          count_ == 0 ||
+          (type_ == RedisTimeSeriesAggregationPB::MIN && number_value < extreme_) ||
+          (type_ == RedisTimeSeriesAggregationPB::MAX && number_value > extreme_);
+      if (is_extreme) {
+        extreme_ = number_value;
+        extreme_value_ = value;
+      }
+      sum_ += number_value;
+    }
+    ++count_;
+    return true;
+  }
+
+  // Adds the start and the aggregated value of the bucket to the array.
+  void AppendTo(RedisArrayPB* array) const {
+    array->add_elements(std::to_string(start_));
+    switch (type_) {
+      case RedisTimeSeriesAggregationPB::MIN: FALLTHROUGH_INTENDED;
+      case RedisTimeSeriesAggregationPB::MAX:
+        array->add_elements(extreme_value_);
+        return;
+      case RedisTimeSeriesAggregationPB::AVG:
+        array->add_elements(SimpleDtoa(sum_ / count_));
+        return;
+      case RedisTimeSeriesAggregationPB::SUM:
+        array->add_elements(SimpleDtoa(sum_));
+        return;
+      case RedisTimeSeriesAggregationPB::COUNT:
+        array->add_elements(std::to_string(count_));
+        return;
+    }
+    LOG(FATAL) << "Unexpected aggregation type " << type_;
+  }
+
+ private:
+  const RedisTimeSeriesAggregationPB::AggregationType type_;
+  int64_t start_ = 0;
+  int64_t count_ = 0;
+  double sum_ = 0;
+  double extreme_ = 0;
+  // The MIN or MAX value as it was written.
+  std::string extreme_value_;
+};
+
+// Reads the points of a time series between the bounds and populates the response with one
+// aggregated point per non-empty bucket, so that only the downsampled points leave the tablet
+// server.
+CHECKED_STATUS GetAndAggregateTimeSeries(
+    rocksdb::DB* rocksdb,
+    rocksdb::QueryId query_id,
+    ReadHybridTime hybrid_time,
+    const SubDocKey& doc_key,
+    const SubDocKeyBound& low_subkey,
+    const SubDocKeyBound& high_subkey,
+    const RedisTimeSeriesAggregationPB& aggregation,
+    RedisResponsePB* response,
+    bool tailing) {
+  const int64_t bucket_size = aggregation.bucket_size();
+  if (bucket_size <= 0) {
+    return STATUS(InvalidArgument, "Aggregation bucket size must be positive");
+  }
+
+  SubDocument doc;
+  bool doc_found = false;
+  GetSubDocumentData data = { &doc_key, &doc, &doc_found };
+  data.low_subkey = &low_subkey;
+  data.high_subkey = &high_subkey;
+  RETURN_NOT_OK(GetSubDocumentRange(rocksdb, data, query_id, hybrid_time, tailing));
+
+  response->set_allocated_array_response(new RedisArrayPB());
+  if (!doc_found) {
+    response->set_code(RedisResponsePB_RedisStatusCode_OK);
+    return Status::OK();
+  }
+  if (!VerifyTypeAndSetCode(ValueType::kRedisTS, doc.value_type(), response)) {
+    return Status::OK();
+  }
+
+  TimeSeriesBucket bucket(aggregation.type());
+  auto* array = response->mutable_array_response();
+  // The timestamps are stored in descending order.
+  const auto& points = doc.object_container();
+  for (auto it = points.rbegin(); it != points.rend(); ++it) {
+    const int64_t timestamp = it->first.GetInt64();
+    int64_t offset = timestamp % bucket_size;
+    if (offset < 0) {
+      offset += bucket_size;
+    }
+    const int64_t bucket_start = timestamp - offset;
+    if (!bucket.empty() && bucket.start() != bucket_start) {
+      bucket.AppendTo(array);
+    }
+    if (bucket.empty() || bucket.start() != bucket_start) {
+      bucket.Reset(bucket_start);
+    }
+    if (!bucket.Add(it->second.GetString())) {
+      response->clear_array_response();
+      response->set_code(RedisResponsePB_RedisStatusCode_WRONG_TYPE);
+      return Status::OK();
+    }
+  }
+  if (!bucket.empty()) {
+    bucket.AppendTo(array);
+  }
+  return Status::OK();
+}
+
+// Iterates over the members of a Redis sorted set in the order of their scores, or in the reverse
+// order, reading only the records of the members it visits. Deleted and expired members, and the
+// members written before the sorted set was last overwritten as a whole, are skipped.
+class SortedSetIterator {
+ public:
+  SortedSetIterator(rocksdb::DB* rocksdb,
+                    rocksdb::QueryId query_id,
+                    const ReadHybridTime& read_time,
+                    const RedisKeyValuePB& kv,
+                    bool reverse)
+      : read_time_(read_time),
+        reverse_(reverse),
+        encoded_doc_key_(DocKey::FromRedisKey(kv.hash_code(), kv.key()).Encode()),
+        iter_(CreateIntentAwareIterator(
+            rocksdb, BloomFilterMode::USE_BLOOM_FILTER, encoded_doc_key_.AsSlice(), query_id,
+            boost::none /* txn_op_context */, read_time)) {}
+
+  // Positions the iterator at the first member.
+  CHECKED_STATUS Init() {
+    RETURN_NOT_OK(iter_->FindLastWriteTime(
+        encoded_doc_key_, &overwrite_ht_, nullptr /* result_value */));
+    forward_prefix_ = encoded_doc_key_;
+    PrimitiveValue(ValueType::kSSForward).AppendToKey(&forward_prefix_);
+    iter_->PushPrefix(forward_prefix_.AsSlice());
+    if (reverse_) {
+      KeyBytes forward_end = forward_prefix_;
+      forward_end.AppendValueType(ValueType::kMaxByte);
+      iter_->PrevSubDocKey(forward_end);
+    } else {
+      iter_->SeekWithoutHt(forward_prefix_.AsSlice());
+    }
+    return SkipInvisible();
+  }
+
+  CHECKED_STATUS Next() {
+    DCHECK(valid_);
+    Advance();
+    return SkipInvisible();
+  }
+
+  bool valid() const { return valid_; }
+
+  // The forward mapping of a sorted set is kSSForward -> score -> member.
+  const PrimitiveValue& score() const { return sub_doc_key_.subkeys()[1]; }
+  const PrimitiveValue& member() const { return sub_doc_key_.subkeys()[2]; }
+
+ private:
+  void Advance() {
+    if (reverse_) {
+      iter_->PrevSubDocKey(sub_doc_key_.Encode(false /* include_hybrid_time */));
+    } else {
+      iter_->SeekPastSubKey(sub_doc_key_);
+    }
+  }
+
+  CHECKED_STATUS SkipInvisible() {
+    for (; iter_->valid(); Advance()) {
+      auto key = iter_->FetchKey();
+      RETURN_NOT_OK(key);
+      RETURN_NOT_OK(sub_doc_key_.FullyDecodeFrom(*key));
+      if (sub_doc_key_.num_subkeys() != 3 || sub_doc_key_.doc_hybrid_time() <= overwrite_ht_) {
+        continue;
+      }
+      Value value;
+      RETURN_NOT_OK(value.Decode(iter_->value()));
+      bool has_expired = false;
+      RETURN_NOT_OK(HasExpiredTTL(
+          sub_doc_key_.hybrid_time(), value.ttl(), read_time_.read, &has_expired));
+      if (value.value_type() != ValueType::kTombstone && !has_expired) {
+        valid_ = true;
+        return Status::OK();
+      }
+    }
+    valid_ = false;
+    return Status::OK();
+  }
+
+  const ReadHybridTime read_time_;
+  const bool reverse_;
+  const KeyBytes encoded_doc_key_;
+  std::unique_ptr<IntentAwareIterator> iter_;
+  DocHybridTime overwrite_ht_ = DocHybridTime::kMin;
+  // Referenced by the prefix of iter_.
+  KeyBytes forward_prefix_;
+  SubDocKey sub_doc_key_;
+  bool valid_ = false;
+};
+
+// Redis glob-style pattern matching, as stringmatchlen in redis/src/util.c. Supports '*', '?',
+// character classes like [a-z] or [^a], and '\' to escape the special characters.
+bool RedisPatternMatch(const uint8_t* pattern, const uint8_t* pattern_end,
+                       const uint8_t* str, const uint8_t* str_end) {
+  while (pattern != pattern_end) {
+    switch (*pattern) {
+      case '*': {
+        while (pattern + 1 != pattern_end && pattern[1] == '*') {
+          ++pattern;
+        }
+        if (pattern + 1 == pattern_end) {
+          return true;
+        }
+        for (;; ++str) {
+          if (RedisPatternMatch(pattern + 1, pattern_end, str, str_end)) {
+            return true;
+          }
+          if (str == str_end) {
+            return false;
+          }
+        }
+      }
+      case '?':
+        if (str == str_end) {
+          return false;
+        }
+        ++str;
+        break;
+      case '[': {
+        if (str == str_end) {
+          return false;
+        }
+        ++pattern;
+        const bool negate = pattern != pattern_end && *pattern == '^';
+        if (negate) {
+          ++pattern;
+        }
+        bool match = false;
+        for (; pattern != pattern_end && *pattern != ']'; ++pattern) {
+          if (*pattern == '\\' && pattern + 1 != pattern_end) {
+            ++pattern;
+            match = match || *pattern == *str;
+          } else if (pattern_end - pattern >= 3 && pattern[1] == '-') {
+            auto range = std::minmax(pattern[0], pattern[2]);
+            match = match || (*str >= range.first && *str <= range.second);
+            pattern += 2;
+          } else {
+            match = match || *pattern == *str;
+          }
+        }
+        if (match == negate) {
+          return false;
+        }
+        ++str;
+        if (pattern == pattern_end) {
+          // An unterminated class ends the pattern.
+          return str == str_end;
+        }
+        break;
+      }
+      case '\\':
+        if (pattern + 1 != pattern_end) {
+          ++pattern;
+        }
+        FALLTHROUGH_INTENDED;
+      default:
+        if (str == str_end || *pattern != *str) {
+          return false;
+        }
+        ++str;
+        break;
+    }
+    ++pattern;
+  }
+  return str == str_end;
+}
+
+bool RedisPatternMatch(const std::string& pattern, const std::string& str) {
+  auto pattern_data = reinterpret_cast<const uint8_t*>(pattern.data());
+  auto str_data = reinterpret_cast<const uint8_t*>(str.data());
+  return RedisPatternMatch(pattern_data, pattern_data + pattern.size(),
+                           str_data, str_data + str.size());
+}
+
 } // anonymous namespace
 
 Status RedisWriteOperation::Apply(const DocOperationApplyData& data) {
@@ -936,6 +1337,8 @@ Status RedisReadOperation::Execute() {
       return ExecuteGetRange();
     case RedisReadRequestPB::RequestCase::kGetCollectionRangeRequest:
       return ExecuteCollectionGetRange();
+    case RedisReadRequestPB::RequestCase::kScanRequest:
+      return ExecuteScan();
     default:
       return STATUS(Corruption,
           Substitute("Unsupported redis write operation: $0", request_.request_case()));
@@ -1007,12 +1410,25 @@ Status RedisReadOperation::ExecuteHGetAllLikeCommands(ValueType value_type,
 
 Status RedisReadOperation::ExecuteCollectionGetRange() {
   const RedisKeyValuePB& key_value = request_.key_value();
-  if (!request_.has_key_value() || !key_value.has_key() || !request_.has_subkey_range() ||
-      !request_.subkey_range().has_lower_bound() || !request_.subkey_range().has_upper_bound()) {
-    return STATUS(InvalidArgument, "Need to specify the key and the subkey range");
+  if (!request_.has_key_value() || !key_value.has_key()) {
+    return STATUS(InvalidArgument, "Need to specify the key");
   }
 
   const auto request_type = request_.get_collection_range_request().request_type();
+  switch (request_type) {
+    case RedisCollectionGetRangeRequestPB_GetRangeRequestType_ZRANGE:
+      return ExecuteSortedSetRangeByRank(/* reverse */ false);
+    case RedisCollectionGetRangeRequestPB_GetRangeRequestType_ZREVRANGE:
+      return ExecuteSortedSetRangeByRank(/* reverse */ true);
+    default:
+      break;
+  }
+
+  if (!request_.has_subkey_range() || !request_.subkey_range().has_lower_bound() ||
+      !request_.subkey_range().has_upper_bound()) {
+    return STATUS(InvalidArgument, "Need to specify the subkey range");
+  }
+
   switch (request_type) {
     case RedisCollectionGetRangeRequestPB_GetRangeRequestType_ZRANGEBYSCORE: FALLTHROUGH_INTENDED;
     case RedisCollectionGetRangeRequestPB_GetRangeRequestType_TSRANGEBYTIME: {
@@ -1079,19 +1495,135 @@ Status RedisReadOperation::ExecuteCollectionGetRange() {
                                                                        SortOrder::kDescending)),
                                               lower_bound.is_exclusive(), /* is_lower_bound */
                                               false);
+        // The newest points are stored first, so a range without an upper bound is read forward
+        // from the start of the time series, as a tailing iterator can.
+        const bool tailing = FLAGS_redis_tailing_time_series_reads &&
+                             upper_bound.has_infinity_type();
+        if (request_.get_collection_range_request().has_aggregation()) {
+          RETURN_NOT_OK(GetAndAggregateTimeSeries(
+              db_, redis_query_id(), read_time_, doc_key, low_subkey, high_subkey,
+              request_.get_collection_range_request().aggregation(), &response_, tailing));
+          break;
+        }
         RETURN_NOT_OK(GetAndPopulateResponseValues(
             db_, redis_query_id(), read_time_, AddResponseValuesGeneric, doc_key,
             ValueType::kRedisTS,  low_subkey, high_subkey, request_, &response_,
-            /* add_keys */ true, /* add_values */ true, /* reverse */ true));
+            /* add_keys */ true, /* add_values */ true, /* reverse */ true, tailing));
       }
       break;
     }
+    case RedisCollectionGetRangeRequestPB_GetRangeRequestType_ZRANGE: FALLTHROUGH_INTENDED;
+    case RedisCollectionGetRangeRequestPB_GetRangeRequestType_ZREVRANGE: FALLTHROUGH_INTENDED;
     case RedisCollectionGetRangeRequestPB_GetRangeRequestType_UNKNOWN:
       return STATUS(InvalidCommand, "Unknown Collection Get Range Request not supported");
   }
   return Status::OK();
 }
 
+Status RedisReadOperation::ExecuteSortedSetRangeByRank(bool reverse) {
+  auto type = GetValueType();
+  RETURN_NOT_OK(type);
+  response_.set_allocated_array_response(new RedisArrayPB());
+  if (!VerifyTypeAndSetCode(RedisDataType::REDIS_TYPE_SORTEDSET, *type, &response_,
+                            VerifySuccessIfMissing::kTrue) ||
+      *type == RedisDataType::REDIS_TYPE_NONE) {
+    return Status::OK();
+  }
+
+  int64_t card;
+  RETURN_NOT_OK(GetCardinality(db_, redis_query_id(), read_time_, request_.key_value(), &card));
+  const auto& range_request = request_.get_collection_range_request();
+  int64_t start = range_request.start();
+  int64_t stop = range_request.stop();
+  if (start < 0) start += card;
+  if (stop < 0) stop += card;
+  start = std::max<int64_t>(start, 0);
+  stop = std::min(stop, card - 1);
+  if (start > stop) {
+    return Status::OK();
+  }
+
+  // Since the cardinality is known, iterate from the end of the sorted set that is closer to the
+  // range, so that the top members are read without reading the whole set.
+  const bool from_end = card - 1 - stop < start;
+  const int64_t first = from_end ? card - 1 - stop : start;
+  const int64_t last = from_end ? card - 1 - start : stop;
+  SortedSetIterator iter(db_, redis_query_id(), read_time_, request_.key_value(),
+                         reverse != from_end);
+  RETURN_NOT_OK(iter.Init());
+  std::vector<std::pair<PrimitiveValue, PrimitiveValue>> entries;
+  entries.reserve(last - first + 1);
+  for (int64_t rank = 0; iter.valid() && rank <= last; ++rank) {
+    if (rank >= first) {
+      entries.emplace_back(iter.score(), iter.member());
+    }
+    RETURN_NOT_OK(iter.Next());
+  }
+  if (from_end) {
+    std::reverse(entries.begin(), entries.end());
+  }
+
+  for (const auto& entry : entries) {
+    RETURN_NOT_OK(AddResponseValuesGeneric(entry.first, entry.second, &response_,
+                                           /* add_keys */ range_request.with_scores(),
+                                           /* add_values */ true));
+  }
+  return Status::OK();
+}
+
+Status RedisReadOperation::ExecuteSortedSetRank() {
+  const RedisKeyValuePB& kv = request_.key_value();
+  if (kv.subkey_size() != 1) {
+    return STATUS(InvalidArgument, "Need to specify a single member");
+  }
+  auto type = GetValueType();
+  RETURN_NOT_OK(type);
+  if (!VerifyTypeAndSetCode(RedisDataType::REDIS_TYPE_SORTEDSET, *type, &response_)) {
+    return Status::OK();
+  }
+
+  const PrimitiveValue member(kv.subkey(0).string_subkey());
+  SubDocKey key_reverse(DocKey::FromRedisKey(kv.hash_code(), kv.key()),
+                        PrimitiveValue(ValueType::kSSReverse), member);
+  SubDocument subdoc_reverse;
+  bool subdoc_reverse_found = false;
+  GetSubDocumentData data = { &key_reverse, &subdoc_reverse, &subdoc_reverse_found };
+  RETURN_NOT_OK(GetSubDocument(
+      db_, data, redis_query_id(), boost::none /* txn_op_context */, read_time_));
+  if (!subdoc_reverse_found) {
+    response_.set_code(RedisResponsePB_RedisStatusCode_NOT_FOUND);
+    return Status::OK();
+  }
+
+  // Look for the member from both ends of the sorted set at once, so that only about twice the
+  // distance of the member to the closer end is read. Its rank from the end is converted using the
+  // cardinality.
+  int64_t card;
+  RETURN_NOT_OK(GetCardinality(db_, redis_query_id(), read_time_, kv, &card));
+  SortedSetIterator forward(db_, redis_query_id(), read_time_, kv, /* reverse */ false);
+  SortedSetIterator backward(db_, redis_query_id(), read_time_, kv, /* reverse */ true);
+  RETURN_NOT_OK(forward.Init());
+  RETURN_NOT_OK(backward.Init());
+  for (int64_t distance = 0; forward.valid() || backward.valid(); ++distance) {
+    if (forward.valid()) {
+      if (forward.member() == member) {
+        response_.set_int_response(distance);
+        return Status::OK();
+      }
+      RETURN_NOT_OK(forward.Next());
+    }
+    if (backward.valid()) {
+      if (backward.member() == member) {
+        response_.set_int_response(card - 1 - distance);
+        return Status::OK();
+      }
+      RETURN_NOT_OK(backward.Next());
+    }
+  }
+  return STATUS_FORMAT(Corruption, "Member $0 of sorted set $1 has no score entry",
+                       member, kv.key());
+}
+
 Result<RedisDataType> RedisReadOperation::GetValueType(int subkey_index) {
   return GetRedisValueType(db_, read_time_, request_.key_value(), redis_query_id(),
                            nullptr /* doc_write_batch */, subkey_index);
@@ -1099,7 +1631,8 @@ Result<RedisDataType> RedisReadOperation::GetValueType(int subkey_index) {
 }
 
 Result<RedisValue> RedisReadOperation::GetValue(int subkey_index) {
-  return GetRedisValue(db_, read_time_, request_.key_value(), redis_query_id(), subkey_index);
+  return GetRedisValue(db_, read_time_, request_.key_value(), redis_query_id(), subkey_index,
+                       row_cache_);
 }
 
 Status RedisReadOperation::ExecuteGet() {
@@ -1154,13 +1687,12 @@ Status RedisReadOperation::ExecuteGet() {
       }
 
       response_.set_allocated_array_response(new RedisArrayPB());
-      for (int i = 0; i < request_.key_value().subkey_size(); i++) {
-        // TODO: ENG-1803: It is inefficient to create a new iterator for each subkey causing a
-        // new seek. Consider reusing the same iterator.
-        auto value = GetValue(i);
-        RETURN_NOT_OK(value);
-        if (value->type == REDIS_TYPE_STRING) {
-          response_.mutable_array_response()->add_elements(value->value);
+      auto values = GetRedisSubKeyValues(
+          db_, read_time_, request_.key_value(), redis_query_id());
+      RETURN_NOT_OK(values);
+      for (const auto& value : *values) {
+        if (value.type == REDIS_TYPE_STRING) {
+          response_.mutable_array_response()->add_elements(value.value);
         } else {
           response_.mutable_array_response()->add_elements(""); // Empty is nil response.
         }
@@ -1182,6 +1714,8 @@ Status RedisReadOperation::ExecuteGet() {
       return ExecuteHGetAllLikeCommands(ValueType::kRedisSet, false, false);
     case RedisGetRequestPB_GetRequestType_ZCARD:
       return ExecuteHGetAllLikeCommands(ValueType::kRedisSortedSet, false, false);
+    case RedisGetRequestPB_GetRequestType_ZRANK:
+      return ExecuteSortedSetRank();
     case RedisGetRequestPB_GetRequestType_UNKNOWN: {
       return STATUS(InvalidCommand, "Unknown Get Request not supported");
     }
@@ -1239,6 +1773,67 @@ Status RedisReadOperation::ExecuteGetRange() {
   return Status::OK();
 }
 
+Status RedisReadOperation::ExecuteScan() {
+  const auto& scan_request = request_.scan_request();
+  if (scan_request.count() <= 0) {
+    return STATUS(InvalidArgument, "Scan count must be positive");
+  }
+
+  const auto& key_value = request_.key_value();
+  KeyBytes seek_key;
+  if (key_value.has_key()) {
+    // Resume after the document of the last key examined by the previous scan.
+    seek_key = DocKey::FromRedisKey(key_value.hash_code(), key_value.key()).Encode();
+    seek_key.AppendValueType(ValueType::kMaxByte);
+  } else {
+    seek_key.AppendValueType(ValueType::kUInt16Hash);
+    seek_key.AppendUInt16(key_value.hash_code());
+  }
+
+  // Only the document keys are looked at here, whether a key exists at the read time is checked
+  // for each of them separately.
+  auto iter = CreateRocksDBIterator(db_, BloomFilterMode::DONT_USE_BLOOM_FILTER,
+                                    boost::none /* user_key_for_filter */, redis_query_id());
+  response_.set_allocated_array_response(new RedisArrayPB());
+  response_.set_code(RedisResponsePB_RedisStatusCode_OK);
+  RedisKeyValuePB examined_key;
+  for (int32_t num_examined = 0;; ++num_examined) {
+    iter->Seek(seek_key.AsSlice());
+    if (!iter->Valid() || iter->key().empty() ||
+        iter->key()[0] != static_cast<uint8_t>(ValueType::kUInt16Hash)) {
+      // All keys of the tablet have been examined.
+      return Status::OK();
+    }
+
+    if (num_examined == scan_request.count()) {
+      response_.mutable_scan_resume_key()->Swap(&examined_key);
+      return Status::OK();
+    }
+
+    DocKey doc_key;
+    rocksdb::Slice encoded_key = iter->key();
+    RETURN_NOT_OK(doc_key.DecodeFrom(&encoded_key));
+    if (doc_key.hashed_group().size() != 1 ||
+        doc_key.hashed_group()[0].value_type() != ValueType::kString) {
+      return STATUS_FORMAT(Corruption, "Unexpected redis document key: $0", doc_key);
+    }
+    examined_key.set_hash_code(doc_key.hash());
+    examined_key.set_key(doc_key.hashed_group()[0].GetString());
+
+    if (!scan_request.has_pattern() ||
+        RedisPatternMatch(scan_request.pattern(), examined_key.key())) {
+      auto type = GetRedisValueType(db_, read_time_, examined_key, redis_query_id());
+      RETURN_NOT_OK(type);
+      if (*type != REDIS_TYPE_NONE) {
+        response_.mutable_array_response()->add_elements(examined_key.key());
+      }
+    }
+
+    seek_key = doc_key.Encode();
+    seek_key.AppendValueType(ValueType::kMaxByte);
+  }
+}
+
 const RedisResponsePB& RedisReadOperation::response() {
   return response_;
 }
@@ -1278,40 +1873,107 @@ bool RequireRead(const QLWriteRequestPB& request, const Schema& schema) {
   return RequireReadForExpressions(request) || has_user_timestamp || is_range_operation;
 }
 
-// Create projection schemas of static and non-static columns from a rowblock projection schema
-// (for read) and a WHERE / IF condition (for read / write). "schema" is the full table schema
-// and "rowblock_schema" is the selected columns from which we are splitting into static and
-// non-static column portions.
-CHECKED_STATUS CreateProjections(const Schema& schema, const QLReferencedColumnsPB& column_refs,
-                                 Schema* static_projection, Schema* non_static_projection) {
-  // The projection schemas are used to scan docdb. Keep the columns to fetch in sorted order for
-  // more efficient scan in the iterator.
-  set<ColumnId> static_columns, non_static_columns;
+// Returns true and sets delta if the column value increments or decrements its own counter column
+// by a constant, e.g. "c = c + 1".
+bool GetCounterDelta(const QLColumnValuePB& column_value, int64_t* delta) {
+  if (!column_value.subscript_args().empty() || !column_value.expr().has_bfcall()) {
+    return false;
+  }
+  const auto& bfcall = column_value.expr().bfcall();
+  if (bfcall.opcode() < 0 || static_cast<size_t>(bfcall.opcode()) >= bfql::kBFDirectory.size() ||
+      bfcall.operands_size() != 2) {
+    return false;
+  }
+  const std::string cpp_name = bfql::kBFDirectory[bfcall.opcode()].cpp_name();
+  const bool increment = cpp_name == "IncCounter";
+  if (!increment && cpp_name != "DecCounter") {
+    return false;
+  }
+  const auto& column = bfcall.operands(0);
+  const auto& value = bfcall.operands(1);
+  if (!column.has_column_id() || column.column_id() != column_value.column_id() ||
+      !value.has_value() || value.value().value_case() != QLValuePB::kInt64Value) {
+    return false;
+  }
+  *delta = increment ? value.value().int64_value() : -value.value().int64_value();
+  return true;
+}
 
-  // Add regular columns.
-  for (int32_t id : column_refs.ids()) {
-    const ColumnId column_id(id);
-    if (!schema.is_key_column(column_id)) {
-      non_static_columns.insert(column_id);
+// Narrows the bounds of a range tombstone, see RangeTombstone, by a condition of a range delete.
+// Returns false unless the condition is a conjunction of comparisons of the first range column with
+// values, at most one for each side of the range.
+bool NarrowRangeTombstoneBounds(const QLConditionPB& condition, const Schema& schema,
+                                bool* has_lower, std::string* lower,
+                                bool* has_upper, std::string* upper) {
+  const auto& operands = condition.operands();
+  if (condition.op() == QL_OP_AND) {
+    for (const auto& operand : operands) {
+      if (!operand.has_condition() ||
+          !NarrowRangeTombstoneBounds(operand.condition(), schema, has_lower, lower, has_upper,
+                                      upper)) {
+        return false;
+      }
     }
+    return true;
   }
-
-  // Add static columns.
-  for (int32_t id : column_refs.static_ids()) {
-    const ColumnId column_id(id);
-    static_columns.insert(column_id);
+  const auto& column = schema.column(schema.num_hash_key_columns());
+  if (operands.size() != 2 || !operands.Get(0).has_column_id() ||
+      operands.Get(0).column_id() != schema.column_id(schema.num_hash_key_columns()) ||
+      !operands.Get(1).has_value() || IsNull(operands.Get(1).value())) {
+    return false;
   }
-
-  RETURN_NOT_OK(
-      schema.CreateProjectionByIdsIgnoreMissing(
-          vector<ColumnId>(static_columns.begin(), static_columns.end()),
-          static_projection));
-  RETURN_NOT_OK(
-      schema.CreateProjectionByIdsIgnoreMissing(
-          vector<ColumnId>(non_static_columns.begin(), non_static_columns.end()),
-          non_static_projection));
-
-  return Status::OK();
+  const bool descending = column.sorting_type() == ColumnSchema::SortingType::kDescending;
+  const PrimitiveValue value =
+      PrimitiveValue::FromQLValuePB(operands.Get(1).value(), column.sorting_type());
+  // The range groups of the rows with the first range column equal to the value are at or after
+  // [value] and before [value, +inf].
+  const std::string before_value = EncodeRangeGroup({value});
+  const std::string after_value =
+      EncodeRangeGroup({value, PrimitiveValue(ValueType::kHighest)});
+  bool sets_lower = false, sets_upper = false;
+  std::string new_lower, new_upper;
+  switch (condition.op()) {
+    case QL_OP_EQUAL:
+      sets_lower = sets_upper = true;
+      new_lower = before_value;
+      new_upper = after_value;
+      break;
+    case QL_OP_GREATER_THAN_EQUAL:
+    case QL_OP_LESS_THAN:
+      // The encoded order of a descending column is the reverse of the order of its values.
+      if ((condition.op() == QL_OP_GREATER_THAN_EQUAL) != descending) {
+        sets_lower = true;
+        new_lower = before_value;
+      } else {
+        sets_upper = true;
+        new_upper = before_value;
+      }
+      break;
+    case QL_OP_GREATER_THAN:
+    case QL_OP_LESS_THAN_EQUAL:
+      if ((condition.op() == QL_OP_GREATER_THAN) != descending) {
+        sets_lower = true;
+        new_lower = after_value;
+      } else {
+        sets_upper = true;
+        new_upper = after_value;
+      }
+      break;
+    default:
+      return false;
+  }
+  if ((sets_lower && *has_lower) || (sets_upper && *has_upper)) {
+    return false;
+  }
+  if (sets_lower) {
+    *has_lower = true;
+    *lower = std::move(new_lower);
+  }
+  if (sets_upper) {
+    *has_upper = true;
+    *upper = std::move(new_upper);
+  }
+  return true;
 }
 
 CHECKED_STATUS PopulateRow(const QLTableRow::SharedPtr& table_row,
@@ -1352,9 +2014,11 @@ void JoinStaticRow(
 
 Status QLWriteOperation::Init(QLWriteRequestPB* request, QLResponsePB* response) {
   response_ = response;
-  require_read_ = RequireRead(*request, schema_);
-
   request_.Swap(request);
+  blind_counter_update_ = IsBlindCounterUpdate();
+  range_tombstone_ = IsRangeTombstoneDelete();
+  require_read_ = RequireRead(request_, schema_) && !blind_counter_update_ && !range_tombstone_;
+
   // Determine if static / non-static columns are being written.
   bool write_static_columns = false;
   bool write_non_static_columns = false;
@@ -1382,6 +2046,56 @@ Status QLWriteOperation::Init(QLWriteRequestPB* request, QLResponsePB* response)
           schema_.num_range_key_columns() == 0);
 }
 
+bool QLWriteOperation::IsBlindCounterUpdate() const {
+  if (!FLAGS_docdb_blind_counter_updates || request_.type() != QLWriteRequestPB::QL_STMT_UPDATE ||
+      request_.has_if_expr() || request_.has_ttl() || request_.has_user_timestamp_usec() ||
+      txn_op_context_ || request_.column_values().empty() ||
+      IsRangeOperation(request_, schema_)) {
+    return false;
+  }
+  std::set<int32_t> counter_ids;
+  for (const auto& column_value : request_.column_values()) {
+    int64_t delta = 0;
+    if (!GetCounterDelta(column_value, &delta)) {
+      return false;
+    }
+    counter_ids.insert(column_value.column_id());
+  }
+  // The counters themselves are the only columns the update may reference.
+  for (const auto id : request_.column_refs().ids()) {
+    if (counter_ids.count(id) == 0) {
+      return false;
+    }
+  }
+  for (const auto id : request_.column_refs().static_ids()) {
+    if (counter_ids.count(id) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool QLWriteOperation::IsRangeTombstoneDelete() {
+  if (!FLAGS_docdb_range_tombstones || request_.type() != QLWriteRequestPB::QL_STMT_DELETE ||
+      request_.has_if_expr() || request_.has_user_timestamp_usec() || txn_op_context_ ||
+      schema_.num_hash_key_columns() == 0 || !request_.has_hash_code() ||
+      !IsRangeOperation(request_, schema_)) {
+    return false;
+  }
+  range_tombstone_lower_.clear();
+  range_tombstone_upper_.clear();
+  if (!request_.has_where_expr()) {
+    return true;
+  }
+  if (!request_.where_expr().has_condition()) {
+    return false;
+  }
+  bool has_lower = false, has_upper = false;
+  return NarrowRangeTombstoneBounds(request_.where_expr().condition(), schema_,
+                                    &has_lower, &range_tombstone_lower_,
+                                    &has_upper, &range_tombstone_upper_);
+}
+
 Status QLWriteOperation::InitializeKeys(const bool hashed_key, const bool primary_key) {
   // Populate the hashed and range components in the same order as they are in the table schema.
   const auto& hashed_column_values = request_.hashed_column_values();
@@ -1518,6 +2232,56 @@ Status QLWriteOperation::IsConditionSatisfied(const QLConditionPB& condition,
   return Status::OK();
 }
 
+Status QLWriteOperation::ApplyPackedRow(const DocOperationApplyData& data,
+                                        const QLTableRow::SharedPtr& table_row,
+                                        MonoDelta ttl,
+                                        UserTimeMicros user_timestamp,
+                                        bool* packed) {
+  *packed = false;
+  if (pk_doc_path_ == nullptr || txn_op_context_ || schema_.has_statics() ||
+      !ttl.Equals(Value::kMaxTtl) || user_timestamp != Value::kInvalidUserTimestamp ||
+      static_cast<size_t>(request_.column_values_size()) !=
+          schema_.num_columns() - schema_.num_key_columns()) {
+    return Status::OK();
+  }
+
+  PackedColumns columns;
+  columns.reserve(request_.column_values_size() + 1);
+  columns.emplace_back(PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn),
+                       PrimitiveValue());
+  for (const auto& column_value : request_.column_values()) {
+    if (!column_value.has_column_id() || !column_value.subscript_args().empty() ||
+        GetTSWriteInstruction(column_value.expr()) != TSOpcode::kScalarInsert) {
+      return Status::OK();
+    }
+    const ColumnId column_id(column_value.column_id());
+    const auto maybe_column = schema_.column_by_id(column_id);
+    RETURN_NOT_OK(maybe_column);
+    QLValue expr_result;
+    RETURN_NOT_OK(EvalExpr(column_value.expr(), table_row, &expr_result));
+    SubDocument sub_doc = SubDocument::FromQLValuePB(
+        expr_result.value(), maybe_column->sorting_type(), TSOpcode::kScalarInsert);
+    if (!sub_doc.IsTombstoneOrPrimitive()) {
+      return Status::OK();
+    }
+    columns.emplace_back(PrimitiveValue(column_id), std::move(sub_doc));
+  }
+  std::sort(columns.begin(), columns.end(),
+            [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+  // Every non-key column should be set exactly once.
+  for (size_t i = 1; i < columns.size(); ++i) {
+    if (columns[i - 1].first == columns[i].first) {
+      return Status::OK();
+    }
+  }
+
+  *packed = true;
+  return data.doc_write_batch->SetPrimitive(
+      DocPath(pk_doc_path_->encoded_doc_key()),
+      Value(PrimitiveValue::PackedRow(EncodePackedRow(columns))),
+      request_.query_id());
+}
+
 Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
   bool should_apply = true;
   QLTableRow::SharedPtr table_row = make_shared<QLTableRow>();
@@ -1527,7 +2291,7 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
                                        &should_apply,
                                        &rowblock_,
                                        table_row));
-  } else if (RequireReadForExpressions(request_)) {
+  } else if (RequireReadForExpressions(request_) && !blind_counter_update_) {
     RETURN_NOT_OK(ReadColumns(data, nullptr, nullptr, table_row));
   }
 
@@ -1544,6 +2308,14 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
       // primary key at least.
       case QLWriteRequestPB::QL_STMT_INSERT:
       case QLWriteRequestPB::QL_STMT_UPDATE: {
+        if (FLAGS_docdb_pack_rows && request_.type() == QLWriteRequestPB::QL_STMT_INSERT) {
+          bool packed = false;
+          RETURN_NOT_OK(ApplyPackedRow(data, table_row, ttl, user_timestamp, &packed));
+          if (packed) {
+            break;
+          }
+        }
+
         // Add the appropriate liveness column only for inserts.
         // We never use init markers for QL to ensure we perform writes without any reads to
         // ensure our write path is fast while complicating the read path a bit.
@@ -1573,6 +2345,13 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
                                               : pk_doc_path_->encoded_doc_key(),
                            PrimitiveValue(column_id));
 
+          int64_t delta = 0;
+          if (blind_counter_update_ && GetCounterDelta(column_value, &delta)) {
+            RETURN_NOT_OK(data.doc_write_batch->SetPrimitive(
+                sub_path, Value(PrimitiveValue::CounterDelta(delta)), request_.query_id()));
+            continue;
+          }
+
           QLValue expr_result;
           RETURN_NOT_OK(EvalExpr(column_value.expr(), table_row, &expr_result));
           const TSOpcode write_instr = GetTSWriteInstruction(column_value.expr());
@@ -1688,6 +2467,11 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
             RETURN_NOT_OK(data.doc_write_batch->DeleteSubDoc(sub_path,
                                                              request_.query_id(), user_timestamp));
           }
+        } else if (range_tombstone_) {
+          // A single record deletes all rows in the range, see RangeTombstone.
+          RETURN_NOT_OK(data.doc_write_batch->DeleteSubDoc(
+              RangeTombstonePath(*hashed_doc_key_, range_tombstone_lower_, range_tombstone_upper_),
+              request_.query_id()));
         } else if (IsRangeOperation(request_, schema_)) {
           // If the range columns are not specified, we read everything and delete all rows for
           // which the where condition matches.
@@ -1776,9 +2560,12 @@ Status QLWriteOperation::DeleteRow(DocWriteBatch* doc_write_batch,
 Status QLReadOperation::Execute(const common::QLStorageIf& ql_storage,
                                 const ReadHybridTime& read_time,
                                 const Schema& schema,
-                                const Schema& query_schema,
+                                const QLReadProjections& projections,
                                 QLResultSet* resultset,
                                 HybridTime* restart_read_ht) {
+  const Schema& query_schema = projections.query_schema;
+  const Schema& static_projection = projections.static_projection;
+  const Schema& non_static_projection = projections.non_static_projection;
   size_t row_count_limit = std::numeric_limits<std::size_t>::max();
   if (request_.has_limit()) {
     if (request_.limit() == 0) {
@@ -1786,14 +2573,19 @@ Status QLReadOperation::Execute(const common::QLStorageIf& ql_storage,
     }
     row_count_limit = request_.limit();
   }
+  // The size of the rows is estimated from the size of their values, since the rows are only
+  // serialized once they are all read.
+  size_t rows_data_size = 0;
+  size_t rows_data_size_limit = std::numeric_limits<std::size_t>::max();
+  if (request_.return_paging_state() && request_.max_rows_data_size() > 0 &&
+      !request_.is_aggregate()) {
+    rows_data_size_limit = request_.max_rows_data_size();
+  }
 
-  // Create the projections of the non-key columns selected by the row block plus any referenced in
+  // The projections of the non-key columns selected by the row block plus any referenced in
   // the WHERE condition. When DocRowwiseIterator::NextRow() populates the value map, it uses this
   // projection only to scan sub-documents. The query schema is used to select only referenced
   // columns and key columns.
-  Schema static_projection, non_static_projection;
-  RETURN_NOT_OK(CreateProjections(schema, request_.column_refs(),
-                                  &static_projection, &non_static_projection));
   const bool read_static_columns = !static_projection.columns().empty();
   const bool read_distinct_columns = request_.distinct();
 
@@ -1828,7 +2620,8 @@ Status QLReadOperation::Execute(const common::QLStorageIf& ql_storage,
 
   // Begin the normal fetch.
   int match_count = 0;
-  while (resultset->rsrow_count() < row_count_limit && iter->HasNext()) {
+  while (resultset->rsrow_count() < row_count_limit && rows_data_size < rows_data_size_limit &&
+         iter->HasNext()) {
     // Note that static columns are sorted before non-static columns in DocDB as follows. This is
     // because "<empty_range_components>" is empty and terminated by kGroupEnd which sorts before
     // all other ValueType characters in a non-empty range component.
@@ -1882,6 +2675,11 @@ Status QLReadOperation::Execute(const common::QLStorageIf& ql_storage,
         RETURN_NOT_OK(EvalAggregate(selected_row));
       } else {
         RETURN_NOT_OK(PopulateResultSet(selected_row, resultset));
+        if (rows_data_size_limit != std::numeric_limits<std::size_t>::max()) {
+          for (const QLValue& value : resultset->rsrows().back().rscols()) {
+            rows_data_size += value.value().ByteSize();
+          }
+        }
       }
     }
   }
@@ -1895,7 +2693,8 @@ Status QLReadOperation::Execute(const common::QLStorageIf& ql_storage,
   }
   *restart_read_ht = iter->RestartReadHt();
 
-  if (resultset->rsrow_count() >= row_count_limit && !request_.is_aggregate()) {
+  if ((resultset->rsrow_count() >= row_count_limit || rows_data_size >= rows_data_size_limit) &&
+      !request_.is_aggregate()) {
     RETURN_NOT_OK(iter->SetPagingStateIfNecessary(request_, &response_));
   }
 
@@ -25,11 +25,14 @@
 #include "yb/common/ql_protocol.pb.h"
 #include "yb/common/ql_rowblock.h"
 #include "yb/common/ql_resultset.h"
+#include "yb/common/typedefs.h"
 
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/doc_path.h"
+#include "yb/docdb/doc_row_cache.h"
 #include "yb/docdb/primitive_value.h"
 #include "yb/docdb/doc_expr.h"
+#include "yb/docdb/ql_read_projections.h"
 
 namespace yb {
 namespace docdb {
@@ -105,8 +108,9 @@ class RedisReadOperation {
  public:
   explicit RedisReadOperation(const yb::RedisReadRequestPB& request,
                               rocksdb::DB* db,
-                              const ReadHybridTime& read_time)
-      : request_(request), db_(db), read_time_(read_time) {}
+                              const ReadHybridTime& read_time,
+                              DocRowCache* row_cache = nullptr)
+      : request_(request), db_(db), read_time_(read_time), row_cache_(row_cache) {}
 
   CHECKED_STATUS Execute();
 
@@ -126,7 +130,13 @@ class RedisReadOperation {
   CHECKED_STATUS ExecuteStrLen();
   CHECKED_STATUS ExecuteExists();
   CHECKED_STATUS ExecuteGetRange();
+  // Examines up to the scan count keys of the tablet, in the order of their documents.
+  CHECKED_STATUS ExecuteScan();
   CHECKED_STATUS ExecuteCollectionGetRange();
+  // Used to implement ZRANGE and ZREVRANGE, the members of a sorted set by their ranks.
+  CHECKED_STATUS ExecuteSortedSetRangeByRank(bool reverse);
+  // Used to implement ZRANK.
+  CHECKED_STATUS ExecuteSortedSetRank();
   CHECKED_STATUS ExecuteGetCard(rocksdb::DB *rocksdb, HybridTime hybrid_time);
 
   rocksdb::QueryId redis_query_id() { return reinterpret_cast<rocksdb::QueryId> (&request_); }
@@ -135,6 +145,8 @@ class RedisReadOperation {
   RedisResponsePB response_;
   rocksdb::DB* db_;
   ReadHybridTime read_time_;
+  // Serves the whole documents read by the operation, when set.
+  DocRowCache* row_cache_;
 };
 
 class QLWriteOperation : public DocOperation, public DocExprExecutor {
@@ -161,6 +173,15 @@ class QLWriteOperation : public DocOperation, public DocExprExecutor {
   const QLRowBlock* rowblock() const { return rowblock_.get(); }
 
  private:
+  // Whether this is an update that only adds constants to counter columns and can be written as
+  // counter deltas without reading the row, see FLAGS_docdb_blind_counter_updates.
+  bool IsBlindCounterUpdate() const;
+
+  // Whether this is a delete of the rows of a hash key in a range of its first range column that
+  // can be written as a single range tombstone, see FLAGS_docdb_range_tombstones. Sets the bounds
+  // of the range tombstone if it is.
+  bool IsRangeTombstoneDelete();
+
   // Initialize hashed_doc_key_ and/or pk_doc_key_.
   CHECKED_STATUS InitializeKeys(bool hashed_key, bool primary_key);
 
@@ -178,6 +199,14 @@ class QLWriteOperation : public DocOperation, public DocExprExecutor {
   CHECKED_STATUS DeleteRow(DocWriteBatch* doc_write_batch,
                            const DocPath row_path);
 
+  // Writes the row of an insert as a packed row, see FLAGS_docdb_pack_rows, and sets packed to true
+  // if the insert qualifies for it.
+  CHECKED_STATUS ApplyPackedRow(const DocOperationApplyData& data,
+                                const QLTableRow::SharedPtr& table_row,
+                                MonoDelta ttl,
+                                UserTimeMicros user_timestamp,
+                                bool* packed);
+
   const Schema& schema_;
 
   // Doc key and doc path for hashed key (i.e. without range columns). Present when there is a
@@ -202,6 +231,14 @@ class QLWriteOperation : public DocOperation, public DocExprExecutor {
 
   // Does this write operation require a read?
   bool require_read_ = false;
+
+  // Is this write operation written as counter deltas without a read?
+  bool blind_counter_update_ = false;
+
+  // Is this write operation a range delete written as a range tombstone with these bounds?
+  bool range_tombstone_ = false;
+  std::string range_tombstone_lower_;
+  std::string range_tombstone_upper_;
 };
 
 class QLReadOperation : public DocExprExecutor {
@@ -214,7 +251,7 @@ class QLReadOperation : public DocExprExecutor {
   CHECKED_STATUS Execute(const common::QLStorageIf& ql_storage,
                          const ReadHybridTime& read_time,
                          const Schema& schema,
-                         const Schema& query_schema,
+                         const QLReadProjections& projections,
                          QLResultSet* result_set,
                          HybridTime* restart_read_ht);
 
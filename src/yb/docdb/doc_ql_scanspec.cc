@@ -14,10 +14,105 @@
 #include "yb/docdb/doc_expr.h"
 #include "yb/docdb/doc_ql_scanspec.h"
 #include "yb/rocksdb/db/compaction.h"
+#include "yb/util/flag_tags.h"
+
+DECLARE_bool(docdb_column_zone_maps);
 
 namespace yb {
 namespace docdb {
 
+namespace {
+
+// Whether the values of this kind are stored as the primitive values recorded in the column zone
+// maps.
+bool IsZoneMapValue(const QLValuePB& value) {
+  switch (value.value_case()) {
+    case QLValuePB::kInt8Value: FALLTHROUGH_INTENDED;
+    case QLValuePB::kInt16Value: FALLTHROUGH_INTENDED;
+    case QLValuePB::kInt32Value: FALLTHROUGH_INTENDED;
+    case QLValuePB::kInt64Value: FALLTHROUGH_INTENDED;
+    case QLValuePB::kFloatValue: FALLTHROUGH_INTENDED;
+    case QLValuePB::kDoubleValue: FALLTHROUGH_INTENDED;
+    case QLValuePB::kStringValue: FALLTHROUGH_INTENDED;
+    case QLValuePB::kBoolValue: FALLTHROUGH_INTENDED;
+    case QLValuePB::kTimestampValue: FALLTHROUGH_INTENDED;
+    case QLValuePB::kDecimalValue:
+      return true;
+    default:
+      return false;
+  }
+}
+
+KeyBytes EncodeColumnValue(const QLValuePB& value) {
+  KeyBytes result;
+  PrimitiveValue::FromQLValuePB(value, ColumnSchema::SortingType::kNotSpecified).AppendToKey(
+      &result);
+  return result;
+}
+
+// Collects the bounds of the relational conjuncts of the condition. As for QLScanRange, strict
+// inequalities are treated as inclusive bounds, since the bounds only need to be a superset.
+void AddColumnValueBounds(const Schema& schema, const QLConditionPB& condition,
+                          std::vector<ColumnValueBounds>* bounds) {
+  const auto& operands = condition.operands();
+  if (condition.op() == QL_OP_AND) {
+    for (const auto& operand : operands) {
+      if (operand.expr_case() == QLExpressionPB::ExprCase::kCondition) {
+        AddColumnValueBounds(schema, operand.condition(), bounds);
+      }
+    }
+    return;
+  }
+
+  bool has_lower = false;
+  bool has_upper = false;
+  switch (condition.op()) {
+    case QL_OP_EQUAL:
+      has_lower = has_upper = true;
+      break;
+    case QL_OP_LESS_THAN: FALLTHROUGH_INTENDED;
+    case QL_OP_LESS_THAN_EQUAL:
+      has_upper = true;
+      break;
+    case QL_OP_GREATER_THAN: FALLTHROUGH_INTENDED;
+    case QL_OP_GREATER_THAN_EQUAL:
+      has_lower = true;
+      break;
+    default:
+      return;
+  }
+  if (operands.size() != 2) {
+    return;
+  }
+  const QLExpressionPB* col_expr = &operands.Get(0);
+  const QLExpressionPB* val_expr = &operands.Get(1);
+  if (col_expr->expr_case() != QLExpressionPB::ExprCase::kColumnId) {
+    // <value> <op> <column> bounds the column the other way.
+    std::swap(col_expr, val_expr);
+    std::swap(has_lower, has_upper);
+  }
+  if (col_expr->expr_case() != QLExpressionPB::ExprCase::kColumnId ||
+      val_expr->expr_case() != QLExpressionPB::ExprCase::kValue ||
+      !IsZoneMapValue(val_expr->value())) {
+    return;
+  }
+  const ColumnId column_id(col_expr->column_id());
+  const int column_idx = schema.find_column_by_id(column_id);
+  if (column_idx == Schema::kColumnNotFound || schema.is_key_column(column_idx)) {
+    return;
+  }
+  ColumnValueBounds column_bounds = { column_id, KeyBytes(), KeyBytes() };
+  if (has_lower) {
+    column_bounds.lower = EncodeColumnValue(val_expr->value());
+  }
+  if (has_upper) {
+    column_bounds.upper = EncodeColumnValue(val_expr->value());
+  }
+  bounds->push_back(std::move(column_bounds));
+}
+
+} // namespace
+
 DocQLScanSpec::DocQLScanSpec(const Schema& schema,
                              const DocKey& doc_key,
                              const rocksdb::QueryId query_id,
@@ -57,6 +152,9 @@ DocQLScanSpec::DocQLScanSpec(const Schema& schema,
       upper_doc_key_(bound_key(false)),
       include_static_columns_(include_static_columns),
       query_id_(query_id) {
+  if (condition && FLAGS_docdb_column_zone_maps) {
+    AddColumnValueBounds(schema, *condition, &column_value_bounds_);
+  }
 }
 
 DocKey DocQLScanSpec::bound_key(const bool lower_bound) const {
@@ -167,6 +265,7 @@ Status DocQLScanSpec::GetBoundKey(const bool lower_bound, DocKey* key) const {
 }
 
 rocksdb::UserBoundaryTag TagForRangeComponent(size_t index);
+rocksdb::UserBoundaryTag TagForRangeTombstones();
 
 namespace {
 
@@ -195,12 +294,26 @@ bool GreaterOrEquals(const Slice& lhs, const Slice& rhs) {
 class RangeBasedFileFilter : public rocksdb::ReadFileFilter {
  public:
   RangeBasedFileFilter(const std::vector<PrimitiveValue>& lower_bounds,
-      const std::vector<PrimitiveValue>& upper_bounds)
+      const std::vector<PrimitiveValue>& upper_bounds,
+      DocKeyHash min_hash, DocKeyHash max_hash)
       : lower_bounds_(EncodePrimitiveValues(lower_bounds, upper_bounds.size())),
-      upper_bounds_(EncodePrimitiveValues(upper_bounds, lower_bounds.size())) {
+      upper_bounds_(EncodePrimitiveValues(upper_bounds, lower_bounds.size())),
+      min_hash_(min_hash), max_hash_(max_hash) {
   }
 
   bool Filter(const rocksdb::FdWithBoundaries& file) const override {
+    // The keys are ordered by hash first, so when both boundary keys of the file are hashed, so are
+    // all the keys between them and the hashes of the file lie between theirs.
+    DocKeyHash smallest_hash, largest_hash;
+    if (DocKey::DecodeHash(file.smallest.user_key(), &smallest_hash) &&
+        DocKey::DecodeHash(file.largest.user_key(), &largest_hash) &&
+        (largest_hash < min_hash_ || smallest_hash > max_hash_)) {
+      return false;
+    }
+    if (file.largest.user_value_with_tag(TagForRangeTombstones()) != nullptr) {
+      // The range tombstones of the file could delete the rows of the scan from other files.
+      return true;
+    }
     for (size_t i = 0; i != lower_bounds_.size(); ++i) {
       auto lower_bound = lower_bounds_[i].AsSlice();
       auto upper_bound = upper_bounds_[i].AsSlice();
@@ -216,6 +329,8 @@ class RangeBasedFileFilter : public rocksdb::ReadFileFilter {
  private:
   std::vector<KeyBytes> lower_bounds_;
   std::vector<KeyBytes> upper_bounds_;
+  const DocKeyHash min_hash_;
+  const DocKeyHash max_hash_;
 };
 
 } // namespace
@@ -223,10 +338,22 @@ class RangeBasedFileFilter : public rocksdb::ReadFileFilter {
 std::shared_ptr<rocksdb::ReadFileFilter> DocQLScanSpec::CreateFileFilter() const {
   auto lower_bound = range_components(true);
   auto upper_bound = range_components(false);
-  if (lower_bound.empty() && upper_bound.empty()) {
+  // Same hash bounds as the ones bound_key() scans between.
+  DocKeyHash min_hash = std::numeric_limits<DocKeyHash>::min();
+  DocKeyHash max_hash = std::numeric_limits<DocKeyHash>::max();
+  if (hash_code_ != kUnspecifiedHashCode_) {
+    min_hash = static_cast<DocKeyHash>(hash_code_);
+  }
+  if (max_hash_code_ != kUnspecifiedHashCode_) {
+    max_hash = static_cast<DocKeyHash>(max_hash_code_);
+  }
+  if (lower_bound.empty() && upper_bound.empty() &&
+      min_hash == std::numeric_limits<DocKeyHash>::min() &&
+      max_hash == std::numeric_limits<DocKeyHash>::max()) {
     return std::shared_ptr<rocksdb::ReadFileFilter>();
   } else {
-    return std::make_shared<RangeBasedFileFilter>(std::move(lower_bound), std::move(upper_bound));
+    return std::make_shared<RangeBasedFileFilter>(
+        std::move(lower_bound), std::move(upper_bound), min_hash, max_hash);
   }
 }
 
@@ -23,6 +23,14 @@
 namespace yb {
 namespace docdb {
 
+// Inclusive bounds that a condition puts on the values of a regular column, encoded as keys. An
+// empty bound is unbounded.
+struct ColumnValueBounds {
+  ColumnId column_id;
+  KeyBytes lower;
+  KeyBytes upper;
+};
+
 // DocDB variant of QL scanspec.
 class DocQLScanSpec : public common::QLScanSpec {
  public:
@@ -50,9 +58,16 @@ class DocQLScanSpec : public common::QLScanSpec {
     return GetBoundKey(false /* upper_bound */, key);
   }
 
-  // Create file filter based on range components.
+  // Create file filter based on the hash code bounds and range components.
   std::shared_ptr<rocksdb::ReadFileFilter> CreateFileFilter() const;
 
+  // The bounds that the conjuncts of the condition put on the values of regular columns, collected
+  // when FLAGS_docdb_column_zone_maps is set. A row satisfies the condition only if its values are
+  // within each of them.
+  const std::vector<ColumnValueBounds>& column_value_bounds() const {
+    return column_value_bounds_;
+  }
+
   // Gets the query id.
   const rocksdb::QueryId QueryId() const {
     return query_id_;
@@ -104,6 +119,8 @@ class DocQLScanSpec : public common::QLScanSpec {
 
   // Query ID of this scan.
   const rocksdb::QueryId query_id_;
+
+  std::vector<ColumnValueBounds> column_value_bounds_;
 };
 
 }  // namespace docdb
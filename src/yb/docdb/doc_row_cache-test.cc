@@ -0,0 +1,112 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/doc_row_cache.h"
+
+#include "yb/docdb/doc_key.h"
+#include "yb/util/size_literals.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+constexpr size_t kCacheCapacity = 1_MB;
+constexpr rocksdb::QueryId kQueryId = 1;
+
+SubDocument StringDocument(const std::string& value, int64_t ttl_seconds = -1) {
+  SubDocument doc(PrimitiveValue{value});
+  doc.SetTtl(ttl_seconds);
+  return doc;
+}
+
+// Returns the key of a record of the document written at hybrid_time.
+std::string RecordKey(const DocKey& doc_key, HybridTime hybrid_time) {
+  return SubDocKey(doc_key, hybrid_time).Encode().data();
+}
+
+class DocRowCacheTest : public YBTest {
+ protected:
+  DocRowCacheTest() : cache_(kCacheCapacity) {}
+
+  // Looks up the document, reading it from "RocksDB" on a miss.
+  bool LookupOrInsert(const DocKey& doc_key, HybridTime read_ht, const SubDocument& stored,
+                      SubDocument* doc) {
+    const KeyBytes encoded = doc_key.Encode();
+    bool doc_found = false;
+    DocRowCache::Ticket ticket;
+    if (cache_.Lookup(encoded.AsSlice(), read_ht, kQueryId, doc, &doc_found, &ticket)) {
+      return true;
+    }
+    *doc = stored;
+    cache_.Insert(encoded.AsSlice(), ticket, read_ht, kQueryId, stored, true /* doc_found */);
+    return false;
+  }
+
+  DocRowCache cache_;
+};
+
+} // namespace
+
+TEST_F(DocRowCacheTest, LookupAndInvalidate) {
+  const DocKey doc_key = DocKey::FromRedisKey(1, "key");
+  const DocKey other_doc_key = DocKey::FromRedisKey(2, "other");
+  SubDocument doc;
+
+  ASSERT_FALSE(LookupOrInsert(doc_key, HybridTime(100), StringDocument("v1"), &doc));
+  ASSERT_TRUE(LookupOrInsert(doc_key, HybridTime(100), StringDocument("v2"), &doc));
+  ASSERT_EQ("v1", doc.GetString());
+  ASSERT_TRUE(LookupOrInsert(doc_key, HybridTime(200), StringDocument("v2"), &doc));
+  ASSERT_EQ("v1", doc.GetString());
+
+  // The document could be different for an earlier read.
+  ASSERT_FALSE(LookupOrInsert(doc_key, HybridTime(50), StringDocument("v0"), &doc));
+
+  ASSERT_FALSE(LookupOrInsert(other_doc_key, HybridTime(400), StringDocument("o1"), &doc));
+  ASSERT_TRUE(LookupOrInsert(other_doc_key, HybridTime(400), StringDocument("o2"), &doc));
+  ASSERT_EQ("o1", doc.GetString());
+
+  rocksdb::WriteBatch write;
+  write.Put(RecordKey(doc_key, HybridTime(500)), "");
+  cache_.Invalidate(write, HybridTime(500));
+  ASSERT_FALSE(LookupOrInsert(doc_key, HybridTime(600), StringDocument("v3"), &doc));
+  ASSERT_TRUE(LookupOrInsert(doc_key, HybridTime(700), StringDocument("v4"), &doc));
+  ASSERT_EQ("v3", doc.GetString());
+
+  cache_.InvalidateAll();
+  ASSERT_FALSE(LookupOrInsert(doc_key, HybridTime(700), StringDocument("v4"), &doc));
+  ASSERT_FALSE(LookupOrInsert(other_doc_key, HybridTime(700), StringDocument("o2"), &doc));
+}
+
+TEST_F(DocRowCacheTest, NotCached) {
+  const DocKey doc_key = DocKey::FromRedisKey(1, "key");
+  SubDocument doc;
+
+  // The values that expire are not cached.
+  ASSERT_FALSE(LookupOrInsert(doc_key, HybridTime(100), StringDocument("v1", 10), &doc));
+  ASSERT_FALSE(LookupOrInsert(doc_key, HybridTime(100), StringDocument("v1", 10), &doc));
+
+  // The documents written after the read are not cached.
+  rocksdb::WriteBatch write;
+  write.Put(RecordKey(doc_key, HybridTime(500)), "");
+  cache_.Invalidate(write, HybridTime(500));
+  ASSERT_FALSE(LookupOrInsert(doc_key, HybridTime(400), StringDocument("v1"), &doc));
+  ASSERT_FALSE(LookupOrInsert(doc_key, HybridTime(600), StringDocument("v2"), &doc));
+  ASSERT_TRUE(LookupOrInsert(doc_key, HybridTime(600), StringDocument("v3"), &doc));
+  ASSERT_EQ("v2", doc.GetString());
+}
+
+}  // namespace docdb
+}  // namespace yb
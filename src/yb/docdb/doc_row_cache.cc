@@ -0,0 +1,199 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/doc_row_cache.h"
+
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/value_type.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+// The cache does not let one document take more than this share of its capacity.
+constexpr size_t kMaxDocumentCapacityShare = 256;
+
+// The documents of Redis collections are at most this deep.
+constexpr int kMaxCachedDepth = 3;
+
+// Approximate memory used by a node of std::map besides its key and value.
+constexpr size_t kMapNodeOverhead = 4 * sizeof(void*);
+
+size_t PrimitiveValueSize(const PrimitiveValue& value) {
+  return sizeof(PrimitiveValue) + (value.IsString() ? value.GetString().size() : 0);
+}
+
+} // namespace
+
+bool DocRowCache::AddDocumentSize(const SubDocument& doc, int depth, size_t* size) {
+  if (doc.IsPrimitive()) {
+    *size += PrimitiveValueSize(doc);
+    return doc.GetTtl() == -1;
+  }
+  *size += sizeof(SubDocument);
+  if (!doc.has_valid_object_container()) {
+    return !doc.has_valid_array_container();
+  }
+  if (depth == kMaxCachedDepth) {
+    return false;
+  }
+  for (const auto& child : doc.object_container()) {
+    *size += kMapNodeOverhead + PrimitiveValueSize(child.first);
+    if (!AddDocumentSize(child.second, depth + 1, size)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+struct DocRowCache::Entry {
+  SubDocument doc;
+  bool doc_found;
+  // The read that cached the document, it is only valid for the reads that are not earlier.
+  HybridTime read_ht;
+  // The version of the stripe of the document before it was read.
+  uint64_t version;
+
+  static void Delete(const Slice& key, void* value) {
+    delete static_cast<Entry*>(value);
+  }
+};
+
+// Invalidates the stripes of the documents written by a batch of regular records.
+class DocRowCache::InvalidateHandler : public rocksdb::WriteBatch::Handler {
+ public:
+  InvalidateHandler(DocRowCache* cache, HybridTime hybrid_time)
+      : cache_(cache), hybrid_time_(hybrid_time) {}
+
+  void Put(const Slice& key, const Slice& value) override {
+    Invalidate(key);
+  }
+
+  void Delete(const Slice& key) override {
+    Invalidate(key);
+  }
+
+  void SingleDelete(const Slice& key) override {
+    Invalidate(key);
+  }
+
+  void Merge(const Slice& key, const Slice& value) override {
+    Invalidate(key);
+  }
+
+  CHECKED_STATUS UserOpId(const rocksdb::OpId& op_id) override {
+    return Status::OK();
+  }
+
+ private:
+  void Invalidate(const Slice& key) {
+    if (invalidated_all_ || key.empty() || key[0] == static_cast<char>(ValueType::kIntentPrefix)) {
+      // Intents are not visible to the reads served by the cache until they are applied.
+      return;
+    }
+    auto doc_key_size = DocKey::EncodedSize(key, DocKeyPart::WHOLE_DOC_KEY);
+    if (!doc_key_size.ok()) {
+      // The documents written by the record are unknown.
+      cache_->InvalidateAll();
+      invalidated_all_ = true;
+      return;
+    }
+    InvalidateStripe(&cache_->StripeFor(Slice(key.data(), *doc_key_size)), hybrid_time_);
+  }
+
+  DocRowCache* const cache_;
+  const HybridTime hybrid_time_;
+  bool invalidated_all_ = false;
+};
+
+DocRowCache::DocRowCache(size_t capacity)
+    : cache_(rocksdb::NewLRUCache(capacity)),
+      stripes_(new Stripe[kNumStripes]) {
+}
+
+DocRowCache::~DocRowCache() {
+}
+
+bool DocRowCache::Lookup(const Slice& encoded_doc_key, HybridTime read_ht,
+                         rocksdb::QueryId query_id, SubDocument* doc, bool* doc_found,
+                         Ticket* ticket) {
+  // The version is loaded first, so that the write time is at least the one of the write that
+  // produced the version.
+  Stripe& stripe = StripeFor(encoded_doc_key);
+  ticket->version = stripe.version.load(std::memory_order_acquire);
+  ticket->max_write_ht = HybridTime(stripe.max_write_ht.load(std::memory_order_acquire));
+
+  auto* handle = cache_->Lookup(encoded_doc_key, query_id);
+  if (handle == nullptr) {
+    return false;
+  }
+  const auto* entry = static_cast<const Entry*>(cache_->Value(handle));
+  const bool valid = entry->version == ticket->version && entry->read_ht <= read_ht;
+  if (valid) {
+    *doc = entry->doc;
+    *doc_found = entry->doc_found;
+  }
+  cache_->Release(handle);
+  return valid;
+}
+
+void DocRowCache::Insert(const Slice& encoded_doc_key, const Ticket& ticket, HybridTime read_ht,
+                         rocksdb::QueryId query_id, const SubDocument& doc, bool doc_found) {
+  if (ticket.max_write_ht > read_ht) {
+    // The document could be changed by a write after the read.
+    return;
+  }
+  size_t charge = sizeof(Entry) + encoded_doc_key.size();
+  if (doc_found && !AddDocumentSize(doc, 0 /* depth */, &charge)) {
+    return;
+  }
+  if (charge > cache_->GetCapacity() / kMaxDocumentCapacityShare) {
+    return;
+  }
+  auto* entry = new Entry{doc, doc_found, read_ht, ticket.version};
+  const auto s = cache_->Insert(encoded_doc_key, query_id, entry, charge, &Entry::Delete);
+  VLOG_IF(3, !s.ok()) << "Failed to cache document: " << s;
+}
+
+void DocRowCache::Invalidate(const rocksdb::WriteBatch& write_batch, HybridTime hybrid_time) {
+  InvalidateHandler handler(this, hybrid_time);
+  const auto s = write_batch.Iterate(&handler);
+  if (!s.ok()) {
+    LOG(DFATAL) << "Failed to iterate over a written batch: " << s;
+    InvalidateAll();
+  }
+}
+
+void DocRowCache::InvalidateAll() {
+  for (size_t i = 0; i != kNumStripes; ++i) {
+    InvalidateStripe(&stripes_[i], HybridTime::kMin);
+  }
+}
+
+DocRowCache::Stripe& DocRowCache::StripeFor(const Slice& encoded_doc_key) {
+  return stripes_[encoded_doc_key.hash() % kNumStripes];
+}
+
+void DocRowCache::InvalidateStripe(Stripe* stripe, HybridTime hybrid_time) {
+  const uint64_t write_ht = hybrid_time.ToUint64();
+  uint64_t max_write_ht = stripe->max_write_ht.load(std::memory_order_relaxed);
+  while (max_write_ht < write_ht &&
+         !stripe->max_write_ht.compare_exchange_weak(max_write_ht, write_ht,
+                                                     std::memory_order_release)) {
+  }
+  stripe->version.fetch_add(1, std::memory_order_acq_rel);
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -0,0 +1,95 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_DOC_ROW_CACHE_H_
+#define YB_DOCDB_DOC_ROW_CACHE_H_
+
+#include <atomic>
+#include <memory>
+
+#include "yb/common/hybrid_time.h"
+#include "yb/docdb/subdocument.h"
+#include "yb/rocksdb/cache.h"
+#include "yb/rocksdb/write_batch.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+namespace docdb {
+
+// A cache of fully decoded documents of a tablet keyed by their encoded DocKey, which serves the
+// point reads of hot documents without seeking RocksDB iterators and decoding blocks.
+//
+// Documents are not updated in the cache, the writes only invalidate them. The encoded DocKeys are
+// hashed into stripes, every stripe has a version that is incremented by each write of a document
+// of the stripe, and a cached document is only valid while the version of its stripe is the one
+// that was seen before the document was read. So a read racing with a write never caches the
+// version of the document that was read before the write.
+//
+// Only the documents that are the same for all the reads after the read that cached them are
+// cached, i.e. documents without TTL that have no writes after the read time. The absence of a
+// document is cached as well.
+//
+// This class is thread-safe.
+class DocRowCache {
+ public:
+  // The state of the stripe of a document, captured before the document is read from RocksDB.
+  struct Ticket {
+    uint64_t version = 0;
+    HybridTime max_write_ht;
+  };
+
+  explicit DocRowCache(size_t capacity);
+  ~DocRowCache();
+
+  // Looks up the document with the given encoded DocKey as of read_ht. Returns true and fills doc
+  // and doc_found if the cached document is valid for the read. Otherwise fills the ticket that
+  // should be passed to Insert() once the document is read from RocksDB.
+  bool Lookup(const Slice& encoded_doc_key, HybridTime read_ht, rocksdb::QueryId query_id,
+              SubDocument* doc, bool* doc_found, Ticket* ticket);
+
+  // Caches the document read as of read_ht if it can be reused by the later reads.
+  void Insert(const Slice& encoded_doc_key, const Ticket& ticket, HybridTime read_ht,
+              rocksdb::QueryId query_id, const SubDocument& doc, bool doc_found);
+
+  // Invalidates the documents written by the batch of regular records at hybrid_time. Should be
+  // called once the batch is written to RocksDB.
+  void Invalidate(const rocksdb::WriteBatch& write_batch, HybridTime hybrid_time);
+
+  // Invalidates all cached documents, used when the records are replaced without a write batch.
+  void InvalidateAll();
+
+ private:
+  class InvalidateHandler;
+  struct Entry;
+  struct Stripe {
+    std::atomic<uint64_t> version{0};
+    std::atomic<uint64_t> max_write_ht{0};
+  };
+
+  static constexpr size_t kNumStripes = 1024;
+
+  Stripe& StripeFor(const Slice& encoded_doc_key);
+  static void InvalidateStripe(Stripe* stripe, HybridTime hybrid_time);
+
+  // Adds the approximate memory used by the document to *size. Returns false if the document
+  // should not be cached, because some of its values expire.
+  static bool AddDocumentSize(const SubDocument& doc, int depth, size_t* size);
+
+  std::shared_ptr<rocksdb::Cache> cache_;
+  std::unique_ptr<Stripe[]> stripes_;
+};
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif  // YB_DOCDB_DOC_ROW_CACHE_H_
@@ -26,12 +26,28 @@
 #include "yb/docdb/subdocument.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/rocksdb/db/compaction.h"
+#include "yb/rocksdb/statistics.h"
 #include "yb/rocksutil/yb_rocksdb.h"
+#include "yb/util/flag_tags.h"
 
 using std::string;
 
 using yb::FormatRocksDBSliceAsStr;
 
+DECLARE_bool(docdb_range_tombstones);
+
+DEFINE_bool(docdb_scans_use_low_priority_block_cache, true,
+            "Whether blocks read by scans that are not restricted to a single hash key should be "
+            "filled into the block cache with low priority, so they do not evict the blocks used "
+            "by point reads.");
+TAG_FLAG(docdb_scans_use_low_priority_block_cache, advanced);
+
+DEFINE_bool(docdb_point_read_fast_path, true,
+            "Whether reads of a single row by its full primary key from a non-transactional table "
+            "should build the row in a single pass over its records when all of them are "
+            "primitive column values, instead of looking up every projected column separately.");
+TAG_FLAG(docdb_point_read_fast_path, advanced);
+
 namespace yb {
 namespace docdb {
 
@@ -68,7 +84,11 @@ DocRowwiseIterator::DocRowwiseIterator(
       db_(db),
       has_bound_key_(false),
       pending_op_(pending_op_counter),
-      done_(false) {
+      done_(false),
+      statistics_(db->GetOptions().statistics.get()),
+      may_have_range_tombstones_(FLAGS_docdb_range_tombstones &&
+                                 schema.num_hash_key_columns() != 0 &&
+                                 schema.num_range_key_columns() != 0) {
   projection_subkeys_.reserve(projection.num_columns() + 1);
   projection_subkeys_.push_back(PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn));
   for (size_t i = projection_.num_key_columns(); i < projection.num_columns(); i++) {
@@ -81,31 +101,35 @@ DocRowwiseIterator::~DocRowwiseIterator() {
 }
 
 Status DocRowwiseIterator::Init(ScanSpec *spec) {
-  // TODO(bogdan): refactor this after we completely move away from the old ScanSpec. For now, just
-  // default to not using bloom filters on scans for these codepaths.
-  db_iter_ = CreateIntentAwareIterator(
-      db_, BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none /* user_key_for_filter */,
-      spec->query_id(), txn_op_context_, read_time_);
-
-  if (spec != nullptr && spec->lower_bound_key() != nullptr) {
-    row_key_ = KuduToDocKey(*spec->lower_bound_key());
-    // Need this seek, because SeekOutOfSubDoc seeks forward.
-    db_iter_->Seek(row_key_);
-    if (!spec->lower_bound_inclusive()) {
-      db_iter_->SeekOutOfSubDoc(SubDocKey(row_key_));
-    }
-  } else {
-    row_key_ = DocKey();
-    db_iter_->Seek(row_key_);
+  // TODO(bogdan): refactor this after we completely move away from the old ScanSpec.
+  has_bound_key_ = spec != nullptr && spec->exclusive_upper_bound_key() != nullptr;
+  if (has_bound_key_) {
+    bound_key_ = KuduToDocKey(*spec->exclusive_upper_bound_key());
   }
-  row_ready_ = false;
+  const bool has_lower_bound = spec != nullptr && spec->lower_bound_key() != nullptr;
+  row_key_ = has_lower_bound ? KuduToDocKey(*spec->lower_bound_key()) : DocKey();
 
-  if (spec != nullptr && spec->exclusive_upper_bound_key() != nullptr) {
-    has_bound_key_ = true;
-    bound_key_ = KuduToDocKey(*spec->exclusive_upper_bound_key());
-  } else {
-    has_bound_key_ = false;
+  // Same heuristic as for QL scans: if both bounds have the same hashed components, all rows of
+  // the scan share the bloom filter key.
+  const bool use_bloom_filter = has_lower_bound && has_bound_key_ && !row_key_.hashed_group().empty() &&
+      bound_key_.HashedComponentsEqual(row_key_);
+  boost::optional<const Slice> user_key_for_filter;
+  if (use_bloom_filter) {
+    filter_key_ = row_key_.Encode();
+    user_key_for_filter = filter_key_.AsSlice();
+  }
+  db_iter_ = CreateIntentAwareIterator(
+      db_,
+      use_bloom_filter ? BloomFilterMode::USE_BLOOM_FILTER : BloomFilterMode::DONT_USE_BLOOM_FILTER,
+      user_key_for_filter, spec != nullptr ? spec->query_id() : rocksdb::kDefaultQueryId,
+      txn_op_context_, read_time_);
+
+  // Need this seek, because SeekOutOfSubDoc seeks forward.
+  db_iter_->Seek(row_key_);
+  if (has_lower_bound && !spec->lower_bound_inclusive()) {
+    db_iter_->SeekOutOfSubDoc(SubDocKey(row_key_));
   }
+  row_ready_ = false;
   return Status::OK();
 }
 
@@ -127,15 +151,34 @@ Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
   const auto mode = is_fixed_point_get ? BloomFilterMode::USE_BLOOM_FILTER :
       BloomFilterMode::DONT_USE_BLOOM_FILTER;
 
-  const KeyBytes row_key_encoded = lower_doc_key.Encode();
-  const Slice row_key_encoded_as_slice = row_key_encoded.AsSlice();
+  // Scans over multiple hash keys (e.g. full table scans) are likely to read many blocks only
+  // once, so do not let them flush the hot blocks out of the cache.
+  const auto query_id = !is_fixed_point_get && FLAGS_docdb_scans_use_low_priority_block_cache
+      ? rocksdb::kLowPriorityQueryId : doc_spec.QueryId();
+
+  filter_key_ = lower_doc_key.Encode();
 
   db_iter_ = CreateIntentAwareIterator(
-      db_, mode, row_key_encoded_as_slice, doc_spec.QueryId(), txn_op_context_, read_time_,
+      db_, mode, filter_key_.AsSlice(), query_id, txn_op_context_, read_time_,
       doc_spec.CreateFileFilter());
 
-  db_iter_->SeekWithoutHt(row_key_encoded);
   row_ready_ = false;
+  // The zone maps are checked after the iterator is created, so they cover the records it reads.
+  // Transactions could have values in their intents, which the zone maps do not cover.
+  if (!txn_op_context_ && !ColumnValuesMayExist(db_, doc_spec.column_value_bounds())) {
+    VLOG(4) << "No rows can satisfy the column conditions according to the zone maps";
+    done_ = true;
+    return Status::OK();
+  }
+  // A single row read by its full primary key from a table without intents, the upper bound of
+  // such a read is the key followed by +inf.
+  if (FLAGS_docdb_point_read_fast_path && !txn_op_context_ && is_forward_scan_ &&
+      lower_doc_key.hashed_group().size() == schema_.num_hash_key_columns() &&
+      lower_doc_key.range_group().size() == schema_.num_range_key_columns()) {
+    DocKey point_upper_doc_key = lower_doc_key;
+    point_upper_doc_key.AddRangeComponent(PrimitiveValue(ValueType::kHighest));
+    try_primitive_columns_row_ = upper_doc_key == point_upper_doc_key;
+  }
 
   if (is_forward_scan_) {
     has_bound_key_ = !upper_doc_key.empty();
@@ -149,11 +192,9 @@ Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
     }
   }
 
-  if (is_forward_scan_) {
-    if (has_bound_key_) {
-       db_iter_->Seek(lower_doc_key);
-    }
-  } else {
+  // Forward scans start at the lower bound, so they are already positioned by this seek.
+  db_iter_->SeekWithoutHt(filter_key_);
+  if (!is_forward_scan_) {
     if (has_bound_key_) {
       db_iter_->PrevDocKey(upper_doc_key);
     } else {
@@ -164,6 +205,22 @@ Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
   return Status::OK();
 }
 
+Status DocRowwiseIterator::ApplyRangeTombstones(
+    const Slice& key, DocHybridTime* deleted_ts) const {
+  Slice hashed_part, range_group;
+  RETURN_NOT_OK(SplitDocKey(key, &hashed_part, &range_group));
+  if (!range_tombstones_.IsFor(hashed_part)) {
+    RETURN_NOT_OK(range_tombstones_.Read(hashed_part, db_iter_.get()));
+    db_iter_->Seek(row_key_);  // Back to the row for GetSubDocument.
+  }
+  // The range group of a static row is empty and is not covered by range tombstones that delete
+  // the regular rows.
+  if (range_group.size() > 1) {
+    *deleted_ts = range_tombstones_.DeletedAt(range_group);
+  }
+  return Status::OK();
+}
+
 Status DocRowwiseIterator::EnsureIteratorPositionCorrect() const {
   if (!is_forward_scan_) {
     db_iter_->PrevDocKey(row_key_);
@@ -212,14 +269,41 @@ bool DocRowwiseIterator::HasNext() const {
     SubDocKey sub_doc_key(row_key_);
     GetSubDocumentData data = { &sub_doc_key, &row_, &doc_found };
     data.table_ttl = TableTTL(schema_);
-    status_ = GetSubDocument(db_iter_.get(), data, &projection_subkeys_);
+    if (may_have_range_tombstones_) {
+      status_ = ApplyRangeTombstones(old_key.AsSlice(), &data.deleted_ts);
+      if (!status_.ok()) {
+        // Defer error reporting to NextBlock().
+        return true;
+      }
+    }
+    bool row_built = false;
+    // The fast path does not know about range tombstones, it is only used for rows they do not
+    // cover.
+    if (try_primitive_columns_row_ && data.deleted_ts != DocHybridTime::kMin) {
+      try_primitive_columns_row_ = false;
+    }
+    if (try_primitive_columns_row_) {
+      // Only the first row of a point read is tried, later ones are past the bound key anyway.
+      try_primitive_columns_row_ = false;
+      status_ = GetPrimitiveColumnsRow(db_iter_.get(), data, projection_subkeys_, &row_built);
+      if (!status_.ok()) {
+        // Defer error reporting to NextBlock().
+        return true;
+      }
+      if (!row_built) {
+        db_iter_->Seek(row_key_);  // Position it for GetSubDocument.
+      }
+    }
+    if (!row_built) {
+      status_ = GetSubDocument(db_iter_.get(), data, &projection_subkeys_);
+    }
     // After this, the iter should be positioned right after the subdocument.
     if (!status_.ok()) {
       // Defer error reporting to NextBlock().
       return true;
     }
 
-    if (!doc_found) {
+    if (!doc_found && !row_built) {
       SubDocument full_row;
       // If doc is not found, decide if some non-projection column exists.
       // Currently we read the whole doc here,
@@ -253,6 +337,12 @@ bool DocRowwiseIterator::HasNext() const {
     }
   }
   row_ready_ = true;
+  if (statistics_ != nullptr) {
+    statistics_->measureTime(rocksdb::NEXTS_PER_ROW, db_iter_->num_nexts() - nexts_before_row_);
+    statistics_->measureTime(rocksdb::SEEKS_PER_ROW, db_iter_->num_seeks() - seeks_before_row_);
+  }
+  nexts_before_row_ = db_iter_->num_nexts();
+  seeks_before_row_ = db_iter_->num_seeks();
   return true;
 }
 
@@ -414,13 +504,35 @@ Status DocRowwiseIterator::NextBlock(RowBlock* dst) {
     return STATUS(InternalError, "next row has not be prepared for reading");
   }
 
-  if (PREDICT_FALSE(dst->row_capacity() == 0)) {
+  const size_t row_capacity = dst->row_capacity();
+  if (PREDICT_FALSE(row_capacity == 0)) {
     return Status::OK();
   }
 
-  dst->Resize(1);
+  dst->Resize(row_capacity);
+  size_t num_rows = 0;
+  for (;;) {
+    Status s = FillRow(dst, num_rows);
+    if (!s.ok()) {
+      dst->Resize(num_rows);
+      dst->selection_vector()->SetAllTrue();
+      return s;
+    }
+    ++num_rows;
+    row_ready_ = false;
+    // HasNext prepares the next row. If it fails, the error is saved in status_ and returned by the
+    // next NextBlock call, after the rows decoded so far are consumed.
+    if (num_rows == row_capacity || !HasNext() || !status_.ok()) {
+      break;
+    }
+  }
+  dst->Resize(num_rows);
   dst->selection_vector()->SetAllTrue();
-  RowBlockRow dst_row(dst->row(0));
+  return Status::OK();
+}
+
+Status DocRowwiseIterator::FillRow(RowBlock* dst, size_t row_index) {
+  RowBlockRow dst_row(dst->row(row_index));
 
   // Populate the key column values from the doc key. We require that when a projection selects
   // either hash or range columns, all hash or range columns are selected.
@@ -442,7 +554,8 @@ Status DocRowwiseIterator::NextBlock(RowBlock* dst) {
   for (size_t i = projection_.num_key_columns(); i < projection_.num_columns(); i++) {
     const SubDocument* value = row_.GetChild(PrimitiveValue(projection_.column_id(i)));
     const bool is_null = value->value_type() == ValueType::kInvalidValueType;
-    const bool is_nullable = dst->column_block(i).is_nullable();
+    ColumnBlock column_block = dst->column_block(i);
+    const bool is_nullable = column_block.is_nullable();
     if (!is_null) {
       RETURN_NOT_OK(PrimitiveValueToKudu(projection_, i, *value, &dst_row));
     }
@@ -465,10 +578,9 @@ Status DocRowwiseIterator::NextBlock(RowBlock* dst) {
       }
     }
     if (is_nullable) {
-      dst->column_block(i).SetCellIsNull(0, is_null);
+      column_block.SetCellIsNull(row_index, is_null);
     }
   }
-  row_ready_ = false;
   return Status::OK();
 }
 
@@ -30,6 +30,7 @@
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/subdocument.h"
 #include "yb/docdb/doc_ql_scanspec.h"
+#include "yb/docdb/range_tombstone.h"
 #include "yb/docdb/value.h"
 #include "yb/util/status.h"
 #include "yb/util/pending_op_counter.h"
@@ -64,8 +65,10 @@ class DocRowwiseIterator : public common::QLRowwiseIteratorIf {
     return projection_;
   }
 
-  // This may return one row at a time in the initial implementation, even though Kudu's scanning
-  // interface supports returning multiple rows at a time.
+  // Decodes as many rows as fit into the row block (up to dst->row_capacity()) in one call, so
+  // the per-call overhead is amortized over the whole block. Rows are written column by column into
+  // the block's columnar buffers. If an error happens after some rows have been decoded, these rows
+  // are returned and the error is reported by the next call.
   CHECKED_STATUS NextBlock(RowBlock *dst) override;
 
   void GetIteratorStats(std::vector<IteratorStats>* stats) const override;
@@ -100,6 +103,9 @@ class DocRowwiseIterator : public common::QLRowwiseIteratorIf {
     return DocKey::FromKuduEncodedKey(encoded_key, schema_);
   }
 
+  // Decodes the row prepared by HasNext into the row with index row_index of the row block.
+  CHECKED_STATUS FillRow(RowBlock* dst, size_t row_index);
+
   // Get the non-key column values of a QL row.
   CHECKED_STATUS GetValues(const Schema& projection, vector<SubDocument>* values);
 
@@ -133,6 +139,11 @@ class DocRowwiseIterator : public common::QLRowwiseIteratorIf {
   // ensures that the iterator will be positioned on the first kv-pair of the next row.
   CHECKED_STATUS EnsureIteratorPositionCorrect() const;
 
+  // Sets deleted_ts to the latest time at which the row that starts at the encoded key was deleted
+  // by a range tombstone, reading the range tombstones of its hash key when it is the first row of
+  // the hash key seen by the scan.
+  CHECKED_STATUS ApplyRangeTombstones(const Slice& key, DocHybridTime* deleted_ts) const;
+
   const Schema& projection_;
 
   // The schema for all columns, not just the columns we're scanning.
@@ -152,6 +163,10 @@ class DocRowwiseIterator : public common::QLRowwiseIteratorIf {
   bool has_bound_key_;
   DocKey bound_key_;
 
+  // Encoded key used to check bloom filters of SST files. The file filters created for db_iter_
+  // reference it, so it should outlive db_iter_.
+  KeyBytes filter_key_;
+
   std::unique_ptr<IntentAwareIterator> db_iter_;
 
   // We keep the "pending operation" counter incremented for the lifetime of this iterator so that
@@ -178,6 +193,24 @@ class DocRowwiseIterator : public common::QLRowwiseIteratorIf {
 
   // Used for keeping track of errors that happen in HasNext. Returned
   mutable Status status_;
+
+  // Whether the next row should be built by GetPrimitiveColumnsRow, which is set for reads of a
+  // single row by its full primary key, see FLAGS_docdb_point_read_fast_path.
+  mutable bool try_primitive_columns_row_ = false;
+
+  // Statistics of db_, where the numbers of Next() and Seek() calls per row are recorded.
+  rocksdb::Statistics* const statistics_;
+
+  // Numbers of Next() and Seek() calls done by db_iter_ before the current row.
+  mutable uint64_t nexts_before_row_ = 0;
+  mutable uint64_t seeks_before_row_ = 0;
+
+  // Whether the rows could be deleted by range tombstones, which only the tables with both hash
+  // and range columns have, see FLAGS_docdb_range_tombstones.
+  const bool may_have_range_tombstones_;
+
+  // The range tombstones of the hash key of the last row.
+  mutable RangeTombstones range_tombstones_;
 };
 
 }  // namespace docdb
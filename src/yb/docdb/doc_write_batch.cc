@@ -291,11 +291,8 @@ Status DocWriteBatch::ExtendList(
         value.value_type());
   }
   const std::vector<SubDocument>& list = value.array_container();
-  // It is assumed that there is an exclusive lock on the list key.
-  // The lock ensures that there isn't another thread picking ArrayIndexes for the same list.
-  // No additional lock is required.
-  int64_t index =
-      std::atomic_fetch_add(monotonic_counter_, static_cast<int64_t>(list.size()));
+  // The indexes are picked without reading the list, so appends and prepends are blind writes.
+  int64_t index = AllocateListIndexes(list.size());
   if (extend_order == ListExtendOrder::APPEND) {
     for (size_t i = 0; i < list.size(); i++) {
       DocPath child_doc_path = doc_path;
@@ -314,6 +311,22 @@ Status DocWriteBatch::ExtendList(
   return Status::OK();
 }
 
+int64_t DocWriteBatch::AllocateListIndexes(size_t count) {
+  // monotonic_counter_ only survives restarts and leader changes through the last value found in
+  // the Raft log, so the indexes are also kept at or above the physical time of the list index
+  // floor. That time is later than any earlier write to the list and goes up by one per
+  // microsecond, so in practice the counter only moves ahead of it during large bursts of appends.
+  const int64_t min_index = list_index_floor_.is_valid()
+      ? static_cast<int64_t>(list_index_floor_.GetPhysicalValueMicros()) : 0;
+  int64_t index = monotonic_counter_->load(std::memory_order_acquire);
+  int64_t start;
+  do {
+    start = std::max(index, min_index);
+  } while (!monotonic_counter_->compare_exchange_weak(
+      index, start + static_cast<int64_t>(count), std::memory_order_acq_rel));
+  return start;
+}
+
 Status DocWriteBatch::ReplaceInList(
     const DocPath &doc_path,
     const vector<int>& indexes,
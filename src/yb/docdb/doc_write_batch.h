@@ -14,6 +14,7 @@
 #ifndef YB_DOCDB_DOC_WRITE_BATCH_H
 #define YB_DOCDB_DOC_WRITE_BATCH_H
 
+#include "yb/common/hybrid_time.h"
 #include "yb/docdb/doc_path.h"
 #include "yb/docdb/doc_write_batch_cache.h"
 #include "yb/docdb/subdocument.h"
@@ -87,6 +88,10 @@ class DocWriteBatch {
       MonoDelta ttl = Value::kMaxTtl,
       UserTimeMicros user_timestamp = Value::kInvalidUserTimestamp);
 
+  // Sets the hybrid time at which the list element indexes picked by ExtendList start, see
+  // AllocateListIndexes.
+  void SetListIndexFloor(HybridTime hybrid_time) { list_index_floor_ = hybrid_time; }
+
   CHECKED_STATUS ExtendList(
       const DocPath& doc_path,
       const SubDocument& value,
@@ -151,6 +156,9 @@ class DocWriteBatch {
   Result<bool> SetPrimitiveInternalHandleUserTimestamp(const Value &value,
                                                        InternalDocIterator* doc_iter);
 
+  // Reserves count consecutive list element indexes and returns the one before the first of them.
+  int64_t AllocateListIndexes(size_t count);
+
   bool required_init_markers() {
     return init_marker_behavior_ == InitMarkerBehavior::kRequired;
   }
@@ -165,6 +173,7 @@ class DocWriteBatch {
 
   const InitMarkerBehavior init_marker_behavior_;
   std::atomic<int64_t>* monotonic_counter_;
+  HybridTime list_index_floor_;
   std::vector<std::pair<std::string, std::string>> put_batch_;
 
   int num_rocksdb_seeks_;
@@ -22,8 +22,6 @@
 #include "yb/docdb/primitive_value.h"
 #include "yb/util/bytes_formatter.h"
 
-using std::back_inserter;
-using std::copy;
 using std::endl;
 using std::ostringstream;
 using std::pair;
@@ -37,6 +35,12 @@ using yb::util::FormatBytesAsStr;
 namespace yb {
 namespace docdb {
 
+DocWriteBatchCache::DocWriteBatchCache()
+    : arena_(new Arena()),
+      prefix_to_gen_ht_(0, Slice::Hash(), std::equal_to<Slice>(),
+                        ArenaAllocator<PrefixMap::value_type>(arena_.get())) {
+}
+
 void DocWriteBatchCache::Put(const KeyBytes& key_bytes,
                              DocHybridTime gen_ht,
                              ValueType value_type,
@@ -47,13 +51,19 @@ void DocWriteBatchCache::Put(const KeyBytes& key_bytes,
       BestEffortDocDBKeyToStr(key_bytes),
       gen_ht.ToString(),
       ToString(value_type));
-  prefix_to_gen_ht_[key_bytes.AsStringRef()] =
-      {gen_ht, value_type, user_timestamp, found_exact_key_prefix};
+  const Entry entry = {gen_ht, value_type, user_timestamp, found_exact_key_prefix};
+  auto iter = prefix_to_gen_ht_.find(key_bytes.AsSlice());
+  if (iter != prefix_to_gen_ht_.end()) {
+    iter->second = entry;
+    return;
+  }
+  const Slice key(arena_->AddSlice(key_bytes.AsSlice()), key_bytes.size());
+  prefix_to_gen_ht_.emplace(key, entry);
 }
 
 boost::optional<DocWriteBatchCache::Entry> DocWriteBatchCache::Get(
     const KeyBytes& encoded_key_prefix) {
-  auto iter = prefix_to_gen_ht_.find(encoded_key_prefix.AsStringRef());
+  auto iter = prefix_to_gen_ht_.find(encoded_key_prefix.AsSlice());
 #ifdef DOCDB_DEBUG
   if (iter == prefix_to_gen_ht_.end()) {
     DOCDB_DEBUG_LOG("DocWriteBatchCache contained no entry for $0",
@@ -68,7 +78,9 @@ boost::optional<DocWriteBatchCache::Entry> DocWriteBatchCache::Get(
 
 string DocWriteBatchCache::ToDebugString() {
   vector<pair<string, Entry>> sorted_contents;
-  copy(prefix_to_gen_ht_.begin(), prefix_to_gen_ht_.end(), back_inserter(sorted_contents));
+  for (const auto& kv : prefix_to_gen_ht_) {
+    sorted_contents.emplace_back(kv.first.ToBuffer(), kv.second);
+  }
   sort(sorted_contents.begin(), sorted_contents.end());
   ostringstream ss;
   ss << "DocWriteBatchCache[" << endl;
@@ -94,7 +106,11 @@ string DocWriteBatchCache::EntryToStr(const Entry& entry) {
 }
 
 void DocWriteBatchCache::Clear() {
-  prefix_to_gen_ht_.clear();
+  // The buckets of the map are allocated in the arena as well, so release them before resetting
+  // it, by swapping in an empty map.
+  PrefixMap(0, Slice::Hash(), std::equal_to<Slice>(), prefix_to_gen_ht_.get_allocator()).swap(
+      prefix_to_gen_ht_);
+  arena_->Reset();
 }
 
 }  // namespace docdb
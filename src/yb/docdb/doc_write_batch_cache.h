@@ -14,7 +14,7 @@
 #ifndef YB_DOCDB_DOC_WRITE_BATCH_CACHE_H_
 #define YB_DOCDB_DOC_WRITE_BATCH_CACHE_H_
 
-#include <unordered_map>
+#include <memory>
 #include <string>
 
 #include <boost/optional.hpp>
@@ -23,6 +23,8 @@
 #include "yb/docdb/key_bytes.h"
 #include "yb/docdb/value_type.h"
 #include "yb/docdb/value.h"
+#include "yb/util/memory/arena.h"
+#include "yb/util/memory/mc_types.h"
 
 namespace yb {
 namespace docdb {
@@ -34,6 +36,8 @@ namespace docdb {
 // This class is not thread-safe.
 class DocWriteBatchCache {
  public:
+  DocWriteBatchCache();
+
   struct Entry {
     DocHybridTime doc_hybrid_time;
     ValueType value_type;
@@ -57,7 +61,6 @@ class DocWriteBatchCache {
 
   // Returns the latest generation hybrid_time for the document/subdocument identified by the given
   // encoded key prefix.
-  // TODO: switch to taking a slice as an input to avoid making a copy on lookup.
   boost::optional<Entry> Get(const KeyBytes& encoded_key_prefix);
 
   std::string ToDebugString();
@@ -67,7 +70,13 @@ class DocWriteBatchCache {
   void Clear();
 
  private:
-  std::unordered_map<std::string, Entry> prefix_to_gen_ht_;
+  typedef MCUnorderedMap<Slice, Entry, Slice::Hash> PrefixMap;
+
+  // The cached key prefixes and the map itself are allocated in this arena, so caching a prefix
+  // does not allocate memory on the heap per key, and all of it is freed at once. It is kept on
+  // the heap so that the cache stays movable.
+  std::unique_ptr<Arena> arena_;
+  PrefixMap prefix_to_gen_ht_;
 };
 
 
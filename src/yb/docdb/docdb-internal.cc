@@ -24,6 +24,9 @@ KeyType GetKeyType(const Slice& slice) {
     if (slice.size() > 1 && slice[1] == static_cast<char>(ValueType::kTransactionId)) {
       if (slice.size() == TransactionId::static_size() + 2) {
         return KeyType::kTransactionMetadata;
+      } else if (slice.size() == TransactionId::static_size() + 3 &&
+                 slice[slice.size() - 1] == static_cast<char>(ValueType::kGroupEnd)) {
+        return KeyType::kTransactionApplyState;
       } else {
         return KeyType::kReverseTxnKey;
       }
@@ -15,16 +15,21 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 
 #include "yb/rocksdb/db.h"
 #include "yb/rocksdb/status.h"
+#include "yb/rocksdb/table_properties.h"
 #include "yb/rocksdb/util/statistics.h"
 
 #include "yb/common/hybrid_time.h"
 #include "yb/docdb/docdb-internal.h"
 #include "yb/docdb/docdb_compaction_filter.h"
+#include "yb/docdb/docdb_rocksdb_util.h"
+#include "yb/docdb/doc_write_batch_cache.h"
 #include "yb/docdb/docdb_test_base.h"
 #include "yb/docdb/docdb_test_util.h"
+#include "yb/docdb/doc_ql_scanspec.h"
 #include "yb/docdb/in_mem_docdb.h"
 #include "yb/docdb/intent.h"
 #include "yb/gutil/stringprintf.h"
@@ -55,7 +60,10 @@ using rocksdb::WriteOptions;
 using namespace std::chrono_literals;
 
 DECLARE_bool(use_docdb_aware_bloom_filter);
+DECLARE_bool(docdb_column_zone_maps);
+DECLARE_bool(redis_hash_indexed_sst_files);
 DECLARE_int32(max_nexts_to_avoid_seek);
+DECLARE_int32(max_adaptive_nexts_to_avoid_seek);
 
 namespace yb {
 namespace docdb {
@@ -841,6 +849,31 @@ SubDocKey(DocKey([], ["list_test", 231]), ["other"; \
         )#");
 }
 
+TEST_F(DocDBTest, ListIndexFloor) {
+  const DocKey doc_key(PrimitiveValues("k"));
+  const DocPath list_path(doc_key.Encode(), PrimitiveValue("l"));
+  const auto append = [this, &list_path](int micros, const SubDocument& elements) -> Status {
+    auto dwb = MakeDocWriteBatch();
+    dwb.SetListIndexFloor(HybridTime::FromMicros(micros));
+    RETURN_NOT_OK(dwb.ExtendList(list_path, elements));
+    return WriteToRocksDB(dwb, HybridTime::FromMicros(micros));
+  };
+
+  ASSERT_OK(append(5000, SubDocument({PrimitiveValue(1), PrimitiveValue(2)})));
+  // Losing the counter, e.g. on a restart, does not move the indexes back.
+  monotonic_counter().store(0);
+  ASSERT_OK(append(6000, SubDocument({PrimitiveValue(3)})));
+  // A floor behind the counter does not either.
+  ASSERT_OK(append(6000, SubDocument({PrimitiveValue(4)})));
+
+  AssertDocDbDebugDumpStrEq(R"#(
+SubDocKey(DocKey([], ["k"]), ["l", ArrayIndex(5001); HT{ physical: 5000 }]) -> 1
+SubDocKey(DocKey([], ["k"]), ["l", ArrayIndex(5002); HT{ physical: 5000 w: 1 }]) -> 2
+SubDocKey(DocKey([], ["k"]), ["l", ArrayIndex(6001); HT{ physical: 6000 }]) -> 3
+SubDocKey(DocKey([], ["k"]), ["l", ArrayIndex(6002); HT{ physical: 6000 }]) -> 4
+      )#");
+}
+
 TEST_F(DocDBTest, ExpiredValueCompactionTest) {
   const DocKey doc_key(PrimitiveValues("k1"));
   const MonoDelta one_ms = 1ms;
@@ -1399,6 +1432,95 @@ TEST_F_EX(DocDBTest, BoundaryValuesMultiFiles, DocDBTestBoundaryValues) {
   TestBoundaryValues(350);
 }
 
+TEST_F(DocDBTest, ColumnZoneMaps) {
+  FLAGS_docdb_column_zone_maps = true;
+  const ColumnId kColumn(10);
+  const ColumnId kOtherColumn(11);
+  auto set_value = [this, kColumn](int key, int64_t value) {
+    const auto doc_key = DocKey(PrimitiveValues("key_" + std::to_string(key))).Encode();
+    return SetPrimitive(DocPath(doc_key, PrimitiveValue(kColumn)), PrimitiveValue(value),
+                        HybridTime::FromMicros(1000 + key));
+  };
+  auto may_exist = [this](ColumnId column_id, int64_t lower, int64_t upper) {
+    ColumnValueBounds bounds = { column_id, KeyBytes(), KeyBytes() };
+    PrimitiveValue(lower).AppendToKey(&bounds.lower);
+    PrimitiveValue(upper).AppendToKey(&bounds.upper);
+    return ColumnValuesMayExist(rocksdb(), { bounds });
+  };
+
+  for (int i = 1; i != 10; ++i) {
+    ASSERT_OK(set_value(i, i));
+  }
+  ASSERT_OK(FlushRocksDB());
+  for (int i = 20; i != 30; ++i) {
+    ASSERT_OK(set_value(i, i));
+  }
+  ASSERT_OK(FlushRocksDB());
+
+  ASSERT_TRUE(may_exist(kColumn, 5, 5));
+  ASSERT_TRUE(may_exist(kColumn, 25, 40));
+  ASSERT_FALSE(may_exist(kColumn, 12, 18));
+  ASSERT_FALSE(may_exist(kColumn, 40, 50));
+  ASSERT_FALSE(may_exist(kOtherColumn, 0, 100));
+
+  // The records in the memtable are not covered.
+  ASSERT_OK(set_value(15, 15));
+  ASSERT_TRUE(may_exist(kColumn, 12, 18));
+  ASSERT_TRUE(may_exist(kColumn, 40, 50));
+  ASSERT_OK(FlushRocksDB());
+  ASSERT_TRUE(may_exist(kColumn, 12, 18));
+  ASSERT_FALSE(may_exist(kColumn, 40, 50));
+
+  // Compactions keep the zone maps.
+  ASSERT_OK(FullyCompactDB(rocksdb()));
+  ASSERT_TRUE(may_exist(kColumn, 12, 18));
+  ASSERT_FALSE(may_exist(kColumn, 40, 50));
+
+  // A file written without the zone maps could contain any value.
+  FLAGS_docdb_column_zone_maps = false;
+  ASSERT_OK(set_value(100, 100));
+  ASSERT_OK(FlushRocksDB());
+  ASSERT_TRUE(may_exist(kColumn, 40, 50));
+  ASSERT_TRUE(may_exist(kOtherColumn, 0, 100));
+}
+
+TEST_F(DocDBTest, HashIndexedPointLookups) {
+  FLAGS_redis_hash_indexed_sst_files = true;
+  InitPointLookupRocksDBOptions(&rocksdb_options_);
+  ASSERT_OK(ReopenRocksDB());
+
+  const auto key = [](int i) {
+    return DocKey(i * 1000, PrimitiveValues("key_" + std::to_string(i)), PrimitiveValues());
+  };
+  for (int i = 0; i != 10; ++i) {
+    if (i == 5) {
+      continue;
+    }
+    ASSERT_OK(SetPrimitive(DocPath(key(i).Encode()), PrimitiveValue("value"),
+                           HybridTime::FromMicros(1000 + i)));
+  }
+  ASSERT_OK(FlushRocksDB());
+
+  for (int i = 0; i != 10; ++i) {
+    SubDocKey subdoc_key(key(i));
+    SubDocument doc;
+    bool found = false;
+    GetSubDocumentData data = { &subdoc_key, &doc, &found };
+    ASSERT_OK(GetSubDocument(
+        rocksdb(), data, rocksdb::kDefaultQueryId, boost::none /* txn_op_context */));
+    ASSERT_EQ(i != 5, found) << i;
+  }
+
+  // Scans that are not bound to a DocKey still see every key in order.
+  auto iter = CreateRocksDBIterator(
+      rocksdb(), BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none, rocksdb::kDefaultQueryId);
+  int num_keys = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    ++num_keys;
+  }
+  ASSERT_EQ(9, num_keys);
+}
+
 TEST_F(DocDBTest, BloomFilterTest) {
   // Turn off "next instead of seek" optimization, because this test rely on DocDB to do seeks.
   FLAGS_max_nexts_to_avoid_seek = 0;
@@ -1497,6 +1619,142 @@ TEST_F(DocDBTest, BloomFilterTest) {
   ASSERT_NO_FATALS(CheckBloom(2, &total_bloom_useful, 2, &total_table_iterators));
 }
 
+TEST_F(DocDBTest, HybridTimeFileFilter) {
+  auto dwb = MakeDocWriteBatch();
+  DocKey key(0, PrimitiveValues("key"), PrimitiveValues());
+  // Every write goes to its own SST file.
+  for (uint64_t time : {1000, 2000, 3000}) {
+    dwb.Clear();
+    ASSERT_OK(dwb.SetPrimitive(DocPath(key.Encode()), PrimitiveValue("value")));
+    ASSERT_OK(WriteToRocksDB(dwb, HybridTime::FromMicros(time)));
+    ASSERT_OK(FlushRocksDB());
+  }
+
+  auto count_records = [this](HybridTime min_hybrid_time, HybridTime max_hybrid_time) {
+    auto iter = CreateRocksDBIterator(
+        rocksdb(), BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none, rocksdb::kDefaultQueryId,
+        CreateHybridTimeFileFilter(min_hybrid_time, max_hybrid_time));
+    int result = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ++result;
+    }
+    return result;
+  };
+
+  ASSERT_EQ(3, count_records(HybridTime::kMin, HybridTime::kMax));
+  ASSERT_EQ(1, count_records(HybridTime::kMin, HybridTime::FromMicros(1500)));
+  ASSERT_EQ(2, count_records(HybridTime::FromMicros(2000), HybridTime::kMax));
+  ASSERT_EQ(1, count_records(HybridTime::FromMicros(1500), HybridTime::FromMicros(2500)));
+  ASSERT_EQ(0, count_records(HybridTime::FromMicros(1500), HybridTime::FromMicros(1600)));
+}
+
+TEST_F(DocDBTest, DeleteExpiredFiles) {
+  const MonoDelta one_ms = 1ms;
+  const HybridTime t0 = HybridTime::FromMicros(1000);
+  const HybridTime t1 = server::HybridClock::AddPhysicalTimeToHybridTime(t0, one_ms);
+  const HybridTime t2 = server::HybridClock::AddPhysicalTimeToHybridTime(t1, one_ms);
+  const HybridTime t3 = server::HybridClock::AddPhysicalTimeToHybridTime(t2, one_ms);
+  const HybridTime t4 = server::HybridClock::AddPhysicalTimeToHybridTime(t3, one_ms);
+  SetTableTTL(1);
+
+  // Every write goes to its own SST file, the one of k2 never expires.
+  auto write_file = [this](const char* key, const Value& value, HybridTime hybrid_time) {
+    ASSERT_OK(SetPrimitive(DocPath(DocKey(PrimitiveValues(key)).Encode()), value, hybrid_time));
+    ASSERT_OK(FlushRocksDB());
+  };
+  write_file("k1", Value(PrimitiveValue("v1")), t0);
+  write_file("k2", Value(PrimitiveValue("v2"), 0ms), t1);
+  write_file("k3", Value(PrimitiveValue("v3")), t2);
+
+  auto num_files = [this] {
+    std::vector<rocksdb::LiveFileMetaData> files;
+    rocksdb()->GetLiveFilesMetaData(&files);
+    return files.size();
+  };
+  ASSERT_EQ(3, num_files());
+
+  // Only the file of k1 is deleted, the file of k3 is newer than the file of k2, that is kept.
+  SetHistoryCutoffHybridTime(t4);
+  write_file("k4", Value(PrimitiveValue("v4")), t4);
+  ASSERT_OK(WaitFor([&num_files]() -> Result<bool> { return num_files() == 3; },
+                    10s, "Expired file deleted"));
+  AssertDocDbDebugDumpStrEq(R"#(
+      SubDocKey(DocKey([], ["k2"]), [HT{ physical: 2000 }]) -> "v2"; ttl: 0.000s
+      SubDocKey(DocKey([], ["k3"]), [HT{ physical: 3000 }]) -> "v3"
+      SubDocKey(DocKey([], ["k4"]), [HT{ physical: 5000 }]) -> "v4"
+      )#");
+}
+
+TEST_F(DocDBTest, DocDBTableProperties) {
+  const KeyBytes key1(DocKey(20, PrimitiveValues("k1"), PrimitiveValues()).Encode());
+  const KeyBytes key2(DocKey(10, PrimitiveValues("k2"), PrimitiveValues()).Encode());
+  const HybridTime ht = HybridTime::FromMicros(1000);
+  ASSERT_OK(SetPrimitive(DocPath(key1, PrimitiveValue(ColumnId(2))),
+                         Value(PrimitiveValue("v")), ht));
+  ASSERT_OK(SetPrimitive(DocPath(key2, PrimitiveValue(ColumnId(0))),
+                         Value(PrimitiveValue("v"), 10s), ht));
+  ASSERT_OK(FlushRocksDB());
+  ASSERT_OK(SetPrimitive(DocPath(key1, PrimitiveValue(ColumnId(1))),
+                         Value(PrimitiveValue("v")), ht));
+  ASSERT_OK(DeleteSubDoc(DocPath(key1, PrimitiveValue(ColumnId(2))), ht));
+  ASSERT_OK(FlushRocksDB());
+
+  rocksdb::TablePropertiesCollection properties;
+  ASSERT_OK(rocksdb()->GetPropertiesOfAllTables(&properties));
+  std::vector<DocDBTableProperties> files_properties;
+  for (const auto& file_and_properties : properties) {
+    DocDBTableProperties docdb_properties;
+    ASSERT_TRUE(GetDocDBTableProperties(*file_and_properties.second, &docdb_properties));
+    files_properties.push_back(docdb_properties);
+  }
+  ASSERT_EQ(2, files_properties.size());
+  // The first file is the one with the TTL value.
+  if (files_properties[0].num_ttl_values == 0) {
+    std::swap(files_properties[0], files_properties[1]);
+  }
+
+  ASSERT_EQ(ColumnIds({ColumnId(0), ColumnId(2)}), files_properties[0].column_ids);
+  ASSERT_TRUE(files_properties[0].has_hash_codes);
+  ASSERT_EQ(10, files_properties[0].min_hash_code);
+  ASSERT_EQ(20, files_properties[0].max_hash_code);
+  ASSERT_EQ(0, files_properties[0].num_tombstones);
+  ASSERT_EQ(1, files_properties[0].num_ttl_values);
+  ASSERT_EQ(0, files_properties[0].num_intents);
+
+  ASSERT_EQ(ColumnIds({ColumnId(1), ColumnId(2)}), files_properties[1].column_ids);
+  ASSERT_TRUE(files_properties[1].has_hash_codes);
+  ASSERT_EQ(20, files_properties[1].min_hash_code);
+  ASSERT_EQ(20, files_properties[1].max_hash_code);
+  ASSERT_EQ(1, files_properties[1].num_tombstones);
+  ASSERT_EQ(0, files_properties[1].num_ttl_values);
+}
+
+TEST_F(DocDBTest, RestoreToHybridTime) {
+  auto set_value = [this](const char* key, const char* value, uint64_t time) {
+    ASSERT_OK(SetPrimitive(DocPath(DocKey(PrimitiveValues(key)).Encode()),
+                           Value(PrimitiveValue(value)), HybridTime::FromMicros(time)));
+  };
+  set_value("k1", "v1", 1000);
+  set_value("k1", "v2", 2000);
+  set_value("k2", "v1", 1500);
+  ASSERT_OK(FlushRocksDB());
+  set_value("k1", "v3", 3000);
+  ASSERT_OK(DeleteSubDoc(DocPath(DocKey(PrimitiveValues("k2")).Encode()),
+                         HybridTime::FromMicros(2500)));
+  set_value("k3", "v1", 3000);
+
+  // The records after HT 2000 are removed, the history before it is kept.
+  SetRestoreHybridTime(HybridTime::FromMicros(2000));
+  ASSERT_OK(FlushRocksDB());
+  ASSERT_OK(FullyCompactDB(rocksdb()));
+  SetRestoreHybridTime(HybridTime::kInvalidHybridTime);
+  AssertDocDbDebugDumpStrEq(R"#(
+      SubDocKey(DocKey([], ["k1"]), [HT{ physical: 2000 }]) -> "v2"
+      SubDocKey(DocKey([], ["k1"]), [HT{ physical: 1000 }]) -> "v1"
+      SubDocKey(DocKey([], ["k2"]), [HT{ physical: 1500 }]) -> "v1"
+      )#");
+}
+
 TEST_F(DocDBTest, MergingIterator) {
   // Test for the case described in https://yugabyte.atlassian.net/browse/ENG-1677.
 
@@ -1716,6 +1974,64 @@ SubDocKey(DocKey(0x0000, ["h1"], ["r2"]), ["c8"; HT{ physical: 1000 }]) -> "v82"
       )#");
 }
 
+TEST_F(DocDBTest, CounterDeltas) {
+  const DocKey doc_key(PrimitiveValues("k1"));
+  const KeyBytes encoded_doc_key(doc_key.Encode());
+  const auto column_path = [&encoded_doc_key](int column) {
+    return DocPath(encoded_doc_key, PrimitiveValue(ColumnId(column)));
+  };
+  const auto verify_column = [this, &doc_key](int column, int micros, const string& expected) {
+    VerifySubDocument(SubDocKey(doc_key, PrimitiveValue(ColumnId(column))),
+                      HybridTime::FromMicros(micros), expected);
+  };
+
+  // Column 0 has an absolute value under its deltas, column 1 only has deltas and column 2 was
+  // deleted in between.
+  ASSERT_OK(SetPrimitive(column_path(0), Value(PrimitiveValue(static_cast<int64_t>(10))),
+                         HybridTime::FromMicros(1000)));
+  ASSERT_OK(SetPrimitive(column_path(0), Value(PrimitiveValue::CounterDelta(5)),
+                         HybridTime::FromMicros(2000)));
+  ASSERT_OK(SetPrimitive(column_path(0), Value(PrimitiveValue::CounterDelta(-2)),
+                         HybridTime::FromMicros(3000)));
+  ASSERT_OK(SetPrimitive(column_path(1), Value(PrimitiveValue::CounterDelta(3)),
+                         HybridTime::FromMicros(1000)));
+  ASSERT_OK(SetPrimitive(column_path(1), Value(PrimitiveValue::CounterDelta(4)),
+                         HybridTime::FromMicros(2000)));
+  ASSERT_OK(SetPrimitive(column_path(2), Value(PrimitiveValue::CounterDelta(1)),
+                         HybridTime::FromMicros(1000)));
+  ASSERT_OK(SetPrimitive(column_path(2), Value(PrimitiveValue::kTombstone),
+                         HybridTime::FromMicros(2000)));
+  ASSERT_OK(SetPrimitive(column_path(2), Value(PrimitiveValue::CounterDelta(2)),
+                         HybridTime::FromMicros(3000)));
+
+  const auto verify_counters = [&verify_column] {
+    verify_column(0, 1500, "10");
+    verify_column(0, 2500, "15");
+    verify_column(0, 3500, "13");
+    verify_column(1, 1500, "3");
+    verify_column(1, 2500, "7");
+    verify_column(2, 1500, "1");
+    verify_column(2, 2500, "");
+    verify_column(2, 3500, "2");
+  };
+  verify_counters();
+
+  // Deltas do not overwrite the older values of a counter, only the tombstone and what it deleted
+  // are compacted away.
+  CompactHistoryBefore(HybridTime::FromMicros(2500));
+  AssertDocDbDebugDumpStrEq(R"#(
+SubDocKey(DocKey([], ["k1"]), [ColumnId(0); HT{ physical: 3000 }]) -> CounterDelta(-2)
+SubDocKey(DocKey([], ["k1"]), [ColumnId(0); HT{ physical: 2000 }]) -> CounterDelta(5)
+SubDocKey(DocKey([], ["k1"]), [ColumnId(0); HT{ physical: 1000 }]) -> 10
+SubDocKey(DocKey([], ["k1"]), [ColumnId(1); HT{ physical: 2000 }]) -> CounterDelta(4)
+SubDocKey(DocKey([], ["k1"]), [ColumnId(1); HT{ physical: 1000 }]) -> CounterDelta(3)
+SubDocKey(DocKey([], ["k1"]), [ColumnId(2); HT{ physical: 3000 }]) -> CounterDelta(2)
+      )#");
+  verify_column(0, 3500, "13");
+  verify_column(1, 2500, "7");
+  verify_column(2, 3500, "2");
+}
+
 TEST_F(DocDBTest, TestUserTimestamp) {
   const DocKey doc_key(PrimitiveValues("k1"));
   KeyBytes encoded_doc_key(doc_key.Encode());
@@ -2037,5 +2353,66 @@ TEST_F(DocDBTest, TestCompactionForCollectionsWithTTL) {
   }
 }
 
+TEST(NextOrSeekPolicyTest, Adapts) {
+  FLAGS_max_nexts_to_avoid_seek = 8;
+  NextOrSeekPolicy policy;
+  ASSERT_EQ(8, policy.max_nexts());
+
+  // Targets reached close to the limit make it grow, up to max_adaptive_nexts_to_avoid_seek.
+  for (int i = 0; i != 10; ++i) {
+    policy.Record(policy.max_nexts(), false /* seeked */);
+  }
+  ASSERT_EQ(FLAGS_max_adaptive_nexts_to_avoid_seek, policy.max_nexts());
+
+  // Nearby targets don't change the limit.
+  policy.Record(1, false /* seeked */);
+  ASSERT_EQ(FLAGS_max_adaptive_nexts_to_avoid_seek, policy.max_nexts());
+
+  // Exhausted limits make it shrink.
+  for (int i = 0; i != 10; ++i) {
+    policy.Record(policy.max_nexts(), true /* seeked */);
+  }
+  ASSERT_EQ(1, policy.max_nexts());
+  ASSERT_EQ(10, policy.num_seeks());
+
+  // After a while the limit is reset to max_nexts_to_avoid_seek.
+  for (int i = 0; i != 32; ++i) {
+    policy.Record(0, false /* seeked */);
+  }
+  ASSERT_EQ(8, policy.max_nexts());
+}
+
+TEST(DocWriteBatchCacheTest, PutGetClear) {
+  DocWriteBatchCache cache;
+  const KeyBytes key1(DocKey(PrimitiveValues("a", 1)).Encode());
+  const KeyBytes key2(DocKey(PrimitiveValues("b", 2)).Encode());
+  const DocHybridTime ht1(HybridTime::FromMicros(1000), 0);
+  const DocHybridTime ht2(HybridTime::FromMicros(2000), 0);
+
+  ASSERT_FALSE(cache.Get(key1));
+  cache.Put(key1, ht1, ValueType::kObject);
+  cache.Put(key2, ht1, ValueType::kTombstone);
+  cache.Put(key1, ht2, ValueType::kObject);
+
+  auto entry = cache.Get(key1);
+  ASSERT_TRUE(entry);
+  ASSERT_EQ(ht2, entry->doc_hybrid_time);
+  ASSERT_EQ(ValueType::kObject, entry->value_type);
+  entry = cache.Get(key2);
+  ASSERT_TRUE(entry);
+  ASSERT_EQ(ht1, entry->doc_hybrid_time);
+  ASSERT_EQ(ValueType::kTombstone, entry->value_type);
+
+  cache.Clear();
+  ASSERT_FALSE(cache.Get(key1));
+  ASSERT_FALSE(cache.Get(key2));
+
+  // The cache is usable after its arena was reset.
+  cache.Put(key2, ht2, ValueType::kObject);
+  entry = cache.Get(key2);
+  ASSERT_TRUE(entry);
+  ASSERT_EQ(ht2, entry->doc_hybrid_time);
+}
+
 }  // namespace docdb
 }  // namespace yb
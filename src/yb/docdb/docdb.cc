@@ -18,6 +18,8 @@
 #include <unordered_map>
 #include <vector>
 
+#include <boost/optional.hpp>
+
 #include "yb/common/hybrid_time.h"
 #include "yb/common/redis_protocol.pb.h"
 #include "yb/common/transaction.h"
@@ -30,7 +32,9 @@
 #include "yb/docdb/docdb_util.h"
 #include "yb/docdb/intent.h"
 #include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/intent_filter.h"
 #include "yb/docdb/internal_doc_iterator.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/docdb/shared_lock_manager.h"
 #include "yb/docdb/subdocument.h"
 #include "yb/docdb/value.h"
@@ -154,6 +158,7 @@ Status ExecuteDocWriteOperation(const vector<unique_ptr<DocOperation>>& doc_writ
                                 HybridTime* restart_read_ht) {
   DCHECK_ONLY_NOTNULL(restart_read_ht);
   DocWriteBatch doc_write_batch(rocksdb, init_marker_behavior, monotonic_counter);
+  doc_write_batch.SetListIndexFloor(read_time.read);
   DocOperationApplyData data = {&doc_write_batch, read_time, restart_read_ht};
   for (const unique_ptr<DocOperation>& doc_op : doc_write_ops) {
     RETURN_NOT_OK(doc_op->Apply(data));
@@ -248,11 +253,13 @@ class PrepareTransactionWriteBatchHelper {
   PrepareTransactionWriteBatchHelper(HybridTime hybrid_time,
                                      rocksdb::WriteBatch* rocksdb_write_batch,
                                      const TransactionId& transaction_id,
-                                     IsolationLevel isolation_level)
+                                     IsolationLevel isolation_level,
+                                     IntentFilter* intent_filter)
       : hybrid_time_(hybrid_time),
         rocksdb_write_batch_(rocksdb_write_batch),
         transaction_id_(transaction_id),
-        intent_types_(GetWriteIntentsForIsolationLevel(isolation_level)) {
+        intent_types_(GetWriteIntentsForIsolationLevel(isolation_level)),
+        intent_filter_(intent_filter) {
   }
 
   // Using operator() to pass this object conveniently to EnumerateIntents.
@@ -280,6 +287,9 @@ class PrepareTransactionWriteBatchHelper {
         doc_ht_buffer.EncodeWithValueType(hybrid_time_, write_id_++),
     }};
     AddIntent(transaction_id_, key_parts, value, rocksdb_write_batch_);
+    if (intent_filter_) {
+      intent_filter_->Add(key->AsSlice());
+    }
 
     return Status::OK();
   }
@@ -304,6 +314,9 @@ class PrepareTransactionWriteBatchHelper {
       }};
 
       AddIntent(transaction_id_, key, value, rocksdb_write_batch_);
+      if (intent_filter_) {
+        intent_filter_->Add(intent);
+      }
     }
   }
 
@@ -316,6 +329,7 @@ class PrepareTransactionWriteBatchHelper {
   IntentTypePair intent_types_;
   std::unordered_set<std::string> weak_intents_;
   IntraTxnWriteId write_id_ = 0;
+  IntentFilter* intent_filter_;
 };
 
 // We have the following distinct types of data in this "intent store":
@@ -333,9 +347,10 @@ void PrepareTransactionWriteBatch(
     HybridTime hybrid_time,
     rocksdb::WriteBatch* rocksdb_write_batch,
     const TransactionId& transaction_id,
-    IsolationLevel isolation_level) {
+    IsolationLevel isolation_level,
+    IntentFilter* intent_filter) {
   PrepareTransactionWriteBatchHelper helper(
-      hybrid_time, rocksdb_write_batch, transaction_id, isolation_level);
+      hybrid_time, rocksdb_write_batch, transaction_id, isolation_level, intent_filter);
 
   // We cannot recover from failures here, because it means that we cannot apply replicated
   // operation.
@@ -358,6 +373,29 @@ void SeekToLowerBound(const SubDocKeyBound& lower_bound, IntentAwareIterator* it
   }
 }
 
+// Sets the remaining TTL and the write time of a primitive value written at write_time, as seen by
+// a read at read_ht. The user supplied timestamp is used as the write time when present.
+void SetTtlAndWriteTime(const MonoDelta& ttl, const DocHybridTime& write_time, HybridTime read_ht,
+                        Value* doc_value) {
+  if (ttl.Equals(Value::kMaxTtl)) {
+    doc_value->mutable_primitive_value()->SetTtl(-1);
+  } else {
+    int64_t time_since_write_seconds = (
+        server::HybridClock::GetPhysicalValueMicros(read_ht) -
+        server::HybridClock::GetPhysicalValueMicros(write_time.hybrid_time())) /
+        MonoTime::kMicrosecondsPerSecond;
+    int64_t ttl_seconds = std::max(static_cast<int64_t>(0),
+        ttl.ToMilliseconds() / MonoTime::kMillisecondsPerSecond - time_since_write_seconds);
+    doc_value->mutable_primitive_value()->SetTtl(ttl_seconds);
+  }
+
+  const UserTimeMicros user_timestamp = doc_value->user_timestamp();
+  doc_value->mutable_primitive_value()->SetWritetime(
+      user_timestamp == Value::kInvalidUserTimestamp
+          ? write_time.hybrid_time().GetPhysicalValueMicros()
+          : user_timestamp);
+}
+
 // This works similar to the ScanSubDocument function, but doesn't assume that object init_markers
 // are present. If no init marker is present, or if a tombstone is found at some level,
 // it still looks for subkeys inside it if they have larger timestamps.
@@ -377,6 +415,19 @@ CHECKED_STATUS BuildSubDocument(
   VLOG(3) << "BuildSubDocument data: " << data << " read_time: " << iter->read_time()
           << " low_ts: " << low_ts;
   const KeyBytes encoded_key = data.subdocument_key->Encode();
+  // Whether data.result has been filled from a packed row, whose columns could be deleted by later
+  // column records.
+  bool packed_row_found = false;
+  // The sum of the counter deltas found so far, newest first, and the TTL and write time of the
+  // newest one. Counter tables only take updates, so the deltas never apply to a packed row.
+  boost::optional<int64_t> counter_sum;
+  MonoDelta counter_ttl;
+  DocHybridTime counter_write_time;
+  auto set_counter_result = [&](int64_t base) {
+    Value counter(PrimitiveValue(base + *counter_sum));
+    SetTtlAndWriteTime(counter_ttl, counter_write_time, iter->read_time().read, &counter);
+    *data.result = SubDocument(counter.primitive_value());
+  };
   while (iter->valid()) {
     auto iter_key = iter->FetchKey();
     RETURN_NOT_OK(iter_key);
@@ -436,6 +487,57 @@ CHECKED_STATUS BuildSubDocument(
         }
       }
 
+      if (doc_value.value_type() == ValueType::kCounterDelta) {
+        if (!counter_sum) {
+          counter_sum = 0;
+          counter_ttl = ttl;
+          counter_write_time = write_time;
+        }
+        *counter_sum += doc_value.primitive_value().GetCounterDelta();
+        // Move on to the next older version of the counter, which sorts right after this one.
+        KeyBytes next_version(*iter_key);
+        next_version.AppendRawBytes("\0", 1);
+        iter->SeekForwardWithoutHt(next_version.AsSlice());
+        continue;
+      }
+
+      if (counter_sum) {
+        // The deltas are added to the latest absolute value of the counter, if it is still live.
+        int64_t base = 0;
+        if (doc_value.value_type() == ValueType::kInt64) {
+          base = doc_value.primitive_value().GetInt64();
+        } else if (doc_value.value_type() != ValueType::kTombstone) {
+          return STATUS_FORMAT(Corruption,
+              "Expected counter value or tombstone, got $0", doc_value.value_type());
+        }
+        set_counter_result(base);
+        iter->SeekOutOfSubDoc(found_key);
+        return Status::OK();
+      }
+
+      if (doc_value.value_type() == ValueType::kPackedRow) {
+        // A packed row overwrites the whole row, so older records of its columns are skipped like
+        // after a tombstone.
+        if (low_ts < write_time) {
+          low_ts = write_time;
+        }
+        PackedColumns columns;
+        RETURN_NOT_OK(DecodePackedRow(doc_value.primitive_value().GetPackedRow(), &columns));
+        *data.result = SubDocument();
+        packed_row_found = true;
+        for (auto& column : columns) {
+          if (column.second.value_type() == ValueType::kTombstone) {
+            continue;
+          }
+          Value column_value(std::move(column.second), doc_value.ttl(),
+                             doc_value.user_timestamp());
+          SetTtlAndWriteTime(ttl, write_time, iter->read_time().read, &column_value);
+          data.result->SetChild(column.first, SubDocument(column_value.primitive_value()));
+        }
+        iter->SeekPastSubKey(found_key);
+        continue;
+      }
+
       // We have found some key that matches our entire subdocument_key, i.e. we didn't skip ahead
       // to a lower level key (with optional object init markers).
       if (IsCollectionType(doc_value.value_type()) ||
@@ -467,24 +569,7 @@ CHECKED_STATUS BuildSubDocument(
         }
 
         DCHECK_GE(iter->read_time().global_limit, write_time.hybrid_time());
-        if (ttl.Equals(Value::kMaxTtl)) {
-          doc_value.mutable_primitive_value()->SetTtl(-1);
-        } else {
-          int64_t time_since_write_seconds = (
-              server::HybridClock::GetPhysicalValueMicros(iter->read_time().read) -
-              server::HybridClock::GetPhysicalValueMicros(write_time.hybrid_time())) /
-              MonoTime::kMicrosecondsPerSecond;
-          int64_t ttl_seconds = std::max(static_cast<int64_t>(0),
-              ttl.ToMilliseconds() / MonoTime::kMillisecondsPerSecond - time_since_write_seconds);
-          doc_value.mutable_primitive_value()->SetTtl(ttl_seconds);
-        }
-
-        // Choose the user supplied timestamp if present.
-        const UserTimeMicros user_timestamp = doc_value.user_timestamp();
-        doc_value.mutable_primitive_value()->SetWritetime(
-            user_timestamp == Value::kInvalidUserTimestamp
-                ? write_time.hybrid_time().GetPhysicalValueMicros()
-                : doc_value.user_timestamp());
+        SetTtlAndWriteTime(ttl, write_time, iter->read_time().read, &doc_value);
         *data.result = SubDocument(doc_value.primitive_value());
         VLOG(3) << "SeekForward: " << found_key.ToString() << ".AdvanceOutOfSubDoc() = "
                 << found_key.AdvanceOutOfSubDoc().ToString();
@@ -504,6 +589,11 @@ CHECKED_STATUS BuildSubDocument(
     }
     if (descendant.value_type() == ValueType::kInvalidValueType) {
       // The document was not found in this level (maybe a tombstone was encountered).
+      if (packed_row_found &&
+          found_key.num_subkeys() == data.subdocument_key->num_subkeys() + 1) {
+        // The column was deleted after the packed row was written.
+        data.result->DeleteChild(found_key.subkeys().back());
+      }
       continue;
     }
 
@@ -537,6 +627,14 @@ CHECKED_STATUS BuildSubDocument(
     current->SetChild(found_key.subkeys().back(), SubDocument(descendant));
   }
 
+  if (counter_sum && data.result->value_type() == ValueType::kInvalidValueType) {
+    // Only counter deltas were found, they add up to the value of the counter.
+    set_counter_result(0);
+  }
+  if (packed_row_found && data.result->object_num_keys() == 0) {
+    // All the columns of the packed row were deleted.
+    *data.result = SubDocument(ValueType::kInvalidValueType);
+  }
   return Status::OK();
 }
 
@@ -572,7 +670,7 @@ yb::Status GetSubDocument(
   *data.doc_found = false;
   DOCDB_DEBUG_LOG("GetSubDocument for key $0 @ $1", data.subdocument_key->ToString(),
                   db_iter->read_time().ToString());
-  DocHybridTime max_deleted_ts(DocHybridTime::kMin);
+  DocHybridTime max_deleted_ts(data.deleted_ts);
 
   VLOG(4) << "GetSubDocument(" << data.subdocument_key->ToString() << ")";
 
@@ -625,6 +723,28 @@ yb::Status GetSubDocument(
 
     return Status::OK();
   }
+  if (doc_value.value_type() == ValueType::kPackedRow) {
+    // The projected columns could be stored in the packed row as well as in later column records,
+    // so the whole row is built and the projected columns are taken from it.
+    SubDocument row(ValueType::kInvalidValueType);
+    {
+      IntentAwareIteratorPrefixScope prefix_scope(key_bytes, db_iter);
+      RETURN_NOT_OK(BuildSubDocument(
+          db_iter, data.Adjusted(data.subdocument_key, &row), max_deleted_ts));
+    }
+    *data.result = SubDocument();
+    for (const PrimitiveValue& subkey : *projection) {
+      SubDocument* column = row.value_type() == ValueType::kObject ? row.GetChild(subkey) : nullptr;
+      if (column != nullptr) {
+        *data.doc_found = true;
+        data.result->SetChild(subkey, std::move(*column));
+      } else {
+        data.result->SetChild(subkey, SubDocument(ValueType::kInvalidValueType));
+      }
+    }
+    return Status::OK();
+  }
+
   // For each subkey in the projection, build subdocument.
   *data.result = SubDocument();
   for (const PrimitiveValue& subkey : *projection) {
@@ -649,6 +769,86 @@ yb::Status GetSubDocument(
   return Status::OK();
 }
 
+Status GetPrimitiveColumnsRow(
+    IntentAwareIterator* db_iter,
+    const GetSubDocumentData& data,
+    const std::vector<PrimitiveValue>& projection,
+    bool* applicable) {
+  DCHECK(std::is_sorted(projection.begin(), projection.end()));
+  DCHECK_EQ(data.subdocument_key->num_subkeys(), 0);
+  *data.doc_found = false;
+  *applicable = false;
+
+  const KeyBytes doc_key_bytes = data.subdocument_key->doc_key().Encode();
+  IntentAwareIteratorPrefixScope prefix_scope(doc_key_bytes, db_iter);
+  db_iter->SeekForwardWithoutHt(doc_key_bytes);
+
+  // Projected columns that are not found are returned as invalid values, like GetSubDocument does.
+  *data.result = SubDocument();
+  for (const PrimitiveValue& subkey : projection) {
+    data.result->SetChild(subkey, SubDocument(ValueType::kInvalidValueType));
+  }
+
+  const HybridTime read_ht = db_iter->read_time().read;
+  while (db_iter->valid()) {
+    auto iter_key = db_iter->FetchKey();
+    RETURN_NOT_OK(iter_key);
+    SubDocKey found_key;
+    RETURN_NOT_OK(found_key.FullyDecodeFrom(*iter_key));
+    // Row level init markers and tombstones, as well as collection elements, need the range
+    // tracking of BuildSubDocument.
+    if (found_key.num_subkeys() != 1) {
+      return Status::OK();
+    }
+
+    Value doc_value;
+    RETURN_NOT_OK(doc_value.Decode(db_iter->value()));
+    if (doc_value.value_type() != ValueType::kTombstone &&
+        !IsPrimitiveValueType(doc_value.value_type())) {
+      return Status::OK();
+    }
+
+    // The iterator returns the latest visible version of a column first, the older versions are
+    // skipped below.
+    const MonoDelta ttl = ComputeTTL(doc_value.ttl(), data.table_ttl);
+    bool is_live = doc_value.value_type() != ValueType::kTombstone;
+    if (is_live && !ttl.Equals(Value::kMaxTtl)) {
+      const HybridTime expiry =
+          server::HybridClock::AddPhysicalTimeToHybridTime(found_key.hybrid_time(), ttl);
+      is_live = read_ht.CompareTo(expiry) <= 0;
+    }
+
+    const PrimitiveValue& column = found_key.subkeys()[0];
+    const bool projected = std::binary_search(projection.begin(), projection.end(), column);
+    if (is_live) {
+      *data.doc_found = true;
+      if (projected) {
+        SetTtlAndWriteTime(ttl, found_key.doc_hybrid_time(), read_ht, &doc_value);
+        data.result->SetChild(column, SubDocument(doc_value.primitive_value()));
+      }
+    }
+    if (projected || !*data.doc_found) {
+      // Only skip older versions of the column here, so that the elements of a collection column
+      // written after a tombstone are noticed.
+      db_iter->SeekPastSubKey(found_key);
+      continue;
+    }
+    // Once the row is known to exist, the columns outside the projection are not needed. Seek
+    // straight to the next projected column, past the values of the columns in between, e.g. the
+    // ones dropped by ALTER TABLE that compactions have not removed yet.
+    auto next_projected = std::upper_bound(projection.begin(), projection.end(), column);
+    if (next_projected == projection.end()) {
+      db_iter->SeekOutOfSubDoc(*data.subdocument_key);
+      break;
+    }
+    db_iter->SeekForwardWithoutHt(
+        SubDocKey(data.subdocument_key->doc_key(), *next_projected).Encode(
+            false /* include_hybrid_time */).AsSlice());
+  }
+  *applicable = true;
+  return Status::OK();
+}
+
 // ------------------------------------------------------------------------------------------------
 // Debug output
 // ------------------------------------------------------------------------------------------------
@@ -686,6 +886,13 @@ Result<std::string> DocDBKeyToDebugStr(Slice key_slice, KeyType* key_type) {
       RETURN_NOT_OK(transaction_id);
       return Format("TXN META $0", *transaction_id);
     }
+    case KeyType::kTransactionApplyState:
+    {
+      key_slice.remove_prefix(2); // kIntentPrefix + kTransactionId
+      auto transaction_id = DecodeTransactionId(&key_slice);
+      RETURN_NOT_OK(transaction_id);
+      return Format("TXN APPLY $0", *transaction_id);
+    }
     case KeyType::kEmpty: FALLTHROUGH_INTENDED;
     case KeyType::kValueKey:
       RETURN_NOT_OK_PREPEND(
@@ -727,6 +934,13 @@ Result<std::string> DocDBValueToDebugStr(
       RETURN_NOT_OK(metadata);
       return ToString(*metadata);
     }
+    case KeyType::kTransactionApplyState: {
+      TransactionApplyStatePB apply_state_pb;
+      if (!apply_state_pb.ParseFromArray(value.cdata(), value.size())) {
+        return STATUS_FORMAT(Corruption, "Bad apply state: $0", value.ToDebugHexString());
+      }
+      return apply_state_pb.ShortDebugString();
+    }
     case KeyType::kReverseTxnKey: {
       KeyType ignore_key_type;
       return DocDBKeyToDebugStr(value, &ignore_key_type);
@@ -763,6 +977,7 @@ void ProcessDumpEntry(Slice key, Slice value, IncludeBinary include_binary, std:
 void DocDBDebugDump(rocksdb::DB* rocksdb, ostream& out, IncludeBinary include_binary) {
   rocksdb::ReadOptions read_opts;
   read_opts.query_id = rocksdb::kDefaultQueryId;
+  read_opts.total_order_seek = true;
   auto iter = unique_ptr<rocksdb::Iterator>(rocksdb->NewIterator(read_opts));
   iter->SeekToFirst();
 
@@ -784,6 +999,11 @@ void AppendTransactionKeyPrefix(const TransactionId& transaction_id, KeyBytes* o
   out->AppendRawBytes(Slice(transaction_id.data, transaction_id.size()));
 }
 
+void AppendTransactionApplyStateKey(const TransactionId& transaction_id, KeyBytes* out) {
+  AppendTransactionKeyPrefix(transaction_id, out);
+  out->AppendValueType(ValueType::kGroupEnd);
+}
+
 DocHybridTimeBuffer::DocHybridTimeBuffer() {
   buffer_[0] = static_cast<char>(ValueType::kHybridTime);
 }
@@ -83,6 +83,8 @@ class Histogram;
 
 namespace docdb {
 
+class IntentFilter;
+
 // This function prepares the transaction by taking locks. The set of keys locked are returned to
 // the caller via the keys_locked argument (because they need to be saved and unlocked when the
 // transaction commits). A flag is also returned to indicate if any of the write operations
@@ -154,7 +156,8 @@ void PrepareTransactionWriteBatch(
     HybridTime hybrid_time,
     rocksdb::WriteBatch* rocksdb_write_batch,
     const TransactionId& transaction_id,
-    IsolationLevel isolation_level);
+    IsolationLevel isolation_level,
+    IntentFilter* intent_filter = nullptr);
 
 // A visitor class that could be overridden to consume results of scanning SubDocuments.
 // See e.g. SubDocumentBuildingVisitor (used in implementing GetSubDocument) as example usage.
@@ -240,6 +243,9 @@ struct GetSubDocumentData {
   bool return_type_only = false;
   const SubDocKeyBound* low_subkey = &SubDocKeyBound::Empty();
   const SubDocKeyBound* high_subkey = &SubDocKeyBound::Empty();
+  // The latest time the document was deleted at by a record outside of it, i.e. a range tombstone,
+  // see range_tombstone.h. The records of the document written before it are skipped.
+  DocHybridTime deleted_ts = DocHybridTime::kMin;
 
   GetSubDocumentData Adjusted(
       const SubDocKey* subdoc_key, SubDocument* result_, bool* doc_found_ = nullptr) const {
@@ -248,6 +254,7 @@ struct GetSubDocumentData {
     result.return_type_only = return_type_only;
     result.low_subkey = low_subkey;
     result.high_subkey = high_subkey;
+    result.deleted_ts = deleted_ts;
     return result;
   }
 
@@ -282,6 +289,19 @@ yb::Status GetSubDocument(
     const std::vector<PrimitiveValue>* projection = nullptr,
     const bool is_iter_valid = true);
 
+// Builds the row with the doc key of data.subdocument_key in a single forward pass over its
+// records, for rows whose records are all primitive column values or column tombstones, which is
+// the common case for key-value style tables. Only the columns from the sorted projection are set
+// in data.result, and data.doc_found tells whether any column of the row exists, like
+// GetSubDocument with a projection does. Sets *applicable to false, leaving the iterator at an
+// unspecified position, when the row has any other record, e.g. a row level init marker or
+// tombstone or a collection; GetSubDocument should be used for such rows.
+CHECKED_STATUS GetPrimitiveColumnsRow(
+    IntentAwareIterator* db_iter,
+    const GetSubDocumentData& data,
+    const std::vector<PrimitiveValue>& projection,
+    bool* applicable);
+
 // This version of GetSubDocument creates a new iterator every time. This is not recommended for
 // multiple calls to subdocs that are sequential or near each other, in eg. doc_rowwise_iterator.
 // low_subkey and high_subkey are optional ranges that we can specify for the subkeys to ensure
@@ -309,6 +329,10 @@ void ConfigureDocDBRocksDBOptions(rocksdb::Options* options);
 
 void AppendTransactionKeyPrefix(const TransactionId& transaction_id, docdb::KeyBytes* out);
 
+// Key of TransactionApplyStatePB of a partially applied transaction. It is ordered between the
+// transaction metadata and the reverse index records of the transaction.
+void AppendTransactionApplyStateKey(const TransactionId& transaction_id, docdb::KeyBytes* out);
+
 // Buffer for encoding DocHybridTime
 class DocHybridTimeBuffer {
  public:
@@ -22,9 +22,17 @@
 
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/docdb-internal.h"
+#include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/value.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 
+#include "yb/util/flag_tags.h"
+
+DEFINE_bool(delete_expired_sst_files, true,
+            "For tables with default TTL, delete the oldest SST files once all their records are "
+            "expired, instead of removing the records one by one in compactions.");
+TAG_FLAG(delete_expired_sst_files, advanced);
+
 using std::shared_ptr;
 using std::unique_ptr;
 using std::unordered_set;
@@ -39,9 +47,11 @@ namespace docdb {
 DocDBCompactionFilter::DocDBCompactionFilter(HybridTime history_cutoff,
                                              ColumnIdsPtr deleted_cols,
                                              bool is_full_compaction,
-                                             MonoDelta table_ttl)
+                                             MonoDelta table_ttl,
+                                             HybridTime restore_ht)
     : history_cutoff_(history_cutoff),
       is_full_compaction_(is_full_compaction),
+      restore_ht_(restore_ht),
       is_first_key_value_(true),
       filter_usage_logged_(false),
       table_ttl_(table_ttl),
@@ -56,15 +66,19 @@ bool DocDBCompactionFilter::Filter(int level,
                                    const rocksdb::Slice& existing_value,
                                    std::string* new_value,
                                    bool* value_changed) const {
-  if (!is_full_compaction_) {
+  if (!is_full_compaction_ && !restore_ht_.is_valid()) {
     // By default, we only perform history garbage collection on full compactions
     // (or major compactions, in the HBase terminology).
     //
     // TODO: Enable history garbage collection on minor (non-full) compactions as well.
     //       This should be similar to the existing workflow, but should be extensively tested.
     //
+    // The values of columns deleted before the history cutoff are not visible at any hybrid time
+    // that can still be read, so unlike the overwritten history they can be dropped by any
+    // compaction, see Tablet::CompactFilesWithDeletedColumns().
+    //
     // Here, false means "keep the key/value pair" (don't filter it out).
-    return false;
+    return !deleted_cols_->empty() && IsDeletedColumnKey(key);
   }
 
   if (!filter_usage_logged_) {
@@ -82,19 +96,41 @@ bool DocDBCompactionFilter::Filter(int level,
     << "    Key (raw): " << FormatRocksDBSliceAsStr(key) << "\n"
     << "    Key (best-effort decoded): " << BestEffortDocDBKeyToStr(key);
 
+  if (restore_ht_.is_valid()) {
+    if (subdoc_key.hybrid_time() > restore_ht_) {
+      // Removing the records written after the restore hybrid time makes the older versions
+      // visible again. The overwrite stack below is left untouched, as if the record never existed.
+      return true;
+    }
+    if (!is_full_compaction_) {
+      return false;
+    }
+  }
+
   if (is_first_key_value_) {
     CHECK_EQ(0, overwrite_ht_.size());
     is_first_key_value_ = false;
   }
 
+  const DocHybridTime& ht = subdoc_key.doc_hybrid_time();
+
+  Slice hashed_part, range_group;
+  CHECK_OK(SplitDocKey(key, &hashed_part, &range_group));
+  if (!range_tombstones_.IsFor(hashed_part)) {
+    range_tombstones_.Reset(hashed_part);
+  } else if (!range_tombstones_.empty() && !subdoc_key.doc_key().range_group().empty() &&
+             ht < range_tombstones_.DeletedAt(range_group)) {
+    // Deleted by a range tombstone that is visible at any hybrid time that can still be read. The
+    // older records of the same row are removed the same way, so the overwrite stack is left as is.
+    return true;
+  }
+
   const size_t num_shared_components = prev_subdoc_key_.NumSharedPrefixComponents(subdoc_key);
 
   // Remove overwrite hybrid_times for components that are no longer relevant for the current
   // SubDocKey.
   overwrite_ht_.resize(min(overwrite_ht_.size(), num_shared_components));
 
-  const DocHybridTime& ht = subdoc_key.doc_hybrid_time();
-
   // We're comparing the hybrid_time in this key with the _previous_ stack top of overwrite_ht_,
   // after truncating the previous hybrid_time to the number of components in the common prefix
   // of previous and current key.
@@ -148,16 +184,28 @@ bool DocDBCompactionFilter::Filter(int level,
 
   const bool ht_at_or_below_cutoff = ht.hybrid_time() <= history_cutoff_;
 
+  ValueType value_type;
+  CHECK_OK(Value::DecodePrimitiveValueType(existing_value, &value_type));
+
   // See if we found a higher hybrid_time not exceeding the history cutoff hybrid_time at which the
   // subdocument (including a primitive value) rooted at the current key was fully overwritten.
   // In case ts > history_cutoff_, we just keep the parent document's highest known overwrite
   // hybrid_time that does not exceed the cutoff hybrid_time. In that case this entry is obviously
-  // too new to be garbage-collected.
-  overwrite_ht_.push_back(ht_at_or_below_cutoff ? max(prev_overwrite_ht, ht) : prev_overwrite_ht);
+  // too new to be garbage-collected. A counter delta does not overwrite the older values of the
+  // counter, which readers add it to. The deltas are not folded into one value here either, since
+  // the filter decides about each record before it sees the older ones.
+  overwrite_ht_.push_back(
+      ht_at_or_below_cutoff && value_type != ValueType::kCounterDelta
+          ? max(prev_overwrite_ht, ht) : prev_overwrite_ht);
 
   CHECK_EQ(new_stack_size, overwrite_ht_.size());
   prev_subdoc_key_ = std::move(subdoc_key);
 
+  if (ht_at_or_below_cutoff && value_type == ValueType::kTombstone &&
+      IsRangeTombstoneKey(prev_subdoc_key_)) {
+    CHECK_OK(range_tombstones_.Add(prev_subdoc_key_));
+  }
+
   if (prev_subdoc_key_.num_subkeys() > 0 &&
       prev_subdoc_key_.subkeys()[0].value_type() == ValueType::kColumnId) {
     // Column ID is first subkey in QL tables.
@@ -168,8 +216,6 @@ bool DocDBCompactionFilter::Filter(int level,
     }
   }
 
-  ValueType value_type;
-  CHECK_OK(Value::DecodePrimitiveValueType(existing_value, &value_type));
   MonoDelta ttl;
 
   // If the value expires by the time of history cutoff, it is treated as deleted and filtered out.
@@ -207,6 +253,20 @@ bool DocDBCompactionFilter::Filter(int level,
   return value_type == ValueType::kTombstone && ht_at_or_below_cutoff && is_full_compaction_;
 }
 
+bool DocDBCompactionFilter::IsDeletedColumnKey(const rocksdb::Slice& key) const {
+  auto doc_key_size = DocKey::EncodedSize(key, DocKeyPart::WHOLE_DOC_KEY);
+  if (!doc_key_size.ok() || *doc_key_size >= key.size() ||
+      key[*doc_key_size] != static_cast<uint8_t>(ValueType::kColumnId)) {
+    return false;
+  }
+  rocksdb::Slice subkey(key.data() + *doc_key_size, key.size() - *doc_key_size);
+  PrimitiveValue column;
+  if (!PrimitiveValue::DecodeKey(&subkey, &column).ok()) {
+    return false;
+  }
+  return deleted_cols_->count(column.GetColumnId()) != 0;
+}
+
 const char* DocDBCompactionFilter::Name() const {
   return "DocDBCompactionFilter";
 }
@@ -224,10 +284,43 @@ DocDBCompactionFilterFactory::~DocDBCompactionFilterFactory() {
 
 unique_ptr<CompactionFilter> DocDBCompactionFilterFactory::CreateCompactionFilter(
     const CompactionFilter::Context& context) {
+  const HybridTime restore_ht = retention_policy_->GetRestoreHybridTime();
+  HybridTime history_cutoff = retention_policy_->GetHistoryCutoff();
+  if (restore_ht.is_valid()) {
+    // The history needed to restore could otherwise be garbage-collected by this compaction if
+    // the cutoff moved past the restore time after the restore was started.
+    history_cutoff = std::min(history_cutoff, restore_ht);
+  }
   return unique_ptr<DocDBCompactionFilter>(
-      new DocDBCompactionFilter(retention_policy_->GetHistoryCutoff(),
+      new DocDBCompactionFilter(history_cutoff,
                                 retention_policy_->GetDeletedColumns(),
-                                context.is_full_compaction, retention_policy_->GetTableTTL()));
+                                context.is_full_compaction, retention_policy_->GetTableTTL(),
+                                restore_ht));
+}
+
+rocksdb::Slice DocDBCompactionFilterFactory::SubcompactionBoundary(
+    const rocksdb::Slice& user_key) const {
+  auto doc_key_size = DocKey::EncodedSize(user_key, DocKeyPart::HASHED_PART_ONLY);
+  if (doc_key_size.ok() && *doc_key_size == 0) {
+    // There are no hashed components, so the range tombstones are not used.
+    doc_key_size = DocKey::EncodedSize(user_key, DocKeyPart::WHOLE_DOC_KEY);
+  }
+  if (!doc_key_size.ok()) {
+    return rocksdb::Slice();
+  }
+  return rocksdb::Slice(user_key.data(), *doc_key_size);
+}
+
+size_t DocDBCompactionFilterFactory::NumExpiredOldestFiles(
+    const std::vector<rocksdb::FileMetaData*>& files) {
+  if (!FLAGS_delete_expired_sst_files) {
+    return 0;
+  }
+  const MonoDelta table_ttl = retention_policy_->GetTableTTL();
+  if (table_ttl.Equals(Value::kMaxTtl)) {
+    return 0;
+  }
+  return docdb::NumExpiredOldestFiles(files, retention_policy_->GetHistoryCutoff(), table_ttl);
 }
 
 const char* DocDBCompactionFilterFactory::Name() const {
@@ -23,6 +23,7 @@
 #include "yb/common/schema.h"
 #include "yb/common/hybrid_time.h"
 #include "yb/docdb/doc_key.h"
+#include "yb/docdb/range_tombstone.h"
 
 namespace yb {
 namespace docdb {
@@ -32,7 +33,8 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   DocDBCompactionFilter(HybridTime history_cutoff,
                         ColumnIdsPtr deleted_cols,
                         bool is_full_compaction,
-                        MonoDelta table_ttl);
+                        MonoDelta table_ttl,
+                        HybridTime restore_ht = HybridTime::kInvalidHybridTime);
 
   ~DocDBCompactionFilter() override;
   bool Filter(int level,
@@ -43,6 +45,9 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   const char* Name() const override;
 
  private:
+  // Returns true if the key is a value of one of deleted_cols_.
+  bool IsDeletedColumnKey(const rocksdb::Slice& key) const;
+
   // We will not keep history below this hybrid_time. The view of the database at this hybrid_time
   // is preserved, but after the compaction completes, we should not expect to be able to do
   // consistent scans at DocDB hybrid_times lower than this. Those scans will result in missing
@@ -51,6 +56,10 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   const HybridTime history_cutoff_;
   const bool is_full_compaction_;
 
+  // When valid, all the records written after this hybrid time are removed, so that the database
+  // goes back to its state as of this hybrid time. This is done in minor compactions as well.
+  const HybridTime restore_ht_;
+
   mutable bool is_first_key_value_;
   mutable SubDocKey prev_subdoc_key_;
 
@@ -92,6 +101,10 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
 
   mutable std::vector<DocHybridTime> overwrite_ht_;
 
+  // The range tombstones at or below history_cutoff_ of the current hash key. They are stored in
+  // its static row, which is compacted before its other rows, whose records they cover are removed.
+  mutable RangeTombstones range_tombstones_;
+
   // We use this to only log a message that the filter is being used once on the first call to
   // the Filter function.
   mutable bool filter_usage_logged_;
@@ -110,6 +123,10 @@ class HistoryRetentionPolicy {
   virtual HybridTime GetHistoryCutoff() = 0;
   virtual ColumnIdsPtr GetDeletedColumns() = 0;
   virtual MonoDelta GetTableTTL() = 0;
+
+  // The hybrid time the database is being restored to, see DocDBCompactionFilter::restore_ht_.
+  // Invalid when no restore is in progress.
+  virtual HybridTime GetRestoreHybridTime() { return HybridTime::kInvalidHybridTime; }
 };
 
 // A history retention policy that always returns the same hybrid_time. Useful in tests. This class
@@ -131,8 +148,12 @@ class FixedHybridTimeRetentionPolicy : public HistoryRetentionPolicy {
   MonoDelta GetTableTTL() override { return table_ttl_; }
   void SetTableTTLForTests(MonoDelta ttl) {  table_ttl_ = ttl; }
 
+  HybridTime GetRestoreHybridTime() override { return restore_ht_.load(); }
+  void SetRestoreHybridTime(HybridTime restore_ht) { restore_ht_.store(restore_ht); }
+
  private:
   std::atomic<HybridTime> history_cutoff_;
+  std::atomic<HybridTime> restore_ht_{HybridTime::kInvalidHybridTime};
   ColumnIds deleted_cols_;
   MonoDelta table_ttl_;
 };
@@ -143,6 +164,12 @@ class DocDBCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
   ~DocDBCompactionFilterFactory() override;
   std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
       const rocksdb::CompactionFilter::Context& context) override;
+  // DocDBCompactionFilter tracks overwrites within a document and range tombstones within a hash
+  // key, so a subcompaction could only start at the hashed part of a DocKey.
+  rocksdb::Slice SubcompactionBoundary(const rocksdb::Slice& user_key) const override;
+  // For tables with default TTL, the oldest files could expire as a whole, see
+  // FLAGS_delete_expired_sst_files.
+  size_t NumExpiredOldestFiles(const std::vector<rocksdb::FileMetaData*>& files) override;
   const char* Name() const override;
 
  private:
@@ -13,17 +13,37 @@
 
 #include "yb/docdb/docdb_rocksdb_util.h"
 
+#include <algorithm>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+
+#include <boost/algorithm/string/predicate.hpp>
 
 #include "yb/common/transaction.h"
 
+#include "yb/gutil/strings/join.h"
+#include "yb/gutil/strings/numbers.h"
+#include "yb/gutil/strings/split.h"
+
+#include "yb/rocksdb/memtablerep.h"
+#include "yb/rocksdb/options.h"
 #include "yb/rocksdb/rate_limiter.h"
+#include "yb/rocksdb/slice_transform.h"
 #include "yb/rocksdb/table.h"
+#include "yb/rocksdb/table_properties.h"
+#include "yb/rocksdb/util/delete_scheduler.h"
 
 #include "yb/docdb/intent_aware_iterator.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 #include "yb/rocksutil/yb_rocksdb_logger.h"
 #include "yb/server/hybrid_clock.h"
+#include "yb/util/env.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/path_util.h"
+#include "yb/util/thread.h"
 #include "yb/util/trace.h"
 #include "yb/util/logging.h"
 
@@ -46,6 +66,18 @@ DEFINE_int32(rocksdb_universal_compaction_size_ratio, 20,
              "The percentage upto which files that are larger are include in a compaction.");
 DEFINE_int32(rocksdb_universal_compaction_min_merge_width, 4,
              "The minimum number of files in a single compaction run.");
+DEFINE_uint64(rocksdb_universal_compaction_small_output_size_bytes, 0,
+              "Flushes and universal compactions whose output is estimated to be at most this "
+              "size (in bytes) use rocksdb_universal_compaction_small_output_compression instead "
+              "of db_compression_type, since small sorted runs are rewritten soon. 0 to use "
+              "db_compression_type for all the files.");
+DEFINE_string(rocksdb_universal_compaction_small_output_compression, "none",
+              "Compression used for the small RocksDB files, see "
+              "rocksdb_universal_compaction_small_output_size_bytes.");
+DEFINE_int32(rocksdb_max_subcompactions, 1,
+             "Maximal number of threads a large compaction (see "
+             "rocksdb_compaction_size_threshold_bytes) is split into, each processing a disjoint "
+             "DocKey range. Capped by rocksdb_max_background_compactions.");
 DEFINE_int64(rocksdb_compact_flush_rate_limit_bytes_per_sec, 100 * 1024 * 1024,
              "Use to control write rate of flush and compaction.");
 DEFINE_uint64(rocksdb_compaction_size_threshold_bytes, 2ULL * 1024 * 1024 * 1024,
@@ -53,20 +85,104 @@ DEFINE_uint64(rocksdb_compaction_size_threshold_bytes, 2ULL * 1024 * 1024 * 1024
 DEFINE_uint64(rocksdb_max_file_size_for_compaction, 0,
              "Maximal allowed file size to participate in RocksDB compaction. 0 - unlimited.");
 
+DEFINE_bool(rocksdb_allow_concurrent_memtable_write, true,
+            "Whether the batches of a RocksDB write group are inserted into the memtable in "
+            "parallel by their writers, instead of by the group leader one after another.");
+DEFINE_bool(rocksdb_enable_write_thread_adaptive_yield, false,
+            "Whether RocksDB writers spin and yield for a short time before blocking while waiting "
+            "for the group leader. Lowers write latency with concurrent memtable writes at the "
+            "cost of CPU.");
+
+DEFINE_int32(rocksdb_max_pooled_iterators, 16,
+             "Number of released iterators that RocksDB keeps to reuse them for new reads. When "
+             "the super version did not change and the read needs no file filters, the kept "
+             "iterator tree is reused as is; otherwise only its memory is reused.");
+TAG_FLAG(rocksdb_max_pooled_iterators, advanced);
+
+DEFINE_bool(rocksdb_use_direct_io_for_flush_and_compaction, false,
+            "Whether SST files written by flushes and compactions bypass the OS page cache, so "
+            "that they don't evict the pages of SST files used by reads.");
+TAG_FLAG(rocksdb_use_direct_io_for_flush_and_compaction, advanced);
+
 DEFINE_int64(db_block_size_bytes, 32 * 1024,
              "Size of RocksDB block (in bytes).");
 
+DEFINE_int64(db_index_block_size_bytes, 0,
+             "Size of RocksDB data index partition (in bytes). If positive, new SST files get a "
+             "two-level data index whose partitions are loaded through the block cache. 0 to "
+             "use a single data index block per SST file.");
+
+DEFINE_int64(db_max_scan_readahead_size_bytes, 256 * 1024,
+             "Maximum number of bytes a RocksDB iterator prefetches ahead of the data blocks it "
+             "reads from an SST file during a scan. 0 to disable prefetching.");
+
+DEFINE_string(db_compression_type, "snappy",
+              "Compression used for RocksDB data blocks: none, snappy, zlib, lz4 or zstd. Falls "
+              "back to snappy when the chosen compression is not supported by this build.");
+
+DEFINE_int32(db_compression_max_dict_bytes, 0,
+             "Maximal size (in bytes) of a compression dictionary trained on the input of each "
+             "compaction and stored in the output SST files. Used with zlib, lz4 and zstd, 0 to "
+             "compress without a dictionary.");
+
 DEFINE_int64(db_write_buffer_size, -1,
              "Size of RocksDB write buffer (in bytes). -1 to use default.");
 
 DEFINE_bool(use_docdb_aware_bloom_filter, true,
             "Whether to use the DocDbAwareFilterPolicy for both bloom storage and seeks.");
+DEFINE_bool(use_docdb_lane_blocked_bloom_filter, false,
+            "Whether new SST files get bloom filters which keep all probes of a key in the 64-bit "
+            "lanes of one cache line, so lookups check them at once. Older versions treat such "
+            "filters as matching all keys.");
+TAG_FLAG(use_docdb_lane_blocked_bloom_filter, advanced);
+DEFINE_bool(use_docdb_hybrid_time_file_filter, true,
+            "Whether reads skip the SST files whose records were all written after the read "
+            "time, using the hybrid times recorded in the file boundaries.");
+DEFINE_bool(use_docdb_hash_indexed_memtable, false,
+            "Whether memtables index their entries by the hashed part of the DocKey, or by the "
+            "whole DocKey for tables without hash columns, so point lookups search a small "
+            "per-bucket skiplist. Every memtable allocates the bucket array up front.");
+DEFINE_int32(docdb_memtable_hash_bucket_count, 64 * 1024,
+             "Number of buckets in the index of a memtable, when "
+             "use_docdb_hash_indexed_memtable is set.");
+TAG_FLAG(use_docdb_hash_indexed_memtable, advanced);
+TAG_FLAG(docdb_memtable_hash_bucket_count, advanced);
+DEFINE_bool(redis_hash_indexed_sst_files, false,
+            "Whether the SST files of Redis tables index their data blocks by the hashed part of "
+            "the DocKey, so that point lookups find their data block with a hash lookup instead of "
+            "a binary search in the index. Replaces the two-level index for these tables.");
+TAG_FLAG(redis_hash_indexed_sst_files, advanced);
+DEFINE_bool(docdb_data_block_hash_index, false,
+            "Whether the data blocks loaded to the block cache get a hash index from the DocKeys "
+            "of their records to the restart intervals holding them, so that a seek in a cached "
+            "block binary searches only the entries of its DocKey. Costs extra cache memory.");
+TAG_FLAG(docdb_data_block_hash_index, advanced);
+DEFINE_bool(docdb_share_key_suffixes, false,
+            "Whether the keys in new SST data blocks also share their ends with the previous key, "
+            "so that the hybrid times and sequence numbers repeated across the columns of a row "
+            "are stored once. The files can't be read by the versions without this encoding.");
+TAG_FLAG(docdb_share_key_suffixes, advanced);
 DEFINE_int32(max_nexts_to_avoid_seek, 8,
              "The number of next calls to try before doing resorting to do a rocksdb seek.");
+DEFINE_bool(adaptive_nexts_to_avoid_seek, true,
+            "Whether iterators adapt the number of Next() calls tried before a RocksDB seek to the "
+            "distances between the keys they seek to, starting from max_nexts_to_avoid_seek.");
+DEFINE_int32(max_adaptive_nexts_to_avoid_seek, 64,
+             "The maximum number of Next() calls tried before a RocksDB seek, when "
+             "adaptive_nexts_to_avoid_seek is set.");
+TAG_FLAG(adaptive_nexts_to_avoid_seek, advanced);
+TAG_FLAG(max_adaptive_nexts_to_avoid_seek, advanced);
 DEFINE_bool(trace_docdb_calls, false, "Whether we should trace calls into the docdb.");
 
 DEFINE_uint64(initial_seqno, 1ULL << 50, "Initial seqno for new RocksDB instances.");
 
+DEFINE_int64(rocksdb_destroy_rate_bytes_per_sec, 64 * 1024 * 1024,
+             "The rate at which the files of truncated tablets and dropped tables are unlinked in "
+             "the background, so large deletions do not saturate the disks. 0 unlinks them as fast "
+             "as possible.");
+TAG_FLAG(rocksdb_destroy_rate_bytes_per_sec, advanced);
+TAG_FLAG(rocksdb_destroy_rate_bytes_per_sec, runtime);
+
 using std::shared_ptr;
 using std::string;
 using std::unique_ptr;
@@ -161,28 +277,59 @@ Status SeekToValidKvAtTs(
   return Status::OK();
 }
 
-void SeekForward(const rocksdb::Slice& slice, rocksdb::Iterator *iter) {
+namespace {
+
+// Number of recorded positionings after which the adapted limit is reset.
+constexpr int kNextOrSeekPolicyResetInterval = 32;
+
+} // namespace
+
+NextOrSeekPolicy::NextOrSeekPolicy() : max_nexts_(FLAGS_max_nexts_to_avoid_seek) {}
+
+void NextOrSeekPolicy::Record(int nexts, bool seeked) {
+  num_nexts_ += nexts;
+  num_seeks_ += seeked;
+  if (!FLAGS_adaptive_nexts_to_avoid_seek || FLAGS_max_nexts_to_avoid_seek <= 0) {
+    max_nexts_ = FLAGS_max_nexts_to_avoid_seek;
+    return;
+  }
+  if (seeked) {
+    // The target was farther than we were ready to go, so the Next() calls were wasted.
+    max_nexts_ = std::max(max_nexts_ / 2, 1);
+  } else if (nexts * 2 > max_nexts_) {
+    max_nexts_ = std::min(max_nexts_ * 2, FLAGS_max_adaptive_nexts_to_avoid_seek);
+  }
+  if (++records_since_reset_ >= kNextOrSeekPolicyResetInterval) {
+    records_since_reset_ = 0;
+    // A limit that was lowered by a few long rows should not stay low for the rest of the scan.
+    max_nexts_ = std::max(max_nexts_, FLAGS_max_nexts_to_avoid_seek);
+  }
+}
+
+void SeekForward(const rocksdb::Slice& slice, rocksdb::Iterator *iter, NextOrSeekPolicy* policy) {
   if (!iter->Valid() || iter->key().compare(slice) >= 0) {
     return;
   }
-  ROCKSDB_SEEK(iter, slice);
+  PerformRocksDBSeek(iter, slice, __FILE__, __LINE__, policy);
 }
 
-void SeekForward(const KeyBytes& key_bytes, rocksdb::Iterator *iter) {
-  SeekForward(key_bytes.AsSlice(), iter);
+void SeekForward(const KeyBytes& key_bytes, rocksdb::Iterator *iter, NextOrSeekPolicy* policy) {
+  SeekForward(key_bytes.AsSlice(), iter, policy);
 }
 
-void SeekPastSubKey(const SubDocKey& sub_doc_key, rocksdb::Iterator* iter) {
+void SeekPastSubKey(const SubDocKey& sub_doc_key, rocksdb::Iterator* iter,
+                    NextOrSeekPolicy* policy) {
   KeyBytes key_bytes = sub_doc_key.Encode(/* include_hybrid_time */ false);
   AppendDocHybridTime(DocHybridTime::kMin, &key_bytes);
-  SeekForward(key_bytes, iter);
+  SeekForward(key_bytes, iter, policy);
 }
 
 void PerformRocksDBSeek(
     rocksdb::Iterator *iter,
     const rocksdb::Slice &seek_key,
     const char* file_name,
-    int line) {
+    int line,
+    NextOrSeekPolicy* policy) {
 #ifndef NDEBUG
   {
     // Validating that we're only using keys with a max "write id" component, or no HybridTime at
@@ -222,27 +369,37 @@ void PerformRocksDBSeek(
   int seek_count = 0;
   if (seek_key.size() == 0) {
     iter->SeekToFirst();
+    if (policy) {
+      policy->RecordSeek();
+    }
   } else if (!iter->Valid() || iter->key().compare(seek_key) > 0) {
     iter->Seek(seek_key);
+    if (policy) {
+      policy->RecordSeek();
+    }
   } else {
-    for (int nexts = 0; nexts <= FLAGS_max_nexts_to_avoid_seek; nexts++) {
+    const int max_nexts = policy ? policy->max_nexts() : FLAGS_max_nexts_to_avoid_seek;
+    for (int nexts = 0; nexts <= max_nexts; nexts++) {
       if (!iter->Valid() || iter->key().compare(seek_key) >= 0) {
         if (FLAGS_trace_docdb_calls) {
           TRACE("Did $0 Next(s) instead of a Seek", nexts);
         }
         break;
       }
-      if (nexts < FLAGS_max_nexts_to_avoid_seek) {
+      if (nexts < max_nexts) {
         iter->Next();
         ++next_count;
       } else {
         if (FLAGS_trace_docdb_calls) {
-          TRACE("Forced to do an actual Seek after $0 Next(s)", FLAGS_max_nexts_to_avoid_seek);
+          TRACE("Forced to do an actual Seek after $0 Next(s)", max_nexts);
         }
         iter->Seek(seek_key);
         ++seek_count;
       }
     }
+    if (policy) {
+      policy->Record(next_count, seek_count != 0);
+    }
   }
   VLOG(4) << Substitute(
       "PerformRocksDBSeek at $0:$1:\n"
@@ -286,6 +443,9 @@ rocksdb::ReadOptions PrepareReadOptions(
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter) {
   rocksdb::ReadOptions read_opts;
   read_opts.query_id = query_id;
+  // Only the reads bounded to one DocKey may use the prefix index of the point lookup tables, see
+  // InitPointLookupRocksDBOptions.
+  read_opts.total_order_seek = bloom_filter_mode != BloomFilterMode::USE_BLOOM_FILTER;
   if (FLAGS_use_docdb_aware_bloom_filter &&
     bloom_filter_mode == BloomFilterMode::USE_BLOOM_FILTER) {
     DCHECK(user_key_for_filter);
@@ -316,10 +476,256 @@ unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
     const TransactionOperationContextOpt& txn_op_context,
     const ReadHybridTime& read_time,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter) {
+  // Records written after the global limit are invisible even as read restart candidates.
+  if (FLAGS_use_docdb_hybrid_time_file_filter && read_time.global_limit.is_valid()) {
+    file_filter = CreateHybridTimeFileFilter(
+        HybridTime::kMin, read_time.global_limit, std::move(file_filter));
+  }
   rocksdb::ReadOptions read_opts = PrepareReadOptions(rocksdb, bloom_filter_mode,
       user_key_for_filter, query_id, std::move(file_filter));
   return std::make_unique<IntentAwareIterator>(
-      rocksdb, read_opts, read_time, txn_op_context);
+      rocksdb, read_opts, read_time, txn_op_context,
+      bloom_filter_mode == BloomFilterMode::USE_BLOOM_FILTER
+          ? user_key_for_filter : boost::optional<const Slice>());
+}
+
+unique_ptr<IntentAwareIterator> CreateTailingIntentAwareIterator(
+    rocksdb::DB* rocksdb,
+    const rocksdb::QueryId query_id,
+    const TransactionOperationContextOpt& txn_op_context,
+    const ReadHybridTime& read_time) {
+  // File filters would prevent the tailing iterator from being reused by the next read.
+  rocksdb::ReadOptions read_opts = PrepareReadOptions(
+      rocksdb, BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none, query_id,
+      nullptr /* file_filter */);
+  read_opts.tailing = true;
+  return std::make_unique<IntentAwareIterator>(rocksdb, read_opts, read_time, txn_op_context);
+}
+
+namespace {
+
+rocksdb::CompressionType ParseCompressionType(const std::string& name) {
+  static const std::pair<const char*, rocksdb::CompressionType> kCompressionTypes[] = {
+      {"none", rocksdb::kNoCompression},
+      {"snappy", rocksdb::kSnappyCompression},
+      {"zlib", rocksdb::kZlibCompression},
+      {"lz4", rocksdb::kLZ4Compression},
+      {"zstd", rocksdb::kZSTD},
+  };
+  for (const auto& entry : kCompressionTypes) {
+    if (boost::iequals(name, entry.first)) {
+      if (rocksdb::IsCompressionTypeSupported(entry.second)) {
+        return entry.second;
+      }
+      YB_LOG_EVERY_N_SECS(WARNING, 600) << "Compression " << entry.first
+                                        << " is not supported, using snappy";
+      return rocksdb::kSnappyCompression;
+    }
+  }
+  YB_LOG_EVERY_N_SECS(WARNING, 600) << "Unknown compression type " << name << ", using snappy";
+  return rocksdb::kSnappyCompression;
+}
+
+// Maps a key to its DocKey prefix that is used to pick the memtable bucket: the hashed part for keys
+// with hash columns and the whole DocKey otherwise. Keys that are not DocKeys, e.g. transaction
+// metadata, are used as is.
+class DocKeyHashedPrefixTransform : public rocksdb::SliceTransform {
+ public:
+  const char* Name() const override {
+    return "DocKeyHashedPrefixTransform";
+  }
+
+  Slice Transform(const Slice& src) const override {
+    size_t offset = !src.empty() && src[0] == static_cast<uint8_t>(ValueType::kIntentPrefix);
+    const auto part = src.size() > offset && src[offset] == static_cast<uint8_t>(
+        ValueType::kUInt16Hash) ? DocKeyPart::HASHED_PART_ONLY : DocKeyPart::WHOLE_DOC_KEY;
+    auto size = DocKey::EncodedSize(src, part);
+    return size.ok() ? Slice(src.data(), *size) : src;
+  }
+
+  bool InDomain(const Slice& src) const override {
+    return true;
+  }
+
+  bool InRange(const Slice& dst) const override {
+    return true;
+  }
+};
+
+// Maps a key to its whole DocKey, with the intent prefix if any, used as the hash key of the data
+// block hash index. Keys that are not DocKeys are used as is.
+class DocKeyPrefixTransform : public rocksdb::SliceTransform {
+ public:
+  const char* Name() const override {
+    return "DocKeyPrefixTransform";
+  }
+
+  Slice Transform(const Slice& src) const override {
+    auto size = DocKey::EncodedSize(src, DocKeyPart::WHOLE_DOC_KEY);
+    return size.ok() ? Slice(src.data(), *size) : src;
+  }
+
+  bool InDomain(const Slice& src) const override {
+    return true;
+  }
+
+  bool InRange(const Slice& dst) const override {
+    return true;
+  }
+};
+
+const char kColumnIdsPropertyName[] = "yb.docdb.column_ids";
+const char kMinHashCodePropertyName[] = "yb.docdb.min_hash_code";
+const char kMaxHashCodePropertyName[] = "yb.docdb.max_hash_code";
+const char kNumTombstonesPropertyName[] = "yb.docdb.num_tombstones";
+const char kNumTtlValuesPropertyName[] = "yb.docdb.num_ttl_values";
+const char kNumIntentsPropertyName[] = "yb.docdb.num_intents";
+
+// Records the DocDBTableProperties of an SST file, so that the files to compact or to read could be
+// picked without reading them. The column id is the first subkey after the DocKey in QL tables,
+// other keys don't contribute to the column ids.
+class DocDBTablePropertiesCollector : public rocksdb::TablePropertiesCollector {
+ public:
+  Status AddUserKey(const Slice& key, const Slice& value, rocksdb::EntryType type,
+                    rocksdb::SequenceNumber seq, uint64_t file_size) override {
+    if (type == rocksdb::kEntryDelete || type == rocksdb::kEntrySingleDelete) {
+      ++properties_.num_tombstones;
+      return Status::OK();
+    }
+    if (type != rocksdb::kEntryPut || key.empty()) {
+      return Status::OK();
+    }
+
+    DocKeyHash hash_code;
+    if (DocKey::DecodeHash(key, &hash_code)) {
+      if (!properties_.has_hash_codes) {
+        properties_.has_hash_codes = true;
+        properties_.min_hash_code = properties_.max_hash_code = hash_code;
+      } else {
+        properties_.min_hash_code = std::min(properties_.min_hash_code, hash_code);
+        properties_.max_hash_code = std::max(properties_.max_hash_code, hash_code);
+      }
+    }
+
+    if (key[0] == static_cast<uint8_t>(ValueType::kIntentPrefix)) {
+      // The values of intents start with the transaction id, so only the intents themselves are
+      // counted.
+      if (key.size() > 1 && key[1] != static_cast<uint8_t>(ValueType::kTransactionId)) {
+        ++properties_.num_intents;
+      }
+      return Status::OK();
+    }
+
+    ValueType value_type;
+    if (Value::DecodePrimitiveValueType(value, &value_type).ok() &&
+        value_type == ValueType::kTombstone) {
+      ++properties_.num_tombstones;
+    }
+    MonoDelta ttl;
+    if (Value::DecodeTTL(value, &ttl).ok() && !ttl.Equals(Value::kMaxTtl)) {
+      ++properties_.num_ttl_values;
+    }
+
+    auto doc_key_size = DocKey::EncodedSize(key, DocKeyPart::WHOLE_DOC_KEY);
+    if (!doc_key_size.ok() || *doc_key_size >= key.size() ||
+        key[*doc_key_size] != static_cast<uint8_t>(ValueType::kColumnId)) {
+      return Status::OK();
+    }
+    Slice subkey(key.data() + *doc_key_size, key.size() - *doc_key_size);
+    PrimitiveValue column;
+    if (PrimitiveValue::DecodeKey(&subkey, &column).ok()) {
+      column_ids_.insert(column.GetColumnId().rep());
+    }
+    return Status::OK();
+  }
+
+  Status Finish(rocksdb::UserCollectedProperties* properties) override {
+    *properties = GetReadableProperties();
+    return Status::OK();
+  }
+
+  rocksdb::UserCollectedProperties GetReadableProperties() const override {
+    rocksdb::UserCollectedProperties result = {
+      {kColumnIdsPropertyName, JoinInts(column_ids_, ",")},
+      {kNumTombstonesPropertyName, std::to_string(properties_.num_tombstones)},
+      {kNumTtlValuesPropertyName, std::to_string(properties_.num_ttl_values)},
+      {kNumIntentsPropertyName, std::to_string(properties_.num_intents)},
+    };
+    if (properties_.has_hash_codes) {
+      result.emplace(kMinHashCodePropertyName, std::to_string(properties_.min_hash_code));
+      result.emplace(kMaxHashCodePropertyName, std::to_string(properties_.max_hash_code));
+    }
+    return result;
+  }
+
+  const char* Name() const override {
+    return "DocDBTablePropertiesCollector";
+  }
+
+ private:
+  DocDBTableProperties properties_;
+  // Kept ordered, so that the ids are listed in a stable order.
+  std::set<ColumnIdRep> column_ids_;
+};
+
+class DocDBTablePropertiesCollectorFactory : public rocksdb::TablePropertiesCollectorFactory {
+ public:
+  rocksdb::TablePropertiesCollector* CreateTablePropertiesCollector(
+      rocksdb::TablePropertiesCollectorFactory::Context context) override {
+    return new DocDBTablePropertiesCollector();
+  }
+
+  const char* Name() const override {
+    return "DocDBTablePropertiesCollectorFactory";
+  }
+};
+
+// Parses the property with the given name into value, which is left untouched when the property
+// is missing. Returns false if the property is malformed.
+template <class T>
+bool ParseUint64Property(const rocksdb::UserCollectedProperties& properties, const char* name,
+                         T* value) {
+  auto it = properties.find(name);
+  if (it == properties.end()) {
+    return true;
+  }
+  uint64_t parsed;
+  if (!safe_strtou64(it->second, &parsed) || parsed > std::numeric_limits<T>::max()) {
+    return false;
+  }
+  *value = static_cast<T>(parsed);
+  return true;
+}
+
+} // namespace
+
+bool GetDocDBTableProperties(const rocksdb::TableProperties& properties,
+                             DocDBTableProperties* docdb_properties) {
+  const auto& user_properties = properties.user_collected_properties;
+  auto it = user_properties.find(kColumnIdsPropertyName);
+  if (it == user_properties.end()) {
+    return false;
+  }
+  *docdb_properties = DocDBTableProperties();
+  const std::vector<std::string> ids = strings::Split(it->second, ",", strings::SkipEmpty());
+  for (const auto& id : ids) {
+    ColumnIdRep rep;
+    if (!safe_strto32(id, &rep)) {
+      return false;
+    }
+    docdb_properties->column_ids.insert(ColumnId(rep));
+  }
+  docdb_properties->has_hash_codes = user_properties.count(kMinHashCodePropertyName) != 0;
+  return ParseUint64Property(user_properties, kMinHashCodePropertyName,
+                             &docdb_properties->min_hash_code) &&
+         ParseUint64Property(user_properties, kMaxHashCodePropertyName,
+                             &docdb_properties->max_hash_code) &&
+         ParseUint64Property(user_properties, kNumTombstonesPropertyName,
+                             &docdb_properties->num_tombstones) &&
+         ParseUint64Property(user_properties, kNumTtlValuesPropertyName,
+                             &docdb_properties->num_ttl_values) &&
+         ParseUint64Property(user_properties, kNumIntentsPropertyName,
+                             &docdb_properties->num_intents);
 }
 
 void InitRocksDBOptions(
@@ -328,18 +734,37 @@ void InitRocksDBOptions(
     const tablet::TabletOptions& tablet_options) {
   options->create_if_missing = true;
   options->disableDataSync = true;
+  // The Raft log is the only write-ahead log, the writes that were not flushed are replayed from
+  // it by the tablet bootstrap.
+  options->disable_wal = true;
   options->statistics = statistics;
   options->info_log = std::make_shared<YBRocksDBLogger>(Substitute("T $0: ", tablet_id));
   options->info_log_level = YBRocksDBLogger::ConvertToRocksDBLogLevel(FLAGS_minloglevel);
   options->initial_seqno = FLAGS_initial_seqno;
   options->boundary_extractor = DocBoundaryValuesExtractorInstance();
   options->memory_monitor = tablet_options.memory_monitor;
+  options->compaction_scheduler = tablet_options.compaction_scheduler;
+  options->table_cache = tablet_options.table_cache;
+  options->allow_concurrent_memtable_write = FLAGS_rocksdb_allow_concurrent_memtable_write;
+  options->enable_write_thread_adaptive_yield = FLAGS_rocksdb_enable_write_thread_adaptive_yield;
+  options->max_pooled_iterators = std::max(FLAGS_rocksdb_max_pooled_iterators, 0);
+  options->use_direct_io_for_flush_and_compaction =
+      FLAGS_rocksdb_use_direct_io_for_flush_and_compaction;
+  if (FLAGS_use_docdb_hash_indexed_memtable) {
+    options->memtable_factory.reset(rocksdb::NewHashIndexedSkipListRepFactory(
+        std::make_shared<DocKeyHashedPrefixTransform>(),
+        std::max(FLAGS_docdb_memtable_hash_bucket_count, 1)));
+  }
   if (FLAGS_db_write_buffer_size != -1) {
     options->write_buffer_size = FLAGS_db_write_buffer_size;
   }
+  options->compression = ParseCompressionType(FLAGS_db_compression_type);
+  options->compression_opts.max_dict_bytes = std::max(FLAGS_db_compression_max_dict_bytes, 0);
   options->listeners.insert(
       options->listeners.end(), tablet_options.listeners.begin(),
       tablet_options.listeners.end()); // Append listeners
+  options->table_properties_collector_factories.push_back(
+      std::make_shared<DocDBTablePropertiesCollectorFactory>());
 
   // Set block cache options.
   rocksdb::BlockBasedTableOptions table_options;
@@ -351,12 +776,24 @@ void InitRocksDBOptions(
     table_options.no_block_cache = true;
     table_options.cache_index_and_filter_blocks = false;
   }
+  table_options.block_cache_compressed = tablet_options.block_cache_compressed;
   table_options.block_size = FLAGS_db_block_size_bytes;
+  if (FLAGS_db_index_block_size_bytes > 0) {
+    table_options.index_type = rocksdb::BlockBasedTableOptions::kTwoLevelIndexSearch;
+    table_options.index_block_size = FLAGS_db_index_block_size_bytes;
+  }
+  table_options.max_scan_readahead_size = std::max<int64_t>(
+      FLAGS_db_max_scan_readahead_size_bytes, 0);
+  table_options.share_key_suffixes = FLAGS_docdb_share_key_suffixes;
+  if (FLAGS_docdb_data_block_hash_index) {
+    table_options.data_block_hash_key_extractor = std::make_shared<DocKeyPrefixTransform>();
+  }
 
   // Set our custom bloom filter that is docdb aware.
   if (FLAGS_use_docdb_aware_bloom_filter) {
     table_options.filter_policy.reset(new DocDbAwareFilterPolicy(
-        table_options.filter_block_size * 8, options->info_log.get()));
+        table_options.filter_block_size * 8, options->info_log.get(),
+        FLAGS_use_docdb_lane_blocked_bloom_filter));
   }
 
   options->table_factory.reset(rocksdb::NewBlockBasedTableFactory(table_options));
@@ -386,7 +823,13 @@ void InitRocksDBOptions(
         FLAGS_rocksdb_universal_compaction_size_ratio;
     options->compaction_options_universal.min_merge_width =
         FLAGS_rocksdb_universal_compaction_min_merge_width;
+    options->compaction_options_universal.small_output_size_bytes =
+        FLAGS_rocksdb_universal_compaction_small_output_size_bytes;
+    options->compaction_options_universal.small_output_compression =
+        ParseCompressionType(FLAGS_rocksdb_universal_compaction_small_output_compression);
     options->compaction_size_threshold_bytes = FLAGS_rocksdb_compaction_size_threshold_bytes;
+    options->max_subcompactions = std::max(
+        std::min(FLAGS_rocksdb_max_subcompactions, FLAGS_rocksdb_max_background_compactions), 1);
     if (FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec > 0) {
       options->rate_limiter.reset(
           rocksdb::NewGenericRateLimiter(FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec));
@@ -399,5 +842,125 @@ void InitRocksDBOptions(
   }
 }
 
+void InitPointLookupRocksDBOptions(rocksdb::Options* options) {
+  if (!FLAGS_redis_hash_indexed_sst_files) {
+    return;
+  }
+  auto table_options = *static_cast<rocksdb::BlockBasedTableOptions*>(
+      CHECK_NOTNULL(options->table_factory->GetOptions()));
+  table_options.index_type = rocksdb::BlockBasedTableOptions::kHashSearch;
+  options->table_factory.reset(rocksdb::NewBlockBasedTableFactory(table_options));
+  // The files written before keep their binary search index, and the files written with the hash
+  // index fall back to binary search without the prefix extractor.
+  options->prefix_extractor = std::make_shared<DocKeyHashedPrefixTransform>();
+}
+
+namespace {
+
+// Infix of the names of the directories renamed by DestroyDBInBackground.
+const char kDestroyedDBInfix[] = ".destroyed.";
+
+// The destroyed directories that are being deleted, so the leftover cleanup skips them.
+std::mutex destroyed_dirs_mutex;
+std::set<std::string> destroyed_dirs_in_progress;
+
+CHECKED_STATUS ListFilesRecursively(Env* env, const std::string& dir,
+                                    std::vector<std::string>* files) {
+  std::vector<std::string> children;
+  RETURN_NOT_OK(env->GetChildren(dir, &children));
+  for (const auto& child : children) {
+    if (child == "." || child == "..") {
+      continue;
+    }
+    const std::string path = JoinPathSegments(dir, child);
+    bool is_dir = false;
+    RETURN_NOT_OK(env->IsDirectory(path, &is_dir));
+    if (is_dir) {
+      RETURN_NOT_OK(ListFilesRecursively(env, path, files));
+    } else {
+      files->push_back(path);
+    }
+  }
+  return Status::OK();
+}
+
+void DeleteDestroyedDB(const std::string& dir) {
+  Env* env = Env::Default();
+  std::vector<std::string> files;
+  Status status = ListFilesRecursively(env, dir, &files);
+  if (status.ok()) {
+    // The directory is the trash directory of the scheduler, the files of the nested directories
+    // are moved into it before they are unlinked.
+    rocksdb::DeleteScheduler scheduler(
+        rocksdb::Env::Default(), dir, FLAGS_rocksdb_destroy_rate_bytes_per_sec,
+        nullptr /* info_log */, nullptr /* sst_file_manager */);
+    for (const auto& file : files) {
+      status = scheduler.DeleteFile(file);
+      if (!status.ok()) {
+        break;
+      }
+    }
+    scheduler.WaitForEmptyTrash();
+  }
+  if (status.ok()) {
+    status = env->DeleteRecursively(dir);
+  }
+  if (status.ok()) {
+    LOG(INFO) << "Deleted destroyed RocksDB directory " << dir;
+  } else {
+    LOG(WARNING) << "Failed to delete destroyed RocksDB directory " << dir << ": " << status;
+  }
+  std::lock_guard<std::mutex> lock(destroyed_dirs_mutex);
+  destroyed_dirs_in_progress.erase(dir);
+}
+
+CHECKED_STATUS DeleteDestroyedDBInBackground(const std::string& dir) {
+  {
+    std::lock_guard<std::mutex> lock(destroyed_dirs_mutex);
+    if (!destroyed_dirs_in_progress.insert(dir).second) {
+      return Status::OK();
+    }
+  }
+  scoped_refptr<Thread> thread;
+  Status status = Thread::Create("docdb", "destroy_db", &DeleteDestroyedDB, dir, &thread);
+  if (!status.ok()) {
+    std::lock_guard<std::mutex> lock(destroyed_dirs_mutex);
+    destroyed_dirs_in_progress.erase(dir);
+  }
+  return status;
+}
+
+}  // namespace
+
+Status DestroyDBInBackground(const std::string& db_dir) {
+  Env* env = Env::Default();
+  if (!env->FileExists(db_dir)) {
+    return Status::OK();
+  }
+  const std::string destroyed_dir =
+      db_dir + kDestroyedDBInfix + rocksdb::Env::Default()->GenerateUniqueId();
+  RETURN_NOT_OK(env->RenameFile(db_dir, destroyed_dir));
+  RETURN_NOT_OK(env->SyncDir(DirName(db_dir)));
+  LOG(INFO) << "Renamed RocksDB directory " << db_dir << " to " << destroyed_dir
+            << " to delete it in the background";
+  return DeleteDestroyedDBInBackground(destroyed_dir);
+}
+
+void DestroyLeftoverDBsInBackground(const std::string& db_dir) {
+  Env* env = Env::Default();
+  const std::string parent_dir = DirName(db_dir);
+  std::vector<std::string> children;
+  if (!env->FileExists(parent_dir) || !env->GetChildren(parent_dir, &children).ok()) {
+    return;
+  }
+  for (const auto& child : children) {
+    if (child.find(kDestroyedDBInfix) == std::string::npos) {
+      continue;
+    }
+    const std::string dir = JoinPathSegments(parent_dir, child);
+    WARN_NOT_OK(DeleteDestroyedDBInBackground(dir), "Failed to delete " + dir);
+  }
+}
+
 }  // namespace docdb
 }  // namespace yb
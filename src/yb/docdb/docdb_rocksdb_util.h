@@ -23,6 +23,7 @@
 #include "yb/docdb/value.h"
 
 #include "yb/rocksdb/cache.h"
+#include "yb/rocksdb/compaction_filter.h"
 #include "yb/rocksdb/db.h"
 #include "yb/rocksdb/options.h"
 
@@ -49,25 +50,61 @@ Status SeekToValidKvAtTs(
     bool *is_found = nullptr,
     Value *found_value = nullptr);
 
+// Per-iterator state of PerformRocksDBSeek. Adapts the number of Next() calls tried before doing
+// an actual Seek() to the distances between the keys seeked on the iterator: the limit is doubled
+// when the target is reached close to it, halved when it is exhausted, and reset to
+// max_nexts_to_avoid_seek from time to time to notice that rows became shorter. Also counts the
+// Next() and Seek() calls, for per-row statistics.
+class NextOrSeekPolicy {
+ public:
+  NextOrSeekPolicy();
+
+  // Number of Next() calls to try before doing an actual Seek().
+  int max_nexts() const { return max_nexts_; }
+
+  // Records a forward positioning that did nexts Next() calls, followed by an actual Seek() if
+  // seeked is true.
+  void Record(int nexts, bool seeked);
+
+  // Records an actual Seek() that did not try Next() calls, e.g. a backward one.
+  void RecordSeek() { ++num_seeks_; }
+
+  void RecordNext() { ++num_nexts_; }
+
+  uint64_t num_nexts() const { return num_nexts_; }
+  uint64_t num_seeks() const { return num_seeks_; }
+
+ private:
+  int max_nexts_;
+  int records_since_reset_ = 0;
+  uint64_t num_nexts_ = 0;
+  uint64_t num_seeks_ = 0;
+};
+
 // See to a rocksdb point that is at least sub_doc_key.
 // If the iterator is already positioned far enough, does not perform a seek.
-void SeekForward(const rocksdb::Slice& slice, rocksdb::Iterator *iter);
+void SeekForward(const rocksdb::Slice& slice, rocksdb::Iterator *iter,
+                 NextOrSeekPolicy* policy = nullptr);
 
-void SeekForward(const KeyBytes& key_bytes, rocksdb::Iterator *iter);
+void SeekForward(const KeyBytes& key_bytes, rocksdb::Iterator *iter,
+                 NextOrSeekPolicy* policy = nullptr);
 
 // When we replace HybridTime::kMin in the end of seek key, next seek will skip older versions of
 // this key, but will not skip any subkeys in its subtree. If the iterator is already positioned far
 // enough, does not perform a seek.
-void SeekPastSubKey(const SubDocKey& sub_doc_key, rocksdb::Iterator* iter);
+void SeekPastSubKey(const SubDocKey& sub_doc_key, rocksdb::Iterator* iter,
+                    NextOrSeekPolicy* policy = nullptr);
 
 // A wrapper around the RocksDB seek operation that uses Next() up to the configured number of
-// times to avoid invalidating iterator state. In debug mode it also allows printing detailed
-// information about RocksDB seeks.
+// times to avoid invalidating iterator state. When policy is specified, the number of Next() calls
+// is adapted by it. In debug mode it also allows printing detailed information about RocksDB
+// seeks.
 void PerformRocksDBSeek(
     rocksdb::Iterator *iter,
     const rocksdb::Slice &seek_key,
     const char* file_name,
-    int line);
+    int line,
+    NextOrSeekPolicy* policy = nullptr);
 
 // Positions the iterator at the largest key k <= seek_key
 void PerformRocksDBReverseSeek(
@@ -106,8 +143,34 @@ std::unique_ptr<rocksdb::Iterator> CreateRocksDBIterator(
     const rocksdb::QueryId query_id,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter = nullptr);
 
+// Returns a file filter that skips the SST files without any record written in
+// [min_hybrid_time, max_hybrid_time] and the files skipped by next, when it is set. With a
+// min_hybrid_time, only records written at or after it are visible, e.g. for "rows written since T"
+// reads.
+std::shared_ptr<rocksdb::ReadFileFilter> CreateHybridTimeFileFilter(
+    HybridTime min_hybrid_time, HybridTime max_hybrid_time,
+    std::shared_ptr<rocksdb::ReadFileFilter> next = nullptr);
+
+// Files are ordered from the newest to the oldest. Returns the number of the oldest files whose
+// records all expire by history_cutoff, according to the boundary hybrid times and value TTLs
+// recorded by DocBoundaryValuesExtractor, and are older than the records of the other files. Such
+// files could be deleted without compacting them.
+size_t NumExpiredOldestFiles(const std::vector<rocksdb::FileMetaData*>& files,
+                             HybridTime history_cutoff, MonoDelta table_ttl);
+
+struct ColumnValueBounds;
+
+// Returns false when no record of rocksdb can hold a column value within one of the bounds,
+// according to the column zone maps recorded with FLAGS_docdb_column_zone_maps. Skipping a single
+// file is not safe, since the newer records of a row in the other files could delete or overwrite
+// its values, so the decision is taken for all the files at once, and only while the memtables are
+// empty, e.g. for bulk loaded or frozen analytics tables.
+bool ColumnValuesMayExist(rocksdb::DB* rocksdb, const std::vector<ColumnValueBounds>& bounds);
+
 // Values and transactions committed later than high_ht can be skipped, so we won't spend time
 // for re-requesting pending transaction status if we already know it wasn't committed at high_ht.
+// SST files with records written only after read_time.global_limit are skipped, see
+// FLAGS_use_docdb_hybrid_time_file_filter.
 std::unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
     rocksdb::DB* rocksdb,
     BloomFilterMode bloom_filter_mode,
@@ -117,6 +180,43 @@ std::unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
     const ReadHybridTime& read_time,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter = nullptr);
 
+// Creates an iterator over a tailing RocksDB iterator, see rocksdb::ReadOptions::tailing. The
+// RocksDB iterator is kept by the DB when the returned iterator is destroyed, and the next tailing
+// iterator reuses it, only building iterators for the memtables and files written in between.
+// Only supports forward positioning, and does not use bloom filters, so is meant for repeated
+// forward range reads of the newest records, e.g. polls of recent time series points.
+std::unique_ptr<IntentAwareIterator> CreateTailingIntentAwareIterator(
+    rocksdb::DB* rocksdb,
+    const rocksdb::QueryId query_id,
+    const TransactionOperationContextOpt& transaction_context,
+    const ReadHybridTime& read_time);
+
+// Statistics about the DocDB records of an SST file, recorded in its table properties while the
+// file is written.
+struct DocDBTableProperties {
+  // Ids of the columns that have values in the file.
+  ColumnIds column_ids;
+
+  // Range of the hash codes of the document keys in the file, when any of them has one.
+  bool has_hash_codes = false;
+  DocKeyHash min_hash_code = 0;
+  DocKeyHash max_hash_code = 0;
+
+  // Number of deletions, i.e. DocDB tombstones and RocksDB delete markers.
+  uint64_t num_tombstones = 0;
+
+  // Number of values with a TTL, which could expire and be removed by a compaction.
+  uint64_t num_ttl_values = 0;
+
+  // Number of provisional records of transactions, not counting their reverse index.
+  uint64_t num_intents = 0;
+};
+
+// Reads the DocDB statistics of an SST file from its table properties. Returns false if the file
+// was written without them.
+bool GetDocDBTableProperties(const rocksdb::TableProperties& properties,
+                             DocDBTableProperties* docdb_properties);
+
 // Initialize the RocksDB 'options' object for tablet identified by 'tablet_id'. The 'statistics'
 // object provided by the caller will be used by RocksDB to maintain the stats for the tablet
 // specified by 'tablet_id'.
@@ -125,6 +225,21 @@ void InitRocksDBOptions(
     const std::shared_ptr<rocksdb::Statistics>& statistics,
     const tablet::TabletOptions& tablet_options);
 
+// Adjusts the options initialized by InitRocksDBOptions for a table whose reads either look up a
+// single DocKey, with the bloom filter, or scan in total order, e.g. a Redis table. With
+// FLAGS_redis_hash_indexed_sst_files, the SST files get a hash index keyed by the hashed part of
+// the DocKey, and the lookups bounded to one DocKey find their data block in O(1).
+void InitPointLookupRocksDBOptions(rocksdb::Options* options);
+
+// Renames the RocksDB directory db_dir, together with the intents DB nested in it, out of the way
+// and deletes the renamed directory in the background, unlinking its files at the rate of
+// FLAGS_rocksdb_destroy_rate_bytes_per_sec. A new database could be created at db_dir right away.
+CHECKED_STATUS DestroyDBInBackground(const std::string& db_dir);
+
+// Deletes the directories that DestroyDBInBackground left next to db_dir, e.g. because of a crash,
+// in the background.
+void DestroyLeftoverDBsInBackground(const std::string& db_dir);
+
 }  // namespace docdb
 }  // namespace yb
 
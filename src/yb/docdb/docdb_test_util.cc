@@ -66,6 +66,15 @@ class NonTransactionalStatusProvider: public TransactionStatusManager {
     Fail();
   }
 
+  HybridTime ResolvedCommitTime(const TransactionId& id) override {
+    Fail();
+    return HybridTime::kInvalidHybridTime;
+  }
+
+  void TransactionResolved(const TransactionId& id, HybridTime commit_time) override {
+    Fail();
+  }
+
   boost::optional<TransactionMetadata> Metadata(const TransactionId& id) override {
     Fail();
     return boost::none;
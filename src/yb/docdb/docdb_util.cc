@@ -205,6 +205,10 @@ void DocDBRocksDBUtil::SetHistoryCutoffHybridTime(HybridTime history_cutoff) {
   retention_policy_->SetHistoryCutoff(history_cutoff);
 }
 
+void DocDBRocksDBUtil::SetRestoreHybridTime(HybridTime restore_ht) {
+  retention_policy_->SetRestoreHybridTime(restore_ht);
+}
+
 void DocDBRocksDBUtil::SetTableTTL(uint64_t ttl_msec) {
   schema_.SetDefaultTimeToLive(ttl_msec);
   retention_policy_->SetTableTTLForTests(MonoDelta::FromMilliseconds(ttl_msec));
@@ -88,6 +88,8 @@ class DocDBRocksDBUtil {
 
   void SetHistoryCutoffHybridTime(HybridTime history_cutoff);
 
+  void SetRestoreHybridTime(HybridTime restore_ht);
+
   // Produces a string listing the contents of the entire RocksDB database, with every key and value
   // decoded as a DocDB key/value and converted to a human-readable string representation.
   std::string DocDBDebugDumpToStr();
@@ -14,11 +14,15 @@
 #include <memory>
 #include <string>
 
+#include "yb/common/ql_expr.h"
+
+#include "yb/docdb/doc_ql_scanspec.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/docdb.h"
 #include "yb/docdb/docdb_test_base.h"
 #include "yb/docdb/docdb_test_util.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/packed_row.h"
 
 #include "yb/server/hybrid_clock.h"
 
@@ -26,6 +30,8 @@
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
 
+DECLARE_bool(docdb_point_read_fast_path);
+
 namespace yb {
 namespace docdb {
 
@@ -135,12 +141,11 @@ TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorTest) {
         ReadHybridTime::FromMicros(2000));
     ASSERT_OK(iter.Init(&scan_spec));
 
-    RowBlock row_block(projection, 10, &arena);
+    RowBlock row_block(projection, 1, &arena);
 
     ASSERT_TRUE(iter.HasNext());
     ASSERT_OK(iter.NextBlock(&row_block));
-    // Current implementation of DocRowwiseIterator::NextBlock always returns 1 row if there are
-    // next rows.
+    // The row block has capacity for one row, so NextBlock returns rows one at a time.
     ASSERT_EQ(1, row_block.nrows());
 
     const auto &row1 = row_block.row(0);
@@ -155,8 +160,7 @@ TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorTest) {
     ASSERT_OK(iter.NextBlock(&row_block));
     const auto &row2 = row_block.row(0);
 
-    // Current implementation of DocRowwiseIterator::NextBlock always returns 1 row if there are
-    // next rows.
+    // The row block has capacity for one row, so NextBlock returns rows one at a time.
     ASSERT_EQ(1, row_block.nrows());
     ASSERT_TRUE(row_block.row(0).is_null(0));
     ASSERT_FALSE(row_block.row(0).is_null(1));
@@ -174,12 +178,11 @@ TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorTest) {
         projection, schema, kNonTransactionalOperationContext, rocksdb(),
         ReadHybridTime::FromMicros(5000));
     ASSERT_OK(iter.Init(&scan_spec));
-    RowBlock row_block(projection, 10, &arena);
+    RowBlock row_block(projection, 1, &arena);
 
     ASSERT_TRUE(iter.HasNext());
     ASSERT_OK(iter.NextBlock(&row_block));
-    // Current implementation of DocRowwiseIterator::NextBlock always returns 1 row if there are
-    // next rows.
+    // The row block has capacity for one row, so NextBlock returns rows one at a time.
     ASSERT_EQ(1, row_block.nrows());
 
     // This row is exactly the same as in the previous case. TODO: deduplicate.
@@ -195,8 +198,7 @@ TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorTest) {
     ASSERT_OK(iter.NextBlock(&row_block));
     const auto &row2 = row_block.row(0);
 
-    // Current implementation of DocRowwiseIterator::NextBlock always returns 1 row if there are
-    // next rows.
+    // The row block has capacity for one row, so NextBlock returns rows one at a time.
     ASSERT_EQ(1, row_block.nrows());
     ASSERT_TRUE(row_block.row(0).is_null(0));
     ASSERT_FALSE(row_block.row(0).is_null(1));
@@ -250,12 +252,12 @@ TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorDeletedDocumentTest) {
         ReadHybridTime::FromMicros(2500));
     ASSERT_OK(iter.Init(&scan_spec));
 
-    RowBlock row_block(projection, 10, &arena);
+    RowBlock row_block(projection, 1, &arena);
 
     ASSERT_TRUE(iter.HasNext());
     ASSERT_OK(iter.NextBlock(&row_block));
-    // Current implementation of DocRowwiseIterator::NextBlock always returns 1 row if there are
-    // next rows. Anyway in this specific test we only have one row matching criteria.
+    // The row block has capacity for one row. Anyway in this specific test we only have one row
+    // matching criteria.
     ASSERT_EQ(1, row_block.nrows());
 
     const auto &row2 = row_block.row(0);
@@ -310,7 +312,7 @@ SubDocKey(DocKey([], ["row2", 22222]), [ColumnId(40); HT{ physical: 2800 w: 1 }]
         ReadHybridTime::FromMicros(2800));
     ASSERT_OK(iter.Init(&scan_spec));
 
-    RowBlock row_block(projection, 10, &arena);
+    RowBlock row_block(projection, 1, &arena);
 
     ASSERT_TRUE(iter.HasNext());
 
@@ -365,7 +367,7 @@ SubDocKey(DocKey([], ["row1", 11111]), [ColumnId(50); HT{ physical: 2800 }]) ->
         ReadHybridTime::FromMicros(2800));
     ASSERT_OK(iter.Init(&scan_spec));
 
-    RowBlock row_block(projection, 10, &arena);
+    RowBlock row_block(projection, 1, &arena);
 
     ASSERT_TRUE(iter.HasNext());
     // Ensure calling HasNext() again doesn't mess up anything.
@@ -414,7 +416,7 @@ TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorIncompleteProjection) {
         ReadHybridTime::FromMicros(2800));
     ASSERT_OK(iter.Init(&scan_spec));
 
-    RowBlock row_block(projection, 10, &arena);
+    RowBlock row_block(projection, 1, &arena);
 
     ASSERT_TRUE(iter.HasNext());
     ASSERT_OK(iter.NextBlock(&row_block));
@@ -493,7 +495,7 @@ SubDocKey(DocKey([], ["row2", 22222]), [ColumnId(50); HT{ physical: 2800 w: 3 }]
         projection, schema, kNonTransactionalOperationContext, rocksdb(), read_time);
     ASSERT_OK(iter.Init(&scan_spec));
 
-    RowBlock row_block(projection, 10, &arena);
+    RowBlock row_block(projection, 1, &arena);
 
     ASSERT_TRUE(iter.HasNext());
     // Ensure Idempotency.
@@ -551,7 +553,7 @@ TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorValidColumnNotInProjection) {
         projection, schema, kNonTransactionalOperationContext, rocksdb(),
         ReadHybridTime::FromMicros(2800));
     ASSERT_OK(iter.Init(&scan_spec));
-    RowBlock row_block(projection, 10, &arena);
+    RowBlock row_block(projection, 1, &arena);
 
     ASSERT_TRUE(iter.HasNext());
 
@@ -601,7 +603,7 @@ SubDocKey(DocKey([], ["row1", 11111]), [ColumnId(50); HT{ physical: 1000 w: 1 }]
         projection, schema, kNonTransactionalOperationContext, rocksdb(),
         ReadHybridTime::FromMicros(2800));
     ASSERT_OK(iter.Init(&scan_spec));
-    RowBlock row_block(projection, 10, &arena);
+    RowBlock row_block(projection, 1, &arena);
 
     ASSERT_TRUE(iter.HasNext());
 
@@ -615,6 +617,83 @@ SubDocKey(DocKey([], ["row1", 11111]), [ColumnId(50); HT{ physical: 1000 w: 1 }]
   }
 }
 
+TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorMultiRowBlock) {
+  auto dwb = MakeDocWriteBatch();
+
+  const KeyBytes encoded_doc_key3(DocKey(PrimitiveValues("row3", 33333)).Encode());
+  ASSERT_OK(dwb.SetPrimitive(DocPath(kEncodedDocKey1, PrimitiveValue(40_ColId)),
+      PrimitiveValue(10000)));
+  ASSERT_OK(dwb.SetPrimitive(DocPath(kEncodedDocKey2, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row2_c")));
+  ASSERT_OK(dwb.SetPrimitive(DocPath(encoded_doc_key3, PrimitiveValue(40_ColId)),
+      PrimitiveValue(30000)));
+  ASSERT_OK(dwb.SetPrimitive(DocPath(encoded_doc_key3, PrimitiveValue(50_ColId)),
+      PrimitiveValue("row3_e")));
+  ASSERT_OK(WriteToRocksDB(dwb, HybridTime::FromMicros(1000)));
+
+  const Schema &schema = kSchemaForIteratorTests;
+  const Schema &projection = kProjectionForIteratorTests;
+  ScanSpec scan_spec;
+  Arena arena(32_KB, 1_MB);
+
+  // All rows fit into one block.
+  {
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, rocksdb(),
+        ReadHybridTime::FromMicros(2000));
+    ASSERT_OK(iter.Init(&scan_spec));
+    RowBlock row_block(projection, 10, &arena);
+
+    ASSERT_TRUE(iter.HasNext());
+    ASSERT_OK(iter.NextBlock(&row_block));
+    ASSERT_EQ(3, row_block.nrows());
+    ASSERT_EQ(3, row_block.selection_vector()->CountSelected());
+
+    const auto &row1 = row_block.row(0);
+    ASSERT_TRUE(row1.is_null(0));
+    ASSERT_FALSE(row1.is_null(1));
+    ASSERT_EQ(10000, row1.get_field<DataType::INT64>(1));
+    ASSERT_TRUE(row1.is_null(2));
+
+    const auto &row2 = row_block.row(1);
+    ASSERT_FALSE(row2.is_null(0));
+    ASSERT_EQ("row2_c", row2.get_field<DataType::STRING>(0));
+    ASSERT_TRUE(row2.is_null(1));
+    ASSERT_TRUE(row2.is_null(2));
+
+    const auto &row3 = row_block.row(2);
+    ASSERT_TRUE(row3.is_null(0));
+    ASSERT_FALSE(row3.is_null(1));
+    ASSERT_EQ(30000, row3.get_field<DataType::INT64>(1));
+    ASSERT_FALSE(row3.is_null(2));
+    ASSERT_EQ("row3_e", row3.get_field<DataType::STRING>(2));
+
+    ASSERT_FALSE(iter.HasNext());
+  }
+
+  // Rows are split across blocks when they don't fit into one.
+  {
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, rocksdb(),
+        ReadHybridTime::FromMicros(2000));
+    ASSERT_OK(iter.Init(&scan_spec));
+    RowBlock row_block(projection, 2, &arena);
+
+    ASSERT_TRUE(iter.HasNext());
+    ASSERT_OK(iter.NextBlock(&row_block));
+    ASSERT_EQ(2, row_block.nrows());
+    ASSERT_EQ(10000, row_block.row(0).get_field<DataType::INT64>(1));
+    ASSERT_EQ("row2_c", row_block.row(1).get_field<DataType::STRING>(0));
+
+    ASSERT_TRUE(iter.HasNext());
+    ASSERT_OK(iter.NextBlock(&row_block));
+    ASSERT_EQ(1, row_block.nrows());
+    ASSERT_EQ("row3_e", row_block.row(0).get_field<DataType::STRING>(2));
+
+    ASSERT_FALSE(iter.HasNext());
+  }
+}
+
 namespace {
 
 class TransactionStatusManagerMock : public TransactionStatusManager {
@@ -640,6 +719,13 @@ class TransactionStatusManagerMock : public TransactionStatusManager {
     txn_commit_time_.emplace(txn_id, commit_time);
   }
 
+  HybridTime ResolvedCommitTime(const TransactionId& id) override {
+    return HybridTime::kInvalidHybridTime;
+  }
+
+  void TransactionResolved(const TransactionId& id, HybridTime commit_time) override {
+  }
+
   boost::optional<TransactionMetadata> Metadata(const TransactionId& id) override {
     return boost::none;
   }
@@ -772,12 +858,11 @@ SubDocKey(DocKey([], ["row2", 22222]), [ColumnId(50); HT{ physical: 2000 }]) ->
         projection, schema, txn_context, rocksdb(), ReadHybridTime::FromMicros(2000));
     ASSERT_OK(iter.Init(&scan_spec));
 
-    RowBlock row_block(projection, 10, &arena);
+    RowBlock row_block(projection, 1, &arena);
 
     ASSERT_TRUE(iter.HasNext());
     ASSERT_OK(iter.NextBlock(&row_block));
-    // Current implementation of DocRowwiseIterator::NextBlock always returns 1 row if there are
-    // next rows.
+    // The row block has capacity for one row, so NextBlock returns rows one at a time.
     ASSERT_EQ(1, row_block.nrows());
 
     const auto& row1 = row_block.row(0);
@@ -792,8 +877,7 @@ SubDocKey(DocKey([], ["row2", 22222]), [ColumnId(50); HT{ physical: 2000 }]) ->
     ASSERT_OK(iter.NextBlock(&row_block));
     const auto &row2 = row_block.row(0);
 
-    // Current implementation of DocRowwiseIterator::NextBlock always returns 1 row if there are
-    // next rows.
+    // The row block has capacity for one row, so NextBlock returns rows one at a time.
     ASSERT_EQ(1, row_block.nrows());
     ASSERT_TRUE(row2.is_null(0));
     ASSERT_FALSE(row2.is_null(1));
@@ -811,12 +895,11 @@ SubDocKey(DocKey([], ["row2", 22222]), [ColumnId(50); HT{ physical: 2000 }]) ->
     DocRowwiseIterator iter(
         projection, schema, txn_context, rocksdb(), ReadHybridTime::FromMicros(5000));
     ASSERT_OK(iter.Init(&scan_spec));
-    RowBlock row_block(projection, 10, &arena);
+    RowBlock row_block(projection, 1, &arena);
 
     ASSERT_TRUE(iter.HasNext());
     ASSERT_OK(iter.NextBlock(&row_block));
-    // Current implementation of DocRowwiseIterator::NextBlock always returns 1 row if there are
-    // next rows.
+    // The row block has capacity for one row, so NextBlock returns rows one at a time.
     ASSERT_EQ(1, row_block.nrows());
 
     const auto &row1 = row_block.row(0);
@@ -831,8 +914,7 @@ SubDocKey(DocKey([], ["row2", 22222]), [ColumnId(50); HT{ physical: 2000 }]) ->
     ASSERT_OK(iter.NextBlock(&row_block));
     const auto &row2 = row_block.row(0);
 
-    // Current implementation of DocRowwiseIterator::NextBlock always returns 1 row if there are
-    // next rows.
+    // The row block has capacity for one row, so NextBlock returns rows one at a time.
     ASSERT_EQ(1, row_block.nrows());
     ASSERT_TRUE(row2.is_null(0));
     ASSERT_FALSE(row2.is_null(1));
@@ -849,12 +931,11 @@ SubDocKey(DocKey([], ["row2", 22222]), [ColumnId(50); HT{ physical: 2000 }]) ->
     DocRowwiseIterator iter(
         projection, schema, txn_context, rocksdb(), ReadHybridTime::FromMicros(6000));
     ASSERT_OK(iter.Init(&scan_spec));
-    RowBlock row_block(projection, 10, &arena);
+    RowBlock row_block(projection, 1, &arena);
 
     ASSERT_TRUE(iter.HasNext());
     ASSERT_OK(iter.NextBlock(&row_block));
-    // Current implementation of DocRowwiseIterator::NextBlock always returns 1 row if there are
-    // next rows.
+    // The row block has capacity for one row, so NextBlock returns rows one at a time.
     ASSERT_EQ(1, row_block.nrows());
 
     const auto &row2 = row_block.row(0);
@@ -868,5 +949,152 @@ SubDocKey(DocKey([], ["row2", 22222]), [ColumnId(50); HT{ physical: 2000 }]) ->
   }
 }
 
+
+TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorPointReadFastPath) {
+  const KeyBytes encoded_doc_key3(DocKey(PrimitiveValues("row3", 33333)).Encode());
+  const KeyBytes encoded_doc_key4(DocKey(PrimitiveValues("row4", 44444)).Encode());
+  auto dwb = MakeDocWriteBatch();
+
+  ASSERT_OK(dwb.SetPrimitive(DocPath(kEncodedDocKey1, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row1_c")));
+  ASSERT_OK(dwb.SetPrimitive(DocPath(kEncodedDocKey1, PrimitiveValue(40_ColId)),
+      PrimitiveValue(10000)));
+  ASSERT_OK(dwb.SetPrimitive(DocPath(kEncodedDocKey2, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row2_c")));
+  ASSERT_OK(dwb.SetPrimitive(DocPath(encoded_doc_key3, PrimitiveValue(50_ColId)),
+      PrimitiveValue("row3_e")));
+  ASSERT_OK(dwb.SetPrimitive(DocPath(encoded_doc_key4, PrimitiveValue(30_ColId)),
+      Value(PrimitiveValue("row4_c"), MonoDelta::FromMilliseconds(1))));
+  ASSERT_OK(WriteToRocksDBAndClear(&dwb, HybridTime::FromMicros(1000)));
+
+  ASSERT_OK(dwb.DeleteSubDoc(DocPath(kEncodedDocKey1, PrimitiveValue(30_ColId))));
+  ASSERT_OK(dwb.DeleteSubDoc(DocPath(kEncodedDocKey2)));
+  ASSERT_OK(WriteToRocksDBAndClear(&dwb, HybridTime::FromMicros(2000)));
+
+  ASSERT_OK(dwb.SetPrimitive(DocPath(kEncodedDocKey1, PrimitiveValue(40_ColId)),
+      PrimitiveValue(20000)));
+  ASSERT_OK(dwb.SetPrimitive(DocPath(kEncodedDocKey2, PrimitiveValue(40_ColId)),
+      PrimitiveValue(30000)));
+  ASSERT_OK(WriteToRocksDBAndClear(&dwb, HybridTime::FromMicros(3000)));
+
+  const Schema &schema = kSchemaForIteratorTests;
+  Schema projection;
+  ASSERT_OK(kSchemaForIteratorTests.CreateProjectionByNames({"c", "d"}, &projection));
+
+  // Reads the row by its full primary key, returns the projected columns read or "not found".
+  auto read_row = [&](const KeyBytes& encoded_doc_key) -> std::string {
+    DocKey doc_key;
+    EXPECT_OK(doc_key.FullyDecodeFrom(encoded_doc_key.AsSlice()));
+    DocQLScanSpec spec(schema, doc_key, rocksdb::kDefaultQueryId);
+    DocRowwiseIterator iter(
+        projection, schema, boost::none, rocksdb(), ReadHybridTime::FromMicros(4000));
+    EXPECT_OK(iter.Init(spec));
+    if (!iter.HasNext()) {
+      return "not found";
+    }
+    auto row = std::make_shared<QLTableRow>();
+    EXPECT_OK(iter.NextRow(projection, row));
+    EXPECT_FALSE(iter.HasNext());
+    std::string result;
+    for (const ColumnId column_id : {30_ColId, 40_ColId}) {
+      const QLTableColumn* column = row->GetColumn(column_id.rep());
+      result += (column != nullptr ? column->value.ShortDebugString() : "absent") + "; ";
+    }
+    return result;
+  };
+
+  for (const bool fast_path : {true, false}) {
+    SCOPED_TRACE(Format("Fast path: $0", fast_path));
+    FLAGS_docdb_point_read_fast_path = fast_path;
+    // A column tombstone followed by an older value and a column overwritten later.
+    ASSERT_EQ("; int64_value: 20000; ", read_row(kEncodedDocKey1));
+    // A row tombstone, which is handled by GetSubDocument.
+    ASSERT_EQ("; int64_value: 30000; ", read_row(kEncodedDocKey2));
+    // Only a column that is not projected exists.
+    ASSERT_EQ("; ; ", read_row(encoded_doc_key3));
+    // The only column has expired.
+    ASSERT_EQ("not found", read_row(encoded_doc_key4));
+  }
+}
+
+TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorPackedRow) {
+  const KeyBytes encoded_doc_key3(DocKey(PrimitiveValues("row3", 33333)).Encode());
+  auto packed_row = [](PrimitiveValue c, PrimitiveValue d, PrimitiveValue e) {
+    PackedColumns columns = {
+        {PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn), PrimitiveValue()},
+        {PrimitiveValue(30_ColId), std::move(c)},
+        {PrimitiveValue(40_ColId), std::move(d)},
+        {PrimitiveValue(50_ColId), std::move(e)}};
+    std::sort(columns.begin(), columns.end(),
+              [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    return Value(PrimitiveValue::PackedRow(EncodePackedRow(columns)));
+  };
+  auto dwb = MakeDocWriteBatch();
+
+  ASSERT_OK(dwb.SetPrimitive(DocPath(kEncodedDocKey1, PrimitiveValue(40_ColId)),
+      PrimitiveValue(5)));
+  ASSERT_OK(WriteToRocksDBAndClear(&dwb, HybridTime::FromMicros(500)));
+
+  ASSERT_OK(dwb.SetPrimitive(DocPath(kEncodedDocKey1), packed_row(
+      PrimitiveValue("row1_c"), PrimitiveValue(10000), PrimitiveValue::kTombstone)));
+  ASSERT_OK(dwb.SetPrimitive(DocPath(kEncodedDocKey2), packed_row(
+      PrimitiveValue("row2_c"), PrimitiveValue(20000), PrimitiveValue("row2_e"))));
+  ASSERT_OK(dwb.SetPrimitive(DocPath(encoded_doc_key3), packed_row(
+      PrimitiveValue::kTombstone, PrimitiveValue(30000), PrimitiveValue::kTombstone)));
+  ASSERT_OK(WriteToRocksDBAndClear(&dwb, HybridTime::FromMicros(1000)));
+
+  ASSERT_OK(dwb.DeleteSubDoc(DocPath(kEncodedDocKey1, PrimitiveValue(30_ColId))));
+  ASSERT_OK(dwb.SetPrimitive(DocPath(kEncodedDocKey1, PrimitiveValue(50_ColId)),
+      PrimitiveValue("row1_e")));
+  ASSERT_OK(dwb.DeleteSubDoc(DocPath(kEncodedDocKey2)));
+  ASSERT_OK(dwb.SetPrimitive(DocPath(encoded_doc_key3, PrimitiveValue(40_ColId)),
+      PrimitiveValue(40000)));
+  ASSERT_OK(WriteToRocksDBAndClear(&dwb, HybridTime::FromMicros(2000)));
+
+  ASSERT_STR_CONTAINS(DocDBDebugDumpToStr(), "PackedRow{");
+
+  const Schema &schema = kSchemaForIteratorTests;
+  Schema projection;
+  ASSERT_OK(kSchemaForIteratorTests.CreateProjectionByNames({"c", "d", "e"}, &projection));
+
+  // Reads the row by its full primary key, returns the projected columns read or "not found".
+  auto read_row = [&](const KeyBytes& encoded_doc_key, HybridTime read_ht) -> std::string {
+    DocKey doc_key;
+    EXPECT_OK(doc_key.FullyDecodeFrom(encoded_doc_key.AsSlice()));
+    DocQLScanSpec spec(schema, doc_key, rocksdb::kDefaultQueryId);
+    DocRowwiseIterator iter(
+        projection, schema, boost::none, rocksdb(), ReadHybridTime::SingleTime(read_ht));
+    EXPECT_OK(iter.Init(spec));
+    if (!iter.HasNext()) {
+      return "not found";
+    }
+    auto row = std::make_shared<QLTableRow>();
+    EXPECT_OK(iter.NextRow(projection, row));
+    EXPECT_FALSE(iter.HasNext());
+    std::string result;
+    for (const ColumnId column_id : {30_ColId, 40_ColId, 50_ColId}) {
+      const QLTableColumn* column = row->GetColumn(column_id.rep());
+      result += (column != nullptr ? column->value.ShortDebugString() : "absent") + "; ";
+    }
+    return result;
+  };
+
+  for (const bool fast_path : {true, false}) {
+    SCOPED_TRACE(Format("Fast path: $0", fast_path));
+    FLAGS_docdb_point_read_fast_path = fast_path;
+    // The packed row hides the older column record.
+    ASSERT_EQ("string_value: \"row1_c\"; int64_value: 10000; ; ",
+              read_row(kEncodedDocKey1, HybridTime::FromMicros(1500)));
+    // Column records written after the packed row override its columns.
+    ASSERT_EQ("; int64_value: 10000; string_value: \"row1_e\"; ",
+              read_row(kEncodedDocKey1, HybridTime::FromMicros(2500)));
+    ASSERT_EQ("string_value: \"row2_c\"; int64_value: 20000; string_value: \"row2_e\"; ",
+              read_row(kEncodedDocKey2, HybridTime::FromMicros(1500)));
+    // The row was deleted after the packed row was written.
+    ASSERT_EQ("not found", read_row(kEncodedDocKey2, HybridTime::FromMicros(2500)));
+    ASSERT_EQ("; int64_value: 40000; ; ", read_row(encoded_doc_key3, HybridTime::FromMicros(2500)));
+  }
+}
+
 }  // namespace docdb
 }  // namespace yb
@@ -80,6 +80,13 @@ Result<HybridTime> TransactionStatusCache::DoGetCommitTime(const TransactionId&
     return local_commit_time;
   }
 
+  // Final status resolved by another read of this tablet.
+  const HybridTime resolved_commit_time = txn_status_manager_->ResolvedCommitTime(transaction_id);
+  if (resolved_commit_time.is_valid()) {
+    return resolved_commit_time <= read_time_.global_limit ? resolved_commit_time
+                                                           : HybridTime::kMin;
+  }
+
   TransactionStatusResult txn_status;
   for(;;) {
     std::promise<Result<TransactionStatusResult>> txn_status_promise;
@@ -114,10 +121,16 @@ Result<HybridTime> TransactionStatusCache::DoGetCommitTime(const TransactionId&
   // with ABORTED status. So we recheck whether it was committed locally.
   if (txn_status.status == TransactionStatus::ABORTED) {
     local_commit_time = GetLocalCommitTime(transaction_id);
-    return local_commit_time.is_valid() ? local_commit_time : HybridTime::kMin;
+    if (local_commit_time.is_valid()) {
+      return local_commit_time;
+    }
+    txn_status_manager_->TransactionResolved(transaction_id, HybridTime::kMin);
+    return HybridTime::kMin;
+  } else if (txn_status.status == TransactionStatus::COMMITTED) {
+    txn_status_manager_->TransactionResolved(transaction_id, txn_status.status_time);
+    return txn_status.status_time;
   } else {
-    return txn_status.status == TransactionStatus::COMMITTED ? txn_status.status_time
-                                                             : HybridTime::kMin;
+    return HybridTime::kMin;
   }
 }
 
@@ -205,22 +218,46 @@ IntentAwareIterator::IntentAwareIterator(
     rocksdb::DB* rocksdb,
     const rocksdb::ReadOptions& read_opts,
     const ReadHybridTime& read_time,
-    const TransactionOperationContextOpt& txn_op_context)
+    const TransactionOperationContextOpt& txn_op_context,
+    const boost::optional<const Slice>& user_key_for_filter)
     : read_time_(read_time),
       txn_op_context_(txn_op_context),
+      regular_db_(rocksdb),
       transaction_status_cache_(
           txn_op_context ? &txn_op_context->txn_status_manager : nullptr, read_time) {
   VLOG(4) << "IntentAwareIterator, read_time: " << read_time
           << ", txp_op_context: " << txn_op_context_;
   if (txn_op_context.is_initialized()) {
-    intent_iter_ = docdb::CreateRocksDBIterator(rocksdb,
-                                                docdb::BloomFilterMode::DONT_USE_BLOOM_FILTER,
-                                                boost::none,
-                                                rocksdb::kDefaultQueryId);
+    auto* intents_db = txn_op_context->intents_db ? txn_op_context->intents_db : rocksdb;
+    intents_db_ = intents_db;
+    if (user_key_for_filter) {
+      // Intents for a key are stored under kIntentPrefix + key, and the DocDB filter key
+      // transformer keeps kIntentPrefix + hashed components. So intent SST files which cannot
+      // contain intents for the hashed components of user_key_for_filter could be skipped.
+      intent_filter_key_.AppendValueType(ValueType::kIntentPrefix);
+      intent_filter_key_.AppendRawBytes(*user_key_for_filter);
+      intent_iter_ = docdb::CreateRocksDBIterator(intents_db,
+                                                  docdb::BloomFilterMode::USE_BLOOM_FILTER,
+                                                  intent_filter_key_.AsSlice(),
+                                                  rocksdb::kDefaultQueryId);
+    } else {
+      intent_iter_ = docdb::CreateRocksDBIterator(intents_db,
+                                                  docdb::BloomFilterMode::DONT_USE_BLOOM_FILTER,
+                                                  boost::none,
+                                                  rocksdb::kDefaultQueryId);
+    }
   }
   iter_.reset(rocksdb->NewIterator(read_opts));
 }
 
+IntentAwareIterator::~IntentAwareIterator() {
+  // Released before intent_filter_key_ is destroyed, because filters of intent_iter_ reference it.
+  if (intent_iter_) {
+    intents_db_->ReleaseIterator(intent_iter_.release());
+  }
+  regular_db_->ReleaseIterator(iter_.release());
+}
+
 void IntentAwareIterator::Seek(const DocKey &doc_key) {
   SeekWithoutHt(doc_key.Encode());
 }
@@ -234,10 +271,11 @@ void IntentAwareIterator::SeekWithoutHt(const Slice& key) {
     return;
   }
 
-  ROCKSDB_SEEK(iter_.get(), key);
+  PerformRocksDBSeek(iter_.get(), key, __FILE__, __LINE__, &regular_seek_policy_);
   SkipFutureRecords();
   if (intent_iter_) {
-    ROCKSDB_SEEK(intent_iter_.get(), GetIntentPrefixForKeyWithoutHt(key));
+    PerformRocksDBSeek(intent_iter_.get(), GetIntentPrefixForKeyWithoutHt(key), __FILE__, __LINE__,
+                       &intent_seek_policy_);
     SeekForwardToSuitableIntent();
   }
 }
@@ -270,7 +308,7 @@ void IntentAwareIterator::SeekPastSubKey(const SubDocKey& subdoc_key) {
     return;
   }
 
-  docdb::SeekPastSubKey(subdoc_key, iter_.get());
+  docdb::SeekPastSubKey(subdoc_key, iter_.get(), &regular_seek_policy_);
   SkipFutureRecords();
   if (intent_iter_ && status_.ok()) {
     KeyBytes intent_prefix = GetIntentPrefixForKey(subdoc_key);
@@ -303,6 +341,7 @@ void IntentAwareIterator::SeekToLastDocKey() {
     return;
   }
   iter_->SeekToLast();
+  regular_seek_policy_.RecordSeek();
   if (!iter_->Valid()) {
     return;
   }
@@ -340,6 +379,53 @@ void IntentAwareIterator::PrevDocKey(const DocKey& doc_key) {
   Seek(prev_key);
 }
 
+void IntentAwareIterator::PrevSubDocKey(const KeyBytes& key_bytes) {
+  VLOG(4) << "PrevSubDocKey(" << SubDocKey::DebugSliceToString(key_bytes.AsSlice()) << ")";
+  if (!status_.ok()) {
+    return;
+  }
+  if (intent_iter_) {
+    // TODO(dtxn) support reverse scan when intents are present.
+    iter_valid_ = false;
+    return;
+  }
+  auto prefix = prefix_stack_.empty() ? Slice() : prefix_stack_.back();
+  KeyBytes upper_bound = key_bytes;
+  PerformRocksDBSeek(iter_.get(), upper_bound.AsSlice(), __FILE__, __LINE__,
+                     &regular_seek_policy_);
+  for (;;) {
+    if (iter_->Valid()) {
+      iter_->Prev();
+      regular_seek_policy_.RecordNext();
+    } else {
+      iter_->SeekToLast();
+      regular_seek_policy_.RecordSeek();
+    }
+    if (!iter_->Valid() || !iter_->key().starts_with(prefix)) {
+      iter_valid_ = false;
+      return;
+    }
+    // The previous record is the oldest one of its SubDocKey, seek to the latest suitable one.
+    int ht_size = 0;
+    status_ = CheckHybridTimeSizeAndValueType(iter_->key(), &ht_size);
+    if (!status_.ok()) {
+      return;
+    }
+    upper_bound.ResetRawBytes(iter_->key().cdata(), iter_->key().size() - ht_size - 1);
+    SeekWithoutHt(upper_bound.AsSlice());
+    if (!status_.ok()) {
+      return;
+    }
+    if (iter_valid_ && iter_->key().starts_with(upper_bound.AsSlice()) &&
+        iter_->key()[upper_bound.size()] == static_cast<char>(ValueType::kHybridTime)) {
+      return;
+    }
+    // All the records of this SubDocKey are after the read time, continue before it.
+    PerformRocksDBSeek(iter_.get(), upper_bound.AsSlice(), __FILE__, __LINE__,
+                       &regular_seek_policy_);
+  }
+}
+
 bool IntentAwareIterator::valid() {
   return !status_.ok() || iter_valid_ || resolved_intent_state_ == ResolvedIntentState::kValid;
 }
@@ -382,7 +468,7 @@ Slice IntentAwareIterator::value() {
 }
 
 void IntentAwareIterator::SeekForwardRegular(const Slice& slice, const Slice& prefix) {
-  docdb::SeekForward(slice, iter_.get());
+  docdb::SeekForward(slice, iter_.get(), &regular_seek_policy_);
   SkipFutureRecords();
 }
 
@@ -438,7 +524,7 @@ void IntentAwareIterator::SeekForwardToSuitableIntent(const KeyBytes &intent_key
       resolved_intent_key_prefix_.CompareTo(intent_key_prefix) >= 0) {
     return;
   }
-  docdb::SeekForward(intent_key_prefix, intent_iter_.get());
+  docdb::SeekForward(intent_key_prefix, intent_iter_.get(), &intent_seek_policy_);
   SeekForwardToSuitableIntent();
 }
 
@@ -470,6 +556,7 @@ void IntentAwareIterator::SeekForwardToSuitableIntent() {
       return;
     }
     intent_iter_->Next();
+    intent_seek_policy_.RecordNext();
   }
   if (resolved_intent_state_ != ResolvedIntentState::kNoIntent) {
     UpdateResolvedIntentSubDocKeyEncoded();
@@ -625,6 +712,7 @@ void IntentAwareIterator::SkipFutureRecords() {
     }
     VLOG(4) << "Skipping because of time: " << iter_->key().ToDebugHexString();
     iter_->Next(); // TODO(dtxn) use seek with the same key, but read limit as doc hybrid time.
+    regular_seek_policy_.RecordNext();
   }
   iter_valid_ = false;
 }
@@ -19,6 +19,7 @@
 #include "yb/common/read_hybrid_time.h"
 
 #include "yb/docdb/doc_key.h"
+#include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/key_bytes.h"
 
 #include "yb/rocksdb/db.h"
@@ -78,7 +79,11 @@ class IntentAwareIterator {
       rocksdb::DB* rocksdb,
       const rocksdb::ReadOptions& read_opts,
       const ReadHybridTime& read_time,
-      const TransactionOperationContextOpt& txn_op_context);
+      const TransactionOperationContextOpt& txn_op_context,
+      const boost::optional<const Slice>& user_key_for_filter = boost::none);
+
+  // Releases the RocksDB iterators to their DBs, that could reuse them.
+  ~IntentAwareIterator();
 
   IntentAwareIterator(const IntentAwareIterator& other) = delete;
   void operator=(const IntentAwareIterator& other) = delete;
@@ -110,6 +115,11 @@ class IntentAwareIterator {
   // provided
   void PrevDocKey(const DocKey& doc_key);
 
+  // Positions the iterator at the latest suitable record of the last SubDocKey that is before
+  // key_bytes, which should not contain a hybrid time. Used to iterate over the subkeys of a
+  // document in reverse order. Like PrevDocKey, it does not support intents yet.
+  void PrevSubDocKey(const KeyBytes& key_bytes);
+
   // Adds new value to prefix stack. The top value of this stack is used to filter
   // returned entries. After seek we check whether currently pointed value has active prefix.
   // If not, than it means that we are out of range of interest and iterator becomes invalid.
@@ -127,6 +137,14 @@ class IntentAwareIterator {
   ReadHybridTime read_time() { return read_time_; }
   HybridTime max_seen_ht() { return max_seen_ht_; }
 
+  // Number of Next() and Seek() calls done on the underlying RocksDB iterators so far.
+  uint64_t num_nexts() const {
+    return regular_seek_policy_.num_nexts() + intent_seek_policy_.num_nexts();
+  }
+  uint64_t num_seeks() const {
+    return regular_seek_policy_.num_seeks() + intent_seek_policy_.num_seeks();
+  }
+
   // If there is a key equal to key_bytes_without_ht + some timestamp, which is later than
   // max_deleted_ts, we update max_deleted_ts and result_value (unless it is nullptr).
   // This should not be used for leaf nodes. - Why? Looks like it is already used for leaf nodes
@@ -189,8 +207,15 @@ class IntentAwareIterator {
 
   const ReadHybridTime read_time_;
   const TransactionOperationContextOpt txn_op_context_;
+  rocksdb::DB* const regular_db_;
+  rocksdb::DB* intents_db_ = nullptr;
+  // kIntentPrefix + user key used to check bloom filters of intent SST files. Should outlive
+  // intent_iter_, because the file filter only keeps a slice referencing it.
+  KeyBytes intent_filter_key_;
   std::unique_ptr<rocksdb::Iterator> intent_iter_;
   std::unique_ptr<rocksdb::Iterator> iter_;
+  NextOrSeekPolicy intent_seek_policy_;
+  NextOrSeekPolicy regular_seek_policy_;
   bool iter_valid_ = false;
   Status status_;
   HybridTime max_seen_ht_ = HybridTime::kMin;
@@ -0,0 +1,88 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/intent_filter.h"
+
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+constexpr size_t kNumCounters = 64 * 1024;
+constexpr int kNumPaths = 1000;
+
+std::string Path(int index) {
+  return "path" + std::to_string(index);
+}
+
+} // namespace
+
+class IntentFilterTest : public YBTest {
+};
+
+TEST_F(IntentFilterTest, AddRemove) {
+  IntentFilter filter(kNumCounters);
+  for (int i = 0; i != kNumPaths; ++i) {
+    ASSERT_FALSE(filter.MayContain(Path(i))) << i;
+  }
+
+  // The same path could be added by several intents, it stays until all of them are removed.
+  for (int i = 0; i != kNumPaths; ++i) {
+    filter.Add(Path(i));
+    filter.Add(Path(i));
+  }
+  for (int i = 0; i != kNumPaths; ++i) {
+    ASSERT_TRUE(filter.MayContain(Path(i))) << i;
+    filter.Remove(Path(i));
+    ASSERT_TRUE(filter.MayContain(Path(i))) << i;
+  }
+
+  // With few paths per counter almost all the absent paths are reported as absent.
+  int false_positives = 0;
+  for (int i = kNumPaths; i != 2 * kNumPaths; ++i) {
+    false_positives += filter.MayContain(Path(i));
+  }
+  ASSERT_LT(false_positives, kNumPaths / 100);
+
+  for (int i = 0; i != kNumPaths; ++i) {
+    filter.Remove(Path(i));
+  }
+  for (int i = 0; i != 2 * kNumPaths; ++i) {
+    ASSERT_FALSE(filter.MayContain(Path(i))) << i;
+  }
+}
+
+TEST_F(IntentFilterTest, Saturation) {
+  // With a single counter all paths share it, and once it is saturated it does not go back.
+  IntentFilter filter(1);
+  for (int i = 0; i != 300; ++i) {
+    filter.Add(Path(0));
+  }
+  for (int i = 0; i != 300; ++i) {
+    filter.Remove(Path(0));
+  }
+  ASSERT_TRUE(filter.MayContain(Path(1)));
+
+  filter.Clear();
+  ASSERT_FALSE(filter.MayContain(Path(1)));
+  filter.Add(Path(0));
+  ASSERT_TRUE(filter.MayContain(Path(1)));
+  filter.Remove(Path(0));
+  ASSERT_FALSE(filter.MayContain(Path(1)));
+}
+
+} // namespace docdb
+} // namespace yb
@@ -0,0 +1,104 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/intent_filter.h"
+
+#include "yb/docdb/conflict_resolution.h"
+#include "yb/docdb/docdb_rocksdb_util.h"
+#include "yb/docdb/value_type.h"
+#include "yb/rocksdb/db.h"
+#include "yb/util/hash_util.h"
+
+namespace yb {
+namespace docdb {
+
+IntentFilter::IntentFilter(size_t num_counters)
+    : num_counters_(std::max<size_t>(num_counters, 1)),
+      counters_(new std::atomic<Counter>[num_counters_]) {
+  Clear();
+}
+
+IntentFilter::~IntentFilter() {}
+
+template <class F>
+void IntentFilter::ForEachCounter(const Slice& intent_path, const F& f) const {
+  // Double hashing, the counters of a path are h1 + i * h2 for i in [0, kNumHashes).
+  const uint64_t hash = HashUtil::MurmurHash2_64(intent_path.data(), intent_path.size(), 0);
+  const uint64_t h1 = static_cast<uint32_t>(hash);
+  const uint64_t h2 = (hash >> 32) | 1;
+  for (size_t i = 0; i != kNumHashes; ++i) {
+    f(&counters_[(h1 + i * h2) % num_counters_]);
+  }
+}
+
+void IntentFilter::Add(const Slice& intent_path) {
+  ForEachCounter(intent_path, [](std::atomic<Counter>* counter) {
+    auto value = counter->load(std::memory_order_relaxed);
+    while (value != kMaxCount &&
+           !counter->compare_exchange_weak(value, value + 1, std::memory_order_acq_rel)) {
+    }
+  });
+}
+
+void IntentFilter::Remove(const Slice& intent_path) {
+  ForEachCounter(intent_path, [](std::atomic<Counter>* counter) {
+    auto value = counter->load(std::memory_order_relaxed);
+    // A saturated counter does not know how many paths it stands for.
+    while (value != kMaxCount && value != 0 &&
+           !counter->compare_exchange_weak(value, value - 1, std::memory_order_acq_rel)) {
+    }
+  });
+}
+
+bool IntentFilter::MayContain(const Slice& intent_path) const {
+  bool result = true;
+  ForEachCounter(intent_path, [&result](std::atomic<Counter>* counter) {
+    if (counter->load(std::memory_order_acquire) == 0) {
+      result = false;
+    }
+  });
+  return result;
+}
+
+void IntentFilter::Clear() {
+  for (size_t i = 0; i != num_counters_; ++i) {
+    counters_[i].store(0, std::memory_order_release);
+  }
+}
+
+Status AddStoredIntentsToFilter(rocksdb::DB* intents_db, IntentFilter* filter) {
+  auto iter = CreateRocksDBIterator(
+      intents_db, BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none /* user_key_for_filter */,
+      rocksdb::kDefaultQueryId);
+  const char intent_prefix = static_cast<char>(ValueType::kIntentPrefix);
+  size_t num_intents = 0;
+  for (iter->Seek(Slice(&intent_prefix, 1)); iter->Valid(); iter->Next()) {
+    const Slice key = iter->key();
+    if (key.empty() || key[0] != static_cast<uint8_t>(ValueType::kIntentPrefix)) {
+      break;
+    }
+    // Skip the reverse index, transaction metadata and apply state records.
+    if (key.size() > 1 && key[1] == static_cast<uint8_t>(ValueType::kTransactionId)) {
+      continue;
+    }
+    auto intent = ParseIntentKey(key, iter->value());
+    RETURN_NOT_OK(intent);
+    filter->Add(Slice(key.data(), intent->doc_path.end()));
+    ++num_intents;
+  }
+  VLOG(1) << "Added " << num_intents << " stored intents to the intent filter";
+  return Status::OK();
+}
+
+} // namespace docdb
+} // namespace yb
@@ -0,0 +1,78 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_INTENT_FILTER_H_
+#define YB_DOCDB_INTENT_FILTER_H_
+
+#include <atomic>
+#include <memory>
+
+#include "yb/util/slice.h"
+#include "yb/util/status.h"
+
+namespace rocksdb {
+
+class DB;
+
+}
+
+namespace yb {
+namespace docdb {
+
+// An approximate set of the paths of the live intents of a tablet, i.e. the encoded intent keys
+// without the intent type and hybrid time. It lets conflict resolution skip the seek of the
+// intents DB for the keys without intents, which is the common case.
+//
+// It is a counting bloom filter: a path is added before an intent for it is written, and removed
+// once the removal of the intent is written. So it never reports a path with a live intent as
+// absent, but may report a path without intents as present. A counter that reaches its limit is
+// never decremented, so the paths hashed to it are reported as present until the filter is
+// cleared.
+//
+// This class is thread-safe.
+class IntentFilter {
+ public:
+  explicit IntentFilter(size_t num_counters);
+  ~IntentFilter();
+
+  void Add(const Slice& intent_path);
+
+  // Removes a path added before.
+  void Remove(const Slice& intent_path);
+
+  // Returns false if there are no intents with the path.
+  bool MayContain(const Slice& intent_path) const;
+
+  // Forgets all paths, used when the intents are dropped without removing them one by one.
+  void Clear();
+
+ private:
+  typedef uint8_t Counter;
+
+  static constexpr size_t kNumHashes = 3;
+  static constexpr Counter kMaxCount = 0xff;
+
+  template <class F>
+  void ForEachCounter(const Slice& intent_path, const F& f) const;
+
+  const size_t num_counters_;
+  std::unique_ptr<std::atomic<Counter>[]> counters_;
+};
+
+// Adds the paths of all intents stored in intents_db to the filter, used when the DB is opened.
+CHECKED_STATUS AddStoredIntentsToFilter(rocksdb::DB* intents_db, IntentFilter* filter);
+
+} // namespace docdb
+} // namespace yb
+
+#endif // YB_DOCDB_INTENT_FILTER_H_
@@ -0,0 +1,73 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/packed_row.h"
+
+#include <algorithm>
+
+#include "yb/docdb/key_bytes.h"
+#include "yb/util/fast_varint.h"
+
+namespace yb {
+namespace docdb {
+
+std::string EncodePackedRow(const PackedColumns& columns) {
+  DCHECK(std::is_sorted(columns.begin(), columns.end(),
+                        [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; }));
+  KeyBytes result;
+  uint8_t length_buffer[16];
+  for (const auto& column : columns) {
+    column.first.AppendToKey(&result);
+    const std::string value = column.second.ToValue();
+    size_t length_size = 0;
+    util::FastEncodeUnsignedVarInt(value.size(), length_buffer, &length_size);
+    result.AppendRawBytes(reinterpret_cast<const char*>(length_buffer), length_size);
+    result.AppendRawBytes(value);
+  }
+  return std::move(*result.mutable_data());
+}
+
+Status DecodePackedRow(const Slice& packed_row, PackedColumns* columns) {
+  columns->clear();
+  Slice input = packed_row;
+  while (!input.empty()) {
+    PrimitiveValue column;
+    RETURN_NOT_OK_PREPEND(PrimitiveValue::DecodeKey(&input, &column),
+                          "Failed to decode a column id of a packed row");
+    uint64_t value_size = 0;
+    size_t length_size = 0;
+    RETURN_NOT_OK(util::FastDecodeUnsignedVarInt(
+        input.data(), input.size(), &value_size, &length_size));
+    input.remove_prefix(length_size);
+    if (value_size > input.size()) {
+      return STATUS_FORMAT(
+          Corruption, "Value of column $0 of a packed row takes $1 bytes, only $2 left",
+          column, value_size, input.size());
+    }
+    PrimitiveValue value;
+    RETURN_NOT_OK(value.DecodeFromValue(Slice(input.data(), value_size)));
+    input.remove_prefix(value_size);
+    columns->emplace_back(std::move(column), std::move(value));
+  }
+  return Status::OK();
+}
+
+const PrimitiveValue* FindPackedColumn(const PackedColumns& columns, const PrimitiveValue& column) {
+  auto it = std::lower_bound(
+      columns.begin(), columns.end(), column,
+      [](const auto& entry, const PrimitiveValue& key) { return entry.first < key; });
+  return it != columns.end() && it->first == column ? &it->second : nullptr;
+}
+
+}  // namespace docdb
+}  // namespace yb
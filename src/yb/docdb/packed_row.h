@@ -0,0 +1,52 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_PACKED_ROW_H
+#define YB_DOCDB_PACKED_ROW_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "yb/docdb/primitive_value.h"
+#include "yb/util/slice.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace docdb {
+
+// A packed row keeps all the non-key columns of a row written by one QL insert in a single DocDB
+// record keyed by the row's DocKey, instead of one record per column, so the DocKey and the hybrid
+// time are not repeated for every column. Its value is ValueType::kPackedRow followed by the
+// columns sorted by their ids, each encoded as the column id in key encoding, the length of the
+// column value as a varint and the column value in value encoding.
+//
+// A packed row written at hybrid time T hides the older records of the row, like a row tombstone
+// at T followed by writing every column at T would, and columns written after T override the values
+// from the packed row.
+typedef std::vector<std::pair<PrimitiveValue, PrimitiveValue>> PackedColumns;
+
+// Encodes the columns, which should be sorted by column id, into the payload of a packed row.
+std::string EncodePackedRow(const PackedColumns& columns);
+
+// Decodes the payload of a packed row into its columns, sorted by column id.
+CHECKED_STATUS DecodePackedRow(const Slice& packed_row, PackedColumns* columns);
+
+// Returns the value of the column from the decoded columns of a packed row, or nullptr if the row
+// does not have this column.
+const PrimitiveValue* FindPackedColumn(const PackedColumns& columns, const PrimitiveValue& column);
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif  // YB_DOCDB_PACKED_ROW_H
@@ -20,6 +20,7 @@
 #include "yb/docdb/doc_kv_util.h"
 #include "yb/docdb/subdocument.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/rocksutil/yb_rocksdb.h"
@@ -109,6 +110,8 @@ string PrimitiveValue::ToString() const {
     case ValueType::kInt64Descending: FALLTHROUGH_INTENDED;
     case ValueType::kInt64:
       return std::to_string(int64_val_);
+    case ValueType::kCounterDelta:
+      return Format("CounterDelta($0)", int64_val_);
     case ValueType::kFloatDescending: FALLTHROUGH_INTENDED;
     case ValueType::kFloat:
       return RealToString(float_val_);
@@ -170,6 +173,25 @@ string PrimitiveValue::ToString() const {
       return "(->)";
     case ValueType::kTombstone:
       return "DEL";
+    case ValueType::kPackedRow: {
+      PackedColumns columns;
+      auto status = DecodePackedRow(str_val_, &columns);
+      if (!status.ok()) {
+        return Format("PackedRow(<error: $0>)", status);
+      }
+      std::stringstream ss;
+      ss << "PackedRow{";
+      bool first = true;
+      for (const auto& column : columns) {
+        if (!first) {
+          ss << ", ";
+        }
+        first = false;
+        ss << column.first.ToString() << ": " << column.second.ToString();
+      }
+      ss << "}";
+      return ss.str();
+    }
     case ValueType::kArray:
       return "[]";
     case ValueType::kTransactionId:
@@ -325,6 +347,11 @@ void PrimitiveValue::AppendToKey(KeyBytes* key_bytes) const {
       key_bytes->AppendIntentType(static_cast<IntentType>(uint16_val_));
       return;
 
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED;
+    case ValueType::kCounterDelta:
+      // Packed rows and counter deltas are not allowed in a key.
+      break;
+
     IGNORE_NON_PRIMITIVE_VALUE_TYPES_IN_SWITCH;
   }
   FATAL_INVALID_ENUM_VALUE(ValueType, type_);
@@ -349,7 +376,8 @@ string PrimitiveValue::ToValue() const {
     case ValueType::kRedisSet: return result;
 
     case ValueType::kStringDescending: FALLTHROUGH_INTENDED;
-    case ValueType::kString:
+    case ValueType::kString: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRow:
       // No zero encoding necessary when storing the string in a value.
       result.append(str_val_);
       return result;
@@ -360,7 +388,8 @@ string PrimitiveValue::ToValue() const {
       return result;
 
     case ValueType::kInt64Descending: FALLTHROUGH_INTENDED;
-    case ValueType::kInt64:
+    case ValueType::kInt64: FALLTHROUGH_INTENDED;
+    case ValueType::kCounterDelta:
       AppendBigEndianUInt64(int64_val_, &result);
       return result;
 
@@ -762,7 +791,9 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
       type_ref = value_type;
       return Status::OK();
     }
-    case ValueType::kMaxByte:
+    case ValueType::kMaxByte: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED;
+    case ValueType::kCounterDelta:
       break;
 
     IGNORE_NON_PRIMITIVE_VALUE_TYPES_IN_SWITCH;
@@ -829,10 +860,11 @@ Status PrimitiveValue::DecodeFromValue(const rocksdb::Slice& rocksdb_slice) {
 
       return STATUS(Corruption, "Reached end of slice looking for frozen group end marker");
     }
-    case ValueType::kString:
+    case ValueType::kString: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRow:
       new(&str_val_) string(slice.cdata(), slice.size());
       // Only set type to string after string field initialization succeeds.
-      type_ = ValueType::kString;
+      type_ = value_type;
       return Status::OK();
 
     case ValueType::kInt32: FALLTHROUGH_INTENDED;
@@ -849,6 +881,7 @@ Status PrimitiveValue::DecodeFromValue(const rocksdb::Slice& rocksdb_slice) {
 
     case ValueType::kInt64: FALLTHROUGH_INTENDED;
     case ValueType::kInt64Descending: FALLTHROUGH_INTENDED;
+    case ValueType::kCounterDelta: FALLTHROUGH_INTENDED;
     case ValueType::kArrayIndex: FALLTHROUGH_INTENDED;
     case ValueType::kDoubleDescending: FALLTHROUGH_INTENDED;
     case ValueType::kDouble:
@@ -930,6 +963,20 @@ Status PrimitiveValue::DecodeFromValue(const rocksdb::Slice& rocksdb_slice) {
   return Status::OK();
 }
 
+PrimitiveValue PrimitiveValue::PackedRow(std::string packed_row) {
+  PrimitiveValue primitive_value;
+  new(&primitive_value.str_val_) std::string(std::move(packed_row));
+  primitive_value.type_ = ValueType::kPackedRow;
+  return primitive_value;
+}
+
+PrimitiveValue PrimitiveValue::CounterDelta(int64_t delta) {
+  PrimitiveValue primitive_value;
+  primitive_value.type_ = ValueType::kCounterDelta;
+  primitive_value.int64_val_ = delta;
+  return primitive_value;
+}
+
 PrimitiveValue PrimitiveValue::Double(double d, SortOrder sort_order) {
   PrimitiveValue primitive_value;
   if (sort_order == SortOrder::kAscending) {
@@ -1035,7 +1082,8 @@ bool PrimitiveValue::operator==(const PrimitiveValue& other) const {
     case ValueType::kMaxByte: return true;
 
     case ValueType::kStringDescending: FALLTHROUGH_INTENDED;
-    case ValueType::kString: return str_val_ == other.str_val_;
+    case ValueType::kString: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRow: return str_val_ == other.str_val_;
 
     case ValueType::kFrozenDescending: FALLTHROUGH_INTENDED;
     case ValueType::kFrozen: return *frozen_val_ == *other.frozen_val_;
@@ -1045,6 +1093,7 @@ bool PrimitiveValue::operator==(const PrimitiveValue& other) const {
 
     case ValueType::kInt64Descending: FALLTHROUGH_INTENDED;
     case ValueType::kInt64: FALLTHROUGH_INTENDED;
+    case ValueType::kCounterDelta: FALLTHROUGH_INTENDED;
     case ValueType::kArrayIndex: return int64_val_ == other.int64_val_;
 
     case ValueType::kFloatDescending: FALLTHROUGH_INTENDED;
@@ -1101,7 +1150,8 @@ int PrimitiveValue::CompareTo(const PrimitiveValue& other) const {
       return 0;
     case ValueType::kStringDescending:
       return other.str_val_.compare(str_val_);
-    case ValueType::kString:
+    case ValueType::kString: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRow:
       return str_val_.compare(other.str_val_);
     case ValueType::kInt64Descending:
       return CompareUsingLessThan(other.int64_val_, int64_val_);
@@ -1110,6 +1160,7 @@ int PrimitiveValue::CompareTo(const PrimitiveValue& other) const {
     case ValueType::kInt32:
       return CompareUsingLessThan(int32_val_, other.int32_val_);
     case ValueType::kInt64: FALLTHROUGH_INTENDED;
+    case ValueType::kCounterDelta: FALLTHROUGH_INTENDED;
     case ValueType::kArrayIndex:
       return CompareUsingLessThan(int64_val_, other.int64_val_);
     case ValueType::kDoubleDescending:
@@ -1173,7 +1224,8 @@ int PrimitiveValue::CompareTo(const PrimitiveValue& other) const {
 PrimitiveValue::PrimitiveValue(ValueType value_type)
     : type_(value_type) {
   complex_data_structure_ = nullptr;
-  if (value_type == ValueType::kString || value_type == ValueType::kStringDescending) {
+  if (value_type == ValueType::kString || value_type == ValueType::kStringDescending ||
+      value_type == ValueType::kPackedRow) {
     new(&str_val_) std::string();
   } else if (value_type == ValueType::kInetaddress
       || value_type == ValueType::kInetaddressDescending) {
@@ -40,7 +40,8 @@ namespace docdb {
 class SubDocument;
 
 enum class SystemColumnIds : ColumnIdRep {
-  kLivenessColumn = 0  // Stores the TTL for QL rows inserted using an INSERT statement.
+  kLivenessColumn = 0,  // Stores the TTL for QL rows inserted using an INSERT statement.
+  kRangeTombstones = 1  // Stores the range tombstones of a hash key, see range_tombstone.h.
 };
 
 enum class SortOrder : int8_t {
@@ -60,7 +61,8 @@ class PrimitiveValue {
   explicit PrimitiveValue(ValueType value_type);
 
   PrimitiveValue(const PrimitiveValue& other) {
-    if (other.type_ == ValueType::kString || other.type_ == ValueType::kStringDescending) {
+    if (other.type_ == ValueType::kString || other.type_ == ValueType::kStringDescending ||
+        other.type_ == ValueType::kPackedRow) {
       type_ = other.type_;
       new(&str_val_) std::string(other.str_val_);
     } else if (other.type_ == ValueType::kInetaddress
@@ -199,7 +201,8 @@ class PrimitiveValue {
   std::string ToString() const;
 
   ~PrimitiveValue() {
-    if (type_ == ValueType::kString || type_ == ValueType::kStringDescending) {
+    if (type_ == ValueType::kString || type_ == ValueType::kStringDescending ||
+        type_ == ValueType::kPackedRow) {
       str_val_.~basic_string();
     } else if (type_ == ValueType::kInetaddress || type_ == ValueType::kInetaddressDescending) {
       delete inetaddress_val_;
@@ -221,6 +224,10 @@ class PrimitiveValue {
   // encoding format. Expects the entire slice to be consumed and returns an error otherwise.
   CHECKED_STATUS DecodeFromValue(const rocksdb::Slice& rocksdb_slice);
 
+  // A packed row with the given payload, see packed_row.h.
+  static PrimitiveValue PackedRow(std::string packed_row);
+  // An increment of a counter by the given delta, see ValueType::kCounterDelta.
+  static PrimitiveValue CounterDelta(int64_t delta);
   static PrimitiveValue Double(double d, SortOrder sort_order = SortOrder::kAscending);
   static PrimitiveValue Float(float f, SortOrder sort_order = SortOrder::kAscending);
   // decimal_str represents a human readable string representing the decimal number, e.g. "0.03".
@@ -278,6 +285,11 @@ class PrimitiveValue {
     return str_val_;
   }
 
+  const std::string& GetPackedRow() const {
+    DCHECK_EQ(ValueType::kPackedRow, type_);
+    return str_val_;
+  }
+
   int32_t GetInt32() const {
     DCHECK(ValueType::kInt32 == type_ || ValueType::kInt32Descending == type_);
     return int32_val_;
@@ -288,6 +300,11 @@ class PrimitiveValue {
     return int64_val_;
   }
 
+  int64_t GetCounterDelta() const {
+    DCHECK_EQ(ValueType::kCounterDelta, type_);
+    return int64_val_;
+  }
+
   uint16_t GetUInt16() const {
     DCHECK(ValueType::kUInt16Hash == type_ || ValueType::kIntentType == type_);
     return uint16_val_;
@@ -404,7 +421,8 @@ class PrimitiveValue {
 
     ttl_seconds_ = other->ttl_seconds_;
     write_time_ = other->write_time_;
-    if (other->type_ == ValueType::kString || other->type_ == ValueType::kStringDescending) {
+    if (other->type_ == ValueType::kString || other->type_ == ValueType::kStringDescending ||
+        other->type_ == ValueType::kPackedRow) {
       type_ = other->type_;
       new(&str_val_) std::string(std::move(other->str_val_));
       // The moved-from object should now be in a "valid but unspecified" state as per the standard.
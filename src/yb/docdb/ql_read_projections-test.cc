@@ -0,0 +1,83 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/ql_read_projections.h"
+
+#include <gtest/gtest.h>
+
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace docdb {
+
+class QLReadProjectionsTest : public YBTest {
+ protected:
+  // Key column 10, static column 11 and regular columns 12 and 13.
+  Schema MakeSchema() {
+    return Schema({ ColumnSchema("k", DataType::INT32, false, true),
+                    ColumnSchema("s", DataType::INT32, true, false, true),
+                    ColumnSchema("a", DataType::INT32, true),
+                    ColumnSchema("b", DataType::INT32, true) },
+                  { ColumnId(10), ColumnId(11), ColumnId(12), ColumnId(13) }, 1);
+  }
+
+  static QLReferencedColumnsPB Refs(std::initializer_list<int32_t> static_ids,
+                                    std::initializer_list<int32_t> ids) {
+    QLReferencedColumnsPB result;
+    for (auto id : static_ids) {
+      result.add_static_ids(id);
+    }
+    for (auto id : ids) {
+      result.add_ids(id);
+    }
+    return result;
+  }
+};
+
+TEST_F(QLReadProjectionsTest, Create) {
+  const Schema schema = MakeSchema();
+  auto projections = QLReadProjections::Create(schema, Refs({11}, {13, 10, 12}));
+  ASSERT_OK(projections);
+  const auto& result = **projections;
+  ASSERT_EQ((vector<ColumnId>{ ColumnId(11), ColumnId(13), ColumnId(10), ColumnId(12) }),
+            result.query_schema.column_ids());
+  ASSERT_EQ(vector<ColumnId>{ ColumnId(11) }, result.static_projection.column_ids());
+  // Key columns are not scanned and the regular columns are sorted.
+  ASSERT_EQ((vector<ColumnId>{ ColumnId(12), ColumnId(13) }),
+            result.non_static_projection.column_ids());
+}
+
+TEST_F(QLReadProjectionsTest, Cache) {
+  const Schema schema = MakeSchema();
+  QLReadProjectionCache cache;
+
+  auto first = cache.Get(schema, Refs({}, {10, 12}));
+  ASSERT_OK(first);
+  auto second = cache.Get(schema, Refs({}, {10, 12}));
+  ASSERT_OK(second);
+  ASSERT_EQ(first->get(), second->get());
+
+  // The same columns as static ones are a different projection.
+  auto other = cache.Get(schema, Refs({10, 12}, {}));
+  ASSERT_OK(other);
+  ASSERT_NE(first->get(), other->get());
+
+  // A new schema version invalidates the cached projections.
+  const Schema altered_schema = MakeSchema();
+  auto altered = cache.Get(altered_schema, Refs({}, {10, 12}));
+  ASSERT_OK(altered);
+  ASSERT_NE(first->get(), altered->get());
+}
+
+} // namespace docdb
+} // namespace yb
@@ -0,0 +1,144 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/ql_read_projections.h"
+
+#include <algorithm>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include <boost/thread/shared_mutex.hpp>
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(ql_read_projection_cache_size, 64,
+             "Maximum number of distinct sets of referenced columns whose read projections each "
+             "tablet caches. When the cache is full it is cleared. 0 disables the cache.");
+TAG_FLAG(ql_read_projection_cache_size, advanced);
+TAG_FLAG(ql_read_projection_cache_size, runtime);
+
+using std::set;
+using std::vector;
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+// Encodes the referenced columns, the static ones being separated from the others by -1 that is
+// not a valid column id.
+std::string ProjectionKey(const QLReferencedColumnsPB& column_refs) {
+  std::string result;
+  result.reserve((column_refs.ids_size() + column_refs.static_ids_size() + 1) * sizeof(int32_t));
+  auto append = [&result](int32_t id) {
+    result.append(reinterpret_cast<const char*>(&id), sizeof(id));
+  };
+  for (int32_t id : column_refs.static_ids()) {
+    append(id);
+  }
+  append(-1);
+  for (int32_t id : column_refs.ids()) {
+    append(id);
+  }
+  return result;
+}
+
+} // namespace
+
+CHECKED_STATUS CreateProjections(const Schema& schema, const QLReferencedColumnsPB& column_refs,
+                                 Schema* static_projection, Schema* non_static_projection) {
+  // The projection schemas are used to scan docdb. Keep the columns to fetch in sorted order for
+  // more efficient scan in the iterator.
+  set<ColumnId> static_columns, non_static_columns;
+
+  // Add regular columns.
+  for (int32_t id : column_refs.ids()) {
+    const ColumnId column_id(id);
+    if (!schema.is_key_column(column_id)) {
+      non_static_columns.insert(column_id);
+    }
+  }
+
+  // Add static columns.
+  for (int32_t id : column_refs.static_ids()) {
+    const ColumnId column_id(id);
+    static_columns.insert(column_id);
+  }
+
+  RETURN_NOT_OK(
+      schema.CreateProjectionByIdsIgnoreMissing(
+          vector<ColumnId>(static_columns.begin(), static_columns.end()),
+          static_projection));
+  RETURN_NOT_OK(
+      schema.CreateProjectionByIdsIgnoreMissing(
+          vector<ColumnId>(non_static_columns.begin(), non_static_columns.end()),
+          non_static_projection));
+
+  return Status::OK();
+}
+
+Result<std::shared_ptr<const QLReadProjections>> QLReadProjections::Create(
+    const Schema& schema, const QLReferencedColumnsPB& column_refs) {
+  auto result = std::make_shared<QLReadProjections>();
+
+  // Form a schema of columns that are referenced by this query.
+  vector<ColumnId> column_ids;
+  for (int32_t id : column_refs.static_ids()) {
+    column_ids.emplace_back(id);
+  }
+  for (int32_t id : column_refs.ids()) {
+    column_ids.emplace_back(id);
+  }
+  RETURN_NOT_OK(schema.CreateProjectionByIdsIgnoreMissing(column_ids, &result->query_schema));
+
+  RETURN_NOT_OK(CreateProjections(schema, column_refs,
+                                  &result->static_projection, &result->non_static_projection));
+  return std::shared_ptr<const QLReadProjections>(std::move(result));
+}
+
+Result<std::shared_ptr<const QLReadProjections>> QLReadProjectionCache::Get(
+    const Schema& schema, const QLReferencedColumnsPB& column_refs) {
+  const size_t capacity = std::max(FLAGS_ql_read_projection_cache_size, 0);
+  if (capacity == 0) {
+    return QLReadProjections::Create(schema, column_refs);
+  }
+
+  std::string key = ProjectionKey(column_refs);
+  {
+    boost::shared_lock<rw_spinlock> lock(mutex_);
+    if (schema_ == &schema) {
+      auto it = projections_.find(key);
+      if (it != projections_.end()) {
+        return it->second;
+      }
+    }
+  }
+
+  auto projections = QLReadProjections::Create(schema, column_refs);
+  if (!projections.ok()) {
+    return projections;
+  }
+
+  std::lock_guard<rw_spinlock> lock(mutex_);
+  if (schema_ != &schema || projections_.size() >= capacity) {
+    projections_.clear();
+    schema_ = &schema;
+  }
+  projections_.emplace(std::move(key), *projections);
+  return projections;
+}
+
+} // namespace docdb
+} // namespace yb
@@ -0,0 +1,70 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_QL_READ_PROJECTIONS_H
+#define YB_DOCDB_QL_READ_PROJECTIONS_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "yb/common/ql_protocol.pb.h"
+#include "yb/common/schema.h"
+#include "yb/util/locks.h"
+#include "yb/util/result.h"
+
+namespace yb {
+namespace docdb {
+
+// Create projection schemas of static and non-static columns from a rowblock projection schema
+// (for read) and a WHERE / IF condition (for read / write). "schema" is the full table schema
+// and "rowblock_schema" is the selected columns from which we are splitting into static and
+// non-static column portions.
+CHECKED_STATUS CreateProjections(const Schema& schema, const QLReferencedColumnsPB& column_refs,
+                                 Schema* static_projection, Schema* non_static_projection);
+
+// The projections of the table schema that a QL read with the given referenced columns uses.
+// They only depend on the schema and on the set of referenced columns, so they are immutable once
+// created and could be shared by all the reads of the same columns.
+struct QLReadProjections {
+  // The referenced columns, static ones first.
+  Schema query_schema;
+
+  // The static columns and the non-key regular columns to scan, see CreateProjections().
+  Schema static_projection;
+  Schema non_static_projection;
+
+  static Result<std::shared_ptr<const QLReadProjections>> Create(
+      const Schema& schema, const QLReferencedColumnsPB& column_refs);
+};
+
+// Cache of the projections of the QL reads of a tablet, keyed by the set of referenced columns.
+// Entries are tied to the schema they were created from. Passing another schema, e.g. after an
+// ALTER TABLE, drops all the entries. Schemas are identified by address, so the caller must keep
+// the schemas it passes alive for the lifetime of the cache, like TabletMetadata does with its old
+// schemas.
+class QLReadProjectionCache {
+ public:
+  Result<std::shared_ptr<const QLReadProjections>> Get(
+      const Schema& schema, const QLReferencedColumnsPB& column_refs);
+
+ private:
+  rw_spinlock mutex_;
+  const Schema* schema_ = nullptr;
+  std::unordered_map<std::string, std::shared_ptr<const QLReadProjections>> projections_;
+};
+
+} // namespace docdb
+} // namespace yb
+
+#endif // YB_DOCDB_QL_READ_PROJECTIONS_H
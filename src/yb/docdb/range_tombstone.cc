@@ -0,0 +1,118 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/range_tombstone.h"
+
+#include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/value.h"
+#include "yb/util/flag_tags.h"
+
+DEFINE_bool(docdb_range_tombstones, false,
+            "Write a QL delete of a range of rows of a single hash key, without user timestamp, "
+            "condition or transaction, as a single range tombstone record instead of a tombstone "
+            "per row. Reads look for range tombstones only while it is set, so it should not be "
+            "turned off again while range tombstones could remain in the tables.");
+TAG_FLAG(docdb_range_tombstones, advanced);
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+const PrimitiveValue& RangeTombstonesColumn() {
+  static const PrimitiveValue column =
+      PrimitiveValue::SystemColumnId(SystemColumnIds::kRangeTombstones);
+  return column;
+}
+
+}  // namespace
+
+DocPath RangeTombstonePath(const DocKey& hashed_doc_key,
+                           const std::string& lower,
+                           const std::string& upper) {
+  DCHECK(hashed_doc_key.range_group().empty());
+  return DocPath(hashed_doc_key.Encode(), RangeTombstonesColumn(), PrimitiveValue(lower),
+                 PrimitiveValue(upper));
+}
+
+bool IsRangeTombstoneKey(const SubDocKey& key) {
+  return key.num_subkeys() == 3 && key.doc_key().range_group().empty() &&
+         key.subkeys()[0] == RangeTombstonesColumn();
+}
+
+std::string EncodeRangeGroup(const std::vector<PrimitiveValue>& range_components) {
+  return DocKey(range_components).Encode().data();
+}
+
+Status SplitDocKey(const Slice& key, Slice* hashed_part, Slice* range_group) {
+  auto hashed_part_size = DocKey::EncodedSize(key, DocKeyPart::HASHED_PART_ONLY);
+  RETURN_NOT_OK(hashed_part_size);
+  auto doc_key_size = DocKey::EncodedSize(key, DocKeyPart::WHOLE_DOC_KEY);
+  RETURN_NOT_OK(doc_key_size);
+  *hashed_part = Slice(key.data(), *hashed_part_size);
+  *range_group = Slice(key.data() + *hashed_part_size, *doc_key_size - *hashed_part_size);
+  return Status::OK();
+}
+
+void RangeTombstones::Reset(const Slice& hashed_part) {
+  initialized_ = true;
+  hashed_part_.assign(hashed_part.cdata(), hashed_part.size());
+  tombstones_.clear();
+}
+
+Status RangeTombstones::Add(const SubDocKey& key) {
+  if (!IsRangeTombstoneKey(key) || key.subkeys()[1].value_type() != ValueType::kString ||
+      key.subkeys()[2].value_type() != ValueType::kString) {
+    return STATUS_FORMAT(Corruption, "Invalid range tombstone key: $0", key);
+  }
+  tombstones_.push_back(
+      {key.subkeys()[1].GetString(), key.subkeys()[2].GetString(), key.doc_hybrid_time()});
+  return Status::OK();
+}
+
+Status RangeTombstones::Read(const Slice& hashed_part, IntentAwareIterator* iter) {
+  Reset(hashed_part);
+  KeyBytes prefix(hashed_part);
+  prefix.AppendValueType(ValueType::kGroupEnd);
+  RangeTombstonesColumn().AppendToKey(&prefix);
+  IntentAwareIteratorPrefixScope prefix_scope(prefix.AsSlice(), iter);
+  iter->SeekWithoutHt(prefix.AsSlice());
+  while (iter->valid()) {
+    auto key = iter->FetchKey();
+    RETURN_NOT_OK(key);
+    SubDocKey record_key;
+    RETURN_NOT_OK(record_key.FullyDecodeFrom(*key));
+    Value value;
+    RETURN_NOT_OK(value.Decode(iter->value()));
+    // Only the latest version of each record visible at the read time matters, the older ones are
+    // skipped.
+    if (value.value_type() == ValueType::kTombstone) {
+      RETURN_NOT_OK(Add(record_key));
+    }
+    iter->SeekPastSubKey(record_key);
+  }
+  return Status::OK();
+}
+
+DocHybridTime RangeTombstones::DeletedAt(const Slice& range_group) const {
+  DocHybridTime result = DocHybridTime::kMin;
+  for (const auto& tombstone : tombstones_) {
+    if (tombstone.time > result && tombstone.Covers(range_group)) {
+      result = tombstone.time;
+    }
+  }
+  return result;
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -0,0 +1,107 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_RANGE_TOMBSTONE_H
+#define YB_DOCDB_RANGE_TOMBSTONE_H
+
+#include <string>
+#include <vector>
+
+#include "yb/common/doc_hybrid_time.h"
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/doc_path.h"
+#include "yb/docdb/primitive_value.h"
+#include "yb/util/slice.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace docdb {
+
+class IntentAwareIterator;
+
+// A range tombstone deletes the rows of a hash key whose range components lie in a range with a
+// single record, instead of a tombstone per row. It is stored in the static row of the hash key,
+// i.e. the document keyed by the hashed components only, which sorts before the rows of the hash
+// key:
+//
+//   SubDocKey(DocKey(hash, [hashed components], []),
+//             [SystemColumnId(kRangeTombstones), lower, upper; HT]) -> DEL
+//
+// lower and upper are strings holding encoded range groups, i.e. the part of the encoded DocKey of
+// a row that follows its hashed components. The records of a row written before HT are deleted if
+// lower <= the encoded range group of the row < upper, an empty bound leaving that side unbounded.
+// As the value of the record is a tombstone, it does not make the static row visible, and full
+// compactions remove it, together with the records it covers, once it is below the history cutoff.
+struct RangeTombstone {
+  std::string lower;
+  std::string upper;
+  DocHybridTime time;
+
+  bool Covers(const Slice& range_group) const {
+    return (lower.empty() || range_group.compare(lower) >= 0) &&
+           (upper.empty() || range_group.compare(upper) < 0);
+  }
+};
+
+// Returns the path of the record of a range tombstone of the hash key with the given bounds.
+DocPath RangeTombstonePath(const DocKey& hashed_doc_key,
+                           const std::string& lower,
+                           const std::string& upper);
+
+// Returns whether the key is the key of a range tombstone record.
+bool IsRangeTombstoneKey(const SubDocKey& key);
+
+// Returns the encoded range group of a DocKey with the given range components.
+std::string EncodeRangeGroup(const std::vector<PrimitiveValue>& range_components);
+
+// Splits the DocKey that the encoded key starts with into its hashed part, see
+// DocKeyPart::HASHED_PART_ONLY, and its range group.
+CHECKED_STATUS SplitDocKey(const Slice& key, Slice* hashed_part, Slice* range_group);
+
+// The range tombstones of one hash key.
+class RangeTombstones {
+ public:
+  // Whether these are the range tombstones of the hash key with the given hashed part.
+  bool IsFor(const Slice& hashed_part) const {
+    return initialized_ && hashed_part == Slice(hashed_part_);
+  }
+
+  bool empty() const {
+    return tombstones_.empty();
+  }
+
+  // Clears the range tombstones and starts collecting the ones of the given hash key.
+  void Reset(const Slice& hashed_part);
+
+  // Adds the range tombstone stored in the record with the given key, which should be a key of a
+  // range tombstone record of the current hash key.
+  CHECKED_STATUS Add(const SubDocKey& key);
+
+  // Replaces the range tombstones with the ones of the given hash key that are visible at the read
+  // time of the iterator. The iterator is then positioned after the range tombstone records.
+  CHECKED_STATUS Read(const Slice& hashed_part, IntentAwareIterator* iter);
+
+  // Returns the latest time at which the row with the given encoded range group was deleted by
+  // these range tombstones, or DocHybridTime::kMin if none of them covers it.
+  DocHybridTime DeletedAt(const Slice& range_group) const;
+
+ private:
+  bool initialized_ = false;
+  std::string hashed_part_;
+  std::vector<RangeTombstone> tombstones_;
+};
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif  // YB_DOCDB_RANGE_TOMBSTONE_H
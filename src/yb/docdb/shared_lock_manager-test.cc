@@ -19,6 +19,9 @@
 
 #include "yb/docdb/shared_lock_manager.h"
 
+#include "yb/util/format.h"
+#include "yb/util/metrics.h"
+#include "yb/util/monotime.h"
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
 
@@ -27,6 +30,10 @@ using std::vector;
 using std::stack;
 using std::thread;
 
+METRIC_DEFINE_entity(test_entity);
+METRIC_DEFINE_counter(test_entity, test_lock_waits, "Test Lock Waits",
+                      yb::MetricUnit::kRequests, "Number of key locks that had to wait");
+
 namespace yb {
 namespace docdb {
 
@@ -383,5 +390,45 @@ TEST_F(SharedLockManagerTest, LockBatchReset) {
   EXPECT_TRUE(lb.empty());
 }
 
+TEST_F(SharedLockManagerTest, LockWaitsCounter) {
+  MetricRegistry registry;
+  auto entity = METRIC_ENTITY_test_entity.Instantiate(&registry, "lock-waits-test");
+  auto lock_waits = METRIC_test_lock_waits.Instantiate(entity);
+  lm_.SetLockWaitsCounter(lock_waits);
+
+  // Non-conflicting intents on the same key do not wait.
+  lm_.LockInTest("foo", IntentType::kWeakSerializableRead);
+  lm_.LockInTest("foo", IntentType::kWeakSerializableWrite);
+  ASSERT_EQ(0, lock_waits->value());
+
+  std::atomic<bool> locked(false);
+  thread t([this, &locked] {
+    lm_.LockInTest("foo", IntentType::kStrongSnapshotWrite);
+    locked = true;
+    lm_.UnlockInTest("foo", IntentType::kStrongSnapshotWrite);
+  });
+  SleepFor(MonoDelta::FromMilliseconds(100));
+  ASSERT_FALSE(locked.load());
+  lm_.UnlockInTest("foo", IntentType::kWeakSerializableWrite);
+  lm_.UnlockInTest("foo", IntentType::kWeakSerializableRead);
+  t.join();
+  ASSERT_TRUE(locked.load());
+  ASSERT_EQ(1, lock_waits->value());
+}
+
+TEST_F(SharedLockManagerTest, ManyKeysAcrossShards) {
+  // Lock more distinct keys than there are shards and free entries, to exercise entry reuse.
+  constexpr int kNumKeys =
+      SharedLockManager::kNumShards * SharedLockManager::kMaxFreeEntriesPerShard * 2;
+  for (int iteration = 0; iteration < 3; ++iteration) {
+    KeyToIntentTypeMap keys;
+    for (int i = 0; i < kNumKeys; ++i) {
+      keys.emplace(Format("key$0_$1", iteration, i), IntentType::kStrongSnapshotWrite);
+    }
+    LockBatch lb(&lm_, std::move(keys));
+    ASSERT_EQ(kNumKeys, lb.size());
+  }
+}
+
 } // namespace docdb
 } // namespace yb
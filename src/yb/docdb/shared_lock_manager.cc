@@ -21,6 +21,7 @@
 #include "yb/util/bytes_formatter.h"
 #include "yb/util/enums.h"
 #include "yb/util/logging.h"
+#include "yb/util/metrics.h"
 #include "yb/util/trace.h"
 #include "yb/util/tostring.h"
 
@@ -196,14 +197,24 @@ IntentType SharedLockManager::CombineIntents(const IntentType i1, const IntentTy
   FATAL_INVALID_ENUM_VALUE(IntentType, i1);
 }
 
-void SharedLockManager::LockEntry::Lock(IntentType lock_type) {
-  // TODO(bojanserafimov): Implement CAS fast path. Only wait when CAS fails.
+bool SharedLockManager::LockEntry::Lock(IntentType lock_type) {
   int type_idx = static_cast<size_t>(lock_type);
   std::unique_lock<std::mutex> lock(mutex);
   auto& state = this->state;
-  cond_var.wait(lock, [&state, type_idx]() {
-    return (state & kIntentConflicts[type_idx]).none();
-  });
+  bool waited = false;
+  while ((state & kIntentConflicts[type_idx]).any()) {
+    waited = true;
+    cond_var.wait(lock);
+  }
+  ++num_holding[type_idx];
+  state.set(type_idx);
+  return waited;
+}
+
+void SharedLockManager::LockEntry::LockUnshared(IntentType lock_type) {
+  DCHECK_EQ(num_using, 1);
+  DCHECK(state.none());
+  size_t type_idx = static_cast<size_t>(lock_type);
   ++num_holding[type_idx];
   state.set(type_idx);
 }
@@ -228,43 +239,93 @@ void SharedLockManager::LockEntry::Unlock(IntentType lock_type) {
   }
 }
 
+void SharedLockManager::LockEntry::Reset() {
+  DCHECK_EQ(num_using, 0);
+  DCHECK(state.none());
+  num_holding.fill(0);
+  state.reset();
+}
+
+SharedLockManager::SharedLockManager() {
+  static_assert((kNumShards & (kNumShards - 1)) == 0, "kNumShards should be a power of 2");
+}
+
+SharedLockManager::~SharedLockManager() {
+}
+
+void SharedLockManager::SetLockWaitsCounter(const scoped_refptr<Counter>& lock_waits) {
+  lock_waits_ = lock_waits;
+}
+
+SharedLockManager::Shard& SharedLockManager::ShardFor(const std::string& key) {
+  return shards_[std::hash<std::string>()(key) & (kNumShards - 1)];
+}
+
 void SharedLockManager::Lock(const KeyToIntentTypeMap& key_to_intent_type) {
   TRACE("Locking a batch of $0 keys", key_to_intent_type.size());
-  std::vector<SharedLockManager::LockEntry*> reserved = Reserve(key_to_intent_type);
-  size_t idx = 0;
+  // Keys are processed in the sorted order of the batch, so batches can't deadlock with each
+  // other. Only one shard mutex is held at a time, and never while waiting for a key lock.
   for (const auto& key_and_intent_type : key_to_intent_type) {
-    const auto intent_type = key_and_intent_type.second;
-    VLOG(4) << "Locking " << docdb::ToString(intent_type) << ": "
+    VLOG(4) << "Locking " << docdb::ToString(key_and_intent_type.second) << ": "
             << util::FormatBytesAsStr(key_and_intent_type.first);
-    reserved[idx]->Lock(intent_type);
-    idx++;
+    LockKey(key_and_intent_type.first, key_and_intent_type.second);
   }
 }
 
-std::vector<SharedLockManager::LockEntry*> SharedLockManager::Reserve(
-    const KeyToIntentTypeMap& key_to_intent_type) {
-  std::vector<SharedLockManager::LockEntry*> reserved;
-  reserved.reserve(key_to_intent_type.size());
+void SharedLockManager::LockKey(const std::string& key, IntentType intent_type) {
+  auto& shard = ShardFor(key);
+  LockEntry* entry;
   {
-    std::lock_guard<std::mutex> lock(global_mutex_);
-    for (const auto& key_and_intent_type : key_to_intent_type) {
-      auto it = locks_.emplace(key_and_intent_type.first, std::make_unique<LockEntry>()).first;
-      it->second->num_using++;
-      reserved.push_back(&*it->second);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.locks.find(key);
+    if (it == shard.locks.end()) {
+      std::unique_ptr<LockEntry> new_entry;
+      if (!shard.free_entries.empty()) {
+        new_entry = std::move(shard.free_entries.back());
+        shard.free_entries.pop_back();
+      } else {
+        new_entry = std::make_unique<LockEntry>();
+      }
+      entry = new_entry.get();
+      shard.locks.emplace(key, std::move(new_entry));
+      entry->num_using = 1;
+      // Fast path: nobody else could reference the entry yet, so there are no conflicting
+      // holders and no need to touch the entry mutex.
+      entry->LockUnshared(intent_type);
+      return;
     }
+    entry = it->second.get();
+    entry->num_using++;
+  }
+  if (entry->Lock(intent_type) && lock_waits_) {
+    lock_waits_->Increment();
   }
-  return reserved;
 }
 
 void SharedLockManager::Unlock(const KeyToIntentTypeMap& key_to_intent_type) {
   TRACE("Unlocking a batch of $0 keys", key_to_intent_type.size());
-  std::lock_guard<std::mutex> lock(global_mutex_);
   for (const auto& key_and_intent_type : boost::adaptors::reverse(key_to_intent_type)) {
     VLOG(4) << "Unlocking " << docdb::ToString(key_and_intent_type.second) << ": "
             << util::FormatBytesAsStr(key_and_intent_type.first);
-    locks_[key_and_intent_type.first]->Unlock(key_and_intent_type.second);
+    UnlockKey(key_and_intent_type.first, key_and_intent_type.second);
+  }
+}
+
+void SharedLockManager::UnlockKey(const std::string& key, IntentType intent_type) {
+  auto& shard = ShardFor(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.locks.find(key);
+  DCHECK(it != shard.locks.end()) << "Unlocking key that is not locked: "
+                                  << util::FormatBytesAsStr(key);
+  auto& entry = it->second;
+  entry->Unlock(intent_type);
+  if (--entry->num_using == 0) {
+    if (shard.free_entries.size() < kMaxFreeEntriesPerShard) {
+      entry->Reset();
+      shard.free_entries.push_back(std::move(entry));
+    }
+    shard.locks.erase(it);
   }
-  Cleanup(key_to_intent_type);
 }
 
 void SharedLockManager::LockInTest(const string& key, IntentType intent_type) {
@@ -275,15 +336,5 @@ void SharedLockManager::UnlockInTest(const string& key, IntentType intent_type)
   Unlock({{key, intent_type}});
 }
 
-void SharedLockManager::Cleanup(const KeyToIntentTypeMap& key_to_intent_type) {
-  for (const auto& item : key_to_intent_type) {
-    auto it = locks_.find(item.first);
-    it->second->num_using--;
-    if (it->second->num_using == 0) {
-      locks_.erase(it);
-    }
-  }
-}
-
 }  // namespace docdb
 }  // namespace yb
@@ -14,7 +14,10 @@
 #ifndef YB_DOCDB_SHARED_LOCK_MANAGER_H
 #define YB_DOCDB_SHARED_LOCK_MANAGER_H
 
+#include <array>
+#include <condition_variable>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
@@ -22,10 +25,15 @@
 
 #include "yb/docdb/shared_lock_manager_fwd.h"
 #include "yb/docdb/lock_batch.h"
+#include "yb/gutil/port.h"
+#include "yb/gutil/ref_counted.h"
 #include "yb/gutil/spinlock.h"
 #include "yb/util/cross_thread_mutex.h"
 
 namespace yb {
+
+class Counter;
+
 namespace docdb {
 
 // This class manages six types of locks on string keys. On each key, the possibilities are:
@@ -34,8 +42,24 @@ namespace docdb {
 // - Multiple kStrongSerializableRead and kWeakSerializableRead
 // - Multiple kStrongSerializableWrite and kWeakSerializableWrite
 // - Multiple kWeakSnapshotWrite, kWeakSerializableRead, and kWeakSerializableWrite
+//
+// The lock table is split into kNumShards hash-partitioned shards, each with its own mutex, so
+// that batches touching different keys do not contend on a single global mutex. Lock entries
+// are recycled through a bounded per-shard free list instead of being allocated for every key.
 class SharedLockManager {
  public:
+  // Number of lock table shards. Must be a power of 2.
+  static constexpr size_t kNumShards = 16;
+
+  // Maximum number of unused lock entries retained by each shard for reuse.
+  static constexpr size_t kMaxFreeEntriesPerShard = 64;
+
+  SharedLockManager();
+  ~SharedLockManager();
+
+  // Counter incremented each time a key lock could not be granted immediately because of a
+  // conflicting holder, and the caller had to wait. Could be null.
+  void SetLockWaitsCounter(const scoped_refptr<Counter>& lock_waits);
 
   // Attempt to lock a batch of keys. The call may be blocked waiting for other locks to be
   // released. If the entries don't exist, they are created. The lock batch gets associated with
@@ -63,17 +87,27 @@ class SharedLockManager {
 
     std::condition_variable cond_var;
 
-    // Refcounting for garbage collection. Can only be used while the global lock is held.
+    // Refcounting for garbage collection. Can only be used while the shard's lock is held.
     size_t num_using = 0;
 
     // Number of holders for each type
     std::array<size_t, kIntentTypeMapSize> num_holding;
     LockState state;
 
-    void Lock(IntentType lock_type);
+    // Acquires the lock, waiting for conflicting holders to release it. Returns true if the
+    // caller had to wait.
+    bool Lock(IntentType lock_type);
 
     void Unlock(IntentType lock_type);
 
+    // Grants the lock without taking the entry mutex. Could only be used on an entry that is not
+    // visible to any other thread, i.e. one that was just reserved with num_using == 1 while the
+    // shard lock is still held.
+    void LockUnshared(IntentType lock_type);
+
+    // Resets the entry to the initial state, so it could be reused for another key.
+    void Reset();
+
     LockEntry() {
       num_holding.fill(0);
     }
@@ -81,19 +115,28 @@ class SharedLockManager {
 
   typedef std::unordered_map<std::string, std::unique_ptr<LockEntry>> LockEntryMap;
 
-  // Make sure the entries exist in the locks_ map and return pointers so we can access
-  // them without holding the global lock. Returns a vector with pointers in the same order
-  // as the keys in the batch.
-  std::vector<LockEntry*> Reserve(const KeyToIntentTypeMap& batch);
+  struct CACHELINE_ALIGNED Shard {
+    // Taken only for very short duration, with no blocking wait.
+    std::mutex mutex;
+
+    // Can only be modified if the shard mutex is held.
+    LockEntryMap locks;
+
+    // Unused entries available for reuse. Guarded by the shard mutex.
+    std::vector<std::unique_ptr<LockEntry>> free_entries;
+  };
+
+  Shard& ShardFor(const std::string& key);
+
+  // Acquires the lock of the given type on the key, creating the lock entry if necessary.
+  void LockKey(const std::string& key, IntentType intent_type);
 
-  // Update refcounts and maybe collect garbage.
-  void Cleanup(const KeyToIntentTypeMap& key_to_intent_type);
+  // Releases the lock on the key, and recycles the lock entry if it is no longer used.
+  void UnlockKey(const std::string& key, IntentType intent_type);
 
-  // The global mutex should be taken only for very short duration, with no blocking wait.
-  std::mutex global_mutex_;
+  std::array<Shard, kNumShards> shards_;
 
-  // Can only be modified if the global mutex is held.
-  LockEntryMap locks_;
+  scoped_refptr<Counter> lock_waits_;
 };
 
 extern const std::array<LockState, kIntentTypeMapSize> kIntentConflicts;
@@ -205,6 +205,9 @@ class SubDocument : public PrimitiveValue {
   // represented as SubDocuments) in InMemDocDbState, and we need access to object_container()
   // from there.
   friend class InMemDocDbState;
+
+  // DocRowCache estimates the memory used by the cached documents.
+  friend class DocRowCache;
 };
 
 std::ostream& operator <<(ostream& out, const SubDocument& subdoc);
@@ -60,6 +60,14 @@ Status Value::DecodeTTL(rocksdb::Slice* slice, MonoDelta* ttl) {
   return Status::OK();
 }
 
+Status Value::DecodeTTLSkippingIntentDocHT(const rocksdb::Slice& rocksdb_value,
+                                           MonoDelta* ttl) {
+  auto slice_copy = rocksdb_value;
+  DocHybridTime intent_doc_ht;
+  RETURN_NOT_OK(DecodeIntentDocHT(&slice_copy, &intent_doc_ht));
+  return DecodeTTL(&slice_copy, ttl);
+}
+
 Status Value::DecodeUserTimestamp(const rocksdb::Slice& rocksdb_value,
                                   UserTimeMicros* user_timestamp) {
   MonoDelta ttl;
@@ -67,6 +67,11 @@ class Value {
     return DecodeTTL(&value_copy, ttl);
   }
 
+  // Same as DecodeTTL, but the value could start with the intent doc hybrid time, as the values
+  // written by transactions do.
+  static CHECKED_STATUS DecodeTTLSkippingIntentDocHT(const rocksdb::Slice& rocksdb_value,
+                                                     MonoDelta* ttl);
+
   // Decode the entire value
   CHECKED_STATUS Decode(const rocksdb::Slice &rocksdb_value);
 
@@ -62,6 +62,8 @@ string ToString(ValueType value_type) {
     case ValueType::kArray: return "Array";
     case ValueType::kArrayIndex: return "ArrayIndex";
     case ValueType::kTombstone: return "Tombstone";
+    case ValueType::kPackedRow: return "PackedRow";
+    case ValueType::kCounterDelta: return "CounterDelta";
     case ValueType::kTtl: return "Ttl";
     case ValueType::kUserTimestamp: return "UserTimestamp";
     case ValueType::kTransactionId: return "TransactionId";
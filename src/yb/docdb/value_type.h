@@ -86,6 +86,10 @@ enum class ValueType : char {
   kColumnId = 'K',  // ASCII code 75
   kDoubleDescending = 'L',  // ASCII code 76
   kFloatDescending = 'M', // ASCII code 77
+  // An increment of a counter column, added to the older values of the column by the readers.
+  kCounterDelta = 'N',  // ASCII code 78
+  // The columns of a row stored in one value of the row's DocKey, see packed_row.h.
+  kPackedRow = 'P',  // ASCII code 80
   kString = 'S',  // ASCII code 83
   kTrue = 'T',  // ASCII code 84
   kTombstone = 'X',  // ASCII code 88
@@ -212,7 +216,8 @@ constexpr inline bool IsCollectionType(const ValueType value_type) {
 constexpr inline bool IsPrimitiveValueType(const ValueType value_type) {
   return kMinPrimitiveValueType <= value_type && value_type <= kMaxPrimitiveValueType &&
          !IsCollectionType(value_type) &&
-         value_type != ValueType::kTombstone;
+         value_type != ValueType::kTombstone && value_type != ValueType::kPackedRow &&
+         value_type != ValueType::kCounterDelta;
 }
 
 // Decode the first byte of the given slice as a ValueType.
@@ -23,6 +23,9 @@ using namespace std::literals; // NOLINT
 DECLARE_int64(global_memstore_size_percentage);
 DECLARE_int64(global_memstore_size_mb_max);
 DECLARE_int32(memstore_size_mb);
+DECLARE_int32(global_memstore_flush_min_size_mb);
+
+METRIC_DECLARE_histogram(global_memstore_flush_size);
 
 namespace yb {
 namespace client {
@@ -108,5 +111,21 @@ TEST_F(FlushITest, TestFlushHappens) {
   ASSERT_GT(flushes_since_write, 0);
 }
 
+// With a minimum flush size above the memstore share of every tablet, memstores are only flushed
+// once together they take the whole global memstore, and then the largest of them first.
+TEST_F(FlushITest, TestSmallMemstoresDeferred) {
+  FLAGS_global_memstore_flush_min_size_mb = kServerLimitMB;
+  const size_t total_flushes_before = TotalFlushes();
+  WriteAtLeast((kServerLimitMB << 20) * 2);
+  ASSERT_OK(WaitFor(
+      [this, total_flushes_before] { return TotalFlushes() > total_flushes_before; },
+      60s, "Flush", 10ms));
+
+  auto flush_size = METRIC_global_memstore_flush_size.Instantiate(
+      cluster_->mini_tablet_server(0)->server()->metric_entity());
+  ASSERT_GT(flush_size->TotalCount(), 0);
+  ASSERT_GE(flush_size->MinValueForTests(), (kServerLimitMB << 20) / kNumTablets);
+}
+
 } // namespace tserver
 } // namespace yb
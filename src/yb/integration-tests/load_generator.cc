@@ -14,6 +14,7 @@
 #include "yb/integration-tests/load_generator.h"
 
 #include <gflags/gflags_declare.h>
+#include <cmath>
 #include <memory>
 #include <queue>
 #include <random>
@@ -89,6 +90,26 @@ DEFINE_int32(load_gen_wait_time_increment_step_ms,
              "In retry loops used in the load test we increment the wait time by this number of "
              "milliseconds after every attempt.");
 
+DEFINE_string(load_gen_read_key_distribution,
+              "recent",
+              "Distribution of the keys read by the load generator's readers among the inserted "
+              "keys: recent (the latest inserted key, a recently inserted one or an older one), "
+              "uniform, zipfian or hotspot.");
+
+DEFINE_double(load_gen_zipfian_exponent,
+              0.99,
+              "Exponent of the zipfian read key distribution.");
+
+DEFINE_double(load_gen_hotspot_keys_fraction,
+              0.2,
+              "Fraction of the inserted keys, the first inserted ones, that are hot with the "
+              "hotspot read key distribution.");
+
+DEFINE_double(load_gen_hotspot_ops_fraction,
+              0.8,
+              "Fraction of the reads that go to the hot keys with the hotspot read key "
+              "distribution.");
+
 namespace {
 
 void ConfigureYBSession(YBSession* session) {
@@ -203,6 +224,105 @@ SingleThreadedWriter* RedisNoopSessionFactory::GetWriter(MultiThreadedWriter* wr
   return new RedisNoopSingleThreadedWriter(writer, redis_server_addresses_, idx);
 }
 
+// ------------------------------------------------------------------------------------------------
+// ZipfianGenerator
+// ------------------------------------------------------------------------------------------------
+
+namespace {
+
+// log(1 + x) / x, accurate for x close to 0.
+double Log1pOverX(double x) {
+  return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1 - x * (0.5 - x * (1.0 / 3 - 0.25 * x));
+}
+
+// (exp(x) - 1) / x, accurate for x close to 0.
+double Expm1OverX(double x) {
+  return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1 + x * 0.5 * (1 + x / 3 * (1 + 0.25 * x));
+}
+
+}  // namespace
+
+ZipfianGenerator::ZipfianGenerator(int64_t num_keys, double exponent)
+    : num_keys_(std::max<int64_t>(num_keys, 1)),
+      exponent_(exponent),
+      h_integral_x1_(HIntegral(1.5) - 1),
+      h_integral_num_keys_(HIntegral(num_keys_ + 0.5)),
+      s_(2 - HIntegralInverse(HIntegral(2.5) - H(2))) {
+}
+
+int64_t ZipfianGenerator::Next(std::mt19937_64* random_number_generator) const {
+  std::uniform_real_distribution<double> uniform;
+  for (;;) {
+    const double u = h_integral_num_keys_ +
+        uniform(*random_number_generator) * (h_integral_x1_ - h_integral_num_keys_);
+    const double x = HIntegralInverse(u);
+    const int64_t k = std::min(std::max<int64_t>(x + 0.5, 1), num_keys_);
+    if (k - x <= s_ || u >= HIntegral(k + 0.5) - H(k)) {
+      return k - 1;
+    }
+  }
+}
+
+double ZipfianGenerator::H(double x) const {
+  return std::exp(-exponent_ * std::log(x));
+}
+
+double ZipfianGenerator::HIntegral(double x) const {
+  const double log_x = std::log(x);
+  return Expm1OverX((1 - exponent_) * log_x) * log_x;
+}
+
+double ZipfianGenerator::HIntegralInverse(double x) const {
+  const double t = std::max(x * (1 - exponent_), -1.0);
+  return std::exp(Log1pOverX(t) * x);
+}
+
+// ------------------------------------------------------------------------------------------------
+// LatencyRecorder
+// ------------------------------------------------------------------------------------------------
+
+namespace {
+
+// Latencies up to an hour are tracked.
+constexpr uint64_t kMaxTrackedLatencyUs = 3600LL * 1000 * 1000;
+
+std::shared_ptr<HdrHistogram> NewLatencyHistogram() {
+  return std::make_shared<HdrHistogram>(kMaxTrackedLatencyUs, 3 /* num_significant_digits */);
+}
+
+}  // namespace
+
+LatencyRecorder::LatencyRecorder()
+    : interval_(NewLatencyHistogram()), total_(NewLatencyHistogram()) {
+}
+
+void LatencyRecorder::Record(int64_t latency_us) {
+  std::shared_ptr<HdrHistogram> interval;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    interval = interval_;
+  }
+  interval->Increment(latency_us);
+  total_->Increment(latency_us);
+}
+
+std::shared_ptr<HdrHistogram> LatencyRecorder::TakeInterval() {
+  auto new_interval = NewLatencyHistogram();
+  std::lock_guard<std::mutex> lock(mutex_);
+  interval_.swap(new_interval);
+  return new_interval;
+}
+
+string LatencyRecorder::Summary(const HdrHistogram& histogram) {
+  if (histogram.TotalCount() == 0) {
+    return "no operations";
+  }
+  return Substitute(
+      "$0 ops, mean: $1 us, p50: $2 us, p99: $3 us, p99.9: $4 us, max: $5 us",
+      histogram.TotalCount(), histogram.MeanValue(), histogram.ValueAtPercentile(50),
+      histogram.ValueAtPercentile(99), histogram.ValueAtPercentile(99.9), histogram.MaxValue());
+}
+
 // ------------------------------------------------------------------------------------------------
 // MultiThreadedAction
 // ------------------------------------------------------------------------------------------------
@@ -251,6 +371,11 @@ string MultiThreadedAction::GetValueByIndex(int64_t key_index) {
 
 void MultiThreadedAction::Start() {
   LOG(INFO) << "Starting " << num_action_threads_ << " " << description_ << " threads";
+  if (target_ops_per_sec_ > 0) {
+    LOG(INFO) << "Open-loop " << description_ << " target rate: " << target_ops_per_sec_
+              << " ops/sec";
+  }
+  schedule_start_ = MonoTime::Now();
   CHECK_OK(thread_pool_->SubmitFunc(std::bind(&MultiThreadedAction::RunStatsThread, this)));
   for (int i = 0; i < num_action_threads_; i++) {
     CHECK_OK(thread_pool_->SubmitFunc(std::bind(&MultiThreadedAction::RunActionThread, this, i)));
@@ -259,6 +384,31 @@ void MultiThreadedAction::Start() {
 
 void MultiThreadedAction::WaitForCompletion() {
   thread_pool_->Wait();
+  LOG(INFO) << "Total " << description_ << " latency: " << LatencyRecorder::Summary(
+      latencies_.total());
+}
+
+MonoTime MultiThreadedAction::WaitForNextOperation() {
+  if (target_ops_per_sec_ <= 0) {
+    return MonoTime::Now();
+  }
+  const int64_t op_index = next_scheduled_op_++;
+  const MonoTime scheduled_time = schedule_start_ + MonoDelta::FromNanoseconds(
+      static_cast<int64_t>(op_index * 1e9 / target_ops_per_sec_));
+  const MonoTime now = MonoTime::Now();
+  if (now < scheduled_time) {
+    SleepFor(scheduled_time - now);
+  }
+  return scheduled_time;
+}
+
+void MultiThreadedAction::OperationCompleted(MonoTime scheduled_time) {
+  latencies_.Record((MonoTime::Now() - scheduled_time).ToMicroseconds());
+}
+
+void MultiThreadedAction::LogIntervalLatencies() {
+  LOG(INFO) << description_ << " latency in the last interval: "
+            << LatencyRecorder::Summary(*latencies_.TakeInterval());
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -307,7 +457,10 @@ void SingleThreadedWriter::Run() {
     string key_str(multi_threaded_writer_->GetKeyByIndex(key_index));
     string value_str(multi_threaded_writer_->GetValueByIndex(key_index));
 
-    if (Write(key_index, key_str, value_str)) {
+    const MonoTime scheduled_time = multi_threaded_writer_->WaitForNextOperation();
+    const bool written = Write(key_index, key_str, value_str);
+    multi_threaded_writer_->OperationCompleted(scheduled_time);
+    if (written) {
       multi_threaded_writer_->inserted_keys_.Insert(key_index);
     } else {
       multi_threaded_writer_->failed_keys_.Insert(key_index);
@@ -453,6 +606,7 @@ void MultiThreadedWriter::RunStatsThread() {
               << (num_writes - prev_writes) * 1000000.0 / (current_time - prev_time)
               << " writes/sec), contiguous insertion point: " << inserted_up_to_inclusive_.load()
               << ", write errors: " << failed_keys_.NumElements();
+    LogIntervalLatencies();
     prev_writes = num_writes;
     prev_time = current_time;
   }
@@ -489,6 +643,27 @@ int64_t SingleThreadedScanner::CountRows() {
 // MultiThreadedReader
 // ------------------------------------------------------------------------------------------------
 
+namespace {
+
+KeyDistribution ParseKeyDistribution(const string& distribution) {
+  if (distribution == "recent") {
+    return KeyDistribution::kRecent;
+  }
+  if (distribution == "uniform") {
+    return KeyDistribution::kUniform;
+  }
+  if (distribution == "zipfian") {
+    return KeyDistribution::kZipfian;
+  }
+  if (distribution == "hotspot") {
+    return KeyDistribution::kHotspot;
+  }
+  LOG(FATAL) << "Unknown read key distribution: " << distribution;
+  return KeyDistribution::kRecent;
+}
+
+}  // namespace
+
 MultiThreadedReader::MultiThreadedReader(int64_t num_keys, int num_reader_threads,
                                          SessionFactory* session_factory,
                                          atomic<int64_t>* insertion_point,
@@ -506,7 +681,8 @@ MultiThreadedReader::MultiThreadedReader(int64_t num_keys, int num_reader_thread
       num_reads_(0),
       num_read_errors_(0),
       max_num_read_errors_(max_num_read_errors),
-      stop_on_empty_read_(stop_on_empty_read) {}
+      stop_on_empty_read_(stop_on_empty_read),
+      key_distribution_(ParseKeyDistribution(FLAGS_load_gen_read_key_distribution)) {}
 
 void MultiThreadedReader::RunActionThread(int reader_index) {
   unique_ptr<SingleThreadedReader> reader_loop(session_factory_->GetReader(this, reader_index));
@@ -526,6 +702,7 @@ void MultiThreadedReader::RunStatsThread() {
     LOG(INFO) << "Read " << num_rows_read << " rows ("
               << (num_rows_read - prev_rows_read) * 1000000.0 / (current_time - prev_time)
               << " reads/sec), read errors: " << num_read_errors_.load();
+    LogIntervalLatencies();
     prev_rows_read = num_rows_read;
     prev_time = current_time;
   }
@@ -678,7 +855,9 @@ void SingleThreadedReader::Run() {
     ++multi_threaded_reader_->num_reads_;
     const string key_str(multi_threaded_reader_->GetKeyByIndex(key_index));
     const string expected_value_str(multi_threaded_reader_->GetValueByIndex(key_index));
+    const MonoTime scheduled_time = multi_threaded_reader_->WaitForNextOperation();
     const ReadStatus read_status = PerformRead(key_index, key_str, expected_value_str);
+    multi_threaded_reader_->OperationCompleted(scheduled_time);
 
     // Read operation returning zero rows is treated as a read error.
     // See: https://yugabyte.atlassian.net/browse/ENG-1272
@@ -695,6 +874,31 @@ int64_t SingleThreadedReader::NextKeyIndexToRead(std::mt19937_64* random_number_
   VLOG(3) << "Reader thread " << reader_index_ << " waiting to load insertion point";
   int64_t written_up_to = multi_threaded_reader_->insertion_point_->load();
   do {
+        // The continue statements below go to the loop condition.
+        switch (multi_threaded_reader_->key_distribution_) {
+          case KeyDistribution::kRecent:
+            break;
+          case KeyDistribution::kUniform:
+            key_index = (*random_number_generator)() % (written_up_to + 1);
+            continue;
+          case KeyDistribution::kZipfian:
+            key_index = ZipfianGenerator(written_up_to + 1, FLAGS_load_gen_zipfian_exponent)
+                .Next(random_number_generator);
+            continue;
+          case KeyDistribution::kHotspot: {
+            const int64_t num_hot_keys = std::max<int64_t>(
+                (written_up_to + 1) * FLAGS_load_gen_hotspot_keys_fraction, 1);
+            std::uniform_real_distribution<double> uniform;
+            if (num_hot_keys > written_up_to ||
+                uniform(*random_number_generator) < FLAGS_load_gen_hotspot_ops_fraction) {
+              key_index = (*random_number_generator)() % num_hot_keys;
+            } else {
+              key_index = num_hot_keys +
+                  (*random_number_generator)() % (written_up_to + 1 - num_hot_keys);
+            }
+            continue;
+          }
+        }
         VLOG(3) << "Reader thread " << reader_index_ << " coin toss";
         switch ((*random_number_generator)() % 3) {
           case 0:
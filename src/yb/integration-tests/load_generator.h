@@ -28,6 +28,8 @@
 #include "yb/gutil/stl_util.h"
 #include "yb/util/threadpool.h"
 #include "yb/util/countdown_latch.h"
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/monotime.h"
 #include "yb/util/test_util.h"
 
 using std::shared_ptr;
@@ -60,6 +62,60 @@ class KeyIndexSet {
   friend std::ostream& operator <<(std::ostream& out, const KeyIndexSet &key_index_set);
 };
 
+// Generates the indexes of keys in [0, num_keys) with a Zipfian distribution: the probability of
+// the index i is proportional to 1 / (i + 1)^exponent. Uses rejection-inversion sampling, which
+// does not need to precompute anything for the key range, so a generator is cheap to create.
+class ZipfianGenerator {
+ public:
+  ZipfianGenerator(int64_t num_keys, double exponent);
+
+  int64_t Next(std::mt19937_64* random_number_generator) const;
+
+ private:
+  double H(double x) const;
+  double HIntegral(double x) const;
+  double HIntegralInverse(double x) const;
+
+  const int64_t num_keys_;
+  const double exponent_;
+  const double h_integral_x1_;
+  const double h_integral_num_keys_;
+  const double s_;
+};
+
+// Distribution of the keys read by readers.
+enum class KeyDistribution {
+  // The latest inserted key, a recently inserted one or an older one, with equal probabilities.
+  kRecent,
+  kUniform,
+  // Zipfian over the inserted keys, with the first inserted keys being the most frequent ones.
+  kZipfian,
+  // FLAGS_load_gen_hotspot_ops_fraction of the reads go to the first
+  // FLAGS_load_gen_hotspot_keys_fraction of the inserted keys, the others to the other keys.
+  kHotspot,
+};
+
+// Records operation latencies in microseconds, both in total and per reporting interval.
+class LatencyRecorder {
+ public:
+  LatencyRecorder();
+
+  void Record(int64_t latency_us);
+
+  // Returns the latencies recorded since the previous call, or since the start, and starts a new
+  // interval.
+  std::shared_ptr<HdrHistogram> TakeInterval();
+
+  const HdrHistogram& total() const { return *total_; }
+
+  static std::string Summary(const HdrHistogram& histogram);
+
+ private:
+  std::mutex mutex_;
+  std::shared_ptr<HdrHistogram> interval_;
+  std::shared_ptr<HdrHistogram> total_;
+};
+
 class SessionFactory {
  public:
   virtual ~SessionFactory() {}
@@ -125,6 +181,18 @@ class MultiThreadedAction {
   bool IsStopRequested() { return stop_requested_->load(); }
   void set_client_id(const std::string& client_id) { client_id_ = client_id; }
 
+  // Makes the action open-loop: its operations are started at target_ops_per_sec in total, no
+  // matter how long the previous operations take, and their latencies are measured from the time
+  // they were scheduled at, so that the queueing of the operations which could not start in time
+  // is included in the latencies (no coordinated omission). There should be enough action threads
+  // to sustain the rate. 0, the default, means closed-loop: every thread starts its next operation
+  // as soon as its previous one completes. Should be called before Start().
+  void set_target_ops_per_sec(double target_ops_per_sec) {
+    target_ops_per_sec_ = target_ops_per_sec;
+  }
+
+  const LatencyRecorder& latencies() const { return latencies_; }
+
  protected:
   friend class SingleThreadedReader;
   friend class SingleThreadedWriter;
@@ -138,6 +206,16 @@ class MultiThreadedAction {
   virtual void RunActionThread(int actionIndex) = 0;
   virtual void RunStatsThread() = 0;
 
+  // Waits for the time the next operation of the action is scheduled at, when it is open-loop, and
+  // returns that time, the time the latency of the operation is measured from.
+  MonoTime WaitForNextOperation();
+
+  // Records the latency of an operation scheduled by WaitForNextOperation, upon its completion.
+  void OperationCompleted(MonoTime scheduled_time);
+
+  // Logs the latencies of the operations completed since the previous call.
+  void LogIntervalLatencies();
+
   std::string description_;
   const int64_t num_keys_;  // Total number of keys in the table after successful end of this action
   const int64_t start_key_;  // First insertion key index of the write action
@@ -150,6 +228,11 @@ class MultiThreadedAction {
   std::atomic_bool* const stop_requested_;
 
   const int value_size_;
+
+  double target_ops_per_sec_ = 0;
+  MonoTime schedule_start_;
+  std::atomic<int64_t> next_scheduled_op_{0};
+  LatencyRecorder latencies_;
 };
 
 // ------------------------------------------------------------------------------------------------
@@ -325,6 +408,7 @@ class MultiThreadedReader : public MultiThreadedAction {
   std::atomic<int64_t> num_read_errors_;
   const int max_num_read_errors_;
   const bool stop_on_empty_read_;
+  const KeyDistribution key_distribution_;
 };
 
 class SingleThreadedReader {
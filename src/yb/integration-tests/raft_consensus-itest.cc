@@ -75,6 +75,8 @@ DEFINE_int64(client_num_batches_per_thread, 5,
 DECLARE_int32(consensus_rpc_timeout_ms);
 DECLARE_int32(leader_lease_duration_ms);
 DECLARE_int32(ht_lease_duration_ms);
+DECLARE_int32(raft_heartbeat_interval_ms);
+DECLARE_double(leader_failure_max_missed_heartbeat_periods);
 
 METRIC_DECLARE_entity(tablet);
 METRIC_DECLARE_counter(operation_memory_pressure_rejections);
@@ -1380,6 +1382,60 @@ TEST_F(RaftConsensusITest, TestAutomaticLeaderElection) {
   ASSERT_ALL_REPLICAS_AGREE(FLAGS_client_inserts_per_thread * kFinalNumReplicas);
 }
 
+// Checks that the followers keep the leader when its heartbeats are batched with the ones of other
+// tablets.
+TEST_F(RaftConsensusITest, TestBatchedHeartbeats) {
+  vector<string> ts_flags = { "--consensus_heartbeat_batch_window_ms=20"s };
+  ASSERT_NO_FATALS(BuildAndStart(ts_flags));
+
+  TServerDetails* leader;
+  ASSERT_OK(GetLeaderReplicaWithRetries(tablet_id_, &leader));
+
+  InsertTestRowsRemoteThread(0, FLAGS_client_inserts_per_thread,
+                             FLAGS_client_num_batches_per_thread, vector<CountDownLatch*>());
+
+  // Idle for long enough that the followers would elect a new leader if the heartbeats were lost.
+  SleepFor(MonoDelta::FromMilliseconds(FLAGS_raft_heartbeat_interval_ms *
+                                       FLAGS_leader_failure_max_missed_heartbeat_periods * 3));
+
+  TServerDetails* new_leader;
+  ASSERT_OK(GetLeaderReplicaWithRetries(tablet_id_, &new_leader));
+  ASSERT_EQ(leader->uuid(), new_leader->uuid());
+  ASSERT_ALL_REPLICAS_AGREE(FLAGS_client_inserts_per_thread);
+}
+
+// Checks that a new leader is elected after the failure of the leader when the followers run a
+// pre-election first, and batch their vote requests.
+TEST_F(RaftConsensusITest, TestPreVoteElection) {
+  vector<string> ts_flags = { "--raft_enable_pre_vote=true"s,
+                              "--consensus_vote_batch_window_ms=10"s };
+  ASSERT_NO_FATALS(BuildAndStart(ts_flags));
+
+  TServerDetails* leader;
+  ASSERT_OK(GetLeaderReplicaWithRetries(tablet_id_, &leader));
+  const MonoDelta kTimeout = MonoDelta::FromSeconds(10);
+  consensus::ConsensusStatePB cstate;
+  ASSERT_OK(itest::GetConsensusState(leader, tablet_id_, consensus::CONSENSUS_CONFIG_ACTIVE,
+                                     kTimeout, &cstate));
+  const int64_t old_term = cstate.current_term();
+
+  InsertTestRowsRemoteThread(0, FLAGS_client_inserts_per_thread,
+                             FLAGS_client_num_batches_per_thread, vector<CountDownLatch*>());
+
+  LOG(INFO) << "Killing current leader " << leader->uuid();
+  cluster_->tablet_server_by_uuid(leader->uuid())->Shutdown();
+
+  TServerDetails* new_leader;
+  ASSERT_OK(GetLeaderReplicaWithRetries(tablet_id_, &new_leader));
+  ASSERT_NE(leader->uuid(), new_leader->uuid());
+  ASSERT_OK(itest::GetConsensusState(new_leader, tablet_id_, consensus::CONSENSUS_CONFIG_ACTIVE,
+                                     kTimeout, &cstate));
+  ASSERT_GT(cstate.current_term(), old_term);
+
+  ASSERT_OK(cluster_->tablet_server_by_uuid(leader->uuid())->Restart());
+  ASSERT_ALL_REPLICAS_AGREE(FLAGS_client_inserts_per_thread);
+}
+
 // Single-replica leader election test.
 TEST_F(RaftConsensusITest, TestAutomaticLeaderElectionOneReplica) {
   FLAGS_num_tablet_servers = 1;
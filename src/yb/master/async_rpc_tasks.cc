@@ -569,6 +569,70 @@ bool AsyncTruncate::SendRequest(int attempt) {
   return true;
 }
 
+// ============================================================================
+//  Class AsyncBackfillIndex.
+// ============================================================================
+AsyncBackfillIndex::AsyncBackfillIndex(Master *master,
+                                       ThreadPool* callback_pool,
+                                       const scoped_refptr<TableInfo>& index_table,
+                                       const scoped_refptr<TabletInfo>& tablet,
+                                       const tserver::BackfillIndexRequestPB& req)
+    : RetryingTSRpcTask(master,
+                        callback_pool,
+                        gscoped_ptr<TSPicker>(new PickLeaderReplica(tablet)),
+                        index_table),
+      tablet_(tablet),
+      req_(req) {
+}
+
+string AsyncBackfillIndex::description() const {
+  return tablet_->ToString() + " Backfill Index " + req_.index_table_id() + " RPC";
+}
+
+TabletId AsyncBackfillIndex::tablet_id() const {
+  return tablet_->tablet_id();
+}
+
+TabletServerId AsyncBackfillIndex::permanent_uuid() const {
+  return target_ts_desc_ != nullptr ? target_ts_desc_->permanent_uuid() : "";
+}
+
+void AsyncBackfillIndex::HandleResponse(int attempt) {
+  server::UpdateClock(resp_, master_->clock());
+
+  if (resp_.has_error()) {
+    const Status s = StatusFromPB(resp_.error().status());
+    const TabletServerErrorPB::Code code = resp_.error().code();
+    LOG(WARNING) << "TS " << permanent_uuid() << ": backfill of index " << req_.index_table_id()
+                 << " failed for tablet " << tablet_id() << " with error code "
+                 << TabletServerErrorPB::Code_Name(code) << ": " << s.ToString();
+    return;
+  }
+
+  VLOG(1) << "TS " << permanent_uuid() << ": backfilled " << resp_.num_rows() << " rows of tablet "
+          << tablet_id() << " into index " << req_.index_table_id();
+  const Status s = master_->catalog_manager()->HandleIndexBackfillResponse(
+      table_, tablet_id(), resp_);
+  if (!s.ok()) {
+    // The batch is sent again by the next backfill round.
+    LOG(WARNING) << "Failed to record the backfill progress of tablet " << tablet_id()
+                 << " of index " << req_.index_table_id() << ": " << s.ToString();
+    PerformStateTransition(kStateRunning, kStateFailed);
+    return;
+  }
+  PerformStateTransition(kStateRunning, kStateComplete);
+}
+
+bool AsyncBackfillIndex::SendRequest(int attempt) {
+  req_.set_dest_uuid(permanent_uuid());
+  req_.set_propagated_hybrid_time(master_->clock()->Now().ToUint64());
+  ts_admin_proxy_->BackfillIndexAsync(req_, &resp_, &rpc_, BindRpcCallback());
+  VLOG(1) << "Send backfill index request to " << permanent_uuid()
+          << " (attempt " << attempt << "):\n"
+          << req_.DebugString();
+  return true;
+}
+
 // ============================================================================
 //  Class CommonInfoForRaftTask.
 // ============================================================================
@@ -702,6 +766,10 @@ bool AsyncAddServerTask::PrepareRequest(int attempt) {
     return false;
   }
   *peer->mutable_last_known_addr() = peer_reg.common().rpc_addresses(0);
+  if (peer_reg.common().has_cloud_info()) {
+    // Lets the leader remote bootstrap the new peer from a replica in the same zone.
+    *peer->mutable_cloud_info() = peer_reg.common().cloud_info();
+  }
 
   return true;
 }
@@ -350,6 +350,35 @@ class AsyncTruncate : public RetryingTSRpcTask {
   tserver::TruncateResponsePB resp_;
 };
 
+// Sends a batch of rows of a tablet of the indexed table to be backfilled into the index, to the
+// leader of the tablet. The task is registered with the index table.
+class AsyncBackfillIndex : public RetryingTSRpcTask {
+ public:
+  AsyncBackfillIndex(Master* master,
+                     ThreadPool* callback_pool,
+                     const scoped_refptr<TableInfo>& index_table,
+                     const scoped_refptr<TabletInfo>& tablet,
+                     const tserver::BackfillIndexRequestPB& req);
+
+  Type type() const override { return ASYNC_BACKFILL_INDEX; }
+
+  std::string type_name() const override { return "Backfill Index"; }
+
+  std::string description() const override;
+
+ protected:
+  TabletId tablet_id() const override;
+
+  TabletServerId permanent_uuid() const;
+
+  void HandleResponse(int attempt) override;
+  bool SendRequest(int attempt) override;
+
+  scoped_refptr<TabletInfo> tablet_;
+  tserver::BackfillIndexRequestPB req_;
+  tserver::BackfillIndexResponsePB resp_;
+};
+
 class CommonInfoForRaftTask : public RetryingTSRpcTask {
  public:
   CommonInfoForRaftTask(
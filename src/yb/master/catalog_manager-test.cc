@@ -129,5 +129,27 @@ TEST(TestLoadBalancerCommunity, TestLoadBalancerAlgorithm) {
   lb->TestAlgorithm();
 }
 
+TEST(TestLoadBalancerCommunity, TestRemoteBootstrapLoad) {
+  RemoteBootstrapLoad load;
+  load.max_per_ts = 2;
+  ASSERT_TRUE(load.CanStart("ts1", "ts2"));
+
+  load.Start("ts1", "ts2");
+  load.Start("ts1", "ts3");
+  ASSERT_EQ(2, load.total);
+  // ts1 already starts two replicas.
+  ASSERT_FALSE(load.CanStart("ts1", "ts4"));
+  ASSERT_TRUE(load.CanStart("ts4", "ts2"));
+
+  load.Start("ts4", "ts2");
+  // ts2 already serves two remote bootstraps.
+  ASSERT_FALSE(load.CanStart("ts5", "ts2"));
+  // Replicas without a known leader are bounded only by the destination.
+  ASSERT_TRUE(load.CanStart("ts5", ""));
+
+  load.max_per_ts = 0;
+  ASSERT_TRUE(load.CanStart("ts1", "ts2"));
+}
+
 } // namespace master
 } // namespace yb
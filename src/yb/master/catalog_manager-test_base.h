@@ -132,12 +132,18 @@ class TestLoadBalancerBase {
     PrepareTestState(ts_descs);
     TestBalancingLeaders();
 
+    PrepareTestState(ts_descs);
+    TestBalancingLeadersByOps();
+
     gflags::SetCommandLineOption("leader_balance_threshold", "2");
     PrepareTestState(ts_descs);
     TestBalancingLeadersWithThreshold();
 
     PrepareTestState(ts_descs);
     TestLeaderOverReplication();
+
+    PrepareTestState(ts_descs);
+    TestBalancingLeadersWithAffinitizedZones();
   }
 
  protected:
@@ -628,6 +634,72 @@ class TestLoadBalancerBase {
     ASSERT_FALSE(HandleLeaderMoves(&placeholder, &placeholder, &placeholder));
   }
 
+  void TestBalancingLeadersWithAffinitizedZones() {
+    LOG(INFO) << "Testing moving leaders into affinitized zones";
+    // Only zones a and b may host leaders.
+    for (const string& zone : {"a", "b"}) {
+      CloudInfoPB cloud_info;
+      cloud_info.set_placement_cloud("aws");
+      cloud_info.set_placement_region("us-west-1");
+      cloud_info.set_placement_zone(zone);
+      affinitized_zones_.insert(cloud_info);
+    }
+    LOG(INFO) << "Leader distribution: 2 1 1. Affinitized zones: a, b";
+
+    AnalyzeTablets();
+
+    // The leader on ts2 should be moved to ts1, which has fewer leaders than ts0.
+    string placeholder;
+    string expected_from_ts = ts_descs_[2]->permanent_uuid();
+    string expected_to_ts = ts_descs_[1]->permanent_uuid();
+    TestMoveLeader(&placeholder, expected_from_ts, expected_to_ts);
+    ASSERT_FALSE(HandleLeaderMoves(&placeholder, &placeholder, &placeholder));
+
+    // Move all leaders to ts0.
+    for (const auto tablet : tablets_) {
+      MoveTabletLeader(tablet.get(), ts_descs_[0]);
+    }
+    LOG(INFO) << "Leader distribution: 4 0 0. Affinitized zones: a, b";
+
+    ResetState();
+    AnalyzeTablets();
+
+    // The leaders should only be balanced between ts0 and ts1.
+    expected_from_ts = ts_descs_[0]->permanent_uuid();
+    expected_to_ts = ts_descs_[1]->permanent_uuid();
+    TestMoveLeader(&placeholder, expected_from_ts, expected_to_ts);
+    TestMoveLeader(&placeholder, expected_from_ts, expected_to_ts);
+    ASSERT_FALSE(HandleLeaderMoves(&placeholder, &placeholder, &placeholder));
+  }
+
+  void TestBalancingLeadersByOps() {
+    LOG(INFO) << "Testing moving leaders serving most operations";
+    // Leader distribution: 2 1 1, but leaders on ts0 serve most operations.
+    ts_descs_[0]->set_tablet_ops_per_sec(
+        {{tablets_[0]->tablet_id(), 1000}, {tablets_[3]->tablet_id(), 1000}});
+    ts_descs_[1]->set_tablet_ops_per_sec({{tablets_[1]->tablet_id(), 10}});
+    ts_descs_[2]->set_tablet_ops_per_sec({{tablets_[2]->tablet_id(), 10}});
+
+    AnalyzeTablets();
+
+    // One of the hot leaders is moved off ts0.
+    string placeholder, tablet_id, hot_ts, cold_ts;
+    TestMoveLeader(&tablet_id, ts_descs_[0]->permanent_uuid(), "");
+    ASSERT_TRUE(tablet_id == tablets_[0]->tablet_id() || tablet_id == tablets_[3]->tablet_id());
+
+    // The cold leader of the tablet server that got the hot leader goes to the other cold one.
+    ASSERT_TRUE(HandleLeaderMoves(&tablet_id, &hot_ts, &cold_ts));
+    ASSERT_NE(ts_descs_[0]->permanent_uuid(), hot_ts);
+    ASSERT_NE(ts_descs_[0]->permanent_uuid(), cold_ts);
+
+    // Each of ts0 and the tablet server that got the hot leader serves one hot leader.
+    ASSERT_FALSE(HandleLeaderMoves(&placeholder, &placeholder, &placeholder));
+
+    for (const auto& ts_desc : ts_descs_) {
+      ts_desc->set_tablet_ops_per_sec({});
+    }
+  }
+
   void TestBalancingLeadersWithThreshold() {
     LOG(INFO) << "Testing moving overloaded leaders with threshold = 2";
     // Move all leaders to ts0.
@@ -158,6 +158,14 @@ DEFINE_int32(master_failover_catchup_timeout_ms, 30 * 1000,  // 30 sec
 TAG_FLAG(master_failover_catchup_timeout_ms, advanced);
 TAG_FLAG(master_failover_catchup_timeout_ms, experimental);
 
+DEFINE_int32(master_follower_catalog_refresh_interval_ms, 10 * 1000,
+             "Minimum amount of time between two reloads of the in-memory catalog of a master "
+             "follower after the sys catalog changed. A follower whose catalog is up to date when "
+             "it is elected leader serves requests without loading the catalog again. 0 to only "
+             "load the catalog when elected leader.");
+TAG_FLAG(master_follower_catalog_refresh_interval_ms, advanced);
+TAG_FLAG(master_follower_catalog_refresh_interval_ms, runtime);
+
 DEFINE_bool(master_tombstone_evicted_tablet_replicas, true,
             "Whether the Master should tombstone (delete) tablet replicas that "
             "are no longer part of the latest reported raft config.");
@@ -169,6 +177,30 @@ DEFINE_bool(catalog_manager_check_ts_count_for_create_table, true,
             "a table to be created.");
 TAG_FLAG(catalog_manager_check_ts_count_for_create_table, hidden);
 
+DEFINE_bool(master_cache_tablet_locations, true,
+            "Whether the master caches locations of tablets returned by GetTableLocations and "
+            "GetTabletLocations, until tablet replicas or tablet server registrations change.");
+TAG_FLAG(master_cache_tablet_locations, advanced);
+
+DEFINE_int32(index_backfill_batch_size, 1000,
+             "Number of rows of a tablet of the indexed table backfilled into a new index per "
+             "batch.");
+TAG_FLAG(index_backfill_batch_size, advanced);
+TAG_FLAG(index_backfill_batch_size, runtime);
+
+DEFINE_int32(index_backfill_max_tablets_per_round, 4,
+             "Maximum number of tablets of the indexed table that a new index is backfilled from "
+             "at the same time. Together with --index_backfill_batch_size, this limits the load "
+             "that the backfill puts on the cluster.");
+TAG_FLAG(index_backfill_max_tablets_per_round, advanced);
+TAG_FLAG(index_backfill_max_tablets_per_round, runtime);
+
+DEFINE_int32(index_backfill_read_delay_ms, 30000,
+             "Delay after the creation of an index of the time the indexed table is read at to "
+             "backfill the index. Writes after that time must be maintained in the index by the "
+             "proxies, so this should cover the time for them to learn about the new index.");
+TAG_FLAG(index_backfill_read_delay_ms, advanced);
+
 METRIC_DEFINE_gauge_uint32(cluster, num_tablet_servers_live,
                            "Number of live tservers in the cluster", yb::MetricUnit::kUnits,
                            "The number of tablet servers that have responded or done a heartbeat "
@@ -271,8 +303,8 @@ class TableLoader : public Visitor<PersistentTableInfo> {
       catalog_manager_->table_names_map_[{l->data().namespace_id(), l->data().name()}] = table;
     }
 
-    LOG(INFO) << "Loaded metadata for table " << table->ToString();
-    VLOG(1) << "Metadata for table " << table->ToString() << ": " << metadata.ShortDebugString();
+    VLOG(1) << "Loaded metadata for table " << table->ToString() << ": "
+            << metadata.ShortDebugString();
     l->Commit();
     return Status::OK();
   }
@@ -334,10 +366,8 @@ class TabletLoader : public Visitor<PersistentTabletInfo> {
     // TODO(KUDU-1070): if we see a running tablet under a deleted table,
     // we should "roll forward" the deletion of the tablet here.
 
-    auto table_lock = table->LockForRead();
-    LOG(INFO) << "Loaded metadata for tablet " << tablet_id
-              << " (table " << table->ToString() << ")";
-    VLOG(2) << "Metadata for tablet " << tablet_id << ": " << metadata.ShortDebugString();
+    VLOG(1) << "Loaded metadata for tablet " << tablet_id << " (table " << table->ToString()
+            << "): " << metadata.ShortDebugString();
 
     return Status::OK();
   }
@@ -599,6 +629,11 @@ void CatalogManagerBgTasks::Run() {
       } else {
         catalog_manager_->load_balance_policy_->RunLoadBalancer();
       }
+
+      // Send the next batches of the index backfills.
+      catalog_manager_->ProcessIndexBackfills();
+    } else {
+      catalog_manager_->MaybeRefreshFollowerCatalog();
     }
 
     // if (!to_delete.empty()) {
@@ -775,8 +810,22 @@ Status CatalogManager::VisitSysCatalog() {
   AppendValuesFromMap(table_ids_map_, &tables);
   AbortAndWaitForAllTasks(tables);
 
-  // Clear internal maps and run data loaders.
-  RETURN_NOT_OK(RunLoaders());
+  // The catalog loaded while we were a follower is current if nothing was written to the sys
+  // catalog since. As the leader we are about to change it, so it is not reused after that.
+  const int64_t loaded_write_index = follower_catalog_write_index_.exchange(-1);
+  const int64_t applied_write_index = tablet_peer()->tablet()->last_applied_write_index();
+  if (loaded_write_index >= 0 && loaded_write_index == applied_write_index) {
+    LOG(INFO) << __func__ << ": Catalog loaded as a follower is up to date at write index "
+              << loaded_write_index << ", not loading it again.";
+    std::vector<std::shared_ptr<TSDescriptor>> descs;
+    master_->ts_manager()->GetAllDescriptors(&descs);
+    for (const auto& ts_desc : descs) {
+      ts_desc->set_has_tablet_report(false);
+    }
+  } else {
+    // Clear internal maps and run data loaders.
+    RETURN_NOT_OK(RunLoaders());
+  }
 
   // Create the system namespaces (created only if they don't already exist).
   RETURN_NOT_OK(PrepareDefaultNamespaces());
@@ -794,11 +843,69 @@ Status CatalogManager::VisitSysCatalog() {
   return Status::OK();
 }
 
+void CatalogManager::MaybeRefreshFollowerCatalog() {
+  const int interval_ms = FLAGS_master_follower_catalog_refresh_interval_ms;
+  if (interval_ms <= 0 || master_->IsShellMode() ||
+      tablet_peer()->consensus()->role() == RaftPeerPB::LEADER) {
+    return;
+  }
+  const auto tablet = tablet_peer()->shared_tablet();
+  if (!tablet || tablet->last_applied_write_index() == follower_catalog_write_index_.load()) {
+    return;
+  }
+  const MonoTime now = MonoTime::Now();
+  {
+    std::lock_guard<simple_spinlock> l(state_lock_);
+    if (follower_catalog_refresh_pending_ ||
+        (follower_catalog_refreshed_at_.Initialized() &&
+         now < follower_catalog_refreshed_at_ + MonoDelta::FromMilliseconds(interval_ms))) {
+      return;
+    }
+    follower_catalog_refresh_pending_ = true;
+  }
+  // Queued behind the leader initialization, if any, so both never run at the same time.
+  Status s = worker_pool_->SubmitFunc(std::bind(&CatalogManager::RefreshFollowerCatalogTask, this));
+  if (!s.ok()) {
+    WARN_NOT_OK(s, "Failed to schedule the refresh of the follower catalog");
+    std::lock_guard<simple_spinlock> l(state_lock_);
+    follower_catalog_refresh_pending_ = false;
+  }
+}
+
+void CatalogManager::RefreshFollowerCatalogTask() {
+  // If we got elected meanwhile, the leader initialization loads the catalog.
+  if (tablet_peer()->consensus()->role() != RaftPeerPB::LEADER) {
+    LOG_SLOW_EXECUTION(INFO, 1000, LogPrefix() + "Loading metadata into memory as a follower") {
+      std::lock_guard<RWMutex> leader_lock_guard(leader_lock_);
+      boost::lock_guard<LockType> lock(lock_);
+
+      // Read before the catalog, so that the writes applied while it is read are loaded again by
+      // the next refresh or the leader initialization, see VisitSysCatalog().
+      const int64_t write_index = tablet_peer()->tablet()->last_applied_write_index();
+      std::vector<scoped_refptr<TableInfo>> tables;
+      AppendValuesFromMap(table_ids_map_, &tables);
+      AbortAndWaitForAllTasks(tables);
+      follower_catalog_write_index_ = -1;
+      Status s = RunLoaders();
+      if (s.ok()) {
+        follower_catalog_write_index_ = write_index;
+      } else {
+        LOG(WARNING) << LogPrefix() << "Failed to load the sys catalog as a follower: " << s;
+      }
+    }
+  }
+
+  std::lock_guard<simple_spinlock> l(state_lock_);
+  follower_catalog_refresh_pending_ = false;
+  follower_catalog_refreshed_at_ = MonoTime::Now();
+}
+
 Status CatalogManager::RunLoaders() {
   // Clear the table and tablet state.
   table_names_map_.clear();
   table_ids_map_.clear();
   tablet_map_.clear();
+  PublishIdMapsSnapshotUnlocked();
 
   // Clear the namespace mappings.
   namespace_ids_map_.clear();
@@ -830,6 +937,9 @@ Status CatalogManager::RunLoaders() {
   unique_ptr<TabletLoader> tablet_loader(new TabletLoader(this));
   RETURN_NOT_OK_PREPEND(
       sys_catalog_->Visit(tablet_loader.get()), "Failed while visiting tablets in sys catalog");
+  PublishIdMapsSnapshotUnlocked();
+  LOG(INFO) << __func__ << ": Loaded " << table_ids_map_.size() << " tables and "
+            << tablet_map_.size() << " tablets.";
 
   LOG(INFO) << __func__ << ": Loading namespaces into memory.";
   unique_ptr<NamespaceLoader> namespace_loader(new NamespaceLoader(this));
@@ -1270,6 +1380,7 @@ Status CatalogManager::AbortTableCreation(TableInfo* table,
       << "Unable to erase table named " << table_name << " from table names map.";
   CHECK_EQ(table_ids_map_.erase(table_id), 1)
       << "Unable to erase tablet with id " << table_id << " from tablet ids map.";
+  PublishIdMapsSnapshotUnlocked();
 
   return CheckIfNoLongerLeaderAndSetupError(s, resp);
 }
@@ -1320,9 +1431,10 @@ Status CatalogManager::AddIndexInfoToTable(const TableId& indexed_table_id,
   Schema indexed_schema;
   RETURN_NOT_OK(indexed_table->GetSchema(&indexed_schema));
 
-  // Populate index info.
+  // Populate index info. The index is not readable until it is backfilled.
   IndexInfoPB index_info;
   index_info.set_table_id(index_table_id);
+  index_info.set_is_readable(false);
   for (size_t i = 0; i < index_schema.num_hash_key_columns(); i++) {
     RETURN_NOT_OK(AddIndexedColumn(index_schema, i, indexed_schema,
                                    index_info.mutable_hash_column_ids()));
@@ -1353,6 +1465,142 @@ Status CatalogManager::AddIndexInfoToTable(const TableId& indexed_table_id,
   return Status::OK();
 }
 
+void CatalogManager::ProcessIndexBackfills() {
+  std::vector<scoped_refptr<TableInfo>> index_tables;
+  {
+    boost::shared_lock<LockType> l(lock_);
+    for (const TableInfoMap::value_type& entry : table_ids_map_) {
+      auto ltm = entry.second->LockForRead();
+      if (ltm->data().is_running() && ltm->data().pb.has_backfill()) {
+        index_tables.push_back(entry.second);
+      }
+    }
+  }
+
+  const HybridTime now = master_->clock()->Now();
+  for (const scoped_refptr<TableInfo>& index_table : index_tables) {
+    // Wait for the index tablets to be created, and for the batches of the previous round.
+    if (index_table->IsCreateInProgress() ||
+        index_table->HasTasks(MonitoredTask::ASYNC_BACKFILL_INDEX)) {
+      continue;
+    }
+    scoped_refptr<TableInfo> indexed_table = GetTableInfo(index_table->indexed_table_id());
+    if (indexed_table == nullptr) {
+      continue;
+    }
+    std::vector<scoped_refptr<TabletInfo>> tablets;
+    indexed_table->GetAllTablets(&tablets);
+
+    IndexBackfillPB backfill;
+    {
+      auto l = index_table->LockForWrite();
+      IndexBackfillPB* backfill_pb = l->mutable_data()->pb.mutable_backfill();
+      if (now < HybridTime(backfill_pb->read_hybrid_time())) {
+        continue;
+      }
+      backfill = *backfill_pb;
+      if (backfill_pb->tablets_size() == 0) {
+        // Start the backfill of each tablet from its beginning.
+        for (const scoped_refptr<TabletInfo>& tablet : tablets) {
+          backfill_pb->add_tablets()->set_tablet_id(tablet->tablet_id());
+        }
+        const Status s = sys_catalog_->UpdateItem(index_table.get());
+        if (!s.ok()) {
+          LOG(WARNING) << "Failed to start the backfill of index " << index_table->ToString()
+                       << ": " << s.ToString();
+          continue;
+        }
+        backfill = *backfill_pb;
+        l->Commit();
+      }
+    }
+
+    std::unordered_map<TabletId, scoped_refptr<TabletInfo>> tablet_map;
+    for (const scoped_refptr<TabletInfo>& tablet : tablets) {
+      tablet_map.emplace(tablet->tablet_id(), tablet);
+    }
+    int num_tablets = 0;
+    bool done = true;
+    for (const IndexBackfillPB::TabletProgressPB& progress : backfill.tablets()) {
+      if (progress.done()) {
+        continue;
+      }
+      done = false;
+      const auto itr = tablet_map.find(progress.tablet_id());
+      if (itr == tablet_map.end() || num_tablets >= FLAGS_index_backfill_max_tablets_per_round) {
+        continue;
+      }
+      tserver::BackfillIndexRequestPB req;
+      req.set_tablet_id(progress.tablet_id());
+      req.set_index_table_id(index_table->id());
+      req.set_read_hybrid_time(backfill.read_hybrid_time());
+      req.set_next_partition_key(progress.next_partition_key());
+      req.set_next_row_key(progress.next_row_key());
+      req.set_max_rows(FLAGS_index_backfill_batch_size);
+      auto call = std::make_shared<AsyncBackfillIndex>(
+          master_, worker_pool_.get(), index_table, itr->second, req);
+      index_table->AddTask(call);
+      WARN_NOT_OK(call->Run(), Substitute("Failed to send backfill request for tablet $0",
+                                          progress.tablet_id()));
+      num_tablets++;
+    }
+    if (done) {
+      WARN_NOT_OK(FinishIndexBackfill(index_table),
+                  "Failed to finish the backfill of index " + index_table->ToString());
+    }
+  }
+}
+
+Status CatalogManager::HandleIndexBackfillResponse(const scoped_refptr<TableInfo>& index_table,
+                                                   const TabletId& tablet_id,
+                                                   const tserver::BackfillIndexResponsePB& resp) {
+  bool done = true;
+  {
+    auto l = index_table->LockForWrite();
+    if (!l->data().is_running() || !l->data().pb.has_backfill()) {
+      return Status::OK();
+    }
+    for (auto& progress : *l->mutable_data()->pb.mutable_backfill()->mutable_tablets()) {
+      if (progress.tablet_id() == tablet_id) {
+        progress.set_next_partition_key(resp.next_partition_key());
+        progress.set_next_row_key(resp.next_row_key());
+        progress.set_done(resp.done());
+      }
+      done = done && progress.done();
+    }
+
+    TRACE("Updating index backfill progress on disk");
+    RETURN_NOT_OK(sys_catalog_->UpdateItem(index_table.get()));
+    l->Commit();
+  }
+
+  return done ? FinishIndexBackfill(index_table) : Status::OK();
+}
+
+Status CatalogManager::FinishIndexBackfill(const scoped_refptr<TableInfo>& index_table) {
+  // The index is marked readable first, so that the backfill is finished again if the master fails
+  // in between.
+  scoped_refptr<TableInfo> indexed_table = GetTableInfo(index_table->indexed_table_id());
+  if (indexed_table != nullptr) {
+    auto l = indexed_table->LockForWrite();
+    for (IndexInfoPB& index_info : *l->mutable_data()->pb.mutable_indexes()) {
+      if (index_info.table_id() == index_table->id()) {
+        index_info.set_is_readable(true);
+      }
+    }
+    RETURN_NOT_OK(sys_catalog_->UpdateItem(indexed_table.get()));
+    l->Commit();
+  }
+
+  auto l = index_table->LockForWrite();
+  l->mutable_data()->pb.clear_backfill();
+  RETURN_NOT_OK(sys_catalog_->UpdateItem(index_table.get()));
+  l->Commit();
+
+  LOG(INFO) << "Finished the backfill of index " << index_table->ToString();
+  return Status::OK();
+}
+
 // Create a new table.
 // See README file in this directory for a description of the design.
 Status CatalogManager::CreateTable(const CreateTableRequestPB* orig_req,
@@ -1556,6 +1804,13 @@ Status CatalogManager::CreateTable(const CreateTableRequestPB* orig_req,
 
   // Update the on-disk table state to "running".
   table->mutable_metadata()->mutable_dirty()->pb.set_state(SysTablesEntryPB::RUNNING);
+  if (req.has_indexed_table_id()) {
+    // The index is backfilled with the rows of the indexed table as of a time by which the proxies
+    // maintain the index on writes.
+    table->mutable_metadata()->mutable_dirty()->pb.mutable_backfill()->set_read_hybrid_time(
+        master_->clock()->Now().AddMicroseconds(
+            FLAGS_index_backfill_read_delay_ms * 1000LL).ToUint64());
+  }
   s = sys_catalog_->AddItem(table.get());
   if (PREDICT_FALSE(!s.ok())) {
     return AbortTableCreation(table.get(), tablets,
@@ -1607,6 +1862,7 @@ Status CatalogManager::CreateTabletsFromTable(const vector<Partition>& partition
   for (TabletInfo* tablet : *tablets) {
     InsertOrDie(&tablet_map_, tablet->tablet_id(), tablet);
   }
+  PublishIdMapsSnapshotUnlocked();
   return Status::OK();
 }
 
@@ -1707,11 +1963,10 @@ TabletInfo* CatalogManager::CreateTabletInfo(TableInfo* table,
 
 Status CatalogManager::FindTable(const TableIdentifierPB& table_identifier,
                                  scoped_refptr<TableInfo> *table_info) {
-  boost::shared_lock<LockType> l(lock_);
-
   if (table_identifier.has_table_id()) {
-    *table_info = FindPtrOrNull(table_ids_map_, table_identifier.table_id());
+    *table_info = FindPtrOrNull(GetIdMapsSnapshot()->table_ids_map, table_identifier.table_id());
   } else if (table_identifier.has_table_name()) {
+    boost::shared_lock<LockType> l(lock_);
     NamespaceId namespace_id;
 
     if (table_identifier.has_namespace_()) {
@@ -2062,10 +2317,24 @@ void CatalogManager::MarkTableDeletedIfNoTablets(scoped_refptr<DeletedTableInfo>
   }
 }
 
+void CatalogManager::PublishIdMapsSnapshotUnlocked() {
+  auto snapshot = std::make_shared<IdMapsSnapshot>();
+  snapshot->table_ids_map = table_ids_map_;
+  snapshot->tablet_map = tablet_map_;
+  std::lock_guard<simple_spinlock> l(id_maps_snapshot_lock_);
+  id_maps_snapshot_ = std::move(snapshot);
+}
+
+std::shared_ptr<const CatalogManager::IdMapsSnapshot> CatalogManager::GetIdMapsSnapshot() const {
+  std::lock_guard<simple_spinlock> l(id_maps_snapshot_lock_);
+  return id_maps_snapshot_;
+}
+
 void CatalogManager::CleanUpDeletedTables() {
   std::lock_guard<LockType> l_map(lock_);
   // Garbage collecting.
   // Going through all tables under the global lock.
+  bool erased = false;
   for (TableInfoMap::iterator it = table_ids_map_.begin(); it != table_ids_map_.end();) {
     scoped_refptr<TableInfo> table(it->second);
 
@@ -2076,6 +2345,7 @@ void CatalogManager::CleanUpDeletedTables() {
       if (l->data().is_deleted()) {
         LOG(INFO) << "Removing from by-ids map table " << table->ToString();
         it = table_ids_map_.erase(it);
+        erased = true;
         // TODO: Check if we want to delete the totally deleted table from the sys_catalog here.
         continue;
       }
@@ -2083,6 +2353,9 @@ void CatalogManager::CleanUpDeletedTables() {
 
     ++it;
   }
+  if (erased) {
+    PublishIdMapsSnapshotUnlocked();
+  }
 }
 
 Status CatalogManager::IsDeleteTableDone(const IsDeleteTableDoneRequestPB* req,
@@ -2498,8 +2771,7 @@ Status CatalogManager::ListTables(const ListTablesRequestPB* req,
 }
 
 scoped_refptr<TableInfo> CatalogManager::GetTableInfo(const TableId& table_id) {
-  boost::shared_lock<LockType> l(lock_);
-  return FindPtrOrNull(table_ids_map_, table_id);
+  return FindPtrOrNull(GetIdMapsSnapshot()->table_ids_map, table_id);
 }
 scoped_refptr<TableInfo> CatalogManager::GetTableInfoFromNamespaceNameAndTableName(
     const NamespaceName& namespace_name, const TableName& table_name) {
@@ -2619,14 +2891,39 @@ Status CatalogManager::ProcessTabletReport(TSDescriptor* ts_desc,
     return Status::OK();
   }
 
+  // Incremental report only contains tablets changed since the previous one, so we could miss
+  // changes if reports were reordered.
+  if (!ts_desc->UpdateTabletReportSequenceNumber(
+          report.is_incremental(), report.sequence_number())) {
+    LOG(WARNING) << "Received an out of order incremental tablet report "
+                 << report.sequence_number() << " from " << ts_desc->permanent_uuid()
+                 << ", requesting full report";
+    ts_desc->set_has_tablet_report(false);
+    return Status::OK();
+  }
+
   // TODO: on a full tablet report, we may want to iterate over the tablets we think
   // the server should have, compare vs the ones being reported, and somehow mark
   // any that have been "lost" (eg somehow the tablet metadata got corrupted or something).
 
-  for (const ReportedTabletPB& reported : report.updated_tablets()) {
+  RETURN_NOT_OK_PREPEND(CheckIsLeaderAndReady(),
+      "This master is no longer the leader, unable to handle tablet report");
+
+  // Look up all reported tablets in the same snapshot of the tablet map.
+  std::vector<scoped_refptr<TabletInfo>> tablets;
+  tablets.reserve(report.updated_tablets_size());
+  {
+    auto id_maps = GetIdMapsSnapshot();
+    for (const ReportedTabletPB& reported : report.updated_tablets()) {
+      tablets.push_back(FindPtrOrNull(id_maps->tablet_map, reported.tablet_id()));
+    }
+  }
+
+  for (int i = 0; i != report.updated_tablets_size(); ++i) {
+    const ReportedTabletPB& reported = report.updated_tablets(i);
     ReportedTabletUpdatesPB *tablet_report = report_update->add_tablets();
     tablet_report->set_tablet_id(reported.tablet_id());
-    RETURN_NOT_OK_PREPEND(HandleReportedTablet(ts_desc, reported, tablet_report),
+    RETURN_NOT_OK_PREPEND(HandleReportedTablet(ts_desc, tablets[i], reported, tablet_report),
                           Substitute("Error handling $0", reported.ShortDebugString()));
   }
 
@@ -2669,18 +2966,11 @@ bool ShouldTransitionTabletToRunning(const ReportedTabletPB& report) {
 }  // anonymous namespace
 
 Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
+                                            const scoped_refptr<TabletInfo>& tablet,
                                             const ReportedTabletPB& report,
                                             ReportedTabletUpdatesPB *report_updates) {
   TRACE_EVENT1("master", "HandleReportedTablet",
                "tablet_id", report.tablet_id());
-  scoped_refptr<TabletInfo> tablet;
-  {
-    boost::shared_lock<LockType> l(lock_);
-    tablet = FindPtrOrNull(tablet_map_, report.tablet_id());
-  }
-  RETURN_NOT_OK_PREPEND(CheckIsLeaderAndReady(),
-      Substitute("This master is no longer the leader, unable to handle report for tablet $0",
-                 report.tablet_id()));
   if (!tablet) {
     LOG(INFO) << "Got report from unknown tablet " << report.tablet_id()
               << ": Sending delete request for this orphan tablet";
@@ -2882,15 +3172,18 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
   }
 
   table_lock->Unlock();
-  // We update the tablets each time that someone reports it.
-  // This shouldn't be very frequent and should only happen when something in fact changed.
-  Status s = sys_catalog_->UpdateItem(tablet.get());
-  if (!s.ok()) {
-    LOG(WARNING) << "Error updating tablets: " << s.ToString() << ". Tablet report was: "
-                 << report.ShortDebugString();
-    return s;
+  // Most of the reported tablets are unchanged, e.g. in full tablet reports, so we update the sys
+  // catalog only when the report in fact changed the persistent tablet state.
+  if (tablet_lock->data().pb.SerializeAsString() !=
+          tablet->metadata().state().pb.SerializeAsString()) {
+    Status s = sys_catalog_->UpdateItem(tablet.get());
+    if (!s.ok()) {
+      LOG(WARNING) << "Error updating tablets: " << s.ToString() << ". Tablet report was: "
+                   << report.ShortDebugString();
+      return s;
+    }
+    tablet_lock->Commit();
   }
-  tablet_lock->Commit();
 
   // Need to defer the AlterTable command to after we've committed the new tablet data,
   // since the tablet report may also be updating the raft config, and the Alter Table
@@ -3819,6 +4112,7 @@ void CatalogManager::HandleAssignCreatingTablet(TabletInfo* tablet,
   {
     std::lock_guard<LockType> l_maps(lock_);
     tablet_map_[replacement->tablet_id()] = replacement;
+    PublishIdMapsSnapshotUnlocked();
   }
 
   // Mark old tablet as replaced.
@@ -4009,6 +4303,7 @@ Status CatalogManager::ProcessPendingAssignments(
       CHECK_EQ(tablet_map_.erase(tablet_id_to_remove), 1)
           << "Unable to erase " << tablet_id_to_remove << " from tablet map.";
     }
+    PublishIdMapsSnapshotUnlocked();
     return s;
   }
 
@@ -4264,6 +4559,9 @@ void CatalogManager::SelectReplicas(
     for (const HostPortPB& addr : reg.common().rpc_addresses()) {
       peer->mutable_last_known_addr()->CopyFrom(addr);
     }
+    if (reg.common().has_cloud_info()) {
+      peer->mutable_cloud_info()->CopyFrom(reg.common().cloud_info());
+    }
   }
 }
 
@@ -4299,6 +4597,10 @@ Status CatalogManager::BuildLocationsForTablet(const scoped_refptr<TabletInfo>&
 
   TSRegistrationPB reg;
 
+  // Read before tablet server registrations are used, so locations built from a registration that
+  // is being changed will not be used from the cache.
+  const uint64_t registrations_version = TSDescriptor::registrations_version();
+  uint64_t replica_locations_version = 0;
   TabletInfo::ReplicaMap locs;
   consensus::ConsensusStatePB cstate;
   {
@@ -4311,7 +4613,15 @@ Status CatalogManager::BuildLocationsForTablet(const scoped_refptr<TabletInfo>&
       return STATUS(ServiceUnavailable, "Tablet not running");
     }
 
-    tablet->GetReplicaLocations(&locs);
+    if (FLAGS_master_cache_tablet_locations) {
+      auto cached = tablet->GetCachedLocations(registrations_version);
+      if (cached) {
+        locs_pb->CopyFrom(*cached);
+        return Status::OK();
+      }
+    }
+
+    tablet->GetReplicaLocations(&locs, &replica_locations_version);
     if (locs.empty() && l_tablet->data().pb.has_committed_consensus_state()) {
       cstate = l_tablet->data().pb.committed_consensus_state();
     }
@@ -4342,6 +4652,10 @@ Status CatalogManager::BuildLocationsForTablet(const scoped_refptr<TabletInfo>&
       replica_pb->mutable_ts_info()->mutable_cloud_info()->Swap(
           tsinfo_pb.mutable_registration()->mutable_common()->mutable_cloud_info());
     }
+    if (FLAGS_master_cache_tablet_locations) {
+      tablet->SetCachedLocations(std::make_shared<TabletLocationsPB>(*locs_pb),
+                                 replica_locations_version, registrations_version);
+    }
     return Status::OK();
   }
 
@@ -4357,12 +4671,10 @@ Status CatalogManager::BuildLocationsForTablet(const scoped_refptr<TabletInfo>&
 Status CatalogManager::RetrieveSystemTablet(const TabletId& tablet_id,
                                             std::shared_ptr<tablet::AbstractTablet>* tablet) {
   RETURN_NOT_OK(CheckOnline());
-  scoped_refptr<TabletInfo> tablet_info;
-  {
-    boost::shared_lock<LockType> l(lock_);
-    if (!FindCopy(tablet_map_, tablet_id, &tablet_info)) {
-      return STATUS(NotFound, Substitute("Unknown tablet $0", tablet_id));
-    }
+  scoped_refptr<TabletInfo> tablet_info =
+      FindPtrOrNull(GetIdMapsSnapshot()->tablet_map, tablet_id);
+  if (!tablet_info) {
+    return STATUS(NotFound, Substitute("Unknown tablet $0", tablet_id));
   }
 
   if (!tablet_info->IsSupportedSystemTable(sys_tables_handler_.supported_system_tables())) {
@@ -4379,12 +4691,10 @@ Status CatalogManager::GetTabletLocations(const TabletId& tablet_id,
   RETURN_NOT_OK(CheckOnline());
 
   locs_pb->mutable_replicas()->Clear();
-  scoped_refptr<TabletInfo> tablet_info;
-  {
-    boost::shared_lock<LockType> l(lock_);
-    if (!FindCopy(tablet_map_, tablet_id, &tablet_info)) {
-      return STATUS(NotFound, Substitute("Unknown tablet $0", tablet_id));
-    }
+  scoped_refptr<TabletInfo> tablet_info =
+      FindPtrOrNull(GetIdMapsSnapshot()->tablet_map, tablet_id);
+  if (!tablet_info) {
+    return STATUS(NotFound, Substitute("Unknown tablet $0", tablet_id));
   }
 
   Status s = BuildLocationsForTablet(tablet_info, locs_pb);
@@ -4884,6 +5194,8 @@ void TabletInfo::SetReplicaLocations(ReplicaMap replica_locations) {
   std::lock_guard<simple_spinlock> l(lock_);
   last_update_time_ = MonoTime::Now();
   replica_locations_ = std::move(replica_locations);
+  ++replica_locations_version_;
+  cached_locations_.reset();
 }
 
 void TabletInfo::GetReplicaLocations(ReplicaMap* replica_locations) const {
@@ -4891,9 +5203,41 @@ void TabletInfo::GetReplicaLocations(ReplicaMap* replica_locations) const {
   *replica_locations = replica_locations_;
 }
 
+void TabletInfo::GetReplicaLocations(ReplicaMap* replica_locations, uint64_t* version) const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  *replica_locations = replica_locations_;
+  *version = replica_locations_version_;
+}
+
 bool TabletInfo::AddToReplicaLocations(const TabletReplica& replica) {
   std::lock_guard<simple_spinlock> l(lock_);
-  return InsertIfNotPresent(&replica_locations_, replica.ts_desc->permanent_uuid(), replica);
+  if (!InsertIfNotPresent(&replica_locations_, replica.ts_desc->permanent_uuid(), replica)) {
+    return false;
+  }
+  ++replica_locations_version_;
+  cached_locations_.reset();
+  return true;
+}
+
+void TabletInfo::SetCachedLocations(std::shared_ptr<const TabletLocationsPB> locations,
+                                    uint64_t replica_locations_version,
+                                    uint64_t registrations_version) {
+  std::lock_guard<simple_spinlock> l(lock_);
+  // Replica locations could change while locations were built.
+  if (replica_locations_version != replica_locations_version_) {
+    return;
+  }
+  cached_locations_ = std::move(locations);
+  cached_locations_registrations_version_ = registrations_version;
+}
+
+std::shared_ptr<const TabletLocationsPB> TabletInfo::GetCachedLocations(
+    uint64_t registrations_version) const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  if (cached_locations_registrations_version_ != registrations_version) {
+    return nullptr;
+  }
+  return cached_locations_;
 }
 
 void TabletInfo::set_last_update_time(const MonoTime& ts) {
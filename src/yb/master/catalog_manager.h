@@ -32,6 +32,7 @@
 #ifndef YB_MASTER_CATALOG_MANAGER_H
 #define YB_MASTER_CATALOG_MANAGER_H
 
+#include <atomic>
 #include <list>
 #include <map>
 #include <set>
@@ -75,6 +76,10 @@ class ThreadPool;
 template<class T>
 class AtomicGauge;
 
+namespace tserver {
+class BackfillIndexResponsePB;
+}
+
 namespace master {
 
 class CatalogManagerBgTasks;
@@ -236,6 +241,19 @@ class TabletInfo : public RefCountedThreadSafe<TabletInfo>,
   void SetReplicaLocations(ReplicaMap replica_locations);
   void GetReplicaLocations(ReplicaMap* replica_locations) const;
 
+  // Also returns the version of the replica locations, that is changed every time they change.
+  void GetReplicaLocations(ReplicaMap* replica_locations, uint64_t* version) const;
+
+  // Locations of this tablet built from replica locations of the specified version, when tablet
+  // server registrations had the specified version. They are dropped when replica locations
+  // change, and ignored when tablet server registrations change.
+  void SetCachedLocations(std::shared_ptr<const TabletLocationsPB> locations,
+                          uint64_t replica_locations_version, uint64_t registrations_version);
+
+  // Returns null if locations were not cached or are no longer valid.
+  std::shared_ptr<const TabletLocationsPB> GetCachedLocations(
+      uint64_t registrations_version) const;
+
   // Adds the given replica to the replica_locations_ map.
   // Returns true iff the replica was inserted.
   bool AddToReplicaLocations(const TabletReplica& replica);
@@ -283,6 +301,11 @@ class TabletInfo : public RefCountedThreadSafe<TabletInfo>,
   // The locations in the latest Raft config where this tablet has been
   // reported. The map is keyed by tablet server UUID.
   ReplicaMap replica_locations_;
+  uint64_t replica_locations_version_ = 0;
+
+  // Locations built from replica_locations_, see SetCachedLocations.
+  std::shared_ptr<const TabletLocationsPB> cached_locations_;
+  uint64_t cached_locations_registrations_version_ = 0;
 
   // Reported schema version (in-memory only).
   uint32_t reported_schema_version_ = 0;
@@ -1016,6 +1039,15 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // to true (under state_lock_).
   void LoadSysCatalogDataTask();
 
+  // Called by the background tasks when this node is not the leader. Schedules a reload of the
+  // in-memory catalog from the sys catalog if it changed since the last one, at most every
+  // --master_follower_catalog_refresh_interval_ms, so that the catalog is ready right away when
+  // this node gets elected.
+  void MaybeRefreshFollowerCatalog();
+
+  // Reloads the in-memory catalog of a follower, submitted by MaybeRefreshFollowerCatalog().
+  void RefreshFollowerCatalogTask();
+
   // Generated the default entry for the cluster config, that is written into sys_catalog on very
   // first leader election of the cluster.
   //
@@ -1090,6 +1122,19 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
                                           const TableId& index_table_id,
                                           DeleteTableResponsePB* resp);
 
+  // Sends the next batches of the backfills of the indexes that are being created, at most one
+  // batch per tablet of an indexed table at a time.
+  void ProcessIndexBackfills();
+
+  // Records the progress of a backfill batch of a tablet of the indexed table.
+  CHECKED_STATUS HandleIndexBackfillResponse(const scoped_refptr<TableInfo>& index_table,
+                                             const TabletId& tablet_id,
+                                             const tserver::BackfillIndexResponsePB& resp);
+
+  // Marks the index readable in the indexed table once all its tablets are backfilled, and drops
+  // the backfill state of the index.
+  CHECKED_STATUS FinishIndexBackfill(const scoped_refptr<TableInfo>& index_table);
+
   // Builds the TabletLocationsPB for a tablet based on the provided TabletInfo.
   // Populates locs_pb and returns true on success.
   // Returns Status::ServiceUnavailable if tablet is not running.
@@ -1100,8 +1145,9 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
                            scoped_refptr<TableInfo>* table_info);
 
   // Handle one of the tablets in a tablet reported.
-  // Requires that the lock is already held.
+  // tablet is the tablet info found for the reported tablet id, or null if there is no such tablet.
   CHECKED_STATUS HandleReportedTablet(TSDescriptor* ts_desc,
+                              const scoped_refptr<TabletInfo>& tablet,
                               const ReportedTabletPB& report,
                               ReportedTabletUpdatesPB *report_updates);
 
@@ -1301,6 +1347,20 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // Delete tables from internal map by id, if it has no more active tasks and tablets.
   void CleanUpDeletedTables();
 
+  // Immutable copy of table_ids_map_ and tablet_map_. Routing lookups, i.e. GetTableLocations,
+  // GetTabletLocations and tablet reports, use it instead of taking lock_, so they are not
+  // blocked by DDL operations.
+  struct IdMapsSnapshot {
+    TableInfoMap table_ids_map;
+    TabletInfoMap tablet_map;
+  };
+
+  // Publishes a new snapshot of table_ids_map_ and tablet_map_.
+  // Should be invoked after modifying those maps, while lock_ is still held for write.
+  void PublishIdMapsSnapshotUnlocked();
+
+  std::shared_ptr<const IdMapsSnapshot> GetIdMapsSnapshot() const;
+
   // Updated table state from DELETING to DELETED, if it has no more tablets.
   void MarkTableDeletedIfNoTablets(scoped_refptr<DeletedTableInfo> deleted_table,
                                    TableInfo* table_info = nullptr);
@@ -1322,6 +1382,10 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // Tablet maps: tablet-id -> TabletInfo
   TabletInfoMap tablet_map_;
 
+  // Lock protecting id_maps_snapshot_, it is held only to copy or replace the pointer.
+  mutable simple_spinlock id_maps_snapshot_lock_;
+  std::shared_ptr<const IdMapsSnapshot> id_maps_snapshot_ = std::make_shared<IdMapsSnapshot>();
+
   // Namespace maps: namespace-id -> NamespaceInfo and namespace-name -> NamespaceInfo
   typedef std::unordered_map<NamespaceName, scoped_refptr<NamespaceInfo> > NamespaceInfoMap;
   NamespaceInfoMap namespace_ids_map_;
@@ -1388,6 +1452,15 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // correctly.
   int64_t leader_ready_term_;
 
+  // Index of the last sys catalog write included in the catalog loaded while this node was a
+  // follower, or -1 if the in-memory catalog was not loaded as a follower or changed since.
+  std::atomic<int64_t> follower_catalog_write_index_{-1};
+
+  // Whether a follower catalog reload is scheduled, and when the last one finished. Protected by
+  // state_lock_.
+  bool follower_catalog_refresh_pending_ = false;
+  MonoTime follower_catalog_refreshed_at_;
+
   // Lock used to fence operations and leader elections. All logical operations
   // (i.e. create table, alter table, etc.) should acquire this lock for
   // reading. Following an election where this master is elected leader, it
@@ -1402,6 +1475,7 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // Async operations are accessing some private methods
   // (TODO: this stuff should be deferred and done in the background thread)
   friend class AsyncAlterTable;
+  friend class AsyncBackfillIndex;
 
   // Number of live tservers metric.
   scoped_refptr<AtomicGauge<uint32_t>> metric_num_tablet_servers_live_;
@@ -14,12 +14,14 @@
 #include "yb/master/cluster_balance.h"
 
 #include <algorithm>
+#include <cmath>
 #include <memory>
 
 #include <boost/thread/locks.hpp>
 
 #include "yb/consensus/quorum_util.h"
 #include "yb/master/master.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/random_util.h"
 
 DEFINE_bool(enable_load_balancing,
@@ -38,9 +40,43 @@ DEFINE_int32(leader_balance_unresponsive_timeout_ms,
                  "excluded from leader balancing.");
 
 DEFINE_int32(load_balancer_max_concurrent_moves,
-             1,
+             10,
              "Maximum number of concurrent LeaderMoves/Adds/Removals.");
 
+DEFINE_int32(load_balancer_max_concurrent_tablet_remote_bootstraps,
+             10,
+             "Maximum number of tablet replicas being remote bootstrapped across the cluster, "
+             "after which the load balancer does not add new replicas.");
+
+DEFINE_int32(load_balancer_max_tablet_remote_bootstraps_per_ts,
+             2,
+             "Maximum number of tablet replicas, that the load balancer lets a tablet server "
+             "remote bootstrap at once, or a tablet leader serve at once. Non positive value "
+             "means no limit.");
+
+DEFINE_int32(load_balancer_max_over_replicated_tablets,
+             10,
+             "Maximum number of tablets with more replicas than configured, e.g. tablets being "
+             "moved, after which the load balancer does not add new replicas.");
+
+DEFINE_bool(leader_balance_by_ops,
+            true,
+            "Whether to move tablet leaders from tablet servers, whose leaders serve many more "
+            "read and write operations than the leaders of other tablet servers, once the leader "
+            "counts are balanced.");
+
+DEFINE_double(leader_balance_ops_imbalance_ratio,
+              0.25,
+              "Leaders are moved by operation rate only when the leaders of a tablet server serve "
+              "more than (1 + ratio) times the operations per second of another tablet server.");
+
+DEFINE_double(leader_balance_min_ops_per_sec_difference,
+              100,
+              "Minimum difference of the operations per second served by the leaders of two "
+              "tablet servers, to move leaders between them by operation rate.");
+TAG_FLAG(leader_balance_ops_imbalance_ratio, advanced);
+TAG_FLAG(leader_balance_min_ops_per_sec_difference, advanced);
+
 DECLARE_int32(min_leader_stepdown_retry_interval_ms);
 
 namespace yb {
@@ -124,6 +160,9 @@ void ClusterLoadBalancer::RunLoadBalancer() {
   // Lock the CatalogManager maps for the duration of the load balancer run.
   boost::shared_lock<CatalogManager::LockType> l(catalog_manager_->lock_);
 
+  RemoteBootstrapLoad remote_bootstrap_load;
+  CountRemoteBootstraps(&remote_bootstrap_load);
+
   int remaining_adds = options_.kMaxConcurrentAdds;
   int remaining_removals = options_.kMaxConcurrentRemovals;
   int remaining_leader_moves = options_.kMaxConcurrentLeaderMoves;
@@ -158,6 +197,7 @@ void ClusterLoadBalancer::RunLoadBalancer() {
     }
 
     ResetState();
+    state_->remote_bootstrap_load_ = &remote_bootstrap_load;
 
     // Prepare the in-memory structures.
     if (!AnalyzeTablets(table.first)) {
@@ -171,7 +211,7 @@ void ClusterLoadBalancer::RunLoadBalancer() {
     TabletServerId out_to_ts;
 
     // Handle adding and moving replicas.
-    for (int i = 0; i < remaining_adds; ++i) {
+    while (remaining_adds > 0) {
       if (!HandleAddReplicas(&out_tablet_id, &out_from_ts, &out_to_ts)) {
         break;
       }
@@ -179,7 +219,7 @@ void ClusterLoadBalancer::RunLoadBalancer() {
     }
 
     // Handle cleanup after over-replication.
-    for (int i = 0; i < remaining_removals; ++i) {
+    while (remaining_removals > 0) {
       if (!HandleRemoveReplicas(&out_tablet_id, &out_from_ts)) {
         break;
       }
@@ -187,7 +227,7 @@ void ClusterLoadBalancer::RunLoadBalancer() {
     }
 
     // Handle tablet servers with too many leaders.
-    for (int i = 0; i < remaining_leader_moves; ++i) {
+    while (remaining_leader_moves > 0) {
       if (!HandleLeaderMoves(&out_tablet_id, &out_from_ts, &out_to_ts)) {
         break;
       }
@@ -200,6 +240,26 @@ void ClusterLoadBalancer::RunLoadBalancer() {
   }
 }
 
+void ClusterLoadBalancer::CountRemoteBootstraps(RemoteBootstrapLoad* load) const {
+  load->max_per_ts = options_.kMaxTabletRemoteBootstrapsPerTS;
+  for (const auto& entry : GetTabletMap()) {
+    TabletInfo::ReplicaMap replicas;
+    entry.second->GetReplicaLocations(&replicas);
+    TabletServerId leader;
+    for (const auto& replica : replicas) {
+      if (replica.second.role == consensus::RaftPeerPB::LEADER) {
+        leader = replica.first;
+      }
+    }
+    for (const auto& replica : replicas) {
+      const auto state = replica.second.state;
+      if (state == tablet::BOOTSTRAPPING || state == tablet::NOT_STARTED) {
+        load->Start(replica.first, leader);
+      }
+    }
+  }
+}
+
 void ClusterLoadBalancer::ResetState() {
   state_ = make_unique<YB_EDITION_NS_PREFIX ClusterLoadState>();
 }
@@ -208,6 +268,22 @@ bool ClusterLoadBalancer::AnalyzeTablets(const TableId& table_uuid) {
   // Set the blacklist so we can also mark the tablet servers as we add them up.
   state_->SetBlacklist(GetServerBlacklist());
 
+  // A table with its own replication info can pin its leaders to its own zones, e.g. to keep the
+  // leaders of a geo-partitioned table in the region of its data. Otherwise, use the cluster wide
+  // affinitized zones.
+  AffinitizedZonesSet affinitized_zones;
+  const auto table = GetTableInfo(table_uuid);
+  if (table) {
+    auto l = table->LockForRead();
+    for (const auto& cloud_info : l->data().pb.replication_info().affinitized_leaders()) {
+      affinitized_zones.insert(cloud_info);
+    }
+  }
+  if (affinitized_zones.empty()) {
+    GetAllAffinitizedZones(&affinitized_zones);
+  }
+  state_->SetAffinitizedZones(affinitized_zones);
+
   // Loop over live tablet servers to set empty defaults, so we can also have info on those
   // servers that have yet to receive load (have heartbeated to the master, but have not been
   // assigned any tablets yet).
@@ -354,11 +430,13 @@ bool ClusterLoadBalancer::HandleAddIfWrongPlacement(
 
 bool ClusterLoadBalancer::HandleAddReplicas(
     TabletId* out_tablet_id, TabletServerId* out_from_ts, TabletServerId* out_to_ts) {
-  if (options_.kAllowLimitStartingTablets &&
-      get_total_starting_tablets() >= options_.kMaxStartingTablets) {
+  // Replicas being started in other tables are known only when running the whole load balancer.
+  const int starting_tablets = state_->remote_bootstrap_load_
+      ? state_->remote_bootstrap_load_->total : get_total_starting_tablets();
+  if (options_.kAllowLimitStartingTablets && starting_tablets >= options_.kMaxStartingTablets) {
     LOG(INFO) << Substitute(
         "Cannot add replicas. Currently starting $0 tablets, when our max allowed is $1",
-        get_total_starting_tablets(), options_.kMaxStartingTablets);
+        starting_tablets, options_.kMaxStartingTablets);
     return false;
   }
 
@@ -592,35 +670,25 @@ bool ClusterLoadBalancer::GetLeaderToMove(
       // If there are, we have a candidate we want, so fill in the output params and return.
       const set<TabletId>& leaders = state_->per_ts_meta_[high_load_uuid].leaders;
       const set<TabletId>& peers = state_->per_ts_meta_[low_load_uuid].running_tablets;
-      set<TabletId> intersection;
-      const auto& itr = std::inserter(intersection, intersection.begin());
-      std::set_intersection(leaders.begin(), leaders.end(), peers.begin(), peers.end(), itr);
+      vector<TabletId> intersection;
+      std::set_intersection(leaders.begin(), leaders.end(), peers.begin(), peers.end(),
+                            std::back_inserter(intersection));
+      if (FLAGS_leader_balance_by_ops) {
+        // Move the leaders serving the fewest operations first, to keep the operation rates of
+        // the tablet servers balanced.
+        std::stable_sort(intersection.begin(), intersection.end(),
+                         [this](const TabletId& lhs, const TabletId& rhs) {
+          return state_->GetTabletOpsPerSec(lhs) < state_->GetTabletOpsPerSec(rhs);
+        });
+      }
 
       for (const auto& tablet_id : intersection) {
+        if (LeaderStepDownFailedRecently(tablet_id, low_load_uuid, current_time)) {
+          continue;
+        }
         *moving_tablet_id = tablet_id;
         *from_ts = high_load_uuid;
         *to_ts = low_load_uuid;
-
-        const auto& per_tablet_meta = state_->per_tablet_meta_;
-        const auto tablet_meta_iter = per_tablet_meta.find(tablet_id);
-        if (PREDICT_TRUE(tablet_meta_iter != per_tablet_meta.end())) {
-          const auto& tablet_meta = tablet_meta_iter->second;
-          const auto& stepdown_failures = tablet_meta.leader_stepdown_failures;
-          const auto stepdown_failure_iter = stepdown_failures.find(low_load_uuid);
-          if (stepdown_failure_iter != stepdown_failures.end()) {
-            const auto time_since_failure = current_time - stepdown_failure_iter->second;
-            if (time_since_failure.ToMilliseconds() < FLAGS_min_leader_stepdown_retry_interval_ms) {
-              LOG(INFO) << "Cannot move tablet " << tablet_id << " leader from TS "
-                        << *from_ts << " to TS " << *to_ts << " yet: previous attempt with the same"
-                        << " intended leader failed only " << ToString(time_since_failure)
-                        << " ago (less " << "than " << FLAGS_min_leader_stepdown_retry_interval_ms
-                        << "ms).";
-            }
-            continue;
-          }
-        } else {
-          LOG(WARNING) << "Did not find load balancer metadata for tablet " << *moving_tablet_id;
-        }
         return true;
       }
     }
@@ -630,6 +698,114 @@ bool ClusterLoadBalancer::GetLeaderToMove(
   FATAL_ERROR("Load balancing algorithm reached invalid state!");
 }
 
+bool ClusterLoadBalancer::GetNonAffinitizedLeaderToMove(
+    TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts) {
+  const auto current_time = MonoTime::Now();
+  // Start with the most loaded tablet server outside of the affinitized zones, and move its
+  // leaders to the least loaded affinitized tablet server that has a running peer.
+  const auto& non_affinitized = state_->sorted_non_affinitized_leader_load_;
+  for (auto it = non_affinitized.rbegin(); it != non_affinitized.rend(); ++it) {
+    const TabletServerId& high_load_uuid = *it;
+    for (const auto& tablet_id : state_->per_ts_meta_[high_load_uuid].leaders) {
+      for (const auto& low_load_uuid : state_->sorted_leader_load_) {
+        if (!state_->per_ts_meta_[low_load_uuid].running_tablets.count(tablet_id) ||
+            LeaderStepDownFailedRecently(tablet_id, low_load_uuid, current_time)) {
+          continue;
+        }
+        *moving_tablet_id = tablet_id;
+        *from_ts = high_load_uuid;
+        *to_ts = low_load_uuid;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool ClusterLoadBalancer::GetLeaderToMoveByOps(
+    TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts) {
+  // Tablet servers sorted ascending by the operation rate of their leaders.
+  vector<TabletServerId> sorted_ops_load = state_->sorted_leader_load_;
+  std::stable_sort(sorted_ops_load.begin(), sorted_ops_load.end(),
+                   [this](const TabletServerId& lhs, const TabletServerId& rhs) {
+    return state_->GetLeaderOpsPerSec(lhs) < state_->GetLeaderOpsPerSec(rhs);
+  });
+
+  // Go from the hottest TS and look for the coldest TS that runs a peer of one of its leaders. The
+  // moved leader is the one that brings the operation rates of the two TSs closest, and it must
+  // serve fewer operations than the difference, so every move reduces the imbalance.
+  const auto current_time = MonoTime::Now();
+  for (int right = static_cast<int>(sorted_ops_load.size()) - 1; right > 0; --right) {
+    const TabletServerId& high_load_uuid = sorted_ops_load[right];
+    const double high_ops = state_->GetLeaderOpsPerSec(high_load_uuid);
+    for (int left = 0; left < right; ++left) {
+      const TabletServerId& low_load_uuid = sorted_ops_load[left];
+      const double low_ops = state_->GetLeaderOpsPerSec(low_load_uuid);
+      const double difference = high_ops - low_ops;
+      if (difference < FLAGS_leader_balance_min_ops_per_sec_difference ||
+          high_ops <= low_ops * (1 + FLAGS_leader_balance_ops_imbalance_ratio)) {
+        // The next TSs are hotter, so their difference is even smaller.
+        break;
+      }
+
+      // Keep the leader counts balanced. At the allowed variance the leader count balancing moves
+      // the coldest leader in the opposite direction, so a hot leader is swapped for a cold one.
+      const int leader_variance =
+          state_->GetLeaderLoad(low_load_uuid) - state_->GetLeaderLoad(high_load_uuid) + 2;
+      if (leader_variance > options_.kMinLeaderLoadVarianceToBalance) {
+        continue;
+      }
+
+      const set<TabletId>& leaders = state_->per_ts_meta_[high_load_uuid].leaders;
+      const set<TabletId>& peers = state_->per_ts_meta_[low_load_uuid].running_tablets;
+      double best_imbalance = difference;
+      for (const auto& tablet_id : leaders) {
+        const double tablet_ops = state_->GetTabletOpsPerSec(tablet_id);
+        const double imbalance = std::abs(difference - 2 * tablet_ops);
+        if (tablet_ops <= 0 || imbalance >= best_imbalance || !peers.count(tablet_id) ||
+            LeaderStepDownFailedRecently(tablet_id, low_load_uuid, current_time)) {
+          continue;
+        }
+        best_imbalance = imbalance;
+        *moving_tablet_id = tablet_id;
+        *from_ts = high_load_uuid;
+        *to_ts = low_load_uuid;
+      }
+      if (best_imbalance < difference) {
+        VLOG(1) << Substitute(
+            "Moving leader of tablet $0 serving $1 ops/sec from TS $2 serving $3 ops/sec to TS $4 "
+            "serving $5 ops/sec", *moving_tablet_id, state_->GetTabletOpsPerSec(*moving_tablet_id),
+            high_load_uuid, high_ops, low_load_uuid, low_ops);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool ClusterLoadBalancer::LeaderStepDownFailedRecently(
+    const TabletId& tablet_id, const TabletServerId& to_ts, MonoTime current_time) {
+  const auto& per_tablet_meta = state_->per_tablet_meta_;
+  const auto tablet_meta_iter = per_tablet_meta.find(tablet_id);
+  if (PREDICT_FALSE(tablet_meta_iter == per_tablet_meta.end())) {
+    LOG(WARNING) << "Did not find load balancer metadata for tablet " << tablet_id;
+    return false;
+  }
+  const auto& stepdown_failures = tablet_meta_iter->second.leader_stepdown_failures;
+  const auto stepdown_failure_iter = stepdown_failures.find(to_ts);
+  if (stepdown_failure_iter == stepdown_failures.end()) {
+    return false;
+  }
+  const auto time_since_failure = current_time - stepdown_failure_iter->second;
+  if (time_since_failure.ToMilliseconds() < FLAGS_min_leader_stepdown_retry_interval_ms) {
+    LOG(INFO) << "Cannot move tablet " << tablet_id << " leader to TS " << to_ts
+              << " yet: previous attempt with the same intended leader failed only "
+              << ToString(time_since_failure) << " ago (less than "
+              << FLAGS_min_leader_stepdown_retry_interval_ms << "ms).";
+  }
+  return true;
+}
+
 bool ClusterLoadBalancer::HandleRemoveReplicas(
     TabletId* out_tablet_id, TabletServerId* out_from_ts) {
   // Give high priority to removing tablets that are not respecting the placement policy.
@@ -705,7 +881,11 @@ bool ClusterLoadBalancer::HandleRemoveIfWrongPlacement(
 
 bool ClusterLoadBalancer::HandleLeaderMoves(
     TabletId* out_tablet_id, TabletServerId* out_from_ts, TabletServerId* out_to_ts) {
-  if (GetLeaderToMove(out_tablet_id, out_from_ts, out_to_ts)) {
+  // Moving leaders into the affinitized zones takes priority over balancing the leader load.
+  if (GetNonAffinitizedLeaderToMove(out_tablet_id, out_from_ts, out_to_ts) ||
+      GetLeaderToMove(out_tablet_id, out_from_ts, out_to_ts) ||
+      (FLAGS_leader_balance_by_ops &&
+       GetLeaderToMoveByOps(out_tablet_id, out_from_ts, out_to_ts))) {
     MoveLeader(*out_tablet_id, *out_from_ts, *out_to_ts);
     return true;
   }
@@ -790,6 +970,13 @@ const BlacklistPB& ClusterLoadBalancer::GetServerBlacklist() const {
   return l->data().pb.server_blacklist();
 }
 
+void ClusterLoadBalancer::GetAllAffinitizedZones(AffinitizedZonesSet* affinitized_zones) const {
+  auto l = catalog_manager_->cluster_config_->LockForRead();
+  for (const auto& cloud_info : l->data().pb.replication_info().affinitized_leaders()) {
+    affinitized_zones->insert(cloud_info);
+  }
+}
+
 bool ClusterLoadBalancer::SkipLoadBalancing(const TableInfo& table) const {
   // Skip load-balancing of system tables. They are virtual tables not hosted by tservers.
   return catalog_manager_->IsSystemTable(table);
@@ -29,6 +29,9 @@
 #include "yb/master/cluster_balance_util.h"
 
 DECLARE_int32(load_balancer_max_concurrent_moves);
+DECLARE_int32(load_balancer_max_concurrent_tablet_remote_bootstraps);
+DECLARE_int32(load_balancer_max_tablet_remote_bootstraps_per_ts);
+DECLARE_int32(load_balancer_max_over_replicated_tablets);
 
 namespace yb {
 namespace master {
@@ -94,14 +97,14 @@ class ClusterLoadBalancer {
     bool kAllowLimitStartingTablets = true;
 
     // Max number of tablets being started across the cluster, if we enable limiting this.
-    int kMaxStartingTablets = 3;
+    int kMaxStartingTablets = FLAGS_load_balancer_max_concurrent_tablet_remote_bootstraps;
 
     // Whether to limit the number of tablets that have more peers than configured at any given
     // time.
     bool kAllowLimitOverReplicatedTablets = true;
 
     // Max number of running tablet replicas that are over the configured limit.
-    int kMaxOverReplicatedTablets = 3;
+    int kMaxOverReplicatedTablets = FLAGS_load_balancer_max_over_replicated_tablets;
 
     // Max number of over-replicated tablet peer removals to do in any one run of the load balancer.
     int kMaxConcurrentRemovals = FLAGS_load_balancer_max_concurrent_moves;
@@ -112,14 +115,9 @@ class ClusterLoadBalancer {
     // Max number of tablet leaders on tablet servers to move in any one run of the load balancer.
     int kMaxConcurrentLeaderMoves = FLAGS_load_balancer_max_concurrent_moves;
 
-    // TODO(bogdan): actually use these...
-    // TODO(bogdan): add state for leaders starting remote bootstraps, to limit on that end too.
-
-    // Max number of tablets being started for any one given TS.
-    int kMaxStartingTabletsPerTS = 1;
-
-    // Max number of tablets being bootstrapped from any one given TS.
-    int kMaxBootstrappingTabletsPerLeaderTS = 1;
+    // Max number of tablets being started for any one given TS, and max number of tablets being
+    // bootstrapped from any one given leader TS.
+    int kMaxTabletRemoteBootstrapsPerTS = FLAGS_load_balancer_max_tablet_remote_bootstraps_per_ts;
   };
 
   // The knobs we use for tweaking the flow of the algorithm.
@@ -147,6 +145,9 @@ class ClusterLoadBalancer {
   // Get the blacklist information.
   virtual const BlacklistPB& GetServerBlacklist() const;
 
+  // Get the zones that the cluster configuration prefers to host tablet leaders in.
+  virtual void GetAllAffinitizedZones(AffinitizedZonesSet* affinitized_zones) const;
+
   // Should skip load-balancing of this table?
   virtual bool SkipLoadBalancing(const TableInfo& table) const;
 
@@ -178,6 +179,10 @@ class ClusterLoadBalancer {
   // Recreates the ClusterLoadState object.
   void ResetState();
 
+  // Counts the replicas being remote bootstrapped across all the tables, per destination tablet
+  // server and per tablet leader, as the source of the remote bootstrap.
+  void CountRemoteBootstraps(RemoteBootstrapLoad* load) const;
+
   // Goes over the tablet_map_ and the set of live TSDescriptors to compute the load distribution
   // across the tablets for the given table. Returns false if we encounter transient errors that
   // should stop the load balancing.
@@ -248,6 +253,28 @@ class ClusterLoadBalancer {
   // Returns false otherwise.
   bool GetLeaderToMove(TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts);
 
+  // Go through sorted_non_affinitized_leader_load_ and figure out which leader to move from a TS
+  // outside of the affinitized zones to the least loaded affinitized TS that has a running peer.
+  //
+  // Returns true if we could find a leader to move and sets the three output parameters.
+  // Returns false otherwise.
+  bool GetNonAffinitizedLeaderToMove(
+      TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts);
+
+  // Go through the tablet servers by the read and write operations per second served by their
+  // leaders, and figure out which leader to move from a hot TS to a cold one, without breaking
+  // the leader count balance.
+  //
+  // Returns true if we could find a leader to rebalance and sets the three output parameters.
+  // Returns false otherwise.
+  bool GetLeaderToMoveByOps(
+      TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts);
+
+  // Returns true if stepping down the leader of the tablet in favor of to_ts failed too recently
+  // to retry it.
+  bool LeaderStepDownFailedRecently(
+      const TabletId& tablet_id, const TabletServerId& to_ts, MonoTime current_time);
+
   // Issue the change config and modify the in-memory state for moving a replica from one tablet
   // server to another.
   void MoveReplica(
@@ -34,6 +34,10 @@ class ClusterLoadBalancerMocked : public ClusterLoadBalancer {
 
   const BlacklistPB& GetServerBlacklist() const override { return blacklist_; }
 
+  void GetAllAffinitizedZones(AffinitizedZonesSet* affinitized_zones) const override {
+    *affinitized_zones = affinitized_zones_;
+  }
+
   void SendReplicaChanges(scoped_refptr<TabletInfo> tablet, const TabletServerId& ts_uuid,
                           const bool is_add, const bool should_remove,
                           const TabletServerId& new_leader_uuid) override {
@@ -103,6 +103,9 @@ struct CBTabletMetadata {
   // The tablet server id of the leader in this tablet's peer group.
   TabletServerId leader_uuid;
 
+  // Read and write operations per second served by the leader, as reported by its tablet server.
+  double leader_ops_per_sec = 0;
+
   // Leader stepdown failures. We use this to prevent retrying the same leader stepdown too soon.
   LeaderStepDownFailureTimes leader_stepdown_failures;
 
@@ -120,6 +123,48 @@ struct CBTabletServerMetadata {
 
   // The set of tablet leader ids that this tablet server is currently running.
   std::set<TabletId> leaders;
+
+  // Total read and write operations per second served by the leaders on this tablet server.
+  double leader_ops_per_sec = 0;
+};
+
+// Remote bootstraps of tablet replicas that are in progress across all tables. A new replica is
+// remote bootstrapped from the tablet leader, so both the tablet server that starts the replica
+// and the leader that sends the data to it are accounted.
+struct RemoteBootstrapLoad {
+  // Max number of remote bootstraps a tablet server can start or serve at once, non positive
+  // values mean no limit.
+  int max_per_ts = 0;
+
+  // Total number of replicas being remote bootstrapped.
+  int total = 0;
+
+  std::unordered_map<TabletServerId, int> starting;
+  std::unordered_map<TabletServerId, int> serving;
+
+  bool CanStart(const TabletServerId& to_ts, const TabletServerId& leader) const {
+    if (max_per_ts <= 0) {
+      return true;
+    }
+    if (Count(starting, to_ts) >= max_per_ts) {
+      return false;
+    }
+    return leader.empty() || Count(serving, leader) < max_per_ts;
+  }
+
+  void Start(const TabletServerId& to_ts, const TabletServerId& leader) {
+    ++total;
+    ++starting[to_ts];
+    if (!leader.empty()) {
+      ++serving[leader];
+    }
+  }
+
+ private:
+  static int Count(const std::unordered_map<TabletServerId, int>& map, const TabletServerId& ts) {
+    auto it = map.find(ts);
+    return it != map.end() ? it->second : 0;
+  }
 };
 
 class ClusterLoadState {
@@ -134,6 +179,12 @@ class ClusterLoadState {
     int load_a = GetLoad(a);
     int load_b = GetLoad(b);
     if (load_a == load_b) {
+      // Prefer moving tablets to the server that uses less disk space.
+      uint64_t disk_a = GetDiskUsage(a);
+      uint64_t disk_b = GetDiskUsage(b);
+      if (disk_a != disk_b) {
+        return disk_a < disk_b;
+      }
       return a < b;
     } else {
       return load_a < load_b;
@@ -174,13 +225,45 @@ class ClusterLoadState {
     return ts_meta.starting_tablets.size() + ts_meta.running_tablets.size();
   }
 
+  // Get the total size of SST files reported by a certain TS.
+  uint64_t GetDiskUsage(const TabletServerId& ts_uuid) const {
+    const auto& descriptor = per_ts_meta_.at(ts_uuid).descriptor;
+    return descriptor ? descriptor->total_sst_file_size() : 0;
+  }
+
   // Get the load for a certain TS.
   int GetLeaderLoad(const TabletServerId& ts_uuid) const {
     return per_ts_meta_.at(ts_uuid).leaders.size();
   }
 
+  // Get the read and write operations per second served by the leaders on a certain TS.
+  double GetLeaderOpsPerSec(const TabletServerId& ts_uuid) const {
+    return per_ts_meta_.at(ts_uuid).leader_ops_per_sec;
+  }
+
+  // Get the read and write operations per second served by the leader of a certain tablet.
+  double GetTabletOpsPerSec(const TabletId& tablet_id) const {
+    auto it = per_tablet_meta_.find(tablet_id);
+    return it != per_tablet_meta_.end() ? it->second.leader_ops_per_sec : 0;
+  }
+
   void SetBlacklist(const BlacklistPB& blacklist) { blacklist_ = blacklist; }
 
+  void SetAffinitizedZones(const AffinitizedZonesSet& affinitized_zones) {
+    affinitized_zones_ = affinitized_zones;
+  }
+
+  // Returns true if leaders may be placed on this tablet server, i.e. no affinitized zones are
+  // configured or the tablet server is in one of them.
+  bool IsInAffinitizedZone(const TSDescriptor& ts_desc) const {
+    if (affinitized_zones_.empty()) {
+      return true;
+    }
+    TSRegistrationPB registration;
+    ts_desc.GetRegistration(&registration);
+    return affinitized_zones_.count(registration.common().cloud_info()) > 0;
+  }
+
   // Update the per-tablet information for this tablet.
   bool UpdateTablet(TabletInfo* tablet) {
     const auto& tablet_id = tablet->id();
@@ -214,6 +297,9 @@ class ClusterLoadState {
       if (replica.second.role == consensus::RaftPeerPB::LEADER) {
         tablet_meta.leader_uuid = ts_uuid;
         ts_meta_it->second.leaders.insert(tablet_id);
+        const auto& descriptor = ts_meta_it->second.descriptor;
+        tablet_meta.leader_ops_per_sec = descriptor ? descriptor->tablet_ops_per_sec(tablet_id) : 0;
+        ts_meta_it->second.leader_ops_per_sec += tablet_meta.leader_ops_per_sec;
       }
 
       const tablet::TabletStatePB& tablet_state = replica.second.state;
@@ -334,7 +420,11 @@ class ClusterLoadState {
     if (!is_blacklisted &&
         ts_desc->TimeSinceHeartbeat().ToMilliseconds() <
         FLAGS_leader_balance_unresponsive_timeout_ms) {
-      sorted_leader_load_.push_back(ts_uuid);
+      if (IsInAffinitizedZone(*ts_desc)) {
+        sorted_leader_load_.push_back(ts_uuid);
+      } else {
+        sorted_non_affinitized_leader_load_.push_back(ts_uuid);
+      }
     }
 
     if (ts_desc->HasTabletDeletePending()) {
@@ -351,6 +441,11 @@ class ClusterLoadState {
     if (tablets_added_.count(tablet_id)) {
       return false;
     }
+    // Do not overload the tablet server or the tablet leader with remote bootstraps.
+    if (remote_bootstrap_load_ &&
+        !remote_bootstrap_load_->CanStart(to_ts, per_tablet_meta_[tablet_id].leader_uuid)) {
+      return false;
+    }
     // We do not add load to blacklisted servers.
     if (blacklisted_servers_.count(to_ts)) {
       return false;
@@ -455,6 +550,9 @@ class ClusterLoadState {
   }
 
   void AddReplica(const TabletId& tablet_id, const TabletServerId& to_ts) {
+    if (remote_bootstrap_load_) {
+      remote_bootstrap_load_->Start(to_ts, per_tablet_meta_[tablet_id].leader_uuid);
+    }
     per_ts_meta_[to_ts].starting_tablets.insert(tablet_id);
     ++per_tablet_meta_[tablet_id].starting;
     ++total_starting_;
@@ -494,11 +592,14 @@ class ClusterLoadState {
 
   void MoveLeader(
     const TabletId& tablet_id, const TabletServerId& from_ts, const TabletServerId& to_ts = "") {
-    DCHECK_EQ(per_tablet_meta_[tablet_id].leader_uuid, from_ts);
-    per_tablet_meta_[tablet_id].leader_uuid = to_ts;
+    auto& tablet_meta = per_tablet_meta_[tablet_id];
+    DCHECK_EQ(tablet_meta.leader_uuid, from_ts);
+    tablet_meta.leader_uuid = to_ts;
     per_ts_meta_[from_ts].leaders.erase(tablet_id);
+    per_ts_meta_[from_ts].leader_ops_per_sec -= tablet_meta.leader_ops_per_sec;
     if (!to_ts.empty()) {
       per_ts_meta_[to_ts].leaders.insert(tablet_id);
+      per_ts_meta_[to_ts].leader_ops_per_sec += tablet_meta.leader_ops_per_sec;
     }
     SortLeaderLoad();
   }
@@ -506,6 +607,8 @@ class ClusterLoadState {
   virtual void SortLeaderLoad() {
     auto leader_count_comparator = LeaderLoadComparator(this);
     sort(sorted_leader_load_.begin(), sorted_leader_load_.end(), leader_count_comparator);
+    sort(sorted_non_affinitized_leader_load_.begin(), sorted_non_affinitized_leader_load_.end(),
+         leader_count_comparator);
   }
 
   inline bool IsLeaderLoadBelowThreshold(const TabletServerId& ts_uuid) {
@@ -547,6 +650,10 @@ class ClusterLoadState {
   // Total number of tablet replicas being started across the cluster.
   int total_starting_ = 0;
 
+  // Remote bootstraps in progress across all tables, shared by the states of all tables processed
+  // by one load balancer run. Null if they are not limited.
+  RemoteBootstrapLoad* remote_bootstrap_load_ = nullptr;
+
   // Set of ts_uuid sorted ascending by load. This is the actual raw data of TS load.
   vector<TabletServerId> sorted_load_;
 
@@ -584,6 +691,14 @@ class ClusterLoadState {
   // If affinitized leaders is enabled, stores leader load for affinitized nodes.
   vector<TabletServerId> sorted_leader_load_;
 
+  // List of tablet server ids outside of the affinitized zones sorted by their leader load. Their
+  // leaders are moved to the affinitized tablet servers before leader load is balanced.
+  vector<TabletServerId> sorted_non_affinitized_leader_load_;
+
+  // The zones that the leaders of the current table should be placed in. Empty if leaders may be
+  // placed anywhere.
+  AffinitizedZonesSet affinitized_zones_;
+
   unordered_map<TableId, TabletToTabletServerMap> pending_add_replica_tasks_;
   unordered_map<TableId, TabletToTabletServerMap> pending_remove_replica_tasks_;
   unordered_map<TableId, TabletToTabletServerMap> pending_stepdown_leader_tasks_;
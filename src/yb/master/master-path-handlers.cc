@@ -212,6 +212,72 @@ void MasterPathHandlers::HandleTabletServers(const Webserver::WebRequest& req,
   *output << "</table>\n";
 }
 
+void MasterPathHandlers::HandleHotTablets(const Webserver::WebRequest& req,
+                                          stringstream* output) {
+  master_->catalog_manager()->AssertLeaderLockAcquiredForReading();
+
+  // Number of the busiest tablets to show.
+  constexpr size_t kMaxTablets = 50;
+
+  struct HotTablet {
+    TabletMetricsPB metrics;
+    string leader;
+  };
+  vector<HotTablet> tablets;
+  vector<std::shared_ptr<TSDescriptor> > descs;
+  master_->ts_manager()->GetAllLiveDescriptors(&descs);
+  for (const std::shared_ptr<TSDescriptor>& desc : descs) {
+    TSRegistrationPB reg;
+    desc->GetRegistration(&reg);
+    string host_port = Substitute("$0:$1",
+                                  reg.common().rpc_addresses(0).host(),
+                                  reg.common().rpc_addresses(0).port());
+    for (auto& metrics : desc->tablet_metrics()) {
+      tablets.push_back(HotTablet{std::move(metrics), host_port});
+    }
+  }
+  auto ops = [](const HotTablet& tablet) {
+    return tablet.metrics.read_ops_per_sec() + tablet.metrics.write_ops_per_sec();
+  };
+  std::sort(tablets.begin(), tablets.end(), [&ops](const HotTablet& lhs, const HotTablet& rhs) {
+    return ops(lhs) > ops(rhs);
+  });
+  if (tablets.size() > kMaxTablets) {
+    tablets.resize(kMaxTablets);
+  }
+
+  *output << std::setprecision(output_precision_);
+  *output << "<h2>Hot Tablets</h2>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "    <tr>\n"
+          << "      <th>Tablet ID</th>\n"
+          << "      <th>Leader</th>\n"
+          << "      <th>Read ops/sec</th>\n"
+          << "      <th>Write ops/sec</th>\n"
+          << "      <th>Read bytes/sec</th>\n"
+          << "      <th>Write bytes/sec</th>\n"
+          << "      <th>Hot keys (share of ops)</th>\n"
+          << "    </tr>\n";
+  for (const HotTablet& tablet : tablets) {
+    const TabletMetricsPB& metrics = tablet.metrics;
+    *output << "  <tr>\n";
+    *output << "    <td>" << EscapeForHtmlToString(metrics.tablet_id()) << "</td>";
+    *output << "    <td>" << EscapeForHtmlToString(tablet.leader) << "</td>";
+    *output << "    <td>" << metrics.read_ops_per_sec() << "</td>";
+    *output << "    <td>" << metrics.write_ops_per_sec() << "</td>";
+    *output << "    <td>" << BytesToHumanReadable(metrics.read_bytes_per_sec()) << "</td>";
+    *output << "    <td>" << BytesToHumanReadable(metrics.write_bytes_per_sec()) << "</td>";
+    *output << "    <td>";
+    for (const auto& hot_key : metrics.hot_keys()) {
+      *output << EscapeForHtmlToString(Slice(hot_key.key()).ToDebugString())
+              << StringPrintf(" (%.1f%%)", hot_key.fraction() * 100) << "<br>";
+    }
+    *output << "</td>";
+    *output << "  </tr>\n";
+  }
+  *output << "</table>\n";
+}
+
 void MasterPathHandlers::HandleCatalogManager(const Webserver::WebRequest& req,
                                               stringstream* output,
                                               bool skip_system_tables) {
@@ -791,6 +857,11 @@ Status MasterPathHandlers::Register(Webserver* server) {
       "/tablet-servers", "Tablet Servers",
       std::bind(&MasterPathHandlers::CallIfLeaderOrPrintRedirect, this, _1, _2, cb), is_styled,
       is_on_nav_bar, "fa fa-server");
+  cb = std::bind(&MasterPathHandlers::HandleHotTablets, this, _1, _2);
+  server->RegisterPathHandler(
+      "/hot-tablets", "Hot Tablets",
+      std::bind(&MasterPathHandlers::CallIfLeaderOrPrintRedirect, this, _1, _2, cb), is_styled,
+      false);
   cb = std::bind(&MasterPathHandlers::HandleCatalogManager,
                  this, _1, _2, false /* skip_system_tables */);
   server->RegisterPathHandler(
@@ -76,6 +76,8 @@ class MasterPathHandlers {
                    std::stringstream* output);
   void HandleTabletServers(const Webserver::WebRequest& req,
                            std::stringstream* output);
+  void HandleHotTablets(const Webserver::WebRequest& req,
+                        std::stringstream* output);
   void HandleCatalogManager(const Webserver::WebRequest& req,
                             std::stringstream* output,
                             bool skip_system_tables = false);
@@ -387,6 +387,34 @@ TEST_F(MasterTest, TestRegisterAndHeartbeat) {
     ASSERT_FALSE(resp.needs_full_tablet_report());
   }
 
+  // Incremental tablet reports should follow the previous report, otherwise the full one is
+  // requested.
+  for (int32_t sequence_number : {2, 1}) {
+    TSHeartbeatRequestPB req;
+    TSHeartbeatResponsePB resp;
+    req.mutable_common()->CopyFrom(common);
+    TabletReportPB* tr = req.mutable_tablet_report();
+    tr->set_is_incremental(true);
+    tr->set_sequence_number(sequence_number);
+    ASSERT_OK(proxy_->TSHeartbeat(req, &resp, ResetAndGetController()));
+
+    ASSERT_FALSE(resp.needs_reregister());
+    ASSERT_EQ(sequence_number == 1, resp.needs_full_tablet_report());
+  }
+
+  // Full tablet report resets the sequence.
+  {
+    TSHeartbeatRequestPB req;
+    TSHeartbeatResponsePB resp;
+    req.mutable_common()->CopyFrom(common);
+    TabletReportPB* tr = req.mutable_tablet_report();
+    tr->set_is_incremental(false);
+    tr->set_sequence_number(3);
+    ASSERT_OK(proxy_->TSHeartbeat(req, &resp, ResetAndGetController()));
+
+    ASSERT_FALSE(resp.needs_full_tablet_report());
+  }
+
   descs.clear();
   mini_master_->master()->ts_manager()->GetAllDescriptors(&descs);
   ASSERT_EQ(1, descs.size()) << "Should still only have one TS registered";
@@ -177,12 +177,14 @@ Status Master::RegisterServices() {
   std::unique_ptr<ServiceIf> consensus_service(
       new ConsensusServiceImpl(metric_entity(), catalog_manager_.get()));
   RETURN_NOT_OK(RpcAndWebServerBase::RegisterService(FLAGS_master_consensus_svc_queue_length,
-                                                     std::move(consensus_service)));
+                                                     std::move(consensus_service),
+                                                     rpc::ThreadPoolTaskPriority::kHigh));
 
   std::unique_ptr<ServiceIf> remote_bootstrap_service(
       new RemoteBootstrapServiceImpl(fs_manager_.get(), catalog_manager_.get(), metric_entity()));
   RETURN_NOT_OK(RpcAndWebServerBase::RegisterService(FLAGS_master_remote_bootstrap_svc_queue_length,
-                                                     std::move(remote_bootstrap_service)));
+                                                     std::move(remote_bootstrap_service),
+                                                     rpc::ThreadPoolTaskPriority::kLow));
   return Status::OK();
 }
 
@@ -159,6 +159,14 @@ void MasterServiceImpl::TSHeartbeat(const TSHeartbeatRequestPB* req,
     ts_desc->set_total_sst_file_size(req->metrics().total_sst_file_size());
     ts_desc->set_write_ops_per_sec(req->metrics().write_ops_per_sec());
     ts_desc->set_read_ops_per_sec(req->metrics().read_ops_per_sec());
+    std::unordered_map<std::string, double> tablet_ops_per_sec;
+    for (const auto& tablet_metrics : req->metrics().tablet_metrics()) {
+      tablet_ops_per_sec[tablet_metrics.tablet_id()] =
+          tablet_metrics.read_ops_per_sec() + tablet_metrics.write_ops_per_sec();
+    }
+    ts_desc->set_tablet_ops_per_sec(std::move(tablet_ops_per_sec));
+    ts_desc->set_tablet_metrics(std::vector<TabletMetricsPB>(
+        req->metrics().tablet_metrics().begin(), req->metrics().tablet_metrics().end()));
   }
 
   if (req->has_tablet_report()) {
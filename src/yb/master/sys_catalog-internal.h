@@ -14,6 +14,10 @@
 #ifndef YB_MASTER_SYS_CATALOG_INTERNAL_H_
 #define YB_MASTER_SYS_CATALOG_INTERNAL_H_
 
+#include <functional>
+#include <string>
+#include <vector>
+
 #include "yb/gutil/strings/substitute.h"
 #include "yb/master/catalog_manager.h"
 #include "yb/tserver/tserver.pb.h"
@@ -21,8 +25,23 @@
 #include "yb/util/pb_util.h"
 
 namespace yb {
+
+class ThreadPool;
+
 namespace master {
 
+// An entry of the sys catalog: its id and its serialized metadata.
+struct SysCatalogEntry {
+  std::string id;
+  std::string data;
+};
+
+// Splits [0, count) into ranges of a few hundred entries, runs range_func(begin, end) on each of
+// them on pool, the last one on the calling thread, and returns the first error once all of them
+// are done. Runs everything on the calling thread if pool is null.
+CHECKED_STATUS ParallelForRanges(
+    ThreadPool* pool, size_t count, const std::function<Status(size_t, size_t)>& range_func);
+
 class VisitorBase {
  public:
   VisitorBase() {}
@@ -32,6 +51,17 @@ class VisitorBase {
 
   virtual CHECKED_STATUS Visit(const Slice* id, const Slice* data) = 0;
 
+  // Visits a batch of entries in order. Visitors that parse the entries on their own may parse the
+  // whole batch in parallel on pool first.
+  virtual CHECKED_STATUS VisitBatch(const std::vector<SysCatalogEntry>& entries, ThreadPool* pool) {
+    for (const auto& entry : entries) {
+      const Slice id(entry.id);
+      const Slice data(entry.data);
+      RETURN_NOT_OK(Visit(&id, &data));
+    }
+    return Status::OK();
+  }
+
  protected:
 };
 
@@ -50,6 +80,28 @@ class Visitor : public VisitorBase {
     return Visit(id->ToString(), metadata);
   }
 
+  // Parsing dominates the cost of loading many small entries, e.g. the tablets, so the batch is
+  // parsed in parallel, and then visited in order on the calling thread.
+  CHECKED_STATUS VisitBatch(const std::vector<SysCatalogEntry>& entries,
+                            ThreadPool* pool) override {
+    std::vector<typename PersistentDataEntryClass::data_type> metadata(entries.size());
+    RETURN_NOT_OK(ParallelForRanges(
+        pool, entries.size(), [&entries, &metadata](size_t begin, size_t end) -> Status {
+      for (size_t i = begin; i != end; ++i) {
+        RETURN_NOT_OK_PREPEND(
+            pb_util::ParseFromArray(
+                &metadata[i], reinterpret_cast<const uint8_t*>(entries[i].data.data()),
+                entries[i].data.size()),
+            "Unable to parse metadata field for item id: " + entries[i].id);
+      }
+      return Status::OK();
+    }));
+    for (size_t i = 0; i != entries.size(); ++i) {
+      RETURN_NOT_OK(Visit(entries[i].id, metadata[i]));
+    }
+    return Status::OK();
+  }
+
   int entry_type() const { return PersistentDataEntryClass::type(); }
 
  protected:
@@ -58,6 +58,7 @@ using yb::rpc::MessengerBuilder;
 using yb::rpc::RpcController;
 
 DECLARE_string(cluster_uuid);
+DECLARE_int32(master_sys_catalog_load_batch_size);
 
 namespace yb {
 namespace master {
@@ -404,6 +405,39 @@ TEST_F(SysCatalogTest, TestSysCatalogTabletsOperations) {
   }
 }
 
+// Visit enough tablets for them to be parsed in parallel, in several batches.
+TEST_F(SysCatalogTest, TestSysCatalogTabletsParallelVisit) {
+  FLAGS_master_sys_catalog_load_batch_size = 700;
+  const int kNumTablets = 2000;
+  scoped_refptr<TableInfo> table(new TableInfo("abc"));
+  std::vector<scoped_refptr<TabletInfo>> tablets;
+  std::vector<TabletInfo*> tablet_ptrs;
+  for (int i = 0; i != kNumTablets; ++i) {
+    tablets.emplace_back(CreateTablet(
+        table.get(), Format("tablet-$0", i), Format("$0", i), Format("$0", i + 1)));
+    tablet_ptrs.push_back(tablets.back().get());
+  }
+
+  SysCatalogTable* sys_catalog = master_->catalog_manager()->sys_catalog();
+  {
+    std::vector<std::unique_ptr<TabletInfo::lock_type>> locks;
+    for (const auto& tablet : tablets) {
+      locks.push_back(tablet->LockForWrite());
+    }
+    ASSERT_OK(sys_catalog->AddItems(tablet_ptrs));
+    for (auto& lock : locks) {
+      lock->Commit();
+    }
+  }
+
+  unique_ptr<TestTabletLoader> loader(new TestTabletLoader());
+  ASSERT_OK(sys_catalog->Visit(loader.get()));
+  ASSERT_EQ(kNumTablets + master_->NumSystemTables(), loader->tablets.size());
+  for (const auto& tablet : tablets) {
+    ASSERT_TRUE(MetadatasEqual(tablet.get(), loader->tablets[tablet->id()])) << tablet->id();
+  }
+}
+
 // Verify that data mutations are not available from metadata() until commit.
 TEST_F(SysCatalogTest, TestTabletInfoCommit) {
   scoped_refptr<TabletInfo> tablet(new TabletInfo(nullptr, "123"));
@@ -32,7 +32,9 @@
 
 #include "yb/master/sys_catalog.h"
 
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 #include <gflags/gflags.h>
 #include <glog/logging.h>
@@ -60,6 +62,7 @@
 #include "yb/tablet/tablet_options.h"
 #include "yb/tserver/ts_tablet_manager.h"
 #include "yb/tablet/operations/write_operation.h"
+#include "yb/util/countdown_latch.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/threadpool.h"
@@ -96,6 +99,15 @@ DEFINE_int32(master_discovery_timeout_ms, 3600000,
              "Timeout for masters to discover each other during cluster creation/startup");
 TAG_FLAG(master_discovery_timeout_ms, hidden);
 
+DEFINE_int32(master_sys_catalog_load_threads, 8,
+             "Number of threads that parse the sys catalog entries in parallel when the catalog is "
+             "loaded into memory. 0 to parse them on the loading thread.");
+TAG_FLAG(master_sys_catalog_load_threads, advanced);
+
+DEFINE_int32(master_sys_catalog_load_batch_size, 4096,
+             "Number of sys catalog entries parsed in parallel at a time when the catalog is "
+             "loaded into memory.");
+TAG_FLAG(master_sys_catalog_load_batch_size, advanced);
 
 namespace yb {
 namespace master {
@@ -112,6 +124,11 @@ SysCatalogTable::SysCatalogTable(Master* master, MetricRegistry* metrics,
       master_(master),
       leader_cb_(std::move(leader_cb)) {
   CHECK_OK(ThreadPoolBuilder("apply").Build(&apply_pool_));
+  if (FLAGS_master_sys_catalog_load_threads > 0) {
+    CHECK_OK(ThreadPoolBuilder("sys-catalog-load")
+             .set_max_threads(FLAGS_master_sys_catalog_load_threads)
+             .Build(&load_pool_));
+  }
 }
 
 SysCatalogTable::~SysCatalogTable() {
@@ -122,6 +139,9 @@ void SysCatalogTable::Shutdown() {
     tablet_peer_->Shutdown();
   }
   apply_pool_->Shutdown();
+  if (load_pool_) {
+    load_pool_->Shutdown();
+  }
 }
 
 Status SysCatalogTable::ConvertConfigToMasterAddresses(
@@ -591,6 +611,11 @@ Status SysCatalogTable::Visit(VisitorBase* visitor) {
   RETURN_NOT_OK(tablet_peer_->tablet()->NewRowIterator(schema_, boost::none, &iter));
   RETURN_NOT_OK(iter->Init(&spec));
 
+  // The entries are copied out of the row blocks into batches, so that a batch larger than a block
+  // can be parsed in parallel.
+  const size_t batch_size = std::max(FLAGS_master_sys_catalog_load_batch_size, 1);
+  std::vector<SysCatalogEntry> batch;
+  batch.reserve(batch_size);
   Arena arena(32 * 1024, 256 * 1024);
   RowBlock block(iter->schema(), 512, &arena);
   while (iter->HasNext()) {
@@ -602,9 +627,44 @@ Status SysCatalogTable::Visit(VisitorBase* visitor) {
           block.row(i), schema_.find_column(kSysCatalogTableColId));
       const Slice* data = schema_.ExtractColumnFromRow<BINARY>(
           block.row(i), schema_.find_column(kSysCatalogTableColMetadata));
-      RETURN_NOT_OK(visitor->Visit(id, data));
+      batch.push_back(SysCatalogEntry{id->ToString(), data->ToString()});
+    }
+    if (batch.size() >= batch_size) {
+      RETURN_NOT_OK(visitor->VisitBatch(batch, load_pool_.get()));
+      batch.clear();
     }
   }
+  if (!batch.empty()) {
+    RETURN_NOT_OK(visitor->VisitBatch(batch, load_pool_.get()));
+  }
+  return Status::OK();
+}
+
+Status ParallelForRanges(
+    ThreadPool* pool, size_t count, const std::function<Status(size_t, size_t)>& range_func) {
+  constexpr size_t kRangeSize = 256;
+  if (pool == nullptr || count <= kRangeSize) {
+    return range_func(0, count);
+  }
+  const size_t num_ranges = (count + kRangeSize - 1) / kRangeSize;
+  std::vector<Status> statuses(num_ranges);
+  CountDownLatch latch(num_ranges - 1);
+  for (size_t range = 0; range != num_ranges - 1; ++range) {
+    auto run_range = [&range_func, &statuses, &latch, range, count] {
+      statuses[range] = range_func(range * kRangeSize, std::min((range + 1) * kRangeSize, count));
+      latch.CountDown();
+    };
+    Status s = pool->SubmitFunc(run_range);
+    if (!s.ok()) {
+      // E.g. the pool is shutting down, so do it here.
+      run_range();
+    }
+  }
+  statuses.back() = range_func((num_ranges - 1) * kRangeSize, count);
+  latch.Wait();
+  for (const auto& status : statuses) {
+    RETURN_NOT_OK(status);
+  }
   return Status::OK();
 }
 
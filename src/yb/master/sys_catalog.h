@@ -213,6 +213,9 @@ class SysCatalogTable {
 
   gscoped_ptr<ThreadPool> apply_pool_;
 
+  // Parses the entries in parallel when the catalog is loaded, null if that is disabled.
+  gscoped_ptr<ThreadPool> load_pool_;
+
   scoped_refptr<tablet::TabletPeer> tablet_peer_;
 
   Master* master_;
@@ -34,6 +34,8 @@
 
 #include <math.h>
 
+#include <atomic>
+
 #include <mutex>
 #include <vector>
 
@@ -48,6 +50,12 @@
 namespace yb {
 namespace master {
 
+namespace {
+
+std::atomic<uint64_t> registrations_version_counter{0};
+
+} // namespace
+
 Status TSDescriptor::RegisterNew(const NodeInstancePB& instance,
                                  const TSRegistrationPB& registration,
                                  gscoped_ptr<TSDescriptor>* desc) {
@@ -91,15 +99,23 @@ Status TSDescriptor::Register(const NodeInstancePB& instance,
   latest_seqno_ = instance.instance_seqno();
   // After re-registering, make the TS re-report its tablets.
   has_tablet_report_ = false;
+  last_tablet_report_seqno_ = -1;
 
   registration_.reset(new TSRegistrationPB(registration));
   placement_id_ = generate_placement_id(registration.common().cloud_info());
 
   proxies_.reset();
 
+  // Changed after the registration, so locations cached before it are not used.
+  registrations_version_counter.fetch_add(1, std::memory_order_acq_rel);
+
   return Status::OK();
 }
 
+uint64_t TSDescriptor::registrations_version() {
+  return registrations_version_counter.load(std::memory_order_acquire);
+}
+
 std::string TSDescriptor::generate_placement_id(const CloudInfoPB& ci) {
   return strings::Substitute(
       "$0:$1:$2", ci.placement_cloud(), ci.placement_region(), ci.placement_zone());
@@ -136,6 +152,15 @@ void TSDescriptor::set_has_tablet_report(bool has_report) {
   has_tablet_report_ = has_report;
 }
 
+bool TSDescriptor::UpdateTabletReportSequenceNumber(bool incremental, int32_t sequence_number) {
+  std::lock_guard<simple_spinlock> l(lock_);
+  if (incremental && sequence_number <= last_tablet_report_seqno_) {
+    return false;
+  }
+  last_tablet_report_seqno_ = sequence_number;
+  return true;
+}
+
 void TSDescriptor::DecayRecentReplicaCreationsUnlocked() {
   // In most cases, we won't have any recent replica creations, so
   // we don't need to bother calling the clock, etc.
@@ -35,8 +35,11 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "yb/gutil/gscoped_ptr.h"
+#include "yb/master/master.pb.h"
 #include "yb/tserver/tserver_service.proxy.h"
 #include "yb/util/locks.h"
 #include "yb/util/monotime.h"
@@ -93,9 +96,18 @@ class TSDescriptor {
   const std::string &permanent_uuid() const { return permanent_uuid_; }
   int64_t latest_seqno() const;
 
+  // Version of registrations of all tablet servers, it is changed every time some tablet server
+  // registers.
+  static uint64_t registrations_version();
+
   bool has_tablet_report() const;
   void set_has_tablet_report(bool has_report);
 
+  // Records sequence number of the tablet report received from this instance. Returns false if
+  // an incremental report does not follow the previously received report, so the instance should
+  // send a full tablet report.
+  bool UpdateTabletReportSequenceNumber(bool incremental, int32_t sequence_number);
+
   // Copy the current registration info into the given PB object.
   // A safe copy is returned because the internal Registration object
   // may be mutated at any point if the tablet server re-registers.
@@ -187,6 +199,31 @@ class TSDescriptor {
     return tsMetrics_.write_ops_per_sec;
   }
 
+  // Replaces the operation rates of the tablet leaders hosted by this tablet server.
+  void set_tablet_ops_per_sec(std::unordered_map<std::string, double> tablet_ops_per_sec) {
+    std::lock_guard<simple_spinlock> l(lock_);
+    tsMetrics_.tablet_ops_per_sec = std::move(tablet_ops_per_sec);
+  }
+
+  // Returns the number of read and write operations per second, that this tablet server served
+  // as the leader of the given tablet, according to its last report.
+  double tablet_ops_per_sec(const std::string& tablet_id) const {
+    std::lock_guard<simple_spinlock> l(lock_);
+    auto it = tsMetrics_.tablet_ops_per_sec.find(tablet_id);
+    return it != tsMetrics_.tablet_ops_per_sec.end() ? it->second : 0;
+  }
+
+  // Replaces the load and hot keys of the tablet leaders hosted by this tablet server.
+  void set_tablet_metrics(std::vector<TabletMetricsPB> tablet_metrics) {
+    std::lock_guard<simple_spinlock> l(lock_);
+    tsMetrics_.tablet_metrics = std::move(tablet_metrics);
+  }
+
+  std::vector<TabletMetricsPB> tablet_metrics() const {
+    std::lock_guard<simple_spinlock> l(lock_);
+    return tsMetrics_.tablet_metrics;
+  }
+
   void ClearMetrics() {
     tsMetrics_.ClearMetrics();
   }
@@ -239,11 +276,19 @@ class TSDescriptor {
 
     double write_ops_per_sec = 0;
 
+    // Read and write operations per second of the tablet leaders hosted by this tablet server.
+    std::unordered_map<std::string, double> tablet_ops_per_sec;
+
+    // Load and hot keys of the tablet leaders, as last reported by this tablet server.
+    std::vector<TabletMetricsPB> tablet_metrics;
+
     void ClearMetrics() {
       total_memory_usage = 0;
       total_sst_file_size = 0;
       read_ops_per_sec = 0;
       write_ops_per_sec = 0;
+      tablet_ops_per_sec.clear();
+      tablet_metrics.clear();
     }
   };
 
@@ -258,6 +303,9 @@ class TSDescriptor {
   // Set to true once this instance has reported all of its tablets.
   bool has_tablet_report_;
 
+  // Sequence number of the last tablet report received from this instance.
+  int32_t last_tablet_report_seqno_ = -1;
+
   // The number of times this tablet server has recently been selected to create a
   // tablet replica. This value decays back to 0 over time.
   double recent_replica_creations_;
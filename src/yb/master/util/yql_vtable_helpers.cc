@@ -22,7 +22,8 @@ namespace util {
 // requests to the respective nodes hosting the partition keys. But for clients using vanilla
 // drivers and thus Cassandra's own token-aware policy, we still want the requests to hit our nodes
 // evenly. To do that, we split Cassandra's token ring (signed 64-bit number space) evenly and
-// return the token for each node in the node list.
+// return the token for each node in the node list. This is used when the tokens can't be taken
+// from the tablet leaders, see YQLVirtualTable::GetTokensValues.
 QLValuePB GetTokensValue(size_t index, size_t node_count) {
   CHECK_GT(node_count, 0);
   QLValuePB value_pb;
@@ -31,6 +32,14 @@ QLValuePB GetTokensValue(size_t index, size_t node_count) {
   return value_pb;
 }
 
+QLValuePB GetTokensValue(const std::set<int64_t>& tokens) {
+  QLValuePB value_pb;
+  for (int64_t token : tokens) {
+    value_pb.mutable_set_value()->add_elems()->set_string_value(std::to_string(token));
+  }
+  return value_pb;
+}
+
 bool RemoteEndpointMatchesTServer(const TSInformationPB& ts_info,
                                   const InetAddress& remote_endpoint) {
   for (HostPortPB rpc_address : ts_info.registration().common().rpc_addresses()) {
@@ -14,6 +14,8 @@
 #ifndef YB_MASTER_UTIL_YQL_VTABLE_HELPERS_H
 #define YB_MASTER_UTIL_YQL_VTABLE_HELPERS_H
 
+#include <set>
+
 #include "yb/common/ql_value.h"
 #include "yb/master/master.pb.h"
 #include "yb/util/net/inetaddress.h"
@@ -103,6 +105,9 @@ QLValuePB GetValue(const T& t, DataType data_type) {
 
 QLValuePB GetTokensValue(size_t index, size_t node_count);
 
+// Returns the given Cassandra tokens as the value of a tokens column.
+QLValuePB GetTokensValue(const std::set<int64_t>& tokens);
+
 QLValuePB GetReplicationValue(int replication_factor);
 
 bool RemoteEndpointMatchesTServer(const TSInformationPB& ts_info,
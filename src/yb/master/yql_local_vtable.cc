@@ -25,12 +25,13 @@ Status LocalVTable::RetrieveData(const QLReadRequestPB& request,
                                  std::unique_ptr<QLRowBlock>* vtable) const {
   vector<std::shared_ptr<TSDescriptor> > descs;
   GetSortedLiveDescriptors(&descs);
+  std::unordered_map<std::string, QLValuePB> tokens;
+  GetTokensValues(descs, &tokens);
   vtable->reset(new QLRowBlock(schema_));
 
   InetAddress remote_endpoint;
   RETURN_NOT_OK(remote_endpoint.FromString(request.remote_endpoint().host()));
 
-  size_t index = 0;
   for (const std::shared_ptr<TSDescriptor>& desc : descs) {
     TSInformationPB ts_info;
     // This is thread safe since all operations are reads.
@@ -49,6 +50,9 @@ Status LocalVTable::RetrieveData(const QLReadRequestPB& request,
       RETURN_NOT_OK(SetColumnValue(kSystemLocalDataCenterColumn, cloud_info.placement_region(),
                                    &row));
       RETURN_NOT_OK(SetColumnValue(kSystemLocalGossipGenerationColumn, 0, &row));
+      Uuid host_id;
+      RETURN_NOT_OK(host_id.FromHexString(ts_info.tserver_instance().permanent_uuid()));
+      RETURN_NOT_OK(SetColumnValue(kSystemLocalHostIdColumn, host_id, &row));
       RETURN_NOT_OK(SetColumnValue(kSystemLocalListenAddressColumn, remote_endpoint, &row));
       RETURN_NOT_OK(SetColumnValue(kSystemLocalNativeProtocolVersionColumn, "4", &row));
       RETURN_NOT_OK(SetColumnValue(kSystemLocalPartitionerColumn,
@@ -63,11 +67,10 @@ Status LocalVTable::RetrieveData(const QLReadRequestPB& request,
       RETURN_NOT_OK(SetColumnValue(kSystemLocalSchemaVersionColumn, schema_version, &row));
       RETURN_NOT_OK(SetColumnValue(kSystemLocalThriftVersionColumn, "20.1.0", &row));
       // setting tokens
-      RETURN_NOT_OK(SetColumnValue(kSystemLocalTokensColumn,
-                                   util::GetTokensValue(index, descs.size()), &row));
+      RETURN_NOT_OK(SetColumnValue(kSystemLocalTokensColumn, tokens[desc->permanent_uuid()],
+                                   &row));
       break;
     }
-    index++;
   }
 
   return Status::OK();
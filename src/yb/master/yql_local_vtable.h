@@ -30,6 +30,11 @@ class LocalVTable : public YQLVirtualTable {
  protected:
   Schema CreateSchema() const;
 
+  // The local node is the tablet server of the CQL proxy that sent the request.
+  boost::optional<std::string> DataCacheKey(const QLReadRequestPB& request) const override {
+    return request.remote_endpoint().host();
+  }
+
  private:
   static constexpr const char* const kSystemLocalKeyColumn = "key";
   static constexpr const char* const kSystemLocalBootstrappedColumn = "bootstrapped";
@@ -67,6 +67,9 @@ Status YQLPartitionsVTable::RetrieveData(const QLReadRequestPB& request,
       QLValuePB replica_addresses;
       QLMapValuePB *map_value = replica_addresses.mutable_map_value();
       for (const auto replica : tabletLocationsPB.replicas()) {
+        if (replica.ts_info().rpc_addresses_size() == 0) {
+          continue;
+        }
         InetAddress addr;
         RETURN_NOT_OK(addr.FromString(replica.ts_info().rpc_addresses(0).host()));
         QLValue elem_key;
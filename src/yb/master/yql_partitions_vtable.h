@@ -28,6 +28,11 @@ class YQLPartitionsVTable : public YQLVirtualTable {
                               std::unique_ptr<QLRowBlock>* vtable) const;
  protected:
   Schema CreateSchema() const;
+
+  // The partitions are the same for all requests.
+  boost::optional<std::string> DataCacheKey(const QLReadRequestPB& request) const override {
+    return std::string();
+  }
  private:
   static constexpr const char* const kKeyspaceName = "keyspace_name";
   static constexpr const char* const kTableName = "table_name";
@@ -36,6 +36,8 @@ Status PeersVTable::RetrieveData(const QLReadRequestPB& request,
   // change the cluster topology often, for now its safe to just have the live nodes here.
   vector<shared_ptr<TSDescriptor> > descs;
   GetSortedLiveDescriptors(&descs);
+  std::unordered_map<string, QLValuePB> tokens;
+  GetTokensValues(descs, &tokens);
 
   // Collect all unique ip addresses.
   InetAddress remote_endpoint;
@@ -44,7 +46,6 @@ Status PeersVTable::RetrieveData(const QLReadRequestPB& request,
   // Populate the YQL rows.
   vtable->reset(new QLRowBlock(schema_));
 
-  size_t index = 0;
   for (const shared_ptr<TSDescriptor>& desc : descs) {
     TSInformationPB ts_info;
     // This is thread safe since all operations are reads.
@@ -87,13 +88,12 @@ Status PeersVTable::RetrieveData(const QLReadRequestPB& request,
         RETURN_NOT_OK(SetColumnValue(kSchemaVersion, schema_version, &row));
 
         // Tokens.
-        RETURN_NOT_OK(SetColumnValue(kTokens, util::GetTokensValue(index, descs.size()), &row));
+        RETURN_NOT_OK(SetColumnValue(kTokens, tokens[desc->permanent_uuid()], &row));
       } else {
         LOG (WARNING) << strings::Substitute("Skipping host $0, since we couldn't resolve it to an "
                                                  "IP address", ts_host);
       }
     }
-    index++;
   }
 
   return Status::OK();
@@ -30,6 +30,11 @@ class PeersVTable : public YQLVirtualTable {
  protected:
   Schema CreateSchema() const;
 
+  // The peers are the tablet servers other than the one of the CQL proxy that sent the request.
+  boost::optional<std::string> DataCacheKey(const QLReadRequestPB& request) const override {
+    return request.remote_endpoint().host();
+  }
+
  private:
   static constexpr const char* const kPeer = "peer";
   static constexpr const char* const kDataCenter = "data_center";
@@ -12,8 +12,35 @@
 //
 
 #include "yb/master/yql_virtual_table.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <set>
+
+#include "yb/common/partition.h"
+#include "yb/common/redis_constants_common.h"
+#include "yb/master/catalog_manager.h"
 #include "yb/master/ts_manager.h"
 #include "yb/master/yql_vtable_iterator.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/yb_partition.h"
+
+DEFINE_bool(yql_tokens_from_tablet_leaders, true,
+            "Assign to each tablet server in system.local and system.peers the tokens of the "
+            "hash partitions whose tablets it leads, so that token-aware drivers send requests "
+            "to the leaders. When a live tablet server leads no tablet, the token ring is split "
+            "evenly between the tablet servers instead.");
+TAG_FLAG(yql_tokens_from_tablet_leaders, advanced);
+TAG_FLAG(yql_tokens_from_tablet_leaders, runtime);
+
+DEFINE_int32(yql_vtable_cache_ttl_ms, 1000,
+             "For how long the rows of system.local, system.peers and system_schema.partitions, "
+             "that drivers poll, are reused by the reads instead of being rebuilt from the state "
+             "of the tablet servers and the catalog. They are rebuilt when a tablet server "
+             "registers as well. 0 disables the cache.");
+TAG_FLAG(yql_vtable_cache_ttl_ms, advanced);
+TAG_FLAG(yql_vtable_cache_ttl_ms, runtime);
 
 namespace yb {
 namespace master {
@@ -34,31 +61,58 @@ CHECKED_STATUS YQLVirtualTable::GetIterator(
     const ReadHybridTime& read_time,
     std::unique_ptr<common::QLRowwiseIteratorIf>* iter)
     const {
-  std::unique_ptr<QLRowBlock> vtable;
-  RETURN_NOT_OK(RetrieveData(request, &vtable));
+  std::shared_ptr<const QLRowBlock> vtable;
+  RETURN_NOT_OK(GetData(request, &vtable));
 
-  // If hashed column values are specified, filter by the hash key.
+  // If hashed column values are specified, filter by the hash key. The retrieved rows could be
+  // shared, so the matching ones are copied.
   if (!request.hashed_column_values().empty()) {
     const size_t num_hash_key_columns = schema_.num_hash_key_columns();
     const auto& hashed_column_values = request.hashed_column_values();
-    std::vector<QLRow>& rows = vtable->rows();
-    auto excluded_rows = std::remove_if(
-        rows.begin(), rows.end(),
-        [num_hash_key_columns, &hashed_column_values](const QLRow& row) -> bool {
-          for (size_t i = 0; i < num_hash_key_columns; i++) {
-            if (hashed_column_values.Get(i).value() != row.column(i)) {
-              return true;
-            }
-          }
-          return false;
-        });
-    rows.erase(excluded_rows, rows.end());
+    auto filtered = std::make_shared<QLRowBlock>(schema_);
+    for (const QLRow& row : vtable->rows()) {
+      bool matches = true;
+      for (size_t i = 0; i < num_hash_key_columns && matches; i++) {
+        matches = hashed_column_values.Get(i).value() == row.column(i);
+      }
+      if (matches) {
+        RETURN_NOT_OK(filtered->AddRow(row));
+      }
+    }
+    vtable = std::move(filtered);
   }
 
   iter->reset(new YQLVTableIterator(std::move(vtable)));
   return Status::OK();
 }
 
+Status YQLVirtualTable::GetData(const QLReadRequestPB& request,
+                                std::shared_ptr<const QLRowBlock>* vtable) const {
+  const auto ttl_ms = FLAGS_yql_vtable_cache_ttl_ms;
+  const auto key = ttl_ms > 0 ? DataCacheKey(request) : boost::none;
+  const auto registrations_version = TSDescriptor::registrations_version();
+  if (key) {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    auto it = cache_.find(*key);
+    if (it != cache_.end() && it->second.registrations_version == registrations_version &&
+        MonoTime::Now().ComesBefore(it->second.expiration)) {
+      *vtable = it->second.vtable;
+      return Status::OK();
+    }
+  }
+
+  // Concurrent reads could rebuild the same data, the last one is cached.
+  std::unique_ptr<QLRowBlock> retrieved;
+  RETURN_NOT_OK(RetrieveData(request, &retrieved));
+  *vtable = std::move(retrieved);
+  if (key) {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    cache_[*key] = CachedData{
+        *vtable, MonoTime::Now() + MonoDelta::FromMilliseconds(ttl_ms), registrations_version};
+  }
+  return Status::OK();
+}
+
 CHECKED_STATUS YQLVirtualTable::BuildQLScanSpec(
     const QLReadRequestPB& request,
     const ReadHybridTime& read_time,
@@ -89,5 +143,70 @@ void YQLVirtualTable::GetSortedLiveDescriptors(std::vector<std::shared_ptr<TSDes
       });
 }
 
+void YQLVirtualTable::GetTokensValues(const std::vector<std::shared_ptr<TSDescriptor>>& descs,
+                                      std::unordered_map<std::string, QLValuePB>* tokens) const {
+  tokens->clear();
+  if (FLAGS_yql_tokens_from_tablet_leaders) {
+    // Cassandra's token-aware policy sends a key to the node owning the first token at or after
+    // the token of the key, so the token of a tablet is the last token of its hash partition.
+    // When tablets of different tables end at the same hash code, the first leader found wins.
+    std::map<int64_t, std::string> leader_tokens;
+    CatalogManager* catalog_manager = master_->catalog_manager();
+    std::vector<scoped_refptr<TableInfo> > tables;
+    catalog_manager->GetAllTables(&tables, true /* includeOnlyRunningTables */);
+    for (const scoped_refptr<TableInfo>& table : tables) {
+      if (catalog_manager->IsSystemTable(*table) || table->name() == common::kRedisTableName) {
+        continue;
+      }
+      {
+        auto l = table->LockForRead();
+        if (l->data().pb.partition_schema().hash_schema() !=
+                PartitionSchemaPB::MULTI_COLUMN_HASH_SCHEMA) {
+          continue;
+        }
+      }
+      std::vector<scoped_refptr<TabletInfo> > tablets;
+      table->GetAllTablets(&tablets);
+      for (const scoped_refptr<TabletInfo>& tablet : tablets) {
+        TabletInfo::ReplicaMap replicas;
+        tablet->GetReplicaLocations(&replicas);
+        for (const auto& replica : replicas) {
+          if (replica.second.role != consensus::RaftPeerPB::LEADER) {
+            continue;
+          }
+          const std::string& end = tablet->metadata().state().pb.partition().partition_key_end();
+          const int64_t token = end.empty()
+              ? std::numeric_limits<int64_t>::max()
+              : YBPartition::YBToCqlHashCode(PartitionSchema::DecodeMultiColumnHashValue(end)) - 1;
+          leader_tokens.emplace(token, replica.first);
+          break;
+        }
+      }
+    }
+
+    std::unordered_map<std::string, std::set<int64_t>> tokens_by_ts;
+    for (const auto& entry : leader_tokens) {
+      tokens_by_ts[entry.second].insert(entry.first);
+    }
+    // A node without tokens would receive no requests at all, so only use the tablet leaders
+    // when every live tablet server leads some tablet.
+    const bool all_lead = std::all_of(
+        descs.begin(), descs.end(), [&tokens_by_ts](const std::shared_ptr<TSDescriptor>& desc) {
+          return tokens_by_ts.count(desc->permanent_uuid()) != 0;
+        });
+    if (all_lead) {
+      for (const std::shared_ptr<TSDescriptor>& desc : descs) {
+        (*tokens)[desc->permanent_uuid()] =
+            util::GetTokensValue(tokens_by_ts[desc->permanent_uuid()]);
+      }
+      return;
+    }
+  }
+
+  for (size_t index = 0; index != descs.size(); ++index) {
+    (*tokens)[descs[index]->permanent_uuid()] = util::GetTokensValue(index, descs.size());
+  }
+}
+
 }  // namespace master
 }  // namespace yb
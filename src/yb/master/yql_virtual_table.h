@@ -14,6 +14,11 @@
 #ifndef YB_MASTER_YQL_VIRTUAL_TABLE_H
 #define YB_MASTER_YQL_VIRTUAL_TABLE_H
 
+#include <mutex>
+#include <unordered_map>
+
+#include <boost/optional.hpp>
+
 #include "yb/common/entity_ids.h"
 #include "yb/common/ql_rowblock.h"
 #include "yb/common/ql_storage_interface.h"
@@ -56,6 +61,13 @@ class YQLVirtualTable : public common::QLStorageIf {
   const TableName& table_name() const { return table_name_; }
 
  protected:
+  // Returns the key of the data retrieved for the request in the cache of the table, or none if the
+  // data should not be cached. The data is reused by the requests with the same key for
+  // --yql_vtable_cache_ttl_ms, unless a tablet server registers in the meantime.
+  virtual boost::optional<std::string> DataCacheKey(const QLReadRequestPB& request) const {
+    return boost::none;
+  }
+
   // Finds the given column name in the schema and updates the specified column in the given row
   // with the provided value.
   template<class T>
@@ -74,9 +86,28 @@ class YQLVirtualTable : public common::QLStorageIf {
   // consistent token.
   void GetSortedLiveDescriptors(std::vector<std::shared_ptr<TSDescriptor>>* descs) const;
 
+  // Returns the value of the tokens column of each of the given tablet servers, keyed by their
+  // permanent uuids. The descriptors should be sorted as by GetSortedLiveDescriptors.
+  void GetTokensValues(const std::vector<std::shared_ptr<TSDescriptor>>& descs,
+                       std::unordered_map<std::string, QLValuePB>* tokens) const;
+
   const Master* const master_;
   TableName table_name_;
   Schema schema_;
+
+ private:
+  // Returns the data of the table for the request, from the cache when possible.
+  CHECKED_STATUS GetData(const QLReadRequestPB& request,
+                         std::shared_ptr<const QLRowBlock>* vtable) const;
+
+  struct CachedData {
+    std::shared_ptr<const QLRowBlock> vtable;
+    MonoTime expiration;
+    uint64_t registrations_version;
+  };
+
+  mutable std::mutex cache_mutex_;
+  mutable std::unordered_map<std::string, CachedData> cache_;
 };
 
 }  // namespace master
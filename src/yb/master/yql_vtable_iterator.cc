@@ -16,7 +16,7 @@
 namespace yb {
 namespace master {
 
-YQLVTableIterator::YQLVTableIterator(std::unique_ptr<QLRowBlock> vtable)
+YQLVTableIterator::YQLVTableIterator(std::shared_ptr<const QLRowBlock> vtable)
     : vtable_(std::move(vtable)),
       vtable_index_(0) {
 }
@@ -41,7 +41,7 @@ CHECKED_STATUS YQLVTableIterator::NextRow(const Schema& projection,
   }
 
   // TODO: return columns in projection only.
-  QLRow& row = vtable_->row(vtable_index_);
+  const QLRow& row = vtable_->row(vtable_index_);
   for (int i = 0; i < row.schema().num_columns(); i++) {
     table_row->AllocColumn(row.schema().column_id(i),
                            down_cast<const QLValue&>(row.column(i)));
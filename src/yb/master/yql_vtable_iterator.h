@@ -24,7 +24,8 @@ namespace master {
 // An iterator over a YQLVirtualTable.
 class YQLVTableIterator : public common::QLRowwiseIteratorIf {
  public:
-  explicit YQLVTableIterator(const std::unique_ptr<QLRowBlock> vtable);
+  // The rows could be shared with other iterators and the cache of the virtual table.
+  explicit YQLVTableIterator(std::shared_ptr<const QLRowBlock> vtable);
   CHECKED_STATUS Init(ScanSpec *spec) override;
 
   CHECKED_STATUS Init(const common::QLScanSpec& spec) override;
@@ -54,7 +55,7 @@ class YQLVTableIterator : public common::QLRowwiseIteratorIf {
 
   virtual ~YQLVTableIterator();
  private:
-  std::unique_ptr<QLRowBlock> vtable_;
+  std::shared_ptr<const QLRowBlock> vtable_;
   size_t vtable_index_;
 };
 
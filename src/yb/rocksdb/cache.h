@@ -59,13 +59,17 @@ class Cache;
 // to 2^num_shard_bits shards, by hash of the key. The total capacity
 // is divided and evenly assigned to each shard.
 //
-// The parameter num_shard_bits defaults to 4, and strict_capacity_limit
-// defaults to false.
+// The parameter num_shard_bits defaults to GetDefaultCacheShardBits(capacity), and
+// strict_capacity_limit defaults to false.
 extern shared_ptr<Cache> NewLRUCache(size_t capacity);
 extern shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits);
 extern shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits,
                                      bool strict_capacity_limit);
 
+// Returns the number of shard bits for a cache of the given capacity. The number of shards grows
+// with the number of cores, while keeping every shard large enough to hold a fair number of blocks.
+extern int GetDefaultCacheShardBits(size_t capacity);
+
 using QueryId = int64_t;
 // Query ids to represent values for the default query id.
 constexpr QueryId kDefaultQueryId = 0;
@@ -73,6 +77,10 @@ constexpr QueryId kDefaultQueryId = 0;
 constexpr QueryId kInMultiTouchId = -1;
 // Query ids to represent values that should not be in any cache.
 constexpr QueryId kNoCacheQueryId = -2;
+// Query ids to represent values filled by large scans. Such values are put at the cold end of the
+// single touch cache and are not upgraded into the multi touch cache by lookups with this id, so a
+// scan does not evict the working set of point reads.
+constexpr QueryId kLowPriorityQueryId = -3;
 
 class Cache {
  public:
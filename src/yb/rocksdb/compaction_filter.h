@@ -33,6 +33,7 @@
 namespace rocksdb {
 
 class SliceTransform;
+struct FileMetaData;
 
 // Context information of a compaction run
 struct CompactionFilterContext {
@@ -144,6 +145,21 @@ class CompactionFilterFactory {
   virtual std::unique_ptr<CompactionFilter> CreateCompactionFilter(
       const CompactionFilter::Context& context) = 0;
 
+  // A compaction could be split into subcompactions over disjoint key ranges, each with its own
+  // compaction filter. Filters that keep state between consecutive keys could require keys with
+  // some common prefix to be processed by the same filter. In this case this function should
+  // return the prefix of user_key where a subcompaction could start, or an empty slice if there
+  // is no such prefix.
+  virtual Slice SubcompactionBoundary(const Slice& user_key) const { return user_key; }
+
+  // Files are ordered from the newest to the oldest. Returns the number of files at the end of
+  // files, i.e. the oldest ones, that contain only records the compaction filter would drop, so
+  // they could be deleted without being read. Called under the DB mutex, so should only look at
+  // file metadata.
+  virtual size_t NumExpiredOldestFiles(const std::vector<FileMetaData*>& files) {
+    return 0;
+  }
+
   // Returns a name that identifies this compaction filter factory.
   virtual const char* Name() const = 0;
 };
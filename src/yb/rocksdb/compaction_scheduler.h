@@ -0,0 +1,84 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+#ifndef ROCKSDB_INCLUDE_ROCKSDB_COMPACTION_SCHEDULER_H
+#define ROCKSDB_INCLUDE_ROCKSDB_COMPACTION_SCHEDULER_H
+
+#include <stdint.h>
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+
+namespace rocksdb {
+
+class Env;
+
+// Admits background compactions of several DBs into a shared pool of Env::Priority::LOW threads.
+// At most max_running_compactions compactions run at once, and whenever a slot frees up the queued
+// compaction with the highest priority is admitted, so DBs that are close to stalling writes are
+// compacted before DBs that can wait. Queued compactions with equal priority are admitted in FIFO
+// order.
+//
+// Should be created with std::make_shared, queued and running compactions keep the scheduler alive.
+class CompactionScheduler : public std::enable_shared_from_this<CompactionScheduler> {
+ public:
+  // Priority of a queued compaction, higher values are admitted first. It is evaluated every time
+  // a slot frees up, under the scheduler mutex, so it should be cheap and must not acquire any DB
+  // mutex.
+  typedef std::function<int64_t()> PriorityFunction;
+
+  CompactionScheduler(Env* env, int max_running_compactions);
+  ~CompactionScheduler();
+
+  // Same contract as Env::Schedule for Env::Priority::LOW, except that function is queued in the
+  // scheduler until it is admitted.
+  void Schedule(void (*function)(void*), void* arg, void* tag,
+                void (*unschedule_function)(void*), PriorityFunction priority);
+
+  // Removes the compactions of tag that were not admitted yet, calling their unschedule_function.
+  // Compactions that were admitted but did not start running should be removed with
+  // Env::UnSchedule(tag, Env::Priority::LOW) before calling this. Returns the number of removed
+  // compactions.
+  int UnSchedule(void* tag);
+
+  int max_running_compactions() const { return max_running_compactions_; }
+
+  int NumRunning() const;
+  int NumQueued() const;
+
+  // No copying allowed
+  CompactionScheduler(const CompactionScheduler&) = delete;
+  void operator=(const CompactionScheduler&) = delete;
+
+ private:
+  struct Task;
+
+  static void Run(void* arg);
+  static void Unscheduled(void* arg);
+
+  // Admits queued compactions while there are free slots.
+  void MaybeAdmit();
+  void Release();
+
+  Env* const env_;
+  const int max_running_compactions_;
+
+  mutable std::mutex mutex_;
+  std::list<Task*> queue_;
+  int running_ = 0;
+};
+
+}  // namespace rocksdb
+
+#endif // ROCKSDB_INCLUDE_ROCKSDB_COMPACTION_SCHEDULER_H
@@ -322,6 +322,12 @@ class DB {
   virtual Iterator* NewIterator(const ReadOptions& options) {
     return NewIterator(options, DefaultColumnFamily());
   }
+  // Releases an iterator returned by NewIterator. Same as deleting it, except that the DB could
+  // keep it to be reused by NewIterator, see DBOptions::max_pooled_iterators.
+  virtual void ReleaseIterator(Iterator* iter) {
+    delete iter;
+  }
+
   // Returns iterators from a consistent database state across multiple
   // column families. Iterators are heap allocated and need to be deleted
   // before the db is deleted
@@ -783,6 +789,12 @@ class DB {
   // Returns the total combined size of all the SST Files in the rocksdb instance.
   virtual uint64_t GetTotalSSTFileSize() { return 0; }
 
+  // Returns a user key of the default column family, that splits the data of its largest SST file
+  // into halves of approximately the same size. Used to pick a key to split the data at.
+  virtual Status GetMiddleKey(std::string* middle_key) {
+    return STATUS(NotSupported, "GetMiddleKey() not supported");
+  }
+
   // Returns a list of all table files with their level, start key
   // and end key
   virtual void GetLiveFilesMetaData(std::vector<LiveFileMetaData>* /*metadata*/) {}
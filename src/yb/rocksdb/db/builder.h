@@ -58,7 +58,8 @@ TableBuilder* NewTableBuilder(const ImmutableCFOptions& options,
                               WritableFileWriter* file,
                               const CompressionType compression_type,
                               const CompressionOptions& compression_opts,
-                              const bool skip_filters = false);
+                              const bool skip_filters = false,
+                              const std::string* compression_dict = nullptr);
 
 TableBuilder* NewTableBuilder(const ImmutableCFOptions& options,
                               const InternalKeyComparator& internal_comparator,
@@ -68,7 +69,8 @@ TableBuilder* NewTableBuilder(const ImmutableCFOptions& options,
                               WritableFileWriter* data_file,
                               const CompressionType compression_type,
                               const CompressionOptions& compression_opts,
-                              const bool skip_filters = false);
+                              const bool skip_filters = false,
+                              const std::string* compression_dict = nullptr);
 
 // Build a Table file from the contents of *iter.  The generated file
 // will be named according to number specified in meta. On success, the rest of
@@ -78,16 +78,17 @@ class CompactedDBImpl : public DBImpl {
     return STATUS(NotSupported, "Not supported in compacted db mode.");
   }
 
+  // Files are never deleted in compacted db mode, so checkpoints can link the live files as is.
   virtual Status DisableFileDeletions() override {
-    return STATUS(NotSupported, "Not supported in compacted db mode.");
+    return Status::OK();
   }
   virtual Status EnableFileDeletions(bool force) override {
-    return STATUS(NotSupported, "Not supported in compacted db mode.");
+    return Status::OK();
   }
-  virtual Status GetLiveFiles(std::vector<std::string>&,
+  virtual Status GetLiveFiles(std::vector<std::string>& live_files,
                               uint64_t* manifest_file_size,
                               bool flush_memtable = true) override {
-    return STATUS(NotSupported, "Not supported in compacted db mode.");
+    return DBImpl::GetLiveFiles(live_files, manifest_file_size, false /* flush_memtable */);
   }
   using DBImpl::Flush;
   virtual Status Flush(const FlushOptions& options,
@@ -504,7 +504,9 @@ bool Compaction::ShouldFormSubcompactions() const {
   if (cfd_->ioptions()->compaction_style == kCompactionStyleLevel) {
     return start_level_ == 0 && !IsOutputLevelEmpty();
   } else if (cfd_->ioptions()->compaction_style == kCompactionStyleUniversal) {
-    return number_levels_ > 1 && output_level_ > 0;
+    // With a single level all sorted runs are in level 0, and subcompaction outputs are grouped
+    // into one sorted run by the compaction picker.
+    return number_levels_ == 1 || output_level_ > 0;
   } else {
     return false;
   }
@@ -61,6 +61,7 @@
 #include "yb/rocksdb/table/merger.h"
 #include "yb/rocksdb/table/table_builder.h"
 #include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/compression.h"
 #include "yb/rocksdb/util/file_reader_writer.h"
 #include "yb/rocksdb/util/iostats_context_imp.h"
 #include "yb/rocksdb/util/log_buffer.h"
@@ -100,6 +101,8 @@ struct CompactionJob::SubcompactionState {
   std::unique_ptr<WritableFileWriter> base_outfile;
   std::unique_ptr<WritableFileWriter> data_outfile;
   std::unique_ptr<TableBuilder> builder;
+  // Dictionary used to compress data blocks of all output files, empty if there is none.
+  std::string compression_dict;
   Output* current_output() {
     if (outputs.empty()) {
       // This subcompaction's outptut could be empty if compaction was aborted
@@ -146,6 +149,7 @@ struct CompactionJob::SubcompactionState {
     base_outfile = std::move(o.base_outfile);
     data_outfile = std::move(o.data_outfile);
     builder = std::move(o.builder);
+    compression_dict = std::move(o.compression_dict);
     total_bytes = std::move(o.total_bytes);
     num_input_records = std::move(o.num_input_records);
     num_output_records = std::move(o.num_output_records);
@@ -390,6 +394,13 @@ void CompactionJob::GenSubcompactionBoundaries() {
           bounds.emplace_back(flevel->files[i].smallest.key);
           bounds.emplace_back(flevel->files[i].largest.key);
         }
+        // With universal compaction level 0 files usually cover the same key range, so also add
+        // keys from inside of each file.
+        if (cfd->ioptions()->compaction_style == kCompactionStyleUniversal) {
+          for (size_t i = 0; i < num_files; i++) {
+            AddBoundaryAnchors(flevel->files[i].fd, &bounds);
+          }
+        }
       } else {
         // For all other levels add the smallest/largest key in the level to
         // encompass the range covered by that level
@@ -439,9 +450,17 @@ void CompactionJob::GenSubcompactionBoundaries() {
 
   // Group the ranges into subcompactions
   const double min_file_fill_percent = 4.0 / 5;
-  uint64_t max_output_files = static_cast<uint64_t>(std::ceil(
-      sum / min_file_fill_percent /
-      cfd->GetCurrentMutableCFOptions()->MaxFileSizeForLevel(out_lvl)));
+  const uint64_t max_file_size = cfd->GetCurrentMutableCFOptions()->MaxFileSizeForLevel(out_lvl);
+  uint64_t max_output_files;
+  if (max_file_size == std::numeric_limits<uint64_t>::max()) {
+    // Output file size is not limited, as for level 0 of universal compaction. Only split
+    // compactions that are considered large, into parts that are large themselves.
+    max_output_files = std::max<uint64_t>(
+        sum / std::max<uint64_t>(db_options_.compaction_size_threshold_bytes, 1), 1);
+  } else {
+    max_output_files = static_cast<uint64_t>(std::ceil(
+        sum / min_file_fill_percent / max_file_size));
+  }
   uint64_t subcompactions =
       std::min({static_cast<uint64_t>(ranges.size()),
                 static_cast<uint64_t>(db_options_.max_subcompactions),
@@ -462,7 +481,16 @@ void CompactionJob::GenSubcompactionBoundaries() {
         continue;
       }
       if (sum >= mean) {
-        boundaries_.emplace_back(ExtractUserKey(ranges[i].range.limit));
+        Slice boundary = ExtractUserKey(ranges[i].range.limit);
+        if (cfd->ioptions()->compaction_filter_factory != nullptr) {
+          boundary = cfd->ioptions()->compaction_filter_factory->SubcompactionBoundary(boundary);
+        }
+        if (boundary.empty() ||
+            (!boundaries_.empty() && cfd_comparator->Compare(boundary, boundaries_.back()) <= 0)) {
+          // Keep adding ranges to this subcompaction.
+          continue;
+        }
+        boundaries_.emplace_back(boundary);
         sizes_.emplace_back(sum);
         subcompactions--;
         sum = 0;
@@ -475,6 +503,32 @@ void CompactionJob::GenSubcompactionBoundaries() {
   }
 }
 
+void CompactionJob::AddBoundaryAnchors(const FileDescriptor& fd, std::vector<Slice>* bounds) {
+  // Enough anchors to split a file into more subcompactions than there are usually threads.
+  constexpr size_t kMaxAnchorsPerFile = 128;
+
+  auto* cfd = compact_->compaction->column_family_data();
+  Cache::Handle* handle = nullptr;
+  Status s = cfd->table_cache()->FindTable(env_options_, cfd->internal_comparator(), fd, &handle,
+                                           kDefaultQueryId);
+  std::vector<std::string> anchors;
+  if (s.ok()) {
+    s = cfd->table_cache()->GetTableReaderFromHandle(handle)->ApproximateKeyAnchors(
+        kMaxAnchorsPerFile, &anchors);
+    cfd->table_cache()->ReleaseHandle(handle);
+  }
+  if (!s.ok()) {
+    RLOG(InfoLogLevel::WARN_LEVEL, db_options_.info_log,
+        "[%s] [JOB %d] Failed to get key anchors of file %" PRIu64 ": %s",
+        cfd->GetName().c_str(), job_id_, fd.GetNumber(), s.ToString().c_str());
+    return;
+  }
+  for (auto& anchor : anchors) {
+    boundary_anchors_.push_back(std::move(anchor));
+    bounds->emplace_back(boundary_anchors_.back());
+  }
+}
+
 Status CompactionJob::Run() {
   AutoThreadOperationStageUpdater stage_updater(
       ThreadStatus::STAGE_COMPACTION_RUN);
@@ -614,6 +668,52 @@ Status CompactionJob::Install(const MutableCFOptions& mutable_cf_options) {
   return status;
 }
 
+void CompactionJob::BuildSubcompactionCompressionDict(SubcompactionState* sub_compact) {
+  // Amount of input sampled to train the dictionary, relative to the dictionary size.
+  constexpr size_t kSampleBytesPerDictByte = 100;
+
+  ColumnFamilyData* cfd = sub_compact->compaction->column_family_data();
+  const size_t max_dict_bytes = cfd->ioptions()->compression_opts.max_dict_bytes;
+  if (max_dict_bytes == 0 ||
+      !CompressionTypeSupportsDictionary(sub_compact->compaction->output_compression())) {
+    return;
+  }
+
+  std::unique_ptr<InternalIterator> input(
+      versions_->MakeInputIterator(sub_compact->compaction));
+  if (sub_compact->start != nullptr) {
+    IterKey start_iter;
+    start_iter.SetInternalKey(*sub_compact->start, kMaxSequenceNumber, kValueTypeForSeek);
+    input->Seek(start_iter.GetKey());
+  } else {
+    input->SeekToFirst();
+  }
+
+  const size_t max_sample_bytes = max_dict_bytes * kSampleBytesPerDictByte;
+  std::string samples;
+  std::vector<size_t> sample_sizes;
+  for (; input->Valid() && samples.size() < max_sample_bytes; input->Next()) {
+    if (sub_compact->end != nullptr &&
+        cfd->user_comparator()->Compare(ExtractUserKey(input->key()), *sub_compact->end) >= 0) {
+      break;
+    }
+    const size_t old_size = samples.size();
+    samples.append(input->key().cdata(), input->key().size());
+    samples.append(input->value().cdata(), input->value().size());
+    sample_sizes.push_back(samples.size() - old_size);
+  }
+  if (!input->status().ok() || samples.empty()) {
+    // Compaction itself will report the error, and works fine without a dictionary.
+    return;
+  }
+
+  sub_compact->compression_dict = BuildCompressionDictionary(samples, sample_sizes, max_dict_bytes);
+  RLOG(InfoLogLevel::INFO_LEVEL, db_options_.info_log,
+      "[%s] [JOB %d] Built %" ROCKSDB_PRIszt " bytes compression dictionary from %"
+      ROCKSDB_PRIszt " bytes of samples",
+      cfd->GetName().c_str(), job_id_, sub_compact->compression_dict.size(), samples.size());
+}
+
 void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   assert(sub_compact != nullptr);
   std::unique_ptr<InternalIterator> input(
@@ -656,6 +756,8 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
 
   TEST_SYNC_POINT("CompactionJob::Run():Inprogress");
 
+  BuildSubcompactionCompressionDict(sub_compact);
+
   Slice* start = sub_compact->start;
   Slice* end = sub_compact->end;
   if (start != nullptr) {
@@ -1062,7 +1164,8 @@ Status CompactionJob::OpenCompactionOutputFile(
       cfd->int_tbl_prop_collector_factories(), cfd->GetID(),
       sub_compact->base_outfile.get(), sub_compact->data_outfile.get(),
       sub_compact->compaction->output_compression(), cfd->ioptions()->compression_opts,
-      skip_filters));
+      skip_filters,
+      sub_compact->compression_dict.empty() ? nullptr : &sub_compact->compression_dict));
   LogFlush(db_options_.info_log);
   return s;
 }
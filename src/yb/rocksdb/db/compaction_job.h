@@ -106,6 +106,11 @@ class CompactionJob {
   // Call compaction filter. Then iterate through input and compact the
   // kv-pairs
   void ProcessKeyValueCompaction(SubcompactionState* sub_compact);
+  // Adds keys from inside of the given input file to the potential subcompaction boundaries.
+  void AddBoundaryAnchors(const FileDescriptor& fd, std::vector<Slice>* bounds);
+  // Samples the beginning of the subcompaction input and stores a compression dictionary trained
+  // on it in sub_compact, if the output compression supports dictionaries.
+  void BuildSubcompactionCompressionDict(SubcompactionState* sub_compact);
 
   Status FinishCompactionOutputFile(const Status& input_status,
                                     SubcompactionState* sub_compact);
@@ -168,6 +173,8 @@ class CompactionJob {
   bool bottommost_level_;
   bool paranoid_file_checks_;
   bool measure_io_stats_;
+  // Keys read from the input files to be used as potential subcompaction boundaries.
+  std::deque<std::string> boundary_anchors_;
   // Stores the Slices that designate the boundaries for each subcompaction
   std::vector<Slice> boundaries_;
   // Stores the approx size of keys covered in the range of each subcompaction
@@ -35,6 +35,7 @@
 
 #include <gflags/gflags.h>
 
+#include "yb/rocksdb/compaction_filter.h"
 #include "yb/rocksdb/db/column_family.h"
 #include "yb/rocksdb/db/filename.h"
 #include "yb/rocksdb/util/log_buffer.h"
@@ -153,6 +154,17 @@ CompressionType GetCompressionType(const ImmutableCFOptions& ioptions,
   }
 }
 
+CompressionType GetUniversalCompressionType(const ImmutableCFOptions& ioptions,
+                                            uint64_t estimated_output_size,
+                                            int level, int base_level,
+                                            const bool enable_compression) {
+  const auto& universal_options = ioptions.compaction_options_universal;
+  if (enable_compression && estimated_output_size <= universal_options.small_output_size_bytes) {
+    return universal_options.small_output_compression;
+  }
+  return GetCompressionType(ioptions, level, base_level, enable_compression);
+}
+
 CompactionPicker::CompactionPicker(const ImmutableCFOptions& ioptions,
                                    const InternalKeyComparator* icmp)
     : ioptions_(ioptions), icmp_(icmp) {}
@@ -1146,20 +1158,61 @@ bool LevelCompactionPicker::PickCompactionBySize(VersionStorageInfo* vstorage,
 bool UniversalCompactionPicker::NeedsCompaction(
     const VersionStorageInfo* vstorage) const {
   const int kLevel0 = 0;
-  return vstorage->CompactionScore(kLevel0) >= 1;
+  if (vstorage->CompactionScore(kLevel0) >= 1) {
+    return true;
+  }
+  std::vector<FileMetaData*> expired_files;
+  return PickExpiredFiles(*vstorage, &expired_files);
+}
+
+bool UniversalCompactionPicker::PickExpiredFiles(
+    const VersionStorageInfo& vstorage, std::vector<FileMetaData*>* expired_files) const {
+  if (ioptions_.compaction_filter_factory == nullptr) {
+    return false;
+  }
+  // Files of the other levels would be older than the level 0 ones.
+  for (int level = 1; level < vstorage.num_levels(); ++level) {
+    if (!vstorage.LevelFiles(level).empty()) {
+      return false;
+    }
+  }
+  const std::vector<FileMetaData*>& level_files = vstorage.LevelFiles(0);
+  const size_t num_expired =
+      ioptions_.compaction_filter_factory->NumExpiredOldestFiles(level_files);
+  assert(num_expired <= level_files.size());
+  // Only a contiguous range of the oldest files could be deleted, otherwise the records they
+  // overwrite could show up again. So we stop at the first file that is being compacted.
+  for (auto it = level_files.rbegin(); it != level_files.rbegin() + num_expired; ++it) {
+    if ((*it)->being_compacted) {
+      break;
+    }
+    expired_files->push_back(*it);
+  }
+  return !expired_files->empty();
 }
 
 struct UniversalCompactionPicker::SortedRun {
   SortedRun(int _level, FileMetaData* _file, uint64_t _size,
             uint64_t _compensated_file_size, bool _being_compacted)
       : level(_level),
-        file(_file),
         size(_size),
         compensated_file_size(_compensated_file_size),
         being_compacted(_being_compacted) {
     assert(compensated_file_size > 0);
     // Allowed either one of level and file.
-    assert((level != 0) != (file != nullptr));
+    assert((level != 0) != (_file != nullptr));
+    if (_file != nullptr) {
+      files.push_back(_file);
+    }
+  }
+
+  // Adds a level 0 file written by the same compaction as the files of this sorted run.
+  void AddFile(FileMetaData* f) {
+    assert(level == 0);
+    files.push_back(f);
+    size += f->fd.GetTotalFileSize();
+    compensated_file_size += f->compensated_file_size;
+    being_compacted = being_compacted || f->being_compacted;
   }
 
   void Dump(char* out_buf, size_t out_buf_size,
@@ -1170,9 +1223,9 @@ struct UniversalCompactionPicker::SortedRun {
                     size_t sorted_run_count) const;
 
   int level;
-  // `file` Will be null for level > 0. For level = 0, the sorted run is
-  // for this file.
-  FileMetaData* file;
+  // `files` will be empty for level > 0. For level = 0, the sorted run is for these files. There
+  // are several of them when they were written by a compaction split into subcompactions.
+  std::vector<FileMetaData*> files;
   // For level > 0, `size` and `compensated_file_size` are sum of sizes all
   // files in the level. `being_compacted` should be the same for all files
   // in a non-zero level. Use the value here.
@@ -1185,7 +1238,8 @@ void UniversalCompactionPicker::SortedRun::Dump(char* out_buf,
                                                 size_t out_buf_size,
                                                 bool print_path) const {
   if (level == 0) {
-    assert(file != nullptr);
+    assert(!files.empty());
+    const FileMetaData* file = files.front();
     if (file->fd.GetPathId() == 0 || !print_path) {
       snprintf(out_buf, out_buf_size, "file %" PRIu64, file->fd.GetNumber());
     } else {
@@ -1202,13 +1256,12 @@ void UniversalCompactionPicker::SortedRun::Dump(char* out_buf,
 void UniversalCompactionPicker::SortedRun::DumpSizeInfo(
     char* out_buf, size_t out_buf_size, size_t sorted_run_count) const {
   if (level == 0) {
-    assert(file != nullptr);
+    assert(!files.empty());
     snprintf(out_buf, out_buf_size,
              "file %" PRIu64 "[%" ROCKSDB_PRIszt
              "] "
              "with size %" PRIu64 " (compensated size %" PRIu64 ")",
-             file->fd.GetNumber(), sorted_run_count, file->fd.GetTotalFileSize(),
-             file->compensated_file_size);
+             files.front()->fd.GetNumber(), sorted_run_count, size, compensated_file_size);
   } else {
     snprintf(out_buf, out_buf_size,
              "level %d[%" ROCKSDB_PRIszt
@@ -1223,10 +1276,17 @@ std::vector<std::vector<UniversalCompactionPicker::SortedRun>>
                                                    const ImmutableCFOptions& ioptions,
                                                    uint64_t max_file_size) {
   std::vector<std::vector<SortedRun>> ret(1);
-  for (FileMetaData* f : vstorage.LevelFiles(0)) {
-    if (f->fd.GetTotalFileSize() <= max_file_size) {
-      ret.back().emplace_back(0, f, f->fd.GetTotalFileSize(), f->compensated_file_size,
-          f->being_compacted);
+  for (const auto& files : vstorage.Level0SortedRuns()) {
+    bool too_large = false;
+    for (FileMetaData* f : files) {
+      too_large = too_large || f->fd.GetTotalFileSize() > max_file_size;
+    }
+    if (!too_large) {
+      ret.back().emplace_back(0, files.front(), files.front()->fd.GetTotalFileSize(),
+          files.front()->compensated_file_size, files.front()->being_compacted);
+      for (size_t i = 1; i < files.size(); ++i) {
+        ret.back().back().AddFile(files[i]);
+      }
     // If last sequence is empty it means that there are multiple too-large-to-compact files in
     // a row. So we just don't start new sequence in this case.
     } else if (!ret.back().empty()) {
@@ -1351,6 +1411,24 @@ Compaction* UniversalCompactionPicker::PickCompaction(
     const MutableCFOptions& mutable_cf_options,
     VersionStorageInfo* vstorage,
     LogBuffer* log_buffer) {
+  std::vector<CompactionInputFiles> expired_inputs(1);
+  expired_inputs[0].level = 0;
+  if (PickExpiredFiles(*vstorage, &expired_inputs[0].files)) {
+    for (const auto* f : expired_inputs[0].files) {
+      char tmp_fsize[16];
+      AppendHumanBytes(f->fd.GetTotalFileSize(), tmp_fsize, sizeof(tmp_fsize));
+      LOG_TO_BUFFER(log_buffer, "[%s] Universal: picking expired file %" PRIu64
+                              " with size %s for deletion",
+                  cf_name.c_str(), f->fd.GetNumber(), tmp_fsize);
+    }
+    Compaction* c = new Compaction(
+        vstorage, mutable_cf_options, std::move(expired_inputs), 0, 0, 0, 0,
+        kNoCompression, {}, /* is manual */ false, vstorage->CompactionScore(0),
+        /* is deletion compaction */ true, CompactionReason::kUniversalExpiredFiles);
+    level0_compactions_in_progress_.insert(c);
+    return c;
+  }
+
   std::vector<std::vector<SortedRun>> sorted_runs = CalculateSortedRuns(
       *vstorage,
       ioptions_,
@@ -1665,8 +1743,12 @@ Compaction* UniversalCompactionPicker::PickCompactionUniversalReadAmp(
   }
 
   uint64_t estimated_total_size = 0;
+  uint64_t estimated_output_size = 0;
   for (unsigned int i = 0; i < first_index_after; i++) {
     estimated_total_size += sorted_runs[i].size;
+    if (i >= start_index) {
+      estimated_output_size += sorted_runs[i].size;
+    }
   }
   uint32_t path_id = GetPathId(ioptions_, estimated_total_size);
   int start_level = sorted_runs[start_index].level;
@@ -1686,8 +1768,8 @@ Compaction* UniversalCompactionPicker::PickCompactionUniversalReadAmp(
   for (size_t i = start_index; i < first_index_after; i++) {
     auto& picking_sr = sorted_runs[i];
     if (picking_sr.level == 0) {
-      FileMetaData* picking_file = picking_sr.file;
-      inputs[0].files.push_back(picking_file);
+      inputs[0].files.insert(
+          inputs[0].files.end(), picking_sr.files.begin(), picking_sr.files.end());
     } else {
       auto& files = inputs[picking_sr.level - start_level].files;
       for (auto* f : vstorage->LevelFiles(picking_sr.level)) {
@@ -1709,7 +1791,8 @@ Compaction* UniversalCompactionPicker::PickCompactionUniversalReadAmp(
   return new Compaction(
       vstorage, mutable_cf_options, std::move(inputs), output_level,
       mutable_cf_options.MaxFileSizeForLevel(output_level), LLONG_MAX, path_id,
-      GetCompressionType(ioptions_, start_level, 1, enable_compression),
+      GetUniversalCompressionType(ioptions_, estimated_output_size, start_level, 1,
+                                  enable_compression),
       /* grandparents */ {}, /* is manual */ false, score,
       false /* deletion_compaction */, compaction_reason);
 }
@@ -1812,8 +1895,8 @@ Compaction* UniversalCompactionPicker::PickCompactionUniversalSizeAmp(
   for (size_t loop = start_index; loop < sorted_runs.size(); loop++) {
     auto& picking_sr = sorted_runs[loop];
     if (picking_sr.level == 0) {
-      FileMetaData* f = picking_sr.file;
-      inputs[0].files.push_back(f);
+      inputs[0].files.insert(
+          inputs[0].files.end(), picking_sr.files.begin(), picking_sr.files.end());
     } else {
       auto& files = inputs[picking_sr.level - start_level].files;
       for (auto* f : vstorage->LevelFiles(picking_sr.level)) {
@@ -1831,7 +1914,8 @@ Compaction* UniversalCompactionPicker::PickCompactionUniversalSizeAmp(
       vstorage->num_levels() - 1,
       mutable_cf_options.MaxFileSizeForLevel(vstorage->num_levels() - 1),
       /* max_grandparent_overlap_bytes */ LLONG_MAX, path_id,
-      GetCompressionType(ioptions_, vstorage->num_levels() - 1, 1),
+      GetUniversalCompressionType(ioptions_, estimated_total_size,
+                                  vstorage->num_levels() - 1, 1),
       /* grandparents */ {}, /* is manual */ false, score,
       false /* deletion_compaction */,
       CompactionReason::kUniversalSizeAmplification);
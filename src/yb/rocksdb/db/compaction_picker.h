@@ -259,6 +259,11 @@ class UniversalCompactionPicker : public CompactionPicker {
  private:
   struct SortedRun;
 
+  // Fills expired_files with the oldest files that could be deleted without being compacted, see
+  // CompactionFilterFactory::NumExpiredOldestFiles(). Returns true if there are such files.
+  bool PickExpiredFiles(const VersionStorageInfo& vstorage,
+                        std::vector<FileMetaData*>* expired_files) const;
+
   Compaction* DoPickCompaction(
       const std::string& cf_name,
       const MutableCFOptions& mutable_cf_options,
@@ -365,6 +370,13 @@ CompressionType GetCompressionType(const ImmutableCFOptions& ioptions,
                                    int level, int base_level,
                                    const bool enable_compression = true);
 
+// Same as GetCompressionType, but also applies
+// CompactionOptionsUniversal::small_output_size_bytes for an output of the given estimated size.
+CompressionType GetUniversalCompressionType(const ImmutableCFOptions& ioptions,
+                                            uint64_t estimated_output_size,
+                                            int level, int base_level,
+                                            const bool enable_compression = true);
+
 }  // namespace rocksdb
 
 #endif // ROCKSDB_DB_COMPACTION_PICKER_H
@@ -474,6 +474,83 @@ TEST_F(CompactionPickerTest, AllowsTrivialMoveUniversal) {
   ASSERT_TRUE(compaction->is_trivial_move());
 }
 
+TEST_F(CompactionPickerTest, UniversalSmallOutputCompression) {
+  const uint64_t kFileSize = 100000;
+
+  ioptions_.compression = kZlibCompression;
+  ioptions_.compaction_options_universal.small_output_size_bytes = 4 * kFileSize;
+  ioptions_.compaction_options_universal.small_output_compression = kNoCompression;
+  UniversalCompactionPicker universal_compaction_picker(ioptions_, &icmp_);
+
+  // Compacting the 4 newest files gives a small output.
+  NewVersionStorage(1, kCompactionStyleUniversal);
+  Add(0, 1U, "150", "200", kFileSize, 0, 500, 550);
+  Add(0, 2U, "201", "250", kFileSize, 0, 401, 450);
+  Add(0, 3U, "260", "300", kFileSize, 0, 260, 300);
+  Add(0, 4U, "301", "350", kFileSize, 0, 101, 150);
+  Add(0, 5U, "100", "350", 100 * kFileSize, 0, 20, 100);
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(
+      universal_compaction_picker.PickCompaction(
+          cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction != nullptr);
+  ASSERT_EQ(4U, compaction->num_input_files(0));
+  ASSERT_EQ(kNoCompression, compaction->output_compression());
+
+  // Compacting 5 files of the same size gives a large output.
+  NewVersionStorage(1, kCompactionStyleUniversal);
+  Add(0, 1U, "150", "200", kFileSize, 0, 500, 550);
+  Add(0, 2U, "201", "250", kFileSize, 0, 401, 450);
+  Add(0, 3U, "260", "300", kFileSize, 0, 260, 300);
+  Add(0, 4U, "301", "350", kFileSize, 0, 101, 150);
+  Add(0, 5U, "100", "350", kFileSize, 0, 20, 100);
+  UpdateVersionStorageInfo();
+
+  compaction.reset(universal_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction != nullptr);
+  ASSERT_EQ(kZlibCompression, compaction->output_compression());
+}
+
+TEST_F(CompactionPickerTest, UniversalSubcompactionOutputsFormOneSortedRun) {
+  const uint64_t kFileSize = 100000;
+
+  UniversalCompactionPicker universal_compaction_picker(ioptions_, &icmp_);
+  NewVersionStorage(1, kCompactionStyleUniversal);
+
+  Add(0, 1U, "150", "200", kFileSize, 0, 500, 550);
+  // Files 2 and 3 were written by subcompactions of one compaction.
+  Add(0, 3U, "200", "300", kFileSize, 0, 301, 449);
+  Add(0, 2U, "100", "199", kFileSize, 0, 300, 450);
+  Add(0, 4U, "100", "300", kFileSize, 0, 100, 200);
+  UpdateVersionStorageInfo();
+
+  auto runs = vstorage_->Level0SortedRuns();
+  ASSERT_EQ(3U, runs.size());
+  ASSERT_EQ(2U, runs[1].size());
+
+  // There are 4 files, but only 3 sorted runs.
+  ASSERT_LT(vstorage_->CompactionScore(0), 1);
+  std::unique_ptr<Compaction> compaction(
+      universal_compaction_picker.PickCompaction(
+          cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction == nullptr);
+
+  NewVersionStorage(1, kCompactionStyleUniversal);
+  Add(0, 5U, "150", "200", kFileSize, 0, 600, 650);
+  Add(0, 1U, "150", "200", kFileSize, 0, 500, 550);
+  Add(0, 3U, "200", "300", kFileSize, 0, 301, 449);
+  Add(0, 2U, "100", "199", kFileSize, 0, 300, 450);
+  Add(0, 4U, "100", "300", kFileSize, 0, 100, 200);
+  UpdateVersionStorageInfo();
+
+  compaction.reset(universal_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction != nullptr);
+  ASSERT_EQ(5U, compaction->num_input_files(0));
+}
+
 TEST_F(CompactionPickerTest, NeedsCompactionFIFO) {
   NewVersionStorage(1, kCompactionStyleFIFO);
   const int kFileCount =
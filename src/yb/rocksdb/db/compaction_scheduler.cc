@@ -0,0 +1,140 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rocksdb/compaction_scheduler.h"
+
+#include <assert.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "yb/rocksdb/env.h"
+
+namespace rocksdb {
+
+struct CompactionScheduler::Task {
+  void (*function)(void*);
+  void* arg;
+  void* tag;
+  void (*unschedule_function)(void*);
+  PriorityFunction priority;
+  std::shared_ptr<CompactionScheduler> scheduler;
+};
+
+CompactionScheduler::CompactionScheduler(Env* env, int max_running_compactions)
+    : env_(env), max_running_compactions_(std::max(max_running_compactions, 1)) {
+  env_->IncBackgroundThreadsIfNeeded(max_running_compactions_, Env::Priority::LOW);
+}
+
+CompactionScheduler::~CompactionScheduler() {
+  assert(queue_.empty());
+  assert(running_ == 0);
+}
+
+void CompactionScheduler::Schedule(void (*function)(void*), void* arg, void* tag,
+                                   void (*unschedule_function)(void*), PriorityFunction priority) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(new Task{
+        function, arg, tag, unschedule_function, std::move(priority), shared_from_this()});
+  }
+  MaybeAdmit();
+}
+
+int CompactionScheduler::UnSchedule(void* tag) {
+  std::vector<Task*> removed;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = queue_.begin(); it != queue_.end();) {
+      if ((*it)->tag == tag) {
+        removed.push_back(*it);
+        it = queue_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  for (auto* task : removed) {
+    if (task->unschedule_function != nullptr) {
+      (*task->unschedule_function)(task->arg);
+    }
+    delete task;
+  }
+  // Slots released by Env::UnSchedule are only reused here, see Unscheduled.
+  MaybeAdmit();
+  return static_cast<int>(removed.size());
+}
+
+int CompactionScheduler::NumRunning() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return running_;
+}
+
+int CompactionScheduler::NumQueued() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return static_cast<int>(queue_.size());
+}
+
+void CompactionScheduler::MaybeAdmit() {
+  std::vector<Task*> admitted;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (running_ < max_running_compactions_ && !queue_.empty()) {
+      auto best = queue_.begin();
+      int64_t best_priority = (*best)->priority();
+      for (auto it = std::next(best); it != queue_.end(); ++it) {
+        const int64_t priority = (*it)->priority();
+        if (priority > best_priority) {
+          best = it;
+          best_priority = priority;
+        }
+      }
+      admitted.push_back(*best);
+      queue_.erase(best);
+      ++running_;
+    }
+  }
+  // Env::Schedule is called without holding mutex_, because the thread pool calls Unscheduled
+  // while holding its own mutex.
+  for (auto* task : admitted) {
+    env_->Schedule(&CompactionScheduler::Run, task, Env::Priority::LOW, task->tag,
+                   &CompactionScheduler::Unscheduled);
+  }
+}
+
+void CompactionScheduler::Release() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    assert(running_ > 0);
+    --running_;
+  }
+  MaybeAdmit();
+}
+
+void CompactionScheduler::Run(void* arg) {
+  std::unique_ptr<Task> task(static_cast<Task*>(arg));
+  (*task->function)(task->arg);
+  task->scheduler->Release();
+}
+
+void CompactionScheduler::Unscheduled(void* arg) {
+  std::unique_ptr<Task> task(static_cast<Task*>(arg));
+  if (task->unschedule_function != nullptr) {
+    (*task->unschedule_function)(task->arg);
+  }
+  // Called under the thread pool mutex, so the slot can't be handed to another compaction here.
+  std::lock_guard<std::mutex> lock(task->scheduler->mutex_);
+  --task->scheduler->running_;
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,180 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+#include "yb/rocksdb/compaction_scheduler.h"
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "yb/rocksdb/env.h"
+#include "yb/rocksdb/util/testharness.h"
+
+namespace rocksdb {
+
+namespace {
+
+// Keeps the scheduled functions in a queue instead of running them, so tests can run them one by
+// one.
+class ManualScheduleEnv : public EnvWrapper {
+ public:
+  ManualScheduleEnv() : EnvWrapper(nullptr) {}
+
+  void Schedule(void (*function)(void*), void* arg, Priority pri, void* tag,
+                void (*unschedule_function)(void*)) override {
+    ASSERT_EQ(Priority::LOW, pri);
+    queue_.push_back({function, arg, tag, unschedule_function});
+  }
+
+  int UnSchedule(void* tag, Priority pri) override {
+    int count = 0;
+    for (auto it = queue_.begin(); it != queue_.end();) {
+      if (it->tag == tag) {
+        (*it->unschedule_function)(it->arg);
+        it = queue_.erase(it);
+        ++count;
+      } else {
+        ++it;
+      }
+    }
+    return count;
+  }
+
+  void IncBackgroundThreadsIfNeeded(int num, Priority pri) override {}
+
+  size_t NumScheduled() const { return queue_.size(); }
+
+  void RunFront() {
+    auto item = queue_.front();
+    queue_.pop_front();
+    (*item.function)(item.arg);
+  }
+
+ private:
+  struct Item {
+    void (*function)(void*);
+    void* arg;
+    void* tag;
+    void (*unschedule_function)(void*);
+  };
+
+  std::deque<Item> queue_;
+};
+
+struct TestCompaction {
+  std::string name;
+  std::vector<std::string>* log;
+};
+
+void RunCompaction(void* arg) {
+  auto* compaction = static_cast<TestCompaction*>(arg);
+  compaction->log->push_back(compaction->name);
+}
+
+void UnscheduleCompaction(void* arg) {
+  auto* compaction = static_cast<TestCompaction*>(arg);
+  compaction->log->push_back("unscheduled " + compaction->name);
+}
+
+CompactionScheduler::PriorityFunction FixedPriority(int64_t priority) {
+  return [priority] { return priority; };
+}
+
+} // namespace
+
+class CompactionSchedulerTest : public testing::Test {
+ protected:
+  void Schedule(TestCompaction* compaction, void* tag,
+                CompactionScheduler::PriorityFunction priority) {
+    scheduler_->Schedule(&RunCompaction, compaction, tag, &UnscheduleCompaction,
+                         std::move(priority));
+  }
+
+  ManualScheduleEnv env_;
+  std::shared_ptr<CompactionScheduler> scheduler_;
+  std::vector<std::string> log_;
+};
+
+TEST_F(CompactionSchedulerTest, AdmitsByPriority) {
+  scheduler_ = std::make_shared<CompactionScheduler>(&env_, 1);
+  int tag1 = 0, tag2 = 0, tag3 = 0;
+  TestCompaction a{"a", &log_}, b{"b", &log_}, c{"c", &log_}, d{"d", &log_};
+  int64_t c_priority = 1;
+
+  Schedule(&a, &tag1, FixedPriority(1));
+  Schedule(&b, &tag2, FixedPriority(5));
+  Schedule(&c, &tag3, [&c_priority] { return c_priority; });
+  Schedule(&d, &tag1, FixedPriority(5));
+  ASSERT_EQ(1, env_.NumScheduled());
+  ASSERT_EQ(1, scheduler_->NumRunning());
+  ASSERT_EQ(3, scheduler_->NumQueued());
+
+  // c becomes the most urgent one while a, that was admitted right away, is running.
+  c_priority = 10;
+  env_.RunFront();
+  ASSERT_EQ(1, env_.NumScheduled());
+  env_.RunFront();
+  // b and d have equal priorities, so they are admitted in FIFO order.
+  env_.RunFront();
+  env_.RunFront();
+  ASSERT_EQ(0, env_.NumScheduled());
+  ASSERT_EQ(0, scheduler_->NumRunning());
+  ASSERT_EQ(0, scheduler_->NumQueued());
+
+  ASSERT_EQ((std::vector<std::string>{"a", "c", "b", "d"}), log_);
+}
+
+TEST_F(CompactionSchedulerTest, LimitsRunningCompactions) {
+  scheduler_ = std::make_shared<CompactionScheduler>(&env_, 2);
+  int tag = 0;
+  TestCompaction a{"a", &log_}, b{"b", &log_}, c{"c", &log_};
+
+  Schedule(&a, &tag, FixedPriority(0));
+  Schedule(&b, &tag, FixedPriority(0));
+  Schedule(&c, &tag, FixedPriority(0));
+  ASSERT_EQ(2, env_.NumScheduled());
+  ASSERT_EQ(1, scheduler_->NumQueued());
+
+  env_.RunFront();
+  ASSERT_EQ(2, env_.NumScheduled());
+  ASSERT_EQ(0, scheduler_->NumQueued());
+  env_.RunFront();
+  env_.RunFront();
+  ASSERT_EQ((std::vector<std::string>{"a", "b", "c"}), log_);
+}
+
+TEST_F(CompactionSchedulerTest, UnSchedule) {
+  scheduler_ = std::make_shared<CompactionScheduler>(&env_, 1);
+  int tag1 = 0, tag2 = 0;
+  TestCompaction a{"a", &log_}, b{"b", &log_}, c{"c", &log_};
+
+  Schedule(&a, &tag1, FixedPriority(0));
+  Schedule(&b, &tag1, FixedPriority(0));
+  Schedule(&c, &tag2, FixedPriority(0));
+
+  // Same order as in DB shutdown: the admitted compaction is removed from the Env first.
+  ASSERT_EQ(1, env_.UnSchedule(&tag1, Env::Priority::LOW));
+  ASSERT_EQ(0, scheduler_->NumRunning());
+  ASSERT_EQ(1, scheduler_->UnSchedule(&tag1));
+  ASSERT_EQ(1, scheduler_->NumRunning());
+  ASSERT_EQ(0, scheduler_->NumQueued());
+
+  env_.RunFront();
+  ASSERT_EQ((std::vector<std::string>{"unscheduled a", "unscheduled b", "c"}), log_);
+}
+
+}  // namespace rocksdb
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
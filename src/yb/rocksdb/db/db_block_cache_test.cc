@@ -24,6 +24,9 @@
 #include <gflags/gflags.h>
 #include "yb/rocksdb/db/db_test_util.h"
 #include "yb/rocksdb/port/stack_trace.h"
+#include "yb/rocksdb/table/secondary_block_cache.h"
+
+#include "yb/util/cache.h"
 
 DECLARE_double(cache_single_touch_ratio);
 
@@ -248,6 +251,58 @@ TEST_F(DBBlockCacheTest, TestWithCompressedBlockCache) {
   delete iter;
   iter = nullptr;
 }
+
+TEST_F(DBBlockCacheTest, TestWithSecondaryBlockCache) {
+  constexpr size_t kCacheSize = 1 << 20;
+  ReadOptions read_options;
+  auto table_options = GetTableOptions();
+  auto options = GetOptions(table_options);
+  options.compression = CompressionType::kSnappyCompression;
+  InitTable(options);
+
+  std::shared_ptr<Cache> cache = NewLRUCache(kCacheSize, 0, false);
+  std::unique_ptr<yb::Cache> backing_cache(
+      yb::NewLRUCache(yb::DRAM_CACHE, kCacheSize, "db_block_cache_test"));
+  std::shared_ptr<Cache> secondary_cache =
+      NewSecondaryBlockCache(std::move(backing_cache), kCacheSize);
+  table_options.block_cache = cache;
+  table_options.block_cache_compressed = secondary_cache;
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  Reopen(options);
+  RecordCacheCounters(options);
+
+  auto read_all_blocks = [this, &read_options]() {
+    for (size_t i = 0; i < kNumBlocks; i++) {
+      std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+      iter->Seek(ToString(i));
+      ASSERT_OK(iter->status());
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(std::string(kValueSize, 'a'), iter->value().ToString());
+    }
+  };
+
+  // Blocks read from disk are added to both tiers.
+  ASSERT_NO_FATAL_FAILURE(read_all_blocks());
+  CheckCacheCounters(options, kNumBlocks, 0, kNumBlocks, 0);
+  CheckCompressedCacheCounters(options, kNumBlocks, 0, kNumBlocks, 0);
+  ASSERT_LT(0, secondary_cache->GetUsage());
+  ASSERT_EQ(0, secondary_cache->GetPinnedUsage());
+
+  // Drop everything from the uncompressed block cache. Blocks are now found in the secondary
+  // cache and promoted back.
+  cache->SetCapacity(0);
+  ASSERT_EQ(0, cache->GetUsage());
+  cache->SetCapacity(kCacheSize);
+  ASSERT_NO_FATAL_FAILURE(read_all_blocks());
+  CheckCacheCounters(options, kNumBlocks, 0, kNumBlocks, 0);
+  CheckCompressedCacheCounters(options, 0, kNumBlocks, 0, 0);
+
+  // Promoted blocks are served by the uncompressed block cache.
+  ASSERT_NO_FATAL_FAILURE(read_all_blocks());
+  CheckCacheCounters(options, 0, kNumBlocks, 0, 0);
+  CheckCompressedCacheCounters(options, 0, 0, 0, 0);
+  ASSERT_EQ(0, secondary_cache->GetPinnedUsage());
+}
 #endif
 
 }  // namespace rocksdb
@@ -36,6 +36,7 @@
 #include <algorithm>
 #include <climits>
 #include <cstdio>
+#include <limits>
 #include <map>
 #include <set>
 #include <stdexcept>
@@ -80,6 +81,7 @@
 #include "yb/rocksdb/port/port.h"
 #include "yb/rocksdb/cache.h"
 #include "yb/rocksdb/compaction_filter.h"
+#include "yb/rocksdb/compaction_scheduler.h"
 #include "yb/rocksdb/db.h"
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/merge_operator.h"
@@ -240,6 +242,9 @@ CompressionType GetCompressionFlush(const ImmutableCFOptions& ioptions) {
   if (ioptions.compaction_style == kCompactionStyleUniversal) {
     can_compress =
         (ioptions.compaction_options_universal.compression_size_percent < 0);
+    if (can_compress && ioptions.compaction_options_universal.small_output_size_bytes > 0) {
+      return ioptions.compaction_options_universal.small_output_compression;
+    }
   } else {
     // For leveled compress when min_level_to_compress == 0.
     can_compress = ioptions.compression_per_level.empty() ||
@@ -307,6 +312,8 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname)
       next_job_id_(1),
       has_unpersisted_data_(false),
       env_options_(db_options_),
+      env_options_for_compaction_(
+          env_->OptimizeForCompactionTableWrite(env_options_, db_options_)),
 #ifndef ROCKSDB_LITE
       wal_manager_(db_options_, env_options_),
 #endif  // ROCKSDB_LITE
@@ -317,12 +324,16 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname)
       opened_successfully_(false) {
   env_->GetAbsolutePath(dbname, &db_absolute_path_);
 
-  // Reserve ten files or so for other uses and give the rest to TableCache.
-  // Give a large number for setting of "infinite" open files.
-  const int table_cache_size = (db_options_.max_open_files == -1) ?
-        4194304 : db_options_.max_open_files - 10;
-  table_cache_ =
-      NewLRUCache(table_cache_size, db_options_.table_cache_numshardbits);
+  if (db_options_.table_cache) {
+    table_cache_ = TableCache::NewSharedCacheView(db_options_.table_cache);
+  } else {
+    // Reserve ten files or so for other uses and give the rest to TableCache.
+    // Give a large number for setting of "infinite" open files.
+    const int table_cache_size = (db_options_.max_open_files == -1) ?
+          4194304 : db_options_.max_open_files - 10;
+    table_cache_ =
+        NewLRUCache(table_cache_size, db_options_.table_cache_numshardbits);
+  }
 
   versions_.reset(new VersionSet(dbname_, &db_options_, env_options_,
                                  table_cache_.get(), &write_buffer_,
@@ -375,11 +386,15 @@ DBImpl::~DBImpl() {
     versions_->GetColumnFamilySet()->FreeDeadColumnFamilies();
   }
   mutex_.Unlock();
+  ClearIteratorPool();
   // CancelAllBackgroundWork called with false means we just set the shutdown
   // marker. After this we do a variant of the waiting and unschedule work
   // (to consider: moving all the waiting into CancelAllBackgroundWork(true))
   CancelAllBackgroundWork(false);
   int compactions_unscheduled = env_->UnSchedule(this, Env::Priority::LOW);
+  if (db_options_.compaction_scheduler) {
+    compactions_unscheduled += db_options_.compaction_scheduler->UnSchedule(this);
+  }
   int flushes_unscheduled = env_->UnSchedule(this, Env::Priority::HIGH);
   mutex_.Lock();
   bg_compaction_scheduled_ -= compactions_unscheduled;
@@ -1557,7 +1572,7 @@ Status DBImpl::FlushMemTableToOutputFile(
       snapshots_.GetAll(&earliest_write_conflict_snapshot);
 
   FlushJob flush_job(
-      dbname_, cfd, db_options_, mutable_cf_options, env_options_,
+      dbname_, cfd, db_options_, mutable_cf_options, env_options_for_compaction_,
       versions_.get(), &mutex_, &shutting_down_, snapshot_seqs,
       earliest_write_conflict_snapshot, job_context, log_buffer,
       directories_.GetDbDir(), directories_.GetDataDir(0U),
@@ -1591,7 +1606,8 @@ Status DBImpl::FlushMemTableToOutputFile(
     bg_error_ = s;
   }
   RecordFlushIOStats();
-  if (s.ok()) {
+  // Nothing was written when the flush filter rejected the oldest memtable.
+  if (s.ok() && file_meta.fd.GetNumber() != 0) {
     MAYBE_FAULT(FLAGS_fault_crash_after_rocksdb_flush);
 #ifndef ROCKSDB_LITE
     // may temporarily unlock and lock the mutex.
@@ -1628,6 +1644,43 @@ uint64_t DBImpl::GetTotalSSTFileSize() {
   return total_sst_file_size;
 }
 
+Status DBImpl::GetMiddleKey(std::string* middle_key) {
+  auto* cfd = default_cf_handle_->cfd();
+  SuperVersion* sv = GetAndRefSuperVersion(cfd);
+  const auto* storage_info = sv->current->storage_info();
+  FileMetaData* largest_file = nullptr;
+  for (int level = 0; level < storage_info->num_non_empty_levels(); ++level) {
+    for (auto* file : storage_info->LevelFiles(level)) {
+      if (!largest_file ||
+          file->fd.GetTotalFileSize() > largest_file->fd.GetTotalFileSize()) {
+        largest_file = file;
+      }
+    }
+  }
+
+  Status s;
+  std::vector<std::string> anchors;
+  if (largest_file) {
+    Cache::Handle* handle = nullptr;
+    s = cfd->table_cache()->FindTable(env_options_, cfd->internal_comparator(), largest_file->fd,
+                                      &handle, kDefaultQueryId);
+    if (s.ok()) {
+      // Anchors split the file into two ranges, the last one is the last key of the file.
+      s = cfd->table_cache()->GetTableReaderFromHandle(handle)->ApproximateKeyAnchors(
+          2, &anchors);
+      cfd->table_cache()->ReleaseHandle(handle);
+    }
+  }
+  ReturnAndCleanupSuperVersion(cfd, sv);
+  RETURN_NOT_OK(s);
+
+  if (anchors.size() < 2) {
+    return STATUS(Incomplete, "Not enough data to get the middle key");
+  }
+  *middle_key = ExtractUserKey(anchors.front()).ToBuffer();
+  return Status::OK();
+}
+
 void DBImpl::SetTotalSSTFileSizeTicker() {
   uint64_t total_sst_file_size = GetTotalSSTFileSize();
   SetTickerCount(stats_, TOTAL_SST_FILE_SIZE, total_sst_file_size);
@@ -1942,7 +1995,7 @@ Status DBImpl::CompactFilesImpl(
 
   assert(is_snapshot_supported_ || snapshots_.empty());
   CompactionJob compaction_job(
-      job_context->job_id, c.get(), db_options_, env_options_, versions_.get(),
+      job_context->job_id, c.get(), db_options_, env_options_for_compaction_, versions_.get(),
       &shutting_down_, log_buffer, directories_.GetDbDir(),
       directories_.GetDataDir(c->output_path_id()), stats_, &mutex_, &bg_error_,
       snapshot_seqs, earliest_write_conflict_snapshot, table_cache_,
@@ -2287,6 +2340,10 @@ Status DBImpl::SyncWAL() {
   bool need_log_dir_sync;
   uint64_t current_log_number;
 
+  if (db_options_.disable_wal) {
+    return Status::OK();
+  }
+
   {
     InstrumentedMutexLock l(&mutex_);
     assert(!logs_.empty());
@@ -2489,8 +2546,7 @@ Status DBImpl::RunManualCompaction(ColumnFamilyData* cfd, int input_level,
       ca->m = &manual;
       manual.incomplete = false;
       bg_compaction_scheduled_++;
-      env_->Schedule(&DBImpl::BGWorkCompaction, ca, Env::Priority::LOW, this,
-                     &DBImpl::UnscheduleCallback);
+      ScheduleCompactionWork(ca);
       scheduled = true;
     }
   }
@@ -2522,22 +2578,27 @@ InternalIterator* DBImpl::NewInternalIterator(
 Status DBImpl::FlushMemTable(ColumnFamilyData* cfd,
                              const FlushOptions& flush_options) {
   Status s;
+  uint64_t num_memtables_to_flush = 0;
   {
     WriteContext context;
     InstrumentedMutexLock guard_lock(&mutex_);
 
-    if (cfd->imm()->NumNotFlushed() == 0 && cfd->mem()->IsEmpty()) {
+    if (cfd->imm()->NumNotFlushed() == 0 &&
+        (cfd->mem()->IsEmpty() || !flush_options.switch_memtable)) {
       // Nothing to flush
       return Status::OK();
     }
 
-    WriteThread::Writer w;
-    write_thread_.EnterUnbatched(&w, &mutex_);
+    if (flush_options.switch_memtable && !cfd->mem()->IsEmpty()) {
+      WriteThread::Writer w;
+      write_thread_.EnterUnbatched(&w, &mutex_);
 
-    // SwitchMemtable() will release and reacquire mutex
-    // during execution
-    s = SwitchMemtable(cfd, &context);
-    write_thread_.ExitUnbatched(&w);
+      // SwitchMemtable() will release and reacquire mutex
+      // during execution
+      s = SwitchMemtable(cfd, &context);
+      write_thread_.ExitUnbatched(&w);
+    }
+    num_memtables_to_flush = cfd->imm()->NumAdded();
 
     cfd->imm()->FlushRequested();
 
@@ -2548,7 +2609,24 @@ Status DBImpl::FlushMemTable(ColumnFamilyData* cfd,
 
   if (s.ok() && flush_options.wait) {
     // Wait until the compaction completes
-    s = WaitForFlushMemTable(cfd);
+    s = WaitForFlushMemTable(cfd, num_memtables_to_flush);
+  }
+  return s;
+}
+
+Status DBImpl::WaitForFlushMemTable(ColumnFamilyData* cfd, uint64_t num_memtables_to_flush) {
+  Status s;
+  // Memtables added later could be rejected by the flush filter, so only wait for the ones that
+  // were added before the flush was requested.
+  InstrumentedMutexLock l(&mutex_);
+  while (cfd->imm()->NumFlushedTotal() < num_memtables_to_flush && bg_error_.ok()) {
+    if (shutting_down_.load(std::memory_order_acquire)) {
+      return STATUS(ShutdownInProgress, "");
+    }
+    bg_cv_.Wait();
+  }
+  if (!bg_error_.ok()) {
+    s = bg_error_;
   }
   return s;
 }
@@ -2628,6 +2706,10 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
     return;
   }
 
+  if (db_options_.compaction_scheduler) {
+    UpdateCompactionPriority();
+  }
+
   while (bg_compaction_scheduled_ < bg_compactions_allowed &&
          unscheduled_compactions_ > 0) {
     CompactionArg* ca = new CompactionArg;
@@ -2635,9 +2717,52 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
     ca->m = nullptr;
     bg_compaction_scheduled_++;
     unscheduled_compactions_--;
+    ScheduleCompactionWork(ca);
+  }
+}
+
+void DBImpl::ScheduleCompactionWork(CompactionArg* ca) {
+  mutex_.AssertHeld();
+  if (!db_options_.compaction_scheduler) {
     env_->Schedule(&DBImpl::BGWorkCompaction, ca, Env::Priority::LOW, this,
                    &DBImpl::UnscheduleCallback);
+    return;
+  }
+  CompactionScheduler::PriorityFunction priority;
+  if (ca->m != nullptr) {
+    // Manual compactions were explicitly requested, so they don't wait behind automatic ones.
+    priority = [] { return std::numeric_limits<int64_t>::max(); };
+  } else {
+    priority = [this] { return compaction_priority_.load(std::memory_order_relaxed); };
+  }
+  db_options_.compaction_scheduler->Schedule(
+      &DBImpl::BGWorkCompaction, ca, this, &DBImpl::UnscheduleCallback, std::move(priority));
+}
+
+void DBImpl::UpdateCompactionPriority() {
+  mutex_.AssertHeld();
+  // The priority combines the write stall risk, i.e. how close the number of L0 files (sorted
+  // runs for universal compaction) is to level0_stop_writes_trigger, in permille, and the read
+  // amplification as a tie breaker.
+  constexpr int64_t kMaxReadAmp = 1000;
+  int64_t priority = 0;
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (cfd->IsDropped()) {
+      continue;
+    }
+    const auto* vstorage = cfd->current()->storage_info();
+    const int64_t l0_count = vstorage->l0_delay_trigger_count();
+    const int64_t stop_trigger =
+        std::max(cfd->GetLatestMutableCFOptions()->level0_stop_writes_trigger, 1);
+    int64_t stall_risk = l0_count * 1000 / stop_trigger;
+    if (write_controller_.IsStopped()) {
+      stall_risk = std::max<int64_t>(stall_risk, 1000);
+    }
+    const int64_t read_amp = std::min(
+        l0_count + std::max(vstorage->num_non_empty_levels() - 1, 0), kMaxReadAmp - 1);
+    priority = std::max(priority, stall_risk * kMaxReadAmp + read_amp);
   }
+  compaction_priority_.store(priority, std::memory_order_relaxed);
 }
 
 int DBImpl::BGCompactionsAllowed() const {
@@ -2864,6 +2989,13 @@ void DBImpl::BackgroundCallFlush() {
       mutex_.Lock();
     }
 
+    if (made_progress && db_options_.max_pooled_iterators != 0) {
+      // The kept iterators could pin the flushed memtables.
+      mutex_.Unlock();
+      ClearIteratorPool(/* keep_tailing */ true);
+      mutex_.Lock();
+    }
+
     assert(num_running_flushes_ > 0);
     num_running_flushes_--;
     bg_flush_scheduled_--;
@@ -3090,7 +3222,8 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
     assert(c->num_input_files(1) == 0);
     assert(c->level() == 0);
     assert(c->column_family_data()->ioptions()->compaction_style ==
-           kCompactionStyleFIFO);
+           kCompactionStyleFIFO ||
+           c->compaction_reason() == CompactionReason::kUniversalExpiredFiles);
 
     compaction_job_stats.num_input_files = c->num_input_files(0);
 
@@ -3176,7 +3309,7 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
 
     assert(is_snapshot_supported_ || snapshots_.empty());
     CompactionJob compaction_job(
-        job_context->job_id, c.get(), db_options_, env_options_,
+        job_context->job_id, c.get(), db_options_, env_options_for_compaction_,
         versions_.get(), &shutting_down_, log_buffer, directories_.GetDbDir(),
         directories_.GetDataDir(c->output_path_id()), stats_, &mutex_,
         &bg_error_, snapshot_seqs, earliest_write_conflict_snapshot,
@@ -4109,6 +4242,30 @@ bool DBImpl::KeyMayExist(const ReadOptions& read_options,
   return s.ok() || s.IsIncomplete();
 }
 
+namespace {
+
+// Whether an iterator tree built with read_options could be reused for other reads. The file
+// filters are specific to the read, e.g. to its key.
+bool ReusableIteratorTree(const ReadOptions& read_options) {
+  return read_options.file_filter == nullptr && read_options.table_aware_file_filter == nullptr &&
+         read_options.iterate_upper_bound == nullptr && !read_options.pin_data;
+}
+
+// Whether iterator trees built with lhs and rhs read the same records in the same way.
+bool SameIteratorRecords(const ReadOptions& lhs, const ReadOptions& rhs) {
+  return ReusableIteratorTree(lhs) && ReusableIteratorTree(rhs) &&
+         lhs.verify_checksums == rhs.verify_checksums && lhs.fill_cache == rhs.fill_cache &&
+         lhs.read_tier == rhs.read_tier && lhs.total_order_seek == rhs.total_order_seek &&
+         lhs.prefix_same_as_start == rhs.prefix_same_as_start;
+}
+
+// Whether an iterator tree built with lhs could be used to read with rhs.
+bool SameIteratorTree(const ReadOptions& lhs, const ReadOptions& rhs) {
+  return SameIteratorRecords(lhs, rhs) && lhs.query_id == rhs.query_id;
+}
+
+} // namespace
+
 Iterator* DBImpl::NewIterator(const ReadOptions& read_options,
                               ColumnFamilyHandle* column_family) {
   if (read_options.read_tier == kPersistedTier) {
@@ -4140,25 +4297,62 @@ Iterator* DBImpl::NewIterator(const ReadOptions& read_options,
     // not supported in lite version
     return nullptr;
 #else
+    // A tailing iterator renews the parts of its tree that changed on each seek, so a pooled one
+    // is reused whatever super version it was built from. Consumers polling the newest records
+    // only pay for the memtables and files written since their previous poll.
+    ArenaWrappedDBIter* db_iter = nullptr;
+    if (db_options_.max_pooled_iterators != 0) {
+      db_iter = TakePooledIterator(cfd, /* tailing */ true);
+      if (db_iter != nullptr && db_iter->initialized()) {
+        if (SameIteratorRecords(db_iter->read_options(), read_options)) {
+          return db_iter;
+        }
+        db_iter->Reset();
+      }
+    }
+    if (db_iter == nullptr) {
+      db_iter = new ArenaWrappedDBIter();
+    }
     SuperVersion* sv = cfd->GetReferencedSuperVersion(&mutex_);
-    auto iter = new ForwardIterator(this, read_options, cfd, sv);
-    return NewDBIterator(
-        env_, *cfd->ioptions(), cfd->user_comparator(), iter,
-        kMaxSequenceNumber,
+    db_iter->Init(
+        env_, *cfd->ioptions(), cfd->user_comparator(), kMaxSequenceNumber,
         sv->mutable_cf_options.max_sequential_skip_in_iterations,
         sv->version_number, read_options.iterate_upper_bound,
         read_options.prefix_same_as_start, read_options.pin_data);
+    auto* mem = db_iter->GetArena()->AllocateAligned(sizeof(ForwardIterator));
+    auto* iter = new (mem) ForwardIterator(this, read_options, cfd, sv);
+    db_iter->SetIterUnderDBIter(iter);
+    db_iter->SetTailingIter(iter);
+    if (db_options_.max_pooled_iterators != 0) {
+      db_iter->SetPoolInfo(cfd, read_options);
+    }
+    return db_iter;
 #endif
   } else {
     SequenceNumber latest_snapshot = versions_->LastSequence();
-    SuperVersion* sv = cfd->GetReferencedSuperVersion(&mutex_);
-
     auto snapshot =
         read_options.snapshot != nullptr
             ? reinterpret_cast<const SnapshotImpl*>(
                 read_options.snapshot)->number_
             : latest_snapshot;
 
+    ArenaWrappedDBIter* db_iter = nullptr;
+    if (db_options_.max_pooled_iterators != 0) {
+      db_iter = TakePooledIterator(cfd, /* tailing */ false);
+      // The super version is checked after reading the last sequence, so the memtables of the
+      // kept iterators contain all the records up to it.
+      if (db_iter != nullptr && db_iter->initialized()) {
+        if (db_iter->version_number() == cfd->GetSuperVersionNumber() &&
+            SameIteratorTree(db_iter->read_options(), read_options)) {
+          db_iter->SetSequence(snapshot);
+          return db_iter;
+        }
+        db_iter->Reset();
+      }
+    }
+
+    SuperVersion* sv = cfd->GetReferencedSuperVersion(&mutex_);
+
     // Try to generate a DB iterator tree in continuous memory area to be
     // cache friendly. Here is an example of result:
     // +-------------------------------+
@@ -4201,7 +4395,10 @@ Iterator* DBImpl::NewIterator(const ReadOptions& read_options,
     // Laying out the iterators in the order of being accessed makes it more
     // likely that any iterator pointer is close to the iterator it points to so
     // that they are likely to be in the same cache line and/or page.
-    ArenaWrappedDBIter* db_iter = NewArenaWrappedDbIterator(
+    if (db_iter == nullptr) {
+      db_iter = new ArenaWrappedDBIter();
+    }
+    db_iter->Init(
         env_, *cfd->ioptions(), cfd->user_comparator(), snapshot,
         sv->mutable_cf_options.max_sequential_skip_in_iterations,
         sv->version_number, read_options.iterate_upper_bound,
@@ -4210,6 +4407,9 @@ Iterator* DBImpl::NewIterator(const ReadOptions& read_options,
     InternalIterator* internal_iter =
         NewInternalIterator(read_options, cfd, sv, db_iter->GetArena());
     db_iter->SetIterUnderDBIter(internal_iter);
+    if (db_options_.max_pooled_iterators != 0) {
+      db_iter->SetPoolInfo(cfd, read_options);
+    }
 
     return db_iter;
   }
@@ -4217,6 +4417,72 @@ Iterator* DBImpl::NewIterator(const ReadOptions& read_options,
   return nullptr;
 }
 
+void DBImpl::ReleaseIterator(Iterator* iter) {
+  auto* db_iter = dynamic_cast<ArenaWrappedDBIter*>(iter);
+  if (db_iter == nullptr || db_iter->cfd() == nullptr) {
+    delete iter;
+    return;
+  }
+  // Only keep the iterator trees that could be reused as is, and only while they are current, so
+  // the pool does not pin obsolete memtables and files. Tailing iterators catch up with the current
+  // super version on their next seek, and after flushes, see ClearIteratorPool.
+  if (db_iter->initialized() &&
+      (!ReusableIteratorTree(db_iter->read_options()) || !db_iter->status().ok() ||
+       (db_iter->tailing_iter() == nullptr &&
+        db_iter->version_number() != db_iter->cfd()->GetSuperVersionNumber()))) {
+    db_iter->Reset();
+  }
+  {
+    std::lock_guard<std::mutex> lock(iterator_pool_mutex_);
+    if (iterator_pool_.size() < db_options_.max_pooled_iterators) {
+      iterator_pool_.push_back(db_iter);
+      return;
+    }
+  }
+  delete db_iter;
+}
+
+ArenaWrappedDBIter* DBImpl::TakePooledIterator(ColumnFamilyData* cfd, bool tailing) {
+  std::lock_guard<std::mutex> lock(iterator_pool_mutex_);
+  for (auto it = iterator_pool_.rbegin(); it != iterator_pool_.rend(); ++it) {
+    if ((*it)->cfd() == cfd &&
+        (!(*it)->initialized() || ((*it)->tailing_iter() != nullptr) == tailing)) {
+      auto* result = *it;
+      iterator_pool_.erase(std::next(it).base());
+      return result;
+    }
+  }
+  return nullptr;
+}
+
+void DBImpl::ClearIteratorPool(bool keep_tailing) {
+  std::vector<ArenaWrappedDBIter*> iterators;
+  {
+    std::lock_guard<std::mutex> lock(iterator_pool_mutex_);
+    iterators.swap(iterator_pool_);
+  }
+  std::vector<ArenaWrappedDBIter*> kept;
+  for (auto* iter : iterators) {
+    if (keep_tailing && iter->tailing_iter() != nullptr) {
+      iter->tailing_iter()->RenewIfStale();
+      kept.push_back(iter);
+    } else {
+      delete iter;
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(iterator_pool_mutex_);
+    while (!kept.empty() && iterator_pool_.size() < db_options_.max_pooled_iterators) {
+      iterator_pool_.push_back(kept.back());
+      kept.pop_back();
+    }
+  }
+  // Released iterators could have filled the pool meanwhile.
+  for (auto* iter : kept) {
+    delete iter;
+  }
+}
+
 Status DBImpl::NewIterators(
     const ReadOptions& read_options,
     const std::vector<ColumnFamilyHandle*>& column_families,
@@ -4370,6 +4636,13 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
   if (write_options.timeout_hint_us != 0) {
     return STATUS(InvalidArgument, "timeout_hint_us is deprecated");
   }
+  if (db_options_.disable_wal && !write_options.disableWAL) {
+    // There are no log files to write to.
+    WriteOptions no_wal_write_options = write_options;
+    no_wal_write_options.disableWAL = true;
+    no_wal_write_options.sync = false;
+    return WriteImpl(no_wal_write_options, my_batch, callback);
+  }
 
   Status status;
 
@@ -4453,6 +4726,7 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
                                     ? 4 * max_total_in_memory_state_
                                     : db_options_.max_total_wal_size;
   if (UNLIKELY(!single_column_family_mode_ &&
+               !alive_log_files_.empty() &&
                alive_log_files_.begin()->getting_flushed == false &&
                total_log_size() > max_total_wal_size)) {
     uint64_t flush_column_family_if_log_file = alive_log_files_.begin()->number;
@@ -5695,23 +5969,27 @@ Status DB::Open(const DBOptions& db_options, const std::string& dbname,
   s = impl->Recover(column_families);
   if (s.ok()) {
     uint64_t new_log_number = impl->versions_->NewFileNumber();
-    unique_ptr<WritableFile> lfile;
-    EnvOptions soptions(db_options);
-    EnvOptions opt_env_options =
-        impl->db_options_.env->OptimizeForLogWrite(soptions, impl->db_options_);
-    s = NewWritableFile(impl->db_options_.env,
-                        LogFileName(impl->db_options_.wal_dir, new_log_number),
-                        &lfile, opt_env_options);
+    impl->logfile_number_ = new_log_number;
+    // Without the WAL the log number is only used to tell which log files were recovered.
+    if (!impl->db_options_.disable_wal) {
+      unique_ptr<WritableFile> lfile;
+      EnvOptions soptions(db_options);
+      EnvOptions opt_env_options =
+          impl->db_options_.env->OptimizeForLogWrite(soptions, impl->db_options_);
+      s = NewWritableFile(impl->db_options_.env,
+                          LogFileName(impl->db_options_.wal_dir, new_log_number),
+                          &lfile, opt_env_options);
+      if (s.ok()) {
+        lfile->SetPreallocationBlockSize((max_write_buffer_size / 10) + max_write_buffer_size);
+        unique_ptr<WritableFileWriter> file_writer(
+            new WritableFileWriter(std::move(lfile), opt_env_options));
+        impl->logs_.emplace_back(
+            new_log_number,
+            new log::Writer(std::move(file_writer), new_log_number,
+                            impl->db_options_.recycle_log_file_num > 0));
+      }
+    }
     if (s.ok()) {
-      lfile->SetPreallocationBlockSize((max_write_buffer_size / 10) + max_write_buffer_size);
-      impl->logfile_number_ = new_log_number;
-      unique_ptr<WritableFileWriter> file_writer(
-          new WritableFileWriter(std::move(lfile), opt_env_options));
-      impl->logs_.emplace_back(
-          new_log_number,
-          new log::Writer(std::move(file_writer), new_log_number,
-                          impl->db_options_.recycle_log_file_num > 0));
-
       // set column family handles
       for (auto cf : column_families) {
         auto cfd =
@@ -5743,8 +6021,10 @@ Status DB::Open(const DBOptions& db_options, const std::string& dbname,
       for (auto cfd : *impl->versions_->GetColumnFamilySet()) {
         impl->InstallSuperVersionAndScheduleWork(cfd, nullptr, *cfd->GetLatestMutableCFOptions());
       }
-      impl->alive_log_files_.push_back(
-          DBImpl::LogFileNumberSize(impl->logfile_number_));
+      if (!impl->db_options_.disable_wal) {
+        impl->alive_log_files_.push_back(
+            DBImpl::LogFileNumberSize(impl->logfile_number_));
+      }
       impl->DeleteObsoleteFiles();
       s = impl->directories_.GetDbDir()->Fsync();
     }
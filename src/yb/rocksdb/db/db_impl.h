@@ -30,6 +30,7 @@
 #include <deque>
 #include <limits>
 #include <list>
+#include <mutex>
 #include <set>
 #include <string>
 #include <utility>
@@ -71,6 +72,7 @@ class VersionEdit;
 class VersionSet;
 class Arena;
 class WriteCallback;
+class ArenaWrappedDBIter;
 struct JobContext;
 struct ExternalSstFileInfo;
 
@@ -132,6 +134,7 @@ class DBImpl : public DB {
       const ReadOptions& options,
       const std::vector<ColumnFamilyHandle*>& column_families,
       std::vector<Iterator*>* iterators) override;
+  void ReleaseIterator(Iterator* iter) override;
   virtual const Snapshot* GetSnapshot() override;
   virtual void ReleaseSnapshot(const Snapshot* snapshot) override;
   using DB::GetProperty;
@@ -578,6 +581,9 @@ class DBImpl : public DB {
   // Wait for memtable flushed
   Status WaitForFlushMemTable(ColumnFamilyData* cfd);
 
+  // Wait until the first num_memtables_to_flush memtables added to the immutable list are flushed.
+  Status WaitForFlushMemTable(ColumnFamilyData* cfd, uint64_t num_memtables_to_flush);
+
   void RecordFlushIOStats();
   void RecordCompactionIOStats();
 
@@ -591,12 +597,19 @@ class DBImpl : public DB {
 
   ColumnFamilyData* GetColumnFamilyDataByName(const std::string& cf_name);
 
+  struct CompactionArg;
+
   void MaybeScheduleFlushOrCompaction();
   void SchedulePendingFlush(ColumnFamilyData* cfd);
   void SchedulePendingCompaction(ColumnFamilyData* cfd);
   static void BGWorkCompaction(void* arg);
   static void BGWorkFlush(void* db);
   static void UnscheduleCallback(void* arg);
+  // Schedules a background compaction either directly in the Env or through
+  // db_options_.compaction_scheduler, when it is set.
+  void ScheduleCompactionWork(CompactionArg* ca);
+  // Recalculates compaction_priority_ from the current state of the column families.
+  void UpdateCompactionPriority();
   void BackgroundCallCompaction(void* arg);
   void BackgroundCallFlush();
   Status BackgroundCompaction(bool* madeProgress, JobContext* job_context,
@@ -612,6 +625,8 @@ class DBImpl : public DB {
 
   uint64_t GetTotalSSTFileSize() override;
 
+  Status GetMiddleKey(std::string* middle_key) override;
+
   void SetTotalSSTFileSizeTicker();
 
   void PrintStatistics();
@@ -785,6 +800,19 @@ class DBImpl : public DB {
 
   SnapshotList snapshots_;
 
+  // Returns an iterator of cfd kept by ReleaseIterator, nullptr if there is none. An initialized
+  // iterator is only returned when it is a tailing iterator exactly when tailing is set.
+  ArenaWrappedDBIter* TakePooledIterator(ColumnFamilyData* cfd, bool tailing);
+
+  // Deletes the iterators kept by ReleaseIterator. Should be called without holding mutex_. With
+  // keep_tailing, the tailing iterators are moved to the current super version and kept instead.
+  void ClearIteratorPool(bool keep_tailing = false);
+
+  // Iterators kept by ReleaseIterator to be reused by NewIterator, the most recently released
+  // one last.
+  std::mutex iterator_pool_mutex_;
+  std::vector<ArenaWrappedDBIter*> iterator_pool_;
+
   // For each background job, pending_outputs_ keeps the current file number at
   // the time that background job started.
   // FindObsoleteFiles()/PurgeObsoleteFiles() never deletes any file that has
@@ -865,6 +893,10 @@ class DBImpl : public DB {
     ManualCompaction* m;
   };
 
+  // Priority of the compactions of this DB in db_options_.compaction_scheduler, refreshed under
+  // mutex_ every time compactions are scheduled. Higher values are admitted first.
+  std::atomic<int64_t> compaction_priority_{0};
+
   // Have we encountered a background error in paranoid mode?
   Status bg_error_;
 
@@ -900,6 +932,9 @@ class DBImpl : public DB {
   // The options to access storage files
   const EnvOptions env_options_;
 
+  // The options to write SST files by flushes and compactions.
+  const EnvOptions env_options_for_compaction_;
+
 #ifndef ROCKSDB_LITE
   WalManager wal_manager_;
 #endif  // ROCKSDB_LITE
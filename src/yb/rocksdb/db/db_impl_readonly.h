@@ -97,17 +97,18 @@ class DBImplReadOnly : public DBImpl {
   }
 
 #ifndef ROCKSDB_LITE
+  // Files are never deleted in read only mode, so checkpoints can link the live files as is.
   virtual Status DisableFileDeletions() override {
-    return STATUS(NotSupported, "Not supported operation in read only mode.");
+    return Status::OK();
   }
 
   virtual Status EnableFileDeletions(bool force) override {
-    return STATUS(NotSupported, "Not supported operation in read only mode.");
+    return Status::OK();
   }
-  virtual Status GetLiveFiles(std::vector<std::string>&,
+  virtual Status GetLiveFiles(std::vector<std::string>& live_files,
                               uint64_t* manifest_file_size,
                               bool flush_memtable = true) override {
-    return STATUS(NotSupported, "Not supported operation in read only mode.");
+    return DBImpl::GetLiveFiles(live_files, manifest_file_size, false /* flush_memtable */);
   }
 #endif  // ROCKSDB_LITE
 
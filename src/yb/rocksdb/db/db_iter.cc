@@ -106,6 +106,13 @@ class DBIter: public Iterator {
       iter_->~InternalIterator();
     }
   }
+  void SetSequence(SequenceNumber sequence) {
+    sequence_ = sequence;
+    valid_ = false;
+    direction_ = kForward;
+    status_ = Status::OK();
+  }
+  uint64_t version_number() const { return version_number_; }
   virtual void SetIter(InternalIterator* iter) {
     assert(iter_ == nullptr);
     iter_ = iter;
@@ -210,7 +217,7 @@ class DBIter: public Iterator {
   const Comparator* const user_comparator_;
   const MergeOperator* const user_merge_operator_;
   InternalIterator* iter_;
-  SequenceNumber const sequence_;
+  SequenceNumber sequence_;
 
   Status status_;
   IterKey saved_key_;
@@ -866,7 +873,45 @@ Iterator* NewDBIterator(Env* env, const ImmutableCFOptions& ioptions,
   return db_iter;
 }
 
-ArenaWrappedDBIter::~ArenaWrappedDBIter() { db_iter_->~DBIter(); }
+ArenaWrappedDBIter::~ArenaWrappedDBIter() {
+  if (db_iter_ != nullptr) {
+    db_iter_->~DBIter();
+  }
+}
+
+void ArenaWrappedDBIter::Init(
+    Env* env, const ImmutableCFOptions& ioptions,
+    const Comparator* user_key_comparator, const SequenceNumber& sequence,
+    uint64_t max_sequential_skip_in_iterations, uint64_t version_number,
+    const Slice* iterate_upper_bound, bool prefix_same_as_start,
+    bool pin_data) {
+  assert(db_iter_ == nullptr);
+  auto mem = arena_.AllocateAligned(sizeof(DBIter));
+  db_iter_ = new (mem) DBIter(env, ioptions, user_key_comparator, nullptr, sequence,
+                              true, max_sequential_skip_in_iterations, version_number,
+                              iterate_upper_bound, prefix_same_as_start);
+  if (pin_data) {
+    PinData();
+  }
+}
+
+void ArenaWrappedDBIter::Reset() {
+  if (db_iter_ != nullptr) {
+    db_iter_->~DBIter();
+    db_iter_ = nullptr;
+  }
+  tailing_iter_ = nullptr;
+  arena_.~Arena();
+  new (&arena_) Arena();
+}
+
+void ArenaWrappedDBIter::SetSequence(SequenceNumber sequence) {
+  db_iter_->SetSequence(sequence);
+}
+
+uint64_t ArenaWrappedDBIter::version_number() const {
+  return db_iter_->version_number();
+}
 
 void ArenaWrappedDBIter::SetDBIter(DBIter* iter) { db_iter_ = iter; }
 
@@ -905,18 +950,8 @@ ArenaWrappedDBIter* NewArenaWrappedDbIterator(
     const Slice* iterate_upper_bound, bool prefix_same_as_start,
     bool pin_data) {
   ArenaWrappedDBIter* iter = new ArenaWrappedDBIter();
-  Arena* arena = iter->GetArena();
-  auto mem = arena->AllocateAligned(sizeof(DBIter));
-  DBIter* db_iter =
-      new (mem) DBIter(env, ioptions, user_key_comparator, nullptr, sequence,
-                       true, max_sequential_skip_in_iterations, version_number,
-                       iterate_upper_bound, prefix_same_as_start);
-
-  iter->SetDBIter(db_iter);
-  if (pin_data) {
-    iter->PinData();
-  }
-
+  iter->Init(env, ioptions, user_key_comparator, sequence, max_sequential_skip_in_iterations,
+             version_number, iterate_upper_bound, prefix_same_as_start, pin_data);
   return iter;
 }
 
@@ -33,7 +33,9 @@
 namespace rocksdb {
 
 class Arena;
+class ColumnFamilyData;
 class DBIter;
+class ForwardIterator;
 class InternalIterator;
 
 // Return a new iterator that converts internal keys (yielded by
@@ -53,8 +55,42 @@ extern Iterator* NewDBIterator(
 // to allocate.
 class ArenaWrappedDBIter : public Iterator {
  public:
+  ArenaWrappedDBIter() {}
   virtual ~ArenaWrappedDBIter();
 
+  // Creates the DB iterator to be wrapped in the arena. The iterator should not be initialized.
+  void Init(Env* env, const ImmutableCFOptions& ioptions,
+            const Comparator* user_key_comparator, const SequenceNumber& sequence,
+            uint64_t max_sequential_skip_in_iterations, uint64_t version_number,
+            const Slice* iterate_upper_bound, bool prefix_same_as_start, bool pin_data);
+
+  // Destroys the wrapped iterators, releasing the super version and the files they pin, and
+  // reinitializes the arena, keeping its inline block. The iterator could be initialized again
+  // after that.
+  void Reset();
+
+  bool initialized() const { return db_iter_ != nullptr; }
+
+  // Makes the wrapped DB iterator read at sequence and invalidates it, keeping the wrapped
+  // iterators. Used to reuse an iterator while the super version it was built from is current.
+  void SetSequence(SequenceNumber sequence);
+
+  // Super version number of the wrapped iterators.
+  uint64_t version_number() const;
+
+  // Set by the DB that could reuse the iterator, see DBOptions::max_pooled_iterators.
+  void SetPoolInfo(ColumnFamilyData* cfd, const ReadOptions& read_options) {
+    cfd_ = cfd;
+    read_options_ = read_options;
+  }
+
+  ColumnFamilyData* cfd() const { return cfd_; }
+  const ReadOptions& read_options() const { return read_options_; }
+
+  // The tailing iterator wrapped by the DB iterator, nullptr for a regular iterator.
+  void SetTailingIter(ForwardIterator* iter) { tailing_iter_ = iter; }
+  ForwardIterator* tailing_iter() const { return tailing_iter_; }
+
   // Get the arena to be used to allocate memory for DBIter to be wrapped,
   // as well as child iterators in it.
   virtual Arena* GetArena() { return &arena_; }
@@ -82,8 +118,11 @@ class ArenaWrappedDBIter : public Iterator {
   virtual Status GetProperty(std::string prop_name, std::string* prop) override;
 
  private:
-  DBIter* db_iter_;
+  DBIter* db_iter_ = nullptr;
   Arena arena_;
+  ColumnFamilyData* cfd_ = nullptr;
+  ReadOptions read_options_;
+  ForwardIterator* tailing_iter_ = nullptr;
 };
 
 // Generate the arena wrapped iterator class.
@@ -7833,6 +7833,34 @@ TEST_F(DBTest, RowCache) {
 }
 #endif  // ROCKSDB_LITE
 
+TEST_F(DBTest, SharedTableCache) {
+  Options options = CurrentOptions();
+  options.table_cache = NewLRUCache(100);
+  DestroyAndReopen(options);
+  ASSERT_OK(Put("foo", "bar"));
+  ASSERT_OK(Flush());
+
+  // The other DB writes the same key into a file with the same number.
+  std::string other_dbname = test::TmpDir(env_) + "/shared_table_cache_test";
+  ASSERT_OK(DestroyDB(other_dbname, options));
+  DB* other_db = nullptr;
+  ASSERT_OK(DB::Open(options, other_dbname, &other_db));
+  ASSERT_OK(other_db->Put(WriteOptions(), "foo", "baz"));
+  ASSERT_OK(other_db->Flush(FlushOptions()));
+
+  ASSERT_EQ("bar", Get("foo"));
+  std::string value;
+  ASSERT_OK(other_db->Get(ReadOptions(), "foo", &value));
+  ASSERT_EQ("baz", value);
+  ASSERT_EQ(2U, options.table_cache->GetUsage());
+
+  // Closing a DB releases its files.
+  delete other_db;
+  ASSERT_EQ(1U, options.table_cache->GetUsage());
+  ASSERT_EQ("bar", Get("foo"));
+  ASSERT_OK(DestroyDB(other_dbname, options));
+}
+
 // TODO(3.13): fix the issue of Seek() + Prev() which might not necessary
 //             return the biggest key which is smaller than the seek key.
 TEST_F(DBTest, PrevAfterMerge) {
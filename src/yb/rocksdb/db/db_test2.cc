@@ -72,6 +72,133 @@ TEST_F(DBTest2, IteratorPropertyVersionNumber) {
   delete iter2;
   delete iter3;
 }
+
+TEST_F(DBTest2, GetMiddleKey) {
+  std::string middle_key;
+  ASSERT_TRUE(db_->GetMiddleKey(&middle_key).IsIncomplete());
+
+  Options options = CurrentOptions();
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+
+  Random rnd(301);
+  const int kNumKeys = 1000;
+  for (int i = 0; i < kNumKeys; ++i) {
+    ASSERT_OK(Put(Key(i), RandomString(&rnd, 100)));
+  }
+  ASSERT_OK(Flush());
+
+  ASSERT_OK(db_->GetMiddleKey(&middle_key));
+  ASSERT_GT(middle_key, Key(kNumKeys / 4));
+  ASSERT_LT(middle_key, Key(kNumKeys * 3 / 4));
+}
+
+TEST_F(DBTest2, ReleasedIteratorsAreReused) {
+  Options options = CurrentOptions();
+  options.max_pooled_iterators = 2;
+  Reopen(options);
+
+  ASSERT_OK(Put("a", "1"));
+  Iterator* iter1 = db_->NewIterator(ReadOptions());
+  iter1->SeekToFirst();
+  ASSERT_TRUE(iter1->Valid());
+  ASSERT_EQ("a", iter1->key().ToString());
+  db_->ReleaseIterator(iter1);
+
+  // The super version did not change, so the iterator is reused and sees the new record.
+  ASSERT_OK(Put("b", "2"));
+  Iterator* iter2 = db_->NewIterator(ReadOptions());
+  ASSERT_EQ(iter1, iter2);
+  iter2->Seek("b");
+  ASSERT_TRUE(iter2->Valid());
+  ASSERT_EQ("2", iter2->value().ToString());
+
+  // A second iterator is allocated while the first one is in use, both are kept.
+  Iterator* iter3 = db_->NewIterator(ReadOptions());
+  ASSERT_NE(iter2, iter3);
+  db_->ReleaseIterator(iter2);
+  db_->ReleaseIterator(iter3);
+
+  // After a flush the iterators are rebuilt from the new super version.
+  ASSERT_OK(Put("c", "3"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("d", "4"));
+  Iterator* iter4 = db_->NewIterator(ReadOptions());
+  int count = 0;
+  for (iter4->SeekToFirst(); iter4->Valid(); iter4->Next()) {
+    ++count;
+  }
+  ASSERT_OK(iter4->status());
+  ASSERT_EQ(4, count);
+  db_->ReleaseIterator(iter4);
+}
+
+TEST_F(DBTest2, ReleasedTailingIteratorsSurviveFlushes) {
+  Options options = CurrentOptions();
+  options.max_pooled_iterators = 2;
+  Reopen(options);
+
+  ReadOptions tailing_options;
+  tailing_options.tailing = true;
+  ASSERT_OK(Put("a", "1"));
+  Iterator* iter1 = db_->NewIterator(tailing_options);
+  iter1->Seek("a");
+  ASSERT_TRUE(iter1->Valid());
+  db_->ReleaseIterator(iter1);
+
+  // A regular iterator does not take the pooled tailing iterator.
+  Iterator* regular_iter = db_->NewIterator(ReadOptions());
+  ASSERT_NE(iter1, regular_iter);
+  db_->ReleaseIterator(regular_iter);
+
+  // The tailing iterator is kept across the flush and sees the records written since.
+  ASSERT_OK(Put("b", "2"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("c", "3"));
+  Iterator* iter2 = db_->NewIterator(tailing_options);
+  ASSERT_EQ(iter1, iter2);
+  std::string keys;
+  for (iter2->Seek("a"); iter2->Valid(); iter2->Next()) {
+    keys += iter2->key().ToString();
+  }
+  ASSERT_OK(iter2->status());
+  ASSERT_EQ("abc", keys);
+  db_->ReleaseIterator(iter2);
+}
+
+TEST_F(DBTest2, DirectIOForFlushAndCompaction) {
+  Options options = CurrentOptions();
+  options.use_direct_io_for_flush_and_compaction = true;
+  options.disable_auto_compactions = true;
+  Reopen(options);
+
+  // Values whose size is not a multiple of the page size, so that direct writes have to pad the
+  // last page of each file.
+  constexpr int kNumKeys = 1000;
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < kNumKeys; ++i) {
+    values.push_back(RandomString(&rnd, 97 + i % 13));
+    ASSERT_OK(Put(Key(i), values.back()));
+    if (i % (kNumKeys / 4) == kNumKeys / 4 - 1) {
+      ASSERT_OK(Flush());
+    }
+  }
+  ASSERT_EQ(4, NumTableFilesAtLevel(0));
+  for (int i = 0; i < kNumKeys; ++i) {
+    ASSERT_EQ(values[i], Get(Key(i)));
+  }
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+  Reopen(options);
+  for (int i = 0; i < kNumKeys; ++i) {
+    ASSERT_EQ(values[i], Get(Key(i)));
+  }
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -100,7 +100,8 @@ bool DBTestBase::ShouldSkipOptions(int option_config, int skip_mask) {
       option_config == kUniversalCompactionMultiLevel ||
       option_config == kUniversalSubcompactions ||
       option_config == kFIFOCompaction ||
-      option_config == kConcurrentSkipList) {
+      option_config == kConcurrentSkipList ||
+      option_config == kHashIndexedSkipList) {
     return true;
     }
 #endif
@@ -283,6 +284,11 @@ Options DBTestBase::CurrentOptions(
       options.memtable_factory.reset(
           NewHashCuckooRepFactory(options.write_buffer_size));
       break;
+    case kHashIndexedSkipList:
+      options.memtable_factory.reset(NewHashIndexedSkipListRepFactory(
+          std::shared_ptr<const SliceTransform>(NewFixedPrefixTransform(1)), 16));
+      options.allow_concurrent_memtable_write = true;
+      break;
 #endif  // ROCKSDB_LITE
     case kMergePut:
       options.merge_operator = MergeOperators::CreatePutOperator();
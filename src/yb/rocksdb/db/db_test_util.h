@@ -546,10 +546,11 @@ class DBTestBase : public testing::Test {
     kRowCache = 28,
     kRecycleLogFiles = 29,
     kConcurrentSkipList = 30,
-    kEnd = 31,
-    kLevelSubcompactions = 31,
-    kUniversalSubcompactions = 32,
-    kBlockBasedTableWithIndexRestartInterval = 33,
+    kHashIndexedSkipList = 31,
+    kEnd = 32,
+    kLevelSubcompactions = 32,
+    kUniversalSubcompactions = 33,
+    kBlockBasedTableWithIndexRestartInterval = 34,
   };
   int option_config_;
 
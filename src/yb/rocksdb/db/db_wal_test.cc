@@ -82,6 +82,32 @@ TEST_F(DBWALTest, RollLog) {
   } while (ChangeOptions());
 }
 
+TEST_F(DBWALTest, DisableWAL) {
+  Options options = CurrentOptions();
+  DestroyAndReopen(options);
+  // Written to the WAL before it is disabled.
+  ASSERT_OK(Put("foo", "v1"));
+
+  options.disable_wal = true;
+  Reopen(options);
+  ASSERT_EQ("v1", Get("foo"));
+
+  ASSERT_OK(Put("bar", "v1"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("baz", "v1"));
+  ASSERT_OK(db_->SyncWAL());
+
+  VectorLogPtr wal_files;
+  ASSERT_OK(db_->GetSortedWalFiles(&wal_files));
+  ASSERT_TRUE(wal_files.empty());
+
+  // Only the flushed records survive the restart.
+  Reopen(options);
+  ASSERT_EQ("v1", Get("foo"));
+  ASSERT_EQ("v1", Get("bar"));
+  ASSERT_EQ("NOT_FOUND", Get("baz"));
+}
+
 TEST_F(DBWALTest, SyncWALNotBlockWrite) {
   Options options = CurrentOptions();
   options.max_write_buffer_number = 4;
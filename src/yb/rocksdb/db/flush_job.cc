@@ -138,7 +138,7 @@ Status FlushJob::Run(FileMetaData* file_meta) {
   // Save the contents of the earliest memtable as a new Table
   FileMetaData meta;
   autovector<MemTable*> mems;
-  cfd_->imm()->PickMemtablesToFlush(&mems);
+  cfd_->imm()->PickMemtablesToFlush(&mems, db_options_.mem_table_flush_filter);
   if (mems.empty()) {
     LOG_TO_BUFFER(log_buffer_, "[%s] Nothing in memtable to flush",
                 cfd_->GetName().c_str());
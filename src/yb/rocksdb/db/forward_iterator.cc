@@ -236,6 +236,13 @@ void ForwardIterator::Seek(const Slice& internal_key) {
   SeekInternal(internal_key, false);
 }
 
+void ForwardIterator::RenewIfStale() {
+  if (sv_ != nullptr && sv_->version_number != cfd_->GetSuperVersionNumber()) {
+    RenewIterators();
+    valid_ = false;
+  }
+}
+
 void ForwardIterator::SeekInternal(const Slice& internal_key,
                                    bool seek_to_first) {
   assert(mutable_iter_);
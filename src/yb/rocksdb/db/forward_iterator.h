@@ -91,6 +91,11 @@ class ForwardIterator : public InternalIterator {
   virtual Status status() const override;
   virtual Status GetProperty(std::string prop_name, std::string* prop) override;
 
+  // Moves the iterator to the current super version when it is not at it, keeping the iterators
+  // of the files in both versions, so that an idle iterator does not pin flushed memtables. The
+  // iterator is invalid afterwards.
+  void RenewIfStale();
+
   bool TEST_CheckDeletedIters(int* deleted_iters, int* num_iters);
 
  private:
@@ -441,7 +441,7 @@ void MemTable::Add(SequenceNumber s, ValueType type,
         earliest_seqno_.load(std::memory_order_relaxed);
     while (
         (cur_earliest_seqno == kMaxSequenceNumber || s < cur_earliest_seqno) &&
-        !first_seqno_.compare_exchange_weak(cur_earliest_seqno, s)) {
+        !earliest_seqno_.compare_exchange_weak(cur_earliest_seqno, s)) {
     }
   }
 
@@ -808,11 +808,12 @@ size_t MemTable::CountSuccessiveMergeEntries(const LookupKey& key) {
   return num_successive_merges;
 }
 
-void MemTable::SetLastOpId(const OpId& op_id) {
+void MemTable::SetLastOpId(const OpId& op_id, bool allow_concurrent) {
   for (;;) {
     OpId old_value = last_op_id_.load(std::memory_order_acquire);
     if (old_value.term > op_id.term || old_value.index >= op_id.index) {
-      LOG(DFATAL) << "Non-increasing last op id: " << old_value << " => " << op_id;
+      LOG_IF(DFATAL, !allow_concurrent)
+          << "Non-increasing last op id: " << old_value << " => " << op_id;
       return;
     }
     if (last_op_id_.compare_exchange_weak(old_value,
@@ -322,7 +322,9 @@ class MemTable {
 
   const MemTableOptions* GetMemTableOptions() const { return &moptions_; }
 
-  void SetLastOpId(const OpId& op_id);
+  // Batches of a parallel write group could be inserted in any order, so with allow_concurrent
+  // op_id could be lower than the last op id, and is ignored in this case.
+  void SetLastOpId(const OpId& op_id, bool allow_concurrent = false);
   OpId LastOpId() const { return last_op_id_.load(std::memory_order_acquire); }
 
  private:
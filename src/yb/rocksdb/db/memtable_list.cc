@@ -241,6 +241,9 @@ void MemTableListVersion::TrimHistory(autovector<MemTable*>* to_delete) {
 // Returns true if there is at least one memtable on which flush has
 // not yet started.
 bool MemTableList::IsFlushPending() const {
+  if (flush_deferred_) {
+    return false;
+  }
   if ((flush_requested_ && num_flush_not_started_ >= 1) ||
       (num_flush_not_started_ >= min_write_buffer_number_to_merge_)) {
     assert(imm_flush_needed.load(std::memory_order_relaxed));
@@ -250,7 +253,8 @@ bool MemTableList::IsFlushPending() const {
 }
 
 // Returns the memtables that need to be flushed.
-void MemTableList::PickMemtablesToFlush(autovector<MemTable*>* ret) {
+void MemTableList::PickMemtablesToFlush(autovector<MemTable*>* ret,
+                                        const MemTableFlushFilter& filter) {
   AutoThreadOperationStageUpdater stage_updater(
       ThreadStatus::STAGE_PICK_MEMTABLES_TO_FLUSH);
   const auto& memlist = current_->memlist_;
@@ -258,6 +262,10 @@ void MemTableList::PickMemtablesToFlush(autovector<MemTable*>* ret) {
     MemTable* m = *it;
     if (!m->flush_in_progress_) {
       assert(!m->flush_completed_);
+      if (filter && !filter(m->LastOpId())) {
+        flush_deferred_ = true;
+        break;
+      }
       num_flush_not_started_--;
       if (num_flush_not_started_ == 0) {
         imm_flush_needed.store(false, std::memory_order_release);
@@ -357,6 +365,7 @@ Status MemTableList::InstallMemtableFlushResults(
                     cfd->GetName().c_str(), m->file_number_, mem_id);
         assert(m->file_number_ > 0);
         current_->Remove(m, to_delete);
+        ++num_flushed_total_;
       } else {
         // commit failed. setup state so that we can flush again.
         LOG_TO_BUFFER(log_buffer, "Level-0 commit table #%" PRIu64
@@ -389,6 +398,8 @@ void MemTableList::Add(MemTable* m, autovector<MemTable*>* to_delete) {
   current_->Add(m, to_delete);
   m->MarkImmutable();
   num_flush_not_started_++;
+  num_added_++;
+  flush_deferred_ = false;
   if (num_flush_not_started_ == 1) {
     imm_flush_needed.store(true, std::memory_order_release);
   }
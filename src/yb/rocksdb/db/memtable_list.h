@@ -162,7 +162,8 @@ class MemTableList {
                                          max_write_buffer_number_to_maintain)),
         num_flush_not_started_(0),
         commit_in_progress_(false),
-        flush_requested_(false) {
+        flush_requested_(false),
+        flush_deferred_(false) {
     current_->Ref();
     current_memory_usage_ = 0;
   }
@@ -191,7 +192,10 @@ class MemTableList {
 
   // Returns the earliest memtables that needs to be flushed. The returned
   // memtables are guaranteed to be in the ascending order of created time.
-  void PickMemtablesToFlush(autovector<MemTable*>* mems);
+  // If filter is set, stops at the first memtable it rejects, and the flush
+  // is deferred until the next Add() or FlushRequested().
+  void PickMemtablesToFlush(autovector<MemTable*>* mems,
+                            const MemTableFlushFilter& filter = MemTableFlushFilter());
 
   // Reset status of the given memtable list back to pending state so that
   // they can get picked up again on the next round of flush.
@@ -212,6 +216,13 @@ class MemTableList {
   // Returns an estimate of the number of bytes of data in use.
   size_t ApproximateMemoryUsage();
 
+  // Number of memtables added to the list and number of them that were
+  // flushed, since the list was created. Memtables are flushed in the order
+  // they were added, so the first NumAdded() memtables are flushed once
+  // NumFlushedTotal() reaches that value.
+  uint64_t NumAdded() const { return num_added_; }
+  uint64_t NumFlushedTotal() const { return num_flushed_total_; }
+
   // Returns an estimate of the number of bytes of data used by
   // the unflushed mem-tables.
   size_t ApproximateUnflushedMemTablesMemoryUsage();
@@ -221,7 +232,10 @@ class MemTableList {
   // non-empty (regardless of the min_write_buffer_number_to_merge
   // parameter). This flush request will persist until the next time
   // PickMemtablesToFlush() is called.
-  void FlushRequested() { flush_requested_ = true; }
+  void FlushRequested() {
+    flush_requested_ = true;
+    flush_deferred_ = false;
+  }
 
   // Copying allowed
   // MemTableList(const MemTableList&);
@@ -246,6 +260,12 @@ class MemTableList {
   // Requested a flush of all memtables to storage
   bool flush_requested_;
 
+  // The flush filter rejected the oldest memtable that was not flushed yet
+  bool flush_deferred_;
+
+  uint64_t num_added_ = 0;
+  uint64_t num_flushed_total_ = 0;
+
   // The current memory usage.
   size_t current_memory_usage_;
 };
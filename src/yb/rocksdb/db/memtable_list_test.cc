@@ -608,6 +608,63 @@ TEST_F(MemTableListTest, FlushPendingTest) {
   to_delete.clear();
 }
 
+TEST_F(MemTableListTest, FlushFilter) {
+  auto factory = std::make_shared<SkipListFactory>();
+  options.memtable_factory = factory;
+  ImmutableCFOptions ioptions(options);
+  InternalKeyComparator cmp(BytewiseComparator());
+  WriteBuffer wb(options.db_write_buffer_size);
+  MutableCFOptions mutable_cf_options(options, ioptions);
+  autovector<MemTable*> to_delete;
+
+  MemTableList list(1, 0);
+  for (int i = 1; i <= 3; i++) {
+    MemTable* mem = new MemTable(cmp, ioptions, mutable_cf_options, &wb, kMaxSequenceNumber);
+    mem->Ref();
+    mem->Add(i, kTypeValue, "key" + ToString(i), "value");
+    mem->SetLastOpId(OpId(1, i));
+    list.Add(mem, &to_delete);
+  }
+  ASSERT_EQ(3, list.NumAdded());
+  ASSERT_TRUE(list.IsFlushPending());
+
+  int64_t max_flushable_index = 1;
+  MemTableFlushFilter filter = [&max_flushable_index](const OpId& last_op_id) {
+    return last_op_id.index <= max_flushable_index;
+  };
+
+  // Only the oldest memtable is accepted, the flush of the other ones is deferred.
+  autovector<MemTable*> to_flush;
+  list.PickMemtablesToFlush(&to_flush, filter);
+  ASSERT_EQ(1, to_flush.size());
+  ASSERT_EQ(1, to_flush[0]->LastOpId().index);
+  ASSERT_FALSE(list.IsFlushPending());
+
+  // Memtables are not picked out of order, even if the filter would accept a newer one.
+  max_flushable_index = 3;
+  list.FlushRequested();
+  ASSERT_TRUE(list.IsFlushPending());
+  autovector<MemTable*> to_flush2;
+  list.PickMemtablesToFlush(&to_flush2, [](const OpId& last_op_id) {
+    return last_op_id.index != 2;
+  });
+  ASSERT_EQ(0, to_flush2.size());
+  ASSERT_FALSE(list.IsFlushPending());
+
+  list.FlushRequested();
+  list.PickMemtablesToFlush(&to_flush2, filter);
+  ASSERT_EQ(2, to_flush2.size());
+  ASSERT_EQ(0, list.NumFlushedTotal());
+
+  list.RollbackMemtableFlush(to_flush, 0);
+  list.RollbackMemtableFlush(to_flush2, 0);
+  list.current()->Unref(&to_delete);
+  ASSERT_EQ(3, to_delete.size());
+  for (MemTable* m : to_delete) {
+    delete m;
+  }
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -52,6 +52,7 @@ int main() {
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/slice_transform.h"
 #include "yb/rocksdb/util/arena.h"
+#include "yb/rocksdb/util/concurrent_arena.h"
 #include "yb/rocksdb/util/mutexlock.h"
 #include "yb/rocksdb/util/stop_watch.h"
 #include "yb/rocksdb/util/testutil.h"
@@ -64,6 +65,8 @@ DEFINE_string(benchmarks, "fillrandom",
               "Comma-separated list of benchmarks to run. Options:\n"
               "\tfillrandom             -- write N random values\n"
               "\tfillseq                -- write N values in sequential order\n"
+              "\tfillrandomconcurrent   -- N threads write random values "
+              "concurrently\n"
               "\treadrandom             -- read N values in random order\n"
               "\treadseq                -- scan the DB\n"
               "\treadwrite              -- 1 thread writes while N - 1 threads "
@@ -125,7 +128,7 @@ DEFINE_int64(
 DEFINE_int32(
     num_threads, 1,
     "Number of concurrent threads to run. If the benchmark includes writes,\n"
-    "then at most one thread will be a writer");
+    "then at most one thread will be a writer, except for fillrandomconcurrent");
 
 DEFINE_int32(num_operations, 1000000,
              "Number of operations to do for write and random read benchmarks");
@@ -262,6 +265,17 @@ class FillBenchmarkThread : public BenchmarkThread {
                         num_ops, read_hits) {}
 
   void FillOne() {
+    Insert(key_gen_->Next(), ++(*sequence_), false /* concurrently */);
+  }
+
+  void operator()() override {
+    for (unsigned int i = 0; i < num_ops_; ++i) {
+      FillOne();
+    }
+  }
+
+ protected:
+  void Insert(uint64_t key, uint64_t sequence, bool concurrently) {
     char* buf = nullptr;
     auto internal_key_size = 16;
     auto encoded_len =
@@ -269,24 +283,44 @@ class FillBenchmarkThread : public BenchmarkThread {
     KeyHandle handle = table_->Allocate(encoded_len, &buf);
     assert(buf != nullptr);
     char* p = EncodeVarint32(buf, internal_key_size);
-    auto key = key_gen_->Next();
     EncodeFixed64(p, key);
     p += 8;
-    EncodeFixed64(p, ++(*sequence_));
+    EncodeFixed64(p, sequence);
     p += 8;
     Slice bytes = generator_.Generate(FLAGS_item_size);
     memcpy(p, bytes.data(), FLAGS_item_size);
     p += FLAGS_item_size;
     assert(p == buf + encoded_len);
-    table_->Insert(handle);
+    if (concurrently) {
+      table_->InsertConcurrently(handle);
+    } else {
+      table_->Insert(handle);
+    }
     *bytes_written_ += encoded_len;
   }
+};
+
+// Writer of fillrandomconcurrent, with its own key generator and bytes written counter. Only the
+// sequence is shared with the other writers.
+class ConcurrentInsertBenchmarkThread : public FillBenchmarkThread {
+ public:
+  ConcurrentInsertBenchmarkThread(MemTableRep* table, KeyGenerator* key_gen,
+                                  uint64_t* bytes_written,
+                                  std::atomic<uint64_t>* sequence,
+                                  uint64_t num_ops)
+      : FillBenchmarkThread(table, key_gen, bytes_written, nullptr, nullptr,
+                            num_ops, nullptr),
+        concurrent_sequence_(sequence) {}
 
   void operator()() override {
     for (unsigned int i = 0; i < num_ops_; ++i) {
-      FillOne();
+      Insert(key_gen_->Next(), concurrent_sequence_->fetch_add(1) + 1,
+             true /* concurrently */);
     }
   }
+
+ private:
+  std::atomic<uint64_t>* concurrent_sequence_;
 };
 
 class ConcurrentFillBenchmarkThread : public FillBenchmarkThread {
@@ -502,6 +536,43 @@ class FillBenchmark : public Benchmark {
   }
 };
 
+// Splits FLAGS_num_operations random writes between FLAGS_num_threads writers
+// inserting into the memtable concurrently, as DB writers of a parallel write
+// group do with allow_concurrent_memtable_write.
+class FillConcurrentBenchmark : public Benchmark {
+ public:
+  explicit FillConcurrentBenchmark(MemTableRep* table, uint64_t* sequence)
+      : Benchmark(table, nullptr, sequence, FLAGS_num_threads) {
+    num_write_ops_per_thread_ = FLAGS_num_operations / FLAGS_num_threads;
+  }
+
+  void RunThreads(std::vector<std::thread>* threads, uint64_t* bytes_written,
+                  uint64_t* bytes_read, bool write,
+                  uint64_t* read_hits) override {
+    std::atomic<uint64_t> sequence(*sequence_);
+    std::vector<std::unique_ptr<Random64>> rngs;
+    std::vector<std::unique_ptr<KeyGenerator>> key_gens;
+    std::vector<uint64_t> thread_bytes_written(num_threads_, 0);
+    for (uint32_t i = 0; i < num_threads_; ++i) {
+      rngs.emplace_back(new Random64(FLAGS_seed + i));
+      key_gens.emplace_back(
+          new KeyGenerator(rngs.back().get(), RANDOM, FLAGS_num_operations));
+    }
+    for (uint32_t i = 0; i < num_threads_; ++i) {
+      threads->emplace_back(ConcurrentInsertBenchmarkThread(
+          table_, key_gens[i].get(), &thread_bytes_written[i], &sequence,
+          num_write_ops_per_thread_));
+    }
+    for (auto& thread : *threads) {
+      thread.join();
+    }
+    for (auto thread_bytes : thread_bytes_written) {
+      *bytes_written += thread_bytes;
+    }
+    *sequence_ = sequence.load();
+  }
+};
+
 class ReadBenchmark : public Benchmark {
  public:
   explicit ReadBenchmark(MemTableRep* table, KeyGenerator* key_gen,
@@ -637,7 +708,8 @@ int main(int argc, char** argv) {
   rocksdb::InternalKeyComparator internal_key_comp(
       rocksdb::BytewiseComparator());
   rocksdb::MemTable::KeyComparator key_comp(internal_key_comp);
-  rocksdb::Arena arena;
+  // Same arena as MemTable uses, so fillrandomconcurrent writers could allocate concurrently.
+  rocksdb::ConcurrentArena arena;
   rocksdb::WriteBuffer wb(FLAGS_write_buffer_size);
   rocksdb::MemTableAllocator memtable_allocator(&arena, &wb);
   uint64_t sequence;
@@ -674,6 +746,15 @@ int main(int argc, char** argv) {
                                               FLAGS_num_operations));
       benchmark.reset(new rocksdb::FillBenchmark(memtablerep.get(),
                                                  key_gen.get(), &sequence));
+    } else if (name == rocksdb::Slice("fillrandomconcurrent")) {
+      if (!factory->IsInsertConcurrentlySupported()) {
+        fprintf(stdout, "%s doesn't support concurrent inserts\n",
+                FLAGS_memtablerep.c_str());
+        exit(1);
+      }
+      memtablerep.reset(createMemtableRep());
+      benchmark.reset(new rocksdb::FillConcurrentBenchmark(memtablerep.get(),
+                                                           &sequence));
     } else if (name == rocksdb::Slice("readrandom")) {
       key_gen.reset(new rocksdb::KeyGenerator(&rng, rocksdb::RANDOM,
                                               FLAGS_num_operations));
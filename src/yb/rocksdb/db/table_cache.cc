@@ -23,6 +23,9 @@
 
 #include "yb/rocksdb/db/table_cache.h"
 
+#include <mutex>
+#include <unordered_set>
+
 #include "yb/rocksdb/db/dbformat.h"
 #include "yb/rocksdb/db/filename.h"
 #include "yb/rocksdb/db/version_edit.h"
@@ -463,4 +466,90 @@ void TableCache::Evict(Cache* cache, uint64_t file_number) {
   cache->Erase(GetSliceForFileNumber(&file_number));
 }
 
+namespace {
+
+class SharedCacheView : public Cache {
+ public:
+  explicit SharedCacheView(std::shared_ptr<Cache> shared_cache)
+      : shared_cache_(std::move(shared_cache)) {
+    PutVarint64(&prefix_, shared_cache_->NewId());
+  }
+
+  ~SharedCacheView() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& key : keys_) {
+      shared_cache_->Erase(key);
+    }
+  }
+
+  Status Insert(const Slice& key, const QueryId query_id, void* value, size_t charge,
+                void (*deleter)(const Slice& key, void* value), Handle** handle,
+                Statistics* statistics) override {
+    std::string prefixed_key = PrefixedKey(key);
+    Status s = shared_cache_->Insert(
+        prefixed_key, query_id, value, charge, deleter, handle, statistics);
+    if (s.ok()) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      keys_.insert(std::move(prefixed_key));
+    }
+    return s;
+  }
+
+  Handle* Lookup(const Slice& key, const QueryId query_id, Statistics* statistics) override {
+    return shared_cache_->Lookup(PrefixedKey(key), query_id, statistics);
+  }
+
+  void Erase(const Slice& key) override {
+    std::string prefixed_key = PrefixedKey(key);
+    shared_cache_->Erase(prefixed_key);
+    std::lock_guard<std::mutex> lock(mutex_);
+    keys_.erase(prefixed_key);
+  }
+
+  void Release(Handle* handle) override { shared_cache_->Release(handle); }
+  void* Value(Handle* handle) override { return shared_cache_->Value(handle); }
+  uint64_t NewId() override { return shared_cache_->NewId(); }
+
+  // The capacity belongs to the owner of the shared cache, a single DB does not change it.
+  void SetCapacity(size_t capacity) override {}
+  void SetStrictCapacityLimit(bool strict_capacity_limit) override {}
+  bool HasStrictCapacityLimit() const override { return shared_cache_->HasStrictCapacityLimit(); }
+  size_t GetCapacity() const override { return shared_cache_->GetCapacity(); }
+  size_t GetUsage() const override { return shared_cache_->GetUsage(); }
+  size_t GetUsage(Handle* handle) const override { return shared_cache_->GetUsage(handle); }
+  size_t GetPinnedUsage() const override { return shared_cache_->GetPinnedUsage(); }
+
+  SubCacheType GetSubCacheType(Handle* handle) const override {
+    return shared_cache_->GetSubCacheType(handle);
+  }
+
+  void ApplyToAllCacheEntries(void (*callback)(void*, size_t), bool thread_safe) override {
+    shared_cache_->ApplyToAllCacheEntries(callback, thread_safe);
+  }
+
+  void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) override {}
+
+ private:
+  std::string PrefixedKey(const Slice& key) const {
+    std::string result;
+    result.reserve(prefix_.size() + key.size());
+    result.append(prefix_);
+    result.append(key.cdata(), key.size());
+    return result;
+  }
+
+  const std::shared_ptr<Cache> shared_cache_;
+  std::string prefix_;
+
+  std::mutex mutex_;
+  // Keys this DB currently has in the shared cache.
+  std::unordered_set<std::string> keys_;
+};
+
+} // namespace
+
+std::shared_ptr<Cache> TableCache::NewSharedCacheView(std::shared_ptr<Cache> shared_cache) {
+  return std::make_shared<SharedCacheView>(std::move(shared_cache));
+}
+
 }  // namespace rocksdb
@@ -107,6 +107,12 @@ class TableCache {
   // Evict any entry for the specified file number
   static void Evict(Cache* cache, uint64_t file_number);
 
+  // Returns the table cache of a single DB that keeps its entries in 'shared_cache'. The keys are
+  // prefixed with an id unique to the returned cache, so DBs sharing the cache with equal file
+  // numbers do not collide, and the entries still present in 'shared_cache' are erased when the
+  // returned cache is destroyed, so a closed DB does not keep its files open.
+  static std::shared_ptr<Cache> NewSharedCacheView(std::shared_ptr<Cache> shared_cache);
+
   // Find table reader
   // @param skip_filters Disables loading/accessing the filter block
   Status FindTable(const EnvOptions& toptions,
@@ -153,7 +153,11 @@ class VersionBuilder::Rep {
           assert(f1->largest.seqno > f2->largest.seqno ||
                  // We can have multiple files with seqno = 0 as a result of
                  // using DB::AddFile()
-                 (f1->largest.seqno == 0 && f2->largest.seqno == 0));
+                 (f1->largest.seqno == 0 && f2->largest.seqno == 0) ||
+                 // Files written by subcompactions of one compaction have disjoint key ranges.
+                 (f1->largest.seqno == f2->largest.seqno &&
+                  (vstorage->InternalComparator()->Compare(f1->largest.key, f2->smallest.key) < 0 ||
+                   vstorage->InternalComparator()->Compare(f2->largest.key, f1->smallest.key) < 0)));
         } else {
           assert(level_nonzero_cmp_(f1, f2));
 
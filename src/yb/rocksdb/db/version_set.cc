@@ -1242,6 +1242,13 @@ void VersionStorageInfo::ComputeCompactionScore(
         }
       }
       if (compaction_style_ == kCompactionStyleUniversal) {
+        // Files written by subcompactions of one compaction form a single sorted run.
+        num_sorted_runs = 0;
+        for (const auto& run : Level0SortedRuns()) {
+          if (!run.front()->being_compacted) {
+            num_sorted_runs++;
+          }
+        }
         // For universal compaction, we use level0 score to indicate
         // compaction score for the whole DB. Adding other levels as if
         // they are L0 files.
@@ -1867,6 +1874,45 @@ uint64_t VersionStorageInfo::MaxBytesForLevel(int level) const {
   return level_max_bytes_[level];
 }
 
+namespace {
+
+// Level 0 files are ordered from the newest to the oldest, and different sorted runs of universal
+// compaction cover disjoint sequence number ranges. So adjacent files with overlapping sequence
+// number ranges and disjoint key ranges were written by one compaction split into
+// subcompactions.
+bool IsSameLevel0SortedRun(const InternalKeyComparator& icmp,
+                           const std::vector<FileMetaData*>& run_files,
+                           const FileMetaData& file) {
+  SequenceNumber run_smallest_seqno = run_files.front()->smallest.seqno;
+  for (const auto* run_file : run_files) {
+    run_smallest_seqno = std::min(run_smallest_seqno, run_file->smallest.seqno);
+  }
+  if (file.largest.seqno < run_smallest_seqno) {
+    return false;
+  }
+  for (const auto* run_file : run_files) {
+    if (icmp.Compare(file.largest.key, run_file->smallest.key) >= 0 &&
+        icmp.Compare(run_file->largest.key, file.smallest.key) >= 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+std::vector<std::vector<FileMetaData*>> VersionStorageInfo::Level0SortedRuns() const {
+  std::vector<std::vector<FileMetaData*>> result;
+  for (FileMetaData* f : files_[0]) {
+    if (!result.empty() && IsSameLevel0SortedRun(*internal_comparator_, result.back(), *f)) {
+      result.back().push_back(f);
+    } else {
+      result.push_back({f});
+    }
+  }
+  return result;
+}
+
 void VersionStorageInfo::CalculateBaseBytes(const ImmutableCFOptions& ioptions,
                                             const MutableCFOptions& options) {
   // Special logic to set number of sorted runs.
@@ -1882,6 +1928,13 @@ void VersionStorageInfo::CalculateBaseBytes(const ImmutableCFOptions& ioptions,
     }
   }
   if (compaction_style_ == kCompactionStyleUniversal) {
+    // Files written by subcompactions of one compaction form a single sorted run.
+    num_l0_count = 0;
+    for (const auto& run : Level0SortedRuns()) {
+      if (run.front()->fd.GetTotalFileSize() <= options.max_file_size_for_compaction) {
+        ++num_l0_count;
+      }
+    }
     // For universal compaction, we use level0 score to indicate
     // compaction score for the whole DB. Adding other levels as if
     // they are L0 files.
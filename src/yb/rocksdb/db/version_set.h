@@ -240,6 +240,11 @@ class VersionStorageInfo {
     return files_[level];
   }
 
+  // Groups level 0 files into sorted runs of universal compaction. Usually each file is a sorted
+  // run, but the files written by one compaction split into subcompactions form a single sorted
+  // run.
+  std::vector<std::vector<FileMetaData*>> Level0SortedRuns() const;
+
   const rocksdb::LevelFilesBrief& LevelFilesBrief(int level) const {
     assert(level < static_cast<int>(level_files_brief_.size()));
     return level_files_brief_[level];
@@ -820,7 +820,7 @@ class MemTableInserter : public WriteBatch::Handler {
     if (!SeekToColumnFamily(0, &seek_status)) {
       return seek_status;
     }
-    cf_mems_->GetMemTable()->SetLastOpId(op_id);
+    cf_mems_->GetMemTable()->SetLastOpId(op_id, concurrent_memtable_writes_);
     return Status::OK();
   }
 
@@ -107,6 +107,10 @@ struct EnvOptions {
   // If false, fallocate() calls are bypassed
   bool allow_fallocate = true;
 
+  // If true, then written data bypasses the OS page cache (O_DIRECT), when the file system supports
+  // it. Not used with mmap writes.
+  bool use_direct_writes = false;
+
   // If true, set the FD_CLOEXEC on open fd.
   bool set_fd_cloexec = true;
 
@@ -384,6 +388,11 @@ class Env {
   // files. Default implementation returns the copy of the same object.
   virtual EnvOptions OptimizeForManifestWrite(const EnvOptions& env_options)
       const;
+  // OptimizeForCompactionTableWrite will create a new EnvOptions object that is a copy of the
+  // EnvOptions in the parameters, but is optimized for writing SST files by flushes and
+  // compactions.
+  virtual EnvOptions OptimizeForCompactionTableWrite(const EnvOptions& env_options,
+                                                     const DBOptions& db_options) const;
 
   // Returns the status of all threads that belong to the current Env.
   virtual Status GetThreadList(std::vector<ThreadStatus>* thread_list) {
@@ -487,6 +496,10 @@ class RandomAccessFile : public File {
 
   virtual void Hint(AccessPattern pattern) {}
 
+  // Starts reading "n" bytes at "offset" into the OS page cache without waiting for them, so that
+  // a later Read() of this range does not block on the device. This is only a hint.
+  virtual void Prefetch(uint64_t offset, size_t n) {}
+
   // Remove any kind of caching of data from the offset to offset+length
   // of this file. If the length is 0, then it refers to the end of file.
   // If the system is not caching the file contents, then this is a noop.
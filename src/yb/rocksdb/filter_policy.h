@@ -198,12 +198,16 @@ extern const FilterPolicy* NewBloomFilterPolicy(int bits_per_key,
 // some metadata added.
 // error_rate: expected false positive error rate to calculate maximum number of keys to store in
 // each filter block. This is used to determine whether a filter block is full.
+// lane_blocked: whether the bloom filter sets one bit per key in each 64-bit lane of a cache line,
+// so that a lookup checks all probes at once. Filter blocks in both formats can be read, but
+// readers without support for this format treat such filter blocks as matching all keys.
 //
 // Callers must delete the result after any database that is using the filter policy has been
 // closed.
 extern const FilterPolicy* NewFixedSizeFilterPolicy(uint32_t total_bits,
                                                     double error_rate,
-                                                    Logger* logger);
+                                                    Logger* logger,
+                                                    bool lane_blocked = false);
 }  // namespace rocksdb
 
 #endif  // YB_ROCKSDB_FILTER_POLICY_H
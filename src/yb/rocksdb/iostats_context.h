@@ -42,6 +42,8 @@ struct IOStatsContext {
   uint64_t bytes_written;
   // number of bytes that has been read.
   uint64_t bytes_read;
+  // number of read calls that returned data.
+  uint64_t read_ops;
 
   // time spent in open() and fopen().
   uint64_t open_nanos;
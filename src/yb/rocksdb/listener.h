@@ -74,6 +74,9 @@ enum class CompactionReason {
   kManualCompaction,
   // DB::SuggestCompactRange() marked files for compaction
   kFilesMarkedForCompaction,
+  // [Universal] oldest files contain only expired records, see
+  // CompactionFilterFactory::NumExpiredOldestFiles()
+  kUniversalExpiredFiles,
 };
 
 #ifndef ROCKSDB_LITE
@@ -0,0 +1,199 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rocksdb/memtable/hash_indexed_skiplist_rep.h"
+
+#include <atomic>
+#include <mutex>
+
+#include "yb/rocksdb/db/inlineskiplist.h"
+#include "yb/rocksdb/db/memtable.h"
+#include "yb/rocksdb/db/skiplist.h"
+#include "yb/rocksdb/util/murmurhash.h"
+#include "yb/rocksdb/util/mutexlock.h"
+
+namespace rocksdb {
+namespace {
+
+// Keeps all the entries in a skiplist ordered over the whole memtable, as SkipListRep does, and
+// also indexes them by the transformed user key: every bucket of a fixed size hash table points to
+// a short skiplist of the entries whose transformed user keys hash to it. Iterators use the
+// ordered skiplist, while point lookups only search the bucket of the key, and don't search at all
+// when the bucket is empty.
+//
+// All the entries of a user key are in the same bucket, so any transform could be used, but
+// lookups are fast only when a few user keys share a transformed key, e.g. a DocKey prefix.
+class HashIndexedSkipListRep : public MemTableRep {
+ public:
+  HashIndexedSkipListRep(const MemTableRep::KeyComparator& compare,
+                         MemTableAllocator* allocator, const SliceTransform* transform,
+                         size_t bucket_count, int32_t skiplist_height,
+                         int32_t skiplist_branching_factor)
+      : MemTableRep(allocator),
+        skip_list_(compare, allocator),
+        compare_(compare),
+        allocator_(allocator),
+        transform_(transform),
+        bucket_count_(bucket_count),
+        skiplist_height_(skiplist_height),
+        skiplist_branching_factor_(skiplist_branching_factor) {
+    auto mem = allocator->AllocateAligned(sizeof(std::atomic<Bucket*>) * bucket_count_);
+    buckets_ = new (mem) std::atomic<Bucket*>[bucket_count_];
+    for (size_t i = 0; i != bucket_count_; ++i) {
+      buckets_[i].store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  KeyHandle Allocate(const size_t len, char** buf) override {
+    *buf = skip_list_.AllocateKey(len);
+    return static_cast<KeyHandle>(*buf);
+  }
+
+  void Insert(KeyHandle handle) override {
+    auto* key = static_cast<char*>(handle);
+    skip_list_.Insert(key);
+    AddToBucket(key);
+  }
+
+  void InsertConcurrently(KeyHandle handle) override {
+    auto* key = static_cast<char*>(handle);
+    skip_list_.InsertConcurrently(key);
+    AddToBucket(key);
+  }
+
+  bool Contains(const char* key) const override {
+    auto* bucket = GetBucket(transform_->Transform(UserKey(key)));
+    return bucket != nullptr && bucket->list.Contains(key);
+  }
+
+  size_t ApproximateMemoryUsage() override {
+    // All memory is allocated through allocator; nothing to report here
+    return 0;
+  }
+
+  void Get(const LookupKey& k, void* callback_args,
+           bool (*callback_func)(void* arg, const char* entry)) override {
+    auto* bucket = GetBucket(transform_->Transform(k.user_key()));
+    if (bucket == nullptr) {
+      return;
+    }
+    BucketList::Iterator iter(&bucket->list);
+    for (iter.Seek(k.memtable_key().cdata());
+         iter.Valid() && callback_func(callback_args, iter.key());
+         iter.Next()) {
+    }
+  }
+
+  uint64_t ApproximateNumEntries(const Slice& start_ikey, const Slice& end_ikey) override {
+    std::string tmp;
+    uint64_t start_count = skip_list_.EstimateCount(EncodeKey(&tmp, start_ikey));
+    uint64_t end_count = skip_list_.EstimateCount(EncodeKey(&tmp, end_ikey));
+    return (end_count >= start_count) ? (end_count - start_count) : 0;
+  }
+
+  MemTableRep::Iterator* GetIterator(Arena* arena = nullptr) override {
+    void* mem = arena ? arena->AllocateAligned(sizeof(Iterator)) : operator new(sizeof(Iterator));
+    return new (mem) Iterator(&skip_list_);
+  }
+
+ private:
+  typedef InlineSkipList<const MemTableRep::KeyComparator&> OrderedList;
+  typedef SkipList<const char*, const MemTableRep::KeyComparator&> BucketList;
+
+  // SkipList supports concurrent readers, but writers should be serialized.
+  struct Bucket {
+    Bucket(const MemTableRep::KeyComparator& compare, Allocator* allocator,
+           int32_t skiplist_height, int32_t skiplist_branching_factor)
+        : list(compare, allocator, skiplist_height, skiplist_branching_factor) {}
+
+    SpinMutex mutex;
+    BucketList list;
+  };
+
+  class Iterator : public MemTableRep::Iterator {
+   public:
+    explicit Iterator(const OrderedList* list) : iter_(list) {}
+
+    bool Valid() const override { return iter_.Valid(); }
+
+    const char* key() const override { return iter_.key(); }
+
+    void Next() override { iter_.Next(); }
+
+    void Prev() override { iter_.Prev(); }
+
+    void Seek(const Slice& user_key, const char* memtable_key) override {
+      iter_.Seek(memtable_key != nullptr ? memtable_key : EncodeKey(&tmp_, user_key));
+    }
+
+    void SeekToFirst() override { iter_.SeekToFirst(); }
+
+    void SeekToLast() override { iter_.SeekToLast(); }
+
+   private:
+    OrderedList::Iterator iter_;
+    std::string tmp_;       // For passing to EncodeKey
+  };
+
+  size_t GetHash(const Slice& transformed) const {
+    return MurmurHash(transformed.data(), static_cast<int>(transformed.size()), 0) %
+           bucket_count_;
+  }
+
+  Bucket* GetBucket(const Slice& transformed) const {
+    return buckets_[GetHash(transformed)].load(std::memory_order_acquire);
+  }
+
+  void AddToBucket(const char* key) {
+    auto& slot = buckets_[GetHash(transform_->Transform(UserKey(key)))];
+    auto* bucket = slot.load(std::memory_order_acquire);
+    if (bucket == nullptr) {
+      auto* addr = allocator_->AllocateAligned(sizeof(Bucket));
+      auto* new_bucket = new (addr) Bucket(
+          compare_, allocator_, skiplist_height_, skiplist_branching_factor_);
+      // When another writer has just created the bucket, the memory of ours is wasted, that is
+      // rare enough.
+      bucket = slot.compare_exchange_strong(bucket, new_bucket, std::memory_order_acq_rel)
+          ? new_bucket : bucket;
+    }
+    std::lock_guard<SpinMutex> lock(bucket->mutex);
+    bucket->list.Insert(key);
+  }
+
+  OrderedList skip_list_;
+  const MemTableRep::KeyComparator& compare_;
+  MemTableAllocator* const allocator_;
+  const SliceTransform* const transform_;
+  const size_t bucket_count_;
+  const int32_t skiplist_height_;
+  const int32_t skiplist_branching_factor_;
+  std::atomic<Bucket*>* buckets_;
+};
+
+} // namespace
+
+MemTableRep* HashIndexedSkipListRepFactory::CreateMemTableRep(
+    const MemTableRep::KeyComparator& compare, MemTableAllocator* allocator,
+    const SliceTransform* transform, Logger* logger) {
+  return new HashIndexedSkipListRep(compare, allocator, transform_.get(), bucket_count_,
+                                    skiplist_height_, skiplist_branching_factor_);
+}
+
+MemTableRepFactory* NewHashIndexedSkipListRepFactory(
+    std::shared_ptr<const SliceTransform> transform, size_t bucket_count,
+    int32_t skiplist_height, int32_t skiplist_branching_factor) {
+  return new HashIndexedSkipListRepFactory(std::move(transform), bucket_count, skiplist_height,
+                                           skiplist_branching_factor);
+}
+
+} // namespace rocksdb
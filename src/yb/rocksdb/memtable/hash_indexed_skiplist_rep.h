@@ -0,0 +1,55 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef ROCKSDB_MEMTABLE_HASH_INDEXED_SKIPLIST_REP_H
+#define ROCKSDB_MEMTABLE_HASH_INDEXED_SKIPLIST_REP_H
+
+#include <memory>
+
+#include "yb/rocksdb/memtablerep.h"
+#include "yb/rocksdb/slice_transform.h"
+
+namespace rocksdb {
+
+class HashIndexedSkipListRepFactory : public MemTableRepFactory {
+ public:
+  HashIndexedSkipListRepFactory(std::shared_ptr<const SliceTransform> transform,
+                                size_t bucket_count,
+                                int32_t skiplist_height,
+                                int32_t skiplist_branching_factor)
+      : transform_(std::move(transform)),
+        bucket_count_(bucket_count),
+        skiplist_height_(skiplist_height),
+        skiplist_branching_factor_(skiplist_branching_factor) {}
+
+  // The transform of the column family is ignored, transform_ is used instead.
+  MemTableRep* CreateMemTableRep(
+      const MemTableRep::KeyComparator& compare, MemTableAllocator* allocator,
+      const SliceTransform* transform, Logger* logger) override;
+
+  const char* Name() const override {
+    return "HashIndexedSkipListRepFactory";
+  }
+
+  bool IsInsertConcurrentlySupported() const override { return true; }
+
+ private:
+  const std::shared_ptr<const SliceTransform> transform_;
+  const size_t bucket_count_;
+  const int32_t skiplist_height_;
+  const int32_t skiplist_branching_factor_;
+};
+
+}  // namespace rocksdb
+
+#endif  // ROCKSDB_MEMTABLE_HASH_INDEXED_SKIPLIST_REP_H
@@ -287,6 +287,21 @@ extern MemTableRepFactory* NewHashSkipListRepFactory(
     int32_t skiplist_branching_factor = 4
 );
 
+// This creates MemTableReps that keep all the entries in a skiplist, as
+// SkipListFactory does, and also index them with a fixed array of buckets by
+// the hash of transform(user key), each pointing to a skiplist of the entries
+// of its bucket. Iteration is in total order, and point lookups only search
+// the bucket of the key. The prefix extractor of the column family is not used.
+// @transform: should map the user keys to prefixes shared by a few user keys
+// @bucket_count: number of fixed array buckets
+// @skiplist_height: the max height of the skiplist of a bucket
+// @skiplist_branching_factor: probabilistic size ratio between adjacent link
+//                             lists in the skiplist of a bucket
+extern MemTableRepFactory* NewHashIndexedSkipListRepFactory(
+    std::shared_ptr<const SliceTransform> transform,
+    size_t bucket_count = 100000, int32_t skiplist_height = 4,
+    int32_t skiplist_branching_factor = 4);
+
 // The factory is to create memtables based on a hash table:
 // it contains a fixed array of buckets, each pointing to either a linked list
 // or a skip list if number of entries inside the bucket exceeds
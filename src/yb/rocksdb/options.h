@@ -26,6 +26,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <functional>
 #include <string>
 #include <memory>
 #include <vector>
@@ -35,6 +36,7 @@
 #include "yb/rocksdb/cache.h"
 #include "yb/rocksdb/version.h"
 #include "yb/rocksdb/listener.h"
+#include "yb/rocksdb/types.h"
 #include "yb/util/slice.h"
 #include "yb/rocksdb/universal_compaction.h"
 
@@ -48,6 +50,7 @@ class BoundaryValuesExtractor;
 class Cache;
 class CompactionFilter;
 class CompactionFilterFactory;
+class CompactionScheduler;
 class Comparator;
 class Env;
 enum InfoLogLevel : unsigned char;
@@ -66,6 +69,10 @@ class InternalKeyComparator;
 class WalFilter;
 class MemoryMonitor;
 
+// Decides whether an immutable memtable can be flushed, given the op id of the last write batch
+// applied to it.
+typedef std::function<bool(const OpId& last_op_id)> MemTableFlushFilter;
+
 // DB contents are stored in a set of blocks, each of which holds a
 // sequence of key,value pairs.  Each block may be compressed before
 // being stored in a file.  The following enum describes which
@@ -79,10 +86,15 @@ enum CompressionType : char {
   kBZip2Compression = 0x3,
   kLZ4Compression = 0x4,
   kLZ4HCCompression = 0x5,
-  // zstd format is not finalized yet so it's subject to changes.
+  kZSTD = 0x7,
+  // Only kept to read files written before zstd format was finalized. It has the same format as
+  // kZSTD.
   kZSTDNotFinalCompression = 0x40,
 };
 
+// Returns whether the compression library for compression_type is linked into this build.
+bool IsCompressionTypeSupported(CompressionType compression_type);
+
 enum CompactionStyle : char {
   // level based compaction style
   kCompactionStyleLevel = 0x0,
@@ -154,9 +166,14 @@ struct CompressionOptions {
   int window_bits;
   int level;
   int strategy;
-  CompressionOptions() : window_bits(-14), level(-1), strategy(0) {}
-  CompressionOptions(int wbits, int _lev, int _strategy)
-      : window_bits(wbits), level(_lev), strategy(_strategy) {}
+  // Maximum size of the dictionary used to compress the data blocks of files produced by
+  // compactions. The dictionary is built from samples of the compaction input and stored in the
+  // "rocksdb.compression_dict" meta block of every output file. It is used by kZlibCompression,
+  // kLZ4Compression, kLZ4HCCompression and kZSTD. 0 disables dictionary compression.
+  uint32_t max_dict_bytes;
+  CompressionOptions() : window_bits(-14), level(-1), strategy(0), max_dict_bytes(0) {}
+  CompressionOptions(int wbits, int _lev, int _strategy, uint32_t _max_dict_bytes = 0)
+      : window_bits(wbits), level(_lev), strategy(_strategy), max_dict_bytes(_max_dict_bytes) {}
 };
 
 enum UpdateStatus {    // Return status For inplace update callback
@@ -878,6 +895,14 @@ struct DBOptions {
   // Default: 5000 or ulimit value of max open files (whichever is smaller)
   int max_open_files;
 
+  // Cache of open table files shared by several DBs, so that they use a common budget of file
+  // descriptors and table reader memory, evicted in LRU order. Entries are charged one unit per
+  // open file. When set, max_open_files does not size a cache of the DB's own, but -1 still makes
+  // the DB open all of its files on DB::Open().
+  //
+  // Default: nullptr (each DB has its own cache of max_open_files files)
+  std::shared_ptr<Cache> table_cache;
+
   // If max_open_files is -1, DB will open all files on DB::Open(). You can
   // use this option to increase the number of threads used to open the files.
   // Default: 1
@@ -1114,6 +1139,22 @@ struct DBOptions {
   // Default: nullptr (disabled)
   std::shared_ptr<MemoryMonitor> memory_monitor;
 
+  // Shared CompactionScheduler that admits the background compactions of several DBs into a
+  // common pool by priority. When not set, compactions are scheduled directly in env. The
+  // scheduler must use the same Env as the DB.
+  //
+  // Default: nullptr
+  std::shared_ptr<CompactionScheduler> compaction_scheduler;
+
+  // When set, immutable memtables are only flushed while the filter accepts them, oldest first.
+  // The first rejected memtable and all the newer ones stay in memory, and are not picked again
+  // until a new flush is requested, e.g. with FlushOptions::switch_memtable set to false. It is
+  // called under the DB mutex. Used to keep the flushed op id of a DB from getting ahead of the
+  // data it depends on in another DB.
+  //
+  // Default: nullptr (all memtables are flushed)
+  MemTableFlushFilter mem_table_flush_filter;
+
   // Specify the file access pattern once a compaction is started.
   // It will be applied to all input files of a compaction.
   // Default: NORMAL
@@ -1307,6 +1348,30 @@ struct DBOptions {
 
   // Max file size for compaction. Supported only for level0 of universal style compactions.
   uint64_t max_file_size_for_compaction = std::numeric_limits<uint64_t>::max();
+
+  // Max number of iterators released with DB::ReleaseIterator that are kept to be reused by
+  // NewIterator, instead of allocating a new iterator tree. A kept iterator is reused as is when
+  // it was created with the same read options without file filters, and the super version did
+  // not change since then. Otherwise its iterator tree is destroyed when it is released, and only
+  // its memory is reused.
+  //
+  // Default: 0 (iterators are not reused)
+  size_t max_pooled_iterators = 0;
+
+  // If true, the DB does not create write-ahead log files, and every write is performed as if
+  // WriteOptions::disableWAL was set. Only data in SST files survives a restart, so the
+  // application is responsible for replaying the writes that were not flushed, e.g. from its own
+  // log using the op ids of the flushed files. Existing log files are still recovered on open.
+  //
+  // Default: false
+  bool disable_wal = false;
+
+  // If true, SST files written by flushes and compactions bypass the OS page cache, so that this
+  // background IO does not evict the pages used by reads. Falls back to buffered writes when the
+  // file system does not support direct IO.
+  //
+  // Default: false
+  bool use_direct_io_for_flush_and_compaction = false;
 };
 
 // Options to control the behavior of a database (passed to DB::Open)
@@ -1524,7 +1589,12 @@ struct FlushOptions {
   // Default: true
   bool wait;
 
-  FlushOptions() : wait(true) {}
+  // If false, the mutable memtable is not switched, so only the immutable memtables are flushed,
+  // e.g. the ones that were rejected by DBOptions::mem_table_flush_filter earlier.
+  // Default: true
+  bool switch_memtable;
+
+  FlushOptions() : wait(true), switch_memtable(true) {}
 };
 
 // Get options based on some guidelines. Now only tune parameter based on
@@ -338,6 +338,9 @@ enum Histograms : uint32_t {
   BYTES_PER_READ,
   BYTES_PER_WRITE,
   BYTES_PER_MULTIGET,
+  // Number of iterator Next() and Seek() calls done by DocDB to read a row.
+  NEXTS_PER_ROW,
+  SEEKS_PER_ROW,
   HISTOGRAM_ENUM_MAX,  // TODO(ldemailly): enforce HistogramsNameMap match
 };
 
@@ -368,6 +371,8 @@ const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
     {BYTES_PER_READ, "rocksdb_bytes_per_read"},
     {BYTES_PER_WRITE, "rocksdb_bytes_per_write"},
     {BYTES_PER_MULTIGET, "rocksdb_bytes_per_multiget"},
+    {NEXTS_PER_ROW, "rocksdb_nexts_per_row"},
+    {SEEKS_PER_ROW, "rocksdb_seeks_per_row"},
 };
 
 struct HistogramData {
@@ -90,6 +90,11 @@ struct BlockBasedTableOptions {
     // The hash index, if enabled, will do the hash lookup when
     // `Options.prefix_extractor` is provided.
     kHashSearch,
+
+    // A two-level index: the data index is split into partitions of about `index_block_size`
+    // bytes, which are loaded through the block cache on demand, and a top-level index over the
+    // partitions, which is loaded the same way as a single-level index.
+    kTwoLevelIndexSearch,
   };
 
   IndexType index_type = kBinarySearch;
@@ -100,6 +105,13 @@ struct BlockBasedTableOptions {
   // (less memory consumption)
   bool hash_index_allow_collision = true;
 
+  // If non-nullptr, each data block loaded to the uncompressed block cache gets a hash index from
+  // the prefixes of its user keys, extracted by this transform, to the restart intervals holding
+  // them. A seek then only binary searches the restart points of the target key's prefix. The keys
+  // with the same prefix must be adjacent, and any key starting with the bytes of a prefix must
+  // map to it, e.g. a self-delimiting encoded key. Affects only how the blocks are read.
+  std::shared_ptr<const SliceTransform> data_block_hash_key_extractor = nullptr;
+
   // Use the specified checksum type. Newly created table files will be
   // protected with this checksum type. Old table files will still be readable,
   // even though they have different checksum type.
@@ -129,6 +141,15 @@ struct BlockBasedTableOptions {
   // Size of each filter block, in bytes. Only applicable for fixed size filter block.
   size_t filter_block_size = 64 * 1024;
 
+  // Approximate size of each data index partition, in bytes. Only applicable for
+  // kTwoLevelIndexSearch index type.
+  size_t index_block_size = 32 * 1024;
+
+  // Maximum number of bytes an iterator prefetches ahead of the data blocks it reads from the file,
+  // once it has read several consecutive data blocks. The prefetched size starts at the size of one
+  // block and doubles up to this value. Zero disables prefetching.
+  size_t max_scan_readahead_size = 0;
+
   // This is used to close a block before it reaches the configured
   // 'block_size'. If the percentage of free space in the current block is less
   // than this specified number and adding a new record to the block will
@@ -151,6 +172,14 @@ struct BlockBasedTableOptions {
   // Default: true
   bool use_delta_encoding = true;
 
+  // If true, the keys in data blocks also reuse the end of the previous key, possibly split by a
+  // few different bytes, on top of the delta encoding. E.g. the DocDB keys of the columns of a row
+  // written at the same hybrid time store it once, even though their write ids differ.
+  // The blocks written with this option can't be read by the versions that don't support it.
+  //
+  // Default: false
+  bool share_key_suffixes = false;
+
   // If non-nullptr, use the specified filter policy to reduce disk reads.
   // Many applications will benefit from passing the result of
   // NewBloomFilterPolicy() here.
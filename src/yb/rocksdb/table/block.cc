@@ -31,7 +31,10 @@
 #include <vector>
 
 #include "yb/rocksdb/comparator.h"
+#include "yb/rocksdb/slice_transform.h"
+#include "yb/rocksdb/db/dbformat.h"
 #include "yb/rocksdb/table/format.h"
+#include "yb/rocksdb/table/block_builder.h"
 #include "yb/rocksdb/table/block_hash_index.h"
 #include "yb/rocksdb/table/block_prefix_index.h"
 #include "yb/rocksdb/util/coding.h"
@@ -40,17 +43,36 @@
 
 namespace rocksdb {
 
+// The lengths of the parts at the end of a key in a block that shares key
+// suffixes, see the entry format in block_builder.cc.
+struct SharedKeySuffix {
+  uint32_t shared_middle = 0;
+  uint32_t unshared_tail = 0;
+  uint32_t shared_suffix = 0;
+
+  bool empty() const {
+    return (shared_middle | unshared_tail | shared_suffix) == 0;
+  }
+
+  uint32_t total() const {
+    return shared_middle + unshared_tail + shared_suffix;
+  }
+};
+
 // Helper routine: decode the next block entry starting at "p",
 // storing the number of shared key bytes, non_shared key bytes,
 // and the length of the value in "*shared", "*non_shared", and
 // "*value_length", respectively.  Will not derefence past "limit".
+// For the blocks that share key suffixes, also decodes the lengths of the
+// parts at the end of the key to "*suffix", which is null for other blocks.
 //
 // If any errors are detected, returns nullptr.  Otherwise, returns a
 // pointer to the key delta (just past the three decoded values).
 static inline const char* DecodeEntry(const char* p, const char* limit,
                                       uint32_t* shared,
                                       uint32_t* non_shared,
-                                      uint32_t* value_length) {
+                                      uint32_t* value_length,
+                                      SharedKeySuffix* suffix) {
   if (limit - p < 3) return nullptr;
   *shared = reinterpret_cast<const unsigned char*>(p)[0];
   *non_shared = reinterpret_cast<const unsigned char*>(p)[1];
@@ -63,6 +85,14 @@ static inline const char* DecodeEntry(const char* p, const char* limit,
     if ((p = GetVarint32Ptr(p, limit, non_shared)) == nullptr) return nullptr;
     if ((p = GetVarint32Ptr(p, limit, value_length)) == nullptr) return nullptr;
   }
+  if (suffix != nullptr) {
+    if ((p = GetVarint32Ptr(p, limit, &suffix->shared_middle)) == nullptr) return nullptr;
+    if ((p = GetVarint32Ptr(p, limit, &suffix->unshared_tail)) == nullptr) return nullptr;
+    if ((p = GetVarint32Ptr(p, limit, &suffix->shared_suffix)) == nullptr) return nullptr;
+    if (static_cast<uint32_t>(limit - p) < (*non_shared + suffix->unshared_tail + *value_length)) {
+      return nullptr;
+    }
+  }
 
   if (static_cast<uint32_t>(limit - p) < (*non_shared + *value_length)) {
     return nullptr;
@@ -105,6 +135,8 @@ void BlockIter::Seek(const Slice& target) {
   bool ok = false;
   if (prefix_index_) {
     ok = PrefixSeek(target, &index);
+  } else if (data_hash_index_) {
+    ok = DataHashSeek(target, &index);
   } else {
     ok = hash_index_ ? HashSeek(target, &index)
       : BinarySeek(target, 0, num_restarts_ - 1, &index);
@@ -162,12 +194,26 @@ bool BlockIter::ParseNextKey() {
 
   // Decode next entry
   uint32_t shared, non_shared, value_length;
-  p = DecodeEntry(p, limit, &shared, &non_shared, &value_length);
-  if (p == nullptr || key_.Size() < shared) {
+  SharedKeySuffix suffix;
+  p = DecodeEntry(p, limit, &shared, &non_shared, &value_length,
+                  shares_key_suffixes_ ? &suffix : nullptr);
+  if (p == nullptr || key_.Size() < shared + suffix.total()) {
     CorruptionError();
     return false;
   } else {
-    if (shared == 0) {
+    if (!suffix.empty()) {
+      // The new key is assembled aside, because it reuses the end of the previous key.
+      const Slice prev_key = key_.GetKey();
+      const char* prev_suffix = prev_key.cend() - suffix.shared_suffix;
+      key_buffer_.assign(prev_key.cdata(), shared);
+      key_buffer_.append(p, non_shared);
+      key_buffer_.append(prev_suffix - suffix.unshared_tail - suffix.shared_middle,
+                         suffix.shared_middle);
+      key_buffer_.append(p + non_shared, suffix.unshared_tail);
+      key_buffer_.append(prev_suffix, suffix.shared_suffix);
+      key_.SetKey(key_buffer_);
+      non_shared += suffix.unshared_tail;
+    } else if (shared == 0) {
       // If this key dont share any bytes with prev key then we dont need
       // to decode it and can use it's address in the block directly.
       key_.SetKey(Slice(p, non_shared), false /* copy */);
@@ -194,10 +240,12 @@ bool BlockIter::BinarySeek(const Slice& target, uint32_t left, uint32_t right,
     uint32_t mid = (left + right + 1) / 2;
     uint32_t region_offset = GetRestartPoint(mid);
     uint32_t shared, non_shared, value_length;
+    SharedKeySuffix suffix;
     const char* key_ptr =
         DecodeEntry(data_ + region_offset, data_ + restarts_, &shared,
-                    &non_shared, &value_length);
-    if (key_ptr == nullptr || (shared != 0)) {
+                    &non_shared, &value_length,
+                    shares_key_suffixes_ ? &suffix : nullptr);
+    if (key_ptr == nullptr || (shared != 0) || !suffix.empty()) {
       CorruptionError();
       return false;
     }
@@ -225,9 +273,11 @@ bool BlockIter::BinarySeek(const Slice& target, uint32_t left, uint32_t right,
 int BlockIter::CompareBlockKey(uint32_t block_index, const Slice& target) {
   uint32_t region_offset = GetRestartPoint(block_index);
   uint32_t shared, non_shared, value_length;
+  SharedKeySuffix suffix;
   const char* key_ptr = DecodeEntry(data_ + region_offset, data_ + restarts_,
-                                    &shared, &non_shared, &value_length);
-  if (key_ptr == nullptr || (shared != 0)) {
+                                    &shared, &non_shared, &value_length,
+                                    shares_key_suffixes_ ? &suffix : nullptr);
+  if (key_ptr == nullptr || (shared != 0) || !suffix.empty()) {
     CorruptionError();
     return 1;  // Return target is smaller
   }
@@ -302,6 +352,20 @@ bool BlockIter::HashSeek(const Slice& target, uint32_t* index) {
   return BinarySeek(target, left, right, index);
 }
 
+bool BlockIter::DataHashSeek(const Slice& target, uint32_t* index) {
+  assert(data_hash_index_);
+  auto restart_index = data_hash_index_->GetRestartIndex(ExtractUserKey(target));
+  if (restart_index == nullptr) {
+    return BinarySeek(target, 0, num_restarts_ - 1, index);
+  }
+
+  // The keys before the first restart interval of the prefix are smaller than the target, and the
+  // linear search continues after the last one when the target is past all keys of the prefix.
+  auto left = restart_index->first_index;
+  auto right = restart_index->first_index + restart_index->num_blocks - 1;
+  return BinarySeek(target, left, right, index);
+}
+
 bool BlockIter::PrefixSeek(const Slice& target, uint32_t* index) {
   assert(prefix_index_);
   uint32_t* block_ids = nullptr;
@@ -317,16 +381,21 @@ bool BlockIter::PrefixSeek(const Slice& target, uint32_t* index) {
 
 uint32_t Block::NumRestarts() const {
   assert(size_ >= 2*sizeof(uint32_t));
-  return DecodeFixed32(data_ + size_ - sizeof(uint32_t));
+  return DecodeFixed32(data_ + size_ - sizeof(uint32_t)) & ~kBlockSharesKeySuffixesFlag;
 }
 
 Block::Block(BlockContents&& contents)
     : contents_(std::move(contents)),
       data_(contents_.data.cdata()),
       size_(contents_.data.size()) {
-  if (size_ < sizeof(uint32_t)) {
+  if (contents_.compression_type != kNoCompression) {
+    // Compressed contents are only kept to be uncompressed later, they have no restart array.
+    restart_offset_ = 0;
+  } else if (size_ < sizeof(uint32_t)) {
     size_ = 0;  // Error marker
   } else {
+    shares_key_suffixes_ =
+        (DecodeFixed32(data_ + size_ - sizeof(uint32_t)) & kBlockSharesKeySuffixesFlag) != 0;
     restart_offset_ =
         static_cast<uint32_t>(size_) - (1 + NumRestarts()) * sizeof(uint32_t);
     if (restart_offset_ > size_ - sizeof(uint32_t)) {
@@ -368,6 +437,8 @@ InternalIterator* Block::NewIterator(const Comparator* cmp, BlockIter* iter,
       iter = new BlockIter(cmp, data_, restart_offset_, num_restarts,
                            hash_index_ptr, prefix_index_ptr);
     }
+    iter->SetDataHashIndex(data_hash_index_.get());
+    iter->SetSharesKeySuffixes(shares_key_suffixes_);
   }
 
   return iter;
@@ -381,6 +452,43 @@ void Block::SetBlockPrefixIndex(BlockPrefixIndex* prefix_index) {
   prefix_index_.reset(prefix_index);
 }
 
+void Block::BuildDataHashIndex(std::shared_ptr<const SliceTransform> hash_key_extractor) {
+  assert(hash_key_extractor);
+  if (size_ < 2 * sizeof(uint32_t) || compression_type() != kNoCompression) {
+    return;
+  }
+  std::unique_ptr<BlockHashIndex> hash_index(new BlockHashIndex(
+      hash_key_extractor.get(), true /* hash_index will copy prefix when Add() is called */));
+  std::string pending_prefix;
+  uint32_t pending_first_index = 0;
+  uint32_t pending_last_index = 0;
+  bool has_pending_prefix = false;
+
+  // Iterating the entries does not compare the keys, so no comparator is needed.
+  BlockIter iter;
+  NewIterator(nullptr /* comparator */, &iter);
+  for (iter.SeekToFirst(); iter.Valid(); iter.Next()) {
+    auto prefix = hash_key_extractor->Transform(ExtractUserKey(iter.key()));
+    if (has_pending_prefix && prefix == pending_prefix) {
+      pending_last_index = iter.restart_index();
+      continue;
+    }
+    if (has_pending_prefix && !hash_index->Add(
+        pending_prefix, pending_first_index, pending_last_index - pending_first_index + 1)) {
+      return;
+    }
+    pending_prefix.assign(prefix.cdata(), prefix.size());
+    pending_first_index = pending_last_index = iter.restart_index();
+    has_pending_prefix = true;
+  }
+  if (!iter.status().ok() || (has_pending_prefix && !hash_index->Add(
+      pending_prefix, pending_first_index, pending_last_index - pending_first_index + 1))) {
+    return;
+  }
+  data_hash_key_extractor_ = std::move(hash_key_extractor);
+  data_hash_index_ = std::move(hash_index);
+}
+
 size_t Block::ApproximateMemoryUsage() const {
   size_t usage = usable_size();
   if (hash_index_) {
@@ -389,6 +497,9 @@ size_t Block::ApproximateMemoryUsage() const {
   if (prefix_index_) {
     usage += prefix_index_->ApproximateMemoryUsage();
   }
+  if (data_hash_index_) {
+    usage += data_hash_index_->ApproximateMemoryUsage();
+  }
   return usage;
 }
 
@@ -45,6 +45,7 @@ class Comparator;
 class BlockIter;
 class BlockHashIndex;
 class BlockPrefixIndex;
+class SliceTransform;
 
 class Block {
  public:
@@ -88,6 +89,13 @@ class Block {
   void SetBlockHashIndex(BlockHashIndex* hash_index);
   void SetBlockPrefixIndex(BlockPrefixIndex* prefix_index);
 
+  // Builds the hash index of a data block from the user key prefixes extracted by
+  // hash_key_extractor to the restart intervals holding them, see
+  // BlockBasedTableOptions::data_block_hash_key_extractor. Unlike the index block hash index, it
+  // is used by the total order seeks too, and the seeks to the prefixes that are not in the block
+  // fall back to the binary search. Keeps the block unchanged if its prefixes are not adjacent.
+  void BuildDataHashIndex(std::shared_ptr<const SliceTransform> hash_key_extractor);
+
   // Report an approximation of how much memory has been used.
   size_t ApproximateMemoryUsage() const;
 
@@ -96,8 +104,13 @@ class Block {
   const char* data_;            // contents_.data.data()
   size_t size_;                 // contents_.data.size()
   uint32_t restart_offset_;     // Offset in data_ of restart array
+  bool shares_key_suffixes_ = false;
   std::unique_ptr<BlockHashIndex> hash_index_;
   std::unique_ptr<BlockPrefixIndex> prefix_index_;
+  // The data block hash index refers to hash_key_extractor_, so that the block can outlive the
+  // table options it was read with in the block cache.
+  std::shared_ptr<const SliceTransform> data_hash_key_extractor_;
+  std::unique_ptr<BlockHashIndex> data_hash_index_;
 
   // No copying allowed
   Block(const Block&);
@@ -115,7 +128,9 @@ class BlockIter : public InternalIterator {
         restart_index_(0),
         status_(Status::OK()),
         hash_index_(nullptr),
-        prefix_index_(nullptr) {}
+        prefix_index_(nullptr),
+        data_hash_index_(nullptr),
+        shares_key_suffixes_(false) {}
 
   BlockIter(const Comparator* comparator, const char* data, uint32_t restarts,
        uint32_t num_restarts, BlockHashIndex* hash_index,
@@ -139,6 +154,16 @@ class BlockIter : public InternalIterator {
     restart_index_ = num_restarts_;
     hash_index_ = hash_index;
     prefix_index_ = prefix_index;
+    data_hash_index_ = nullptr;
+    shares_key_suffixes_ = false;
+  }
+
+  void SetDataHashIndex(BlockHashIndex* data_hash_index) {
+    data_hash_index_ = data_hash_index;
+  }
+
+  void SetSharesKeySuffixes(bool shares_key_suffixes) {
+    shares_key_suffixes_ = shares_key_suffixes;
   }
 
   void SetStatus(Status s) {
@@ -178,6 +203,9 @@ class BlockIter : public InternalIterator {
 
   virtual bool IsKeyPinned() const override { return key_.IsKeyPinned(); }
 
+  // Index of the restart interval the current entry is in.
+  uint32_t restart_index() const { return restart_index_; }
+
  private:
   const Comparator* comparator_;
   const char* data_;       // underlying block contents
@@ -192,6 +220,11 @@ class BlockIter : public InternalIterator {
   Status status_;
   BlockHashIndex* hash_index_;
   BlockPrefixIndex* prefix_index_;
+  BlockHashIndex* data_hash_index_;
+  // Whether the keys of the block share their suffixes with the previous key.
+  bool shares_key_suffixes_;
+  // Assembles the keys that share their suffix with the previous key.
+  std::string key_buffer_;
 
   inline int Compare(const Slice& a, const Slice& b) const {
     return comparator_->Compare(a, b);
@@ -235,6 +268,7 @@ class BlockIter : public InternalIterator {
 
   bool PrefixSeek(const Slice& target, uint32_t* index);
 
+  bool DataHashSeek(const Slice& target, uint32_t* index);
 };
 
 }  // namespace rocksdb
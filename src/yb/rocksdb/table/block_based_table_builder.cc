@@ -109,6 +109,7 @@ bool GoodCompressionRatio(size_t compressed_size, size_t raw_size) {
 Slice CompressBlock(const Slice& raw,
                     const CompressionOptions& compression_options,
                     CompressionType* type, uint32_t format_version,
+                    const Slice& compression_dict,
                     std::string* compressed_output) {
   if (*type == kNoCompression) {
     return raw;
@@ -128,7 +129,7 @@ Slice CompressBlock(const Slice& raw,
       if (Zlib_Compress(
               compression_options,
               GetCompressFormatForVersion(kZlibCompression, format_version),
-              raw.cdata(), raw.size(), compressed_output) &&
+              raw.cdata(), raw.size(), compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -146,7 +147,7 @@ Slice CompressBlock(const Slice& raw,
       if (LZ4_Compress(
               compression_options,
               GetCompressFormatForVersion(kLZ4Compression, format_version),
-              raw.cdata(), raw.size(), compressed_output) &&
+              raw.cdata(), raw.size(), compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -155,14 +156,15 @@ Slice CompressBlock(const Slice& raw,
       if (LZ4HC_Compress(
               compression_options,
               GetCompressFormatForVersion(kLZ4HCCompression, format_version),
-              raw.cdata(), raw.size(), compressed_output) &&
+              raw.cdata(), raw.size(), compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
       break;     // fall back to no compression.
+    case kZSTD:
     case kZSTDNotFinalCompression:
       if (ZSTD_Compress(compression_options, raw.cdata(), raw.size(),
-                        compressed_output) &&
+                        compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -293,6 +295,8 @@ struct BlockBasedTableBuilder::Rep {
   std::string last_filter_key;
   const CompressionType compression_type;
   const CompressionOptions compression_opts;
+  // Data block compression dictionary, empty if there is none.
+  const std::string compression_dict;
   TableProperties props;
 
   bool closed = false;  // Either Finish() or Abandon() has been called.
@@ -314,6 +318,7 @@ struct BlockBasedTableBuilder::Rep {
       WritableFileWriter* data_file,
       const CompressionType _compression_type,
       const CompressionOptions& _compression_opts,
+      const std::string* _compression_dict,
       const bool skip_filters)
       : ioptions(_ioptions),
         table_options(table_opt),
@@ -322,22 +327,24 @@ struct BlockBasedTableBuilder::Rep {
         filter_block_builder(skip_filters ? nullptr : CreateFilterBlockBuilder(
             _ioptions, table_options, filter_type)),
         data_block_builder(table_options.block_restart_interval,
-                   table_options.use_delta_encoding),
+                   table_options.use_delta_encoding, table_options.share_key_suffixes),
         internal_prefix_transform(_ioptions.prefix_extractor),
         filter_key_transformer(table_opt.filter_policy ?
             table_opt.filter_policy->GetKeyTransformer() : nullptr),
         data_index_builder(
             IndexBuilder::CreateIndexBuilder(
                 table_options.index_type, &internal_comparator, &internal_prefix_transform,
-                table_options.index_block_restart_interval)),
+                table_options.index_block_restart_interval, table_options.index_block_size)),
         filter_index_builder(
             // Prefix_extractor is not used by binary search index which we use for bloom filter
             // blocks indexing.
             IndexBuilder::CreateIndexBuilder(
                 BlockBasedTableOptions::kBinarySearch, BytewiseComparator(),
-                nullptr /* prefix_extractor */, table_options.index_block_restart_interval)),
+                nullptr /* prefix_extractor */, table_options.index_block_restart_interval,
+                table_options.index_block_size)),
         compression_type(_compression_type),
         compression_opts(_compression_opts),
+        compression_dict(_compression_dict == nullptr ? std::string() : *_compression_dict),
         flush_block_policy(
             table_options.flush_block_policy_factory->NewFlushBlockPolicy(
                 table_options, data_block_builder)) {
@@ -372,6 +379,7 @@ BlockBasedTableBuilder::BlockBasedTableBuilder(
     WritableFileWriter* data_file,
     const CompressionType compression_type,
     const CompressionOptions& compression_opts,
+    const std::string* compression_dict,
     const bool skip_filters) {
   BlockBasedTableOptions sanitized_table_options(table_options);
   if (sanitized_table_options.format_version == 0 &&
@@ -386,7 +394,7 @@ BlockBasedTableBuilder::BlockBasedTableBuilder(
 
   rep_ = new Rep(ioptions, sanitized_table_options, internal_comparator,
                  int_tbl_prop_collector_factories, column_family_id, metadata_file, data_file,
-                 compression_type, compression_opts, skip_filters);
+                 compression_type, compression_opts, compression_dict, skip_filters);
 
   if (rep_->filter_block_builder != nullptr) {
     rep_->filter_block_builder->StartBlock(0);
@@ -518,14 +526,15 @@ void BlockBasedTableBuilder::FlushFilterBlock(const Slice& next_block_first_key)
 size_t BlockBasedTableBuilder::WriteBlock(BlockBuilder* block,
                                           BlockHandle* handle,
                                           FileWriterWithOffsetAndCachePrefix* writer_info) {
-  size_t block_size = WriteBlock(block->Finish(), handle, writer_info);
+  size_t block_size = WriteBlock(block->Finish(), handle, writer_info, rep_->compression_dict);
   block->Reset();
   return block_size;
 }
 
 size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
                                           BlockHandle* handle,
-                                          FileWriterWithOffsetAndCachePrefix* writer_info) {
+                                          FileWriterWithOffsetAndCachePrefix* writer_info,
+                                          const Slice& compression_dict) {
   // File format contains a sequence of blocks where each block has:
   //    block_data: uint8[n]
   //    type: uint8
@@ -538,7 +547,8 @@ size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
   if (raw_block_contents.size() < kCompressionSizeLimit) {
     block_contents =
         CompressBlock(raw_block_contents, r->compression_opts, &type,
-                      r->table_options.format_version, &r->compressed_output);
+                      r->table_options.format_version, compression_dict,
+                      &r->compressed_output);
   } else {
     RecordTick(r->ioptions.statistics, NUMBER_BLOCK_NOT_COMPRESSED);
     type = kNoCompression;
@@ -664,6 +674,16 @@ Status BlockBasedTableBuilder::Finish() {
   BlockHandle meta_index_block_handle, data_index_block_handle;
   IndexBuilder::IndexBlocks index_blocks;
   auto s = r->data_index_builder->Finish(&index_blocks);
+  // Write index partitions of multi-level index, if any.
+  while (s.IsIncomplete() && ok()) {
+    BlockHandle partition_block_handle;
+    WriteBlock(index_blocks.index_block_contents, &partition_block_handle,
+        r->metadata_writer.get());
+    s = r->data_index_builder->Finish(&index_blocks, partition_block_handle);
+  }
+  if (!ok()) {
+    return r->status;
+  }
   if (!s.ok()) {
     return s;
   }
@@ -671,8 +691,9 @@ Status BlockBasedTableBuilder::Finish() {
   // Write meta blocks and metaindex block with the following order.
   //    1. [meta block: filter]
   //    2. [other meta blocks]
-  //    3. [meta block: properties]
-  //    4. [metaindex block]
+  //    3. [meta block: compression dictionary]
+  //    4. [meta block: properties]
+  //    5. [metaindex block]
   // write meta blocks
   MetaIndexBuilder meta_index_builder;
   for (const auto& item : index_blocks.meta_blocks) {
@@ -722,6 +743,14 @@ Status BlockBasedTableBuilder::Finish() {
       }
     }
 
+    // Write compression dictionary block.
+    if (!r->compression_dict.empty()) {
+      BlockHandle compression_dict_block_handle;
+      WriteRawBlock(r->compression_dict, kNoCompression, &compression_dict_block_handle,
+          r->metadata_writer.get());
+      meta_index_builder.Add(kCompressionDictBlock, compression_dict_block_handle);
+    }
+
     // Write properties block.
     {
       PropertyBlockBuilder property_block_builder;
@@ -58,7 +58,9 @@ class BlockBasedTableBuilder : public TableBuilder {
       uint32_t column_family_id, WritableFileWriter* metadata_file,
       WritableFileWriter* data_file,
       const CompressionType compression_type,
-      const CompressionOptions& compression_opts, const bool skip_filters);
+      const CompressionOptions& compression_opts,
+      const std::string* compression_dict,
+      const bool skip_filters);
 
   // REQUIRES: Either Finish() or Abandon() has been called.
   ~BlockBasedTableBuilder();
@@ -111,8 +113,10 @@ class BlockBasedTableBuilder : public TableBuilder {
   size_t WriteBlock(BlockBuilder* block, BlockHandle* handle,
       FileWriterWithOffsetAndCachePrefix* writer_info);
   // Directly write block content to the file. Returns number of bytes written to file.
+  // compression_dict is only used for data blocks.
   size_t WriteBlock(const Slice& block_contents, BlockHandle* handle,
-      FileWriterWithOffsetAndCachePrefix* writer_info);
+      FileWriterWithOffsetAndCachePrefix* writer_info,
+      const Slice& compression_dict = Slice());
   size_t WriteRawBlock(const Slice& data, CompressionType, BlockHandle* handle,
       FileWriterWithOffsetAndCachePrefix* writer_info);
   Status InsertBlockInCache(const Slice& block_contents,
@@ -31,6 +31,7 @@
 #include "yb/rocksdb/port/port.h"
 #include "yb/rocksdb/flush_block_policy.h"
 #include "yb/rocksdb/cache.h"
+#include "yb/rocksdb/slice_transform.h"
 #include "yb/rocksdb/table/block_based_table_builder.h"
 #include "yb/rocksdb/table/block_based_table_reader.h"
 #include "yb/rocksdb/table/format.h"
@@ -97,6 +98,7 @@ TableBuilder* BlockBasedTableFactory::NewTableBuilder(
       data_file,
       table_builder_options.compression_type,
       table_builder_options.compression_opts,
+      table_builder_options.compression_dict,
       table_builder_options.skip_filters);
 
   return table_builder;
@@ -142,6 +144,10 @@ std::string BlockBasedTableFactory::GetPrintableTableOptions() const {
   snprintf(buffer, kBufferSize, "  hash_index_allow_collision: %d\n",
            table_options_.hash_index_allow_collision);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  data_block_hash_key_extractor: %s\n",
+           table_options_.data_block_hash_key_extractor == nullptr ?
+             "nullptr" : table_options_.data_block_hash_key_extractor->Name());
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  checksum: %d\n",
            table_options_.checksum);
   ret.append(buffer);
@@ -168,12 +174,21 @@ std::string BlockBasedTableFactory::GetPrintableTableOptions() const {
   snprintf(buffer, kBufferSize, "  block_size: %" ROCKSDB_PRIszt "\n",
            table_options_.block_size);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  index_block_size: %" ROCKSDB_PRIszt "\n",
+           table_options_.index_block_size);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  max_scan_readahead_size: %" ROCKSDB_PRIszt "\n",
+           table_options_.max_scan_readahead_size);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  block_size_deviation: %d\n",
            table_options_.block_size_deviation);
   ret.append(buffer);
   snprintf(buffer, kBufferSize, "  block_restart_interval: %d\n",
            table_options_.block_restart_interval);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  share_key_suffixes: %d\n",
+           table_options_.share_key_suffixes);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  index_block_restart_interval: %d\n",
            table_options_.index_block_restart_interval);
   ret.append(buffer);
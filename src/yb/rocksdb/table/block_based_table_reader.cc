@@ -23,6 +23,7 @@
 
 #include "yb/rocksdb/table/block_based_table_reader.h"
 
+#include <algorithm>
 #include <string>
 #include <utility>
 #include <cinttypes>
@@ -217,8 +218,13 @@ struct BlockBasedTable::Rep {
   // types.
   BlockHandle filter_handle;
 
+  // Dictionary used to compress data blocks, empty if the file was written without one.
+  std::string compression_dict;
+
   std::shared_ptr<const TableProperties> table_properties;
   BlockBasedTableOptions::IndexType index_type;
+  // Type of the data index stored in the file.
+  BlockBasedTableOptions::IndexType data_index_type = BlockBasedTableOptions::kBinarySearch;
   bool hash_index_allow_collision;
   bool whole_key_filtering;
   bool prefix_filtering;
@@ -369,6 +375,22 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
     }
   }
 
+  // Read the compression dictionary.
+  BlockHandle compression_dict_handle;
+  if (FindMetaBlock(meta_iter.get(), kCompressionDictBlock, &compression_dict_handle).ok()) {
+    BlockContents compression_dict_contents;
+    s = ReadBlockContents(rep->base_reader_with_cache_prefix->reader.get(), rep->footer,
+        ReadOptions::kDefault, compression_dict_handle, &compression_dict_contents,
+        rep->ioptions.env, false /* do_uncompress */);
+    if (!s.ok()) {
+      RLOG(InfoLogLevel::ERROR_LEVEL, rep->ioptions.info_log,
+          "Encountered error while reading compression dictionary block %s",
+          s.ToString().c_str());
+      return s;
+    }
+    rep->compression_dict = compression_dict_contents.data.ToBuffer();
+  }
+
   // Read the properties
   bool found_properties_block = true;
   s = SeekToPropertiesBlock(meta_iter.get(), &found_properties_block);
@@ -397,6 +419,17 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
         "Cannot find Properties block from file.");
   }
 
+  // Some old version of block-based tables don't have index type present in
+  // table properties. If that's the case we can safely use the kBinarySearch.
+  if (rep->table_properties) {
+    auto& props = rep->table_properties->user_collected_properties;
+    auto pos = props.find(BlockBasedTablePropertyNames::kIndexType);
+    if (pos != props.end()) {
+      rep->data_index_type = static_cast<BlockBasedTableOptions::IndexType>(
+          DecodeFixed32(pos->second.c_str()));
+    }
+  }
+
   // Determine whether whole key filtering is supported.
   if (rep->table_properties) {
     rep->whole_key_filtering &=
@@ -587,7 +620,9 @@ Status BlockBasedTable::GetDataBlockFromCache(
     const Slice& block_cache_key, const Slice& compressed_block_cache_key,
     Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
     const ReadOptions& read_options,
-    BlockBasedTable::CachableEntry<Block>* block, uint32_t format_version) {
+    BlockBasedTable::CachableEntry<Block>* block, uint32_t format_version,
+    const Slice& compression_dict,
+    const std::shared_ptr<const SliceTransform>& data_block_hash_key_extractor) {
   Status s;
   Block* compressed_block = nullptr;
   Cache::Handle* block_cache_compressed_handle = nullptr;
@@ -631,7 +666,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
   BlockContents contents;
   s = UncompressBlockContents(compressed_block->data(),
                               compressed_block->size(), &contents,
-                              format_version);
+                              format_version, compression_dict);
 
   // Insert uncompressed block into block cache
   if (s.ok()) {
@@ -639,8 +674,11 @@ Status BlockBasedTable::GetDataBlockFromCache(
     assert(block->value->compression_type() == kNoCompression);
     if (block_cache != nullptr && block->value->cachable() &&
         read_options.fill_cache) {
+      if (data_block_hash_key_extractor) {
+        block->value->BuildDataHashIndex(data_block_hash_key_extractor);
+      }
       s = block_cache->Insert(block_cache_key, read_options.query_id, block->value,
-                              block->value->usable_size(), &DeleteCachedEntry<Block>,
+                              block->value->ApproximateMemoryUsage(), &DeleteCachedEntry<Block>,
                               &block->cache_handle, statistics);
       if (!s.ok()) {
         delete block->value;
@@ -658,7 +696,9 @@ Status BlockBasedTable::PutDataBlockToCache(
     const Slice& block_cache_key, const Slice& compressed_block_cache_key,
     Cache* block_cache, Cache* block_cache_compressed,
     const ReadOptions& read_options, Statistics* statistics,
-    CachableEntry<Block>* block, Block* raw_block, uint32_t format_version) {
+    CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
+    const Slice& compression_dict,
+    const std::shared_ptr<const SliceTransform>& data_block_hash_key_extractor) {
   assert(raw_block->compression_type() == kNoCompression ||
          block_cache_compressed != nullptr);
 
@@ -667,7 +707,7 @@ Status BlockBasedTable::PutDataBlockToCache(
   BlockContents contents;
   if (raw_block->compression_type() != kNoCompression) {
     s = UncompressBlockContents(raw_block->data(), raw_block->size(), &contents,
-                                format_version);
+                                format_version, compression_dict);
   }
   if (!s.ok()) {
     delete raw_block;
@@ -685,11 +725,13 @@ Status BlockBasedTable::PutDataBlockToCache(
   // Release the hold on the compressed cache entry immediately.
   if (block_cache_compressed != nullptr && raw_block != nullptr &&
       raw_block->cachable()) {
-    s = block_cache_compressed->Insert(compressed_block_cache_key, read_options.query_id, raw_block,
-                                       raw_block->usable_size(), &DeleteCachedEntry<Block>);
-    if (s.ok()) {
-      // Avoid the following code to delete this cached block.
-      raw_block = nullptr;
+    // Without a handle the cache takes ownership of the block even if the insert fails, and a
+    // failure to fill the compressed cache should not fail the read.
+    Status compressed_status = block_cache_compressed->Insert(
+        compressed_block_cache_key, read_options.query_id, raw_block, raw_block->usable_size(),
+        &DeleteCachedEntry<Block>);
+    raw_block = nullptr;
+    if (compressed_status.ok()) {
       RecordTick(statistics, BLOCK_CACHE_COMPRESSED_ADD);
     } else {
       RecordTick(statistics, BLOCK_CACHE_COMPRESSED_ADD_FAILURES);
@@ -700,8 +742,11 @@ Status BlockBasedTable::PutDataBlockToCache(
   // insert into uncompressed block cache
   assert((block->value->compression_type() == kNoCompression));
   if (block_cache != nullptr && block->value->cachable()) {
+    if (data_block_hash_key_extractor) {
+      block->value->BuildDataHashIndex(data_block_hash_key_extractor);
+    }
     s = block_cache->Insert(block_cache_key, read_options.query_id, block->value,
-                            block->value->usable_size(),
+                            block->value->ApproximateMemoryUsage(),
                             &DeleteCachedEntry<Block>, &block->cache_handle, statistics);
     if (!s.ok()) {
       delete block->value;
@@ -904,8 +949,45 @@ InternalIterator* ReturnNoIOErrorIterator(BlockIter* input_iter) {
 
 } // namespace
 
+class BlockBasedTable::IndexPartitionIteratorState : public TwoLevelIteratorState {
+ public:
+  IndexPartitionIteratorState(BlockBasedTable* table, const ReadOptions& read_options)
+      : TwoLevelIteratorState(false /* check_prefix_may_match */),
+        table_(table),
+        read_options_(read_options) {}
+
+  InternalIterator* NewSecondaryIterator(const Slice& index_value) override {
+    // Index partitions are stored in the metadata file.
+    return table_->NewBlockIterator(read_options_, index_value,
+                                    table_->rep_->base_reader_with_cache_prefix.get(),
+                                    nullptr /* input_iter */);
+  }
+
+  bool PrefixMayMatch(const Slice& internal_key) override {
+    return true;
+  }
+
+ private:
+  // Don't own table_
+  BlockBasedTable* const table_;
+  const ReadOptions read_options_;
+};
+
 InternalIterator* BlockBasedTable::NewIndexIterator(
     const ReadOptions& read_options, BlockIter* input_iter) {
+  if (rep_->data_index_type != BlockBasedTableOptions::kTwoLevelIndexSearch) {
+    return NewIndexBlockIterator(read_options, input_iter);
+  }
+  // The top-level index is loaded the same way as single-level index (i.e. preloaded or kept in
+  // the block cache), while index partitions are read through the block cache on demand.
+  return NewTwoLevelIterator(
+      new IndexPartitionIteratorState(this, read_options),
+      NewIndexBlockIterator(read_options), nullptr /* arena */,
+      true /* need_free_iter_and_state */);
+}
+
+InternalIterator* BlockBasedTable::NewIndexBlockIterator(
+    const ReadOptions& read_options, BlockIter* input_iter) {
   // index reader has already been pre-populated.
   IndexReader* index_reader = rep_->data_index_reader.get(std::memory_order_acquire);
   if (index_reader) {
@@ -990,6 +1072,60 @@ InternalIterator* BlockBasedTable::NewIndexIterator(
 // If input_iter is not null, update this iter and return it
 InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
     const Slice& index_value, BlockIter* input_iter) {
+  return NewBlockIterator(ro, index_value, rep_->data_reader_with_cache_prefix.get(), input_iter);
+}
+
+// Detects that an iterator reads consecutive data blocks and prefetches the blocks that follow, so
+// that a scan missing the block cache does not wait for the device on each block. The prefetched
+// size starts at the size of one block and doubles up to max_scan_readahead_size.
+class BlockBasedTable::ScanReadahead {
+ public:
+  explicit ScanReadahead(size_t max_size) : max_size_(max_size) {}
+
+  // Should be called for each block the iterator moves to.
+  void BlockUsed(const BlockHandle& handle) {
+    if (handle.offset() != next_block_offset_) {
+      num_sequential_blocks_ = 0;
+      readahead_size_ = 0;
+      prefetched_end_ = 0;
+    }
+    ++num_sequential_blocks_;
+    next_block_offset_ = handle.offset() + handle.size() + kBlockTrailerSize;
+  }
+
+  // Should be called after BlockUsed(), when the block is read from the file.
+  void BlockRead(const BlockHandle& handle, const RandomAccessFileReader* reader) {
+    if (max_size_ == 0 || num_sequential_blocks_ < kMinSequentialBlocks) {
+      return;
+    }
+    // Keep at least half of the last prefetched size ahead of the iterator.
+    if (next_block_offset_ + readahead_size_ / 2 < prefetched_end_) {
+      return;
+    }
+    readahead_size_ = readahead_size_ == 0
+        ? handle.size() + kBlockTrailerSize : std::min(readahead_size_ * 2, max_size_);
+    const uint64_t start = std::max(next_block_offset_, prefetched_end_);
+    const uint64_t end = next_block_offset_ + readahead_size_;
+    if (start < end) {
+      reader->Prefetch(start, end - start);
+      prefetched_end_ = end;
+    }
+  }
+
+ private:
+  // Number of consecutive blocks after which reads are considered to be sequential.
+  static constexpr size_t kMinSequentialBlocks = 2;
+
+  const size_t max_size_;
+  uint64_t next_block_offset_ = 0;
+  size_t num_sequential_blocks_ = 0;
+  size_t readahead_size_ = 0;
+  uint64_t prefetched_end_ = 0;
+};
+
+InternalIterator* BlockBasedTable::NewBlockIterator(const ReadOptions& ro,
+    const Slice& index_value, FileReaderWithCachePrefix* reader_with_cache_prefix,
+    BlockIter* input_iter, ScanReadahead* readahead) {
   PERF_TIMER_GUARD(new_table_block_iter_nanos);
 
   const bool no_io = (ro.read_tier == kBlockCacheTier);
@@ -1013,6 +1149,10 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
     }
   }
 
+  if (readahead != nullptr) {
+    readahead->BlockUsed(handle);
+  }
+
   // If either block cache is enabled, we'll try to read from it.
   if (block_cache != nullptr || block_cache_compressed != nullptr) {
     Statistics* statistics = rep_->ioptions.statistics;
@@ -1023,31 +1163,41 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
 
     // create key for block cache
     if (block_cache != nullptr) {
-      key = GetCacheKey(rep_->data_reader_with_cache_prefix->cache_key_prefix, handle, cache_key);
+      key = GetCacheKey(reader_with_cache_prefix->cache_key_prefix, handle, cache_key);
     }
 
     if (block_cache_compressed != nullptr) {
-      ckey = GetCacheKey(rep_->data_reader_with_cache_prefix->compressed_cache_key_prefix, handle,
+      ckey = GetCacheKey(reader_with_cache_prefix->compressed_cache_key_prefix, handle,
           compressed_cache_key);
     }
 
+    // Index partitions are read the same way, but only data blocks get the hash index.
+    static const std::shared_ptr<const SliceTransform> kNoHashKeyExtractor;
+    const auto& data_block_hash_key_extractor =
+        reader_with_cache_prefix == rep_->data_reader_with_cache_prefix.get()
+            ? rep_->table_options.data_block_hash_key_extractor : kNoHashKeyExtractor;
     s = GetDataBlockFromCache(key, ckey, block_cache, block_cache_compressed,
                               statistics, ro, &block,
-                              rep_->table_options.format_version);
+                              rep_->table_options.format_version, rep_->compression_dict,
+                              data_block_hash_key_extractor);
 
     if (block.value == nullptr && !no_io && ro.fill_cache) {
       std::unique_ptr<Block> raw_block;
+      if (readahead != nullptr) {
+        readahead->BlockRead(handle, reader_with_cache_prefix->reader.get());
+      }
       {
         StopWatch sw(rep_->ioptions.env, statistics, READ_BLOCK_GET_MICROS);
-        s = block_based_table::ReadBlockFromFile(rep_->data_reader_with_cache_prefix->reader.get(),
+        s = block_based_table::ReadBlockFromFile(reader_with_cache_prefix->reader.get(),
             rep_->footer, ro, handle, &raw_block, rep_->ioptions.env,
-            block_cache_compressed == nullptr);
+            block_cache_compressed == nullptr, rep_->compression_dict);
       }
 
       if (s.ok()) {
         s = PutDataBlockToCache(key, ckey, block_cache, block_cache_compressed,
                                 ro, statistics, &block, raw_block.release(),
-                                rep_->table_options.format_version);
+                                rep_->table_options.format_version, rep_->compression_dict,
+                                data_block_hash_key_extractor);
       }
     }
   }
@@ -1064,9 +1214,12 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
       }
     }
     std::unique_ptr<Block> block_value;
+    if (readahead != nullptr) {
+      readahead->BlockRead(handle, reader_with_cache_prefix->reader.get());
+    }
     s = block_based_table::ReadBlockFromFile(
-        rep_->data_reader_with_cache_prefix->reader.get(), rep_->footer, ro, handle, &block_value,
-        rep_->ioptions.env);
+        reader_with_cache_prefix->reader.get(), rep_->footer, ro, handle, &block_value,
+        rep_->ioptions.env, true /* do_uncompress */, rep_->compression_dict);
     if (s.ok()) {
       block.value = block_value.release();
     }
@@ -1100,10 +1253,13 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
                               nullptr),
         table_(table),
         read_options_(read_options),
-        skip_filters_(skip_filters) {}
+        skip_filters_(skip_filters),
+        readahead_(table->rep_->table_options.max_scan_readahead_size) {}
 
   InternalIterator* NewSecondaryIterator(const Slice& index_value) override {
-    return table_->NewDataBlockIterator(read_options_, index_value);
+    return table_->NewBlockIterator(
+        read_options_, index_value, table_->rep_->data_reader_with_cache_prefix.get(),
+        nullptr /* input_iter */, &readahead_);
   }
 
   bool PrefixMayMatch(const Slice& internal_key) override {
@@ -1118,6 +1274,7 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
   BlockBasedTable* const table_;
   const ReadOptions read_options_;
   const bool skip_filters_;
+  ScanReadahead readahead_;
 };
 
 // This will be broken if the user specifies an unusual implementation
@@ -1271,8 +1428,11 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& intern
     RecordTick(rep_->ioptions.statistics, BLOOM_FILTER_USEFUL);
   } else {
     // Either filter is block-based or key may match.
-    BlockIter iiter;
-    NewIndexIterator(read_options, &iiter);
+    BlockIter index_block_iter;
+    InternalIterator* const index_iter = NewIndexIterator(read_options, &index_block_iter);
+    std::unique_ptr<InternalIterator> index_iter_holder(
+        index_iter != &index_block_iter ? index_iter : nullptr);
+    InternalIterator& iiter = *index_iter;
 
     bool done = false;
     for (iiter.Seek(internal_key); iiter.Valid() && !done; iiter.Next()) {
@@ -1343,8 +1503,11 @@ Status BlockBasedTable::Prefetch(const Slice* const begin,
     return STATUS(InvalidArgument, *begin, *end);
   }
 
-  BlockIter iiter;
-  NewIndexIterator(ReadOptions::kDefault, &iiter);
+  BlockIter index_block_iter;
+  InternalIterator* const index_iter = NewIndexIterator(ReadOptions::kDefault, &index_block_iter);
+  std::unique_ptr<InternalIterator> index_iter_holder(
+      index_iter != &index_block_iter ? index_iter : nullptr);
+  InternalIterator& iiter = *index_iter;
 
   if (!iiter.status().ok()) {
     // error opening index iterator
@@ -1401,7 +1564,8 @@ bool BlockBasedTable::TEST_KeyInCache(const ReadOptions& options,
   Slice ckey;
 
   s = GetDataBlockFromCache(cache_key, ckey, block_cache, nullptr, nullptr, options, &block,
-      rep_->table_options.format_version);
+      rep_->table_options.format_version, rep_->compression_dict,
+      nullptr /* data_block_hash_key_extractor */);
   assert(s.ok());
   bool in_cache = block.value != nullptr;
   if (in_cache) {
@@ -1418,17 +1582,7 @@ bool BlockBasedTable::TEST_KeyInCache(const ReadOptions& options,
 //  5. index_type
 Status BlockBasedTable::CreateDataBlockIndexReader(
     std::unique_ptr<IndexReader>* index_reader, InternalIterator* preloaded_meta_index_iter) {
-  // Some old version of block-based tables don't have index type present in
-  // table properties. If that's the case we can safely use the kBinarySearch.
-  auto index_type_on_file = BlockBasedTableOptions::kBinarySearch;
-  if (rep_->table_properties) {
-    auto& props = rep_->table_properties->user_collected_properties;
-    auto pos = props.find(BlockBasedTablePropertyNames::kIndexType);
-    if (pos != props.end()) {
-      index_type_on_file = static_cast<BlockBasedTableOptions::IndexType>(
-          DecodeFixed32(pos->second.c_str()));
-    }
-  }
+  auto index_type_on_file = rep_->data_index_type;
 
   auto file = rep_->base_reader_with_cache_prefix->reader.get();
   auto env = rep_->ioptions.env;
@@ -1445,7 +1599,10 @@ Status BlockBasedTable::CreateDataBlockIndexReader(
   }
 
   switch (index_type_on_file) {
-    case BlockBasedTableOptions::kBinarySearch: {
+    case BlockBasedTableOptions::kBinarySearch: FALLTHROUGH_INTENDED;
+    case BlockBasedTableOptions::kTwoLevelIndexSearch: {
+      // For two-level index this reads the top-level index, which has the same format as
+      // single-level binary search index. Partitions are read by NewIndexIterator.
       return BinarySearchIndexReader::Create(
           file, footer, footer.index_handle(), env, comparator, index_reader);
     }
@@ -1517,6 +1674,31 @@ uint64_t BlockBasedTable::ApproximateOffsetOf(const Slice& key) {
   return result;
 }
 
+Status BlockBasedTable::ApproximateKeyAnchors(size_t max_anchors,
+                                              std::vector<std::string>* anchors) {
+  if (max_anchors == 0) {
+    return Status::OK();
+  }
+  unique_ptr<InternalIterator> index_iter(NewIndexBlockIterator(ReadOptions::kDefault));
+  size_t num_entries = 0;
+  for (index_iter->SeekToFirst(); index_iter->Valid(); index_iter->Next()) {
+    ++num_entries;
+  }
+  if (!index_iter->status().ok()) {
+    return index_iter->status();
+  }
+
+  // Take every step-th index key, so at most max_anchors of them.
+  const size_t step = std::max<size_t>((num_entries + max_anchors - 1) / max_anchors, 1);
+  size_t index = 0;
+  for (index_iter->SeekToFirst(); index_iter->Valid(); index_iter->Next()) {
+    if (++index % step == 0) {
+      anchors->push_back(index_iter->key().ToBuffer());
+    }
+  }
+  return index_iter->status();
+}
+
 bool BlockBasedTable::TEST_filter_block_preloaded() const {
   return rep_->filter != nullptr;
 }
@@ -161,6 +161,9 @@ class BlockBasedTable : public TableReader {
   // be close to the file length.
   uint64_t ApproximateOffsetOf(const Slice& key) override;
 
+  // Uses the keys of the data index, or of the top-level index for a two-level index.
+  Status ApproximateKeyAnchors(size_t max_anchors, std::vector<std::string>* anchors) override;
+
   // Returns true if the block for the specified key is in cache.
   // REQUIRES: key is in this table && block cache enabled
   bool TEST_KeyInCache(const ReadOptions& options, const Slice& key);
@@ -197,6 +200,8 @@ class BlockBasedTable : public TableReader {
   Rep* rep_;
 
   class BlockEntryIteratorState;
+  class IndexPartitionIteratorState;
+  class ScanReadahead;
 
   // Returns filter block handle for fixed-size bloom filter using filter index and filter key.
   Status GetFixedSizeFilterBlockHandle(const Slice& filter_key,
@@ -228,9 +233,25 @@ class BlockBasedTable : public TableReader {
   //  2. index is not present in block cache.
   //  3. We disallowed any io to be performed, that is, read_options ==
   //     kBlockCacheTier
+  //
+  // For a two-level index, input_iter is only used for the top-level index, and the returned
+  // iterator is always a new one.
   InternalIterator* NewIndexIterator(const ReadOptions& read_options,
                                      BlockIter* input_iter = nullptr);
 
+  // Same as NewIndexIterator, but in case of two-level index iterates over the top-level index.
+  InternalIterator* NewIndexBlockIterator(const ReadOptions& read_options,
+                                          BlockIter* input_iter = nullptr);
+
+  // Converts a block handle encoded in index_value into an iterator over the block of the file
+  // from reader_with_cache_prefix, reading the block through the block cache.
+  // readahead: if set, prefetches the blocks that follow when the block has to be read from the
+  // file.
+  InternalIterator* NewBlockIterator(
+      const ReadOptions& ro, const Slice& index_value,
+      FileReaderWithCachePrefix* reader_with_cache_prefix, BlockIter* input_iter,
+      ScanReadahead* readahead = nullptr);
+
   // Read block cache from block caches (if set): block_cache and
   // block_cache_compressed.
   // On success, Status::OK with be returned and @block will be populated with
@@ -239,7 +260,9 @@ class BlockBasedTable : public TableReader {
       const Slice& block_cache_key, const Slice& compressed_block_cache_key,
       Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
       const ReadOptions& read_options,
-      BlockBasedTable::CachableEntry<Block>* block, uint32_t format_version);
+      BlockBasedTable::CachableEntry<Block>* block, uint32_t format_version,
+      const Slice& compression_dict,
+      const std::shared_ptr<const SliceTransform>& data_block_hash_key_extractor);
   // Put a raw block (maybe compressed) to the corresponding block caches.
   // This method will perform decompression against raw_block if needed and then
   // populate the block caches.
@@ -252,7 +275,9 @@ class BlockBasedTable : public TableReader {
       const Slice& block_cache_key, const Slice& compressed_block_cache_key,
       Cache* block_cache, Cache* block_cache_compressed,
       const ReadOptions& read_options, Statistics* statistics,
-      CachableEntry<Block>* block, Block* raw_block, uint32_t format_version);
+      CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
+      const Slice& compression_dict,
+      const std::shared_ptr<const SliceTransform>& data_block_hash_key_extractor);
 
   // Calls (*handle_result)(arg, ...) repeatedly, starting with the entry found
   // after a call to Seek(key), until handle_result returns false.
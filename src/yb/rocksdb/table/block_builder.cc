@@ -40,10 +40,30 @@
 //     value: char[value_length]
 // shared_bytes == 0 for restart points.
 //
+// When the block shares key suffixes, the key of an entry also reuses the
+// end of the previous key, e.g. the hybrid time and the sequence number of a
+// DocDB key, which are only split by a different write id. The key is:
+//     prev_key[0, shared_bytes) + key_delta +
+//     prev_key[prev_size - shared_suffix_bytes - unshared_tail_bytes -
+//              shared_middle_bytes, shared_middle_bytes) +
+//     key_tail + prev_key[prev_size - shared_suffix_bytes, prev_size)
+// and the entry has the form:
+//     shared_bytes: varint32
+//     unshared_bytes: varint32
+//     value_length: varint32
+//     shared_middle_bytes: varint32
+//     unshared_tail_bytes: varint32
+//     shared_suffix_bytes: varint32
+//     key_delta: char[unshared_bytes]
+//     key_tail: char[unshared_tail_bytes]
+//     value: char[value_length]
+// All shared lengths are 0 for restart points.
+//
 // The trailer of the block has the form:
 //     restarts: uint32[num_restarts]
 //     num_restarts: uint32
 // restarts[i] contains the offset within the block of the ith restart point.
+// The top bit of num_restarts is kBlockSharesKeySuffixesFlag.
 
 #include "yb/rocksdb/table/block_builder.h"
 
@@ -57,9 +77,47 @@
 
 namespace rocksdb {
 
-BlockBuilder::BlockBuilder(int block_restart_interval, bool use_delta_encoding)
+namespace {
+
+// The maximum number of bytes between the shared middle and the shared suffix of a key, enough for
+// the write id at the end of a DocDB hybrid time.
+constexpr size_t kMaxUnsharedTailSize = 4;
+
+// Finds the bytes at the end of key that could be copied from last_key, which shares the first
+// shared bytes with it.
+void FindSharedKeySuffix(const Slice& last_key, const Slice& key, size_t shared,
+                         size_t* shared_middle, size_t* unshared_tail, size_t* shared_suffix) {
+  const size_t max_size = std::min(last_key.size(), key.size()) - shared;
+  // Number of equal bytes going backward from skip bytes before the end of both keys.
+  auto common_suffix_size = [&last_key, &key](size_t skip, size_t max) {
+    size_t result = 0;
+    while (result < max &&
+           last_key[last_key.size() - skip - result - 1] == key[key.size() - skip - result - 1]) {
+      ++result;
+    }
+    return result;
+  };
+
+  *shared_suffix = common_suffix_size(0, max_size);
+  *shared_middle = 0;
+  *unshared_tail = 0;
+  for (size_t tail = 1; tail <= kMaxUnsharedTailSize && *shared_suffix + tail < max_size; ++tail) {
+    const size_t middle =
+        common_suffix_size(*shared_suffix + tail, max_size - *shared_suffix - tail);
+    if (middle > *shared_middle) {
+      *shared_middle = middle;
+      *unshared_tail = tail;
+    }
+  }
+}
+
+} // namespace
+
+BlockBuilder::BlockBuilder(int block_restart_interval, bool use_delta_encoding,
+                           bool share_key_suffixes)
     : block_restart_interval_(block_restart_interval),
       use_delta_encoding_(use_delta_encoding),
+      share_key_suffixes_(use_delta_encoding && share_key_suffixes),
       restarts_(),
       counter_(0),
       finished_(false) {
@@ -93,6 +151,9 @@ size_t BlockBuilder::EstimateSizeAfterKV(const Slice& key, const Slice& value)
   estimate += sizeof(int32_t); // varint for shared prefix length.
   estimate += VarintLength(key.size()); // varint for key length.
   estimate += VarintLength(value.size()); // varint for value length.
+  if (share_key_suffixes_) {
+    estimate += 3 * sizeof(int32_t); // varints for shared suffix lengths.
+  }
 
   return estimate;
 }
@@ -102,7 +163,8 @@ Slice BlockBuilder::Finish() {
   for (size_t i = 0; i < restarts_.size(); i++) {
     PutFixed32(&buffer_, restarts_[i]);
   }
-  PutFixed32(&buffer_, static_cast<uint32_t>(restarts_.size()));
+  PutFixed32(&buffer_, static_cast<uint32_t>(restarts_.size()) |
+      (share_key_suffixes_ ? kBlockSharesKeySuffixesFlag : 0));
   finished_ = true;
   return Slice(buffer_);
 }
@@ -112,6 +174,10 @@ void BlockBuilder::Add(const Slice& key, const Slice& value) {
   assert(!finished_);
   assert(counter_ <= block_restart_interval_);
   size_t shared = 0;  // number of bytes shared with prev key
+  // Numbers of bytes at the end of the key, see the entry format above.
+  size_t shared_middle = 0;
+  size_t unshared_tail = 0;
+  size_t shared_suffix = 0;
   if (counter_ >= block_restart_interval_) {
     // Restart compression
     restarts_.push_back(static_cast<uint32_t>(buffer_.size()));
@@ -122,21 +188,31 @@ void BlockBuilder::Add(const Slice& key, const Slice& value) {
     while ((shared < min_length) && (last_key_piece[shared] == key[shared])) {
       shared++;
     }
+    if (share_key_suffixes_) {
+      FindSharedKeySuffix(
+          last_key_piece, key, shared, &shared_middle, &unshared_tail, &shared_suffix);
+    }
   }
-  const size_t non_shared = key.size() - shared;
+  const size_t non_shared = key.size() - shared - shared_middle - unshared_tail - shared_suffix;
 
   // Add "<shared><non_shared><value_size>" to buffer_
   PutVarint32(&buffer_, static_cast<uint32_t>(shared));
   PutVarint32(&buffer_, static_cast<uint32_t>(non_shared));
   PutVarint32(&buffer_, static_cast<uint32_t>(value.size()));
+  if (share_key_suffixes_) {
+    PutVarint32(&buffer_, static_cast<uint32_t>(shared_middle));
+    PutVarint32(&buffer_, static_cast<uint32_t>(unshared_tail));
+    PutVarint32(&buffer_, static_cast<uint32_t>(shared_suffix));
+  }
 
   // Add string delta to buffer_ followed by value
   buffer_.append(key.cdata() + shared, non_shared);
+  buffer_.append(key.cdata() + key.size() - shared_suffix - unshared_tail, unshared_tail);
   buffer_.append(value.cdata(), value.size());
 
   // Update state
   last_key_.resize(shared);
-  last_key_.append(key.cdata() + shared, non_shared);
+  last_key_.append(key.cdata() + shared, key.size() - shared);
   assert(Slice(last_key_) == key);
   counter_++;
 }
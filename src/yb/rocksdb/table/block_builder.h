@@ -29,13 +29,18 @@
 
 namespace rocksdb {
 
+// Set in the number of restarts stored at the end of a block, when the keys of the block share
+// their suffixes with the previous key.
+constexpr uint32_t kBlockSharesKeySuffixesFlag = 1u << 31;
+
 class BlockBuilder {
  public:
   BlockBuilder(const BlockBuilder&) = delete;
   void operator=(const BlockBuilder&) = delete;
 
   explicit BlockBuilder(int block_restart_interval,
-                        bool use_delta_encoding = true);
+                        bool use_delta_encoding = true,
+                        bool share_key_suffixes = false);
 
   // Reset the contents as if the BlockBuilder was just constructed.
   void Reset();
@@ -64,6 +69,7 @@ class BlockBuilder {
  private:
   const int          block_restart_interval_;
   const bool         use_delta_encoding_;
+  const bool         share_key_suffixes_;
 
   std::string           buffer_;    // Destination buffer
   std::vector<uint32_t> restarts_;  // Restart points
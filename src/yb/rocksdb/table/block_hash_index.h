@@ -70,7 +70,9 @@ class BlockHashIndex {
            uint32_t num_blocks);
 
   size_t ApproximateMemoryUsage() const {
-    return arena_.ApproximateMemoryUsage();
+    return arena_.ApproximateMemoryUsage() +
+           restart_indices_.bucket_count() * sizeof(void*) +
+           restart_indices_.size() * (sizeof(Slice) + sizeof(RestartIndex) + 2 * sizeof(void*));
   }
 
  private:
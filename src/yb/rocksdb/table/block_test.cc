@@ -243,6 +243,100 @@ TEST_F(BlockTest, IndexHashWithSharedPrefix) {
   CheckBlockContents(std::move(contents), kMaxKey, keys, values);
 }
 
+TEST_F(BlockTest, SharedKeySuffixes) {
+  Random rnd(301);
+  InternalKeyComparator comparator(BytewiseComparator());
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  // Sorted keys like DocDB ones: a row prefix, a column, a time shared by the row, and a write id.
+  for (int row = 0; row < 300; ++row) {
+    const std::string time = RandomString(&rnd, 10);
+    const int num_columns = 1 + rnd.Uniform(5);
+    for (int column = 0; column < num_columns; ++column) {
+      std::string user_key = GenerateKey(row, column, 0, &rnd) + time;
+      user_key.append(1 + rnd.Uniform(2), static_cast<char>(row * num_columns + column));
+      keys.push_back(InternalKey(user_key, row % 3, kTypeValue).Encode().ToString());
+      values.push_back(RandomString(&rnd, rnd.Uniform(20)));
+    }
+  }
+  BlockBuilder plain_builder(16);
+  BlockBuilder builder(16, true /* use_delta_encoding */, true /* share_key_suffixes */);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    plain_builder.Add(keys[i], values[i]);
+    builder.Add(keys[i], values[i]);
+  }
+  const size_t plain_size = plain_builder.Finish().size();
+  BlockContents contents;
+  contents.data = builder.Finish();
+  contents.cachable = false;
+  ASSERT_LT(contents.data.size(), plain_size);
+  Block reader(std::move(contents));
+
+  std::unique_ptr<InternalIterator> iter(reader.NewIterator(&comparator));
+  size_t count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++count) {
+    ASSERT_EQ(keys[count], iter->key().ToString());
+    ASSERT_EQ(values[count], iter->value().ToString());
+  }
+  ASSERT_EQ(keys.size(), count);
+  for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+    --count;
+    ASSERT_EQ(keys[count], iter->key().ToString());
+  }
+  ASSERT_EQ(0, count);
+  for (int i = 0; i < 1000; ++i) {
+    const size_t index = rnd.Uniform(static_cast<int>(keys.size()));
+    iter->Seek(keys[index]);
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(keys[index], iter->key().ToString());
+    ASSERT_EQ(values[index], iter->value().ToString());
+  }
+}
+
+TEST_F(BlockTest, DataHashIndex) {
+  const int kMaxKey = 1000;
+  const int kPrefixGroup = 7;
+  const int kPrefixSize = 6;
+  std::vector<std::string> user_keys;
+  std::vector<std::string> values;
+  // Only the even primary keys are written, so that the odd ones seek to the prefixes that are not
+  // in the block.
+  GenerateRandomKVs(&user_keys, &values, 0, kMaxKey, 2, 0, kPrefixGroup);
+
+  BlockBuilder builder(4 /* restart interval */);
+  for (size_t i = 0; i < user_keys.size(); ++i) {
+    builder.Add(InternalKey(user_keys[i], 100, kTypeValue).Encode(), values[i]);
+  }
+  Slice rawblock = builder.Finish();
+  BlockContents contents;
+  contents.data = rawblock;
+  contents.cachable = false;
+  Block plain_block(std::move(contents));
+  contents.data = rawblock;
+  contents.cachable = false;
+  Block hashed_block(std::move(contents));
+  hashed_block.BuildDataHashIndex(
+      std::shared_ptr<const SliceTransform>(NewFixedPrefixTransform(kPrefixSize)));
+  ASSERT_GT(hashed_block.ApproximateMemoryUsage(), plain_block.ApproximateMemoryUsage());
+
+  InternalKeyComparator comparator(BytewiseComparator());
+  std::unique_ptr<InternalIterator> plain_iter(plain_block.NewIterator(&comparator));
+  std::unique_ptr<InternalIterator> hashed_iter(hashed_block.NewIterator(&comparator));
+  Random rnd(301);
+  for (int i = -1; i <= kMaxKey; ++i) {
+    for (int j = 0; j <= kPrefixGroup; ++j) {
+      const auto seq = rnd.Uniform(200);
+      const auto target = InternalKey(GenerateKey(i, j, 0, &rnd), seq, kTypeValue).Encode();
+      plain_iter->Seek(target);
+      hashed_iter->Seek(target);
+      ASSERT_EQ(plain_iter->Valid(), hashed_iter->Valid()) << i << ", " << j;
+      if (plain_iter->Valid()) {
+        ASSERT_EQ(plain_iter->key(), hashed_iter->key()) << i << ", " << j;
+      }
+    }
+  }
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char **argv) {
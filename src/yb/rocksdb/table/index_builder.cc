@@ -24,7 +24,8 @@ IndexBuilder* IndexBuilder::CreateIndexBuilder(
     BlockBasedTableOptions::IndexType type,
     const Comparator* comparator,
     const SliceTransform* prefix_extractor,
-    int index_block_restart_interval) {
+    int index_block_restart_interval,
+    size_t index_block_size) {
   switch (type) {
     case BlockBasedTableOptions::kBinarySearch: {
       return new ShortenedIndexBuilder(comparator,
@@ -34,6 +35,10 @@ IndexBuilder* IndexBuilder::CreateIndexBuilder(
       return new HashIndexBuilder(comparator, prefix_extractor,
                                   index_block_restart_interval);
     }
+    case BlockBasedTableOptions::kTwoLevelIndexSearch: {
+      return new PartitionedIndexBuilder(comparator, index_block_restart_interval,
+                                         index_block_size);
+    }
     default: {
       assert(!"Do not recognize the index type ");
       return nullptr;
@@ -115,4 +120,64 @@ void HashIndexBuilder::FlushPendingPrefix() {
   PutVarint32(&prefix_meta_block_, pending_block_num_);
 }
 
+PartitionedIndexBuilder::PartitionedIndexBuilder(const Comparator* comparator,
+                                                 int index_block_restart_interval,
+                                                 size_t index_block_size)
+    : IndexBuilder(comparator),
+      index_block_restart_interval_(index_block_restart_interval),
+      index_block_size_(index_block_size),
+      top_level_index_builder_(index_block_restart_interval) {}
+
+void PartitionedIndexBuilder::AddIndexEntry(
+    std::string* last_key_in_current_block,
+    const Slice* first_key_in_next_block,
+    const BlockHandle& block_handle) {
+  if (!current_partition_) {
+    current_partition_.reset(new ShortenedIndexBuilder(comparator_, index_block_restart_interval_));
+  }
+  // ShortenedIndexBuilder replaces last_key_in_current_block with the separator it used.
+  current_partition_->AddIndexEntry(last_key_in_current_block, first_key_in_next_block,
+                                    block_handle);
+  current_partition_last_key_ = *last_key_in_current_block;
+  if (current_partition_->EstimatedSize() >= index_block_size_) {
+    CutPartition();
+  }
+}
+
+void PartitionedIndexBuilder::CutPartition() {
+  partitions_size_ += current_partition_->EstimatedSize();
+  partitions_.push_back(Partition{std::move(current_partition_last_key_),
+                                  std::move(current_partition_)});
+  current_partition_last_key_.clear();
+}
+
+Status PartitionedIndexBuilder::Finish(IndexBlocks* index_blocks) {
+  return Finish(index_blocks, BlockHandle::NullBlockHandle());
+}
+
+Status PartitionedIndexBuilder::Finish(IndexBlocks* index_blocks,
+                                       const BlockHandle& last_partition_block_handle) {
+  if (current_partition_) {
+    // First call, flush the partition being built.
+    DCHECK_EQ(finished_partitions_, 0);
+    CutPartition();
+  }
+  if (finished_partitions_ > 0) {
+    // Previous call returned a partition for writing, add it to the top-level index.
+    std::string handle_encoding;
+    last_partition_block_handle.EncodeTo(&handle_encoding);
+    auto& partition = partitions_[finished_partitions_ - 1];
+    top_level_index_builder_.Add(partition.last_key, handle_encoding);
+    // The partition contents is not needed anymore once it was written.
+    partition.index_builder.reset();
+  }
+  if (finished_partitions_ < partitions_.size()) {
+    RETURN_NOT_OK(partitions_[finished_partitions_].index_builder->Finish(index_blocks));
+    ++finished_partitions_;
+    return STATUS(Incomplete, "Index partition returned");
+  }
+  index_blocks->index_block_contents = top_level_index_builder_.Finish();
+  return Status::OK();
+}
+
 } // namespace rocksdb
@@ -14,8 +14,12 @@
 #ifndef YB_ROCKSDB_TABLE_INDEX_BUILDER_H
 #define YB_ROCKSDB_TABLE_INDEX_BUILDER_H
 
+#include <memory>
+#include <vector>
+
 #include "yb/rocksdb/table.h"
 #include "yb/rocksdb/table/block_builder.h"
+#include "yb/rocksdb/table/format.h"
 
 namespace rocksdb {
 
@@ -38,7 +42,8 @@ class IndexBuilder {
       BlockBasedTableOptions::IndexType index_type,
       const Comparator* comparator,
       const SliceTransform* prefix_extractor,
-      const int index_block_restart_interval);
+      const int index_block_restart_interval,
+      const size_t index_block_size);
 
   // Index builder will construct a set of blocks which contain:
   //  1. One primary index block.
@@ -77,6 +82,15 @@ class IndexBuilder {
   // REQUIRES: Finish() has not yet been called.
   virtual CHECKED_STATUS Finish(IndexBlocks* index_blocks) = 0;
 
+  // Same as above, for multi-level indexes which consist of several blocks. Returns Incomplete and
+  // the next index block to write in index_blocks->index_block_contents while there are more
+  // blocks. The next call should pass the handle of the block written. When OK is returned,
+  // index_blocks contains the top-level index block.
+  virtual CHECKED_STATUS Finish(IndexBlocks* index_blocks,
+                                const BlockHandle& last_partition_block_handle) {
+    return Finish(index_blocks);
+  }
+
   // Get the estimated size for index block.
   virtual size_t EstimatedSize() const = 0;
 
@@ -183,6 +197,61 @@ class HashIndexBuilder : public IndexBuilder {
   uint64_t current_restart_index_ = 0;
 };
 
+// PartitionedIndexBuilder builds a two-level index (kTwoLevelIndexSearch). The data index is split
+// into partitions of about `index_block_size` bytes, each of them being a block built by
+// ShortenedIndexBuilder. The top-level index block maps the last key of each partition to the
+// partition's block handle, so it has the same format as a single-level index block.
+//
+// Partitions are only cut between data blocks, and the last key of a partition is the shortened
+// separator of its last data block, so it also separates the partition from the next one.
+class PartitionedIndexBuilder : public IndexBuilder {
+ public:
+  PartitionedIndexBuilder(const Comparator* comparator,
+                          int index_block_restart_interval,
+                          size_t index_block_size);
+
+  void AddIndexEntry(
+      std::string* last_key_in_current_block,
+      const Slice* first_key_in_next_block,
+      const BlockHandle& block_handle) override;
+
+  CHECKED_STATUS Finish(IndexBlocks* index_blocks) override;
+
+  CHECKED_STATUS Finish(IndexBlocks* index_blocks,
+                        const BlockHandle& last_partition_block_handle) override;
+
+  size_t EstimatedSize() const override {
+    return partitions_size_ +
+           (current_partition_ ? current_partition_->EstimatedSize() : 0) +
+           top_level_index_builder_.CurrentSizeEstimate();
+  }
+
+  size_t NumPartitions() const {
+    return partitions_.size();
+  }
+
+ private:
+  struct Partition {
+    std::string last_key;
+    std::unique_ptr<ShortenedIndexBuilder> index_builder;
+  };
+
+  void CutPartition();
+
+  const int index_block_restart_interval_;
+  const size_t index_block_size_;
+
+  std::unique_ptr<ShortenedIndexBuilder> current_partition_;
+  std::string current_partition_last_key_;
+  std::vector<Partition> partitions_;
+  // Total estimated size of the partitions that were cut.
+  size_t partitions_size_ = 0;
+
+  // Index of the partition returned by the last Finish() call.
+  size_t finished_partitions_ = 0;
+  BlockBuilder top_level_index_builder_;
+};
+
 } // namespace rocksdb
 
 #endif  // YB_ROCKSDB_TABLE_INDEX_BUILDER_H
@@ -0,0 +1,278 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rocksdb/table/secondary_block_cache.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include <atomic>
+
+#include "yb/rocksdb/table/block.h"
+#include "yb/rocksdb/table/format.h"
+
+#include "yb/util/cache.h"
+#include "yb/util/metrics.h"
+
+METRIC_DEFINE_counter(server, secondary_block_cache_inserts,
+                      "Secondary Block Cache Inserts", yb::MetricUnit::kBlocks,
+                      "Number of compressed blocks inserted in the secondary block cache");
+METRIC_DEFINE_counter(server, secondary_block_cache_insert_failures,
+                      "Secondary Block Cache Insert Failures", yb::MetricUnit::kBlocks,
+                      "Number of compressed blocks that did not fit in the secondary block cache");
+METRIC_DEFINE_counter(server, secondary_block_cache_evictions,
+                      "Secondary Block Cache Evictions", yb::MetricUnit::kBlocks,
+                      "Number of compressed blocks evicted from the secondary block cache");
+METRIC_DEFINE_counter(server, secondary_block_cache_hits,
+                      "Secondary Block Cache Hits", yb::MetricUnit::kBlocks,
+                      "Number of lookups that found a block in the secondary block cache");
+METRIC_DEFINE_counter(server, secondary_block_cache_misses,
+                      "Secondary Block Cache Misses", yb::MetricUnit::kBlocks,
+                      "Number of lookups that didn't find a block in the secondary block cache");
+METRIC_DEFINE_gauge_uint64(server, secondary_block_cache_usage,
+                           "Secondary Block Cache Memory Usage", yb::MetricUnit::kBytes,
+                           "Memory consumed by the compressed blocks in the secondary block cache");
+
+namespace rocksdb {
+
+namespace {
+
+struct SecondaryBlockCacheMetrics {
+  explicit SecondaryBlockCacheMetrics(const scoped_refptr<yb::MetricEntity>& entity)
+      : inserts(METRIC_secondary_block_cache_inserts.Instantiate(entity)),
+        insert_failures(METRIC_secondary_block_cache_insert_failures.Instantiate(entity)),
+        evictions(METRIC_secondary_block_cache_evictions.Instantiate(entity)),
+        hits(METRIC_secondary_block_cache_hits.Instantiate(entity)),
+        misses(METRIC_secondary_block_cache_misses.Instantiate(entity)),
+        usage(METRIC_secondary_block_cache_usage.Instantiate(entity, 0)) {}
+
+  scoped_refptr<yb::Counter> inserts;
+  scoped_refptr<yb::Counter> insert_failures;
+  scoped_refptr<yb::Counter> evictions;
+  scoped_refptr<yb::Counter> hits;
+  scoped_refptr<yb::Counter> misses;
+  scoped_refptr<yb::AtomicGauge<uint64_t>> usage;
+};
+
+// Memory accounting shared by the cache and the deleter of the stored blocks.
+struct SecondaryBlockCacheUsage {
+  void Add(size_t charge) {
+    usage.fetch_add(charge, std::memory_order_relaxed);
+    if (metrics) {
+      metrics->usage->IncrementBy(charge);
+    }
+  }
+
+  void Remove(size_t charge) {
+    usage.fetch_sub(charge, std::memory_order_relaxed);
+    if (metrics) {
+      metrics->usage->DecrementBy(charge);
+    }
+  }
+
+  std::atomic<size_t> usage{0};
+  std::unique_ptr<SecondaryBlockCacheMetrics> metrics;
+};
+
+// Layout of a compressed block in memory allocated from the backing cache.
+struct StoredBlock {
+  uint32_t size;
+  CompressionType compression_type;
+  char data[1];
+
+  static size_t AllocationSize(size_t data_size) {
+    return offsetof(StoredBlock, data) + data_size;
+  }
+
+  size_t AllocationSize() const {
+    return AllocationSize(size);
+  }
+};
+
+// Handle returned to the block based table reader. The stored contents are wrapped into a Block
+// that does not own them, the backing cache handle keeps them alive until Release().
+struct SecondaryBlockCacheHandle {
+  SecondaryBlockCacheHandle(yb::Cache::Handle* backing_handle_, const StoredBlock* stored)
+      : backing_handle(backing_handle_),
+        block(BlockContents(Slice(stored->data, stored->size), false /* cachable */,
+                            stored->compression_type)),
+        charge(stored->AllocationSize()) {}
+
+  yb::Cache::Handle* const backing_handle;
+  Block block;
+  const size_t charge;
+};
+
+class StoredBlockDeleter : public yb::CacheDeleter {
+ public:
+  StoredBlockDeleter(yb::Cache* backing_cache, SecondaryBlockCacheUsage* usage)
+      : backing_cache_(backing_cache), usage_(usage) {}
+
+  void Delete(const Slice& key, void* value) override {
+    auto* stored = static_cast<StoredBlock*>(value);
+    usage_->Remove(stored->AllocationSize());
+    if (usage_->metrics) {
+      usage_->metrics->evictions->Increment();
+    }
+    backing_cache_->Free(reinterpret_cast<uint8_t*>(stored));
+  }
+
+ private:
+  yb::Cache* const backing_cache_;
+  SecondaryBlockCacheUsage* const usage_;
+};
+
+class SecondaryBlockCache : public Cache {
+ public:
+  SecondaryBlockCache(std::unique_ptr<yb::Cache> backing_cache, size_t capacity)
+      : capacity_(capacity),
+        deleter_(backing_cache.get(), &usage_),
+        backing_cache_(std::move(backing_cache)) {}
+
+  Status Insert(const Slice& key, const QueryId query_id, void* value, size_t charge,
+                void (*deleter)(const Slice& key, void* value), Handle** handle,
+                Statistics* statistics) override {
+    const Block* block = static_cast<const Block*>(value);
+    const size_t allocation_size = StoredBlock::AllocationSize(block->size());
+    auto* stored = reinterpret_cast<StoredBlock*>(
+        backing_cache_->Allocate(static_cast<int>(allocation_size)));
+    if (stored == nullptr) {
+      return InsertFailed(key, value, deleter, handle);
+    }
+    stored->size = static_cast<uint32_t>(block->size());
+    stored->compression_type = block->compression_type();
+    memcpy(stored->data, block->data(), block->size());
+
+    usage_.Add(allocation_size);
+    auto* backing_handle = backing_cache_->Insert(key, stored, allocation_size, &deleter_);
+    if (backing_handle == nullptr) {
+      usage_.Remove(allocation_size);
+      backing_cache_->Free(reinterpret_cast<uint8_t*>(stored));
+      return InsertFailed(key, value, deleter, handle);
+    }
+    if (usage_.metrics) {
+      usage_.metrics->inserts->Increment();
+    }
+
+    // The contents were copied to the backing cache, so the original block is not needed anymore.
+    (*deleter)(key, value);
+    if (handle != nullptr) {
+      *handle = NewHandle(backing_handle);
+    } else {
+      backing_cache_->Release(backing_handle);
+    }
+    return Status::OK();
+  }
+
+  Handle* Lookup(const Slice& key, const QueryId query_id, Statistics* statistics) override {
+    auto* backing_handle = backing_cache_->Lookup(key, yb::Cache::NO_EXPECT_IN_CACHE);
+    if (usage_.metrics) {
+      (backing_handle != nullptr ? usage_.metrics->hits : usage_.metrics->misses)->Increment();
+    }
+    if (backing_handle == nullptr) {
+      return nullptr;
+    }
+    return NewHandle(backing_handle);
+  }
+
+  void Release(Handle* handle) override {
+    auto* h = reinterpret_cast<SecondaryBlockCacheHandle*>(handle);
+    pinned_usage_.fetch_sub(h->charge, std::memory_order_relaxed);
+    backing_cache_->Release(h->backing_handle);
+    delete h;
+  }
+
+  void* Value(Handle* handle) override {
+    return &reinterpret_cast<SecondaryBlockCacheHandle*>(handle)->block;
+  }
+
+  void Erase(const Slice& key) override {
+    backing_cache_->Erase(key);
+  }
+
+  uint64_t NewId() override {
+    return backing_cache_->NewId();
+  }
+
+  // The capacity of the backing cache is fixed when it is created.
+  void SetCapacity(size_t capacity) override {}
+
+  void SetStrictCapacityLimit(bool strict_capacity_limit) override {}
+
+  bool HasStrictCapacityLimit() const override {
+    return false;
+  }
+
+  size_t GetCapacity() const override {
+    return capacity_;
+  }
+
+  size_t GetUsage() const override {
+    return usage_.usage.load(std::memory_order_relaxed);
+  }
+
+  size_t GetUsage(Handle* handle) const override {
+    return reinterpret_cast<SecondaryBlockCacheHandle*>(handle)->charge;
+  }
+
+  size_t GetPinnedUsage() const override {
+    return pinned_usage_.load(std::memory_order_relaxed);
+  }
+
+  // The backing cache does not support iterating over its entries.
+  void ApplyToAllCacheEntries(void (*callback)(void*, size_t), bool thread_safe) override {}
+
+  // The backing cache is not given the entity: its metrics would be merged with the ones of the
+  // uncompressed block cache.
+  void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) override {
+    usage_.metrics.reset(new SecondaryBlockCacheMetrics(entity));
+    usage_.metrics->usage->set_value(GetUsage());
+  }
+
+ private:
+  Status InsertFailed(const Slice& key, void* value,
+                      void (*deleter)(const Slice& key, void* value), Handle** handle) {
+    if (handle == nullptr) {
+      (*deleter)(key, value);
+    } else {
+      *handle = nullptr;
+    }
+    if (usage_.metrics) {
+      usage_.metrics->insert_failures->Increment();
+    }
+    return STATUS(Incomplete, "Insert failed due to secondary block cache being full.");
+  }
+
+  Handle* NewHandle(yb::Cache::Handle* backing_handle) {
+    auto* stored = static_cast<const StoredBlock*>(backing_cache_->Value(backing_handle));
+    auto* h = new SecondaryBlockCacheHandle(backing_handle, stored);
+    pinned_usage_.fetch_add(h->charge, std::memory_order_relaxed);
+    return reinterpret_cast<Handle*>(h);
+  }
+
+  const size_t capacity_;
+  SecondaryBlockCacheUsage usage_;
+  std::atomic<size_t> pinned_usage_{0};
+  StoredBlockDeleter deleter_;
+  // Declared last, so entries still in the backing cache are freed while the deleter is alive.
+  std::unique_ptr<yb::Cache> backing_cache_;
+};
+
+}  // namespace
+
+std::shared_ptr<Cache> NewSecondaryBlockCache(std::unique_ptr<yb::Cache> backing_cache,
+                                              size_t capacity) {
+  return std::make_shared<SecondaryBlockCache>(std::move(backing_cache), capacity);
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,41 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+#ifndef ROCKSDB_TABLE_SECONDARY_BLOCK_CACHE_H
+#define ROCKSDB_TABLE_SECONDARY_BLOCK_CACHE_H
+
+#include <memory>
+
+#include "yb/rocksdb/cache.h"
+
+namespace yb {
+class Cache;
+}
+
+namespace rocksdb {
+
+// Returns a cache that can be used as BlockBasedTableOptions::block_cache_compressed, i.e. as the
+// second tier behind the uncompressed block cache. The compressed block contents are copied into
+// memory allocated from backing_cache, which may be a yb::NVM_CACHE placed on persistent memory or
+// on a file system on a local SSD, so the second tier can be much larger than DRAM.
+//
+// Blocks read from disk are added to this tier in compressed form, and a miss in the uncompressed
+// block cache that hits here uncompresses the block and promotes it back into the uncompressed
+// block cache.
+//
+// capacity is only reported back by GetCapacity(), it must match the capacity of backing_cache.
+std::shared_ptr<Cache> NewSecondaryBlockCache(std::unique_ptr<yb::Cache> backing_cache,
+                                              size_t capacity);
+
+}  // namespace rocksdb
+
+#endif  // ROCKSDB_TABLE_SECONDARY_BLOCK_CACHE_H
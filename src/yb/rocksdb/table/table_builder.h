@@ -68,13 +68,15 @@ struct TableBuilderOptions {
       const IntTblPropCollectorFactories& _int_tbl_prop_collector_factories,
       CompressionType _compression_type,
       const CompressionOptions& _compression_opts,
-      bool _skip_filters)
+      bool _skip_filters,
+      const std::string* _compression_dict = nullptr)
       : ioptions(_ioptions),
         internal_comparator(_internal_comparator),
         int_tbl_prop_collector_factories(&_int_tbl_prop_collector_factories),
         compression_type(_compression_type),
         compression_opts(_compression_opts),
-        skip_filters(_skip_filters) {}
+        skip_filters(_skip_filters),
+        compression_dict(_compression_dict) {}
 
   const ImmutableCFOptions& ioptions;
   const InternalKeyComparator& internal_comparator;
@@ -83,6 +85,9 @@ struct TableBuilderOptions {
   const CompressionOptions& compression_opts;
   // This is only used for BlockBasedTableBuilder
   bool skip_filters = false;
+  // Dictionary used to compress data blocks, nullptr if there is none. It should outlive the
+  // table builder. This is only used for BlockBasedTableBuilder.
+  const std::string* compression_dict;
 };
 
 // TableBuilder provides the interface used to build a Table
@@ -25,6 +25,8 @@
 #define ROCKSDB_TABLE_TABLE_READER_H
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "yb/util/slice.h"
 
@@ -114,6 +116,13 @@ class TableReader {
   virtual Status DumpTable(WritableFile* out_file) {
     return STATUS(NotSupported, "DumpTable() not supported");
   }
+
+  // Appends to anchors up to max_anchors internal keys in increasing order, that split the file
+  // into ranges of approximately the same size. Used to partition a compaction into
+  // subcompactions.
+  virtual Status ApproximateKeyAnchors(size_t max_anchors, std::vector<std::string>* anchors) {
+    return STATUS(NotSupported, "ApproximateKeyAnchors() not supported");
+  }
 };
 
 }  // namespace rocksdb
@@ -320,8 +320,8 @@ class TableConstructor: public Constructor {
 
     // Open the table
     uniq_id_ = cur_uniq_id_++;
-    file_reader_.reset(test::GetRandomAccessFileReader(new test::StringSource(
-        GetSink()->contents(), uniq_id_, ioptions.allow_mmap_reads)));
+    source_ = new test::StringSource(GetSink()->contents(), uniq_id_, ioptions.allow_mmap_reads);
+    file_reader_.reset(test::GetRandomAccessFileReader(source_));
     return ioptions.table_factory->NewTableReader(
         TableReaderOptions(ioptions, soptions, internal_comparator),
         std::move(file_reader_), GetSink()->contents().size(), &table_reader_);
@@ -342,8 +342,8 @@ class TableConstructor: public Constructor {
   }
 
   virtual Status Reopen(const ImmutableCFOptions& ioptions) {
-    file_reader_.reset(test::GetRandomAccessFileReader(new test::StringSource(
-        GetSink()->contents(), uniq_id_, ioptions.allow_mmap_reads)));
+    source_ = new test::StringSource(GetSink()->contents(), uniq_id_, ioptions.allow_mmap_reads);
+    file_reader_.reset(test::GetRandomAccessFileReader(source_));
     return ioptions.table_factory->NewTableReader(
         TableReaderOptions(ioptions, soptions, *last_internal_key_),
         std::move(file_reader_), GetSink()->contents().size(), &table_reader_);
@@ -353,6 +353,11 @@ class TableConstructor: public Constructor {
     return table_reader_.get();
   }
 
+  // The file the table reader reads from, owned by the table reader.
+  const test::StringSource* GetSource() const {
+    return source_;
+  }
+
   bool AnywayDeleteIterator() const override {
     return convert_to_internal_key_;
   }
@@ -360,6 +365,7 @@ class TableConstructor: public Constructor {
  private:
   void Reset() {
     uniq_id_ = 0;
+    source_ = nullptr;
     table_reader_.reset();
     file_writer_.reset();
     file_reader_.reset();
@@ -373,6 +379,7 @@ class TableConstructor: public Constructor {
   unique_ptr<WritableFileWriter> file_writer_;
   unique_ptr<RandomAccessFileReader> file_reader_;
   unique_ptr<TableReader> table_reader_;
+  test::StringSource* source_ = nullptr;
   bool convert_to_internal_key_;
 
   TableConstructor();
@@ -1907,6 +1914,47 @@ TEST_F(BlockBasedTableTest, BlockReadCountTest) {
   }
 }
 
+TEST_F(BlockBasedTableTest, ScanReadahead) {
+  constexpr size_t kMaxReadaheadSize = 16 * 1024;
+  for (size_t max_readahead_size : {size_t(0), kMaxReadaheadSize}) {
+    Options options;
+    BlockBasedTableOptions table_options;
+    table_options.no_block_cache = true;
+    table_options.block_size = 1024;
+    table_options.max_scan_readahead_size = max_readahead_size;
+    options.table_factory.reset(new BlockBasedTableFactory(table_options));
+    options.compression = kNoCompression;
+
+    TableConstructor c(BytewiseComparator(), true);
+    Random rnd(301);
+    for (int i = 0; i < 1000; ++i) {
+      c.Add("key" + std::to_string(1000000 + i), RandomString(&rnd, 100));
+    }
+    std::vector<std::string> keys;
+    stl_wrappers::KVMap kvmap;
+    const ImmutableCFOptions ioptions(options);
+    c.Finish(options, ioptions, table_options,
+             GetPlainInternalComparator(options.comparator), &keys, &kvmap);
+
+    std::unique_ptr<InternalIterator> iter(c.NewIterator());
+    size_t num_keys = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ++num_keys;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(1000, num_keys);
+
+    const uint64_t prefetched_bytes = c.GetSource()->total_prefetched_bytes();
+    if (max_readahead_size == 0) {
+      ASSERT_EQ(0, prefetched_bytes);
+    } else {
+      // Everything after the first blocks is prefetched, and nothing is prefetched twice.
+      ASSERT_GT(prefetched_bytes, c.GetSource()->Size() / 2);
+      ASSERT_LE(prefetched_bytes, c.GetSource()->Size() + kMaxReadaheadSize);
+    }
+  }
+}
+
 TEST_F(BlockBasedTableTest, BlockCacheLeak) {
   // Check that when we reopen a table we don't lose access to blocks already
   // in the cache. This test checks whether the Table actually makes use of the
@@ -2117,6 +2165,104 @@ TEST_F(GeneralTableTest, ApproximateOffsetOfCompressed) {
   }
 }
 
+namespace {
+
+// Writes a block based table with the given compression and dictionary, checks that all entries
+// are read back and returns the file size.
+uint64_t WriteAndVerifyTableWithDictionary(CompressionType compression,
+                                           const std::string* compression_dict,
+                                           const stl_wrappers::KVMap& kvmap) {
+  Options options;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 256;
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  const ImmutableCFOptions ioptions(options);
+  InternalKeyComparator ikc(options.comparator);
+  IntTblPropCollectorFactories int_tbl_prop_collector_factories;
+
+  unique_ptr<WritableFileWriter> file_writer(test::GetWritableFileWriter(new test::StringSink()));
+  unique_ptr<TableBuilder> builder(options.table_factory->NewTableBuilder(
+      TableBuilderOptions(ioptions, ikc, int_tbl_prop_collector_factories, compression,
+                          CompressionOptions(), /* skip_filters */ false, compression_dict),
+      TablePropertiesCollectorFactory::Context::kUnknownColumnFamily,
+      file_writer.get()));
+  for (const auto& kv : kvmap) {
+    builder->Add(InternalKey(kv.first, 0, kTypeValue).Encode(), kv.second);
+  }
+  EXPECT_OK(builder->Finish());
+  EXPECT_OK(file_writer->Flush());
+
+  auto* sink = static_cast<test::StringSink*>(file_writer->writable_file());
+  unique_ptr<RandomAccessFileReader> file_reader(test::GetRandomAccessFileReader(
+      new test::StringSource(sink->contents(), 0 /* unique_id */, false /* mmap */)));
+  unique_ptr<TableReader> table_reader;
+  EXPECT_OK(options.table_factory->NewTableReader(
+      TableReaderOptions(ioptions, EnvOptions(), ikc), std::move(file_reader),
+      sink->contents().size(), &table_reader));
+  if (!table_reader) {
+    return 0;
+  }
+
+  unique_ptr<InternalIterator> iter(table_reader->NewIterator(ReadOptions()));
+  iter->SeekToFirst();
+  for (const auto& kv : kvmap) {
+    EXPECT_TRUE(iter->Valid());
+    if (!iter->Valid()) {
+      break;
+    }
+    EXPECT_EQ(kv.first, ExtractUserKey(iter->key()).ToBuffer());
+    EXPECT_EQ(kv.second, iter->value().ToBuffer());
+    iter->Next();
+  }
+  EXPECT_FALSE(iter->Valid());
+  EXPECT_OK(iter->status());
+  return sink->contents().size();
+}
+
+}  // namespace
+
+TEST_F(GeneralTableTest, CompressionDictionary) {
+  std::vector<CompressionType> compression_types;
+  for (auto type : {kZlibCompression, kLZ4Compression, kLZ4HCCompression, kZSTD}) {
+    if (CompressionTypeSupported(type)) {
+      compression_types.push_back(type);
+    } else {
+      fprintf(stderr, "skipping %s compression dictionary test\n",
+              CompressionTypeToString(type).c_str());
+    }
+  }
+
+  // Values are built from a small set of random phrases, so they repeat across blocks but hardly
+  // within a single block.
+  Random rnd(301);
+  std::vector<std::string> phrases;
+  for (int i = 0; i < 16; ++i) {
+    phrases.push_back(RandomString(&rnd, 64));
+  }
+  stl_wrappers::KVMap kvmap;
+  for (int i = 0; i < 1000; ++i) {
+    char key[16];
+    snprintf(key, sizeof(key), "key%05d", i);
+    kvmap[key] = phrases[rnd.Uniform(static_cast<int>(phrases.size()))];
+  }
+  std::string samples;
+  std::vector<size_t> sample_sizes;
+  for (const auto& phrase : phrases) {
+    samples += phrase;
+    sample_sizes.push_back(phrase.size());
+  }
+  const std::string dict = BuildCompressionDictionary(samples, sample_sizes, 4096);
+
+  for (auto type : compression_types) {
+    SCOPED_TRACE(CompressionTypeToString(type));
+    const uint64_t size_without_dict = WriteAndVerifyTableWithDictionary(type, nullptr, kvmap);
+    const uint64_t size_with_dict = WriteAndVerifyTableWithDictionary(type, &dict, kvmap);
+    ASSERT_GT(size_without_dict, 0);
+    ASSERT_GT(size_with_dict, 0);
+    ASSERT_LT(size_with_dict, size_without_dict);
+  }
+}
+
 TEST_F(HarnessTest, Randomized) {
 #if defined(ROCKSDB_TSAN_RUN) || defined(THREAD_SANITIZER)
   static constexpr int kMaxNumEntries = 200;
@@ -2412,6 +2558,74 @@ TEST_P(IndexBlockRestartIntervalTest, IndexBlockRestartInterval) {
   ASSERT_EQ(kv_iter, kvmap.end());
 }
 
+TEST_F(BlockBasedTableTest, TwoLevelIndex) {
+  const int kKeysInTable = 10000;
+  const int kKeySize = 100;
+  const int kValSize = 500;
+
+  Options options;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 64;  // small block size to get big index
+  table_options.index_type = BlockBasedTableOptions::kTwoLevelIndexSearch;
+  table_options.index_block_size = 4096;
+  table_options.block_cache = NewLRUCache(16 * 1024 * 1024);
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+
+  TableConstructor c(BytewiseComparator());
+  static Random rnd(301);
+  for (int i = 0; i < kKeysInTable; i++) {
+    InternalKey k(RandomString(&rnd, kKeySize), 0, kTypeValue);
+    c.Add(k.Encode().ToString(), RandomString(&rnd, kValSize));
+  }
+
+  std::vector<std::string> keys;
+  stl_wrappers::KVMap kvmap;
+  std::unique_ptr<InternalKeyComparator> comparator(
+      new InternalKeyComparator(BytewiseComparator()));
+  const ImmutableCFOptions ioptions(options);
+  c.Finish(options, ioptions, table_options, *comparator, &keys, &kvmap);
+  auto reader = c.GetTableReader();
+  // Index should be split into many partitions.
+  ASSERT_GT(reader->GetTableProperties()->data_index_size, 10 * table_options.index_block_size);
+
+  std::unique_ptr<InternalIterator> db_iter(reader->NewIterator(ReadOptions()));
+
+  // Test point lookup
+  for (auto& kv : kvmap) {
+    db_iter->Seek(kv.first);
+
+    ASSERT_TRUE(db_iter->Valid());
+    ASSERT_OK(db_iter->status());
+    ASSERT_EQ(db_iter->key(), kv.first);
+    ASSERT_EQ(db_iter->value(), kv.second);
+
+    std::string value;
+    GetContext get_context(options.comparator, nullptr, nullptr, nullptr,
+                           GetContext::kNotFound, ExtractUserKey(kv.first), &value, nullptr,
+                           nullptr, nullptr);
+    ASSERT_OK(reader->Get(ReadOptions(), kv.first, &get_context));
+    ASSERT_EQ(kv.second, value);
+  }
+
+  // Test iterating
+  auto kv_iter = kvmap.begin();
+  for (db_iter->SeekToFirst(); db_iter->Valid(); db_iter->Next()) {
+    ASSERT_EQ(db_iter->key(), kv_iter->first);
+    ASSERT_EQ(db_iter->value(), kv_iter->second);
+    kv_iter++;
+  }
+  ASSERT_EQ(kv_iter, kvmap.end());
+
+  // Test iterating backwards
+  auto kv_riter = kvmap.rbegin();
+  for (db_iter->SeekToLast(); db_iter->Valid(); db_iter->Prev()) {
+    ASSERT_EQ(db_iter->key(), kv_riter->first);
+    ASSERT_EQ(db_iter->value(), kv_riter->second);
+    kv_riter++;
+  }
+  ASSERT_EQ(kv_riter, kvmap.rend());
+}
+
 class PrefixTest : public testing::Test {
  public:
   PrefixTest() : testing::Test() {}
@@ -108,6 +108,8 @@ struct TablePropertiesNames {
 };
 
 extern const std::string kPropertiesBlock;
+// Meta block that keeps the dictionary used to compress data blocks.
+extern const std::string kCompressionDictBlock;
 
 enum EntryType {
   kEntryPut,
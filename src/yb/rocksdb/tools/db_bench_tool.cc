@@ -546,7 +546,7 @@ enum rocksdb::CompressionType StringToCompressionType(const char* ctype) {
   else if (!strcasecmp(ctype, "lz4hc"))
     return rocksdb::kLZ4HCCompression;
   else if (!strcasecmp(ctype, "zstd"))
-    return rocksdb::kZSTDNotFinalCompression;
+    return rocksdb::kZSTD;
 
   fprintf(stdout, "Cannot parse compression type '%s'\n", ctype);
   return rocksdb::kSnappyCompression;  // default value
@@ -1614,6 +1614,7 @@ class Benchmark {
         ok = LZ4HC_Compress(Options().compression_opts, 2, input.cdata(),
                             input.size(), compressed);
         break;
+      case rocksdb::kZSTD:
       case rocksdb::kZSTDNotFinalCompression:
         ok = ZSTD_Compress(Options().compression_opts, input.cdata(),
                            input.size(), compressed);
@@ -2329,6 +2330,7 @@ class Benchmark {
                                       &decompress_size, 2);
         ok = uncompressed != nullptr;
         break;
+      case rocksdb::kZSTD:
       case rocksdb::kZSTDNotFinalCompression:
         uncompressed = ZSTD_Uncompress(compressed.data(), compressed.size(),
                                        &decompress_size);
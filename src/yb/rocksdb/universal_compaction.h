@@ -27,6 +27,8 @@
 
 namespace rocksdb {
 
+enum CompressionType : char;
+
 //
 // Algorithm used to make a compaction request stop picking new files
 // into a single compaction run
@@ -80,6 +82,18 @@ class CompactionOptionsUniversal {
   // Default: -1
   int compression_size_percent;
 
+  // Compaction outputs whose estimated size is at most this number of bytes are compressed
+  // with small_output_compression instead of the column family compression. Memtable flushes
+  // are always considered small when this is enabled. Small sorted runs are soon rewritten by
+  // later compactions, so spending CPU on a strong compression for them is mostly wasted, while
+  // the large runs keep the strong compression.
+  // Disabled if 0. Default: 0
+  uint64_t small_output_size_bytes;
+
+  // Compression used for the small outputs, see small_output_size_bytes.
+  // Default: kNoCompression
+  CompressionType small_output_compression;
+
   // The algorithm used to stop picking files into a single compaction run
   // Default: kCompactionStopStyleTotalSize
   CompactionStopStyle stop_style;
@@ -96,6 +110,8 @@ class CompactionOptionsUniversal {
         max_merge_width(UINT_MAX),
         max_size_amplification_percent(200),
         compression_size_percent(-1),
+        small_output_size_bytes(0),
+        small_output_compression(),
         stop_style(kCompactionStopStyleTotalSize),
         allow_trivial_move(false) {}
 };
@@ -63,6 +63,49 @@ inline void AddHash(uint32_t h, char* data, uint32_t num_lines, uint32_t total_b
   }
 }
 
+// Lane-blocked format: each key sets one bit in each of the kLaneBlockedProbes 64-bit lanes of
+// one 64-byte line, so a lookup loads a single cache line and checks all probes at once, without
+// a branch per probe. Such filters are marked by zero probes in the metadata, so readers that
+// don't know this format treat them as matching all keys. For the same false positive rate the
+// format needs about 10% more bits than AddHash().
+constexpr size_t kLaneBlockedProbes = 8;
+constexpr uint32_t kLaneBlockedLineBytes = kLaneBlockedProbes * sizeof(uint64_t);
+constexpr uint32_t kLaneBlockedLineBits = kLaneBlockedLineBytes * 8;
+
+// Odd multipliers that pick the bit of each lane from the hash.
+constexpr uint32_t kLaneBlockedSalt[kLaneBlockedProbes] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+inline size_t LaneBlockedLineOffset(uint32_t h, uint32_t num_lines) {
+  // Maps the hash to [0, num_lines) without a division.
+  return ((static_cast<uint64_t>(h) * num_lines) >> 32) * kLaneBlockedLineBytes;
+}
+
+inline uint64_t LaneBlockedBit(uint32_t h, size_t lane) {
+  const uint32_t rotated = (h >> 17) | (h << 15);  // Rotate right 17 bits
+  return 1ULL << ((rotated * kLaneBlockedSalt[lane]) >> 26);
+}
+
+inline void LaneBlockedAddHash(uint32_t h, char* data, uint32_t num_lines) {
+  DCHECK_GT(num_lines, 0);
+  char* line = data + LaneBlockedLineOffset(h, num_lines);
+  for (size_t lane = 0; lane != kLaneBlockedProbes; ++lane) {
+    char* lane_data = line + lane * sizeof(uint64_t);
+    EncodeFixed64(lane_data, DecodeFixed64(lane_data) | LaneBlockedBit(h, lane));
+  }
+}
+
+inline bool LaneBlockedHashMayMatch(uint32_t h, const char* data, uint32_t num_lines) {
+  const char* line = data + LaneBlockedLineOffset(h, num_lines);
+  // There are no branches in the loop, so the compiler could vectorize it.
+  uint64_t missing = 0;
+  for (size_t lane = 0; lane != kLaneBlockedProbes; ++lane) {
+    missing |= ~DecodeFixed64(line + lane * sizeof(uint64_t)) & LaneBlockedBit(h, lane);
+  }
+  return missing == 0;
+}
+
 class FullFilterBitsBuilder : public FilterBitsBuilder {
  public:
   explicit FullFilterBitsBuilder(const size_t bits_per_key,
@@ -184,13 +227,16 @@ class FullFilterBitsReader : public FilterBitsReader {
         num_lines_(0) {
     assert(data_);
     GetFilterMeta(contents, &num_probes_, &num_lines_);
+    lane_blocked_ = num_probes_ == 0 && num_lines_ != 0;
+    const uint32_t line_size = lane_blocked_ ? kLaneBlockedLineBytes : CACHE_LINE_SIZE;
     // Sanitize broken parameters
-    if (num_lines_ != 0 && data_len_ != num_lines_ * CACHE_LINE_SIZE +
+    if (num_lines_ != 0 && data_len_ != num_lines_ * line_size +
         FullFilterBitsBuilder::kMetaDataSize) {
       RLOG(InfoLogLevel::ERROR_LEVEL, logger, "Bloom filter data is broken, won't be used.");
       FAIL_IF_NOT_PRODUCTION();
       num_lines_ = 0;
       num_probes_ = 0;
+      lane_blocked_ = false;
     }
   }
 
@@ -200,6 +246,9 @@ class FullFilterBitsReader : public FilterBitsReader {
     if (data_len_ <= FullFilterBitsBuilder::kMetaDataSize) { // remain same with original filter
       return false;
     }
+    if (lane_blocked_) {
+      return LaneBlockedHashMayMatch(BloomHash(entry), data_, num_lines_);
+    }
     // Other Error params, including a broken filter, regarded as match
     if (num_probes_ == 0 || num_lines_ == 0) return true;
     uint32_t hash = BloomHash(entry);
@@ -214,6 +263,8 @@ class FullFilterBitsReader : public FilterBitsReader {
   uint32_t data_len_;
   size_t num_probes_;
   uint32_t num_lines_;
+  // Whether the filter has the lane-blocked format, see LaneBlockedAddHash().
+  bool lane_blocked_ = false;
 
   // Get num_probes, and num_lines from filter
   // If filter format broken, set both to 0.
@@ -411,15 +462,33 @@ class BloomFilterPolicy : public FilterPolicy {
 // The number of hash function given error rate p is -ln p / ln 2.
 // The maximum number of keys that can be inserted in a Bloom filter of m bits
 // so that one maintains the false positive error rate p is -m (ln 2)^2 / ln p.
+//
+// With lane_blocked the filter uses the format of LaneBlockedAddHash() with zero probes in the
+// metadata, and accepts 10% fewer keys to keep the error rate.
 class FixedSizeFilterBitsBuilder : public FilterBitsBuilder {
  public:
   FixedSizeFilterBitsBuilder(const FixedSizeFilterBitsBuilder&) = delete;
   void operator=(const FixedSizeFilterBitsBuilder&) = delete;
 
-  FixedSizeFilterBitsBuilder(uint32_t total_bits, double error_rate)
-      : error_rate_(error_rate) {
+  FixedSizeFilterBitsBuilder(uint32_t total_bits, double error_rate, bool lane_blocked)
+      : error_rate_(error_rate), lane_blocked_(lane_blocked) {
     DCHECK_GT(error_rate, 0);
     DCHECK_GT(total_bits, 0);
+    const double minus_log_error_rate = -log(error_rate_);
+    DCHECK_GT(minus_log_error_rate, 0);
+    keys_added_ = 0;
+    if (lane_blocked_) {
+      // Lines are picked by multiplication, so their number does not have to be odd.
+      num_lines_ = yb::ceil_div(total_bits, kLaneBlockedLineBits);
+      total_bits_ = num_lines_ * kLaneBlockedLineBits;
+      num_probes_ = 0;
+      max_keys_ = static_cast<size_t>(
+          0.9 * total_bits_ * LOG2 * LOG2 / minus_log_error_rate);
+      data_.reset(new char[FilterSize()]);
+      memset(data_.get(), 0, FilterSize());
+      return;
+    }
+
     num_lines_ = yb::ceil_div(total_bits, CACHE_LINE_SIZE * 8);
     // AddHash implementation gives much higher false positive rate when num_lines_ is even, so
     // make sure it is odd.
@@ -434,15 +503,12 @@ class FixedSizeFilterBitsBuilder : public FilterBitsBuilder {
     }
     total_bits_ = num_lines_ * CACHE_LINE_SIZE * 8;
 
-    const double minus_log_error_rate = -log(error_rate_);
-    DCHECK_GT(minus_log_error_rate, 0);
     num_probes_ = static_cast<size_t> (minus_log_error_rate / LOG2);
     num_probes_ = std::max<size_t>(num_probes_, 1);
     num_probes_ = std::min<size_t>(num_probes_, 255);
     const double max_keys = total_bits_ * LOG2 * LOG2 / minus_log_error_rate;
     DCHECK_LT(max_keys, std::numeric_limits<size_t>::max());
     max_keys_ = static_cast<size_t> (max_keys);
-    keys_added_ = 0;
 
     // TODO - add tests verifying that after inserting max_keys we will have required error rate
 
@@ -453,6 +519,10 @@ class FixedSizeFilterBitsBuilder : public FilterBitsBuilder {
   virtual void AddKey(const Slice& key) override {
     ++keys_added_;
     uint32_t hash = BloomHash(key);
+    if (lane_blocked_) {
+      LaneBlockedAddHash(hash, data_.get(), num_lines_);
+      return;
+    }
     AddHash(hash, data_.get(), num_lines_, total_bits_, num_probes_);
   }
 
@@ -478,7 +548,8 @@ class FixedSizeFilterBitsBuilder : public FilterBitsBuilder {
   uint32_t total_bits_; // total number of bits used for filter (excluding metadata)
   uint32_t num_lines_;
   double error_rate_;
-  size_t num_probes_; // number of hash functions
+  bool lane_blocked_;
+  size_t num_probes_; // number of hash functions, zero for the lane-blocked format
 };
 
 class FixedSizeFilterBitsReader : public FullFilterBitsReader {
@@ -492,10 +563,12 @@ class FixedSizeFilterBitsReader : public FullFilterBitsReader {
 
 class FixedSizeFilterPolicy : public FilterPolicy {
  public:
-  explicit FixedSizeFilterPolicy(uint32_t total_bits, double error_rate, Logger* logger)
+  explicit FixedSizeFilterPolicy(
+      uint32_t total_bits, double error_rate, Logger* logger, bool lane_blocked)
       : total_bits_(total_bits),
         error_rate_(error_rate),
-        logger_(logger) {
+        logger_(logger),
+        lane_blocked_(lane_blocked) {
     DCHECK_GT(error_rate, 0);
     // Make sure num_probes > 0.
     DCHECK_GT(static_cast<int64_t> (-log(error_rate) / LOG2), 0);
@@ -519,7 +592,7 @@ class FixedSizeFilterPolicy : public FilterPolicy {
   }
 
   virtual FilterBitsBuilder* GetFilterBitsBuilder() const override {
-    return new FixedSizeFilterBitsBuilder(total_bits_, error_rate_);
+    return new FixedSizeFilterBitsBuilder(total_bits_, error_rate_, lane_blocked_);
   }
 
   virtual FilterBitsReader* GetFilterBitsReader(const Slice& contents) const override {
@@ -532,6 +605,7 @@ class FixedSizeFilterPolicy : public FilterPolicy {
   uint32_t total_bits_;
   double error_rate_;
   Logger* logger_;
+  bool lane_blocked_;
 };
 
 }  // namespace
@@ -544,8 +618,9 @@ const FilterPolicy* NewBloomFilterPolicy(int bits_per_key,
 
 const FilterPolicy* NewFixedSizeFilterPolicy(uint32_t total_bits,
                                              double error_rate,
-                                             Logger* logger) {
-  return new FixedSizeFilterPolicy(total_bits, error_rate, logger);
+                                             Logger* logger,
+                                             bool lane_blocked) {
+  return new FixedSizeFilterPolicy(total_bits, error_rate, logger, lane_blocked);
 }
 
 }  // namespace rocksdb
@@ -217,6 +217,11 @@ class FullFilterBloomTestContext : public BloomTestContext {
 
 class FixedSizeFilterBloomTestContext : public BloomTestContext {
  public:
+  explicit FixedSizeFilterBloomTestContext(bool lane_blocked)
+      : filter_policy_(NewFixedSizeFilterPolicy(
+            FilterPolicy::kDefaultFixedSizeFilterBits,
+            FilterPolicy::kDefaultFixedSizeFilterErrorRate, nullptr, lane_blocked)) {}
+
   const FilterPolicy& filter_policy() const override { return *filter_policy_.get(); }
 
   // For fixed-size filter we limit maximum number of keys depending on total bits in test itself
@@ -228,13 +233,11 @@ class FixedSizeFilterBloomTestContext : public BloomTestContext {
   }
 
  private:
-  std::unique_ptr<const FilterPolicy> filter_policy_{
-      NewFixedSizeFilterPolicy(
-          FilterPolicy::kDefaultFixedSizeFilterBits, FilterPolicy::kDefaultFixedSizeFilterErrorRate,
-          nullptr)};
+  std::unique_ptr<const FilterPolicy> filter_policy_;
 };
 
-YB_DEFINE_ENUM(BuilderReaderBloomTestType, (kFullFilter)(kFixedSizeFilter));
+YB_DEFINE_ENUM(BuilderReaderBloomTestType,
+               (kFullFilter)(kFixedSizeFilter)(kFixedSizeLaneBlockedFilter));
 
 namespace {
 
@@ -243,7 +246,9 @@ std::unique_ptr<const BloomTestContext> CreateContext(BuilderReaderBloomTestType
     case BuilderReaderBloomTestType::kFullFilter:
       return std::make_unique<FullFilterBloomTestContext>();
     case BuilderReaderBloomTestType::kFixedSizeFilter:
-      return std::make_unique<FixedSizeFilterBloomTestContext>();
+      return std::make_unique<FixedSizeFilterBloomTestContext>(false /* lane_blocked */);
+    case BuilderReaderBloomTestType::kFixedSizeLaneBlockedFilter:
+      return std::make_unique<FixedSizeFilterBloomTestContext>(true /* lane_blocked */);
   }
   FATAL_INVALID_ENUM_VALUE(BuilderReaderBloomTestType, type);
 }
@@ -372,7 +377,8 @@ TEST_P(BuilderReaderBloomTest, FullVaryingLengths) {
 
 INSTANTIATE_TEST_CASE_P(, BuilderReaderBloomTest, ::testing::Values(
     BuilderReaderBloomTestType::kFullFilter,
-    BuilderReaderBloomTestType::kFixedSizeFilter));
+    BuilderReaderBloomTestType::kFixedSizeFilter,
+    BuilderReaderBloomTestType::kFixedSizeLaneBlockedFilter));
 
 }  // namespace rocksdb
 
@@ -24,8 +24,15 @@
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include <boost/thread/shared_mutex.hpp>
 #include <gflags/gflags.h>
 
+#include "yb/util/locks.h"
 #include "yb/util/metrics.h"
 #include "yb/rocksdb/cache.h"
 #include "yb/rocksdb/statistics.h"
@@ -56,7 +63,8 @@ namespace {
 //
 // LRUHandle can be in these states:
 // 1. Referenced externally AND in hash table.
-//  In that case the entry is *not* in the LRU. (refs > 1 && in_cache == true)
+//  The entry could still be linked into the LRU, since a hit does not unlink it. Such entries are
+//  unlinked when eviction reaches them. (refs > 1 && in_cache == true)
 // 2. Not referenced externally and in hash table. In that case the entry is
 // in the LRU and can be freed. (refs == 1 && in_cache == true)
 // 3. Referenced externally and not in hash table. In that case the entry is
@@ -70,6 +78,11 @@ namespace {
 // that any successful LRUCache::Lookup/LRUCache::Insert have a matching
 // RUCache::Release (to move into state 2) or LRUCache::Erase (for state 3)
 //
+// Lookups and releases that do not change the position of an entry in the LRU only take the
+// shard lock in shared mode. So the LRU order is updated lazily: a hit increments the saturating
+// hit counter of the entry, and eviction gives entries with hits another chance by decrementing the
+// counter and moving them to the newest end of the LRU instead of evicting them.
+//
 // LRU also supports scan resistant access by allowing it to be one of two
 // caches. query_id is to detect that multiple touches from the same query will not
 // upgrade the cache element from single touch LRU into the multiple touch LRU.
@@ -78,6 +91,8 @@ namespace {
 // that are accessed multiple times by different queries.
 // query_id == kNoCacheQueryId means that this Handle is not going to be added
 // into the cache.
+// query_id == kLowPriorityQueryId means that the handle was added by a scan, so it is
+// placed at the cold end of the single touch LRU and is evicted first.
 
 struct LRUHandle {
   void* value;
@@ -87,9 +102,12 @@ struct LRUHandle {
   LRUHandle* prev;
   size_t charge;      // TODO(opt): Only allow uint32_t?
   size_t key_length;
-  uint32_t refs;      // a number of refs to this entry
-                      // cache itself is counted as 1
+  std::atomic<uint32_t> refs;     // a number of refs to this entry
+                                  // cache itself is counted as 1
   bool in_cache;      // true, if this entry is referenced by the hash table
+  bool in_lru;        // true, if this entry is linked into the LRU list of its sub cache
+  std::atomic<uint8_t> hits;      // Number of hits since the entry was linked into the LRU,
+                                  // saturated at kMaxLRUHits
   uint32_t hash;      // Hash of key(); used for fast sharding and comparisons
   QueryId query_id;  // Query id that added the value to the cache.
   char key_data[1];   // Beginning of key
@@ -121,6 +139,10 @@ struct LRUHandle {
   SubCacheType GetSubCacheType() const {
     return (query_id == kInMultiTouchId) ? MULTI_TOUCH : SINGLE_TOUCH;
   }
+
+  bool IsLowPriority() const {
+    return query_id == kLowPriorityQueryId;
+  }
 };
 
 // We provide our own simple hash table since it removes a whole bunch
@@ -170,7 +192,8 @@ class HandleTable {
     }
 
     LRUHandle* val = Lookup(h->key(), h->hash);
-    if (val != nullptr && (val->GetSubCacheType() == MULTI_TOUCH || val->query_id != h->query_id)) {
+    if (val != nullptr && (val->GetSubCacheType() == MULTI_TOUCH ||
+                           (val->query_id != h->query_id && !h->IsLowPriority()))) {
       h->query_id = kInMultiTouchId;
       return MULTI_TOUCH;
     }
@@ -262,11 +285,7 @@ class LRUSubCache {
 
   // Accessors.
   size_t Usage() const {
-    return usage_;
-  }
-
-  size_t LRU_Usage() const {
-    return lru_usage_;
+    return usage_.load(std::memory_order_relaxed);
   }
 
   size_t Capacity() const {
@@ -289,27 +308,36 @@ class LRUSubCache {
   }
 
   size_t GetPinnedUsage() const {
-    assert(usage_ >= lru_usage_);
-    return usage_ - lru_usage_;
+    return pinned_usage_.load(std::memory_order_relaxed);
   }
 
   void DecrementUsage(const size_t charge) {
-    assert(usage_ >= charge);
-    usage_ -= charge;
+    auto old_usage = usage_.fetch_sub(charge, std::memory_order_relaxed);
+    assert(old_usage >= charge);
   }
 
   void IncrementUsage(const size_t charge) {
     assert(usage_ + charge > 0);
-    usage_ += charge;
+    usage_.fetch_add(charge, std::memory_order_relaxed);
+  }
+
+  void DecrementPinnedUsage(const size_t charge) {
+    auto old_usage = pinned_usage_.fetch_sub(charge, std::memory_order_relaxed);
+    assert(old_usage >= charge);
+  }
+
+  void IncrementPinnedUsage(const size_t charge) {
+    pinned_usage_.fetch_add(charge, std::memory_order_relaxed);
   }
 
   void LRU_Remove(LRUHandle* e);
   void LRU_Append(LRUHandle *e);
+  void LRU_Prepend(LRUHandle *e);
 
  private:
   // Dummy heads of single-touch and multi-touch LRU list.
   // lru.prev is newest entry, lru.next is oldest entry.
-  // LRU contains items which can be evicted, ie referenced only by cache.
+  // LRU contains items which can be evicted, and items that were referenced after being linked.
   LRUHandle lru_;
 
   // Capacity of the sub_cache.
@@ -317,13 +345,14 @@ class LRUSubCache {
 
   // Memory size for entries residing in the cache.
   // Includes entries in the LRU list and referenced by callers and thus not eligible for cleanup.
-  size_t usage_;
+  // Updated under the shared lock when the last reference to an erased entry is released.
+  std::atomic<size_t> usage_;
 
-  // Memory size for entries residing only in the LRU list
-  size_t lru_usage_;
+  // Memory size for entries referenced by callers.
+  std::atomic<size_t> pinned_usage_;
 };
 
-LRUSubCache::LRUSubCache() : capacity_(0), usage_(0), lru_usage_(0) {
+LRUSubCache::LRUSubCache() : capacity_(0), usage_(0), pinned_usage_(0) {
   // Make empty circular linked list
   lru_.next = &lru_;
   lru_.prev = &lru_;
@@ -335,23 +364,39 @@ LRUSubCache::~LRUSubCache() {}
 void LRUSubCache::LRU_Remove(LRUHandle* e) {
   assert(e->next != nullptr);
   assert(e->prev != nullptr);
+  assert(e->in_lru);
   e->next->prev = e->prev;
   e->prev->next = e->next;
   e->prev = e->next = nullptr;
-  lru_usage_ -= e->charge;
+  e->in_lru = false;
 }
 
 // Append to the LRU header of the sub cache.
 void LRUSubCache::LRU_Append(LRUHandle *e) {
   assert(e->next == nullptr);
-  assert(e->next == nullptr);
+  assert(e->prev == nullptr);
   e->next = &lru_;
   e->prev = lru_.prev;
   e->prev->next = e;
   e->next->prev = e;
-  lru_usage_ += e->charge;
+  e->in_lru = true;
+}
+
+// Prepend to the LRU header of the sub cache, so the handle is the first one to be evicted.
+void LRUSubCache::LRU_Prepend(LRUHandle *e) {
+  assert(e->next == nullptr);
+  assert(e->prev == nullptr);
+  e->prev = &lru_;
+  e->next = lru_.next;
+  e->prev->next = e;
+  e->next->prev = e;
+  e->in_lru = true;
 }
 
+// Hits are counted up to this number, so an entry that is hit often survives this number of passes
+// of eviction over the LRU.
+constexpr uint8_t kMaxLRUHits = 3;
+
 // A single shard of sharded cache.
 class LRUCache {
  public:
@@ -381,17 +426,13 @@ class LRUCache {
   void Release(Cache::Handle* handle);
   void Erase(const Slice& key, uint32_t hash);
 
-  // Although in some platforms the update of size_t is atomic, to make sure
-  // GetUsage() and GetPinnedUsage() work correctly under any platform, we'll
-  // protect them with mutex_.
+  // Usages are atomic, so GetUsage() and GetPinnedUsage() do not need to lock the shard.
 
   size_t GetUsage() const {
-    MutexLock l(&mutex_);
     return single_touch_sub_cache_.Usage() + multi_touch_sub_cache_.Usage();
   }
 
   size_t GetPinnedUsage() const {
-    MutexLock l(&mutex_);
     return single_touch_sub_cache_.GetPinnedUsage() + multi_touch_sub_cache_.GetPinnedUsage();
   }
 
@@ -407,14 +448,33 @@ class LRUCache {
   LRUSubCache* GetSubCache(const SubCacheType subcache_type);
   LRUSubCache single_touch_sub_cache_;
   LRUSubCache multi_touch_sub_cache_;
+
+  // Adds an external reference to the entry, that is in the hash table.
+  void Ref(LRUHandle* e);
+
   // Just reduce the reference count by 1.
   // Return true if last reference
   bool Unref(LRUHandle* e);
 
+  // Marks the entry as recently used, so eviction will give it another chance.
+  void Touch(LRUHandle* e);
+
+  // Whether lookup of the entry by the given query changes the sub cache or the position of the
+  // entry, so requires the exclusive lock.
+  bool LookupNeedsExclusiveLock(LRUHandle* e, const QueryId query_id);
+
+  // Updates the state of the entry that was found by Lookup under the exclusive lock.
+  void UpdateOnLookup(LRUHandle* e, const QueryId query_id);
+
+  // Whether release of the entry could be done under the shared lock.
+  bool CanReleaseShared(LRUHandle* e);
+
+  void RecordLookup(LRUHandle* e, Statistics* statistics);
+
   // Free some space following strict LRU policy until enough space
   // to hold (usage_ + charge) is freed or the lru list is empty
   // This function is not thread safe - it needs to be executed while
-  // holding the mutex_
+  // holding the mutex_ in exclusive mode
   void EvictFromLRU(size_t charge, autovector<LRUHandle*>* deleted, SubCacheType subcache_type);
 
   // Decrements the usage on the appropriate subcache.
@@ -424,9 +484,11 @@ class LRUCache {
   bool strict_capacity_limit_;
 
   // mutex_ protects the following state.
+  // Lookups and releases that do not change the LRU take it in shared mode, everything else takes
+  // it in exclusive mode.
   // We don't count mutex_ as the cache's internal state so semantically we
   // don't mind mutex_ invoking the non-const actions.
-  mutable port::Mutex mutex_;
+  mutable yb::rw_spinlock mutex_;
 
   HandleTable table_;
 
@@ -437,10 +499,30 @@ LRUCache::LRUCache() {}
 
 LRUCache::~LRUCache() {}
 
+void LRUCache::Ref(LRUHandle* e) {
+  assert(e->in_cache);
+  // The first external reference pins the entry.
+  if (e->refs.fetch_add(1) == 1) {
+    GetSubCache(e->GetSubCacheType())->IncrementPinnedUsage(e->charge);
+  }
+}
+
 bool LRUCache::Unref(LRUHandle* e) {
-  assert(e->refs > 0);
-  e->refs--;
-  return e->refs == 0;
+  auto old_refs = e->refs.fetch_sub(1);
+  assert(old_refs > 0);
+  return old_refs == 1;
+}
+
+void LRUCache::Touch(LRUHandle* e) {
+  // Values filled by scans should stay at the cold end of the LRU.
+  if (e->IsLowPriority()) {
+    return;
+  }
+  // Concurrent hits could be lost, this is fine since the counter is only a hint for eviction.
+  auto hits = e->hits.load(std::memory_order_relaxed);
+  if (hits < kMaxLRUHits) {
+    e->hits.store(hits + 1, std::memory_order_relaxed);
+  }
 }
 
 LRUSubCache* LRUCache::GetSubCache(const SubCacheType subcache_type) {
@@ -462,13 +544,13 @@ void LRUCache::DecrementUsage(const SubCacheType subcache_type, const size_t cha
 void LRUCache::ApplyToAllCacheEntries(void (*callback)(void*, size_t),
                                       bool thread_safe) {
   if (thread_safe) {
-    mutex_.Lock();
+    mutex_.lock();
   }
   table_.ApplyToAllCacheEntries([callback](LRUHandle* h) {
     callback(h->value, h->charge);
   });
   if (thread_safe) {
-    mutex_.Unlock();
+    mutex_.unlock();
   }
 }
 
@@ -477,6 +559,11 @@ void LRUCache::LRU_Remove(LRUHandle* e) {
 }
 
 void LRUCache::LRU_Append(LRUHandle* e) {
+  if (e->IsLowPriority()) {
+    // Values filled by scans are made the oldest entry by inserting just after lru_.
+    GetSubCache(e->GetSubCacheType())->LRU_Prepend(e);
+    return;
+  }
   // Make "e" newest entry by inserting just before lru_
   GetSubCache(e->GetSubCacheType())->LRU_Append(e);
 }
@@ -488,8 +575,18 @@ void LRUCache::EvictFromLRU(size_t charge, autovector<LRUHandle*>* deleted,
   while (sub_cache->Usage() + charge > sub_cache->Capacity() && !sub_cache->IsLRUEmpty()) {
     LRUHandle* old = sub_cache->LRU_Head().next;
     assert(old->in_cache);
-    assert(old->refs == 1);  // LRU list contains elements which may be evicted
     sub_cache->LRU_Remove(old);
+    if (old->refs > 1) {
+      // Referenced externally, so cannot be evicted. It is linked back when released.
+      continue;
+    }
+    auto hits = old->hits.load(std::memory_order_relaxed);
+    if (hits != 0) {
+      // Was hit since it was linked, so give it another chance.
+      old->hits.store(hits - 1, std::memory_order_relaxed);
+      LRU_Append(old);
+      continue;
+    }
     table_.Remove(old->key(), old->hash);
     old->in_cache = false;
     Unref(old);
@@ -501,7 +598,7 @@ void LRUCache::EvictFromLRU(size_t charge, autovector<LRUHandle*>* deleted,
 void LRUCache::SetCapacity(size_t capacity) {
   autovector<LRUHandle*> last_reference_list;
   {
-    MutexLock l(&mutex_);
+    std::lock_guard<yb::rw_spinlock> l(mutex_);
     single_touch_sub_cache_.SetCapacity(
       static_cast<size_t>(round(FLAGS_cache_single_touch_ratio * capacity)));
     multi_touch_sub_cache_.SetCapacity(capacity - single_touch_sub_cache_.Capacity());
@@ -516,46 +613,68 @@ void LRUCache::SetCapacity(size_t capacity) {
 }
 
 void LRUCache::SetStrictCapacityLimit(bool strict_capacity_limit) {
-  MutexLock l(&mutex_);
+  std::lock_guard<yb::rw_spinlock> l(mutex_);
   strict_capacity_limit_ = strict_capacity_limit;
 }
 
-Cache::Handle* LRUCache::Lookup(const Slice& key, uint32_t hash, const QueryId query_id,
-                                Statistics* statistics)  {
-  MutexLock l(&mutex_);
-  LRUHandle* e = table_.Lookup(key, hash);
-  if (e != nullptr) {
-    assert(e->in_cache);
-    // Since the entry is now referenced externally, cannot be evicted, so remove from LRU.
-    if (e->refs == 1) {
-      LRU_Remove(e);
-    }
-    // Increase the number of references and move to state 1. (in cache and not in LRU)
-    e->refs++;
+bool LRUCache::LookupNeedsExclusiveLock(LRUHandle* e, const QueryId query_id) {
+  // A regular query touching a value filled by a scan makes it a regular value.
+  if (e->IsLowPriority() && query_id != kLowPriorityQueryId) {
+    return true;
+  }
+  // The handle will be moved to the multi touch pool.
+  return FLAGS_cache_single_touch_ratio < 1 && e->GetSubCacheType() != MULTI_TOUCH &&
+         e->query_id != query_id && query_id != kLowPriorityQueryId;
+}
 
-    // Now the handle will be added to the multi touch pool only if it exists.
-    if (FLAGS_cache_single_touch_ratio < 1 && e->GetSubCacheType() != MULTI_TOUCH &&
-        e->query_id != query_id) {
-      autovector<LRUHandle*> multi_touch_eviction_list;
-      EvictFromLRU(e->charge, &multi_touch_eviction_list, MULTI_TOUCH);
-      for (auto entry : multi_touch_eviction_list) {
-        entry->Free(metrics_.get());
+void LRUCache::UpdateOnLookup(LRUHandle* e, const QueryId query_id) {
+  // Now the handle will be added to the multi touch pool only if it exists.
+  if (FLAGS_cache_single_touch_ratio < 1 && e->GetSubCacheType() != MULTI_TOUCH &&
+      e->query_id != query_id && query_id != kLowPriorityQueryId) {
+    autovector<LRUHandle*> multi_touch_eviction_list;
+    EvictFromLRU(e->charge, &multi_touch_eviction_list, MULTI_TOUCH);
+    for (auto entry : multi_touch_eviction_list) {
+      entry->Free(metrics_.get());
+    }
+    // Cannot have any single touch elements in this case.
+    assert(FLAGS_cache_single_touch_ratio != 0);
+    if (!strict_capacity_limit_ ||
+        multi_touch_sub_cache_.GetPinnedUsage() + e->charge <= multi_touch_sub_cache_.Capacity()) {
+      const bool in_lru = e->in_lru;
+      if (in_lru) {
+        single_touch_sub_cache_.LRU_Remove(e);
+      }
+      e->query_id = kInMultiTouchId;
+      single_touch_sub_cache_.DecrementUsage(e->charge);
+      multi_touch_sub_cache_.IncrementUsage(e->charge);
+      // The entry was just referenced by this lookup, so it is pinned.
+      single_touch_sub_cache_.DecrementPinnedUsage(e->charge);
+      multi_touch_sub_cache_.IncrementPinnedUsage(e->charge);
+      if (in_lru) {
+        multi_touch_sub_cache_.LRU_Append(e);
       }
-      // Cannot have any single touch elements in this case.
-      assert(FLAGS_cache_single_touch_ratio != 0);
-      if (!strict_capacity_limit_ ||
-          multi_touch_sub_cache_.Usage() - multi_touch_sub_cache_.LRU_Usage() + e->charge <=
-          multi_touch_sub_cache_.Capacity()) {
-        e->query_id = kInMultiTouchId;
-        single_touch_sub_cache_.DecrementUsage(e->charge);
-        multi_touch_sub_cache_.IncrementUsage(e->charge);
-       if (metrics_) {
-         metrics_->multi_touch_cache_usage->IncrementBy(e->charge);
-         metrics_->single_touch_cache_usage->DecrementBy(e->charge);
-       }
+      if (metrics_) {
+        metrics_->multi_touch_cache_usage->IncrementBy(e->charge);
+        metrics_->single_touch_cache_usage->DecrementBy(e->charge);
       }
     }
-    if (statistics != nullptr) {
+  }
+  // A regular query touching a value filled by a scan makes it a regular single touch value.
+  if (e->IsLowPriority() && query_id != kLowPriorityQueryId) {
+    const bool in_lru = e->in_lru;
+    if (in_lru) {
+      LRU_Remove(e);
+    }
+    e->query_id = query_id;
+    if (in_lru) {
+      LRU_Append(e);
+    }
+  }
+}
+
+void LRUCache::RecordLookup(LRUHandle* e, Statistics* statistics) {
+  if (statistics != nullptr) {
+    if (e != nullptr) {
       // overall cache hit
       RecordTick(statistics, BLOCK_CACHE_HIT);
       // total bytes read from cache
@@ -567,9 +686,7 @@ Cache::Handle* LRUCache::Lookup(const Slice& key, uint32_t hash, const QueryId q
         RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_HIT);
         RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_BYTES_READ, e->charge);
       }
-    }
-  } else {
-    if (statistics != nullptr) {
+    } else {
       RecordTick(statistics, BLOCK_CACHE_MISS);
     }
   }
@@ -583,34 +700,94 @@ Cache::Handle* LRUCache::Lookup(const Slice& key, uint32_t hash, const QueryId q
       metrics_->cache_misses->Increment();
     }
   }
+}
+
+Cache::Handle* LRUCache::Lookup(const Slice& key, uint32_t hash, const QueryId query_id,
+                                Statistics* statistics)  {
+  LRUHandle* e;
+  bool needs_exclusive_lock = false;
+  {
+    boost::shared_lock<yb::rw_spinlock> l(mutex_);
+    e = table_.Lookup(key, hash);
+    if (e != nullptr) {
+      needs_exclusive_lock = LookupNeedsExclusiveLock(e, query_id);
+      if (!needs_exclusive_lock) {
+        // Increase the number of references and move to state 1. The entry stays in the LRU
+        // until eviction reaches it.
+        Ref(e);
+        Touch(e);
+      }
+    }
+  }
+  if (needs_exclusive_lock) {
+    std::lock_guard<yb::rw_spinlock> l(mutex_);
+    // The entry could be replaced or evicted while the lock was not held, so look it up again.
+    e = table_.Lookup(key, hash);
+    if (e != nullptr) {
+      Ref(e);
+      UpdateOnLookup(e, query_id);
+      Touch(e);
+    }
+  }
+  RecordLookup(e, statistics);
   return reinterpret_cast<Cache::Handle*>(e);
 }
 
+bool LRUCache::CanReleaseShared(LRUHandle* e) {
+  if (!e->in_cache) {
+    return true;
+  }
+  // The entry should be linked back into the LRU, or the shard is over capacity and the entry
+  // should be evicted when it is no longer referenced.
+  LRUSubCache* sub_cache = GetSubCache(e->GetSubCacheType());
+  return e->in_lru && sub_cache->Usage() <= sub_cache->Capacity();
+}
+
 void LRUCache::Release(Cache::Handle* handle) {
   if (handle == nullptr) {
     return;
   }
   LRUHandle* e = reinterpret_cast<LRUHandle*>(handle);
   bool last_reference = false;
+  bool released = false;
   {
-    MutexLock l(&mutex_);
+    boost::shared_lock<yb::rw_spinlock> l(mutex_);
+    if (CanReleaseShared(e)) {
+      LRUSubCache* sub_cache = GetSubCache(e->GetSubCacheType());
+      const bool in_cache = e->in_cache;
+      last_reference = Unref(e);
+      if (last_reference) {
+        // Entries that are not in the cache hold only external references.
+        sub_cache->DecrementPinnedUsage(e->charge);
+        sub_cache->DecrementUsage(e->charge);
+      } else if (in_cache && e->refs == 1) {
+        sub_cache->DecrementPinnedUsage(e->charge);
+      }
+      released = true;
+    }
+  }
+  if (!released) {
+    std::lock_guard<yb::rw_spinlock> l(mutex_);
     LRUSubCache* sub_cache = GetSubCache(e->GetSubCacheType());
     last_reference = Unref(e);
     if (last_reference) {
+      sub_cache->DecrementPinnedUsage(e->charge);
       sub_cache->DecrementUsage(e->charge);
     }
     if (e->refs == 1 && e->in_cache) {
       // The item is still in cache, and nobody else holds a reference to it
+      sub_cache->DecrementPinnedUsage(e->charge);
       if (sub_cache->Usage() > sub_cache->Capacity()) {
-        // The LRU list must be empty since the cache is full.
-        assert(sub_cache->IsLRUEmpty());
         // take this opportunity and remove the item
+        if (e->in_lru) {
+          sub_cache->LRU_Remove(e);
+        }
         table_.Remove(e->key(), e->hash);
         e->in_cache = false;
         Unref(e);
         sub_cache->DecrementUsage(e->charge);
         last_reference = true;
-      } else {
+      } else if (!e->in_lru) {
         // put the item on the list to be potentially freed.
         LRU_Append(e);
       }
@@ -633,8 +810,7 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
   // Allocate the memory here outside of the mutex
   // If the cache is full, we'll have to release it
   // It shouldn't happen very often though.
-  LRUHandle* e = reinterpret_cast<LRUHandle*>(
-                    new char[sizeof(LRUHandle) - 1 + key.size()]);
+  LRUHandle* e = new (new char[sizeof(LRUHandle) - 1 + key.size()]) LRUHandle;
   Status s;
   autovector<LRUHandle*> last_reference_list;
 
@@ -648,12 +824,14 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
                  : 2);  // One from LRUCache, one for the returned handle
   e->next = e->prev = nullptr;
   e->in_cache = true;
+  e->in_lru = false;
+  e->hits = 0;
   // Adding query id to the handle.
   e->query_id = query_id;
   memcpy(e->key_data, key.data(), key.size());
 
   {
-    MutexLock l(&mutex_);
+    std::lock_guard<yb::rw_spinlock> l(mutex_);
     // Free the space following strict LRU policy until enough space
     // is freed or the lru list is empty.
     // Check if there is a single touch cache.
@@ -671,7 +849,7 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
     LRUSubCache* sub_cache = GetSubCache(subcache_type);
     // If the cache no longer has any more space in the given pool.
     if (strict_capacity_limit_ &&
-        sub_cache->Usage() - sub_cache->LRU_Usage() + charge > sub_cache->Capacity()) {
+        sub_cache->GetPinnedUsage() + charge > sub_cache->Capacity()) {
       if (handle == nullptr) {
         last_reference_list.push_back(e);
       } else {
@@ -687,18 +865,19 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
       sub_cache->IncrementUsage(e->charge);
       if (old != nullptr) {
         old->in_cache = false;
+        if (old->in_lru) {
+          LRU_Remove(old);
+        }
         if (Unref(old)) {
           DecrementUsage(old->GetSubCacheType(), old->charge);
-          // old is on LRU because it's in cache and its reference count
-          // was just 1 (Unref returned 0)
-          LRU_Remove(old);
           last_reference_list.push_back(old);
         }
       }
-      // No external reference, so put it in LRU to be potentially evicted.
-      if (handle == nullptr) {
-        LRU_Append(e);
-      } else {
+      // Put it in LRU to be potentially evicted, referenced entry will be unlinked from the LRU
+      // when eviction reaches it.
+      LRU_Append(e);
+      if (handle != nullptr) {
+        sub_cache->IncrementPinnedUsage(e->charge);
         *handle = reinterpret_cast<Cache::Handle*>(e);
       }
       s = Status::OK();
@@ -742,16 +921,16 @@ void LRUCache::Erase(const Slice& key, uint32_t hash) {
   LRUHandle* e;
   bool last_reference = false;
   {
-    MutexLock l(&mutex_);
+    std::lock_guard<yb::rw_spinlock> l(mutex_);
     e = table_.Remove(key, hash);
     if (e != nullptr) {
+      if (e->in_lru) {
+        LRU_Remove(e);
+      }
       last_reference = Unref(e);
       if (last_reference) {
         DecrementUsage(e->GetSubCacheType(), e->charge);
       }
-      if (last_reference && e->in_cache) {
-        LRU_Remove(e);
-      }
       e->in_cache = false;
     }
   }
@@ -762,7 +941,12 @@ void LRUCache::Erase(const Slice& key, uint32_t hash) {
   }
 }
 
-static int kNumShardBits = 4;          // default values, can be overridden
+// Shards are not made smaller than this, so a shard still holds a fair number of blocks.
+constexpr size_t kMinShardCapacity = 512 * 1024;
+// The number of shards is selected to have this number of shards per core.
+constexpr size_t kShardsPerCore = 2;
+// NewLRUCache does not allow cache to be sharded into more pieces.
+constexpr int kMaxNumShardBits = 19;
 
 class ShardedLRUCache : public Cache {
  private:
@@ -785,7 +969,8 @@ class ShardedLRUCache : public Cache {
   }
 
   bool IsValidQueryId(const QueryId query_id) {
-    return query_id >= 0 || query_id == kInMultiTouchId || query_id == kNoCacheQueryId;
+    return query_id >= 0 || query_id == kInMultiTouchId || query_id == kNoCacheQueryId ||
+           query_id == kLowPriorityQueryId;
   }
 
  public:
@@ -925,8 +1110,19 @@ class ShardedLRUCache : public Cache {
 
 }  // end anonymous namespace
 
+int GetDefaultCacheShardBits(size_t capacity) {
+  const size_t num_shards = kShardsPerCore * std::max(std::thread::hardware_concurrency(), 1U);
+  int num_shard_bits = 0;
+  while (num_shard_bits < kMaxNumShardBits &&
+         (static_cast<size_t>(1) << num_shard_bits) < num_shards &&
+         (capacity >> (num_shard_bits + 1)) >= kMinShardCapacity) {
+    ++num_shard_bits;
+  }
+  return num_shard_bits;
+}
+
 shared_ptr<Cache> NewLRUCache(size_t capacity) {
-  return NewLRUCache(capacity, kNumShardBits, false);
+  return NewLRUCache(capacity, GetDefaultCacheShardBits(capacity), false);
 }
 
 shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits) {
@@ -48,7 +48,7 @@ static const uint32_t KB = 1024;
 DEFINE_int32(threads, 16, "Number of concurrent threads to run.");
 DEFINE_int64(cache_size, 8 * KB * KB,
              "Number of bytes to use as a cache of uncompressed data.");
-DEFINE_int32(num_shard_bits, 4, "shard_bits.");
+DEFINE_int32(num_shard_bits, -1, "shard_bits, -1 to pick the default for the cache size.");
 
 DEFINE_int64(max_key, 1 * KB * KB * KB, "Max number of key to place in cache");
 DEFINE_uint64(ops_per_thread, 1200000, "Number of operations per thread.");
@@ -66,7 +66,7 @@ namespace rocksdb {
 class CacheBench;
 namespace {
 void deleter(const Slice& key, void* value) {
-    delete reinterpret_cast<char *>(value);
+    delete[] reinterpret_cast<char *>(value);
 }
 
 // State shared by all concurrent executions of the same benchmark.
@@ -145,7 +145,9 @@ struct ThreadState {
 class CacheBench {
  public:
   CacheBench() :
-      cache_(NewLRUCache(FLAGS_cache_size, FLAGS_num_shard_bits)),
+      cache_(NewLRUCache(FLAGS_cache_size,
+                         FLAGS_num_shard_bits < 0 ? GetDefaultCacheShardBits(FLAGS_cache_size)
+                                                  : FLAGS_num_shard_bits)),
       num_threads_(FLAGS_threads) {}
 
   ~CacheBench() {}
@@ -157,7 +159,7 @@ class CacheBench {
       // Cast uint64* to be char*, data would be copied to cache
       Slice key(reinterpret_cast<char*>(&rand_key), 8);
       // do insert
-      cache_->Insert(key, new char[10], 1, &deleter);
+      cache_->Insert(key, kDefaultQueryId, new char[10], 1, &deleter);
     }
   }
 
@@ -233,18 +235,18 @@ class CacheBench {
       // Cast uint64* to be char*, data would be copied to cache
       Slice key(reinterpret_cast<char*>(&rand_key), 8);
       int32_t prob_op = thread->rnd.Uniform(100);
-      if (prob_op >= 0 && prob_op < FLAGS_insert_percent) {
+      // Use a few distinct query ids so that lookups exercise multi-touch promotion.
+      const QueryId query_id = 1 + thread->tid % 4;
+      if (prob_op < FLAGS_insert_percent) {
         // do insert
-        cache_->Insert(key, new char[10], 1, &deleter);
-      } else if (prob_op -= FLAGS_insert_percent &&
-                 prob_op < FLAGS_lookup_percent) {
+        cache_->Insert(key, query_id, new char[10], 1, &deleter);
+      } else if (prob_op < FLAGS_insert_percent + FLAGS_lookup_percent) {
         // do lookup
-        auto handle = cache_->Lookup(key);
+        auto handle = cache_->Lookup(key, query_id);
         if (handle) {
           cache_->Release(handle);
         }
-      } else if (prob_op -= FLAGS_lookup_percent &&
-                 prob_op < FLAGS_erase_percent) {
+      } else if (prob_op < FLAGS_insert_percent + FLAGS_lookup_percent + FLAGS_erase_percent) {
         // do erase
         cache_->Erase(key);
       }
@@ -23,12 +23,15 @@
 
 #include "yb/rocksdb/cache.h"
 
+#include <atomic>
 #include <forward_list>
 #include <vector>
 #include <string>
 #include <iostream>
+#include <thread>
 #include <gflags/gflags.h>
 #include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/random.h"
 #include "yb/rocksdb/util/string_util.h"
 #include "yb/rocksdb/util/testharness.h"
 
@@ -463,6 +466,33 @@ TEST_F(CacheTest, EvictionPolicyMultiTouch) {
   ASSERT_LT(kCacheSize * FLAGS_cache_single_touch_ratio, cache_->GetUsage());
 }
 
+TEST_F(CacheTest, LowPriorityFill) {
+  const int kCapacity = 100;
+  auto cache = NewLRUCache(kCapacity, 0);
+  const int kNumRegular = 10;
+  for (int i = 0; i < kNumRegular; i++) {
+    ASSERT_OK(Insert(cache, i, i + 1));
+  }
+
+  // Emulate a scan that reads much more than the cache capacity.
+  for (int i = 0; i < kCapacity * 10; i++) {
+    ASSERT_OK(Insert(cache, 1000 + i, 2000 + i, 1, kLowPriorityQueryId));
+    ASSERT_EQ(2000 + i, Lookup(cache, 1000 + i, kLowPriorityQueryId));
+  }
+
+  // Values filled by regular queries should not be evicted by the scan.
+  for (int i = 0; i < kNumRegular; i++) {
+    ASSERT_EQ(i + 1, Lookup(cache, i));
+  }
+  ASSERT_LE(cache->GetUsage(), kCapacity);
+
+  // Repeated scans do not upgrade the value to the multi touch cache, but a regular query does.
+  ASSERT_OK(Insert(cache, 500, 501, 1, kLowPriorityQueryId));
+  ASSERT_FALSE(LookupAndCheckInMultiTouch(cache, 500, 501, kLowPriorityQueryId));
+  ASSERT_FALSE(LookupAndCheckInMultiTouch(cache, 500, 501, kLowPriorityQueryId));
+  ASSERT_TRUE(LookupAndCheckInMultiTouch(cache, 500, 501, kTestQueryId));
+}
+
 TEST_F(CacheTest, HeavyEntries) {
   // Add a bunch of light and heavy entries and then count the combined
   // size of items still in the cache, which must be approximately the
@@ -490,6 +520,46 @@ TEST_F(CacheTest, HeavyEntries) {
   ASSERT_LE(cached_weight, kCacheSize + kCacheSize/10);
 }
 
+TEST_F(CacheTest, ConcurrentAccess) {
+  // Hits are served under the shared lock, so run lookups concurrently with evictions and erases
+  // and check that the accounting stays consistent.
+  const int kCapacity = 1000;
+  const int kNumKeys = 3000;
+  const int kNumThreads = 8;
+  const int kOpsPerThread = 100000;
+  auto cache = NewLRUCache(kCapacity, 2);
+  std::atomic<int> hits(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t != kNumThreads; ++t) {
+    threads.emplace_back([cache, t, &hits] {
+      Random rnd(t + 1);
+      for (int i = 0; i != kOpsPerThread; ++i) {
+        const int key = rnd.Uniform(kNumKeys);
+        const QueryId query_id = 1 + rnd.Uniform(3);
+        const int op = rnd.Uniform(100);
+        if (op < 20) {
+          ASSERT_OK(cache->Insert(EncodeKey(key), query_id, EncodeValue(key + 1), 1, dumbDeleter));
+        } else if (op < 25) {
+          cache->Erase(EncodeKey(key));
+        } else {
+          auto handle = cache->Lookup(EncodeKey(key), query_id);
+          if (handle != nullptr) {
+            ASSERT_EQ(key + 1, DecodeValue(cache->Value(handle)));
+            ++hits;
+            cache->Release(handle);
+          }
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_GT(hits.load(), 0);
+  ASSERT_EQ(0, cache->GetPinnedUsage());
+  ASSERT_LE(cache->GetUsage(), kCapacity);
+}
+
 TEST_F(CacheTest, NewId) {
   uint64_t a = cache_->NewId();
   uint64_t b = cache_->NewId();
@@ -26,6 +26,7 @@
 #include <algorithm>
 #include <limits>
 #include <string>
+#include <vector>
 
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/util/coding.h"
@@ -49,6 +50,9 @@
 
 #if defined(ZSTD)
 #include <zstd.h>
+#if ZSTD_VERSION_NUMBER >= 800  // v0.8.0+
+#include <zdict.h>
+#endif  // ZSTD_VERSION_NUMBER >= 800
 #endif
 
 namespace rocksdb {
@@ -102,6 +106,7 @@ inline bool CompressionTypeSupported(CompressionType compression_type) {
       return LZ4_Supported();
     case kLZ4HCCompression:
       return LZ4_Supported();
+    case kZSTD:
     case kZSTDNotFinalCompression:
       return ZSTD_Supported();
     default:
@@ -124,6 +129,7 @@ inline std::string CompressionTypeToString(CompressionType compression_type) {
       return "LZ4";
     case kLZ4HCCompression:
       return "LZ4HC";
+    case kZSTD:
     case kZSTDNotFinalCompression:
       return "ZSTD";
     default:
@@ -198,7 +204,8 @@ inline bool GetDecompressedSizeInfo(const char** input_data,
 inline bool Zlib_Compress(const CompressionOptions& opts,
                           uint32_t compress_format_version,
                           const char* input, size_t length,
-                          ::std::string* output) {
+                          ::std::string* output,
+                          const Slice& compression_dict = Slice()) {
 #ifdef ZLIB
   if (length > std::numeric_limits<uint32_t>::max()) {
     // Can't compress more than 4GB
@@ -228,6 +235,17 @@ inline bool Zlib_Compress(const CompressionOptions& opts,
     return false;
   }
 
+  if (compression_dict.size()) {
+    // Initialize the compression library's dictionary
+    st = deflateSetDictionary(
+        &_stream, reinterpret_cast<const Bytef*>(compression_dict.data()),
+        static_cast<unsigned int>(compression_dict.size()));
+    if (st != Z_OK) {
+      deflateEnd(&_stream);
+      return false;
+    }
+  }
+
   // Compress the input, and put compressed data in output.
   _stream.next_in = (Bytef *)input;
   _stream.avail_in = static_cast<unsigned int>(length);
@@ -268,6 +286,7 @@ inline bool Zlib_Compress(const CompressionOptions& opts,
 inline char* Zlib_Uncompress(const char* input_data, size_t input_length,
                              int* decompress_size,
                              uint32_t compress_format_version,
+                             const Slice& compression_dict = Slice(),
                              int windowBits = -14) {
 #ifdef ZLIB
   uint32_t output_len = 0;
@@ -297,6 +316,17 @@ inline char* Zlib_Uncompress(const char* input_data, size_t input_length,
     return nullptr;
   }
 
+  // A raw inflate stream never asks for the dictionary, so it should be set up front.
+  if (compression_dict.size() && windowBits < 0) {
+    st = inflateSetDictionary(
+        &_stream, reinterpret_cast<const Bytef*>(compression_dict.data()),
+        static_cast<unsigned int>(compression_dict.size()));
+    if (st != Z_OK) {
+      inflateEnd(&_stream);
+      return nullptr;
+    }
+  }
+
   _stream.next_in = (Bytef *)input_data;
   _stream.avail_in = static_cast<unsigned int>(input_length);
 
@@ -330,6 +360,14 @@ inline char* Zlib_Uncompress(const char* input_data, size_t input_length,
         _stream.avail_out = static_cast<unsigned int>(output_len - old_sz);
         break;
       }
+      case Z_NEED_DICT:
+        if (compression_dict.size() &&
+            inflateSetDictionary(
+                &_stream, reinterpret_cast<const Bytef*>(compression_dict.data()),
+                static_cast<unsigned int>(compression_dict.size())) == Z_OK) {
+          break;
+        }
+        // Intentional fallback (to failure case)
       case Z_BUF_ERROR:
       default:
         delete[] output;
@@ -498,7 +536,8 @@ inline char* BZip2_Uncompress(const char* input_data, size_t input_length,
 // header in varint32 format
 inline bool LZ4_Compress(const CompressionOptions& opts,
                          uint32_t compress_format_version, const char* input,
-                         size_t length, ::std::string* output) {
+                         size_t length, ::std::string* output,
+                         const Slice& compression_dict = Slice()) {
 #ifdef LZ4
   if (length > std::numeric_limits<uint32_t>::max()) {
     // Can't compress more than 4GB
@@ -521,9 +560,24 @@ inline bool LZ4_Compress(const CompressionOptions& opts,
 
   int compressBound = LZ4_compressBound(static_cast<int>(length));
   output->resize(static_cast<size_t>(output_header_len + compressBound));
-  int outlen =
-      LZ4_compress_limitedOutput(input, &(*output)[output_header_len],
-                                 static_cast<int>(length), compressBound);
+  int outlen;
+#if LZ4_VERSION_NUMBER >= 10400  // r124+
+  LZ4_stream_t* stream = LZ4_createStream();
+  if (compression_dict.size()) {
+    LZ4_loadDict(stream, compression_dict.cdata(), static_cast<int>(compression_dict.size()));
+  }
+#if LZ4_VERSION_NUMBER >= 10700  // r129+
+  outlen = LZ4_compress_fast_continue(stream, input, &(*output)[output_header_len],
+                                      static_cast<int>(length), compressBound, 1);
+#else  // up to r128
+  outlen = LZ4_compress_limitedOutput_continue(stream, input, &(*output)[output_header_len],
+                                               static_cast<int>(length), compressBound);
+#endif
+  LZ4_freeStream(stream);
+#else   // up to r123
+  outlen = LZ4_compress_limitedOutput(input, &(*output)[output_header_len],
+                                      static_cast<int>(length), compressBound);
+#endif  // LZ4_VERSION_NUMBER >= 10400
   if (outlen == 0) {
     return false;
   }
@@ -539,7 +593,8 @@ inline bool LZ4_Compress(const CompressionOptions& opts,
 // header in varint32 format
 inline char* LZ4_Uncompress(const char* input_data, size_t input_length,
                             int* decompress_size,
-                            uint32_t compress_format_version) {
+                            uint32_t compress_format_version,
+                            const Slice& compression_dict = Slice()) {
 #ifdef LZ4
   uint32_t output_len = 0;
   if (compress_format_version == 2) {
@@ -559,9 +614,21 @@ inline char* LZ4_Uncompress(const char* input_data, size_t input_length,
     input_data += 8;
   }
   char* output = new char[output_len];
+#if LZ4_VERSION_NUMBER >= 10400  // r124+
+  LZ4_streamDecode_t* stream = LZ4_createStreamDecode();
+  if (compression_dict.size()) {
+    LZ4_setStreamDecode(stream, compression_dict.cdata(),
+                        static_cast<int>(compression_dict.size()));
+  }
+  *decompress_size = LZ4_decompress_safe_continue(
+      stream, input_data, output, static_cast<int>(input_length),
+      static_cast<int>(output_len));
+  LZ4_freeStreamDecode(stream);
+#else   // up to r123
   *decompress_size =
       LZ4_decompress_safe(input_data, output, static_cast<int>(input_length),
                           static_cast<int>(output_len));
+#endif  // LZ4_VERSION_NUMBER >= 10400
   if (*decompress_size < 0) {
     delete[] output;
     return nullptr;
@@ -578,7 +645,8 @@ inline char* LZ4_Uncompress(const char* input_data, size_t input_length,
 // header in varint32 format
 inline bool LZ4HC_Compress(const CompressionOptions& opts,
                            uint32_t compress_format_version, const char* input,
-                           size_t length, ::std::string* output) {
+                           size_t length, ::std::string* output,
+                           const Slice& compression_dict = Slice()) {
 #ifdef LZ4
   if (length > std::numeric_limits<uint32_t>::max()) {
     // Can't compress more than 4GB
@@ -602,7 +670,21 @@ inline bool LZ4HC_Compress(const CompressionOptions& opts,
   int compressBound = LZ4_compressBound(static_cast<int>(length));
   output->resize(static_cast<size_t>(output_header_len + compressBound));
   int outlen;
-#ifdef LZ4_VERSION_MAJOR  // they only started defining this since r113
+#if LZ4_VERSION_NUMBER >= 10400  // r124+
+  LZ4_streamHC_t* stream = LZ4_createStreamHC();
+  LZ4_resetStreamHC(stream, opts.level);
+  if (compression_dict.size()) {
+    LZ4_loadDictHC(stream, compression_dict.cdata(), static_cast<int>(compression_dict.size()));
+  }
+#if LZ4_VERSION_NUMBER >= 10700  // r129+
+  outlen = LZ4_compress_HC_continue(stream, input, &(*output)[output_header_len],
+                                    static_cast<int>(length), compressBound);
+#else  // r124-r128
+  outlen = LZ4_compressHC_limitedOutput_continue(stream, input, &(*output)[output_header_len],
+                                                 static_cast<int>(length), compressBound);
+#endif
+  LZ4_freeStreamHC(stream);
+#elif defined(LZ4_VERSION_MAJOR)  // they only started defining this since r113
   outlen = LZ4_compressHC2_limitedOutput(input, &(*output)[output_header_len],
                                          static_cast<int>(length),
                                          compressBound, opts.level);
@@ -620,8 +702,12 @@ inline bool LZ4HC_Compress(const CompressionOptions& opts,
   return false;
 }
 
+// The compression level used by ZSTD when CompressionOptions::level is left at its default.
+constexpr int kZSTDDefaultCompressionLevel = 3;
+
 inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
-                          size_t length, ::std::string* output) {
+                          size_t length, ::std::string* output,
+                          const Slice& compression_dict = Slice()) {
 #ifdef ZSTD
   if (length > std::numeric_limits<uint32_t>::max()) {
     // Can't compress more than 4GB
@@ -631,11 +717,21 @@ inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
   size_t output_header_len = compression::PutDecompressedSizeInfo(
       output, static_cast<uint32_t>(length));
 
+  const int level = opts.level < 0 ? kZSTDDefaultCompressionLevel : opts.level;
   size_t compressBound = ZSTD_compressBound(length);
   output->resize(static_cast<size_t>(output_header_len + compressBound));
-  size_t outlen = ZSTD_compress(&(*output)[output_header_len], compressBound,
-                                input, length, opts.level);
-  if (outlen == 0) {
+  size_t outlen;
+#if ZSTD_VERSION_NUMBER >= 500  // v0.5.0+
+  ZSTD_CCtx* context = ZSTD_createCCtx();
+  outlen = ZSTD_compress_usingDict(
+      context, &(*output)[output_header_len], compressBound, input, length,
+      compression_dict.data(), compression_dict.size(), level);
+  ZSTD_freeCCtx(context);
+#else   // up to v0.4.x
+  outlen = ZSTD_compress(&(*output)[output_header_len], compressBound, input,
+                         length, level);
+#endif  // ZSTD_VERSION_NUMBER >= 500
+  if (outlen == 0 || ZSTD_isError(outlen)) {
     return false;
   }
   output->resize(output_header_len + outlen);
@@ -645,7 +741,8 @@ inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
 }
 
 inline char* ZSTD_Uncompress(const char* input_data, size_t input_length,
-                             int* decompress_size) {
+                             int* decompress_size,
+                             const Slice& compression_dict = Slice()) {
 #ifdef ZSTD
   uint32_t output_len = 0;
   if (!compression::GetDecompressedSizeInfo(&input_data, &input_length,
@@ -654,13 +751,61 @@ inline char* ZSTD_Uncompress(const char* input_data, size_t input_length,
   }
 
   char* output = new char[output_len];
-  size_t actual_output_length =
+  size_t actual_output_length;
+#if ZSTD_VERSION_NUMBER >= 500  // v0.5.0+
+  ZSTD_DCtx* context = ZSTD_createDCtx();
+  actual_output_length = ZSTD_decompress_usingDict(
+      context, output, output_len, input_data, input_length,
+      compression_dict.data(), compression_dict.size());
+  ZSTD_freeDCtx(context);
+#else   // up to v0.4.x
+  actual_output_length =
       ZSTD_decompress(output, output_len, input_data, input_length);
-  assert(actual_output_length == output_len);
+#endif  // ZSTD_VERSION_NUMBER >= 500
+  if (ZSTD_isError(actual_output_length) || actual_output_length != output_len) {
+    delete[] output;
+    return nullptr;
+  }
   *decompress_size = static_cast<int>(actual_output_length);
   return output;
 #endif
   return nullptr;
 }
 
+// Returns whether the given compression type can make use of a compression dictionary.
+inline bool CompressionTypeSupportsDictionary(CompressionType compression_type) {
+  switch (compression_type) {
+    case kZlibCompression:
+    case kLZ4Compression:
+    case kLZ4HCCompression:
+    case kZSTD:
+    case kZSTDNotFinalCompression:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Builds a compression dictionary of at most max_dict_bytes from samples, which is the
+// concatenation of samples with the given sizes. With ZSTD the dictionary is trained on the
+// samples, otherwise the samples themselves are used as the dictionary.
+inline std::string BuildCompressionDictionary(const std::string& samples,
+                                              const std::vector<size_t>& sample_sizes,
+                                              size_t max_dict_bytes) {
+#if defined(ZSTD) && ZSTD_VERSION_NUMBER >= 800  // v0.8.0+
+  std::string dict(max_dict_bytes, '\0');
+  size_t dict_len = ZDICT_trainFromBuffer(
+      &dict[0], max_dict_bytes, samples.data(), sample_sizes.data(),
+      static_cast<unsigned>(sample_sizes.size()));
+  if (!ZDICT_isError(dict_len)) {
+    dict.resize(dict_len);
+    return dict;
+  }
+  // Training fails when there are too few samples, just use the samples then.
+#endif
+  // Keep the end of the samples, since the compressors favor matches at small distances.
+  return samples.size() <= max_dict_bytes
+      ? samples : samples.substr(samples.size() - max_dict_bytes);
+}
+
 }  // namespace rocksdb
@@ -215,14 +215,32 @@ class PosixEnv : public Env {
     result->reset();
     Status s;
     int fd = -1;
-    do {
+    bool direct_io = false;
+#ifdef O_DIRECT
+    if (options.use_direct_writes && !options.use_mmap_writes) {
+      do {
+        IOSTATS_TIMER_GUARD(open_nanos);
+        fd = open(fname.c_str(), O_CREAT | O_RDWR | O_TRUNC | O_DIRECT, 0644);
+      } while (fd < 0 && errno == EINTR);
+      // Not all file systems support direct IO, fall back to buffered writes on them.
+      direct_io = fd >= 0;
+    }
+#endif
+    while (fd < 0) {
       IOSTATS_TIMER_GUARD(open_nanos);
       fd = open(fname.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
-    } while (fd < 0 && errno == EINTR);
+      if (fd >= 0 || errno != EINTR) {
+        break;
+      }
+    }
     if (fd < 0) {
       s = IOError(fname, errno);
     } else {
       SetFD_CLOEXEC(fd, &options);
+      if (direct_io) {
+        result->reset(new PosixWritableFile(fname, fd, options, true /* direct_io */));
+        return s;
+      }
       if (options.use_mmap_writes) {
         if (!checkedDiskForMmap_) {
           // this will be executed once in the program's lifetime.
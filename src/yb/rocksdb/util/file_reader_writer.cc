@@ -38,6 +38,9 @@ namespace rocksdb {
 Status SequentialFileReader::Read(size_t n, Slice* result, char* scratch) {
   Status s = file_->Read(n, result, scratch);
   IOSTATS_ADD(bytes_read, result->size());
+  if (!result->empty()) {
+    IOSTATS_ADD(read_ops, 1);
+  }
   return s;
 }
 
@@ -52,7 +55,10 @@ Status RandomAccessFileReader::Read(uint64_t offset, size_t n, Slice* result,
                  (stats_ != nullptr) ? &elapsed : nullptr);
     IOSTATS_TIMER_GUARD(read_nanos);
     s = file_->Read(offset, n, result, scratch);
-    IOSTATS_ADD_IF_POSITIVE(bytes_read, result->size());
+    if (!result->empty()) {
+      IOSTATS_ADD(bytes_read, result->size());
+      IOSTATS_ADD(read_ops, 1);
+    }
   }
   if (stats_ != nullptr && file_read_hist_ != nullptr) {
     file_read_hist_->Add(elapsed);
@@ -464,6 +470,8 @@ class ReadaheadRandomAccessFile : public RandomAccessFile {
 
   void Hint(AccessPattern pattern) override { file_->Hint(pattern); }
 
+  void Prefetch(uint64_t offset, size_t n) override { file_->Prefetch(offset, n); }
+
   Status InvalidateCache(size_t offset, size_t length) override {
     return file_->InvalidateCache(offset, length);
   }
@@ -223,6 +223,13 @@ void PosixRandomAccessFile::Hint(AccessPattern pattern) {
   }
 }
 
+void PosixRandomAccessFile::Prefetch(uint64_t offset, size_t n) {
+  // Pages would be dropped from the page cache by the next Read() anyway.
+  if (use_os_buffer_) {
+    Fadvise(fd_, static_cast<off_t>(offset), n, POSIX_FADV_WILLNEED);
+  }
+}
+
 Status PosixRandomAccessFile::InvalidateCache(size_t offset, size_t length) {
 #ifndef OS_LINUX
   return Status::OK();
@@ -516,8 +523,8 @@ Status PosixMmapFile::Allocate(uint64_t offset, uint64_t len) {
  * Use posix write to write data to a file.
  */
 PosixWritableFile::PosixWritableFile(const std::string& fname, int fd,
-                                     const EnvOptions& options)
-    : filename_(fname), fd_(fd), filesize_(0) {
+                                     const EnvOptions& options, bool direct_io)
+    : filename_(fname), fd_(fd), filesize_(0), direct_io_(direct_io) {
 #ifdef ROCKSDB_FALLOCATE_PRESENT
   allow_fallocate_ = options.allow_fallocate;
   fallocate_with_keep_size_ = options.fallocate_with_keep_size;
@@ -549,6 +556,39 @@ Status PosixWritableFile::Append(const Slice& data) {
   return Status::OK();
 }
 
+Status PosixWritableFile::PositionedAppend(const Slice& data, uint64_t offset) {
+  assert(direct_io_);
+  const char* src = data.cdata();
+  size_t left = data.size();
+  uint64_t write_offset = offset;
+  while (left != 0) {
+    ssize_t done = pwrite(fd_, src, left, static_cast<off_t>(write_offset));
+    if (done < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return IOError(filename_, errno);
+    }
+    left -= done;
+    src += done;
+    write_offset += done;
+  }
+  filesize_ = std::max(filesize_, write_offset);
+  return Status::OK();
+}
+
+Status PosixWritableFile::Truncate(uint64_t size) {
+  if (!direct_io_) {
+    return Status::OK();
+  }
+  // Direct writes pad the last page with zeros, cut them off.
+  if (ftruncate(fd_, size) < 0) {
+    return IOError(filename_, errno);
+  }
+  filesize_ = size;
+  return Status::OK();
+}
+
 Status PosixWritableFile::Close() {
   Status s;
 
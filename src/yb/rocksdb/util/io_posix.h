@@ -77,6 +77,7 @@ class PosixRandomAccessFile : public RandomAccessFile {
   virtual size_t GetUniqueId(char* id, size_t max_size) const override;
 #endif
   virtual void Hint(AccessPattern pattern) override;
+  virtual void Prefetch(uint64_t offset, size_t n) override;
   virtual Status InvalidateCache(size_t offset, size_t length) override;
 };
 
@@ -85,6 +86,9 @@ class PosixWritableFile : public WritableFile {
   const std::string filename_;
   int fd_;
   uint64_t filesize_;
+  // Whether the file is opened with O_DIRECT, so data has to be written with PositionedAppend()
+  // from aligned buffers.
+  const bool direct_io_;
 #ifdef ROCKSDB_FALLOCATE_PRESENT
   bool allow_fallocate_;
   bool fallocate_with_keep_size_;
@@ -92,14 +96,16 @@ class PosixWritableFile : public WritableFile {
 
  public:
   PosixWritableFile(const std::string& fname, int fd,
-                    const EnvOptions& options);
+                    const EnvOptions& options, bool direct_io = false);
   ~PosixWritableFile();
 
-  // Means Close() will properly take care of truncate
+  // Without direct IO means Close() will properly take care of truncate
   // and it does not need any additional information
-  virtual Status Truncate(uint64_t size) override { return Status::OK(); }
+  virtual Status Truncate(uint64_t size) override;
   virtual Status Close() override;
+  virtual bool UseOSBuffer() const override { return !direct_io_; }
   virtual Status Append(const Slice& data) override;
+  virtual Status PositionedAppend(const Slice& data, uint64_t offset) override;
   virtual Status Flush() override;
   virtual Status Sync() override;
   virtual Status Fsync() override;
@@ -35,6 +35,7 @@ __thread IOStatsContext iostats_context;
 void IOStatsContext::Reset() {
   thread_pool_id = Env::Priority::TOTAL;
   bytes_read = 0;
+  read_ops = 0;
   bytes_written = 0;
   open_nanos = 0;
   allocate_nanos = 0;
@@ -55,6 +56,7 @@ std::string IOStatsContext::ToString(bool exclude_zero_counters) const {
   std::ostringstream ss;
   IOSTATS_CONTEXT_OUTPUT(thread_pool_id);
   IOSTATS_CONTEXT_OUTPUT(bytes_read);
+  IOSTATS_CONTEXT_OUTPUT(read_ops);
   IOSTATS_CONTEXT_OUTPUT(bytes_written);
   IOSTATS_CONTEXT_OUTPUT(open_nanos);
   IOSTATS_CONTEXT_OUTPUT(allocate_nanos);
@@ -18,7 +18,9 @@
 // under the License.
 //
 
+#include "yb/rocksdb/env.h"
 #include "yb/rocksdb/iostats_context.h"
+#include "yb/rocksdb/util/file_reader_writer.h"
 #include "yb/rocksdb/util/testharness.h"
 
 namespace rocksdb {
@@ -36,6 +38,26 @@ TEST(IOStatsContextTest, ToString) {
   ASSERT_NE(std::string::npos, zero_excluded.find("= 12345"));
 }
 
+TEST(IOStatsContextTest, RandomAccessReads) {
+  std::unique_ptr<Env> env(NewMemEnv(Env::Default()));
+  const std::string fname = "/iostats_context_test";
+  ASSERT_OK(WriteStringToFile(env.get(), std::string(100, 'x'), fname));
+  std::unique_ptr<RandomAccessFile> file;
+  ASSERT_OK(env->NewRandomAccessFile(fname, &file, EnvOptions()));
+  RandomAccessFileReader reader(std::move(file));
+
+  iostats_context.Reset();
+  char scratch[100];
+  Slice result;
+  ASSERT_OK(reader.Read(0, 60, &result, scratch));
+  ASSERT_OK(reader.Read(60, 60, &result, scratch));
+  ASSERT_EQ(40U, result.size());
+  // Reading past the end of the file returns no data and is not counted as a read.
+  ASSERT_OK(reader.Read(100, 60, &result, scratch));
+  ASSERT_EQ(100U, iostats_context.bytes_read);
+  ASSERT_EQ(2U, iostats_context.read_ops);
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
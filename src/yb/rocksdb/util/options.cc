@@ -389,6 +389,18 @@ void DBOptions::Dump(Logger* log) const {
       use_adaptive_mutex);
   RHEADER(log, "                            Options.rate_limiter: %p",
       rate_limiter.get());
+  RHEADER(log, "                    Options.compaction_scheduler: %p",
+      compaction_scheduler.get());
+  RHEADER(log, "                             Options.table_cache: %p",
+      table_cache.get());
+  RHEADER(log, "                  Options.mem_table_flush_filter: %d",
+      static_cast<bool>(mem_table_flush_filter));
+  RHEADER(log, "                    Options.max_pooled_iterators: %" ROCKSDB_PRIszt,
+      max_pooled_iterators);
+  RHEADER(log, "                             Options.disable_wal: %d",
+      disable_wal);
+  RHEADER(log, "  Options.use_direct_io_for_flush_and_compaction: %d",
+      use_direct_io_for_flush_and_compaction);
   RHEADER(
       log, "     Options.sst_file_manager.rate_bytes_per_sec: %" PRIi64,
       sst_file_manager ? sst_file_manager->GetDeleteRateBytesPerSecond() : 0);
@@ -458,6 +470,8 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
       compression_opts.level);
   RHEADER(log, "              Options.compression_opts.strategy: %d",
       compression_opts.strategy);
+  RHEADER(log, "        Options.compression_opts.max_dict_bytes: %" PRIu32,
+      compression_opts.max_dict_bytes);
   RHEADER(log, "     Options.level0_file_num_compaction_trigger: %d",
       level0_file_num_compaction_trigger);
   RHEADER(log, "         Options.level0_slowdown_writes_trigger: %d",
@@ -521,6 +535,10 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
   RHEADER(log,
       "Options.compaction_options_universal.compression_size_percent: %d",
       compaction_options_universal.compression_size_percent);
+  RHEADER(log, "Options.compaction_options_universal.small_output_size_bytes: %" PRIu64,
+      compaction_options_universal.small_output_size_bytes);
+  RHEADER(log, "Options.compaction_options_universal.small_output_compression: %s",
+      CompressionTypeToString(compaction_options_universal.small_output_compression).c_str());
   RHEADER(log,
       "Options.compaction_options_fifo.max_table_files_size: %" PRIu64,
       compaction_options_fifo.max_table_files_size);
@@ -720,4 +738,8 @@ ReadOptions::ReadOptions(bool cksum, bool cache)
              reinterpret_cast<ReadOptions*>(this));
 }
 
+bool IsCompressionTypeSupported(CompressionType compression_type) {
+  return CompressionTypeSupported(compression_type);
+}
+
 }  // namespace rocksdb
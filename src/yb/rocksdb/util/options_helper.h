@@ -540,6 +540,9 @@ static std::unordered_map<std::string,
     {"filter_block_size",
      {offsetof(struct BlockBasedTableOptions, filter_block_size), OptionType::kSizeT,
       OptionVerificationType::kNormal}},
+    {"index_block_size",
+     {offsetof(struct BlockBasedTableOptions, index_block_size), OptionType::kSizeT,
+      OptionVerificationType::kNormal}},
     {"block_size_deviation",
      {offsetof(struct BlockBasedTableOptions, block_size_deviation),
       OptionType::kInt, OptionVerificationType::kNormal}},
@@ -596,12 +599,14 @@ static std::unordered_map<std::string, CompressionType>
         {"kBZip2Compression", kBZip2Compression},
         {"kLZ4Compression", kLZ4Compression},
         {"kLZ4HCCompression", kLZ4HCCompression},
+        {"kZSTD", kZSTD},
         {"kZSTDNotFinalCompression", kZSTDNotFinalCompression}};
 
 static std::unordered_map<std::string, BlockBasedTableOptions::IndexType>
     block_base_table_index_type_string_map = {
         {"kBinarySearch", BlockBasedTableOptions::IndexType::kBinarySearch},
-        {"kHashSearch", BlockBasedTableOptions::IndexType::kHashSearch}};
+        {"kHashSearch", BlockBasedTableOptions::IndexType::kHashSearch},
+        {"kTwoLevelIndexSearch", BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch}};
 
 static std::unordered_map<std::string, EncodingType> encoding_type_string_map =
     {{"kPlain", kPlain}, {"kPrefix", kPrefix}};
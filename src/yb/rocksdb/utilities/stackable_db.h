@@ -133,6 +133,10 @@ class StackableDB : public DB {
     return db_->NewIterator(opts, column_family);
   }
 
+  void ReleaseIterator(Iterator* iter) override {
+    db_->ReleaseIterator(iter);
+  }
+
   virtual Status NewIterators(
       const ReadOptions& options,
       const std::vector<ColumnFamilyHandle*>& column_families,
@@ -265,6 +269,10 @@ class StackableDB : public DB {
     db_->GetLiveFilesMetaData(metadata);
   }
 
+  Status GetMiddleKey(std::string* middle_key) override {
+    return db_->GetMiddleKey(middle_key);
+  }
+
   OpId GetFlushedOpId() override {
     return db_->GetFlushedOpId();
   }
@@ -79,16 +79,24 @@ Acceptor::~Acceptor() {
   Shutdown();
 }
 
-Status Acceptor::Listen(const Endpoint& endpoint, Endpoint* bound_endpoint) {
-  Socket socket;
-  RETURN_NOT_OK(socket.Init(endpoint.address().is_v6() ? Socket::FLAG_IPV6 : 0));
-  RETURN_NOT_OK(socket.SetReuseAddr(true));
-  RETURN_NOT_OK(socket.Bind(endpoint));
+Status CreateListeningSocket(
+    const Endpoint& endpoint, bool reuse_port, Socket* socket, Endpoint* bound_endpoint) {
+  RETURN_NOT_OK(socket->Init(endpoint.address().is_v6() ? Socket::FLAG_IPV6 : 0));
+  RETURN_NOT_OK(socket->SetReuseAddr(true));
+  if (reuse_port) {
+    RETURN_NOT_OK(socket->SetReusePort(true));
+  }
+  RETURN_NOT_OK(socket->Bind(endpoint));
   if (bound_endpoint) {
-    RETURN_NOT_OK(socket.GetSocketAddress(bound_endpoint));
+    RETURN_NOT_OK(socket->GetSocketAddress(bound_endpoint));
   }
-  RETURN_NOT_OK(socket.SetNonBlocking(true));
-  RETURN_NOT_OK(socket.Listen(FLAGS_rpc_acceptor_listen_backlog));
+  RETURN_NOT_OK(socket->SetNonBlocking(true));
+  return socket->Listen(FLAGS_rpc_acceptor_listen_backlog);
+}
+
+Status Acceptor::Listen(const Endpoint& endpoint, Endpoint* bound_endpoint) {
+  Socket socket;
+  RETURN_NOT_OK(CreateListeningSocket(endpoint, false /* reuse_port */, &socket, bound_endpoint));
 
   bool was_empty;
   {
@@ -54,6 +54,12 @@ namespace rpc {
 
 class Messenger;
 
+// Creates a non-blocking socket listening on 'endpoint'. With 'reuse_port' the socket gets
+// SO_REUSEPORT, so several such sockets could share the endpoint. Return bound address in
+// bound_endpoint.
+CHECKED_STATUS CreateListeningSocket(
+    const Endpoint& endpoint, bool reuse_port, Socket* socket, Endpoint* bound_endpoint = nullptr);
+
 // A acceptor that calls accept() to create new connections.
 class Acceptor {
  public:
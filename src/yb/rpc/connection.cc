@@ -61,11 +61,18 @@ DEFINE_uint64(rpc_connection_timeout_ms, 15000, "Timeout for RPC connection oper
 METRIC_DEFINE_histogram(
     server, handler_latency_outbound_transfer, "Time taken to transfer the response ",
     yb::MetricUnit::kMicroseconds, "Microseconds spent to queue and write the response to the wire",
-    60000000LU, 2);
+    60000000LU, 2, yb::STRIPED);
 
 namespace yb {
 namespace rpc {
 
+namespace {
+
+// Resolution of call timeouts, calls could time out up to this much later than their deadline.
+const auto kCallTimeoutTick = 1ms;
+
+} // namespace
+
 ///
 /// Connection
 ///
@@ -79,7 +86,8 @@ Connection::Connection(Reactor* reactor,
       remote_(remote),
       direction_(direction),
       last_activity_time_(CoarseMonoClock::Now()),
-      read_buffer_(FLAGS_rpc_initial_buffer_size, context->BufferLimit()),
+      expirations_(kCallTimeoutTick, last_activity_time_),
+      read_buffer_(reactor->buffer_allocator(), context->BufferLimit()),
       context_(std::move(context)) {
   const auto metric_entity = reactor->messenger()->metric_entity();
   handler_latency_outbound_transfer_ = metric_entity ?
@@ -178,6 +186,8 @@ void Connection::Shutdown(const Status& status) {
     }
   }
   awaiting_response_.clear();
+  std::vector<std::weak_ptr<OutboundCall>> expired;
+  expirations_.Clear(&expired);
 
   ClearSending(status);
 
@@ -234,9 +244,10 @@ void Connection::HandleTimeout(ev::timer& watcher, int revents) {  // NOLINT
     StartTimer(deadline - now, &timer_);
   }
 
-  while (!expiration_queue_.empty() && expiration_queue_.top().first <= now) {
-    auto call = expiration_queue_.top().second.lock();
-    expiration_queue_.pop();
+  std::vector<std::weak_ptr<OutboundCall>> expired;
+  expirations_.Advance(now, &expired);
+  for (const auto& weak_call : expired) {
+    auto call = weak_call.lock();
     if (call && !call->IsFinished()) {
       call->SetTimedOut();
       auto i = awaiting_response_.find(call->call_id());
@@ -249,8 +260,8 @@ void Connection::HandleTimeout(ev::timer& watcher, int revents) {  // NOLINT
     }
   }
 
-  if (!expiration_queue_.empty()) {
-    StartTimer(expiration_queue_.top().first - now, &timer_);
+  if (!expirations_.empty()) {
+    StartTimer(expirations_.NextExpiration() - now, &timer_);
   }
 }
 
@@ -323,6 +334,8 @@ Status Connection::ReadHandler() {
     }
     // Exit the loop if we did not receive anything.
     if (!received.get()) {
+      // Connection is idle, so give memory of read buffer back to the reactor.
+      read_buffer_.ReleaseIfEmpty();
       return Status::OK();
     }
     // If we were not able to process next call exit loop.
@@ -384,6 +397,18 @@ Result<bool> Connection::TryProcessCalls() {
   return true;
 }
 
+void Connection::ProcessReceived() {
+  DCHECK(reactor_->IsCurrentThread());
+  if (!is_epoll_registered_) {
+    return;
+  }
+
+  auto result = TryProcessCalls();
+  if (!result.ok()) {
+    reactor_->DestroyConnection(this, result.status());
+  }
+}
+
 Status Connection::HandleCallResponse(Slice call_data) {
   DCHECK(reactor_->IsCurrentThread());
   CallResponse resp;
@@ -399,6 +424,7 @@ Status Connection::HandleCallResponse(Slice call_data) {
   }
   auto call = awaiting->second;
   awaiting_response_.erase(awaiting);
+  expirations_.Erase(resp.call_id());
 
   if (PREDICT_FALSE(!call)) {
     // The call already failed due to a timeout.
@@ -477,8 +503,8 @@ void Connection::CallSent(OutboundCallPtr call) {
   const MonoDelta& timeout = call->controller()->timeout();
   if (timeout.Initialized()) {
     auto expires_at = CoarseMonoClock::Now() + timeout.ToSteadyDuration();
-    auto reschedule = expiration_queue_.empty() || expiration_queue_.top().first > expires_at;
-    expiration_queue_.emplace(expires_at, call);
+    auto reschedule = expirations_.NextExpiration() > expires_at;
+    expirations_.Insert(call->call_id(), expires_at, call);
     if (reschedule) {
       StartTimer(timeout.ToSteadyDuration(), &timer_);
     }
@@ -63,6 +63,7 @@
 #include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/status.h"
 #include "yb/util/strongly_typed_bool.h"
+#include "yb/util/timer_wheel.h"
 
 namespace yb {
 namespace rpc {
@@ -150,6 +151,10 @@ class Connection final : public std::enable_shared_from_this<Connection> {
   // Invoked when we have something to read.
   CHECKED_STATUS ReadHandler();
 
+  // Processes received data that was left unprocessed by the context, shutting down the
+  // connection on failure. Should be invoked in reactor thread.
+  void ProcessReceived();
+
   // Invoked when socket is ready for writing.
   // `just_connected` is used to avoid flooding log on each connect.
   CHECKED_STATUS WriteHandler(bool just_connected);
@@ -244,18 +249,8 @@ class Connection final : public std::enable_shared_from_this<Connection> {
   // at connection level.
   scoped_refptr<Histogram> handler_latency_outbound_transfer_;
 
-  struct CompareExpiration {
-    template<class Pair>
-    bool operator()(const Pair& lhs, const Pair& rhs) const {
-      return rhs.first < lhs.first;
-    }
-  };
-
-  typedef std::pair<CoarseMonoClock::TimePoint, std::weak_ptr<OutboundCall>> ExpirationPair;
-
-  std::priority_queue<ExpirationPair,
-                      std::vector<ExpirationPair>,
-                      CompareExpiration> expiration_queue_;
+  // Timeouts of calls awaiting response, keyed by call id.
+  TimerWheel<CoarseMonoClock, int32_t, std::weak_ptr<OutboundCall>> expirations_;
   ev::timer timer_;
 
   // Data received on this connection that has not been processed yet.
@@ -17,6 +17,7 @@
 
 #include "yb/rpc/growable_buffer.h"
 
+#include "yb/util/mem_tracker.h"
 #include "yb/util/test_util.h"
 
 namespace yb {
@@ -83,5 +84,62 @@ TEST_F(GrowableBufferTest, TestConsume) {
   }
 }
 
+TEST_F(GrowableBufferTest, TestAllocator) {
+  auto mem_tracker = MemTracker::CreateTracker(-1, "growable_buffer_test");
+  GrowableBufferAllocator allocator(kInitialSize, kSizeLimit, mem_tracker);
+
+  {
+    GrowableBuffer buffer(&allocator, kSizeLimit);
+    // Memory is not allocated before read.
+    ASSERT_EQ(0, buffer.capacity_left());
+    ASSERT_EQ(0, mem_tracker->consumption());
+
+    ASSERT_OK(buffer.PrepareRead());
+    ASSERT_EQ(kInitialSize, buffer.capacity_left());
+    ASSERT_EQ(kInitialSize, mem_tracker->consumption());
+
+    // Fill and grow buffer, data should be preserved while moving to the bigger size class.
+    for (size_t i = 0; i != kInitialSize * 3; ++i) {
+      ASSERT_OK(buffer.EnsureFreeSpace(1));
+      *buffer.write_position() = static_cast<uint8_t>(i);
+      buffer.DataAppended(1);
+    }
+    ASSERT_EQ(kInitialSize * 4, buffer.size() + buffer.capacity_left());
+    for (size_t i = 0; i != buffer.size(); ++i) {
+      ASSERT_EQ(static_cast<uint8_t>(i), buffer.begin()[i]);
+    }
+    // Smaller blocks were returned to the pool.
+    ASSERT_EQ(kInitialSize * 3, allocator.pooled_bytes());
+    ASSERT_EQ(kInitialSize * 7, mem_tracker->consumption());
+
+    // Non empty buffer keeps its memory.
+    buffer.ReleaseIfEmpty();
+    ASSERT_EQ(kInitialSize * 3, allocator.pooled_bytes());
+
+    buffer.Consume(buffer.size());
+    buffer.ReleaseIfEmpty();
+    ASSERT_EQ(0, buffer.capacity_left());
+    ASSERT_EQ(kInitialSize * 7, allocator.pooled_bytes());
+
+    // Pooled block is reused.
+    ASSERT_OK(buffer.PrepareRead());
+    ASSERT_EQ(kInitialSize, buffer.capacity_left());
+    ASSERT_EQ(kInitialSize * 6, allocator.pooled_bytes());
+    ASSERT_EQ(kInitialSize * 7, mem_tracker->consumption());
+  }
+
+  ASSERT_EQ(kInitialSize * 7, allocator.pooled_bytes());
+  ASSERT_EQ(kInitialSize * 7, mem_tracker->consumption());
+
+  // Blocks over pool limit are freed.
+  {
+    GrowableBuffer buffer(&allocator, kSizeLimit);
+    ASSERT_OK(buffer.EnsureFreeSpace(kSizeLimit));
+    ASSERT_EQ(kSizeLimit, buffer.capacity_left());
+  }
+  ASSERT_EQ(kInitialSize * 7, allocator.pooled_bytes());
+  ASSERT_EQ(kInitialSize * 7, mem_tracker->consumption());
+}
+
 } // namespace rpc
 } // namespace yb
@@ -19,18 +19,128 @@
 
 #include "yb/gutil/strings/substitute.h"
 
+#include "yb/util/mem_tracker.h"
+
 using strings::Substitute;
 
 namespace yb {
 namespace rpc {
 
+GrowableBufferAllocator::GrowableBufferAllocator(size_t min_block_size,
+                                                 size_t max_pooled_bytes,
+                                                 std::shared_ptr<MemTracker> mem_tracker)
+    : min_block_size_(std::max<size_t>(min_block_size, 1)),
+      max_pooled_bytes_(max_pooled_bytes),
+      mem_tracker_(std::move(mem_tracker)) {
+}
+
+GrowableBufferAllocator::~GrowableBufferAllocator() {
+  size_t size_class_block = min_block_size_;
+  for (auto& blocks : free_blocks_) {
+    for (auto* block : blocks) {
+      free(block);
+    }
+    if (mem_tracker_) {
+      mem_tracker_->Release(size_class_block * blocks.size());
+    }
+    size_class_block *= 2;
+  }
+}
+
+size_t GrowableBufferAllocator::SizeClass(size_t size) const {
+  size_t result = 0;
+  size_t block_size = min_block_size_;
+  while (block_size < size) {
+    block_size *= 2;
+    ++result;
+  }
+  return result;
+}
+
+uint8_t* GrowableBufferAllocator::Allocate(size_t size, size_t* block_size) {
+  const size_t size_class = SizeClass(size);
+  *block_size = min_block_size_ << size_class;
+  {
+    std::lock_guard<simple_spinlock> lock(mutex_);
+    if (size_class < free_blocks_.size() && !free_blocks_[size_class].empty()) {
+      auto* result = free_blocks_[size_class].back();
+      free_blocks_[size_class].pop_back();
+      pooled_bytes_ -= *block_size;
+      return result;
+    }
+  }
+  auto* result = static_cast<uint8_t*>(malloc(*block_size));
+  if (result && mem_tracker_) {
+    mem_tracker_->Consume(*block_size);
+  }
+  return result;
+}
+
+void GrowableBufferAllocator::Free(uint8_t* block, size_t block_size) {
+  if (!block) {
+    return;
+  }
+  {
+    std::lock_guard<simple_spinlock> lock(mutex_);
+    if (pooled_bytes_ + block_size <= max_pooled_bytes_) {
+      const size_t size_class = SizeClass(block_size);
+      DCHECK_EQ(min_block_size_ << size_class, block_size);
+      if (free_blocks_.size() <= size_class) {
+        free_blocks_.resize(size_class + 1);
+      }
+      free_blocks_[size_class].push_back(block);
+      pooled_bytes_ += block_size;
+      return;
+    }
+  }
+  free(block);
+  if (mem_tracker_) {
+    mem_tracker_->Release(block_size);
+  }
+}
+
+size_t GrowableBufferAllocator::pooled_bytes() const {
+  std::lock_guard<simple_spinlock> lock(mutex_);
+  return pooled_bytes_;
+}
+
 GrowableBuffer::GrowableBuffer(size_t initial, size_t limit)
-    : buffer_(static_cast<uint8_t*>(malloc(initial))),
+    : allocator_(nullptr),
+      buffer_(static_cast<uint8_t*>(malloc(initial))),
       limit_(limit),
       capacity_(initial),
       size_(0) {
 }
 
+GrowableBuffer::GrowableBuffer(GrowableBufferAllocator* allocator, size_t limit)
+    : allocator_(allocator),
+      buffer_(nullptr),
+      limit_(limit),
+      capacity_(0),
+      size_(0) {
+}
+
+GrowableBuffer::~GrowableBuffer() {
+  FreeBuffer();
+}
+
+void GrowableBuffer::FreeBuffer() {
+  if (allocator_) {
+    allocator_->Free(buffer_, block_size_);
+  } else {
+    free(buffer_);
+  }
+  buffer_ = nullptr;
+  capacity_ = 0;
+  block_size_ = 0;
+}
+
+void GrowableBuffer::ReleaseIfEmpty() {
+  if (allocator_ && empty()) {
+    FreeBuffer();
+  }
+}
+
 void GrowableBuffer::DumpTo(std::ostream& out) const {
   out << "size: " << size_ << ", capacity: " << capacity_ << ", limit: " << limit_;
 }
@@ -42,7 +152,7 @@ void GrowableBuffer::Consume(size_t count) {
   if (count) {
     size_t left = size_ - count;
     if (left) {
-      memmove(buffer_.get(), buffer_.get() + count, left);
+      memmove(buffer_, buffer_ + count, left);
     }
     size_ = left;
   }
@@ -50,28 +160,51 @@ void GrowableBuffer::Consume(size_t count) {
 
 void GrowableBuffer::Swap(GrowableBuffer* rhs) {
   DCHECK_EQ(limit_, rhs->limit_);
+  DCHECK_EQ(allocator_, rhs->allocator_);
 
-  buffer_.swap(rhs->buffer_);
+  std::swap(buffer_, rhs->buffer_);
   std::swap(capacity_, rhs->capacity_);
+  std::swap(block_size_, rhs->block_size_);
   std::swap(size_, rhs->size_);
 }
 
 Status GrowableBuffer::Reshape(size_t new_capacity) {
   DCHECK_LE(new_capacity, limit_);
-  if (new_capacity != capacity_) {
-    auto new_buffer = static_cast<uint8_t *>(realloc(buffer_.get(), new_capacity));
+  if (new_capacity == capacity_) {
+    return Status::OK();
+  }
+  if (allocator_) {
+    size_t new_block_size = 0;
+    auto new_buffer = allocator_->Allocate(new_capacity, &new_block_size);
     if (!new_buffer) {
       return STATUS(RuntimeError,
           Substitute("Failed to change buffer size from $0 to $1 bytes", capacity_, new_capacity));
     }
-    buffer_.release();
-    buffer_.reset(new_buffer);
-    capacity_ = new_capacity;
+    if (size_) {
+      memcpy(new_buffer, buffer_, size_);
+    }
+    allocator_->Free(buffer_, block_size_);
+    buffer_ = new_buffer;
+    block_size_ = new_block_size;
+    // Use the whole block, but do not go over the limit.
+    capacity_ = std::min(new_block_size, limit_);
+    return Status::OK();
   }
+  auto new_buffer = static_cast<uint8_t *>(realloc(buffer_, new_capacity));
+  if (!new_buffer) {
+    return STATUS(RuntimeError,
+        Substitute("Failed to change buffer size from $0 to $1 bytes", capacity_, new_capacity));
+  }
+  buffer_ = new_buffer;
+  capacity_ = new_capacity;
   return Status::OK();
 }
 
 Status GrowableBuffer::PrepareRead() {
+  if (!buffer_ && allocator_) {
+    // Memory was given back to the allocator, take the smallest block again.
+    return Reshape(std::min<size_t>(limit_, 1));
+  }
   if (size_ * 2 > capacity_) {
     const size_t new_capacity = std::min(limit_, capacity_ * 2);
     if (size_ == new_capacity) {
@@ -94,7 +227,7 @@ Status GrowableBuffer::EnsureFreeSpace(size_t len) {
             limit_));
   }
   if (expected > capacity_) {
-    size_t new_capacity = capacity_ * 2;
+    size_t new_capacity = std::max<size_t>(capacity_ * 2, 1);
     while (new_capacity < expected) {
       new_capacity *= 2;
     }
@@ -17,36 +17,93 @@
 
 #include <iosfwd>
 #include <memory>
+#include <vector>
 
 #include "yb/gutil/gscoped_ptr.h"
 
+#include "yb/util/locks.h"
 #include "yb/util/status.h"
 
 #include "yb/util/net/socket.h"
 
 namespace yb {
+
+class MemTracker;
+
 namespace rpc {
 
+// Allocates memory blocks for GrowableBuffer.
+// Block sizes are rounded up to size classes, i.e. powers of two starting with min_block_size.
+// Freed blocks are kept for reuse, as long as total size of kept blocks does not exceed
+// max_pooled_bytes. All allocated memory, including kept blocks, is accounted in mem_tracker.
+//
+// This class is thread-safe.
+class GrowableBufferAllocator {
+ public:
+  GrowableBufferAllocator(size_t min_block_size,
+                          size_t max_pooled_bytes,
+                          std::shared_ptr<MemTracker> mem_tracker);
+  ~GrowableBufferAllocator();
+
+  GrowableBufferAllocator(const GrowableBufferAllocator&) = delete;
+  void operator=(const GrowableBufferAllocator&) = delete;
+
+  // Allocates block of at least size bytes and stores its actual size to *block_size.
+  // Returns nullptr if allocation failed.
+  uint8_t* Allocate(size_t size, size_t* block_size);
+
+  // Returns block previously obtained from Allocate, with block_size set by it.
+  void Free(uint8_t* block, size_t block_size);
+
+  size_t pooled_bytes() const;
+
+ private:
+  size_t SizeClass(size_t size) const;
+
+  const size_t min_block_size_;
+  const size_t max_pooled_bytes_;
+  std::shared_ptr<MemTracker> mem_tracker_;
+
+  mutable simple_spinlock mutex_;
+  // Free blocks for each size class.
+  std::vector<std::vector<uint8_t*>> free_blocks_;
+  size_t pooled_bytes_ = 0;
+};
+
 // Convenience buffer for receiving bytes.
 // Major features:
 //   Limit allocated bytes.
 //   Resize depending on used size.
 //   Consume read data.
+//   Optionally take memory from GrowableBufferAllocator, and give it back while buffer is empty.
 class GrowableBuffer {
  public:
   explicit GrowableBuffer(size_t initial, size_t limit);
 
+  // Creates buffer that takes memory from allocator. Memory is not allocated until data is read
+  // into the buffer.
+  GrowableBuffer(GrowableBufferAllocator* allocator, size_t limit);
+
+  ~GrowableBuffer();
+
+  GrowableBuffer(const GrowableBuffer&) = delete;
+  void operator=(const GrowableBuffer&) = delete;
+
   inline bool empty() const { return size_ == 0; }
   inline size_t size() const { return size_; }
-  inline const uint8_t* begin() const { return buffer_.get(); }
-  inline const uint8_t* end() const { return buffer_.get() + size_; }
+  inline const uint8_t* begin() const { return buffer_; }
+  inline const uint8_t* end() const { return buffer_ + size_; }
   inline size_t capacity_left() const { return capacity_ - size_; }
-  inline uint8_t* write_position() { return buffer_.get() + size_; }
+  inline uint8_t* write_position() { return buffer_ + size_; }
   inline size_t limit() const { return limit_; }
 
   void Swap(GrowableBuffer* rhs);
   // Reset buffer size to zero. Like with std::vector Clean does not deallocate any memory.
   void Clear() { size_ = 0; }
+
+  // Returns memory of empty buffer to the allocator. Does nothing for buffers without allocator,
+  // or if buffer is not empty.
+  void ReleaseIfEmpty();
   void DumpTo(std::ostream& out) const;
 
   // Removes first `count` bytes from buffer, moves remaining bytes to the beginning of the buffer.
@@ -79,15 +136,23 @@ class GrowableBuffer {
  private:
   CHECKED_STATUS Reshape(size_t new_capacity);
 
+  void FreeBuffer();
+
+  // Allocator used to obtain memory, nullptr if memory is obtained with malloc/realloc.
+  GrowableBufferAllocator* const allocator_;
+
   // Contained data
-  std::unique_ptr<uint8_t, FreeDeleter> buffer_;
+  uint8_t* buffer_;
 
   // Max capacity for this buffer
   const size_t limit_;
 
-  // Current capacity, i.e. allocated bytes
+  // Current capacity, i.e. usable allocated bytes
   size_t capacity_;
 
+  // Size of block obtained from allocator_, could be bigger than capacity_.
+  size_t block_size_ = 0;
+
   // Currently used bytes
   size_t size_;
 };
@@ -83,6 +83,8 @@ InboundCall::InboundCall(ConnectionPtr conn, CallProcessedListener call_processe
     : trace_(new Trace),
       conn_(std::move(conn)),
       call_processed_listener_(std::move(call_processed_listener)) {
+  // Calls that carry the trace id of their sampled caller overwrite it while parsing the header.
+  trace_->set_trace_id(Trace::MaybeSampleTraceId());
   TRACE_TO(trace_, "Created InboundCall");
   RecordCallReceived();
 }
@@ -134,6 +136,9 @@ void InboundCall::RecordHandlingStarted(scoped_refptr<Histogram> incoming_queue_
   timing_.time_handled = MonoTime::Now();
   incoming_queue_time->Increment(
       timing_.time_handled.GetDeltaSince(timing_.time_received).ToMicroseconds());
+  if (PREDICT_FALSE(trace_->sampled())) {
+    RecordTraceStage("rpc.inbound_queue", timing_.time_handled - timing_.time_received);
+  }
 }
 
 void InboundCall::RecordHandlingCompleted(scoped_refptr<Histogram> handler_run_time) {
@@ -142,6 +147,9 @@ void InboundCall::RecordHandlingCompleted(scoped_refptr<Histogram> handler_run_t
   if (handler_run_time) {
     handler_run_time->Increment((timing_.time_completed - timing_.time_handled).ToMicroseconds());
   }
+  if (PREDICT_FALSE(trace_->sampled())) {
+    RecordTraceStage("rpc.inbound_handler", timing_.time_completed - timing_.time_handled);
+  }
 }
 
 bool InboundCall::ClientTimedOut() const {
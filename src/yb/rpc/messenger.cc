@@ -37,6 +37,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <list>
 #include <mutex>
 #include <set>
@@ -81,6 +82,11 @@ DEFINE_int32(rpc_default_keepalive_time_ms, 65000,
              "will disconnect the client.");
 TAG_FLAG(rpc_default_keepalive_time_ms, advanced);
 DEFINE_uint64(io_thread_pool_size, 4, "Size of allocated IO Thread Pool.");
+DEFINE_bool(rpc_reuse_port_per_reactor, false,
+            "Listen for RPC connections with a SO_REUSEPORT socket per reactor, so every reactor "
+            "accepts connections on its own thread, instead of a single acceptor thread "
+            "distributing them.");
+TAG_FLAG(rpc_reuse_port_per_reactor, advanced);
 
 namespace yb {
 namespace rpc {
@@ -88,6 +94,33 @@ namespace rpc {
 class Messenger;
 class ServerBuilder;
 
+namespace {
+
+// Endpoints the messengers of this process listen on.
+struct ListeningEndpoint {
+  Endpoint endpoint;
+  Messenger* messenger;
+  std::weak_ptr<Messenger> weak_messenger;
+};
+
+std::mutex listening_endpoints_mutex;
+
+std::vector<ListeningEndpoint>& listening_endpoints() {
+  static auto* result = new std::vector<ListeningEndpoint>();
+  return *result;
+}
+
+// Whether a connection to 'remote' would reach a socket listening on 'listening'.
+bool EndpointReaches(const Endpoint& remote, const Endpoint& listening) {
+  if (remote.port() != listening.port()) {
+    return false;
+  }
+  return remote.address() == listening.address() ||
+         (listening.address().is_unspecified() && remote.address().is_loopback());
+}
+
+} // namespace
+
 MessengerBuilder::MessengerBuilder(std::string name)
     : name_(std::move(name)),
       connection_keepalive_time_(FLAGS_rpc_default_keepalive_time_ms * 1ms),
@@ -157,10 +190,13 @@ void Messenger::Shutdown() {
     rpc_services_.clear();
 
     acceptor.swap(acceptor_);
+    reactor_listen_sockets_.clear();
 
     reactors = reactors_;
   }
 
+  RemoveListeningEndpoints();
+
   if (acceptor) {
     acceptor->Shutdown();
   }
@@ -180,10 +216,10 @@ void Messenger::Shutdown() {
 }
 
 Status Messenger::ListenAddress(const Endpoint& accept_endpoint, Endpoint* bound_endpoint) {
-  Acceptor* acceptor;
+  Acceptor* acceptor = nullptr;
   {
     std::lock_guard<percpu_rwlock> guard(lock_);
-    if (!acceptor_) {
+    if (!acceptor_ && !FLAGS_rpc_reuse_port_per_reactor) {
       acceptor_.reset(new Acceptor(this));
     }
     auto accept_host = accept_endpoint.address();
@@ -192,18 +228,85 @@ Status Messenger::ListenAddress(const Endpoint& accept_endpoint, Endpoint* bound
     if (outbound_address.is_unspecified() && !accept_host.is_unspecified()) {
       outbound_address = accept_host;
     }
-    acceptor = acceptor_.get();
+    if (!FLAGS_rpc_reuse_port_per_reactor) {
+      acceptor = acceptor_.get();
+    }
+  }
+  Endpoint bound;
+  if (!acceptor) {
+    RETURN_NOT_OK(ListenOnReactors(accept_endpoint, &bound));
+  } else {
+    RETURN_NOT_OK(acceptor->Listen(accept_endpoint, &bound));
+  }
+  AddListeningEndpoint(bound);
+  if (bound_endpoint) {
+    *bound_endpoint = bound;
+  }
+  return Status::OK();
+}
+
+void Messenger::AddListeningEndpoint(const Endpoint& endpoint) {
+  std::lock_guard<std::mutex> lock(listening_endpoints_mutex);
+  listening_endpoints().push_back(ListeningEndpoint{endpoint, this, retain_self_});
+}
+
+void Messenger::RemoveListeningEndpoints() {
+  std::lock_guard<std::mutex> lock(listening_endpoints_mutex);
+  auto& endpoints = listening_endpoints();
+  endpoints.erase(
+      std::remove_if(endpoints.begin(), endpoints.end(),
+                     [this](const ListeningEndpoint& entry) { return entry.messenger == this; }),
+      endpoints.end());
+}
+
+std::shared_ptr<Messenger> Messenger::FindListeningMessenger(const Endpoint& endpoint) {
+  std::lock_guard<std::mutex> lock(listening_endpoints_mutex);
+  for (const auto& entry : listening_endpoints()) {
+    if (EndpointReaches(endpoint, entry.endpoint)) {
+      return entry.weak_messenger.lock();
+    }
+  }
+  return nullptr;
+}
+
+Status Messenger::ListenOnReactors(const Endpoint& accept_endpoint, Endpoint* bound_endpoint) {
+  std::vector<Socket> sockets(reactors_.size());
+  Endpoint endpoint = accept_endpoint;
+  for (auto& socket : sockets) {
+    // When the port is picked by the system, the rest of the sockets use the bound one.
+    Endpoint bound;
+    RETURN_NOT_OK(CreateListeningSocket(endpoint, true /* reuse_port */, &socket, &bound));
+    endpoint = bound;
+  }
+  if (bound_endpoint) {
+    *bound_endpoint = endpoint;
   }
-  return acceptor->Listen(accept_endpoint, bound_endpoint);
+
+  std::lock_guard<percpu_rwlock> guard(lock_);
+  if (closing_) {
+    return STATUS(ServiceUnavailable, "Messenger is shutting down");
+  }
+  for (size_t i = 0; i != sockets.size(); ++i) {
+    if (reactors_listening_) {
+      reactors_[i]->Listen(std::move(sockets[i]));
+    } else {
+      reactor_listen_sockets_.push_back(std::move(sockets[i]));
+    }
+  }
+  return Status::OK();
 }
 
 Status Messenger::StartAcceptor() {
   std::lock_guard<percpu_rwlock> guard(lock_);
-  if (acceptor_) {
-    return acceptor_->Start();
-  } else {
+  if (!acceptor_ && reactor_listen_sockets_.empty()) {
     return STATUS(IllegalState, "Trying to start acceptor w/o active addresses");
   }
+  reactors_listening_ = true;
+  for (size_t i = 0; i != reactor_listen_sockets_.size(); ++i) {
+    reactors_[i % reactors_.size()]->Listen(std::move(reactor_listen_sockets_[i]));
+  }
+  reactor_listen_sockets_.clear();
+  return acceptor_ ? acceptor_->Start() : Status::OK();
 }
 
 void Messenger::BreakConnectivityWith(const IpAddress& address) {
@@ -255,6 +358,14 @@ void Messenger::ShutdownAcceptor() {
   {
     std::lock_guard<percpu_rwlock> guard(lock_);
     acceptor.swap(acceptor_);
+    reactor_listen_sockets_.clear();
+    RemoveListeningEndpoints();
+    if (reactors_listening_) {
+      reactors_listening_ = false;
+      for (auto* reactor : reactors_) {
+        reactor->StopListening();
+      }
+    }
   }
   if (acceptor) {
     acceptor->Shutdown();
@@ -379,6 +490,29 @@ size_t Messenger::max_concurrent_requests() const {
   return FLAGS_num_connections_to_server;
 }
 
+std::shared_ptr<ConnectionLoads> Messenger::GetConnectionLoads(
+    const Endpoint& remote, size_t num_connections) {
+  std::lock_guard<percpu_rwlock> guard(lock_);
+  auto& weak_loads = connection_loads_[remote];
+  auto loads = weak_loads.lock();
+  if (!loads || loads->size() < num_connections) {
+    if (!loads) {
+      // Drop entries of servers that no proxy refers to anymore.
+      for (auto it = connection_loads_.begin(); it != connection_loads_.end();) {
+        if (it->second.expired() && it->first != remote) {
+          it = connection_loads_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+    // Calls tracked by the old loads keep releasing them, new ones use the bigger vector.
+    loads = std::make_shared<ConnectionLoads>(num_connections);
+    connection_loads_[remote] = loads;
+  }
+  return loads;
+}
+
 Reactor* Messenger::RemoteToReactor(const Endpoint& remote, uint32_t idx) {
   uint32_t hashCode = hash_value(remote);
   int reactor_idx = (hashCode + idx) % reactors_.size();
@@ -220,6 +220,10 @@ class Messenger {
     return scheduler_;
   }
 
+  // Returns the messenger of this process that listens on 'endpoint', or null if there is none.
+  // Calls to such endpoint could be handled by that messenger directly, without the network.
+  static std::shared_ptr<Messenger> FindListeningMessenger(const Endpoint& endpoint);
+
  private:
   FRIEND_TEST(TestRpc, TestConnectionKeepalive);
   friend class DelayedTask;
@@ -230,6 +234,17 @@ class Messenger {
   CHECKED_STATUS Init();
   void UpdateServicesCache(std::lock_guard<percpu_rwlock>* guard);
 
+  // Returns the loads of the connections to 'remote', with at least 'num_connections' entries.
+  std::shared_ptr<ConnectionLoads> GetConnectionLoads(
+      const Endpoint& remote, size_t num_connections);
+
+  // Remembers that this messenger listens on 'endpoint', see FindListeningMessenger().
+  void AddListeningEndpoint(const Endpoint& endpoint);
+  void RemoveListeningEndpoints();
+
+  // Creates a SO_REUSEPORT listening socket on accept_endpoint for every reactor.
+  CHECKED_STATUS ListenOnReactors(const Endpoint& accept_endpoint, Endpoint* bound_endpoint);
+
   // Called by external-facing shared_ptr when the user no longer holds
   // any references. See 'retain_self_' for more info.
   void AllExternalReferencesDropped();
@@ -256,6 +271,14 @@ class Messenger {
 
   // Acceptor which is listening on behalf of this messenger.
   std::unique_ptr<Acceptor> acceptor_;
+  // Sockets created by ListenOnReactors() and not yet passed to reactors, socket i belongs to
+  // reactor i % reactors_.size().
+  std::vector<Socket> reactor_listen_sockets_;
+  // Whether reactors accept connections from their own sockets, i.e. StartAcceptor() was called.
+  bool reactors_listening_ = false;
+
+  // Loads of the connections to remote servers, alive while some proxy to the server exists.
+  std::unordered_map<Endpoint, std::weak_ptr<ConnectionLoads>, EndpointHash> connection_loads_;
   IpAddress outbound_address_v4_;
   IpAddress outbound_address_v6_;
 
@@ -59,15 +59,16 @@
 METRIC_DEFINE_histogram(
     server, handler_latency_outbound_call_queue_time, "Time taken to queue the request ",
     yb::MetricUnit::kMicroseconds, "Microseconds spent to queue the request to the reactor",
-    60000000LU, 2);
+    60000000LU, 2, yb::STRIPED);
 METRIC_DEFINE_histogram(
     server, handler_latency_outbound_call_send_time, "Time taken to send the request ",
     yb::MetricUnit::kMicroseconds, "Microseconds spent to queue and write the request to the wire",
-    60000000LU, 2);
+    60000000LU, 2, yb::STRIPED);
 METRIC_DEFINE_histogram(
     server, handler_latency_outbound_call_time_to_response, "Time taken to get the response ",
     yb::MetricUnit::kMicroseconds,
-    "Microseconds spent to send the request and get a response on the wire", 60000000LU, 2);
+    "Microseconds spent to send the request and get a response on the wire", 60000000LU, 2,
+    yb::STRIPED);
 
 // 100M cycles should be about 50ms on a 2Ghz box. This should be high
 // enough that involuntary context switches don't trigger it, but low enough
@@ -185,6 +186,7 @@ OutboundCall::OutboundCall(
   }
   if (Trace::CurrentTrace()) {
     Trace::CurrentTrace()->AddChildTrace(trace_.get());
+    trace_->set_trace_id(Trace::CurrentTrace()->trace_id());
   }
 
   DVLOG(4) << "OutboundCall " << this << " constructed with state_: " << StateName(state_)
@@ -320,7 +322,24 @@ void OutboundCall::set_state(State new_state) {
   }
 }
 
+void OutboundCall::TrackConnectionLoad(std::shared_ptr<ConnectionLoads> connection_loads) {
+  DCHECK_LT(conn_id_.idx(), connection_loads->size());
+  tracked_bytes_ = buffer_.size();
+  auto& load = (*connection_loads)[conn_id_.idx()];
+  load.outstanding_calls.fetch_add(1, std::memory_order_relaxed);
+  load.outstanding_bytes.fetch_add(tracked_bytes_, std::memory_order_relaxed);
+  connection_loads_ = std::move(connection_loads);
+}
+
 void OutboundCall::CallCallback() {
+  if (connection_loads_) {
+    // Released first, so calls started from the callback see the connection without this one.
+    auto& load = (*connection_loads_)[conn_id_.idx()];
+    load.outstanding_calls.fetch_sub(1, std::memory_order_relaxed);
+    load.outstanding_bytes.fetch_sub(tracked_bytes_, std::memory_order_relaxed);
+    connection_loads_.reset();
+  }
+
   int64_t start_cycles = CycleClock::Now();
   {
     SCOPED_WATCH_STACK(100);
@@ -350,6 +369,9 @@ void OutboundCall::SetResponse(CallResponse&& resp) {
   if (outbound_call_metrics_) {
     outbound_call_metrics_->time_to_response->Increment(now.GetDeltaSince(start_).ToMicroseconds());
   }
+  if (PREDICT_FALSE(trace_->sampled())) {
+    RecordTraceStage("rpc.outbound_call", now - start_);
+  }
   call_response_ = std::move(resp);
   Slice r(call_response_.serialized_response());
 
@@ -489,6 +511,9 @@ void OutboundCall::InitHeader(RequestHeader* header) {
     header->set_timeout_millis(timeout.ToMilliseconds());
   }
   header->set_allocated_remote_method(remote_method_pool_->Take());
+  if (trace_->sampled()) {
+    header->set_trace_id(trace_->trace_id());
+  }
 }
 
 ///
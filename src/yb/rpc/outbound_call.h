@@ -32,7 +32,9 @@
 #ifndef YB_RPC_OUTBOUND_CALL_H_
 #define YB_RPC_OUTBOUND_CALL_H_
 
+#include <atomic>
 #include <deque>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -105,6 +107,16 @@ inline bool operator==(const ConnectionId& lhs, const ConnectionId& rhs) {
   return lhs.remote() == rhs.remote() && lhs.idx() == rhs.idx();
 }
 
+// Load of a connection to a remote server, i.e. calls sent over it that did not finish yet.
+// Shared by all proxies of a messenger, which use it to pick the least loaded connection.
+struct ConnectionLoad {
+  std::atomic<size_t> outstanding_calls{0};
+  std::atomic<size_t> outstanding_bytes{0};
+};
+
+// Loads of the connections to a remote server, indexed by ConnectionId::idx().
+typedef std::vector<ConnectionLoad> ConnectionLoads;
+
 // Container for OutboundCall metrics
 struct OutboundCallMetrics {
   explicit OutboundCallMetrics(const scoped_refptr<MetricEntity>& metric_entity);
@@ -204,6 +216,10 @@ class OutboundCall : public RpcCall {
   // subsequently mutated with no ill effects.
   virtual CHECKED_STATUS SetRequestParam(const google::protobuf::Message& req);
 
+  // Accounts this call in the load of its connection until the callback is invoked.
+  // Requires that SetRequestParam() is called first.
+  void TrackConnectionLoad(std::shared_ptr<ConnectionLoads> connection_loads);
+
   // Serialize the call for the wire. Requires that SetRequestParam()
   // is called first. This is called from the Reactor thread.
   void Serialize(std::deque<RefCntBuffer>* output) const override;
@@ -335,6 +351,10 @@ class OutboundCall : public RpcCall {
 
   RemoteMethodPool* remote_method_pool_;
 
+  // Set by TrackConnectionLoad(), released before invoking the callback.
+  std::shared_ptr<ConnectionLoads> connection_loads_;
+  size_t tracked_bytes_ = 0;
+
   DISALLOW_COPY_AND_ASSIGN(OutboundCall);
 };
 
@@ -474,7 +474,7 @@ class CodeGenerator : public ::google::protobuf::compiler::CodeGenerator {
           "  \"$rpc_full_name$ RPC Time\",\n"
           "  yb::MetricUnit::kMicroseconds,\n"
           "  \"Microseconds spent handling $rpc_full_name$() RPC requests\",\n"
-          "  60000000LU, 2);\n"
+          "  60000000LU, 2, yb::STRIPED);\n"
           "\n");
         subs->Pop();
       }
@@ -500,7 +500,8 @@ class CodeGenerator : public ::google::protobuf::compiler::CodeGenerator {
         "}\n"
         "\n"
         "void $service_name$If::Handle(::yb::rpc::InboundCallPtr call) {\n"
-        "  auto yb_call = std::static_pointer_cast<::yb::rpc::YBInboundCall>(call);\n");
+        "  auto yb_call = std::static_pointer_cast<::yb::rpc::YBInboundCall>(call);\n"
+        "  auto arena = yb_call->IsLocalCall() ? nullptr : ::yb::rpc::NewCallArena();\n");
 
       for (int method_idx = 0; method_idx < service->method_count();
            ++method_idx) {
@@ -515,8 +516,8 @@ class CodeGenerator : public ::google::protobuf::compiler::CodeGenerator {
         "            metrics_[$metric_enum_key$]) :\n"
         "        ::yb::rpc::RpcContext(\n"
         "            yb_call, \n"
-        "            std::make_shared<$request$>(),\n"
-        "            std::make_shared<$response$>(),\n"
+        "            ::yb::rpc::NewCallMessage<$request$>(arena),\n"
+        "            ::yb::rpc::NewCallMessage<$response$>(arena),\n"
         "            metrics_[$metric_enum_key$]);\n"
         "    if (!rpc_context.responded()) {\n"
         "      const auto* req = static_cast<const $request$*>(rpc_context.request_pb());\n"
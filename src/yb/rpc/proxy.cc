@@ -37,6 +37,7 @@
 
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <sstream>
 #include <vector>
@@ -52,10 +53,22 @@
 #include "yb/util/net/sockaddr.h"
 #include "yb/util/net/socket.h"
 #include "yb/util/countdown_latch.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/status.h"
 #include "yb/util/user.h"
 
 DEFINE_int32(num_connections_to_server, 4, "Number of underlying connections to each server");
+DEFINE_bool(rpc_select_least_loaded_connection, true,
+            "Send every call over the connection to the server with the least outstanding calls "
+            "and bytes, instead of picking connections round robin.");
+TAG_FLAG(rpc_select_least_loaded_connection, advanced);
+TAG_FLAG(rpc_select_least_loaded_connection, runtime);
+DEFINE_bool(rpc_direct_local_calls, false,
+            "Handle calls to an endpoint that a messenger of this process listens on directly in "
+            "that messenger, passing request and response objects without serialization. "
+            "Services must be generated ones, since local calls are not parsed. Not suitable for "
+            "processes running several servers, like mini clusters.");
+TAG_FLAG(rpc_direct_local_calls, advanced);
 
 using google::protobuf::Message;
 using std::string;
@@ -75,11 +88,20 @@ Proxy::Proxy(const std::shared_ptr<Messenger>& messenger,
   DCHECK(!service_name_.empty()) << "Proxy service name must not be blank";
 
   VLOG(1) << "Create proxy to " << service_name_ << " at " << remote;
+  if (call_local_service_) {
+    local_messenger_ = messenger_;
+  } else if (FLAGS_rpc_direct_local_calls) {
+    local_messenger_ = Messenger::FindListeningMessenger(remote);
+    call_local_service_ = local_messenger_ != nullptr;
+  }
   size_t num_connections_to_server = FLAGS_num_connections_to_server;
   conn_ids_.reserve(num_connections_to_server);
   while (conn_ids_.size() != num_connections_to_server) {
     conn_ids_.emplace_back(remote, conn_ids_.size());
   }
+  if (!call_local_service_) {
+    connection_loads_ = messenger_->GetConnectionLoads(remote, num_connections_to_server);
+  }
 }
 
 Proxy::~Proxy() {
@@ -92,7 +114,7 @@ void Proxy::AsyncRequest(const RemoteMethod* method,
                          ResponseCallback callback) const {
   CHECK(controller->call_.get() == nullptr) << "Controller should be reset";
   is_started_.store(true, std::memory_order_release);
-  uint8_t idx = num_calls_.fetch_add(1) % conn_ids_.size();
+  size_t idx = SelectConnection();
 
   controller->call_ =
       call_local_service_ ?
@@ -116,6 +138,9 @@ void Proxy::AsyncRequest(const RemoteMethod* method,
     call->SetFailed(s); // calls callback internally
     return;
   }
+  if (connection_loads_) {
+    call->TrackConnectionLoad(connection_loads_);
+  }
 
   if (call_local_service_) {
     // For local call, the response message buffer is reused when an RPC call is retried. So clear
@@ -128,9 +153,9 @@ void Proxy::AsyncRequest(const RemoteMethod* method,
     const shared_ptr<LocalYBInboundCall>& local_call =
         static_cast<LocalOutboundCall*>(call)->CreateLocalInboundCall();
     if (ThreadPool::IsCurrentThreadRpcWorker()) {
-      messenger_->Handle(local_call);
+      local_messenger_->Handle(local_call);
     } else {
-      messenger_->QueueInboundCall(local_call);
+      local_messenger_->QueueInboundCall(local_call);
     }
   } else {
     // If this fails to queue, the callback will get called immediately
@@ -140,6 +165,33 @@ void Proxy::AsyncRequest(const RemoteMethod* method,
 }
 
 
+size_t Proxy::SelectConnection() const {
+  const size_t num_connections = conn_ids_.size();
+  const size_t start = num_calls_.fetch_add(1, std::memory_order_relaxed) % num_connections;
+  if (!connection_loads_ || num_connections == 1 || !FLAGS_rpc_select_least_loaded_connection) {
+    return start;
+  }
+
+  size_t best = start;
+  size_t best_calls = std::numeric_limits<size_t>::max();
+  size_t best_bytes = std::numeric_limits<size_t>::max();
+  for (size_t i = 0; i != num_connections; ++i) {
+    const size_t idx = (start + i) % num_connections;
+    const auto& load = (*connection_loads_)[idx];
+    const size_t calls = load.outstanding_calls.load(std::memory_order_relaxed);
+    const size_t bytes = load.outstanding_bytes.load(std::memory_order_relaxed);
+    if (calls < best_calls || (calls == best_calls && bytes < best_bytes)) {
+      best = idx;
+      best_calls = calls;
+      best_bytes = bytes;
+      if (calls == 0) {
+        break;
+      }
+    }
+  }
+  return best;
+}
+
 Status Proxy::SyncRequest(const RemoteMethod* method,
                           const google::protobuf::Message& req,
                           google::protobuf::Message* resp,
@@ -67,7 +67,8 @@ class Messenger;
 // requests sent over a single proxy across different connections to the server.
 //
 // When remote endpoint is blank (i.e. Endpoint()), the proxy will attempt to
-// call the service locally in the messenger instead.
+// call the service locally in the messenger instead. The same happens when the remote
+// endpoint is one a messenger of this process listens on, see --rpc_direct_local_calls.
 //
 // Proxy objects are thread-safe after initialization only.
 // Setters on the Proxy are not thread-safe, and calling a setter after any RPC
@@ -126,13 +127,22 @@ class Proxy {
  private:
   GrowableBuffer& Buffer() const;
 
+  // Returns index of the connection for the next call: the one with the least outstanding calls
+  // and then bytes, starting from a round robin position, so ties are spread.
+  size_t SelectConnection() const;
+
   const std::string service_name_;
   std::shared_ptr<Messenger> messenger_;
   std::vector<ConnectionId> conn_ids_;
   mutable std::atomic<bool> is_started_{false};
   mutable std::atomic<size_t> num_calls_{0};
   std::shared_ptr<OutboundCallMetrics> outbound_call_metrics_;
-  const bool call_local_service_;
+  // Whether calls are handled by local_messenger_ directly, without serialization. Set for a
+  // blank remote endpoint, or when the remote endpoint is one this process listens on.
+  bool call_local_service_;
+  std::shared_ptr<Messenger> local_messenger_;
+  // Loads of conn_ids_, shared with other proxies to the same server. Null for local service.
+  std::shared_ptr<ConnectionLoads> connection_loads_;
 
   DISALLOW_COPY_AND_ASSIGN(Proxy);
 };
@@ -60,6 +60,8 @@
 #include "yb/util/countdown_latch.h"
 #include "yb/util/errno.h"
 #include "yb/util/flag_tags.h"
+#include "yb/util/mem_tracker.h"
+#include "yb/util/metrics.h"
 #include "yb/util/memory/memory.h"
 #include "yb/util/monotime.h"
 #include "yb/util/thread.h"
@@ -74,12 +76,22 @@ using std::shared_ptr;
 
 DECLARE_string(local_ip_for_outbound_sockets);
 DECLARE_int32(num_connections_to_server);
+DECLARE_uint64(rpc_initial_buffer_size);
+
+DEFINE_uint64(rpc_max_pooled_read_buffer_bytes, 4 * 1024 * 1024,
+              "Max number of bytes kept by each reactor in free read buffers for reuse by its "
+              "connections.");
+TAG_FLAG(rpc_max_pooled_read_buffer_bytes, advanced);
+
+METRIC_DECLARE_counter(rpc_connections_accepted);
 
 namespace yb {
 namespace rpc {
 
 namespace {
 
+const char* const kReadBuffersMemTrackerId = "Read Buffers";
+
 Status ShutdownError(bool aborted) {
   const char* msg = "reactor is shutting down";
   return aborted ?
@@ -109,6 +121,9 @@ Reactor::Reactor(const shared_ptr<Messenger>& messenger,
                  const MessengerBuilder &bld)
   : messenger_(messenger),
     name_(StringPrintf("%s_R%03d", messenger->name().c_str(), index)),
+    buffer_allocator_(FLAGS_rpc_initial_buffer_size,
+                      FLAGS_rpc_max_pooled_read_buffer_bytes,
+                      MemTracker::FindOrCreateTracker(-1, kReadBuffersMemTrackerId)),
     loop_(kDefaultLibEvFlags),
     cur_time_(CoarseMonoClock::Now()),
     last_unused_tcp_scan_(cur_time_),
@@ -189,6 +204,8 @@ void Reactor::ShutdownInternal() {
   }
   server_conns_.clear();
 
+  StopListeningInternal();
+
   // Abort any scheduled tasks.
   //
   // These won't be found in the Reactor's list of pending tasks
@@ -710,6 +727,88 @@ void Reactor::RegisterInboundSocket(Socket *socket, const Endpoint& remote) {
   });
 }
 
+void Reactor::Listen(Socket socket) {
+  auto shared_socket = std::make_shared<Socket>(std::move(socket));
+  ScheduleReactorFunctor([shared_socket](Reactor* reactor) {
+    DCHECK(reactor->IsCurrentThread());
+    if (!reactor->rpc_connections_accepted_) {
+      reactor->rpc_connections_accepted_ = METRIC_rpc_connections_accepted.Instantiate(
+          reactor->messenger_->metric_entity());
+    }
+    VLOG(1) << reactor->name() << ": accepting on socket fd " << shared_socket->GetFd();
+    ListeningSocket listening{ std::unique_ptr<ev::io>(new ev::io), std::move(*shared_socket) };
+    listening.io->set(reactor->loop_);
+    listening.io->set<Reactor, &Reactor::AcceptHandler>(reactor);
+    listening.io->start(listening.socket.GetFd(), EV_READ);
+    auto* io = listening.io.get();
+    reactor->listening_sockets_.emplace(io, std::move(listening));
+  });
+}
+
+void Reactor::StopListening() {
+  ScheduleReactorFunctor([](Reactor* reactor) {
+    reactor->StopListeningInternal();
+  });
+}
+
+void Reactor::StopListeningInternal() {
+  DCHECK(IsCurrentThread());
+  for (auto& listening : listening_sockets_) {
+    listening.second.io->stop();
+  }
+  listening_sockets_.clear();
+}
+
+void Reactor::AcceptHandler(ev::io& io, int events) {  // NOLINT
+  DCHECK(IsCurrentThread());
+  auto it = listening_sockets_.find(&io);
+  if (it == listening_sockets_.end()) {
+    LOG(ERROR) << name_ << ": AcceptHandler for unknown socket: " << &io;
+    return;
+  }
+  Socket& socket = it->second.socket;
+  if (events & EV_ERROR) {
+    LOG(INFO) << name_ << ": listening socket failure: " << socket.GetFd();
+    io.stop();
+    listening_sockets_.erase(it);
+    return;
+  }
+
+  if (!(events & EV_READ)) {
+    return;
+  }
+
+  for (;;) {
+    Socket new_sock;
+    Endpoint remote;
+    Status s = socket.Accept(&new_sock, &remote, Socket::FLAG_NONBLOCKING);
+    if (!s.ok()) {
+      if (!Socket::IsTemporarySocketError(s)) {
+        LOG(WARNING) << name_ << ": accept failed: " << s;
+      }
+      return;
+    }
+    s = new_sock.SetNoDelay(true);
+    if (!s.ok()) {
+      LOG(WARNING) << name_ << ": failed to set TCP_NODELAY on a socket accepted from " << remote
+                   << ": " << s;
+      continue;
+    }
+    rpc_connections_accepted_->Increment();
+    if (messenger_->IsArtificiallyDisconnectedFrom(remote.address())) {
+      auto status = new_sock.Close();
+      LOG(INFO) << "TEST: Rejected connection from " << remote
+                << ", close status: " << status.ToString();
+      continue;
+    }
+    VLOG(3) << name_ << ": accepted inbound connection from " << remote;
+    // Already on the reactor thread, so the connection could be registered right away.
+    RegisterConnection(std::make_shared<Connection>(
+        this, remote, new_sock.Release(), ConnectionDirection::SERVER,
+        messenger_->connection_context_factory_()));
+  }
+}
+
 void Reactor::ScheduleReactorTask(std::shared_ptr<ReactorTask> task) {
   bool was_empty;
   {
@@ -40,6 +40,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 
 #include <ev++.h> // NOLINT
 
@@ -48,6 +49,7 @@
 
 #include "yb/gutil/ref_counted.h"
 
+#include "yb/rpc/growable_buffer.h"
 #include "yb/rpc/outbound_call.h"
 
 #include "yb/util/thread.h"
@@ -57,6 +59,9 @@
 #include "yb/util/status.h"
 
 namespace yb {
+
+class Counter;
+
 namespace rpc {
 
 // When compiling on Mac OS X, use 'kqueue' instead of the default, 'select', for the event loop.
@@ -250,6 +255,9 @@ class Reactor {
 
   CoarseMonoClock::TimePoint cur_time() const { return cur_time_; }
 
+  // Allocator for read buffers of connections served by this reactor.
+  GrowableBufferAllocator* buffer_allocator() { return &buffer_allocator_; }
+
   // Drop all connections with remote address. Used in tests with broken connectivity.
   void DropWithRemoteAddress(const IpAddress& address);
 
@@ -292,6 +300,14 @@ class Reactor {
   // If the reactor is already shut down, takes care of closing the socket.
   void RegisterInboundSocket(Socket *socket, const Endpoint& remote);
 
+  // Starts accepting connections from 'socket' on the reactor thread, and registers them with
+  // this reactor. Used when every reactor listens on its own SO_REUSEPORT socket.
+  // If the reactor is already shut down, the socket is closed.
+  void Listen(Socket socket);
+
+  // Stops accepting connections from the sockets passed to Listen() and closes them.
+  void StopListening();
+
   // Schedule the given task's Run() method to be called on the
   // reactor thread.
   // If the reactor shuts down before it is run, the Abort method will be
@@ -331,6 +347,11 @@ class Reactor {
   // Register a new connection.
   void RegisterConnection(const ConnectionPtr& conn);
 
+  // Accepts pending connections from one of listening_sockets_.
+  void AcceptHandler(ev::io& io, int events); // NOLINT
+
+  void StopListeningInternal();
+
   // Actually perform shutdown of the thread, tearing down any connections,
   // etc. This is called from within the thread.
   void ShutdownInternal();
@@ -353,6 +374,9 @@ class Reactor {
 
   const std::string name_;
 
+  // Should be declared before connections, so it is destroyed after them.
+  GrowableBufferAllocator buffer_allocator_;
+
   mutable simple_spinlock pending_tasks_lock_;
 
   // Whether the reactor is shutting down.
@@ -374,6 +398,16 @@ class Reactor {
   // Handles the periodic timer.
   ev::timer timer_;
 
+  struct ListeningSocket {
+    std::unique_ptr<ev::io> io;
+    Socket socket;
+  };
+
+  // Sockets this reactor accepts connections from, see Listen().
+  std::unordered_map<ev::io*, ListeningSocket> listening_sockets_;
+
+  scoped_refptr<Counter> rpc_connections_accepted_;
+
   // Scheduled (but not yet run) delayed tasks.
   //
   // Each task owns its own memory and must be freed by its TaskRun and
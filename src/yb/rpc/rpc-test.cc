@@ -44,6 +44,7 @@
 
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/strings/join.h"
+#include "yb/rpc/rpc_introspection.pb.h"
 #include "yb/rpc/serialization.h"
 #include "yb/util/countdown_latch.h"
 #include "yb/util/env.h"
@@ -52,6 +53,10 @@
 METRIC_DECLARE_histogram(handler_latency_yb_rpc_test_CalculatorService_Sleep);
 METRIC_DECLARE_histogram(rpc_incoming_queue_time);
 
+DECLARE_bool(rpc_reuse_port_per_reactor);
+DECLARE_int32(num_connections_to_server);
+DECLARE_bool(rpc_direct_local_calls);
+
 DEFINE_int32(rpc_test_connection_keepalive_num_iterations, 1,
   "Number of iterations in TestRpc.TestConnectionKeepalive");
 
@@ -148,6 +153,66 @@ TEST_F(TestRpc, TestCall) {
   }
 }
 
+// Test calls to a server where every reactor accepts connections on its own SO_REUSEPORT socket.
+TEST_F(TestRpc, TestCallReusePortPerReactor) {
+  FLAGS_rpc_reuse_port_per_reactor = true;
+
+  Endpoint server_addr;
+  StartTestServer(&server_addr);
+
+  // Several client messengers, so connections are spread over the server sockets.
+  for (int i = 0; i < 8; i++) {
+    shared_ptr<Messenger> client_messenger(CreateMessenger("Client" + std::to_string(i)));
+    Proxy p(client_messenger, server_addr, GenericCalculatorService::static_service_name());
+    ASSERT_OK(DoTestSyncCall(p, GenericCalculatorService::AddMethod()));
+  }
+}
+
+// Test that a call is not sent over a connection that has calls in flight while another
+// connection to the same server is idle.
+TEST_F(TestRpc, TestLeastLoadedConnection) {
+  FLAGS_num_connections_to_server = 2;
+
+  Endpoint server_addr;
+  StartTestServer(&server_addr);
+
+  shared_ptr<Messenger> client_messenger(CreateMessenger("Client"));
+  Proxy p(client_messenger, server_addr, GenericCalculatorService::static_service_name());
+
+  rpc_test::SleepRequestPB req;
+  req.set_sleep_micros(1000 * 1000);
+  rpc_test::SleepResponsePB resp[2];
+  RpcController controller[2];
+  CountDownLatch latch(2);
+
+  controller[0].set_timeout(MonoDelta::FromSeconds(10));
+  p.AsyncRequest(GenericCalculatorService::SleepMethod(), req, &resp[0], &controller[0],
+                 [&latch] { latch.CountDown(); });
+  // Round robin would send the second sleep over the same connection as the first one.
+  ASSERT_OK(DoTestSyncCall(p, GenericCalculatorService::AddMethod()));
+  controller[1].set_timeout(MonoDelta::FromSeconds(10));
+  p.AsyncRequest(GenericCalculatorService::SleepMethod(), req, &resp[1], &controller[1],
+                 [&latch] { latch.CountDown(); });
+
+  DumpRunningRpcsResponsePB dump;
+  ASSERT_OK(WaitFor([&client_messenger, &dump]() -> Result<bool> {
+    dump.Clear();
+    RETURN_NOT_OK(client_messenger->DumpRunningRpcs(DumpRunningRpcsRequestPB(), &dump));
+    int calls = 0;
+    for (const auto& conn : dump.outbound_connections()) {
+      calls += conn.calls_in_flight_size();
+    }
+    return calls == 2;
+  }, 5s, "Both calls in flight"));
+  for (const auto& conn : dump.outbound_connections()) {
+    ASSERT_LE(conn.calls_in_flight_size(), 1) << dump.ShortDebugString();
+  }
+
+  latch.Wait();
+  ASSERT_OK(controller[0].status());
+  ASSERT_OK(controller[1].status());
+}
+
 // Test that connecting to an invalid server properly throws an error.
 TEST_F(TestRpc, TestCallToBadServer) {
   shared_ptr<Messenger> client_messenger(CreateMessenger("Client"));
@@ -575,6 +640,34 @@ TEST_F(TestRpc, TestRpcContextClientDeadline) {
   ASSERT_OK(p.SyncRequest(&method, req, &resp, &controller));
 }
 
+// Test that a call to an endpoint of this process is handled directly by the listening messenger.
+TEST_F(TestRpc, TestDirectLocalCall) {
+  FLAGS_rpc_direct_local_calls = true;
+
+  Endpoint server_addr;
+  StartTestServerWithGeneratedCode(&server_addr);
+
+  shared_ptr<Messenger> client_messenger(CreateMessenger("Client"));
+  Proxy p(client_messenger, server_addr, rpc_test::CalculatorServiceIf::static_service_name());
+  ASSERT_TRUE(p.IsServiceLocal());
+
+  rpc_test::AddRequestPB req;
+  req.set_x(10);
+  req.set_y(20);
+  rpc_test::AddResponsePB resp;
+  RpcController controller;
+  controller.set_timeout(MonoDelta::FromSeconds(1));
+  RemoteMethod method(rpc_test::CalculatorServiceIf::static_service_name(),
+                      GenericCalculatorService::AddMethod()->method_name());
+  ASSERT_OK(p.SyncRequest(&method, req, &resp, &controller));
+  ASSERT_EQ(30U, resp.result());
+
+  // The call did not go through the network.
+  DumpRunningRpcsResponsePB dump;
+  ASSERT_OK(client_messenger->DumpRunningRpcs(DumpRunningRpcsRequestPB(), &dump));
+  ASSERT_EQ(0, dump.outbound_connections_size());
+}
+
 struct DisconnectShare {
   Proxy proxy;
   size_t left;
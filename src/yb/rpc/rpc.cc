@@ -32,6 +32,7 @@
 
 #include "yb/rpc/rpc.h"
 
+#include <algorithm>
 #include <functional>
 #include <string>
 #include <thread>
@@ -75,7 +76,7 @@ bool RpcRetrier::HandleResponse(RpcCommand* rpc, Status* out_status) {
   return false;
 }
 
-void RpcRetrier::DelayedRetry(RpcCommand* rpc, const Status& why_status) {
+void RpcRetrier::DelayedRetry(RpcCommand* rpc, const Status& why_status, MonoDelta min_delay) {
   if (!why_status.ok() && (last_error_.ok() || last_error_.IsTimedOut())) {
     last_error_ = why_status;
   }
@@ -84,6 +85,7 @@ void RpcRetrier::DelayedRetry(RpcCommand* rpc, const Status& why_status) {
   // If the delay causes us to miss our deadline, RetryCb will fail the
   // RPC on our behalf.
   int num_ms = ++attempt_num_ + RandomUniformInt(0, 4);
+  num_ms = std::max<int>(num_ms, min_delay.ToMilliseconds());
 
   RpcRetrierState expected_state = RpcRetrierState::kIdle;
   while (!state_.compare_exchange_strong(expected_state, RpcRetrierState::kWaiting)) {
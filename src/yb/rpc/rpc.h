@@ -113,7 +113,10 @@ class RpcRetrier {
   // deadline has already expired at the time that Retry() was called.
   //
   // Callers should ensure that 'rpc' remains alive.
-  void DelayedRetry(RpcCommand* rpc, const Status& why_status);
+  //
+  // 'min_delay' is a lower bound for the delay, e.g. a retry hint sent by the server.
+  void DelayedRetry(RpcCommand* rpc, const Status& why_status,
+                    MonoDelta min_delay = MonoDelta::kZero);
 
   RpcController* mutable_controller() { return &controller_; }
   const RpcController& controller() const { return controller_; }
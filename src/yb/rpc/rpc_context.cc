@@ -44,6 +44,7 @@
 #include "yb/rpc/reactor.h"
 #include "yb/rpc/yb_rpc.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/hdr_histogram.h"
 #include "yb/util/metrics.h"
 #include "yb/util/trace.h"
@@ -54,11 +55,25 @@
 using google::protobuf::Message;
 DECLARE_int32(rpc_max_message_size);
 
+DEFINE_bool(rpc_arena_allocate_messages, false,
+            "Allocate the request and response of inbound calls on a protobuf arena that is freed "
+            "as a single block with the call, instead of on the heap. Only applies to messages of "
+            "proto files that enable arenas.");
+TAG_FLAG(rpc_arena_allocate_messages, advanced);
+TAG_FLAG(rpc_arena_allocate_messages, runtime);
+
 namespace yb {
 namespace rpc {
 
 using std::shared_ptr;
 
+std::shared_ptr<google::protobuf::Arena> NewCallArena() {
+  if (!FLAGS_rpc_arena_allocate_messages) {
+    return nullptr;
+  }
+  return std::make_shared<google::protobuf::Arena>();
+}
+
 namespace {
 
 // Wrapper for a protobuf message which lazily converts to JSON when
@@ -127,7 +142,8 @@ RpcContext::RpcContext(std::shared_ptr<LocalYBInboundCall> call,
 }
 
 void RpcContext::RespondSuccess() {
-  if (response_pb_->ByteSize() > FLAGS_rpc_max_message_size) {
+  // Local calls pass the response object as is, so its size is not limited by the wire format.
+  if (!call_->IsLocalCall() && response_pb_->ByteSize() > FLAGS_rpc_max_message_size) {
     RespondFailure(STATUS(InvalidArgument, "RPC message too long"));
     return;
   }
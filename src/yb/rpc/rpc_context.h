@@ -33,6 +33,9 @@
 #define YB_RPC_RPC_CONTEXT_H
 
 #include <string>
+#include <type_traits>
+
+#include <google/protobuf/arena.h>
 
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/rpc/local_call.h"
@@ -61,6 +64,42 @@ namespace rpc {
 
 class YBInboundCall;
 
+// Returns a new arena for the request and response of an inbound call, or nullptr if
+// FLAGS_rpc_arena_allocate_messages is not set.
+std::shared_ptr<google::protobuf::Arena> NewCallArena();
+
+namespace internal {
+
+template <class T>
+std::shared_ptr<T> NewCallMessage(const std::shared_ptr<google::protobuf::Arena>& arena,
+                                  std::true_type) {
+  if (!arena) {
+    return std::make_shared<T>();
+  }
+  // The message shares the ownership of the arena, so all the allocations of the call are freed
+  // in one go once both its request and its response are released.
+  return std::shared_ptr<T>(arena, google::protobuf::Arena::CreateMessage<T>(arena.get()));
+}
+
+template <class T>
+std::shared_ptr<T> NewCallMessage(const std::shared_ptr<google::protobuf::Arena>& arena,
+                                  std::false_type) {
+  // Only messages of files with cc_enable_arenas could be placed on an arena, others could be
+  // handed over to owners that delete them.
+  return std::make_shared<T>();
+}
+
+} // namespace internal
+
+// Allocates a message of an inbound call, on 'arena' when it is not null and the message type
+// supports arenas.
+template <class T>
+std::shared_ptr<T> NewCallMessage(const std::shared_ptr<google::protobuf::Arena>& arena) {
+  return internal::NewCallMessage<T>(
+      arena,
+      std::integral_constant<bool, google::protobuf::Arena::is_arena_constructable<T>::value>());
+}
+
 // The context provided to a generated ServiceIf. This provides
 // methods to respond to the RPC. In the future, this will also
 // include methods to access information about the caller: e.g
@@ -55,6 +55,7 @@
 DEFINE_bool(is_panic_test_child, false, "Used by TestRpcPanic");
 DECLARE_bool(socket_inject_short_recvs);
 DECLARE_int32(rpc_slow_query_threshold_ms);
+DECLARE_bool(rpc_arena_allocate_messages);
 
 using namespace std::chrono_literals;
 
@@ -244,6 +245,22 @@ TEST_F(RpcStubTest, TestRespondDeferred) {
 }
 
 // Test that the default user credentials are propagated to the server.
+// Calls whose messages live on an arena, including one responded to after its handler returned.
+TEST_F(RpcStubTest, TestArenaAllocatedMessages) {
+  google::FlagSaver saver;
+  FLAGS_rpc_arena_allocate_messages = true;
+
+  SendSimpleCall();
+
+  CalculatorServiceProxy p(client_messenger_, server_endpoint_);
+  RpcController controller;
+  SleepRequestPB req;
+  req.set_sleep_micros(1000);
+  req.set_deferred(true);
+  SleepResponsePB resp;
+  ASSERT_OK(p.Sleep(req, &resp, &controller));
+}
+
 TEST_F(RpcStubTest, TestDefaultCredentialsPropagated) {
   CalculatorServiceProxy p(client_messenger_, server_endpoint_);
 
@@ -70,6 +70,7 @@ void ConnectionContextWithQueue::CallProcessed(InboundCall* call) {
     auto call_ptr = calls_queue_[max_concurrent_calls_ - 1];
     reactor->messenger()->QueueInboundCall(call_ptr);
   }
+  OnCallProcessed(call->connection().get());
 }
 
 void ConnectionContextWithQueue::QueueResponse(const ConnectionPtr& conn,
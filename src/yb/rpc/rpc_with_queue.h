@@ -54,6 +54,15 @@ class ConnectionContextWithQueue : public ConnectionContext {
 
   void Enqueue(std::shared_ptr<QueueableInboundCall> call);
 
+  // Whether call enqueued now would be processed immediately, i.e. limit of concurrent calls is
+  // not reached.
+  bool CanStartProcessingCall() const {
+    return calls_queue_.size() < max_concurrent_calls_;
+  }
+
+  // Invoked in reactor thread after call was processed and removed from queue.
+  virtual void OnCallProcessed(Connection* connection) {}
+
   uint64_t ProcessedCallCount() override {
     return processed_call_count_.load(std::memory_order_acquire);
   }
@@ -18,27 +18,29 @@
 #include <boost/asio/steady_timer.hpp>
 #include <boost/asio/strand.hpp>
 
-#include <boost/multi_index_container.hpp>
-#include <boost/multi_index/hashed_index.hpp>
-#include <boost/multi_index/mem_fun.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-
 #include <glog/logging.h>
 
 #include "yb/util/status.h"
+#include "yb/util/timer_wheel.h"
 
+using namespace std::literals;
 using namespace std::placeholders;
-using boost::multi_index::const_mem_fun;
-using boost::multi_index::hashed_unique;
-using boost::multi_index::ordered_non_unique;
 
 namespace yb {
 namespace rpc {
 
+namespace {
+
+// Resolution of the timer wheel, tasks could run up to this much later than scheduled.
+const auto kTick = 1ms;
+
+} // namespace
+
 class Scheduler::Impl {
  public:
   explicit Impl(IoService* io_service)
-      : io_service_(*io_service), strand_(*io_service), timer_(*io_service) {}
+      : io_service_(*io_service), strand_(*io_service), timer_(*io_service),
+        tasks_(kTick, std::chrono::steady_clock::now()) {}
 
   ~Impl() {
     Shutdown();
@@ -47,11 +49,9 @@ class Scheduler::Impl {
 
   void Abort(ScheduledTaskId task_id) {
     strand_.dispatch([this, task_id] {
-      auto& index = tasks_.get<IdTag>();
-      auto it = index.find(task_id);
-      if (it != index.end()) {
-        io_service_.post([task = *it] { task->Run(STATUS(Aborted, "Task aborted")); });
-        index.erase(it);
+      std::shared_ptr<ScheduledTaskBase> task;
+      if (tasks_.Erase(task_id, &task)) {
+        io_service_.post([task] { task->Run(STATUS(Aborted, "Task aborted")); });
       }
     });
   }
@@ -67,10 +67,12 @@ class Scheduler::Impl {
         auto status = STATUS(ServiceUnavailable, "Scheduler is shutting down", "", ESHUTDOWN);
         // Abort all scheduled tasks. It is ok to run task earlier than it was scheduled because
         // we pass error status to it.
-        for (auto task : tasks_) {
+        std::vector<std::shared_ptr<ScheduledTaskBase>> tasks;
+        tasks_.Clear(&tasks);
+        for (auto& task : tasks) {
           io_service_.post([task, status] { task->Run(status); });
         }
-        tasks_.clear();
+        timer_expiry_ = SteadyTimePoint::max();
       });
     }
   }
@@ -84,9 +86,9 @@ class Scheduler::Impl {
         return;
       }
 
-      auto pair = tasks_.insert(task);
-      CHECK(pair.second);
-      if (pair.first == tasks_.begin()) {
+      auto time = task->time();
+      tasks_.Insert(task->id(), time, task);
+      if (time < timer_expiry_) {
         StartTimer();
       }
     });
@@ -101,8 +103,9 @@ class Scheduler::Impl {
     DCHECK(strand_.running_in_this_thread());
     DCHECK(!tasks_.empty());
 
+    timer_expiry_ = tasks_.NextExpiration();
     boost::system::error_code ec;
-    timer_.expires_at((*tasks_.begin())->time(), ec);
+    timer_.expires_at(timer_expiry_, ec);
     LOG_IF(ERROR, ec) << "Reschedule timer failed: " << ec.message();
     timer_.async_wait(strand_.wrap(std::bind(&Impl::HandleTimer, this, _1)));
   }
@@ -111,6 +114,7 @@ class Scheduler::Impl {
     DCHECK(strand_.running_in_this_thread());
 
     if (ec) {
+      // The wait is also aborted when StartTimer() moves the expiry earlier.
       LOG_IF(ERROR, ec != boost::asio::error::operation_aborted) << "Wait failed: " << ec.message();
       return;
     }
@@ -118,38 +122,30 @@ class Scheduler::Impl {
       return;
     }
 
-    auto now = std::chrono::steady_clock::now();
-    while (!tasks_.empty() && (*tasks_.begin())->time() <= now) {
-      io_service_.post([task = *tasks_.begin()] { task->Run(Status::OK()); });
-      tasks_.erase(tasks_.begin());
+    std::vector<std::shared_ptr<ScheduledTaskBase>> expired;
+    tasks_.Advance(std::chrono::steady_clock::now(), &expired);
+    for (auto& task : expired) {
+      io_service_.post([task] { task->Run(Status::OK()); });
     }
 
     if (!tasks_.empty()) {
       StartTimer();
+    } else {
+      timer_expiry_ = SteadyTimePoint::max();
     }
   }
 
-  class IdTag;
-
-  typedef boost::multi_index_container<
-      std::shared_ptr<ScheduledTaskBase>,
-      boost::multi_index::indexed_by<
-          ordered_non_unique<
-              const_mem_fun<ScheduledTaskBase, SteadyTimePoint, &ScheduledTaskBase::time>
-          >,
-          hashed_unique<
-              boost::multi_index::tag<IdTag>,
-              const_mem_fun<ScheduledTaskBase, ScheduledTaskId, &ScheduledTaskBase::id>
-          >
-      >
-  > Tasks;
+  typedef TimerWheel<std::chrono::steady_clock, ScheduledTaskId,
+                     std::shared_ptr<ScheduledTaskBase>> Tasks;
 
   IoService& io_service_;
   std::atomic<ScheduledTaskId> id_ = {0};
-  Tasks tasks_;
-  // Strand that protects tasks_ and timer_ fields.
+  // Strand that protects tasks_, timer_ and timer_expiry_ fields.
   boost::asio::io_service::strand strand_;
   boost::asio::steady_timer timer_;
+  // Time the timer is armed for, or max if it is not armed.
+  SteadyTimePoint timer_expiry_ = SteadyTimePoint::max();
+  Tasks tasks_;
   std::atomic<bool> closing_ = {false};
 };
 
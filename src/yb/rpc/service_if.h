@@ -66,6 +66,11 @@ class ServiceIf {
   virtual ~ServiceIf();
   virtual void Handle(InboundCallPtr incoming) = 0;
 
+  // Whether the call could be handled directly on the reactor thread that received it, instead of
+  // being queued to the thread pool (see --rpc_handle_calls_on_reactor). Only calls whose handling
+  // never blocks, e.g. only dispatches asynchronous operations, should return true.
+  virtual bool CanHandleOnReactor(const InboundCall& call) const { return false; }
+
   virtual void Shutdown();
   virtual std::string service_name() const = 0;
 };
@@ -41,12 +41,15 @@
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/gutil/ref_counted.h"
 
+#include "yb/rpc/connection.h"
 #include "yb/rpc/inbound_call.h"
 #include "yb/rpc/messenger.h"
+#include "yb/rpc/reactor.h"
 #include "yb/rpc/service_if.h"
 #include "yb/rpc/tasks_pool.h"
 
 #include "yb/gutil/strings/substitute.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/metrics.h"
 #include "yb/util/status.h"
 #include "yb/util/thread.h"
@@ -59,7 +62,7 @@ METRIC_DEFINE_histogram(server, rpc_incoming_queue_time,
                         "RPC Queue Time",
                         yb::MetricUnit::kMicroseconds,
                         "Number of microseconds incoming RPC requests spend in the worker queue",
-                        60000000LU, 3);
+                        60000000LU, 3, yb::STRIPED);
 
 METRIC_DEFINE_counter(server, rpcs_timed_out_in_queue,
                       "RPC Queue Timeouts",
@@ -73,6 +76,11 @@ METRIC_DEFINE_counter(server, rpcs_queue_overflow,
                       "Number of RPCs dropped because the service queue "
                       "was full.");
 
+DEFINE_bool(rpc_handle_calls_on_reactor, false,
+            "Handle inbound calls of services that allow it directly on the reactor thread "
+            "that received them, avoiding the hand off to a worker thread.");
+TAG_FLAG(rpc_handle_calls_on_reactor, advanced);
+
 namespace yb {
 namespace rpc {
 
@@ -99,13 +107,14 @@ class ServicePoolImpl {
   ServicePoolImpl(size_t max_tasks,
        ThreadPool* thread_pool,
        std::unique_ptr<ServiceIf> service,
-       const scoped_refptr<MetricEntity>& entity)
+       const scoped_refptr<MetricEntity>& entity,
+       ThreadPoolTaskPriority priority)
       : thread_pool_(thread_pool),
         service_(std::move(service)),
         incoming_queue_time_(METRIC_rpc_incoming_queue_time.Instantiate(entity)),
         rpcs_timed_out_in_queue_(METRIC_rpcs_timed_out_in_queue.Instantiate(entity)),
         rpcs_queue_overflow_(METRIC_rpcs_queue_overflow.Instantiate(entity)),
-        tasks_pool_(max_tasks) {
+        tasks_pool_(max_tasks, priority) {
   }
 
   ~ServicePoolImpl() {
@@ -120,6 +129,15 @@ class ServicePoolImpl {
   }
 
   void Enqueue(InboundCallPtr call) {
+    if (FLAGS_rpc_handle_calls_on_reactor && service_->CanHandleOnReactor(*call)) {
+      auto connection = call->connection();
+      if (connection && connection->reactor()->IsCurrentThread()) {
+        TRACE_TO(call->trace(), "Handling call on reactor");
+        Handle(std::move(call));
+        return;
+      }
+    }
+
     TRACE_TO(call->trace(), "Inserting onto call queue");
 
     if (!tasks_pool_.Enqueue(thread_pool_, this, std::move(call))) {
@@ -214,8 +232,10 @@ void InboundCallTask::Done(const Status& status) {
 ServicePool::ServicePool(size_t max_tasks,
                          ThreadPool* thread_pool,
                          std::unique_ptr<ServiceIf> service,
-                         const scoped_refptr<MetricEntity>& metric_entity)
-    : impl_(new ServicePoolImpl(max_tasks, thread_pool, std::move(service), metric_entity)) {
+                         const scoped_refptr<MetricEntity>& metric_entity,
+                         ThreadPoolTaskPriority priority)
+    : impl_(new ServicePoolImpl(
+          max_tasks, thread_pool, std::move(service), metric_entity, priority)) {
 }
 
 ServicePool::~ServicePool() {
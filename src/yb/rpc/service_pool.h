@@ -40,6 +40,7 @@
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/gutil/ref_counted.h"
 #include "yb/rpc/rpc_service.h"
+#include "yb/rpc/thread_pool.h"
 #include "yb/util/blocking_queue.h"
 #include "yb/util/mutex.h"
 #include "yb/util/thread.h"
@@ -56,7 +57,6 @@ namespace rpc {
 
 class Messenger;
 class ServiceIf;
-class ThreadPool;
 class ServicePoolImpl;
 
 // A pool of threads that handle new incoming RPC calls.
@@ -66,7 +66,8 @@ class ServicePool : public RpcService {
   ServicePool(size_t max_tasks,
               ThreadPool* thread_pool,
               std::unique_ptr<ServiceIf> service,
-              const scoped_refptr<MetricEntity>& metric_entity);
+              const scoped_refptr<MetricEntity>& metric_entity,
+              ThreadPoolTaskPriority priority = ThreadPoolTaskPriority::kNormal);
   virtual ~ServicePool();
 
   // Shut down the queue and the thread pool.
@@ -15,20 +15,22 @@
 
 #include <boost/lockfree/queue.hpp>
 
+#include "yb/rpc/thread_pool.h"
+
 #ifndef YB_RPC_TASKS_POOL_H
 #define YB_RPC_TASKS_POOL_H
 
 namespace yb {
 namespace rpc {
 
-class ThreadPool;
-
 // Tasks pool that could be used in conjunction with ThreadPool, to preallocate a buffer for a fixed
 // number of tasks and avoid allocating memory for each task separately.
 template <class Task>
 class TasksPool {
  public:
-  explicit TasksPool(size_t size) : tasks_(size), queue_(size) {
+  explicit TasksPool(size_t size,
+                     ThreadPoolTaskPriority priority = ThreadPoolTaskPriority::kNormal)
+      : priority_(priority), tasks_(size), queue_(size) {
     for (auto& task : tasks_) {
       CHECK(queue_.bounded_push(&task));
     }
@@ -40,7 +42,7 @@ class TasksPool {
     if (queue_.pop(task)) {
       task->pool = this;
       new (&task->storage) Task(std::forward<Args>(args)...);
-      thread_pool->Enqueue(task);
+      thread_pool->Enqueue(task, priority_);
       return true;
     } else {
       return false;
@@ -83,6 +85,7 @@ class TasksPool {
     }
   };
 
+  const ThreadPoolTaskPriority priority_;
   std::vector<WrappedTask> tasks_;
   boost::lockfree::queue<WrappedTask*> queue_;
 };
@@ -14,6 +14,7 @@
 //
 
 #include <atomic>
+#include <mutex>
 #include <thread>
 
 #include <gtest/gtest.h>
@@ -208,5 +209,65 @@ TEST_F(ThreadPoolTest, TestShutdown) {
   }
 }
 
+namespace {
+
+class OrderedTask final : public ThreadPoolTask {
+ public:
+  OrderedTask(std::mutex* mutex, std::vector<int>* order, int id, CountDownLatch* start = nullptr)
+      : mutex_(mutex), order_(order), id_(id), start_(start) {}
+
+  void Run() override {
+    if (start_) {
+      start_->Wait();
+    }
+    std::lock_guard<std::mutex> lock(*mutex_);
+    order_->push_back(id_);
+  }
+
+  void Done(const Status& status) override {
+    ASSERT_OK(status);
+  }
+
+ private:
+  std::mutex* mutex_;
+  std::vector<int>* order_;
+  const int id_;
+  CountDownLatch* start_;
+};
+
+} // namespace
+
+TEST_F(ThreadPoolTest, TestPriorities) {
+  constexpr int kTasksPerPriority = 10;
+  ThreadPool pool("test", kTasksPerPriority, 1 /* max_workers */);
+
+  std::mutex mutex;
+  std::vector<int> order;
+  CountDownLatch start(1);
+  // Keep the only worker busy until all other tasks are queued.
+  OrderedTask blocker(&mutex, &order, -1, &start);
+  ASSERT_TRUE(pool.Enqueue(&blocker));
+
+  std::vector<std::unique_ptr<OrderedTask>> tasks;
+  const ThreadPoolTaskPriority priorities[] = {
+      ThreadPoolTaskPriority::kLow, ThreadPoolTaskPriority::kNormal, ThreadPoolTaskPriority::kHigh };
+  for (auto priority : priorities) {
+    for (int i = 0; i != kTasksPerPriority; ++i) {
+      tasks.emplace_back(new OrderedTask(&mutex, &order, static_cast<int>(priority)));
+      ASSERT_TRUE(pool.Enqueue(tasks.back().get(), priority));
+    }
+  }
+  start.CountDown();
+
+  ASSERT_OK(WaitFor([&] {
+    std::lock_guard<std::mutex> lock(mutex);
+    return order.size() == tasks.size() + 1;
+  }, MonoDelta::FromSeconds(10), "All tasks executed"));
+  pool.Shutdown();
+
+  ASSERT_EQ(-1, order.front());
+  ASSERT_TRUE(std::is_sorted(order.begin(), order.end())) << yb::ToString(order);
+}
+
 } // namespace rpc
 } // namespace yb
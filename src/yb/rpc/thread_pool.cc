@@ -15,6 +15,7 @@
 
 #include "yb/rpc/thread_pool.h"
 
+#include <array>
 #include <condition_variable>
 #include <mutex>
 #include <thread>
@@ -36,13 +37,39 @@ typedef boost::lockfree::queue<Worker*> WaitingWorkers;
 
 struct ThreadPoolShare {
   ThreadPoolOptions options;
-  TaskQueue task_queue;
+  // Separate queue for each priority, queue_limit is applied to each of them.
+  std::array<std::unique_ptr<TaskQueue>, kNumThreadPoolTaskPriorities> task_queues;
   WaitingWorkers waiting_workers;
 
   explicit ThreadPoolShare(ThreadPoolOptions o)
       : options(std::move(o)),
-        task_queue(options.queue_limit),
         waiting_workers(options.max_workers) {
+    for (auto& queue : task_queues) {
+      queue.reset(new TaskQueue(options.queue_limit));
+    }
+  }
+
+  TaskQueue& task_queue(ThreadPoolTaskPriority priority) {
+    return *task_queues[static_cast<size_t>(priority)];
+  }
+
+  // Pops a task with the highest available priority.
+  bool PopTask(ThreadPoolTask** task) {
+    for (auto& queue : task_queues) {
+      if (queue->pop(*task)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool Empty() const {
+    for (const auto& queue : task_queues) {
+      if (!queue->empty()) {
+        return false;
+      }
+    }
+    return true;
   }
 };
 
@@ -104,7 +131,7 @@ class Worker {
   bool PopTask(ThreadPoolTask** task) {
     // First of all we try to get already queued task, w/o locking.
     // If there is no task, so we could go to waiting state.
-    if (share_->task_queue.pop(*task)) {
+    if (share_->PopTask(task)) {
       return true;
     }
     std::unique_lock<std::mutex> lock(mutex_);
@@ -120,7 +147,7 @@ class Worker {
       // the worker queue. So worker queue could be empty in this case, and nobody was notified
       // about new task. So we check there for this case. This technique is similar to
       // double check.
-      if (share_->task_queue.pop(*task)) {
+      if (share_->PopTask(task)) {
         return true;
       }
 
@@ -128,7 +155,7 @@ class Worker {
 
       // Sometimes another worker could steal task before we wake up. In this case we will
       // just enqueue ourselves back.
-      if (share_->task_queue.pop(*task)) {
+      if (share_->PopTask(task)) {
         return true;
       }
     }
@@ -171,14 +198,14 @@ class ThreadPool::Impl {
     return share_.options;
   }
 
-  bool Enqueue(ThreadPoolTask* task) {
+  bool Enqueue(ThreadPoolTask* task, ThreadPoolTaskPriority priority) {
     ++adding_;
     if (closing_) {
       --adding_;
       task->Done(shutdown_status_);
       return false;
     }
-    bool added = share_.task_queue.bounded_push(task);
+    bool added = share_.task_queue(priority).bounded_push(task);
     --adding_;
     if (!added) {
       task->Done(queue_full_status_);
@@ -212,7 +239,7 @@ class ThreadPool::Impl {
     {
       std::lock_guard<std::mutex> lock(mutex_);
       if (closing_) {
-        CHECK(share_.task_queue.empty());
+        CHECK(share_.Empty());
         CHECK(workers_.empty());
         return;
       }
@@ -231,7 +258,7 @@ class ThreadPool::Impl {
       std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
     ThreadPoolTask* task = nullptr;
-    while (share_.task_queue.pop(task)) {
+    while (share_.PopTask(&task)) {
       task->Done(shutdown_status_);
     }
   }
@@ -271,8 +298,8 @@ bool ThreadPool::IsCurrentThreadRpcWorker() {
   return thread != nullptr && thread->category() == kRpcThreadCategory;
 }
 
-bool ThreadPool::Enqueue(ThreadPoolTask* task) {
-  return impl_->Enqueue(task);
+bool ThreadPool::Enqueue(ThreadPoolTask* task, ThreadPoolTaskPriority priority) {
+  return impl_->Enqueue(task, priority);
 }
 
 void ThreadPool::Shutdown() {
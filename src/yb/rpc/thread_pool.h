@@ -36,6 +36,17 @@ class ThreadPoolTask {
   ~ThreadPoolTask() {}
 };
 
+// Priority of a task queued to ThreadPool. Workers are shared by all services of a server, and an
+// idle worker always picks a queued task with the highest priority first. So, for instance,
+// consensus traffic is not stuck behind slow reads on a busy server.
+enum class ThreadPoolTaskPriority {
+  kHigh = 0,
+  kNormal,
+  kLow,
+};
+
+constexpr size_t kNumThreadPoolTaskPriorities = 3;
+
 struct ThreadPoolOptions {
   std::string name;
   size_t queue_limit;
@@ -59,7 +70,8 @@ class ThreadPool {
 
   const ThreadPoolOptions& options() const;
 
-  bool Enqueue(ThreadPoolTask* task);
+  bool Enqueue(ThreadPoolTask* task,
+               ThreadPoolTaskPriority priority = ThreadPoolTaskPriority::kNormal);
   void Shutdown();
 
   static bool IsCurrentThreadRpcWorker();
@@ -29,6 +29,7 @@
 #include "yb/util/size_literals.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/memory/memory.h"
+#include "yb/util/trace.h"
 
 using google::protobuf::io::CodedInputStream;
 using yb::operator"" _MB;
@@ -243,6 +244,9 @@ Status YBInboundCall::ParseFrom(Slice source) {
         header_.remote_method().InitializationErrorString());
   }
   remote_method_.FromPB(header_.remote_method());
+  if (header_.has_trace_id()) {
+    trace_->set_trace_id(header_.trace_id());
+  }
 
   return Status::OK();
 }
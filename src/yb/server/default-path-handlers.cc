@@ -68,6 +68,7 @@
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
 #include "yb/util/jsonwriter.h"
+#include "yb/util/trace.h"
 
 DEFINE_int64(web_log_bytes, 1024 * 1024,
     "The maximum number of bytes to display on the debug webserver's log page");
@@ -188,12 +189,24 @@ static void MemTrackersHandler(const Webserver::WebRequest& req, std::stringstre
   *output << "</table>\n";
 }
 
+// Registered to handle "/trace-stages", and prints out latencies of the stages of sampled requests.
+static void TraceStagesHandler(const Webserver::WebRequest& req, std::stringstream* output) {
+  bool as_text = (req.parsed_args.find("raw") != req.parsed_args.end());
+  Tags tags(as_text);
+  (*output) << tags.header << "Request Stage Latencies" << tags.end_header;
+  (*output) << tags.pre_tag;
+  DumpTraceStages(output);
+  (*output) << tags.end_pre_tag;
+}
+
 void AddDefaultPathHandlers(Webserver* webserver) {
   webserver->RegisterPathHandler("/logs", "Logs", LogsHandler, true, false);
   webserver->RegisterPathHandler("/varz", "Flags", FlagsHandler, true, false);
   webserver->RegisterPathHandler("/memz", "Memory (total)", MemUsageHandler, true, false);
   webserver->RegisterPathHandler("/mem-trackers", "Memory (detail)",
                                  MemTrackersHandler, true, false);
+  webserver->RegisterPathHandler("/trace-stages", "Request Stages",
+                                 TraceStagesHandler, true, false);
 
   AddPprofPathHandlers(webserver);
 }
@@ -233,15 +246,34 @@ static void WriteMetricsAsJson(const MetricRegistry* const metrics,
               "Couldn't write JSON metrics over HTTP");
 }
 
+// Supports the following arguments:
+//   entity_types: comma-separated types of the entities to export, e.g. "server,tablet".
+//   metrics: comma-separated substrings of the names of the metrics to export.
+//   skip_unchanged_counters: omit the counters that did not change since the previous scrape.
 static void WriteForPrometheus(const MetricRegistry* const metrics,
-                               const Webserver::WebRequest& req, std::stringstream* output) {
-  PrometheusWriter writer(output);
+                               const Webserver::WebRequest& req, std::ostream* output) {
+  MetricPrometheusOptions opts;
+  const string* entity_types_param = FindOrNull(req.parsed_args, "entity_types");
+  if (entity_types_param != nullptr) {
+    SplitStringUsing(*entity_types_param, ",", &opts.entity_types);
+  }
+  const string* requested_metrics_param = FindOrNull(req.parsed_args, "metrics");
+  if (requested_metrics_param != nullptr) {
+    opts.requested_metrics.clear();
+    SplitStringUsing(*requested_metrics_param, ",", &opts.requested_metrics);
+  }
+  {
+    string arg = FindWithDefault(req.parsed_args, "skip_unchanged_counters", "false");
+    opts.skip_unchanged_counters = ParseLeadingBoolValue(arg.c_str(), false);
+  }
+
+  PrometheusWriter writer(output, opts);
   WARN_NOT_OK(metrics->WriteForPrometheus(&writer), "Couldn't write text metrics for Prometheus");
 }
 
 void RegisterMetricsJsonHandler(Webserver* webserver, const MetricRegistry* const metrics) {
   Webserver::PathHandlerCallback callback = std::bind(WriteMetricsAsJson, metrics, _1, _2);
-  Webserver::PathHandlerCallback prometheus_callback = std::bind(
+  Webserver::StreamingPathHandlerCallback prometheus_callback = std::bind(
       WriteForPrometheus, metrics, _1, _2);
   bool not_styled = false;
   bool not_on_nav_bar = false;
@@ -251,8 +283,10 @@ void RegisterMetricsJsonHandler(Webserver* webserver, const MetricRegistry* cons
   // monitoring software which expects the old name.
   webserver->RegisterPathHandler("/jsonmetricz", "Metrics", callback, not_styled, not_on_nav_bar);
 
-  webserver->RegisterPathHandler(
-      "/prometheus-metrics", "Metrics", prometheus_callback, not_styled, not_on_nav_bar);
+  // With thousands of tablets the output is large, so it is streamed to the client as it is
+  // generated.
+  webserver->RegisterStreamingPathHandler(
+      "/prometheus-metrics", "Metrics", prometheus_callback, not_on_nav_bar);
 }
 
 } // namespace yb
@@ -31,6 +31,7 @@
 //
 
 #include <algorithm>
+#include <thread>
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
@@ -45,6 +46,10 @@ DECLARE_bool(use_mock_wall_clock);
 DECLARE_uint64(max_clock_sync_error_usec);
 DECLARE_bool(disable_clock_sync_error);
 
+DEFINE_int32(hybrid_clock_bench_threads, 8, "Number of threads calling Now() in the benchmark.");
+DEFINE_int32(hybrid_clock_bench_calls_per_thread, 100000,
+             "Number of Now() calls made by each thread in the benchmark.");
+
 namespace yb {
 namespace server {
 
@@ -258,6 +263,42 @@ TEST_F(HybridClockTest, TestClockDoesntGoBackwardsWithUpdates) {
   }
 }
 
+// Measures the throughput of Now() called concurrently from several threads, and checks that the
+// issued hybrid times are unique and increase monotonically on each thread.
+TEST_F(HybridClockTest, NowThroughput) {
+  const int num_threads = FLAGS_hybrid_clock_bench_threads;
+  const size_t num_calls = FLAGS_hybrid_clock_bench_calls_per_thread;
+  std::vector<std::vector<HybridTimeRepr>> issued(num_threads);
+  std::vector<std::thread> threads;
+
+  const MonoTime start = MonoTime::Now();
+  for (int i = 0; i != num_threads; ++i) {
+    threads.emplace_back([this, num_calls, &issued, i] {
+      auto& values = issued[i];
+      values.reserve(num_calls);
+      for (size_t n = 0; n != num_calls; ++n) {
+        values.push_back(clock_->Now().ToUint64());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const MonoDelta elapsed = MonoTime::Now().GetDeltaSince(start);
+
+  LOG(INFO) << num_threads << " threads made " << num_threads * num_calls << " Now() calls in "
+            << elapsed.ToString() << ": "
+            << num_threads * num_calls / std::max(elapsed.ToSeconds(), 1e-9) << " calls/sec";
+
+  std::vector<HybridTimeRepr> all;
+  for (const auto& values : issued) {
+    ASSERT_TRUE(std::is_sorted(values.begin(), values.end()));
+    all.insert(all.end(), values.begin(), values.end());
+  }
+  std::sort(all.begin(), all.end());
+  ASSERT_TRUE(std::adjacent_find(all.begin(), all.end()) == all.end());
+}
+
 TEST_F(HybridClockTest, CompareHybridClocksToDelta) {
   EXPECT_EQ(1, HybridClock::CompareHybridClocksToDelta(
       HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(1000, 10),
@@ -115,8 +115,7 @@ HybridClock::HybridClock()
       divisor_(1),
 #endif
       tolerance_adjustment_(1),
-      last_usec_(0),
-      next_logical_(0),
+      last_(0),
       state_(kNotInitialized) {
 }
 
@@ -215,8 +214,7 @@ HybridTime HybridClock::Now() {
   HybridTime now;
   uint64_t error;
 
-  std::lock_guard<simple_spinlock> lock(lock_);
-  NowWithErrorUnlocked(&now, &error);
+  NowWithError(&now, &error);
   return now;
 }
 
@@ -224,10 +222,7 @@ HybridTime HybridClock::NowLatest() {
   HybridTime now;
   uint64_t error;
 
-  {
-    std::lock_guard<simple_spinlock> lock(lock_);
-    NowWithErrorUnlocked(&now, &error);
-  }
+  NowWithError(&now, &error);
 
   uint64_t now_latest = GetPhysicalValueMicros(now) + error;
   uint64_t now_logical = GetLogicalValue(now);
@@ -244,13 +239,6 @@ Status HybridClock::GetGlobalLatest(HybridTime* t) {
 }
 
 void HybridClock::NowWithError(HybridTime *hybrid_time, uint64_t *max_error_usec) {
-  std::lock_guard<simple_spinlock> lock(lock_);
-  NowWithErrorUnlocked(hybrid_time, max_error_usec);
-}
-
-void HybridClock::NowWithErrorUnlocked(HybridTime *hybrid_time, uint64_t *max_error_usec) {
-
-  DCHECK(lock_.is_locked());
   DCHECK_EQ(state_, kInitialized) << "Clock not initialized. Must call Init() first.";
 
   uint64_t now_usec;
@@ -261,11 +249,21 @@ void HybridClock::NowWithErrorUnlocked(HybridTime *hybrid_time, uint64_t *max_er
         "Status: $0", s.ToString());
   }
 
+  const HybridTimeRepr now = HybridTimeFromMicroseconds(now_usec).ToUint64();
+  HybridTimeRepr last = last_.load(std::memory_order_acquire);
+  HybridTimeRepr next;
+  bool advanced;
+  do {
+    // The current time has a zero logical value, so it is higher than the last one exactly when
+    // its physical value is.
+    advanced = now > last;
+    next = PREDICT_TRUE(advanced) ? now : last + 1;
+  } while (!last_.compare_exchange_weak(last, next, std::memory_order_acq_rel));
+
+  *hybrid_time = HybridTime(next);
+
   // If the current time surpasses the last update just return it
-  if (PREDICT_TRUE(now_usec > last_usec_)) {
-    last_usec_ = now_usec;
-    next_logical_ = 1;
-    *hybrid_time = HybridTimeFromMicroseconds(last_usec_);
+  if (PREDICT_TRUE(advanced)) {
     *max_error_usec = error_usec;
     if (PREDICT_FALSE(VLOG_IS_ON(2))) {
       VLOG(2) << "Current clock is higher than the last one. Resetting logical values."
@@ -293,14 +291,12 @@ void HybridClock::NowWithErrorUnlocked(HybridTime *hybrid_time, uint64_t *max_er
   // This broadens the error interval for both cases but always returns
   // a correct error interval.
 
-  *max_error_usec = last_usec_ - (now_usec - error_usec);
-  *hybrid_time = HybridTimeFromMicrosecondsAndLogicalValue(last_usec_, next_logical_);
+  *max_error_usec = GetPhysicalValueMicros(*hybrid_time) - (now_usec - error_usec);
   if (PREDICT_FALSE(VLOG_IS_ON(2))) {
     VLOG(2) << "Current clock is lower than the last one. Returning last read and incrementing"
         " logical values. Physical Value: " << now_usec << " usec Logical Value: "
-        << next_logical_ << " Error: " << *max_error_usec;
+        << GetLogicalValue(*hybrid_time) << " Error: " << *max_error_usec;
   }
-  next_logical_++;
 }
 
 void HybridClock::Update(const HybridTime& to_update) {
@@ -308,17 +304,12 @@ void HybridClock::Update(const HybridTime& to_update) {
     return;
   }
 
-  std::lock_guard<simple_spinlock> lock(lock_);
-  HybridTime now;
-  uint64_t error_ignored;
-  NowWithErrorUnlocked(&now, &error_ignored);
-
-  if (PREDICT_TRUE(now.CompareTo(to_update) > 0)) {
-    return;
+  // Make sure the next hybrid_time issued is higher than the incoming one. If the wall clock is
+  // already past it, the next NowWithError() picks that up by itself.
+  const HybridTimeRepr value = to_update.ToUint64();
+  HybridTimeRepr last = last_.load(std::memory_order_acquire);
+  while (last < value && !last_.compare_exchange_weak(last, value, std::memory_order_acq_rel)) {
   }
-
-  last_usec_ = GetPhysicalValueMicros(to_update);
-  next_logical_ = GetLogicalValue(to_update) + 1;
 }
 
 Status HybridClock::WaitUntilAfter(const HybridTime& then_latest,
@@ -326,10 +317,7 @@ Status HybridClock::WaitUntilAfter(const HybridTime& then_latest,
   TRACE_EVENT0("clock", "HybridClock::WaitUntilAfter");
   HybridTime now;
   uint64_t error;
-  {
-    std::lock_guard<simple_spinlock> lock(lock_);
-    NowWithErrorUnlocked(&now, &error);
-  }
+  NowWithError(&now, &error);
 
   // "unshift" the hybrid_times so that we can measure actual time
   uint64_t now_usec = GetPhysicalValueMicros(now);
@@ -370,10 +358,7 @@ Status HybridClock::WaitUntilAfterLocally(const HybridTime& then,
   while (true) {
     HybridTime now;
     uint64_t error;
-    {
-      std::lock_guard<simple_spinlock> lock(lock_);
-      NowWithErrorUnlocked(&now, &error);
-    }
+    NowWithError(&now, &error);
     if (now.CompareTo(then) > 0) {
       return Status::OK();
     }
@@ -391,16 +376,13 @@ bool HybridClock::IsAfter(HybridTime t) {
   uint64_t error_usec;
   CHECK_OK(WalltimeWithError(&now_usec, &error_usec));
 
-  std::lock_guard<simple_spinlock> lock(lock_);
-  now_usec = std::max(now_usec, last_usec_);
+  const HybridTimeRepr last = last_.load(std::memory_order_acquire);
 
-  HybridTime now;
-  if (now_usec > last_usec_) {
-    now = HybridTimeFromMicroseconds(now_usec);
-  } else {
-    // last_usec_ may be in the future if we were updated from a remote
+  HybridTime now = HybridTimeFromMicroseconds(now_usec);
+  if (now.ToUint64() <= last) {
+    // last_ may be in the future if we were updated from a remote
     // node.
-    now = HybridTimeFromMicrosecondsAndLogicalValue(last_usec_, next_logical_);
+    now = HybridTime(last + 1);
   }
 
   return t.value() < now.value();
@@ -445,14 +427,12 @@ yb::Status HybridClock::WalltimeWithError(uint64_t* now_usec, uint64_t* error_us
 
 void HybridClock::SetMockClockWallTimeForTests(uint64_t now_usec) {
   CHECK(FLAGS_use_mock_wall_clock);
-  std::lock_guard<simple_spinlock> lock(lock_);
-  CHECK_GE(now_usec, mock_clock_time_usec_);
+  CHECK_GE(now_usec, mock_clock_time_usec_.load());
   mock_clock_time_usec_ = now_usec;
 }
 
 void HybridClock::SetMockMaxClockErrorForTests(uint64_t max_error_usec) {
   CHECK(FLAGS_use_mock_wall_clock);
-  std::lock_guard<simple_spinlock> lock(lock_);
   mock_clock_max_error_usec_ = max_error_usec;
 }
 
@@ -466,8 +446,7 @@ uint64_t HybridClock::ErrorForMetrics() {
   HybridTime now;
   uint64_t error;
 
-  std::lock_guard<simple_spinlock> lock(lock_);
-  NowWithErrorUnlocked(&now, &error);
+  NowWithError(&now, &error);
   return error;
 }
 
@@ -33,6 +33,7 @@
 #ifndef YB_SERVER_HYBRID_CLOCK_H_
 #define YB_SERVER_HYBRID_CLOCK_H_
 
+#include <atomic>
 #include <string>
 #if !defined(__APPLE__)
 #include <sys/timex.h>
@@ -130,9 +131,8 @@ class HybridClock : public Clock {
   // error in micros. This may fail if the clock is unsynchronized or synchronized
   // but the error is too high and, since we can't do anything about it,
   // LOG(FATAL)'s in that case.
-  void NowWithErrorUnlocked(HybridTime* hybrid_time, uint64_t* max_error_usec);
-
-  // Variation of above method with locking.
+  //
+  // This is lock-free: the last issued hybrid time is advanced with a compare-and-swap.
   void NowWithError(HybridTime* hybrid_time, uint64_t* max_error_usec);
 
   virtual std::string Stringify(HybridTime hybrid_time) override;
@@ -217,11 +217,11 @@ class HybridClock : public Clock {
 
   // Set by calls to SetMockClockWallTimeForTests().
   // For testing purposes only.
-  uint64_t mock_clock_time_usec_;
+  std::atomic<uint64_t> mock_clock_time_usec_;
 
   // Set by calls to SetMockClockErrorForTests().
   // For testing purposes only.
-  uint64_t mock_clock_max_error_usec_;
+  std::atomic<uint64_t> mock_clock_max_error_usec_;
 
 #if !defined(__APPLE__)
   uint64_t divisor_;
@@ -229,12 +229,10 @@ class HybridClock : public Clock {
 
   double tolerance_adjustment_;
 
-  mutable simple_spinlock lock_;
-
-  // the last clock read/update, in microseconds.
-  uint64_t last_usec_;
-  // the next logical value to be assigned to a hybrid_time
-  uint64_t next_logical_;
+  // The value of the last hybrid_time issued by NowWithError() or received by Update(). The
+  // next hybrid_time issued is either the current wall clock time, if it is higher, or this value
+  // with the logical component incremented.
+  std::atomic<HybridTimeRepr> last_;
 
   // How many bits to left shift a microseconds clock read. The remainder
   // of the hybrid_time will be reserved for logical values.
@@ -60,6 +60,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/sysinfo.h"
 #include "yb/server/webserver.h"
+#include "yb/util/cpu_sampling_profiler.h"
 #include "yb/util/env.h"
 #include "yb/util/logging.h"
 #include "yb/util/monotime.h"
@@ -204,6 +205,19 @@ static void PprofContentionHandler(const Webserver::WebRequest& req, stringstrea
 #endif // defined(__linux__)
 }
 
+// Profile of the continuous CPU sampling profiler, for the interval of 'seconds' seconds that
+// ended 'ago' seconds ago, both given as query parameters. Returns immediately, since the samples
+// were already taken, in the folded stack format that flamegraph.pl takes as input:
+//   curl 'http://<host>:<port>/pprof/continuous?seconds=60&ago=300' | flamegraph.pl > cpu.svg
+static void PprofContinuousHandler(const Webserver::WebRequest& req, stringstream* output) {
+  string secs_str = FindWithDefault(req.parsed_args, "seconds", "");
+  int32_t seconds = ParseLeadingInt32Value(secs_str.c_str(), PPROF_DEFAULT_SAMPLE_SECS);
+  string ago_str = FindWithDefault(req.parsed_args, "ago", "");
+  int32_t ago = ParseLeadingInt32Value(ago_str.c_str(), 0);
+
+  const MonoTime to = MonoTime::Now() - MonoDelta::FromSeconds(ago);
+  WriteCpuSamplingProfile(to - MonoDelta::FromSeconds(seconds), to, output);
+}
 
 // pprof asks for the url /pprof/symbol to map from hex addresses to variable names.
 // When the server receives a GET request for /pprof/symbol, it should return a line
@@ -267,6 +281,7 @@ void AddPprofPathHandlers(Webserver* webserver) {
   webserver->RegisterPathHandler("/pprof/profile", "", PprofCpuProfileHandler, false, false);
   webserver->RegisterPathHandler("/pprof/symbol", "", PprofSymbolHandler, false, false);
   webserver->RegisterPathHandler("/pprof/contention", "", PprofContentionHandler, false, false);
+  webserver->RegisterPathHandler("/pprof/continuous", "", PprofContinuousHandler, false, false);
 }
 
 } // namespace yb
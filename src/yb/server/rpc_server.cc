@@ -120,13 +120,15 @@ Status RpcServer::Init(const shared_ptr<Messenger>& messenger) {
   return Status::OK();
 }
 
-Status RpcServer::RegisterService(size_t queue_limit, std::unique_ptr<rpc::ServiceIf> service) {
+Status RpcServer::RegisterService(size_t queue_limit, std::unique_ptr<rpc::ServiceIf> service,
+                                  rpc::ThreadPoolTaskPriority priority) {
   CHECK(server_state_ == INITIALIZED ||
         server_state_ == BOUND) << "bad state: " << server_state_;
   const scoped_refptr<MetricEntity>& metric_entity = messenger_->metric_entity();
   string service_name = service->service_name();
   scoped_refptr<rpc::ServicePool> service_pool =
-    new rpc::ServicePool(queue_limit, thread_pool_.get(), std::move(service), metric_entity);
+    new rpc::ServicePool(queue_limit, thread_pool_.get(), std::move(service), metric_entity,
+                         priority);
   RETURN_NOT_OK(messenger_->RegisterService(service_name, service_pool));
   return Status::OK();
 }
@@ -63,7 +63,9 @@ class RpcServer {
   CHECKED_STATUS Init(const std::shared_ptr<rpc::Messenger>& messenger);
   // Services need to be registered after Init'ing, but before Start'ing.
   // The service's ownership will be given to a ServicePool.
-  CHECKED_STATUS RegisterService(size_t queue_limit, std::unique_ptr<rpc::ServiceIf> service);
+  CHECKED_STATUS RegisterService(
+      size_t queue_limit, std::unique_ptr<rpc::ServiceIf> service,
+      rpc::ThreadPoolTaskPriority priority = rpc::ThreadPoolTaskPriority::kNormal);
   CHECKED_STATUS Bind();
   CHECKED_STATUS Start();
   void Shutdown();
@@ -59,6 +59,7 @@
 #include "yb/server/tracing-path-handlers.h"
 #include "yb/server/webserver.h"
 #include "yb/util/atomic.h"
+#include "yb/util/cpu_sampling_profiler.h"
 #include "yb/util/env.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/jsonwriter.h"
@@ -241,8 +242,9 @@ Status RpcServerBase::DumpServerInfo(const string& path,
 }
 
 Status RpcServerBase::RegisterService(size_t queue_limit,
-                                      std::unique_ptr<rpc::ServiceIf> rpc_impl) {
-  return rpc_server_->RegisterService(queue_limit, std::move(rpc_impl));
+                                      std::unique_ptr<rpc::ServiceIf> rpc_impl,
+                                      rpc::ThreadPoolTaskPriority priority) {
+  return rpc_server_->RegisterService(queue_limit, std::move(rpc_impl), priority);
 }
 
 Status RpcServerBase::StartMetricsLogging() {
@@ -473,6 +475,7 @@ Status RpcAndWebServerBase::Start() {
                                    true, true, "fa fa-wrench");
   web_server_->set_footer_html(FooterHtml());
   RETURN_NOT_OK(web_server_->Start());
+  RETURN_NOT_OK(StartCpuSamplingProfiler());
 
   RETURN_NOT_OK(RpcServerBase::Start());
 
@@ -40,6 +40,7 @@
 #include "yb/gutil/macros.h"
 #include "yb/gutil/ref_counted.h"
 #include "yb/rpc/service_if.h"
+#include "yb/rpc/thread_pool.h"
 #include "yb/server/server_base_options.h"
 #include "yb/server/webserver.h"
 #include "yb/util/status.h"
@@ -99,7 +100,9 @@ class RpcServerBase {
   virtual ~RpcServerBase();
 
   CHECKED_STATUS Init();
-  CHECKED_STATUS RegisterService(size_t queue_limit, std::unique_ptr<rpc::ServiceIf> rpc_impl);
+  CHECKED_STATUS RegisterService(
+      size_t queue_limit, std::unique_ptr<rpc::ServiceIf> rpc_impl,
+      rpc::ThreadPoolTaskPriority priority = rpc::ThreadPoolTaskPriority::kNormal);
   CHECKED_STATUS Start();
   CHECKED_STATUS StartRpcServer();
   void Shutdown();
@@ -50,6 +50,8 @@
 #include <functional>
 #include <map>
 #include <mutex>
+#include <ostream>
+#include <streambuf>
 #include <string>
 #include <vector>
 
@@ -358,6 +360,11 @@ int Webserver::RunPathHandler(const PathHandler& handler,
     }
   }
 
+  if (handler.streaming_callback()) {
+    RunStreamingPathHandler(handler, req, connection);
+    return 1;
+  }
+
   if (!handler.is_styled() || ContainsKey(req.parsed_args, "raw")) {
     use_style = false;
   }
@@ -403,6 +410,93 @@ void Webserver::RegisterPathHandler(const string& path,
   it->second->AddCallback(callback);
 }
 
+void Webserver::RegisterStreamingPathHandler(const string& path,
+                                             const string& alias,
+                                             const StreamingPathHandlerCallback& callback,
+                                             bool is_on_nav_bar) {
+  std::lock_guard<boost::shared_mutex> lock(lock_);
+  auto it = path_handlers_.find(path);
+  if (it == path_handlers_.end()) {
+    it = path_handlers_.insert(
+        make_pair(path, new PathHandler(false, is_on_nav_bar, alias, ""))).first;
+  }
+  DCHECK(it->second->callbacks().empty()) << path << " already has regular callbacks";
+  it->second->set_streaming_callback(callback);
+}
+
+namespace {
+
+// Sends what is written to it to the client as HTTP/1.1 chunks, each time its buffer fills up.
+class ChunkedResponseBuf : public std::streambuf {
+ public:
+  explicit ChunkedResponseBuf(struct sq_connection* connection)
+      : connection_(connection), buffer_(kBufferSize) {
+    setp(buffer_.data(), buffer_.data() + buffer_.size());
+  }
+
+  // Sends the remaining output followed by the terminating empty chunk.
+  void Finish() {
+    SendChunk();
+    Send("0\r\n\r\n", 5);
+  }
+
+ protected:
+  int_type overflow(int_type ch) override {
+    if (!SendChunk()) {
+      return traits_type::eof();
+    }
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(ch);
+      pbump(1);
+    }
+    return traits_type::not_eof(ch);
+  }
+
+  int sync() override {
+    return SendChunk() ? 0 : -1;
+  }
+
+ private:
+  static constexpr size_t kBufferSize = 64 * 1024;
+
+  bool SendChunk() {
+    const size_t size = pptr() - pbase();
+    if (size == 0) {
+      return ok_;
+    }
+    const string header = StringPrintf("%zx\r\n", size);
+    Send(header.c_str(), header.size());
+    Send(pbase(), size);
+    Send("\r\n", 2);
+    setp(buffer_.data(), buffer_.data() + buffer_.size());
+    return ok_;
+  }
+
+  void Send(const char* data, size_t size) {
+    // Once the client went away, the rest of the output is dropped.
+    ok_ = ok_ && sq_write(connection_, data, size) == static_cast<int>(size);
+  }
+
+  struct sq_connection* const connection_;
+  std::vector<char> buffer_;
+  bool ok_ = true;
+};
+
+} // namespace
+
+void Webserver::RunStreamingPathHandler(const PathHandler& handler,
+                                        const WebRequest& req,
+                                        struct sq_connection* connection) {
+  sq_printf(connection, "HTTP/1.1 200 OK\r\n"
+            "Content-Type: text/plain\r\n"
+            "Transfer-Encoding: chunked\r\n"
+            "\r\n");
+  ChunkedResponseBuf buf(connection);
+  std::ostream output(&buf);
+  handler.streaming_callback()(req, &output);
+  buf.Finish();
+}
+
 const char* const PAGE_HEADER = "<!DOCTYPE html>"
 "<html>"
 "  <head>"
@@ -86,6 +86,10 @@ class Webserver : public WebCallbackRegistry {
                                    bool is_on_nav_bar = true,
                                    const std::string icon = "") override;
 
+  virtual void RegisterStreamingPathHandler(const std::string& path, const std::string& alias,
+                                            const StreamingPathHandlerCallback& callback,
+                                            bool is_on_nav_bar = true) override;
+
   // Change the footer HTML to be displayed at the bottom of all styled web pages.
   void set_footer_html(const std::string& html);
 
@@ -111,6 +115,11 @@ class Webserver : public WebCallbackRegistry {
     const std::string& icon() const { return icon_; }
     const std::vector<PathHandlerCallback>& callbacks() const { return callbacks_; }
 
+    void set_streaming_callback(const StreamingPathHandlerCallback& callback) {
+      streaming_callback_ = callback;
+    }
+    const StreamingPathHandlerCallback& streaming_callback() const { return streaming_callback_; }
+
    private:
     // If true, the page appears is rendered styled.
     bool is_styled_;
@@ -126,6 +135,9 @@ class Webserver : public WebCallbackRegistry {
 
     // List of callbacks to render output for this page, called in order.
     std::vector<PathHandlerCallback> callbacks_;
+
+    // If set, the callback streaming the output of this page, used instead of callbacks_.
+    StreamingPathHandlerCallback streaming_callback_;
   };
 
   bool static_pages_available() const;
@@ -150,6 +162,11 @@ class Webserver : public WebCallbackRegistry {
                      struct sq_connection* connection,
                      struct sq_request_info* request_info);
 
+  // Runs the streaming callback of 'handler', sending its output as a chunked response.
+  void RunStreamingPathHandler(const PathHandler& handler,
+                               const WebRequest& req,
+                               struct sq_connection* connection);
+
   // Callback to funnel mongoose logs through glog.
   static int LogMessageCallbackStatic(const struct sq_connection* connection,
                                       const char* message);
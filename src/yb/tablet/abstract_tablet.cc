@@ -18,6 +18,11 @@
 namespace yb {
 namespace tablet {
 
+Result<std::shared_ptr<const docdb::QLReadProjections>> AbstractTablet::GetQLReadProjections(
+    const Schema& schema, const QLReferencedColumnsPB& column_refs) {
+  return docdb::QLReadProjections::Create(schema, column_refs);
+}
+
 CHECKED_STATUS AbstractTablet::HandleQLReadRequest(
     const ReadHybridTime& read_time,
     const QLReadRequestPB& ql_read_request,
@@ -27,24 +32,18 @@ CHECKED_STATUS AbstractTablet::HandleQLReadRequest(
   // TODO(Robert): verify that all key column values are provided
   docdb::QLReadOperation doc_op(ql_read_request, txn_op_context);
 
-  // Form a schema of columns that are referenced by this query.
+  // Get the projections of the columns that are referenced by this query.
   const Schema &schema = SchemaRef();
-  Schema query_schema;
-  const QLReferencedColumnsPB& column_pbs = ql_read_request.column_refs();
-  vector<ColumnId> column_refs;
-  for (int32_t id : column_pbs.static_ids()) {
-    column_refs.emplace_back(id);
-  }
-  for (int32_t id : column_pbs.ids()) {
-    column_refs.emplace_back(id);
+  auto projections = GetQLReadProjections(schema, ql_read_request.column_refs());
+  if (!projections.ok()) {
+    return projections.status();
   }
-  RETURN_NOT_OK(schema.CreateProjectionByIdsIgnoreMissing(column_refs, &query_schema));
 
   QLRSRowDesc rsrow_desc(ql_read_request.rsrow_desc());
   QLResultSet resultset;
   TRACE("Start Execute");
   const Status s = doc_op.Execute(
-      QLStorage(), read_time, schema, query_schema, &resultset, &result->restart_read_ht);
+      QLStorage(), read_time, schema, **projections, &resultset, &result->restart_read_ht);
   TRACE("Done Execute");
   if (!s.ok()) {
     result->response.set_status(QLResponsePB::YQL_STATUS_RUNTIME_ERROR);
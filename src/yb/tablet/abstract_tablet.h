@@ -17,6 +17,7 @@
 #include "yb/common/redis_protocol.pb.h"
 #include "yb/common/schema.h"
 #include "yb/common/ql_storage_interface.h"
+#include "yb/docdb/ql_read_projections.h"
 
 namespace yb {
 namespace tablet {
@@ -59,6 +60,11 @@ class AbstractTablet {
   virtual HybridTime SafeTimestampToRead() const = 0;
 
  protected:
+  // Returns the projections of 'schema' that a QL read of the given columns uses. Tablets that
+  // serve many reads could cache them.
+  virtual Result<std::shared_ptr<const docdb::QLReadProjections>> GetQLReadProjections(
+      const Schema& schema, const QLReferencedColumnsPB& column_refs);
+
   CHECKED_STATUS HandleQLReadRequest(
       const ReadHybridTime& read_time,
       const QLReadRequestPB& ql_read_request,
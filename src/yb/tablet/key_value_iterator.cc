@@ -34,6 +34,7 @@ KeyValueIterator::~KeyValueIterator() {
 Status KeyValueIterator::Init(ScanSpec* spec) {
   rocksdb::ReadOptions read_options;
   read_options.query_id = spec->query_id();
+  read_options.total_order_seek = true;
   db_iter_.reset(db_->NewIterator(read_options));
 
   if (spec->lower_bound_key() != nullptr) {
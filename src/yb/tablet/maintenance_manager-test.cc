@@ -45,6 +45,8 @@
 #include "yb/util/test_util.h"
 #include "yb/util/thread.h"
 
+DECLARE_int64(maintenance_manager_disk_io_budget_bytes);
+
 using yb::tablet::MaintenanceManagerStatusPB;
 using std::shared_ptr;
 using std::vector;
@@ -140,6 +142,7 @@ class TestMaintenanceOp : public MaintenanceOp {
     stats->set_ram_anchored(consumption_.consumption());
     stats->set_logs_retained_bytes(logs_retained_bytes_);
     stats->set_perf_improvement(perf_improvement_);
+    stats->set_estimated_io_bytes(estimated_io_bytes_);
   }
 
   void Enable() {
@@ -187,6 +190,11 @@ class TestMaintenanceOp : public MaintenanceOp {
     perf_improvement_ = perf_improvement;
   }
 
+  void set_estimated_io_bytes(uint64_t estimated_io_bytes) {
+    std::lock_guard<Mutex> guard(lock_);
+    estimated_io_bytes_ = estimated_io_bytes;
+  }
+
   scoped_refptr<Histogram> DurationHistogram() const override {
     return maintenance_op_duration_;
   }
@@ -202,6 +210,7 @@ class TestMaintenanceOp : public MaintenanceOp {
   ScopedTrackedConsumption consumption_;
   uint64_t logs_retained_bytes_;
   uint64_t perf_improvement_;
+  uint64_t estimated_io_bytes_ = 0;
   MetricRegistry metric_registry_;
   scoped_refptr<MetricEntity> metric_entity_;
   scoped_refptr<Histogram> maintenance_op_duration_;
@@ -279,6 +288,36 @@ TEST_F(MaintenanceManagerTest, TestLogRetentionPrioritization) {
   manager_->UnregisterOp(&op2);
 }
 
+// Test that ops are held back while the ops running on their device use its IO budget.
+TEST_F(MaintenanceManagerTest, TestIOBudget) {
+  manager_->Shutdown();
+  FLAGS_maintenance_manager_disk_io_budget_bytes = 1000;
+
+  TestMaintenanceOp op1("op1", MaintenanceOp::HIGH_IO_USAGE, OP_RUNNABLE, test_tracker_);
+  op1.set_perf_improvement(2);
+
+  TestMaintenanceOp op2("op2", MaintenanceOp::HIGH_IO_USAGE, OP_RUNNABLE, test_tracker_);
+  op2.set_perf_improvement(1);
+  op2.set_estimated_io_bytes(500);
+
+  manager_->RegisterOp(&op1);
+  manager_->RegisterOp(&op2);
+
+  // Nothing is running, so the op without an estimate may take the whole budget.
+  ASSERT_EQ(&op1, manager_->FindBestOp());
+
+  // With another op running, only the op that declares a small enough IO cost fits.
+  manager_->running_io_bytes_[""] = 400;
+  ASSERT_EQ(&op2, manager_->FindBestOp());
+
+  manager_->running_io_bytes_[""] = 600;
+  ASSERT_EQ(nullptr, manager_->FindBestOp());
+
+  manager_->running_io_bytes_[""] = 0;
+  manager_->UnregisterOp(&op1);
+  manager_->UnregisterOp(&op2);
+}
+
 // Test adding operations and make sure that the history of recently completed operations
 // is correct in that it wraps around and doesn't grow.
 TEST_F(MaintenanceManagerTest, TestCompletedOpsHistory) {
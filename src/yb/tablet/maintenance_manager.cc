@@ -34,6 +34,7 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
@@ -62,13 +63,21 @@ TAG_FLAG(maintenance_manager_num_threads, stable);
 
 DEFINE_int32(maintenance_manager_polling_interval_ms, 250,
        "Polling interval for the maintenance manager scheduler, "
-       "in milliseconds.");
+       "in milliseconds. The scheduler also runs as soon as an op completes or is registered.");
 TAG_FLAG(maintenance_manager_polling_interval_ms, hidden);
 
 DEFINE_int32(maintenance_manager_history_size, 8,
        "Number of completed operations the manager is keeping track of.");
 TAG_FLAG(maintenance_manager_history_size, hidden);
 
+DEFINE_int64(maintenance_manager_disk_io_budget_bytes, 256 * 1024 * 1024,
+       "Maximum number of bytes that the maintenance ops running at once may read and write on "
+       "a single device, by their own estimates. A HIGH_IO_USAGE op without an estimate takes "
+       "the whole budget. An op is always allowed on a device that has nothing running. "
+       "0 disables the limit.");
+TAG_FLAG(maintenance_manager_disk_io_budget_bytes, advanced);
+TAG_FLAG(maintenance_manager_disk_io_budget_bytes, runtime);
+
 DEFINE_bool(enable_maintenance_manager, true,
        "Enable the maintenance manager, runs compaction and tablet cleaning tasks.");
 TAG_FLAG(enable_maintenance_manager, unsafe);
@@ -89,6 +98,7 @@ void MaintenanceOpStats::Clear() {
   ram_anchored_ = 0;
   logs_retained_bytes_ = 0;
   perf_improvement_ = 0;
+  estimated_io_bytes_ = 0;
 }
 
 MaintenanceOp::MaintenanceOp(std::string name, IOUsage io_usage)
@@ -116,6 +126,7 @@ MaintenanceManager::MaintenanceManager(const Options& options)
       FLAGS_maintenance_manager_num_threads : options.num_threads),
     cond_(&lock_),
     shutdown_(false),
+    wake_pending_(false),
     running_ops_(0),
     polling_interval_ms_(options.polling_interval_ms <= 0 ?
           FLAGS_maintenance_manager_polling_interval_ms :
@@ -170,6 +181,17 @@ void MaintenanceManager::RegisterOp(MaintenanceOp* op) {
   op->manager_ = shared_from_this();
   op->cond_.reset(new ConditionVariable(&lock_));
   VLOG_AND_TRACE("maintenance", 1) << "Registered " << op->name();
+  WakeUnlocked();
+}
+
+void MaintenanceManager::Wake() {
+  std::lock_guard<Mutex> guard(lock_);
+  WakeUnlocked();
+}
+
+void MaintenanceManager::WakeUnlocked() {
+  wake_pending_ = true;
+  cond_.Signal();
 }
 
 void MaintenanceManager::UnregisterOp(MaintenanceOp* op) {
@@ -204,9 +226,15 @@ void MaintenanceManager::RunSchedulerThread() {
   MonoDelta polling_interval = MonoDelta::FromMilliseconds(polling_interval_ms_);
 
   std::unique_lock<Mutex> guard(lock_);
+  bool launched = false;
   while (true) {
-    // Loop until we are shutting down or it is time to run another op.
-    cond_.TimedWait(polling_interval);
+    // Loop until we are shutting down or it is time to run another op. After launching an op, or
+    // when woken up, look again right away, since another op may be able to run now.
+    if (!launched && !wake_pending_) {
+      cond_.TimedWait(polling_interval);
+    }
+    wake_pending_ = false;
+    launched = false;
     if (shutdown_) {
       VLOG_AND_TRACE("maintenance", 1) << "Shutting down maintenance manager.";
       return;
@@ -219,6 +247,8 @@ void MaintenanceManager::RunSchedulerThread() {
       continue;
     }
 
+    const uint64_t io_bytes = IOCost(*op, ops_[op]);
+
     // Prepare the maintenance operation.
     op->running_++;
     running_ops_++;
@@ -229,16 +259,41 @@ void MaintenanceManager::RunSchedulerThread() {
       LOG(INFO) << "Prepare failed for " << op->name()
                 << ".  Re-running scheduler.";
       op->running_--;
+      running_ops_--;
       op->cond_->Signal();
       continue;
     }
 
     // Run the maintenance operation.
-    Status s = thread_pool_->SubmitFunc(std::bind(&MaintenanceManager::LaunchOp, this, op));
+    running_io_bytes_[op->io_device()] += io_bytes;
+    Status s = thread_pool_->SubmitFunc(
+        std::bind(&MaintenanceManager::LaunchOp, this, op, io_bytes));
     CHECK(s.ok());
+    launched = true;
   }
 }
 
+uint64_t MaintenanceManager::IOCost(const MaintenanceOp& op,
+                                    const MaintenanceOpStats& stats) const {
+  if (stats.estimated_io_bytes() > 0 || op.io_usage() == MaintenanceOp::LOW_IO_USAGE) {
+    return stats.estimated_io_bytes();
+  }
+  return std::max<int64_t>(FLAGS_maintenance_manager_disk_io_budget_bytes, 1);
+}
+
+bool MaintenanceManager::FitsIOBudget(const MaintenanceOp& op,
+                                      const MaintenanceOpStats& stats) const {
+  const int64_t budget = FLAGS_maintenance_manager_disk_io_budget_bytes;
+  if (budget <= 0) {
+    return true;
+  }
+  auto it = running_io_bytes_.find(op.io_device());
+  if (it == running_io_bytes_.end() || it->second == 0) {
+    return true;
+  }
+  return it->second + IOCost(op, stats) <= static_cast<uint64_t>(budget);
+}
+
 // Finding the best operation goes through four filters:
 // - If there's an Op that we can run quickly that frees log retention, we run it.
 // - If we've hit the overall process memory limit (note: this includes memory that the Ops cannot
@@ -291,6 +346,11 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
     if (!stats.valid() || !stats.runnable()) {
       continue;
     }
+    if (!FitsIOBudget(*op, stats)) {
+      VLOG_AND_TRACE("maintenance", 2) << "Not running " << op->name() << ", because the ops "
+                                       << "already running use the IO budget of its device";
+      continue;
+    }
     if (stats.logs_retained_bytes() > low_io_most_logs_retained_bytes &&
         op->io_usage_ == MaintenanceOp::LOW_IO_USAGE) {
       low_io_most_logs_retained_bytes_op = op;
@@ -366,7 +426,7 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
   return nullptr;
 }
 
-void MaintenanceManager::LaunchOp(MaintenanceOp* op) {
+void MaintenanceManager::LaunchOp(MaintenanceOp* op, uint64_t io_bytes) {
   MonoTime start_time(MonoTime::Now());
   op->RunningGauge()->Increment();
   LOG_TIMING(INFO, Substitute("running $0", op->name())) {
@@ -388,8 +448,10 @@ void MaintenanceManager::LaunchOp(MaintenanceOp* op) {
   op->DurationHistogram()->Increment(delta.ToMilliseconds());
 
   running_ops_--;
+  running_io_bytes_[op->io_device()] -= io_bytes;
   op->running_--;
   op->cond_->Signal();
+  WakeUnlocked();
 }
 
 void MaintenanceManager::GetMaintenanceManagerStatusDump(MaintenanceManagerStatusPB* out_pb) {
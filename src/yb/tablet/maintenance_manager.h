@@ -105,6 +105,16 @@ class MaintenanceOpStats {
     perf_improvement_ = perf_improvement;
   }
 
+  uint64_t estimated_io_bytes() const {
+    DCHECK(valid_);
+    return estimated_io_bytes_;
+  }
+
+  void set_estimated_io_bytes(uint64_t estimated_io_bytes) {
+    UpdateLastModified();
+    estimated_io_bytes_ = estimated_io_bytes;
+  }
+
   const MonoTime& last_modified() const {
     DCHECK(valid_);
     return last_modified_;
@@ -139,6 +149,10 @@ class MaintenanceOpStats {
   // absolute scale (yet TBD).
   double perf_improvement_;
 
+  // The approximate number of bytes the op reads and writes on its device. May be 0, in which case
+  // a HIGH_IO_USAGE op is assumed to use the whole IO budget of the device.
+  uint64_t estimated_io_bytes_;
+
   // The last time that the stats were modified.
   MonoTime last_modified_;
 };
@@ -187,6 +201,10 @@ class MaintenanceOp {
   // Returns the gauge for this op that tracks when this op is running. Cannot be NULL.
   virtual scoped_refptr<AtomicGauge<uint32_t> > RunningGauge() const = 0;
 
+  // Returns the device, e.g. the data directory, that the op does its IO on. Ops on the same device
+  // share its IO budget. The default puts all ops on a single device.
+  virtual std::string io_device() const { return std::string(); }
+
   uint32_t running() { return running_; }
 
   std::string name() const { return name_; }
@@ -258,10 +276,14 @@ class MaintenanceManager : public std::enable_shared_from_this<MaintenanceManage
 
   void GetMaintenanceManagerStatusDump(tablet::MaintenanceManagerStatusPB* out_pb);
 
+  // Makes the scheduler look for an op to run now instead of at the next polling interval.
+  void Wake();
+
   static const Options DEFAULT_OPTIONS;
 
  private:
   FRIEND_TEST(MaintenanceManagerTest, TestLogRetentionPrioritization);
+  FRIEND_TEST(MaintenanceManagerTest, TestIOBudget);
   typedef std::map<MaintenanceOp*, MaintenanceOpStats,
           MaintenanceOpComparator> OpMapTy;
 
@@ -270,7 +292,16 @@ class MaintenanceManager : public std::enable_shared_from_this<MaintenanceManage
   // find the best op, or null if there is nothing we want to run
   MaintenanceOp* FindBestOp();
 
-  void LaunchOp(MaintenanceOp* op);
+  void LaunchOp(MaintenanceOp* op, uint64_t io_bytes);
+
+  // Returns the number of bytes of its device's IO budget that running the op takes.
+  uint64_t IOCost(const MaintenanceOp& op, const MaintenanceOpStats& stats) const;
+
+  // Returns true if the op can run without exceeding the IO budget of its device. An op is always
+  // allowed on a device that has nothing running, so that ops larger than the budget still run.
+  bool FitsIOBudget(const MaintenanceOp& op, const MaintenanceOpStats& stats) const;
+
+  void WakeUnlocked();
 
   const int32_t num_threads_;
   OpMapTy ops_; // registered operations
@@ -279,7 +310,11 @@ class MaintenanceManager : public std::enable_shared_from_this<MaintenanceManage
   gscoped_ptr<ThreadPool> thread_pool_;
   ConditionVariable cond_;
   bool shutdown_;
+  // Set when something happened that may allow another op to run, e.g. an op completed.
+  bool wake_pending_;
   uint64_t running_ops_;
+  // Bytes of IO budget taken by the running ops, by device.
+  std::map<std::string, uint64_t> running_io_bytes_;
   int32_t polling_interval_ms_;
   // Vector used as a circular buffer for recently completed ops. Elements need to be added at
   // the completed_ops_count_ % the vector's size and then the count needs to be incremented.
@@ -30,6 +30,9 @@
 // under the License.
 //
 
+#include <atomic>
+#include <thread>
+
 #include <gtest/gtest.h>
 #include <glog/logging.h>
 
@@ -195,5 +198,59 @@ TEST_F(MvccTest, Random) {
   LOG(INFO) << "Passed: " << yb::ToString(end - start);
 }
 
+// Measures throughput of concurrent readers and a writer, and checks that readers never get a
+// safe time that is not below the time of an operation added afterwards.
+TEST_F(MvccTest, ConcurrentReadersAndWriter) {
+  constexpr int kReaders = 4;
+  const auto kDuration = std::chrono::seconds(2);
+
+  std::atomic<bool> stop(false);
+  std::atomic<uint64_t> reads(0);
+  std::atomic<uint64_t> writes(0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i != kReaders; ++i) {
+    threads.emplace_back([this, &stop, &reads] {
+      uint64_t local_reads = 0;
+      while (!stop.load(std::memory_order_acquire)) {
+        auto safe_time = manager_.SafeTimestampToRead(HybridTime::kMax);
+        // Safe time is either below a tracked operation or taken from the clock.
+        ASSERT_LE(safe_time, clock_->Now());
+        ++local_reads;
+      }
+      reads += local_reads;
+    });
+  }
+  threads.emplace_back([this, &stop, &writes] {
+    std::deque<HybridTime> pending;
+    uint64_t local_writes = 0;
+    while (!stop.load(std::memory_order_acquire)) {
+      HybridTime ht;
+      // AddPending crashes if safe time returned to a reader is not below the new operation.
+      manager_.AddPending(&ht);
+      pending.push_back(ht);
+      if (pending.size() > 2) {
+        manager_.Replicated(pending.front());
+        pending.pop_front();
+      }
+      ++local_writes;
+    }
+    for (auto ht : pending) {
+      manager_.Replicated(ht);
+    }
+    writes += local_writes;
+  });
+
+  std::this_thread::sleep_for(kDuration);
+  stop.store(true, std::memory_order_release);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  const double seconds = std::chrono::duration<double>(kDuration).count();
+  LOG(INFO) << "Reads/sec: " << reads / seconds << ", writes/sec: " << writes / seconds;
+  ASSERT_GT(reads, 0);
+  ASSERT_GT(writes, 0);
+}
+
 } // namespace tablet
 } // namespace yb
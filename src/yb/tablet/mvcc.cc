@@ -32,12 +32,40 @@
 
 #include "yb/tablet/mvcc.h"
 
+#include <boost/optional.hpp>
+
 #include "yb/util/debug-util.h"
 #include "yb/util/logging.h"
 
 namespace yb {
 namespace tablet {
 
+namespace {
+
+// Number of times a reader tries to compute safe time without taking the mutex.
+constexpr int kMaxLockFreeReadAttempts = 16;
+
+}  // namespace
+
+// Marks modification of the published state. Should be created while holding the mutex.
+class MvccManager::WriteScope {
+ public:
+  explicit WriteScope(std::atomic<uint64_t>* sequence)
+      : sequence_(sequence), value_(sequence->load(std::memory_order_relaxed)) {
+    DCHECK_EQ(value_ & 1, 0);
+    sequence_->store(value_ + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  ~WriteScope() {
+    sequence_->store(value_ + 2, std::memory_order_release);
+  }
+
+ private:
+  std::atomic<uint64_t>* sequence_;
+  uint64_t value_;
+};
+
 MvccManager::MvccManager(std::string prefix, server::ClockPtr clock)
     : prefix_(std::move(prefix)), clock_(std::move(clock)) {}
 
@@ -47,8 +75,9 @@ void MvccManager::Replicated(HybridTime ht) {
   std::lock_guard<std::mutex> lock(mutex_);
   CHECK(!queue_.empty());
   CHECK_EQ(queue_.front(), ht);
+  WriteScope write_scope(&sequence_);
   PopFront(&lock);
-  last_replicated_ = ht;
+  last_replicated_.store(ht.ToUint64(), std::memory_order_relaxed);
 }
 
 void MvccManager::Aborted(HybridTime ht) {
@@ -57,6 +86,7 @@ void MvccManager::Aborted(HybridTime ht) {
   std::lock_guard<std::mutex> lock(mutex_);
   CHECK(!queue_.empty());
   if (queue_.front() == ht) {
+    WriteScope write_scope(&sequence_);
     PopFront(&lock);
   } else {
     aborted_.push(ht);
@@ -74,10 +104,19 @@ void MvccManager::PopFront(std::lock_guard<std::mutex>* lock) {
     queue_.pop_front();
     aborted_.pop();
   }
+  queue_front_.store(queue_.empty() ? kInvalidHybridTimeValue : queue_.front().ToUint64(),
+                     std::memory_order_relaxed);
 }
 
 void MvccManager::AddPending(HybridTime* ht) {
   std::lock_guard<std::mutex> lock(mutex_);
+  // Adding an operation only changes the result of SafeTimestampToRead when there are no tracked
+  // operations. In that case readers use the clock, so the time is assigned inside the write scope,
+  // otherwise a reader could pick a time after the one assigned here.
+  boost::optional<WriteScope> write_scope;
+  if (queue_.empty()) {
+    write_scope.emplace(&sequence_);
+  }
   if (!ht->is_valid()) {
     // ... otherwise this is a new transaction and we must assign a new hybrid_time. We assign
     // one in the present.
@@ -86,36 +125,67 @@ void MvccManager::AddPending(HybridTime* ht) {
   } else {
     VLOG_WITH_PREFIX(1) << "AddPending(" << *ht << ")";
   }
-  CHECK_GT(*ht, max_safe_time_returned_);
+  CHECK_GT(*ht, HybridTime(max_safe_time_returned_.load(std::memory_order_acquire)));
   if (!queue_.empty()) {
     CHECK_GT(*ht, queue_.back());
   }
-  CHECK_GT(*ht, last_replicated_);
+  CHECK_GT(*ht, HybridTime(last_replicated_.load(std::memory_order_relaxed)));
   queue_.push_back(*ht);
+  if (write_scope) {
+    queue_front_.store(ht->ToUint64(), std::memory_order_relaxed);
+  }
 }
 
 void MvccManager::SetLastReplicated(HybridTime ht) {
   VLOG_WITH_PREFIX(1) << "SetLastReplicated(" << ht << ")";
 
   std::lock_guard<std::mutex> lock(mutex_);
-  last_replicated_ = ht;
+  WriteScope write_scope(&sequence_);
+  last_replicated_.store(ht.ToUint64(), std::memory_order_relaxed);
 }
 
-HybridTime MvccManager::SafeTimestampToRead(HybridTime limit) const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  HybridTime result = !queue_.empty() ? queue_.front().Decremented() : clock_->Now();
+HybridTime MvccManager::DoSafeTimestampToRead(HybridTime limit) const {
+  HybridTime queue_front(queue_front_.load(std::memory_order_relaxed));
+  HybridTime result = queue_front.is_valid() ? queue_front.Decremented() : clock_->Now();
   result = std::min(result, limit);
-  result = std::max(result, last_replicated_); // Suitable to replica
-  CHECK_GE(result, max_safe_time_returned_);
-  max_safe_time_returned_ = result;
+  // Suitable to replica
+  return std::max(result, HybridTime(last_replicated_.load(std::memory_order_relaxed)));
+}
+
+HybridTime MvccManager::SafeTimestampToRead(HybridTime limit) const {
+  HybridTime result;
+  bool consistent = false;
+  for (int attempt = 0; attempt != kMaxLockFreeReadAttempts; ++attempt) {
+    auto sequence = sequence_.load(std::memory_order_acquire);
+    if (sequence & 1) {
+      continue;
+    }
+    result = DoSafeTimestampToRead(limit);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence_.load(std::memory_order_relaxed) == sequence) {
+      consistent = true;
+      break;
+    }
+  }
+  if (!consistent) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    result = DoSafeTimestampToRead(limit);
+  }
+
+  // Concurrent readers could finish in any order, so we only keep the maximal returned time.
+  auto max_safe_time_returned = max_safe_time_returned_.load(std::memory_order_acquire);
+  while (result.ToUint64() > max_safe_time_returned &&
+         !max_safe_time_returned_.compare_exchange_weak(max_safe_time_returned, result.ToUint64(),
+                                                        std::memory_order_acq_rel)) {
+  }
   VLOG_WITH_PREFIX(1) << "GetMaxSafeTimeToReadAt(), result = " << result;
   return result;
 }
 
 HybridTime MvccManager::LastReplicatedHybridTime() const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  VLOG_WITH_PREFIX(1) << "LastReplicatedHybridTime(), result = " << last_replicated_;
-  return last_replicated_;
+  HybridTime result(last_replicated_.load(std::memory_order_acquire));
+  VLOG_WITH_PREFIX(1) << "LastReplicatedHybridTime(), result = " << result;
+  return result;
 }
 
 }  // namespace tablet
@@ -32,6 +32,7 @@
 #ifndef YB_TABLET_MVCC_H_
 #define YB_TABLET_MVCC_H_
 
+#include <atomic>
 #include <mutex>
 #include <deque>
 #include <queue>
@@ -48,6 +49,10 @@ namespace tablet {
 // methods.
 // Operations could be replicated only in the same order as they were added.
 // Time of newly added operation should be after time of all previously added operations.
+//
+// Writers are serialized by a mutex, while readers do not take it: writers publish the state
+// required to compute safe time in atomics, and a sequence counter lets readers detect that a
+// writer modified this state while they were computing the result.
 class MvccManager {
  public:
   // `prefix` is used for logging.
@@ -79,19 +84,34 @@ class MvccManager {
   HybridTime LastReplicatedHybridTime() const;
 
  private:
+  class WriteScope;
+
   const std::string& LogPrefix() const { return prefix_; }
   void PopFront(std::lock_guard<std::mutex>* lock);
 
+  // Computes safe time from the published state, without updating max_safe_time_returned_.
+  HybridTime DoSafeTimestampToRead(HybridTime limit) const;
+
   std::string prefix_;
   server::ClockPtr clock_;
+  // Serializes writers. Readers only take it when they fail to get a consistent snapshot of the
+  // published state too many times in a row.
   mutable std::mutex mutex_;
+  // Incremented before and after each modification of the published state, so it is odd while a
+  // writer is modifying it.
+  std::atomic<uint64_t> sequence_{0};
   // Queue of times of tracked operations. It is ordered.
   std::deque<HybridTime> queue_;
   // Priority queue of aborted operations. Required because we could abort operations from the
   // middle of the queue.
   std::priority_queue<HybridTime, std::vector<HybridTime>, std::greater<>> aborted_;
-  HybridTime last_replicated_ = HybridTime::kMin;
-  mutable HybridTime max_safe_time_returned_ = HybridTime::kMin;
+
+  // Published state. The time of the first tracked operation, or invalid hybrid time if there are
+  // no tracked operations, and the time of the last replicated operation.
+  std::atomic<HybridTimeRepr> queue_front_{kInvalidHybridTimeValue};
+  std::atomic<HybridTimeRepr> last_replicated_{kMinHybridTimeValue};
+
+  mutable std::atomic<HybridTimeRepr> max_safe_time_returned_{kMinHybridTimeValue};
 };
 
 }  // namespace tablet
@@ -0,0 +1,75 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/operations/ingest_sst_files_operation.h"
+
+#include <glog/logging.h>
+
+#include "yb/server/hybrid_clock.h"
+#include "yb/tablet/tablet.h"
+#include "yb/tserver/tserver.pb.h"
+#include "yb/util/trace.h"
+
+namespace yb {
+namespace tablet {
+
+using consensus::ReplicateMsg;
+using consensus::INGEST_SST_FILES_OP;
+using consensus::DriverType;
+using strings::Substitute;
+
+string IngestSSTFilesOperationState::ToString() const {
+  return Format("IngestSSTFilesOperationState [hybrid_time=$0, files=$1]",
+                hybrid_time_even_if_unset(),
+                request_ != nullptr ? request_->file_paths_size() : 0);
+}
+
+IngestSSTFilesOperation::IngestSSTFilesOperation(
+    std::unique_ptr<IngestSSTFilesOperationState> state, DriverType type)
+    : Operation(std::move(state), type, Operation::INGEST_SST_FILES_TXN) {
+}
+
+consensus::ReplicateMsgPtr IngestSSTFilesOperation::NewReplicateMsg() {
+  auto result = std::make_shared<ReplicateMsg>();
+  result->set_op_type(INGEST_SST_FILES_OP);
+  result->mutable_ingest_sst_files_request()->CopyFrom(*state()->request());
+  return result;
+}
+
+void IngestSSTFilesOperation::Start() {
+  state()->TrySetHybridTimeFromClock();
+
+  TRACE("START INGEST SST FILES: hybrid time: $0",
+        server::HybridClock::GetPhysicalValueMicros(state()->hybrid_time()));
+}
+
+Status IngestSSTFilesOperation::Apply() {
+  TRACE("APPLY INGEST SST FILES: started");
+
+  Status s = state()->tablet()->IngestSSTFiles(state());
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to ingest SST files for tablet " << state()->tablet()->tablet_id()
+                 << ": " << s;
+    state()->completion_callback()->set_error(s);
+  }
+
+  TRACE("APPLY INGEST SST FILES: finished");
+  return Status::OK();
+}
+
+string IngestSSTFilesOperation::ToString() const {
+  return Substitute("IngestSSTFilesOperation [state=$0]", state()->ToString());
+}
+
+}  // namespace tablet
+}  // namespace yb
@@ -0,0 +1,84 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_OPERATIONS_INGEST_SST_FILES_OPERATION_H
+#define YB_TABLET_OPERATIONS_INGEST_SST_FILES_OPERATION_H
+
+#include <string>
+
+#include "yb/gutil/macros.h"
+#include "yb/tablet/operations/operation.h"
+
+namespace yb {
+namespace tablet {
+
+// Operation Context for the IngestSSTFiles operation.
+// Keeps track of the Operation states (request, result, ...)
+class IngestSSTFilesOperationState : public OperationState {
+ public:
+  explicit IngestSSTFilesOperationState(Tablet* tablet,
+                                        const tserver::IngestSSTFilesRequestPB* request = nullptr)
+      : OperationState(tablet), request_(request) {}
+  ~IngestSSTFilesOperationState() {}
+
+  const tserver::IngestSSTFilesRequestPB* request() const override { return request_; }
+
+  void UpdateRequestFromConsensusRound() override {
+    request_ = consensus_round()->replicate_msg()->mutable_ingest_sst_files_request();
+  }
+
+  virtual std::string ToString() const override;
+
+ private:
+  // The original RPC request.
+  const tserver::IngestSSTFilesRequestPB *request_;
+
+  DISALLOW_COPY_AND_ASSIGN(IngestSSTFilesOperationState);
+};
+
+// Links the SST files of the request into the RocksDB of the tablet. Only the file paths go
+// through Raft, the data itself is never written to the WAL.
+class IngestSSTFilesOperation : public Operation {
+ public:
+  IngestSSTFilesOperation(std::unique_ptr<IngestSSTFilesOperationState> operation_state,
+                          consensus::DriverType type);
+
+  IngestSSTFilesOperationState* state() override {
+    return down_cast<IngestSSTFilesOperationState*>(Operation::state());
+  }
+
+  const IngestSSTFilesOperationState* state() const override {
+    return down_cast<const IngestSSTFilesOperationState*>(Operation::state());
+  }
+
+  consensus::ReplicateMsgPtr NewReplicateMsg() override;
+
+  virtual CHECKED_STATUS Prepare() override { return Status::OK(); }
+
+  // Starts the IngestSSTFilesOperation by assigning it a timestamp.
+  virtual void Start() override;
+
+  // Ingests the files. A file that can't be ingested, e.g. because it is missing on this replica
+  // or overlaps the existing data, fails the operation for the client, but not the replica.
+  virtual CHECKED_STATUS Apply() override;
+
+  virtual std::string ToString() const override;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(IngestSSTFilesOperation);
+};
+
+}  // namespace tablet
+}  // namespace yb
+
+#endif  // YB_TABLET_OPERATIONS_INGEST_SST_FILES_OPERATION_H
@@ -33,6 +33,7 @@
 #ifndef YB_TABLET_OPERATIONS_OPERATION_H
 #define YB_TABLET_OPERATIONS_OPERATION_H
 
+#include <functional>
 #include <mutex>
 #include <string>
 
@@ -67,6 +68,7 @@ class Operation {
     UPDATE_TRANSACTION_TXN,
     SNAPSHOT_TXN,
     TRUNCATE_TXN,
+    INGEST_SST_FILES_TXN,
 
     kOperationTypes // Must be the last one (number of types above).
   };
@@ -117,6 +119,13 @@ class Operation {
   // method where data-structures are changed.
   virtual CHECKED_STATUS Apply() = 0;
 
+  // Applies the transaction as part of the batch of committed operations that the tablet is
+  // applying on the current thread, if it supports that. `applied` is invoked once the changes
+  // are written, instead of the PreCommit() and Finish() steps that normally follow Apply().
+  // Returns false if the transaction must be applied with Apply().
+  // Default implementation does not support batching.
+  virtual bool ApplyBatched(std::function<void()> applied) { return false; }
+
   // Executed after Apply() but before the commit is submitted to consensus.
   // Some transactions use this to perform pre-commit actions (e.g. write
   // transactions perform early lock release on this hook).
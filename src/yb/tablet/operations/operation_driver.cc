@@ -81,6 +81,7 @@ OperationDriver::OperationDriver(OperationTracker *operation_tracker,
       table_type_(table_type) {
   if (Trace::CurrentTrace()) {
     Trace::CurrentTrace()->AddChildTrace(trace_.get());
+    trace_->set_trace_id(Trace::CurrentTrace()->trace_id());
   }
 }
 
@@ -300,6 +301,10 @@ void OperationDriver::HandleFailure(const Status& s) {
 }
 
 void OperationDriver::ReplicationFinished(const Status& status) {
+  if (PREDICT_FALSE(trace_->sampled())) {
+    RecordTraceStage("tablet.operation_replication", MonoTime::Now() - start_time_);
+  }
+
   consensus::OpId op_id_local;
   {
     std::lock_guard<simple_spinlock> op_id_lock(opid_lock_);
@@ -400,6 +405,19 @@ void OperationDriver::ApplyTask() {
   scoped_refptr<OperationDriver> ref(this);
 
   {
+    // Writes of a batch of committed operations are coalesced, the operation is committed once
+    // the batch is written.
+    if (operation_->ApplyBatched([ref] {
+          ref->operation_->PreCommit();
+          ref->Finalize();
+        })) {
+      return;
+    }
+
+    Tablet* tablet = operation_->state()->tablet();
+    if (tablet != nullptr) {
+      tablet->PrepareApplyOutsideBatch();
+    }
     CHECK_OK(operation_->Apply());
 
     operation_->PreCommit();
@@ -414,6 +432,9 @@ void OperationDriver::Finalize() {
   // object while we still hold the lock.
   scoped_refptr<OperationDriver> ref(this);
   std::lock_guard<simple_spinlock> lock(lock_);
+  if (PREDICT_FALSE(trace_->sampled())) {
+    RecordTraceStage("tablet.operation_total", MonoTime::Now() - start_time_);
+  }
   operation_->Finish(Operation::COMMITTED);
   mutable_state()->completion_callback()->OperationCompleted();
   operation_tracker_->Release(this);
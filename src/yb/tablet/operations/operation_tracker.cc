@@ -79,6 +79,10 @@ METRIC_DEFINE_gauge_uint64(tablet, truncate_operations_inflight,
                            "Truncate Operations In Flight",
                            yb::MetricUnit::kOperations,
                            "Number of truncate operations currently in-flight");
+METRIC_DEFINE_gauge_uint64(tablet, ingest_sst_files_operations_inflight,
+                           "Ingest SST Files Operations In Flight",
+                           yb::MetricUnit::kOperations,
+                           "Number of ingest SST files operations currently in-flight");
 
 METRIC_DEFINE_counter(tablet, operation_memory_pressure_rejections,
                       "Operation Memory Pressure Rejections",
@@ -109,7 +113,9 @@ OperationTracker::Metrics::Metrics(const scoped_refptr<MetricEntity>& entity)
       METRIC_snapshot_operations_inflight.Instantiate(entity, 0);
   operations_inflight[Operation::TRUNCATE_TXN] =
       METRIC_truncate_operations_inflight.Instantiate(entity, 0);
-  static_assert(5 == Operation::kOperationTypes, "Init metrics for all operation types");
+  operations_inflight[Operation::INGEST_SST_FILES_TXN] =
+      METRIC_ingest_sst_files_operations_inflight.Instantiate(entity, 0);
+  static_assert(6 == Operation::kOperationTypes, "Init metrics for all operation types");
 }
 #undef GINIT
 #undef MINIT
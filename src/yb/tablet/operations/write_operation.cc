@@ -112,6 +112,19 @@ Status WriteOperation::Apply() {
   return Status::OK();
 }
 
+bool WriteOperation::ApplyBatched(std::function<void()> applied) {
+  if (PREDICT_FALSE(
+          ANNOTATE_UNPROTECTED_READ(FLAGS_tablet_inject_latency_on_apply_write_txn_ms) > 0)) {
+    return false;
+  }
+
+  if (!tablet()->AddToApplyBatch(state(), std::move(applied))) {
+    return false;
+  }
+  TRACE("APPLY: Added to apply batch");
+  return true;
+}
+
 void WriteOperation::PreCommit() {
   TRACE_EVENT0("txn", "WriteOperation::PreCommit");
   TRACE("PRECOMMIT: Releasing row and schema locks");
@@ -133,6 +133,16 @@ class WriteOperationState : public OperationState {
     return &ql_write_ops_;
   }
 
+  // The deadline of the client request, after which the leader drops the write instead of
+  // executing it. MonoTime::Max() if there is none.
+  MonoTime deadline() const {
+    return deadline_;
+  }
+
+  void set_deadline(MonoTime deadline) {
+    deadline_ = deadline;
+  }
+
   // Moves the given lock batch into this object so it can be unlocked when the operation is
   // complete.
   void ReplaceDocDBLocks(LockBatch&& docdb_locks) {
@@ -171,6 +181,8 @@ class WriteOperationState : public OperationState {
   // or if an error happens.
   LockBatch docdb_locks_;
 
+  MonoTime deadline_ = MonoTime::Max();
+
   DISALLOW_COPY_AND_ASSIGN(WriteOperationState);
 };
 
@@ -218,6 +230,9 @@ class WriteOperation : public Operation {
   // algorithm.
   CHECKED_STATUS Apply() override;
 
+  // Adds the writes to the tablet's apply batch, if it has one on the current thread.
+  bool ApplyBatched(std::function<void()> applied) override;
+
   // Releases the row locks (Early Lock Release).
   void PreCommit() override;
 
@@ -11,6 +11,7 @@
 // under the License.
 //
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <mutex>
@@ -24,9 +25,32 @@
 #include "yb/util/logging.h"
 #include "yb/tablet/prepare_thread.h"
 #include "yb/tablet/operations/operation_driver.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/metrics.h"
+#include "yb/util/trace.h"
 
 DEFINE_int32(max_group_replicate_batch_size, 16,
-             "Maximum number of operations to submit to consensus for replication in a batch.");
+             "Maximum number of operations to submit to consensus for replication in a batch "
+             "while the prepare queue is not backed up.");
+
+DEFINE_int32(max_adaptive_group_replicate_batch_size, 256,
+             "While the prepare queue stays backed up, the maximum number of operations in a "
+             "replication batch doubles with each full batch, up to this many. It halves back "
+             "towards max_group_replicate_batch_size when the queue drains or replicating a "
+             "batch exceeds group_replicate_batch_target_latency_us.");
+TAG_FLAG(max_adaptive_group_replicate_batch_size, advanced);
+TAG_FLAG(max_adaptive_group_replicate_batch_size, runtime);
+
+DEFINE_int32(max_group_replicate_batch_bytes, 1024 * 1024,
+             "A replication batch is submitted once its operations add up to this many bytes.");
+TAG_FLAG(max_group_replicate_batch_bytes, advanced);
+TAG_FLAG(max_group_replicate_batch_bytes, runtime);
+
+DEFINE_int32(group_replicate_batch_target_latency_us, 2000,
+             "Replication batches are not grown while submitting a batch to consensus takes "
+             "longer than this.");
+TAG_FLAG(group_replicate_batch_target_latency_us, advanced);
+TAG_FLAG(group_replicate_batch_target_latency_us, runtime);
 
 // We have to make the queue length really long. Otherwise we risk crashes on followers when they
 // fail to append entries to the queue, as we try to cancel the operation in that case, and it
@@ -39,6 +63,18 @@ DEFINE_int32(max_group_replicate_batch_size, 16,
 DEFINE_int32(prepare_queue_max_size, 100000,
              "Maximum number of operations waiting in the per-tablet prepare queue.");
 
+METRIC_DEFINE_histogram(tablet, group_replicate_batch_size,
+                        "Group Replicate Batch Size",
+                        yb::MetricUnit::kOperations,
+                        "Number of operations submitted to consensus for replication in a batch.",
+                        10000, 2);
+
+METRIC_DEFINE_histogram(tablet, group_replicate_batch_bytes,
+                        "Group Replicate Batch Bytes",
+                        yb::MetricUnit::kBytes,
+                        "Size of the operations submitted to consensus for replication in a batch.",
+                        1024 * 1024 * 1024, 2);
+
 using std::vector;
 
 namespace yb {
@@ -49,7 +85,8 @@ namespace tablet {
 
 class PrepareThreadImpl {
  public:
-  explicit PrepareThreadImpl(consensus::Consensus* consensus);
+  PrepareThreadImpl(consensus::Consensus* consensus,
+                    const scoped_refptr<MetricEntity>& metric_entity);
   ~PrepareThreadImpl();
   CHECKED_STATUS Start();
   void Stop();
@@ -74,6 +111,9 @@ class PrepareThreadImpl {
 
   boost::lockfree::queue<OperationDriver*> queue_;
 
+  // The number of operations in queue_, used to grow the batches while it is backed up.
+  std::atomic<int64_t> queue_size_{0};
+
   std::mutex mtx_;
   std::condition_variable cond_;
 
@@ -88,6 +128,20 @@ class PrepareThreadImpl {
 
   OperationDrivers leader_side_batch_;
 
+  // The total size of the replicate messages of leader_side_batch_.
+  int64_t leader_side_batch_bytes_ = 0;
+
+  // The current maximum number of operations in leader_side_batch_, between
+  // max_group_replicate_batch_size and max_adaptive_group_replicate_batch_size. Only used by the
+  // prepare thread.
+  int max_batch_size_;
+
+  // The latency of the last Consensus::ReplicateBatch call.
+  MonoDelta last_replicate_latency_ = MonoDelta::FromMicroseconds(0);
+
+  scoped_refptr<Histogram> batch_size_histogram_;
+  scoped_refptr<Histogram> batch_bytes_histogram_;
+
   // A temporary buffer of rounds to replicate, used to reduce reallocation.
   consensus::ConsensusRounds rounds_to_replicate_;
 
@@ -99,6 +153,10 @@ class PrepareThreadImpl {
   void Run();
   void ProcessItem(OperationDriver* item);
 
+  // Grows max_batch_size_ when a full batch is submitted while more operations are queued and
+  // consensus keeps up, shrinks it otherwise.
+  void AdaptMaxBatchSize(bool full_batch);
+
   // @return true if at least one item was processed.
   // @param lock This unique_lock of mtx_ is provided so that we can release it if we need to submit
   //        a batch for replication. The reason is that ReplicateBatch acquires the Raft
@@ -115,9 +173,15 @@ class PrepareThreadImpl {
                          std::unique_lock<std::mutex>* lock);
 };
 
-PrepareThreadImpl::PrepareThreadImpl(consensus::Consensus* consensus)
+PrepareThreadImpl::PrepareThreadImpl(consensus::Consensus* consensus,
+                                     const scoped_refptr<MetricEntity>& metric_entity)
     : consensus_(consensus),
-      queue_(FLAGS_prepare_queue_max_size) {
+      queue_(FLAGS_prepare_queue_max_size),
+      max_batch_size_(FLAGS_max_group_replicate_batch_size) {
+  if (metric_entity) {
+    batch_size_histogram_ = METRIC_group_replicate_batch_size.Instantiate(metric_entity);
+    batch_bytes_histogram_ = METRIC_group_replicate_batch_bytes.Instantiate(metric_entity);
+  }
 }
 
 PrepareThreadImpl::~PrepareThreadImpl() {
@@ -159,7 +223,9 @@ Status PrepareThreadImpl::Submit(OperationDriver* operation_driver) {
   if (stop_requested_.load(std::memory_order_acquire)) {
     return STATUS(IllegalState, "Prepare thread is shutting down");
   }
+  queue_size_.fetch_add(1, std::memory_order_relaxed);
   if (!queue_.bounded_push(operation_driver)) {
+    queue_size_.fetch_sub(1, std::memory_order_relaxed);
     return STATUS_FORMAT(ServiceUnavailable,
                          "Prepare queue is full (max capacity $0)",
                          FLAGS_prepare_queue_max_size);
@@ -219,7 +285,12 @@ void PrepareThreadImpl::Run() {
           //
           // Also, if we no longer own the lock as a result of ProcessAndClearLeaderSideBatch()
           // having released it, we can't block now so we'll loop around.
-          if ((!ProcessAndClearLeaderSideBatch(&lock) || can_block()) && lock.owns_lock()) {
+          // The queue has drained, so the batches do not need to be as large.
+          const bool processed = ProcessAndClearLeaderSideBatch(&lock);
+          if (processed) {
+            AdaptMaxBatchSize(false /* full_batch */);
+          }
+          if ((!processed || can_block()) && lock.owns_lock()) {
             cond_.wait(lock, [this] { return processing_.load(std::memory_order_acquire); });
           }
         }
@@ -229,6 +300,7 @@ void PrepareThreadImpl::Run() {
     for (;;) {
       OperationDriver* item = nullptr;
       while (queue_.pop(item)) {
+        queue_size_.fetch_sub(1, std::memory_order_relaxed);
         ProcessItem(item);
       }
       processing_.store(false, std::memory_order_release);
@@ -250,18 +322,23 @@ void PrepareThreadImpl::ProcessItem(OperationDriver* item) {
     // AlterSchemaOperation in a batch of its own.
     const bool is_alter = item->operation_type() == Operation::ALTER_SCHEMA_TXN;
 
-    // Don't add more than the max number of operations to a batch, and also don't add
-    // operations bound to different terms, so as not to fail unrelated operations
-    // unnecessarily in case of a bound term mismatch.
-    if (leader_side_batch_.size() >= FLAGS_max_group_replicate_batch_size ||
-        !leader_side_batch_.empty() &&
+    // Don't add operations bound to different terms to a batch, so as not to fail unrelated
+    // operations unnecessarily in case of a bound term mismatch.
+    if (!leader_side_batch_.empty() &&
             bound_term != leader_side_batch_.back()->consensus_round()->bound_term() ||
         is_alter) {
       ProcessAndClearLeaderSideBatch();
     }
     leader_side_batch_.push_back(item);
-    if (is_alter) {
+    leader_side_batch_bytes_ += item->consensus_round()->replicate_msg()->ByteSize();
+
+    // Don't add more than the max number of operations or bytes to a batch.
+    const bool full_batch =
+        leader_side_batch_.size() >= static_cast<size_t>(max_batch_size_) ||
+        leader_side_batch_bytes_ >= GetAtomicFlag(&FLAGS_max_group_replicate_batch_bytes);
+    if (full_batch || is_alter) {
       ProcessAndClearLeaderSideBatch();
+      AdaptMaxBatchSize(full_batch);
     }
   } else {
     // We found a non-leader-side operation. We need to process the accumulated batch of
@@ -278,6 +355,10 @@ bool PrepareThreadImpl::ProcessAndClearLeaderSideBatch(std::unique_lock<std::mut
   }
 
   VLOG(1) << "Preparing a batch of " << leader_side_batch_.size() << " leader-side operations";
+  if (batch_size_histogram_) {
+    batch_size_histogram_->Increment(leader_side_batch_.size());
+    batch_bytes_histogram_->Increment(leader_side_batch_bytes_);
+  }
 
   auto iter = leader_side_batch_.begin();
   auto replication_subbatch_begin = iter;
@@ -309,9 +390,26 @@ bool PrepareThreadImpl::ProcessAndClearLeaderSideBatch(std::unique_lock<std::mut
   ReplicateSubBatch(replication_subbatch_begin, replication_subbatch_end, lock);
 
   leader_side_batch_.clear();
+  leader_side_batch_bytes_ = 0;
   return true;
 }
 
+void PrepareThreadImpl::AdaptMaxBatchSize(bool full_batch) {
+  const int min_size = std::max(FLAGS_max_group_replicate_batch_size, 1);
+  const int max_size = std::max(GetAtomicFlag(&FLAGS_max_adaptive_group_replicate_batch_size),
+                                min_size);
+  const bool consensus_keeps_up =
+      last_replicate_latency_.ToMicroseconds() <=
+          GetAtomicFlag(&FLAGS_group_replicate_batch_target_latency_us);
+  if (full_batch && consensus_keeps_up && queue_size_.load(std::memory_order_relaxed) > 0) {
+    max_batch_size_ = std::min(max_batch_size_ * 2, max_size);
+  } else {
+    max_batch_size_ = std::max(max_batch_size_ / 2, min_size);
+  }
+  // Apply the flags if they changed.
+  max_batch_size_ = std::min(std::max(max_batch_size_, min_size), max_size);
+}
+
 void PrepareThreadImpl::ReplicateSubBatch(
     OperationDrivers::iterator batch_begin,
     OperationDrivers::iterator batch_end,
@@ -340,7 +438,16 @@ void PrepareThreadImpl::ReplicateSubBatch(
   if (lock && lock->owns_lock()) {
     lock->unlock();
   }
+
+  // All operations of the sub-batch are appended to the log together, so the log append latency is
+  // attributed to the first sampled operation of the sub-batch, if any.
+  auto sampled = std::find_if(batch_begin, batch_end, [](OperationDriver* driver) {
+    return driver->trace()->sampled();
+  });
+  ADOPT_TRACE(sampled != batch_end ? (*sampled)->trace() : nullptr);
+  const MonoTime start = MonoTime::Now();
   const Status s = consensus_->ReplicateBatch(rounds_to_replicate_);
+  last_replicate_latency_ = MonoTime::Now().GetDeltaSince(start);
   rounds_to_replicate_.clear();
 
   if (PREDICT_FALSE(!s.ok())) {
@@ -358,8 +465,9 @@ void PrepareThreadImpl::ReplicateSubBatch(
 // ------------------------------------------------------------------------------------------------
 // PrepareThread
 
-PrepareThread::PrepareThread(consensus::Consensus* consensus)
-    : impl_(std::make_unique<PrepareThreadImpl>(consensus)) {
+PrepareThread::PrepareThread(consensus::Consensus* consensus,
+                             const scoped_refptr<MetricEntity>& metric_entity)
+    : impl_(std::make_unique<PrepareThreadImpl>(consensus, metric_entity)) {
 }
 
 PrepareThread::~PrepareThread() = default;
@@ -16,6 +16,7 @@
 
 #include <gflags/gflags.h>
 
+#include "yb/gutil/ref_counted.h"
 #include "yb/util/status.h"
 
 DECLARE_int32(max_group_replicate_batch_size);
@@ -23,6 +24,8 @@ DECLARE_int32(prepare_queue_max_size);
 
 namespace yb {
 
+class MetricEntity;
+
 namespace consensus {
 class Consensus;
 }
@@ -38,7 +41,9 @@ class PrepareThreadImpl;
 // useful because we have a "fat lock" in the consensus.
 class PrepareThread {
  public:
-  explicit PrepareThread(consensus::Consensus* consensus);
+  // metric_entity may be null, then the batch size histograms are not exported.
+  PrepareThread(consensus::Consensus* consensus,
+                const scoped_refptr<MetricEntity>& metric_entity);
   ~PrepareThread();
 
   CHECKED_STATUS Start();
@@ -32,6 +32,10 @@
 
 #include <time.h>
 
+#include <set>
+
+#include <boost/algorithm/string/predicate.hpp>
+
 #include <glog/logging.h>
 
 #include "yb/common/iterator.h"
@@ -42,6 +46,8 @@
 #include "yb/tablet/local_tablet_writer.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet-test-base.h"
+#include "yb/tablet/operations/truncate_operation.h"
+#include "yb/util/path_util.h"
 #include "yb/util/slice.h"
 #include "yb/util/test_macros.h"
 
@@ -202,5 +208,140 @@ TYPED_TEST(TestTablet, TestMetricsInit) {
   ASSERT_OK(registry->WriteAsJson(&new_writer, { "*" }, MetricJsonOptions()));
 }
 
+// Test that the checkpoints left by remote bootstrap sessions are deleted when the tablet is opened.
+TYPED_TEST(TestTablet, TestStaleCheckpointsDeletedOnOpen) {
+  LocalTabletWriter writer(this->tablet().get());
+  ASSERT_OK(this->InsertTestRow(&writer, 0, 0));
+
+  const string checkpoints_dir = JoinPathSegments(this->tablet()->metadata()->rocksdb_dir(),
+                                                  kCheckpointsDirName);
+  ASSERT_OK(this->fs_manager()->CreateDirIfMissing(checkpoints_dir));
+  ASSERT_OK(this->tablet()->CreateCheckpoint(JoinPathSegments(checkpoints_dir, "session"),
+                                             nullptr /* rocksdb_files */));
+  ASSERT_TRUE(this->fs_manager()->env()->FileExists(checkpoints_dir));
+
+  this->TabletReOpen();
+  ASSERT_FALSE(this->fs_manager()->env()->FileExists(checkpoints_dir));
+
+  // The row was flushed by the checkpoint.
+  vector<string> rows;
+  ASSERT_OK(this->IterateToStringList(&rows));
+  ASSERT_EQ(1, rows.size());
+}
+
+// Test that truncate starts an empty database right away and deletes the old one in the background.
+TYPED_TEST(TestTablet, TestTruncate) {
+  LocalTabletWriter writer(this->tablet().get());
+  for (int32_t i = 0; i < 10; i++) {
+    ASSERT_OK(this->InsertTestRow(&writer, i, 0));
+  }
+  ASSERT_OK(this->tablet()->Flush(FlushMode::kSync));
+
+  TruncateOperationState state(this->tablet().get());
+  state.mutable_op_id()->set_term(1);
+  state.mutable_op_id()->set_index(1);
+  ASSERT_OK(this->tablet()->Truncate(&state));
+
+  vector<string> rows;
+  ASSERT_OK(this->IterateToStringList(&rows));
+  ASSERT_EQ(0, rows.size());
+
+  const string table_dir = DirName(this->tablet()->metadata()->rocksdb_dir());
+  ASSERT_OK(WaitFor([this, &table_dir]() -> Result<bool> {
+    vector<string> children;
+    RETURN_NOT_OK(this->fs_manager()->env()->GetChildren(table_dir, &children));
+    for (const auto& child : children) {
+      if (child.find(".destroyed.") != string::npos) {
+        return false;
+      }
+    }
+    return true;
+  }, MonoDelta::FromSeconds(30), "Delete the truncated database"));
+
+  ASSERT_OK(this->InsertTestRow(&writer, 0, 1));
+  ASSERT_OK(this->IterateToStringList(&rows));
+  ASSERT_EQ(1, rows.size());
+}
+
+// Test that an incremental checkpoint only needs the SST files written since the base checkpoint.
+TYPED_TEST(TestTablet, TestExcludeBaseCheckpointFiles) {
+  LocalTabletWriter writer(this->tablet().get());
+  const string checkpoints_dir = JoinPathSegments(this->tablet()->metadata()->rocksdb_dir(),
+                                                  kCheckpointsDirName);
+  ASSERT_OK(this->fs_manager()->CreateDirIfMissing(checkpoints_dir));
+
+  google::protobuf::RepeatedPtrField<RocksDBFilePB> base_files;
+  ASSERT_OK(this->InsertTestRow(&writer, 0, 0));
+  ASSERT_OK(this->tablet()->CreateCheckpoint(JoinPathSegments(checkpoints_dir, "base"),
+                                             &base_files));
+
+  google::protobuf::RepeatedPtrField<RocksDBFilePB> files;
+  ASSERT_OK(this->InsertTestRow(&writer, 1, 0));
+  ASSERT_OK(this->tablet()->CreateCheckpoint(JoinPathSegments(checkpoints_dir, "incremental"),
+                                             &files));
+  const int num_files = files.size();
+
+  Tablet::ExcludeBaseCheckpointFiles(base_files, &files);
+  ASSERT_LT(files.size(), num_files);
+
+  std::set<string> base_names;
+  for (const auto& file : base_files) {
+    base_names.insert(file.name());
+  }
+  bool has_new_sst = false;
+  for (const auto& file : files) {
+    if (boost::ends_with(file.name(), ".sst")) {
+      ASSERT_EQ(0, base_names.count(file.name())) << file.name();
+      has_new_sst = true;
+    }
+  }
+  // The second row was flushed to a new SST file by the second checkpoint.
+  ASSERT_TRUE(has_new_sst);
+}
+
+// Test that a frozen tablet keeps serving its rows, rejects writes and stays frozen on restart.
+TYPED_TEST(TestTablet, TestFreeze) {
+  {
+    LocalTabletWriter writer(this->tablet().get());
+    for (int32_t i = 0; i < 10; i++) {
+      ASSERT_OK(this->InsertTestRow(&writer, i, 0));
+    }
+    ASSERT_OK(this->tablet()->Flush(FlushMode::kSync));
+    ASSERT_OK(this->UpdateTestRow(&writer, 0, 1));
+  }
+
+  ASSERT_OK(this->tablet()->Freeze());
+  ASSERT_TRUE(this->tablet()->frozen());
+
+  vector<string> rows;
+  ASSERT_OK(this->IterateToStringList(&rows));
+  ASSERT_EQ(10, rows.size());
+  ASSERT_EQ(this->setup_.FormatDebugRow(0, 1, false), rows[0]);
+
+  {
+    LocalTabletWriter writer(this->tablet().get());
+    ASSERT_TRUE(this->InsertTestRow(&writer, 10, 0).IsIllegalState());
+  }
+
+  // Checkpoints for remote bootstrap work on the read only DB.
+  const string checkpoints_dir = JoinPathSegments(this->tablet()->metadata()->rocksdb_dir(),
+                                                  kCheckpointsDirName);
+  ASSERT_OK(this->fs_manager()->CreateDirIfMissing(checkpoints_dir));
+  ASSERT_OK(this->tablet()->CreateCheckpoint(JoinPathSegments(checkpoints_dir, "frozen"),
+                                             nullptr /* rocksdb_files */));
+
+  this->TabletReOpen();
+  ASSERT_TRUE(this->tablet()->frozen());
+  ASSERT_OK(this->IterateToStringList(&rows));
+  ASSERT_EQ(10, rows.size());
+
+  ASSERT_OK(this->tablet()->Thaw());
+  ASSERT_FALSE(this->tablet()->frozen());
+  LocalTabletWriter writer(this->tablet().get());
+  ASSERT_OK(this->InsertTestRow(&writer, 10, 0));
+  ASSERT_OK(this->IterateToStringList(&rows));
+  ASSERT_EQ(11, rows.size());
+}
+
 } // namespace tablet
 } // namespace yb
@@ -38,12 +38,16 @@
 #include <memory>
 #include <mutex>
 #include <ostream>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/optional.hpp>
 #include <boost/scope_exit.hpp>
 
+#include "yb/rocksdb/convenience.h"
 #include "yb/rocksdb/db.h"
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/statistics.h"
@@ -62,12 +66,14 @@
 #include "yb/consensus/opid_util.h"
 
 #include "yb/docdb/conflict_resolution.h"
+#include "yb/docdb/doc_key.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/docdb.h"
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/docdb_compaction_filter.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/intent_filter.h"
 #include "yb/docdb/primitive_value.h"
 #include "yb/docdb/lock_batch.h"
 
@@ -87,9 +93,11 @@
 #include "yb/tablet/transaction_coordinator.h"
 #include "yb/tablet/transaction_participant.h"
 #include "yb/tablet/operations/alter_schema_operation.h"
+#include "yb/tablet/operations/ingest_sst_files_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/write_operation.h"
 #include "yb/tablet/tablet_options.h"
+#include "yb/util/atomic.h"
 #include "yb/util/bloom_filter.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/enums.h"
@@ -121,6 +129,33 @@ DEFINE_double(tablet_bloom_target_fp_rate, 0.01f,
               "required for bloom filters.");
 TAG_FLAG(tablet_bloom_target_fp_rate, advanced);
 
+DEFINE_bool(tablet_separate_intents_db, false,
+            "Whether new transactional tablets keep the intents of transactions in a separate "
+            "RocksDB instance, so that the regular records are not interleaved with intents and "
+            "applied intents are not rewritten by the regular compactions. Tablets that already "
+            "have data keep the intents with the regular records.");
+TAG_FLAG(tablet_separate_intents_db, advanced);
+
+DEFINE_int32(max_coalesced_write_operations, 64,
+             "Maximum number of committed non-transactional write operations whose changes are "
+             "applied to RocksDB with one write, 1 means that every operation is written "
+             "separately.");
+TAG_FLAG(max_coalesced_write_operations, advanced);
+TAG_FLAG(max_coalesced_write_operations, runtime);
+
+DEFINE_int64(redis_row_cache_size_bytes, 0,
+             "Capacity of the cache of decoded documents of every non-transactional Redis tablet, "
+             "which serves the point reads of hot keys before RocksDB. 0 disables the cache.");
+TAG_FLAG(redis_row_cache_size_bytes, advanced);
+
+DEFINE_int32(tablet_intent_filter_num_counters, 256 * 1024,
+             "Number of one byte counters of the filter of live intent keys of every transactional "
+             "tablet, which lets conflict resolution skip the seek of the intents for the keys "
+             "without them. 0 disables the filter.");
+TAG_FLAG(tablet_intent_filter_num_counters, advanced);
+
+DECLARE_bool(flush_rocksdb_on_shutdown);
+
 METRIC_DEFINE_entity(tablet);
 
 using namespace std::placeholders;
@@ -362,6 +397,7 @@ Tablet::Tablet(
     });
 
     metrics_.reset(new TabletMetrics(metric_entity_));
+    shared_lock_manager_.SetLockWaitsCounter(metrics_->write_lock_waits);
   }
 
   if (transaction_participant_context) {
@@ -391,6 +427,9 @@ Status Tablet::Open() {
   CHECK_EQ(state_, kInitialized) << "already open";
   CHECK(schema()->has_column_ids());
 
+  // Truncates and deletions interrupted by a restart could leave destroyed databases behind.
+  docdb::DestroyLeftoverDBsInBackground(metadata()->rocksdb_dir());
+
   switch (table_type_) {
     case TableType::YQL_TABLE_TYPE: FALLTHROUGH_INTENDED;
     case TableType::REDIS_TABLE_TYPE:
@@ -405,14 +444,55 @@ Status Tablet::Open() {
   return Status::OK();
 }
 
+namespace {
+
+// Forwards the flush events of one of the RocksDB instances of a tablet.
+class TabletFlushListener : public rocksdb::EventListener {
+ public:
+  TabletFlushListener(std::function<void()> on_flush_scheduled,
+                      std::function<void()> on_flush_completed)
+      : on_flush_scheduled_(std::move(on_flush_scheduled)),
+        on_flush_completed_(std::move(on_flush_completed)) {}
+
+  void OnFlushScheduled(rocksdb::DB* db) override {
+    if (on_flush_scheduled_) {
+      on_flush_scheduled_();
+    }
+  }
+
+  void OnFlushCompleted(rocksdb::DB* db, const rocksdb::FlushJobInfo& info) override {
+    if (on_flush_completed_) {
+      on_flush_completed_();
+    }
+  }
+
+ private:
+  const std::function<void()> on_flush_scheduled_;
+  const std::function<void()> on_flush_completed_;
+};
+
+} // namespace
+
 Status Tablet::OpenKeyValueTablet() {
   rocksdb::Options rocksdb_options;
   docdb::InitRocksDBOptions(&rocksdb_options, tablet_id(), rocksdb_statistics_, tablet_options_);
+  // Intents are removed explicitly when transactions are applied, so the intents DB does not need
+  // the history cleanup.
+  rocksdb::Options intents_options = rocksdb_options;
 
   // Install the history cleanup handler. Note that TabletRetentionPolicy is going to hold a raw ptr
   // to this tablet. So, we ensure that rocksdb_ is reset before this tablet gets destroyed.
+  retention_policy_ = make_shared<TabletRetentionPolicy>(this);
   rocksdb_options.compaction_filter_factory = make_shared<DocDBCompactionFilterFactory>(
-      make_shared<TabletRetentionPolicy>(this));
+      retention_policy_);
+  if (table_type_ == TableType::REDIS_TABLE_TYPE) {
+    docdb::InitPointLookupRocksDBOptions(&rocksdb_options);
+  }
+  if (transaction_participant_) {
+    // Retries the flushes of the intents DB that had to wait for the regular records.
+    rocksdb_options.listeners.push_back(std::make_shared<TabletFlushListener>(
+        nullptr /* on_flush_scheduled */, std::bind(&Tablet::RegularDBFlushed, this)));
+  }
 
   const string db_dir = metadata()->rocksdb_dir();
   LOG(INFO) << "Creating RocksDB database in dir " << db_dir;
@@ -426,9 +506,27 @@ Status Tablet::OpenKeyValueTablet() {
                         Substitute("Failed to create RocksDB tablet directory $0",
                                    db_dir));
 
-  LOG(INFO) << "Opening RocksDB at: " << db_dir;
+  // Remote bootstrap sessions don't survive a restart, so their checkpoints are only taking space.
+  const string checkpoints_dir = JoinPathSegments(db_dir, kCheckpointsDirName);
+  if (metadata()->fs_manager()->env()->FileExists(checkpoints_dir)) {
+    LOG(INFO) << "Deleting stale remote bootstrap checkpoints in " << checkpoints_dir;
+    RETURN_NOT_OK_PREPEND(metadata()->fs_manager()->env()->DeleteRecursively(checkpoints_dir),
+                          Substitute("Failed to delete checkpoints directory $0",
+                                     checkpoints_dir));
+  }
+
   rocksdb::DB* db = nullptr;
-  rocksdb::Status rocksdb_open_status = rocksdb::DB::Open(rocksdb_options, db_dir, &db);
+  rocksdb::Status rocksdb_open_status;
+  if (metadata()->frozen()) {
+    // The compacted DB mode, which reads straight from the single sorted run, keeps all the table
+    // readers open.
+    LOG(INFO) << "Opening frozen RocksDB at: " << db_dir;
+    rocksdb_options.max_open_files = -1;
+    rocksdb_open_status = rocksdb::DB::OpenForReadOnly(rocksdb_options, db_dir, &db);
+  } else {
+    LOG(INFO) << "Opening RocksDB at: " << db_dir;
+    rocksdb_open_status = rocksdb::DB::Open(rocksdb_options, db_dir, &db);
+  }
   if (!rocksdb_open_status.ok()) {
     LOG(ERROR) << "Failed to open a RocksDB database in directory " << db_dir << ": "
                << rocksdb_open_status.ToString();
@@ -439,13 +537,160 @@ Status Tablet::OpenKeyValueTablet() {
   }
   rocksdb_.reset(db);
   ql_storage_.reset(new docdb::QLRocksDBStorage(rocksdb_.get()));
-  if (transaction_participant_) {
-    transaction_participant_->SetDB(db);
+  // The documents cached for the previous DB are dropped with the cache. The cache does not know
+  // the transactions, so it is only used by the tablets without them.
+  row_cache_.reset();
+  if (table_type_ == TableType::REDIS_TABLE_TYPE && !transaction_participant_ &&
+      FLAGS_redis_row_cache_size_bytes > 0) {
+    row_cache_ = std::make_unique<docdb::DocRowCache>(FLAGS_redis_row_cache_size_bytes);
   }
   LOG(INFO) << "Successfully opened a RocksDB database at " << db_dir;
+
+  RETURN_NOT_OK(OpenIntentsDB(&intents_options));
+  RETURN_NOT_OK(LoadIntentFilter());
+  if (transaction_participant_) {
+    transaction_participant_->SetDB(intents_db(), this);
+  }
+  return Status::OK();
+}
+
+Status Tablet::OpenIntentsDB(rocksdb::Options* options) {
+  if (!transaction_participant_) {
+    return Status::OK();
+  }
+
+  const string db_dir = metadata()->intents_rocksdb_dir();
+  if (!metadata()->fs_manager()->env()->FileExists(db_dir)) {
+    if (!FLAGS_tablet_separate_intents_db) {
+      return Status::OK();
+    }
+    // Existing intents can't be moved, so a tablet with data keeps them with the regular records.
+    std::vector<rocksdb::LiveFileMetaData> live_files_metadata;
+    rocksdb_->GetLiveFilesMetaData(&live_files_metadata);
+    if (!live_files_metadata.empty()) {
+      return Status::OK();
+    }
+  }
+
+  options->listeners.clear();
+  options->listeners.push_back(std::make_shared<TabletFlushListener>(
+      [this] { intents_flush_scheduled_.store(true, std::memory_order_release); },
+      nullptr /* on_flush_completed */));
+  options->mem_table_flush_filter = std::bind(&Tablet::IntentsFlushAllowed, this, _1);
+
+  LOG(INFO) << "Opening intents RocksDB at: " << db_dir;
+  rocksdb::DB* db = nullptr;
+  rocksdb::Status rocksdb_open_status = rocksdb::DB::Open(*options, db_dir, &db);
+  if (!rocksdb_open_status.ok()) {
+    LOG(ERROR) << "Failed to open a RocksDB database in directory " << db_dir << ": "
+               << rocksdb_open_status.ToString();
+    if (db != nullptr) {
+      delete db;
+    }
+    return STATUS(IllegalState, rocksdb_open_status.ToString());
+  }
+  intents_db_.reset(db);
+  LOG(INFO) << "Successfully opened the intents RocksDB database at " << db_dir;
   return Status::OK();
 }
 
+Status Tablet::LoadIntentFilter() {
+  if (!transaction_participant_ || FLAGS_tablet_intent_filter_num_counters <= 0) {
+    return Status::OK();
+  }
+  // The filter is reused by a reopened DB, so the conflict resolution never sees it replaced.
+  if (intent_filter_) {
+    intent_filter_->Clear();
+  } else {
+    intent_filter_ = std::make_unique<docdb::IntentFilter>(
+        FLAGS_tablet_intent_filter_num_counters);
+  }
+  return docdb::AddStoredIntentsToFilter(intents_db(), intent_filter_.get());
+}
+
+void Tablet::RemoveFromIntentFilter(const std::vector<std::string>& intent_paths) {
+  if (!intent_filter_) {
+    return;
+  }
+  for (const auto& intent_path : intent_paths) {
+    intent_filter_->Remove(intent_path);
+  }
+}
+
+void Tablet::CloseRocksDBs() {
+  if (intents_db_) {
+    // Flushes of the intents DB may have to wait for the regular records, and they are retried by
+    // the flush listener of the regular DB. So the regular records are flushed, and all background
+    // work of the regular DB is finished before the intents DB is closed.
+    if (FLAGS_flush_rocksdb_on_shutdown) {
+      rocksdb_->Flush(rocksdb::FlushOptions());
+    }
+    rocksdb::CancelAllBackgroundWork(rocksdb_.get(), true /* wait */);
+    intents_db_ = nullptr;
+  }
+  rocksdb_ = nullptr;
+}
+
+bool Tablet::IntentsFlushAllowed(const rocksdb::OpId& last_op_id) {
+  // Removal of the intents of an applied transaction must not be persisted before its regular
+  // records, otherwise the apply could not be replayed after a restart.
+  const auto regular_flushed_op_id = rocksdb_->GetFlushedOpId();
+  std::lock_guard<std::mutex> lock(unflushed_applies_mutex_);
+  while (!unflushed_applies_.empty() &&
+         unflushed_applies_.front() <= regular_flushed_op_id.index) {
+    unflushed_applies_.pop_front();
+  }
+  return unflushed_applies_.empty() || unflushed_applies_.front() > last_op_id.index;
+}
+
+void Tablet::FlushRegularDBForIntents() {
+  uint64_t num_immutable_mem_tables = 0;
+  intents_db_->GetIntProperty(
+      rocksdb::DB::Properties::kNumImmutableMemTable, &num_immutable_mem_tables);
+  if (num_immutable_mem_tables == 0) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(unflushed_applies_mutex_);
+    if (unflushed_applies_.empty()) {
+      return;
+    }
+  }
+  // Only called from the write path, so this never waits for the writes to the regular DB.
+  rocksdb::FlushOptions options;
+  options.wait = false;
+  rocksdb_->Flush(options);
+}
+
+void Tablet::RegularDBFlushed() {
+  rocksdb::FlushOptions options;
+  options.wait = false;
+  options.switch_memtable = false;
+  intents_db_->Flush(options);
+
+  // When all intents are flushed, the flushed op id of the intents DB is advanced to the one of
+  // the regular DB, so an idle intents DB does not hold the log back. Writes of applied
+  // transactions are skipped, as they can't be flushed yet anyway.
+  std::unique_lock<std::mutex> lock(apply_intents_mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    return;
+  }
+  uint64_t num_active_entries = 0;
+  uint64_t num_immutable_mem_tables = 0;
+  intents_db_->GetIntProperty(
+      rocksdb::DB::Properties::kNumEntriesActiveMemTable, &num_active_entries);
+  intents_db_->GetIntProperty(
+      rocksdb::DB::Properties::kNumImmutableMemTable, &num_immutable_mem_tables);
+  if (num_active_entries != 0 || num_immutable_mem_tables != 0) {
+    return;
+  }
+  const auto regular_flushed_op_id = rocksdb_->GetFlushedOpId();
+  if (regular_flushed_op_id.index > intents_db_->GetFlushedOpId().index) {
+    WARN_NOT_OK(intents_db_->SetFlushedOpId(regular_flushed_op_id),
+                "Failed to set flushed op id of the intents DB");
+  }
+}
+
 void Tablet::MarkFinishedBootstrapping() {
   CHECK_EQ(state_, kBootstrapping);
   state_ = kOpen;
@@ -458,6 +703,10 @@ void Tablet::SetShutdownRequestedFlag() {
 void Tablet::Shutdown() {
   SetShutdownRequestedFlag();
 
+  if (transaction_participant_) {
+    transaction_participant_->StopBackgroundApply();
+  }
+
   auto op_pause = PauseReadWriteOperations();
   if (!op_pause.ok()) {
     LOG(WARNING) << Substitute("Tablet $0: failed to shut down", tablet_id());
@@ -469,8 +718,8 @@ void Tablet::Shutdown() {
   }
 
   std::lock_guard<rw_spinlock> lock(component_lock_);
-  // Shutdown the RocksDB instance for this table, if present.
-  rocksdb_.reset();
+  // Shutdown the RocksDB instances for this table, if present.
+  CloseRocksDBs();
   state_ = kShutdown;
 }
 
@@ -512,18 +761,94 @@ void Tablet::StartOperation(WriteOperationState* operation_state) {
   }
 }
 
+namespace {
+
+const KeyValueWriteBatchPB& WriteBatchOf(WriteOperationState* operation_state) {
+  return operation_state->consensus_round() && operation_state->consensus_round()->replicate_msg()
+      // Online case.
+      ? operation_state->consensus_round()->replicate_msg()->write_request().write_batch()
+      // Bootstrap case.
+      : operation_state->request()->write_batch();
+}
+
+} // namespace
+
 void Tablet::ApplyRowOperations(WriteOperationState* operation_state) {
   last_committed_write_index_.store(operation_state->op_id().index(), std::memory_order_release);
-  const KeyValueWriteBatchPB& put_batch =
-      operation_state->consensus_round() && operation_state->consensus_round()->replicate_msg()
-          // Online case.
-          ? operation_state->consensus_round()->replicate_msg()->write_request().write_batch()
-          // Bootstrap case.
-          : operation_state->request()->write_batch();
-
-  ApplyKeyValueRowOperations(put_batch,
+  ApplyKeyValueRowOperations(WriteBatchOf(operation_state),
                              operation_state->op_id(),
                              operation_state->hybrid_time());
+  last_applied_write_index_.store(operation_state->op_id().index(), std::memory_order_release);
+}
+
+void Tablet::StartApplyBatch() {
+  apply_batch_mutex_.lock();
+  apply_batch_thread_.store(std::this_thread::get_id(), std::memory_order_release);
+}
+
+void Tablet::FinishApplyBatch() {
+  DCHECK_EQ(apply_batch_thread_.load(std::memory_order_acquire), std::this_thread::get_id());
+  WriteApplyBatch();
+  apply_batch_thread_.store(std::thread::id(), std::memory_order_release);
+  apply_batch_mutex_.unlock();
+}
+
+bool Tablet::AddToApplyBatch(WriteOperationState* operation_state, std::function<void()> applied) {
+  if (apply_batch_thread_.load(std::memory_order_acquire) != std::this_thread::get_id()) {
+    return false;
+  }
+
+  const KeyValueWriteBatchPB& put_batch = WriteBatchOf(operation_state);
+  const size_t max_operations = std::max(GetAtomicFlag(&FLAGS_max_coalesced_write_operations), 1);
+  // Transactional writes go to the intents DB and are not coalesced.
+  if (put_batch.has_transaction() || max_operations == 1) {
+    WriteApplyBatch();
+    return false;
+  }
+
+  last_committed_write_index_.store(operation_state->op_id().index(), std::memory_order_release);
+  // Each operation has its own hybrid time in the keys of its records, and the batch is written
+  // with the op id of its last operation.
+  PrepareNonTransactionWriteBatch(
+      put_batch, operation_state->hybrid_time(), &apply_batch_write_batch_);
+  apply_batch_last_op_id_ = rocksdb::OpId(
+      operation_state->op_id().term(), operation_state->op_id().index());
+  apply_batch_max_hybrid_time_.MakeAtLeast(operation_state->hybrid_time());
+  apply_batch_callbacks_.push_back(std::move(applied));
+
+  if (apply_batch_callbacks_.size() >= max_operations) {
+    WriteApplyBatch();
+  }
+  return true;
+}
+
+void Tablet::PrepareApplyOutsideBatch() {
+  if (apply_batch_thread_.load(std::memory_order_acquire) == std::this_thread::get_id()) {
+    WriteApplyBatch();
+    return;
+  }
+  // Operations committed before this one could still be in the batch of another thread.
+  std::lock_guard<std::mutex> lock(apply_batch_mutex_);
+}
+
+void Tablet::WriteApplyBatch() {
+  if (apply_batch_callbacks_.empty()) {
+    return;
+  }
+
+  if (apply_batch_write_batch_.Count() != 0) {
+    apply_batch_write_batch_.SetUserOpId(apply_batch_last_op_id_);
+    WriteToRocksDB(rocksdb_.get(), apply_batch_max_hybrid_time_, &apply_batch_write_batch_);
+    apply_batch_write_batch_.Clear();
+  }
+  apply_batch_max_hybrid_time_ = HybridTime::kMin;
+
+  // The operations become visible to readers only after they are written.
+  std::vector<std::function<void()>> callbacks;
+  callbacks.swap(apply_batch_callbacks_);
+  for (const auto& callback : callbacks) {
+    callback();
+  }
 }
 
 Status Tablet::CreateCheckpoint(const std::string& dir,
@@ -533,29 +858,40 @@ Status Tablet::CreateCheckpoint(const std::string& dir,
 
   std::lock_guard<std::mutex> lock(create_checkpoint_lock_);
 
-  rocksdb::Status status = rocksdb::checkpoint::CreateCheckpoint(rocksdb_.get(), dir);
+  // The intents are checkpointed first: the checkpoint of the regular records taken after it
+  // contains the records of all transactions whose intents were removed from it.
+  const string intents_dir = dir + ".intents";
+  rocksdb::Status status;
+  if (intents_db_) {
+    status = rocksdb::checkpoint::CreateCheckpoint(intents_db_.get(), intents_dir);
+    if (!status.ok()) {
+      LOG(WARNING) << "Create intents checkpoint status: " << status.ToString();
+      return STATUS(IllegalState, Substitute("Unable to create checkpoint: $0", status.ToString()));
+    }
+  }
+
+  status = rocksdb::checkpoint::CreateCheckpoint(rocksdb_.get(), dir);
 
   if (!status.ok()) {
     LOG(WARNING) << "Create checkpoint status: " << status.ToString();
     return STATUS(IllegalState, Substitute("Unable to create checkpoint: $0", status.ToString()));
   }
-  LOG(INFO) << "Checkpoint created in " << dir;
 
-  if (rocksdb_files != nullptr) {
-    vector<rocksdb::Env::FileAttributes> files_attrs;
-    status = rocksdb_->GetEnv()->GetChildrenFileAttributes(dir, &files_attrs);
+  // The intents DB is nested in the checkpoint directory the same way as in the tablet directory.
+  if (intents_db_) {
+    status = rocksdb_->GetEnv()->RenameFile(intents_dir, JoinPathSegments(dir, kIntentsDBDirName));
     if (!status.ok()) {
-      return STATUS(IllegalState, Substitute("Unable to get RocksDB files in dir $0: $1", dir,
+      return STATUS(IllegalState, Substitute("Unable to move intents checkpoint to $0: $1", dir,
                                              status.ToString()));
     }
+  }
+  LOG(INFO) << "Checkpoint created in " << dir;
 
-    for (const auto& file_attrs : files_attrs) {
-      if (file_attrs.name == "." || file_attrs.name == "..") {
-        continue;
-      }
-      auto rocksdb_file_pb = rocksdb_files->Add();
-      rocksdb_file_pb->set_name(file_attrs.name);
-      rocksdb_file_pb->set_size_bytes(file_attrs.size_bytes);
+  if (rocksdb_files != nullptr) {
+    RETURN_NOT_OK(AddCheckpointFiles(dir, "" /* prefix */, rocksdb_files));
+    if (intents_db_) {
+      RETURN_NOT_OK(AddCheckpointFiles(
+          JoinPathSegments(dir, kIntentsDBDirName), kIntentsDBDirName, rocksdb_files));
     }
   }
 
@@ -564,6 +900,58 @@ Status Tablet::CreateCheckpoint(const std::string& dir,
   return Status::OK();
 }
 
+Status Tablet::AddCheckpointFiles(
+    const std::string& dir, const std::string& prefix,
+    google::protobuf::RepeatedPtrField<RocksDBFilePB>* rocksdb_files) {
+  vector<rocksdb::Env::FileAttributes> files_attrs;
+  rocksdb::Status status = rocksdb_->GetEnv()->GetChildrenFileAttributes(dir, &files_attrs);
+  if (!status.ok()) {
+    return STATUS(IllegalState, Substitute("Unable to get RocksDB files in dir $0: $1", dir,
+                                           status.ToString()));
+  }
+
+  for (const auto& file_attrs : files_attrs) {
+    if (file_attrs.name == "." || file_attrs.name == "..") {
+      continue;
+    }
+    // Files of the nested intents DB are listed separately.
+    if (prefix.empty() && file_attrs.name == kIntentsDBDirName) {
+      continue;
+    }
+    auto rocksdb_file_pb = rocksdb_files->Add();
+    rocksdb_file_pb->set_name(
+        prefix.empty() ? file_attrs.name : JoinPathSegments(prefix, file_attrs.name));
+    rocksdb_file_pb->set_size_bytes(file_attrs.size_bytes);
+  }
+  return Status::OK();
+}
+
+void Tablet::ExcludeBaseCheckpointFiles(
+    const google::protobuf::RepeatedPtrField<RocksDBFilePB>& base_files,
+    google::protobuf::RepeatedPtrField<RocksDBFilePB>* rocksdb_files) {
+  // Only SST files, i.e. "<number>.sst" and their data blocks "<number>.sst.sblock.<n>", are
+  // immutable. MANIFEST, CURRENT, OPTIONS etc. are written anew by every checkpoint.
+  const auto is_immutable = [](const string& name) {
+    return boost::ends_with(name, ".sst") || name.find(".sst.sblock.") != string::npos;
+  };
+
+  std::unordered_map<string, uint64_t> base_sizes;
+  for (const auto& file : base_files) {
+    if (is_immutable(file.name())) {
+      base_sizes.emplace(file.name(), file.size_bytes());
+    }
+  }
+
+  google::protobuf::RepeatedPtrField<RocksDBFilePB> remaining;
+  for (auto& file : *rocksdb_files) {
+    const auto it = base_sizes.find(file.name());
+    if (it == base_sizes.end() || it->second != file.size_bytes()) {
+      remaining.Add()->Swap(&file);
+    }
+  }
+  rocksdb_files->Swap(&remaining);
+}
+
 void Tablet::PrepareTransactionWriteBatch(
     const KeyValueWriteBatchPB& put_batch,
     HybridTime hybrid_time,
@@ -579,7 +967,8 @@ void Tablet::PrepareTransactionWriteBatch(
 
   auto isolation_level = metadata->isolation;
   yb::docdb::PrepareTransactionWriteBatch(
-      put_batch, hybrid_time, rocksdb_write_batch, *transaction_id, isolation_level);
+      put_batch, hybrid_time, rocksdb_write_batch, *transaction_id, isolation_level,
+      intent_filter_.get());
 }
 
 void Tablet::ApplyKeyValueRowOperations(const KeyValueWriteBatchPB& put_batch,
@@ -601,21 +990,36 @@ void Tablet::ApplyKeyValueRowOperations(const KeyValueWriteBatchPB& put_batch,
 
   if (put_batch.has_transaction()) {
     PrepareTransactionWriteBatch(put_batch, hybrid_time, rocksdb_write_batch);
+    // The batch of a transaction only contains intents, reverse index records and transaction
+    // metadata.
+    WriteToRocksDB(intents_db(), hybrid_time, rocksdb_write_batch);
   } else {
     PrepareNonTransactionWriteBatch(put_batch, hybrid_time, rocksdb_write_batch);
+    WriteToRocksDB(rocksdb_.get(), hybrid_time, rocksdb_write_batch);
   }
+}
 
+void Tablet::WriteToRocksDB(
+    rocksdb::DB* db, HybridTime hybrid_time, rocksdb::WriteBatch* rocksdb_write_batch) {
   // We are using Raft replication index for the RocksDB sequence number for
   // all members of this write batch.
   rocksdb::WriteOptions write_options;
   InitRocksDBWriteOptions(&write_options);
 
   flush_stats_->AboutToWriteToDb(hybrid_time);
-  auto rocksdb_write_status = rocksdb_->Write(write_options, rocksdb_write_batch);
+  auto rocksdb_write_status = db->Write(write_options, rocksdb_write_batch);
   if (!rocksdb_write_status.ok()) {
     LOG(FATAL) << "Failed to write a batch with " << rocksdb_write_batch->Count() << " operations"
                << " into RocksDB: " << rocksdb_write_status.ToString();
   }
+  if (row_cache_ && db == rocksdb_.get()) {
+    row_cache_->Invalidate(*rocksdb_write_batch, hybrid_time);
+  }
+
+  if (db == intents_db_.get() &&
+      intents_flush_scheduled_.exchange(false, std::memory_order_acq_rel)) {
+    FlushRegularDBForIntents();
+  }
 }
 
 namespace {
@@ -633,6 +1037,24 @@ void SetupKeyValueBatch(WriteRequestPB* write_request, WriteRequestPB* batch_req
     write_request->mutable_write_batch()->mutable_transaction()->Swap(
         batch_request->mutable_write_batch()->mutable_transaction());
   }
+  if (batch_request->write_batch().single_shard_transaction()) {
+    write_request->mutable_write_batch()->set_single_shard_transaction(true);
+  }
+  if (batch_request->write_batch().parallel_commit()) {
+    write_request->mutable_write_batch()->set_parallel_commit(true);
+  }
+}
+
+// Returns the key under which the load of a QL operation is tracked by TabletHotspots: its hash
+// code and hashed column values, in a human readable form.
+std::string QLHotKey(uint32_t hash_code,
+                     const google::protobuf::RepeatedPtrField<QLExpressionPB>& hashed_values) {
+  std::string result = Format("hash_code: $0", hash_code);
+  for (const auto& value : hashed_values) {
+    result += ", ";
+    result += value.ShortDebugString();
+  }
+  return result;
 }
 
 } // namespace
@@ -648,7 +1070,11 @@ Status Tablet::KeyValueBatchFromRedisWriteBatch(const WriteOperationData& data)
 
   doc_ops.reserve(redis_write_batch->size());
   for (size_t i = 0; i < redis_write_batch->size(); i++) {
-    doc_ops.emplace_back(new RedisWriteOperation(redis_write_batch->Mutable(i)));
+    RedisWriteRequestPB* req = redis_write_batch->Mutable(i);
+    if (hotspots_.RecordWrite(req->ByteSize())) {
+      hotspots_.RecordKey(req->key_value().key());
+    }
+    doc_ops.emplace_back(new RedisWriteOperation(req));
   }
   RETURN_NOT_OK(StartDocWriteOperation(doc_ops, data));
   if (data.restart_read_ht->is_valid()) {
@@ -670,13 +1096,22 @@ Status Tablet::HandleRedisReadRequest(const ReadHybridTime& read_time,
   RETURN_NOT_OK(scoped_read_operation);
 
   ScopedTabletMetricsTracker metrics_tracker(metrics_->redis_read_latency);
+  ScopedTabletReadIOTracker io_tracker(metrics_.get());
 
-  docdb::RedisReadOperation doc_op(redis_read_request, rocksdb_.get(), read_time);
+  docdb::RedisReadOperation doc_op(redis_read_request, rocksdb_.get(), read_time, row_cache_.get());
   RETURN_NOT_OK(doc_op.Execute());
   *response = std::move(doc_op.response());
+  if (hotspots_.RecordRead(response->ByteSize())) {
+    hotspots_.RecordKey(redis_read_request.key_value().key());
+  }
   return Status::OK();
 }
 
+Result<std::shared_ptr<const docdb::QLReadProjections>> Tablet::GetQLReadProjections(
+    const Schema& schema, const QLReferencedColumnsPB& column_refs) {
+  return ql_read_projection_cache_.Get(schema, column_refs);
+}
+
 Status Tablet::HandleQLReadRequest(
     const ReadHybridTime& read_time,
     const QLReadRequestPB& ql_read_request,
@@ -685,6 +1120,7 @@ Status Tablet::HandleQLReadRequest(
   ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
   RETURN_NOT_OK(scoped_read_operation);
   ScopedTabletMetricsTracker metrics_tracker(metrics_->ql_read_latency);
+  ScopedTabletReadIOTracker io_tracker(metrics_.get());
 
   if (metadata()->schema_version() != ql_read_request.schema_version()) {
     result->response.set_status(QLResponsePB::YQL_STATUS_SCHEMA_VERSION_MISMATCH);
@@ -694,8 +1130,15 @@ Status Tablet::HandleQLReadRequest(
   Result<TransactionOperationContextOpt> txn_op_ctx =
       CreateTransactionOperationContext(transaction_metadata);
   RETURN_NOT_OK(txn_op_ctx);
-  return AbstractTablet::HandleQLReadRequest(
-      read_time, ql_read_request, *txn_op_ctx, result);
+  RETURN_NOT_OK(AbstractTablet::HandleQLReadRequest(
+      read_time, ql_read_request, *txn_op_ctx, result));
+  // Full table scans have no key to attribute the load to.
+  if (hotspots_.RecordRead(result->rows_data.size()) &&
+      !ql_read_request.hashed_column_values().empty()) {
+    hotspots_.RecordKey(
+        QLHotKey(ql_read_request.hash_code(), ql_read_request.hashed_column_values()));
+  }
+  return Status::OK();
 }
 
 CHECKED_STATUS Tablet::CreatePagingStateForRead(const QLReadRequestPB& ql_read_request,
@@ -741,6 +1184,9 @@ Status Tablet::KeyValueBatchFromQLWriteBatch(const WriteOperationData& data) {
   RETURN_NOT_OK(txn_op_ctx);
   for (size_t i = 0; i < ql_write_batch->size(); i++) {
     QLWriteRequestPB* req = ql_write_batch->Mutable(i);
+    if (hotspots_.RecordWrite(req->ByteSize())) {
+      hotspots_.RecordKey(QLHotKey(req->hash_code(), req->hashed_column_values()));
+    }
     QLResponsePB* resp = data.operation_state->response()->add_ql_response_batch();
     if (metadata_->schema_version() != req->schema_version()) {
       resp->set_status(QLResponsePB::YQL_STATUS_SCHEMA_VERSION_MISMATCH);
@@ -770,6 +1216,10 @@ Status Tablet::KeyValueBatchFromQLWriteBatch(const WriteOperationData& data) {
 
 Status Tablet::AcquireLocksAndPerformDocOperations(
     WriteOperationState *state, HybridTime* restart_read_ht) {
+  if (PREDICT_FALSE(frozen())) {
+    return STATUS_FORMAT(IllegalState, "Tablet $0 is frozen", tablet_id());
+  }
+
   LockBatch locks_held;
   WriteRequestPB* key_value_write_request = state->mutable_request();
 
@@ -824,12 +1274,27 @@ Status Tablet::FlushUnlocked(FlushMode mode) {
   // the tablet just got shutdown. Acquire a read lock on component_lock_?
   rocksdb::FlushOptions options;
   options.wait = mode == FlushMode::kSync;
+  if (intents_db_) {
+    // The intents are switched out first, so the flush of the regular records below covers all
+    // the transactions applied before, and the intents can be flushed after it.
+    rocksdb::FlushOptions intents_options;
+    intents_options.wait = false;
+    intents_db_->Flush(intents_options);
+  }
   rocksdb_->Flush(options);
+  if (intents_db_ && options.wait) {
+    options.switch_memtable = false;
+    intents_db_->Flush(options);
+  }
   return Status::OK();
 }
 
 Status Tablet::ImportData(const std::string& source_dir) {
-  return rocksdb_->Import(source_dir);
+  const Status status = rocksdb_->Import(source_dir);
+  if (row_cache_) {
+    row_cache_->InvalidateAll();
+  }
+  return status;
 }
 
 #define INTENT_VALUE_SCHECK(lhs, op, rhs, msg) \
@@ -846,29 +1311,126 @@ Status Tablet::ImportData(const std::string& source_dir) {
 // After that we delete both intent record and reverse index record.
 // TODO(dtxn) use separate thread for applying intents.
 // TODO(dtxn) use multiple batches when applying really big transaction.
-Status Tablet::ApplyIntents(const TransactionApplyData& data) {
+Result<bool> Tablet::ApplyIntents(const TransactionApplyData& data, size_t max_intents) {
+  WriteBatch rocksdb_write_batch;
+  WriteBatch separate_intents_write_batch;
+  WriteBatch* intents_write_batch =
+      intents_db_ ? &separate_intents_write_batch : &rocksdb_write_batch;
+
+  // Flushes of the separate intents DB are ordered by op ids of applies, so it is applied at once.
+  if (intents_db_) {
+    max_intents = 0;
+  }
+
+  // Apply of a partially applied transaction could be replayed during bootstrap.
+  auto apply_state = LoadApplyState(data.transaction_id);
+  RETURN_NOT_OK(apply_state);
+  IntraTxnWriteId write_id = *apply_state ? (**apply_state).next_write_id() : 0;
+  std::vector<std::string> intent_paths;
+  auto all_applied = PrepareApplyIntents(
+      data.transaction_id, data.commit_time, max_intents, &write_id, &rocksdb_write_batch,
+      intents_write_batch, intent_filter_ ? &intent_paths : nullptr);
+  RETURN_NOT_OK(all_applied);
+
+  if (!intents_db_) {
+    // data.hybrid_time contains transaction commit time.
+    // We don't set transaction field of put_batch, otherwise we would write another bunch of
+    // intents.
+    ApplyKeyValueRowOperations(
+        KeyValueWriteBatchPB(), data.op_id, data.commit_time, &rocksdb_write_batch);
+    RemoveFromIntentFilter(intent_paths);
+    return all_applied;
+  }
+
+  // The regular records are written before the intents are removed, and the apply is registered
+  // in between, see IntentsFlushAllowed. So the intents DB never persists the removal of intents
+  // whose regular records could be lost, and replaying the apply after a restart finds them.
+  std::lock_guard<std::mutex> lock(apply_intents_mutex_);
+  if (rocksdb_write_batch.Count() != 0) {
+    ApplyKeyValueRowOperations(
+        KeyValueWriteBatchPB(), data.op_id, data.commit_time, &rocksdb_write_batch);
+    std::lock_guard<std::mutex> applies_lock(unflushed_applies_mutex_);
+    unflushed_applies_.push_back(data.op_id.index());
+  }
+  separate_intents_write_batch.SetUserOpId(rocksdb::OpId(data.op_id.term(), data.op_id.index()));
+  WriteToRocksDB(intents_db_.get(), data.commit_time, &separate_intents_write_batch);
+  RemoveFromIntentFilter(intent_paths);
+  return all_applied;
+}
+
+Result<bool> Tablet::ContinueApplyIntents(const TransactionId& id, size_t max_intents) {
+  ScopedPendingOperation scoped_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_operation);
+
+  auto apply_state = LoadApplyState(id);
+  RETURN_NOT_OK(apply_state);
+  if (!*apply_state) {
+    // Remaining intents were applied by a replayed apply.
+    return true;
+  }
+  DCHECK(!intents_db_);
+
+  const HybridTime commit_time((**apply_state).commit_hybrid_time());
+  IntraTxnWriteId write_id = (**apply_state).next_write_id();
+  WriteBatch rocksdb_write_batch;
+  std::vector<std::string> intent_paths;
+  auto all_applied = PrepareApplyIntents(
+      id, commit_time, max_intents, &write_id, &rocksdb_write_batch, &rocksdb_write_batch,
+      intent_filter_ ? &intent_paths : nullptr);
+  RETURN_NOT_OK(all_applied);
+
+  // Chunks are written without an op id: each of them replaces intents with regular records
+  // atomically, and the apply state written by the apply operation tells what is left after a
+  // restart.
+  WriteToRocksDB(rocksdb_.get(), commit_time, &rocksdb_write_batch);
+  RemoveFromIntentFilter(intent_paths);
+  return all_applied;
+}
+
+Result<boost::optional<docdb::TransactionApplyStatePB>> Tablet::LoadApplyState(
+    const TransactionId& id) {
+  KeyBytes key;
+  docdb::AppendTransactionApplyStateKey(id, &key);
+  string value;
+  auto status = intents_db()->Get(rocksdb::ReadOptions(), key.data(), &value);
+  if (status.IsNotFound()) {
+    return boost::optional<docdb::TransactionApplyStatePB>();
+  }
+  RETURN_NOT_OK(status);
+  docdb::TransactionApplyStatePB apply_state;
+  if (!apply_state.ParseFromString(value)) {
+    return STATUS_FORMAT(Corruption, "Unable to parse apply state of $0", id);
+  }
+  return boost::make_optional(std::move(apply_state));
+}
+
+Result<bool> Tablet::PrepareApplyIntents(
+    const TransactionId& id, HybridTime commit_time, size_t max_intents,
+    IntraTxnWriteId* write_id, WriteBatch* regular_write_batch, WriteBatch* intents_write_batch,
+    std::vector<std::string>* intent_paths) {
   auto reverse_index_iter = docdb::CreateRocksDBIterator(
-      rocksdb_.get(),
+      intents_db(),
       docdb::BloomFilterMode::DONT_USE_BLOOM_FILTER,
       boost::none,
       rocksdb::kDefaultQueryId);
 
-  auto intent_iter = docdb::CreateRocksDBIterator(rocksdb_.get(),
+  auto intent_iter = docdb::CreateRocksDBIterator(intents_db(),
                                                   docdb::BloomFilterMode::DONT_USE_BLOOM_FILTER,
                                                   boost::none,
                                                   rocksdb::kDefaultQueryId);
 
   KeyBytes txn_reverse_index_prefix;
-  Slice transaction_id_slice(data.transaction_id.data, TransactionId::static_size());
-  AppendTransactionKeyPrefix(data.transaction_id, &txn_reverse_index_prefix);
+  Slice transaction_id_slice(id.data, TransactionId::static_size());
+  AppendTransactionKeyPrefix(id, &txn_reverse_index_prefix);
+  KeyBytes apply_state_key;
+  docdb::AppendTransactionApplyStateKey(id, &apply_state_key);
 
   reverse_index_iter->Seek(txn_reverse_index_prefix.data());
 
-  WriteBatch rocksdb_write_batch;
-
   docdb::DocHybridTimeBuffer doc_ht_buffer;
 
-  IntraTxnWriteId write_id = 0;
+  size_t num_intents = 0;
+  bool all_applied = true;
   while (reverse_index_iter->Valid()) {
     rocksdb::Slice key_slice(reverse_index_iter->key());
 
@@ -877,54 +1439,73 @@ Status Tablet::ApplyIntents(const TransactionApplyData& data) {
     }
 
     // If the key ends at the transaction id then it is transaction metadata (status tablet,
-    // isolation level etc.).
-    if (key_slice.size() > txn_reverse_index_prefix.size()) {
-      // Value of reverse index is a key of original intent record, so seek it and check match.
-      intent_iter->Seek(reverse_index_iter->value());
-      if (!intent_iter->Valid() || intent_iter->key() != reverse_index_iter->value()) {
-        LOG(DFATAL) << "Unable to find intent: " << reverse_index_iter->value().ToDebugString()
-                    << " for " << reverse_index_iter->key().ToDebugString();
-        continue;
-      }
-      auto intent = docdb::ParseIntentKey(intent_iter->key(), transaction_id_slice);
-      RETURN_NOT_OK(intent);
-
-      if (IsStrongIntent(intent->type)) {
-        Slice intent_value(intent_iter->value());
-        INTENT_VALUE_SCHECK(intent_value[0], EQ, static_cast<uint8_t>(ValueType::kTransactionId),
-                            "prefix expected");
-        intent_value.consume_byte();
-        INTENT_VALUE_SCHECK(intent_value.starts_with(transaction_id_slice), EQ, true,
-                            "wrong transaction id");
-        intent_value.remove_prefix(transaction_id_slice.size());
-
-        // After strip of prefix and suffix intent_key contains just SubDocKey w/o a hybrid time.
-        // Time will be added when writing batch to rocks db.
-        std::array<Slice, 2> key_parts = {{
-            intent->doc_path,
-            doc_ht_buffer.EncodeWithValueType(data.commit_time, write_id),
-        }};
-        std::array<Slice, 2> value_parts = {{
-            intent->doc_ht,
-            intent_value,
-        }};
-        rocksdb_write_batch.Put(key_parts, value_parts);
-        ++write_id;
-      }
+    // isolation level etc.). It is removed with the apply state, after the last intent.
+    if (key_slice.size() == txn_reverse_index_prefix.size() || key_slice == apply_state_key) {
+      reverse_index_iter->Next();
+      continue;
+    }
 
-      rocksdb_write_batch.Delete(intent_iter->key());
+    if (max_intents != 0 && num_intents == max_intents) {
+      all_applied = false;
+      break;
+    }
+    ++num_intents;
+
+    // Value of reverse index is a key of original intent record, so seek it and check match.
+    intent_iter->Seek(reverse_index_iter->value());
+    if (!intent_iter->Valid() || intent_iter->key() != reverse_index_iter->value()) {
+      LOG(DFATAL) << "Unable to find intent: " << reverse_index_iter->value().ToDebugString()
+                  << " for " << reverse_index_iter->key().ToDebugString();
+      reverse_index_iter->Next();
+      continue;
+    }
+    auto intent = docdb::ParseIntentKey(intent_iter->key(), transaction_id_slice);
+    RETURN_NOT_OK(intent);
+
+    if (IsStrongIntent(intent->type)) {
+      Slice intent_value(intent_iter->value());
+      INTENT_VALUE_SCHECK(intent_value[0], EQ, static_cast<uint8_t>(ValueType::kTransactionId),
+                          "prefix expected");
+      intent_value.consume_byte();
+      INTENT_VALUE_SCHECK(intent_value.starts_with(transaction_id_slice), EQ, true,
+                          "wrong transaction id");
+      intent_value.remove_prefix(transaction_id_slice.size());
+
+      // After strip of prefix and suffix intent_key contains just SubDocKey w/o a hybrid time.
+      // Time will be added when writing batch to rocks db.
+      std::array<Slice, 2> key_parts = {{
+          intent->doc_path,
+          doc_ht_buffer.EncodeWithValueType(commit_time, *write_id),
+      }};
+      std::array<Slice, 2> value_parts = {{
+          intent->doc_ht,
+          intent_value,
+      }};
+      regular_write_batch->Put(key_parts, value_parts);
+      ++*write_id;
     }
 
-    rocksdb_write_batch.Delete(reverse_index_iter->key());
+    intents_write_batch->Delete(intent_iter->key());
+    intents_write_batch->Delete(reverse_index_iter->key());
+    if (intent_paths) {
+      // The path is the intent key up to the intent type, including the intent prefix.
+      intent_paths->emplace_back(
+          intent_iter->key().cdata(), intent->doc_path.cend() - intent_iter->key().cdata());
+    }
 
     reverse_index_iter->Next();
   }
 
-  // data.hybrid_time contains transaction commit time.
-  // We don't set transaction field of put_batch, otherwise we would write another bunch of intents.
-  ApplyKeyValueRowOperations(
-      KeyValueWriteBatchPB(), data.op_id, data.commit_time, &rocksdb_write_batch);
-  return Status::OK();
+  if (all_applied) {
+    intents_write_batch->Delete(txn_reverse_index_prefix.data());
+    intents_write_batch->Delete(apply_state_key.data());
+  } else {
+    docdb::TransactionApplyStatePB apply_state;
+    apply_state.set_commit_hybrid_time(commit_time.ToUint64());
+    apply_state.set_next_write_id(*write_id);
+    intents_write_batch->Put(apply_state_key.data(), apply_state.SerializeAsString());
+  }
+  return all_applied;
 }
 
 Status Tablet::CreatePreparedAlterSchema(AlterSchemaOperationState *operation_state,
@@ -1009,16 +1590,26 @@ Result<ScopedPendingOperationPause> Tablet::PauseReadWriteOperations() {
 
 Status Tablet::SetFlushedOpId(const consensus::OpId& op_id) {
   const rocksdb::OpId flushed_op_id(op_id.term(), op_id.index());
-  const Status s = rocksdb_->SetFlushedOpId(flushed_op_id);
-  if (PREDICT_FALSE(!s.ok())) {
-    LOG(WARNING) << "Failed to set flushed op id: " << s;
-    return STATUS(IllegalState, "Failed to set flushed op id", s.ToString());
+  for (auto* db : {rocksdb_.get(), intents_db_.get()}) {
+    if (!db) {
+      continue;
+    }
+    const Status s = db->SetFlushedOpId(flushed_op_id);
+    if (PREDICT_FALSE(!s.ok())) {
+      LOG(WARNING) << "Failed to set flushed op id: " << s;
+      return STATUS(IllegalState, "Failed to set flushed op id", s.ToString());
+    }
+    DCHECK_EQ(flushed_op_id, db->GetFlushedOpId());
   }
-  DCHECK_EQ(flushed_op_id, rocksdb_->GetFlushedOpId());
   return Flush(FlushMode::kAsync);
 }
 
 Status Tablet::Truncate(TruncateOperationState *state) {
+  // Resumed when the new DB is opened.
+  if (transaction_participant_) {
+    transaction_participant_->StopBackgroundApply();
+  }
+
   auto op_pause = PauseReadWriteOperations();
   RETURN_NOT_OK(op_pause);
 
@@ -1030,10 +1621,16 @@ Status Tablet::Truncate(TruncateOperationState *state) {
   const rocksdb::SequenceNumber sequence_number = rocksdb_->GetLatestSequenceNumber();
   const string db_dir = rocksdb_->GetName();
 
-  rocksdb_ = nullptr;
-  rocksdb::Options rocksdb_options;
-  docdb::InitRocksDBOptions(&rocksdb_options, tablet_id(), rocksdb_statistics_, tablet_options_);
-  Status s = rocksdb::DestroyDB(db_dir, rocksdb_options);
+  CloseRocksDBs();
+  if (metadata_->frozen()) {
+    // The new database is empty, and is written to.
+    metadata_->set_frozen(false);
+    RETURN_NOT_OK(metadata_->Flush());
+  }
+  // The old files are deleted in the background, so the time the operations are paused for does
+  // not depend on the size of the tablet. The intents DB is nested in the regular one and moves
+  // with it.
+  Status s = docdb::DestroyDBInBackground(db_dir);
   if (PREDICT_FALSE(!s.ok())) {
     LOG(WARNING) << "Failed to clean up db dir " << db_dir << ": " << s;
     return STATUS(IllegalState, "Failed to clean up db dir", s.ToString());
@@ -1055,6 +1652,132 @@ Status Tablet::Truncate(TruncateOperationState *state) {
   return Status::OK();
 }
 
+Status Tablet::IngestSSTFiles(IngestSSTFilesOperationState* state) {
+  auto op_pause = PauseReadWriteOperations();
+  RETURN_NOT_OK(op_pause);
+
+  // Check if tablet is in shutdown mode.
+  if (IsShutdownRequested()) {
+    return STATUS(IllegalState, "Tablet was shut down");
+  }
+
+  if (frozen()) {
+    return STATUS_FORMAT(IllegalState, "Tablet $0 is frozen", tablet_id());
+  }
+
+  // Writes applied before the ingestion could still be in memtables, and would be lost on restart
+  // once the ingestion is recorded as flushed.
+  RETURN_NOT_OK(Flush(FlushMode::kSync));
+
+  Status status;
+  for (const auto& path : state->request()->file_paths()) {
+    // The files are linked rather than moved, so that a replay of the operation still finds them.
+    status = rocksdb_->AddFile(path, false /* move_file */);
+    if (!status.ok()) {
+      status = status.CloneAndPrepend(Format("Failed to ingest $0", path));
+      break;
+    }
+    LOG(INFO) << "Ingested " << path << " into tablet " << tablet_id();
+  }
+  if (row_cache_) {
+    row_cache_->InvalidateAll();
+  }
+
+  // A failed ingestion is recorded as flushed as well, replaying it would only fail again.
+  RETURN_NOT_OK(SetFlushedOpId(state->op_id()));
+  return status;
+}
+
+Status Tablet::RestoreToHybridTime(HybridTime restore_ht) {
+  if (intents_db_) {
+    // Provisional records of the transactions in flight would have to be rolled back as well.
+    return STATUS(NotSupported, "Restoring to a hybrid time is not supported for transactional "
+                                "tables");
+  }
+
+  auto op_pause = PauseReadWriteOperations();
+  RETURN_NOT_OK(op_pause);
+
+  // Check if tablet is in shutdown mode.
+  if (IsShutdownRequested()) {
+    return STATUS(IllegalState, "Tablet was shut down");
+  }
+
+  const HybridTime history_cutoff = retention_policy_->GetHistoryCutoff();
+  if (restore_ht < history_cutoff) {
+    return STATUS_FORMAT(InvalidArgument,
+                         "Restore hybrid time $0 is outside of the history retention window, "
+                         "history cutoff is $1", restore_ht, history_cutoff);
+  }
+
+  // The compaction does not see the records still in memtables.
+  RETURN_NOT_OK(Flush(FlushMode::kSync));
+
+  LOG(INFO) << "Restoring tablet " << tablet_id() << " to " << restore_ht;
+  retention_policy_->SetRestoreHybridTime(restore_ht);
+  const Status status = rocksdb_->CompactRange(
+      rocksdb::CompactRangeOptions(), /* begin = */ nullptr, /* end = */ nullptr);
+  retention_policy_->SetRestoreHybridTime(HybridTime::kInvalidHybridTime);
+  if (row_cache_) {
+    row_cache_->InvalidateAll();
+  }
+  return status;
+}
+
+Status Tablet::Freeze() {
+  if (intents_db_ || transaction_participant_) {
+    // Provisional records are written and removed until their transactions are resolved.
+    return STATUS(NotSupported, "Freezing is not supported for transactional tables");
+  }
+
+  auto op_pause = PauseReadWriteOperations();
+  RETURN_NOT_OK(op_pause);
+
+  // Check if tablet is in shutdown mode.
+  if (IsShutdownRequested()) {
+    return STATUS(IllegalState, "Tablet was shut down");
+  }
+
+  if (frozen()) {
+    return Status::OK();
+  }
+
+  // The compacted DB mode requires the records to be in a single sorted run, so the memtables are
+  // flushed before the full compaction.
+  RETURN_NOT_OK(Flush(FlushMode::kSync));
+  RETURN_NOT_OK(rocksdb_->CompactRange(
+      rocksdb::CompactRangeOptions(), /* begin = */ nullptr, /* end = */ nullptr));
+
+  LOG(INFO) << "Freezing tablet " << tablet_id();
+  return SetFrozen(true);
+}
+
+Status Tablet::Thaw() {
+  auto op_pause = PauseReadWriteOperations();
+  RETURN_NOT_OK(op_pause);
+
+  // Check if tablet is in shutdown mode.
+  if (IsShutdownRequested()) {
+    return STATUS(IllegalState, "Tablet was shut down");
+  }
+
+  if (!frozen()) {
+    return Status::OK();
+  }
+
+  LOG(INFO) << "Thawing tablet " << tablet_id();
+  return SetFrozen(false);
+}
+
+Status Tablet::SetFrozen(bool frozen) {
+  // The state is persisted first: the records are compacted already, so the tablet can be opened
+  // either way after a crash in between.
+  metadata_->set_frozen(frozen);
+  RETURN_NOT_OK(metadata_->Flush());
+  CloseRocksDBs();
+  return OpenKeyValueTablet();
+}
+
 void Tablet::UpdateMonotonicCounter(int64_t value) {
   int64_t counter = monotonic_counter_;
   while (true) {
@@ -1075,16 +1798,158 @@ Result<bool> Tablet::HasSSTables() const {
   ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
   RETURN_NOT_OK(scoped_read_operation);
 
+  for (auto* db : {rocksdb_.get(), intents_db_.get()}) {
+    if (!db) {
+      continue;
+    }
+    std::vector<rocksdb::LiveFileMetaData> live_files_metadata;
+    db->GetLiveFilesMetaData(&live_files_metadata);
+    if (!live_files_metadata.empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+Status Tablet::GetFilesWithDeletedColumns(std::vector<std::string>* files,
+                                          uint64_t* total_size) {
+  files->clear();
+  *total_size = 0;
+
+  ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_read_operation);
+
+  if (!rocksdb_ || !retention_policy_) {
+    return Status::OK();
+  }
+  const ColumnIdsPtr deleted_columns = retention_policy_->GetDeletedColumns();
+  if (deleted_columns->empty()) {
+    return Status::OK();
+  }
+
   std::vector<rocksdb::LiveFileMetaData> live_files_metadata;
   rocksdb_->GetLiveFilesMetaData(&live_files_metadata);
-  return !live_files_metadata.empty();
+
+  std::lock_guard<std::mutex> lock(files_without_deleted_columns_mutex_);
+  if (deleted_columns->size() != num_deleted_columns_checked_) {
+    files_without_deleted_columns_.clear();
+    num_deleted_columns_checked_ = deleted_columns->size();
+  }
+  // Keep only the files that are still live, so that the set does not grow with every compaction.
+  std::unordered_set<std::string> files_without_deleted_columns;
+  rocksdb::TablePropertiesCollection properties;
+  bool properties_loaded = false;
+  for (const auto& file : live_files_metadata) {
+    const std::string path = file.db_path + file.name;
+    if (files_without_deleted_columns_.count(path)) {
+      files_without_deleted_columns.insert(path);
+      continue;
+    }
+    if (!properties_loaded) {
+      RETURN_NOT_OK(rocksdb_->GetPropertiesOfAllTables(&properties));
+      properties_loaded = true;
+    }
+    auto it = properties.find(path);
+    docdb::DocDBTableProperties docdb_properties;
+    // Files written before the column ids were recorded may hold any column.
+    bool has_deleted_columns = it == properties.end() ||
+                               !docdb::GetDocDBTableProperties(*it->second, &docdb_properties);
+    const ColumnIds& column_ids = docdb_properties.column_ids;
+    for (auto column_id = column_ids.begin();
+         !has_deleted_columns && column_id != column_ids.end(); ++column_id) {
+      has_deleted_columns = deleted_columns->count(*column_id) != 0;
+    }
+    if (!has_deleted_columns) {
+      files_without_deleted_columns.insert(path);
+    } else if (!file.being_compacted) {
+      files->push_back(path);
+      *total_size += file.total_size;
+    }
+  }
+  files_without_deleted_columns_.swap(files_without_deleted_columns);
+  return Status::OK();
+}
+
+Status Tablet::CompactFilesWithDeletedColumns() {
+  std::vector<std::string> files;
+  uint64_t total_size = 0;
+  RETURN_NOT_OK(GetFilesWithDeletedColumns(&files, &total_size));
+  if (files.empty()) {
+    return Status::OK();
+  }
+
+  ScopedPendingOperation scoped_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_operation);
+  LOG(INFO) << "Compacting " << files.size() << " SST files of " << total_size
+            << " bytes with values of deleted columns in tablet " << tablet_id();
+  return rocksdb_->CompactFiles(rocksdb::CompactionOptions(), files, 0 /* output_level */);
+}
+
+Result<std::string> Tablet::GetEncodedMiddleSplitKey() const {
+  ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_read_operation);
+  if (!rocksdb_) {
+    return STATUS(IllegalState, "Tablet is not backed by RocksDB");
+  }
+
+  std::string middle_key;
+  RETURN_NOT_OK(rocksdb_->GetMiddleKey(&middle_key));
+  docdb::DocKey doc_key;
+  Slice key_slice(middle_key);
+  RETURN_NOT_OK(doc_key.DecodeFrom(&key_slice, docdb::DocKeyPart::HASHED_PART_ONLY));
+  if (doc_key.hashed_group().empty()) {
+    return STATUS(NotSupported, "Only hash partitioned tablets could be split");
+  }
+
+  auto partition_key = PartitionSchema::EncodeMultiColumnHashValue(doc_key.hash());
+  const auto& partition = metadata_->partition();
+  if (partition_key <= partition.partition_key_start() ||
+      (!partition.partition_key_end().empty() && partition_key >= partition.partition_key_end())) {
+    return STATUS_FORMAT(Incomplete, "Middle key of tablet $0 is on the partition boundary",
+                         tablet_id());
+  }
+  return partition_key;
 }
 
 Result<yb::OpId> Tablet::MaxPersistentOpId() const {
   ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
   RETURN_NOT_OK(scoped_read_operation);
 
-  return rocksdb_->GetFlushedOpId();
+  auto result = rocksdb_->GetFlushedOpId();
+  if (intents_db_) {
+    // Operations after the smaller of the flushed op ids are replayed into both RocksDB instances.
+    const auto intents_flushed_op_id = intents_db_->GetFlushedOpId();
+    if (intents_flushed_op_id.index < result.index) {
+      result = intents_flushed_op_id;
+    }
+  }
+  return result;
+}
+
+int Tablet::NumLevel0Files() const {
+  ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
+  std::string value;
+  int32_t result = 0;
+  if (scoped_read_operation.ok() && rocksdb_ &&
+      rocksdb_->GetProperty(rocksdb::DB::Properties::kNumFilesAtLevelPrefix + "0", &value) &&
+      safe_strto32(value, &result)) {
+    return result;
+  }
+  return 0;
+}
+
+uint64_t Tablet::ActiveMemTableSize() const {
+  ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
+  uint64_t size = 0;
+  if (scoped_read_operation.ok() && rocksdb_) {
+    rocksdb_->GetIntProperty(rocksdb::DB::Properties::kCurSizeActiveMemTable, &size);
+    if (intents_db_) {
+      uint64_t intents_size = 0;
+      intents_db_->GetIntProperty(rocksdb::DB::Properties::kCurSizeActiveMemTable, &intents_size);
+      size += intents_size;
+    }
+  }
+  return size;
 }
 
 Status Tablet::DebugDump(vector<string> *lines) {
@@ -1101,6 +1966,10 @@ void Tablet::DocDBDebugDump(vector<string> *lines) {
   LOG_STRING(INFO, lines) << "Dumping tablet:";
   LOG_STRING(INFO, lines) << "---------------------------";
   yb::docdb::DocDBDebugDump(rocksdb_.get(), LOG_STRING(INFO, lines));
+  if (intents_db_) {
+    LOG_STRING(INFO, lines) << "Intents:";
+    yb::docdb::DocDBDebugDump(intents_db_.get(), LOG_STRING(INFO, lines));
+  }
 }
 
 Status Tablet::CaptureConsistentIterators(
@@ -1167,9 +2036,12 @@ Status Tablet::StartDocWriteOperation(const docdb::DocOperations &doc_ops,
   auto isolation_level = GetIsolationLevel(*write_batch, transaction_participant_.get());
   RETURN_NOT_OK(isolation_level);
   bool need_read_snapshot = false;
-  docdb::PrepareDocWriteOperation(
-      doc_ops, metrics_->write_lock_latency, *isolation_level, &shared_lock_manager_,
-      data.keys_locked, &need_read_snapshot);
+  {
+    TRACE_STAGE("tablet.lock_acquisition");
+    docdb::PrepareDocWriteOperation(
+        doc_ops, metrics_->write_lock_latency, *isolation_level, &shared_lock_manager_,
+        data.keys_locked, &need_read_snapshot);
+  }
 
   auto read_op = need_read_snapshot ? ScopedReadOperation(this, data.read_time())
                                     : ScopedReadOperation();
@@ -1178,9 +2050,11 @@ Status Tablet::StartDocWriteOperation(const docdb::DocOperations &doc_ops,
 
   if (*isolation_level == IsolationLevel::NON_TRANSACTIONAL &&
       metadata_->schema().table_properties().is_transactional()) {
+    TRACE_STAGE("tablet.conflict_resolution");
     auto now = clock_->Now();
     auto result = docdb::ResolveOperationConflicts(
-        doc_ops, now, rocksdb_.get(), transaction_participant_.get());
+        doc_ops, now, rocksdb_.get(), intents_db(), intent_filter_.get(),
+        transaction_participant_.get());
     RETURN_NOT_OK(result);
     if (now != *result) {
       clock_->Update(*result);
@@ -1204,11 +2078,20 @@ Status Tablet::StartDocWriteOperation(const docdb::DocOperations &doc_ops,
     auto result = docdb::ResolveTransactionConflicts(*write_batch,
                                                      clock_->Now(),
                                                      rocksdb_.get(),
+                                                     intents_db(),
+                                                     intent_filter_.get(),
                                                      transaction_participant_.get());
     if (!result.ok()) {
       *data.keys_locked = LockBatch();  // Unlock the keys.
       return result;
     }
+    // Conflicts were resolved as for a regular transaction, and the keys stay locked until this
+    // write is applied. So it could be applied as a non transactional write, i.e. without intents,
+    // and the transaction is committed at the hybrid time of this write.
+    if (write_batch->single_shard_transaction()) {
+      write_batch->clear_transaction();
+      write_batch->clear_single_shard_transaction();
+    }
   }
 
   return Status::OK();
@@ -1329,6 +2212,10 @@ void Tablet::ForceRocksDBCompactInTest() {
 }
 
 std::string Tablet::DocDBDumpStrInTest() {
+  if (intents_db_) {
+    return docdb::DocDBDebugDumpToStr(rocksdb_.get()) +
+           docdb::DocDBDebugDumpToStr(intents_db_.get());
+  }
   return docdb::DocDBDebugDumpToStr(rocksdb_.get());
 }
 
@@ -1347,7 +2234,8 @@ uint64_t Tablet::GetTotalSSTFileSizes() const {
   if (!pending_op_counter_.IsReady() || !rocksdb_) {
     return 0;
   }
-  return rocksdb_->GetTotalSSTFileSize();
+  return rocksdb_->GetTotalSSTFileSize() +
+         (intents_db_ ? intents_db_->GetTotalSSTFileSize() : 0);
 }
 
 Result<TransactionOperationContextOpt> Tablet::CreateTransactionOperationContext(
@@ -1358,12 +2246,13 @@ Result<TransactionOperationContextOpt> Tablet::CreateTransactionOperationContext
           transaction_metadata.transaction_id());
       RETURN_NOT_OK(txn_id);
       return Result<TransactionOperationContextOpt>(boost::make_optional(
-          TransactionOperationContext(*txn_id, transaction_participant())));
+          TransactionOperationContext(*txn_id, transaction_participant(), intents_db_.get())));
     } else {
       // We still need context with transaction participant in order to resolve intents during
       // possible reads.
       return Result<TransactionOperationContextOpt>(boost::make_optional(
-          TransactionOperationContext(GenerateTransactionId(), transaction_participant())));
+          TransactionOperationContext(
+              GenerateTransactionId(), transaction_participant(), intents_db_.get())));
     }
   } else {
     return Result<TransactionOperationContextOpt>(boost::none);
@@ -1374,11 +2263,13 @@ TransactionOperationContextOpt Tablet::CreateTransactionOperationContext(
     const boost::optional<TransactionId>& transaction_id) const {
   if (metadata_->schema().table_properties().is_transactional()) {
     if (transaction_id.is_initialized()) {
-      return TransactionOperationContext(transaction_id.get(), transaction_participant());
+      return TransactionOperationContext(
+          transaction_id.get(), transaction_participant(), intents_db_.get());
     } else {
       // We still need context with transaction participant in order to resolve intents during
       // possible reads.
-      return TransactionOperationContext(GenerateTransactionId(), transaction_participant());
+      return TransactionOperationContext(
+          GenerateTransactionId(), transaction_participant(), intents_db_.get());
     }
   } else {
     return boost::none;
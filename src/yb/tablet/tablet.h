@@ -32,11 +32,15 @@
 #ifndef YB_TABLET_TABLET_H_
 #define YB_TABLET_TABLET_H_
 
+#include <deque>
+#include <functional>
 #include <iosfwd>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_set>
 #include <vector>
 
 #include "yb/rocksdb/cache.h"
@@ -57,6 +61,8 @@
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/docdb_compaction_filter.h"
 #include "yb/docdb/doc_operation.h"
+#include "yb/docdb/doc_row_cache.h"
+#include "yb/docdb/intent_filter.h"
 #include "yb/docdb/ql_rocksdb_storage.h"
 #include "yb/docdb/shared_lock_manager.h"
 
@@ -66,6 +72,7 @@
 
 #include "yb/tablet/abstract_tablet.h"
 #include "yb/tablet/lock_manager.h"
+#include "yb/tablet/tablet_hotspots.h"
 #include "yb/tablet/tablet_options.h"
 #include "yb/tablet/mvcc.h"
 #include "yb/tablet/tablet_metadata.h"
@@ -105,8 +112,10 @@ class MaintenanceOpStats;
 namespace tablet {
 
 class AlterSchemaOperationState;
+class IngestSSTFilesOperationState;
 class ScopedReadOperation;
 struct TabletMetrics;
+class TabletRetentionPolicy;
 struct TransactionApplyData;
 class TransactionCoordinator;
 class TransactionCoordinatorContext;
@@ -197,7 +206,9 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   CHECKED_STATUS ImportData(const std::string& source_dir);
 
-  CHECKED_STATUS ApplyIntents(const TransactionApplyData& data) override;
+  Result<bool> ApplyIntents(const TransactionApplyData& data, size_t max_intents) override;
+
+  Result<bool> ContinueApplyIntents(const TransactionId& id, size_t max_intents) override;
 
   // Finish the Prepare phase of a write transaction.
   //
@@ -238,6 +249,25 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
       HybridTime hybrid_time,
       rocksdb::WriteBatch* rocksdb_write_batch = nullptr);
 
+  // Starts a batch of the committed operations applied by the current thread until
+  // FinishApplyBatch(): the writes of the non-transactional write operations added to it with
+  // AddToApplyBatch() are coalesced into one RocksDB write. Only one thread can apply a batch at a
+  // time.
+  void StartApplyBatch();
+
+  // Writes the operations of the current thread's apply batch and ends it.
+  void FinishApplyBatch();
+
+  // Adds the writes of the operation to the apply batch of the current thread, `applied` is
+  // invoked once they are written to RocksDB. Returns false if the operation must be applied with
+  // ApplyRowOperations() instead, in which case the operations already in the batch are written.
+  bool AddToApplyBatch(WriteOperationState* operation_state, std::function<void()> applied);
+
+  // Should be invoked before an operation is applied outside of an apply batch, so that it is
+  // applied after the operations committed before it: writes the batch of the current thread, or
+  // waits for the batch of another thread to be written.
+  void PrepareApplyOutsideBatch();
+
   // Takes a Redis WriteRequestPB as input with its redis_write_batch.
   // Constructs a WriteRequestPB containing a serialized WriteBatch that will be
   // replicated by Raft. (Makes a copy, it is caller's responsibility to deallocate
@@ -271,6 +301,34 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   CHECKED_STATUS CreateCheckpoint(const std::string& dir,
       google::protobuf::RepeatedPtrField<RocksDBFilePB>* rocksdb_files = nullptr);
 
+  // Removes from the files of a checkpoint the SST files that are also present, with the same
+  // name and size, in the files of a base checkpoint of the same tablet. RocksDB never reuses an
+  // SST file name and never modifies an SST file once written, so what remains is the set of files
+  // an incremental copy on top of the base checkpoint needs.
+  static void ExcludeBaseCheckpointFiles(
+      const google::protobuf::RepeatedPtrField<RocksDBFilePB>& base_files,
+      google::protobuf::RepeatedPtrField<RocksDBFilePB>* rocksdb_files);
+
+  // Brings the regular records of this tablet back to their state as of restore_ht, using the
+  // history retained in the tablet's own SST files: a full compaction drops every record written
+  // after restore_ht. restore_ht must not be older than the history cutoff, since the history
+  // before it could already be compacted away. Reads and writes are paused for the duration.
+  // The restore is local to this replica, the caller is responsible for running it on every
+  // replica of the tablet.
+  CHECKED_STATUS RestoreToHybridTime(HybridTime restore_ht);
+
+  // Compacts all the records of this tablet into a single sorted run and reopens its RocksDB read
+  // only, so reads of an immutable tablet skip the memtable and the level iteration, and it does
+  // not take any flush or compaction work. Writes are rejected until the tablet is thawed, and the
+  // state is persisted in the tablet metadata. As with RestoreToHybridTime, the caller is
+  // responsible for freezing every replica, after the writes to the tablet have stopped.
+  CHECKED_STATUS Freeze();
+
+  // Reopens the RocksDB of a frozen tablet for writes.
+  CHECKED_STATUS Thaw();
+
+  bool frozen() const { return metadata_->frozen(); }
+
   // Create a new row iterator which yields the rows as of the current MVCC
   // state of this tablet.
   // The returned iterator is not initialized.
@@ -308,6 +366,11 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Truncate this tablet by resetting the content of RocksDB.
   CHECKED_STATUS Truncate(TruncateOperationState* state);
 
+  // Ingests the externally built SST files of the request into RocksDB, see
+  // rocksdb::DB::AddFile(). The data already in the tablet is flushed first, and the operation is
+  // then recorded as flushed, so it is only replayed on bootstrap after a crash during ingestion.
+  CHECKED_STATUS IngestSSTFiles(IngestSSTFilesOperationState* state);
+
   // Verbosely dump this entire tablet to the logs. This is only
   // really useful when debugging unit tests failures where the tablet
   // has a very small number of rows.
@@ -340,6 +403,9 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // May be NULL in unit tests, etc.
   TabletMetrics* metrics() { return metrics_.get(); }
 
+  // Return the tracker of the read and write load of this tablet and of its hot keys.
+  TabletHotspots* hotspots() { return &hotspots_; }
+
   // Return handle to the metric entity of this tablet.
   const scoped_refptr<MetricEntity>& GetMetricEntity() const { return metric_entity_; }
 
@@ -351,9 +417,33 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Returns true if a RocksDB-backed tablet has any SSTables.
   Result<bool> HasSSTables() const;
 
+  // Returns the SST files of the regular DB that may still hold values of columns deleted before
+  // the history cutoff, based on the column ids each file records, and their total size. Files
+  // that are already being compacted are left out.
+  CHECKED_STATUS GetFilesWithDeletedColumns(std::vector<std::string>* files, uint64_t* total_size);
+
+  // Compacts the files returned by GetFilesWithDeletedColumns(), which drops the values of the
+  // deleted columns from them without rewriting the rest of the tablet. Only the files between
+  // them in the compaction order are rewritten as well.
+  CHECKED_STATUS CompactFilesWithDeletedColumns();
+
+  // Returns the encoded partition key, that splits the data of this tablet into two halves of
+  // approximately the same size, picked from the index of its largest SST file. The key is strictly
+  // inside the tablet partition, so it can be used as the boundary of the child tablets.
+  Result<std::string> GetEncodedMiddleSplitKey() const;
+
   // Returns the maximum persistent op id from all SSTables in RocksDB.
   Result<yb::OpId> MaxPersistentOpId() const;
 
+  // Returns the memory used by the active memtable, i.e. the one a flush would write out, or 0 if
+  // the tablet is not open.
+  uint64_t ActiveMemTableSize() const;
+
+  // Returns the number of SST files in level 0 of the regular RocksDB, or 0 if the tablet is not
+  // open. With universal compaction and a single level this is the number of SST files that the
+  // level0_slowdown_writes_trigger and level0_stop_writes_trigger limits apply to.
+  int NumLevel0Files() const;
+
   // Returns the location of the last rocksdb checkpoint. Used for tests only.
   std::string GetLastRocksDBCheckpointDirForTest() { return last_rocksdb_checkpoint_dir_; }
 
@@ -408,6 +498,12 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
     return last_committed_write_index_.load(std::memory_order_acquire);
   }
 
+  // Returns the index of the last write whose changes are visible to the reads of the tablet.
+  // Unlike last_committed_write_index(), it is only updated once the write has been applied.
+  int64_t last_applied_write_index() const {
+    return last_applied_write_index_.load(std::memory_order_acquire);
+  }
+
   void LostLeadership();
 
   uint64_t GetTotalSSTFileSizes() const;
@@ -426,6 +522,9 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   CHECKED_STATUS FlushUnlocked(FlushMode mode);
 
+  Result<std::shared_ptr<const docdb::QLReadProjections>> GetQLReadProjections(
+      const Schema& schema, const QLReferencedColumnsPB& column_refs) override;
+
   // Capture a set of iterators which, together, reflect all of the data in the tablet.
   //
   // These iterators are not true snapshot iterators, but they are safe against
@@ -456,8 +555,65 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   CHECKED_STATUS GetMappedReadProjection(const Schema& projection,
       Schema *mapped_projection) const;
 
+  // Opens the RocksDB of the tablet, read only when the tablet is frozen.
   CHECKED_STATUS OpenKeyValueTablet();
 
+  // Persists the frozen state of the tablet and reopens its RocksDB accordingly.
+  CHECKED_STATUS SetFrozen(bool frozen);
+
+  // Opens the RocksDB instance that keeps transaction intents apart from the regular records, when
+  // it exists or the tablet is new and FLAGS_tablet_separate_intents_db is set.
+  CHECKED_STATUS OpenIntentsDB(rocksdb::Options* options);
+
+  // Closes the intents and the regular RocksDB instances.
+  void CloseRocksDBs();
+
+  // DB that contains transaction intents, that is the regular one when they are not separated.
+  rocksdb::DB* intents_db() const {
+    return intents_db_ ? intents_db_.get() : rocksdb_.get();
+  }
+
+  void WriteToRocksDB(
+      rocksdb::DB* db, HybridTime hybrid_time, rocksdb::WriteBatch* rocksdb_write_batch);
+
+  // Writes the operations added to the apply batch of the current thread and invokes their
+  // callbacks.
+  void WriteApplyBatch();
+
+  // Flush filter of the intents DB: a memtable can't be flushed while it contains the removal of
+  // intents of a transaction whose regular records are not flushed yet.
+  bool IntentsFlushAllowed(const rocksdb::OpId& last_op_id);
+
+  // Flushes the regular DB when the intents DB has memtables that wait for it.
+  void FlushRegularDBForIntents();
+
+  // Called after each flush of the regular DB, retries the deferred flushes of the intents DB.
+  void RegularDBFlushed();
+
+  // Adds regular records for at most max_intents intents of transaction id to
+  // regular_write_batch, zero means all of them, and removes the intents in intents_write_batch.
+  // The progress is stored in intents_write_batch when not all intents were applied. The paths of
+  // the removed intents are appended to intent_paths, unless it is null. Returns whether all
+  // intents were applied.
+  Result<bool> PrepareApplyIntents(
+      const TransactionId& id, HybridTime commit_time, size_t max_intents,
+      IntraTxnWriteId* write_id, rocksdb::WriteBatch* regular_write_batch,
+      rocksdb::WriteBatch* intents_write_batch, std::vector<std::string>* intent_paths);
+
+  // Removes the paths of intents whose removal was written from intent_filter_.
+  void RemoveFromIntentFilter(const std::vector<std::string>& intent_paths);
+
+  // Creates intent_filter_ for a transactional tablet and fills it with the stored intents.
+  CHECKED_STATUS LoadIntentFilter();
+
+  // Returns the apply state of a partially applied transaction, none if there is no such state.
+  Result<boost::optional<docdb::TransactionApplyStatePB>> LoadApplyState(
+      const TransactionId& id);
+
+  CHECKED_STATUS AddCheckpointFiles(
+      const std::string& dir, const std::string& prefix,
+      google::protobuf::RepeatedPtrField<RocksDBFilePB>* rocksdb_files);
+
   void DocDBDebugDump(std::vector<std::string> *lines);
 
   // Register/Unregister a read operation, with an associated timestamp, for the purpose of
@@ -530,6 +686,8 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   gscoped_ptr<TabletMetrics> metrics_;
   FunctionGaugeDetacher metric_detacher_;
 
+  TabletHotspots hotspots_;
+
   int64_t next_mrs_id_ = 0;
 
   // A pointer to the server's clock.
@@ -574,8 +732,33 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // RocksDB database for key-value tables.
   std::unique_ptr<rocksdb::DB> rocksdb_;
 
+  // RocksDB database for transaction intents, see FLAGS_tablet_separate_intents_db. Null when the
+  // intents are kept in rocksdb_.
+  std::unique_ptr<rocksdb::DB> intents_db_;
+
+  // Serializes applying of transactions with the flushed op id updates of the idle intents DB.
+  std::mutex apply_intents_mutex_;
+
+  // Op ids of the applied transactions whose regular records may be not flushed yet, ascending.
+  std::mutex unflushed_applies_mutex_;
+  std::deque<int64_t> unflushed_applies_;
+
+  // Set when the intents DB scheduled a flush, so the write path flushes the regular DB as well.
+  std::atomic<bool> intents_flush_scheduled_{false};
+
+  // Paths of the live intents, lets conflict resolution skip the keys without them. Null for
+  // non-transactional tablets, or when the filter is disabled.
+  std::unique_ptr<docdb::IntentFilter> intent_filter_;
+
   std::unique_ptr<common::QLStorageIf> ql_storage_;
 
+  // Decoded documents of the hot keys of a Redis tablet, invalidated by the writes to rocksdb_.
+  std::unique_ptr<docdb::DocRowCache> row_cache_;
+
+  // Projections of the QL reads, shared across reads of the same columns. The metadata keeps the
+  // old schemas alive, as the cache requires.
+  docdb::QLReadProjectionCache ql_read_projection_cache_;
+
   // This is for docdb fine-grained locking.
   docdb::SharedLockManager shared_lock_manager_;
 
@@ -601,13 +784,31 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // This is marked mutable because read path member functions (which are const) are using this.
   mutable yb::util::PendingOperationCounter pending_op_counter_;
 
-  std::shared_ptr<yb::docdb::HistoryRetentionPolicy> retention_policy_;
+  std::shared_ptr<TabletRetentionPolicy> retention_policy_;
+
+  // SST files known not to hold values of any of the deleted columns, so that
+  // GetFilesWithDeletedColumns() does not check them again, and the number of deleted columns they
+  // were checked against.
+  std::mutex files_without_deleted_columns_mutex_;
+  std::unordered_set<std::string> files_without_deleted_columns_;
+  size_t num_deleted_columns_checked_ = 0;
 
   std::unique_ptr<TransactionCoordinator> transaction_coordinator_;
 
   std::unique_ptr<TransactionParticipant> transaction_participant_;
 
   std::atomic<int64_t> last_committed_write_index_{0};
+  std::atomic<int64_t> last_applied_write_index_{0};
+
+  // Held by the thread that applies a batch of committed operations, see StartApplyBatch().
+  std::mutex apply_batch_mutex_;
+  std::atomic<std::thread::id> apply_batch_thread_{std::thread::id()};
+
+  // Coalesced writes of the current apply batch, only accessed by apply_batch_thread_.
+  rocksdb::WriteBatch apply_batch_write_batch_;
+  rocksdb::OpId apply_batch_last_op_id_;
+  HybridTime apply_batch_max_hybrid_time_ = HybridTime::kMin;
+  std::vector<std::function<void()>> apply_batch_callbacks_;
 
   // Remembers he HybridTime of the oldest write that is still not scheduled to
   // be flushed in RocksDB.
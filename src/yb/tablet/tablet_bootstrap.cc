@@ -31,6 +31,9 @@
 //
 #include "yb/tablet/tablet_bootstrap.h"
 
+#include <deque>
+#include <future>
+
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/log_reader.h"
@@ -38,6 +41,7 @@
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tablet/operations/alter_schema_operation.h"
+#include "yb/tablet/operations/ingest_sst_files_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/update_txn_operation.h"
 #include "yb/tablet/operations/write_operation.h"
@@ -46,16 +50,30 @@
 #include "yb/util/opid.h"
 #include "yb/util/logging.h"
 #include "yb/util/stopwatch.h"
+#include "yb/util/threadpool.h"
 
 DEFINE_bool(skip_remove_old_recovery_dir, false,
             "Skip removing WAL recovery dir after startup. (useful for debugging)");
 TAG_FLAG(skip_remove_old_recovery_dir, hidden);
 
+DEFINE_int32(bootstrap_log_read_ahead_segments, 2,
+             "Number of WAL segments to read, decode and verify on background threads while "
+             "the previous segments are being replayed during tablet bootstrap. Each read ahead "
+             "segment is kept in memory until replayed. 0 disables read ahead.");
+TAG_FLAG(bootstrap_log_read_ahead_segments, advanced);
+
+DEFINE_bool(skip_flushed_log_segments_during_bootstrap, false,
+            "Do not read and replay closed WAL segments whose entries are all already flushed to "
+            "RocksDB. Such segments are not copied to the new log, so lagging followers that "
+            "still need them would be remote bootstrapped.");
+TAG_FLAG(skip_flushed_log_segments_during_bootstrap, advanced);
+
 DEFINE_test_flag(double, fault_crash_during_log_replay, 0.0,
                  "Fraction of the time when the tablet will crash immediately "
                  "after processing a log entry during log replay.");
 
 DECLARE_uint64(max_clock_sync_error_usec);
+DECLARE_int32(log_min_segments_to_retain);
 
 namespace yb {
 namespace tablet {
@@ -101,6 +119,92 @@ static string DebugInfo(const string& tablet_id,
                     segment_path, debug_str);
 }
 
+namespace {
+
+struct ReadSegmentResult {
+  log::LogEntries entries;
+  Status status;
+};
+
+ReadSegmentResult ReadSegment(const scoped_refptr<ReadableLogSegment>& segment) {
+  ReadSegmentResult result;
+  result.status = segment->ReadEntries(&result.entries);
+  return result;
+}
+
+// Reads log segments in order, decoding and checking CRCs of up to read_ahead segments in a
+// thread pool while the caller replays the previous ones.
+class SegmentReader {
+ public:
+  SegmentReader(const log::SegmentSequence& segments, ThreadPool* pool, size_t read_ahead)
+      : segments_(segments), pool_(pool), read_ahead_(pool ? read_ahead : 0) {}
+
+  ~SegmentReader() {
+    // Submitted tasks only reference their own segment and promise, but wait for them anyway, so
+    // we don't keep reading the log after bootstrap has returned.
+    for (auto& future : pending_) {
+      future.wait();
+    }
+  }
+
+  ReadSegmentResult Next() {
+    while (pending_.size() < read_ahead_ && next_to_submit_ < segments_.size() &&
+           Submit(segments_[next_to_submit_])) {
+      ++next_to_submit_;
+    }
+    if (pending_.empty()) {
+      // Read ahead is disabled or we could not submit a task, so read synchronously.
+      return ReadSegment(segments_[next_to_submit_++]);
+    }
+    auto result = pending_.front().get();
+    pending_.pop_front();
+    return result;
+  }
+
+ private:
+  bool Submit(const scoped_refptr<ReadableLogSegment>& segment) {
+    auto promise = std::make_shared<std::promise<ReadSegmentResult>>();
+    auto future = promise->get_future();
+    auto status = pool_->SubmitFunc([promise, segment] {
+      promise->set_value(ReadSegment(segment));
+    });
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to submit log segment read ahead: " << status;
+      read_ahead_ = 0;
+      return false;
+    }
+    pending_.push_back(std::move(future));
+    return true;
+  }
+
+  const log::SegmentSequence& segments_;
+  ThreadPool* const pool_;
+  size_t read_ahead_;
+  size_t next_to_submit_ = 0;
+  std::deque<std::future<ReadSegmentResult>> pending_;
+};
+
+// Returns the number of leading segments that contain only entries with index below
+// flushed_index. The segment containing the entry with flushed_index itself is always kept,
+// because bootstrap uses it to restore the last replicated hybrid time.
+size_t NumFlushedSegments(const log::SegmentSequence& segments, int64_t flushed_index) {
+  const size_t max_to_skip = segments.size() > FLAGS_log_min_segments_to_retain
+      ? segments.size() - FLAGS_log_min_segments_to_retain : 0;
+  size_t result = 0;
+  while (result < max_to_skip) {
+    const auto& segment = segments[result];
+    // Segments without footer, i.e. not closed properly, could not be checked without reading.
+    if (!segment->HasFooter() || segment->footer().max_replicate_index() < 0 ||
+        segment->footer().max_replicate_index() >= flushed_index) {
+      break;
+    }
+    ++result;
+  }
+  return result;
+}
+
+} // namespace
+
 // ============================================================================
 //  Class ReplayState.
 // ============================================================================
@@ -557,6 +661,9 @@ Status TabletBootstrap::HandleOperation(OperationType op_type,
     case consensus::TRUNCATE_OP:
       return PlayTruncateRequest(replicate);
 
+    case consensus::INGEST_SST_FILES_OP:
+      return PlayIngestSSTFilesRequest(replicate);
+
     case consensus::NO_OP:
       return PlayNoOpRequest(replicate);
 
@@ -641,11 +748,35 @@ Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
   // from the log we're reading into the log we're writing.
   RETURN_NOT_OK_PREPEND(OpenNewLog(), "Failed to open new log");
 
+  if (FLAGS_skip_flushed_log_segments_during_bootstrap &&
+      state.last_stored_op_id.term() > yb::OpId::kUnknownTerm) {
+    const size_t num_flushed = NumFlushedSegments(segments, state.last_stored_op_id.index());
+    if (num_flushed > 0) {
+      LOG_WITH_PREFIX(INFO) << "Skipping " << num_flushed << " log segments up to "
+                            << segments[num_flushed - 1]->path() << ", already flushed to RocksDB";
+      segments.erase(segments.begin(), segments.begin() + num_flushed);
+      stats_.segments_skipped += num_flushed;
+    }
+  }
+
+  // Reading and decoding segments is done ahead on a thread pool, while entries are still applied
+  // in order on this thread.
+  std::unique_ptr<ThreadPool> read_pool;
+  if (FLAGS_bootstrap_log_read_ahead_segments > 0 && segments.size() > 1) {
+    RETURN_NOT_OK(ThreadPoolBuilder("log-read-ahead")
+                      .set_min_threads(0)
+                      .set_max_threads(FLAGS_bootstrap_log_read_ahead_segments)
+                      .Build(&read_pool));
+  }
+  SegmentReader segment_reader(
+      segments, read_pool.get(), std::max(FLAGS_bootstrap_log_read_ahead_segments, 0));
+
   int segment_count = 0;
   for (const scoped_refptr<ReadableLogSegment>& segment : segments) {
-    log::LogEntries entries;
     // TODO: Optimize this to not read the whole thing into memory?
-    Status read_status = segment->ReadEntries(&entries);
+    auto read_result = segment_reader.Next();
+    log::LogEntries& entries = read_result.entries;
+    const Status& read_status = read_result.status;
     for (int entry_idx = 0; entry_idx < entries.size(); ++entry_idx) {
       Status s = HandleEntry(&state, &entries[entry_idx]);
       if (!s.ok()) {
@@ -796,6 +927,18 @@ Status TabletBootstrap::PlayTruncateRequest(ReplicateMsg* replicate_msg) {
   return Status::OK();
 }
 
+Status TabletBootstrap::PlayIngestSSTFilesRequest(ReplicateMsg* replicate_msg) {
+  IngestSSTFilesOperationState operation_state(
+      nullptr, replicate_msg->mutable_ingest_sst_files_request());
+  operation_state.mutable_op_id()->CopyFrom(replicate_msg->id());
+
+  // The operation is only replayed when the tablet crashed while ingesting, so some of the files
+  // could already be in RocksDB and fail to be ingested again as overlapping.
+  WARN_NOT_OK(tablet_->IngestSSTFiles(&operation_state),
+              LogPrefix() + "Failed to replay SST files ingestion");
+  return Status::OK();
+}
+
 Status TabletBootstrap::PlayUpdateTransactionRequest(ReplicateMsg* replicate_msg) {
   DCHECK(replicate_msg->has_hybrid_time());
 
@@ -830,9 +973,11 @@ string TabletBootstrap::LogPrefix() const {
 //  Class TabletBootstrap::Stats.
 // ============================================================================
 string TabletBootstrap::Stats::ToString() const {
-  return Substitute("ops{read=$0 overwritten=$1} "
-                    "inserts{seen=$2 ignored=$3} "
-                    "mutations{seen=$4 ignored=$5}",
+  return Substitute("segments{skipped=$0} "
+                    "ops{read=$1 overwritten=$2} "
+                    "inserts{seen=$3 ignored=$4} "
+                    "mutations{seen=$5 ignored=$6}",
+                    segments_skipped,
                     ops_read, ops_overwritten,
                     inserts_seen, inserts_ignored,
                     mutations_seen, mutations_ignored);
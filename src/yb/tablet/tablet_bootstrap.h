@@ -186,6 +186,8 @@ class TabletBootstrap {
 
   Status PlayTruncateRequest(consensus::ReplicateMsg* replicate_msg);
 
+  Status PlayIngestSSTFilesRequest(consensus::ReplicateMsg* replicate_msg);
+
   void DumpReplayStateToLog(const ReplayState& state);
 
   // Handlers for each type of message seen in the log during replay.
@@ -222,7 +224,8 @@ class TabletBootstrap {
   // Statistics on the replay of entries in the log.
   struct Stats {
     Stats()
-      : ops_read(0),
+      : segments_skipped(0),
+        ops_read(0),
         ops_overwritten(0),
         inserts_seen(0),
         inserts_ignored(0),
@@ -232,6 +235,10 @@ class TabletBootstrap {
 
     std::string ToString() const;
 
+    // Number of log segments that were not read, because all of their entries are already flushed
+    // to RocksDB.
+    int segments_skipped;
+
     // Number of REPLICATE messages read from the log
     int ops_read;
 
@@ -0,0 +1,119 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/tablet_hotspots.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(tablet_hotspot_half_life_sec, 30,
+             "Half-life of the decaying per-tablet operation and byte rates, and of the hot key "
+             "counts, reported to the master.");
+TAG_FLAG(tablet_hotspot_half_life_sec, advanced);
+TAG_FLAG(tablet_hotspot_half_life_sec, runtime);
+
+DEFINE_int32(tablet_hot_key_sample_every, 64,
+             "Track the key of one in this many tablet operations to find the hot keys of the "
+             "tablet. 0 disables hot key tracking.");
+TAG_FLAG(tablet_hot_key_sample_every, advanced);
+TAG_FLAG(tablet_hot_key_sample_every, runtime);
+
+DEFINE_int32(tablet_num_hot_keys, 5, "Number of hot keys tracked per tablet.");
+TAG_FLAG(tablet_num_hot_keys, advanced);
+
+namespace yb {
+namespace tablet {
+
+namespace {
+
+// Dimensions of the count-min sketch of sampled keys, about 16KB per tablet.
+constexpr size_t kHotKeysSketchWidth = 512;
+constexpr size_t kHotKeysSketchDepth = 4;
+
+// Rates are not updated more often than this, to avoid noisy instantaneous rates.
+const MonoDelta kMinRateUpdateInterval = MonoDelta::FromSeconds(1);
+
+} // namespace
+
+TabletHotspots::TabletHotspots()
+    : last_halved_(MonoTime::Now()),
+      hot_keys_(FLAGS_tablet_num_hot_keys, kHotKeysSketchWidth, kHotKeysSketchDepth) {
+}
+
+bool TabletHotspots::ShouldSampleKey() {
+  const int sample_every = FLAGS_tablet_hot_key_sample_every;
+  if (sample_every <= 0 || ops_until_sample_.fetch_sub(1, std::memory_order_relaxed) > 1) {
+    return false;
+  }
+  ops_until_sample_.store(sample_every, std::memory_order_relaxed);
+  return true;
+}
+
+void TabletHotspots::RecordKey(Slice key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  hot_keys_.Add(key);
+}
+
+TabletLoad TabletHotspots::GetLoad() {
+  const double half_life_sec = std::max(FLAGS_tablet_hotspot_half_life_sec, 1);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Counters are read under the lock, so they never go below the ones of the previous update.
+  const auto reads = reads_.load(std::memory_order_relaxed);
+  const auto writes = writes_.load(std::memory_order_relaxed);
+  const auto read_bytes = read_bytes_.load(std::memory_order_relaxed);
+  const auto write_bytes = write_bytes_.load(std::memory_order_relaxed);
+  const auto now = MonoTime::Now();
+  const bool first_update = !prev_update_.Initialized();
+  if (first_update || now - prev_update_ >= kMinRateUpdateInterval) {
+    if (!first_update) {
+      const double elapsed_sec = (now - prev_update_).ToSeconds();
+      // Weight of the rate over the elapsed interval in the exponentially decaying average.
+      const double weight = 1 - std::exp2(-elapsed_sec / half_life_sec);
+      auto update = [weight, elapsed_sec](uint64_t total, uint64_t prev, double* rate) {
+        *rate += weight * ((total - prev) / elapsed_sec - *rate);
+      };
+      update(reads, prev_reads_, &load_.read_ops_per_sec);
+      update(writes, prev_writes_, &load_.write_ops_per_sec);
+      update(read_bytes, prev_read_bytes_, &load_.read_bytes_per_sec);
+      update(write_bytes, prev_write_bytes_, &load_.write_bytes_per_sec);
+    }
+    prev_reads_ = reads;
+    prev_writes_ = writes;
+    prev_read_bytes_ = read_bytes;
+    prev_write_bytes_ = write_bytes;
+    prev_update_ = now;
+  }
+
+  if ((now - last_halved_).ToSeconds() >= half_life_sec) {
+    hot_keys_.Halve();
+    last_halved_ = now;
+  }
+
+  TabletLoad result = load_;
+  const auto total = hot_keys_.total();
+  if (total != 0) {
+    for (auto& entry : hot_keys_.TopKeys()) {
+      result.hot_keys.emplace_back(std::move(entry.first),
+                                   std::min(1.0, static_cast<double>(entry.second) / total));
+    }
+  }
+  return result;
+}
+
+} // namespace tablet
+} // namespace yb
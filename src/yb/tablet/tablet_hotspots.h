@@ -0,0 +1,104 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_TABLET_HOTSPOTS_H
+#define YB_TABLET_TABLET_HOTSPOTS_H
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "yb/gutil/macros.h"
+#include "yb/util/count_min_sketch.h"
+#include "yb/util/monotime.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+namespace tablet {
+
+// Load of a tablet, as rates decayed over --tablet_hotspot_half_life_sec.
+struct TabletLoad {
+  double read_ops_per_sec = 0;
+  double write_ops_per_sec = 0;
+  double read_bytes_per_sec = 0;
+  double write_bytes_per_sec = 0;
+
+  // The most frequently accessed keys among the sampled operations, with the estimated fraction
+  // of the tablet operations that accessed them, most frequent first.
+  std::vector<std::pair<std::string, double>> hot_keys;
+};
+
+// Tracks how hot a tablet is: decaying read and write rates in operations and bytes, plus the
+// approximate top keys of a sample of the operations.
+//
+// Recording an operation costs a couple of relaxed atomic increments; only one in
+// --tablet_hot_key_sample_every operations is asked for its key and takes a lock.
+//
+// This class is thread-safe.
+class TabletHotspots {
+ public:
+  TabletHotspots();
+
+  // Records an operation. Returns true if its key should be passed to RecordKey.
+  bool RecordRead(size_t bytes) {
+    reads_.fetch_add(1, std::memory_order_relaxed);
+    read_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    return ShouldSampleKey();
+  }
+
+  bool RecordWrite(size_t bytes) {
+    writes_.fetch_add(1, std::memory_order_relaxed);
+    write_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    return ShouldSampleKey();
+  }
+
+  // Records the key of a sampled operation.
+  void RecordKey(Slice key);
+
+  // Updates the decaying rates with the operations recorded since the previous call and returns
+  // the current load.
+  TabletLoad GetLoad();
+
+ private:
+  bool ShouldSampleKey();
+
+  std::atomic<uint64_t> reads_{0};
+  std::atomic<uint64_t> writes_{0};
+  std::atomic<uint64_t> read_bytes_{0};
+  std::atomic<uint64_t> write_bytes_{0};
+  std::atomic<uint64_t> ops_until_sample_{0};
+
+  std::mutex mutex_;
+
+  // Totals and time of the previous rate update.
+  uint64_t prev_reads_ = 0;
+  uint64_t prev_writes_ = 0;
+  uint64_t prev_read_bytes_ = 0;
+  uint64_t prev_write_bytes_ = 0;
+  MonoTime prev_update_;
+
+  // Time when the hot key counts were last halved.
+  MonoTime last_halved_;
+
+  TabletLoad load_;
+  HeavyHitters hot_keys_;
+
+  DISALLOW_COPY_AND_ASSIGN(TabletHotspots);
+};
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_TABLET_HOTSPOTS_H
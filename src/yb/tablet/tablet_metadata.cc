@@ -80,6 +80,8 @@ namespace yb {
 namespace tablet {
 
 const int64 kNoDurableMemStore = -1;
+const char* const kIntentsDBDirName = "intents";
+const char* const kCheckpointsDirName = "checkpoints";
 
 // ============================================================================
 //  Tablet Metadata
@@ -199,13 +201,11 @@ Status TabletMetadata::DeleteTabletData(TabletDataState delete_type,
     }
   }
 
-  rocksdb::Options rocksdb_options;
-  TabletOptions tablet_options;
-  docdb::InitRocksDBOptions(
-      &rocksdb_options, tablet_id_, nullptr /* statistics */, tablet_options);
-
+  // The whole directory is renamed and deleted in the background, including the intents DB and
+  // the checkpoints of remote bootstrap sessions nested in it, so dropping a large table does not
+  // block on unlinking its files.
   LOG(INFO) << "Destroying RocksDB at: " << rocksdb_dir_;
-  rocksdb::Status status = rocksdb::DestroyDB(rocksdb_dir_, rocksdb_options);
+  Status status = docdb::DestroyDBInBackground(rocksdb_dir_);
 
   if (!status.ok()) {
     LOG(ERROR) << "Failed to destroy RocksDB at: " << rocksdb_dir_ << ": "
@@ -273,6 +273,7 @@ TabletMetadata::TabletMetadata(FsManager* fs_manager,
       wal_dir_(wal_dir),
       partition_schema_(std::move(partition_schema)),
       tablet_data_state_(tablet_data_state),
+      frozen_(false),
       tombstone_last_logged_opid_(MinimumOpId()),
       num_flush_pins_(0),
       needs_flush_(false) {
@@ -290,6 +291,7 @@ TabletMetadata::TabletMetadata(FsManager* fs_manager, string tablet_id)
       tablet_id_(std::move(tablet_id)),
       fs_manager_(fs_manager),
       schema_(nullptr),
+      frozen_(false),
       tombstone_last_logged_opid_(MinimumOpId()),
       num_flush_pins_(0),
       needs_flush_(false) {}
@@ -350,6 +352,7 @@ Status TabletMetadata::LoadFromSuperBlock(const TabletSuperBlockPB& superblock)
     }
 
     tablet_data_state_ = superblock.tablet_data_state();
+    frozen_ = superblock.frozen();
 
     deleted_cols_.clear();
     for (const DeletedColumnPB& deleted_col : superblock.deleted_cols()) {
@@ -536,6 +539,9 @@ Status TabletMetadata::ToSuperBlockUnlocked(TabletSuperBlockPB* super_block) con
                         "Couldn't serialize schema into superblock");
 
   pb.set_tablet_data_state(tablet_data_state_);
+  if (frozen_) {
+    pb.set_frozen(true);
+  }
   if (!consensus::OpIdEquals(tombstone_last_logged_opid_, MinimumOpId())) {
     *pb.mutable_tombstone_last_logged_opid() = tombstone_last_logged_opid_;
   }
@@ -595,6 +601,10 @@ uint32_t TabletMetadata::schema_version() const {
   return schema_version_;
 }
 
+string TabletMetadata::intents_rocksdb_dir() const {
+  return JoinPathSegments(rocksdb_dir_, kIntentsDBDirName);
+}
+
 string TabletMetadata::data_root_dir() const {
   if (rocksdb_dir_.empty()) {
     return "";
@@ -624,6 +634,16 @@ void TabletMetadata::set_tablet_data_state(TabletDataState state) {
   tablet_data_state_ = state;
 }
 
+void TabletMetadata::set_frozen(bool frozen) {
+  std::lock_guard<LockType> l(data_lock_);
+  frozen_ = frozen;
+}
+
+bool TabletMetadata::frozen() const {
+  std::lock_guard<LockType> l(data_lock_);
+  return frozen_;
+}
+
 string TabletMetadata::LogPrefix() const {
   return Substitute("T $0 P $1: ", tablet_id_, fs_manager_->uuid());
 }
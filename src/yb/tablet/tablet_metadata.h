@@ -60,6 +60,14 @@ namespace tablet {
 
 extern const int64 kNoDurableMemStore;
 
+// Name of the directory of the intents RocksDB, relative to the regular RocksDB directory.
+extern const char* const kIntentsDBDirName;
+
+// Name of the directory with the RocksDB checkpoints served by remote bootstrap sessions, relative
+// to the regular RocksDB directory. The checkpoints hard link the SST files, so they don't have to
+// be kept by the tablet itself while a session is running.
+extern const char* const kCheckpointsDirName;
+
 // Manages the "blocks tracking" for the specified tablet.
 //
 // TabletMetadata is owned by the Tablet. As new blocks are written to store
@@ -132,6 +140,11 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
 
   std::string rocksdb_dir() const { return rocksdb_dir_; }
 
+  // Directory of the RocksDB instance that keeps the transaction intents of this tablet, when they
+  // are stored separately from the regular records. It is nested in rocksdb_dir(), so it is
+  // checkpointed and removed together with the regular records.
+  std::string intents_rocksdb_dir() const;
+
   std::string wal_dir() const { return wal_dir_; }
 
   // Given the data directory of a tablet, returns the data root dir for that tablet.
@@ -170,6 +183,10 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
   void set_tablet_data_state(TabletDataState state);
   TabletDataState tablet_data_state() const;
 
+  // Set / get whether the tablet is frozen, i.e. its RocksDB is opened read only.
+  void set_frozen(bool frozen);
+  bool frozen() const;
+
   // Increments flush pin count by one: if flush pin count > 0,
   // metadata will _not_ be flushed to disk during Flush().
   void PinFlush();
@@ -350,6 +367,9 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
   // The current state of remote bootstrap for the tablet.
   TabletDataState tablet_data_state_;
 
+  // Whether the tablet is frozen. Protected by 'data_lock_'.
+  bool frozen_;
+
   // Record of the last opid logged by the tablet before it was last
   // tombstoned. Has no meaning for non-tombstoned tablets.
   consensus::OpId tombstone_last_logged_opid_;
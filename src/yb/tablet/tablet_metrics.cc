@@ -32,6 +32,7 @@
 #include "yb/tablet/tablet_metrics.h"
 
 #include "yb/gutil/strings/substitute.h"
+#include "yb/rocksdb/iostats_context.h"
 #include "yb/util/metrics.h"
 #include "yb/util/trace.h"
 
@@ -126,6 +127,11 @@ METRIC_DEFINE_histogram(
     tablet, write_lock_latency, "Write lock latency", yb::MetricUnit::kMicroseconds,
     "Time taken to acquire key locks for a write operation", 60000000LU, 2);
 
+METRIC_DEFINE_counter(tablet, write_lock_waits, "Write lock waits",
+    yb::MetricUnit::kRequests,
+    "Number of key locks that could not be granted immediately because of a conflicting "
+    "holder");
+
 METRIC_DEFINE_gauge_uint32(tablet, compact_rs_running,
   "RowSet Compactions Running",
   yb::MetricUnit::kMaintenanceOperations,
@@ -156,11 +162,52 @@ METRIC_DEFINE_histogram(tablet, delta_major_compact_rs_duration,
   yb::MetricUnit::kSeconds,
   "Seconds spent major delta compacting.", 60000000LU, 2);
 
+METRIC_DEFINE_counter(tablet, user_read_bytes, "User Read Bytes",
+  yb::MetricUnit::kBytes,
+  "Number of bytes read from SST files by user read requests. Flush, compaction and WAL IO of "
+  "the tablet is reported by the rocksdb_flush_write_bytes, rocksdb_compact_read_bytes, "
+  "rocksdb_compact_write_bytes and log_bytes_logged metrics.");
+
+METRIC_DEFINE_counter(tablet, user_read_ops, "User Read Operations",
+  yb::MetricUnit::kOperations,
+  "Number of reads from SST files done by user read requests, i.e. block cache misses that "
+  "went to disk or to the OS page cache.");
+
 METRIC_DEFINE_counter(tablet, leader_memory_pressure_rejections,
   "Leader Memory Pressure Rejections",
   yb::MetricUnit::kRequests,
   "Number of RPC requests rejected due to memory pressure while LEADER.");
 
+METRIC_DEFINE_counter(tablet, write_pressure_throttled_requests,
+  "Write Pressure Throttled Requests",
+  yb::MetricUnit::kRequests,
+  "Number of write RPC requests the LEADER asked the client to retry later because the "
+  "memstore, the log cache or pending compactions approached their limits.");
+
+METRIC_DEFINE_counter(tablet, table_quota_rejections,
+  "Table Quota Rejections",
+  yb::MetricUnit::kRequests,
+  "Number of read and write RPC requests rejected because the table exceeded its quota of "
+  "operations or bytes per second on this tablet server.");
+
+METRIC_DEFINE_counter(tablet, expired_requests_dropped,
+  "Expired Requests Dropped",
+  yb::MetricUnit::kRequests,
+  "Number of read and write RPC requests dropped before an expensive stage of their execution "
+  "because their client deadline had already passed.");
+
+METRIC_DEFINE_counter(tablet, leader_lease_read_rejections,
+  "Leader Lease Read Rejections",
+  yb::MetricUnit::kRequests,
+  "Number of strongly consistent reads rejected because this peer was not a leader holding a "
+  "lease, including the reads of a new leader waiting for the lease of the old one to expire.");
+
+METRIC_DEFINE_counter(tablet, stale_follower_read_rejections,
+  "Stale Follower Read Rejections",
+  yb::MetricUnit::kRequests,
+  "Number of follower reads rejected because the safe time of the follower was older than the "
+  "staleness bound of the read.");
+
 using strings::Substitute;
 
 namespace yb {
@@ -180,8 +227,16 @@ TabletMetrics::TabletMetrics(const scoped_refptr<MetricEntity>& entity)
     MINIT(redis_read_latency),
     MINIT(ql_read_latency),
     MINIT(write_lock_latency),
+    MINIT(write_lock_waits),
     MINIT(write_op_duration_client_propagated_consistency),
-    MINIT(leader_memory_pressure_rejections) {
+    MINIT(user_read_bytes),
+    MINIT(user_read_ops),
+    MINIT(leader_memory_pressure_rejections),
+    MINIT(write_pressure_throttled_requests),
+    MINIT(table_quota_rejections),
+    MINIT(expired_requests_dropped),
+    MINIT(leader_lease_read_rejections),
+    MINIT(stale_follower_read_rejections) {
 }
 #undef MINIT
 #undef GINIT
@@ -192,5 +247,16 @@ ScopedTabletMetricsTracker::ScopedTabletMetricsTracker(scoped_refptr<Histogram>
 ScopedTabletMetricsTracker::~ScopedTabletMetricsTracker() {
   latency_->Increment(MonoTime::Now().GetDeltaSince(start_time_).ToMicroseconds());
 }
+
+ScopedTabletReadIOTracker::ScopedTabletReadIOTracker(TabletMetrics* metrics)
+    : metrics_(metrics),
+      start_bytes_read_(rocksdb::iostats_context.bytes_read),
+      start_read_ops_(rocksdb::iostats_context.read_ops) {}
+
+ScopedTabletReadIOTracker::~ScopedTabletReadIOTracker() {
+  // The IO stats context is per thread, and reads are served on the thread that handles them.
+  metrics_->user_read_bytes->IncrementBy(rocksdb::iostats_context.bytes_read - start_bytes_read_);
+  metrics_->user_read_ops->IncrementBy(rocksdb::iostats_context.read_ops - start_read_ops_);
+}
 } // namespace tablet
 } // namespace yb
@@ -32,6 +32,8 @@
 #ifndef YB_TABLET_TABLET_METRICS_H
 #define YB_TABLET_TABLET_METRICS_H
 
+#include <stdint.h>
+
 #include "yb/gutil/macros.h"
 #include "yb/gutil/ref_counted.h"
 
@@ -66,10 +68,22 @@ struct TabletMetrics {
   scoped_refptr<Histogram> redis_read_latency;
   scoped_refptr<Histogram> ql_read_latency;
   scoped_refptr<Histogram> write_lock_latency;
+  scoped_refptr<Counter> write_lock_waits;
   scoped_refptr<Histogram> write_op_duration_client_propagated_consistency;
   scoped_refptr<Histogram> write_op_duration_commit_wait_consistency;
 
+  // IO done by user reads.
+  scoped_refptr<Counter> user_read_bytes;
+  scoped_refptr<Counter> user_read_ops;
+
   scoped_refptr<Counter> leader_memory_pressure_rejections;
+  scoped_refptr<Counter> write_pressure_throttled_requests;
+  scoped_refptr<Counter> table_quota_rejections;
+  scoped_refptr<Counter> expired_requests_dropped;
+
+  // Reads rejected by consistency checks.
+  scoped_refptr<Counter> leader_lease_read_rejections;
+  scoped_refptr<Counter> stale_follower_read_rejections;
 };
 
 class ScopedTabletMetricsTracker {
@@ -82,6 +96,21 @@ class ScopedTabletMetricsTracker {
   MonoTime start_time_;
 };
 
+// Attributes the SST file IO done by the current thread during its lifetime to user reads of the
+// tablet.
+class ScopedTabletReadIOTracker {
+ public:
+  explicit ScopedTabletReadIOTracker(TabletMetrics* metrics);
+  ~ScopedTabletReadIOTracker();
+
+ private:
+  TabletMetrics* metrics_;
+  uint64_t start_bytes_read_;
+  uint64_t start_read_ops_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedTabletReadIOTracker);
+};
+
 } // namespace tablet
 } // namespace yb
 #endif /* YB_TABLET_TABLET_METRICS_H */
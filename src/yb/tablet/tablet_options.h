@@ -14,6 +14,7 @@
 #define YB_TABLET_TABLET_OPTIONS_H
 
 namespace rocksdb {
+class CompactionScheduler;
 class EventListener;
 }
 
@@ -22,7 +23,13 @@ namespace tablet {
 
 struct TabletOptions {
   std::shared_ptr<rocksdb::Cache> block_cache;
+  // Second tier behind block_cache, that keeps compressed blocks.
+  std::shared_ptr<rocksdb::Cache> block_cache_compressed;
   std::shared_ptr<rocksdb::MemoryMonitor> memory_monitor;
+  // Open SST files of all tablets, within a single file descriptor budget.
+  std::shared_ptr<rocksdb::Cache> table_cache;
+  // Admits compactions of all tablets into a shared pool by priority.
+  std::shared_ptr<rocksdb::CompactionScheduler> compaction_scheduler;
   std::vector<std::shared_ptr<rocksdb::EventListener>> listeners;
 };
 
@@ -51,6 +51,7 @@
 #include "yb/tablet/operations/operation.h"
 #include "yb/tablet/operations/operation_driver.h"
 #include "yb/tablet/operations/write_operation.h"
+#include "yb/tablet/tablet_metrics.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tablet/tablet_peer_mm_ops.h"
 #include "yb/tablet/tablet-test-util.h"
@@ -442,6 +443,24 @@ TEST_P(TabletPeerTest, TestGCEmptyLog) {
   ASSERT_OK(tablet_peer_->RunLogGC());
 }
 
+// A write whose client deadline has already passed is dropped instead of being replicated.
+TEST_P(TabletPeerTest, TestExpiredWriteIsDropped) {
+  ConsensusBootstrapInfo info;
+  ASSERT_OK(StartPeer(info));
+
+  WriteRequestPB req;
+  GenerateSequentialInsertRequest(&req);
+  WriteResponsePB resp;
+  auto operation_state = std::make_unique<WriteOperationState>(
+      tablet_peer_->tablet(), &req, &resp);
+  auto deadline = MonoTime::Now();
+  deadline.AddDelta(MonoDelta::FromMilliseconds(-1));
+  operation_state->set_deadline(deadline);
+  auto status = tablet_peer_->SubmitWrite(std::move(operation_state));
+  ASSERT_TRUE(status.IsTimedOut()) << status;
+  ASSERT_EQ(1, tablet_peer_->tablet()->metrics()->expired_requests_dropped->value());
+}
+
 INSTANTIATE_TEST_CASE_P(Rocks, TabletPeerTest, ::testing::Values(YQL_TABLE_TYPE));
 
 } // namespace tablet
@@ -62,6 +62,7 @@
 
 #include "yb/tablet/operations/alter_schema_operation.h"
 #include "yb/tablet/operations/operation_driver.h"
+#include "yb/tablet/operations/ingest_sst_files_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/write_operation.h"
 #include "yb/tablet/operations/update_txn_operation.h"
@@ -190,7 +191,7 @@ Status TabletPeer::InitTabletPeer(const shared_ptr<TabletClass> &tablet,
         return consensus_->majority_replicated_ht_lease_expiration();
     });
 
-    prepare_thread_ = std::make_unique<PrepareThread>(consensus_.get());
+    prepare_thread_ = std::make_unique<PrepareThread>(consensus_.get(), metric_entity);
   }
 
   RETURN_NOT_OK(prepare_thread_->Start());
@@ -372,8 +373,12 @@ Status TabletPeer::SubmitWrite(std::unique_ptr<WriteOperationState> state) {
   auto operation = std::make_unique<WriteOperation>(std::move(state), consensus::LEADER);
   RETURN_NOT_OK(CheckRunning());
 
+  // Waiting for the locks could take long under contention, so the deadline is checked both
+  // before and after. Nothing is replicated yet, so the write could still be dropped.
+  RETURN_NOT_OK(CheckWriteDeadline(*operation->state(), "acquiring locks"));
   HybridTime restart_read_ht;
   RETURN_NOT_OK(tablet_->AcquireLocksAndPerformDocOperations(operation->state(), &restart_read_ht));
+  RETURN_NOT_OK(CheckWriteDeadline(*operation->state(), "replication"));
   // If a restart read is required, then we return this fact to caller and don't perform the write
   // operation.
   if (restart_read_ht.is_valid()) {
@@ -390,6 +395,14 @@ Status TabletPeer::SubmitWrite(std::unique_ptr<WriteOperationState> state) {
   return Status::OK();
 }
 
+Status TabletPeer::CheckWriteDeadline(const WriteOperationState& state, const char* stage) {
+  if (PREDICT_TRUE(state.deadline() == MonoTime::Max() || MonoTime::Now() < state.deadline())) {
+    return Status::OK();
+  }
+  tablet_->metrics()->expired_requests_dropped->Increment();
+  return STATUS_FORMAT(TimedOut, "Write passed its deadline before $0", stage);
+}
+
 void TabletPeer::Submit(std::unique_ptr<Operation> operation) {
   auto status = CheckRunning();
 
@@ -483,6 +496,9 @@ void TabletPeer::GetInFlightOperations(Operation::TraceType trace_type,
         case Operation::SNAPSHOT_TXN:
           status_pb.set_operation_type(consensus::SNAPSHOT_OP);
           break;
+        case Operation::INGEST_SST_FILES_TXN:
+          status_pb.set_operation_type(consensus::INGEST_SST_FILES_OP);
+          break;
 
         default:
           FATAL_INVALID_ENUM_VALUE(Operation::OperationType, driver->operation_type());
@@ -583,6 +599,28 @@ Status TabletPeer::GetGCableDataSize(int64_t* retention_size) const {
   return Status::OK();
 }
 
+Status TabletPeer::GetMemStoreRetainedLogSize(int64_t* retention_size) const {
+  RETURN_NOT_OK(CheckRunning());
+  *retention_size = 0;
+  int64_t last_committed_write_index = tablet_->last_committed_write_index();
+  Result<yb::OpId> max_persistent_op_id = tablet_->MaxPersistentOpId();
+  RETURN_NOT_OK(max_persistent_op_id);
+  if (max_persistent_op_id.get_ptr()->index >= last_committed_write_index) {
+    // All writes are flushed, so the memstore does not anchor the log.
+    return Status::OK();
+  }
+  MaxIdxToSegmentSizeMap idx_size_map;
+  RETURN_NOT_OK(GetMaxIndexesToSegmentSizeMap(&idx_size_map));
+  // Segments that end before the last committed write could be GCed once it is flushed.
+  for (const auto& entry : idx_size_map) {
+    if (entry.first >= last_committed_write_index) {
+      break;
+    }
+    *retention_size += entry.second;
+  }
+  return Status::OK();
+}
+
 std::unique_ptr<Operation> TabletPeer::CreateOperation(consensus::ReplicateMsg* replicate_msg) {
   switch (replicate_msg->op_type()) {
     case consensus::WRITE_OP:
@@ -609,6 +647,12 @@ std::unique_ptr<Operation> TabletPeer::CreateOperation(consensus::ReplicateMsg*
       return std::make_unique<TruncateOperation>(
           std::make_unique<TruncateOperationState>(tablet()), consensus::REPLICA);
 
+    case consensus::INGEST_SST_FILES_OP:
+      DCHECK(replicate_msg->has_ingest_sst_files_request()) << "INGEST_SST_FILES_OP replica"
+          " operation must receive an IngestSSTFilesRequestPB";
+      return std::make_unique<IngestSSTFilesOperation>(
+          std::make_unique<IngestSSTFilesOperationState>(tablet()), consensus::REPLICA);
+
     case consensus::SNAPSHOT_OP: FALLTHROUGH_INTENDED;
     case consensus::UNKNOWN_OP: FALLTHROUGH_INTENDED;
     case consensus::NO_OP: FALLTHROUGH_INTENDED;
@@ -653,6 +697,14 @@ Status TabletPeer::StartReplicaOperation(const scoped_refptr<ConsensusRound>& ro
   return Status::OK();
 }
 
+void TabletPeer::StartApplyingCommittedOperations() {
+  tablet_->StartApplyBatch();
+}
+
+void TabletPeer::FinishApplyingCommittedOperations() {
+  tablet_->FinishApplyBatch();
+}
+
 string TabletPeer::permanent_uuid() const {
   if (cached_permanent_uuid_initialized_.load(std::memory_order_acquire)) {
     return cached_permanent_uuid_;
@@ -694,6 +746,10 @@ void TabletPeer::RegisterMaintenanceOps(MaintenanceManager* maint_mgr) {
   gscoped_ptr<MaintenanceOp> log_gc(new LogGCOp(this));
   maint_mgr->RegisterOp(log_gc.get());
   maintenance_ops_.push_back(log_gc.release());
+
+  gscoped_ptr<MaintenanceOp> deleted_columns_compaction(new DeletedColumnsCompactionOp(this));
+  maint_mgr->RegisterOp(deleted_columns_compaction.get());
+  maintenance_ops_.push_back(deleted_columns_compaction.release());
 }
 
 void TabletPeer::UnregisterMaintenanceOps() {
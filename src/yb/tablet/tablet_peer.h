@@ -150,6 +150,10 @@ class TabletPeer : public RefCountedThreadSafe<TabletPeer>,
   virtual CHECKED_STATUS StartReplicaOperation(
       const scoped_refptr<consensus::ConsensusRound>& round) override;
 
+  // Coalesce the writes of operations committed together, see Tablet::StartApplyBatch().
+  void StartApplyingCommittedOperations() override;
+  void FinishApplyingCommittedOperations() override;
+
   consensus::Consensus* consensus() const {
     std::lock_guard<simple_spinlock> lock(lock_);
     return consensus_.get();
@@ -229,6 +233,12 @@ class TabletPeer : public RefCountedThreadSafe<TabletPeer>,
   // Returns a non-ok status if the tablet isn't running.
   CHECKED_STATUS GetGCableDataSize(int64_t* retention_size) const;
 
+  // Returns the amount of log bytes that are retained only because the latest writes are still in
+  // the memstore, i.e. roughly what a flush followed by RunLogGC() would free.
+  //
+  // Returns a non-ok status if the tablet isn't running.
+  CHECKED_STATUS GetMemStoreRetainedLogSize(int64_t* retention_size) const;
+
   // Return a pointer to the Log.
   // TabletPeer keeps a reference to Log after Init().
   log::Log* log() const {
@@ -374,6 +384,9 @@ class TabletPeer : public RefCountedThreadSafe<TabletPeer>,
   mutable std::string cached_permanent_uuid_;
 
  private:
+  // Returns TimedOut if the client deadline of the write passed before the given stage.
+  CHECKED_STATUS CheckWriteDeadline(const WriteOperationState& state, const char* stage);
+
   std::shared_future<client::YBClientPtr> client_future_;
 
   DISALLOW_COPY_AND_ASSIGN(TabletPeer);
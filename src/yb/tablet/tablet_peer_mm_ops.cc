@@ -36,6 +36,7 @@
 #include <map>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include <gflags/gflags.h>
 #include "yb/gutil/strings/substitute.h"
@@ -52,6 +53,16 @@ METRIC_DEFINE_histogram(tablet, log_gc_duration,
                         "Log GC Duration",
                         yb::MetricUnit::kMilliseconds,
                         "Time spent garbage collecting the logs.", 60000LU, 1);
+METRIC_DEFINE_gauge_uint32(tablet, deleted_columns_compaction_running,
+                           "Deleted Columns Compactions Running",
+                           yb::MetricUnit::kOperations,
+                           "Number of compactions of SST files with values of deleted columns "
+                           "currently running.");
+METRIC_DEFINE_histogram(tablet, deleted_columns_compaction_duration,
+                        "Deleted Columns Compaction Duration",
+                        yb::MetricUnit::kMilliseconds,
+                        "Time spent compacting SST files with values of deleted columns.",
+                        3600000LU, 1);
 
 namespace yb {
 namespace tablet {
@@ -107,5 +118,62 @@ scoped_refptr<AtomicGauge<uint32_t> > LogGCOp::RunningGauge() const {
   return log_gc_running_;
 }
 
+//
+// DeletedColumnsCompactionOp.
+//
+
+DeletedColumnsCompactionOp::DeletedColumnsCompactionOp(TabletPeer* tablet_peer)
+    : MaintenanceOp(StringPrintf("DeletedColumnsCompactionOp(%s)",
+                                 tablet_peer->tablet()->tablet_id().c_str()),
+                    MaintenanceOp::HIGH_IO_USAGE),
+      tablet_peer_(tablet_peer),
+      duration_(METRIC_deleted_columns_compaction_duration.Instantiate(
+                    tablet_peer->tablet()->GetMetricEntity())),
+      running_(METRIC_deleted_columns_compaction_running.Instantiate(
+                   tablet_peer->tablet()->GetMetricEntity(), 0)),
+      sem_(1) {}
+
+void DeletedColumnsCompactionOp::UpdateStats(MaintenanceOpStats* stats) {
+  std::vector<std::string> files;
+  uint64_t total_size = 0;
+  if (sem_.GetValue() != 1 ||
+      !tablet_peer_->tablet()->GetFilesWithDeletedColumns(&files, &total_size).ok() ||
+      files.empty()) {
+    return;
+  }
+  stats->set_runnable(true);
+  // Prefer the tablets where the most space can be reclaimed.
+  stats->set_perf_improvement(static_cast<double>(total_size) / (1LL << 30));
+  // The files are read and written once.
+  stats->set_estimated_io_bytes(2 * total_size);
+}
+
+bool DeletedColumnsCompactionOp::Prepare() {
+  return sem_.try_lock();
+}
+
+void DeletedColumnsCompactionOp::Perform() {
+  CHECK(!sem_.try_lock());
+
+  Status s = tablet_peer_->tablet()->CompactFilesWithDeletedColumns();
+  if (!s.ok()) {
+    LOG(WARNING) << name() << ": " << s.ToString();
+  }
+
+  sem_.unlock();
+}
+
+scoped_refptr<Histogram> DeletedColumnsCompactionOp::DurationHistogram() const {
+  return duration_;
+}
+
+scoped_refptr<AtomicGauge<uint32_t> > DeletedColumnsCompactionOp::RunningGauge() const {
+  return running_;
+}
+
+std::string DeletedColumnsCompactionOp::io_device() const {
+  return tablet_peer_->tablet()->metadata()->data_root_dir();
+}
+
 }  // namespace tablet
 }  // namespace yb
@@ -70,6 +70,34 @@ class LogGCOp : public MaintenanceOp {
   mutable Semaphore sem_;
 };
 
+// Maintenance task that compacts the SST files still holding values of columns deleted before the
+// history cutoff, so that the space of a dropped column is reclaimed without waiting for a full
+// compaction of the tablet to rewrite those files.
+//
+// Only one such op can run for a tablet at a time.
+class DeletedColumnsCompactionOp : public MaintenanceOp {
+ public:
+  explicit DeletedColumnsCompactionOp(TabletPeer* tablet_peer);
+
+  virtual void UpdateStats(MaintenanceOpStats* stats) override;
+
+  virtual bool Prepare() override;
+
+  virtual void Perform() override;
+
+  virtual scoped_refptr<Histogram> DurationHistogram() const override;
+
+  virtual scoped_refptr<AtomicGauge<uint32_t> > RunningGauge() const override;
+
+  virtual std::string io_device() const override;
+
+ private:
+  TabletPeer *const tablet_peer_;
+  scoped_refptr<Histogram> duration_;
+  scoped_refptr<AtomicGauge<uint32_t> > running_;
+  mutable Semaphore sem_;
+};
+
 } // namespace tablet
 } // namespace yb
 
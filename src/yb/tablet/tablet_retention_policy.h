@@ -30,9 +30,17 @@ class TabletRetentionPolicy : public docdb::HistoryRetentionPolicy {
   ColumnIdsPtr GetDeletedColumns() override;
   MonoDelta GetTableTTL() override;
 
+  HybridTime GetRestoreHybridTime() override { return restore_ht_.load(); }
+
+  // Makes the compactions remove the records written after restore_ht, see
+  // Tablet::RestoreToHybridTime. Pass an invalid hybrid time to go back to normal compactions.
+  void SetRestoreHybridTime(HybridTime restore_ht) { restore_ht_.store(restore_ht); }
+
  private:
   const Tablet* tablet_;
 
+  std::atomic<HybridTime> restore_ht_{HybridTime::kInvalidHybridTime};
+
   // The delta to be added to the current time to get the history cutoff timestamp. This is always
   // a negative amount.
   MonoDelta retention_delta_;
@@ -48,6 +48,7 @@
 #include "yb/tserver/tserver_service.pb.h"
 
 #include "yb/util/enums.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/kernel_stack_watchdog.h"
 #include "yb/util/metrics.h"
 #include "yb/util/random_util.h"
@@ -59,6 +60,13 @@ DEFINE_uint64(transaction_timeout_usec, 1500000, "Transaction expiration timeout
 DEFINE_uint64(transaction_check_interval_usec, 500000, "Transaction check interval in usec.");
 DEFINE_double(transaction_ignore_applying_probability_in_tests, 0,
               "Probability to ignore APPLYING update in tests.");
+DEFINE_uint64(transaction_heartbeat_replication_interval_usec, 500000,
+              "Heartbeat of a pending transaction is replicated only when its last replicated "
+              "heartbeat is at least that old. After leader change transaction expires if it was "
+              "not heard for transaction_timeout_usec since its last replicated heartbeat, so "
+              "this value plus transaction_heartbeat_usec should be less than "
+              "transaction_timeout_usec.");
+TAG_FLAG(transaction_heartbeat_replication_interval_usec, advanced);
 
 using namespace std::literals;
 using namespace std::placeholders;
@@ -107,7 +115,8 @@ class TransactionState {
       : context_(*context),
         id_(id),
         log_prefix_(Format("$0: ", to_string(id_))),
-        last_touch_(last_touch) {}
+        last_touch_(last_touch),
+        replicated_touch_(last_touch) {}
 
   // Id of transaction.
   const TransactionId& id() const {
@@ -115,7 +124,8 @@ class TransactionState {
   }
 
   // Time when we last heard from transaction. I.e. hybrid time of replicated raft log entry
-  // that updates status of this transaction.
+  // that updates status of this transaction, or time of heartbeat that was received by leader
+  // and was not replicated.
   HybridTime last_touch() const {
     return last_touch_;
   }
@@ -171,6 +181,11 @@ class TransactionState {
   // Clear all locks on this transaction.
   // Currently there is only one lock, but user of this function should not care about that.
   void ClearLocks() {
+    // Confirmations of written intents are not replicated, so the new leader could not receive
+    // all of them.
+    FailParallelCommit(STATUS(TryAgain, "Leader changed during parallel commit"));
+    written_tablets_.clear();
+
     if (replicating_ != nullptr || !request_queue_.empty() || !abort_waiters_.empty()) {
       auto status = STATUS(TryAgain, "Leader changed during abort");
       if (replicating_ != nullptr) {
@@ -238,6 +253,15 @@ class TransactionState {
       request->completion_callback()->CompleteWithStatus(status);
       return;
     }
+    if (state.status() == TransactionStatus::WRITTEN_IN_ONE_OF_INVOLVED_TABLETS) {
+      WrittenInOneOfInvolvedTablets(state);
+      request->completion_callback()->CompleteWithStatus(Status::OK());
+      return;
+    }
+    if (state.status() == TransactionStatus::COMMITTED && state.pending_tablets_size() != 0) {
+      StartParallelCommit(std::move(request));
+      return;
+    }
     if (replicating_) {
       request_queue_.push_back(std::move(request));
       return;
@@ -245,6 +269,27 @@ class TransactionState {
     DoHandle(std::move(request));
   }
 
+  // Handles heartbeat received by leader at now. Returns false if transaction is aborted or
+  // expired.
+  bool Heartbeat(HybridTime now) {
+    if (ShouldBeAborted()) {
+      return false;
+    }
+    if (status_ != TransactionStatus::PENDING || ShouldBeCommitted()) {
+      return true;
+    }
+    if (ExpiredAt(now)) {
+      Abort();
+      return false;
+    }
+    last_touch_.MakeAtLeast(now);
+    auto passed = now.GetPhysicalValueMicros() - replicated_touch_.GetPhysicalValueMicros();
+    if (!replicating_ && passed >= FLAGS_transaction_heartbeat_replication_interval_usec) {
+      SubmitUpdateStatus(TransactionStatus::PENDING);
+    }
+    return true;
+  }
+
   // Aborts this transaction.
   void Abort() {
     if (ShouldBeCommitted()) {
@@ -255,6 +300,7 @@ class TransactionState {
       return;
     }
     CHECK_EQ(status_, TransactionStatus::PENDING);
+    FailParallelCommit(STATUS(Aborted, "Transaction aborted before its last intents were written"));
     SubmitUpdateStatus(TransactionStatus::ABORTED);
   }
 
@@ -304,8 +350,10 @@ class TransactionState {
         // this tablet as a transaction status tablet, but tablets that are involved in the data
         // path (receive write intents) for this transactions
         FATAL_INVALID_ENUM_VALUE(TransactionStatus, data.state.status());
-      case TransactionStatus::APPLIED_IN_ONE_OF_INVOLVED_TABLETS:
-        // APPLIED_IN_ONE_OF_INVOLVED_TABLETS handled w/o use of RAFT log
+      case TransactionStatus::APPLIED_IN_ONE_OF_INVOLVED_TABLETS: FALLTHROUGH_INTENDED;
+      case TransactionStatus::WRITTEN_IN_ONE_OF_INVOLVED_TABLETS:
+        // APPLIED_IN_ONE_OF_INVOLVED_TABLETS and WRITTEN_IN_ONE_OF_INVOLVED_TABLETS handled w/o
+        // use of RAFT log
         FATAL_INVALID_ENUM_VALUE(TransactionStatus, data.state.status());
       case TransactionStatus::APPLIED_IN_ALL_INVOLVED_TABLETS:
         return AppliedInAllInvolvedTabletsReplicationFinished(data);
@@ -348,6 +396,61 @@ class TransactionState {
     return Status::OK();
   }
 
+  // Commit that was sent in parallel with the last intents of the transaction waits until all
+  // tablets, that receive those intents, report that they are written.
+  void StartParallelCommit(std::unique_ptr<tablet::UpdateTxnOperationState> request) {
+    auto status = parallel_commit_ ? STATUS(IllegalState, "Transaction is already committing")
+                                   : HandleCommit();
+    if (!status.ok()) {
+      request->completion_callback()->CompleteWithStatus(status);
+      return;
+    }
+
+    for (const auto& tablet : request->request()->pending_tablets()) {
+      if (written_tablets_.count(tablet) == 0) {
+        parallel_commit_tablets_.insert(tablet);
+      }
+    }
+    written_tablets_.clear();
+    parallel_commit_ = std::move(request);
+    MaybeFinishParallelCommit();
+  }
+
+  void WrittenInOneOfInvolvedTablets(const tserver::TransactionStatePB& state) {
+    DCHECK_EQ(state.tablets_size(), 1);
+    if (status_ != TransactionStatus::PENDING || ShouldBeAborted()) {
+      return;
+    }
+    if (parallel_commit_) {
+      parallel_commit_tablets_.erase(state.tablets(0));
+      MaybeFinishParallelCommit();
+    } else {
+      // Tablet could write intents before the commit request arrives.
+      written_tablets_.insert(state.tablets(0));
+    }
+  }
+
+  void MaybeFinishParallelCommit() {
+    if (!parallel_commit_ || !parallel_commit_tablets_.empty()) {
+      return;
+    }
+    VLOG_WITH_PREFIX(1) << "All intents of parallel commit are written";
+    auto request = std::move(parallel_commit_);
+    if (replicating_) {
+      request_queue_.push_back(std::move(request));
+    } else {
+      DoHandle(std::move(request));
+    }
+  }
+
+  void FailParallelCommit(const Status& status) {
+    if (parallel_commit_) {
+      parallel_commit_->completion_callback()->CompleteWithStatus(status);
+      parallel_commit_.reset();
+      parallel_commit_tablets_.clear();
+    }
+  }
+
   void SubmitUpdateStatus(TransactionStatus status) {
     tserver::TransactionStatePB state;
     state.set_transaction_id(id_.begin(), id_.size());
@@ -421,7 +524,9 @@ class TransactionState {
       return Status::OK();
     }
     CHECK_EQ(status_, TransactionStatus::PENDING);
-    last_touch_ = data.hybrid_time;
+    // Leader could already have a later heartbeat, that was not replicated.
+    last_touch_.MakeAtLeast(data.hybrid_time);
+    replicated_touch_ = data.hybrid_time;
     first_entry_raft_index_ = data.op_id.index();
     return Status::OK();
   }
@@ -441,6 +546,8 @@ class TransactionState {
   const std::string log_prefix_;
   TransactionStatus status_ = TransactionStatus::PENDING;
   HybridTime last_touch_;
+  // Hybrid time of the last replicated CREATED or PENDING record.
+  HybridTime replicated_touch_;
   // It should match last_touch_, but it is possible that because of some code errors it
   // would not be so. To add stability we introduce a separate field for it.
   HybridTime commit_time_;
@@ -453,6 +560,12 @@ class TransactionState {
   std::deque<std::unique_ptr<tablet::UpdateTxnOperationState>> request_queue_;
 
   std::vector<TransactionAbortCallback> abort_waiters_;
+
+  // Commit request that waits until the last intents are written in parallel_commit_tablets_.
+  std::unique_ptr<tablet::UpdateTxnOperationState> parallel_commit_;
+  std::unordered_set<TabletId> parallel_commit_tablets_;
+  // Tablets that reported written intents before the commit request arrived.
+  std::unordered_set<TabletId> written_tablets_;
 };
 
 // Contains actions that should be executed after lock in transaction coordinator is released.
@@ -546,6 +659,40 @@ class TransactionCoordinator::Impl : public TransactionStateContext {
   }
 
 
+  CHECKED_STATUS ProcessHeartbeats(const tserver::UpdateTransactionRequestPB& request,
+                                   tserver::UpdateTransactionResponsePB* response) {
+    std::vector<TransactionId> ids;
+    ids.reserve(request.heartbeat_transaction_ids_size());
+    for (const auto& transaction_id : request.heartbeat_transaction_ids()) {
+      auto id = FullyDecodeTransactionId(transaction_id);
+      RETURN_NOT_OK(id);
+      ids.push_back(*id);
+    }
+
+    PostponedLeaderActions actions;
+    {
+      std::lock_guard<std::mutex> lock(managed_mutex_);
+      postponed_leader_actions_.leader = true;
+      auto now = context_.clock().Now();
+      for (size_t i = 0; i != ids.size(); ++i) {
+        auto it = managed_transactions_.find(ids[i]);
+        bool alive = false;
+        if (it != managed_transactions_.end()) {
+          managed_transactions_.modify(it, [now, &alive](TransactionState& state) {
+            alive = state.Heartbeat(now);
+          });
+        }
+        if (!alive) {
+          response->add_expired_transaction_ids(request.heartbeat_transaction_ids(i));
+        }
+      }
+      actions.Swap(&postponed_leader_actions_);
+    }
+    ExecutePostponedLeaderActions(&actions);
+
+    return Status::OK();
+  }
+
   size_t test_count_transactions() {
     std::lock_guard<std::mutex> lock(managed_mutex_);
     return managed_transactions_.size();
@@ -840,6 +987,11 @@ void TransactionCoordinator::Handle(std::unique_ptr<tablet::UpdateTxnOperationSt
   impl_->Handle(std::move(request));
 }
 
+Status TransactionCoordinator::ProcessHeartbeats(const tserver::UpdateTransactionRequestPB& request,
+                                                 tserver::UpdateTransactionResponsePB* response) {
+  return impl_->ProcessHeartbeats(request, response);
+}
+
 void TransactionCoordinator::ClearLocks() {
   impl_->ClearLocks();
 }
@@ -48,6 +48,8 @@ namespace tserver {
 class AbortTransactionResponsePB;
 class GetTransactionStatusResponsePB;
 class TransactionStatePB;
+class UpdateTransactionRequestPB;
+class UpdateTransactionResponsePB;
 
 }
 
@@ -124,6 +126,14 @@ class TransactionCoordinator {
 
   void Abort(const std::string& transaction_id, TransactionAbortCallback callback);
 
+  // Handles heartbeats of pending transactions listed in request.heartbeat_transaction_ids.
+  // Heartbeat is replicated in RAFT only when the last replicated heartbeat of transaction is
+  // older than transaction_heartbeat_replication_interval_usec, otherwise it only prolongs
+  // transaction while this tablet stays leader.
+  // Fills response.expired_transaction_ids with transactions that are expired or aborted.
+  CHECKED_STATUS ProcessHeartbeats(const tserver::UpdateTransactionRequestPB& request,
+                                   tserver::UpdateTransactionResponsePB* response);
+
   // Returns count of managed transactions. Used in tests.
   size_t test_count_transactions() const;
 
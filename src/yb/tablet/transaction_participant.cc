@@ -15,7 +15,12 @@
 
 #include "yb/tablet/transaction_participant.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <mutex>
+#include <thread>
+#include <unordered_map>
 
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/hashed_index.hpp>
@@ -29,37 +34,245 @@
 
 #include "yb/client/transaction_rpc.h"
 
+#include "yb/docdb/conflict_resolution.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/docdb.h"
 
+#include "yb/client/client.h"
+
+#include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc.h"
 
 #include "yb/tserver/tserver_service.pb.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/locks.h"
 #include "yb/util/monotime.h"
+#include "yb/util/threadpool.h"
 
 using namespace std::placeholders;
 
+DEFINE_int32(transaction_resolved_status_cache_size, 10000,
+             "Maximal number of final transaction statuses, resolved by reads, that are remembered "
+             "per tablet and shared with the following reads of the same intents.");
+TAG_FLAG(transaction_resolved_status_cache_size, advanced);
+
+DEFINE_int32(transaction_status_batch_window_us, 0,
+             "How long status requests for transactions of the same status tablet are collected "
+             "before they are sent in one batch. Requests are always batched while a previous "
+             "batch for the same status tablet is in flight.");
+TAG_FLAG(transaction_status_batch_window_us, advanced);
+
+DEFINE_int32(transaction_apply_chunk_size, 0,
+             "Maximal number of intents applied in the apply path of a transaction, the remaining "
+             "ones are applied in the background in chunks of this size, so applying a large "
+             "transaction does not block other writes to the tablet. 0 means that all intents are "
+             "applied in the apply path. Only used when intents are stored with regular records.");
+TAG_FLAG(transaction_apply_chunk_size, advanced);
+
+DEFINE_int32(transaction_apply_chunk_delay_ms, 1,
+             "Delay between the chunks of intents applied in the background, limits the load that "
+             "applying of large transactions puts on the tablet.");
+TAG_FLAG(transaction_apply_chunk_delay_ms, advanced);
+
 namespace yb {
 namespace tablet {
 
 namespace {
 
+// Sends status requests of transactions that are managed by the same status tablet in one
+// GetTransactionStatus RPC, so resolving conflicts with many transactions does not send a
+// separate RPC for each of them.
+class StatusRequestBatcher : public std::enable_shared_from_this<StatusRequestBatcher> {
+ public:
+  explicit StatusRequestBatcher(TransactionParticipantContext* context) : context_(*context) {}
+
+  ~StatusRequestBatcher() {
+    DCHECK(closed_);
+  }
+
+  // Requests status of transaction id, from status_tablet. callback is invoked with a response
+  // that contains the status of this transaction only.
+  void Request(const TabletId& status_tablet, const TransactionId& id,
+               client::GetTransactionStatusCallback callback) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (closed_) {
+      lock.unlock();
+      callback(STATUS(Aborted, "Transaction participant is shutting down"),
+               tserver::GetTransactionStatusResponsePB());
+      return;
+    }
+    auto& batch = batches_[status_tablet];
+    batch.ids.push_back(id);
+    batch.callbacks.push_back(std::move(callback));
+    if (batch.in_flight || batch.send_scheduled) {
+      return;
+    }
+    const auto window = FLAGS_transaction_status_batch_window_us;
+    if (window > 0) {
+      batch.send_scheduled = true;
+      auto self = shared_from_this();
+      client()->messenger()->scheduler().Schedule(
+          [self, status_tablet](const Status& status) {
+            self->ScheduledSend(status_tablet, status);
+          },
+          std::chrono::microseconds(window));
+      return;
+    }
+    Send(status_tablet, &lock);
+  }
+
+  // Fails queued requests and waits for the requests that are in flight.
+  void Shutdown() {
+    std::unordered_map<TabletId, Batch> batches;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      closed_ = true;
+      sending_cond_.wait(lock, [this] { return sending_ == 0; });
+      batches.swap(batches_);
+    }
+    for (auto& tablet_and_batch : batches) {
+      Fail(&tablet_and_batch.second, STATUS(Aborted, "Transaction participant is shutting down"));
+    }
+    rpcs_.Shutdown();
+  }
+
+ private:
+  struct Batch {
+    std::vector<TransactionId> ids;
+    std::vector<client::GetTransactionStatusCallback> callbacks;
+    // Whether a batch for this status tablet is in flight, new requests wait until it completes.
+    bool in_flight = false;
+    bool send_scheduled = false;
+  };
+
+  static void Fail(Batch* batch, const Status& status) {
+    for (const auto& callback : batch->callbacks) {
+      callback(status, tserver::GetTransactionStatusResponsePB());
+    }
+  }
+
+  void ScheduledSend(const TabletId& status_tablet, const Status& status) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = batches_.find(status_tablet);
+    if (closed_ || it == batches_.end()) {
+      return;
+    }
+    it->second.send_scheduled = false;
+    if (!status.ok()) {
+      Batch batch = std::move(it->second);
+      batches_.erase(it);
+      lock.unlock();
+      Fail(&batch, status);
+      return;
+    }
+    Send(status_tablet, &lock);
+  }
+
+  // Sends all queued requests for status_tablet, releases lock.
+  void Send(const TabletId& status_tablet, std::unique_lock<std::mutex>* lock) {
+    auto it = batches_.find(status_tablet);
+    auto ids = std::move(it->second.ids);
+    auto callbacks = std::make_shared<std::vector<client::GetTransactionStatusCallback>>(
+        std::move(it->second.callbacks));
+    it->second.ids.clear();
+    it->second.callbacks.clear();
+    it->second.in_flight = true;
+    auto handle = rpcs_.Prepare();
+    ++sending_;
+    lock->unlock();
+
+    tserver::GetTransactionStatusRequestPB req;
+    req.set_tablet_id(status_tablet);
+    for (const auto& id : ids) {
+      req.add_transaction_ids(id.begin(), id.size());
+    }
+    req.set_propagated_hybrid_time(context_.Now().ToUint64());
+    *handle = client::GetTransactionStatus(
+        TransactionRpcDeadline(),
+        nullptr /* tablet */,
+        client(),
+        &req,
+        std::bind(&StatusRequestBatcher::Received, shared_from_this(), status_tablet, callbacks,
+                  handle, _1, _2));
+    (**handle).SendRpc();
+
+    std::lock_guard<std::mutex> sending_lock(mutex_);
+    if (--sending_ == 0) {
+      sending_cond_.notify_all();
+    }
+  }
+
+  void Received(const TabletId& status_tablet,
+                const std::shared_ptr<std::vector<client::GetTransactionStatusCallback>>& callbacks,
+                rpc::Rpcs::Handle handle,
+                Status status,
+                const tserver::GetTransactionStatusResponsePB& response) {
+    rpcs_.Unregister(handle);
+    if (response.has_propagated_hybrid_time()) {
+      context_.UpdateClock(HybridTime(response.propagated_hybrid_time()));
+    }
+    const int size = static_cast<int>(callbacks->size());
+    if (status.ok() &&
+        (response.statuses_size() != size || response.status_hybrid_times_size() != size)) {
+      status = STATUS_FORMAT(IllegalState, "Wrong number of transaction statuses: $0, expected $1",
+                             response.statuses_size(), size);
+    }
+    for (int i = 0; i != size; ++i) {
+      tserver::GetTransactionStatusResponsePB transaction_response;
+      if (status.ok()) {
+        transaction_response.set_status(response.statuses(i));
+        transaction_response.set_status_hybrid_time(response.status_hybrid_times(i));
+      }
+      (*callbacks)[i](status, transaction_response);
+    }
+
+    // Requests that were queued while this batch was in flight.
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = batches_.find(status_tablet);
+    if (closed_ || it == batches_.end()) {
+      return;
+    }
+    it->second.in_flight = false;
+    if (it->second.ids.empty()) {
+      batches_.erase(it);
+      return;
+    }
+    if (!it->second.send_scheduled) {
+      Send(status_tablet, &lock);
+    }
+  }
+
+  client::YBClient* client() const {
+    return context_.client_future().get().get();
+  }
+
+  TransactionParticipantContext& context_;
+  rpc::Rpcs rpcs_;
+
+  std::mutex mutex_;
+  std::condition_variable sending_cond_;
+  // Number of Send calls that are preparing or starting an RPC without holding mutex_.
+  int sending_ = 0;
+  bool closed_ = false;
+  std::unordered_map<TabletId, Batch> batches_;
+};
+
 class RunningTransaction {
  public:
   RunningTransaction(TransactionMetadata metadata,
                      rpc::Rpcs* rpcs,
+                     StatusRequestBatcher* status_request_batcher,
                      TransactionParticipantContext* context)
       : metadata_(std::move(metadata)),
         rpcs_(*rpcs),
+        status_request_batcher_(*status_request_batcher),
         context_(*context),
-        get_status_handle_(rpcs->InvalidHandle()),
         abort_handle_(rpcs->InvalidHandle()) {
   }
 
   ~RunningTransaction() {
-    rpcs_.Abort({&get_status_handle_, &abort_handle_});
+    rpcs_.Abort({&abort_handle_});
   }
 
   const TransactionId& id() const {
@@ -78,8 +291,7 @@ class RunningTransaction {
     local_commit_time_ = time;
   }
 
-  void RequestStatusAt(client::YBClient* client,
-                       const StatusRequest& request,
+  void RequestStatusAt(const StatusRequest& request,
                        std::unique_lock<std::mutex>* lock) const {
     if (last_known_status_hybrid_time_ > HybridTime::kMin) {
       auto transaction_status =
@@ -98,18 +310,9 @@ class RunningTransaction {
       return;
     }
     lock->unlock();
-    tserver::GetTransactionStatusRequestPB req;
-    req.set_tablet_id(metadata_.status_tablet);
-    req.set_transaction_id(metadata_.transaction_id.begin(), metadata_.transaction_id.size());
-    req.set_propagated_hybrid_time(context_.Now().ToUint64());
-    rpcs_.RegisterAndStart(
-        client::GetTransactionStatus(
-            TransactionRpcDeadline(),
-            nullptr /* tablet */,
-            client,
-            &req,
-            std::bind(&RunningTransaction::StatusReceived, this, _1, _2, lock->mutex())),
-        &get_status_handle_);
+    status_request_batcher_.Request(
+        metadata_.status_tablet, metadata_.transaction_id,
+        std::bind(&RunningTransaction::StatusReceived, this, _1, _2, lock->mutex()));
   }
 
   void Abort(client::YBClient* client,
@@ -160,11 +363,6 @@ class RunningTransaction {
   void StatusReceived(const Status& status,
                       const tserver::GetTransactionStatusResponsePB& response,
                       std::mutex* mutex) const {
-    if (response.has_propagated_hybrid_time()) {
-      context_.UpdateClock(HybridTime(response.propagated_hybrid_time()));
-    }
-
-    rpcs_.Unregister(&get_status_handle_);
     decltype(status_waiters_) status_waiters;
     HybridTime time;
     TransactionStatus transaction_status;
@@ -254,13 +452,13 @@ class RunningTransaction {
 
   TransactionMetadata metadata_;
   rpc::Rpcs& rpcs_;
+  StatusRequestBatcher& status_request_batcher_;
   TransactionParticipantContext& context_;
   HybridTime local_commit_time_ = HybridTime::kInvalidHybridTime;
 
   mutable TransactionStatus last_known_status_;
   mutable HybridTime last_known_status_hybrid_time_ = HybridTime::kMin;
   mutable std::vector<StatusRequest> status_waiters_;
-  mutable rpc::Rpcs::Handle get_status_handle_;
   mutable rpc::Rpcs::Handle abort_handle_;
   mutable std::vector<TransactionStatusCallback> abort_waiters_;
 };
@@ -270,9 +468,17 @@ class RunningTransaction {
 class TransactionParticipant::Impl {
  public:
   explicit Impl(TransactionParticipantContext* context)
-      : context_(*context), log_prefix_(context->tablet_id() + ": ") {}
+      : context_(*context), log_prefix_(context->tablet_id() + ": "),
+        status_request_batcher_(std::make_shared<StatusRequestBatcher>(context)) {
+    CHECK_OK(ThreadPoolBuilder("txn_apply").set_min_threads(0).set_max_threads(1)
+                 .Build(&apply_pool_));
+  }
 
   ~Impl() {
+    StopBackgroundApply();
+    apply_pool_->Shutdown();
+    // Status requests are completed first, as they refer to the running transactions.
+    status_request_batcher_->Shutdown();
     transactions_.clear();
     rpcs_.Shutdown();
   }
@@ -289,7 +495,7 @@ class TransactionParticipant::Impl {
       std::lock_guard<std::mutex> lock(mutex_);
       auto it = transactions_.find(metadata->transaction_id);
       if (it == transactions_.end()) {
-        transactions_.emplace(*metadata, &rpcs_, &context_);
+        transactions_.emplace(*metadata, &rpcs_, status_request_batcher_.get(), &context_);
         store = true;
       } else {
         DCHECK_EQ(it->metadata(), *metadata);
@@ -330,7 +536,29 @@ class TransactionParticipant::Impl {
           STATUS_FORMAT(NotFound, "Request status of unknown transaction: $0", *request.id));
       return;
     }
-    return it->RequestStatusAt(client(), request, &lock);
+    return it->RequestStatusAt(request, &lock);
+  }
+
+  HybridTime ResolvedCommitTime(const TransactionId& id) {
+    std::lock_guard<std::mutex> lock(resolved_mutex_);
+    auto it = resolved_.find(id);
+    return it != resolved_.end() ? it->second : HybridTime::kInvalidHybridTime;
+  }
+
+  void TransactionResolved(const TransactionId& id, HybridTime commit_time) {
+    const size_t max_size = std::max(FLAGS_transaction_resolved_status_cache_size, 0);
+    docdb::TransactionCompleted(id);
+    std::lock_guard<std::mutex> lock(resolved_mutex_);
+    if (max_size == 0 || !resolved_.emplace(id, commit_time).second) {
+      return;
+    }
+    resolved_order_.push_back(id);
+    // Entries of applied transactions are erased out of order, so resolved_order_ could contain
+    // ids that are already absent in resolved_.
+    while (resolved_.size() > max_size || resolved_order_.size() > 2 * max_size) {
+      resolved_.erase(resolved_order_.front());
+      resolved_order_.pop_front();
+    }
   }
 
   void Abort(const TransactionId& id,
@@ -353,7 +581,18 @@ class TransactionParticipant::Impl {
       FindOrLoad(data.transaction_id);
     }
 
-    CHECK_OK(data.applier->ApplyIntents(data));
+    bool all_applied;
+    {
+      std::lock_guard<std::mutex> lock(apply_intents_mutex_);
+      auto result = data.applier->ApplyIntents(
+          data, std::max(FLAGS_transaction_apply_chunk_size, 0));
+      CHECK_OK(result);
+      all_applied = result.get();
+    }
+
+    if (all_applied) {
+      TransactionApplied(data.transaction_id);
+    }
 
     {
       std::lock_guard<std::mutex> lock(mutex_);
@@ -365,41 +604,81 @@ class TransactionParticipant::Impl {
         LOG_WITH_PREFIX(WARNING) << "Apply of unknown transaction: " << data.transaction_id;
         return Status::OK();
       } else {
+        // Readers and conflict resolution use the local commit time for the intents that are
+        // still applied in the background.
         transactions_.modify(it, [&data](RunningTransaction& transaction) {
           transaction.SetLocalCommitTime(data.commit_time);
         });
         // TODO(dtxn) cleanup
       }
+      if (!all_applied) {
+        ScheduleBackgroundApply(data.transaction_id);
+      }
+      docdb::TransactionCompleted(data.transaction_id);
       if (data.mode == ProcessingMode::LEADER) {
-        tserver::UpdateTransactionRequestPB req;
-        req.set_tablet_id(data.status_tablet);
-        auto& state = *req.mutable_state();
-        state.set_transaction_id(data.transaction_id.begin(), data.transaction_id.size());
-        state.set_status(TransactionStatus::APPLIED_IN_ONE_OF_INVOLVED_TABLETS);
-        state.add_tablets(context_.tablet_id());
-
-        auto handle = rpcs_.Prepare();
-        *handle = UpdateTransaction(
-            TransactionRpcDeadline(),
-            nullptr /* remote_tablet */,
-            client(),
-            &req,
-            [this, handle](const Status& status, HybridTime propagated_hybrid_time) {
-              context_.UpdateClock(propagated_hybrid_time);
-              rpcs_.Unregister(handle);
-              LOG_IF_WITH_PREFIX(WARNING, !status.ok()) << "Failed to send applied: " << status;
-            });
-        (**handle).SendRpc();
+        NotifyStatusTablet(data.status_tablet, data.transaction_id,
+                           TransactionStatus::APPLIED_IN_ONE_OF_INVOLVED_TABLETS);
       }
     }
     return Status::OK();
   }
 
-  void SetDB(rocksdb::DB* db) {
+  void LastIntentsWritten(const TransactionId& id) {
+    auto metadata = Metadata(id);
+    if (!metadata) {
+      LOG_WITH_PREFIX(WARNING) << "Written intents of unknown transaction: " << id;
+      return;
+    }
+    NotifyStatusTablet(metadata->status_tablet, id,
+                       TransactionStatus::WRITTEN_IN_ONE_OF_INVOLVED_TABLETS);
+  }
+
+  void SetDB(rocksdb::DB* db, TransactionIntentApplier* applier) {
+    {
+      std::lock_guard<std::mutex> lock(background_apply_mutex_);
+      background_apply_stopped_ = false;
+      pending_applies_.clear();
+    }
     db_ = db;
+    applier_ = applier;
+    LoadPendingApplies();
+  }
+
+  void StopBackgroundApply() {
+    {
+      std::lock_guard<std::mutex> lock(background_apply_mutex_);
+      background_apply_stopped_ = true;
+    }
+    apply_pool_->Wait();
   }
 
  private:
+  // Notifies status tablet that this tablet reached specified status for transaction id.
+  // Failures are only logged, since the status tablet does not wait forever for those events.
+  void NotifyStatusTablet(const TabletId& status_tablet, const TransactionId& id,
+                          TransactionStatus status) {
+    tserver::UpdateTransactionRequestPB req;
+    req.set_tablet_id(status_tablet);
+    auto& state = *req.mutable_state();
+    state.set_transaction_id(id.begin(), id.size());
+    state.set_status(status);
+    state.add_tablets(context_.tablet_id());
+
+    auto handle = rpcs_.Prepare();
+    *handle = UpdateTransaction(
+        TransactionRpcDeadline(),
+        nullptr /* remote_tablet */,
+        client(),
+        &req,
+        [this, handle, status](const Status& rpc_status, HybridTime propagated_hybrid_time) {
+          context_.UpdateClock(propagated_hybrid_time);
+          rpcs_.Unregister(handle);
+          LOG_IF_WITH_PREFIX(WARNING, !rpc_status.ok())
+              << "Failed to send " << TransactionStatus_Name(status) << ": " << rpc_status;
+        });
+    (**handle).SendRpc();
+  }
+
   typedef boost::multi_index_container<RunningTransaction,
       boost::multi_index::indexed_by <
           boost::multi_index::hashed_unique <
@@ -429,7 +708,7 @@ class TransactionParticipant::Impl {
       if (metadata_pb.ParseFromArray(iter->value().cdata(), iter->value().size())) {
         auto metadata = TransactionMetadata::FromPB(metadata_pb);
         if (metadata.ok()) {
-          it = transactions_.emplace(std::move(*metadata), &rpcs_, &context_).first;
+          it = transactions_.emplace(std::move(*metadata), &rpcs_, status_request_batcher_.get(), &context_).first;
         } else {
           LOG_WITH_PREFIX(DFATAL) << "Loaded bad metadata: " << metadata.status();
         }
@@ -444,6 +723,124 @@ class TransactionParticipant::Impl {
     return it;
   }
 
+  // There are no intents of this transaction anymore, so nobody would look up its status.
+  void TransactionApplied(const TransactionId& id) {
+    std::lock_guard<std::mutex> lock(resolved_mutex_);
+    resolved_.erase(id);
+  }
+
+  // Finds transactions whose apply was interrupted by a restart, and continues applying them.
+  void LoadPendingApplies() {
+    docdb::KeyBytes reverse_index_prefix;
+    reverse_index_prefix.AppendValueType(docdb::ValueType::kIntentPrefix);
+    reverse_index_prefix.AppendValueType(docdb::ValueType::kTransactionId);
+    auto iter = docdb::CreateRocksDBIterator(db_,
+                                             docdb::BloomFilterMode::DONT_USE_BLOOM_FILTER,
+                                             boost::none,
+                                             rocksdb::kDefaultQueryId);
+    // Keys of one transaction are adjacent, so each of them is visited with two seeks.
+    iter->Seek(reverse_index_prefix.data());
+    while (iter->Valid() && iter->key().starts_with(reverse_index_prefix.data())) {
+      Slice id_slice = iter->key();
+      id_slice.remove_prefix(reverse_index_prefix.size());
+      auto id = DecodeTransactionId(&id_slice);
+      if (!id.ok()) {
+        LOG_WITH_PREFIX(DFATAL) << "Bad transaction key: " << iter->key().ToDebugHexString();
+        return;
+      }
+
+      docdb::KeyBytes key;
+      docdb::AppendTransactionApplyStateKey(*id, &key);
+      iter->Seek(key.data());
+      if (iter->Valid() && iter->key() == key.data()) {
+        docdb::TransactionApplyStatePB apply_state;
+        if (apply_state.ParseFromArray(iter->value().cdata(), iter->value().size())) {
+          LOG_WITH_PREFIX(INFO) << "Resuming apply of " << *id;
+          SetLocalCommitTimeOfPendingApply(
+              *id, HybridTime(apply_state.commit_hybrid_time()));
+          ScheduleBackgroundApply(*id);
+        } else {
+          LOG_WITH_PREFIX(DFATAL) << "Unable to parse apply state: "
+                                  << iter->value().ToDebugHexString();
+        }
+      }
+
+      key.Clear();
+      AppendTransactionKeyPrefix(*id, &key);
+      key.AppendValueType(docdb::ValueType::kMaxByte);
+      iter->Seek(key.data());
+    }
+  }
+
+  void SetLocalCommitTimeOfPendingApply(const TransactionId& id, HybridTime commit_time) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = FindOrLoad(id);
+    if (it != transactions_.end()) {
+      transactions_.modify(it, [commit_time](RunningTransaction& transaction) {
+        transaction.SetLocalCommitTime(commit_time);
+      });
+    }
+  }
+
+  void ScheduleBackgroundApply(const TransactionId& id) {
+    std::lock_guard<std::mutex> lock(background_apply_mutex_);
+    // Apply of a partially applied transaction could be replayed after a restart.
+    if (std::find(pending_applies_.begin(), pending_applies_.end(), id) == pending_applies_.end()) {
+      pending_applies_.push_back(id);
+    }
+    if (background_apply_running_ || background_apply_stopped_) {
+      return;
+    }
+    background_apply_running_ = true;
+    auto status = apply_pool_->SubmitFunc(std::bind(&Impl::BackgroundApply, this));
+    if (!status.ok()) {
+      LOG_WITH_PREFIX(WARNING) << "Failed to schedule background apply: " << status;
+      background_apply_running_ = false;
+    }
+  }
+
+  // Applies pending transactions chunk by chunk, in the order they were committed.
+  void BackgroundApply() {
+    for (;;) {
+      TransactionId id;
+      {
+        std::lock_guard<std::mutex> lock(background_apply_mutex_);
+        if (background_apply_stopped_ || pending_applies_.empty()) {
+          background_apply_running_ = false;
+          return;
+        }
+        id = pending_applies_.front();
+      }
+
+      Result<bool> all_applied(false);
+      {
+        std::lock_guard<std::mutex> lock(apply_intents_mutex_);
+        all_applied = applier_->ContinueApplyIntents(
+            id, std::max(FLAGS_transaction_apply_chunk_size, 0));
+      }
+      if (!all_applied.ok()) {
+        // Retried when the next transaction is applied in background or after the restart.
+        LOG_WITH_PREFIX(WARNING) << "Failed to apply intents of " << id << ": "
+                                 << all_applied.status();
+        std::lock_guard<std::mutex> lock(background_apply_mutex_);
+        background_apply_running_ = false;
+        return;
+      }
+
+      if (all_applied.get()) {
+        VLOG_WITH_PREFIX(2) << "Applied all intents of " << id;
+        TransactionApplied(id);
+        std::lock_guard<std::mutex> lock(background_apply_mutex_);
+        pending_applies_.pop_front();
+      }
+
+      if (FLAGS_transaction_apply_chunk_delay_ms > 0) {
+        std::this_thread::sleep_for(
+            std::chrono::milliseconds(FLAGS_transaction_apply_chunk_delay_ms));
+      }
+    }
+  }
+
   client::YBClient* client() const {
     return context_.client_future().get().get();
   }
@@ -456,9 +853,29 @@ class TransactionParticipant::Impl {
   std::string log_prefix_;
 
   rocksdb::DB* db_ = nullptr;
+  TransactionIntentApplier* applier_ = nullptr;
   std::mutex mutex_;
   rpc::Rpcs rpcs_;
+  std::shared_ptr<StatusRequestBatcher> status_request_batcher_;
   Transactions transactions_;
+
+  // Final statuses of transactions resolved by reads, see TransactionResolved. Protected by a
+  // separate mutex, so readers don't contend with the management of running transactions.
+  std::mutex resolved_mutex_;
+  std::unordered_map<TransactionId, HybridTime, TransactionIdHash> resolved_;
+  // Ids in the order they were added to resolved_, used for eviction.
+  std::deque<TransactionId> resolved_order_;
+
+  // Serializes the apply path with the background apply, so chunks of one transaction don't
+  // interleave.
+  std::mutex apply_intents_mutex_;
+
+  // Committed transactions whose intents are applied in the background.
+  std::mutex background_apply_mutex_;
+  std::deque<TransactionId> pending_applies_;
+  bool background_apply_running_ = false;
+  bool background_apply_stopped_ = false;
+  std::unique_ptr<ThreadPool> apply_pool_;
 };
 
 TransactionParticipant::TransactionParticipant(TransactionParticipantContext* context)
@@ -473,6 +890,10 @@ void TransactionParticipant::Add(const TransactionMetadataPB& data,
   impl_->Add(data, write_batch);
 }
 
+void TransactionParticipant::LastIntentsWritten(const TransactionId& id) {
+  impl_->LastIntentsWritten(id);
+}
+
 boost::optional<TransactionMetadata> TransactionParticipant::Metadata(const TransactionId& id) {
   return impl_->Metadata(id);
 }
@@ -485,6 +906,15 @@ void TransactionParticipant::RequestStatusAt(const StatusRequest& request) {
   return impl_->RequestStatusAt(request);
 }
 
+HybridTime TransactionParticipant::ResolvedCommitTime(const TransactionId& id) {
+  return impl_->ResolvedCommitTime(id);
+}
+
+void TransactionParticipant::TransactionResolved(const TransactionId& id,
+                                                 HybridTime commit_time) {
+  impl_->TransactionResolved(id, commit_time);
+}
+
 void TransactionParticipant::Abort(const TransactionId& id,
                                    TransactionStatusCallback callback) {
   return impl_->Abort(id, std::move(callback));
@@ -494,8 +924,12 @@ CHECKED_STATUS TransactionParticipant::ProcessApply(const TransactionApplyData&
   return impl_->ProcessApply(data);
 }
 
-void TransactionParticipant::SetDB(rocksdb::DB* db) {
-  impl_->SetDB(db);
+void TransactionParticipant::SetDB(rocksdb::DB* db, TransactionIntentApplier* applier) {
+  impl_->SetDB(db, applier);
+}
+
+void TransactionParticipant::StopBackgroundApply() {
+  impl_->StopBackgroundApply();
 }
 
 } // namespace tablet
@@ -61,7 +61,15 @@ struct TransactionApplyData {
 // Interface to object that should apply intents in RocksDB when transaction is applying.
 class TransactionIntentApplier {
  public:
-  virtual CHECKED_STATUS ApplyIntents(const TransactionApplyData& data) = 0;
+  // Converts intents of the transaction to regular records and removes them. When max_intents is
+  // not zero, at most max_intents intents are applied and the progress is stored with them, so the
+  // rest can be applied by ContinueApplyIntents, also after a restart. Returns whether all intents
+  // were applied.
+  virtual Result<bool> ApplyIntents(const TransactionApplyData& data, size_t max_intents) = 0;
+
+  // Applies at most max_intents of the remaining intents of a partially applied transaction, zero
+  // means all of them. Returns whether all intents were applied.
+  virtual Result<bool> ContinueApplyIntents(const TransactionId& id, size_t max_intents) = 0;
 
  protected:
   ~TransactionIntentApplier() {}
@@ -95,11 +103,25 @@ class TransactionParticipant : public TransactionStatusManager {
 
   void RequestStatusAt(const StatusRequest& request) override;
 
+  HybridTime ResolvedCommitTime(const TransactionId& id) override;
+
+  void TransactionResolved(const TransactionId& id, HybridTime commit_time) override;
+
   void Abort(const TransactionId& id, TransactionStatusCallback callback) override;
 
   CHECKED_STATUS ProcessApply(const TransactionApplyData& data);
 
-  void SetDB(rocksdb::DB* db);
+  // Invoked by leader when it replicated the last intents of transaction id, that is committed in
+  // parallel with them. Notifies the status tablet of this transaction.
+  void LastIntentsWritten(const TransactionId& id);
+
+  // Sets the DB that contains transaction intents, and resumes applying of the transactions that
+  // were partially applied in it.
+  void SetDB(rocksdb::DB* db, TransactionIntentApplier* applier);
+
+  // Stops applying intents in the background and waits for the chunk in progress. Should be
+  // called before the DB is closed, SetDB resumes it.
+  void StopBackgroundApply();
 
  private:
   class Impl;
@@ -0,0 +1,435 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+// A micro-benchmark of the DocDB storage layer. Unlike db_bench, which exercises raw RocksDB
+// key/value operations, it runs QL and Redis document workloads through DocWriteBatch,
+// DocRowwiseIterator, GetSubDocument, IntentAwareIterator and DocDBCompactionFilter against a local
+// DocDB instance, and reports the throughput, the latency distribution and the read and write
+// amplification of every workload.
+//
+// Example:
+//   docdb_bench --docdb_bench_workloads=ql_write,ql_point_read --docdb_bench_num_rows=1000000
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/common/ql_expr.h"
+#include "yb/common/schema.h"
+#include "yb/common/transaction.h"
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/doc_ql_scanspec.h"
+#include "yb/docdb/doc_rowwise_iterator.h"
+#include "yb/docdb/docdb.h"
+#include "yb/docdb/docdb_util.h"
+#include "yb/gutil/strings/split.h"
+#include "yb/gutil/strings/substitute.h"
+#include "yb/rocksdb/db.h"
+#include "yb/rocksdb/statistics.h"
+#include "yb/util/env.h"
+#include "yb/util/flags.h"
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/logging.h"
+#include "yb/util/monotime.h"
+#include "yb/util/path_util.h"
+#include "yb/util/random.h"
+#include "yb/util/random_util.h"
+#include "yb/util/status.h"
+
+DEFINE_string(docdb_bench_dir, "/tmp/docdb_bench",
+              "Directory to create the benchmark DocDB instance in. Its previous contents are "
+              "removed.");
+DEFINE_string(docdb_bench_workloads,
+              "ql_write,ql_point_read,ql_scan,ql_ttl_read,redis_write,redis_read,"
+              "intent_write,intent_point_read",
+              "Comma separated list of the workloads to run, in order. The read workloads read "
+              "the rows written by the matching write workload, which should run before them: "
+              "ql_write for ql_point_read and ql_scan, redis_write for redis_read and intent_write "
+              "for intent_point_read. ql_ttl_read writes its own rows.");
+DEFINE_int32(docdb_bench_num_rows, 100000, "Number of rows or Redis keys written by a workload.");
+DEFINE_int32(docdb_bench_num_columns, 10,
+             "Number of non-key columns of a QL row and of fields of a Redis hash.");
+DEFINE_int32(docdb_bench_value_size, 32, "Size of a column or field value in bytes.");
+DEFINE_int32(docdb_bench_num_reads, 100000, "Number of reads done by a point read workload.");
+DEFINE_int32(docdb_bench_write_batch_size, 100,
+             "Number of rows or Redis keys written by one DocWriteBatch.");
+DEFINE_int32(docdb_bench_ttl_ms, 1000, "TTL of the rows written by the ql_ttl_read workload.");
+DEFINE_bool(docdb_bench_compact_after_writes, true,
+            "Flush and fully compact the DocDB instance after every write workload, so the write "
+            "amplification includes the compactions and the reads run against SST files.");
+DEFINE_int32(docdb_bench_seed, 0, "Seed of the random values and keys, 0 means a random seed.");
+
+namespace yb {
+namespace tools {
+
+using docdb::DocKey;
+using docdb::DocPath;
+using docdb::PrimitiveValue;
+using docdb::SubDocKey;
+using docdb::SubDocument;
+using docdb::Value;
+
+namespace {
+
+// Reports every transaction as pending, so transactional reads resolve the intents they find and
+// skip their values.
+class PendingTransactionStatusManager : public TransactionStatusManager {
+ public:
+  HybridTime LocalCommitTime(const TransactionId& id) override {
+    return HybridTime::kInvalidHybridTime;
+  }
+
+  void RequestStatusAt(const StatusRequest& request) override {
+    request.callback(TransactionStatusResult{TransactionStatus::PENDING, request.read_ht});
+  }
+
+  HybridTime ResolvedCommitTime(const TransactionId& id) override {
+    return HybridTime::kInvalidHybridTime;
+  }
+
+  void TransactionResolved(const TransactionId& id, HybridTime commit_time) override {
+  }
+
+  boost::optional<TransactionMetadata> Metadata(const TransactionId& id) override {
+    return boost::none;
+  }
+
+  void Abort(const TransactionId& id, TransactionStatusCallback callback) override {
+  }
+};
+
+// RocksDB statistics used to compute the amplification of a workload.
+const std::vector<std::pair<rocksdb::Tickers, const char*>> kTickers = {
+    {rocksdb::NUMBER_DB_SEEK, "seeks"},
+    {rocksdb::NUMBER_DB_NEXT, "nexts"},
+    {rocksdb::BLOCK_CACHE_DATA_HIT, "data block hits"},
+    {rocksdb::BLOCK_CACHE_DATA_MISS, "data block misses"},
+    {rocksdb::BYTES_WRITTEN, "bytes written"},
+    {rocksdb::FLUSH_WRITE_BYTES, "flush bytes"},
+    {rocksdb::COMPACT_WRITE_BYTES, "compaction bytes"},
+};
+
+class DocDBBench : public docdb::DocDBRocksDBUtil {
+ public:
+  DocDBBench()
+      : rng_(FLAGS_docdb_bench_seed != 0 ? FLAGS_docdb_bench_seed : GetRandomSeed32()) {
+    std::vector<ColumnSchema> columns;
+    std::vector<ColumnId> column_ids;
+    columns.emplace_back("k", DataType::STRING, /* is_nullable = */ false);
+    column_ids.emplace_back(10);
+    for (int i = 0; i < FLAGS_docdb_bench_num_columns; ++i) {
+      columns.emplace_back(strings::Substitute("c$0", i), DataType::STRING, true);
+      column_ids.emplace_back(100 + i);
+    }
+    schema_ = Schema(columns, column_ids, 1 /* key_columns */);
+    std::vector<StringPiece> projected_columns;
+    for (size_t i = schema_.num_key_columns(); i < schema_.num_columns(); ++i) {
+      projected_columns.push_back(schema_.column(i).name());
+    }
+    CHECK_OK(schema_.CreateProjectionByNames(projected_columns, &projection_));
+  }
+
+  CHECKED_STATUS InitRocksDBDir() override {
+    if (!Env::Default()->FileExists(FLAGS_docdb_bench_dir)) {
+      RETURN_NOT_OK(Env::Default()->CreateDir(FLAGS_docdb_bench_dir));
+    }
+    rocksdb_dir_ = JoinPathSegments(FLAGS_docdb_bench_dir, tablet_id());
+    if (Env::Default()->FileExists(rocksdb_dir_)) {
+      RETURN_NOT_OK(Env::Default()->DeleteRecursively(rocksdb_dir_));
+    }
+    return Status::OK();
+  }
+
+  CHECKED_STATUS InitRocksDBOptions() override {
+    return InitCommonRocksDBOptions();
+  }
+
+  std::string tablet_id() override {
+    return "docdb_bench";
+  }
+
+  CHECKED_STATUS Run() {
+    RETURN_NOT_OK(InitRocksDBOptions());
+    RETURN_NOT_OK(OpenRocksDB());
+    const std::vector<std::string> workloads = strings::Split(
+        FLAGS_docdb_bench_workloads, ",", strings::SkipEmpty());
+    for (const std::string& workload : workloads) {
+      RETURN_NOT_OK(RunWorkload(workload));
+    }
+    return Status::OK();
+  }
+
+ private:
+  CHECKED_STATUS RunWorkload(const std::string& workload) {
+    const int num_batches =
+        (FLAGS_docdb_bench_num_rows + FLAGS_docdb_bench_write_batch_size - 1) /
+        FLAGS_docdb_bench_write_batch_size;
+    if (workload == "ql_write") {
+      return MeasureWrites(workload, num_batches, [this](int batch) {
+        return WriteQLRows("row", batch, Value::kMaxTtl);
+      });
+    }
+    if (workload == "ql_point_read") {
+      return Measure(workload, FLAGS_docdb_bench_num_reads, [this](int) {
+        return ReadQLRow(QLRowKey("row", rng_.Uniform(FLAGS_docdb_bench_num_rows)),
+                         boost::none, ReadHybridTime::SingleTime(last_write_time_),
+                         true /* expect_found */);
+      });
+    }
+    if (workload == "ql_scan") {
+      return Measure(workload, 1, [this](int) { return ScanQLRows(); });
+    }
+    if (workload == "ql_ttl_read") {
+      // The rows are written with a TTL and read once they have expired, so every read skips the
+      // expired columns of a row.
+      const auto ttl = MonoDelta::FromMilliseconds(FLAGS_docdb_bench_ttl_ms);
+      RETURN_NOT_OK(MeasureWrites("ql_ttl_write", num_batches, [this, ttl](int batch) {
+        return WriteQLRows("ttl_row", batch, ttl);
+      }));
+      const HybridTime read_ht = HybridTime::FromMicros(
+          last_write_time_.GetPhysicalValueMicros() + ttl.ToMicroseconds() + 1);
+      return Measure(workload, FLAGS_docdb_bench_num_reads, [this, read_ht](int) {
+        return ReadQLRow(QLRowKey("ttl_row", rng_.Uniform(FLAGS_docdb_bench_num_rows)),
+                         boost::none, ReadHybridTime::SingleTime(read_ht),
+                         false /* expect_found */);
+      });
+    }
+    if (workload == "redis_write") {
+      return MeasureWrites(workload, num_batches, [this](int batch) {
+        return WriteRedisHashes(batch);
+      });
+    }
+    if (workload == "redis_read") {
+      return Measure(workload, FLAGS_docdb_bench_num_reads, [this](int) {
+        return ReadRedisHash(rng_.Uniform(FLAGS_docdb_bench_num_rows));
+      });
+    }
+    if (workload == "intent_write") {
+      // Every batch is written by its own transaction, as intents.
+      return MeasureWrites(workload, num_batches, [this](int batch) {
+        SetCurrentTransactionId(GenerateTransactionId());
+        SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
+        Status status = WriteQLRows("intent_row", batch, Value::kMaxTtl);
+        ResetCurrentTransactionId();
+        SetTransactionIsolationLevel(IsolationLevel::NON_TRANSACTIONAL);
+        return status;
+      });
+    }
+    if (workload == "intent_point_read") {
+      const TransactionOperationContext txn_op_context(GenerateTransactionId(), &status_manager_);
+      return Measure(workload, FLAGS_docdb_bench_num_reads, [this, &txn_op_context](int) {
+        return ReadQLRow(QLRowKey("intent_row", rng_.Uniform(FLAGS_docdb_bench_num_rows)),
+                         txn_op_context, ReadHybridTime::SingleTime(last_write_time_),
+                         false /* expect_found */);
+      });
+    }
+    return STATUS_FORMAT(InvalidArgument, "Unknown workload: $0", workload);
+  }
+
+  DocKey QLRowKey(const char* prefix, int row) const {
+    return DocKey({PrimitiveValue(strings::Substitute("$0$1", prefix, row))});
+  }
+
+  std::string RandomValue() {
+    std::string result(FLAGS_docdb_bench_value_size, '\0');
+    RandomString(&result[0], result.size(), &rng_);
+    return result;
+  }
+
+  HybridTime NextWriteTime() {
+    // Leave room for the physical time of a hybrid time to advance between the batches.
+    last_write_time_ = HybridTime::FromMicros(last_write_time_.GetPhysicalValueMicros() + 1);
+    return last_write_time_;
+  }
+
+  // Writes the rows of the batch-th write batch, with the liveness column and all the non-key
+  // columns set, as a QL insert would.
+  CHECKED_STATUS WriteQLRows(const char* prefix, int batch, MonoDelta ttl) {
+    auto dwb = MakeDocWriteBatch();
+    const int end = std::min((batch + 1) * FLAGS_docdb_bench_write_batch_size,
+                             FLAGS_docdb_bench_num_rows);
+    for (int row = batch * FLAGS_docdb_bench_write_batch_size; row < end; ++row) {
+      const auto encoded_doc_key = QLRowKey(prefix, row).Encode();
+      RETURN_NOT_OK(dwb.SetPrimitive(
+          DocPath(encoded_doc_key,
+                  PrimitiveValue::SystemColumnId(docdb::SystemColumnIds::kLivenessColumn)),
+          Value(PrimitiveValue(), ttl)));
+      for (size_t i = schema_.num_key_columns(); i < schema_.num_columns(); ++i) {
+        RETURN_NOT_OK(dwb.SetPrimitive(
+            DocPath(encoded_doc_key, PrimitiveValue(schema_.column_id(i))),
+            Value(PrimitiveValue(RandomValue()), ttl)));
+      }
+    }
+    return WriteToRocksDB(dwb, NextWriteTime());
+  }
+
+  CHECKED_STATUS ReadQLRow(const DocKey& doc_key,
+                           const TransactionOperationContextOpt& txn_op_context,
+                           const ReadHybridTime& read_time,
+                           bool expect_found) {
+    docdb::DocQLScanSpec spec(schema_, doc_key, rocksdb::kDefaultQueryId);
+    docdb::DocRowwiseIterator iter(projection_, schema_, txn_op_context, rocksdb(), read_time);
+    RETURN_NOT_OK(iter.Init(spec));
+    if (iter.HasNext() != expect_found) {
+      return STATUS_FORMAT(IllegalState, "Row $0 should$1 be found", doc_key,
+                           expect_found ? "" : " not");
+    }
+    if (expect_found) {
+      auto row = std::make_shared<QLTableRow>();
+      RETURN_NOT_OK(iter.NextRow(projection_, row));
+    }
+    return Status::OK();
+  }
+
+  CHECKED_STATUS ScanQLRows() {
+    ScanSpec spec;
+    docdb::DocRowwiseIterator iter(
+        projection_, schema_, boost::none, rocksdb(), ReadHybridTime::SingleTime(last_write_time_));
+    RETURN_NOT_OK(iter.Init(&spec));
+    auto row = std::make_shared<QLTableRow>();
+    int num_rows = 0;
+    while (iter.HasNext()) {
+      RETURN_NOT_OK(iter.NextRow(projection_, row));
+      ++num_rows;
+    }
+    LOG(INFO) << "Scanned " << num_rows << " rows";
+    return Status::OK();
+  }
+
+  std::string RedisKey(int key) const {
+    return strings::Substitute("hash$0", key);
+  }
+
+  // Writes the Redis hashes of the batch-th write batch, with all their fields set, as HMSET would.
+  CHECKED_STATUS WriteRedisHashes(int batch) {
+    auto dwb = MakeDocWriteBatch();
+    const int end = std::min((batch + 1) * FLAGS_docdb_bench_write_batch_size,
+                             FLAGS_docdb_bench_num_rows);
+    for (int key = batch * FLAGS_docdb_bench_write_batch_size; key < end; ++key) {
+      SubDocument hash;
+      for (int field = 0; field < FLAGS_docdb_bench_num_columns; ++field) {
+        hash.SetChild(PrimitiveValue(strings::Substitute("f$0", field)),
+                      SubDocument(PrimitiveValue(RandomValue())));
+      }
+      RETURN_NOT_OK(dwb.InsertSubDocument(
+          DocPath::DocPathFromRedisKey(static_cast<uint16_t>(key), RedisKey(key)), hash));
+    }
+    return WriteToRocksDB(dwb, NextWriteTime());
+  }
+
+  CHECKED_STATUS ReadRedisHash(int key) {
+    const SubDocKey subdoc_key(DocKey::FromRedisKey(static_cast<uint16_t>(key), RedisKey(key)));
+    SubDocument result;
+    bool doc_found = false;
+    RETURN_NOT_OK(docdb::GetSubDocument(
+        rocksdb(), docdb::GetSubDocumentData(&subdoc_key, &result, &doc_found),
+        rocksdb::kDefaultQueryId, boost::none, ReadHybridTime::SingleTime(last_write_time_)));
+    if (!doc_found) {
+      return STATUS_FORMAT(IllegalState, "Redis key $0 should be found", RedisKey(key));
+    }
+    return Status::OK();
+  }
+
+  std::map<rocksdb::Tickers, uint64_t> TickerSnapshot() const {
+    std::map<rocksdb::Tickers, uint64_t> result;
+    for (const auto& ticker : kTickers) {
+      result[ticker.first] = options().statistics->getTickerCount(ticker.first);
+    }
+    return result;
+  }
+
+  // Like Measure, followed by a flush and a full compaction when
+  // FLAGS_docdb_bench_compact_after_writes is set, which are included in the write amplification.
+  template <class Op>
+  CHECKED_STATUS MeasureWrites(const std::string& workload, int num_ops, const Op& op) {
+    return Measure(workload, num_ops, op, FLAGS_docdb_bench_compact_after_writes);
+  }
+
+  // Runs op num_ops times, with the index of the operation, and prints the throughput, the latency
+  // distribution and the per operation RocksDB statistics of the workload.
+  template <class Op>
+  CHECKED_STATUS Measure(const std::string& workload, int num_ops, const Op& op,
+                         bool compact = false) {
+    const auto tickers_before = TickerSnapshot();
+    HdrHistogram latency_us(60 * MonoTime::kMicrosecondsPerSecond, 2);
+    const MonoTime start = MonoTime::Now();
+    for (int i = 0; i < num_ops; ++i) {
+      const MonoTime op_start = MonoTime::Now();
+      RETURN_NOT_OK_PREPEND(op(i), strings::Substitute("Workload $0 failed", workload));
+      latency_us.Increment((MonoTime::Now() - op_start).ToMicroseconds());
+    }
+    const MonoDelta elapsed = MonoTime::Now() - start;
+    if (compact) {
+      RETURN_NOT_OK(FlushRocksDB());
+      RETURN_NOT_OK(rocksdb()->CompactRange(rocksdb::CompactRangeOptions(), nullptr, nullptr));
+    }
+    const auto tickers_after = TickerSnapshot();
+
+    std::cout << workload << ": " << num_ops << " ops in " << elapsed.ToSeconds() << " s, "
+              << num_ops / std::max(elapsed.ToSeconds(), 1e-9) << " ops/s" << std::endl
+              << "  latency us: mean " << latency_us.MeanValue()
+              << " p50 " << latency_us.ValueAtPercentile(50)
+              << " p99 " << latency_us.ValueAtPercentile(99)
+              << " p99.9 " << latency_us.ValueAtPercentile(99.9)
+              << " max " << latency_us.MaxValue() << std::endl;
+    std::cout << "  per op:";
+    std::map<rocksdb::Tickers, uint64_t> delta;
+    for (const auto& ticker : kTickers) {
+      delta[ticker.first] = tickers_after.at(ticker.first) - tickers_before.at(ticker.first);
+      std::cout << " " << ticker.second << " "
+                << static_cast<double>(delta[ticker.first]) / std::max(num_ops, 1) << ";";
+    }
+    std::cout << std::endl;
+    // Write amplification: bytes written to SST files by flushes and compactions per byte written
+    // by the user.
+    if (delta[rocksdb::BYTES_WRITTEN] > 0) {
+      std::cout << "  write amplification: "
+                << static_cast<double>(delta[rocksdb::FLUSH_WRITE_BYTES] +
+                                       delta[rocksdb::COMPACT_WRITE_BYTES]) /
+                   delta[rocksdb::BYTES_WRITTEN]
+                << std::endl;
+    }
+    return Status::OK();
+  }
+
+  Random rng_;
+  Schema projection_;
+  PendingTransactionStatusManager status_manager_;
+  HybridTime last_write_time_ = HybridTime::FromMicros(MonoTime::kMicrosecondsPerSecond);
+};
+
+} // namespace
+
+} // namespace tools
+} // namespace yb
+
+int main(int argc, char** argv) {
+  yb::ParseCommandLineFlags(&argc, &argv, true);
+  yb::InitGoogleLoggingSafe(argv[0]);
+  if (FLAGS_docdb_bench_num_rows <= 0 || FLAGS_docdb_bench_num_columns <= 0 ||
+      FLAGS_docdb_bench_write_batch_size <= 0) {
+    LOG(FATAL) << "--docdb_bench_num_rows, --docdb_bench_num_columns and "
+        "--docdb_bench_write_batch_size need to be greater than 0";
+  }
+
+  yb::tools::DocDBBench bench;
+  yb::Status s = bench.Run();
+  if (!s.ok()) {
+    LOG(FATAL) << "Error running DocDB benchmark: " << s.ToString();
+  }
+  return 0;
+}
@@ -601,5 +601,59 @@ TEST_F_EX(YBBulkLoadTest, TestCLITool, YBBulkLoadTestWithoutRebalancing) {
   }
 }
 
+TEST_F_EX(YBBulkLoadTest, TestCLIToolPartitionsInput, YBBulkLoadTestWithoutRebalancing) {
+  string test_dir;
+  Env* env = Env::Default();
+  ASSERT_OK(env->GetTestDirectory(&test_dir));
+  string bulk_load_data = JoinPathSegments(test_dir, "bulk_load_partitioned_data");
+  if (env->FileExists(bulk_load_data)) {
+    ASSERT_OK(env->DeleteRecursively(bulk_load_data));
+  }
+  ASSERT_OK(env->CreateDir(bulk_load_data));
+
+  // Unsorted rows without tablet ids, and a partition buffer small enough to spill many times.
+  vector<string> bulk_load_argv = {
+      kBulkLoadToolName,
+      "-master_addresses", master_addresses_comma_separated_,
+      "-table_name", kTableName,
+      "-namespace_name", kNamespace,
+      "-base_dir", bulk_load_data,
+      "-initial_seqno", "0",
+      "-bulk_load_partition_input",
+      "-bulk_load_partition_buffer_bytes", "4096"
+  };
+  FILE *out;
+  FILE *in;
+  std::unique_ptr<Subprocess> bulk_load_process;
+  ASSERT_OK(StartProcessAndGetStreams(GetToolPath(kBulkLoadToolName), bulk_load_argv, &out, &in,
+                                      &bulk_load_process));
+  for (int i = 0; i < kNumIterations; i++) {
+    ASSERT_GT(fputs((GenerateRow(i) + "\n").c_str(), out), 0);
+  }
+  ASSERT_EQ(0, fflush(out));
+  CloseStreamsAndWaitForProcess(out, in, bulk_load_process.get());
+
+  // Every tablet got its own SST files, and the spilled rows are cleaned up.
+  master::GetTableLocationsRequestPB req;
+  master::GetTableLocationsResponsePB resp;
+  rpc::RpcController controller;
+  req.mutable_table()->set_table_name(table_name_->table_name());
+  req.mutable_table()->mutable_namespace_()->set_name(kNamespace);
+  req.set_max_returned_locations(kNumTablets);
+  ASSERT_OK(proxy_->GetTableLocations(req, &resp, &controller));
+  ASSERT_FALSE(resp.has_error());
+  ASSERT_EQ(kNumTablets, resp.tablet_locations_size());
+  for (const master::TabletLocationsPB& tablet_location : resp.tablet_locations()) {
+    string tablet_path = JoinPathSegments(bulk_load_data, tablet_location.tablet_id());
+    ASSERT_TRUE(env->FileExists(tablet_path));
+    vector<string> tablet_files;
+    ASSERT_OK(env->GetChildren(tablet_path, &tablet_files));
+    ASSERT_TRUE(std::any_of(tablet_files.begin(), tablet_files.end(), [](const string& file) {
+      return boost::algorithm::ends_with(file, ".sst");
+    })) << tablet_path;
+  }
+  ASSERT_FALSE(env->FileExists(JoinPathSegments(bulk_load_data, ".partitions")));
+}
+
 } // namespace tools
 } // namespace yb
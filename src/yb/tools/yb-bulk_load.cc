@@ -12,6 +12,7 @@
 //
 
 #include <sched.h>
+#include <fstream>
 #include <iostream>
 #include <thread>
 #include <boost/algorithm/string.hpp>
@@ -58,6 +59,7 @@ using yb::client::YBTableName;
 using yb::docdb::DocWriteBatch;
 using yb::docdb::InitMarkerBehavior;
 using yb::operator"" _GB;
+using yb::operator"" _MB;
 
 DEFINE_string(master_addresses, "", "Comma-separated list of YB Master server addresses");
 DEFINE_string(table_name, "", "Name of the table to generate partitions for");
@@ -82,6 +84,12 @@ DEFINE_int32(bulk_load_max_background_flushes, 2, "Number of flushes to perform
 DEFINE_uint64(bulk_load_num_files_per_tablet, 5,
               "Determines how to compact the data of a tablet to ensure we have only a certain "
               "number of sst files per tablet");
+DEFINE_bool(bulk_load_partition_input, false,
+            "If true, the input consists of plain rows which the tool partitions into tablets "
+            "itself, instead of the output of yb-generate_partitions sorted by tablet id");
+DEFINE_int64(bulk_load_partition_buffer_bytes, 256_MB,
+             "With --bulk_load_partition_input, the amount of memory used to buffer partitioned "
+             "rows before they are spilled to per-tablet files under --base_dir");
 
 namespace yb {
 namespace tools {
@@ -117,12 +125,39 @@ class CompactionTask: public Runnable {
   BulkLoadDocDBUtil *const db_fixture_;
 };
 
+// Groups the rows of the input by tablet with bounded memory. Rows are buffered per tablet, and
+// the buffers are appended to a spill file per tablet whenever they get too large.
+class RowPartitioner {
+ public:
+  RowPartitioner(YBPartitionGenerator* partition_generator, string spill_dir);
+
+  CHECKED_STATUS Add(string row);
+
+  // Spills the remaining rows and closes the files.
+  CHECKED_STATUS Finish();
+
+  // The spill file of each tablet, ordered by tablet id.
+  const std::map<TabletId, string>& spill_files() const { return spill_files_; }
+
+ private:
+  CHECKED_STATUS Spill();
+
+  YBPartitionGenerator* const partition_generator_;
+  const string spill_dir_;
+  std::map<TabletId, vector<string>> buffers_;
+  size_t buffered_bytes_ = 0;
+  std::map<TabletId, string> spill_files_;
+  std::map<TabletId, std::unique_ptr<WritableFile>> files_;
+};
+
 class BulkLoad {
  public:
   CHECKED_STATUS RunBulkLoad();
 
  private:
   CHECKED_STATUS InitYBBulkLoad();
+  CHECKED_STATUS AddRow(const TabletId& tablet_id, string row);
+  CHECKED_STATUS LoadPartitionedInput();
   CHECKED_STATUS InitDBUtil(const TabletId &tablet_id);
   CHECKED_STATUS FinishTabletProcessing(const TabletId &tablet_id,
                                         vector<pair<TabletId, string>> rows);
@@ -134,8 +169,59 @@ class BulkLoad {
   unique_ptr<YBPartitionGenerator> partition_generator_;
   gscoped_ptr<ThreadPool> thread_pool_;
   unique_ptr<BulkLoadDocDBUtil> db_fixture_;
+  TabletId current_tablet_id_;
+  vector<pair<TabletId, string>> rows_;
 };
 
+RowPartitioner::RowPartitioner(YBPartitionGenerator* partition_generator, string spill_dir)
+    : partition_generator_(partition_generator),
+      spill_dir_(std::move(spill_dir)) {
+}
+
+Status RowPartitioner::Add(string row) {
+  string tablet_id;
+  string partition_key;
+  RETURN_NOT_OK_PREPEND(partition_generator_->LookupTabletId(row, &tablet_id, &partition_key),
+                        "Error parsing line: " + row);
+  buffered_bytes_ += row.size() + 1;
+  buffers_[tablet_id].push_back(std::move(row));
+  if (buffered_bytes_ >= static_cast<size_t>(FLAGS_bulk_load_partition_buffer_bytes)) {
+    return Spill();
+  }
+  return Status::OK();
+}
+
+Status RowPartitioner::Spill() {
+  Env* env = Env::Default();
+  for (auto& entry : buffers_) {
+    const TabletId& tablet_id = entry.first;
+    auto& file = files_[tablet_id];
+    if (!file) {
+      const string path = JoinPathSegments(spill_dir_, tablet_id);
+      gscoped_ptr<WritableFile> new_file;
+      RETURN_NOT_OK(env->NewWritableFile(path, &new_file));
+      file.reset(new_file.release());
+      spill_files_[tablet_id] = path;
+    }
+    for (const string& row : entry.second) {
+      RETURN_NOT_OK(file->Append(row));
+      RETURN_NOT_OK(file->Append("\n"));
+    }
+  }
+  buffers_.clear();
+  buffered_bytes_ = 0;
+  return Status::OK();
+}
+
+Status RowPartitioner::Finish() {
+  RETURN_NOT_OK(Spill());
+  for (auto& entry : files_) {
+    RETURN_NOT_OK(entry.second->Close());
+  }
+  files_.clear();
+  return Status::OK();
+}
+
 CompactionTask::CompactionTask(const vector<string>& sst_filenames, BulkLoadDocDBUtil* db_fixture)
     : sst_filenames_(sst_filenames),
       db_fixture_(db_fixture) {
@@ -475,43 +561,75 @@ Status BulkLoad::InitYBBulkLoad() {
 }
 
 
-Status BulkLoad::RunBulkLoad() {
-
-  RETURN_NOT_OK(InitYBBulkLoad());
+Status BulkLoad::AddRow(const TabletId& tablet_id, string row) {
+  // Reinitialize rocksdb if needed.
+  if (current_tablet_id_.empty() || current_tablet_id_ != tablet_id) {
+    // Flush all of the data before opening a new rocksdb.
+    RETURN_NOT_OK(FinishTabletProcessing(current_tablet_id_, std::move(rows_)));
+    rows_.clear();
+    RETURN_NOT_OK(InitDBUtil(tablet_id));
+  }
+  current_tablet_id_ = tablet_id;
+  rows_.emplace_back(tablet_id, std::move(row));
 
-  TabletId current_tablet_id;
+  // Flush the batch if necessary.
+  if (rows_.size() >= FLAGS_row_batch_size) {
+    RETURN_NOT_OK(RetryableSubmit(std::move(rows_)));
+    rows_.clear();
+  }
+  return Status::OK();
+}
 
-  vector<pair<TabletId, string>> rows;
+Status BulkLoad::LoadPartitionedInput() {
+  // The rows are grouped by tablet first, then each tablet is loaded as if its rows came sorted.
+  const string spill_dir = JoinPathSegments(FLAGS_base_dir, ".partitions");
+  Env* env = Env::Default();
+  RETURN_NOT_OK(env->CreateDir(spill_dir));
+  RowPartitioner partitioner(partition_generator_.get(), spill_dir);
   for (string line; std::getline(std::cin, line);) {
     // Trim the line.
     boost::algorithm::trim(line);
+    if (!line.empty()) {
+      RETURN_NOT_OK(partitioner.Add(std::move(line)));
+    }
+  }
+  RETURN_NOT_OK(partitioner.Finish());
 
-    // Get the key and value.
-    std::size_t index = line.find("\t");
-    if (index == std::string::npos) {
-      return STATUS_SUBSTITUTE(IllegalState, "Invalid line: $0", line);
+  for (const auto& entry : partitioner.spill_files()) {
+    std::ifstream input(entry.second);
+    for (string row; std::getline(input, row);) {
+      RETURN_NOT_OK(AddRow(entry.first, std::move(row)));
     }
-    const TabletId tablet_id = line.substr(0, index);
-    const string row = line.substr(index + 1, line.size() - (index + 1));
-
-    // Reinitialize rocksdb if needed.
-    if (current_tablet_id.empty() || current_tablet_id != tablet_id) {
-      // Flush all of the data before opening a new rocksdb.
-      RETURN_NOT_OK(FinishTabletProcessing(current_tablet_id, std::move(rows)));
-      RETURN_NOT_OK(InitDBUtil(tablet_id));
+    if (input.bad()) {
+      return STATUS_SUBSTITUTE(IOError, "Failed to read $0", entry.second);
     }
-    current_tablet_id = tablet_id;
-    rows.emplace_back(std::move(tablet_id), std::move(row));
+  }
+  return env->DeleteRecursively(spill_dir);
+}
 
-    // Flush the batch if necessary.
-    if (rows.size() >= FLAGS_row_batch_size) {
-      RETURN_NOT_OK(RetryableSubmit(std::move(rows)));
+Status BulkLoad::RunBulkLoad() {
+
+  RETURN_NOT_OK(InitYBBulkLoad());
+
+  if (FLAGS_bulk_load_partition_input) {
+    RETURN_NOT_OK(LoadPartitionedInput());
+  } else {
+    for (string line; std::getline(std::cin, line);) {
+      // Trim the line.
+      boost::algorithm::trim(line);
+
+      // Get the key and value.
+      std::size_t index = line.find("\t");
+      if (index == std::string::npos) {
+        return STATUS_SUBSTITUTE(IllegalState, "Invalid line: $0", line);
+      }
+      const TabletId tablet_id = line.substr(0, index);
+      RETURN_NOT_OK(AddRow(tablet_id, line.substr(index + 1, line.size() - (index + 1))));
     }
   }
 
   // Process last tablet.
-  RETURN_NOT_OK(FinishTabletProcessing(current_tablet_id, std::move(rows)));
-  return Status::OK();
+  return FinishTabletProcessing(current_tablet_id_, std::move(rows_));
 }
 
 } // anonymous namespace
@@ -67,11 +67,12 @@ class MockYsckTabletServer : public YsckTabletServer {
       const Schema& schema,
       const ChecksumOptions& options,
       const ReportResultCallback& callback) override {
+    scanned_hybrid_times_.push_back(options.use_snapshot ? options.snapshot_hybrid_time : 0);
     callback.Run(Status::OK(), 0);
   }
 
   Status CurrentHybridTime(uint64_t* hybrid_time) const override {
-    *hybrid_time = 0;
+    *hybrid_time = current_hybrid_time_;
     return Status::OK();
   }
 
@@ -79,8 +80,10 @@ class MockYsckTabletServer : public YsckTabletServer {
     return address_;
   }
 
-  // Public because the unit tests mutate this variable directly.
+  // Public because the unit tests mutate and check these variables directly.
   Status connect_status_;
+  uint64_t current_hybrid_time_ = 0;
+  vector<uint64_t> scanned_hybrid_times_;
 
  private:
   const string address_;
@@ -273,5 +276,26 @@ TEST_F(YsckTest, TestOneOneTabletBrokenTable) {
   ASSERT_TRUE(ysck_->CheckTablesConsistency().IsCorruption());
 }
 
+TEST_F(YsckTest, TestChecksumSnapshotHybridTime) {
+  constexpr uint64_t kHybridTime = 12345;
+  CreateOneSmallReplicatedTable();
+  for (const auto& entry : master_->tablet_servers_) {
+    static_pointer_cast<MockYsckTabletServer>(entry.second)->current_hybrid_time_ = kHybridTime;
+  }
+  ASSERT_OK(ysck_->FetchTableAndTabletInfo());
+  ASSERT_OK(ysck_->ChecksumData({}, {}, ChecksumOptions(MonoDelta::FromSeconds(1), 16)));
+
+  // Every replica of every tablet is scanned at the hybrid time of a single server.
+  size_t num_scans = 0;
+  for (const auto& entry : master_->tablet_servers_) {
+    for (auto hybrid_time : static_pointer_cast<MockYsckTabletServer>(entry.second)
+                                ->scanned_hybrid_times_) {
+      ASSERT_EQ(kHybridTime, hybrid_time);
+      ++num_scans;
+    }
+  }
+  ASSERT_EQ(9U, num_scans);
+}
+
 } // namespace tools
 } // namespace yb
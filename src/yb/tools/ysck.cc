@@ -62,6 +62,11 @@ DEFINE_int32(checksum_timeout_sec, 120,
              "before timing out.");
 DEFINE_int32(checksum_scan_concurrency, 4,
              "Number of concurrent checksum scans to execute per tablet server.");
+DEFINE_bool(checksum_snapshot, true,
+            "Should the checksum scan of every replica read at the same hybrid time.");
+DEFINE_uint64(checksum_snapshot_hybrid_time, yb::tools::ChecksumOptions::kCurrentHybridTime,
+              "Hybrid time to use for the snapshot checksum scans. Defaults to the current "
+              "hybrid time of one of the tablet servers.");
 
 // Print an informational message to cerr.
 static ostream& Info() {
@@ -83,11 +88,18 @@ static ostream& Error() {
 
 ChecksumOptions::ChecksumOptions()
     : timeout(MonoDelta::FromSeconds(FLAGS_checksum_timeout_sec)),
-      scan_concurrency(FLAGS_checksum_scan_concurrency) {}
+      scan_concurrency(FLAGS_checksum_scan_concurrency),
+      use_snapshot(FLAGS_checksum_snapshot),
+      snapshot_hybrid_time(FLAGS_checksum_snapshot_hybrid_time) {}
 
-ChecksumOptions::ChecksumOptions(MonoDelta timeout, int scan_concurrency)
+ChecksumOptions::ChecksumOptions(MonoDelta timeout, int scan_concurrency, bool use_snapshot,
+                                 uint64_t snapshot_hybrid_time)
     : timeout(std::move(timeout)),
-      scan_concurrency(scan_concurrency) {}
+      scan_concurrency(scan_concurrency),
+      use_snapshot(use_snapshot),
+      snapshot_hybrid_time(snapshot_hybrid_time) {}
+
+constexpr uint64_t ChecksumOptions::kCurrentHybridTime;
 
 YsckCluster::~YsckCluster() {
 }
@@ -346,6 +358,15 @@ Status Ysck::ChecksumData(const vector<string>& tables,
     }
   }
 
+  if (options.use_snapshot && options.snapshot_hybrid_time == ChecksumOptions::kCurrentHybridTime &&
+      !tablet_server_queues.empty()) {
+    const shared_ptr<YsckTabletServer>& tablet_server = tablet_server_queues.begin()->first;
+    RETURN_NOT_OK_PREPEND(tablet_server->CurrentHybridTime(&options.snapshot_hybrid_time),
+                          Substitute("Unable to get the current hybrid time of $0",
+                                     tablet_server->address()));
+    Info() << "Using snapshot hybrid time " << options.snapshot_hybrid_time << endl;
+  }
+
   // Kick off checksum scans in parallel. For each tablet server, we start
   // scan_concurrency scans. Each callback then initiates one additional
   // scan when it returns if the queue for that TS is not empty.
@@ -56,13 +56,24 @@ struct ChecksumOptions {
 
   ChecksumOptions();
 
-  ChecksumOptions(MonoDelta timeout, int scan_concurrency);
+  ChecksumOptions(MonoDelta timeout, int scan_concurrency, bool use_snapshot = true,
+                  uint64_t snapshot_hybrid_time = kCurrentHybridTime);
+
+  // Value of snapshot_hybrid_time that makes ysck pick the current hybrid time of a tablet server.
+  static constexpr uint64_t kCurrentHybridTime = 0;
 
   // The maximum total time to wait for results to come back from all replicas.
   MonoDelta timeout;
 
   // The maximum number of concurrent checksum scans to run per tablet server.
   int scan_concurrency;
+
+  // Whether all the replicas are scanned at the same hybrid time, so that writes running
+  // concurrently with the checksum do not show up as mismatches.
+  bool use_snapshot;
+
+  // The hybrid time to scan at when use_snapshot is set.
+  uint64_t snapshot_hybrid_time;
 };
 
 // Representation of a tablet replica on a tablet server.
@@ -0,0 +1,76 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tserver/cdc_service.h"
+
+#include <gtest/gtest.h>
+
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/value.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace tserver {
+
+using docdb::DocKey;
+using docdb::PrimitiveValue;
+using docdb::PrimitiveValues;
+using docdb::SubDocKey;
+
+class CDCServiceTest : public YBTest {
+ protected:
+  void AddPair(const char* row, int column, const char* value) {
+    auto* kv = msg_.mutable_write_request()->mutable_write_batch()->add_kv_pairs();
+    kv->set_key(SubDocKey(DocKey(PrimitiveValues(row)),
+                          PrimitiveValue(ColumnId(column))).Encode(false).data());
+    kv->set_value(docdb::Value(PrimitiveValue(value)).Encode());
+  }
+
+  consensus::ReplicateMsg msg_;
+};
+
+TEST_F(CDCServiceTest, PopulateRecord) {
+  msg_.set_op_type(consensus::WRITE_OP);
+  msg_.mutable_id()->set_term(1);
+  msg_.mutable_id()->set_index(5);
+  msg_.set_hybrid_time(1000);
+  AddPair("k1", 10, "v1");
+  AddPair("k1", 11, "v2");
+  AddPair("k2", 10, "v3");
+
+  CDCRecordPB record;
+  ASSERT_OK(PopulateCDCRecord(msg_, &record));
+  ASSERT_EQ(5, record.op_id().index());
+  ASSERT_EQ(1000, record.hybrid_time());
+  ASSERT_EQ(2, record.rows_size());
+  ASSERT_EQ(DocKey(PrimitiveValues("k1")).Encode().data(), record.rows(0).key());
+  ASSERT_EQ(2, record.rows(0).changes_size());
+  ASSERT_EQ(msg_.write_request().write_batch().kv_pairs(1).key(),
+            record.rows(0).changes(1).key());
+  ASSERT_EQ(DocKey(PrimitiveValues("k2")).Encode().data(), record.rows(1).key());
+  ASSERT_EQ(1, record.rows(1).changes_size());
+}
+
+TEST_F(CDCServiceTest, SkipTransactionalWrites) {
+  msg_.set_op_type(consensus::WRITE_OP);
+  AddPair("k1", 10, "v1");
+  msg_.mutable_write_request()->mutable_write_batch()->mutable_transaction()->set_transaction_id(
+      "txn");
+
+  CDCRecordPB record;
+  ASSERT_OK(PopulateCDCRecord(msg_, &record));
+  ASSERT_EQ(0, record.rows_size());
+}
+
+} // namespace tserver
+} // namespace yb
@@ -0,0 +1,224 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tserver/cdc_service.h"
+
+#include <algorithm>
+
+#include "yb/consensus/consensus.h"
+#include "yb/docdb/doc_key.h"
+#include "yb/rpc/rpc_context.h"
+#include "yb/tablet/tablet_peer.h"
+#include "yb/tserver/service_util.h"
+#include "yb/tserver/tablet_peer_lookup.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/format.h"
+#include "yb/util/size_literals.h"
+
+using yb::operator"" _MB;
+
+DEFINE_int32(cdc_max_batch_size_bytes, 4_MB,
+             "Maximum total size of the operations read from the log for a single change data "
+             "capture request.");
+TAG_FLAG(cdc_max_batch_size_bytes, advanced);
+
+DEFINE_int64(cdc_checkpoint_idle_timeout_ms, 3600000,
+             "The log of a tablet is no longer retained for a change data capture consumer that "
+             "has not read the tablet for this amount of time, in milliseconds.");
+TAG_FLAG(cdc_checkpoint_idle_timeout_ms, advanced);
+TAG_FLAG(cdc_checkpoint_idle_timeout_ms, runtime);
+
+namespace yb {
+namespace tserver {
+
+using consensus::OpId;
+using consensus::ReplicateMsgs;
+using tablet::TabletPeer;
+
+Status PopulateCDCRecord(const consensus::ReplicateMsg& msg, CDCRecordPB* record) {
+  *record->mutable_op_id() = msg.id();
+  record->set_hybrid_time(msg.hybrid_time());
+  const auto& write_batch = msg.write_request().write_batch();
+  if (write_batch.has_transaction()) {
+    return Status::OK();
+  }
+  // The pairs of a row are next to each other in the batch.
+  CDCRowChangePB* row = nullptr;
+  for (const auto& kv : write_batch.kv_pairs()) {
+    auto doc_key_size = docdb::DocKey::EncodedSize(kv.key(), docdb::DocKeyPart::WHOLE_DOC_KEY);
+    RETURN_NOT_OK(doc_key_size);
+    const Slice doc_key(kv.key().data(), *doc_key_size);
+    if (row == nullptr || doc_key != Slice(row->key())) {
+      row = record->add_rows();
+      row->set_key(doc_key.cdata(), doc_key.size());
+    }
+    *row->add_changes() = kv;
+  }
+  return Status::OK();
+}
+
+CDCServiceImpl::ConsumerCheckpoint::ConsumerCheckpoint(
+    scoped_refptr<log::LogAnchorRegistry> registry)
+    : log_anchor_registry(std::move(registry)) {
+}
+
+CDCServiceImpl::ConsumerCheckpoint::~ConsumerCheckpoint() {
+  WARN_NOT_OK(log_anchor_registry->UnregisterIfAnchored(&log_anchor),
+              "Failed to release CDC checkpoint");
+}
+
+CDCServiceImpl::CDCServiceImpl(TabletPeerLookupIf* tablet_peer_lookup,
+                               const scoped_refptr<MetricEntity>& metric_entity)
+    : CDCServiceIf(metric_entity),
+      tablet_peer_lookup_(CHECK_NOTNULL(tablet_peer_lookup)) {
+}
+
+CDCServiceImpl::~CDCServiceImpl() {
+  Shutdown();
+}
+
+void CDCServiceImpl::GetChanges(const GetChangesRequestPB* req,
+                                GetChangesResponsePB* resp,
+                                rpc::RpcContext context) {
+  scoped_refptr<TabletPeer> tablet_peer;
+  Status s = tablet_peer_lookup_->GetTabletPeer(req->tablet_id(), &tablet_peer);
+  if (!s.ok()) {
+    SetupErrorAndRespond(resp->mutable_error(), s, TabletServerErrorPB::TABLET_NOT_FOUND, &context);
+    return;
+  }
+  if (req->consumer_id().empty()) {
+    SetupErrorAndRespond(resp->mutable_error(),
+                         STATUS(InvalidArgument, "Consumer id is required"),
+                         TabletServerErrorPB::UNKNOWN_ERROR, &context);
+    return;
+  }
+
+  consensus::Consensus* consensus = tablet_peer->consensus();
+  if (consensus == nullptr) {
+    SetupErrorAndRespond(resp->mutable_error(),
+                         STATUS(IllegalState, "Tablet is not running"),
+                         TabletServerErrorPB::TABLET_NOT_RUNNING, &context);
+    return;
+  }
+
+  OpId from_op_id;
+  if (req->has_from_op_id()) {
+    from_op_id = req->from_op_id();
+  } else {
+    s = consensus->GetLastOpId(consensus::COMMITTED_OPID, &from_op_id);
+  }
+
+  // The log is anchored before it is read, so it could not be garbage-collected in between.
+  if (s.ok()) {
+    s = UpdateCheckpoint(*tablet_peer, req->consumer_id(), from_op_id.index());
+  }
+
+  ReplicateMsgs msgs;
+  if (s.ok()) {
+    int max_batch_size_bytes = FLAGS_cdc_max_batch_size_bytes;
+    if (req->has_max_batch_size_bytes()) {
+      max_batch_size_bytes = std::min(max_batch_size_bytes, req->max_batch_size_bytes());
+    }
+    s = consensus->ReadReplicatedMessagesForCDC(from_op_id, max_batch_size_bytes, &msgs);
+    if (s.IsNotFound()) {
+      s = s.CloneAndPrepend(Format("The log after $0 was already garbage-collected",
+                                   from_op_id.ShortDebugString()));
+    }
+  }
+
+  OpId checkpoint = from_op_id;
+  for (const auto& msg : msgs) {
+    if (!s.ok()) {
+      break;
+    }
+    if (msg->op_type() == consensus::WRITE_OP) {
+      CDCRecordPB record;
+      s = PopulateCDCRecord(*msg, &record);
+      if (s.ok() && record.rows_size() > 0) {
+        resp->add_records()->Swap(&record);
+      }
+    }
+    checkpoint = msg->id();
+  }
+
+  if (!s.ok()) {
+    HandleErrorResponse(resp, &context, s);
+    return;
+  }
+  *resp->mutable_checkpoint() = checkpoint;
+  context.RespondSuccess();
+}
+
+void CDCServiceImpl::ReleaseCheckpoint(const ReleaseCheckpointRequestPB* req,
+                                       ReleaseCheckpointResponsePB* resp,
+                                       rpc::RpcContext context) {
+  std::unique_ptr<ConsumerCheckpoint> checkpoint;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = checkpoints_.find(CheckpointKey(req->tablet_id(), req->consumer_id()));
+    if (it != checkpoints_.end()) {
+      checkpoint = std::move(it->second);
+      checkpoints_.erase(it);
+    }
+  }
+  context.RespondSuccess();
+}
+
+void CDCServiceImpl::Shutdown() {
+  CheckpointMap checkpoints;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    checkpoints.swap(checkpoints_);
+  }
+}
+
+Status CDCServiceImpl::UpdateCheckpoint(const TabletPeer& tablet_peer,
+                                        const std::string& consumer_id,
+                                        int64_t op_index) {
+  const MonoTime now = MonoTime::Now();
+  std::lock_guard<std::mutex> lock(mutex_);
+  ReleaseIdleCheckpointsUnlocked(now);
+
+  const std::string owner = Format("CDC-$0", consumer_id);
+  auto& checkpoint = checkpoints_[CheckpointKey(tablet_peer.tablet_id(), consumer_id)];
+  if (checkpoint &&
+      checkpoint->log_anchor_registry.get() != tablet_peer.log_anchor_registry().get()) {
+    // The tablet peer was replaced, e.g. by a remote bootstrap.
+    checkpoint.reset();
+  }
+  if (!checkpoint) {
+    checkpoint.reset(new ConsumerCheckpoint(tablet_peer.log_anchor_registry()));
+    checkpoint->log_anchor_registry->Register(op_index, owner, &checkpoint->log_anchor);
+  } else {
+    RETURN_NOT_OK(checkpoint->log_anchor_registry->UpdateRegistration(
+        op_index, owner, &checkpoint->log_anchor));
+  }
+  checkpoint->last_active = now;
+  return Status::OK();
+}
+
+void CDCServiceImpl::ReleaseIdleCheckpointsUnlocked(MonoTime now) {
+  const MonoDelta idle_timeout = MonoDelta::FromMilliseconds(FLAGS_cdc_checkpoint_idle_timeout_ms);
+  for (auto it = checkpoints_.begin(); it != checkpoints_.end();) {
+    if (now.GetDeltaSince(it->second->last_active).MoreThan(idle_timeout)) {
+      LOG(INFO) << "Releasing idle CDC checkpoint of consumer " << it->first.second
+                << " on tablet " << it->first.first;
+      it = checkpoints_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+} // namespace tserver
+} // namespace yb
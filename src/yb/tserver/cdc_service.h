@@ -0,0 +1,100 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TSERVER_CDC_SERVICE_H
+#define YB_TSERVER_CDC_SERVICE_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "yb/consensus/consensus.pb.h"
+#include "yb/consensus/log_anchor_registry.h"
+#include "yb/gutil/ref_counted.h"
+#include "yb/tserver/cdc_service.service.h"
+#include "yb/util/monotime.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+namespace tablet {
+class TabletPeer;
+} // namespace tablet
+
+namespace tserver {
+
+class TabletPeerLookupIf;
+
+// Fills 'record' with the row changes of a replicated write operation. The writes of distributed
+// transactions produce no rows, their changes are written to the regular records only when the
+// transaction is applied.
+CHECKED_STATUS PopulateCDCRecord(const consensus::ReplicateMsg& msg, CDCRecordPB* record);
+
+// Change data capture service. Streams the committed writes of a tablet by tailing its Raft log,
+// through the log cache of the tablet's consensus. The log of a tablet is retained from the
+// checkpoint of every consumer, as long as the consumer keeps reading it, see
+// cdc_checkpoint_idle_timeout_ms.
+class CDCServiceImpl : public CDCServiceIf {
+ public:
+  CDCServiceImpl(TabletPeerLookupIf* tablet_peer_lookup,
+                 const scoped_refptr<MetricEntity>& metric_entity);
+
+  ~CDCServiceImpl();
+
+  void GetChanges(const GetChangesRequestPB* req,
+                  GetChangesResponsePB* resp,
+                  rpc::RpcContext context) override;
+
+  void ReleaseCheckpoint(const ReleaseCheckpointRequestPB* req,
+                         ReleaseCheckpointResponsePB* resp,
+                         rpc::RpcContext context) override;
+
+  void Shutdown() override;
+
+ private:
+  // The log of a tablet anchored for a consumer.
+  struct ConsumerCheckpoint {
+    explicit ConsumerCheckpoint(scoped_refptr<log::LogAnchorRegistry> registry);
+    ~ConsumerCheckpoint();
+
+    const scoped_refptr<log::LogAnchorRegistry> log_anchor_registry;
+    log::LogAnchor log_anchor;
+    MonoTime last_active;
+  };
+
+  // Tablet id and consumer id.
+  typedef std::pair<std::string, std::string> CheckpointKey;
+  typedef std::map<CheckpointKey, std::unique_ptr<ConsumerCheckpoint>> CheckpointMap;
+
+  // Anchors the log of the tablet at 'op_index' for the consumer, releasing the log before it.
+  CHECKED_STATUS UpdateCheckpoint(const tablet::TabletPeer& tablet_peer,
+                                  const std::string& consumer_id,
+                                  int64_t op_index);
+
+  // Releases the checkpoints of the consumers that have not read for longer than
+  // cdc_checkpoint_idle_timeout_ms.
+  void ReleaseIdleCheckpointsUnlocked(MonoTime now);
+
+  TabletPeerLookupIf* const tablet_peer_lookup_;
+
+  // Protects checkpoints_.
+  std::mutex mutex_;
+  CheckpointMap checkpoints_;
+};
+
+} // namespace tserver
+} // namespace yb
+
+#endif // YB_TSERVER_CDC_SERVICE_H
@@ -47,6 +47,7 @@
 #include "yb/master/master_rpc.h"
 #include "yb/server/server_base.proxy.h"
 #include "yb/server/webserver.h"
+#include "yb/tablet/tablet_hotspots.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/tablet_server_options.h"
 #include "yb/tserver/ts_tablet_manager.h"
@@ -132,6 +133,11 @@ class Heartbeater::Thread {
   int GetMillisUntilNextHeartbeat() const;
   CHECKED_STATUS DoHeartbeat();
   CHECKED_STATUS TryHeartbeat();
+  // Adds the decaying read and write rates and the hot keys of the tablet to the heartbeat request
+  // if the tablet peer is the leader and the tablet served any operations recently.
+  void ReportTabletLoad(const scoped_refptr<tablet::TabletPeer>& tablet_peer,
+                        tablet::TabletClass* tablet,
+                        master::TSHeartbeatRequestPB* req);
   CHECKED_STATUS SetupRegistration(master::TSRegistrationPB* reg);
   void SetupCommonField(master::TSToMasterCommonPB* common);
   bool IsCurrentThread() const;
@@ -333,6 +339,36 @@ Status Heartbeater::Thread::SetupRegistration(master::TSRegistrationPB* reg) {
   return Status::OK();
 }
 
+void Heartbeater::Thread::ReportTabletLoad(
+    const scoped_refptr<tablet::TabletPeer>& tablet_peer, tablet::TabletClass* tablet,
+    master::TSHeartbeatRequestPB* req) {
+  if (tablet == nullptr) {
+    return;
+  }
+  // Rates are updated even for followers, so they are up to date when the peer becomes leader.
+  const tablet::TabletLoad load = tablet->hotspots()->GetLoad();
+  if (tablet_peer->LeaderStatus() == consensus::Consensus::LeaderStatus::NOT_LEADER) {
+    return;
+  }
+  // Rates below this are leftovers of the decay of a tablet that is not used anymore.
+  constexpr double kMinReportedOpsPerSec = 0.01;
+  if (load.read_ops_per_sec < kMinReportedOpsPerSec &&
+      load.write_ops_per_sec < kMinReportedOpsPerSec) {
+    return;
+  }
+  auto* tablet_metrics = req->mutable_metrics()->add_tablet_metrics();
+  tablet_metrics->set_tablet_id(tablet_peer->tablet_id());
+  tablet_metrics->set_read_ops_per_sec(load.read_ops_per_sec);
+  tablet_metrics->set_write_ops_per_sec(load.write_ops_per_sec);
+  tablet_metrics->set_read_bytes_per_sec(load.read_bytes_per_sec);
+  tablet_metrics->set_write_bytes_per_sec(load.write_bytes_per_sec);
+  for (const auto& hot_key : load.hot_keys) {
+    auto* hot_key_pb = tablet_metrics->add_hot_keys();
+    hot_key_pb->set_key(hot_key.first);
+    hot_key_pb->set_fraction(hot_key.second);
+  }
+}
+
 int Heartbeater::Thread::GetMinimumHeartbeatMillis() const {
   // If we've failed a few heartbeats in a row, back off to the normal
   // interval, rather than retrying in a loop.
@@ -394,6 +430,10 @@ Status Heartbeater::Thread::TryHeartbeat() {
       req.mutable_metrics()->set_total_ram_usage(ru.ru_maxrss);
       VLOG(4) << "Total Memory Usage: " << ru.ru_maxrss;
     }
+    // Calculate the time since the previous submission, for the read and write ops per second.
+    MonoDelta diff = MonoTime::Now() - prev_tserver_metrics_submission_;
+    double_t div = diff.ToSeconds();
+
     // Get the Total SST file sizes and set it in the proto buf
     std::vector<scoped_refptr<yb::tablet::TabletPeer> > tablet_peers;
     uint64_t total_file_sizes = 0;
@@ -403,6 +443,7 @@ Status Heartbeater::Thread::TryHeartbeat() {
       if (tablet_peer) {
         shared_ptr<yb::tablet::TabletClass> tablet_class = tablet_peer->shared_tablet();
         total_file_sizes += (tablet_class) ? tablet_class->GetTotalSSTFileSizes() : 0;
+        ReportTabletLoad(tablet_peer, tablet_class.get(), &req);
       }
     }
     req.mutable_metrics()->set_total_sst_file_size(total_file_sizes);
@@ -417,9 +458,6 @@ Status Heartbeater::Thread::TryHeartbeat() {
     uint64_t num_writes = (writes_hist != nullptr) ? writes_hist->TotalCount() : 0;
 
     // Calculate the read and write ops per second.
-    MonoDelta diff = MonoTime::Now() - prev_tserver_metrics_submission_;
-    double_t div = diff.ToSeconds();
-
     double rops_per_sec = (div > 0 && num_reads > 0) ?
         (static_cast<double>(num_reads - prev_reads_) / div) : 0;
 
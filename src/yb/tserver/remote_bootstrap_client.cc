@@ -32,6 +32,9 @@
 
 #include "yb/tserver/remote_bootstrap_client.h"
 
+#include <atomic>
+#include <mutex>
+
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
@@ -44,6 +47,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/strings/util.h"
 #include "yb/gutil/walltime.h"
+#include "yb/rocksdb/rate_limiter.h"
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc_controller.h"
 #include "yb/tablet/tablet.pb.h"
@@ -53,6 +57,7 @@
 #include "yb/tserver/remote_bootstrap.proxy.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/ts_tablet_manager.h"
+#include "yb/util/countdown_latch.h"
 #include "yb/util/crc.h"
 #include "yb/util/env.h"
 #include "yb/util/env_util.h"
@@ -60,6 +65,26 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/net/net_util.h"
+#include "yb/util/size_literals.h"
+#include "yb/util/threadpool.h"
+
+using yb::operator"" _MB;
+
+DEFINE_int32(remote_bootstrap_max_concurrent_downloads, 4,
+             "Maximum number of RocksDB files or WAL segments, that a remote bootstrap client "
+             "downloads at once.");
+TAG_FLAG(remote_bootstrap_max_concurrent_downloads, advanced);
+
+DEFINE_int64(remote_bootstrap_max_chunk_size, 64_MB,
+             "Maximum number of bytes requested by a remote bootstrap client in one round trip. "
+             "It is also limited by rpc_max_message_size.");
+TAG_FLAG(remote_bootstrap_max_chunk_size, advanced);
+
+DEFINE_int64(remote_bootstrap_rate_limit_bytes_per_sec, 256_MB,
+             "Maximum number of bytes per second, that all remote bootstrap clients of this "
+             "tablet server download together. Non positive value means no limit. Read once, "
+             "when the first remote bootstrap starts.");
+TAG_FLAG(remote_bootstrap_rate_limit_bytes_per_sec, advanced);
 
 DEFINE_int32(remote_bootstrap_begin_session_timeout_ms, 3000,
              "Tablet server RPC client timeout for BeginRemoteBootstrapSession calls.");
@@ -116,6 +141,54 @@ using tablet::TabletMetadata;
 using tablet::TabletStatusListener;
 using tablet::TabletSuperBlockPB;
 
+namespace {
+
+// Limits the download rate of all the remote bootstrap clients of this process.
+rocksdb::RateLimiter* DownloadRateLimiter() {
+  static std::unique_ptr<rocksdb::RateLimiter> rate_limiter(
+      FLAGS_remote_bootstrap_rate_limit_bytes_per_sec > 0
+          ? rocksdb::NewGenericRateLimiter(FLAGS_remote_bootstrap_rate_limit_bytes_per_sec)
+          : nullptr);
+  return rate_limiter.get();
+}
+
+void ThrottleDownload(size_t bytes) {
+  auto* rate_limiter = DownloadRateLimiter();
+  if (!rate_limiter) {
+    return;
+  }
+  // The rate limiter grants at most one burst at a time.
+  int64_t remaining = bytes;
+  while (remaining > 0) {
+    const int64_t request = std::min(remaining, rate_limiter->GetSingleBurstBytes());
+    rate_limiter->Request(request, rocksdb::Env::IO_HIGH);
+    remaining -= request;
+  }
+}
+
+// Asynchronous FetchData call of a chunk.
+struct FetchDataCall {
+  FetchDataRequestPB req;
+  FetchDataResponsePB resp;
+  rpc::RpcController controller;
+  CountDownLatch latch{0};
+  bool in_flight = false;
+
+  void Wait() {
+    if (in_flight) {
+      latch.Wait();
+      in_flight = false;
+    }
+  }
+
+  ~FetchDataCall() {
+    // The response and the controller are used by the RPC until it completes.
+    Wait();
+  }
+};
+
+} // namespace
+
 RemoteBootstrapClient::RemoteBootstrapClient(std::string tablet_id,
                                              FsManager* fs_manager,
                                              shared_ptr<Messenger> messenger,
@@ -513,18 +586,60 @@ Status RemoteBootstrapClient::DownloadWALs() {
   // Download the WAL segments.
   int num_segments = wal_seqnos_.size();
   LOG_WITH_PREFIX(INFO) << "Starting download of " << num_segments << " WAL segments...";
-  uint64_t counter = 0;
+  std::atomic<int> counter(0);
+  vector<std::function<Status()>> downloads;
   for (uint64_t seg_seqno : wal_seqnos_) {
-    UpdateStatusMessage(Substitute("Downloading WAL segment with seq. number $0 ($1/$2)",
-                                   seg_seqno, counter + 1, num_segments));
-    RETURN_NOT_OK(DownloadWAL(seg_seqno));
-    ++counter;
+    downloads.push_back([this, seg_seqno, num_segments, &counter] {
+      UpdateStatusMessage(Substitute("Downloading WAL segment with seq. number $0 ($1/$2)",
+                                     seg_seqno, ++counter, num_segments));
+      return DownloadWAL(seg_seqno);
+    });
   }
+  RETURN_NOT_OK(DownloadInParallel("rb-wal-download", downloads));
 
   downloaded_wal_ = true;
   return Status::OK();
 }
 
+Status RemoteBootstrapClient::DownloadInParallel(
+    const string& name, const vector<std::function<Status()>>& downloads) {
+  const int max_threads = std::min<int>(FLAGS_remote_bootstrap_max_concurrent_downloads,
+                                        downloads.size());
+  if (max_threads <= 1) {
+    for (const auto& download : downloads) {
+      RETURN_NOT_OK(download());
+    }
+    return Status::OK();
+  }
+
+  gscoped_ptr<ThreadPool> pool;
+  RETURN_NOT_OK(ThreadPoolBuilder(name).set_max_threads(max_threads).Build(&pool));
+  std::mutex mutex;
+  Status result;
+  std::atomic<bool> failed(false);
+  for (const auto& download : downloads) {
+    Status s = pool->SubmitFunc([&download, &mutex, &result, &failed] {
+      if (failed.load(std::memory_order_acquire)) {
+        return;
+      }
+      Status s = download();
+      if (!s.ok()) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (result.ok()) {
+          result = s;
+        }
+        failed.store(true, std::memory_order_release);
+      }
+    });
+    if (!s.ok()) {
+      pool->Wait();
+      return s;
+    }
+  }
+  pool->Wait();
+  return result;
+}
+
 Status RemoteBootstrapClient::DownloadRocksDBFiles() {
   gscoped_ptr<TabletSuperBlockPB> new_sb(new TabletSuperBlockPB());
   new_sb->CopyFrom(*superblock_);
@@ -541,21 +656,34 @@ Status RemoteBootstrapClient::DownloadRocksDBFiles() {
                         Substitute("Failed to create RocksDB tablet directory $0",
                                    rocksdb_dir));
 
+  vector<std::function<Status()>> downloads;
   for (auto const& file_pb : new_sb->rocksdb_files()) {
-    WritableFileOptions opts;
-    opts.sync_on_close = true;
-    gscoped_ptr<WritableFile> rocksdb_file;
     auto file_path = JoinPathSegments(rocksdb_dir, file_pb.name());
-    RETURN_NOT_OK(fs_manager_->env()->NewWritableFile(opts, file_path, &rocksdb_file));
-
-    DataIdPB data_id;
-    data_id.set_type(DataIdPB::ROCKSDB_FILE);
-    data_id.set_file_name(file_pb.name());
-    RETURN_NOT_OK_PREPEND(DownloadFile(data_id, rocksdb_file.get()),
-                          Substitute("Unable to download rocksdb file $0",
-                                     file_path));
-    VLOG(2) << "Downloading file " << file_path;
+    // Files of the nested intents RocksDB are listed relative to rocksdb_dir.
+    if (DirName(file_path) != rocksdb_dir) {
+      RETURN_NOT_OK_PREPEND(meta_->fs_manager()->CreateDirIfMissing(DirName(file_path)),
+                            Substitute("Failed to create RocksDB directory $0",
+                                       DirName(file_path)));
+    }
+
+    const string& file_name = file_pb.name();
+    downloads.push_back([this, file_path, &file_name] {
+      WritableFileOptions opts;
+      opts.sync_on_close = true;
+      gscoped_ptr<WritableFile> rocksdb_file;
+      RETURN_NOT_OK(fs_manager_->env()->NewWritableFile(opts, file_path, &rocksdb_file));
+
+      VLOG(2) << "Downloading file " << file_path;
+      DataIdPB data_id;
+      data_id.set_type(DataIdPB::ROCKSDB_FILE);
+      data_id.set_file_name(file_name);
+      RETURN_NOT_OK_PREPEND(DownloadFile(data_id, rocksdb_file.get()),
+                            Substitute("Unable to download rocksdb file $0",
+                                       file_path));
+      return Status::OK();
+    });
   }
+  RETURN_NOT_OK(DownloadInParallel("rb-file-download", downloads));
   new_superblock_.swap(new_sb);
   downloaded_rocksdb_files_ = true;
   return Status::OK();
@@ -629,41 +757,73 @@ template<class Appendable>
 Status RemoteBootstrapClient::DownloadFile(const DataIdPB& data_id,
                                            Appendable* appendable) {
   uint64_t offset = 0;
-  int32_t max_length = FLAGS_rpc_max_message_size - 1024; // Leave 1K for message headers.
+  // Leave 1K for message headers.
+  const int64_t max_length = std::min<int64_t>(FLAGS_remote_bootstrap_max_chunk_size,
+                                               FLAGS_rpc_max_message_size - 1024);
+
+  // While one chunk is verified and written, the next one is transferred.
+  FetchDataCall calls[2];
+  auto start_fetch = [this, &data_id, max_length](uint64_t chunk_offset, FetchDataCall* call) {
+    call->controller.Reset();
+    call->controller.set_timeout(MonoDelta::FromMilliseconds(session_idle_timeout_millis_));
+    call->req.set_session_id(session_id_);
+    call->req.mutable_data_id()->CopyFrom(data_id);
+    call->req.set_offset(chunk_offset);
+    call->req.set_max_length(max_length);
+    call->req.set_allow_data_sidecar(true);
+    call->resp.Clear();
+    call->latch.Reset(1);
+    call->in_flight = true;
+    proxy_->FetchDataAsync(call->req, &call->resp, &call->controller,
+                           [call] { call->latch.CountDown(); });
+  };
+
+  int current = 0;
+  start_fetch(offset, &calls[current]);
+  for (;;) {
+    FetchDataCall& call = calls[current];
+    call.Wait();
+    RETURN_NOT_OK_UNWIND_PREPEND(call.controller.status(),
+                                 call.controller,
+                                 "Unable to fetch data from remote");
+    // Servers that do not support sidecars send data in the chunk itself.
+    Slice data(call.resp.chunk().data());
+    if (call.resp.chunk().has_data_sidecar_idx()) {
+      RETURN_NOT_OK_PREPEND(
+          call.controller.GetSidecar(call.resp.chunk().data_sidecar_idx(), &data),
+          "Unable to get data sidecar");
+    }
 
-  rpc::RpcController controller;
-  controller.set_timeout(MonoDelta::FromMilliseconds(session_idle_timeout_millis_));
-  FetchDataRequestPB req;
+    const uint64_t next_offset = offset + data.size();
+    const bool done = next_offset >= call.resp.chunk().total_data_length();
+    if (!done && !data.empty()) {
+      start_fetch(next_offset, &calls[1 - current]);
+    }
 
-  bool done = false;
-  while (!done) {
-    controller.Reset();
-    req.set_session_id(session_id_);
-    req.mutable_data_id()->CopyFrom(data_id);
-    req.set_offset(offset);
-    req.set_max_length(max_length);
-
-    FetchDataResponsePB resp;
-    RETURN_NOT_OK_UNWIND_PREPEND(proxy_->FetchData(req, &resp, &controller),
-                                controller,
-                                "Unable to fetch data from remote");
     // Sanity-check for corruption.
-    RETURN_NOT_OK_PREPEND(VerifyData(offset, resp.chunk()),
+    RETURN_NOT_OK_PREPEND(VerifyData(offset, call.resp.chunk(), data),
                           Substitute("Error validating data item $0", data_id.ShortDebugString()));
 
     // Write the data.
-    RETURN_NOT_OK(appendable->Append(resp.chunk().data()));
+    ThrottleDownload(data.size());
+    RETURN_NOT_OK(appendable->Append(data));
 
-    if (offset + resp.chunk().data().size() == resp.chunk().total_data_length()) {
-      done = true;
+    if (done) {
+      break;
+    }
+    if (data.empty()) {
+      return STATUS(Corruption, "Received empty chunk",
+                    Substitute("$0 at offset $1", data_id.ShortDebugString(), offset));
     }
-    offset += resp.chunk().data().size();
+    offset = next_offset;
+    current = 1 - current;
   }
 
   return Status::OK();
 }
 
-Status RemoteBootstrapClient::VerifyData(uint64_t offset, const DataChunkPB& chunk) {
+Status RemoteBootstrapClient::VerifyData(
+    uint64_t offset, const DataChunkPB& chunk, const Slice& data) {
   // Verify the offset is what we expected.
   if (offset != chunk.offset()) {
     return STATUS(InvalidArgument, "Offset did not match what was asked for",
@@ -671,11 +831,11 @@ Status RemoteBootstrapClient::VerifyData(uint64_t offset, const DataChunkPB& chu
   }
 
   // Verify the checksum.
-  uint32_t crc32 = crc::Crc32c(chunk.data().data(), chunk.data().length());
+  uint32_t crc32 = crc::Crc32c(data.data(), data.size());
   if (PREDICT_FALSE(crc32 != chunk.crc32())) {
     return STATUS(Corruption,
         Substitute("CRC32 does not match at offset $0 size $1: $2 vs $3",
-          offset, chunk.data().size(), crc32, chunk.crc32()));
+          offset, data.size(), crc32, chunk.crc32()));
   }
   return Status::OK();
 }
@@ -32,6 +32,7 @@
 #ifndef YB_TSERVER_REMOTE_BOOTSTRAP_CLIENT_H
 #define YB_TSERVER_REMOTE_BOOTSTRAP_CLIENT_H
 
+#include <functional>
 #include <string>
 #include <memory>
 #include <vector>
@@ -73,11 +74,8 @@ class RemoteBootstrapServiceProxy;
 class TSTabletManager;
 
 // Client class for using remote bootstrap to copy a tablet from another host.
-// This class is not thread-safe.
-//
-// TODO:
-// * Parallelize download of blocks and WAL segments.
-//
+// This class is not thread-safe. RocksDB files and WAL segments are downloaded by several threads
+// internally, with the next chunk of each file being transferred while the current one is written.
 class RemoteBootstrapClient {
  public:
 
@@ -132,6 +130,7 @@ class RemoteBootstrapClient {
  private:
   FRIEND_TEST(RemoteBootstrapRocksDBClientTest, TestBeginEndSession);
   FRIEND_TEST(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFiles);
+  FRIEND_TEST(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFilesInSmallChunks);
 
   // Extract the embedded Status message from the given ErrorStatusPB.
   // The given ErrorStatusPB must extend RemoteBootstrapErrorPB.
@@ -147,9 +146,14 @@ class RemoteBootstrapClient {
   // End the remote bootstrap session.
   CHECKED_STATUS EndRemoteSession();
 
-  // Download all WAL files sequentially.
+  // Download all WAL files, several of them at once.
   CHECKED_STATUS DownloadWALs();
 
+  // Runs the given downloads on up to FLAGS_remote_bootstrap_max_concurrent_downloads threads.
+  // Returns the first failure, the downloads that did not start yet are skipped after it.
+  CHECKED_STATUS DownloadInParallel(const std::string& name,
+                                    const std::vector<std::function<Status()>>& downloads);
+
   // Download a single WAL file.
   // Assumes the WAL directories have already been created.
   // WAL file is opened with options so that it will fsync() on close.
@@ -166,7 +170,8 @@ class RemoteBootstrapClient {
   CHECKED_STATUS DownloadBlock(const BlockId& old_block_id, BlockId* new_block_id);
 
   // Download a single remote file. The block and WAL implementations delegate
-  // to this method when downloading files.
+  // to this method when downloading files. The next chunk is requested before the current one
+  // is appended, so one round trip is always in flight.
   //
   // An Appendable is typically a WritableBlock (block) or WritableFile (WAL).
   //
@@ -177,7 +182,8 @@ class RemoteBootstrapClient {
 
   CHECKED_STATUS DownloadRocksDBFiles();
 
-  CHECKED_STATUS VerifyData(uint64_t offset, const DataChunkPB& resp);
+  // Verifies that data received at the specified offset matches the chunk's checksum.
+  CHECKED_STATUS VerifyData(uint64_t offset, const DataChunkPB& resp, const Slice& data);
 
   // Return standard log prefix.
   std::string LogPrefix();
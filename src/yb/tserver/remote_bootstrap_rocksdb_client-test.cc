@@ -18,6 +18,9 @@
 
 using std::shared_ptr;
 
+DECLARE_int64(remote_bootstrap_max_chunk_size);
+DECLARE_int32(remote_bootstrap_max_concurrent_downloads);
+
 namespace yb {
 namespace tserver {
 
@@ -33,6 +36,10 @@ class RemoteBootstrapRocksDBClientTest : public RemoteBootstrapClientTest {
   void SetUp() override {
     RemoteBootstrapClientTest::SetUp();
   }
+
+ protected:
+  // Verifies that the client has the same files that the leader has.
+  void CheckDownloadedRocksDBFiles();
 };
 
 // Basic begin / end remote bootstrap session.
@@ -46,6 +53,19 @@ TEST_F(RemoteBootstrapRocksDBClientTest, TestBeginEndSession) {
 TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFiles) {
   TabletStatusListener listener(meta_);
   ASSERT_OK(client_->DownloadRocksDBFiles());
+  ASSERT_NO_FATALS(CheckDownloadedRocksDBFiles());
+}
+
+// Download files in many small chunks, to make sure pipelined chunks are written in order.
+TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFilesInSmallChunks) {
+  FLAGS_remote_bootstrap_max_chunk_size = 100;
+  FLAGS_remote_bootstrap_max_concurrent_downloads = 2;
+  TabletStatusListener listener(meta_);
+  ASSERT_OK(client_->DownloadRocksDBFiles());
+  ASSERT_NO_FATALS(CheckDownloadedRocksDBFiles());
+}
+
+void RemoteBootstrapRocksDBClientTest::CheckDownloadedRocksDBFiles() {
   auto tablet_peer_checkpoint_dir = tablet_peer_->tablet()->GetLastRocksDBCheckpointDirForTest();
 
   vector<std::string> rocksdb_files;
@@ -126,7 +126,8 @@ class RemoteBootstrapServiceTest : public RemoteBootstrapTest {
   Status DoFetchData(const string& session_id, const DataIdPB& data_id,
                      uint64_t* offset, int64_t* max_length,
                      FetchDataResponsePB* resp,
-                     RpcController* controller) {
+                     RpcController* controller,
+                     bool allow_data_sidecar = false) {
     controller->set_timeout(MonoDelta::FromSeconds(1.0));
     FetchDataRequestPB req;
     req.set_session_id(session_id);
@@ -137,6 +138,7 @@ class RemoteBootstrapServiceTest : public RemoteBootstrapTest {
     if (max_length) {
       req.set_max_length(*max_length);
     }
+    req.set_allow_data_sidecar(allow_data_sidecar);
     return UnwindRemoteError(
         remote_bootstrap_proxy_->FetchData(req, resp, controller), controller);
   }
@@ -406,6 +408,39 @@ TEST_F(RemoteBootstrapServiceTest, TestFetchLog) {
   AssertDataEqual(slice.data(), slice.size(), resp.chunk());
 }
 
+// Test that log segment data could be fetched as RPC sidecar.
+TEST_F(RemoteBootstrapServiceTest, TestFetchLogAsSidecar) {
+  string session_id;
+  tablet::TabletSuperBlockPB superblock;
+  uint64_t idle_timeout_millis;
+  vector<uint64_t> segment_seqnos;
+  ASSERT_OK(DoBeginValidRemoteBootstrapSession(&session_id,
+                                               &superblock,
+                                               &idle_timeout_millis,
+                                               &segment_seqnos));
+
+  DataIdPB data_id;
+  data_id.set_type(DataIdPB::LOG_SEGMENT);
+  data_id.set_wal_segment_seqno(*segment_seqnos.begin());
+
+  FetchDataResponsePB resp;
+  RpcController controller;
+  ASSERT_OK(DoFetchData(session_id, data_id, nullptr, nullptr, &resp, &controller));
+
+  FetchDataResponsePB sidecar_resp;
+  RpcController sidecar_controller;
+  ASSERT_OK(DoFetchData(session_id, data_id, nullptr, nullptr, &sidecar_resp,
+                        &sidecar_controller, true /* allow_data_sidecar */));
+  ASSERT_TRUE(sidecar_resp.chunk().has_data_sidecar_idx());
+  ASSERT_TRUE(sidecar_resp.chunk().data().empty());
+  Slice sidecar;
+  ASSERT_OK(sidecar_controller.GetSidecar(sidecar_resp.chunk().data_sidecar_idx(), &sidecar));
+
+  AssertDataEqual(sidecar.data(), sidecar.size(), resp.chunk());
+  ASSERT_EQ(resp.chunk().crc32(), sidecar_resp.chunk().crc32());
+  ASSERT_EQ(resp.chunk().total_data_length(), sidecar_resp.chunk().total_data_length());
+}
+
 // Test that the remote bootstrap session timeout works properly.
 TEST_F(RemoteBootstrapServiceTest, TestSessionTimeout) {
   // This flag should be seen by the service due to TSO.
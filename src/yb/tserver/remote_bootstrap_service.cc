@@ -218,6 +218,37 @@ void RemoteBootstrapServiceImpl::CheckSessionActive(
   }
 }
 
+namespace {
+
+template <class Buffer>
+Status GetDataPiece(RemoteBootstrapSession* session, const DataIdPB& data_id, uint64_t offset,
+                    int64_t client_maxlen, Buffer* data, int64_t* total_data_length,
+                    RemoteBootstrapErrorPB::Code* error_code, string* error_message) {
+  switch (data_id.type()) {
+    case DataIdPB::BLOCK:
+      // Fetching a data block chunk.
+      *error_message = "Unable to get piece of data block";
+      return session->GetBlockPiece(BlockId::FromPB(data_id.block_id()), offset, client_maxlen,
+                                    data, total_data_length, error_code);
+    case DataIdPB::LOG_SEGMENT:
+      // Fetching a log segment chunk.
+      *error_message = "Unable to get piece of log segment";
+      return session->GetLogSegmentPiece(data_id.wal_segment_seqno(), offset, client_maxlen,
+                                         data, total_data_length, error_code);
+    case DataIdPB::ROCKSDB_FILE:
+      *error_message = "Unable to get piece of RocksDB file";
+      return session->GetFilePiece(data_id.file_name(), offset, client_maxlen, data,
+                                   total_data_length, error_code);
+    default:
+      break;
+  }
+  *error_message = Substitute("Invalid request type $0", data_id.type());
+  *error_code = RemoteBootstrapErrorPB::INVALID_REMOTE_BOOTSTRAP_REQUEST;
+  return STATUS(InvalidArgument, *error_message);
+}
+
+} // namespace
+
 void RemoteBootstrapServiceImpl::FetchData(const FetchDataRequestPB* req,
                                            FetchDataResponsePB* resp,
                                            rpc::RpcContext context) {
@@ -243,36 +274,38 @@ void RemoteBootstrapServiceImpl::FetchData(const FetchDataRequestPB* req,
                     error_code, "Invalid DataId");
 
   DataChunkPB* data_chunk = resp->mutable_chunk();
-  string* data = data_chunk->mutable_data();
   int64_t total_data_length = 0;
-  if (data_id.type() == DataIdPB::BLOCK) {
-    // Fetching a data block chunk.
-    const BlockId& block_id = BlockId::FromPB(data_id.block_id());
-    RPC_RETURN_NOT_OK(session->GetBlockPiece(block_id, offset, client_maxlen,
-                                             data, &total_data_length, &error_code),
-                      error_code, "Unable to get piece of data block");
-  } else if (data_id.type() == DataIdPB::LOG_SEGMENT) {
-    // Fetching a log segment chunk.
-    uint64_t segment_seqno = data_id.wal_segment_seqno();
-    RPC_RETURN_NOT_OK(session->GetLogSegmentPiece(segment_seqno, offset, client_maxlen,
-                                                  data, &total_data_length, &error_code),
-                      error_code, "Unable to get piece of log segment");
-  } else if (data_id.type() == DataIdPB::ROCKSDB_FILE) {
-    auto file_name = data_id.file_name();
-    RPC_RETURN_NOT_OK(session->GetFilePiece(file_name, offset, client_maxlen, data,
-                                            &total_data_length, &error_code),
-                      error_code, "Unable to get piece of RocksDB file");
+  uint32_t crc32 = 0;
+  string error_message;
+  Status status;
+  if (req->allow_data_sidecar()) {
+    // Send data as sidecar, so it is written to the socket directly from the buffer it was read to.
+    RefCntBuffer data;
+    status = GetDataPiece(session.get(), data_id, offset, client_maxlen, &data,
+                          &total_data_length, &error_code, &error_message);
+    if (status.ok()) {
+      crc32 = Crc32c(data.data(), data.size());
+      int sidecar_idx = 0;
+      status = context.AddRpcSidecar(std::move(data), &sidecar_idx);
+      if (status.ok()) {
+        data_chunk->set_data(string());
+        data_chunk->set_data_sidecar_idx(sidecar_idx);
+      } else {
+        error_message = "Unable to add data sidecar";
+      }
+    }
   } else {
-    auto msg = Substitute("Invalid request type $0", data_id.type());
-    RPC_RETURN_APP_ERROR(RemoteBootstrapErrorPB::INVALID_REMOTE_BOOTSTRAP_REQUEST, msg,
-                         STATUS(InvalidArgument, msg));
+    string* data = data_chunk->mutable_data();
+    status = GetDataPiece(session.get(), data_id, offset, client_maxlen, data,
+                          &total_data_length, &error_code, &error_message);
+    if (status.ok()) {
+      crc32 = Crc32c(data->data(), data->length());
+    }
   }
+  RPC_RETURN_NOT_OK(status, error_code, error_message);
 
   data_chunk->set_total_data_length(total_data_length);
   data_chunk->set_offset(offset);
-
-  // Calculate checksum.
-  uint32_t crc32 = Crc32c(data->data(), data->length());
   data_chunk->set_crc32(crc32);
 
   context.RespondSuccess();
@@ -42,6 +42,7 @@
 #include "yb/gutil/type_traits.h"
 #include "yb/server/metadata.h"
 #include "yb/tablet/tablet_peer.h"
+#include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/trace.h"
 
@@ -107,6 +108,15 @@ Status RemoteBootstrapSession::ChangeRole() {
                                            tablet::TabletStatePB_Name(tablet_state), tablet_state));
   }
 
+  // A follower picked as the bootstrap source can't change the config. The leader promotes the peer
+  // once it has replicated the log tail to it, see Peer::SendNextRequest.
+  if (consensus->role() != RaftPeerPB::LEADER) {
+    LOG(INFO) << "Not the leader of tablet " << tablet_peer_->tablet_id() << ", leaving the role "
+              << "change of peer " << requestor_uuid_ << " to the leader in bootstrap session "
+              << session_id_;
+    return Status::OK();
+  }
+
   // If peer being bootstrapped is already a VOTER, don't send the ChangeConfig request. This could
   // happen when a tserver that is already a VOTER in the configuration tombstones its tablet, and
   // the leader starts bootstrapping it.
@@ -205,7 +215,10 @@ Status RemoteBootstrapSession::Init() {
   }
 
   MonoTime now = MonoTime::Now();
-  auto checkpoints_dir = JoinPathSegments(tablet_superblock_.rocksdb_dir(), "checkpoints");
+  // The checkpoint hard links a consistent set of SST files, so compactions keep running while the
+  // session is active and the files are only kept on disk while they are linked from it.
+  auto checkpoints_dir = JoinPathSegments(tablet_superblock_.rocksdb_dir(),
+                                          tablet::kCheckpointsDirName);
   RETURN_NOT_OK_PREPEND(metadata->fs_manager()->CreateDirIfMissing(checkpoints_dir),
                         Substitute("Unable to create checkpoints diretory $0", checkpoints_dir));
 
@@ -294,13 +307,27 @@ static Status GetResponseDataSize(int64_t total_size,
   return Status::OK();
 }
 
+// Resizes the buffer to the specified size and returns pointer to its data.
+static uint8_t* ResizeBuffer(size_t size, string* data) {
+  // Writing into a std::string buffer is basically guaranteed to work on C++11,
+  // however any modern compiler should be compatible with it.
+  // Violates the API contract, but avoids excessive copies.
+  data->resize(size);
+  return reinterpret_cast<uint8_t*>(const_cast<char*>(data->data()));
+}
+
+static uint8_t* ResizeBuffer(size_t size, RefCntBuffer* data) {
+  *data = RefCntBuffer(size);
+  return data->udata();
+}
+
 // Read a chunk of a file into a buffer.
 // data_name provides a string for the block/log to be used in error messages.
-template <class Info>
+template <class Info, class Buffer>
 static Status ReadFileChunkToBuf(const Info* info,
                                  uint64_t offset, int64_t client_maxlen,
                                  const string& data_name,
-                                 string* data, int64_t* file_size,
+                                 Buffer* data, int64_t* file_size,
                                  RemoteBootstrapErrorPB::Code* error_code) {
   int64_t response_data_size = 0;
   RETURN_NOT_OK_PREPEND(GetResponseDataSize(info->size, offset, client_maxlen, error_code,
@@ -310,11 +337,7 @@ static Status ReadFileChunkToBuf(const Info* info,
   Stopwatch chunk_timer(Stopwatch::THIS_THREAD);
   chunk_timer.start();
 
-  // Writing into a std::string buffer is basically guaranteed to work on C++11,
-  // however any modern compiler should be compatible with it.
-  // Violates the API contract, but avoids excessive copies.
-  data->resize(response_data_size);
-  uint8_t* buf = reinterpret_cast<uint8_t*>(const_cast<char*>(data->data()));
+  uint8_t* buf = ResizeBuffer(response_data_size, data);
   Slice slice;
   Status s = info->ReadFully(offset, response_data_size, &slice, buf);
   if (PREDICT_FALSE(!s.ok())) {
@@ -329,6 +352,12 @@ static Status ReadFileChunkToBuf(const Info* info,
   if (slice.data() != buf) {
     memcpy(buf, slice.data(), slice.size());
   }
+  // Files are fetched chunk by chunk from the start, so start reading the next chunk while this
+  // one is sent.
+  const uint64_t next_offset = offset + response_data_size;
+  if (next_offset < info->size) {
+    info->Prefetch(next_offset, std::min<int64_t>(response_data_size, info->size - next_offset));
+  }
   chunk_timer.stop();
   TRACE("Remote bootstrap: $0: $1 total bytes read. Total time elapsed: $2",
         data_name, response_data_size, chunk_timer.elapsed().ToString());
@@ -337,9 +366,10 @@ static Status ReadFileChunkToBuf(const Info* info,
   return Status::OK();
 }
 
+template <class Buffer>
 Status RemoteBootstrapSession::GetBlockPiece(const BlockId& block_id,
                                              uint64_t offset, int64_t client_maxlen,
-                                             string* data, int64_t* block_file_size,
+                                             Buffer* data, int64_t* block_file_size,
                                              RemoteBootstrapErrorPB::Code* error_code) {
   ImmutableReadableBlockInfo* block_info;
   RETURN_NOT_OK(FindBlock(block_id, &block_info, error_code));
@@ -356,9 +386,10 @@ Status RemoteBootstrapSession::GetBlockPiece(const BlockId& block_id,
   return Status::OK();
 }
 
+template <class Buffer>
 Status RemoteBootstrapSession::GetLogSegmentPiece(uint64_t segment_seqno,
                                                   uint64_t offset, int64_t client_maxlen,
-                                                  std::string* data, int64_t* block_file_size,
+                                                  Buffer* data, int64_t* block_file_size,
                                                   RemoteBootstrapErrorPB::Code* error_code) {
   ImmutableRandomAccessFileInfo* file_info;
   RETURN_NOT_OK(FindLogSegment(segment_seqno, &file_info, error_code));
@@ -372,9 +403,10 @@ Status RemoteBootstrapSession::GetLogSegmentPiece(uint64_t segment_seqno,
   return Status::OK();
 }
 
+template <class Buffer>
 Status RemoteBootstrapSession::GetFilePiece(const std::string file_name,
                                             uint64_t offset, int64_t client_maxlen,
-                                            std::string* data, int64_t* block_file_size,
+                                            Buffer* data, int64_t* block_file_size,
                                             RemoteBootstrapErrorPB::Code* error_code) {
 
   auto file_path = JoinPathSegments(checkpoint_dir_, file_name);
@@ -404,6 +436,20 @@ Status RemoteBootstrapSession::GetFilePiece(const std::string file_name,
   return Status::OK();
 }
 
+#define INSTANTIATE_GET_PIECE_METHODS(Buffer) \
+  template Status RemoteBootstrapSession::GetBlockPiece( \
+      const BlockId& block_id, uint64_t offset, int64_t client_maxlen, Buffer* data, \
+      int64_t* block_file_size, RemoteBootstrapErrorPB::Code* error_code); \
+  template Status RemoteBootstrapSession::GetLogSegmentPiece( \
+      uint64_t segment_seqno, uint64_t offset, int64_t client_maxlen, Buffer* data, \
+      int64_t* block_file_size, RemoteBootstrapErrorPB::Code* error_code); \
+  template Status RemoteBootstrapSession::GetFilePiece( \
+      const std::string file_name, uint64_t offset, int64_t client_maxlen, Buffer* data, \
+      int64_t* block_file_size, RemoteBootstrapErrorPB::Code* error_code);
+
+INSTANTIATE_GET_PIECE_METHODS(std::string);
+INSTANTIATE_GET_PIECE_METHODS(RefCntBuffer);
+
 bool RemoteBootstrapSession::IsBlockOpenForTests(const BlockId& block_id) const {
   boost::lock_guard<simple_spinlock> l(session_lock_);
   return ContainsKey(blocks_, block_id);
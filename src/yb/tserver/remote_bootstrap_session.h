@@ -76,6 +76,10 @@ struct ImmutableRandomAccessFileInfo {
   CHECKED_STATUS ReadFully(uint64_t offset, int64_t size, Slice* data, uint8_t* scratch) const {
     return env_util::ReadFully(readable.get(), offset, size, data, scratch);
   }
+
+  void Prefetch(uint64_t offset, int64_t size) const {
+    readable->Prefetch(offset, size);
+  }
 };
 
 // Caches block size and holds an exclusive reference to a ReadableBlock.
@@ -93,6 +97,8 @@ struct ImmutableReadableBlockInfo {
   CHECKED_STATUS ReadFully(uint64_t offset, int64_t size, Slice* data, uint8_t* scratch) const {
     return readable->Read(offset, size, data, scratch);
   }
+
+  void Prefetch(uint64_t offset, int64_t size) const {}
 };
 
 // A potential Learner must establish a RemoteBootstrapSession with the leader in order
@@ -117,31 +123,34 @@ class RemoteBootstrapSession : public RefCountedThreadSafe<RemoteBootstrapSessio
 
   // Open block for reading, if it's not already open, and read some of it.
   // If maxlen is 0, we use a system-selected length for the data piece.
-  // *data is set to a std::string containing the data. Ownership of this object
-  // is passed to the caller. A string is used because the RPC interface is
-  // sending data serialized as protobuf and we want to minimize copying.
+  // *data is set to a buffer containing the data. Buffer could be std::string, used when data is
+  // sent serialized as protobuf, or RefCntBuffer, used when data is sent as RPC sidecar.
+  // Ownership of this object is passed to the caller.
   // On error, Status is set to a non-OK value and error_code is filled in.
   //
   // This method is thread-safe.
+  template <class Buffer>
   CHECKED_STATUS GetBlockPiece(const BlockId& block_id,
                        uint64_t offset, int64_t client_maxlen,
-                       std::string* data, int64_t* block_file_size,
+                       Buffer* data, int64_t* block_file_size,
                        RemoteBootstrapErrorPB::Code* error_code);
 
   // Get a piece of a log segment.
   // The behavior and params are very similar to GetBlockPiece(), but this one
   // is only for sending WAL segment files.
+  template <class Buffer>
   CHECKED_STATUS GetLogSegmentPiece(uint64_t segment_seqno,
                             uint64_t offset, int64_t client_maxlen,
-                            std::string* data, int64_t* log_file_size,
+                            Buffer* data, int64_t* log_file_size,
                             RemoteBootstrapErrorPB::Code* error_code);
 
   // Get a piece of a rocksdb checkpoint file.
   // The behavior and params are very similar to GetBlockPiece(), but this one
   // is only for sending rocksdb files.
+  template <class Buffer>
   CHECKED_STATUS GetFilePiece(const std::string file_name,
                       uint64_t offset, int64_t client_maxlen,
-                      std::string* data, int64_t* log_file_size,
+                      Buffer* data, int64_t* log_file_size,
                       RemoteBootstrapErrorPB::Code* error_code);
 
   const tablet::TabletSuperBlockPB& tablet_superblock() const { return tablet_superblock_; }
@@ -34,12 +34,17 @@
 #include <vector>
 
 #include <gtest/gtest.h>
+#include "yb/common/iterator.h"
+#include "yb/common/rowblock.h"
+#include "yb/common/scan_spec.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tserver/scanner_metrics.h"
 #include "yb/util/metrics.h"
 #include "yb/util/test_util.h"
 
 DECLARE_int32(scanner_ttl_ms);
+DECLARE_bool(scanner_prefetch_enabled);
+DECLARE_int32(scanner_batch_size_rows);
 
 namespace yb {
 
@@ -96,5 +101,91 @@ TEST(ScannerTest, TestExpire) {
   ASSERT_EQ(s2->id(), active_scanners[0]->id());
 }
 
+namespace {
+
+// Returns the given number of rows with a single UINT32 column.
+class CountingIterator : public RowwiseIterator {
+ public:
+  explicit CountingIterator(uint32_t num_rows)
+      : schema_({ ColumnSchema("key", UINT32) }, 1), num_rows_(num_rows) {}
+
+  CHECKED_STATUS Init(ScanSpec* spec) override { return Status::OK(); }
+
+  bool HasNext() const override { return next_ < num_rows_; }
+
+  string ToString() const override { return "CountingIterator"; }
+
+  const Schema& schema() const override { return schema_; }
+
+  CHECKED_STATUS NextBlock(RowBlock* dst) override {
+    const size_t nrows = std::min<size_t>(dst->row_capacity(), num_rows_ - next_);
+    dst->Resize(nrows);
+    ColumnBlock column = dst->column_block(0);
+    for (size_t i = 0; i != nrows; ++i) {
+      column.SetCellValue(i, &next_);
+      ++next_;
+    }
+    return Status::OK();
+  }
+
+  void GetIteratorStats(std::vector<IteratorStats>* stats) const override {}
+
+ private:
+  Schema schema_;
+  const uint32_t num_rows_;
+  uint32_t next_ = 0;
+};
+
+size_t NumPrefetchedRows(const PrefetchedRows& rows) {
+  size_t result = 0;
+  for (const auto& block : rows.blocks) {
+    result += block->nrows();
+  }
+  return result;
+}
+
+} // namespace
+
+TEST(ScannerTest, TestPrefetch) {
+  FLAGS_scanner_prefetch_enabled = true;
+  FLAGS_scanner_batch_size_rows = 100;
+  scoped_refptr<TabletPeer> null_peer(nullptr);
+  ScannerManager mgr(nullptr);
+  SharedScanner scanner;
+  mgr.NewScanner(null_peer, "", &scanner);
+  scanner->Init(gscoped_ptr<RowwiseIterator>(new CountingIterator(250)),
+                gscoped_ptr<ScanSpec>(new ScanSpec()));
+
+  // Nothing is read until a prefetch is started.
+  ASSERT_EQ(nullptr, scanner->TakePrefetchedRows());
+
+  // Two blocks of 100 rows of 4 bytes fill 800 bytes.
+  mgr.PrefetchNextBatch(scanner, 800);
+  auto rows = scanner->TakePrefetchedRows();
+  ASSERT_NE(nullptr, rows);
+  ASSERT_OK(rows->status);
+  ASSERT_EQ(2, rows->blocks.size());
+  ASSERT_EQ(200, NumPrefetchedRows(*rows));
+
+  // The rows that are returned are not read again.
+  rows->blocks.pop_front();
+  scanner->ReturnPrefetchedRows(std::move(rows));
+  mgr.PrefetchNextBatch(scanner, 800);
+  rows = scanner->TakePrefetchedRows();
+  ASSERT_NE(nullptr, rows);
+  ASSERT_EQ(100, NumPrefetchedRows(*rows));
+  ASSERT_EQ(nullptr, scanner->TakePrefetchedRows());
+
+  mgr.PrefetchNextBatch(scanner, 800);
+  rows = scanner->TakePrefetchedRows();
+  ASSERT_NE(nullptr, rows);
+  ASSERT_EQ(50, NumPrefetchedRows(*rows));
+  ASSERT_FALSE(scanner->iter()->HasNext());
+
+  // There is nothing left to prefetch.
+  mgr.PrefetchNextBatch(scanner, 800);
+  ASSERT_EQ(nullptr, scanner->TakePrefetchedRows());
+}
+
 } // namespace tserver
 } // namespace yb
@@ -43,6 +43,7 @@
 #include "yb/tserver/scanner_metrics.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/thread.h"
+#include "yb/util/threadpool.h"
 #include "yb/util/metrics.h"
 
 DEFINE_int32(scanner_ttl_ms, 60000,
@@ -53,6 +54,18 @@ DEFINE_int32(scanner_gc_check_interval_us, 5 * 1000L *1000L, // 5 seconds
              "Number of microseconds in the interval at which we remove expired scanners");
 TAG_FLAG(scanner_ttl_ms, hidden);
 
+DEFINE_bool(scanner_prefetch_enabled, false,
+            "Read the next batch of a scan in the background while the client processes the "
+            "current one.");
+TAG_FLAG(scanner_prefetch_enabled, advanced);
+TAG_FLAG(scanner_prefetch_enabled, runtime);
+
+DEFINE_int32(scanner_prefetch_threads, 4,
+             "Number of threads reading the next batches of scans, see scanner_prefetch_enabled.");
+TAG_FLAG(scanner_prefetch_threads, advanced);
+
+DECLARE_int32(scanner_batch_size_rows);
+
 // TODO: would be better to scope this at a tablet level instead of
 // server level.
 METRIC_DEFINE_gauge_size(server, active_scanners,
@@ -78,6 +91,10 @@ ScannerManager::ScannerManager(const scoped_refptr<MetricEntity>& metric_entity)
   for (size_t i = 0; i < kNumScannerMapStripes; i++) {
     scanner_maps_.push_back(new ScannerMapStripe());
   }
+  CHECK_OK(ThreadPoolBuilder("scan-prefetch")
+               .set_min_threads(0)
+               .set_max_threads(FLAGS_scanner_prefetch_threads)
+               .Build(&prefetch_pool_));
 }
 
 ScannerManager::~ScannerManager() {
@@ -89,6 +106,7 @@ ScannerManager::~ScannerManager() {
   if (removal_thread_.get() != nullptr) {
     CHECK_OK(ThreadJoiner(removal_thread_.get()).Join());
   }
+  prefetch_pool_->Shutdown();
   STLDeleteElements(&scanner_maps_);
 }
 
@@ -133,27 +151,27 @@ void ScannerManager::NewScanner(const scoped_refptr<TabletPeer>& tablet_peer,
     scanner->reset(new Scanner(id, tablet_peer, requestor_string, metrics_.get()));
 
     ScannerMapStripe& stripe = GetStripeByScannerId(id);
-    std::lock_guard<boost::shared_mutex> l(stripe.lock_);
+    std::lock_guard<rw_spinlock> l(stripe.lock_);
     success = InsertIfNotPresent(&stripe.scanners_by_id_, id, *scanner);
   }
 }
 
 bool ScannerManager::LookupScanner(const string& scanner_id, SharedScanner* scanner) {
   ScannerMapStripe& stripe = GetStripeByScannerId(scanner_id);
-  boost::shared_lock<boost::shared_mutex> l(stripe.lock_);
+  boost::shared_lock<rw_spinlock> l(stripe.lock_);
   return FindCopy(stripe.scanners_by_id_, scanner_id, scanner);
 }
 
 bool ScannerManager::UnregisterScanner(const string& scanner_id) {
   ScannerMapStripe& stripe = GetStripeByScannerId(scanner_id);
-  std::lock_guard<boost::shared_mutex> l(stripe.lock_);
+  std::lock_guard<rw_spinlock> l(stripe.lock_);
   return stripe.scanners_by_id_.erase(scanner_id) > 0;
 }
 
 size_t ScannerManager::CountActiveScanners() const {
   size_t total = 0;
   for (const ScannerMapStripe* e : scanner_maps_) {
-    boost::shared_lock<boost::shared_mutex> l(e->lock_);
+    boost::shared_lock<rw_spinlock> l(e->lock_);
     total += e->scanners_by_id_.size();
   }
   return total;
@@ -161,7 +179,7 @@ size_t ScannerManager::CountActiveScanners() const {
 
 void ScannerManager::ListScanners(std::vector<SharedScanner>* scanners) {
   for (const ScannerMapStripe* stripe : scanner_maps_) {
-    boost::shared_lock<boost::shared_mutex> l(stripe->lock_);
+    boost::shared_lock<rw_spinlock> l(stripe->lock_);
     for (const ScannerMapEntry& se : stripe->scanners_by_id_) {
       scanners->push_back(se.second);
     }
@@ -172,7 +190,7 @@ void ScannerManager::RemoveExpiredScanners() {
   auto scanner_ttl = std::chrono::milliseconds(FLAGS_scanner_ttl_ms);
 
   for (ScannerMapStripe* stripe : scanner_maps_) {
-    std::lock_guard<boost::shared_mutex> l(stripe->lock_);
+    std::lock_guard<rw_spinlock> l(stripe->lock_);
     for (auto it = stripe->scanners_by_id_.begin(); it != stripe->scanners_by_id_.end();) {
       SharedScanner& scanner = it->second;
       auto time_live = scanner->TimeSinceLastAccess(CoarseMonoClock::Now());
@@ -194,6 +212,20 @@ void ScannerManager::RemoveExpiredScanners() {
   }
 }
 
+void ScannerManager::PrefetchNextBatch(const SharedScanner& scanner, size_t batch_size_bytes) {
+  if (!FLAGS_scanner_prefetch_enabled || !scanner->StartPrefetch()) {
+    return;
+  }
+  Status s = prefetch_pool_->SubmitFunc([scanner, batch_size_bytes] {
+    scanner->Prefetch(batch_size_bytes);
+  });
+  if (!s.ok()) {
+    // The rows are just read by the next request instead.
+    LOG(WARNING) << "Failed to prefetch the next batch of scanner " << scanner->id() << ": " << s;
+    scanner->ReturnPrefetchedRows(nullptr);
+  }
+}
+
 Scanner::Scanner(string id, const scoped_refptr<TabletPeer>& tablet_peer,
                  string requestor_string, ScannerMetrics* metrics)
     : id_(std::move(id)),
@@ -213,17 +245,15 @@ Scanner::~Scanner() {
 }
 
 void Scanner::UpdateAccessTime() {
-  auto now = CoarseMonoClock::Now();
-  std::lock_guard<simple_spinlock> l(lock_);
-  last_access_time_ = now;
+  last_access_time_.store(CoarseMonoClock::Now(), std::memory_order_release);
 }
 
 void Scanner::Init(gscoped_ptr<RowwiseIterator> iter,
                    gscoped_ptr<ScanSpec> spec) {
-  std::lock_guard<simple_spinlock> l(lock_);
   CHECK(!iter_) << "Already initialized";
   iter_.reset(iter.release());
   spec_.reset(spec.release());
+  initialized_.store(true, std::memory_order_release);
 }
 
 const ScanSpec& Scanner::spec() const {
@@ -234,6 +264,52 @@ void Scanner::GetIteratorStats(vector<IteratorStats>* stats) const {
   iter_->GetIteratorStats(stats);
 }
 
+bool Scanner::StartPrefetch() {
+  std::lock_guard<std::mutex> lock(prefetch_mutex_);
+  if (prefetch_running_ || prefetched_rows_) {
+    return false;
+  }
+  prefetch_running_ = true;
+  return true;
+}
+
+void Scanner::Prefetch(size_t batch_size_bytes) {
+  std::unique_ptr<PrefetchedRows> rows(new PrefetchedRows);
+  // Only the fixed size part of the rows is counted, the indirect data is not.
+  const size_t row_size = iter_->schema().byte_size();
+  size_t size = 0;
+  while (size < batch_size_bytes && iter_->HasNext()) {
+    std::unique_ptr<RowBlock> block(
+        new RowBlock(iter_->schema(), FLAGS_scanner_batch_size_rows, &rows->arena));
+    rows->status = iter_->NextBlock(block.get());
+    if (!rows->status.ok()) {
+      break;
+    }
+    if (block->nrows() > 0) {
+      size += block->nrows() * row_size;
+      rows->blocks.push_back(std::move(block));
+    }
+  }
+  ReturnPrefetchedRows(std::move(rows));
+}
+
+std::unique_ptr<PrefetchedRows> Scanner::TakePrefetchedRows() {
+  std::unique_lock<std::mutex> lock(prefetch_mutex_);
+  prefetch_cond_.wait(lock, [this] { return !prefetch_running_; });
+  return std::move(prefetched_rows_);
+}
+
+void Scanner::ReturnPrefetchedRows(std::unique_ptr<PrefetchedRows> rows) {
+  {
+    std::lock_guard<std::mutex> lock(prefetch_mutex_);
+    if (rows && (!rows->blocks.empty() || !rows->status.ok())) {
+      prefetched_rows_ = std::move(rows);
+    }
+    prefetch_running_ = false;
+  }
+  prefetch_cond_.notify_all();
+}
+
 
 } // namespace tserver
 } // namespace yb
@@ -32,6 +32,9 @@
 #ifndef YB_TSERVER_SCANNERS_H
 #define YB_TSERVER_SCANNERS_H
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -39,13 +42,16 @@
 #include <utility>
 #include <vector>
 
-#include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
 #include "yb/common/iterator_stats.h"
+#include "yb/common/rowblock.h"
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/gutil/macros.h"
 #include "yb/gutil/ref_counted.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/util/auto_release_pool.h"
+#include "yb/util/locks.h"
 #include "yb/util/memory/arena.h"
 #include "yb/util/metrics.h"
 #include "yb/util/monotime.h"
@@ -59,6 +65,7 @@ class ScanSpec;
 class Schema;
 class Status;
 class Thread;
+class ThreadPool;
 
 struct IteratorStats;
 
@@ -110,6 +117,11 @@ class ScannerManager {
   // Iterate through scanners and remove any which are past their TTL.
   void RemoveExpiredScanners();
 
+  // Reads about 'batch_size_bytes' of the next rows of the scanner in the background, while the
+  // client processes the current batch. The next continue scan request starts from these rows.
+  // Does nothing unless scanner_prefetch_enabled is set.
+  void PrefetchNextBatch(const SharedScanner& scanner, size_t batch_size_bytes);
+
  private:
   FRIEND_TEST(ScannerTest, TestExpire);
 
@@ -122,8 +134,8 @@ class ScannerManager {
   typedef std::pair<std::string, SharedScanner> ScannerMapEntry;
 
   struct ScannerMapStripe {
-    // Lock protecting the scanner map.
-    mutable boost::shared_mutex lock_;
+    // Lock protecting the scanner map. Lookups only take it in shared mode.
+    mutable rw_spinlock lock_;
     // Map of the currently active scanners.
     ScannerMap scanners_by_id_;
   };
@@ -150,6 +162,9 @@ class ScannerManager {
   // Thread to remove expired scanners.
   scoped_refptr<yb::Thread> removal_thread_;
 
+  // Runs the prefetches of the scanners.
+  std::unique_ptr<ThreadPool> prefetch_pool_;
+
   FunctionGaugeDetacher metric_detacher_;
 
   DISALLOW_COPY_AND_ASSIGN(ScannerManager);
@@ -178,6 +193,17 @@ class ScopedUnregisterScanner {
   bool cancelled_;
 };
 
+// Rows of a scanner read ahead of the continue scan request that returns them.
+struct PrefetchedRows {
+  PrefetchedRows() : arena(32 * 1024, 1 * 1024 * 1024) {}
+
+  // Indirect data of the rows.
+  Arena arena;
+  std::deque<std::unique_ptr<RowBlock>> blocks;
+  // The error the prefetch stopped at, returned once the blocks read before it are consumed.
+  Status status;
+};
+
 // An open scanner on the server side.
 class Scanner {
  public:
@@ -195,8 +221,7 @@ class Scanner {
   // Once a Scanner is initialized, it is safe to assume that iter() and spec()
   // return non-NULL for the lifetime of the Scanner object.
   bool IsInitialized() const {
-    std::lock_guard<simple_spinlock> l(lock_);
-    return iter_ != NULL;
+    return initialized_.load(std::memory_order_acquire);
   }
 
   RowwiseIterator* iter() {
@@ -239,20 +264,17 @@ class Scanner {
 
   // Returns the current call sequence ID of the scanner.
   uint32_t call_seq_id() const {
-    std::lock_guard<simple_spinlock> l(lock_);
-    return call_seq_id_;
+    return call_seq_id_.load(std::memory_order_acquire);
   }
 
   // Increments the call sequence ID.
   void IncrementCallSeqId() {
-    std::lock_guard<simple_spinlock> l(lock_);
-    call_seq_id_ += 1;
+    call_seq_id_.fetch_add(1, std::memory_order_acq_rel);
   }
 
   // Return the delta from the last time this scan was updated to 'now'.
   CoarseMonoClock::Duration TimeSinceLastAccess(CoarseMonoClock::TimePoint now) const {
-    std::lock_guard<simple_spinlock> l(lock_);
-    return now - last_access_time_;
+    return now - last_access_time_.load(std::memory_order_acquire);
   }
 
   // Returns the time this scan was started.
@@ -286,9 +308,22 @@ class Scanner {
     already_reported_stats_ = stats;
   }
 
+  // Waits for the running prefetch, if any, and returns the rows it read, or null if there are
+  // none. iter() must not be used before this, while a prefetch could be reading from it.
+  std::unique_ptr<PrefetchedRows> TakePrefetchedRows();
+
+  // Keeps the prefetched rows that did not fit in a response for the next request.
+  void ReturnPrefetchedRows(std::unique_ptr<PrefetchedRows> rows);
+
  private:
   friend class ScannerManager;
 
+  // Marks a prefetch as running, returns false if rows are already prefetched or being prefetched.
+  bool StartPrefetch();
+
+  // Reads about 'batch_size_bytes' of rows from iter() into the prefetched rows.
+  void Prefetch(size_t batch_size_bytes);
+
   // The unique ID of this scanner.
   const std::string id_;
 
@@ -300,13 +335,13 @@ class Scanner {
   const std::string requestor_string_;
 
   // The last time that the scanner was accessed.
-  CoarseMonoClock::TimePoint last_access_time_;
+  std::atomic<CoarseMonoClock::TimePoint> last_access_time_;
 
   // The current call sequence ID.
-  uint32_t call_seq_id_;
+  std::atomic<uint32_t> call_seq_id_;
 
-  // Protects last_access_time_ call_seq_id_, iter_, and spec_.
-  mutable simple_spinlock lock_;
+  // Set once iter_ and spec_ are.
+  std::atomic<bool> initialized_{false};
 
   // The time the scanner was started.
   CoarseMonoClock::TimePoint start_time_;
@@ -335,6 +370,12 @@ class Scanner {
   // response.
   Arena arena_;
 
+  // Protects prefetch_running_ and prefetched_rows_.
+  std::mutex prefetch_mutex_;
+  std::condition_variable prefetch_cond_;
+  bool prefetch_running_ = false;
+  std::unique_ptr<PrefetchedRows> prefetched_rows_;
+
   DISALLOW_COPY_AND_ASSIGN(Scanner);
 };
 
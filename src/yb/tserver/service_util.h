@@ -118,6 +118,8 @@ bool LookupTabletPeerOrRespond(TabletPeerLookupIf* tablet_manager,
                       tablet::TabletStatePB_Name(state));
     if (state == tablet::FAILED) {
       s = s.CloneAndAppend((*peer)->error().ToString());
+    } else if (state == tablet::NOT_STARTED) {
+      tablet_manager->PrioritizeTabletOpen(tablet_id);
     }
     SetupErrorAndRespond(resp->mutable_error(), s,
                          TabletServerErrorPB::TABLET_NOT_RUNNING, context);
@@ -0,0 +1,84 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tserver/table_quotas.h"
+
+#include <gtest/gtest.h>
+
+#include "yb/util/size_literals.h"
+#include "yb/util/test_util.h"
+
+DECLARE_int64(table_quota_ops_per_sec);
+DECLARE_int64(table_quota_bytes_per_sec);
+DECLARE_int32(table_quota_burst_ms);
+
+namespace yb {
+namespace tserver {
+
+class TableQuotasTest : public YBTest {
+ protected:
+  bool Admit(const TableId& table_id, size_t bytes) {
+    return quotas_.Admit(table_id, bytes, now_, &retry_after_);
+  }
+
+  TableQuotas quotas_;
+  MonoTime now_ = MonoTime::Now();
+  MonoDelta retry_after_;
+};
+
+TEST_F(TableQuotasTest, Unlimited) {
+  for (int i = 0; i != 1000; ++i) {
+    ASSERT_TRUE(Admit("table", 1_MB));
+  }
+}
+
+TEST_F(TableQuotasTest, OpsPerSec) {
+  FLAGS_table_quota_ops_per_sec = 10;
+  FLAGS_table_quota_burst_ms = 1000;
+
+  for (int i = 0; i != 10; ++i) {
+    ASSERT_TRUE(Admit("table", 0));
+  }
+  ASSERT_FALSE(Admit("table", 0));
+  ASSERT_GT(retry_after_, MonoDelta::kZero);
+  ASSERT_LE(retry_after_, MonoDelta::FromMilliseconds(100));
+
+  // Other tables have their own quota.
+  ASSERT_TRUE(Admit("other_table", 0));
+
+  now_ += MonoDelta::FromMilliseconds(101);
+  ASSERT_TRUE(Admit("table", 0));
+  ASSERT_FALSE(Admit("table", 0));
+}
+
+TEST_F(TableQuotasTest, BytesPerSec) {
+  FLAGS_table_quota_bytes_per_sec = 1000;
+  FLAGS_table_quota_burst_ms = 1000;
+
+  // A request larger than the burst is admitted while the table has tokens, and puts it in debt.
+  ASSERT_TRUE(Admit("table", 3000));
+  ASSERT_FALSE(Admit("table", 0));
+  const double debt_retry_sec = retry_after_.ToSeconds();
+  ASSERT_GE(debt_retry_sec, 2);
+
+  // Bytes charged after the fact, e.g. read responses, delay the next request further.
+  quotas_.Consume("table", 1000, now_);
+  ASSERT_FALSE(Admit("table", 0));
+  ASSERT_GE(retry_after_.ToSeconds(), debt_retry_sec + 0.9);
+
+  now_ += MonoDelta::FromSeconds(4);
+  ASSERT_TRUE(Admit("table", 0));
+}
+
+} // namespace tserver
+} // namespace yb
@@ -0,0 +1,120 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tserver/table_quotas.h"
+
+#include <algorithm>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_int64(table_quota_ops_per_sec, 0,
+             "Maximum number of read and write requests per second that a tablet server serves "
+             "for each table. 0 means unlimited.");
+TAG_FLAG(table_quota_ops_per_sec, advanced);
+TAG_FLAG(table_quota_ops_per_sec, runtime);
+
+DEFINE_int64(table_quota_bytes_per_sec, 0,
+             "Maximum number of bytes per second of write requests and read responses that a "
+             "tablet server serves for each table. 0 means unlimited.");
+TAG_FLAG(table_quota_bytes_per_sec, advanced);
+TAG_FLAG(table_quota_bytes_per_sec, runtime);
+
+DEFINE_int32(table_quota_burst_ms, 1000,
+             "How many milliseconds worth of the table quotas a table that was idle can use at "
+             "once.");
+TAG_FLAG(table_quota_burst_ms, advanced);
+TAG_FLAG(table_quota_burst_ms, runtime);
+
+namespace yb {
+namespace tserver {
+
+namespace {
+
+double Burst(double rate) {
+  return rate * std::max(FLAGS_table_quota_burst_ms, 1) / 1000.0;
+}
+
+} // namespace
+
+void TableQuotas::Bucket::Refill(double rate, double burst, double elapsed_sec) {
+  tokens = std::min(burst, tokens + rate * elapsed_sec);
+}
+
+MonoDelta TableQuotas::Bucket::TimeUntil(double needed, double rate) const {
+  return MonoDelta::FromSeconds((needed - tokens) / rate);
+}
+
+TableQuotas::TableState& TableQuotas::RefilledState(const TableId& table_id, MonoTime now) {
+  const double ops_rate = FLAGS_table_quota_ops_per_sec;
+  const double bytes_rate = FLAGS_table_quota_bytes_per_sec;
+  auto it = tables_.find(table_id);
+  if (it == tables_.end()) {
+    TableState state;
+    state.last_refill = now;
+    state.ops.tokens = Burst(ops_rate);
+    state.bytes.tokens = Burst(bytes_rate);
+    return tables_.emplace(table_id, state).first->second;
+  }
+  auto& state = it->second;
+  if (now > state.last_refill) {
+    const double elapsed_sec = (now - state.last_refill).ToSeconds();
+    state.ops.Refill(ops_rate, Burst(ops_rate), elapsed_sec);
+    state.bytes.Refill(bytes_rate, Burst(bytes_rate), elapsed_sec);
+    state.last_refill = now;
+  }
+  return state;
+}
+
+bool TableQuotas::Admit(const TableId& table_id, size_t bytes, MonoTime now,
+                        MonoDelta* retry_after) {
+  const int64_t ops_rate = FLAGS_table_quota_ops_per_sec;
+  const int64_t bytes_rate = FLAGS_table_quota_bytes_per_sec;
+  if (ops_rate <= 0 && bytes_rate <= 0) {
+    return true;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& state = RefilledState(table_id, now);
+  MonoDelta wait = MonoDelta::kZero;
+  if (ops_rate > 0 && state.ops.tokens < 1) {
+    wait = state.ops.TimeUntil(1, ops_rate);
+  }
+  if (bytes_rate > 0 && state.bytes.tokens <= 0) {
+    wait = std::max(wait, state.bytes.TimeUntil(1, bytes_rate));
+  }
+  if (wait > MonoDelta::kZero) {
+    *retry_after = wait;
+    return false;
+  }
+  if (ops_rate > 0) {
+    state.ops.tokens -= 1;
+  }
+  if (bytes_rate > 0) {
+    state.bytes.tokens -= bytes;
+  }
+  return true;
+}
+
+void TableQuotas::Consume(const TableId& table_id, size_t bytes, MonoTime now) {
+  if (FLAGS_table_quota_bytes_per_sec <= 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  RefilledState(table_id, now).bytes.tokens -= bytes;
+}
+
+} // namespace tserver
+} // namespace yb
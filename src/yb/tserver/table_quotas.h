@@ -0,0 +1,69 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TSERVER_TABLE_QUOTAS_H
+#define YB_TSERVER_TABLE_QUOTAS_H
+
+#include <mutex>
+#include <unordered_map>
+
+#include "yb/common/entity_ids.h"
+#include "yb/util/monotime.h"
+
+namespace yb {
+namespace tserver {
+
+// Token bucket quotas on the operations and bytes per second that the requests to each table may
+// use on this tablet server, so that one table cannot starve the others. The limits are set by
+// FLAGS_table_quota_ops_per_sec and FLAGS_table_quota_bytes_per_sec, 0 means unlimited.
+//
+// Byte quotas are allowed to go into debt: a request is admitted as long as the table has any
+// byte tokens left, and the bytes it uses are charged afterwards, e.g. the size of a read response.
+class TableQuotas {
+ public:
+  // Returns true and charges one operation and 'bytes' bytes to the table if the request is
+  // admitted. Otherwise returns false and sets 'retry_after' to how long the client should wait
+  // before retrying.
+  bool Admit(const TableId& table_id, size_t bytes, MonoTime now, MonoDelta* retry_after);
+
+  // Charges 'bytes' more to the table.
+  void Consume(const TableId& table_id, size_t bytes, MonoTime now);
+
+ private:
+  struct Bucket {
+    double tokens = 0;
+
+    // Adds the tokens accumulated over 'elapsed_sec' at 'rate' per second, up to 'burst'.
+    void Refill(double rate, double burst, double elapsed_sec);
+
+    // Time after which the bucket will hold 'needed' tokens.
+    MonoDelta TimeUntil(double needed, double rate) const;
+  };
+
+  struct TableState {
+    MonoTime last_refill;
+    Bucket ops;
+    Bucket bytes;
+  };
+
+  // Returns the state of the table with its buckets refilled up to 'now'.
+  TableState& RefilledState(const TableId& table_id, MonoTime now);
+
+  std::mutex mutex_;
+  std::unordered_map<TableId, TableState> tables_;
+};
+
+} // namespace tserver
+} // namespace yb
+
+#endif // YB_TSERVER_TABLE_QUOTAS_H
@@ -68,6 +68,10 @@ class TabletPeerLookupIf {
 
   virtual CHECKED_STATUS StartRemoteBootstrap(
       const consensus::StartRemoteBootstrapRequestPB& req) = 0;
+
+  // Called when a request arrives for a tablet that is not running yet, so that implementations
+  // which open tablets in the background can open this one ahead of the others.
+  virtual void PrioritizeTabletOpen(const std::string& tablet_id) {}
 };
 
 } // namespace tserver
@@ -0,0 +1,293 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+// Benchmarks of the RPC paths of the tablet server: TabletService Write and Read, and raw
+// UpdateConsensus sent by an in-process fake leader. Server side knobs, such as the number of
+// reactors or the socket buffer sizes, are set with their own flags, e.g.:
+//
+//   tablet_server-bench --bench_client_threads=16 --bench_connections=4 \
+//       --bench_batch_size=10 --bench_payload_bytes=1024 --num_reactor_threads=8
+
+#include <atomic>
+#include <functional>
+#include <thread>
+
+#include "yb/consensus/opid_util.h"
+#include "yb/server/clock.h"
+#include "yb/tserver/tablet_server-test-base.h"
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/stopwatch.h"
+
+using namespace std::literals; // NOLINT
+
+DEFINE_int32(bench_seconds, 5, "Duration of each benchmark");
+DEFINE_int32(bench_client_threads, 8, "Number of client threads issuing RPCs");
+DEFINE_int32(bench_connections, 1,
+             "Number of client messengers, hence of connections to the tablet server, shared by "
+             "the client threads");
+DEFINE_int32(bench_batch_size, 1,
+             "Number of rows per Write or Read RPC, or of operations per UpdateConsensus RPC");
+DEFINE_int32(bench_payload_bytes, 64,
+             "Size of the string value of each row, or of the payload of each replicated "
+             "operation");
+DEFINE_int32(bench_num_rows, 10000, "Number of rows preloaded for the read benchmark");
+
+namespace yb {
+namespace tserver {
+
+using consensus::ConsensusRequestPB;
+using consensus::ConsensusResponsePB;
+using consensus::ConsensusServiceProxy;
+using consensus::MakeOpId;
+
+class TabletServerBench : public TabletServerTestBase {
+ public:
+  void SetUp() override {
+    TabletServerTestBase::SetUp();
+    StartTabletServer();
+
+    for (int i = 0; i < FLAGS_bench_connections; ++i) {
+      rpc::MessengerBuilder builder(Format("BenchClient$0", i));
+      std::shared_ptr<rpc::Messenger> messenger;
+      ASSERT_OK(builder.Build().MoveTo(&messenger));
+      messengers_.push_back(std::move(messenger));
+    }
+  }
+
+  void TearDown() override {
+    for (const auto& messenger : messengers_) {
+      messenger->Shutdown();
+    }
+    TabletServerTestBase::TearDown();
+  }
+
+ protected:
+  // Messenger used by the client thread with the given index.
+  const std::shared_ptr<rpc::Messenger>& ThreadMessenger(int thread_idx) {
+    return messengers_[thread_idx % messengers_.size()];
+  }
+
+  // Calls 'call' in a loop from --bench_client_threads threads for --bench_seconds and logs the
+  // throughput and latency of the calls. 'call' does one RPC for the thread with the given index,
+  // and 'ops_per_call' is the number of rows or operations it carries.
+  void RunBenchmark(const std::string& name, int ops_per_call,
+                    const std::function<void(int thread_idx, int64_t seq_no)>& call);
+
+  void AddReadRow(int32_t key, ReadRequestPB* req);
+
+  std::vector<std::shared_ptr<rpc::Messenger>> messengers_;
+};
+
+void TabletServerBench::RunBenchmark(
+    const std::string& name, int ops_per_call,
+    const std::function<void(int thread_idx, int64_t seq_no)>& call) {
+  HdrHistogram latency(60000000LU, 2);
+  std::atomic<bool> stop{false};
+  std::atomic<int64_t> total_calls{0};
+  std::vector<std::thread> threads;
+
+  Stopwatch sw(Stopwatch::ALL_THREADS);
+  sw.start();
+  for (int i = 0; i < FLAGS_bench_client_threads; ++i) {
+    threads.emplace_back([&call, &latency, &stop, &total_calls, i] {
+      int64_t seq_no = 0;
+      while (!stop.load(std::memory_order_acquire)) {
+        const auto start = MonoTime::Now();
+        call(i, seq_no++);
+        latency.Increment(MonoTime::Now().GetDeltaSince(start).ToMicroseconds());
+      }
+      total_calls.fetch_add(seq_no, std::memory_order_relaxed);
+    });
+  }
+  std::this_thread::sleep_for(FLAGS_bench_seconds * 1s);
+  stop.store(true, std::memory_order_release);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  sw.stop();
+
+  const int64_t calls = total_calls.load(std::memory_order_relaxed);
+  ASSERT_GT(calls, 0);
+  const double wall_seconds = sw.elapsed().wall_seconds();
+  LOG(INFO) << name << ": " << FLAGS_bench_client_threads << " threads, "
+            << messengers_.size() << " connections, " << ops_per_call << " ops per call, "
+            << FLAGS_bench_payload_bytes << " payload bytes";
+  LOG(INFO) << "Calls/sec:         " << calls / wall_seconds;
+  LOG(INFO) << "Ops/sec:           " << calls * ops_per_call / wall_seconds;
+  LOG(INFO) << "Latency (us):      mean " << latency.MeanValue()
+            << ", p50 " << latency.ValueAtPercentile(50)
+            << ", p99 " << latency.ValueAtPercentile(99)
+            << ", p99.9 " << latency.ValueAtPercentile(99.9)
+            << ", max " << latency.MaxValue();
+  LOG(INFO) << "User CPU per call: " << sw.elapsed().user / 1000.0 / calls << "us";
+  LOG(INFO) << "Sys CPU per call:  " << sw.elapsed().system / 1000.0 / calls << "us";
+}
+
+void TabletServerBench::AddReadRow(int32_t key, ReadRequestPB* req) {
+  auto batch = req->add_ql_batch();
+  batch->set_schema_version(0);
+  std::string hash_key;
+  YBPartition::AppendIntToKey<int32_t, uint32_t>(key, &hash_key);
+  batch->set_hash_code(YBPartition::HashColumnCompoundValue(hash_key));
+  batch->add_hashed_column_values()->mutable_value()->set_int32_value(key);
+  int id = kFirstColumnId;
+  auto rsrow = batch->mutable_rsrow_desc();
+  for (const auto& col : schema_.columns()) {
+    batch->add_selected_exprs()->set_column_id(id);
+    batch->mutable_column_refs()->add_ids(id);
+    auto coldesc = rsrow->add_rscol_descs();
+    coldesc->set_name(col.name());
+    col.type()->ToQLTypePB(coldesc->mutable_ql_type());
+    ++id;
+  }
+}
+
+TEST_F(TabletServerBench, Write) {
+  const std::string value(FLAGS_bench_payload_bytes, 'x');
+  const int batch_size = FLAGS_bench_batch_size;
+  const int num_threads = FLAGS_bench_client_threads;
+  std::vector<std::unique_ptr<TabletServerServiceProxy>> proxies;
+  for (int i = 0; i < num_threads; ++i) {
+    proxies.emplace_back(new TabletServerServiceProxy(
+        ThreadMessenger(i), mini_server_->bound_rpc_addr()));
+  }
+
+  RunBenchmark("Write", batch_size, [&](int thread_idx, int64_t seq_no) {
+    WriteRequestPB req;
+    WriteResponsePB resp;
+    req.set_tablet_id(kTabletId);
+    for (int i = 0; i < batch_size; ++i) {
+      // Threads write disjoint keys.
+      const auto key = static_cast<int32_t>((seq_no * batch_size + i) * num_threads + thread_idx);
+      AddTestRowInsert(key, key, value, &req);
+    }
+    rpc::RpcController controller;
+    controller.set_timeout(MonoDelta::FromSeconds(FLAGS_rpc_timeout));
+    CHECK_OK(proxies[thread_idx]->Write(req, &resp, &controller));
+    CHECK(!resp.has_error()) << resp.ShortDebugString();
+  });
+}
+
+TEST_F(TabletServerBench, Read) {
+  const std::string value(FLAGS_bench_payload_bytes, 'x');
+  const int num_rows = FLAGS_bench_num_rows;
+  constexpr int kLoadBatchSize = 100;
+  for (int first_key = 0; first_key < num_rows; first_key += kLoadBatchSize) {
+    WriteRequestPB req;
+    WriteResponsePB resp;
+    req.set_tablet_id(kTabletId);
+    for (int key = first_key; key < std::min(num_rows, first_key + kLoadBatchSize); ++key) {
+      AddTestRowInsert(key, key, value, &req);
+    }
+    rpc::RpcController controller;
+    controller.set_timeout(MonoDelta::FromSeconds(FLAGS_rpc_timeout));
+    ASSERT_OK(proxy_->Write(req, &resp, &controller));
+    ASSERT_FALSE(resp.has_error()) << resp.ShortDebugString();
+  }
+
+  const int batch_size = FLAGS_bench_batch_size;
+  std::vector<std::unique_ptr<TabletServerServiceProxy>> proxies;
+  for (int i = 0; i < FLAGS_bench_client_threads; ++i) {
+    proxies.emplace_back(new TabletServerServiceProxy(
+        ThreadMessenger(i), mini_server_->bound_rpc_addr()));
+  }
+
+  RunBenchmark("Read", batch_size, [&](int thread_idx, int64_t seq_no) {
+    ReadRequestPB req;
+    ReadResponsePB resp;
+    req.set_tablet_id(kTabletId);
+    for (int i = 0; i < batch_size; ++i) {
+      AddReadRow(static_cast<int32_t>((seq_no * batch_size + i + thread_idx) % num_rows), &req);
+    }
+    rpc::RpcController controller;
+    controller.set_timeout(MonoDelta::FromSeconds(FLAGS_rpc_timeout));
+    CHECK_OK(proxies[thread_idx]->Read(req, &resp, &controller));
+    CHECK(!resp.has_error()) << resp.ShortDebugString();
+    CHECK_EQ(batch_size, resp.ql_batch_size());
+  });
+}
+
+// Each client thread acts as the leader of its own tablet and replicates no-op operations to the
+// tablet server, which is a follower of all these tablets.
+TEST_F(TabletServerBench, UpdateConsensus) {
+  struct FakeLeader {
+    std::string tablet_id;
+    std::unique_ptr<ConsensusServiceProxy> proxy;
+    int64_t term;
+    int64_t last_index;
+  };
+
+  const std::string payload(FLAGS_bench_payload_bytes, 'x');
+  const int batch_size = FLAGS_bench_batch_size;
+  const std::string server_uuid = mini_server_->server()->permanent_uuid();
+  std::vector<FakeLeader> leaders(FLAGS_bench_client_threads);
+  for (int i = 0; i < FLAGS_bench_client_threads; ++i) {
+    auto& leader = leaders[i];
+    leader.tablet_id = Format("bench-tablet-$0", i);
+    ASSERT_OK(mini_server_->AddTestTablet(
+        kTableName.table_name(), leader.tablet_id, schema_, table_type_));
+    ASSERT_OK(WaitForTabletRunning(leader.tablet_id.c_str()));
+    leader.proxy.reset(new ConsensusServiceProxy(
+        ThreadMessenger(i), mini_server_->bound_rpc_addr()));
+
+    scoped_refptr<tablet::TabletPeer> peer;
+    ASSERT_OK(mini_server_->server()->tablet_manager()->GetTabletPeer(leader.tablet_id, &peer));
+    consensus::OpId last_op_id;
+    ASSERT_OK(peer->consensus()->GetLastOpId(consensus::RECEIVED_OPID, &last_op_id));
+    leader.term = last_op_id.term() + 1;
+    leader.last_index = last_op_id.index();
+
+    // The first request in a higher term makes the local leader step down.
+    ConsensusRequestPB req;
+    ConsensusResponsePB resp;
+    req.set_tablet_id(leader.tablet_id);
+    req.set_dest_uuid(server_uuid);
+    req.set_caller_uuid("bench_leader");
+    req.set_caller_term(leader.term);
+    *req.mutable_preceding_id() = last_op_id;
+    *req.mutable_committed_index() = last_op_id;
+    rpc::RpcController controller;
+    controller.set_timeout(MonoDelta::FromSeconds(FLAGS_rpc_timeout));
+    ASSERT_OK(leader.proxy->UpdateConsensus(req, &resp, &controller));
+    ASSERT_FALSE(resp.has_error()) << resp.ShortDebugString();
+    ASSERT_FALSE(resp.status().has_error()) << resp.ShortDebugString();
+  }
+
+  auto* clock = mini_server_->server()->clock();
+  RunBenchmark("UpdateConsensus", batch_size, [&](int thread_idx, int64_t seq_no) {
+    auto& leader = leaders[thread_idx];
+    ConsensusRequestPB req;
+    ConsensusResponsePB resp;
+    req.set_tablet_id(leader.tablet_id);
+    req.set_dest_uuid(server_uuid);
+    req.set_caller_uuid("bench_leader");
+    req.set_caller_term(leader.term);
+    *req.mutable_preceding_id() = MakeOpId(leader.term, leader.last_index);
+    for (int i = 0; i < batch_size; ++i) {
+      auto* msg = req.add_ops();
+      *msg->mutable_id() = MakeOpId(leader.term, ++leader.last_index);
+      msg->set_hybrid_time(clock->Now().ToUint64());
+      msg->set_op_type(consensus::NO_OP);
+      msg->mutable_noop_request()->set_payload_for_tests(payload);
+    }
+    // Commits the operations of this request, so the follower applies them as it goes.
+    *req.mutable_committed_index() = MakeOpId(leader.term, leader.last_index);
+    rpc::RpcController controller;
+    controller.set_timeout(MonoDelta::FromSeconds(FLAGS_rpc_timeout));
+    CHECK_OK(leader.proxy->UpdateConsensus(req, &resp, &controller));
+    CHECK(!resp.has_error() && !resp.status().has_error()) << resp.ShortDebugString();
+  });
+}
+
+} // namespace tserver
+} // namespace yb
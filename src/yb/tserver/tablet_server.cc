@@ -51,6 +51,7 @@
 #include "yb/tserver/ts_tablet_manager.h"
 #include "yb/tserver/tserver-path-handlers.h"
 #include "yb/tserver/remote_bootstrap_service.h"
+#include "yb/tserver/cdc_service.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/net/net_util.h"
 #include "yb/util/net/sockaddr.h"
@@ -95,6 +96,10 @@ DEFINE_int32(ts_remote_bootstrap_svc_queue_length, 50,
              "RPC queue length for the TS remote bootstrap service");
 TAG_FLAG(ts_remote_bootstrap_svc_queue_length, advanced);
 
+DEFINE_int32(ts_cdc_svc_queue_length, 50,
+             "RPC queue length for the TS change data capture service");
+TAG_FLAG(ts_cdc_svc_queue_length, advanced);
+
 DEFINE_bool(enable_direct_local_tablet_server_call,
             true,
             "Enable direct call to local tablet server");
@@ -240,12 +245,20 @@ Status TabletServer::RegisterServices() {
   std::unique_ptr<ServiceIf> consensus_service(new ConsensusServiceImpl(metric_entity(),
                                                                         tablet_manager_.get()));
   RETURN_NOT_OK(RpcAndWebServerBase::RegisterService(FLAGS_ts_consensus_svc_queue_length,
-                                                     std::move(consensus_service)));
+                                                     std::move(consensus_service),
+                                                     rpc::ThreadPoolTaskPriority::kHigh));
 
   std::unique_ptr<ServiceIf> remote_bootstrap_service(
       new RemoteBootstrapServiceImpl(fs_manager_.get(), tablet_manager_.get(), metric_entity()));
   RETURN_NOT_OK(RpcAndWebServerBase::RegisterService(FLAGS_ts_remote_bootstrap_svc_queue_length,
-                                                     std::move(remote_bootstrap_service)));
+                                                     std::move(remote_bootstrap_service),
+                                                     rpc::ThreadPoolTaskPriority::kLow));
+
+  std::unique_ptr<ServiceIf> cdc_service(
+      new CDCServiceImpl(tablet_manager_.get(), metric_entity()));
+  RETURN_NOT_OK(RpcAndWebServerBase::RegisterService(FLAGS_ts_cdc_svc_queue_length,
+                                                     std::move(cdc_service),
+                                                     rpc::ThreadPoolTaskPriority::kLow));
   return Status::OK();
 }
 
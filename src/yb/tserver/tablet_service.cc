@@ -33,23 +33,31 @@
 #include "yb/tserver/tablet_service.h"
 
 #include <algorithm>
+#include <cmath>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <vector>
 
 #include <boost/scope_exit.hpp>
 
+#include "yb/client/client.h"
+#include "yb/client/yb_op.h"
 #include "yb/common/iterator.h"
+#include "yb/common/ql_rowblock.h"
 #include "yb/common/schema.h"
 #include "yb/common/wire_protocol.h"
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/leader_lease.h"
+#include "yb/consensus/log_cache.h"
 #include "yb/docdb/doc_operation.h"
 #include "yb/gutil/bind.h"
 #include "yb/gutil/casts.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/escaping.h"
+#include "yb/rocksdb/memory_monitor.h"
+#include "yb/rocksdb/rate_limiter.h"
 #include "yb/server/hybrid_clock.h"
 #include "yb/tablet/tablet_bootstrap_if.h"
 #include "yb/tserver/remote_bootstrap_service.h"
@@ -57,8 +65,10 @@
 #include "yb/tablet/abstract_tablet.h"
 #include "yb/tablet/metadata.pb.h"
 #include "yb/tablet/tablet_metrics.h"
+#include "yb/tablet/transaction_participant.h"
 
 #include "yb/tablet/operations/alter_schema_operation.h"
+#include "yb/tablet/operations/ingest_sst_files_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/update_txn_operation.h"
 #include "yb/tablet/operations/write_operation.h"
@@ -73,6 +83,7 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/monotime.h"
+#include "yb/util/random_util.h"
 #include "yb/util/status.h"
 #include "yb/util/status_callback.h"
 #include "yb/util/trace.h"
@@ -110,11 +121,51 @@ DEFINE_int32(max_wait_for_safe_time_ms, 5000,
              "Maximum time in milliseconds to wait for the safe time to advance when trying to "
              "scan at the given hybrid_time.");
 
+DEFINE_int64(checksum_scan_rate_limit_bytes_per_sec, 0,
+             "Maximum number of bytes per second that the checksum scans of all the tablets of "
+             "this tablet server read together. 0 means no limit.");
+TAG_FLAG(checksum_scan_rate_limit_bytes_per_sec, advanced);
+
 DEFINE_bool(tserver_noop_read_write, false, "Respond NOOP to read/write.");
 TAG_FLAG(tserver_noop_read_write, unsafe);
 TAG_FLAG(tserver_noop_read_write, hidden);
 
+DEFINE_bool(ql_batch_reads_in_key_order, true,
+            "Whether the QL reads of a batch sent to a tablet should be executed in the order of "
+            "their hash codes, so that consecutive reads find the index and data blocks they need "
+            "in the block cache. Responses are still returned in the order of the requests.");
+TAG_FLAG(ql_batch_reads_in_key_order, advanced);
+
+DEFINE_int32(index_backfill_write_timeout_ms, 60000,
+             "Timeout of the writes of the index entries of a batch of rows backfilled into an "
+             "index.");
+TAG_FLAG(index_backfill_write_timeout_ms, advanced);
+
+DEFINE_bool(enable_write_throttling, true,
+            "Whether the tablet leader rejects a growing fraction of writes, asking the client to "
+            "retry later, as the memstore, the log cache or the number of level 0 files approach "
+            "their limits.");
+TAG_FLAG(enable_write_throttling, advanced);
+TAG_FLAG(enable_write_throttling, runtime);
+
+DEFINE_int32(write_throttling_start_percentage, 80,
+             "Percentage of the global memstore and log cache limits at which write throttling "
+             "starts. The fraction of rejected writes grows linearly from 0 at this usage to 1 at "
+             "the limit. For level 0 files it grows between rocksdb_level0_slowdown_writes_trigger "
+             "and rocksdb_level0_stop_writes_trigger.");
+TAG_FLAG(write_throttling_start_percentage, advanced);
+TAG_FLAG(write_throttling_start_percentage, runtime);
+
+DEFINE_int32(write_throttling_max_retry_delay_ms, 200,
+             "Retry delay hinted to the client for a write throttled at full pressure. Writes "
+             "throttled at lower pressure get a proportionally shorter delay.");
+TAG_FLAG(write_throttling_max_retry_delay_ms, advanced);
+TAG_FLAG(write_throttling_max_retry_delay_ms, runtime);
+
 DECLARE_uint64(max_clock_skew_usec);
+DECLARE_bool(rocksdb_disable_compactions);
+DECLARE_int32(rocksdb_level0_slowdown_writes_trigger);
+DECLARE_int32(rocksdb_level0_stop_writes_trigger);
 
 namespace yb {
 namespace tserver {
@@ -133,6 +184,10 @@ using consensus::GetNodeInstanceResponsePB;
 using consensus::LeaderStepDownRequestPB;
 using consensus::LeaderStepDownResponsePB;
 using consensus::LeaderLeaseStatus;
+using consensus::MultiConsensusRequestPB;
+using consensus::MultiConsensusResponsePB;
+using consensus::MultiVoteRequestPB;
+using consensus::MultiVoteResponsePB;
 using consensus::RunLeaderElectionRequestPB;
 using consensus::RunLeaderElectionResponsePB;
 using consensus::StartRemoteBootstrapRequestPB;
@@ -184,9 +239,181 @@ Status GetTabletRef(const scoped_refptr<TabletPeer>& tablet_peer,
   return Status::OK();
 }
 
+// Reads up to max_rows rows of the indexed table tablet from the requested position, at the read
+// time of the backfill, and writes their index entries. The entries are written with the read time
+// as their timestamp, so that any later write of the row maintained by the proxies wins over them.
+Status BackfillIndexRows(const TabletPeer& tablet_peer,
+                         Tablet* tablet,
+                         const BackfillIndexRequestPB& req,
+                         MonoTime deadline,
+                         BackfillIndexResponsePB* resp) {
+  const HybridTime read_ht(req.read_hybrid_time());
+  if (tablet->SafeTimestampToRead() < read_ht) {
+    return STATUS_FORMAT(TryAgain, "Safe time of tablet $0 has not reached the backfill read "
+                         "time $1 yet", tablet->tablet_id(), read_ht);
+  }
+
+  auto client = tablet_peer.client_future().get();
+  shared_ptr<client::YBTable> index_table;
+  RETURN_NOT_OK(client->OpenTableById(req.index_table_id(), &index_table));
+  const client::YBSchema& index_schema = index_table->schema();
+
+  // Select the columns of the indexed table that the index table columns have the names of.
+  const Schema& schema = tablet->SchemaRef();
+  QLReadRequestPB read_req;
+  read_req.set_client(YQL_CLIENT_CQL);
+  read_req.set_schema_version(tablet->metadata()->schema_version());
+  std::vector<ColumnSchema> columns;
+  QLRSRowDescPB* rsrow_desc = read_req.mutable_rsrow_desc();
+  for (size_t idx = 0; idx < index_schema.num_columns(); idx++) {
+    const string& name = index_schema.Column(idx).name();
+    const int column_idx = schema.find_column(name);
+    if (column_idx == Schema::kColumnNotFound) {
+      return STATUS_FORMAT(IllegalState, "Column $0 of index $1 not found in tablet $2", name,
+                           req.index_table_id(), tablet->tablet_id());
+    }
+    const ColumnSchema& column = schema.column(column_idx);
+    const int32_t column_id = schema.column_id(column_idx);
+    read_req.add_selected_exprs()->set_column_id(column_id);
+    if (column.is_static()) {
+      read_req.mutable_column_refs()->add_static_ids(column_id);
+    } else {
+      read_req.mutable_column_refs()->add_ids(column_id);
+    }
+    QLRSColDescPB* rscol_desc = rsrow_desc->add_rscol_descs();
+    rscol_desc->set_name(name);
+    column.type()->ToQLTypePB(rscol_desc->mutable_ql_type());
+    columns.push_back(column);
+  }
+  read_req.set_limit(std::max<uint32_t>(req.max_rows(), 1));
+  read_req.set_return_paging_state(true);
+  if (!req.next_row_key().empty()) {
+    QLPagingStatePB* paging_state = read_req.mutable_paging_state();
+    paging_state->set_next_partition_key(req.next_partition_key());
+    paging_state->set_next_row_key(req.next_row_key());
+  }
+
+  tablet::QLReadRequestResult result;
+  RETURN_NOT_OK(tablet->HandleQLReadRequest(
+      ReadHybridTime::SingleTime(read_ht), read_req, TransactionMetadataPB(), &result));
+  if (result.response.status() != QLResponsePB::YQL_STATUS_OK) {
+    return STATUS_FORMAT(RuntimeError, "Backfill read of tablet $0 failed: $1",
+                         tablet->tablet_id(), result.response.error_message());
+  }
+  QLRowBlock rows(Schema(columns, 0));
+  Slice data(result.rows_data);
+  if (!data.empty()) {
+    RETURN_NOT_OK(rows.Deserialize(read_req.client(), &data));
+  }
+
+  // Rows with a null index key have no index entry.
+  auto session = client->NewSession();
+  RETURN_NOT_OK(session->SetFlushMode(client::YBSession::MANUAL_FLUSH));
+  // The writes of the index entries should not outlive the backfill request itself.
+  session->SetTimeout(std::min(MonoDelta::FromMilliseconds(FLAGS_index_backfill_write_timeout_ms),
+                               deadline - MonoTime::Now()));
+  const size_t num_hash_key_columns = index_schema.num_hash_key_columns();
+  const size_t num_key_columns = index_schema.num_key_columns();
+  for (const QLRow& row : rows.rows()) {
+    bool has_entry = true;
+    for (size_t idx = 0; idx < num_key_columns; idx++) {
+      has_entry = has_entry && !row.column(idx).IsNull();
+    }
+    if (!has_entry) {
+      continue;
+    }
+    shared_ptr<client::YBqlWriteOp> insert_op(index_table->NewQLInsert());
+    QLWriteRequestPB* index_req = insert_op->mutable_request();
+    for (size_t idx = 0; idx < row.column_count(); idx++) {
+      const QLValuePB& value = row.column(idx).value();
+      if (idx < num_key_columns) {
+        QLExpressionPB* expr_pb = idx < num_hash_key_columns ? index_req->add_hashed_column_values()
+                                                             : index_req->add_range_column_values();
+        expr_pb->mutable_value()->CopyFrom(value);
+      } else {
+        QLColumnValuePB* col_pb = index_req->add_column_values();
+        col_pb->set_column_id(index_schema.ColumnId(idx));
+        col_pb->mutable_expr()->mutable_value()->CopyFrom(value);
+      }
+    }
+    index_req->set_user_timestamp_usec(read_ht.GetPhysicalValueMicros());
+    RETURN_NOT_OK(session->Apply(std::move(insert_op)));
+  }
+  RETURN_NOT_OK(session->Flush());
+
+  const QLPagingStatePB& paging_state = result.response.paging_state();
+  resp->set_done(paging_state.next_row_key().empty());
+  if (!resp->done()) {
+    resp->set_next_partition_key(paging_state.next_partition_key());
+    resp->set_next_row_key(paging_state.next_row_key());
+  }
+  resp->set_num_rows(rows.row_count());
+  return Status::OK();
+}
+
 } // namespace
 
 // Prepares modification operation, checks limits, fetches tablet_peer and tablet etc.
+namespace {
+
+// Maps 'value' within [start, limit] linearly to [0, 1].
+double ScalePressure(double value, double start, double limit) {
+  if (value <= start) {
+    return 0;
+  }
+  if (value >= limit || limit <= start) {
+    return 1;
+  }
+  return (value - start) / (limit - start);
+}
+
+double MemoryPressure(int64_t usage, int64_t limit) {
+  if (limit <= 0) {
+    return 0;
+  }
+  return ScalePressure(
+      usage, limit * FLAGS_write_throttling_start_percentage / 100.0, limit);
+}
+
+} // namespace
+
+double TabletServiceImpl::WritePressure(const tablet::Tablet& tablet) const {
+  double result = MemoryPressure(log_cache_mem_tracker_->consumption(),
+                                 log_cache_mem_tracker_->limit());
+
+  auto* memory_monitor = server_->tablet_manager()->memory_monitor();
+  if (memory_monitor) {
+    result = std::max(result, MemoryPressure(memory_monitor->memory_usage(),
+                                             memory_monitor->limit()));
+  }
+
+  // Without compactions RocksDB never stalls on level 0 files, so their number is not a signal.
+  if (!FLAGS_rocksdb_disable_compactions && FLAGS_rocksdb_level0_stop_writes_trigger > 0) {
+    result = std::max(result, ScalePressure(tablet.NumLevel0Files(),
+                                            FLAGS_rocksdb_level0_slowdown_writes_trigger,
+                                            FLAGS_rocksdb_level0_stop_writes_trigger));
+  }
+  return result;
+}
+
+template<class Resp>
+bool TabletServiceImpl::AdmitOrRespond(tablet::Tablet* tablet, size_t bytes, Resp* resp,
+                                       rpc::RpcContext* context) {
+  MonoDelta retry_after;
+  if (table_quotas_.Admit(tablet->metadata()->table_id(), bytes, MonoTime::Now(), &retry_after)) {
+    return true;
+  }
+  tablet->metrics()->table_quota_rejections->Increment();
+  resp->mutable_error()->set_retry_after_ms(
+      static_cast<uint32_t>(std::ceil(retry_after.ToSeconds() * 1000)));
+  SetupErrorAndRespond(
+      resp->mutable_error(),
+      STATUS_FORMAT(ServiceUnavailable, "Quota of table $0 exceeded, retry after $1",
+                    tablet->metadata()->table_id(), retry_after),
+      TabletServerErrorPB::QUOTA_EXCEEDED, context);
+  return false;
+}
+
 template<class Req, class Resp>
 bool TabletServiceImpl::PrepareModify(
     const Req& req,
@@ -228,6 +455,24 @@ bool TabletServiceImpl::PrepareModify(
     return false;
   }
 
+  // Below the hard limits, reject a fraction of writes that grows with the pressure so that
+  // clients back off gradually instead of all hitting the limits at once.
+  if (FLAGS_enable_write_throttling) {
+    const double pressure = WritePressure(**tablet);
+    if (RandomActWithProbability(pressure)) {
+      (*tablet)->metrics()->write_pressure_throttled_requests->Increment();
+      const auto retry_after_ms = static_cast<uint32_t>(
+          std::ceil(pressure * std::max(FLAGS_write_throttling_max_retry_delay_ms, 0)));
+      string msg = StringPrintf("Write throttled (pressure %.2f)", pressure);
+      YB_LOG_EVERY_N_SECS(INFO, 1) << "Rejecting Write request: " << msg << THROTTLE_MSG;
+      resp->mutable_error()->set_retry_after_ms(retry_after_ms);
+      SetupErrorAndRespond(resp->mutable_error(), STATUS(ServiceUnavailable, msg),
+                           TabletServerErrorPB::WRITE_THROTTLED,
+                           context);
+      return false;
+    }
+  }
+
   return true;
 }
 
@@ -287,6 +532,7 @@ class WriteOperationCompletionCallback : public OperationCompletionCallback {
       if (include_trace_ && Trace::CurrentTrace() != nullptr) {
         response_->set_trace_buffer(Trace::CurrentTrace()->DumpToString(true));
       }
+      NotifyParallelCommit();
       response_->set_propagated_hybrid_time(clock_->Now().ToUint64());
       context_->RespondSuccess();
     }
@@ -298,6 +544,20 @@ class WriteOperationCompletionCallback : public OperationCompletionCallback {
     return response_->mutable_error();
   }
 
+  // Status tablet waits for the last intents of a transaction committed in parallel with them.
+  void NotifyParallelCommit() {
+    const auto& write_batch = state_->request()->write_batch();
+    if (!write_batch.parallel_commit()) {
+      return;
+    }
+    auto id = FullyDecodeTransactionId(write_batch.transaction().transaction_id());
+    if (!id.ok()) {
+      LOG(DFATAL) << "Bad transaction id in parallel commit write: " << id.status();
+      return;
+    }
+    state_->tablet()->transaction_participant()->LastIntentsWritten(*id);
+  }
+
   const std::shared_ptr<rpc::RpcContext> context_;
   WriteResponsePB* const response_;
   tablet::WriteOperationState* const state_;
@@ -405,7 +665,8 @@ class ScanResultChecksummer : public ScanResultCollector {
   ScanResultChecksummer()
       : crc_(crc::GetCrc32cInstance()),
         agg_checksum_(0),
-        blocks_processed_(0) {
+        blocks_processed_(0),
+        bytes_processed_(0) {
   }
 
   virtual void HandleRowBlock(const Schema* client_projection_schema,
@@ -420,6 +681,7 @@ class ScanResultChecksummer : public ScanResultCollector {
       if (!row_block.selection_vector()->IsRowSelected(i)) continue;
       uint32_t row_crc = CalcRowCrc32(*client_projection_schema, row_block.row(i));
       agg_checksum_ += row_crc;
+      bytes_processed_ += tmp_buf_.size();
     }
     // Find the last selected row and save its encoded key.
     SetLastRow(row_block, &encoded_last_row_);
@@ -440,6 +702,9 @@ class ScanResultChecksummer : public ScanResultCollector {
   void set_agg_checksum(uint64_t value) { agg_checksum_ = value; }
   uint64_t agg_checksum() const { return agg_checksum_; }
 
+  // The total size of the row data checksummed by this collector.
+  size_t bytes_processed() const { return bytes_processed_; }
+
  private:
   // Calculates a CRC32C for the given row.
   uint32_t CalcRowCrc32(const Schema& projection, const RowBlockRow& row) {
@@ -471,11 +736,35 @@ class ScanResultChecksummer : public ScanResultCollector {
   crc::Crc* const crc_;
   uint64_t agg_checksum_;
   int blocks_processed_;
+  size_t bytes_processed_;
   faststring encoded_last_row_;
 
   DISALLOW_COPY_AND_ASSIGN(ScanResultChecksummer);
 };
 
+// Limits the rate at which all the checksum scans of this process read rows.
+rocksdb::RateLimiter* ChecksumRateLimiter() {
+  static std::unique_ptr<rocksdb::RateLimiter> rate_limiter(
+      FLAGS_checksum_scan_rate_limit_bytes_per_sec > 0
+          ? rocksdb::NewGenericRateLimiter(FLAGS_checksum_scan_rate_limit_bytes_per_sec)
+          : nullptr);
+  return rate_limiter.get();
+}
+
+void ThrottleChecksumScan(size_t bytes) {
+  auto* rate_limiter = ChecksumRateLimiter();
+  if (!rate_limiter) {
+    return;
+  }
+  // The rate limiter grants at most one burst at a time.
+  int64_t remaining = bytes;
+  while (remaining > 0) {
+    const int64_t request = std::min(remaining, rate_limiter->GetSingleBurstBytes());
+    rate_limiter->Request(request, rocksdb::Env::IO_LOW);
+    remaining -= request;
+  }
+}
+
 // Return the batch size to use for a given request, after clamping
 // the user-requested request within the server-side allowable range.
 // This is only a hint, really more of a threshold since returned bytes
@@ -491,7 +780,8 @@ static size_t GetMaxBatchSizeBytesHint(const ScanRequestPB* req) {
 
 TabletServiceImpl::TabletServiceImpl(TabletServerIf* server)
     : TabletServerServiceIf(server->MetricEnt()),
-      server_(server) {
+      server_(server),
+      log_cache_mem_tracker_(consensus::LogCache::GetGlobalMemTracker()) {
 }
 
 TabletServiceAdminImpl::TabletServiceAdminImpl(TabletServer* server)
@@ -568,6 +858,41 @@ void TabletServiceAdminImpl::AlterSchema(const AlterSchemaRequestPB* req,
       std::move(operation_state), consensus::LEADER));
 }
 
+void TabletServiceAdminImpl::BackfillIndex(const BackfillIndexRequestPB* req,
+                                           BackfillIndexResponsePB* resp,
+                                           rpc::RpcContext context) {
+  if (!CheckUuidMatchOrRespond(server_->tablet_manager(), "BackfillIndex", req, resp, &context)) {
+    return;
+  }
+  TRACE_EVENT1("tserver", "BackfillIndex", "tablet_id", req->tablet_id());
+  DVLOG(3) << "Received Backfill Index RPC: " << req->DebugString();
+
+  server::UpdateClock(*req, server_->Clock());
+
+  scoped_refptr<TabletPeer> tablet_peer;
+  if (!LookupTabletPeerOrRespond(server_->tablet_manager(), req->tablet_id(), resp, &context,
+                                 &tablet_peer)) {
+    return;
+  }
+
+  // Only the leader is sure to have all the rows up to the read time.
+  TabletServerErrorPB::Code error_code = TabletServerErrorPB::UNKNOWN_ERROR;
+  Status s = TabletServiceImpl::CheckPeerIsLeaderAndReady(*tablet_peer, &error_code);
+  shared_ptr<Tablet> tablet;
+  if (s.ok()) {
+    s = GetTabletRef(tablet_peer, &tablet, &error_code);
+  }
+  if (s.ok()) {
+    s = BackfillIndexRows(*tablet_peer, tablet.get(), *req, context.GetClientDeadline(), resp);
+  }
+  if (!s.ok()) {
+    SetupErrorAndRespond(resp->mutable_error(), s, error_code, &context);
+    return;
+  }
+  resp->set_propagated_hybrid_time(server_->Clock()->Now().ToUint64());
+  context.RespondSuccess();
+}
+
 void TabletServiceImpl::UpdateTransaction(const UpdateTransactionRequestPB* req,
                                           UpdateTransactionResponsePB* resp,
                                           rpc::RpcContext context) {
@@ -588,6 +913,18 @@ void TabletServiceImpl::UpdateTransaction(const UpdateTransactionRequestPB* req,
     return;
   }
 
+  if (!req->heartbeat_transaction_ids().empty()) {
+    status = tablet_peer->tablet()->transaction_coordinator()->ProcessHeartbeats(*req, resp);
+    resp->set_propagated_hybrid_time(server_->Clock()->Now().ToUint64());
+    if (status.ok()) {
+      context.RespondSuccess();
+    } else {
+      SetupErrorAndRespond(
+          resp->mutable_error(), status, TabletServerErrorPB::UNKNOWN_ERROR, &context);
+    }
+    return;
+  }
+
   auto state = std::make_unique<tablet::UpdateTxnOperationState>(tablet_peer->tablet(),
                                                                  &req->state());
   state->set_completion_callback(MakeRpcOperationCompletionCallback(
@@ -612,8 +949,22 @@ void TabletServiceImpl::GetTransactionStatus(const GetTransactionStatusRequestPB
     return;
   }
 
-  auto status = tablet_peer->tablet()->transaction_coordinator()->GetStatus(
-      req->transaction_id(), resp);
+  auto* coordinator = tablet_peer->tablet()->transaction_coordinator();
+  Status status;
+  if (req->transaction_ids().empty()) {
+    status = coordinator->GetStatus(req->transaction_id(), resp);
+  } else {
+    for (const auto& transaction_id : req->transaction_ids()) {
+      GetTransactionStatusResponsePB transaction_resp;
+      status = coordinator->GetStatus(transaction_id, &transaction_resp);
+      if (!status.ok()) {
+        break;
+      }
+      resp->add_statuses(transaction_resp.status());
+      resp->add_status_hybrid_times(transaction_resp.has_status_hybrid_time()
+          ? transaction_resp.status_hybrid_time() : HybridTime::kMax.ToUint64());
+    }
+  }
   resp->set_propagated_hybrid_time(server_->Clock()->Now().ToUint64());
   if (status.ok()) {
     context.RespondSuccess();
@@ -685,6 +1036,51 @@ void TabletServiceImpl::Truncate(const TruncateRequestPB* req,
       std::make_unique<tablet::TruncateOperation>(std::move(tx_state), consensus::LEADER));
 }
 
+void TabletServiceImpl::IngestSSTFiles(const IngestSSTFilesRequestPB* req,
+                                       IngestSSTFilesResponsePB* resp,
+                                       rpc::RpcContext context) {
+  TRACE("IngestSSTFiles");
+
+  UpdateClock(*req, server_->Clock());
+
+  scoped_refptr<tablet::TabletPeer> tablet_peer;
+  if (!LookupTabletPeerOrRespond(server_->tablet_manager(),
+                                 req->tablet_id(),
+                                 resp, &context,
+                                 &tablet_peer)) {
+    return;
+  }
+
+  // Replicas can't reject the operation once it is replicated, so at least check that the files
+  // are in place on the leader.
+  Status s;
+  if (req->file_paths_size() == 0) {
+    s = STATUS(InvalidArgument, "No SST files to ingest");
+  }
+  for (const auto& path : req->file_paths()) {
+    if (!s.ok()) {
+      break;
+    }
+    if (!tablet_peer->tablet_metadata()->fs_manager()->env()->FileExists(path)) {
+      s = STATUS_FORMAT(NotFound, "SST file $0 not found", path);
+    }
+  }
+  if (!s.ok()) {
+    SetupErrorAndRespond(resp->mutable_error(), s, TabletServerErrorPB::UNKNOWN_ERROR, &context);
+    return;
+  }
+
+  auto tx_state = std::make_unique<tablet::IngestSSTFilesOperationState>(
+      tablet_peer->tablet(), req);
+
+  tx_state->set_completion_callback(
+      MakeRpcOperationCompletionCallback(std::move(context), resp, server_->Clock()));
+
+  // Submit the ingest op. The RPC will be responded to asynchronously.
+  tablet_peer->Submit(std::make_unique<tablet::IngestSSTFilesOperation>(
+      std::move(tx_state), consensus::LEADER));
+}
+
 void TabletServiceAdminImpl::CreateTablet(const CreateTabletRequestPB* req,
                                           CreateTabletResponsePB* resp,
                                           rpc::RpcContext context) {
@@ -784,6 +1180,7 @@ void TabletServiceImpl::Write(const WriteRequestPB* req,
     return;
   }
   TRACE("Start Write");
+  TRACE_STAGE("tserver.write_submit");
   TRACE_EVENT1("tserver", "TabletServiceImpl::Write",
                "tablet_id", req->tablet_id());
   DVLOG(3) << "Received Write RPC: " << req->DebugString();
@@ -794,6 +1191,10 @@ void TabletServiceImpl::Write(const WriteRequestPB* req,
     return;
   }
 
+  if (!AdmitOrRespond(tablet.get(), req->ByteSize(), resp, &context)) {
+    return;
+  }
+
   if (req->has_write_batch() && req->write_batch().has_transaction()) {
     VLOG(1) << "Write with transaction: " << req->write_batch().transaction().ShortDebugString();
   }
@@ -819,6 +1220,7 @@ void TabletServiceImpl::Write(const WriteRequestPB* req,
   }
 
   auto operation_state = std::make_unique<WriteOperationState>(tablet_peer->tablet(), req, resp);
+  operation_state->set_deadline(context.GetClientDeadline());
 
   auto context_ptr = std::make_shared<RpcContext>(std::move(context));
   operation_state->set_completion_callback(
@@ -901,6 +1303,10 @@ bool TabletServiceImpl::GetTabletOrRespond(const ReadRequestPB* req,
   if (req->consistency_level() == YBConsistencyLevel::STRONG) {
     s = CheckPeerIsLeader(*tablet_peer.get(), &error_code);
     if (PREDICT_FALSE(!s.ok())) {
+      auto shared_tablet = tablet_peer->shared_tablet();
+      if (shared_tablet) {
+        shared_tablet->metrics()->leader_lease_read_rejections->Increment();
+      }
       SetupErrorAndRespond(resp->mutable_error(), s, error_code, context);
       return false;
     }
@@ -912,6 +1318,41 @@ bool TabletServiceImpl::GetTabletOrRespond(const ReadRequestPB* req,
     SetupErrorAndRespond(resp->mutable_error(), s, error_code, context);
     return false;
   }
+
+  // A follower that lags too far behind for the read rejects it, the client then retries it on
+  // another replica. The leader always serves it.
+  if (req->consistency_level() == YBConsistencyLevel::CONSISTENT_PREFIX &&
+      (req->has_max_staleness_ms() || req->has_read_after_hybrid_time()) &&
+      !CheckPeerIsLeader(*tablet_peer.get(), &error_code).ok()) {
+    const HybridTime safe_time = ptr->SafeTimestampToRead();
+    if (req->has_max_staleness_ms()) {
+      const MicrosTime max_staleness_us = req->max_staleness_ms() * 1000;
+      const MicrosTime now_us = server_->Clock()->Now().GetPhysicalValueMicros();
+      if (safe_time.GetPhysicalValueMicros() + max_staleness_us < now_us) {
+        ptr->metrics()->stale_follower_read_rejections->Increment();
+        SetupErrorAndRespond(
+            resp->mutable_error(),
+            STATUS_FORMAT(ServiceUnavailable, "Safe time $0 of follower is more than $1 ms old",
+                          safe_time, req->max_staleness_ms()),
+            TabletServerErrorPB::STALE_FOLLOWER, context);
+        return false;
+      }
+    }
+    // The session of the client wrote at this time, so that older data would miss its writes.
+    if (req->has_read_after_hybrid_time()) {
+      const HybridTime read_after(req->read_after_hybrid_time());
+      if (safe_time < read_after) {
+        ptr->metrics()->stale_follower_read_rejections->Increment();
+        SetupErrorAndRespond(
+            resp->mutable_error(),
+            STATUS_FORMAT(ServiceUnavailable, "Safe time $0 of follower is before $1",
+                          safe_time, read_after),
+            TabletServerErrorPB::STALE_FOLLOWER, context);
+        return false;
+      }
+    }
+  }
+
   *tablet = ptr;
   return true;
 }
@@ -924,6 +1365,7 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
     return;
   }
   TRACE("Start Read");
+  TRACE_STAGE("tserver.read");
   TRACE_EVENT1("tserver", "TabletServiceImpl::Read",
                "tablet_id", req->tablet_id());
   DVLOG(3) << "Received Read RPC: " << req->DebugString();
@@ -933,6 +1375,12 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
     return;
   }
 
+  // Quotas apply to user tables only, not to the virtual system tablets served by the master.
+  auto* user_tablet = dynamic_cast<tablet::Tablet*>(tablet.get());
+  if (user_tablet && !AdmitOrRespond(user_tablet, req->ByteSize(), resp, &context)) {
+    return;
+  }
+
   auto safe_ht_to_read = tablet->SafeTimestampToRead();
   auto read_time = ReadHybridTime::FromReadTimePB(*req);
   bool allow_retry = !read_time;
@@ -956,11 +1404,24 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
   host_port_pb.set_host(remote_address.address().to_string());
   host_port_pb.set_port(remote_address.port());
 
+  size_t sidecars_bytes = 0;
   for (;;) {
     resp->Clear();
     context.ResetRpcSidecars();
+    sidecars_bytes = 0;
+    // A read restart could run after the client has given up, don't bother then.
+    if (PREDICT_FALSE(context.GetClientDeadline() < MonoTime::Now())) {
+      if (user_tablet) {
+        user_tablet->metrics()->expired_requests_dropped->Increment();
+      }
+      SetupErrorAndRespond(
+          resp->mutable_error(), STATUS(TimedOut, "Read passed its deadline before execution"),
+          TabletServerErrorPB::UNKNOWN_ERROR, &context);
+      return;
+    }
     auto result = DoRead(
-        tablet.get(), req, read_time, safe_ht_to_read, &host_port_pb, resp, &context);
+        tablet.get(), req, read_time, safe_ht_to_read, &host_port_pb, resp, &context,
+        &sidecars_bytes);
     if (!result.ok()) {
       SetupErrorAndRespond(
           resp->mutable_error(), result.status(), TabletServerErrorPB::UNKNOWN_ERROR, &context);
@@ -982,6 +1443,11 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
       break;
     }
   }
+  if (user_tablet) {
+    // The size of the response is only known now, charge it after the fact.
+    table_quotas_.Consume(user_tablet->metadata()->table_id(), resp->ByteSize() + sidecars_bytes,
+                          MonoTime::Now());
+  }
   if (req->include_trace() && Trace::CurrentTrace() != nullptr) {
     resp->set_trace_buffer(Trace::CurrentTrace()->DumpToString(true));
   }
@@ -997,7 +1463,8 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(tablet::AbstractTablet* tablet,
                                                  HybridTime safe_ht_to_read,
                                                  HostPortPB* host_port_pb,
                                                  ReadResponsePB* resp,
-                                                 rpc::RpcContext* context) {
+                                                 rpc::RpcContext* context,
+                                                 size_t* sidecars_bytes) {
   tablet::ScopedReadOperation read_tx(tablet, read_time);
   switch (tablet->table_type()) {
     case TableType::REDIS_TABLE_TYPE: {
@@ -1013,14 +1480,26 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(tablet::AbstractTablet* tablet,
     }
     case TableType::YQL_TABLE_TYPE: {
       ReadRequestPB* mutable_req = const_cast<ReadRequestPB*>(req);
-      for (QLReadRequestPB& ql_read_req : *mutable_req->mutable_ql_batch()) {
+      auto& ql_batch = *mutable_req->mutable_ql_batch();
+      // Hash codes are the leading part of the keys, so this order makes the reads of the batch
+      // walk the tablet forward instead of jumping between random blocks.
+      std::vector<int> read_order(ql_batch.size());
+      std::iota(read_order.begin(), read_order.end(), 0);
+      if (FLAGS_ql_batch_reads_in_key_order) {
+        std::stable_sort(read_order.begin(), read_order.end(), [&ql_batch](int lhs, int rhs) {
+          return ql_batch.Get(lhs).hash_code() < ql_batch.Get(rhs).hash_code();
+        });
+      }
+      std::vector<tablet::QLReadRequestResult> results(ql_batch.size());
+      for (int idx : read_order) {
+        QLReadRequestPB& ql_read_req = *ql_batch.Mutable(idx);
         // Update the remote endpoint.
         ql_read_req.set_allocated_remote_endpoint(host_port_pb);
         BOOST_SCOPE_EXIT(&ql_read_req) {
           ql_read_req.release_remote_endpoint();
         } BOOST_SCOPE_EXIT_END;
 
-        tablet::QLReadRequestResult result;
+        tablet::QLReadRequestResult& result = results[idx];
         TRACE("Start HandleQLReadRequest");
         RETURN_NOT_OK(tablet->HandleQLReadRequest(
             read_tx.read_time(), ql_read_req, req->transaction(), &result));
@@ -1031,9 +1510,12 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(tablet::AbstractTablet* tablet,
           read_time.local_limit = safe_ht_to_read;
           return read_time;
         }
+      }
+      for (tablet::QLReadRequestResult& result : results) {
         int rows_data_sidecar_idx = 0;
         RETURN_NOT_OK(context->AddRpcSidecar(
             RefCntBuffer(result.rows_data), &rows_data_sidecar_idx));
+        *sidecars_bytes += result.rows_data.size();
         result.response.set_rows_data_sidecar(rows_data_sidecar_idx);
         resp->add_ql_batch()->Swap(&result.response);
       }
@@ -1086,6 +1568,106 @@ void ConsensusServiceImpl::UpdateConsensus(const ConsensusRequestPB* req,
   context.RespondSuccess();
 }
 
+namespace {
+
+// MultiUpdateConsensus and MultiRequestConsensusVote report the errors of each request in its
+// response.
+template <class Response>
+void SetupConsensusError(const Status& s, TabletServerErrorPB::Code code, Response* resp) {
+  resp->Clear();
+  StatusToPB(s, resp->mutable_error()->mutable_status());
+  resp->mutable_error()->set_code(code);
+}
+
+// Returns the consensus of the running tablet that request is for, or null after setting up the
+// error in response.
+template <class Request, class Response>
+scoped_refptr<Consensus> LookupConsensusOrSetupError(TabletPeerLookupIf* tablet_manager,
+                                                     const char* method_name,
+                                                     const Request& request,
+                                                     Response* response) {
+  const string& local_uuid = tablet_manager->NodeInstance().permanent_uuid();
+  if (PREDICT_FALSE(request.dest_uuid() != local_uuid)) {
+    SetupConsensusError(
+        STATUS_SUBSTITUTE(InvalidArgument,
+                          "$0: Wrong destination UUID requested. "
+                          "Local UUID: $1. Requested UUID: $2",
+                          method_name, local_uuid, request.dest_uuid()),
+        TabletServerErrorPB::WRONG_SERVER_UUID, response);
+    return nullptr;
+  }
+
+  scoped_refptr<TabletPeer> tablet_peer;
+  Status s = tablet_manager->GetTabletPeer(request.tablet_id(), &tablet_peer);
+  if (PREDICT_FALSE(!s.ok())) {
+    SetupConsensusError(s, s.IsServiceUnavailable() ? TabletServerErrorPB::UNKNOWN_ERROR
+                                                    : TabletServerErrorPB::TABLET_NOT_FOUND,
+                        response);
+    return nullptr;
+  }
+  const tablet::TabletStatePB state = tablet_peer->state();
+  if (PREDICT_FALSE(state != tablet::RUNNING)) {
+    if (state == tablet::NOT_STARTED) {
+      // The leader is waiting for this replica, so open it before the tablets nobody asked for.
+      tablet_manager->PrioritizeTabletOpen(request.tablet_id());
+    }
+    SetupConsensusError(
+        STATUS(IllegalState, "Tablet not RUNNING", tablet::TabletStatePB_Name(state)),
+        TabletServerErrorPB::TABLET_NOT_RUNNING, response);
+    return nullptr;
+  }
+  scoped_refptr<Consensus> consensus = tablet_peer->shared_consensus();
+  if (PREDICT_FALSE(!consensus)) {
+    SetupConsensusError(
+        STATUS(ServiceUnavailable, "Consensus unavailable. Tablet not running"),
+        TabletServerErrorPB::TABLET_NOT_RUNNING, response);
+  }
+  return consensus;
+}
+
+} // namespace
+
+void ConsensusServiceImpl::MultiUpdateConsensus(const MultiConsensusRequestPB* req,
+                                                MultiConsensusResponsePB* resp,
+                                                rpc::RpcContext context) {
+  DVLOG(3) << "Received Consensus Multi Update RPC: " << req->ShortDebugString();
+  for (const auto& request : req->requests()) {
+    ConsensusResponsePB* response = resp->add_responses();
+    scoped_refptr<Consensus> consensus = LookupConsensusOrSetupError(
+        tablet_manager_, "MultiUpdateConsensus", request, response);
+    if (!consensus) {
+      continue;
+    }
+
+    // Heartbeats carry no operations to move out of the request, but Update() takes it mutable.
+    Status s = consensus->Update(const_cast<ConsensusRequestPB*>(&request), response);
+    if (PREDICT_FALSE(!s.ok())) {
+      SetupConsensusError(s, TabletServerErrorPB::UNKNOWN_ERROR, response);
+    }
+  }
+  context.RespondSuccess();
+}
+
+void ConsensusServiceImpl::MultiRequestConsensusVote(const MultiVoteRequestPB* req,
+                                                     MultiVoteResponsePB* resp,
+                                                     rpc::RpcContext context) {
+  DVLOG(3) << "Received Consensus Multi Request Vote RPC: " << req->ShortDebugString();
+  for (const auto& request : req->requests()) {
+    VoteResponsePB* response = resp->add_responses();
+    scoped_refptr<Consensus> consensus = LookupConsensusOrSetupError(
+        tablet_manager_, "MultiRequestConsensusVote", request, response);
+    if (!consensus) {
+      continue;
+    }
+
+    Status s = consensus->RequestVote(&request, response);
+    if (PREDICT_FALSE(!s.ok())) {
+      SetupConsensusError(s, TabletServerErrorPB::UNKNOWN_ERROR, response);
+    }
+  }
+  context.RespondSuccess();
+}
+
 void ConsensusServiceImpl::RequestConsensusVote(const VoteRequestPB* req,
                                                 VoteResponsePB* resp,
                                                 rpc::RpcContext context) {
@@ -1528,6 +2110,10 @@ void TabletServiceImpl::Checksum(const ChecksumRequestPB* req,
     return;
   }
 
+  // Charging the budget after the batch delays the next request of the scanner, which keeps the
+  // scans of all the tablets of this server within the budget on average.
+  ThrottleChecksumScan(collector.bytes_processed());
+
   resp->set_checksum(collector.agg_checksum());
   resp->set_has_more_results(has_more);
 
@@ -1718,6 +2304,22 @@ Result<boost::optional<TransactionId>> GetTransactionId(const ScanRequestPB &req
   return txn_id;
 }
 
+// Waits up to max_wait_for_safe_time_ms for the safe time of the tablet to reach read_ht, so that
+// no write with a lower hybrid time can be applied after a scan at read_ht starts.
+Status WaitForSafeTime(const Tablet& tablet, HybridTime read_ht) {
+  const MonoTime deadline =
+      MonoTime::Now() + MonoDelta::FromMilliseconds(FLAGS_max_wait_for_safe_time_ms);
+  HybridTime safe_time;
+  while ((safe_time = tablet.SafeTimestampToRead()) < read_ht) {
+    if (deadline.ComesBefore(MonoTime::Now())) {
+      return STATUS_FORMAT(TimedOut, "Safe time $0 of tablet $1 has not reached the scan hybrid "
+                           "time $2", safe_time, tablet.tablet_id(), read_ht);
+    }
+    SleepFor(MonoDelta::FromMilliseconds(1));
+  }
+  return Status::OK();
+}
+
 } // namespace
 
 // Start a new scan.
@@ -1808,11 +2410,23 @@ Status TabletServiceImpl::HandleNewScanRequest(TabletPeer* tablet_peer,
     TRACE("Creating iterator");
     TRACE_EVENT0("tserver", "Create iterator");
 
+    // A scan at a requested hybrid time sees the same rows on every replica of the tablet.
+    HybridTime read_ht = HybridTime::kMax;
+    if (scan_pb.has_snap_hybrid_time()) {
+      read_ht = HybridTime(scan_pb.snap_hybrid_time());
+      s = WaitForSafeTime(*tablet, read_ht);
+      if (PREDICT_FALSE(!s.ok())) {
+        *error_code = TabletServerErrorPB::UNKNOWN_ERROR;
+        return s;
+      }
+      *snap_hybrid_time = read_ht;
+    }
+
     Result<boost::optional<TransactionId>> txn_id = GetTransactionId(*req);
     if (!txn_id.ok()) {
       s = txn_id.status();
     } else {
-      s = tablet->NewRowIterator(projection, *txn_id, &iter);
+      s = tablet->NewRowIterator(projection, read_ht, Tablet::UNORDERED, *txn_id, &iter);
     }
     TRACE("Iterator created");
   }
@@ -1911,6 +2525,28 @@ Status TabletServiceImpl::HandleContinueScanRequest(const ScanRequestPB* req,
   scanner->IncrementCallSeqId();
   scanner->UpdateAccessTime();
 
+  // The rows read ahead after the previous request come first.
+  int64_t rows_scanned = 0;
+  std::unique_ptr<PrefetchedRows> prefetched_rows = scanner->TakePrefetchedRows();
+  if (prefetched_rows) {
+    auto& blocks = prefetched_rows->blocks;
+    while (!blocks.empty() && result_collector->ResponseSize() < batch_size_bytes) {
+      rows_scanned += blocks.front()->nrows();
+      result_collector->HandleRowBlock(scanner->client_projection_schema(), *blocks.front());
+      blocks.pop_front();
+    }
+    if (blocks.empty() && !prefetched_rows->status.ok()) {
+      LOG(WARNING) << "Prefetching rows from internal iterator for request "
+                   << req->ShortDebugString();
+      *error_code = TabletServerErrorPB::UNKNOWN_ERROR;
+      return prefetched_rows->status;
+    }
+  }
+  const bool has_prefetched_rows = prefetched_rows && !prefetched_rows->blocks.empty();
+  if (has_prefetched_rows) {
+    scanner->ReturnPrefetchedRows(std::move(prefetched_rows));
+  }
+
   RowwiseIterator* iter = scanner->iter();
 
   // TODO: could size the RowBlock based on the user's requested batch size?
@@ -1925,8 +2561,8 @@ Status TabletServiceImpl::HandleContinueScanRequest(const ScanRequestPB* req,
   const auto kBudget = 500ms;
   auto deadline = CoarseMonoClock::Now() + kBudget;
 
-  int64_t rows_scanned = 0;
-  while (iter->HasNext()) {
+  while (!has_prefetched_rows && result_collector->ResponseSize() < batch_size_bytes &&
+         iter->HasNext()) {
     if (PREDICT_FALSE(FLAGS_scanner_inject_latency_on_each_batch_ms > 0)) {
       SleepFor(MonoDelta::FromMilliseconds(FLAGS_scanner_inject_latency_on_each_batch_ms));
     }
@@ -1999,9 +2635,10 @@ Status TabletServiceImpl::HandleContinueScanRequest(const ScanRequestPB* req,
       delta_stats.bytes_read_from_disk);
 
   scanner->UpdateAccessTime();
-  *has_more_results = !req->close_scanner() && iter->HasNext();
+  *has_more_results = !req->close_scanner() && (has_prefetched_rows || iter->HasNext());
   if (*has_more_results) {
     unreg_scanner.Cancel();
+    server_->scanner_manager()->PrefetchNextBatch(scanner, batch_size_bytes);
   } else {
     VLOG(2) << "Scanner " << scanner->id() << " complete: removing...";
   }
@@ -39,11 +39,13 @@
 #include "yb/consensus/consensus.service.h"
 #include "yb/gutil/ref_counted.h"
 #include "yb/tablet/tablet.h"
+#include "yb/tserver/table_quotas.h"
 #include "yb/tserver/tablet_server_interface.h"
 #include "yb/tserver/tserver_admin.service.h"
 #include "yb/tserver/tserver_service.service.h"
 
 namespace yb {
+class MemTracker;
 class RowwiseIterator;
 class Schema;
 class Status;
@@ -114,8 +116,22 @@ class TabletServiceImpl : public TabletServerServiceIf {
                 TruncateResponsePB* resp,
                 rpc::RpcContext context) override;
 
+  void IngestSSTFiles(const IngestSSTFilesRequestPB* req,
+                      IngestSSTFilesResponsePB* resp,
+                      rpc::RpcContext context) override;
+
   void Shutdown() override;
 
+  // Check if the tablet peer is the leader and is in ready state for servicing IOs.
+  static CHECKED_STATUS CheckPeerIsLeaderAndReady(const tablet::TabletPeer& tablet_peer,
+                                                  TabletServerErrorPB::Code* error_code);
+
+  static CHECKED_STATUS CheckPeerIsLeader(const tablet::TabletPeer& tablet_peer,
+                                          TabletServerErrorPB::Code* error_code);
+
+  static CHECKED_STATUS CheckPeerIsReady(const tablet::TabletPeer& tablet_peer,
+                                         TabletServerErrorPB::Code* error_code);
+
  private:
   CHECKED_STATUS HandleNewScanRequest(tablet::TabletPeer* tablet_peer,
                               const ScanRequestPB* req,
@@ -131,16 +147,6 @@ class TabletServiceImpl : public TabletServerServiceIf {
                                    bool* has_more_results,
                                    TabletServerErrorPB::Code* error_code);
 
-  // Check if the tablet peer is the leader and is in ready state for servicing IOs.
-  CHECKED_STATUS CheckPeerIsLeaderAndReady(const tablet::TabletPeer& tablet_peer,
-                                           TabletServerErrorPB::Code* error_code);
-
-  CHECKED_STATUS CheckPeerIsLeader(const tablet::TabletPeer& tablet_peer,
-                                   TabletServerErrorPB::Code* error_code);
-
-  CHECKED_STATUS CheckPeerIsReady(const tablet::TabletPeer& tablet_peer,
-                                  TabletServerErrorPB::Code* error_code);
-
   virtual bool GetTabletOrRespond(const ReadRequestPB* req,
                                   ReadResponsePB* resp,
                                   rpc::RpcContext* context,
@@ -153,6 +159,15 @@ class TabletServiceImpl : public TabletServerServiceIf {
                      tablet::TabletPeerPtr* tablet_peer,
                      tablet::TabletPtr* tablet);
 
+  // Returns a value in [0, 1] that tells how close the tablet is to the memstore, log cache and
+  // level 0 file limits at which writes fail or stall.
+  double WritePressure(const tablet::Tablet& tablet) const;
+
+  // Charges a request of 'bytes' bytes to the quotas of the tablet's table. Responds with
+  // QUOTA_EXCEEDED and returns false if the request must be retried later.
+  template<class Resp>
+  bool AdmitOrRespond(tablet::Tablet* tablet, size_t bytes, Resp* resp, rpc::RpcContext* context);
+
   // Read implementation. If restart is required returns restart time, in case of success
   // returns invalid ReadHybridTime. Otherwise returns error status.
   Result<ReadHybridTime> DoRead(tablet::AbstractTablet* tablet,
@@ -161,9 +176,15 @@ class TabletServiceImpl : public TabletServerServiceIf {
                                 HybridTime safe_ht_to_read,
                                 HostPortPB* hostPortPB,
                                 ReadResponsePB* resp,
-                                rpc::RpcContext* context);
+                                rpc::RpcContext* context,
+                                size_t* sidecars_bytes);
 
   TabletServerIf *const server_;
+
+  // Tracker of the memory used by all log caches on this server.
+  const std::shared_ptr<MemTracker> log_cache_mem_tracker_;
+
+  TableQuotas table_quotas_;
 };
 
 class TabletServiceAdminImpl : public TabletServerAdminServiceIf {
@@ -181,6 +202,12 @@ class TabletServiceAdminImpl : public TabletServerAdminServiceIf {
                            AlterSchemaResponsePB* resp,
                            rpc::RpcContext context) override;
 
+  // Writes the index entries of a batch of rows of the indexed table tablet, as read at the
+  // backfill read time.
+  virtual void BackfillIndex(const BackfillIndexRequestPB* req,
+                             BackfillIndexResponsePB* resp,
+                             rpc::RpcContext context) override;
+
  private:
   TabletServer* server_;
 };
@@ -196,10 +223,18 @@ class ConsensusServiceImpl : public consensus::ConsensusServiceIf {
                                consensus::ConsensusResponsePB *resp,
                                rpc::RpcContext context) override;
 
+  virtual void MultiUpdateConsensus(const consensus::MultiConsensusRequestPB* req,
+                                    consensus::MultiConsensusResponsePB* resp,
+                                    rpc::RpcContext context) override;
+
   virtual void RequestConsensusVote(const consensus::VoteRequestPB* req,
                                     consensus::VoteResponsePB* resp,
                                     rpc::RpcContext context) override;
 
+  virtual void MultiRequestConsensusVote(const consensus::MultiVoteRequestPB* req,
+                                         consensus::MultiVoteResponsePB* resp,
+                                         rpc::RpcContext context) override;
+
   virtual void ChangeConfig(const consensus::ChangeConfigRequestPB* req,
                             consensus::ChangeConfigResponsePB* resp,
                             rpc::RpcContext context) override;
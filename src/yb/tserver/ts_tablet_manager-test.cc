@@ -47,6 +47,7 @@
 #include "yb/tablet/tablet-test-util.h"
 #include "yb/tserver/mini_tablet_server.h"
 #include "yb/tserver/tablet_server.h"
+#include "yb/util/path_util.h"
 #include "yb/util/test_util.h"
 #include "yb/util/format.h"
 
@@ -57,6 +58,7 @@
   ASSERT_NO_FATALS(AssertMonotonicReportSeqno(report_seqno, tablet_report))
 
 DECLARE_bool(pretend_memory_exceeded_enforce_flush);
+DECLARE_int32(global_memstore_flush_min_size_mb);
 
 namespace yb {
 namespace tserver {
@@ -144,9 +146,39 @@ TEST_F(TsTabletManagerTest, TestCreateTablet) {
   ASSERT_EQ(kTabletId, peer->tablet()->tablet_id());
 }
 
+// Test that single tablet tables are spread over all the data directories.
+TEST_F(TsTabletManagerTest, TestSpreadTabletsOverDataDirs) {
+  const int kNumDirs = 3;
+  mini_server_->Shutdown();
+  mini_server_.reset(new MiniTabletServer(test_data_root_, 0));
+  mini_server_->options()->fs_opts.data_paths.clear();
+  for (int i = 0; i < kNumDirs; ++i) {
+    mini_server_->options()->fs_opts.data_paths.push_back(
+        JoinPathSegments(test_data_root_, Format("data-$0", i)));
+  }
+  ASSERT_OK(mini_server_->Start());
+  ASSERT_OK(mini_server_->WaitStarted());
+  mini_server_->FailHeartbeats();
+  tablet_manager_ = mini_server_->server()->tablet_manager();
+
+  // Every tablet belongs to its own table, as CreateNewTablet uses the tablet id as table id.
+  std::unordered_map<std::string, int> tablets_per_dir;
+  for (int i = 0; i < kNumDirs * 2; ++i) {
+    scoped_refptr<TabletPeer> peer;
+    ASSERT_OK(CreateNewTablet(Format("tablet-$0", i), schema_, &peer));
+    ++tablets_per_dir[peer->tablet_metadata()->data_root_dir()];
+  }
+  ASSERT_EQ(kNumDirs, tablets_per_dir.size());
+  for (const auto& entry : tablets_per_dir) {
+    ASSERT_EQ(2, entry.second) << entry.first;
+  }
+}
+
 TEST_F(TsTabletManagerTest, TestProperBackgroundFlushOnStartup) {
   FlagSaver flag_saver;
   FLAGS_pretend_memory_exceeded_enforce_flush = true;
+  // The memstores of the test tablets are tiny, flush them anyway.
+  FLAGS_global_memstore_flush_min_size_mb = 0;
 
   const int kNumTablets = 2;
   const int kNumRestarts = 3;
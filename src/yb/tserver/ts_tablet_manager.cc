@@ -36,6 +36,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include <boost/optional/optional.hpp>
@@ -55,12 +56,18 @@
 #include "yb/fs/fs_manager.h"
 
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/sysinfo.h"
 #include "yb/gutil/strings/util.h"
+#include "yb/gutil/walltime.h"
 
 #include "yb/master/master.pb.h"
 #include "yb/master/sys_catalog.h"
 
+#include "yb/rocksdb/compaction_scheduler.h"
+#include "yb/rocksdb/env.h"
 #include "yb/rocksdb/memory_monitor.h"
+#include "yb/rocksdb/port/port.h"
+#include "yb/rocksdb/table/secondary_block_cache.h"
 
 #include "yb/rpc/messenger.h"
 
@@ -77,6 +84,7 @@
 #include "yb/tserver/tablet_server.h"
 
 #include "yb/util/background_task.h"
+#include "yb/util/cache.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/env.h"
 #include "yb/util/env_util.h"
@@ -91,12 +99,14 @@
 
 using namespace std::literals;
 
+DECLARE_int32(rocksdb_max_background_compactions);
+
 DEFINE_int32(num_tablets_to_open_simultaneously, 0,
              "Number of threads available to open tablets during startup. If this "
              "is set to 0 (the default), then the number of bootstrap threads will "
-             "be set based on the number of data directories. If the data directories "
-             "are on some very fast storage device such as SSD or a RAID array, it "
-             "may make sense to manually tune this.");
+             "be the larger of the number of data directories and half the number of CPUs. "
+             "Tablets that were likely leaders before the restart are opened first, and a "
+             "tablet that receives a request while waiting is moved to the front of the queue.");
 TAG_FLAG(num_tablets_to_open_simultaneously, advanced);
 
 DEFINE_int32(tablet_start_warn_threshold_ms, 500,
@@ -145,6 +155,29 @@ DEFINE_int64(global_memstore_size_mb_max, 2048,
              "memory. However, this flag limits it in absolute size. Value of 0 "
              "means no limit on the value obtained by the percentage. Default is 2048.");
 
+DEFINE_double(global_memstore_flush_size_weight, 1.0,
+              "Weight of the memstore size when picking the tablet to flush because the global "
+              "memstore limit is exceeded. Flushing large memstores first produces fewer small "
+              "SSTables.");
+TAG_FLAG(global_memstore_flush_size_weight, advanced);
+DEFINE_double(global_memstore_flush_age_weight, 1.0,
+              "Weight of the age of the oldest write in the memstore when picking the tablet to "
+              "flush because the global memstore limit is exceeded.");
+TAG_FLAG(global_memstore_flush_age_weight, advanced);
+DEFINE_double(global_memstore_flush_log_retention_weight, 1.0,
+              "Weight of the log size retained by the memstore when picking the tablet to flush "
+              "because the global memstore limit is exceeded. Segments beyond "
+              "FLAGS_log_min_segments_to_retain that could be GCed after the flush are counted.");
+TAG_FLAG(global_memstore_flush_log_retention_weight, advanced);
+DEFINE_int32(global_memstore_flush_min_size_mb, 8,
+             "Memstores smaller than this are not flushed because the global memstore limit is "
+             "exceeded, unless they retain log segments that could be GCed after the flush, or "
+             "the small memstores alone take the whole global memstore. They keep growing "
+             "instead, so that a burst of memory pressure does not write many tiny SSTables that "
+             "immediately trigger compactions. 0 to flush memstores of any size.");
+TAG_FLAG(global_memstore_flush_min_size_mb, advanced);
+TAG_FLAG(global_memstore_flush_min_size_mb, runtime);
+
 DEFINE_int64(db_block_cache_size_bytes, kDbCacheSizeUsePercentage,
              "Size of cross-tablet shared RocksDB block cache (in bytes). "
              "This defaults to -1 for system auto-generated default, which would use "
@@ -155,6 +188,46 @@ DEFINE_int32(db_block_cache_size_percentage, 50,
              "Default percentage of total available memory to use as block cache size, if not "
              "asking for a raw number, through FLAGS_db_block_cache_size_bytes.");
 
+DEFINE_int32(db_block_cache_num_shard_bits, -1,
+             "Number of bits of the key hash used to select a shard of the block cache. "
+             "-1 means that the number of shards is selected based on the number of cores and "
+             "the size of the block cache.");
+TAG_FLAG(db_block_cache_num_shard_bits, advanced);
+
+DEFINE_int64(db_secondary_block_cache_size_bytes, 0,
+             "Size of the secondary block cache (in bytes), which keeps compressed blocks behind "
+             "the block cache, so a working set larger than the block cache is served without "
+             "reading from disk. Blocks found there are uncompressed and promoted back into the "
+             "block cache. Value of 0 disables the secondary block cache.");
+TAG_FLAG(db_secondary_block_cache_size_bytes, advanced);
+
+DEFINE_string(db_secondary_block_cache_type, "dram",
+              "Memory used by the secondary block cache: 'dram', or 'nvm' to allocate it from "
+              "FLAGS_nvm_cache_path, that could be on persistent memory or on a local SSD.");
+TAG_FLAG(db_secondary_block_cache_type, advanced);
+
+DEFINE_int32(db_max_running_compactions, -1,
+             "Maximum number of background compactions running at once across all tablets. "
+             "Pending compactions are admitted by write stall risk, i.e. how close the number of "
+             "L0 files is to FLAGS_rocksdb_level0_stop_writes_trigger, then by read amplification. "
+             "-1 means FLAGS_rocksdb_max_background_compactions, and 0 disables the shared "
+             "scheduler, so every tablet schedules its compactions on its own.");
+TAG_FLAG(db_max_running_compactions, advanced);
+
+DEFINE_int32(db_max_open_table_files, 0,
+             "Maximum number of SST files kept open across all tablets. The tablets share an LRU "
+             "cache of open table files within this budget, instead of each one keeping up to "
+             "RocksDB max_open_files files open. 0 means half of the process open file limit, "
+             "and -1 disables the shared cache.");
+TAG_FLAG(db_max_open_table_files, advanced);
+
+DEFINE_int32(db_max_running_compactions_per_data_dir, 0,
+             "When positive, every data directory gets its own compaction scheduler that runs at "
+             "most this many compactions of the tablets placed in it, instead of one scheduler "
+             "for the whole tserver. Lets the compaction IO of a tserver with several disks scale "
+             "with the number of disks, without one busy disk taking all the slots.");
+TAG_FLAG(db_max_running_compactions_per_data_dir, advanced);
+
 DEFINE_test_flag(int32, sleep_after_tombstoning_tablet_secs, 0,
                  "Whether we sleep in LogAndTombstone after calling DeleteTabletData.");
 
@@ -188,6 +261,18 @@ METRIC_DEFINE_histogram(server, op_apply_run_time, "Operation Apply Run Time",
                         "that operations consist of very large batches.",
                         10000000, 2);
 
+METRIC_DEFINE_histogram(server, global_memstore_flush_size, "Global Memstore Flush Size",
+                        MetricUnit::kBytes,
+                        "Size of the memstores flushed because the global memstore limit was "
+                        "exceeded.",
+                        1ULL << 34, 2);
+
+METRIC_DEFINE_counter(server, global_memstore_flush_deferrals, "Global Memstore Flush Deferrals",
+                      MetricUnit::kUnits,
+                      "Number of times a memstore smaller than global_memstore_flush_min_size_mb "
+                      "was left to grow rather than flushed because the global memstore limit was "
+                      "exceeded.");
+
 using consensus::ConsensusMetadata;
 using consensus::ConsensusStatePB;
 using consensus::OpId;
@@ -220,31 +305,152 @@ void TSTabletManager::MaybeFlushTablet() {
   int iteration = 0;
   while (memory_monitor()->Exceeded() ||
          (iteration++ == 0 && FLAGS_pretend_memory_exceeded_enforce_flush)) {
-    scoped_refptr<TabletPeer> tablet_to_flush = TabletToFlush();
+    size_t num_deferred = 0;
+    scoped_refptr<TabletPeer> tablet_to_flush = TabletToFlush(&num_deferred);
+    if (!tablet_to_flush) {
+      // The memory will be released by the flushes in progress. The next allocation over the limit
+      // wakes us up again if it is not enough.
+      global_memstore_flush_deferrals_->IncrementBy(num_deferred);
+      break;
+    }
     // TODO(bojanserafimov): If tablet_to_flush flushes now because of other reasons,
     // we will schedule a second flush, which will unnecessarily stall writes for a short time. This
     // will not happen often, but should be fixed.
-    if (tablet_to_flush) {
-      WARN_NOT_OK(tablet_to_flush->tablet()->Flush(tablet::FlushMode::kAsync),
+    const auto tablet = tablet_to_flush->shared_tablet();
+    if (tablet) {
+      global_memstore_flush_size_->Increment(tablet->ActiveMemTableSize());
+      WARN_NOT_OK(tablet->Flush(tablet::FlushMode::kAsync),
           Substitute("Flush failed on $0", tablet_to_flush->tablet_id()));
     }
   }
 }
 
-// Return the tablet with the oldest write in memstore, or nullptr if all
-// tablet memstores are empty or about to flush.
-scoped_refptr<TabletPeer> TSTabletManager::TabletToFlush() {
-  boost::shared_lock<rw_spinlock> lock(lock_); // For using the tablet map
-  HybridTime oldest_write_in_memstores = HybridTime::kMax;
-  scoped_refptr<TabletPeer> tablet_to_flush;
-  for (const TabletMap::value_type& entry : tablet_map_) {
-    const auto tablet = entry.second->shared_tablet();
-    if (tablet) {
+namespace {
+
+struct MemStoreFlushCandidate {
+  scoped_refptr<TabletPeer> tablet_peer;
+  uint64_t memstore_size;
+  int64_t age_us;
+  int64_t retained_log_size;
+  bool deferred;
+};
+
+double Fraction(double value, double max_value) {
+  return max_value > 0 ? value / max_value : 0;
+}
+
+// Returns the directory with the fewest tablets of table_id. Ties are broken by the estimated
+// number of bytes in the directory, then by its number of tablets of all tables, so tables with
+// fewer tablets than directories don't all land on the same disks. Tablets without a known size,
+// e.g. just created ones, are estimated at the average size of the others.
+template <class AssignmentMap>
+string LeastLoadedDir(const AssignmentMap& assignment_map, const string& table_id,
+                      const DirLoadMap& dir_loads) {
+  std::unordered_map<string, size_t> dir_tablets;
+  for (const auto& table : assignment_map) {
+    for (const auto& dir : table.second) {
+      dir_tablets[dir.first] += dir.second.size();
+    }
+  }
+  uint64_t total_bytes = 0;
+  size_t total_sized_tablets = 0;
+  for (const auto& dir : dir_loads) {
+    total_bytes += dir.second.bytes;
+    total_sized_tablets += dir.second.num_tablets;
+  }
+  const uint64_t average_tablet_bytes =
+      total_sized_tablets > 0 ? std::max<uint64_t>(total_bytes / total_sized_tablets, 1) : 1;
+
+  string result;
+  std::tuple<size_t, uint64_t, size_t> min_load;
+  for (const auto& dir : assignment_map.at(table_id)) {
+    const size_t num_tablets = dir_tablets[dir.first];
+    DirLoad load;
+    auto it = dir_loads.find(dir.first);
+    if (it != dir_loads.end()) {
+      load = it->second;
+    }
+    const uint64_t bytes = load.bytes +
+        average_tablet_bytes * (num_tablets - std::min(num_tablets, load.num_tablets));
+    auto dir_load = std::make_tuple(dir.second.size(), bytes, num_tablets);
+    if (result.empty() || dir_load < min_load) {
+      result = dir.first;
+      min_load = dir_load;
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+// Return the tablet whose memstore is the best one to flush, or nullptr if all tablet memstores
+// are empty, about to flush or deferred. Tablets are ranked by memstore size, age of the oldest
+// write in the memstore and log size retained by the memstore, each relative to the largest value
+// among the candidates.
+//
+// Memstores below --global_memstore_flush_min_size_mb that retain no log that could be GCed are
+// deferred: flushing them would only free a little memory at the cost of a tiny SSTable. They are
+// only flushed when together they reach the global memstore limit, since the memory of the flushes
+// in progress can't bring the total under the limit then.
+scoped_refptr<TabletPeer> TSTabletManager::TabletToFlush(size_t* num_deferred) {
+  std::vector<MemStoreFlushCandidate> candidates;
+  uint64_t max_memstore_size = 0;
+  int64_t max_age_us = 0;
+  int64_t max_retained_log_size = 0;
+  uint64_t deferred_memstore_size = 0;
+  const int64_t now_us = GetCurrentTimeMicros();
+  const uint64_t min_flush_size = static_cast<uint64_t>(FLAGS_global_memstore_flush_min_size_mb)
+                                  << 20;
+  {
+    boost::shared_lock<rw_spinlock> lock(lock_); // For using the tablet map
+    for (const TabletMap::value_type& entry : tablet_map_) {
+      const auto tablet = entry.second->shared_tablet();
+      if (!tablet) {
+        continue;
+      }
       const HybridTime oldest_write_in_memstore = tablet->flush_stats()->oldest_write_in_memstore();
-      if (oldest_write_in_memstore < oldest_write_in_memstores) {
-        oldest_write_in_memstores = oldest_write_in_memstore;
-        tablet_to_flush = entry.second;
+      if (oldest_write_in_memstore == HybridTime::kMax) {
+        continue;
+      }
+      MemStoreFlushCandidate candidate = {
+          entry.second,
+          tablet->ActiveMemTableSize(),
+          std::max<int64_t>(now_us - oldest_write_in_memstore.GetPhysicalValueMicros(), 0),
+          0,
+          false };
+      if (!entry.second->GetMemStoreRetainedLogSize(&candidate.retained_log_size).ok()) {
+        candidate.retained_log_size = 0;
+      }
+      if (candidate.memstore_size < min_flush_size && candidate.retained_log_size == 0) {
+        candidate.deferred = true;
+        deferred_memstore_size += candidate.memstore_size;
       }
+      max_memstore_size = std::max(max_memstore_size, candidate.memstore_size);
+      max_age_us = std::max(max_age_us, candidate.age_us);
+      max_retained_log_size = std::max(max_retained_log_size, candidate.retained_log_size);
+      candidates.push_back(std::move(candidate));
+    }
+  }
+
+  const bool flush_deferred =
+      memory_monitor() != nullptr && deferred_memstore_size >= memory_monitor()->limit();
+  scoped_refptr<TabletPeer> tablet_to_flush;
+  double best_score = -1;
+  *num_deferred = 0;
+  for (auto& candidate : candidates) {
+    if (candidate.deferred && !flush_deferred) {
+      ++*num_deferred;
+      continue;
+    }
+    const double score =
+        FLAGS_global_memstore_flush_size_weight *
+            Fraction(candidate.memstore_size, max_memstore_size) +
+        FLAGS_global_memstore_flush_age_weight * Fraction(candidate.age_us, max_age_us) +
+        FLAGS_global_memstore_flush_log_retention_weight *
+            Fraction(candidate.retained_log_size, max_retained_log_size);
+    if (score > best_score) {
+      best_score = score;
+      tablet_to_flush = std::move(candidate.tablet_peer);
     }
   }
   return tablet_to_flush;
@@ -270,6 +476,10 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
       METRIC_op_apply_queue_time.Instantiate(server_->metric_entity()));
   apply_pool_->SetRunTimeMicrosHistogram(
       METRIC_op_apply_run_time.Instantiate(server_->metric_entity()));
+  global_memstore_flush_size_ =
+      METRIC_global_memstore_flush_size.Instantiate(server_->metric_entity());
+  global_memstore_flush_deferrals_ =
+      METRIC_global_memstore_flush_deferrals.Instantiate(server_->metric_entity());
 
   int64_t block_cache_size_bytes = FLAGS_db_block_cache_size_bytes;
   int64_t total_ram_avail = MemTracker::GetRootTracker()->limit();
@@ -285,9 +495,47 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
     block_cache_size_bytes = total_ram_avail * FLAGS_db_block_cache_size_percentage / 100;
   }
   if (FLAGS_db_block_cache_size_bytes != kDbCacheSizeCacheDisabled) {
-    tablet_options_.block_cache = rocksdb::NewLRUCache(block_cache_size_bytes);
+    const int num_shard_bits = FLAGS_db_block_cache_num_shard_bits >= 0
+        ? FLAGS_db_block_cache_num_shard_bits
+        : rocksdb::GetDefaultCacheShardBits(block_cache_size_bytes);
+    tablet_options_.block_cache = rocksdb::NewLRUCache(block_cache_size_bytes, num_shard_bits);
     tablet_options_.block_cache->SetMetrics(server_->metric_entity());
   }
+  if (FLAGS_db_secondary_block_cache_size_bytes > 0) {
+    CacheType cache_type = DRAM_CACHE;
+    if (FLAGS_db_secondary_block_cache_type == "nvm") {
+      cache_type = NVM_CACHE;
+    } else {
+      CHECK_EQ(FLAGS_db_secondary_block_cache_type, "dram")
+          << "Unsupported secondary block cache type";
+    }
+    std::unique_ptr<Cache> backing_cache(NewLRUCache(
+        cache_type, FLAGS_db_secondary_block_cache_size_bytes, "secondary_block_cache"));
+    tablet_options_.block_cache_compressed = rocksdb::NewSecondaryBlockCache(
+        std::move(backing_cache), FLAGS_db_secondary_block_cache_size_bytes);
+    tablet_options_.block_cache_compressed->SetMetrics(server_->metric_entity());
+  }
+  int max_open_table_files = FLAGS_db_max_open_table_files;
+  if (max_open_table_files == 0) {
+    const int process_limit = rocksdb::port::GetMaxOpenFiles();
+    // Leave the other half for the Raft logs, RPC connections and everything else.
+    max_open_table_files = process_limit > 0 ? process_limit / 2 : 1000000;
+  }
+  if (max_open_table_files > 0) {
+    // Entries are charged one per file, so shard by the number of files rather than by bytes, and
+    // keep enough shards for all tablets not to contend on a single mutex.
+    int num_shard_bits = 0;
+    while (num_shard_bits < 6 && (max_open_table_files >> (num_shard_bits + 1)) >= 64) {
+      ++num_shard_bits;
+    }
+    tablet_options_.table_cache = rocksdb::NewLRUCache(max_open_table_files, num_shard_bits);
+  }
+  const int max_running_compactions = FLAGS_db_max_running_compactions >= 0
+      ? FLAGS_db_max_running_compactions : FLAGS_rocksdb_max_background_compactions;
+  if (max_running_compactions > 0) {
+    tablet_options_.compaction_scheduler = std::make_shared<rocksdb::CompactionScheduler>(
+        rocksdb::Env::Default(), max_running_compactions);
+  }
 
   // Calculate memstore_size_bytes
   bool should_count_memory = FLAGS_global_memstore_size_percentage > 0;
@@ -328,8 +576,10 @@ Status TSTabletManager::Init() {
   // FsManager isn't initialized until this point.
   int max_bootstrap_threads = FLAGS_num_tablets_to_open_simultaneously;
   if (max_bootstrap_threads == 0) {
-    // Default to the number of disks.
-    max_bootstrap_threads = fs_manager_->GetDataRootDirs().size();
+    // Bootstrap is bound by log replay on the CPU as often as by the disks, so use at least one
+    // thread per disk but also enough threads to keep half of the cores busy.
+    max_bootstrap_threads = std::max<int>(fs_manager_->GetDataRootDirs().size(),
+                                          base::NumCPUs() / 2);
   }
   RETURN_NOT_OK(ThreadPoolBuilder("tablet-bootstrap")
                 .set_max_threads(max_bootstrap_threads)
@@ -365,7 +615,16 @@ Status TSTabletManager::Init() {
     metas.push_back(meta);
   }
 
-  // Now submit the "Open" task for each.
+  // Open the tablets this server was likely leading first, since their followers and clients
+  // are blocked until they come back, while the others already have a leader elsewhere.
+  std::stable_partition(
+      metas.begin(), metas.end(),
+      [this](const scoped_refptr<TabletMetadata>& meta) {
+        return IsLikelyLeader(meta->tablet_id());
+      });
+
+  // Now register each tablet and queue it for opening. A fixed number of workers drain the queue,
+  // so that PrioritizeTabletOpen() can still reorder the tablets that are waiting.
   for (const scoped_refptr<TabletMetadata>& meta : metas) {
     scoped_refptr<TransitionInProgressDeleter> deleter;
     {
@@ -374,8 +633,14 @@ Status TSTabletManager::Init() {
     }
 
     scoped_refptr<TabletPeer> tablet_peer = CreateAndRegisterTabletPeer(meta, NEW_PEER);
+    std::lock_guard<std::mutex> lock(pending_tablet_opens_mutex_);
+    pending_tablet_opens_.push_back(PendingTabletOpen{meta, deleter});
+  }
+
+  const size_t num_workers = std::min<size_t>(metas.size(), max_bootstrap_threads);
+  for (size_t i = 0; i != num_workers; ++i) {
     RETURN_NOT_OK(open_tablet_pool_->SubmitFunc(
-        std::bind(&TSTabletManager::OpenTablet, this, meta, deleter)));
+        std::bind(&TSTabletManager::OpenPendingTablets, this)));
   }
 
   {
@@ -390,6 +655,53 @@ Status TSTabletManager::Init() {
   return Status::OK();
 }
 
+bool TSTabletManager::IsLikelyLeader(const string& tablet_id) {
+  gscoped_ptr<ConsensusMetadata> cmeta;
+  Status s = ConsensusMetadata::Load(fs_manager_, tablet_id, fs_manager_->uuid(), &cmeta);
+  if (!s.ok()) {
+    // Bootstrap reports the problem, the ordering does not need to.
+    return false;
+  }
+  const RaftConfigPB& config = cmeta->committed_config();
+  if (config.peers_size() == 1 && config.peers(0).permanent_uuid() == fs_manager_->uuid()) {
+    return true;
+  }
+  // A replica votes for itself when it runs for election, and the vote is persisted together with
+  // the term, so this holds for the last winner of an election unless a newer term has been seen.
+  return cmeta->has_voted_for() && cmeta->voted_for() == fs_manager_->uuid();
+}
+
+void TSTabletManager::OpenPendingTablets() {
+  for (;;) {
+    PendingTabletOpen pending;
+    {
+      std::lock_guard<std::mutex> lock(pending_tablet_opens_mutex_);
+      if (pending_tablet_opens_.empty()) {
+        return;
+      }
+      pending = std::move(pending_tablet_opens_.front());
+      pending_tablet_opens_.pop_front();
+    }
+    OpenTablet(pending.meta, pending.deleter);
+  }
+}
+
+void TSTabletManager::PrioritizeTabletOpen(const string& tablet_id) {
+  std::lock_guard<std::mutex> lock(pending_tablet_opens_mutex_);
+  auto it = std::find_if(
+      pending_tablet_opens_.begin(), pending_tablet_opens_.end(),
+      [&tablet_id](const PendingTabletOpen& pending) {
+        return pending.meta->tablet_id() == tablet_id;
+      });
+  if (it == pending_tablet_opens_.end() || it == pending_tablet_opens_.begin()) {
+    return;
+  }
+  VLOG(1) << "Opening tablet " << tablet_id << " next, since it received a request";
+  PendingTabletOpen pending = std::move(*it);
+  pending_tablet_opens_.erase(it);
+  pending_tablet_opens_.push_front(std::move(pending));
+}
+
 Status TSTabletManager::WaitForAllBootstrapsToFinish() {
   CHECK_EQ(state(), MANAGER_RUNNING);
 
@@ -564,7 +876,7 @@ Status HandleReplacingStaleTablet(
 
 Status TSTabletManager::StartRemoteBootstrap(const StartRemoteBootstrapRequestPB& req) {
   const string& tablet_id = req.tablet_id();
-  const string& bootstrap_peer_uuid = req.bootstrap_peer_uuid();
+  string bootstrap_peer_uuid = req.bootstrap_peer_uuid();
   HostPort bootstrap_peer_addr;
   RETURN_NOT_OK(HostPortFromPB(req.bootstrap_peer_addr(), &bootstrap_peer_addr));
   int64_t leader_term = req.caller_term();
@@ -606,10 +918,24 @@ Status TSTabletManager::StartRemoteBootstrap(const StartRemoteBootstrapRequestPB
   if (replacing_tablet) {
     RETURN_NOT_OK(rb_client->SetTabletToReplace(meta, leader_term));
   }
-  RETURN_NOT_OK(rb_client->Start(bootstrap_peer_uuid,
-                                 bootstrap_peer_addr,
-                                 &meta,
-                                 this));
+  Status start_status = rb_client->Start(bootstrap_peer_uuid, bootstrap_peer_addr, &meta, this);
+  // The leader may have picked a follower close to us as the source. If the follower can't serve
+  // the session, and no new tablet metadata was created yet, bootstrap from the leader instead.
+  if (!start_status.ok() && req.has_leader_uuid() && req.leader_uuid() != bootstrap_peer_uuid &&
+      (replacing_tablet || !meta)) {
+    LOG(WARNING) << kLogPrefix << "Remote bootstrap: Unable to start session with peer "
+                 << bootstrap_peer_uuid << ": " << start_status << ". Falling back to leader "
+                 << req.leader_uuid();
+    bootstrap_peer_uuid = req.leader_uuid();
+    RETURN_NOT_OK(HostPortFromPB(req.leader_addr(), &bootstrap_peer_addr));
+    rb_client.reset(new RemoteBootstrapClient(
+        tablet_id, fs_manager_, server_->messenger(), fs_manager_->uuid()));
+    if (replacing_tablet) {
+      RETURN_NOT_OK(rb_client->SetTabletToReplace(meta, leader_term));
+    }
+    start_status = rb_client->Start(bootstrap_peer_uuid, bootstrap_peer_addr, &meta, this);
+  }
+  RETURN_NOT_OK(start_status);
 
   // From this point onward, the superblock is persisted in TABLET_DATA_COPYING
   // state, and we need to tombstone the tablet if additional steps prior to
@@ -855,7 +1181,7 @@ void TSTabletManager::OpenTablet(const scoped_refptr<TabletMetadata>& meta,
         metric_registry_,
         tablet_peer->status_listener(),
         tablet_peer->log_anchor_registry(),
-        tablet_options_,
+        TabletOptionsForDataDir(meta->data_root_dir()),
         tablet_peer.get(),
         tablet_peer.get()};
     s = BootstrapTablet(data, &tablet, &log, &bootstrap_info);
@@ -936,6 +1262,13 @@ void TSTabletManager::Shutdown() {
     }
   }
 
+  // Drop the tablets that are still waiting to be opened, they will be shut down below along with
+  // the rest.
+  {
+    std::lock_guard<std::mutex> lock(pending_tablet_opens_mutex_);
+    pending_tablet_opens_.clear();
+  }
+
   // Shut down the bootstrap pool, so new tablets are registered after this point.
   open_tablet_pool_->Shutdown();
 
@@ -1201,6 +1534,8 @@ void TSTabletManager::GetAndRegisterDataAndWalDir(FsManager* fs_manager,
   if (table_id == master::kSysCatalogTableId) {
     return;
   }
+  // Taken before dir_assignment_lock_, as it needs the tablet map lock.
+  const DirLoadMap data_dir_loads = GetDataDirLoads();
   MutexLock l(dir_assignment_lock_);
   LOG(INFO) << "Get and update data/wal directory assignment map for table: " << table_id;
   // Initialize the map if the directory mapping does not exist.
@@ -1213,25 +1548,14 @@ void TSTabletManager::GetAndRegisterDataAndWalDir(FsManager* fs_manager,
       table_data_assignment_map_[table_id][data_root_iter] = tablet_id_set;
     }
   }
-  // Find the data directory with the least count of tablets for this table.
-  table_data_assignment_iter = table_data_assignment_map_.find(table_id);
-  auto data_assignment_value_map = table_data_assignment_iter->second;
-  string min_dir;
-  uint64_t min_dir_count = kuint64max;
-  for (auto it = data_assignment_value_map.begin(); it != data_assignment_value_map.end(); ++it) {
-    if (min_dir_count > it->second.size()) {
-      min_dir = it->first;
-      min_dir_count = it->second.size();
-    }
-  }
+  // Find the least loaded data directory for this table.
+  string min_dir = LeastLoadedDir(table_data_assignment_map_, table_id, data_dir_loads);
   *data_root_dir = min_dir;
   // Increment the count for min_dir.
   auto data_assignment_value_iter = table_data_assignment_map_[table_id].find(min_dir);
   data_assignment_value_iter->second.insert(tablet_id);
 
   // Find the wal directory with the least count of tablets for this table.
-  min_dir = "";
-  min_dir_count = kuint64max;
   auto wal_root_dirs = fs_manager->GetWalRootDirs();
   CHECK(!wal_root_dirs.empty()) << "No wal root directories found";
   auto table_wal_assignment_iter = table_wal_assignment_map_.find(table_id);
@@ -1241,19 +1565,47 @@ void TSTabletManager::GetAndRegisterDataAndWalDir(FsManager* fs_manager,
       table_wal_assignment_map_[table_id][wal_root_iter] = tablet_id_set;
     }
   }
-  table_wal_assignment_iter = table_wal_assignment_map_.find(table_id);
-  auto wal_assignment_value_map = table_wal_assignment_iter->second;
-  for (auto it = wal_assignment_value_map.begin(); it != wal_assignment_value_map.end(); ++it) {
-    if (min_dir_count > it->second.size()) {
-      min_dir = it->first;
-      min_dir_count = it->second.size();
-    }
-  }
+  min_dir = LeastLoadedDir(table_wal_assignment_map_, table_id, DirLoadMap());
   *wal_root_dir = min_dir;
   auto wal_assignment_value_iter = table_wal_assignment_map_[table_id].find(min_dir);
   wal_assignment_value_iter->second.insert(tablet_id);
 }
 
+DirLoadMap TSTabletManager::GetDataDirLoads() const {
+  DirLoadMap result;
+  boost::shared_lock<rw_spinlock> lock(lock_);
+  for (const TabletMap::value_type& entry : tablet_map_) {
+    const auto tablet = entry.second->shared_tablet();
+    if (!tablet) {
+      continue;
+    }
+    auto& load = result[entry.second->tablet_metadata()->data_root_dir()];
+    load.bytes += tablet->GetTotalSSTFileSizes();
+    ++load.num_tablets;
+  }
+  return result;
+}
+
+tablet::TabletOptions TSTabletManager::TabletOptionsForDataDir(const string& data_root_dir) {
+  if (FLAGS_db_max_running_compactions_per_data_dir <= 0 || data_root_dir.empty()) {
+    return tablet_options_;
+  }
+  tablet::TabletOptions result = tablet_options_;
+  MutexLock l(dir_assignment_lock_);
+  auto& scheduler = data_dir_compaction_schedulers_[data_root_dir];
+  if (!scheduler) {
+    scheduler = std::make_shared<rocksdb::CompactionScheduler>(
+        rocksdb::Env::Default(), FLAGS_db_max_running_compactions_per_data_dir);
+    // The schedulers share the low priority pool, so it needs threads for all of them.
+    rocksdb::Env::Default()->IncBackgroundThreadsIfNeeded(
+        FLAGS_db_max_running_compactions_per_data_dir *
+            static_cast<int>(data_dir_compaction_schedulers_.size()),
+        rocksdb::Env::Priority::LOW);
+  }
+  result.compaction_scheduler = scheduler;
+  return result;
+}
+
 void TSTabletManager::RegisterDataAndWalDir(FsManager* fs_manager,
                                             const string& table_id,
                                             const string& tablet_id,
@@ -32,7 +32,9 @@
 #ifndef YB_TSERVER_TS_TABLET_MANAGER_H
 #define YB_TSERVER_TS_TABLET_MANAGER_H
 
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -93,6 +95,15 @@ using rocksdb::MemoryMonitor;
 // Map of tablet id -> transition reason string.
 typedef std::unordered_map<std::string, std::string> TransitionInProgressMap;
 
+// Bytes stored by the tablets with a known size in a data directory.
+struct DirLoad {
+  uint64_t bytes = 0;
+  size_t num_tablets = 0;
+};
+
+// Map of data root directory -> load.
+typedef std::unordered_map<std::string, DirLoad> DirLoadMap;
+
 class TransitionInProgressDeleter;
 
 // If 'expr' fails, log a message, tombstone the given tablet, and return the
@@ -201,6 +212,9 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   virtual CHECKED_STATUS
       StartRemoteBootstrap(const consensus::StartRemoteBootstrapRequestPB& req) override;
 
+  // Move the given tablet to the front of the startup open queue, if it is still waiting there.
+  void PrioritizeTabletOpen(const std::string& tablet_id) override;
+
   // Generate an incremental tablet report.
   //
   // This will report any tablets which have changed since the last acknowleged
@@ -267,6 +281,10 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
                             const std::string& data_root_dir,
                             const std::string& wal_root_dir);
 
+  // Options of the tablets placed in data_root_dir: they share the compaction scheduler of the
+  // directory when FLAGS_db_max_running_compactions_per_data_dir is set.
+  tablet::TabletOptions TabletOptionsForDataDir(const std::string& data_root_dir);
+
   bool IsTabletInTransition(const std::string& tablet_id) const;
 
   TabletServer* server() { return server_; }
@@ -327,6 +345,14 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   void OpenTablet(const scoped_refptr<tablet::TabletMetadata>& meta,
                   const scoped_refptr<TransitionInProgressDeleter>& deleter);
 
+  // Open the tablets queued in pending_tablet_opens_ one by one until the queue is empty.
+  // Init() runs one such loop per thread of open_tablet_pool_.
+  void OpenPendingTablets();
+
+  // Returns true if this replica is likely to have been the leader of the tablet before the
+  // restart, based on its persisted consensus metadata.
+  bool IsLikelyLeader(const std::string& tablet_id);
+
   // Open a tablet whose metadata has already been loaded.
   void BootstrapAndInitTablet(const scoped_refptr<tablet::TabletMetadata>& meta,
                               scoped_refptr<tablet::TabletPeer>* peer);
@@ -366,8 +392,10 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // TABLET_DATA_READY state. Generally, we tombstone the replica.
   CHECKED_STATUS HandleNonReadyTabletOnStartup(const scoped_refptr<tablet::TabletMetadata>& meta);
 
-  // Return the tablet with oldest write still in its memstore
-  scoped_refptr<tablet::TabletPeer> TabletToFlush();
+  // Return the tablet to flush when the global memstore limit is exceeded, ranked by memstore
+  // size, age of the oldest write still in its memstore and log size retained by the memstore.
+  // Small memstores are deferred, and their number is stored in num_deferred.
+  scoped_refptr<tablet::TabletPeer> TabletToFlush(size_t* num_deferred);
 
   TSTabletManagerStatePB state() const {
     boost::shared_lock<rw_spinlock> lock(lock_);
@@ -400,9 +428,15 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // Map from tablet ID to tablet
   TabletMap tablet_map_;
 
+  // Returns the size of the SST files of the running tablets per data root directory.
+  DirLoadMap GetDataDirLoads() const;
+
   // Map from table ID to count of children in data and wal directories.
   TableDiskAssignmentMap table_data_assignment_map_;
   TableDiskAssignmentMap table_wal_assignment_map_;
+  // Compaction schedulers of the data root directories, protected by dir_assignment_lock_.
+  std::unordered_map<std::string, std::shared_ptr<rocksdb::CompactionScheduler>>
+      data_dir_compaction_schedulers_;
   mutable Mutex dir_assignment_lock_;
 
   // Map of tablet ids -> reason strings where the keys are tablets whose
@@ -424,12 +458,26 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // Thread pool used to open the tablets async, whether bootstrap is required or not.
   gscoped_ptr<ThreadPool> open_tablet_pool_;
 
+  struct PendingTabletOpen {
+    scoped_refptr<tablet::TabletMetadata> meta;
+    scoped_refptr<TransitionInProgressDeleter> deleter;
+  };
+
+  // Tablets found on startup that have not been picked up by open_tablet_pool_ yet, in the order
+  // they will be opened.
+  std::mutex pending_tablet_opens_mutex_;
+  std::deque<PendingTabletOpen> pending_tablet_opens_;
+
   // Thread pool for apply transactions, shared between all tablets.
   gscoped_ptr<ThreadPool> apply_pool_;
 
   // Used for scheduling flushes
   std::unique_ptr<BackgroundTask> background_task_;
 
+  // Flushes because of the global memstore limit.
+  scoped_refptr<Histogram> global_memstore_flush_size_;
+  scoped_refptr<Counter> global_memstore_flush_deferrals_;
+
   // For block cache and memory monitor shared across tablets
   tablet::TabletOptions tablet_options_;
 
@@ -42,6 +42,7 @@
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/quorum_util.h"
 #include "yb/gutil/map-util.h"
+#include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/human_readable.h"
 #include "yb/gutil/strings/join.h"
 #include "yb/gutil/strings/numbers.h"
@@ -88,6 +89,10 @@ Status TabletServerPathHandlers::Register(Webserver* server) {
   server->RegisterPathHandler(
       "/tablets", "Tablets", std::bind(&TabletServerPathHandlers::HandleTabletsPage, this, _1, _2),
       true /* styled */, true /* is_on_nav_bar */, "fa fa-server");
+  server->RegisterPathHandler(
+      "/hot-tablets", "Hot Tablets",
+      std::bind(&TabletServerPathHandlers::HandleHotTabletsPage, this, _1, _2),
+      true /* styled */, false /* is_on_nav_bar */);
   server->RegisterPathHandler(
       "/tablet", "", std::bind(&TabletServerPathHandlers::HandleTabletPage, this, _1, _2),
       true /* styled */, false /* is_on_nav_bar */);
@@ -239,6 +244,54 @@ void TabletServerPathHandlers::HandleTabletsPage(const Webserver::WebRequest& re
   *output << "</table>\n";
 }
 
+void TabletServerPathHandlers::HandleHotTabletsPage(const Webserver::WebRequest& req,
+                                                    std::stringstream *output) {
+  vector<scoped_refptr<TabletPeer> > peers;
+  tserver_->tablet_manager()->GetTabletPeers(&peers);
+
+  vector<std::pair<scoped_refptr<TabletPeer>, tablet::TabletLoad>> loads;
+  for (const scoped_refptr<TabletPeer>& peer : peers) {
+    shared_ptr<Tablet> tablet = peer->shared_tablet();
+    if (tablet) {
+      loads.emplace_back(peer, tablet->hotspots()->GetLoad());
+    }
+  }
+  std::sort(loads.begin(), loads.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.second.read_ops_per_sec + lhs.second.write_ops_per_sec >
+           rhs.second.read_ops_per_sec + rhs.second.write_ops_per_sec;
+  });
+
+  *output << "<h1>Hot Tablets</h1>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Table name</th><th>Tablet ID</th><th>Role</th>"
+      "<th>Read ops/sec</th><th>Write ops/sec</th><th>Read bytes/sec</th><th>Write bytes/sec</th>"
+      "<th>Hot keys (share of ops)</th></tr>\n";
+  for (const auto& entry : loads) {
+    const scoped_refptr<TabletPeer>& peer = entry.first;
+    const tablet::TabletLoad& load = entry.second;
+    scoped_refptr<consensus::Consensus> consensus = peer->shared_consensus();
+    const RaftPeerPB::Role role = consensus ? consensus->role() : RaftPeerPB::UNKNOWN_ROLE;
+    string hot_keys;
+    for (const auto& hot_key : load.hot_keys) {
+      hot_keys += Substitute("$0 ($1%)<br>",
+                             EscapeForHtmlToString(Slice(hot_key.first).ToDebugString()),
+                             StringPrintf("%.1f", hot_key.second * 100));
+    }
+    (*output) << Substitute(
+        "<tr><td>$0</td><td>$1</td><td>$2</td><td>$3</td><td>$4</td><td>$5</td><td>$6</td>"
+        "<td>$7</td></tr>\n",
+        EscapeForHtmlToString(peer->tablet_metadata()->table_name()),
+        TabletLink(peer->tablet_id()),
+        RaftPeerPB::Role_Name(role),
+        StringPrintf("%.2f", load.read_ops_per_sec),
+        StringPrintf("%.2f", load.write_ops_per_sec),
+        HumanReadableNumBytes::ToString(load.read_bytes_per_sec),
+        HumanReadableNumBytes::ToString(load.write_bytes_per_sec),
+        hot_keys);
+  }
+  *output << "</table>\n";
+}
+
 namespace {
 
 bool CompareByMemberType(const RaftPeerPB& a, const RaftPeerPB& b) {
@@ -67,6 +67,8 @@ class TabletServerPathHandlers {
                        std::stringstream* output);
   void HandleTabletsPage(const Webserver::WebRequest& req,
                          std::stringstream* output);
+  void HandleHotTabletsPage(const Webserver::WebRequest& req,
+                         std::stringstream* output);
   void HandleTabletPage(const Webserver::WebRequest& req,
                         std::stringstream* output);
   void HandleTransactionsPage(const Webserver::WebRequest& req,
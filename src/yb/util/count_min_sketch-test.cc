@@ -0,0 +1,66 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/count_min_sketch.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+class CountMinSketchTest : public YBTest {
+};
+
+TEST_F(CountMinSketchTest, Estimate) {
+  CountMinSketch sketch(256, 4);
+  for (int i = 0; i != 1000; ++i) {
+    sketch.Add(std::to_string(i % 100));
+  }
+  ASSERT_EQ(1000U, sketch.total());
+  for (int i = 0; i != 100; ++i) {
+    // Estimates never go below the real count.
+    ASSERT_GE(sketch.Estimate(std::to_string(i)), 10U);
+  }
+
+  sketch.Halve();
+  ASSERT_EQ(500U, sketch.total());
+  ASSERT_GE(sketch.Estimate("1"), 5U);
+}
+
+TEST_F(CountMinSketchTest, HeavyHitters) {
+  HeavyHitters hitters(3, 256, 4);
+  for (int i = 0; i != 10000; ++i) {
+    if (i % 2 == 0) {
+      hitters.Add("hot");
+    } else if (i % 5 == 1) {
+      hitters.Add("warm");
+    } else {
+      hitters.Add(std::to_string(i));
+    }
+  }
+  auto top = hitters.TopKeys();
+  ASSERT_EQ(3U, top.size());
+  ASSERT_EQ("hot", top[0].first);
+  ASSERT_GE(top[0].second, 5000U);
+  ASSERT_EQ("warm", top[1].first);
+  ASSERT_GE(top[1].second, 1000U);
+
+  for (int i = 0; i != 20; ++i) {
+    hitters.Halve();
+  }
+  ASSERT_TRUE(hitters.TopKeys().empty());
+}
+
+} // namespace yb
@@ -0,0 +1,115 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/count_min_sketch.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <glog/logging.h>
+
+#include "yb/util/hash_util.h"
+
+namespace yb {
+
+namespace {
+
+constexpr uint64_t kHashSeed = 0x9e3779b97f4a7c15ULL;
+
+} // namespace
+
+CountMinSketch::CountMinSketch(size_t width, size_t depth)
+    : width_(width), depth_(depth), counts_(width * depth) {
+  CHECK_GT(width, 0);
+  CHECK_GT(depth, 0);
+}
+
+size_t CountMinSketch::Index(size_t row, uint64_t hash) const {
+  // Double hashing: derives the hash of each row from two halves of a single 64-bit hash.
+  const uint32_t h1 = static_cast<uint32_t>(hash);
+  const uint32_t h2 = static_cast<uint32_t>(hash >> 32);
+  return row * width_ + (h1 + row * h2) % width_;
+}
+
+uint64_t CountMinSketch::Add(Slice key, uint64_t count) {
+  const uint64_t hash = HashUtil::MurmurHash2_64(key.data(), key.size(), kHashSeed);
+  uint64_t result = std::numeric_limits<uint64_t>::max();
+  for (size_t row = 0; row != depth_; ++row) {
+    auto& value = counts_[Index(row, hash)];
+    value += count;
+    result = std::min(result, value);
+  }
+  total_ += count;
+  return result;
+}
+
+uint64_t CountMinSketch::Estimate(Slice key) const {
+  const uint64_t hash = HashUtil::MurmurHash2_64(key.data(), key.size(), kHashSeed);
+  uint64_t result = std::numeric_limits<uint64_t>::max();
+  for (size_t row = 0; row != depth_; ++row) {
+    result = std::min(result, counts_[Index(row, hash)]);
+  }
+  return result;
+}
+
+void CountMinSketch::Halve() {
+  for (auto& value : counts_) {
+    value >>= 1;
+  }
+  total_ >>= 1;
+}
+
+HeavyHitters::HeavyHitters(size_t num_keys, size_t width, size_t depth)
+    : num_keys_(num_keys), sketch_(width, depth) {
+  top_.reserve(num_keys);
+}
+
+void HeavyHitters::Add(Slice key, uint64_t count) {
+  const uint64_t estimate = sketch_.Add(key, count);
+  auto min_it = top_.end();
+  for (auto it = top_.begin(); it != top_.end(); ++it) {
+    if (key == it->first) {
+      it->second = estimate;
+      return;
+    }
+    if (min_it == top_.end() || it->second < min_it->second) {
+      min_it = it;
+    }
+  }
+  if (top_.size() < num_keys_) {
+    top_.emplace_back(key.ToBuffer(), estimate);
+  } else if (min_it != top_.end() && min_it->second < estimate) {
+    min_it->first = key.ToBuffer();
+    min_it->second = estimate;
+  }
+}
+
+void HeavyHitters::Halve() {
+  sketch_.Halve();
+  for (auto& entry : top_) {
+    entry.second >>= 1;
+  }
+  top_.erase(std::remove_if(top_.begin(), top_.end(),
+                            [](const auto& entry) { return entry.second == 0; }),
+             top_.end());
+}
+
+std::vector<std::pair<std::string, uint64_t>> HeavyHitters::TopKeys() const {
+  auto result = top_;
+  std::sort(result.begin(), result.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.second > rhs.second;
+  });
+  return result;
+}
+
+} // namespace yb
@@ -0,0 +1,84 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_COUNT_MIN_SKETCH_H
+#define YB_UTIL_COUNT_MIN_SKETCH_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "yb/gutil/macros.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+
+// Count-min sketch: approximate counts of keys in a fixed amount of memory. Estimates never
+// underestimate the real count, and overestimate it by at most 'total / width' with probability
+// of at least 1 - 2^-depth.
+//
+// This class is not thread-safe.
+class CountMinSketch {
+ public:
+  CountMinSketch(size_t width, size_t depth);
+
+  // Adds 'count' occurrences of 'key' and returns the new estimate of its count.
+  uint64_t Add(Slice key, uint64_t count = 1);
+
+  uint64_t Estimate(Slice key) const;
+
+  // Divides all counts by two, so that old occurrences weigh less than recent ones.
+  void Halve();
+
+  uint64_t total() const { return total_; }
+
+ private:
+  size_t Index(size_t row, uint64_t hash) const;
+
+  const size_t width_;
+  const size_t depth_;
+  std::vector<uint64_t> counts_;
+  uint64_t total_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(CountMinSketch);
+};
+
+// Tracks the approximate top-K most frequent keys of a stream, using a count-min sketch for
+// frequencies and keeping the K keys with the highest estimates as candidates.
+//
+// This class is not thread-safe.
+class HeavyHitters {
+ public:
+  HeavyHitters(size_t num_keys, size_t width, size_t depth);
+
+  void Add(Slice key, uint64_t count = 1);
+
+  // Halves all counts, see CountMinSketch::Halve.
+  void Halve();
+
+  // Returns the tracked keys with their estimated counts, most frequent first.
+  std::vector<std::pair<std::string, uint64_t>> TopKeys() const;
+
+  uint64_t total() const { return sketch_.total(); }
+
+ private:
+  const size_t num_keys_;
+  CountMinSketch sketch_;
+  std::vector<std::pair<std::string, uint64_t>> top_;
+
+  DISALLOW_COPY_AND_ASSIGN(HeavyHitters);
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_COUNT_MIN_SKETCH_H
@@ -0,0 +1,96 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/cpu_sampling_profiler.h"
+
+#include <atomic>
+#include <sstream>
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "yb/util/test_util.h"
+#include "yb/util/thread.h"
+
+DECLARE_int32(cpu_sampling_profiler_window_secs);
+
+namespace yb {
+
+class CpuSamplingProfilerTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    ASSERT_OK(Thread::Create("spinner", "spinner", [this] {
+      while (!stop_.load(std::memory_order_acquire)) {
+      }
+    }, &spinner_));
+  }
+
+  void TearDown() override {
+    stop_.store(true, std::memory_order_release);
+    ASSERT_OK(ThreadJoiner(spinner_.get()).Join());
+    YBTest::TearDown();
+  }
+
+  // Samples until the spinning thread shows up in the profile of [from, to).
+  void SampleUntilSpinnerFound(MonoTime now, MonoTime from, MonoTime to) {
+    for (int i = 0; i != 100; ++i) {
+      profiler_.TakeSample(now);
+      if (Profile(from, to).find("spinner;") != std::string::npos) {
+        return;
+      }
+    }
+    FAIL() << "Spinning thread not sampled: " << Profile(from, to);
+  }
+
+  std::string Profile(MonoTime from, MonoTime to) {
+    std::stringstream out;
+    profiler_.WriteProfile(from, to, &out);
+    return out.str();
+  }
+
+  CpuSamplingProfiler profiler_;
+  std::atomic<bool> stop_{false};
+  scoped_refptr<Thread> spinner_;
+};
+
+TEST_F(CpuSamplingProfilerTest, SamplesRunningThreads) {
+  const auto start = MonoTime::Now();
+  const auto end = start + MonoDelta::FromSeconds(1);
+  ASSERT_NO_FATALS(SampleUntilSpinnerFound(start, start, end));
+
+  // Every line is a folded stack followed by its number of samples.
+  std::stringstream profile(Profile(start, end));
+  std::string line;
+  while (std::getline(profile, line)) {
+    auto count_pos = line.rfind(' ');
+    ASSERT_NE(std::string::npos, count_pos) << line;
+    ASSERT_GT(std::stoll(line.substr(count_pos + 1)), 0) << line;
+  }
+
+  // Nothing was sampled outside of the window that was asked for.
+  ASSERT_EQ("", Profile(end, end + MonoDelta::FromSeconds(1)));
+}
+
+TEST_F(CpuSamplingProfilerTest, DropsSamplesOutsideOfWindow) {
+  FLAGS_cpu_sampling_profiler_window_secs = 10;
+  const auto start = MonoTime::Now();
+  const auto second = MonoDelta::FromSeconds(1);
+  ASSERT_NO_FATALS(SampleUntilSpinnerFound(start, start, start + second));
+
+  const auto later = start + MonoDelta::FromSeconds(20);
+  ASSERT_NO_FATALS(SampleUntilSpinnerFound(later, later, later + second));
+  ASSERT_EQ("", Profile(start, start + second));
+}
+
+} // namespace yb
@@ -0,0 +1,190 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/cpu_sampling_profiler.h"
+
+#include <ostream>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/logging.h"
+#include "yb/util/os-util.h"
+#include "yb/util/thread.h"
+
+DEFINE_int32(cpu_sampling_profiler_frequency_hz, 2,
+             "Number of times per second that the continuous CPU profiler samples the stacks of "
+             "the running threads of the process, shown by /pprof/continuous. 0 to pause it.");
+TAG_FLAG(cpu_sampling_profiler_frequency_hz, advanced);
+TAG_FLAG(cpu_sampling_profiler_frequency_hz, runtime);
+
+DEFINE_int32(cpu_sampling_profiler_window_secs, 600,
+             "Number of seconds of samples that the continuous CPU profiler keeps in memory.");
+TAG_FLAG(cpu_sampling_profiler_window_secs, advanced);
+TAG_FLAG(cpu_sampling_profiler_window_secs, runtime);
+
+DEFINE_int32(cpu_sampling_profiler_stack_timeout_ms, 10,
+             "How long the continuous CPU profiler waits for a thread to report its stack before "
+             "skipping it in the current sample.");
+TAG_FLAG(cpu_sampling_profiler_stack_timeout_ms, advanced);
+
+namespace yb {
+
+size_t CpuSamplingProfiler::SampleKeyHash::operator()(const SampleKey& key) const {
+  size_t seed = std::hash<std::string>()(key.category);
+  boost::hash_combine(seed, key.stack.HashCode());
+  return seed;
+}
+
+CpuSamplingProfiler::CpuSamplingProfiler() : stop_latch_(1) {
+}
+
+CpuSamplingProfiler::~CpuSamplingProfiler() {
+  Shutdown();
+}
+
+Status CpuSamplingProfiler::Start() {
+  MutexLock l(mutex_);
+  if (thread_) {
+    return Status::OK();
+  }
+  stop_latch_.Reset(1);
+  return Thread::Create(
+      "profiler", "cpu-sampler", std::bind(&CpuSamplingProfiler::RunThread, this), &thread_);
+}
+
+void CpuSamplingProfiler::Shutdown() {
+  scoped_refptr<Thread> thread;
+  {
+    MutexLock l(mutex_);
+    thread.swap(thread_);
+  }
+  if (thread) {
+    stop_latch_.CountDown();
+    CHECK_OK(ThreadJoiner(thread.get()).Join());
+  }
+}
+
+void CpuSamplingProfiler::RunThread() {
+  for (;;) {
+    // Read on every iteration, so that the profiler can be paused or sped up at runtime.
+    const int frequency_hz = FLAGS_cpu_sampling_profiler_frequency_hz;
+    const MonoDelta interval = frequency_hz > 0
+        ? MonoDelta::FromMicroseconds(1000000 / frequency_hz) : MonoDelta::FromSeconds(1);
+    if (stop_latch_.WaitFor(interval)) {
+      return;
+    }
+    if (frequency_hz > 0) {
+      TakeSample(MonoTime::Now());
+    }
+  }
+}
+
+void CpuSamplingProfiler::TakeSample(MonoTime now) {
+  std::vector<pid_t> tids;
+  Status s = ListThreads(&tids);
+  if (!s.ok()) {
+    YB_LOG_EVERY_N(WARNING, 100) << "Could not list the threads of the process: " << s;
+    return;
+  }
+
+  // Only the few threads on CPU are signalled, which is what keeps the overhead low: the others
+  // are just skipped after reading their state from /proc.
+  const auto registered_categories = RegisteredThreadCategories();
+  const int64_t own_tid = Thread::CurrentThreadId();
+  const auto timeout = MonoDelta::FromMilliseconds(FLAGS_cpu_sampling_profiler_stack_timeout_ms);
+  std::vector<SampleKey> samples;
+  for (pid_t tid : tids) {
+    ThreadStats stats;
+    std::string name;
+    if (tid == own_tid || !GetThreadStats(tid, &stats, &name).ok() || stats.state != 'R') {
+      continue;
+    }
+    SampleKey sample;
+    if (!GetThreadStack(tid, timeout, &sample.stack).ok()) {
+      // The thread exited or is blocking signals.
+      continue;
+    }
+    auto it = registered_categories.find(tid);
+    sample.category = it != registered_categories.end() ? it->second
+                                                        : UnregisteredThreadCategory(name);
+    samples.push_back(std::move(sample));
+  }
+
+  const auto window = MonoDelta::FromSeconds(FLAGS_cpu_sampling_profiler_window_secs);
+  MutexLock l(mutex_);
+  while (!buckets_.empty() && buckets_.front().start + window < now) {
+    buckets_.pop_front();
+  }
+  if (buckets_.empty() || buckets_.back().start + MonoDelta::FromSeconds(1) <= now) {
+    buckets_.emplace_back();
+    buckets_.back().start = now;
+  }
+  auto& counts = buckets_.back().counts;
+  for (auto& sample : samples) {
+    ++counts[std::move(sample)];
+  }
+}
+
+void CpuSamplingProfiler::WriteProfile(MonoTime from, MonoTime to, std::ostream* out) const {
+  SampleCounts counts;
+  {
+    MutexLock l(mutex_);
+    for (const auto& bucket : buckets_) {
+      if (from <= bucket.start && bucket.start < to) {
+        for (const auto& entry : bucket.counts) {
+          counts[entry.first] += entry.second;
+        }
+      }
+    }
+  }
+
+  // The same frames show up in many stacks, so each address is only symbolized once.
+  std::unordered_map<void*, std::string> symbols;
+  for (const auto& entry : counts) {
+    const StackTrace& stack = entry.first.stack;
+    *out << entry.first.category;
+    for (int i = stack.num_frames(); i-- > 0;) {
+      void* pc = stack.frame(i);
+      auto it = symbols.find(pc);
+      if (it == symbols.end()) {
+        it = symbols.emplace(pc, SymbolizeFunctionName(pc)).first;
+      }
+      *out << ';' << it->second;
+    }
+    *out << ' ' << entry.second << std::endl;
+  }
+}
+
+namespace {
+
+// Never destroyed, so that the sampling thread does not race with the static destructors at exit.
+CpuSamplingProfiler* ProcessCpuSamplingProfiler() {
+  static CpuSamplingProfiler* profiler = new CpuSamplingProfiler();
+  return profiler;
+}
+
+} // namespace
+
+Status StartCpuSamplingProfiler() {
+  return ProcessCpuSamplingProfiler()->Start();
+}
+
+void WriteCpuSamplingProfile(MonoTime from, MonoTime to, std::ostream* out) {
+  ProcessCpuSamplingProfiler()->WriteProfile(from, to, out);
+}
+
+} // namespace yb
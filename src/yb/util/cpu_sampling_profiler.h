@@ -0,0 +1,109 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_CPU_SAMPLING_PROFILER_H
+#define YB_UTIL_CPU_SAMPLING_PROFILER_H
+
+#include <deque>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+
+#include "yb/gutil/macros.h"
+#include "yb/gutil/ref_counted.h"
+#include "yb/util/countdown_latch.h"
+#include "yb/util/debug-util.h"
+#include "yb/util/monotime.h"
+#include "yb/util/mutex.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+class Thread;
+
+// Continuous low overhead CPU profiler of the process.
+//
+// A background thread wakes up --cpu_sampling_profiler_frequency_hz times per second, finds the
+// threads that are running at that moment from /proc and collects their stacks through the stack
+// trace signal (see GetThreadStack()). The samples are counted by thread category and stack in one
+// bucket per second, and the buckets of the last --cpu_sampling_profiler_window_secs seconds are
+// kept, so that the profile of any recent interval can be looked at after the fact, without having
+// to reproduce the issue under a profiler. Stacks are only symbolized when a profile is written.
+//
+// It does not use SIGPROF, so it runs alongside the on-demand profile of /pprof/profile.
+class CpuSamplingProfiler {
+ public:
+  CpuSamplingProfiler();
+  ~CpuSamplingProfiler();
+
+  // Starts the background sampling thread. Does nothing if it is already running.
+  CHECKED_STATUS Start();
+
+  // Stops the background sampling thread. The samples taken so far are kept.
+  void Shutdown();
+
+  // Takes one sample at time 'now': counts the stack of each thread of the process that is running
+  // or runnable, other than the calling one.
+  void TakeSample(MonoTime now);
+
+  // Writes the samples taken in [from, to) to 'out' in the folded stack format read by
+  // flamegraph.pl: one line per thread category and distinct stack, the category first and then
+  // the frames from the outermost one, followed by the number of samples, e.g.
+  //   rpc_thread_pool;start_thread;yb::Thread::SuperviseThread;...;yb::tablet::Tablet::Read 12
+  void WriteProfile(MonoTime from, MonoTime to, std::ostream* out) const;
+
+ private:
+  struct SampleKey {
+    std::string category;
+    StackTrace stack;
+
+    bool operator==(const SampleKey& rhs) const {
+      return category == rhs.category && stack.Equals(rhs.stack);
+    }
+  };
+
+  struct SampleKeyHash {
+    size_t operator()(const SampleKey& key) const;
+  };
+
+  typedef std::unordered_map<SampleKey, int64_t, SampleKeyHash> SampleCounts;
+
+  // The samples taken in the second starting at 'start'.
+  struct Bucket {
+    MonoTime start;
+    SampleCounts counts;
+  };
+
+  void RunThread();
+
+  mutable Mutex mutex_;
+
+  // The buckets of the current window, oldest first.
+  std::deque<Bucket> buckets_;
+
+  CountDownLatch stop_latch_;
+  scoped_refptr<Thread> thread_;
+
+  DISALLOW_COPY_AND_ASSIGN(CpuSamplingProfiler);
+};
+
+// Starts the CPU sampling profiler of the process, if it is not running yet.
+CHECKED_STATUS StartCpuSamplingProfiler();
+
+// Writes the profile of the CPU sampling profiler of the process in [from, to), see
+// CpuSamplingProfiler::WriteProfile().
+void WriteCpuSamplingProfile(MonoTime from, MonoTime to, std::ostream* out);
+
+} // namespace yb
+
+#endif // YB_UTIL_CPU_SAMPLING_PROFILER_H
@@ -33,6 +33,7 @@
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/util/crc.h"
+#include "yb/util/random.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/test_util.h"
 
@@ -71,6 +72,35 @@ TEST_F(CrcTest, TestCRC32C) {
   output = FastHex32ToBuffer(static_cast<uint32_t>(data_crc), buf);
   LOG(INFO) << "CRC32C of " << test_data << " is: 0x" << output << " (truncated 32 bits)";
   ASSERT_EQ(0xa9421b7, data_crc); // Known value from crcutil usage test program.
+  ASSERT_EQ(0xa9421b7, Crc32c(test_data.data(), test_data.length()));
+}
+
+// Crc32c() should match crcutil for all lengths and alignments, including the ones handled by the
+// interleaved hardware implementation.
+TEST_F(CrcTest, TestCRC32CMatchesCrcutil) {
+  LOG(INFO) << "Hardware CRC32C supported: " << IsHardwareCrc32cSupported();
+  Random rng(SeedRandom());
+  std::string data(100000, 0);
+  for (auto& c : data) {
+    c = static_cast<char>(rng.Next());
+  }
+  Crc* crc32c = GetCrc32cInstance();
+  for (size_t offset = 0; offset != 8; ++offset) {
+    for (size_t length : {0, 1, 7, 8, 9, 255, 256, 767, 768, 769, 1000, 8192 * 3 - 1, 8192 * 3,
+                          8192 * 3 + 5, 50000, 99000}) {
+      uint64_t expected = 0;
+      crc32c->Compute(data.data() + offset, length, &expected);
+      ASSERT_EQ(expected, Crc32c(data.data() + offset, length))
+          << "offset: " << offset << ", length: " << length;
+
+      // The CRC of a prefix extended with the rest.
+      const size_t prefix = length / 3;
+      const uint32_t prefix_crc = Crc32c(data.data() + offset, prefix);
+      ASSERT_EQ(expected,
+                Crc32cExtend(prefix_crc, data.data() + offset + prefix, length - prefix))
+          << "offset: " << offset << ", length: " << length;
+    }
+  }
 }
 
 // Simple benchmark of CRC32C throughput.
@@ -100,6 +130,17 @@ TEST_F(CrcTest, BenchmarkCRC32C) {
                           kNumRuns, buflen, kNumBytes, elapsed.wall_seconds(),
                           (kNumBytes / elapsed.wall_millis()),
                           (kNumBytes / elapsed.wall));
+
+  sw.start();
+  for (int i = 0; i < kNumRuns; i++) {
+    Crc32c(buf, buflen);
+  }
+  sw.stop();
+  elapsed = sw.elapsed();
+  LOG(INFO) << Substitute("$0 runs of Crc32c() ($1) on $2 bytes of data in $3 seconds; "
+                          "$4 bytes per millisecond",
+                          kNumRuns, IsHardwareCrc32cSupported() ? "hardware" : "crcutil", buflen,
+                          elapsed.wall_seconds(), (kNumBytes / elapsed.wall_millis()));
 }
 
 } // namespace crc
@@ -31,6 +31,15 @@
 //
 #include "yb/util/crc.h"
 
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#endif
+
+#include <string.h>
+
 #include <crcutil/interface.h>
 
 #include "yb/gutil/once.h"
@@ -55,11 +64,211 @@ Crc* GetCrc32cInstance() {
   return crc32c_instance;
 }
 
-uint32_t Crc32c(const void* data, size_t length) {
-  uint64_t crc32 = 0;
+namespace {
+
+uint32_t SoftwareExtend(uint32_t crc, const void* data, size_t length) {
+  uint64_t crc32 = crc;
   GetCrc32cInstance()->Compute(data, length, &crc32);
   return static_cast<uint32_t>(crc32); // Only uses lower 32 bits.
 }
 
+#if defined(__SSE4_2__) || (defined(__aarch64__) && defined(__ARM_FEATURE_CRC32))
+
+// CRC32C polynomial in the reversed bit order.
+constexpr uint32_t kCrc32cPolynomial = 0x82f63b78;
+
+// The CRC instructions have a latency of 3 cycles, but a throughput of one per cycle, so the CRCs
+// of three adjacent blocks are computed in parallel and then combined. Long blocks are used for
+// large buffers, short ones for the rest, to reduce the cost of the combination.
+constexpr size_t kLongBlock = 8192;
+constexpr size_t kShortBlock = 256;
+
+// Multiplies the 32x32 GF(2) matrix mat by vec.
+uint32_t Gf2MatrixTimes(const uint32_t* mat, uint32_t vec) {
+  uint32_t sum = 0;
+  while (vec) {
+    if (vec & 1) {
+      sum ^= *mat;
+    }
+    vec >>= 1;
+    ++mat;
+  }
+  return sum;
+}
+
+void Gf2MatrixSquare(uint32_t* square, const uint32_t* mat) {
+  for (int n = 0; n < 32; ++n) {
+    square[n] = Gf2MatrixTimes(mat, mat[n]);
+  }
+}
+
+// Shifts a CRC over a fixed number of zero bytes, i.e. converts the CRC of a block A into the CRC of
+// A followed by the zeros. XOR-ing the result with the CRC of a block B of this length, computed
+// from a zero initial value, gives the CRC of A followed by B.
+class ZerosShift {
+ public:
+  // length must be a power of two.
+  explicit ZerosShift(size_t length) {
+    uint32_t op[32];
+    ZerosOperator(length, op);
+    for (uint32_t n = 0; n < 256; ++n) {
+      table_[0][n] = Gf2MatrixTimes(op, n);
+      table_[1][n] = Gf2MatrixTimes(op, n << 8);
+      table_[2][n] = Gf2MatrixTimes(op, n << 16);
+      table_[3][n] = Gf2MatrixTimes(op, n << 24);
+    }
+  }
+
+  uint32_t operator()(uint32_t crc) const {
+    return table_[0][crc & 0xff] ^ table_[1][(crc >> 8) & 0xff] ^
+           table_[2][(crc >> 16) & 0xff] ^ table_[3][crc >> 24];
+  }
+
+ private:
+  // Builds the matrix that applies length zero bytes to a CRC.
+  static void ZerosOperator(size_t length, uint32_t* even) {
+    // Operator for one zero bit.
+    uint32_t odd[32];
+    odd[0] = kCrc32cPolynomial;
+    uint32_t row = 1;
+    for (int n = 1; n < 32; ++n) {
+      odd[n] = row;
+      row <<= 1;
+    }
+    // Two zero bits in even, then four in odd.
+    Gf2MatrixSquare(even, odd);
+    Gf2MatrixSquare(odd, even);
+    // Each squaring doubles the number of zeros, the first one gives a zero byte.
+    for (;;) {
+      Gf2MatrixSquare(even, odd);
+      length >>= 1;
+      if (length == 0) {
+        return;
+      }
+      Gf2MatrixSquare(odd, even);
+      length >>= 1;
+      if (length == 0) {
+        break;
+      }
+    }
+    memcpy(even, odd, sizeof(odd));
+  }
+
+  uint32_t table_[4][256];
+};
+
+#if defined(__SSE4_2__)
+
+bool HardwareSupported() {
+  return __builtin_cpu_supports("sse4.2");
+}
+
+inline uint64_t HardwareCrc64(uint64_t crc, const uint8_t* p) {
+  uint64_t value;
+  memcpy(&value, p, sizeof(value));
+  return _mm_crc32_u64(crc, value);
+}
+
+inline uint64_t HardwareCrc8(uint64_t crc, const uint8_t* p) {
+  return _mm_crc32_u8(static_cast<uint32_t>(crc), *p);
+}
+
+#else
+
+bool HardwareSupported() {
+  return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+}
+
+inline uint64_t HardwareCrc64(uint64_t crc, const uint8_t* p) {
+  uint64_t value;
+  memcpy(&value, p, sizeof(value));
+  return __crc32cd(static_cast<uint32_t>(crc), value);
+}
+
+inline uint64_t HardwareCrc8(uint64_t crc, const uint8_t* p) {
+  return __crc32cb(static_cast<uint32_t>(crc), *p);
+}
+
+#endif
+
+// Computes the CRCs of three adjacent blocks of block_size bytes in parallel, while at least three
+// such blocks remain.
+inline void ExtendBlocks(
+    size_t block_size, const ZerosShift& shift, uint64_t* crc, const uint8_t** p, size_t* length) {
+  while (*length >= block_size * 3) {
+    uint64_t crc0 = *crc;
+    uint64_t crc1 = 0;
+    uint64_t crc2 = 0;
+    const uint8_t* next = *p;
+    const uint8_t* end = next + block_size;
+    do {
+      crc0 = HardwareCrc64(crc0, next);
+      crc1 = HardwareCrc64(crc1, next + block_size);
+      crc2 = HardwareCrc64(crc2, next + 2 * block_size);
+      next += 8;
+    } while (next < end);
+    crc0 = shift(static_cast<uint32_t>(crc0)) ^ crc1;
+    *crc = shift(static_cast<uint32_t>(crc0)) ^ crc2;
+    *p += block_size * 3;
+    *length -= block_size * 3;
+  }
+}
+
+uint32_t HardwareExtend(uint32_t crc, const void* data, size_t length) {
+  static const ZerosShift long_shift(kLongBlock);
+  static const ZerosShift short_shift(kShortBlock);
+
+  const uint8_t* p = static_cast<const uint8_t*>(data);
+  uint64_t result = crc ^ 0xffffffffu;
+  // Align the loads of 8 bytes.
+  while (length != 0 && (reinterpret_cast<uintptr_t>(p) & 7) != 0) {
+    result = HardwareCrc8(result, p);
+    ++p;
+    --length;
+  }
+  ExtendBlocks(kLongBlock, long_shift, &result, &p, &length);
+  ExtendBlocks(kShortBlock, short_shift, &result, &p, &length);
+  while (length >= 8) {
+    result = HardwareCrc64(result, p);
+    p += 8;
+    length -= 8;
+  }
+  while (length != 0) {
+    result = HardwareCrc8(result, p);
+    ++p;
+    --length;
+  }
+  return static_cast<uint32_t>(result) ^ 0xffffffffu;
+}
+
+#else
+
+bool HardwareSupported() {
+  return false;
+}
+
+uint32_t HardwareExtend(uint32_t crc, const void* data, size_t length) {
+  return SoftwareExtend(crc, data, length);
+}
+
+#endif
+
+} // namespace
+
+bool IsHardwareCrc32cSupported() {
+  // Function local static, since checksums could be computed by static initializers.
+  static const bool supported = HardwareSupported();
+  return supported;
+}
+
+uint32_t Crc32cExtend(uint32_t crc, const void* data, size_t length) {
+  return IsHardwareCrc32cSupported() ? HardwareExtend(crc, data, length)
+                                     : SoftwareExtend(crc, data, length);
+}
+
+uint32_t Crc32c(const void* data, size_t length) {
+  return Crc32cExtend(0, data, length);
+}
+
 } // namespace crc
 } // namespace yb
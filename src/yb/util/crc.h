@@ -46,8 +46,16 @@ typedef crcutil_interface::CRC Crc;
 Crc* GetCrc32cInstance();
 
 // Helper function to simply calculate a CRC32C of the given data.
+// Returns the CRC32C of data.
 uint32_t Crc32c(const void* data, size_t length);
 
+// Returns the CRC32C of the concatenation of some string A and data, where crc is the CRC32C of A.
+// Uses the CRC32C instructions of SSE4.2 or ARMv8 when the CPU has them, and crcutil otherwise.
+uint32_t Crc32cExtend(uint32_t crc, const void* data, size_t length);
+
+// Whether Crc32c() uses CRC32C instructions on this host.
+bool IsHardwareCrc32cSupported();
+
 } // namespace crc
 } // namespace yb
 
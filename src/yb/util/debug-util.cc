@@ -357,14 +357,14 @@ Status SetStackTraceSignal(int signum) {
   return Status::OK();
 }
 
-std::string DumpThreadStack(int64_t tid) {
+Status GetThreadStack(int64_t tid, MonoDelta timeout, StackTrace* stack) {
 #if defined(__linux__)
   base::SpinLockHolder h(&g_dumper_thread_lock);
 
   // Ensure that our signal handler is installed. We don't need any fancy GoogleOnce here
   // because of the mutex above.
   if (!InitSignalHandlerUnlocked(g_stack_trace_signum)) {
-    return "<unable to take thread stack: signal handler unavailable>";
+    return STATUS(ServiceUnavailable, "unable to take thread stack: signal handler unavailable");
   }
 
   // Set the target TID in our communication structure, so if we end up with any
@@ -383,41 +383,66 @@ std::string DumpThreadStack(int64_t tid) {
       SignalCommunication::Lock l;
       g_comm.target_tid = 0;
     }
-    return "(unable to deliver signal: process may have exited)";
+    return STATUS(NotFound, "unable to deliver signal: process may have exited");
   }
 
-  // We give the thread ~1s to respond. In testing, threads typically respond within
-  // a few iterations of the loop, so this timeout is very conservative.
+  // A running thread typically responds within microseconds, so we first just yield for a
+  // while, and only then sleep between the checks until the timeout.
   //
   // The main reason that a thread would not respond is that it has blocked signals. For
   // example, glibc's timer_thread doesn't respond to our signal, so we always time out
   // on that one.
-  string buf;
+  const MonoTime deadline = MonoTime::Now() + timeout;
   int i = 0;
-  while (!base::subtle::Acquire_Load(&g_comm.result_ready) &&
-         i++ < 100) {
-    SleepFor(MonoDelta::FromMilliseconds(10));
+  while (!base::subtle::Acquire_Load(&g_comm.result_ready) && MonoTime::Now() < deadline) {
+    if (i++ < 100) {
+      sched_yield();
+    } else {
+      SleepFor(MonoDelta::FromMilliseconds(1));
+    }
   }
 
+  Status result;
   {
     SignalCommunication::Lock l;
     CHECK_EQ(tid, g_comm.target_tid);
 
     if (!g_comm.result_ready) {
-      buf = "(thread did not respond: maybe it is blocking signals)";
+      result = STATUS(TimedOut, "thread did not respond: maybe it is blocking signals");
     } else {
-      buf = g_comm.stack.Symbolize();
+      stack->CopyFrom(g_comm.stack);
     }
 
     g_comm.target_tid = 0;
     g_comm.result_ready = 0;
   }
-  return buf;
+  return result;
 #else // defined(__linux__)
-  return "(unsupported platform)";
+  return STATUS(NotSupported, "unsupported platform");
 #endif
 }
 
+std::string DumpThreadStack(int64_t tid) {
+  // We give the thread ~1s to respond. In testing, threads typically respond within
+  // a few iterations of the loop, so this timeout is very conservative.
+  StackTrace stack;
+  Status s = GetThreadStack(tid, MonoDelta::FromSeconds(1), &stack);
+  if (!s.ok()) {
+    return "(" + s.message().ToString() + ")";
+  }
+  return stack.Symbolize();
+}
+
+std::string SymbolizeFunctionName(void* pc) {
+  // See the note in StackTrace::Symbolize() about why we subtract 1 from the return address.
+  void* const adjusted_pc = reinterpret_cast<void*>(reinterpret_cast<size_t>(pc) - 1);
+  char buf[1024];
+  if (google::Symbolize(adjusted_pc, buf, sizeof(buf))) {
+    return buf;
+  }
+  return StringPrintf("%p", pc);
+}
+
 Status ListThreads(vector<pid_t> *tids) {
 #if defined(__linux__)
   DIR *dir = opendir("/proc/self/task/");
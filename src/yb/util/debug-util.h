@@ -38,6 +38,7 @@
 #include <vector>
 
 #include "yb/gutil/strings/fastmem.h"
+#include "yb/util/monotime.h"
 #include "yb/util/status.h"
 
 namespace yb {
@@ -121,7 +122,7 @@ class StackTrace {
     memcpy(this, &s, sizeof(s));
   }
 
-  bool Equals(const StackTrace& s) {
+  bool Equals(const StackTrace& s) const {
     return s.num_frames_ == num_frames_ &&
       strings::memeq(frames_, s.frames_,
                      num_frames_ * sizeof(frames_[0]));
@@ -169,6 +170,15 @@ class StackTrace {
 
   uint64_t HashCode() const;
 
+  int num_frames() const {
+    return num_frames_;
+  }
+
+  // Return address of the frame 'i', 0 being the innermost frame.
+  void* frame(int i) const {
+    return frames_[i];
+  }
+
  private:
   enum {
     // The maximum number of stack frames to collect.
@@ -182,6 +192,16 @@ class StackTrace {
   void* frames_[kMaxFrames];
 };
 
+// Collect the stack trace of the given thread into 'stack', without symbolizing it, waiting at
+// most 'timeout' for the thread to respond. This is what DumpThreadStack() is built on, and has
+// the same requirements and the same coarse synchronization.
+Status GetThreadStack(int64_t tid, MonoDelta timeout, StackTrace* stack);
+
+// Return the demangled name of the function that the return address 'pc' of a collected stack
+// trace points into, or the address in hex form if it can't be symbolized.
+// This is not async-safe.
+std::string SymbolizeFunctionName(void* pc);
+
 constexpr bool IsDebug() {
 #ifdef NDEBUG
   return false;
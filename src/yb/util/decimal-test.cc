@@ -216,6 +216,25 @@ TEST_F(DecimalTest, TestVarIntConversions) {
   EXPECT_EQ("-8.71233726138962103701973e+23", Decimal(varint).ToString());
 }
 
+TEST_F(DecimalTest, TestArithmetic) {
+  EXPECT_EQ("3.5", (Decimal("1.25") + Decimal("2.25")).ToString());
+  EXPECT_EQ("-1", (Decimal("1.25") - Decimal("2.25")).ToString());
+  EXPECT_EQ("0", (Decimal("1.25") - Decimal("1.25")).ToString());
+  EXPECT_EQ("1.25", (Decimal("0") + Decimal("1.25")).ToString());
+  EXPECT_TRUE(Decimal("1000000.000001") == Decimal("1e6") + Decimal("1e-6"));
+  EXPECT_TRUE(Decimal("999999999999999999") == Decimal("999999999999999998") + Decimal("1"));
+
+  // Too many digits for int64.
+  EXPECT_TRUE(Decimal("1234567890123456789012.5") ==
+              Decimal("1234567890123456789012") + Decimal("0.5"));
+  EXPECT_TRUE(Decimal("-0.0000000000000000000001") ==
+              Decimal("0.9999999999999999999999") - Decimal("1"));
+  // The aligned mantissas overflow int64.
+  EXPECT_TRUE(Decimal("1000000000000000000.000000000000000001") ==
+              Decimal("1e18") + Decimal("1e-18"));
+  EXPECT_TRUE(Decimal("1e100") == Decimal("9.9e99") + Decimal("1e98"));
+}
+
 TEST_F(DecimalTest, TestComparableEncoding) {
   std::vector<Decimal> test_decimals;
   std::vector<std::string> encoded_strings;
@@ -11,6 +11,7 @@
 // under the License.
 //
 
+#include <algorithm>
 #include <vector>
 #include <limits>
 #include <iomanip>
@@ -391,6 +392,109 @@ void Decimal::make_canonical() {
   }
 }
 
+namespace {
+
+// The largest number of decimal digits that always fits in int64.
+constexpr size_t kMaxInt64Digits = 18;
+
+// Exponents up to this magnitude leave room for the digit counts added to them.
+constexpr int64_t kMaxFastExponent = 1LL << 62;
+
+int64_t PowerOfTen(size_t n) {
+  int64_t result = 1;
+  while (n-- > 0) {
+    result *= 10;
+  }
+  return result;
+}
+
+}  // namespace
+
+bool Decimal::ToScaledInt64(int64_t* mantissa, int64_t* scale) const {
+  int64_t exponent = 0;
+  if (digits_.size() > kMaxInt64Digits || !exponent_.FitsInt64(&exponent) ||
+      exponent > kMaxFastExponent || exponent < -kMaxFastExponent) {
+    return false;
+  }
+  *scale = exponent - static_cast<int64_t>(digits_.size());
+  int64_t value = 0;
+  for (auto digit : digits_) {
+    value = value * 10 + digit;
+  }
+  *mantissa = is_positive_ ? value : -value;
+  return true;
+}
+
+void Decimal::FromScaledInt64(int64_t mantissa, int64_t scale) {
+  clear();
+  if (mantissa == 0) {
+    return;
+  }
+  is_positive_ = mantissa > 0;
+  uint64_t value = is_positive_ ? static_cast<uint64_t>(mantissa)
+                                : ~static_cast<uint64_t>(mantissa) + 1;
+  // Trailing zeros are not part of the canonical digits.
+  while (value % 10 == 0) {
+    value /= 10;
+    ++scale;
+  }
+  while (value > 0) {
+    digits_.push_back(value % 10);
+    value /= 10;
+  }
+  std::reverse(digits_.begin(), digits_.end());
+  exponent_ = VarInt(scale + static_cast<int64_t>(digits_.size()));
+}
+
+VarInt Decimal::ShiftedMantissa(size_t shift) const {
+  std::vector<uint8_t> digits(shift, 0);
+  digits.insert(digits.end(), digits_.rbegin(), digits_.rend());
+  return VarInt(digits, 10, is_positive_);
+}
+
+Decimal Decimal::operator+(const Decimal& other) const {
+  if (digits_.empty()) {
+    return other;
+  }
+  if (other.digits_.empty()) {
+    return *this;
+  }
+
+  int64_t mantissa = 0, scale = 0, other_mantissa = 0, other_scale = 0;
+  if (ToScaledInt64(&mantissa, &scale) && other.ToScaledInt64(&other_mantissa, &other_scale)) {
+    // Align the operand with the larger scale to the smaller one.
+    if (scale < other_scale) {
+      std::swap(mantissa, other_mantissa);
+      std::swap(scale, other_scale);
+    }
+    int64_t sum = 0;
+    const uint64_t shift = static_cast<uint64_t>(scale) - static_cast<uint64_t>(other_scale);
+    if (shift <= kMaxInt64Digits &&
+        !__builtin_mul_overflow(mantissa, PowerOfTen(shift), &mantissa) &&
+        !__builtin_add_overflow(mantissa, other_mantissa, &sum)) {
+      Decimal result;
+      result.FromScaledInt64(sum, other_scale);
+      return result;
+    }
+  }
+
+  // Arbitrary precision: this = M * 10^(exponent - |digits|), the mantissas are aligned to the
+  // smaller scale and added as radix 10 VarInts.
+  const VarInt scale_var = exponent_ - VarInt(digits_.size());
+  const VarInt other_scale_var = other.exponent_ - VarInt(other.digits_.size());
+  const bool this_is_higher = scale_var > other_scale_var;
+  int64_t shift = 0;
+  CHECK_OK((this_is_higher ? scale_var - other_scale_var : other_scale_var - scale_var)
+               .ToInt64(&shift));
+  const VarInt sum = this_is_higher
+      ? ShiftedMantissa(shift) + other.ShiftedMantissa(0)
+      : ShiftedMantissa(0) + other.ShiftedMantissa(shift);
+  const VarInt& low_scale = this_is_higher ? other_scale_var : scale_var;
+  std::vector<uint8_t> digits(sum.digits_.rbegin(), sum.digits_.rend());
+  const VarInt exponent = low_scale + VarInt(digits.size());
+  return Decimal(digits, exponent, sum.is_positive_);
+}
+
 Decimal DecimalFromComparable(const Slice& slice) {
   Decimal decimal;
   CHECK_OK(decimal.DecodeFromComparable(slice));
@@ -134,6 +134,12 @@ class Decimal {
   Decimal operator-() const { return Decimal(digits_, exponent_, !is_positive_); }
   Decimal operator+() const { return Decimal(digits_, exponent_, is_positive_); }
 
+  // Exact sum and difference. When both operands have at most 18 significant digits and the
+  // aligned result fits in int64, the digits are added as fixed-width integers instead of digit
+  // by digit.
+  Decimal operator+(const Decimal& other) const;
+  Decimal operator-(const Decimal& other) const { return *this + -other; }
+
   // Encodes the decimal by using comparable encoding, as described above.
   std::string EncodeToComparable() const;
 
@@ -164,6 +170,13 @@ class Decimal {
   bool is_canonical() const;
   void make_canonical();
 
+  // Sets mantissa and scale so that this = mantissa * 10^scale, if the digits fit in int64.
+  bool ToScaledInt64(int64_t* mantissa, int64_t* scale) const;
+  // Sets this to mantissa * 10^scale.
+  void FromScaledInt64(int64_t mantissa, int64_t scale);
+  // Returns the digits as an integer in radix 10 followed by shift zeros, with this's sign.
+  VarInt ShiftedMantissa(size_t shift) const;
+
   std::vector<uint8_t> digits_;
   VarInt exponent_;
   bool is_positive_;
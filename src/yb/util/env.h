@@ -332,6 +332,10 @@ class RandomAccessFile {
   // Returns the size of the file
   virtual CHECKED_STATUS Size(uint64_t *size) const = 0;
 
+  // Starts reading "n" bytes at "offset" into the OS page cache without waiting for them, so that
+  // a later Read() of this range does not block on the device. This is only a hint.
+  virtual void Prefetch(uint64_t offset, size_t n) {}
+
   // Returns the filename provided when the RandomAccessFile was constructed.
   virtual const std::string& filename() const = 0;
 
@@ -350,10 +354,15 @@ struct WritableFileOptions {
   // See CreateMode for details.
   Env::CreateMode mode;
 
+  // With OPEN_EXISTING, write the file from its start and treat its current contents as
+  // preallocated space, which Close() truncates when it is not used.
+  bool reuse_allocated_space;
+
   WritableFileOptions()
     : sync_on_close(false),
       o_direct(false),
-      mode(Env::CREATE_IF_NON_EXISTING_TRUNCATE) { }
+      mode(Env::CREATE_IF_NON_EXISTING_TRUNCATE),
+      reuse_allocated_space(false) { }
 };
 
 // Options specified when a file is opened for random access.
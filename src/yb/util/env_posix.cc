@@ -314,6 +314,12 @@ class PosixRandomAccessFile: public RandomAccessFile {
     return Status::OK();
   }
 
+  void Prefetch(uint64_t offset, size_t n) override {
+#if !defined(__APPLE__)
+    posix_fadvise(fd_, static_cast<off_t>(offset), n, POSIX_FADV_WILLNEED);
+#endif
+  }
+
   const string& filename() const override { return filename_; }
 
   size_t memory_footprint() const override {
@@ -328,12 +334,12 @@ class PosixRandomAccessFile: public RandomAccessFile {
 class PosixWritableFile : public WritableFile {
  public:
   PosixWritableFile(std::string fname, int fd, uint64_t file_size,
-                    bool sync_on_close)
+                    bool sync_on_close, uint64_t pre_allocated_size = 0)
       : filename_(std::move(fname)),
         fd_(fd),
         sync_on_close_(sync_on_close),
         filesize_(file_size),
-        pre_allocated_size_(0),
+        pre_allocated_size_(pre_allocated_size),
         pending_sync_(false) {}
 
   ~PosixWritableFile() {
@@ -519,8 +525,8 @@ class PosixWritableFile : public WritableFile {
 class PosixDirectIOWritableFile : public PosixWritableFile {
  public:
   PosixDirectIOWritableFile(const std::string &fname, int fd, uint64_t file_size,
-                            bool sync_on_close)
-      : PosixWritableFile(fname, fd, file_size, false /* sync_on_close */) {
+                            bool sync_on_close, uint64_t pre_allocated_size = 0)
+      : PosixWritableFile(fname, fd, file_size, false /* sync_on_close */, pre_allocated_size) {
 
     if (file_size != 0) {
       // For now, we don't support appending to an already existing file (of non-zero size).
@@ -1421,16 +1427,23 @@ class PosixEnv : public Env {
                                     const WritableFileOptions& opts,
                                     gscoped_ptr<WritableFile>* result) {
     uint64_t file_size = 0;
+    uint64_t pre_allocated_size = 0;
     if (opts.mode == OPEN_EXISTING) {
       RETURN_NOT_OK(GetFileSize(fname, &file_size));
+      if (opts.reuse_allocated_space) {
+        pre_allocated_size = file_size;
+        file_size = 0;
+      }
     }
     PosixWritableFile *posix_writable_file;
 #if defined(__linux)
     if (opts.o_direct)
-      posix_writable_file = new PosixDirectIOWritableFile(fname, fd, file_size, opts.sync_on_close);
+      posix_writable_file = new PosixDirectIOWritableFile(
+          fname, fd, file_size, opts.sync_on_close, pre_allocated_size);
     else
 #endif
-      posix_writable_file = new PosixWritableFile(fname, fd, file_size, opts.sync_on_close);
+      posix_writable_file = new PosixWritableFile(
+          fname, fd, file_size, opts.sync_on_close, pre_allocated_size);
     result->reset(posix_writable_file);
     return Status::OK();
   }
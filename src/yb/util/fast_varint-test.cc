@@ -150,6 +150,29 @@ TEST(FastVarIntTest, TestEncodePerformance) {
             << 1000.0 * (end_time - start_time) / CLOCKS_PER_SEC << " ms\n";
 }
 
+TEST(FastVarIntTest, TestDecodePerformance) {
+  const std::vector<int64_t> values = GenerateRandomValues<int64_t>();
+  std::string encoded;
+  for (size_t i = 0; i != values.size(); ++i) {
+    // Both signs, as in the keys of ascending and descending columns.
+    FastAppendSignedVarIntToStr(i % 2 ? values[i] : -values[i], &encoded);
+  }
+
+  int64_t sum = 0;
+  std::clock_t start_time = std::clock();
+  Slice slice(encoded);
+  while (!slice.empty()) {
+    int64_t value = 0;
+    int decoded_size = 0;
+    ASSERT_OK(FastDecodeSignedVarInt(slice.data(), slice.size(), &value, &decoded_size));
+    slice.remove_prefix(decoded_size);
+    sum += value;
+  }
+  std::clock_t end_time = std::clock();
+  LOG(INFO) << std::fixed << std::setprecision(2) << "CPU time used: "
+            << 1000.0 * (end_time - start_time) / CLOCKS_PER_SEC << " ms, sum: " << sum << "\n";
+}
+
 TEST(FastVarIntTest, TestSignedPositiveVarIntLength) {
   ASSERT_EQ(1, SignedPositiveVarIntLength(0));
   ASSERT_EQ(1, SignedPositiveVarIntLength(63));
@@ -402,5 +425,30 @@ TEST(FastVarIntTest, EncodeUnsignedPerformance) {
             << 1000.0 * (end_time - start_time) / CLOCKS_PER_SEC << " ms\n";
 }
 
+TEST(FastVarIntTest, DecodeUnsignedPerformance) {
+  const std::vector<uint64_t> values = GenerateRandomValues<uint64_t>();
+  std::string encoded;
+  uint8_t buf[kMaxVarIntBufferSize];
+  for (auto value : values) {
+    size_t encoded_size = 0;
+    FastEncodeUnsignedVarInt(value, buf, &encoded_size);
+    encoded.append(to_char_ptr(buf), encoded_size);
+  }
+
+  uint64_t sum = 0;
+  std::clock_t start_time = std::clock();
+  Slice slice(encoded);
+  while (!slice.empty()) {
+    uint64_t value = 0;
+    size_t decoded_size = 0;
+    ASSERT_OK(FastDecodeUnsignedVarInt(slice.data(), slice.size(), &value, &decoded_size));
+    slice.remove_prefix(decoded_size);
+    sum += value;
+  }
+  std::clock_t end_time = std::clock();
+  LOG(INFO) << std::fixed << std::setprecision(2) << "CPU time used: "
+            << 1000.0 * (end_time - start_time) / CLOCKS_PER_SEC << " ms, sum: " << sum << "\n";
+}
+
 }  // namespace util
 }  // namespace yb
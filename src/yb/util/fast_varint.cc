@@ -13,6 +13,7 @@
 
 #include "yb/util/fast_varint.h"
 
+#include "yb/gutil/endian.h"
 #include "yb/util/bytes_formatter.h"
 #include "yb/util/cast.h"
 #include "yb/util/debug-util.h"
@@ -50,6 +51,21 @@ inline Status NotEnoughEncodedBytes(int decoded_varint_size, int bytes_provided)
       decoded_varint_size, bytes_provided);
 }
 
+// Loads the first n_bytes (1 to 8) bytes of src as a big endian number, with a single load when
+// the buffer is long enough.
+inline uint64_t LoadBigEndianPrefix(const uint8_t* src, size_t src_size, size_t n_bytes) {
+  if (src_size >= sizeof(uint64_t)) {
+    return BigEndian::Load64(src) >> (64 - 8 * n_bytes);
+  }
+  uint64_t result = 0;
+  for (size_t i = 0; i < n_bytes; ++i) {
+    result = (result << 8) | src[i];
+  }
+  return result;
+}
+
+Status DecodeSignedVarIntSlow(const uint8_t* src, int src_size, int64_t* v, int* decoded_size);
+
 }  // anonymous namespace
 
 int SignedPositiveVarIntLength(uint64_t v) {
@@ -157,11 +173,41 @@ std::string FastEncodeSignedVarIntToStr(int64_t v) {
 }
 
 Status FastDecodeSignedVarInt(const uint8_t* src, int src_size, int64_t* v, int* decoded_size) {
-  uint8_t buf[16];
   if (src_size == 0) {
     return STATUS(Corruption, "Cannot decode a variable-length integer of zero size");
   }
 
+  // All bytes of a negative value are complemented.
+  const uint8_t complement = (src[0] & 0x80) ? 0 : 0xff;
+  const uint8_t first_byte = src[0] ^ complement;
+  const int n_bytes = kVarIntSizeTable.varint_size[first_byte];
+  if (src_size < n_bytes) {
+    return NotEnoughEncodedBytes(n_bytes, src_size);
+  }
+  if (n_bytes < 8 || ((src[1] ^ complement) & 0x80) == 0) {
+    // The value of an encoding of up to 8 bytes is in the lower 7 * n_bytes - 1 bits of these
+    // bytes, after the sign bit and the size prefix. So it is decoded with one load and a mask,
+    // instead of byte by byte.
+    uint64_t result = n_bytes == 1 ? src[0] : LoadBigEndianPrefix(src, src_size, n_bytes);
+    if (complement) {
+      result = ~result;
+    }
+    result &= (1ULL << (7 * n_bytes - 1)) - 1;
+    const int64_t signed_result = static_cast<int64_t>(result);
+    *v = complement ? -signed_result : signed_result;
+    *decoded_size = n_bytes;
+    return Status::OK();
+  }
+
+  return DecodeSignedVarIntSlow(src, src_size, v, decoded_size);
+}
+
+namespace {
+
+// Decodes any signed varint byte by byte, used for the encodings of 9 and 10 bytes.
+Status DecodeSignedVarIntSlow(const uint8_t* src, int src_size, int64_t* v, int* decoded_size) {
+  uint8_t buf[16];
+
   const uint8_t* const orig_src = src;
 
   bool negative;
@@ -252,6 +298,8 @@ Status FastDecodeSignedVarInt(const uint8_t* src, int src_size, int64_t* v, int*
   return Status::OK();
 }
 
+}  // anonymous namespace
+
 Status FastDecodeSignedVarInt(const std::string& encoded, int64_t* v, int* decoded_size) {
   return FastDecodeSignedVarInt(to_uchar_ptr(encoded.c_str()), encoded.size(), v, decoded_size);
 }
@@ -319,20 +367,23 @@ CHECKED_STATUS FastDecodeUnsignedVarInt(
     return Status::OK();
   }
 
+  if (n_bytes < 9) {
+    // The value is in the lower 7 * n_bytes bits, after the size prefix.
+    *v = LoadBigEndianPrefix(src, src_size, n_bytes) & ((1ULL << (7 * n_bytes)) - 1);
+    *decoded_size = n_bytes;
+    return Status::OK();
+  }
+
+  // 9 or 10 bytes.
   uint64_t result = 0;
   int i = 0;
-  if (n_bytes == 9) {
-    if (src[1] & 0x80) {
-      n_bytes = 10;
-      result = src[1] & 0x3f;
-      i = 2;
-    }
-    if (src_size < n_bytes) {
-      return NotEnoughEncodedBytes(n_bytes, src_size);
-    }
-  } else {
-    result = src[0] & ((1 << (8 - n_bytes)) - 1);
-    i = 1;
+  if (src[1] & 0x80) {
+    n_bytes = 10;
+    result = src[1] & 0x3f;
+    i = 2;
+  }
+  if (src_size < n_bytes) {
+    return NotEnoughEncodedBytes(n_bytes, src_size);
   }
 
   for (; i < n_bytes; ++i) {
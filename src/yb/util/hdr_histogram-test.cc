@@ -125,4 +125,25 @@ TEST_F(HdrHistogramTest, PercentileAndCopyTest) {
   ASSERT_EQ(hist.TotalSum(), copy.TotalSum());
 }
 
+TEST_F(HdrHistogramTest, MergeTest) {
+  HdrHistogram hist(100000, kSigDigits);
+  HdrHistogram other(100000, kSigDigits);
+  hist.Increment(10);
+  hist.Increment(20);
+  other.Increment(5);
+  other.IncrementBy(1000, 2);
+
+  hist.MergeFrom(other);
+  ASSERT_EQ(5, hist.TotalCount());
+  ASSERT_EQ(2035, hist.TotalSum());
+  ASSERT_EQ(5, hist.MinValue());
+  ASSERT_EQ(1000, hist.MaxValue());
+  ASSERT_EQ(2, hist.CountInBucketForValue(1000));
+
+  // Merging an empty histogram changes nothing.
+  hist.MergeFrom(HdrHistogram(100000, kSigDigits));
+  ASSERT_EQ(5, hist.TotalCount());
+  ASSERT_EQ(5, hist.MinValue());
+}
+
 } // namespace yb
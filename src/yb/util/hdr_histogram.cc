@@ -173,11 +173,15 @@ void HdrHistogram::IncrementBy(int64_t value, int64_t count) {
   NoBarrier_AtomicIncrement(&total_count_, count);
   NoBarrier_AtomicIncrement(&total_sum_, value * count);
 
+  UpdateMinMax(value, value);
+}
+
+void HdrHistogram::UpdateMinMax(int64_t min, int64_t max) {
   // Update min, if needed.
   {
     Atomic64 min_val;
-    while (PREDICT_FALSE(value < (min_val = MinValue()))) {
-      Atomic64 old_val = NoBarrier_CompareAndSwap(&min_value_, min_val, value);
+    while (PREDICT_FALSE(min < (min_val = MinValue()))) {
+      Atomic64 old_val = NoBarrier_CompareAndSwap(&min_value_, min_val, min);
       if (PREDICT_TRUE(old_val == min_val)) break; // CAS success.
     }
   }
@@ -185,13 +189,37 @@ void HdrHistogram::IncrementBy(int64_t value, int64_t count) {
   // Update max, if needed.
   {
     Atomic64 max_val;
-    while (PREDICT_FALSE(value > (max_val = MaxValue()))) {
-      Atomic64 old_val = NoBarrier_CompareAndSwap(&max_value_, max_val, value);
+    while (PREDICT_FALSE(max > (max_val = MaxValue()))) {
+      Atomic64 old_val = NoBarrier_CompareAndSwap(&max_value_, max_val, max);
       if (PREDICT_TRUE(old_val == max_val)) break; // CAS success.
     }
   }
 }
 
+void HdrHistogram::MergeFrom(const HdrHistogram& other) {
+  CHECK_EQ(highest_trackable_value_, other.highest_trackable_value_);
+  CHECK_EQ(num_significant_digits_, other.num_significant_digits_);
+
+  // Same order as the copy constructor: sum and min first, then counts, then max.
+  const Atomic64 other_sum = NoBarrier_Load(&other.total_sum_);
+  const Atomic64 other_min = NoBarrier_Load(&other.min_value_);
+  uint64_t merged_count = 0;
+  for (int i = 0; i < counts_array_length_; i++) {
+    uint64_t count = NoBarrier_Load(&other.counts_[i]);
+    if (count != 0) {
+      NoBarrier_AtomicIncrement(&counts_[i], count);
+      merged_count += count;
+    }
+  }
+  const Atomic64 other_max = NoBarrier_Load(&other.max_value_);
+  if (merged_count == 0) {
+    return;
+  }
+  NoBarrier_AtomicIncrement(&total_count_, merged_count);
+  NoBarrier_AtomicIncrement(&total_sum_, other_sum);
+  UpdateMinMax(other_min, other_max);
+}
+
 void HdrHistogram::IncrementWithExpectedInterval(int64_t value,
                                                  int64_t expected_interval_between_samples) {
   Increment(value);
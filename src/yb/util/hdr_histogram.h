@@ -104,6 +104,10 @@ class HdrHistogram {
   void IncrementWithExpectedInterval(int64_t value,
                                      int64_t expected_interval_between_samples);
 
+  // Adds the values recorded in 'other', which must have the same configuration, to this
+  // histogram. Like copying, this is not a consistent snapshot of 'other'.
+  void MergeFrom(const HdrHistogram& other);
+
   // Fetch configuration params.
   uint64_t highest_trackable_value() const { return highest_trackable_value_; }
   int num_significant_digits() const { return num_significant_digits_; }
@@ -185,6 +189,7 @@ class HdrHistogram {
 
   void Init();
   int CountsArrayIndex(int bucket_index, int sub_bucket_index) const;
+  void UpdateMinMax(int64_t min, int64_t max);
 
   uint64_t highest_trackable_value_;
   int num_significant_digits_;
@@ -34,12 +34,14 @@
 #include <gtest/gtest.h>
 #include <rapidjson/document.h>
 #include <string>
+#include <thread>
 #include <unordered_set>
 #include <vector>
 
 #include "yb/gutil/bind.h"
 #include "yb/gutil/map-util.h"
 #include "yb/util/hdr_histogram.h"
+#include "yb/util/histogram.pb.h"
 #include "yb/util/jsonreader.h"
 #include "yb/util/jsonwriter.h"
 #include "yb/util/metrics.h"
@@ -181,6 +183,33 @@ TEST_F(MetricsTest, SimpleHistogramTest) {
   // TODO: Test coverage needs to be improved a lot.
 }
 
+METRIC_DEFINE_histogram(test_entity, test_striped_hist, "Test Striped Histogram",
+                        MetricUnit::kMilliseconds, "foo", 1000000, 2, STRIPED);
+
+TEST_F(MetricsTest, StripedHistogramTest) {
+  scoped_refptr<Histogram> hist = METRIC_test_striped_hist.Instantiate(entity_);
+  constexpr int kNumThreads = 8;
+  constexpr int kValuesPerThread = 1000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i != kNumThreads; ++i) {
+    threads.emplace_back([hist, i] {
+      for (int j = 1; j <= kValuesPerThread; ++j) {
+        hist->Increment(i * kValuesPerThread + j);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(kNumThreads * kValuesPerThread, hist->TotalCount());
+  ASSERT_EQ(1, hist->MinValueForTests());
+  ASSERT_EQ(kNumThreads * kValuesPerThread, hist->MaxValueForTests());
+
+  HistogramSnapshotPB snapshot;
+  ASSERT_OK(hist->GetHistogramSnapshotPB(&snapshot, MetricJsonOptions()));
+  ASSERT_EQ(kNumThreads * kValuesPerThread, snapshot.total_count());
+}
+
 TEST_F(MetricsTest, JsonPrintTest) {
   scoped_refptr<Counter> bytes_seen = METRIC_reqs_pending.Instantiate(entity_);
   bytes_seen->Increment();
@@ -218,6 +247,45 @@ TEST_F(MetricsTest, JsonPrintTest) {
 }
 
 // Test that metrics are retired when they are no longer referenced.
+METRIC_DEFINE_counter(server, test_prometheus_requests, "Test Requests",
+                      MetricUnit::kRequests, "Test counter exported to Prometheus");
+METRIC_DEFINE_gauge_uint64(server, test_prometheus_gauge, "Test Gauge", MetricUnit::kBytes,
+                           "Test gauge exported to Prometheus");
+
+TEST_F(MetricsTest, PrometheusOptionsTest) {
+  scoped_refptr<MetricEntity> server = METRIC_ENTITY_server.Instantiate(&registry_, "my-server");
+  scoped_refptr<Counter> requests = METRIC_test_prometheus_requests.Instantiate(server);
+  scoped_refptr<AtomicGauge<uint64_t>> gauge = METRIC_test_prometheus_gauge.Instantiate(server, 5);
+  requests->Increment();
+
+  auto write = [this](const MetricPrometheusOptions& opts) {
+    std::stringstream output;
+    PrometheusWriter writer(&output, opts);
+    CHECK_OK(registry_.WriteForPrometheus(&writer));
+    return output.str();
+  };
+
+  MetricPrometheusOptions opts;
+  string out = write(opts);
+  ASSERT_STR_CONTAINS(out, "test_prometheus_requests{");
+  ASSERT_STR_CONTAINS(out, "test_prometheus_gauge{");
+
+  opts.requested_metrics = {"requests"};
+  out = write(opts);
+  ASSERT_STR_CONTAINS(out, "test_prometheus_requests{");
+  ASSERT_EQ(string::npos, out.find("test_prometheus_gauge{"));
+
+  opts.entity_types = {"tablet"};
+  ASSERT_EQ(string::npos, write(opts).find("test_prometheus_requests{"));
+
+  opts.entity_types.clear();
+  opts.skip_unchanged_counters = true;
+  ASSERT_STR_CONTAINS(write(opts), "test_prometheus_requests{");
+  ASSERT_EQ(string::npos, write(opts).find("test_prometheus_requests{"));
+  requests->Increment();
+  ASSERT_STR_CONTAINS(write(opts), "test_prometheus_requests{");
+}
+
 TEST_F(MetricsTest, RetirementTest) {
   FLAGS_metrics_retirement_age_ms = 100;
 
@@ -32,6 +32,7 @@
 #include "yb/util/metrics.h"
 
 #include <iostream>
+#include <limits>
 #include <map>
 #include <set>
 
@@ -43,6 +44,7 @@
 #include "yb/gutil/singleton.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/sysinfo.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/hdr_histogram.h"
 #include "yb/util/histogram.pb.h"
@@ -60,6 +62,11 @@ TAG_FLAG(metrics_retirement_age_ms, advanced);
 DEFINE_string(metric_node_name, "DEFAULT_NODE_NAME",
               "Value to use as node name for metrics reporting");
 
+DEFINE_int32(max_histogram_stripes, 16,
+             "Maximum number of stripes of the histograms defined as STRIPED. They get one stripe "
+             "per CPU, up to this number.");
+TAG_FLAG(max_histogram_stripes, advanced);
+
 // Process/server-wide metrics should go into the 'server' entity.
 // More complex applications will define other entities.
 METRIC_DEFINE_entity(server);
@@ -278,6 +285,10 @@ Status MetricEntity::WriteAsJson(JsonWriter* writer,
 }
 
 CHECKED_STATUS MetricEntity::WriteForPrometheus(PrometheusWriter* writer) const {
+  if (!writer->IsEntityTypeRequested(prototype_->name())) {
+    return Status::OK();
+  }
+
   // We want the keys to be in alphabetical order when printing, so we use an ordered map here.
   typedef std::map<const char*, scoped_refptr<Metric> > OrderedMetricMap;
   OrderedMetricMap metrics;
@@ -293,7 +304,9 @@ CHECKED_STATUS MetricEntity::WriteForPrometheus(PrometheusWriter* writer) const
       const MetricPrototype* prototype = val.first;
       const scoped_refptr<Metric>& metric = val.second;
 
-      InsertOrDie(&metrics, prototype->name(), metric);
+      if (MatchMetricInList(prototype->name(), writer->options().requested_metrics)) {
+        InsertOrDie(&metrics, prototype->name(), metric);
+      }
     }
   }
   AttributeMap prometheus_attr;
@@ -431,9 +444,13 @@ CHECKED_STATUS MetricRegistry::WriteForPrometheus(PrometheusWriter* writer) cons
     entities = entities_;
   }
 
-  for (const EntityMap::value_type e : entities) {
-    WARN_NOT_OK(e.second->WriteForPrometheus(writer),
-                Substitute("Failed to write entity $0 as Prometheus", e.second->id()));
+  for (const EntityMap::value_type& e : entities) {
+    Status s = e.second->WriteForPrometheus(writer);
+    if (PREDICT_FALSE(!s.ok())) {
+      // The output went away, e.g. the scraper disconnected, no point in going on.
+      RETURN_NOT_OK(writer->status());
+      WARN_NOT_OK(s, Substitute("Failed to write entity $0 as Prometheus", e.second->id()));
+    }
   }
   RETURN_NOT_OK(writer->FlushAggregatedValues());
 
@@ -676,7 +693,30 @@ Status Counter::WriteAsJson(JsonWriter* writer,
 
 CHECKED_STATUS Counter::WriteForPrometheus(
     PrometheusWriter* writer, const MetricEntity::AttributeMap& attr) const {
-  return writer->WriteSingleEntry(attr, prototype_->name(), value());
+  const int64_t current = value();
+  bool changed = true;
+  if (writer->options().skip_unchanged_counters) {
+    changed = last_exported_value_.exchange(current, std::memory_order_relaxed) != current;
+  }
+  return writer->WriteSingleEntry(attr, prototype_->name(), current, changed);
+}
+
+//
+// PrometheusWriter
+//
+
+bool PrometheusWriter::IsEntityTypeRequested(const char* entity_type) const {
+  return opts_.entity_types.empty() ||
+         std::find(opts_.entity_types.begin(), opts_.entity_types.end(), entity_type) !=
+             opts_.entity_types.end();
+}
+
+bool PrometheusWriter::IsMetricRequested(const std::string& name) const {
+  return MatchMetricInList(name, opts_.requested_metrics);
+}
+
+Status PrometheusWriter::status() const {
+  return output_->good() ? Status::OK() : STATUS(IOError, "Failed to write Prometheus metrics");
 }
 
 
@@ -707,17 +747,82 @@ scoped_refptr<Histogram> HistogramPrototype::Instantiate(
 // Histogram
 /////////////////////////////////////////////////
 
+namespace {
+
+size_t NumHistogramStripes(const HistogramPrototype* proto) {
+  if (!(proto->flags() & STRIPED)) {
+    return 1;
+  }
+  const int max_stripes = std::max(FLAGS_max_histogram_stripes, 1);
+  size_t result = 1;
+  while (result < std::min(base::NumCPUs(), max_stripes)) {
+    result <<= 1;
+  }
+  return result;
+}
+
+// Index of the stripe of the current thread, assigned round-robin so that concurrently running
+// threads likely get different stripes.
+size_t CurrentStripeHint() {
+  static std::atomic<size_t> next_hint{0};
+  static __thread size_t hint = std::numeric_limits<size_t>::max();
+  if (PREDICT_FALSE(hint == std::numeric_limits<size_t>::max())) {
+    hint = next_hint.fetch_add(1, std::memory_order_relaxed);
+  }
+  return hint;
+}
+
+} // namespace
+
 Histogram::Histogram(const HistogramPrototype* proto)
   : Metric(proto),
-    histogram_(new HdrHistogram(proto->max_trackable_value(), proto->num_sig_digits())) {
+    histogram_(new HdrHistogram(proto->max_trackable_value(), proto->num_sig_digits())),
+    num_stripes_(NumHistogramStripes(proto)) {
+  if (num_stripes_ > 1) {
+    stripes_.reset(new std::atomic<HdrHistogram*>[num_stripes_ - 1]());
+  }
+}
+
+Histogram::~Histogram() {
+  for (size_t i = 0; i + 1 < num_stripes_; ++i) {
+    delete stripes_[i].load(std::memory_order_acquire);
+  }
+}
+
+HdrHistogram* Histogram::RecordingHistogram() {
+  const size_t index = num_stripes_ > 1 ? CurrentStripeHint() & (num_stripes_ - 1) : 0;
+  if (index == 0) {
+    return histogram_.get();
+  }
+  auto& stripe = stripes_[index - 1];
+  HdrHistogram* result = stripe.load(std::memory_order_acquire);
+  if (PREDICT_FALSE(result == nullptr)) {
+    std::unique_ptr<HdrHistogram> created(new HdrHistogram(
+        histogram_->highest_trackable_value(), histogram_->num_significant_digits()));
+    if (stripe.compare_exchange_strong(result, created.get(), std::memory_order_acq_rel)) {
+      result = created.release();
+    }
+  }
+  return result;
+}
+
+std::unique_ptr<HdrHistogram> Histogram::Snapshot() const {
+  std::unique_ptr<HdrHistogram> result(new HdrHistogram(*histogram_));
+  for (size_t i = 0; i + 1 < num_stripes_; ++i) {
+    const HdrHistogram* stripe = stripes_[i].load(std::memory_order_acquire);
+    if (stripe != nullptr) {
+      result->MergeFrom(*stripe);
+    }
+  }
+  return result;
 }
 
 void Histogram::Increment(int64_t value) {
-  histogram_->Increment(value);
+  RecordingHistogram()->Increment(value);
 }
 
 void Histogram::IncrementBy(int64_t value, int64_t amount) {
-  histogram_->IncrementBy(value, amount);
+  RecordingHistogram()->IncrementBy(value, amount);
 }
 
 Status Histogram::WriteAsJson(JsonWriter* writer,
@@ -731,7 +836,8 @@ Status Histogram::WriteAsJson(JsonWriter* writer,
 
 CHECKED_STATUS Histogram::WriteForPrometheus(
     PrometheusWriter* writer, const MetricEntity::AttributeMap& attr) const {
-  HdrHistogram snapshot(*histogram_);
+  const auto snapshot_holder = Snapshot();
+  const HdrHistogram& snapshot = *snapshot_holder;
 
   // Representing the sum and count require suffixed names.
   std::string hist_name = prototype_->name();
@@ -764,7 +870,8 @@ CHECKED_STATUS Histogram::WriteForPrometheus(
 
 Status Histogram::GetHistogramSnapshotPB(HistogramSnapshotPB* snapshot_pb,
                                          const MetricJsonOptions& opts) const {
-  HdrHistogram snapshot(*histogram_);
+  const auto snapshot_holder = Snapshot();
+  const HdrHistogram& snapshot = *snapshot_holder;
   snapshot_pb->set_name(prototype_->name());
   if (opts.include_schema_info) {
     snapshot_pb->set_type(MetricType::Name(prototype_->type()));
@@ -798,22 +905,29 @@ Status Histogram::GetHistogramSnapshotPB(HistogramSnapshotPB* snapshot_pb,
 }
 
 uint64_t Histogram::CountInBucketForValueForTests(uint64_t value) const {
-  return histogram_->CountInBucketForValue(value);
+  return Snapshot()->CountInBucketForValue(value);
 }
 
 uint64_t Histogram::TotalCount() const {
-  return histogram_->TotalCount();
+  uint64_t result = histogram_->TotalCount();
+  for (size_t i = 0; i + 1 < num_stripes_; ++i) {
+    const HdrHistogram* stripe = stripes_[i].load(std::memory_order_acquire);
+    if (stripe != nullptr) {
+      result += stripe->TotalCount();
+    }
+  }
+  return result;
 }
 
 uint64_t Histogram::MinValueForTests() const {
-  return histogram_->MinValue();
+  return Snapshot()->MinValue();
 }
 
 uint64_t Histogram::MaxValueForTests() const {
-  return histogram_->MaxValue();
+  return Snapshot()->MaxValue();
 }
 double Histogram::MeanValueForTests() const {
-  return histogram_->MeanValue();
+  return Snapshot()->MeanValue();
 }
 
 ScopedLatencyMetric::ScopedLatencyMetric(Histogram* latency_hist)
@@ -239,7 +239,10 @@
 /////////////////////////////////////////////////////
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include <mutex>
+#include <ostream>
 #include <string>
 #include <sstream>
 #include <unordered_map>
@@ -303,13 +306,14 @@
 #define METRIC_DEFINE_gauge_double(entity, name, label, unit, desc, ...) \
     METRIC_DEFINE_gauge(double, entity, name, label, unit, desc, ## __VA_ARGS__)
 
-#define METRIC_DEFINE_histogram(entity, name, label, unit, desc, max_val, num_sig_digits) \
+#define METRIC_DEFINE_histogram(entity, name, label, unit, desc, max_val, num_sig_digits, ...) \
   ::yb::HistogramPrototype BOOST_PP_CAT(METRIC_, name)(                                   \
       ::yb::MetricPrototype::CtorArgs(BOOST_PP_STRINGIZE(entity), \
                                       BOOST_PP_STRINGIZE(name), \
                                       label, \
                                       unit, \
-                                      desc), \
+                                      desc, \
+                                      ## __VA_ARGS__), \
       max_val, \
       num_sig_digits)
 
@@ -440,6 +444,19 @@ struct MetricJsonOptions {
   bool include_schema_info;
 };
 
+struct MetricPrometheusOptions {
+  // Types of the entities to export, e.g. "tablet" or "server". Empty means all of them.
+  std::vector<std::string> entity_types;
+
+  // Only the metrics whose name contains one of these are exported, "*" matches all of them.
+  std::vector<std::string> requested_metrics = {"*"};
+
+  // Omit the counters that did not change since the previous export with this option set.
+  // Each counter remembers the value it was last exported with, so this is meant for a single
+  // scraper.
+  bool skip_unchanged_counters = false;
+};
+
 class MetricEntityPrototype {
  public:
   explicit MetricEntityPrototype(const char* name);
@@ -572,27 +589,37 @@ class MetricEntity : public RefCountedThreadSafe<MetricEntity> {
 
 typedef scoped_refptr<MetricEntity> MetricEntityPtr;
 
+// Writes metrics in the Prometheus text format. Entries are written to the output as they come,
+// except for the tablet ones, which are summed up per table until FlushAggregatedValues().
 class PrometheusWriter {
  public:
-  explicit PrometheusWriter(std::stringstream* output)
+  explicit PrometheusWriter(std::ostream* output,
+                            const MetricPrometheusOptions& opts = MetricPrometheusOptions())
     : output_(output),
+      opts_(opts),
       timestamp_(std::chrono::duration_cast<std::chrono::milliseconds>(
           std::chrono::system_clock::now().time_since_epoch()).count()) {}
 
+  // 'changed' is false for a counter that did not change since it was last exported, see
+  // MetricPrometheusOptions::skip_unchanged_counters.
   template<typename T>
   CHECKED_STATUS WriteSingleEntry(
-      const MetricEntity::AttributeMap& attr, const std::string& name, const T& value) {
+      const MetricEntity::AttributeMap& attr, const std::string& name, const T& value,
+      bool changed = true) {
+    if (!IsMetricRequested(name)) {
+      return Status::OK();
+    }
     auto it = attr.find("table_id");
     if (it != attr.end()) {
       // For tablet level metrics, we roll up on the table level.
       if (per_table_attributes_.find(it->second) == per_table_attributes_.end()) {
         // If it's the first time we see this table, create the aggregate structures.
         per_table_attributes_[it->second] = attr;
-        per_table_values_[it->second];
-      } else {
-        per_table_values_[it->second][name] += value;
       }
-    } else {
+      auto& aggregated = per_table_values_[it->second][name];
+      aggregated.value += value;
+      aggregated.changed = aggregated.changed || changed;
+    } else if (changed) {
       // For non-tablet level metrics, export them directly.
       RETURN_NOT_OK(FlushSingleEntry(attr, name, value));
     }
@@ -603,12 +630,23 @@ class PrometheusWriter {
     for (const auto& entry : per_table_values_) {
       const auto& attrs = per_table_attributes_[entry.first];
       for (const auto& metric_entry : entry.second) {
-        RETURN_NOT_OK(FlushSingleEntry(attrs, metric_entry.first, metric_entry.second));
+        // A table value is unchanged only when all of its tablet counters are.
+        if (metric_entry.second.changed) {
+          RETURN_NOT_OK(FlushSingleEntry(attrs, metric_entry.first, metric_entry.second.value));
+        }
       }
     }
     return Status::OK();
   }
 
+  const MetricPrometheusOptions& options() const { return opts_; }
+
+  bool IsEntityTypeRequested(const char* entity_type) const;
+  bool IsMetricRequested(const std::string& name) const;
+
+  // Returns an error once writing to the output failed, e.g. because the client went away.
+  CHECKED_STATUS status() const;
+
  private:
   template<typename T>
   CHECKED_STATUS FlushSingleEntry(
@@ -627,16 +665,23 @@ class PrometheusWriter {
     }
     *output_ << " " << value;
     *output_ << " " << timestamp_;
-    *output_ << std::endl;
-    return Status::OK();
+    // Not std::endl: flushing every entry would send tiny chunks when streaming.
+    *output_ << '\n';
+    return status();
   }
 
+  struct AggregatedValue {
+    double value = 0;
+    bool changed = false;
+  };
+
   // Map from table_id to attributes
   std::map<std::string, MetricEntity::AttributeMap> per_table_attributes_;
   // Map from table_id to map of metric_name to value
-  std::map<std::string, std::map<std::string, double>> per_table_values_;
+  std::map<std::string, std::map<std::string, AggregatedValue>> per_table_values_;
   // Output stream
-  std::stringstream* output_;
+  std::ostream* output_;
+  const MetricPrometheusOptions opts_;
   // Timestamp for all metrics belonging to this writer instance.
   int64_t timestamp_;
 };
@@ -768,7 +813,13 @@ class MetricPrototypeRegistry {
 enum PrototypeFlags {
   // Flag which causes a Gauge prototype to expose itself as if it
   // were a counter.
-  EXPOSE_AS_COUNTER = 1 << 0
+  EXPOSE_AS_COUNTER = 1 << 0,
+
+  // Flag which makes a Histogram record into per-thread stripes that are merged when it is
+  // read, so that threads on different cores do not contend on the same buckets. Meant for
+  // server level histograms updated on every request. Each stripe is a full copy of the
+  // buckets, allocated the first time a thread records into it.
+  STRIPED = 1 << 1,
 };
 
 class MetricPrototype {
@@ -803,6 +854,7 @@ class MetricPrototype {
   const char* label() const { return args_.label_; }
   MetricUnit::Type unit() const { return args_.unit_; }
   const char* description() const { return args_.description_; }
+  uint32_t flags() const { return args_.flags_; }
   virtual MetricType::Type type() const = 0;
 
   // Writes the fields of this prototype to the given JSON writer.
@@ -1093,6 +1145,10 @@ class Counter : public Metric {
   explicit Counter(const CounterPrototype* proto);
 
   LongAdder value_;
+
+  // The value this counter was last exported to Prometheus with, when skipping unchanged
+  // counters.
+  mutable std::atomic<int64_t> last_exported_value_{-1};
   DISALLOW_COPY_AND_ASSIGN(Counter);
 };
 
@@ -1145,8 +1201,21 @@ class Histogram : public Metric {
   FRIEND_TEST(MetricsTest, SimpleHistogramTest);
   friend class MetricEntity;
   explicit Histogram(const HistogramPrototype* proto);
+  ~Histogram();
+
+  // Returns the histogram the current thread records into.
+  HdrHistogram* RecordingHistogram();
+
+  // Returns a snapshot of the histogram, with all the stripes merged.
+  std::unique_ptr<HdrHistogram> Snapshot() const;
 
+  // The first stripe, the only one unless the prototype is STRIPED.
   const gscoped_ptr<HdrHistogram> histogram_;
+
+  // The other stripes of a STRIPED histogram, allocated on first use.
+  const size_t num_stripes_;
+  std::unique_ptr<std::atomic<HdrHistogram*>[]> stripes_;
+
   DISALLOW_COPY_AND_ASSIGN(Histogram);
 };
 
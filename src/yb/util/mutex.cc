@@ -35,8 +35,10 @@
 
 #include <glog/logging.h>
 
+#include "yb/gutil/walltime.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/env.h"
+#include "yb/util/spinlock_profiling.h"
 
 namespace yb {
 
@@ -82,7 +84,13 @@ bool Mutex::TryAcquire() {
 }
 
 void Mutex::Acquire() {
-  int rv = pthread_mutex_lock(&native_handle_);
+  // Only a contended acquisition reads the clock, to report the wait to the contention profiler.
+  int rv = pthread_mutex_trylock(&native_handle_);
+  if (PREDICT_FALSE(rv == EBUSY)) {
+    const int64_t wait_start = CycleClock::Now();
+    rv = pthread_mutex_lock(&native_handle_);
+    SubmitLockContention(this, CycleClock::Now() - wait_start);
+  }
 #ifndef NDEBUG
   DCHECK_EQ(0, rv) << ". " << strerror(rv)
       << ". Owner tid: " << owning_tid_ << "; Self tid: " << Env::Default()->gettid()
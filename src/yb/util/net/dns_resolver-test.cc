@@ -67,4 +67,37 @@ TEST_F(DnsResolverTest, TestResolution) {
   }
 }
 
+namespace {
+
+void SetStatus(bool* done, Status* out, const Status& status) {
+  *out = status;
+  *done = true;
+}
+
+} // namespace
+
+TEST_F(DnsResolverTest, TestCachedResolution) {
+  for (const auto& host : {"localhost", "nonexistent.invalid"}) {
+    vector<Endpoint> addrs;
+    Synchronizer s;
+    resolver_.ResolveAddresses(HostPort(host, 12345), &addrs, s.AsStatusCallback());
+    Status first = s.Wait();
+
+    // The next lookup of the same host is served from the cache, on the caller's thread.
+    vector<Endpoint> cached_addrs;
+    bool done = false;
+    Status cached;
+    DnsResolver other_resolver;
+    other_resolver.ResolveAddresses(
+        HostPort(host, 23456), &cached_addrs, Bind(&SetStatus, &done, &cached));
+    ASSERT_TRUE(done) << host;
+    ASSERT_EQ(first.ok(), cached.ok()) << host << ": " << first << " vs " << cached;
+    ASSERT_EQ(addrs.size(), cached_addrs.size());
+    for (size_t i = 0; i != addrs.size(); ++i) {
+      ASSERT_EQ(addrs[i].address(), cached_addrs[i].address());
+      ASSERT_EQ(23456, cached_addrs[i].port());
+    }
+  }
+}
+
 } // namespace yb
@@ -32,23 +32,163 @@
 
 #include "yb/util/net/dns_resolver.h"
 
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
 #include "yb/util/flag_tags.h"
+#include "yb/util/monotime.h"
 #include "yb/util/threadpool.h"
 #include "yb/util/net/net_util.h"
 #include "yb/util/net/sockaddr.h"
 
+using namespace std::literals;
+
 DEFINE_int32(dns_num_resolver_threads, 1, "The number of threads to use for DNS resolution");
 TAG_FLAG(dns_num_resolver_threads, advanced);
 
+DEFINE_int32(dns_cache_ttl_ms, 60000,
+             "How long DnsResolver keeps resolved addresses of a host. Once half of this time has "
+             "passed since the resolution, a lookup of the host refreshes them in background. "
+             "0 disables the cache.");
+TAG_FLAG(dns_cache_ttl_ms, advanced);
+TAG_FLAG(dns_cache_ttl_ms, runtime);
+
+DEFINE_int32(dns_cache_negative_ttl_ms, 1000,
+             "How long DnsResolver keeps a failure to resolve a host.");
+TAG_FLAG(dns_cache_negative_ttl_ms, advanced);
+TAG_FLAG(dns_cache_negative_ttl_ms, runtime);
+
 using std::vector;
 
 namespace yb {
 
+namespace {
+
+// Resolution results of hosts, shared by all resolvers of the process. getaddrinfo() does not
+// provide record TTLs, so entries live for --dns_cache_ttl_ms.
+class DnsCache {
+ public:
+  // Looks up a live entry for the host and fills 'addresses' with the port of 'hostport'.
+  // Returns false if there is no such entry. Sets 'refresh' when the caller should refresh the
+  // entry in background, only one caller gets it.
+  bool Lookup(const HostPort& hostport, std::vector<Endpoint>* addresses, Status* status,
+              bool* refresh) {
+    const auto now = CoarseMonoClock::Now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(hostport.host());
+    if (it == entries_.end() || it->second.expiration <= now) {
+      return false;
+    }
+    auto& entry = it->second;
+    *status = entry.status;
+    if (addresses && entry.status.ok()) {
+      for (auto endpoint : entry.addresses) {
+        endpoint.port(hostport.port());
+        addresses->push_back(endpoint);
+      }
+    }
+    *refresh = entry.status.ok() && !entry.refreshing && entry.refresh_time <= now;
+    if (*refresh) {
+      entry.refreshing = true;
+    }
+    return true;
+  }
+
+  void Update(const std::string& host, const Status& status,
+              const std::vector<Endpoint>& addresses) {
+    const auto now = CoarseMonoClock::Now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entry = entries_[host];
+    entry.status = status;
+    entry.addresses = addresses;
+    entry.refreshing = false;
+    if (status.ok()) {
+      const auto ttl = FLAGS_dns_cache_ttl_ms * 1ms;
+      entry.expiration = now + ttl;
+      entry.refresh_time = now + ttl / 2;
+    } else {
+      entry.expiration = now + FLAGS_dns_cache_negative_ttl_ms * 1ms;
+      entry.refresh_time = entry.expiration;
+    }
+  }
+
+  // Called when a refresh could not be started, so a later lookup could try again.
+  void RefreshFailed(const std::string& host) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(host);
+    if (it != entries_.end()) {
+      it->second.refreshing = false;
+    }
+  }
+
+ private:
+  struct Entry {
+    Status status;
+    std::vector<Endpoint> addresses;
+    CoarseMonoClock::TimePoint expiration;
+    CoarseMonoClock::TimePoint refresh_time;
+    bool refreshing = false;
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+};
+
+DnsCache& dns_cache() {
+  // Never destroyed, so resolution threads could still use it during process shutdown.
+  static DnsCache* cache = new DnsCache();
+  return *cache;
+}
+
+bool CacheEnabled() {
+  return FLAGS_dns_cache_ttl_ms > 0;
+}
+
+// Resolves the host and stores the result in the cache.
+Status ResolveAndCache(const HostPort& hostport, std::vector<Endpoint>* addresses) {
+  std::vector<Endpoint> resolved;
+  Status status = HostPort(hostport.host(), 0).ResolveAddresses(&resolved);
+  if (CacheEnabled()) {
+    dns_cache().Update(hostport.host(), status, resolved);
+  }
+  if (status.ok() && addresses) {
+    for (auto& endpoint : resolved) {
+      endpoint.port(hostport.port());
+      addresses->push_back(endpoint);
+    }
+  }
+  return status;
+}
+
+void DoRefresh(const HostPort& hostport) {
+  WARN_NOT_OK(ResolveAndCache(hostport, nullptr), "Failed to refresh addresses");
+}
+
+void DoResolution(const HostPort &hostport,
+                  std::vector<Endpoint>* addresses,
+                  StatusCallback cb) {
+  if (CacheEnabled()) {
+    // Another resolution of the same host could have completed while this one was queued.
+    Status status;
+    bool refresh = false;
+    if (dns_cache().Lookup(hostport, addresses, &status, &refresh)) {
+      cb.Run(status);
+      if (refresh) {
+        DoRefresh(hostport);
+      }
+      return;
+    }
+  }
+  cb.Run(ResolveAndCache(hostport, addresses));
+}
+
+} // namespace
+
 DnsResolver::DnsResolver() {
   CHECK_OK(ThreadPoolBuilder("dns-resolver")
            .set_max_threads(FLAGS_dns_num_resolver_threads)
@@ -59,17 +199,24 @@ DnsResolver::~DnsResolver() {
   pool_->Shutdown();
 }
 
-namespace {
-static void DoResolution(const HostPort &hostport,
-                         std::vector<Endpoint>* addresses,
-                         StatusCallback cb) {
-  cb.Run(hostport.ResolveAddresses(addresses));
-}
-} // anonymous namespace
-
 void DnsResolver::ResolveAddresses(const HostPort& hostport,
                                    std::vector<Endpoint>* addresses,
                                    const StatusCallback& cb) {
+  if (CacheEnabled()) {
+    Status status;
+    bool refresh = false;
+    if (dns_cache().Lookup(hostport, addresses, &status, &refresh)) {
+      if (refresh) {
+        Status s = pool_->SubmitFunc(std::bind(&DoRefresh, hostport));
+        if (!s.ok()) {
+          dns_cache().RefreshFailed(hostport.host());
+        }
+      }
+      cb.Run(status);
+      return;
+    }
+  }
+
   Status s = pool_->SubmitFunc(std::bind(&DoResolution, hostport, addresses, cb));
   if (!s.ok()) {
     cb.Run(s);
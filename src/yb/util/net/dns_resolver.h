@@ -46,6 +46,10 @@ class HostPort;
 class ThreadPool;
 
 // DNS Resolver which supports async address resolution.
+//
+// Results, including failures, are kept in a process-wide cache shared by all resolvers, see
+// --dns_cache_ttl_ms. Cached addresses are refreshed in background before they expire, so hosts
+// that are used regularly are not resolved while serving requests.
 class DnsResolver {
  public:
   DnsResolver();
@@ -62,7 +66,7 @@ class DnsResolver {
   //
   // NOTE: the callback should be fast since it is called by the DNS
   // resolution thread.
-  // NOTE: in some rare cases, the callback may also be called inline
+  // NOTE: when the result is cached, the callback is called inline
   // from this function call, on the caller's thread.
   void ResolveAddresses(const HostPort& hostport,
                         std::vector<Endpoint>* addresses,
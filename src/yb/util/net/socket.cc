@@ -265,6 +265,17 @@ Status Socket::SetReuseAddr(bool flag) {
   return Status::OK();
 }
 
+Status Socket::SetReusePort(bool flag) {
+  int err;
+  int int_flag = flag ? 1 : 0;
+  if (setsockopt(fd_, SOL_SOCKET, SO_REUSEPORT, &int_flag, sizeof(int_flag)) == -1) {
+    err = errno;
+    return STATUS(NetworkError, std::string("failed to set SO_REUSEPORT: ") +
+                                ErrnoToString(err), Slice(), err);
+  }
+  return Status::OK();
+}
+
 Status Socket::BindAndListen(const Endpoint& sockaddr,
                              int listenQueueSize) {
   RETURN_NOT_OK(SetReuseAddr(true));
@@ -98,6 +98,10 @@ class Socket {
   // Sets SO_REUSEADDR to 'flag'. Should be used prior to Bind().
   CHECKED_STATUS SetReuseAddr(bool flag);
 
+  // Sets SO_REUSEPORT to 'flag', so several sockets could listen on the same endpoint. Should be
+  // used prior to Bind().
+  CHECKED_STATUS SetReusePort(bool flag);
+
   // Convenience method to invoke the common sequence:
   // 1) SetReuseAddr(true)
   // 2) Bind()
@@ -32,6 +32,9 @@
 
 #include "yb/util/os-util.h"
 
+#include <sys/syscall.h>
+#include <unistd.h>
+
 #include <gtest/gtest.h>
 
 #include "yb/gutil/strings/substitute.h"
@@ -54,6 +57,7 @@ void RunTest(const string& name, int user_ticks, int kernel_ticks, int io_wait)
   string extracted_name;
   ASSERT_OK(ParseStat(buf, &extracted_name, &stats));
   ASSERT_EQ(name, extracted_name);
+  ASSERT_EQ('S', stats.state);
   ASSERT_EQ(user_ticks * (1e9 / sysconf(_SC_CLK_TCK)), stats.user_ns);
   ASSERT_EQ(kernel_ticks * (1e9 / sysconf(_SC_CLK_TCK)), stats.kernel_ns);
   ASSERT_EQ(io_wait * (1e9 / sysconf(_SC_CLK_TCK)), stats.iowait_ns);
@@ -71,4 +75,14 @@ TEST(OsUtilTest, TestSelfNameWithParens) {
   RunTest("a(b(c((d))e)", 111, 222, 333);
 }
 
+#if defined(__linux__)
+TEST(OsUtilTest, TestCurrentThreadStats) {
+  ThreadStats stats;
+  string name;
+  ASSERT_OK(GetThreadStats(syscall(SYS_gettid), &stats, &name));
+  ASSERT_FALSE(name.empty());
+  ASSERT_GE(stats.user_ns, 0);
+}
+#endif // defined(__linux__)
+
 } // namespace yb
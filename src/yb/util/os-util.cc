@@ -69,6 +69,7 @@ static const int64_t TICKS_PER_SEC = sysconf(_SC_CLK_TCK);
 //
 // They are themselves offset by two because the pid and comm fields of the
 // file are parsed separately.
+static const int64_t STATE = 2 - 2;
 static const int64_t USER_TICKS = 13 - 2;
 static const int64_t KERNEL_TICKS = 14 - 2;
 static const int64_t IO_WAIT = 41 - 2;
@@ -96,6 +97,9 @@ Status ParseStat(const std::string& buffer, std::string* name, ThreadStats* stat
     return STATUS(IOError, "Unrecognised /proc format");
   }
 
+  if (!splits[STATE].empty()) {
+    stats->state = splits[STATE][0];
+  }
   int64 tmp;
   if (safe_strto64(splits[USER_TICKS], &tmp)) {
     stats->user_ns = tmp * (1e9 / TICKS_PER_SEC);
@@ -113,7 +117,7 @@ Status ParseStat(const std::string& buffer, std::string* name, ThreadStats* stat
 
 }
 
-Status GetThreadStats(int64_t tid, ThreadStats* stats) {
+Status GetThreadStats(int64_t tid, ThreadStats* stats, std::string* name) {
   DCHECK(stats != nullptr);
   if (TICKS_PER_SEC <= 0) {
     return STATUS(NotSupported, "ThreadStats not supported");
@@ -129,7 +133,7 @@ Status GetThreadStats(int64_t tid, ThreadStats* stats) {
   string buffer((istreambuf_iterator<char>(proc_file)),
       istreambuf_iterator<char>());
 
-  return ParseStat(buffer, nullptr, stats); // don't want the name
+  return ParseStat(buffer, name, stats);
 }
 
 bool RunShellProcess(const string& cmd, string* msg) {
@@ -52,9 +52,13 @@ struct ThreadStats {
   int64_t kernel_ns;
   int64_t iowait_ns;
 
+  // Scheduling state of the thread, e.g. 'R' while it is running or runnable and 'S' while it is
+  // sleeping.
+  char state;
+
   // Default constructor zeroes all members in case structure can't be filled by
   // GetThreadStats.
-  ThreadStats() : user_ns(0), kernel_ns(0), iowait_ns(0) { }
+  ThreadStats() : user_ns(0), kernel_ns(0), iowait_ns(0), state('\0') { }
 };
 
 // Populates ThreadStats object using a given buffer. The buffer is expected to
@@ -66,7 +70,9 @@ Status ParseStat(const std::string&buffer, std::string* name, ThreadStats* stats
 // Populates ThreadStats object for a given thread by reading from
 // /proc/<pid>/task/<tid>/stat. Returns OK unless the file cannot be read or is in an
 // unrecognised format, or if the kernel version is not modern enough.
-Status GetThreadStats(int64_t tid, ThreadStats* stats);
+// Retrieves the CPU statistics of the thread 'tid' of this process from /proc. If 'name' is not
+// null, it is set to the name of the thread.
+Status GetThreadStats(int64_t tid, ThreadStats* stats, std::string* name = nullptr);
 
 // Runs a shell command. Returns false if there was any error (either failure to launch or
 // non-0 exit code), and true otherwise. *msg is set to an error message including the OS
@@ -38,7 +38,9 @@
 #include "yb/gutil/atomicops.h"
 #include "yb/gutil/macros.h"
 #include "yb/gutil/port.h"
+#include "yb/gutil/walltime.h"
 #include "yb/util/debug-util.h"
+#include "yb/util/spinlock_profiling.h"
 
 #include "yb/util/thread.h"
 
@@ -64,6 +66,9 @@ namespace yb {
 //   #define RW_SEMAPHORE_TRACK_HOLDER 1
 // ... and then in gdb, print the contents of the semaphore, and you should
 // see the collected stack trace.
+//
+// Time spent spinning for the lock is reported to the contention profiler, see
+// SubmitLockContention().
 class rw_semaphore {
  public:
   rw_semaphore() : state_(0) {
@@ -72,6 +77,7 @@ class rw_semaphore {
 
   void lock_shared() {
     int loop_count = 0;
+    int64_t wait_start = 0;
     Atomic32 cur_state = base::subtle::NoBarrier_Load(&state_);
     while (true) {
       Atomic32 expected = cur_state & kNumReadersMask;   // I expect no write lock
@@ -80,8 +86,10 @@ class rw_semaphore {
       if (cur_state == expected)
         break;
       // Either was already locked by someone else, or CAS failed.
+      StartWait(&wait_start);
       boost::detail::yield(loop_count++);
     }
+    FinishWait(wait_start);
   }
 
   void unlock_shared() {
@@ -119,13 +127,16 @@ class rw_semaphore {
       boost::detail::yield(loop_count++);
     }
 
-    WaitPendingReaders();
+    int64_t wait_start = 0;
+    WaitPendingReaders(&wait_start);
+    FinishWait(wait_start);
     RecordLockHolderStack();
     return true;
   }
 
   void lock() {
     int loop_count = 0;
+    int64_t wait_start = 0;
     Atomic32 cur_state = base::subtle::NoBarrier_Load(&state_);
     while (true) {
       Atomic32 expected = cur_state & kNumReadersMask;   // I expect some 0+ readers
@@ -136,10 +147,12 @@ class rw_semaphore {
       if (cur_state == expected)
         break;
       // Either was already locked by someone else, or CAS failed.
+      StartWait(&wait_start);
       boost::detail::yield(loop_count++);
     }
 
-    WaitPendingReaders();
+    WaitPendingReaders(&wait_start);
+    FinishWait(wait_start);
 
 #ifndef NDEBUG
     writer_tid_ = Thread::CurrentThreadId();
@@ -192,13 +205,27 @@ class rw_semaphore {
   }
 #endif
 
-  void WaitPendingReaders() {
+  void WaitPendingReaders(int64_t* wait_start) {
     int loop_count = 0;
     while ((base::subtle::Acquire_Load(&state_) & kNumReadersMask) > 0) {
+      StartWait(wait_start);
       boost::detail::yield(loop_count++);
     }
   }
 
+  // The clock is only read once the lock turns out to be contended.
+  static void StartWait(int64_t* wait_start) {
+    if (*wait_start == 0) {
+      *wait_start = CycleClock::Now();
+    }
+  }
+
+  void FinishWait(int64_t wait_start) const {
+    if (PREDICT_FALSE(wait_start != 0)) {
+      SubmitLockContention(this, CycleClock::Now() - wait_start);
+    }
+  }
+
  private:
   volatile Atomic32 state_;
 #ifndef NDEBUG
@@ -38,6 +38,7 @@
 #include "yb/gutil/walltime.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/env.h"
+#include "yb/util/spinlock_profiling.h"
 #include "yb/util/thread.h"
 #endif // NDEBUG
 
@@ -92,8 +93,12 @@ bool RWCLock::HasWriteLock() const {
 void RWCLock::WriteLock() {
   MutexLock l(lock_);
   // Wait for any other mutations to finish.
-  while (write_locked_) {
-    no_mutators_.Wait();
+  if (PREDICT_FALSE(write_locked_)) {
+    const int64_t wait_start = CycleClock::Now();
+    while (write_locked_) {
+      no_mutators_.Wait();
+    }
+    SubmitLockContention(this, CycleClock::Now() - wait_start);
   }
 #ifndef NDEBUG
   last_writelock_acquire_time_ = GetCurrentTimeMicros();
@@ -116,8 +121,12 @@ void RWCLock::WriteUnlock() {
 void RWCLock::UpgradeToCommitLock() {
   lock_.lock();
   DCHECK(write_locked_);
-  while (reader_count_ > 0) {
-    no_readers_.Wait();
+  if (PREDICT_FALSE(reader_count_ > 0)) {
+    const int64_t wait_start = CycleClock::Now();
+    while (reader_count_ > 0) {
+      no_readers_.Wait();
+    }
+    SubmitLockContention(this, CycleClock::Now() - wait_start);
   }
   DCHECK(write_locked_);
 
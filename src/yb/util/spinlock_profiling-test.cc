@@ -33,12 +33,17 @@
 #include <gtest/gtest.h>
 #include <glog/logging.h>
 #include <strstream>
+#include <thread>
 
 #include "yb/gutil/spinlock.h"
+#include "yb/util/countdown_latch.h"
+#include "yb/util/mutex.h"
 #include "yb/util/spinlock_profiling.h"
 #include "yb/util/test_util.h"
 #include "yb/util/trace.h"
 
+DECLARE_int32(lock_contention_profiling_sample_every);
+
 // Can't include gutil/synchronization_profiling.h directly as it'll
 // declare a weak symbol directly in this unit test, which the runtime
 // linker will prefer over equivalent strong symbols for some reason. By
@@ -86,4 +91,42 @@ TEST_F(SpinLockProfilingTest, TestStackCollection) {
   ASSERT_EQ(0, dropped);
 }
 
+TEST_F(SpinLockProfilingTest, TestSampling) {
+  FLAGS_lock_contention_profiling_sample_every = 4;
+  StartSynchronizationProfiling();
+  base::SpinLock lock;
+  for (int i = 0; i != 8; ++i) {
+    gutil::SubmitSpinLockProfileData(&lock, 100);
+  }
+  StopSynchronizationProfiling();
+  FLAGS_lock_contention_profiling_sample_every = 1;
+  std::stringstream str;
+  int64_t dropped = 0;
+  FlushSynchronizationProfile(&str, &dropped);
+  // Two of the eight contentions are sampled, each counting for four of them.
+  ASSERT_STR_CONTAINS(str.str(), "800\t8 @ ");
+  ASSERT_EQ(0, dropped);
+}
+
+TEST_F(SpinLockProfilingTest, TestMutexContention) {
+  StartSynchronizationProfiling();
+  Mutex mutex;
+  CountDownLatch locked(1);
+  std::thread holder([&mutex, &locked] {
+    MutexLock l(mutex);
+    locked.CountDown();
+    SleepFor(MonoDelta::FromMilliseconds(100));
+  });
+  locked.Wait();
+  {
+    MutexLock l(mutex);
+  }
+  holder.join();
+  StopSynchronizationProfiling();
+  std::stringstream str;
+  int64_t dropped = 0;
+  FlushSynchronizationProfile(&str, &dropped);
+  ASSERT_STR_CONTAINS(str.str(), "\t1 @ ");
+}
+
 } // namespace yb
@@ -32,6 +32,8 @@
 
 #include "yb/util/spinlock_profiling.h"
 
+#include <algorithm>
+
 #include <glog/logging.h>
 #include <gflags/gflags.h>
 
@@ -54,6 +56,13 @@ DEFINE_int32(lock_contention_trace_threshold_cycles,
              "stack trace is logged to the trace buffer.");
 TAG_FLAG(lock_contention_trace_threshold_cycles, hidden);
 
+DEFINE_int32(lock_contention_profiling_sample_every, 1,
+             "While a contention profile is being collected, record the stack trace of one in "
+             "this many contended lock acquisitions of each thread. Recorded samples are "
+             "weighted accordingly, so the profile stays unbiased.");
+TAG_FLAG(lock_contention_profiling_sample_every, advanced);
+TAG_FLAG(lock_contention_profiling_sample_every, runtime);
+
 METRIC_DEFINE_gauge_uint64(server, spinlock_contention_time,
     "Spinlock Contention Time", yb::MetricUnit::kMicroseconds,
     "Amount of time consumed by contention on internal spinlocks since the server "
@@ -87,8 +96,9 @@ class ContentionStacks {
     : dropped_samples_(0) {
   }
 
-  // Add a stack trace to the table.
-  void AddStack(const StackTrace& s, int64_t cycles);
+  // Add a stack trace to the table, as 'count' contended acquisitions that waited 'cycles' in
+  // total.
+  void AddStack(const StackTrace& s, int64_t cycles, int64_t count);
 
   // Flush stacks from the buffer to 'out'. See the docs for FlushSynchronizationProfile()
   // in spinlock_profiling.h for details on format.
@@ -147,7 +157,7 @@ class ContentionStacks {
 Atomic32 g_profiling_enabled = 0;
 ContentionStacks* g_contention_stacks = nullptr;
 
-void ContentionStacks::AddStack(const StackTrace& s, int64_t cycles) {
+void ContentionStacks::AddStack(const StackTrace& s, int64_t cycles, int64_t count) {
   uint64_t hash = s.HashCode();
 
   // Linear probe up to 4 attempts before giving up
@@ -172,7 +182,7 @@ void ContentionStacks::AddStack(const StackTrace& s, int64_t cycles) {
 
     // Contribute to the stats for this stack.
     e->cycle_count += cycles;
-    e->trip_count++;
+    e->trip_count += count;
     e->lock.Unlock();
     return;
   }
@@ -234,11 +244,24 @@ void SubmitSpinLockProfileData(const void *contendedlock, int64 wait_cycles) {
   if (in_func) return; // non-re-entrant
   in_func = true;
 
+  // Collecting the stack trace is the expensive part, so it is only done for sampled contentions.
+  int64_t sample_weight = 0;
+  if (profiling_enabled) {
+    static __thread int32_t contentions_until_sample = 0;
+    if (--contentions_until_sample <= 0) {
+      sample_weight = std::max(FLAGS_lock_contention_profiling_sample_every, 1);
+      contentions_until_sample = sample_weight;
+    }
+  }
+
   StackTrace stack;
-  stack.Collect();
+  if (sample_weight || long_wait_time) {
+    stack.Collect();
+  }
 
-  if (profiling_enabled) {
-    DCHECK_NOTNULL(g_contention_stacks)->AddStack(stack, wait_cycles);
+  if (sample_weight) {
+    DCHECK_NOTNULL(g_contention_stacks)->AddStack(
+        stack, wait_cycles * sample_weight, sample_weight);
   }
 
   if (PREDICT_FALSE(long_wait_time)) {
@@ -271,6 +294,10 @@ void DoInit() {
 
 } // anonymous namespace
 
+void SubmitLockContention(const void* lock, int64_t wait_cycles) {
+  SubmitSpinLockProfileData(lock, wait_cycles);
+}
+
 void InitSpinLockContentionProfiling() {
   static GoogleOnceType once = GOOGLE_ONCE_INIT;
   GoogleOnceInit(&once, DoInit);
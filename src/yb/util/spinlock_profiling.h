@@ -83,5 +83,13 @@ void FlushSynchronizationProfile(std::stringstream* out, int64_t* drop_count);
 // Stop collecting contention profiles.
 void StopSynchronizationProfiling();
 
+// Reports that acquiring 'lock' had to wait for 'wait_cycles' cycles, the same way contention on
+// gutil spinlocks is reported: it is recorded in the synchronization profile while profiling is
+// enabled, and logged to the current trace if the wait was long.
+//
+// Used by the yb lock primitives (Mutex, rw_spinlock, RWCLock and hence CowLock) on their contended
+// path only, so uncontended acquisitions stay free of any overhead.
+void SubmitLockContention(const void* lock, int64_t wait_cycles);
+
 } // namespace yb
 #endif /* YB_UTIL_SPINLOCK_PROFILING_H */
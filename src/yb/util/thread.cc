@@ -47,15 +47,22 @@
 #include <map>
 #include <memory>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
+#include <gflags/gflags.h>
+
 #include "yb/gutil/atomicops.h"
 #include "yb/gutil/dynamic_annotations.h"
 #include "yb/gutil/mathlimits.h"
 #include "yb/gutil/once.h"
+#include "yb/gutil/strings/numbers.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/util/debug-util.h"
+#include "yb/util/env.h"
 #include "yb/util/errno.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/jsonwriter.h"
 #include "yb/util/logging.h"
 #include "yb/util/metrics.h"
 #include "yb/util/mutex.h"
@@ -99,6 +106,12 @@ METRIC_DEFINE_gauge_uint64(server, involuntary_context_switches,
                            "Total involuntary context switches",
                            yb::EXPOSE_AS_COUNTER);
 
+DEFINE_int32(thread_cpu_time_sampling_interval_ms, 1000,
+             "Minimum interval between two samples of the CPU time of all the threads of the "
+             "process, which is reported aggregated by thread category.");
+TAG_FLAG(thread_cpu_time_sampling_interval_ms, advanced);
+TAG_FLAG(thread_cpu_time_sampling_interval_ms, runtime);
+
 namespace yb {
 
 using std::endl;
@@ -135,6 +148,17 @@ uint64_t GetInVoluntaryContextSwitches() {
   return ru.ru_nivcsw;
 }
 
+// Metric name component for a thread category, e.g. "thread pool" becomes "thread_pool".
+std::string SanitizeCategoryName(const std::string& category) {
+  std::string result = category;
+  for (char& c : result) {
+    if (!isalnum(c)) {
+      c = '_';
+    }
+  }
+  return result;
+}
+
 // A singleton class that tracks all live threads, and groups them together for easy
 // auditing. Used only by Thread.
 class ThreadMgr {
@@ -160,10 +184,19 @@ class ThreadMgr {
       int64_t tid);
 
   // Removes a thread from the supplied category. If the thread has
-  // already been removed, this is a no-op.
+  // already been removed, this is a no-op. Must be called by the thread itself, when it exits.
   void RemoveThread(const pthread_t& pthread_id, const string& category);
 
+  // Returns the category of each live thread started through Thread, by TID.
+  std::unordered_map<int64_t, string> CategoriesByTid();
+
  private:
+  // CPU time consumed by the threads of a category.
+  struct CpuTime {
+    int64_t user_ns = 0;
+    int64_t kernel_ns = 0;
+  };
+  typedef std::map<string, CpuTime> CpuTimeMap;
   // Container class for any details we want to capture about a thread
   // TODO: Add start-time.
   // TODO: Track fragment ID.
@@ -202,6 +235,16 @@ class ThreadMgr {
   // True after StartInstrumentation(..) returns
   bool metrics_enabled_;
 
+  // CPU time of the threads that already exited, by category.
+  CpuTimeMap exited_threads_cpu_time_;
+
+  // Protects the CPU time sample below.
+  Mutex cpu_time_lock_;
+
+  // The latest sample of the CPU time of all threads by category, and when it was taken.
+  CpuTimeMap cpu_time_;
+  MonoTime cpu_time_sampled_;
+
   // Counters to track all-time total number of threads, and the
   // current number of running threads.
   uint64_t threads_started_metric_;
@@ -211,6 +254,12 @@ class ThreadMgr {
   uint64_t ReadThreadsStarted();
   uint64_t ReadThreadsRunning();
 
+  // Returns the CPU time of all threads of the process by category, sampling it again from /proc
+  // if the latest sample is older than --thread_cpu_time_sampling_interval_ms.
+  CpuTimeMap CpuTimeByCategory();
+  void WriteCpuTimeAsJson(JsonWriter* writer);
+  void WriteCpuTimeForPrometheus(const MetricEntity::AttributeMap& attrs, PrometheusWriter* writer);
+
   // Webpage callback; prints all threads by category
   void ThreadPathHandler(const WebCallbackRegistry::WebRequest& args, stringstream* output);
   void PrintThreadCategoryRows(const ThreadCategory& category, stringstream* output);
@@ -267,6 +316,17 @@ Status ThreadMgr::StartInstrumentation(const scoped_refptr<MetricEntity>& metric
       METRIC_involuntary_context_switches.InstantiateFunctionGauge(metrics,
         Bind(&GetInVoluntaryContextSwitches)));
 
+  // The set of thread categories is not known in advance, so their CPU time is exported the way
+  // the RocksDB statistics of a tablet are.
+  metrics->AddExternalJsonMetricsCb([this](JsonWriter* writer, const MetricJsonOptions& opts) {
+    WriteCpuTimeAsJson(writer);
+  });
+  MetricEntity::AttributeMap attrs;
+  attrs["metric_id"] = metrics->id();
+  metrics->AddExternalPrometheusMetricsCb([this, attrs](PrometheusWriter* writer) {
+    WriteCpuTimeForPrometheus(attrs, writer);
+  });
+
   WebCallbackRegistry::PathHandlerCallback thread_callback =
       std::bind(&ThreadMgr::ThreadPathHandler, this, _1, _2);
   DCHECK_NOTNULL(web)->RegisterPathHandler("/threadz", "Threads", thread_callback, true, false);
@@ -283,6 +343,101 @@ uint64_t ThreadMgr::ReadThreadsRunning() {
   return threads_running_metric_;
 }
 
+ThreadMgr::CpuTimeMap ThreadMgr::CpuTimeByCategory() {
+  MutexLock sample_lock(cpu_time_lock_);
+  const auto now = MonoTime::Now();
+  if (cpu_time_sampled_.Initialized() &&
+      now - cpu_time_sampled_ <
+          MonoDelta::FromMilliseconds(FLAGS_thread_cpu_time_sampling_interval_ms)) {
+    return cpu_time_;
+  }
+
+  CpuTimeMap result;
+  {
+    MutexLock l(lock_);
+    result = exited_threads_cpu_time_;
+    for (const auto& category : thread_categories_) {
+      result[category.first];
+    }
+  }
+  const auto thread_categories = CategoriesByTid();
+
+  // /proc is read without holding lock_, so that starting and stopping threads is not blocked.
+  // A thread exiting meanwhile may be missed from this sample, but not from the next ones.
+  vector<string> tids;
+  Status s = Env::Default()->GetChildren("/proc/self/task", &tids);
+  if (!s.ok()) {
+    YB_LOG_EVERY_N(INFO, 100) << "Could not list the threads of the process: " << s.ToString();
+  }
+  for (const auto& tid_str : tids) {
+    int64_t tid;
+    if (!safe_strto64(tid_str, &tid)) {
+      continue;
+    }
+    ThreadStats stats;
+    string name;
+    if (!GetThreadStats(tid, &stats, &name).ok()) {
+      continue;
+    }
+    auto it = thread_categories.find(tid);
+    auto& cpu_time = result[it != thread_categories.end() ? it->second
+                                                          : UnregisteredThreadCategory(name)];
+    cpu_time.user_ns += stats.user_ns;
+    cpu_time.kernel_ns += stats.kernel_ns;
+  }
+
+  cpu_time_ = result;
+  cpu_time_sampled_ = now;
+  return result;
+}
+
+std::unordered_map<int64_t, string> ThreadMgr::CategoriesByTid() {
+  std::unordered_map<int64_t, string> result;
+  MutexLock l(lock_);
+  for (const auto& category : thread_categories_) {
+    for (const auto& thread : category.second) {
+      result.emplace(thread.second.thread_id(), category.first);
+    }
+  }
+  return result;
+}
+
+void ThreadMgr::WriteCpuTimeAsJson(JsonWriter* writer) {
+  for (const auto& entry : CpuTimeByCategory()) {
+    const string name = SanitizeCategoryName(entry.first);
+    writer->StartObject();
+    writer->String("name");
+    writer->String(Substitute("cpu_utime_$0", name));
+    writer->String("value");
+    writer->Int64(entry.second.user_ns / 1000000);
+    writer->EndObject();
+    writer->StartObject();
+    writer->String("name");
+    writer->String(Substitute("cpu_stime_$0", name));
+    writer->String("value");
+    writer->Int64(entry.second.kernel_ns / 1000000);
+    writer->EndObject();
+  }
+}
+
+void ThreadMgr::WriteCpuTimeForPrometheus(const MetricEntity::AttributeMap& attrs,
+                                          PrometheusWriter* writer) {
+  for (const auto& entry : CpuTimeByCategory()) {
+    auto category_attrs = attrs;
+    category_attrs["thread_category"] = entry.first;
+    Status s = writer->WriteSingleEntry(
+        category_attrs, "thread_category_cpu_utime", entry.second.user_ns / 1000000);
+    if (s.ok()) {
+      s = writer->WriteSingleEntry(
+          category_attrs, "thread_category_cpu_stime", entry.second.kernel_ns / 1000000);
+    }
+    if (!s.ok()) {
+      YB_LOG_EVERY_N(WARNING, 100) << "Failed to write thread CPU time: " << s.ToString();
+      return;
+    }
+  }
+}
+
 void ThreadMgr::AddThread(const pthread_t& pthread_id, const string& name,
     const string& category, int64_t tid) {
   // These annotations cause TSAN to ignore the synchronization on lock_
@@ -312,6 +467,11 @@ void ThreadMgr::AddThread(const pthread_t& pthread_id, const string& name,
 }
 
 void ThreadMgr::RemoveThread(const pthread_t& pthread_id, const string& category) {
+  // The CPU time of the exiting thread is kept in its category, so that the total CPU time of the
+  // category does not drop when one of its threads exits.
+  ThreadStats stats;
+  const bool has_stats = GetThreadStats(Thread::CurrentThreadId(), &stats).ok();
+
   ANNOTATE_IGNORE_SYNC_BEGIN();
   ANNOTATE_IGNORE_READS_AND_WRITES_BEGIN();
   {
@@ -322,6 +482,11 @@ void ThreadMgr::RemoveThread(const pthread_t& pthread_id, const string& category
     if (metrics_enabled_) {
       threads_running_metric_--;
     }
+    if (has_stats) {
+      auto& cpu_time = exited_threads_cpu_time_[category];
+      cpu_time.user_ns += stats.user_ns;
+      cpu_time.kernel_ns += stats.kernel_ns;
+    }
   }
   ANNOTATE_IGNORE_SYNC_END();
   ANNOTATE_IGNORE_READS_AND_WRITES_END();
@@ -424,6 +589,16 @@ Status StartThreadInstrumentation(const scoped_refptr<MetricEntity>& server_metr
   return thread_manager->StartInstrumentation(server_metrics, web);
 }
 
+std::unordered_map<int64_t, std::string> RegisteredThreadCategories() {
+  InitThreading();
+  return thread_manager->CategoriesByTid();
+}
+
+std::string UnregisteredThreadCategory(const std::string& thread_name) {
+  auto end = thread_name.find_last_not_of("0123456789");
+  return thread_name.substr(0, end == std::string::npos ? 0 : end + 1);
+}
+
 ThreadJoiner::ThreadJoiner(Thread* thr)
   : thread_(CHECK_NOTNULL(thr)),
     warn_after_ms_(kDefaultWarnAfterMs),
@@ -39,6 +39,7 @@
 
 #include <functional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "yb/gutil/atomicops.h"
@@ -355,6 +356,14 @@ Status StartThreadInstrumentation(const scoped_refptr<MetricEntity>& server_metr
 // This initializes the thread manager and warms up libunwind's state (see ENG-1402).
 void InitThreading();
 
+// Returns the category of each live thread that was started through Thread, by TID.
+std::unordered_map<int64_t, std::string> RegisteredThreadCategories();
+
+// Category of the threads that were not started through Thread, e.g. the RocksDB background
+// threads: their name without the trailing thread index, so "rocksdb:low:bg3" maps to
+// "rocksdb:low:bg".
+std::string UnregisteredThreadCategory(const std::string& thread_name);
+
 } // namespace yb
 
 #endif /* YB_UTIL_THREAD_H */
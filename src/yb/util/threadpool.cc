@@ -658,7 +658,9 @@ Status ThreadPool::CreateThreadUnlocked() {
   // The first few threads are permanent, and do not time out.
   bool permanent = (num_threads_ < min_threads_);
   scoped_refptr<Thread> t;
-  Status s = yb::Thread::Create("thread pool", strings::Substitute("$0 [worker]", name_),
+  // Each pool is a category of its own, so that e.g. the CPU time of the apply threads can be told
+  // apart from the one of the other pools.
+  Status s = yb::Thread::Create(name_, strings::Substitute("$0 [worker]", name_),
                                   &ThreadPool::DispatchThread, this, permanent, &t);
   if (s.ok()) {
     InsertOrDie(&threads_, t.get());
@@ -0,0 +1,118 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <chrono>
+#include <map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/random.h"
+#include "yb/util/timer_wheel.h"
+#include "yb/util/test_util.h"
+
+using namespace std::literals;
+
+namespace yb {
+
+typedef std::chrono::steady_clock Clock;
+
+class TimerWheelTest : public YBTest {
+ protected:
+  const Clock::time_point start_ = Clock::now();
+};
+
+TEST_F(TimerWheelTest, Simple) {
+  TimerWheel<Clock, int, int> wheel(1ms, start_);
+  ASSERT_EQ(Clock::time_point::max(), wheel.NextExpiration());
+
+  wheel.Insert(1, start_ + 10ms, 1);
+  wheel.Insert(2, start_ + 5ms, 2);
+  wheel.Insert(3, start_ + 2000ms, 3);
+  ASSERT_EQ(3U, wheel.size());
+  ASSERT_EQ(start_ + 5ms, wheel.NextExpiration());
+
+  std::vector<int> expired;
+  wheel.Advance(start_ + 4ms, &expired);
+  ASSERT_TRUE(expired.empty());
+  wheel.Advance(start_ + 10ms, &expired);
+  ASSERT_EQ((std::vector<int>{2, 1}), expired);
+
+  int value = 0;
+  ASSERT_TRUE(wheel.Erase(3, &value));
+  ASSERT_EQ(3, value);
+  ASSERT_FALSE(wheel.Erase(3));
+  ASSERT_FALSE(wheel.Erase(1));
+  ASSERT_TRUE(wheel.empty());
+}
+
+// Uses a small wheel, so timers go through cascades and past the horizon, and checks it against
+// an ordered map.
+TEST_F(TimerWheelTest, Random) {
+  constexpr int kIterations = 20000;
+  constexpr size_t kSlotBits = 2;
+  constexpr size_t kNumLevels = 3;
+  TimerWheel<Clock, int, int, kSlotBits, kNumLevels> wheel(1ms, start_);
+  std::map<int, Clock::time_point> timers;
+  Random rnd(SeedRandom());
+  auto now = start_;
+  std::vector<int> expired;
+  for (int i = 0; i != kIterations; ++i) {
+    switch (rnd.Uniform(3)) {
+      case 0: {
+        auto deadline = now + std::chrono::microseconds(rnd.Uniform(200000));
+        wheel.Insert(i, deadline, i);
+        timers.emplace(i, deadline);
+        break;
+      }
+      case 1:
+        if (!timers.empty()) {
+          auto it = timers.lower_bound(rnd.Uniform(i));
+          if (it == timers.end()) {
+            it = timers.begin();
+          }
+          ASSERT_TRUE(wheel.Erase(it->first));
+          timers.erase(it);
+        }
+        break;
+      case 2: {
+        auto next = wheel.NextExpiration();
+        now += std::chrono::microseconds(rnd.Uniform(20000));
+        expired.clear();
+        wheel.Advance(now, &expired);
+        if (next > now) {
+          ASSERT_TRUE(expired.empty());
+        }
+        for (int key : expired) {
+          auto it = timers.find(key);
+          ASSERT_TRUE(it != timers.end());
+          ASSERT_LE(it->second, now);
+          timers.erase(it);
+        }
+        for (const auto& timer : timers) {
+          // Timers fire at most one tick late.
+          ASSERT_GT(timer.second + 1ms, now) << "Key: " << timer.first;
+        }
+        break;
+      }
+    }
+    ASSERT_EQ(timers.size(), wheel.size());
+  }
+
+  expired.clear();
+  wheel.Clear(&expired);
+  ASSERT_EQ(timers.size(), expired.size());
+  ASSERT_TRUE(wheel.empty());
+}
+
+} // namespace yb
@@ -0,0 +1,273 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+#ifndef YB_UTIL_TIMER_WHEEL_H
+#define YB_UTIL_TIMER_WHEEL_H
+
+#include <algorithm>
+#include <list>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "yb/gutil/macros.h"
+
+namespace yb {
+
+// Hierarchical timer wheel: kNumLevels levels of 2^kSlotBits slots each, where a slot of level L
+// covers 2^(kSlotBits * L) ticks. Timers are kept in the slot of the lowest level that covers
+// their deadline, and are moved down a level when the current tick reaches the start of their
+// slot. Insert and Erase are O(1), Advance is O(1) per expired timer plus one cascade per level
+// per revolution of the level below.
+//
+// Deadlines are rounded up to the tick, so timers never fire early, but may fire up to one tick
+// late. Timers further than 2^(kSlotBits * kNumLevels) ticks away are parked in the farthest slot
+// of the top level, and placed again when it is reached.
+//
+// This class is not thread-safe.
+template <class Clock, class Key, class Value,
+          size_t kSlotBits = 8, size_t kNumLevels = 4, class Hash = std::hash<Key>>
+class TimerWheel {
+ public:
+  typedef typename Clock::time_point TimePoint;
+  typedef typename Clock::duration Duration;
+
+  TimerWheel(Duration tick, TimePoint start) : tick_(tick), start_(start) {
+    CHECK_GT(tick.count(), 0);
+  }
+
+  // Adds a timer that expires at 'deadline'. There should be no timer with the same key already.
+  // Deadlines in the past expire at the next call to Advance() for a time after the current tick.
+  void Insert(const Key& key, TimePoint deadline, Value value) {
+    if (!slots_) {
+      // Slots are allocated lazily, so wheels that never get a timer stay cheap.
+      slots_.reset(new Slot[kNumLevels * kNumSlots]);
+    }
+    const uint64_t tick = DeadlineTick(deadline);
+    const auto pos = SlotFor(tick);
+    Slot& slot = slot_at(pos.first, pos.second);
+    slot.push_back(Entry{key, tick, std::move(value)});
+    SetOccupied(pos.first, pos.second);
+    bool inserted = index_.emplace(key, Location{pos.first, pos.second, --slot.end()}).second;
+    DCHECK(inserted) << "Duplicate timer key";
+  }
+
+  // Removes the timer for 'key', storing its value in 'value' if it is not null. Returns false if
+  // there is no such timer, e.g. because it already expired.
+  bool Erase(const Key& key, Value* value = nullptr) {
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      return false;
+    }
+    const Location& location = it->second;
+    Slot& slot = slot_at(location.level, location.slot);
+    if (value) {
+      *value = std::move(location.it->value);
+    }
+    slot.erase(location.it);
+    if (slot.empty()) {
+      ClearOccupied(location.level, location.slot);
+    }
+    index_.erase(it);
+    return true;
+  }
+
+  // Removes the timers that expired at 'now' and appends their values to 'expired', ordered by
+  // deadline up to the tick resolution.
+  void Advance(TimePoint now, std::vector<Value>* expired) {
+    const uint64_t target = CurrentTick(now);
+    while (current_ <= target) {
+      if (index_.empty()) {
+        current_ = target + 1;
+        break;
+      }
+      const size_t index = current_ & kSlotMask;
+      if (index == 0) {
+        Cascade();
+      }
+      Slot& slot = slot_at(0, index);
+      for (auto& entry : slot) {
+        index_.erase(entry.key);
+        expired->push_back(std::move(entry.value));
+      }
+      slot.clear();
+      ClearOccupied(0, index);
+      // Skip empty slots, but stop at the end of this revolution, since the next one starts with a
+      // cascade.
+      const uint64_t next = (current_ & ~kSlotMask) + NextOccupied(0, index + 1);
+      current_ = std::min(next, target + 1);
+    }
+  }
+
+  // Removes all timers, appending their values to 'values'.
+  void Clear(std::vector<Value>* values) {
+    if (slots_) {
+      for (size_t i = 0; i != kNumLevels * kNumSlots; ++i) {
+        for (auto& entry : slots_[i]) {
+          values->push_back(std::move(entry.value));
+        }
+        slots_[i].clear();
+      }
+    }
+    std::fill(std::begin(occupied_), std::end(occupied_), 0);
+    index_.clear();
+  }
+
+  // Returns the time of the next tick at which Advance() has work to do, i.e. fires timers or
+  // cascades a non-empty slot, or TimePoint::max() if there are no timers.
+  TimePoint NextExpiration() const {
+    if (index_.empty()) {
+      return TimePoint::max();
+    }
+    uint64_t result = std::numeric_limits<uint64_t>::max();
+    for (size_t level = 0; level != kNumLevels; ++level) {
+      const size_t shift = kSlotBits * level;
+      const uint64_t revolution = (current_ >> shift) & ~kSlotMask;
+      // An upper level slot containing current_ was already cascaded, unless current_ is its
+      // start, so when it is occupied, its timers belong to the next revolution.
+      const bool cascaded = (current_ & ((1ULL << shift) - 1)) != 0;
+      const size_t index = ((current_ >> shift) & kSlotMask) + (cascaded ? 1 : 0);
+      size_t slot = NextOccupied(level, index);
+      uint64_t start;
+      if (slot != kNumSlots) {
+        start = revolution + slot;
+      } else {
+        slot = NextOccupied(level, 0);
+        if (slot == kNumSlots) {
+          continue;
+        }
+        start = revolution + kNumSlots + slot;
+      }
+      result = std::min(result, std::max<uint64_t>(start << shift, current_));
+    }
+    return start_ + tick_ * result;
+  }
+
+  size_t size() const { return index_.size(); }
+  bool empty() const { return index_.empty(); }
+
+ private:
+  static constexpr size_t kNumSlots = 1ULL << kSlotBits;
+  static constexpr uint64_t kSlotMask = kNumSlots - 1;
+  static constexpr size_t kWordBits = 64;
+  static constexpr size_t kWordsPerLevel = (kNumSlots + kWordBits - 1) / kWordBits;
+  static constexpr uint64_t kMaxDelta = (1ULL << (kSlotBits * kNumLevels)) - 1;
+
+  static_assert(kSlotBits * kNumLevels < 64, "Timer wheel horizon does not fit into 64 bits");
+
+  struct Entry {
+    Key key;
+    uint64_t tick;
+    Value value;
+  };
+
+  typedef std::list<Entry> Slot;
+
+  struct Location {
+    size_t level;
+    size_t slot;
+    typename Slot::iterator it;
+  };
+
+  // Deadlines are rounded up, so a timer does not fire before its deadline.
+  uint64_t DeadlineTick(TimePoint deadline) const {
+    if (deadline <= start_) {
+      return 0;
+    }
+    return (deadline - start_ + tick_ - Duration(1)) / tick_;
+  }
+
+  uint64_t CurrentTick(TimePoint now) const {
+    return now <= start_ ? 0 : (now - start_) / tick_;
+  }
+
+  // Returns the level and slot where a timer expiring at 'tick' belongs, given the current tick.
+  std::pair<size_t, size_t> SlotFor(uint64_t tick) const {
+    const uint64_t delta = std::min(tick > current_ ? tick - current_ : 0, kMaxDelta);
+    tick = current_ + delta;
+    size_t level = 0;
+    while (level + 1 != kNumLevels && delta >> (kSlotBits * (level + 1))) {
+      ++level;
+    }
+    return std::make_pair(level, (tick >> (kSlotBits * level)) & kSlotMask);
+  }
+
+  // Called when current_ starts a new revolution of level 0. Moves the timers of every upper level
+  // slot that starts at current_ down, starting from the highest one.
+  void Cascade() {
+    size_t levels = 1;
+    while (levels != kNumLevels && (current_ & ((1ULL << (kSlotBits * levels)) - 1)) == 0) {
+      ++levels;
+    }
+    for (size_t level = levels - 1; level > 0; --level) {
+      const size_t index = (current_ >> (kSlotBits * level)) & kSlotMask;
+      Slot slot;
+      slot.swap(slot_at(level, index));
+      ClearOccupied(level, index);
+      while (!slot.empty()) {
+        const auto it = slot.begin();
+        const auto pos = SlotFor(it->tick);
+        Slot& dest = slot_at(pos.first, pos.second);
+        // Splicing keeps the iterator valid, so only the position in the index changes.
+        dest.splice(dest.end(), slot, it);
+        SetOccupied(pos.first, pos.second);
+        index_[it->key] = Location{pos.first, pos.second, it};
+      }
+    }
+  }
+
+  // Returns the first occupied slot of 'level' at or after 'from', or kNumSlots if there is none.
+  size_t NextOccupied(size_t level, size_t from) const {
+    const uint64_t* words = occupied_ + level * kWordsPerLevel;
+    for (size_t word = from / kWordBits; word < kWordsPerLevel; ++word) {
+      uint64_t bits = words[word];
+      if (word == from / kWordBits) {
+        bits &= ~0ULL << (from % kWordBits);
+      }
+      if (bits) {
+        return std::min<size_t>(word * kWordBits + __builtin_ctzll(bits), kNumSlots);
+      }
+    }
+    return kNumSlots;
+  }
+
+  void SetOccupied(size_t level, size_t slot) {
+    occupied_[level * kWordsPerLevel + slot / kWordBits] |= 1ULL << (slot % kWordBits);
+  }
+
+  void ClearOccupied(size_t level, size_t slot) {
+    occupied_[level * kWordsPerLevel + slot / kWordBits] &= ~(1ULL << (slot % kWordBits));
+  }
+
+  Slot& slot_at(size_t level, size_t slot) const {
+    return slots_[level * kNumSlots + slot];
+  }
+
+  const Duration tick_;
+  const TimePoint start_;
+
+  // Next tick to be processed by Advance().
+  uint64_t current_ = 0;
+  std::unique_ptr<Slot[]> slots_;
+  uint64_t occupied_[kNumLevels * kWordsPerLevel] = {};
+  std::unordered_map<Key, Location, Hash> index_;
+
+  DISALLOW_COPY_AND_ASSIGN(TimerWheel);
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_TIMER_WHEEL_H
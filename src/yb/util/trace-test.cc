@@ -30,6 +30,7 @@
 // under the License.
 //
 
+#include <sstream>
 #include <string>
 
 #include <gtest/gtest.h>
@@ -52,6 +53,8 @@ using rapidjson::Value;
 using std::string;
 using std::vector;
 
+DECLARE_double(trace_sampling_rate);
+
 namespace yb {
 
 class TraceTest : public YBTest {
@@ -121,6 +124,38 @@ TEST_F(TraceTest, TestChildTrace) {
             XOutDigits(traceA->DumpToString(false)));
 }
 
+TEST_F(TraceTest, TestSampledStages) {
+  FLAGS_trace_sampling_rate = 0;
+  ASSERT_EQ(0U, Trace::MaybeSampleTraceId());
+  FLAGS_trace_sampling_rate = 1;
+  auto trace_id = Trace::MaybeSampleTraceId();
+  ASSERT_NE(0U, trace_id);
+
+  scoped_refptr<Trace> not_sampled(new Trace);
+  {
+    ADOPT_TRACE(not_sampled.get());
+    EXPECT_EQ(0U, Trace::CurrentTraceId());
+    TRACE_STAGE("test.not_sampled");
+  }
+
+  scoped_refptr<Trace> sampled(new Trace);
+  sampled->set_trace_id(trace_id);
+  {
+    // Sampled traces are adopted even when tracing is disabled, so the trace id is available
+    // to the code that handles the request.
+    ADOPT_TRACE(sampled.get());
+    EXPECT_EQ(trace_id, Trace::CurrentTraceId());
+    TRACE_STAGE("test.sampled");
+  }
+  EXPECT_EQ(0U, Trace::CurrentTraceId());
+
+  std::stringstream out;
+  DumpTraceStages(&out);
+  auto dump = out.str();
+  EXPECT_NE(dump.find("test.sampled: count=1 "), string::npos) << dump;
+  EXPECT_EQ(dump.find("test.not_sampled"), string::npos) << dump;
+}
+
 static void GenerateTraceEvents(int thread_id,
                                 int num_events) {
   for (int i = 0; i < num_events; i++) {
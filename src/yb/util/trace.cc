@@ -35,6 +35,8 @@
 #include <iomanip>
 #include <ios>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <strstream>
 #include <string>
 #include <vector>
@@ -45,13 +47,23 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/walltime.h"
 
+#include "yb/util/flag_tags.h"
+#include "yb/util/hdr_histogram.h"
 #include "yb/util/memory/arena.h"
 #include "yb/util/memory/memory.h"
 #include "yb/util/object_pool.h"
+#include "yb/util/random_util.h"
 #include "yb/util/size_literals.h"
 
 DEFINE_bool(enable_tracing, false, "Flag to enable/disable tracing across the code.");
 
+DEFINE_double(trace_sampling_rate, 0.0,
+              "Fraction of requests for which a trace id is assigned and propagated to the RPCs "
+              "and operations they spawn, recording the latency of each request stage. "
+              "0 disables sampling.");
+TAG_FLAG(trace_sampling_rate, advanced);
+TAG_FLAG(trace_sampling_rate, runtime);
+
 namespace yb {
 
 using strings::internal::SubstituteArg;
@@ -156,10 +168,52 @@ int64_t GetCurrentMicrosFast(MonoTime now) {
   return initial_micros_offset + now.GetDeltaSinceMin().ToMicroseconds();
 }
 
+// Latency histograms of request stages, keyed by stage name.
+class TraceStages {
+ public:
+  static TraceStages& Instance() {
+    static TraceStages instance;
+    return instance;
+  }
+
+  void Record(const char* stage, MonoDelta elapsed) {
+    HdrHistogram* histogram;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto& entry = histograms_[stage];
+      if (!entry) {
+        // Track latencies of up to 60 seconds with 2 significant digits.
+        entry = std::make_unique<HdrHistogram>(60000000, 2);
+      }
+      histogram = entry.get();
+    }
+    histogram->Increment(std::max<int64_t>(elapsed.ToMicroseconds(), 0));
+  }
+
+  void Dump(std::ostream* out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& p : histograms_) {
+      const auto& histogram = *p.second;
+      *out << p.first
+           << ": count=" << histogram.TotalCount()
+           << " mean=" << histogram.MeanValue()
+           << "us p50=" << histogram.ValueAtPercentile(50)
+           << "us p99=" << histogram.ValueAtPercentile(99)
+           << "us p99.9=" << histogram.ValueAtPercentile(99.9)
+           << "us max=" << histogram.MaxValue() << "us" << std::endl;
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  std::map<std::string, std::unique_ptr<HdrHistogram>> histograms_;
+};
+
 } // namespace
 
 ScopedAdoptTrace::ScopedAdoptTrace(Trace* t)
-    : old_trace_(Trace::threadlocal_trace_), is_enabled_(FLAGS_enable_tracing) {
+    : old_trace_(Trace::threadlocal_trace_),
+      is_enabled_(FLAGS_enable_tracing || (t && t->sampled())) {
   if (is_enabled_) {
     trace_ = t;
     Trace::threadlocal_trace_ = t;
@@ -349,6 +403,17 @@ void Trace::DumpCurrentTrace() {
   t->Dump(&std::cerr, true);
 }
 
+uint64_t Trace::MaybeSampleTraceId() {
+  if (PREDICT_TRUE(!RandomActWithProbability(FLAGS_trace_sampling_rate))) {
+    return 0;
+  }
+  uint64_t result;
+  do {
+    result = RandomUniformInt<uint64_t>();
+  } while (result == 0);
+  return result;
+}
+
 void Trace::AddChildTrace(Trace* child_trace) {
   CHECK_NOTNULL(child_trace);
   {
@@ -359,6 +424,14 @@ void Trace::AddChildTrace(Trace* child_trace) {
   CHECK(!child_trace->HasOneRef());
 }
 
+void RecordTraceStage(const char* stage, MonoDelta elapsed) {
+  TraceStages::Instance().Record(stage, elapsed);
+}
+
+void DumpTraceStages(std::ostream* out) {
+  TraceStages::Instance().Dump(out);
+}
+
 PlainTrace::PlainTrace() {
 }
 
@@ -48,6 +48,7 @@
 
 #include "yb/util/locks.h"
 #include "yb/util/memory/arena_fwd.h"
+#include "yb/util/monotime.h"
 
 DECLARE_bool(enable_tracing);
 
@@ -90,6 +91,10 @@ DECLARE_bool(enable_tracing);
     } \
   } while (0)
 
+// Measures the time until the end of the current scope as the given request stage, if the trace
+// adopted by the current thread was sampled. See ScopedTraceStage.
+#define TRACE_STAGE(stage) yb::ScopedTraceStage _trace_stage(stage)
+
 #define PLAIN_TRACE_TO(trace, message) \
   do { \
     if (FLAGS_enable_tracing) { \
@@ -155,11 +160,36 @@ class Trace : public RefCountedThreadSafe<Trace> {
   // Attaches the given trace which will get appended at the end when Dumping.
   void AddChildTrace(Trace* child_trace);
 
+  // Identifier of the sampled request this trace belongs to, or 0 if the request was not sampled.
+  // The id is propagated to the traces of the child operations and RPCs of the request, and
+  // latencies of the request stages are only recorded for sampled requests.
+  uint64_t trace_id() const {
+    return trace_id_.load(std::memory_order_acquire);
+  }
+
+  void set_trace_id(uint64_t trace_id) {
+    trace_id_.store(trace_id, std::memory_order_release);
+  }
+
+  bool sampled() const {
+    return trace_id() != 0;
+  }
+
   // Return the current trace attached to this thread, if there is one.
   static Trace* CurrentTrace() {
     return threadlocal_trace_;
   }
 
+  // Return the trace id of the current trace attached to this thread, or 0 if there is no trace
+  // or it was not sampled.
+  static uint64_t CurrentTraceId() {
+    return threadlocal_trace_ ? threadlocal_trace_->trace_id() : 0;
+  }
+
+  // Decides whether a new request should be sampled according to --trace_sampling_rate.
+  // Returns a new non-zero trace id in that case and 0 otherwise.
+  static uint64_t MaybeSampleTraceId();
+
   // Simple function to dump the current trace to stderr, if one is
   // available. This is meant for usage when debugging in gdb via
   // 'call yb::Trace::DumpCurrentTrace();'.
@@ -197,6 +227,8 @@ class Trace : public RefCountedThreadSafe<Trace> {
 
   std::vector<scoped_refptr<Trace> > child_traces_;
 
+  std::atomic<uint64_t> trace_id_{0};
+
   DISALLOW_COPY_AND_ASSIGN(Trace);
 };
 
@@ -220,6 +252,35 @@ class ScopedAdoptTrace {
   DISALLOW_COPY_AND_ASSIGN(ScopedAdoptTrace);
 };
 
+// Records 'elapsed' into the process-wide latency histogram of the given request stage.
+// 'stage' should be a static constant, it is used as the key of the histogram.
+void RecordTraceStage(const char* stage, MonoDelta elapsed);
+
+// Dumps count, mean and percentiles of the latencies of all request stages recorded so far.
+void DumpTraceStages(std::ostream* out);
+
+// Records the time spent in the current scope as the given request stage, when the trace adopted
+// by the current thread was sampled. Does nothing, not even reading the clock, otherwise.
+class ScopedTraceStage {
+ public:
+  explicit ScopedTraceStage(const char* stage)
+      : stage_(Trace::CurrentTraceId() != 0 ? stage : nullptr),
+        start_(stage_ ? MonoTime::Now() : MonoTime()) {
+  }
+
+  ~ScopedTraceStage() {
+    if (stage_) {
+      RecordTraceStage(stage_, MonoTime::Now() - start_);
+    }
+  }
+
+ private:
+  const char* const stage_;
+  const MonoTime start_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedTraceStage);
+};
+
 // PlainTrace could be used in simple cases when we trace only up to 20 entries with const message.
 // So it does not allocate memory.
 class PlainTrace {
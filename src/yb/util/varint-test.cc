@@ -151,6 +151,12 @@ TEST_F(VarIntTest, TestArithmetic) {
   ASSERT_EQ(VarInt("-1"), VarInt::add({VarInt("23"), VarInt("3"), VarInt("-27")}));
   // Test arithmetic even if the numbers are not in the same base
   ASSERT_EQ(VarInt("-112"), VarInt("29").ConvertToBase(7) - VarInt("141"));
+  // Sums that overflow int64 fall back to digit by digit addition.
+  ASSERT_EQ(VarInt("18446744073709551614"),
+            VarInt("9223372036854775807") + VarInt("9223372036854775807"));
+  ASSERT_EQ(VarInt("-9223372036854775809"),
+            VarInt("-9223372036854775808") - VarInt("1"));
+  ASSERT_EQ(VarInt("1"), VarInt("100000000000000000000001") - VarInt("100000000000000000000000"));
 }
 
 TEST_F(VarIntTest, TestComparableEncoding) {
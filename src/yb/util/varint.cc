@@ -71,11 +71,18 @@ string VarInt::ToString() const {
 }
 
 Status VarInt::ToInt64(int64_t* int64_value) const {
+  if (PREDICT_FALSE(!FitsInt64(int64_value))) {
+    return STATUS(InvalidArgument, "VarInt cannot be converted to int64 due to overflow");
+  }
+  return Status::OK();
+}
+
+bool VarInt::FitsInt64(int64_t* int64_value) const {
   uint64_t output = 0;
   const uint64_t overflow_bound = (numeric_limits<uint64_t>::max() / radix_) - 1;
   for (auto itr = digits_.rbegin(); itr != digits_.rend(); ++itr) {
     if (PREDICT_FALSE(output >= overflow_bound)) {
-      return STATUS(InvalidArgument, "VarInt cannot be converted to int64 due to overflow");
+      return false;
     }
     output *= static_cast<uint64_t> (radix_);
     output += *itr;
@@ -85,10 +92,17 @@ Status VarInt::ToInt64(int64_t* int64_value) const {
   }
   // Negative values should cast correctly because we did two's complement above.
   *int64_value = static_cast<int64_t> (output);
-  if (PREDICT_FALSE(is_positive_ ? *int64_value < 0 : *int64_value >= 0)) {
-    return STATUS(InvalidArgument, "VarInt cannot be converted to int64 due to overflow");
+  return !(is_positive_ ? *int64_value < 0 : *int64_value >= 0);
+}
+
+VarInt VarInt::operator+(const VarInt& other) const {
+  int64_t lhs = 0, rhs = 0, sum = 0;
+  if (FitsInt64(&lhs) && other.FitsInt64(&rhs) && !__builtin_add_overflow(lhs, rhs, &sum)) {
+    VarInt result;
+    result.FromInt64(sum, radix_);
+    return result;
   }
-  return Status::OK();
+  return add({*this, other});
 }
 
 Status VarInt::FromString(const Slice &slice) {
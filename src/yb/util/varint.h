@@ -80,6 +80,9 @@ class VarInt {
 
   CHECKED_STATUS ToInt64(int64_t* int64_value) const;
 
+  // The same as ToInt64, but returns false instead of an error status on overflow.
+  bool FitsInt64(int64_t* int64_value) const;
+
   // The input is expected to be of the form (-)?[0-9]+, whitespace is not allowed. Use this
   // after removing whitespace.
   CHECKED_STATUS FromString(const Slice &slice);
@@ -113,8 +116,9 @@ class VarInt {
   VarInt operator+() const { return VarInt(digits_, radix_, is_positive_); }
   VarInt operator-() const { return VarInt(digits_, radix_, !is_positive_); }
 
-  VarInt operator+(const VarInt& other) const { return add({*this, other}); }
-  VarInt operator-(const VarInt& other) const { return add({*this, -other}); }
+  // These take a fixed-width fast path when both operands and the result fit in int64.
+  VarInt operator+(const VarInt& other) const;
+  VarInt operator-(const VarInt& other) const { return *this + -other; }
 
   /**
    * (1) Encoding algorithm for unsigned varint (with no reserved bits):
@@ -33,6 +33,7 @@
 #define YB_UTIL_WEB_CALLBACK_REGISTRY_H
 
 #include <functional>
+#include <iosfwd>
 #include <map>
 #include <string>
 
@@ -63,6 +64,11 @@ class WebCallbackRegistry {
   typedef std::function<void(const WebRequest& args, std::stringstream* output)>
       PathHandlerCallback;
 
+  // Callback whose output is sent to the client as it is written, instead of being buffered until
+  // the callback returns. Its output is sent as unstyled plain text.
+  typedef std::function<void(const WebRequest& args, std::ostream* output)>
+      StreamingPathHandlerCallback;
+
   virtual ~WebCallbackRegistry() {}
 
   // Register a callback for a URL path. Path should not include the
@@ -78,6 +84,12 @@ class WebCallbackRegistry {
                                    const PathHandlerCallback& callback,
                                    bool is_styled = true, bool is_on_nav_bar = true,
                                    const std::string icon = "") = 0;
+
+  // Register a callback for a URL path that streams its output, for large responses. A path has
+  // either a streaming callback or regular ones.
+  virtual void RegisterStreamingPathHandler(const std::string& path, const std::string& alias,
+                                            const StreamingPathHandlerCallback& callback,
+                                            bool is_on_nav_bar = true) = 0;
 };
 
 } // namespace yb
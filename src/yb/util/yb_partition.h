@@ -40,10 +40,11 @@ class YBPartition {
     return cql_hash;
   }
 
+  // Splits the token ring at the same hash codes as tablets of a table with node_count evenly
+  // split hash partitions.
   static string CqlTokenSplit(size_t node_count, size_t index) {
-    uint64 hash_code = (UINT16_MAX / node_count * index) << 48;
-    int64_t cql_hash_code = static_cast<int64_t>(hash_code);
-    return std::to_string(cql_hash_code);
+    uint16_t hash_code = static_cast<uint16_t>(kMaxHashCode / node_count * index);
+    return std::to_string(YBToCqlHashCode(hash_code));
   }
 
   static void AppendBytesToKey(const char *bytes, size_t len, string *encoded_key) {
@@ -23,6 +23,15 @@
 
 #include "yb/gutil/endian.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(cql_response_compression_min_bytes, 256,
+             "CQL response bodies smaller than this are sent uncompressed even when the client "
+             "negotiated compression, as compressing them saves little and costs CPU.");
+TAG_FLAG(cql_response_compression_min_bytes, advanced);
+TAG_FLAG(cql_response_compression_min_bytes, runtime);
+
+DECLARE_int32(max_message_length);
 
 namespace yb {
 namespace cqlserver {
@@ -55,6 +64,8 @@ constexpr char CQLMessage::kNoCompactOption[];
 constexpr char CQLMessage::kLZ4Compression[];
 constexpr char CQLMessage::kSnappyCompression[];
 
+constexpr char CQLMessage::kReadAfterHybridTimePayload[];
+
 Status CQLMessage::QueryParameters::GetBindVariable(const std::string& name,
                                                     const int64_t pos,
                                                     const shared_ptr<QLType>& type,
@@ -235,6 +246,8 @@ bool CQLRequest::ParseRequest(
               "STARTUP request should not be compressed"));
       return false;
     }
+    size_t uncomp_size = 0;
+    bool ok = false;
     switch (compression_scheme) {
       case CompressionScheme::LZ4: {
         if (body_size < sizeof(uint32_t)) {
@@ -244,40 +257,15 @@ bool CQLRequest::ParseRequest(
                   "Insufficient compressed data"));
           return false;
         }
-
-        const uint32_t uncomp_size = static_cast<uint32_t>(NetworkByteOrder::Load32(body_data));
-        buffer = std::make_unique<uint8_t[]>(uncomp_size);
-        body_data += sizeof(uncomp_size);
-        body_size -= sizeof(uncomp_size);
-        const int size = LZ4_decompress_safe(to_char_ptr(body_data), to_char_ptr(buffer.get()),
-                                             body_size, uncomp_size);
-        if (size < 0 || size != uncomp_size) {
-          error_response->reset(
-              new ErrorResponse(
-                  header.stream_id, ErrorResponse::Code::PROTOCOL_ERROR,
-                  "Error occurred when uncompressing CQL message"));
-          return false;
-        }
-        body_data = buffer.get();
-        body_size = uncomp_size;
+        uncomp_size = NetworkByteOrder::Load32(body_data);
+        body_data += sizeof(uint32_t);
+        body_size -= sizeof(uint32_t);
+        ok = true;
         break;
       }
-      case CompressionScheme::SNAPPY: {
-        size_t uncomp_size = 0;
-        if (GetUncompressedLength(to_char_ptr(body_data), body_size, &uncomp_size)) {
-          buffer = std::make_unique<uint8_t[]>(uncomp_size);
-          if (RawUncompress(to_char_ptr(body_data), body_size, to_char_ptr(buffer.get()))) {
-            body_data = buffer.get();
-            body_size = uncomp_size;
-            break;
-          }
-        }
-        error_response->reset(
-            new ErrorResponse(
-                header.stream_id, ErrorResponse::Code::PROTOCOL_ERROR,
-                "Error occurred when uncompressing CQL message"));
+      case CompressionScheme::SNAPPY:
+        ok = GetUncompressedLength(to_char_ptr(body_data), body_size, &uncomp_size);
         break;
-      }
       case CompressionScheme::NONE:
         error_response->reset(
             new ErrorResponse(
@@ -285,6 +273,33 @@ bool CQLRequest::ParseRequest(
                 "No compression scheme specified"));
         return false;
     }
+    // The declared size comes from the client: check it before allocating the buffer.
+    if (ok && uncomp_size > static_cast<size_t>(FLAGS_max_message_length)) {
+      error_response->reset(
+          new ErrorResponse(
+              header.stream_id, ErrorResponse::Code::PROTOCOL_ERROR,
+              "Uncompressed CQL message too long"));
+      return false;
+    }
+    if (ok) {
+      buffer = std::make_unique<uint8_t[]>(uncomp_size);
+      if (compression_scheme == CompressionScheme::LZ4) {
+        const int size = LZ4_decompress_safe(to_char_ptr(body_data), to_char_ptr(buffer.get()),
+                                             body_size, uncomp_size);
+        ok = size >= 0 && static_cast<size_t>(size) == uncomp_size;
+      } else {
+        ok = RawUncompress(to_char_ptr(body_data), body_size, to_char_ptr(buffer.get()));
+      }
+    }
+    if (!ok) {
+      error_response->reset(
+          new ErrorResponse(
+              header.stream_id, ErrorResponse::Code::PROTOCOL_ERROR,
+              "Error occurred when uncompressing CQL message"));
+      return false;
+    }
+    body_data = buffer.get();
+    body_size = uncomp_size;
   }
 
   const Slice body = (body_size == 0) ? Slice() : Slice(body_data, body_size);
@@ -340,8 +355,14 @@ bool CQLRequest::ParseRequest(
     return false;
   }
 
-  // Parse the request body
-  const Status status = (*request)->ParseBody();
+  // Parse the custom payload that precedes the request body, then the body.
+  Status status;
+  if (header.flags & kCustomPayloadFlag) {
+    status = (*request)->ParseBytesMap(&(*request)->custom_payload_);
+  }
+  if (status.ok()) {
+    status = (*request)->ParseBody();
+  }
   if (!status.ok()) {
     error_response->reset(
         new ErrorResponse(
@@ -858,7 +879,6 @@ void SerializeStringMultiMap(const unordered_map<string, vector<string>>& map, f
   }
 }
 
-#if 0 // Save these functions for future use
 void SerializeBytesMap(const unordered_map<string, string>& map, faststring* mesg) {
   SerializeShort(map.size(), mesg);
   for (const auto& element : map) {
@@ -867,6 +887,7 @@ void SerializeBytesMap(const unordered_map<string, string>& map, faststring* mes
   }
 }
 
+#if 0 // Save this function for future use
 void SerializeValue(const CQLMessage::Value& value, faststring* mesg) {
   switch (value.kind) {
     case CQLMessage::Value::Kind::NOT_NULL:
@@ -909,48 +930,75 @@ CQLResponse::~CQLResponse() {
 #define SERIALIZE_LONG(buf, pos, value) \
   NetworkByteOrder::Store64(&(buf)[pos], static_cast<int64_t>(value))
 
+namespace {
+
+// Compresses 'body' into 'out' in the format of the given scheme. Returns false if the compressed
+// body would not be smaller, in which case the body should be sent uncompressed.
+bool CompressBody(const CQLMessage::CompressionScheme compression_scheme, const Slice& body,
+                  faststring* out) {
+  switch (compression_scheme) {
+    case CQLMessage::CompressionScheme::LZ4: {
+      // LZ4 bodies are prefixed with the uncompressed length.
+      const int max_comp_size = LZ4_compressBound(body.size());
+      out->resize(sizeof(uint32_t) + max_comp_size);
+      NetworkByteOrder::Store32(out->data(), static_cast<uint32_t>(body.size()));
+      const int comp_size = LZ4_compress_default(body.cdata(),
+                                                 to_char_ptr(out->data() + sizeof(uint32_t)),
+                                                 body.size(),
+                                                 max_comp_size);
+      CHECK_NE(comp_size, 0) << "LZ4 compression failed";
+      out->resize(sizeof(uint32_t) + comp_size);
+      break;
+    }
+    case CQLMessage::CompressionScheme::SNAPPY: {
+      size_t comp_size = 0;
+      out->resize(MaxCompressedLength(body.size()));
+      RawCompress(body.cdata(), body.size(), to_char_ptr(out->data()), &comp_size);
+      out->resize(comp_size);
+      break;
+    }
+    case CQLMessage::CompressionScheme::NONE:
+      LOG(FATAL) << "No compression scheme";
+      break;
+  }
+  return out->size() < body.size();
+}
+
+} // namespace
+
 void CQLResponse::Serialize(const CompressionScheme compression_scheme, faststring* mesg) const {
   const size_t start_pos = mesg->size(); // save the start position
-  const bool compress = (compression_scheme != CQLMessage::CompressionScheme::NONE);
-  SerializeHeader(compress, mesg);
-  if (compress) {
-    faststring body;
-    SerializeBody(&body);
-    switch (compression_scheme) {
-      case CQLMessage::CompressionScheme::LZ4: {
-        SerializeInt(static_cast<int32_t>(body.size()), mesg);
-        const size_t curr_size = mesg->size();
-        const int max_comp_size = LZ4_compressBound(body.size());
-        mesg->resize(curr_size + max_comp_size);
-        const int comp_size = LZ4_compress_default(to_char_ptr(body.data()),
-                                                   to_char_ptr(mesg->data() + curr_size),
-                                                   body.size(),
-                                                   max_comp_size);
-        CHECK_NE(comp_size, 0) << "LZ4 compression failed";
-        mesg->resize(curr_size + comp_size);
-        break;
-      }
-      case CQLMessage::CompressionScheme::SNAPPY: {
-        const size_t curr_size = mesg->size();
-        const size_t max_comp_size = MaxCompressedLength(body.size());
-        size_t comp_size = 0;
-        mesg->resize(curr_size + max_comp_size);
-        RawCompress(to_char_ptr(body.data()), body.size(),
-                    to_char_ptr(mesg->data() + curr_size), &comp_size);
-        mesg->resize(curr_size + comp_size);
-        break;
-      }
-      case CQLMessage::CompressionScheme::NONE:
-        LOG(FATAL) << "No compression scheme";
-        break;
+  SerializeHeader(false /* compress */, mesg);
+  const size_t body_pos = mesg->size();
+  // The custom payload precedes the body and is compressed along with it.
+  if (!custom_payload_.empty() && VersionIsCompatible(kV4Version)) {
+    SerializeBytesMap(custom_payload_, mesg);
+    (*mesg)[start_pos + kHeaderPosFlags] |= kCustomPayloadFlag;
+  }
+  SerializeBody(mesg);
+
+  // Compression is flagged per message, so small or incompressible bodies are sent as is.
+  const size_t body_size = mesg->size() - body_pos;
+  if (compression_scheme != CQLMessage::CompressionScheme::NONE && body_size > 0 &&
+      body_size >= static_cast<size_t>(FLAGS_cql_response_compression_min_bytes)) {
+    faststring compressed;
+    if (CompressBody(compression_scheme, Slice(mesg->data() + body_pos, body_size),
+                     &compressed)) {
+      mesg->resize(body_pos);
+      mesg->append(compressed.data(), compressed.size());
+      (*mesg)[start_pos + kHeaderPosFlags] |= kCompressionFlag;
     }
-  } else {
-    SerializeBody(mesg);
   }
   SERIALIZE_INT(
       mesg->data(), start_pos + kHeaderPosLength, mesg->size() - start_pos - kMessageHeaderLength);
 }
 
+RefCntBuffer CQLResponse::SerializeToBuffer(const CompressionScheme compression_scheme) const {
+  faststring mesg;
+  Serialize(compression_scheme, &mesg);
+  return RefCntBuffer(mesg);
+}
+
 void CQLResponse::SerializeHeader(const bool compress, faststring* mesg) const {
   uint8_t buffer[kMessageHeaderLength];
   SERIALIZE_BYTE(buffer, kHeaderPosVersion, version());
@@ -1480,13 +1528,40 @@ RowsResultResponse::RowsResultResponse(
 RowsResultResponse::~RowsResultResponse() {
 }
 
-void RowsResultResponse::SerializeResultBody(faststring* mesg) const {
+void RowsResultResponse::SerializeMetadata(faststring* mesg) const {
   SerializeRowsMetadata(
       RowsMetadata(result_->table_name(), result_->column_schemas(),
                    result_->paging_state(), skip_metadata_), mesg);
+}
+
+void RowsResultResponse::SerializeResultBody(faststring* mesg) const {
+  SerializeMetadata(mesg);
   mesg->append(result_->rows_data());
 }
 
+RefCntBuffer RowsResultResponse::SerializeToBuffer(
+    const CompressionScheme compression_scheme) const {
+  // The tablet servers return the rows already in the CQL wire format: only the header and the
+  // metadata are serialized here, and the rows are copied once, straight into the output buffer.
+  const std::string& rows_data = result_->rows_data();
+  faststring prefix;
+  SerializeHeader(false /* compress */, &prefix);
+  SerializeInt(static_cast<int32_t>(Kind::ROWS), &prefix);
+  SerializeMetadata(&prefix);
+  const size_t body_size = prefix.size() - kMessageHeaderLength + rows_data.size();
+  if (compression_scheme != CompressionScheme::NONE &&
+      body_size >= static_cast<size_t>(FLAGS_cql_response_compression_min_bytes)) {
+    // The body is compressed as a whole.
+    return ResultResponse::SerializeToBuffer(compression_scheme);
+  }
+
+  RefCntBuffer buffer(prefix.size() + rows_data.size());
+  memcpy(buffer.data(), prefix.data(), prefix.size());
+  memcpy(buffer.data() + prefix.size(), rows_data.data(), rows_data.size());
+  NetworkByteOrder::Store32(buffer.data() + kHeaderPosLength, static_cast<uint32_t>(body_size));
+  return buffer;
+}
+
 //----------------------------------------------------------------------------------------
 PreparedResultResponse::PreparedMetadata::PreparedMetadata() {
 }
@@ -32,6 +32,7 @@
 #include "yb/util/slice.h"
 #include "yb/util/status.h"
 #include "yb/util/net/sockaddr.h"
+#include "yb/util/ref_cnt_buffer.h"
 
 namespace yb {
 namespace cqlserver {
@@ -123,6 +124,10 @@ class CQLMessage {
   static constexpr char kLZ4Compression[] = "lz4";
   static constexpr char kSnappyCompression[] = "snappy";
 
+  // Custom payload entry carrying the read-your-writes token of a client, i.e. the hybrid time of
+  // its last write as an 8-byte big-endian number (Since V4).
+  static constexpr char kReadAfterHybridTimePayload[] = "yb_read_after_hybrid_time";
+
   // Basic datatype mapping for CQL message body:
   //   Int        -> int32_t
   //   Long       -> int64_t
@@ -237,6 +242,11 @@ class CQLRequest : public CQLMessage {
 
   virtual ~CQLRequest();
 
+  // The custom payload sent along with the request (Since V4).
+  const std::unordered_map<std::string, std::string>& custom_payload() const {
+    return custom_payload_;
+  }
+
  protected:
   CQLRequest(const Header& header, const Slice& body);
 
@@ -312,6 +322,7 @@ class CQLRequest : public CQLMessage {
 
  private:
   Slice body_;
+  std::unordered_map<std::string, std::string> custom_payload_;
 };
 
 // ------------------------------ Individual CQL requests -----------------------------------
@@ -465,6 +476,14 @@ class CQLResponse : public CQLMessage {
   virtual ~CQLResponse();
   virtual void Serialize(CompressionScheme compression_scheme, faststring* mesg) const;
 
+  // Serializes the response into a buffer to send to the client.
+  virtual RefCntBuffer SerializeToBuffer(CompressionScheme compression_scheme) const;
+
+  // Sets the custom payload to send along with the response. It is dropped for V3 clients.
+  void set_custom_payload(std::unordered_map<std::string, std::string> custom_payload) {
+    custom_payload_ = std::move(custom_payload);
+  }
+
  protected:
   CQLResponse(const CQLRequest& request, Opcode opcode);
   CQLResponse(StreamId stream_id, Opcode opcode);
@@ -472,6 +491,9 @@ class CQLResponse : public CQLMessage {
 
   // Function to serialize a response body that all CQLResponse subclasses need to implement
   virtual void SerializeBody(faststring* mesg) const = 0;
+
+ private:
+  std::unordered_map<std::string, std::string> custom_payload_;
 };
 
 // ------------------------------ Individual CQL responses -----------------------------------
@@ -724,10 +746,14 @@ class RowsResultResponse : public ResultResponse {
   RowsResultResponse(const ExecuteRequest& request, const ql::RowsResult::SharedPtr& result);
   virtual ~RowsResultResponse() override;
 
+  virtual RefCntBuffer SerializeToBuffer(CompressionScheme compression_scheme) const override;
+
  protected:
   virtual void SerializeResultBody(faststring* mesg) const override;
 
  private:
+  void SerializeMetadata(faststring* mesg) const;
+
   const ql::RowsResult::SharedPtr result_;
   const bool skip_metadata_;
 };
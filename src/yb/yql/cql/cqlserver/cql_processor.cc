@@ -15,12 +15,16 @@
 
 #include "yb/yql/cql/cqlserver/cql_processor.h"
 
+#include <unordered_map>
+
+#include "yb/gutil/endian.h"
 #include "yb/gutil/strings/escaping.h"
 
 #include "yb/rpc/connection.h"
 #include "yb/rpc/rpc_context.h"
 
 #include "yb/util/crypt.h"
+#include "yb/util/flag_tags.h"
 
 #include "yb/yql/cql/cqlserver/cql_service.h"
 
@@ -50,6 +54,16 @@ METRIC_DEFINE_histogram(
 METRIC_DEFINE_counter(
     server, yb_cqlserver_CQLServerService_ParsingErrors, "Errors encountered when parsing ",
     yb::MetricUnit::kRequests, "Errors encountered when parsing ");
+METRIC_DEFINE_counter(
+    server, yb_cqlserver_CQLServerService_QueryStatementsCacheHits,
+    "Unprepared queries executed using the cached analyzed statement",
+    yb::MetricUnit::kRequests,
+    "Unprepared queries executed using the cached analyzed statement");
+METRIC_DEFINE_counter(
+    server, yb_cqlserver_CQLServerService_QueryStatementsCacheMisses,
+    "Unprepared queries not found in the cache of analyzed statements",
+    yb::MetricUnit::kRequests,
+    "Unprepared queries not found in the cache of analyzed statements");
 METRIC_DEFINE_histogram(
     server, handler_latency_yb_cqlserver_CQLServerService_Any,
     "yb.cqlserver.CQLServerService.AnyMethod RPC Time", yb::MetricUnit::kMicroseconds,
@@ -63,6 +77,13 @@ namespace cqlserver {
 
 DEFINE_bool(use_cassandra_authentication, false, "If to require authentication on startup.");
 
+DEFINE_bool(cql_resume_on_reactor, false,
+            "Continue CQL statements on the reactor thread that completed their reads and writes, "
+            "instead of requeuing them to a CQL service thread. Statements that need to block, "
+            "e.g. to reanalyze against refreshed metadata, are still requeued.");
+TAG_FLAG(cql_resume_on_reactor, advanced);
+TAG_FLAG(cql_resume_on_reactor, runtime);
+
 const unordered_map<string, vector<string>> kSupportedOptions = {
   {CQLMessage::kCQLVersionOption, {"3.0.0" /* minimum */, "3.4.2" /* current */} },
   {CQLMessage::kCompressionOption, {CQLMessage::kLZ4Compression, CQLMessage::kSnappyCompression} }
@@ -111,6 +132,10 @@ CQLMetrics::CQLMetrics(const scoped_refptr<yb::MetricEntity>& metric_entity)
       METRIC_handler_latency_yb_cqlserver_CQLServerService_Any.Instantiate(metric_entity);
   num_errors_parsing_cql_ =
       METRIC_yb_cqlserver_CQLServerService_ParsingErrors.Instantiate(metric_entity);
+  num_query_stmts_cache_hits_ =
+      METRIC_yb_cqlserver_CQLServerService_QueryStatementsCacheHits.Instantiate(metric_entity);
+  num_query_stmts_cache_misses_ =
+      METRIC_yb_cqlserver_CQLServerService_QueryStatementsCacheMisses.Instantiate(metric_entity);
 }
 
 //------------------------------------------------------------------------------------------------
@@ -121,7 +146,8 @@ CQLProcessor::CQLProcessor(CQLServiceImpl* service_impl, const CQLProcessorListP
       service_impl_(service_impl),
       cql_metrics_(service_impl->cql_metrics()),
       pos_(pos),
-      statement_executed_cb_(Bind(&CQLProcessor::StatementExecuted, Unretained(this))) {
+      statement_executed_cb_(Bind(&CQLProcessor::StatementExecuted, Unretained(this))),
+      retry_request_cb_(Bind(&CQLProcessor::RetryRequest, Unretained(this))) {
 }
 
 CQLProcessor::~CQLProcessor() {
@@ -143,7 +169,7 @@ void CQLProcessor::ProcessCall(rpc::InboundCallPtr call) {
   if (!CQLRequest::ParseRequest(call_->serialized_request(), compression_scheme,
                                 &request, &response)) {
     cql_metrics_->num_errors_parsing_cql_->Increment();
-    SendResponse(*response);
+    SendResponse(response.get());
     service_impl_->ReturnProcessor(pos_);
     return;
   }
@@ -158,21 +184,39 @@ void CQLProcessor::ProcessCall(rpc::InboundCallPtr call) {
   call_->SetRequest(request_, service_impl_);
   retry_count_ = 0;
   unprepared_id_.clear();
+  // The token lets follower reads of the call see the writes the client made before, possibly
+  // through another proxy. A client asks for it by sending the payload entry, empty at first.
+  const auto& payload = request_->custom_payload();
+  const auto token = payload.find(CQLMessage::kReadAfterHybridTimePayload);
+  return_read_after_hybrid_time_ = token != payload.end();
+  ql_env_.SetReadAfterHybridTime(
+      return_read_after_hybrid_time_ && token->second.size() == sizeof(uint64_t)
+          ? NetworkByteOrder::Load64(token->second.data()) : YBClient::kNoHybridTime);
+  // Checking the password of an AUTH_RESPONSE is too expensive to do on a reactor thread.
+  ql_env_.set_resume_on_reactor(FLAGS_cql_resume_on_reactor &&
+                                request_->opcode() != CQLMessage::Opcode::AUTH_RESPONSE);
   response.reset(ProcessRequest(*request_));
   if (response != nullptr) {
-    SendResponse(*response);
+    SendResponse(response.get());
   }
 }
 
-void CQLProcessor::SendResponse(const CQLResponse& response) {
+void CQLProcessor::SendResponse(CQLResponse* response) {
   // Serialize the response to return to the CQL client. In case of error, an error response
   // should still be present.
   MonoTime response_begin = MonoTime::Now();
+  if (request_ != nullptr && return_read_after_hybrid_time_) {
+    const uint64_t read_after_hybrid_time = ql_env_.read_after_hybrid_time();
+    if (read_after_hybrid_time != YBClient::kNoHybridTime) {
+      string token(sizeof(read_after_hybrid_time), '\0');
+      NetworkByteOrder::Store64(&token[0], read_after_hybrid_time);
+      response->set_custom_payload({{CQLMessage::kReadAfterHybridTimePayload, std::move(token)}});
+    }
+  }
   const auto& context = static_cast<const CQLConnectionContext&>(call_->connection()->context());
   const auto compression_scheme = context.compression_scheme();
-  faststring msg;
-  response.Serialize(compression_scheme, &msg);
-  call_->RespondSuccess(RefCntBuffer(msg), cql_metrics_->rpc_method_metrics_);
+  call_->RespondSuccess(response->SerializeToBuffer(compression_scheme),
+                        cql_metrics_->rpc_method_metrics_);
 
   MonoTime response_done = MonoTime::Now();
   cql_metrics_->time_to_process_request_->Increment(
@@ -188,6 +232,7 @@ void CQLProcessor::SendResponse(const CQLResponse& response) {
   call_ = nullptr;
   request_ = nullptr;
   stmts_.clear();
+  query_stmts_.clear();
   parse_trees_.clear();
   SetCurrentCall(nullptr);
   Return();
@@ -302,6 +347,17 @@ CQLResponse* CQLProcessor::ProcessRequest(const ExecuteRequest& req) {
 
 CQLResponse* CQLProcessor::ProcessRequest(const QueryRequest& req) {
   VLOG(1) << "QUERY " << req.query();
+  if (service_impl_->query_stmts_cache_enabled()) {
+    Status s;
+    const shared_ptr<const CQLStatement> stmt = GetQueryStatement(req.query(), &s);
+    if (stmt != nullptr) {
+      s = stmt->ExecuteAsync(this, req.params(), statement_executed_cb_);
+    }
+    if (PREDICT_FALSE(!s.ok())) {
+      StatementExecuted(s);
+    }
+    return nullptr;
+  }
   RunAsync(req.query(), req.params(), statement_executed_cb_);
   return nullptr;
 }
@@ -313,6 +369,10 @@ CQLResponse* CQLProcessor::ProcessRequest(const BatchRequest& req) {
 
   BeginBatch(statement_executed_cb_);
 
+  // Parse trees of the unprepared queries of this batch by query text, so that a query repeated
+  // in the batch is analyzed only once when the query statements cache is disabled.
+  std::unordered_map<std::string, const ql::ParseTree*> batch_parse_trees;
+
   for (const BatchRequest::Query& query : req.queries()) {
 
     if (query.is_prepared) {
@@ -329,12 +389,32 @@ CQLResponse* CQLProcessor::ProcessRequest(const BatchRequest& req) {
         }
       }
 
+    } else if (service_impl_->query_stmts_cache_enabled()) {
+
+      VLOG(1) << "BATCH QUERY " << query.query;
+      Status s;
+      const shared_ptr<const CQLStatement> stmt = GetQueryStatement(query.query, &s);
+      if (stmt != nullptr) {
+        s = stmt->ExecuteBatch(this, query.params);
+      }
+      if (PREDICT_FALSE(!s.ok())) {
+        StatementExecuted(s);
+      }
+
     } else {
 
       VLOG(1) << "BATCH QUERY " << query.query;
-      ql::ParseTree::UniPtr parse_tree;
-      RunBatch(query.query, query.params, &parse_tree, retry_count > 0);
-      parse_trees_.insert(std::move(parse_tree));
+      const auto it = batch_parse_trees.find(query.query);
+      if (it != batch_parse_trees.end()) {
+        ExecuteBatch(query.query, *it->second, query.params);
+      } else {
+        ql::ParseTree::UniPtr parse_tree;
+        RunBatch(query.query, query.params, &parse_tree, retry_count > 0);
+        if (parse_tree != nullptr) {
+          batch_parse_trees.emplace(query.query, parse_tree.get());
+        }
+        parse_trees_.insert(std::move(parse_tree));
+      }
 
     }
 
@@ -383,11 +463,44 @@ shared_ptr<const CQLStatement> CQLProcessor::GetPreparedStatement(const CQLMessa
   return stmt;
 }
 
+shared_ptr<const CQLStatement> CQLProcessor::GetQueryStatement(const string& query, Status* s) {
+  const CQLMessage::QueryId query_id = CQLStatement::GetQueryId(ql_env_.CurrentKeyspace(), query);
+  shared_ptr<CQLStatement> stmt = service_impl_->AllocateQueryStatement(
+      query_id, ql_env_.CurrentKeyspace(), query);
+  if (stmt->unprepared()) {
+    cql_metrics_->num_query_stmts_cache_misses_->Increment();
+  } else {
+    cql_metrics_->num_query_stmts_cache_hits_->Increment();
+  }
+
+  // Only DML statements are kept in the cache. Other statements are still executed using the
+  // statement prepared here, so that the query is not parsed again.
+  PreparedResult::UniPtr result;
+  *s = stmt->Prepare(this, nullptr /* mem_tracker */, &result);
+  if (!s->ok() || result == nullptr) {
+    service_impl_->DeleteQueryStatement(stmt);
+    if (!s->ok()) {
+      return nullptr;
+    }
+  }
+
+  stmt->clear_reparsed();
+  query_stmts_.insert(stmt);
+  return stmt;
+}
+
+void CQLProcessor::RetryRequest() {
+  unique_ptr<CQLResponse> response(ProcessRequest(*request_));
+  if (response != nullptr) {
+    SendResponse(response.get());
+  }
+}
+
 void CQLProcessor::StatementExecuted(const Status& s,
                                      const ql::ExecutedResult::SharedPtr& result) {
   unique_ptr<CQLResponse> response(ProcessResult(s, result));
   if (response != nullptr) {
-    SendResponse(*response);
+    SendResponse(response.get());
   }
 }
 
@@ -412,12 +525,25 @@ CQLResponse* CQLProcessor::ProcessResult(Status s, const ExecutedResult::SharedP
             unprepared_id_ = stmt->query_id();
           }
         }
+        // Cached query statements are unknown to the client, so just delete the stale ones and
+        // let the retry below analyze the query again.
+        for (const auto& stmt : query_stmts_) {
+          if (stmt->stale()) {
+            service_impl_->DeleteQueryStatement(stmt);
+          }
+        }
         if (!unprepared_id_.empty()) {
           return new UnpreparedErrorResponse(*request_, unprepared_id_);
         }
         // When no unprepared_id is found, it means all statements we executed were queries
         // (non-prepared statements). In that case, just retry the request (once only).
         if (++retry_count_ == 1) {
+          if (ql_env_.on_reactor_thread()) {
+            // Analyzing the query again may fetch table metadata synchronously, which must not be
+            // done on a reactor thread.
+            ql_env_.RequeueCurrentCall(&retry_request_cb_);
+            return nullptr;
+          }
           return ProcessRequest(*request_);
         }
         return new ErrorResponse(*request_, ErrorResponse::Code::INVALID,
@@ -45,6 +45,8 @@ class CQLMetrics : public ql::QLMetrics {
 
   scoped_refptr<yb::Histogram> time_to_queue_cql_response_;
   scoped_refptr<yb::Counter> num_errors_parsing_cql_;
+  scoped_refptr<yb::Counter> num_query_stmts_cache_hits_;
+  scoped_refptr<yb::Counter> num_query_stmts_cache_misses_;
   // Rpc level metrics
   yb::rpc::RpcMethodMetrics rpc_method_metrics_;
 };
@@ -81,6 +83,14 @@ class CQLProcessor : public ql::QLProcessor {
   // Get a prepared statement and adds it to the set of statements currently being executed.
   std::shared_ptr<const CQLStatement> GetPreparedStatement(const CQLMessage::QueryId& id);
 
+  // Get an analyzed query statement from the query statements cache, preparing it on cache miss,
+  // and adds it to the set of query statements currently being executed. Nullptr will be returned
+  // if the query could not be prepared, with the error status stored in *s.
+  std::shared_ptr<const CQLStatement> GetQueryStatement(const std::string& query, Status* s);
+
+  // Process the current request again, on the server's handler thread.
+  void RetryRequest();
+
   // Statement executed callback.
   void StatementExecuted(const Status& s, const ql::ExecutedResult::SharedPtr& result = nullptr);
 
@@ -88,7 +98,7 @@ class CQLProcessor : public ql::QLProcessor {
   CQLResponse* ProcessResult(Status s, const ql::ExecutedResult::SharedPtr& result = nullptr);
 
   // Send response back to client.
-  void SendResponse(const CQLResponse& response);
+  void SendResponse(CQLResponse* response);
 
   // Return Processor back to Service.
   void Return();
@@ -108,11 +118,15 @@ class CQLProcessor : public ql::QLProcessor {
   CQLInboundCallPtr call_;
   std::shared_ptr<const CQLRequest> request_;
   std::unordered_set<std::shared_ptr<const CQLStatement>> stmts_;
+  std::unordered_set<std::shared_ptr<const CQLStatement>> query_stmts_;
   std::unordered_set<ql::ParseTree::UniPtr> parse_trees_;
 
   // Current retry count.
   int retry_count_ = 0;
 
+  // Whether the client of the current call asked for its read-your-writes token in the response.
+  bool return_read_after_hybrid_time_ = false;
+
   // Unprepared query id being executed.
   CQLMessage::QueryId unprepared_id_;
 
@@ -123,6 +137,9 @@ class CQLProcessor : public ql::QLProcessor {
   // Statement executed callback.
   ql::StatementExecutedCallback statement_executed_cb_;
 
+  // Callback to retry the current request after it is requeued from a reactor thread.
+  Callback<void(void)> retry_request_cb_;
+
   //----------------------------------------------------------------------------------------------
 };
 
@@ -16,8 +16,12 @@
 #include <mutex>
 #include <thread>
 
+#include <boost/thread/shared_mutex.hpp>
+
 #include "yb/gutil/strings/join.h"
 
+#include "yb/client/meta_data_cache.h"
+
 #include "yb/yql/cql/cqlserver/cql_processor.h"
 #include "yb/yql/cql/cqlserver/cql_rpc.h"
 #include "yb/yql/cql/cqlserver/cql_server.h"
@@ -32,6 +36,9 @@
 DEFINE_int64(cql_service_max_prepared_statement_size_bytes, 0,
              "The maximum amount of memory the CQL proxy should use to maintain prepared "
              "statements. 0 or negative means unlimited.");
+DEFINE_int32(cql_service_max_cached_query_statements, 0,
+             "The maximum number of analyzed unprepared statements the CQL proxy should cache "
+             "for reuse by identical queries. 0 or negative disables the cache.");
 DEFINE_int32(cql_ybclient_reactor_threads, 24,
              "The number of reactor threads to be used for processing ybclient "
              "requests originating in the cql layer");
@@ -52,6 +59,26 @@ using yb::client::YBSession;
 using yb::client::YBMetaDataCache;
 using yb::rpc::InboundCall;
 
+namespace {
+
+// Remove statement from the statement map and the LRU list. The map entry is removed only when it
+// is the same statement object. "stmt" is passed by value, so that it stays valid while the very
+// shared_ptr in the map or the list is deleted.
+void DeleteStatementUnlocked(
+    const shared_ptr<const CQLStatement> stmt, CQLStatementMap* map, CQLStatementList* list) {
+  const auto itr = map->find(stmt->query_id());
+  if (itr != map->end() && itr->second == stmt) {
+    map->erase(itr);
+  }
+  // Remove statement from LRU list only when it is in the list, i.e. pos() != end().
+  if (stmt->pos() != list->end()) {
+    list->erase(stmt->pos());
+    stmt->set_pos(list->end());
+  }
+}
+
+} // namespace
+
 CQLServiceImpl::CQLServiceImpl(CQLServer* server, const CQLServerOptions& opts)
     : CQLServerServiceIf(server->metric_entity()),
       server_(server),
@@ -156,7 +183,7 @@ void CQLServiceImpl::ReturnProcessor(const CQLProcessorListPos& pos) {
 shared_ptr<CQLStatement> CQLServiceImpl::AllocatePreparedStatement(
     const CQLMessage::QueryId& query_id, const string& keyspace, const string& ql_stmt) {
   // Get exclusive lock before allocating a prepared statement and updating the LRU list.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
+  std::lock_guard<rw_spinlock> guard(prepared_stmts_mutex_);
 
   shared_ptr<CQLStatement> stmt;
   const auto itr = prepared_stmts_map_.find(query_id);
@@ -171,7 +198,7 @@ shared_ptr<CQLStatement> CQLServiceImpl::AllocatePreparedStatement(
   } else {
     // Return existing statement if found.
     stmt = itr->second;
-    MoveLruPreparedStatementUnlocked(stmt);
+    stmt->MarkReferenced();
   }
 
   VLOG(1) << "InsertPreparedStatement: CQL prepared statement cache count = "
@@ -183,33 +210,37 @@ shared_ptr<CQLStatement> CQLServiceImpl::AllocatePreparedStatement(
 
 shared_ptr<const CQLStatement> CQLServiceImpl::GetPreparedStatement(
     const CQLMessage::QueryId& query_id) {
-  // Get exclusive lock before looking up a prepared statement and updating the LRU list.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
+  shared_ptr<CQLStatement> stmt;
+  {
+    // A shared lock is enough to look up a prepared statement: the LRU list is not reordered here,
+    // the statement is just marked referenced.
+    boost::shared_lock<rw_spinlock> guard(prepared_stmts_mutex_);
 
-  const auto itr = prepared_stmts_map_.find(query_id);
-  if (itr == prepared_stmts_map_.end()) {
-    return nullptr;
-  }
+    const auto itr = prepared_stmts_map_.find(query_id);
+    if (itr == prepared_stmts_map_.end()) {
+      return nullptr;
+    }
 
-  shared_ptr<CQLStatement> stmt = itr->second;
+    stmt = itr->second;
 
-  // If the statement has not finished preparing, do not return it.
-  if (stmt->unprepared()) {
-    return nullptr;
-  }
-  // If the statement is stale, delete it.
-  if (stmt->stale()) {
-    DeletePreparedStatementUnlocked(stmt);
-    return nullptr;
+    // If the statement has not finished preparing, do not return it.
+    if (stmt->unprepared()) {
+      return nullptr;
+    }
+    if (!stmt->stale()) {
+      stmt->MarkReferenced();
+      return stmt;
+    }
   }
 
-  MoveLruPreparedStatementUnlocked(stmt);
-  return stmt;
+  // The statement is stale, delete it.
+  DeletePreparedStatement(stmt);
+  return nullptr;
 }
 
 void CQLServiceImpl::DeletePreparedStatement(const shared_ptr<const CQLStatement>& stmt) {
   // Get exclusive lock before deleting the prepared statement.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
+  std::lock_guard<rw_spinlock> guard(prepared_stmts_mutex_);
 
   DeletePreparedStatementUnlocked(stmt);
 
@@ -223,32 +254,29 @@ void CQLServiceImpl::InsertLruPreparedStatementUnlocked(const shared_ptr<CQLStat
   stmt->set_pos(prepared_stmts_list_.insert(prepared_stmts_list_.begin(), stmt));
 }
 
-void CQLServiceImpl::MoveLruPreparedStatementUnlocked(const shared_ptr<CQLStatement>& stmt) {
-  // Move the statement to the front of the LRU list.
-  prepared_stmts_list_.splice(prepared_stmts_list_.begin(), prepared_stmts_list_, stmt->pos());
-}
-
 void CQLServiceImpl::DeletePreparedStatementUnlocked(
     const std::shared_ptr<const CQLStatement> stmt) {
   // Remove statement from cache by looking it up by query ID and only when it is same statement
   // object. Note that the "stmt" parameter above is not a ref ("&") intentionally so that we have
   // a separate copy of the shared_ptr and not the very shared_ptr in prepared_stmts_map_ or
   // prepared_stmt_list_ we are deleting.
-  const auto itr = prepared_stmts_map_.find(stmt->query_id());
-  if (itr != prepared_stmts_map_.end() && itr->second == stmt) {
-    prepared_stmts_map_.erase(itr);
-  }
-  // Remove statement from LRU list only when it is in the list, i.e. pos() != end().
-  if (stmt->pos() != prepared_stmts_list_.end()) {
-    prepared_stmts_list_.erase(stmt->pos());
-    stmt->set_pos(prepared_stmts_list_.end());
-  }
+  DeleteStatementUnlocked(stmt, &prepared_stmts_map_, &prepared_stmts_list_);
 }
 
 void CQLServiceImpl::DeleteLruPreparedStatement() {
   // Get exclusive lock before deleting the least recently used statement at the end of the LRU
   // list from the cache.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
+  std::lock_guard<rw_spinlock> guard(prepared_stmts_mutex_);
+
+  // Give statements used since the last scan a second chance. After one full pass every mark is
+  // cleared, so this terminates.
+  for (size_t n = prepared_stmts_list_.size(); n > 0; --n) {
+    const auto pos = std::prev(prepared_stmts_list_.end());
+    if (!(*pos)->TestAndClearReferenced()) {
+      break;
+    }
+    prepared_stmts_list_.splice(prepared_stmts_list_.begin(), prepared_stmts_list_, pos);
+  }
 
   if (!prepared_stmts_list_.empty()) {
     DeletePreparedStatementUnlocked(prepared_stmts_list_.back());
@@ -259,5 +287,44 @@ void CQLServiceImpl::DeleteLruPreparedStatement() {
           << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
 }
 
+bool CQLServiceImpl::query_stmts_cache_enabled() const {
+  return FLAGS_cql_service_max_cached_query_statements > 0;
+}
+
+shared_ptr<CQLStatement> CQLServiceImpl::AllocateQueryStatement(
+    const CQLMessage::QueryId& query_id, const string& keyspace, const string& ql_stmt) {
+  std::lock_guard<std::mutex> guard(query_stmts_mutex_);
+
+  const auto itr = query_stmts_map_.find(query_id);
+  if (itr != query_stmts_map_.end()) {
+    shared_ptr<CQLStatement> stmt = itr->second;
+    if (!stmt->unprepared() && stmt->stale()) {
+      DeleteStatementUnlocked(stmt, &query_stmts_map_, &query_stmts_list_);
+    } else {
+      // Move the statement to the front of the LRU list.
+      query_stmts_list_.splice(query_stmts_list_.begin(), query_stmts_list_, stmt->pos());
+      return stmt;
+    }
+  }
+
+  // Allocate the statement placeholder, the same way as for prepared statements, so that clients
+  // running the same new query in parallel wait for one of them to analyze it.
+  auto stmt = std::make_shared<CQLStatement>(keyspace, ql_stmt, query_stmts_list_.end());
+  query_stmts_map_.emplace(query_id, stmt);
+  stmt->set_pos(query_stmts_list_.insert(query_stmts_list_.begin(), stmt));
+
+  while (query_stmts_list_.size() >
+             static_cast<size_t>(FLAGS_cql_service_max_cached_query_statements)) {
+    DeleteStatementUnlocked(query_stmts_list_.back(), &query_stmts_map_, &query_stmts_list_);
+  }
+
+  return stmt;
+}
+
+void CQLServiceImpl::DeleteQueryStatement(const shared_ptr<const CQLStatement>& stmt) {
+  std::lock_guard<std::mutex> guard(query_stmts_mutex_);
+  DeleteStatementUnlocked(stmt, &query_stmts_map_, &query_stmts_list_);
+}
+
 }  // namespace cqlserver
 }  // namespace yb
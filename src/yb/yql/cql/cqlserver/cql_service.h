@@ -27,6 +27,7 @@
 #include "yb/yql/cql/cqlserver/cql_server_options.h"
 #include "yb/yql/cql/ql/statement.h"
 
+#include "yb/util/locks.h"
 #include "yb/util/string_case.h"
 
 #include "yb/client/async_initializer.h"
@@ -72,6 +73,17 @@ class CQLServiceImpl : public CQLServerServiceIf {
   // Delete the prepared statement from the cache.
   void DeletePreparedStatement(const std::shared_ptr<const CQLStatement>& stmt);
 
+  // Whether analyzed unprepared (QUERY) statements are cached.
+  bool query_stmts_cache_enabled() const;
+
+  // Allocate a cached query statement. If the statement already exists and is not stale, return
+  // it instead.
+  std::shared_ptr<CQLStatement> AllocateQueryStatement(
+      const CQLMessage::QueryId& id, const std::string& keyspace, const std::string& ql_stmt);
+
+  // Delete the cached query statement.
+  void DeleteQueryStatement(const std::shared_ptr<const CQLStatement>& stmt);
+
   // Return the memory tracker for prepared statements.
   std::shared_ptr<MemTracker> prepared_stmts_mem_tracker() const {
     return prepared_stmts_mem_tracker_;
@@ -102,15 +114,12 @@ class CQLServiceImpl : public CQLServerServiceIf {
   // locked before this call.
   void InsertLruPreparedStatementUnlocked(const std::shared_ptr<CQLStatement>& stmt);
 
-  // Move a prepared statement to the front of the LRU list. "prepared_stmts_mutex_" needs to be
-  // locked before this call.
-  void MoveLruPreparedStatementUnlocked(const std::shared_ptr<CQLStatement>& stmt);
-
   // Delete a prepared statement from the cache and the LRU list. "prepared_stmts_mutex_" needs to
   // be locked before this call.
   void DeletePreparedStatementUnlocked(const std::shared_ptr<const CQLStatement> stmt);
 
-  // Delete the least recently used prepared statement from the cache to free up memory.
+  // Delete the least recently used prepared statement from the cache to free up memory. Statements
+  // used since the last scan get a second chance and are moved back to the front of the list.
   void DeleteLruPreparedStatement();
 
   // CQLServer of this service.
@@ -137,11 +146,21 @@ class CQLServiceImpl : public CQLServerServiceIf {
   // Prepared statements cache.
   CQLStatementMap prepared_stmts_map_;
 
-  // Prepared statements LRU list (least recently used one at the end).
+  // Prepared statements LRU list (least recently used one at the end). Lookups do not reorder the
+  // list but mark the statement referenced, so that EXECUTE only needs a shared lock.
   CQLStatementList prepared_stmts_list_;
 
-  // Mutex that protects the prepared statements and the LRU list.
-  std::mutex prepared_stmts_mutex_;
+  // Lock that protects the prepared statements and the LRU list. Lookups take it shared.
+  rw_spinlock prepared_stmts_mutex_;
+
+  // Cache of analyzed unprepared (QUERY) statements, keyed by keyspace and query text.
+  CQLStatementMap query_stmts_map_;
+
+  // Query statements LRU list (least recently used one at the end).
+  CQLStatementList query_stmts_list_;
+
+  // Mutex that protects the query statements and the LRU list.
+  std::mutex query_stmts_mutex_;
 
   std::shared_ptr<ql::Statement> auth_prepared_stmt_;
 
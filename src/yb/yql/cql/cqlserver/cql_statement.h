@@ -19,6 +19,7 @@
 #ifndef YB_YQL_CQL_CQLSERVER_CQL_STATEMENT_H_
 #define YB_YQL_CQL_CQLSERVER_CQL_STATEMENT_H_
 
+#include <atomic>
 #include <list>
 
 #include "yb/yql/cql/cqlserver/cql_message.h"
@@ -51,12 +52,24 @@ class CQLStatement : public ql::Statement {
   CQLStatementListPos pos() const { return pos_; }
   void set_pos(CQLStatementListPos pos) const { pos_ = pos; }
 
+  // Mark the statement as used since the LRU list was last scanned. Unlike moving the statement in
+  // the list, this is safe to do while holding only a shared lock on the list.
+  void MarkReferenced() const { referenced_.store(true, std::memory_order_relaxed); }
+
+  // Return whether the statement was used since the last call, and clear the mark.
+  bool TestAndClearReferenced() const {
+    return referenced_.exchange(false, std::memory_order_relaxed);
+  }
+
   // Return the query id of a statement.
   static CQLMessage::QueryId GetQueryId(const std::string& keyspace, const std::string& ql_stmt);
 
  private:
   // Position of the statement in the LRU.
   mutable CQLStatementListPos pos_;
+
+  // Whether the statement was used since the LRU list was last scanned.
+  mutable std::atomic<bool> referenced_{false};
 };
 
 }  // namespace cqlserver
@@ -11,6 +11,10 @@
 // under the License.
 //
 
+#include <lz4.h>
+#include <snappy.h>
+
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
@@ -22,6 +26,8 @@
 #include "yb/yql/cql/cqlserver/cql_server.h"
 
 #include "yb/gutil/strings/join.h"
+#include "yb/gutil/casts.h"
+#include "yb/gutil/endian.h"
 #include "yb/util/cast.h"
 #include "yb/util/net/net_util.h"
 #include "yb/util/test_util.h"
@@ -250,5 +256,121 @@ TEST_F(TestCQLService, TestCQLServerEventConst) {
   ASSERT_EQ(0, memcmp(buffer, ptr, kSize));
 }
 
+namespace {
+
+// Returns a REGISTER request whose body is compressed with the given function.
+template <class Compress>
+string CompressedRegisterRequest(const Compress& compress) {
+  const string body = BINARY_STRING("\x00\x01" "\x00\x0d" "SCHEMA_CHANGE");
+  const string compressed = compress(body);
+  string mesg = BINARY_STRING("\x04\x01\x00\x00\x0b" "\x00\x00\x00\x00");
+  NetworkByteOrder::Store32(&mesg[CQLMessage::kHeaderPosLength], compressed.size());
+  return mesg + compressed;
+}
+
+string Lz4Compress(const string& data) {
+  string result(sizeof(uint32_t) + LZ4_compressBound(data.size()), '\0');
+  NetworkByteOrder::Store32(&result[0], data.size());
+  const int size = LZ4_compress_default(
+      data.data(), &result[sizeof(uint32_t)], data.size(), result.size() - sizeof(uint32_t));
+  result.resize(sizeof(uint32_t) + size);
+  return result;
+}
+
+string SnappyCompress(const string& data) {
+  string result;
+  snappy::Compress(data.data(), data.size(), &result);
+  return result;
+}
+
+} // namespace
+
+TEST_F(TestCQLService, CompressedRequest) {
+  unique_ptr<CQLRequest> request;
+  unique_ptr<CQLResponse> error_response;
+  ASSERT_TRUE(CQLRequest::ParseRequest(
+      CompressedRegisterRequest(Lz4Compress), CQLMessage::CompressionScheme::LZ4,
+      &request, &error_response));
+  ASSERT_EQ(CQLMessage::Opcode::REGISTER, request->opcode());
+  ASSERT_TRUE(CQLRequest::ParseRequest(
+      CompressedRegisterRequest(SnappyCompress), CQLMessage::CompressionScheme::SNAPPY,
+      &request, &error_response));
+  ASSERT_EQ(CQLMessage::Opcode::REGISTER, request->opcode());
+
+  // Corrupt and oversized compressed bodies are rejected.
+  const auto corrupt = [](const string& data) { return string(data.size(), '\xff'); };
+  ASSERT_FALSE(CQLRequest::ParseRequest(
+      CompressedRegisterRequest(corrupt), CQLMessage::CompressionScheme::SNAPPY,
+      &request, &error_response));
+  ASSERT_NE(nullptr, error_response);
+  const auto oversized = [](const string& data) {
+    string result = Lz4Compress(data);
+    NetworkByteOrder::Store32(&result[0], std::numeric_limits<uint32_t>::max());
+    return result;
+  };
+  ASSERT_FALSE(CQLRequest::ParseRequest(
+      CompressedRegisterRequest(oversized), CQLMessage::CompressionScheme::LZ4,
+      &request, &error_response));
+  ASSERT_NE(nullptr, error_response);
+}
+
+TEST_F(TestCQLService, CompressedResponse) {
+  const ErrorResponse small(0, ErrorResponse::Code::SERVER_ERROR, "small");
+  const ErrorResponse large(0, ErrorResponse::Code::SERVER_ERROR, string(4096, 'a'));
+
+  for (auto scheme : {CQLMessage::CompressionScheme::LZ4, CQLMessage::CompressionScheme::SNAPPY}) {
+    faststring plain;
+    large.Serialize(CQLMessage::CompressionScheme::NONE, &plain);
+    faststring compressed;
+    large.Serialize(scheme, &compressed);
+    ASSERT_TRUE(compressed[CQLMessage::kHeaderPosFlags] & CQLMessage::kCompressionFlag);
+    ASSERT_LT(compressed.size(), plain.size());
+
+    // The uncompressed body matches the body of the uncompressed response.
+    const char* comp_body = to_char_ptr(compressed.data()) + CQLMessage::kMessageHeaderLength;
+    const size_t comp_body_size = compressed.size() - CQLMessage::kMessageHeaderLength;
+    const string plain_body(to_char_ptr(plain.data()) + CQLMessage::kMessageHeaderLength,
+                            plain.size() - CQLMessage::kMessageHeaderLength);
+    string body;
+    if (scheme == CQLMessage::CompressionScheme::LZ4) {
+      body.resize(NetworkByteOrder::Load32(comp_body));
+      ASSERT_EQ(static_cast<int>(body.size()), LZ4_decompress_safe(comp_body + sizeof(uint32_t), &body[0],
+                                                 comp_body_size - sizeof(uint32_t), body.size()));
+    } else {
+      ASSERT_TRUE(snappy::Uncompress(comp_body, comp_body_size, &body));
+    }
+    ASSERT_EQ(plain_body, body);
+
+    // Small bodies are not worth compressing.
+    faststring small_mesg;
+    small.Serialize(scheme, &small_mesg);
+    ASSERT_FALSE(small_mesg[CQLMessage::kHeaderPosFlags] & CQLMessage::kCompressionFlag);
+  }
+}
+
+TEST_F(TestCQLService, RowsResultResponseBuffer) {
+  unique_ptr<CQLRequest> request;
+  unique_ptr<CQLResponse> error_response;
+  ASSERT_TRUE(CQLRequest::ParseRequest(
+      BINARY_STRING("\x04\x00\x00\x01\x07" "\x00\x00\x00\x0f"
+                    "\x00\x00\x00\x08" "SELECT 1" "\x00\x01" "\x00"),
+      CQLMessage::CompressionScheme::NONE, &request, &error_response));
+  // One row with a 1000-byte value.
+  const string rows_data = BINARY_STRING("\x00\x00\x00\x01" "\x00\x00\x03\xe8") +
+                           string(1000, 'r');
+  auto result = std::make_shared<ql::RowsResult>(
+      client::YBTableName("ks", "t"),
+      std::make_shared<vector<ColumnSchema>>(vector<ColumnSchema>{ColumnSchema("v", STRING)}),
+      rows_data);
+  const RowsResultResponse response(down_cast<const QueryRequest&>(*request), result);
+
+  // The response serialized straight into the output buffer matches the generic serialization.
+  for (auto scheme : {CQLMessage::CompressionScheme::NONE, CQLMessage::CompressionScheme::LZ4}) {
+    faststring expected;
+    response.Serialize(scheme, &expected);
+    ASSERT_EQ(expected.ToString(), response.SerializeToBuffer(scheme).ToBuffer());
+  }
+}
+
 }  // namespace cqlserver
 }  // namespace yb
@@ -85,5 +85,93 @@ CHECKED_STATUS Executor::ColumnArgsToPB(const shared_ptr<client::YBTable>& table
   return Status::OK();
 }
 
+const WriteRequestTemplate* Executor::GetWriteRequestTemplate(const PTDmlStmt *tnode) {
+  if (!tnode->write_request_template_set()) {
+    // A statement without bind variables is usually executed once, a template would not pay off.
+    tnode->set_write_request_template(
+        tnode->bind_variables().empty() ? nullptr : BuildWriteRequestTemplate(tnode));
+  }
+  return tnode->write_request_template();
+}
+
+shared_ptr<const WriteRequestTemplate> Executor::BuildWriteRequestTemplate(
+    const PTDmlStmt *tnode) {
+  if (!tnode->subscripted_col_args().empty()) {
+    return nullptr;
+  }
+
+  auto result = std::make_shared<WriteRequestTemplate>();
+  QLWriteRequestPB *req = &result->request;
+  for (const ColumnArg& col : tnode->column_args()) {
+    if (!col.IsInitialized()) {
+      continue;
+    }
+
+    // Other expressions, including collections that may contain bind variables, are evaluated
+    // on every execution.
+    const ExprOperator expr_op = col.expr()->expr_op();
+    if (expr_op != ExprOperator::kConst && expr_op != ExprOperator::kBindVar) {
+      return nullptr;
+    }
+
+    const ColumnDesc *col_desc = col.desc();
+    QLExpressionPB *expr_pb;
+    WriteRequestTemplate::Section section;
+    int index;
+    if (col_desc->is_hash()) {
+      section = WriteRequestTemplate::Section::kHashedColumn;
+      index = req->hashed_column_values_size();
+      expr_pb = req->add_hashed_column_values();
+    } else if (col_desc->is_primary()) {
+      section = WriteRequestTemplate::Section::kRangeColumn;
+      index = req->range_column_values_size();
+      expr_pb = req->add_range_column_values();
+    } else {
+      section = WriteRequestTemplate::Section::kRegularColumn;
+      index = req->column_values_size();
+      QLColumnValuePB* col_pb = req->add_column_values();
+      col_pb->set_column_id(col_desc->id());
+      expr_pb = col_pb->mutable_expr();
+    }
+
+    if (expr_op == ExprOperator::kBindVar) {
+      result->bind_var_slots.push_back({static_cast<const PTBindVar*>(col.expr().get()), section,
+                                        index, col_desc->is_primary()});
+    } else if (!PTExprToPB(col.expr(), expr_pb).ok() ||
+               (col_desc->is_primary() && expr_pb->has_value() && IsNull(expr_pb->value()))) {
+      // Leave it to ColumnArgsToPB to report the error on every execution.
+      return nullptr;
+    }
+  }
+
+  if (!ColumnRefsToPB(tnode, req->mutable_column_refs()).ok()) {
+    return nullptr;
+  }
+  return result;
+}
+
+CHECKED_STATUS Executor::WriteRequestTemplateToPB(const WriteRequestTemplate& request_template,
+                                                  QLWriteRequestPB *req) {
+  // The request has no column values yet, so the slot indexes are also valid in it.
+  req->MergeFrom(request_template.request);
+  for (const WriteRequestTemplate::BindVarSlot& slot : request_template.bind_var_slots) {
+    QLExpressionPB *expr_pb;
+    if (slot.section == WriteRequestTemplate::Section::kHashedColumn) {
+      expr_pb = req->mutable_hashed_column_values(slot.index);
+    } else if (slot.section == WriteRequestTemplate::Section::kRangeColumn) {
+      expr_pb = req->mutable_range_column_values(slot.index);
+    } else {
+      expr_pb = req->mutable_column_values(slot.index)->mutable_expr();
+    }
+
+    RETURN_NOT_OK(PTExprToPB(slot.bind_var, expr_pb));
+    if (slot.is_primary && expr_pb->has_value() && IsNull(expr_pb->value())) {
+      LOG(INFO) << "Unexpected null value. Current request: " << req->DebugString();
+      return exec_context_->Error(ErrorCode::NULL_ARGUMENT_FOR_PRIMARY_KEY);
+    }
+  }
+  return Status::OK();
+}
+
 }  // namespace ql
 }  // namespace yb
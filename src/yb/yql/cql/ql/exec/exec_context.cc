@@ -16,6 +16,8 @@
 #include "yb/yql/cql/ql/exec/exec_context.h"
 #include "yb/yql/cql/ql/ptree/pt_select.h"
 #include "yb/client/callbacks.h"
+#include "yb/client/client.h"
+#include "yb/client/yb_op.h"
 
 namespace yb {
 namespace ql {
@@ -110,5 +112,64 @@ void ExecContext::AdvanceToNextPartition(QLReadRequestPB *req) {
   }
 }
 
+Status ExecContext::ApplyPartitionReads(const std::shared_ptr<client::YBqlReadOp>& op,
+                                        uint64_t max_partitions) {
+  const uint64_t partitions_count = std::min(UnreadPartitionsRemaining(), max_partitions);
+  if (partitions_count <= 1) {
+    return Apply(op);
+  }
+
+  op_ = op;
+  partition_ops_.clear();
+  partition_ops_.reserve(partitions_count);
+  partition_ops_.push_back(op);
+  RETURN_NOT_OK(ql_env_->Apply(op));
+
+  // Each following partition op is a copy of the previous one advanced to the next partition. Only
+  // the current partition may be resuming a prior read, so the paging state is not carried over.
+  const uint64_t start_partition = current_partition_index_;
+  const auto& table = static_cast<const PTSelectStmt*>(tnode())->table();
+  for (uint64_t i = 1; i < partitions_count; i++) {
+    std::shared_ptr<client::YBqlReadOp> partition_op(table->NewQLSelect());
+    QLReadRequestPB *req = partition_op->mutable_request();
+    req->CopyFrom(partition_ops_.back()->request());
+    req->set_request_id(reinterpret_cast<uint64_t>(partition_op.get()));
+    req->clear_paging_state();
+    req->clear_hash_code();
+    req->clear_max_hash_code();
+    AdvanceToNextPartition(req);
+    partition_op->set_yb_consistency_level(op->yb_consistency_level());
+    partition_op->set_max_staleness_ms(op->max_staleness_ms());
+    RETURN_NOT_OK(ql_env_->Apply(partition_op));
+    partition_ops_.push_back(std::move(partition_op));
+  }
+  current_partition_index_ = start_partition;
+  return Status::OK();
+}
+
+void ExecContext::ResumeFromPartitionOp(size_t index) {
+  DCHECK_LT(index, partition_ops_.size());
+  op_ = partition_ops_[index];
+  current_partition_index_ += index;
+  partition_ops_.clear();
+}
+
+Status ExecContext::ApplyIndexedWriteRead(std::shared_ptr<client::YBqlReadOp> read_op,
+                                          std::shared_ptr<client::YBqlWriteOp> write_op) {
+  pending_write_op_ = std::move(write_op);
+  return Apply(std::move(read_op));
+}
+
+Status ExecContext::ApplyIndexedWrite(std::vector<std::shared_ptr<client::YBqlWriteOp>> index_ops) {
+  DCHECK(pending_write_op_ != nullptr);
+  RETURN_NOT_OK(Apply(std::move(pending_write_op_)));
+  pending_write_op_ = nullptr;
+  index_ops_ = std::move(index_ops);
+  for (const auto& index_op : index_ops_) {
+    RETURN_NOT_OK(ql_env_->Apply(index_op));
+  }
+  return Status::OK();
+}
+
 }  // namespace ql
 }  // namespace yb
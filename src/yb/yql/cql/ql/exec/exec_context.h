@@ -164,6 +164,25 @@ class ExecContext : public ProcessContextBase {
     partitions_count_ = count;
   }
 
+  // Used for multi-partition selects (i.e. with 'IN' conditions on hash columns).
+  // Applies "op", which references the current partition, together with copies of it for up to
+  // "max_partitions - 1" following partitions so that they are all read in parallel. The current
+  // partition index is left unchanged. If only one partition remains, just "op" is applied.
+  // Called from Executor::ExecPTNode for PTSelectStmt and Executor::FetchMoreRowsIfNeeded.
+  CHECKED_STATUS ApplyPartitionReads(const std::shared_ptr<client::YBqlReadOp>& op,
+                                     uint64_t max_partitions);
+
+  // Read ops applied by the last ApplyPartitionReads(), in partition order. Empty if the last
+  // apply was for a single op only.
+  const std::vector<std::shared_ptr<client::YBqlReadOp>>& partition_ops() const {
+    return partition_ops_;
+  }
+
+  // Used for multi-partition selects after the results of the parallel partition reads have been
+  // processed. Makes the "index"-th partition op the current op (i.e. the one to continue the read
+  // from) and moves the current partition index to its partition.
+  void ResumeFromPartitionOp(size_t index);
+
   // Access function for start_time.
   const MonoTime& start_time() const {
     return start_time_;
@@ -172,9 +191,28 @@ class ExecContext : public ProcessContextBase {
   // Apply YBClient read/write operation.
   CHECKED_STATUS Apply(std::shared_ptr<client::YBqlOp> op) {
     op_ = op;
+    partition_ops_.clear();
     return ql_env_->Apply(op);
   }
 
+  // For a write to a table with secondary indexes: applies the read of the current row, and keeps
+  // "write_op" pending until the index writes are known and ApplyIndexedWrite() is called.
+  CHECKED_STATUS ApplyIndexedWriteRead(std::shared_ptr<client::YBqlReadOp> read_op,
+                                       std::shared_ptr<client::YBqlWriteOp> write_op);
+
+  const std::shared_ptr<client::YBqlWriteOp>& pending_write_op() const {
+    return pending_write_op_;
+  }
+
+  // Applies the pending write, which becomes the current op, along with the writes of the index
+  // tables.
+  CHECKED_STATUS ApplyIndexedWrite(std::vector<std::shared_ptr<client::YBqlWriteOp>> index_ops);
+
+  // Index table writes applied by the last ApplyIndexedWrite().
+  const std::vector<std::shared_ptr<client::YBqlWriteOp>>& index_ops() const {
+    return index_ops_;
+  }
+
   bool SelectingAggregate();
 
   // Variants of ProcessContextBase::Error() that report location of statement tnode as the error
@@ -209,6 +247,15 @@ class ExecContext : public ProcessContextBase {
   std::unique_ptr<std::vector<std::vector<QLExpressionPB>>> hash_values_options_;
   uint64_t partitions_count_;
   uint64_t current_partition_index_;
+
+  // For multi-partition selects reading several partitions in parallel, the read ops issued for
+  // partitions [current_partition_index_, current_partition_index_ + partition_ops_.size()).
+  std::vector<std::shared_ptr<client::YBqlReadOp>> partition_ops_;
+
+  // For writes to a table with secondary indexes, the write waiting for the read of the current
+  // row, and the writes of the index tables applied with it.
+  std::shared_ptr<client::YBqlWriteOp> pending_write_op_;
+  std::vector<std::shared_ptr<client::YBqlWriteOp>> index_ops_;
 };
 
 }  // namespace ql
@@ -20,6 +20,24 @@
 #include "yb/client/yb_op.h"
 #include "yb/yql/cql/ql/ql_processor.h"
 #include "yb/util/decimal.h"
+#include "yb/util/flag_tags.h"
+
+DEFINE_uint64(cql_select_partitions_parallelism, 4,
+              "Maximum number of partitions (i.e. combinations of hash column values allowed by "
+              "'IN' conditions) that a single select statement reads in parallel. A value of 1 "
+              "reads the partitions one at a time.");
+
+DEFINE_uint64(cql_select_max_rows_data_size, 4 * 1024 * 1024,
+              "Approximate maximum size of the rows that a tablet server returns for a read of a "
+              "select statement, so that a page of large rows is read in several smaller reads "
+              "instead of one large one. 0 means no limit.");
+
+DEFINE_uint64(cql_follower_reads_max_staleness_ms, 0,
+              "Maximum staleness of the data that a follower may return for a select at "
+              "consistency level ONE. A follower that lags more rejects the read, which is then "
+              "retried on another replica. 0 means no bound.");
+TAG_FLAG(cql_follower_reads_max_staleness_ms, advanced);
+TAG_FLAG(cql_follower_reads_max_staleness_ms, runtime);
 
 namespace yb {
 namespace ql {
@@ -87,10 +105,14 @@ void Executor::ExecuteBatch(const std::string &ql_stmt, const ParseTree &parse_t
       case TreeNodeOpcode::kPTInsertStmt: FALLTHROUGH_INTENDED;
       case TreeNodeOpcode::kPTUpdateStmt: FALLTHROUGH_INTENDED;
       case TreeNodeOpcode::kPTDeleteStmt: {
-        const PTExpr::SharedPtr& if_clause = static_cast<const PTDmlStmt*>(tnode)->if_clause();
-        if (if_clause != nullptr) {
+        const PTDmlStmt* dml_stmt = static_cast<const PTDmlStmt*>(tnode);
+        if (dml_stmt->if_clause() != nullptr) {
           s = ErrorStatus(ErrorCode::CQL_STATEMENT_INVALID,
                           "batch execution of conditional DML statement not supported yet");
+        } else if (!dml_stmt->index_tables().empty()) {
+          s = ErrorStatus(ErrorCode::CQL_STATEMENT_INVALID,
+                          "batch execution of DML statement on table with secondary indexes not "
+                          "supported yet");
         }
         break;
       }
@@ -210,6 +232,8 @@ Status Executor::ExecPTNode(const PTCreateType *tnode) {
     return exec_context_->Error(tnode->type_name(), s, error_code);
   }
 
+  // Forget any cached lookup that found the type missing.
+  ql_env_->RemoveCachedUDType(keyspace_name, type_name);
   result_ = std::make_shared<SchemaChangeResult>("CREATED", "TYPE", keyspace_name, type_name);
   return Status::OK();
 }
@@ -300,9 +324,13 @@ Status Executor::ExecPTNode(const PTCreateTable *tnode) {
     return exec_context_->Error(tnode->table_name(), s, error_code);
   }
 
+  // Forget any cached lookup that found the table missing.
+  ql_env_->RemoveCachedTableDesc(table_name);
   if (tnode->opcode() == TreeNodeOpcode::kPTCreateIndex) {
     const YBTableName indexed_table_name =
         static_cast<const PTCreateIndex*>(tnode)->indexed_table_name();
+    // Have the next writes to the indexed table pick up the new index.
+    ql_env_->RemoveCachedTableDesc(indexed_table_name);
     result_ = std::make_shared<SchemaChangeResult>(
         "UPDATED", "TABLE", indexed_table_name.namespace_name(), indexed_table_name.table_name());
   } else {
@@ -380,6 +408,9 @@ Status Executor::ExecPTNode(const PTDropStmt *tnode) {
       const YBTableName table_name = tnode->yb_table_name();
       YBTableName indexed_table_name;
       s = exec_context_->DeleteIndexTable(table_name, &indexed_table_name);
+      if (s.ok()) {
+        ql_env_->RemoveCachedTableDesc(indexed_table_name);
+      }
       error_not_found = ErrorCode::TABLE_NOT_FOUND;
       result_ = std::make_shared<SchemaChangeResult>(
           "UPDATED", "TABLE", indexed_table_name.namespace_name(), indexed_table_name.table_name());
@@ -502,6 +533,9 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode) {
   // We should return paging state when page size limit is hit.
   req->set_limit(params.page_size());
   req->set_return_paging_state(true);
+  if (FLAGS_cql_select_max_rows_data_size > 0) {
+    req->set_max_rows_data_size(FLAGS_cql_select_max_rows_data_size);
+  }
 
   // Check if there is a limit and compute the new limit based on the number of returned rows.
   if (tnode->has_limit()) {
@@ -549,10 +583,14 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode) {
     select_op->set_yb_consistency_level(YBConsistencyLevel::STRONG);
   } else {
     select_op->set_yb_consistency_level(params.yb_consistency_level());
+    if (params.yb_consistency_level() == YBConsistencyLevel::CONSISTENT_PREFIX) {
+      select_op->set_max_staleness_ms(FLAGS_cql_follower_reads_max_staleness_ms);
+    }
   }
 
   // If we have several hash partitions (i.e. IN condition on hash columns) we initialize the
-  // start partition here, and then iteratively scan the rest in FetchMoreRowsIfNeeded.
+  // start partition here, read it together with the next few partitions in parallel, and then
+  // scan the rest in FetchMoreRowsIfNeeded.
   // Otherwise, the request will already have the right hashed column values set.
   if (exec_context_->UnreadPartitionsRemaining() > 0) {
     if (continue_select) {
@@ -561,6 +599,7 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode) {
     } else {
       exec_context_->InitializePartition(select_op->mutable_request(), 0);
     }
+    return exec_context_->ApplyPartitionReads(select_op, FLAGS_cql_select_partitions_parallelism);
   }
 
   // Apply the operator.
@@ -633,6 +672,16 @@ Status Executor::FetchMoreRowsIfNeeded() {
       paging_state.set_table_id(tnode->table()->id());
       paging_state.set_next_partition_index(exec_context_->current_partition_index());
       current_result->set_paging_state(paging_state);
+    } else if (!finished_current_read_partition &&
+               exec_context_->UnreadPartitionsRemaining() > 0) {
+      // If we stopped in the middle of a partition, the next fetch should resume from it too.
+      QLPagingStatePB paging_state;
+      paging_state.set_next_partition_key(current_params.next_partition_key());
+      paging_state.set_next_row_key(current_params.next_row_key());
+      paging_state.set_total_num_rows_read(total_row_count);
+      paging_state.set_table_id(tnode->table()->id());
+      paging_state.set_next_partition_index(exec_context_->current_partition_index());
+      current_result->set_paging_state(paging_state);
     }
 
     return Status::OK();
@@ -648,7 +697,10 @@ Status Executor::FetchMoreRowsIfNeeded() {
   paging_state->set_next_row_key(current_params.next_row_key());
   paging_state->set_total_num_rows_read(total_row_count);
 
-  // Apply the request.
+  // Apply the request. When moving on to a new partition, read the next few ones in parallel too.
+  if (finished_current_read_partition) {
+    return exec_context_->ApplyPartitionReads(op, FLAGS_cql_select_partitions_parallelism);
+  }
   return exec_context_->Apply(op);
 }
 
@@ -666,16 +718,25 @@ Status Executor::ExecPTNode(const PTInsertStmt *tnode) {
   // Set the timestamp
   RETURN_NOT_OK(TimestampToPB(tnode, req));
 
-  // Set the values for columns.
-  Status s = ColumnArgsToPB(table, tnode, req);
-  if (PREDICT_FALSE(!s.ok())) {
-    return exec_context_->Error(s, ErrorCode::INVALID_ARGUMENTS);
-  }
+  // Set the values for columns and the column values that need to be read, from the template of
+  // the statement when it has one.
+  Status s;
+  const WriteRequestTemplate* request_template = GetWriteRequestTemplate(tnode);
+  if (request_template != nullptr) {
+    s = WriteRequestTemplateToPB(*request_template, req);
+    if (PREDICT_FALSE(!s.ok())) {
+      return exec_context_->Error(s, ErrorCode::INVALID_ARGUMENTS);
+    }
+  } else {
+    s = ColumnArgsToPB(table, tnode, req);
+    if (PREDICT_FALSE(!s.ok())) {
+      return exec_context_->Error(s, ErrorCode::INVALID_ARGUMENTS);
+    }
 
-  // Setup the column values that need to be read.
-  s = ColumnRefsToPB(tnode, req->mutable_column_refs());
-  if (PREDICT_FALSE(!s.ok())) {
-    return exec_context_->Error(s, ErrorCode::INVALID_ARGUMENTS);
+    s = ColumnRefsToPB(tnode, req->mutable_column_refs());
+    if (PREDICT_FALSE(!s.ok())) {
+      return exec_context_->Error(s, ErrorCode::INVALID_ARGUMENTS);
+    }
   }
 
   // Set the IF clause.
@@ -687,7 +748,7 @@ Status Executor::ExecPTNode(const PTInsertStmt *tnode) {
   }
 
   // Apply the operator.
-  return exec_context_->Apply(insert_op);
+  return ApplyWrite(tnode, insert_op);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -728,7 +789,7 @@ Status Executor::ExecPTNode(const PTDeleteStmt *tnode) {
   }
 
   // Apply the operator.
-  return exec_context_->Apply(delete_op);
+  return ApplyWrite(tnode, delete_op);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -774,7 +835,261 @@ Status Executor::ExecPTNode(const PTUpdateStmt *tnode) {
   }
 
   // Apply the operator.
-  return exec_context_->Apply(update_op);
+  return ApplyWrite(tnode, update_op);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+namespace {
+
+// Whether an expression has the same value for any row, so that it can be evaluated once up front.
+bool IsRowIndependent(const QLExpressionPB& expr) {
+  switch (expr.expr_case()) {
+    case QLExpressionPB::ExprCase::kValue:
+      return true;
+    case QLExpressionPB::ExprCase::kBfcall:
+      for (const auto& operand : expr.bfcall().operands()) {
+        if (!IsRowIndependent(operand)) {
+          return false;
+        }
+      }
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool SameValue(const QLValuePB& lhs, const QLValuePB& rhs) {
+  return IsNull(lhs) ? IsNull(rhs) : !IsNull(rhs) && lhs == rhs;
+}
+
+typedef std::unordered_map<int32_t, QLValuePB> ColumnValueMap;
+
+const QLValuePB& ColumnValue(const ColumnValueMap& row, int32_t column_id) {
+  static const QLValuePB kNullValue;
+  const auto itr = row.find(column_id);
+  return itr != row.end() ? itr->second : kNullValue;
+}
+
+// Ids of the columns of the indexed table that make up the columns of an index table, in the
+// order of the index table columns. The index table columns have the names of the indexed ones.
+std::vector<int32_t> IndexedColumnIds(const PTDmlStmt *tnode, const YBTable& index_table) {
+  std::unordered_map<std::string, int32_t> column_ids;
+  for (const ColumnDesc& col_desc : tnode->table_columns()) {
+    column_ids.emplace(col_desc.name(), col_desc.id());
+  }
+  const client::YBSchema& index_schema = index_table.schema();
+  std::vector<int32_t> result;
+  result.reserve(index_schema.num_columns());
+  for (size_t idx = 0; idx < index_schema.num_columns(); idx++) {
+    const auto itr = column_ids.find(index_schema.Column(idx).name());
+    result.push_back(itr != column_ids.end() ? itr->second : -1);
+  }
+  return result;
+}
+
+// Whether the row has an entry in the index, i.e. it exists and none of the index key columns is
+// null.
+bool HasIndexEntry(bool row_exists, const std::vector<int32_t>& column_ids, size_t num_key_columns,
+                   const ColumnValueMap& row) {
+  if (!row_exists) {
+    return false;
+  }
+  for (size_t idx = 0; idx < num_key_columns; idx++) {
+    if (IsNull(ColumnValue(row, column_ids[idx]))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void IndexKeyToPB(const std::vector<int32_t>& column_ids, size_t num_hash_key_columns,
+                  size_t num_key_columns, const ColumnValueMap& row, QLWriteRequestPB *req) {
+  for (size_t idx = 0; idx < num_key_columns; idx++) {
+    QLExpressionPB *expr_pb = idx < num_hash_key_columns ? req->add_hashed_column_values()
+                                                         : req->add_range_column_values();
+    expr_pb->mutable_value()->CopyFrom(ColumnValue(row, column_ids[idx]));
+  }
+}
+
+} // namespace
+
+Status Executor::ApplyWrite(const PTDmlStmt *tnode, const shared_ptr<YBqlWriteOp>& write_op) {
+  if (tnode->index_tables().empty()) {
+    return exec_context_->Apply(write_op);
+  }
+
+  // The index writes are derived from the current row and the new column values, so the write must
+  // be to a single row and must set known values.
+  QLWriteRequestPB *req = write_op->mutable_request();
+  if (req->has_if_expr() || req->has_user_timestamp_usec()) {
+    return exec_context_->Error("Conditional or timestamped write to table with secondary indexes "
+                                "not supported yet", ErrorCode::FEATURE_NOT_SUPPORTED);
+  }
+  if (req->has_where_expr() ||
+      req->range_column_values_size() != tnode->num_key_columns() - tnode->num_hash_key_columns()) {
+    return exec_context_->Error("Range delete from table with secondary indexes not supported yet",
+                                ErrorCode::FEATURE_NOT_SUPPORTED);
+  }
+
+  // Evaluate the key and the values of the index columns once, so that the table and index rows
+  // get the same values (e.g. of now()).
+  auto eval_value = [this](QLExpressionPB *expr_pb) -> Status {
+    if (!IsRowIndependent(*expr_pb)) {
+      return exec_context_->Error("Non-constant value of an indexed column not supported yet",
+                                  ErrorCode::FEATURE_NOT_SUPPORTED);
+    }
+    if (!expr_pb->has_value()) {
+      QLValue value;
+      RETURN_NOT_OK(EvalExpr(*expr_pb, nullptr, &value));
+      expr_pb->mutable_value()->CopyFrom(value.value());
+    }
+    return Status::OK();
+  };
+  for (QLExpressionPB& expr_pb : *req->mutable_hashed_column_values()) {
+    RETURN_NOT_OK(eval_value(&expr_pb));
+  }
+  for (QLExpressionPB& expr_pb : *req->mutable_range_column_values()) {
+    RETURN_NOT_OK(eval_value(&expr_pb));
+  }
+
+  std::unordered_set<int32_t> index_column_ids;
+  for (const auto& index_table : tnode->index_tables()) {
+    for (const int32_t column_id : IndexedColumnIds(tnode, *index_table)) {
+      index_column_ids.insert(column_id);
+    }
+  }
+  for (QLColumnValuePB& col_pb : *req->mutable_column_values()) {
+    if (index_column_ids.count(col_pb.column_id()) == 0) {
+      continue;
+    }
+    if (col_pb.subscript_args_size() > 0) {
+      return exec_context_->Error("Subscripted write to an indexed column not supported yet",
+                                  ErrorCode::FEATURE_NOT_SUPPORTED);
+    }
+    // Deleted columns have no value.
+    if (col_pb.has_expr()) {
+      RETURN_NOT_OK(eval_value(col_pb.mutable_expr()));
+    }
+  }
+
+  // Read the key and index columns of the current row. The write and the index writes are applied
+  // once the read is done.
+  shared_ptr<YBqlReadOp> read_op(tnode->table()->NewQLSelect());
+  QLReadRequestPB *read_req = read_op->mutable_request();
+  read_req->mutable_hashed_column_values()->CopyFrom(req->hashed_column_values());
+  if (req->range_column_values_size() > 0) {
+    QLConditionPB *where_pb = read_req->mutable_where_expr()->mutable_condition();
+    where_pb->set_op(QL_OP_AND);
+    for (int idx = 0; idx < req->range_column_values_size(); idx++) {
+      QLConditionPB *condition = where_pb->add_operands()->mutable_condition();
+      condition->set_op(QL_OP_EQUAL);
+      condition->add_operands()->set_column_id(
+          tnode->table_columns()[tnode->num_hash_key_columns() + idx].id());
+      condition->add_operands()->CopyFrom(req->range_column_values(idx));
+    }
+  }
+  QLRSRowDescPB *rsrow_desc_pb = read_req->mutable_rsrow_desc();
+  for (const ColumnDesc& col_desc : tnode->table_columns()) {
+    if (!col_desc.is_primary() && index_column_ids.count(col_desc.id()) == 0) {
+      continue;
+    }
+    read_req->add_selected_exprs()->set_column_id(col_desc.id());
+    QLRSColDescPB *rscol_desc_pb = rsrow_desc_pb->add_rscol_descs();
+    rscol_desc_pb->set_name(col_desc.name());
+    col_desc.ql_type()->ToQLTypePB(rscol_desc_pb->mutable_ql_type());
+    if (col_desc.is_static()) {
+      read_req->mutable_column_refs()->add_static_ids(col_desc.id());
+    } else {
+      read_req->mutable_column_refs()->add_ids(col_desc.id());
+    }
+  }
+  read_req->set_limit(1);
+  read_op->set_yb_consistency_level(YBConsistencyLevel::STRONG);
+
+  return exec_context_->ApplyIndexedWriteRead(read_op, write_op);
+}
+
+Status Executor::ApplyIndexWrites() {
+  const PTDmlStmt *tnode = static_cast<const PTDmlStmt*>(exec_context_->tnode());
+  auto* read_op = static_cast<YBqlReadOp*>(exec_context_->op().get());
+  RETURN_NOT_OK(ProcessOpStatus(read_op, exec_context_));
+  auto row_block = read_op->MakeRowBlock();
+  RETURN_NOT_OK(row_block);
+
+  shared_ptr<YBqlWriteOp> write_op = exec_context_->pending_write_op();
+  const QLWriteRequestPB& req = write_op->request();
+
+  // The current row, and the row after the write.
+  ColumnValueMap old_row;
+  const bool old_exists = row_block->row_count() > 0;
+  if (old_exists) {
+    const QLRow& row = row_block->row(0);
+    for (int idx = 0; idx < read_op->request().selected_exprs_size(); idx++) {
+      old_row[read_op->request().selected_exprs(idx).column_id()] = row.column(idx).value();
+    }
+  }
+  ColumnValueMap new_row = old_row;
+  for (int idx = 0; idx < req.hashed_column_values_size(); idx++) {
+    new_row[tnode->table_columns()[idx].id()] = req.hashed_column_values(idx).value();
+  }
+  for (int idx = 0; idx < req.range_column_values_size(); idx++) {
+    new_row[tnode->table_columns()[tnode->num_hash_key_columns() + idx].id()] =
+        req.range_column_values(idx).value();
+  }
+  for (const QLColumnValuePB& col_pb : req.column_values()) {
+    if (col_pb.has_expr()) {
+      new_row[col_pb.column_id()] = col_pb.expr().value();
+    } else {
+      new_row[col_pb.column_id()].Clear();
+    }
+  }
+  bool new_exists = true;
+  if (req.type() == QLWriteRequestPB::QL_STMT_DELETE) {
+    // Deleting the whole row or some columns of it.
+    new_exists = old_exists && req.column_values_size() > 0;
+  }
+
+  std::vector<shared_ptr<YBqlWriteOp>> index_ops;
+  for (const auto& index_table : tnode->index_tables()) {
+    const std::vector<int32_t> column_ids = IndexedColumnIds(tnode, *index_table);
+    const size_t num_hash_key_columns = index_table->schema().num_hash_key_columns();
+    const size_t num_key_columns = index_table->schema().num_key_columns();
+    const bool old_entry = HasIndexEntry(old_exists, column_ids, num_key_columns, old_row);
+    const bool new_entry = HasIndexEntry(new_exists, column_ids, num_key_columns, new_row);
+    bool same_key = old_entry && new_entry;
+    bool same_values = true;
+    for (size_t idx = 0; idx < column_ids.size(); idx++) {
+      if (!SameValue(ColumnValue(old_row, column_ids[idx]), ColumnValue(new_row, column_ids[idx]))) {
+        (idx < num_key_columns ? same_key : same_values) = false;
+      }
+    }
+
+    if (old_entry && !same_key) {
+      shared_ptr<YBqlWriteOp> delete_op(index_table->NewQLDelete());
+      IndexKeyToPB(column_ids, num_hash_key_columns, num_key_columns, old_row,
+                   delete_op->mutable_request());
+      index_ops.push_back(std::move(delete_op));
+    }
+    if (new_entry && !(same_key && same_values && !req.has_ttl())) {
+      shared_ptr<YBqlWriteOp> insert_op(index_table->NewQLInsert());
+      QLWriteRequestPB *index_req = insert_op->mutable_request();
+      IndexKeyToPB(column_ids, num_hash_key_columns, num_key_columns, new_row, index_req);
+      for (size_t idx = num_key_columns; idx < column_ids.size(); idx++) {
+        QLColumnValuePB *col_pb = index_req->add_column_values();
+        col_pb->set_column_id(index_table->schema().ColumnId(idx));
+        col_pb->mutable_expr()->mutable_value()->CopyFrom(ColumnValue(new_row, column_ids[idx]));
+      }
+      if (req.has_ttl()) {
+        index_req->set_ttl(req.ttl());
+      }
+      index_ops.push_back(std::move(insert_op));
+    }
+  }
+
+  // The read is done with, start over with the write and the index writes.
+  ql_env_->Reset();
+  return exec_context_->ApplyIndexedWrite(std::move(index_ops));
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -822,7 +1137,13 @@ Status Executor::ExecPTNode(const PTUseKeyspace *tnode) {
 
 void Executor::FlushAsyncDone(const Status &s) {
   Status ss = s;
-  if (ss.ok()) {
+  if (ss.ok() && exec_context_->pending_write_op() != nullptr) {
+    // The current row has been read for a write to a table with secondary indexes.
+    ss = ProcessStatementStatus(*exec_context_->parse_tree(), ApplyIndexWrites());
+    if (ss.ok() && ql_env_->FlushAsync(&flush_async_cb_)) {
+      return;
+    }
+  } else if (ss.ok()) {
     ss = ProcessAsyncResults();
     if (ss.ok() && exec_context_->tnode()->opcode() == TreeNodeOpcode::kPTSelectStmt) {
 
@@ -869,31 +1190,70 @@ Status Executor::ProcessStatementStatus(const ParseTree &parse_tree, const Statu
   return s;
 }
 
-Status Executor::ProcessOpResponse(client::YBqlOp* op, ExecContext* exec_context) {
+Status Executor::ProcessOpStatus(client::YBqlOp* op, ExecContext* exec_context) {
+  const Status s = ql_env_->GetOpError(op);
+  if (PREDICT_FALSE(!s.ok())) {
+    // YBOperation returns not-found error when the tablet is not found.
+    const auto error_code =
+        s.IsNotFound() ? ErrorCode::TABLET_NOT_FOUND : ErrorCode::SQL_STATEMENT_INVALID;
+    return exec_context->Error(s, error_code);
+  }
   const QLResponsePB &resp = op->response();
   CHECK(resp.has_status()) << "QLResponsePB status missing";
   if (resp.status() != QLResponsePB::YQL_STATUS_OK) {
     return exec_context->Error(resp.error_message().c_str(), QLStatusToErrorCode(resp.status()));
   }
+  return Status::OK();
+}
+
+Status Executor::ProcessOpResult(client::YBqlOp* op, ExecContext* exec_context) {
+  RETURN_NOT_OK(ProcessOpStatus(op, exec_context));
   return op->rows_data().empty() ? Status::OK() : AppendResult(std::make_shared<RowsResult>(op));
 }
 
+Status Executor::ProcessPartitionReadResults(ExecContext* exec_context) {
+  // The partitions were read in parallel, all with the same row limit. Append their results in
+  // partition order for as long as they fit within that limit and stop at the first partition that
+  // has not been read completely, so that the read continues from there. A partition result that
+  // does not fit is dropped along with the ones after it, and is read again by the next fetch.
+  const auto& partition_ops = exec_context->partition_ops();
+  uint64_t rows_remaining = partition_ops.front()->request().limit();
+  size_t last_processed = 0;
+  for (size_t i = 0; i < partition_ops.size(); i++) {
+    YBqlReadOp* op = partition_ops[i].get();
+    size_t row_count = 0;
+    if (!op->rows_data().empty()) {
+      RETURN_NOT_OK(QLRowBlock::GetRowCount(op->request().client(), op->rows_data(), &row_count));
+    }
+    if (i > 0 && row_count > rows_remaining) {
+      break;
+    }
+    RETURN_NOT_OK(ProcessOpResult(op, exec_context));
+    rows_remaining -= std::min<uint64_t>(row_count, rows_remaining);
+    last_processed = i;
+    if (op->response().has_paging_state()) {
+      break;
+    }
+  }
+  exec_context->ResumeFromPartitionOp(last_processed);
+  return Status::OK();
+}
+
 Status Executor::ProcessAsyncResults() {
   Status s, ss;
   for (auto& exec_context : exec_contexts_) {
     if (exec_context.tnode() == nullptr) {
       continue; // Skip empty statement.
     }
-    client::YBqlOp* op = exec_context.op().get();
-    ss = ql_env_->GetOpError(op);
-    if (PREDICT_FALSE(!ss.ok())) {
-      // YBOperation returns not-found error when the tablet is not found.
-      const auto error_code =
-          ss.IsNotFound() ? ErrorCode::TABLET_NOT_FOUND : ErrorCode::SQL_STATEMENT_INVALID;
-      ss = exec_context.Error(ss, error_code);
-    }
-    if (ss.ok()) {
-      ss = ProcessOpResponse(op, &exec_context);
+    if (!exec_context.partition_ops().empty()) {
+      ss = ProcessPartitionReadResults(&exec_context);
+    } else {
+      ss = ProcessOpResult(exec_context.op().get(), &exec_context);
+      for (const auto& index_op : exec_context.index_ops()) {
+        if (ss.ok()) {
+          ss = ProcessOpResult(index_op.get(), &exec_context);
+        }
+      }
     }
     ss = ProcessStatementStatus(*exec_context.parse_tree(), ss);
     if (PREDICT_FALSE(!ss.ok())) {
@@ -914,7 +1274,7 @@ Status Executor::AppendResult(const ExecutedResult::SharedPtr& result) {
   CHECK(result_->type() == ExecutedResult::Type::ROWS);
   CHECK(result->type() == ExecutedResult::Type::ROWS);
   return std::static_pointer_cast<RowsResult>(result_)->Append(
-      static_cast<const RowsResult&>(*result));
+      std::move(static_cast<RowsResult&>(*result)));
 }
 
 void Executor::StatementExecuted(const Status& s) {
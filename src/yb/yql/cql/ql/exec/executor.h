@@ -42,6 +42,29 @@ namespace ql {
 
 class QLMetrics;
 
+// Column arguments and references of the write requests of a prepared DML statement whose column
+// arguments are all constants or bind variables. The constants are converted once, so executing
+// the statement only copies the template and sets the values of the bind variables.
+struct WriteRequestTemplate {
+  enum class Section {
+    kHashedColumn,
+    kRangeColumn,
+    kRegularColumn,
+  };
+
+  // A bind variable and the expression of the request it is set in, identified by its section
+  // and index in that section.
+  struct BindVarSlot {
+    const PTBindVar* bind_var;
+    Section section;
+    int index;
+    bool is_primary;
+  };
+
+  QLWriteRequestPB request;
+  std::vector<BindVarSlot> bind_var_slots;
+};
+
 class Executor : public QLExprExecutor {
  public:
   //------------------------------------------------------------------------------------------------
@@ -114,6 +137,18 @@ class Executor : public QLExprExecutor {
   // Uses a keyspace.
   CHECKED_STATUS ExecPTNode(const PTUseKeyspace *tnode);
 
+  //------------------------------------------------------------------------------------------------
+  // Secondary index maintenance.
+
+  // Apply the write op of a DML statement. For a table with secondary indexes, the current row is
+  // read first and the write is applied with the writes of the index tables by ApplyIndexWrites().
+  CHECKED_STATUS ApplyWrite(const PTDmlStmt *tnode,
+                            const std::shared_ptr<client::YBqlWriteOp>& write_op);
+
+  // Apply the pending write of the current statement along with the writes that update its index
+  // tables, once the current row has been read.
+  CHECKED_STATUS ApplyIndexWrites();
+
   //------------------------------------------------------------------------------------------------
   // Result processing.
 
@@ -123,13 +158,20 @@ class Executor : public QLExprExecutor {
   // Process the status of executing a statement.
   CHECKED_STATUS ProcessStatementStatus(const ParseTree& parse_tree, const Status& s);
 
-  // Process the read/write op response.
-  CHECKED_STATUS ProcessOpResponse(client::YBqlOp* op, ExecContext* exec_context);
+  // Process the read/write op error and response status.
+  CHECKED_STATUS ProcessOpStatus(client::YBqlOp* op, ExecContext* exec_context);
+
+  // Process the read/write op status and then the rows in its response.
+  CHECKED_STATUS ProcessOpResult(client::YBqlOp* op, ExecContext* exec_context);
+
+  // Process the responses of the partition reads of a multi-partition select that were issued in
+  // parallel (see ExecContext::ApplyPartitionReads).
+  CHECKED_STATUS ProcessPartitionReadResults(ExecContext* exec_context);
 
   // Process result of FlushAsyncDone.
   CHECKED_STATUS ProcessAsyncResults();
 
-  // Append execution result.
+  // Append execution result. The rows data of 'result' is moved into the accumulated result.
   CHECKED_STATUS AppendResult(const ExecutedResult::SharedPtr& result);
 
   // Continue a multi-partition select (e.g. table scan or query with 'IN' condition on hash cols).
@@ -227,6 +269,15 @@ class Executor : public QLExprExecutor {
                                 const PTDmlStmt *tnode,
                                 QLWriteRequestPB *req);
 
+  // Returns the write request template of a statement, building it on the first execution. Returns
+  // null if the statement can't use a template.
+  const WriteRequestTemplate* GetWriteRequestTemplate(const PTDmlStmt *tnode);
+  std::shared_ptr<const WriteRequestTemplate> BuildWriteRequestTemplate(const PTDmlStmt *tnode);
+
+  // Set the column arguments and references of a write request from a template.
+  CHECKED_STATUS WriteRequestTemplateToPB(const WriteRequestTemplate& request_template,
+                                          QLWriteRequestPB *req);
+
   //------------------------------------------------------------------------------------------------
   // Where clause evaluation.
 
@@ -80,10 +80,17 @@ void ParseTree::AddAnalyzedTable(const client::YBTableName& table_name) {
   analyzed_tables_.insert(table_name);
 }
 
+void ParseTree::AddAnalyzedTableId(const TableId& table_id) {
+  analyzed_table_ids_.insert(table_id);
+}
+
 void ParseTree::ClearAnalyzedTableCache(QLEnv* ql_env) const {
   for (const auto& table_name : analyzed_tables_) {
     ql_env->RemoveCachedTableDesc(table_name);
   }
+  for (const auto& table_id : analyzed_table_ids_) {
+    ql_env->RemoveCachedTableDescById(table_id);
+  }
 }
 
 void ParseTree::AddAnalyzedUDType(const std::string& keyspace_name, const std::string& type_name) {
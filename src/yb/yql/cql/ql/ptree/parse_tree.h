@@ -81,6 +81,9 @@ class ParseTree {
   // Add table to the set of tables used during semantic analysis.
   void AddAnalyzedTable(const client::YBTableName& table_name);
 
+  // Add table, looked up by id, to the set of tables used during semantic analysis.
+  void AddAnalyzedTableId(const TableId& table_id);
+
   // Clear the metadata cache of the tables used to analyze this parse tree.
   void ClearAnalyzedTableCache(QLEnv *ql_env) const;
 
@@ -95,6 +98,7 @@ class ParseTree {
 
   // Set of tables used during semantic analysis.
   std::unordered_set<client::YBTableName, boost::hash<client::YBTableName>> analyzed_tables_;
+  std::unordered_set<TableId> analyzed_table_ids_;
 
   // Set of types used during semantic analysis.
   std::unordered_set<std::pair<string, string>,
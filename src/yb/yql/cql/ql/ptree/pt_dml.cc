@@ -63,8 +63,21 @@ PTDmlStmt::~PTDmlStmt() {
 }
 
 CHECKED_STATUS PTDmlStmt::LookupTable(SemContext *sem_context) {
-  return sem_context->LookupTable(table_name(), table_loc(), IsWriteOp(), &table_, &is_system_,
-                                  &table_columns_, &num_key_columns_, &num_hash_key_columns_);
+  RETURN_NOT_OK(sem_context->LookupTable(table_name(), table_loc(), IsWriteOp(), &table_,
+                                         &is_system_, &table_columns_, &num_key_columns_,
+                                         &num_hash_key_columns_));
+  index_tables_.clear();
+  if (IsWriteOp()) {
+    for (const auto& index : table_->indexes()) {
+      std::shared_ptr<YBTable> index_table = sem_context->GetTableDescById(index.table_id);
+      if (index_table == nullptr) {
+        return sem_context->Error(table_loc(), "Index table not found",
+                                  ErrorCode::TABLE_NOT_FOUND);
+      }
+      index_tables_.push_back(std::move(index_table));
+    }
+  }
+  return Status::OK();
 }
 
 // Node semantics analysis.
@@ -348,6 +361,28 @@ CHECKED_STATUS WhereExprState::AnalyzeColumnOp(SemContext *sem_context,
       break;
     }
 
+    case QL_OP_NOT_EQUAL: {
+      // Inequality is only a filter, it is evaluated by the tablet server for every scanned row.
+      if (statement_type_ != TreeNodeOpcode::kPTSelectStmt) {
+        return sem_context->Error(expr, "Operator is not supported in where clause",
+                                  ErrorCode::CQL_STATEMENT_INVALID);
+      }
+
+      if (col_desc->is_hash()) {
+        return sem_context->Error(expr, "Partition column cannot be used in this expression",
+                                  ErrorCode::CQL_STATEMENT_INVALID);
+      }
+
+      if (col_args != nullptr) {
+        SubscriptedColumnOp subcol_op(col_desc, col_args, value, expr->ql_op());
+        subscripted_col_ops_->push_back(subcol_op);
+      } else {
+        ColumnOp col_op(col_desc, value, expr->ql_op());
+        ops_->push_back(col_op);
+      }
+      break;
+    }
+
     case QL_OP_NOT_IN: FALLTHROUGH_INTENDED;
     case QL_OP_IN: {
       if (statement_type_ != TreeNodeOpcode::kPTSelectStmt) {
@@ -392,7 +427,8 @@ CHECKED_STATUS WhereExprState::AnalyzeColumnFunction(SemContext *sem_context,
     case QL_OP_LESS_THAN_EQUAL:
     case QL_OP_EQUAL:
     case QL_OP_GREATER_THAN_EQUAL:
-    case QL_OP_GREATER_THAN: {
+    case QL_OP_GREATER_THAN:
+    case QL_OP_NOT_EQUAL: {
       FuncOp func_op(value, call, expr->ql_op());
       func_ops_->push_back(func_op);
       break;
@@ -18,6 +18,10 @@
 #ifndef YB_YQL_CQL_QL_PTREE_PT_DML_H_
 #define YB_YQL_CQL_QL_PTREE_PT_DML_H_
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+
 #include "yb/yql/cql/ql/ptree/column_desc.h"
 #include "yb/yql/cql/ql/ptree/list_node.h"
 #include "yb/yql/cql/ql/ptree/tree_node.h"
@@ -30,6 +34,8 @@
 namespace yb {
 namespace ql {
 
+struct WriteRequestTemplate;
+
 //--------------------------------------------------------------------------------------------------
 // Counter of operators on each column. "gt" includes ">" and ">=". "lt" includes "<" and "<=".
 class ColumnOpCounter {
@@ -191,6 +197,11 @@ class PTDmlStmt : public PTCollection {
     return table_;
   }
 
+  // Index tables of the table, in the order of table()->indexes(). Looked up for writes only.
+  const std::vector<std::shared_ptr<client::YBTable>>& index_tables() const {
+    return index_tables_;
+  }
+
   bool is_system() const {
     return is_system_;
   }
@@ -318,6 +329,23 @@ class PTDmlStmt : public PTCollection {
            opcode() == TreeNodeOpcode::kPTDeleteStmt;
   }
 
+  // Template of the write requests of this statement, set once by the executor on the first
+  // execution. It is null when the statement can't use one.
+  bool write_request_template_set() const {
+    return write_request_template_set_.load(std::memory_order_acquire);
+  }
+  const WriteRequestTemplate* write_request_template() const {
+    DCHECK(write_request_template_set());
+    return write_request_template_.get();
+  }
+  void set_write_request_template(std::shared_ptr<const WriteRequestTemplate> value) const {
+    std::lock_guard<std::mutex> lock(write_request_template_mutex_);
+    if (!write_request_template_set_.load(std::memory_order_relaxed)) {
+      write_request_template_ = std::move(value);
+      write_request_template_set_.store(true, std::memory_order_release);
+    }
+  }
+
  protected:
   // Protected functions.
   CHECKED_STATUS AnalyzeWhereExpr(SemContext *sem_context, PTExpr *expr);
@@ -334,6 +362,9 @@ class PTDmlStmt : public PTCollection {
   // The semantic analyzer will decorate this node with the following information.
   std::shared_ptr<client::YBTable> table_;
 
+  // Index tables that need to be maintained when writing to the table.
+  std::vector<std::shared_ptr<client::YBTable>> index_tables_;
+
   // Is the table a system table?
   bool is_system_;
 
@@ -384,6 +415,12 @@ class PTDmlStmt : public PTCollection {
   //       We prepare this vector once at compile time and use it at execution times.
   std::shared_ptr<vector<ColumnSchema>> selected_schemas_;
 
+  // The parse tree of a prepared statement is shared by concurrent executions, so the write request
+  // template is published once under the mutex and read without it.
+  mutable std::mutex write_request_template_mutex_;
+  mutable std::shared_ptr<const WriteRequestTemplate> write_request_template_;
+  mutable std::atomic<bool> write_request_template_set_{false};
+
   static const PTExpr::SharedPtr kNullPointerRef;
 };
 
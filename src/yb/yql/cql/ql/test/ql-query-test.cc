@@ -27,6 +27,9 @@ using std::unique_ptr;
 using std::shared_ptr;
 using strings::Substitute;
 
+DECLARE_uint64(cql_select_partitions_parallelism);
+DECLARE_uint64(cql_select_max_rows_data_size);
+
 namespace yb {
 namespace ql {
 
@@ -496,6 +499,78 @@ TEST_F(TestQLQuery, TestPagingState) {
   }
 }
 
+TEST_F(TestQLQuery, TestPagingStateWithParallelPartitionReads) {
+  // Init the simulated cluster.
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+
+  // Get a processor.
+  TestQLProcessor *processor = GetQLProcessor();
+
+  CHECK_VALID_STMT("CREATE TABLE t (h int, r int, v int, primary key((h), r));");
+
+  // Insert a different number of rows for each hash key so that the partitions read in parallel
+  // fill up the pages unevenly.
+  static constexpr int kNumHashKeys = 8;
+  for (int h = 1; h <= kNumHashKeys; h++) {
+    for (int r = 1; r <= h; r++) {
+      CHECK_VALID_STMT(Substitute("INSERT INTO t (h, r, v) VALUES ($0, $1, $2);", h, r, 10 * h + r));
+    }
+  }
+
+  // Reads all pages of the given select and returns them as a string, one row block per page.
+  auto read_pages = [processor](const string& select_stmt, int page_size) {
+    StatementParameters params;
+    params.set_page_size(page_size);
+    string pages;
+    do {
+      CHECK_OK(processor->Run(select_stmt, params));
+      pages.append(processor->row_block()->ToString());
+      if (processor->rows_result()->paging_state().empty()) {
+        break;
+      }
+      CHECK_OK(params.set_paging_state(processor->rows_result()->paging_state()));
+    } while (true);
+    return pages;
+  };
+
+  // Verify that reading the partitions in parallel returns the same pages as reading them one at
+  // a time, with and without a LIMIT clause.
+  const std::vector<string> select_stmts = {
+      "SELECT h, r, v FROM t WHERE h IN (8, 1, 3, 6, 2, 7, 4, 5);",
+      "SELECT h, r, v FROM t WHERE h IN (8, 1, 3, 6, 2, 7, 4, 5) LIMIT 17;",
+      "SELECT h, r, v FROM t WHERE h IN (1, 2, 3, 4, 5, 6, 7, 8) AND r > 2;" };
+  const std::vector<int> page_sizes = { 1, 2, 3, 5, 8, 100 };
+  const uint64_t saved_parallelism = FLAGS_cql_select_partitions_parallelism;
+  const uint64_t saved_max_rows_data_size = FLAGS_cql_select_max_rows_data_size;
+  for (const string& select_stmt : select_stmts) {
+    for (int page_size : page_sizes) {
+      FLAGS_cql_select_partitions_parallelism = 1;
+      const string expected_pages = read_pages(select_stmt, page_size);
+      for (uint64_t parallelism : {2, 3, 8, 16}) {
+        FLAGS_cql_select_partitions_parallelism = parallelism;
+        EXPECT_EQ(expected_pages, read_pages(select_stmt, page_size))
+            << select_stmt << " page size " << page_size << " parallelism " << parallelism;
+
+        // With a tiny rows data size limit, every read returns a single row, and the pages are
+        // still filled up by reading more.
+        FLAGS_cql_select_max_rows_data_size = 1;
+        EXPECT_EQ(expected_pages, read_pages(select_stmt, page_size))
+            << select_stmt << " page size " << page_size << " parallelism " << parallelism
+            << " with rows data size limit";
+        FLAGS_cql_select_max_rows_data_size = saved_max_rows_data_size;
+      }
+    }
+  }
+  FLAGS_cql_select_partitions_parallelism = saved_parallelism;
+
+  // Verify a read resumed from the middle of a partition other than the first one.
+  FLAGS_cql_select_partitions_parallelism = 1;
+  VerifyPaginationSelect(processor, "SELECT h, r, v FROM t WHERE h IN (1, 2);", 2,
+      "{ { int32:1, int32:1, int32:11 }, { int32:2, int32:1, int32:21 } }"
+      "{ { int32:2, int32:2, int32:22 } }");
+  FLAGS_cql_select_partitions_parallelism = saved_parallelism;
+}
+
 #define RUN_PAGINATION_WITH_DESC_TEST(processor, type, values, rows)                               \
 do {                                                                                               \
   /* Creating the table. */                                                                        \
@@ -1713,6 +1788,42 @@ TEST_F(TestQLQuery, TestTtlWritetimeInWhereClauseOfSelectStatements) {
   ASSERT_EQ(0, row_block->row_count());
 }
 
+TEST_F(TestQLQuery, TestNotEqualInWhereClause) {
+  // Init the simulated cluster.
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+
+  TestQLProcessor *processor = GetQLProcessor();
+
+  CHECK_OK(processor->Run("CREATE TABLE not_equal_test (h int, r int, v int, "
+                          "PRIMARY KEY((h), r))"));
+  for (int i = 0; i < 10; i++) {
+    CHECK_OK(processor->Run(Substitute("INSERT INTO not_equal_test (h, r, v) VALUES (1, $0, $1)",
+                                       i, i % 3)));
+  }
+
+  // Filter on a regular column.
+  CHECK_OK(processor->Run("SELECT r, v FROM not_equal_test WHERE h = 1 AND v != 0"));
+  auto row_block = processor->row_block();
+  ASSERT_EQ(6, row_block->row_count());
+  for (const QLRow& row : row_block->rows()) {
+    EXPECT_NE(0, row.column(1).int32_value());
+    EXPECT_NE(0, row.column(0).int32_value() % 3);
+  }
+
+  // Filter on a range column, combined with a range condition.
+  CHECK_OK(processor->Run("SELECT r FROM not_equal_test WHERE h = 1 AND r > 2 AND r <> 5"));
+  row_block = processor->row_block();
+  ASSERT_EQ(6, row_block->row_count());
+  for (const QLRow& row : row_block->rows()) {
+    EXPECT_GT(row.column(0).int32_value(), 2);
+    EXPECT_NE(5, row.column(0).int32_value());
+  }
+
+  // Inequality is not allowed on a partition column or in a write.
+  CHECK_INVALID_STMT("SELECT * FROM not_equal_test WHERE h != 1");
+  CHECK_INVALID_STMT("DELETE FROM not_equal_test WHERE h = 1 AND r != 1");
+}
+
 TEST_F(TestQLQuery, TestFloatPrimaryKey) {
   // Init the simulated cluster.
   ASSERT_NO_FATALS(CreateSimulatedCluster());
@@ -16,6 +16,7 @@
 #include "yb/yql/cql/ql/test/ql-test-base.h"
 
 #include "yb/client/client.h"
+#include "yb/client/meta_data_cache.h"
 
 namespace yb {
 namespace ql {
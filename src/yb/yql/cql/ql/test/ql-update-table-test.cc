@@ -107,5 +107,37 @@ TEST_F(TestQLUpdateTable, TestQLUpdateTableSimple) {
   }
 }
 
+TEST_F(TestQLUpdateTable, TestQLUpdateTableWithIndex) {
+  // Init the simulated cluster.
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+
+  // Get a processor.
+  TestQLProcessor *processor = GetQLProcessor();
+
+  // Create the table and its index.
+  CHECK_VALID_STMT("CREATE TABLE test_table(h int, r int, v1 int, v2 varchar, "
+                   "PRIMARY KEY ((h), r));");
+  CHECK_VALID_STMT("CREATE INDEX test_index ON test_table (v1) COVERING (v2);");
+
+  // Writes to the table maintain the index.
+  CHECK_VALID_STMT("INSERT INTO test_table(h, r, v1, v2) VALUES(1, 1, 10, 'a');");
+  CHECK_VALID_STMT("UPDATE test_table SET v1 = 20 WHERE h = 1 AND r = 1;");
+  CHECK_VALID_STMT("UPDATE test_table SET v2 = 'b' WHERE h = 1 AND r = 1;");
+  CHECK_VALID_STMT("DELETE v1 FROM test_table WHERE h = 1 AND r = 1;");
+  CHECK_VALID_STMT("DELETE FROM test_table WHERE h = 1 AND r = 1;");
+
+  CHECK_VALID_STMT("INSERT INTO test_table(h, r, v1, v2) VALUES(1, 2, 30, 'c');");
+  CHECK_VALID_STMT("SELECT v1, v2 FROM test_table WHERE h = 1;");
+  std::shared_ptr<QLRowBlock> row_block = processor->row_block();
+  CHECK_EQ(row_block->row_count(), 1);
+  CHECK_EQ(row_block->row(0).column(0).int32_value(), 30);
+  CHECK_EQ(row_block->row(0).column(1).string_value(), "c");
+
+  // Writes that the index can't be maintained for are rejected.
+  CHECK_INVALID_STMT("INSERT INTO test_table(h, r, v1, v2) VALUES(1, 3, 40, 'd') IF NOT EXISTS;");
+  CHECK_INVALID_STMT("UPDATE test_table SET v1 = 50 WHERE h = 1 AND r = 2 IF v1 = 30;");
+  CHECK_INVALID_STMT("DELETE FROM test_table WHERE h = 1;");
+}
+
 } // namespace ql
 } // namespace yb
@@ -18,6 +18,7 @@
 #include "yb/yql/cql/ql/util/ql_env.h"
 #include "yb/client/callbacks.h"
 #include "yb/client/client.h"
+#include "yb/client/meta_data_cache.h"
 #include "yb/client/yb_op.h"
 
 #include "yb/master/catalog_manager.h"
@@ -101,6 +102,7 @@ void QLEnv::SetCurrentCall(rpc::InboundCallPtr cql_call) {
   DCHECK(cql_call == nullptr || current_call_ == nullptr)
       << this << " Tried updating current call. Current call is " << current_call_;
   current_call_ = std::move(cql_call);
+  on_reactor_thread_ = false;
 }
 
 CHECKED_STATUS QLEnv::Apply(std::shared_ptr<client::YBqlOp> op) {
@@ -131,6 +133,14 @@ void QLEnv::AbortOps() {
   session_->Abort();
 }
 
+uint64_t QLEnv::read_after_hybrid_time() const {
+  return session_->GetReadAfterHybridTime();
+}
+
+void QLEnv::SetReadAfterHybridTime(uint64_t ht_hybrid_time) {
+  session_->SetReadAfterHybridTime(ht_hybrid_time);
+}
+
 void QLEnv::FlushAsyncDone(const Status &s) {
   // When any error occurs during the dispatching of YBOperation, YBSession saves the error and
   // returns IOError. When it happens, retrieves the errors and discard the IOError.
@@ -156,9 +166,23 @@ void QLEnv::FlushAsyncDone(const Status &s) {
     return;
   }
 
+  if (resume_on_reactor_) {
+    // Continue the statement on this reactor thread, saving a round trip through the handler
+    // thread pool. Nothing may be touched after the callback since the call may be completed and
+    // this environment reused by then.
+    on_reactor_thread_ = true;
+    ResumeCQLCall();
+    return;
+  }
+
   // Production/cqlserver usecase: enqueue the callback to run in the server's handler thread.
   resume_execution_ = Bind(&QLEnv::ResumeCQLCall, Unretained(this));
-  current_cql_call()->SetResumeFrom(&resume_execution_);
+  RequeueCurrentCall(&resume_execution_);
+}
+
+void QLEnv::RequeueCurrentCall(Callback<void(void)>* cb) {
+  on_reactor_thread_ = false;
+  current_cql_call()->SetResumeFrom(cb);
 
   auto messenger = messenger_.lock();
   DCHECK(messenger != nullptr) << "weak_ptr's messenger is null";
@@ -186,6 +210,18 @@ shared_ptr<YBTable> QLEnv::GetTableDesc(const YBTableName& table_name, bool* cac
   return yb_table;
 }
 
+shared_ptr<YBTable> QLEnv::GetTableDescById(const TableId& table_id, bool* cache_used) {
+  shared_ptr<YBTable> yb_table;
+  Status s = metadata_cache_->GetTableById(table_id, &yb_table, cache_used);
+
+  if (!s.ok()) {
+    VLOG(3) << "GetTableDescById: Server returns an error: " << s.ToString();
+    return nullptr;
+  }
+
+  return yb_table;
+}
+
 shared_ptr<QLType> QLEnv::GetUDType(const std::string &keyspace_name,
                                       const std::string &type_name,
                                       bool *cache_used) {
@@ -204,6 +240,10 @@ void QLEnv::RemoveCachedTableDesc(const YBTableName& table_name) {
   metadata_cache_->RemoveCachedTable(table_name);
 }
 
+void QLEnv::RemoveCachedTableDescById(const TableId& table_id) {
+  metadata_cache_->RemoveCachedTableById(table_id);
+}
+
 void QLEnv::RemoveCachedUDType(const std::string& keyspace_name, const std::string& type_name) {
   metadata_cache_->RemoveCachedUDType(keyspace_name, type_name);
 }
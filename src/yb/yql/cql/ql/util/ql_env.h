@@ -77,11 +77,23 @@ class QLEnv {
   // Abort the batched ops.
   virtual void AbortOps();
 
+  // The hybrid time that replicas serving follower reads must have caught up to, advanced by the
+  // writes. See client::YBSession::GetReadAfterHybridTime.
+  uint64_t read_after_hybrid_time() const;
+
+  void SetReadAfterHybridTime(uint64_t ht_hybrid_time);
+
   virtual std::shared_ptr<client::YBTable> GetTableDesc(
       const client::YBTableName& table_name, bool *cache_used);
 
   virtual void RemoveCachedTableDesc(const client::YBTableName& table_name);
 
+  // Same as above, for the table with the given id, which may also be an index table.
+  virtual std::shared_ptr<client::YBTable> GetTableDescById(
+      const TableId& table_id, bool *cache_used);
+
+  virtual void RemoveCachedTableDescById(const TableId& table_id);
+
   // Keyspace related methods.
 
   // Create a new keyspace with the given name.
@@ -123,6 +135,17 @@ class QLEnv {
 
   void SetCurrentCall(rpc::InboundCallPtr call);
 
+  // Whether the continuation of the current call after FlushAsync may run directly on the reactor
+  // thread that completed the flush, instead of being requeued to the server's handler thread.
+  // The continuation must not block when this is set.
+  void set_resume_on_reactor(bool value) { resume_on_reactor_ = value; }
+
+  // Whether the current call is being continued on a reactor thread.
+  bool on_reactor_thread() const { return on_reactor_thread_; }
+
+  // Requeue the current call to the server's handler thread, where 'cb' is run.
+  void RequeueCurrentCall(Callback<void(void)>* cb);
+
   cqlserver::CQLRpcServerEnv* cql_rpcserver_env() { return cql_rpcserver_env_; }
 
  private:
@@ -167,6 +190,10 @@ class QLEnv {
   Callback<void(const Status&)>* requested_callback_ = nullptr;
   Callback<void(void)> resume_execution_;
 
+  // See set_resume_on_reactor() and on_reactor_thread().
+  bool resume_on_reactor_ = false;
+  bool on_reactor_thread_ = false;
+
   // The current keyspace. Used only in test environment when there is no current call.
   std::unique_ptr<std::string> current_keyspace_;
 
@@ -134,7 +134,8 @@ class RowsResult : public ExecutedResult {
   const std::string& paging_state() const { return paging_state_; }
   QLClient client() const { return client_; }
 
-  CHECKED_STATUS Append(const RowsResult& other);
+  // Appends the rows of 'other', which is left without rows data.
+  CHECKED_STATUS Append(RowsResult&& other);
   void clear_paging_state() { paging_state_.clear(); }
   void set_paging_state(const QLPagingStatePB& paging_state) {
     paging_state.SerializeToString(&paging_state_);
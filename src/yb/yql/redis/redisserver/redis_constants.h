@@ -22,6 +22,11 @@ static constexpr uint16_t kRedisClusterSlots = 16384;
 static constexpr const char* const kExpireAt = "EXPIRE_AT";
 static constexpr const char* const kExpireIn = "EXPIRE_IN";
 static constexpr const char* const kWithScores = "WITHSCORES";
+static constexpr const char* const kAggregation = "AGGREGATION";
+static constexpr const char* const kMatch = "MATCH";
+static constexpr const char* const kCount = "COUNT";
+// Number of keys examined by SCAN without COUNT, as in Redis.
+static constexpr int32_t kDefaultScanCount = 10;
 static constexpr int64_t kRedisMaxTtlSeconds = std::numeric_limits<int64_t>::max() /
     yb::MonoTime::kNanosecondsPerSecond;
 // Note that this deviates from vanilla Redis, since vanilla Redis allows negative TTLs. We
@@ -0,0 +1,166 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "yb/client/meta_cache.h"
+#include "yb/client/yb_op.h"
+
+#include "yb/common/redis_protocol.pb.h"
+
+#include "yb/yql/redis/redisserver/redis_encoding.h"
+#include "yb/yql/redis/redisserver/redis_parser.h"
+
+#include "yb/util/ref_cnt_buffer.h"
+#include "yb/util/stopwatch.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace redisserver {
+
+class RedisParserTest : public YBTest {
+ protected:
+  // Parses all commands from source, returns number of parsed commands.
+  Result<size_t> ParseAll(Slice source, RedisClientBatch* batch = nullptr) {
+    RedisParser parser(source);
+    size_t result = 0;
+    RedisClientCommand command;
+    const uint8_t* end_of_command = nullptr;
+    for (;;) {
+      parser.SetArgs(batch ? &command : nullptr);
+      RETURN_NOT_OK(parser.NextCommand(&end_of_command));
+      if (end_of_command == nullptr) {
+        break;
+      }
+      ++result;
+      if (batch) {
+        batch->push_back(command);
+      }
+      if (end_of_command == source.end()) {
+        break;
+      }
+    }
+    return result;
+  }
+};
+
+TEST_F(RedisParserTest, Simple) {
+  RedisClientBatch batch;
+  const std::string input = "*3\r\n$3\r\nset\r\n$1\r\nk\r\n$12\r\nhello world!\r\n"
+                            "*2\r\n$3\r\nget\r\n$1\r\nk\r\n";
+  auto parsed = ParseAll(input, &batch);
+  ASSERT_OK(parsed);
+  ASSERT_EQ(2, *parsed);
+  ASSERT_EQ(3, batch[0].size());
+  ASSERT_EQ("set", batch[0][0].ToBuffer());
+  ASSERT_EQ("k", batch[0][1].ToBuffer());
+  ASSERT_EQ("hello world!", batch[0][2].ToBuffer());
+  ASSERT_EQ(2, batch[1].size());
+  ASSERT_EQ("get", batch[1][0].ToBuffer());
+}
+
+TEST_F(RedisParserTest, BadNumbers) {
+  for (const std::string input : {"*\r\n", "*-1\r\n", "*0\r\n", "* 1\r\n", "*1a\r\n",
+                                  "*99999999999999999999999\r\n",
+                                  "*1\r\n$\r\n", "*1\r\n$-2\r\n", "*1\r\n$1x\r\n"}) {
+    ASSERT_NOK(ParseAll(input)) << "Input: " << input;
+  }
+  ASSERT_OK(ParseAll("*1\r\n$0\r\n\r\n"));
+}
+
+TEST_F(RedisParserTest, ScanCursor) {
+  std::vector<RedisKeyValuePB> positions(3);
+  positions[0].set_hash_code(0x1234);
+  positions[1].set_hash_code(0xffff);
+  positions[1].set_key(std::string("key\0\xff", 5));
+  positions[2].set_hash_code(7);
+  positions[2].set_key("");
+
+  for (const auto& position : positions) {
+    const std::string cursor = EncodeScanCursor(position);
+    ASSERT_EQ(std::string::npos, cursor.find_first_not_of("0123456789")) << cursor;
+    client::YBRedisReadOp op(nullptr /* table */);
+    ASSERT_OK(ParseScan(&op, {Slice("SCAN"), Slice(cursor)}));
+    const auto& key_value = op.request().key_value();
+    ASSERT_EQ(position.hash_code(), key_value.hash_code());
+    ASSERT_EQ(position.has_key(), key_value.has_key());
+    ASSERT_EQ(position.key(), key_value.key());
+  }
+
+  // The first scan starts at hash code 0.
+  client::YBRedisReadOp op(nullptr /* table */);
+  ASSERT_OK(ParseScan(&op, {Slice("SCAN"), Slice("0"), Slice("MATCH"), Slice("a*")}));
+  ASSERT_EQ(0, op.request().key_value().hash_code());
+  ASSERT_FALSE(op.request().key_value().has_key());
+  ASSERT_EQ("a*", op.request().scan_request().pattern());
+
+  for (const char* cursor : {"1", "12", "100000000", "1002000000000", "1000000256000", "-5"}) {
+    ASSERT_NOK(ParseScan(&op, {Slice("SCAN"), Slice(cursor)})) << cursor;
+  }
+}
+
+#ifdef NDEBUG
+
+namespace {
+
+constexpr size_t kCommandsInPipeline = 1000;
+constexpr size_t kIterations = 1000;
+
+std::string GeneratePipeline() {
+  std::string result;
+  for (size_t i = 0; i != kCommandsInPipeline; ++i) {
+    auto key = std::to_string(i);
+    result += "*3\r\n$3\r\nset\r\n$" + std::to_string(key.size()) + "\r\n" + key +
+              "\r\n$16\r\n0123456789abcdef\r\n";
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_F(RedisParserTest, BenchmarkParse) {
+  const std::string pipeline = GeneratePipeline();
+  size_t total_commands = 0;
+  LOG_TIMING(INFO, "Parsing commands") {
+    RedisClientBatch batch;
+    for (size_t i = 0; i != kIterations; ++i) {
+      batch.clear();
+      auto parsed = ParseAll(pipeline, &batch);
+      ASSERT_OK(parsed);
+      total_commands += *parsed;
+    }
+  }
+  ASSERT_EQ(kCommandsInPipeline * kIterations, total_commands);
+}
+
+TEST_F(RedisParserTest, BenchmarkEncode) {
+  google::protobuf::RepeatedPtrField<std::string> values;
+  for (size_t i = 0; i != kCommandsInPipeline; ++i) {
+    *values.Add() = std::to_string(i);
+  }
+  size_t total_size = 0; // to avoid optimizing out the results
+  LOG_TIMING(INFO, "Encoding responses") {
+    for (size_t i = 0; i != kIterations; ++i) {
+      total_size += EncodeAsArray(values).size();
+    }
+  }
+  ASSERT_GT(total_size, kIterations);
+}
+
+#endif
+
+} // namespace redisserver
+} // namespace yb
@@ -139,13 +139,14 @@ CHECKED_STATUS ParseSet(YBRedisWriteOp *op, const RedisClientCommand& args) {
   return Status::OK();
 }
 
-// TODO: support MSET
+// MSET is split by the service into separate operation for each key, so here we parse
+// arguments related to single key only: MSET <KEY> <VALUE>.
 CHECKED_STATUS ParseMSet(YBRedisWriteOp *op, const RedisClientCommand& args) {
-  if (args.size() < 3 || args.size() % 2 == 0) {
+  if (args.size() != 3) {
     return STATUS_SUBSTITUTE(InvalidArgument,
-        "An MSET request must have at least 3, odd number of arguments, found $0", args.size());
+        "An MSET key must be followed by single value, found $0 arguments", args.size());
   }
-  return STATUS(InvalidCommand, "MSET command not yet supported");
+  return ParseSet(op, args);
 }
 
 CHECKED_STATUS ParseHSet(YBRedisWriteOp *op, const RedisClientCommand& args) {
@@ -366,9 +367,14 @@ CHECKED_STATUS ParseHGetLikeCommands(YBRedisReadOp* op, const RedisClientCommand
   return ParseCollection(op, args, boost::none, add_string_subkey, remove_duplicates);
 }
 
-// TODO: Support MGET
+// MGET is split by the service into separate operation for each key, so here we parse
+// arguments related to single key only: MGET <KEY>.
 CHECKED_STATUS ParseMGet(YBRedisReadOp* op, const RedisClientCommand& args) {
-  return STATUS(InvalidCommand, "MGET command not yet supported");
+  if (args.size() != 2) {
+    return STATUS_SUBSTITUTE(InvalidArgument,
+        "An MGET key must not be followed by other arguments, found $0 arguments", args.size());
+  }
+  return ParseGet(op, args);
 }
 
 CHECKED_STATUS ParseHGet(YBRedisReadOp* op, const RedisClientCommand& args) {
@@ -440,6 +446,28 @@ CHECKED_STATUS ParseTsRangeByTime(YBRedisReadOp* op, const RedisClientCommand& a
       RedisCollectionGetRangeRequestPB_GetRangeRequestType_TSRANGEBYTIME));
 
   op->mutable_request()->mutable_key_value()->set_key(key.ToBuffer());
+  if (args.size() == 4) {
+    return Status::OK();
+  }
+
+  // TSRANGEBYTIME key low high AGGREGATION <MIN|MAX|AVG|SUM|COUNT> <bucket_size>
+  if (args.size() != 7 || !boost::iequals(args[4].ToBuffer(), kAggregation)) {
+    return STATUS(InvalidArgument, "Expected AGGREGATION followed by its type and bucket size");
+  }
+  RedisTimeSeriesAggregationPB::AggregationType type;
+  if (!RedisTimeSeriesAggregationPB::AggregationType_Parse(
+          boost::to_upper_copy(args[5].ToBuffer()), &type)) {
+    return STATUS_SUBSTITUTE(InvalidArgument, "Unknown aggregation type $0", args[5].ToBuffer());
+  }
+  auto bucket_size = ParseInt64(args[6], "Bucket size");
+  RETURN_NOT_OK(bucket_size);
+  if (*bucket_size <= 0) {
+    return STATUS_SUBSTITUTE(InvalidArgument, "Bucket size $0 must be positive", *bucket_size);
+  }
+  auto* aggregation =
+      op->mutable_request()->mutable_get_collection_range_request()->mutable_aggregation();
+  aggregation->set_type(type);
+  aggregation->set_bucket_size(*bucket_size);
   return Status::OK();
 }
 
@@ -480,6 +508,39 @@ CHECKED_STATUS ParseZRangeByScore(YBRedisReadOp* op, const RedisClientCommand& a
   }
 }
 
+CHECKED_STATUS ParseZRangeByRank(
+    YBRedisReadOp* op, const RedisClientCommand& args,
+    RedisCollectionGetRangeRequestPB::GetRangeRequestType request_type) {
+  if (args.size() > 5) {
+    return STATUS_SUBSTITUTE(InvalidArgument, "Expected at most 5 arguments, found $0",
+                             args.size());
+  }
+  auto* range_request = op->mutable_request()->mutable_get_collection_range_request();
+  range_request->set_request_type(request_type);
+
+  const auto& key = args[1];
+  op->mutable_request()->mutable_key_value()->set_key(key.cdata(), key.size());
+  auto start = ParseInt64(args[2], "Start");
+  RETURN_NOT_OK(start);
+  range_request->set_start(*start);
+  auto stop = ParseInt64(args[3], "Stop");
+  RETURN_NOT_OK(stop);
+  range_request->set_stop(*stop);
+  if (args.size() == 5) {
+    RETURN_NOT_OK(ParseWithScores(args[4], range_request));
+  }
+  return Status::OK();
+}
+
+CHECKED_STATUS ParseZRange(YBRedisReadOp* op, const RedisClientCommand& args) {
+  return ParseZRangeByRank(op, args, RedisCollectionGetRangeRequestPB_GetRangeRequestType_ZRANGE);
+}
+
+CHECKED_STATUS ParseZRevRange(YBRedisReadOp* op, const RedisClientCommand& args) {
+  return ParseZRangeByRank(
+      op, args, RedisCollectionGetRangeRequestPB_GetRangeRequestType_ZREVRANGE);
+}
+
 CHECKED_STATUS ParseTsGet(YBRedisReadOp* op, const RedisClientCommand& args) {
   op->mutable_request()->set_allocated_get_request(new RedisGetRequestPB());
   op->mutable_request()->mutable_get_request()->set_request_type(
@@ -538,6 +599,10 @@ CHECKED_STATUS ParseZCard(YBRedisReadOp* op, const RedisClientCommand& args) {
   return ParseHGetLikeCommands(op, args, RedisGetRequestPB_GetRequestType_ZCARD);
 }
 
+CHECKED_STATUS ParseZRank(YBRedisReadOp* op, const RedisClientCommand& args) {
+  return ParseHGetLikeCommands(op, args, RedisGetRequestPB_GetRequestType_ZRANK);
+}
+
 CHECKED_STATUS ParseStrLen(YBRedisReadOp* op, const RedisClientCommand& args) {
   op->mutable_request()->set_allocated_strlen_request(new RedisStrLenRequestPB());
   const auto& key = args[1];
@@ -569,6 +634,88 @@ CHECKED_STATUS ParseGetRange(YBRedisReadOp* op, const RedisClientCommand& args)
   return Status::OK();
 }
 
+// The SCAN cursor is "0" at the start of the scan. Otherwise it is "1" followed by 3 decimal
+// digits for each byte of: 1 when the scan resumes after a key and 0 when it starts at a hash
+// code, the big endian hash code and the key, if any. The cursor is a decimal number, since clients
+// tend to parse it as one.
+std::string EncodeScanCursor(const RedisKeyValuePB& position) {
+  std::string bytes(1, position.has_key() ? 1 : 0);
+  bytes.push_back(static_cast<char>(position.hash_code() >> 8));
+  bytes.push_back(static_cast<char>(position.hash_code() & 0xff));
+  if (position.has_key()) {
+    bytes.append(position.key());
+  }
+  std::string result = "1";
+  result.reserve(1 + bytes.size() * 3);
+  for (uint8_t byte : bytes) {
+    result.push_back('0' + byte / 100);
+    result.push_back('0' + byte / 10 % 10);
+    result.push_back('0' + byte % 10);
+  }
+  return result;
+}
+
+namespace {
+
+CHECKED_STATUS DecodeScanCursor(const Slice& cursor, RedisKeyValuePB* position) {
+  if (cursor == Slice("0")) {
+    position->set_hash_code(0);
+    return Status::OK();
+  }
+  auto invalid = STATUS_SUBSTITUTE(InvalidArgument, "Invalid cursor $0", cursor.ToDebugString());
+  if (cursor.size() < 10 || cursor[0] != '1' || (cursor.size() - 1) % 3 != 0) {
+    return invalid;
+  }
+  std::string bytes;
+  for (size_t i = 1; i != cursor.size(); i += 3) {
+    int byte = 0;
+    for (size_t j = i; j != i + 3; ++j) {
+      if (!isdigit(cursor[j])) {
+        return invalid;
+      }
+      byte = byte * 10 + (cursor[j] - '0');
+    }
+    if (byte > 0xff) {
+      return invalid;
+    }
+    bytes.push_back(static_cast<char>(byte));
+  }
+  if (bytes[0] != 0 && bytes[0] != 1) {
+    return invalid;
+  }
+  position->set_hash_code((static_cast<uint8_t>(bytes[1]) << 8) | static_cast<uint8_t>(bytes[2]));
+  if (bytes[0] == 1) {
+    position->set_key(bytes.substr(3));
+  }
+  return Status::OK();
+}
+
+} // namespace
+
+// SCAN <CURSOR> [MATCH <PATTERN>] [COUNT <COUNT>]
+CHECKED_STATUS ParseScan(YBRedisReadOp* op, const RedisClientCommand& args) {
+  auto* scan_request = op->mutable_request()->mutable_scan_request();
+  scan_request->set_count(kDefaultScanCount);
+  for (size_t i = 2; i < args.size(); i += 2) {
+    if (i + 1 == args.size()) {
+      return STATUS(InvalidArgument, "Syntax error");
+    }
+    if (boost::iequals(args[i].ToBuffer(), kMatch)) {
+      scan_request->set_pattern(args[i + 1].cdata(), args[i + 1].size());
+    } else if (boost::iequals(args[i].ToBuffer(), kCount)) {
+      auto count = ParseInt32(args[i + 1], "Count");
+      RETURN_NOT_OK(count);
+      if (*count <= 0) {
+        return STATUS(InvalidArgument, "Syntax error");
+      }
+      scan_request->set_count(*count);
+    } else {
+      return STATUS(InvalidArgument, "Syntax error");
+    }
+  }
+  return DecodeScanCursor(args[1], op->mutable_request()->mutable_key_value());
+}
+
 // Begin of input is going to be consumed, so we should adjust our pointers.
 // Since the beginning of input is being consumed by shifting the remaining bytes to the
 // beginning of the buffer.
@@ -742,18 +889,44 @@ CHECKED_STATUS RedisParser::ParseNumber(char prefix,
                              prefix,
                              static_cast<char>(*token_begin_));
   }
+  // Numbers are parsed in place, since they are located in the read buffer and are not null
+  // terminated. It also avoids any temporary allocations on the hot path.
   auto number_begin = token_begin_ + 1;
   auto expected_stop = pos_ - kLineEndLength;
-  auto parsed_number = util::CheckedStoll(Slice(number_begin, expected_stop));
-  RETURN_NOT_OK(parsed_number);
-  static_assert(sizeof(*parsed_number) == sizeof(*out), "Expected size");
-  SCHECK_BOUNDS(*parsed_number,
+  auto it = number_begin;
+  bool negative = it != expected_stop && *it == '-';
+  if (negative) {
+    ++it;
+  }
+  if (it == expected_stop) {
+    return STATUS_SUBSTITUTE(Corruption, "$0 is empty", name);
+  }
+  // Bounds are checked while accumulating digits, so this value could not overflow.
+  const ptrdiff_t limit = negative ? -min : max;
+  ptrdiff_t parsed_number = 0;
+  for (; it != expected_stop; ++it) {
+    auto digit = *it - '0';
+    if (digit < 0 || digit > 9) {
+      return STATUS_SUBSTITUTE(Corruption,
+                               "Invalid character in $0: $1",
+                               name,
+                               static_cast<char>(*it));
+    }
+    parsed_number = parsed_number * 10 + digit;
+    if (parsed_number > limit) {
+      break;
+    }
+  }
+  if (negative) {
+    parsed_number = -parsed_number;
+  }
+  SCHECK_BOUNDS(parsed_number,
                 min,
                 max,
                 Corruption,
                 yb::Format("$0 out of expected range [$1, $2] : $3",
-                           name, min, max, *parsed_number));
-  *out = static_cast<ptrdiff_t>(*parsed_number);
+                           name, min, max, Slice(number_begin, expected_stop).ToBuffer()));
+  *out = parsed_number;
   return Status::OK();
 }
 
@@ -29,6 +29,9 @@
 #include "yb/util/size_literals.h"
 
 namespace yb {
+
+class RedisKeyValuePB;
+
 namespace redisserver {
 
 constexpr size_t kMaxBufferSize = 512_MB;
@@ -37,6 +40,12 @@ constexpr int64_t kNoneTtl = -1;
 CHECKED_STATUS ParseSet(client::YBRedisWriteOp *op, const RedisClientCommand& args);
 CHECKED_STATUS ParseGet(client::YBRedisReadOp* op, const RedisClientCommand& args);
 
+CHECKED_STATUS ParseScan(client::YBRedisReadOp* op, const RedisClientCommand& args);
+
+// Returns the SCAN cursor for the given scan position: the hash code to start from and, when set,
+// the key to resume after. ParseScan decodes it into the key_value of the scan request.
+std::string EncodeScanCursor(const RedisKeyValuePB& position);
+
 // TODO: make additional command support here
 
 // RedisParser is a finite state machine with memory.
@@ -27,6 +27,7 @@
 #include "yb/rpc/reactor.h"
 #include "yb/rpc/rpc_introspection.pb.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/size_literals.h"
 
@@ -42,6 +43,10 @@ DEFINE_uint64(redis_max_concurrent_commands, 1,
               "Max number of redis commands received from single connection, "
               "that could be processed concurrently");
 DEFINE_uint64(redis_max_batch, 500, "Max number of redis commands that forms batch");
+DEFINE_bool(redis_coalesce_pipelined_commands, false,
+            "Keep received redis commands while the connection is at its limit of concurrently "
+            "processed commands, so pipelined commands form one batch instead of many small ones.");
+TAG_FLAG(redis_coalesce_pipelined_commands, advanced);
 DEFINE_int32(rpcz_max_redis_query_dump_size, 4_KB,
              "The maximum size of the Redis query string in the RPCZ dump.");
 
@@ -88,7 +93,11 @@ Status RedisConnectionContext::ProcessCalls(const rpc::ConnectionPtr& connection
   // Create call for rest of commands.
   // Do not form new call if we are in a middle of command.
   // It means that soon we should receive remaining data for this command and could wait.
-  if (commands_in_batch_ > 0 && end_of_batch == slice.end()) {
+  // When coalescing is enabled, also wait while the call could not be processed immediately.
+  // Remaining commands are processed, together with commands received meanwhile, after one
+  // of calls being processed is done, see OnCallProcessed.
+  if (commands_in_batch_ > 0 && end_of_batch == slice.end() &&
+      (!FLAGS_redis_coalesce_pipelined_commands || CanStartProcessingCall())) {
     RETURN_NOT_OK(HandleInboundCall(connection,
                                     commands_in_batch_,
                                     Slice(begin_of_batch, end_of_batch)));
@@ -118,6 +127,17 @@ Status RedisConnectionContext::HandleInboundCall(const rpc::ConnectionPtr& conne
   return Status::OK();
 }
 
+void RedisConnectionContext::OnCallProcessed(rpc::Connection* connection) {
+  if (commands_in_batch_ == 0 || !CanStartProcessingCall()) {
+    return;
+  }
+  // There are received commands that were kept to be coalesced.
+  connection->reactor()->ScheduleReactorFunctor(
+      [connection = connection->shared_from_this()](rpc::Reactor*) {
+    connection->ProcessReceived();
+  });
+}
+
 size_t RedisConnectionContext::BufferLimit() {
   return kMaxBufferSize;
 }
@@ -46,6 +46,8 @@ class RedisConnectionContext : public rpc::ConnectionContextWithQueue {
                               size_t* consumed) override;
   size_t BufferLimit() override;
 
+  void OnCallProcessed(rpc::Connection* connection) override;
+
   CHECKED_STATUS HandleInboundCall(const rpc::ConnectionPtr& connection,
                                    size_t commands_in_batch,
                                    Slice source);
@@ -47,6 +47,7 @@
 #include "yb/tserver/tablet_server.h"
 
 #include "yb/util/bytes_formatter.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/memory/mc_types.h"
 #include "yb/util/size_literals.h"
@@ -109,9 +110,27 @@ DEFINE_int32(redis_max_value_size, 64_MB,
 
 DEFINE_bool(redis_safe_batch, true, "Use safe batching with Redis service");
 
+DEFINE_int32(redis_scan_batch_size, 1000,
+             "Maximum number of keys a single SCAN call examines on one tablet.");
+TAG_FLAG(redis_scan_batch_size, advanced);
+TAG_FLAG(redis_scan_batch_size, runtime);
+
+DEFINE_int32(redis_scan_max_parallel_tablets, 8,
+             "Maximum number of tablets a single SCAN call examines in parallel, when its COUNT "
+             "is above redis_scan_batch_size.");
+TAG_FLAG(redis_scan_max_parallel_tablets, advanced);
+TAG_FLAG(redis_scan_max_parallel_tablets, runtime);
+
+DEFINE_int32(redis_follower_reads_max_staleness_ms, 0,
+             "If positive, Redis reads are served by the closest replica whose data is at most "
+             "this many milliseconds stale, falling back to other replicas and the leader. "
+             "Otherwise they are served by the leader.");
+TAG_FLAG(redis_follower_reads_max_staleness_ms, advanced);
+TAG_FLAG(redis_follower_reads_max_staleness_ms, runtime);
+
 #define REDIS_COMMANDS \
     ((get, Get, 2, READ)) \
-    ((mget, MGet, -2, READ)) \
+    ((mget, MGet, -2, MULTI_READ)) \
     ((hget, HGet, 3, READ)) \
     ((tsget, TsGet, 3, READ)) \
     ((hmget, HMGet, -3, READ)) \
@@ -128,16 +147,19 @@ DEFINE_bool(redis_safe_batch, true, "Use safe batching with Redis service");
     ((exists, Exists, 2, READ)) \
     ((getrange, GetRange, 4, READ)) \
     ((zcard, ZCard, 2, READ)) \
+    ((zrank, ZRank, 3, READ)) \
     ((set, Set, -3, WRITE)) \
-    ((mset, MSet, -3, WRITE)) \
+    ((mset, MSet, -3, MULTI_WRITE)) \
     ((hset, HSet, 4, WRITE)) \
     ((hmset, HMSet, -4, WRITE)) \
     ((hdel, HDel, -3, WRITE)) \
     ((sadd, SAdd, -3, WRITE)) \
     ((srem, SRem, -3, WRITE)) \
     ((tsadd, TsAdd, -4, WRITE)) \
-    ((tsrangebytime, TsRangeByTime, 4, READ)) \
+    ((tsrangebytime, TsRangeByTime, -4, READ)) \
     ((zrangebyscore, ZRangeByScore, -4, READ)) \
+    ((zrange, ZRange, -4, READ)) \
+    ((zrevrange, ZRevRange, -4, READ)) \
     ((tsrem, TsRem, -3, WRITE)) \
     ((zrem, ZRem, -3, WRITE)) \
     ((zadd, ZAdd, -4, WRITE)) \
@@ -155,7 +177,8 @@ DEFINE_bool(redis_safe_batch, true, "Use safe batching with Redis service");
     ((command, Command, -1, LOCAL)) \
     ((quit, Quit, 1, LOCAL)) \
     ((flushdb, FlushDB, 1, TRUNCATE)) \
-    ((flushall, FlushAll, 1, TRUNCATE))
+    ((flushall, FlushAll, 1, TRUNCATE)) \
+    ((scan, Scan, -2, SCAN))
     /**/
 
 #define DO_DEFINE_HISTOGRAM(name, cname, arity, type) \
@@ -181,8 +204,11 @@ typedef boost::container::small_vector_base<Slice> RedisKeyList;
 
 #define READ_OP YBRedisReadOp
 #define WRITE_OP YBRedisWriteOp
+#define MULTI_READ_OP YBRedisReadOp
+#define MULTI_WRITE_OP YBRedisWriteOp
 #define LOCAL_OP RedisResponsePB
 #define TRUNCATE_OP void
+#define SCAN_OP YBRedisReadOp
 
 #define DO_PARSER_FORWARD(name, cname, arity, type) \
     CHECKED_STATUS BOOST_PP_CAT(Parse, cname)( \
@@ -194,18 +220,107 @@ BOOST_PP_SEQ_FOR_EACH(PARSER_FORWARD, ~, REDIS_COMMANDS)
 
 namespace {
 
+// Collects responses for all keys of a multi key command, i.e. MGET or MSET, that is executed
+// as separate operation for each key. Responds to the command when all keys are responded.
+class MultiKeyResponse {
+ public:
+  MultiKeyResponse(const std::shared_ptr<RedisInboundCall>& call,
+                   size_t index,
+                   size_t num_keys,
+                   bool read,
+                   const rpc::RpcMethodMetrics& metrics)
+      : call_(call),
+        index_(index),
+        read_(read),
+        metrics_(metrics),
+        responses_(num_keys),
+        statuses_(num_keys),
+        keys_left_(num_keys) {}
+
+  // Invoked once for each key, could be invoked concurrently for different keys.
+  void Respond(size_t key_index, const Status& status, RedisResponsePB* response) {
+    if (status.ok()) {
+      responses_[key_index].Swap(response);
+    } else {
+      statuses_[key_index] = status;
+    }
+    if (keys_left_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      Done();
+    }
+  }
+
+ private:
+  void Done() {
+    for (const auto& status : statuses_) {
+      if (!status.ok()) {
+        call_->RespondFailure(index_, status);
+        return;
+      }
+    }
+
+    RedisResponsePB response;
+    response.set_code(RedisResponsePB_RedisStatusCode_OK);
+    if (read_) {
+      // As in Redis, nil is returned for keys that do not exist or do not hold a string.
+      auto* array_response = response.mutable_array_response();
+      for (const auto& key_response : responses_) {
+        if (key_response.code() == RedisResponsePB_RedisStatusCode_OK &&
+            key_response.has_string_response()) {
+          auto encoded = EncodeAsBulkString(key_response.string_response());
+          array_response->add_elements(encoded.data(), encoded.size());
+        } else {
+          array_response->add_elements(kNilResponse);
+        }
+      }
+      array_response->set_encoded(true);
+    } else {
+      for (auto& key_response : responses_) {
+        if (key_response.code() != RedisResponsePB_RedisStatusCode_OK) {
+          response.Swap(&key_response);
+          break;
+        }
+      }
+    }
+    call_->RespondSuccess(index_, metrics_, &response);
+  }
+
+  std::shared_ptr<RedisInboundCall> call_;
+  const size_t index_;
+  const bool read_;
+  rpc::RpcMethodMetrics metrics_;
+  std::vector<RedisResponsePB> responses_;
+  std::vector<Status> statuses_;
+  std::atomic<size_t> keys_left_;
+};
+
+// Lets the read be served by a follower, when enabled by redis_follower_reads_max_staleness_ms.
+void SetReadConsistency(YBRedisReadOp* op) {
+  const int32_t max_staleness_ms = FLAGS_redis_follower_reads_max_staleness_ms;
+  if (max_staleness_ms > 0) {
+    op->set_yb_consistency_level(YBConsistencyLevel::CONSISTENT_PREFIX);
+    op->set_max_staleness_ms(max_staleness_ms);
+  }
+}
+
+void SetReadConsistency(YBRedisWriteOp* op) {
+}
+
 class Operation {
  public:
   template <class Op>
   Operation(const std::shared_ptr<RedisInboundCall>& call,
             size_t index,
             std::shared_ptr<Op> operation,
-            const rpc::RpcMethodMetrics& metrics)
+            const rpc::RpcMethodMetrics& metrics,
+            std::shared_ptr<MultiKeyResponse> multi_key_response = nullptr,
+            size_t key_index = 0)
     : read_(std::is_same<Op, YBRedisReadOp>::value),
       call_(call),
       index_(index),
       operation_(std::move(operation)),
-      metrics_(metrics) {
+      metrics_(metrics),
+      multi_key_response_(std::move(multi_key_response)),
+      key_index_(key_index) {
     auto status = operation_->GetPartitionKey(&partition_key_);
     if (!status.ok()) {
       Respond(status);
@@ -272,7 +387,9 @@ class Operation {
 
   void Respond(const Status& status) {
     responded_.store(true, std::memory_order_release);
-    if (status.ok()) {
+    if (multi_key_response_) {
+      multi_key_response_->Respond(key_index_, status, &response());
+    } else if (status.ok()) {
       call_->RespondSuccess(index_, metrics_, &response());
     } else {
       call_->RespondFailure(index_, status);
@@ -284,6 +401,8 @@ class Operation {
   size_t index_;
   std::shared_ptr<YBRedisOp> operation_;
   rpc::RpcMethodMetrics metrics_;
+  std::shared_ptr<MultiKeyResponse> multi_key_response_;
+  size_t key_index_;
   std::string partition_key_;
   scoped_refptr<client::internal::RemoteTablet> tablet_;
   std::atomic<bool> responded_{false};
@@ -567,8 +686,11 @@ class BatchContext : public RefCountedThreadSafe<BatchContext> {
   template <class Op>
   void Apply(size_t idx,
              std::shared_ptr<Op> op,
-             const rpc::RpcMethodMetrics& metrics) {
-    operations_.emplace_back(call_, idx, std::move(op), metrics);
+             const rpc::RpcMethodMetrics& metrics,
+             std::shared_ptr<MultiKeyResponse> multi_key_response = nullptr,
+             size_t key_index = 0) {
+    operations_.emplace_back(
+        call_, idx, std::move(op), metrics, std::move(multi_key_response), key_index);
     if (PREDICT_FALSE(operations_.back().responded())) {
       operations_.pop_back();
     }
@@ -614,6 +736,164 @@ class BatchContext : public RefCountedThreadSafe<BatchContext> {
   MCUnorderedMap<Slice, TabletOperations, Slice::Hash> tablets_;
 };
 
+// Executes SCAN on consecutive tablets, starting from the tablet of the cursor. The tablets are
+// looked up one after another and then scanned in parallel, as a single flush. The keys of a
+// tablet are only returned when all tablets before it have been scanned to their end, so the new
+// cursor points into the first tablet that has more keys.
+//
+// SCAN is not batched with the other commands of the call, so it does not wait for the writes that
+// precede it in the same call.
+class ScanContext : public RefCountedThreadSafe<ScanContext> {
+ public:
+  ScanContext(const std::shared_ptr<client::YBClient>& client,
+              const std::shared_ptr<client::YBTable>& table,
+              SessionPool* session_pool,
+              const std::shared_ptr<RedisInboundCall>& call,
+              size_t index,
+              const rpc::RpcMethodMetrics& metrics,
+              std::shared_ptr<YBRedisReadOp> first_op)
+      : client_(client),
+        table_(table),
+        session_pool_(session_pool),
+        call_(call),
+        index_(index),
+        metrics_(metrics),
+        deadline_(MonoTime::Now() +
+                  MonoDelta::FromMilliseconds(FLAGS_redis_service_yb_client_timeout_millis)) {
+    const int64_t count = first_op->request().scan_request().count();
+    const int64_t tablet_count = std::min<int64_t>(count, std::max(FLAGS_redis_scan_batch_size, 1));
+    first_op->mutable_request()->mutable_scan_request()->set_count(tablet_count);
+    num_tablets_ = std::max<int64_t>(
+        std::min<int64_t>((count + tablet_count - 1) / tablet_count,
+                          FLAGS_redis_scan_max_parallel_tablets),
+        1);
+    ops_.push_back(std::move(first_op));
+    tablets_.reserve(num_tablets_);
+  }
+
+  void Start() {
+    LookupTablet(PartitionSchema::EncodeMultiColumnHashValue(
+        ops_.front()->request().key_value().hash_code()));
+  }
+
+ private:
+  class ScanCallback : public YBStatusCallback {
+   public:
+    explicit ScanCallback(scoped_refptr<ScanContext> context) : context_(std::move(context)) {}
+
+    void Run(const Status& status) override {
+      context_->Done(status);
+      context_.reset();
+      delete this;
+    }
+   private:
+    scoped_refptr<ScanContext> context_;
+  };
+
+  void LookupTablet(const std::string& partition_key) {
+    tablets_.emplace_back();
+    client_->LookupTabletByKey(table_.get(), partition_key, deadline_, &tablets_.back(),
+                               Bind(&ScanContext::LookupDone, this));
+  }
+
+  void LookupDone(const Status& status) {
+    if (!status.ok()) {
+      call_->RespondFailure(index_, status);
+      return;
+    }
+    const auto& partition_end = tablets_.back()->partition().partition_key_end();
+    if (tablets_.size() < num_tablets_ && !partition_end.empty()) {
+      LookupTablet(partition_end);
+      return;
+    }
+    Launch();
+  }
+
+  void Launch() {
+    // The next tablets are scanned from their start.
+    for (size_t i = 1; i != tablets_.size(); ++i) {
+      auto op = std::make_shared<YBRedisReadOp>(table_);
+      *op->mutable_request()->mutable_scan_request() = ops_.front()->request().scan_request();
+      const auto& partition_start = tablets_[i]->partition().partition_key_start();
+      op->mutable_request()->mutable_key_value()->set_hash_code(
+          PartitionSchema::DecodeMultiColumnHashValue(partition_start));
+      ops_.push_back(std::move(op));
+    }
+
+    session_ = session_pool_->Take();
+    for (size_t i = 0; i != ops_.size(); ++i) {
+      ops_[i]->SetTablet(tablets_[i]);
+      const Status status = session_->Apply(ops_[i]);
+      if (!status.ok()) {
+        session_->Abort();
+        Done(status);
+        return;
+      }
+    }
+    session_->FlushAsync(new ScanCallback(this));
+  }
+
+  void Done(const Status& status) {
+    if (!status.ok()) {
+      for (const auto& error : session_->GetPendingErrors()) {
+        LOG(WARNING) << "Explicit error while scanning: " << error->status().ToString();
+      }
+    }
+    session_pool_->Release(session_);
+    session_.reset();
+    if (!status.ok()) {
+      call_->RespondFailure(index_, status);
+      return;
+    }
+
+    google::protobuf::RepeatedPtrField<std::string> keys;
+    std::string cursor;
+    for (size_t i = 0; i != ops_.size(); ++i) {
+      auto& response = *ops_[i]->mutable_response();
+      if (response.code() != RedisResponsePB_RedisStatusCode_OK) {
+        call_->RespondFailure(index_, STATUS(RuntimeError, response.error_message()));
+        return;
+      }
+      keys.MergeFrom(response.array_response().elements());
+      if (response.has_scan_resume_key()) {
+        cursor = EncodeScanCursor(response.scan_resume_key());
+        break;
+      }
+      const auto& partition_end = tablets_[i]->partition().partition_key_end();
+      if (partition_end.empty()) {
+        // The last tablet has been scanned to its end.
+        cursor = "0";
+        break;
+      }
+      RedisKeyValuePB next_tablet;
+      next_tablet.set_hash_code(PartitionSchema::DecodeMultiColumnHashValue(partition_end));
+      cursor = EncodeScanCursor(next_tablet);
+    }
+
+    RedisResponsePB response;
+    response.set_code(RedisResponsePB_RedisStatusCode_OK);
+    auto* array_response = response.mutable_array_response();
+    auto encoded = EncodeAsBulkString(cursor);
+    array_response->add_elements(encoded.data(), encoded.size());
+    encoded = EncodeAsArray(keys);
+    array_response->add_elements(encoded.data(), encoded.size());
+    array_response->set_encoded(true);
+    call_->RespondSuccess(index_, metrics_, &response);
+  }
+
+  std::shared_ptr<client::YBClient> client_;
+  std::shared_ptr<client::YBTable> table_;
+  SessionPool* session_pool_;
+  std::shared_ptr<RedisInboundCall> call_;
+  const size_t index_;
+  rpc::RpcMethodMetrics metrics_;
+  const MonoTime deadline_;
+  size_t num_tablets_;
+  std::vector<std::shared_ptr<YBRedisReadOp>> ops_;
+  std::vector<scoped_refptr<client::internal::RemoteTablet>> tablets_;
+  std::shared_ptr<client::YBSession> session_;
+};
+
 template<class Op>
 using Parser = Status(*)(Op*, const RedisClientCommand&);
 
@@ -642,6 +922,11 @@ class RedisServiceImpl::Impl {
 
   void Handle(yb::rpc::InboundCallPtr call_ptr);
 
+  // Commands only dispatch asynchronous operations, once the client is set up.
+  bool CanHandleOnReactor() const {
+    return yb_client_initialized_.load(std::memory_order_acquire);
+  }
+
  private:
   void SetupMethod(const RedisCommandInfo& info) {
     auto info_ptr = std::make_shared<RedisCommandInfo>(info);
@@ -680,12 +965,27 @@ class RedisServiceImpl::Impl {
       Parser<Op> parser,
       BatchContext* context);
 
+  // Executes command over multiple keys as separate operation for each key, so operations are
+  // batched per tablet together with other operations of the call.
+  template<class Op>
+  void MultiKeyCommand(
+      const RedisCommandInfo& info,
+      size_t idx,
+      Parser<Op> parser,
+      BatchContext* context);
+
   void TruncateCommand(
       const RedisCommandInfo& info,
       size_t idx,
       void (*parse)(const RedisClientCommand&),
       BatchContext* context);
 
+  void ScanCommand(
+      const RedisCommandInfo& info,
+      size_t idx,
+      Parser<YBRedisReadOp> parser,
+      BatchContext* context);
+
   constexpr static int kRpcTimeoutSec = 5;
 
   void PopulateHandlers();
@@ -781,8 +1081,11 @@ void ParseFlushAll(const RedisClientCommand& command) {
 
 #define READ_COMMAND Command<YBRedisReadOp>
 #define WRITE_COMMAND Command<YBRedisWriteOp>
+#define MULTI_READ_COMMAND MultiKeyCommand<YBRedisReadOp>
+#define MULTI_WRITE_COMMAND MultiKeyCommand<YBRedisWriteOp>
 #define LOCAL_COMMAND LocalCommand
 #define TRUNCATE_COMMAND TruncateCommand
+#define SCAN_COMMAND ScanCommand
 
 #define DO_POPULATE_HANDLER(name, cname, arity, type) \
   { \
@@ -952,9 +1255,54 @@ void RedisServiceImpl::Impl::Command(
     RespondWithFailure(context->call(), idx, s.message().ToBuffer());
     return;
   }
+  SetReadConsistency(op.get());
   context->Apply(idx, std::move(op), info.metrics);
 }
 
+template<class Op>
+void RedisServiceImpl::Impl::MultiKeyCommand(
+    const RedisCommandInfo& info,
+    size_t idx,
+    Parser<Op> parser,
+    BatchContext* context) {
+  VLOG(1) << "Processing " << info.name << ".";
+
+  // Multi key command has form: CMD (<KEY> <ARG>*)+, where number of arguments for each key,
+  // including the key itself, is determined by arity, i.e. the minimal number of arguments.
+  const auto& command = context->command(idx);
+  const size_t args_per_key = -info.arity - 1;
+  if ((command.size() - 1) % args_per_key != 0) {
+    RespondWithFailure(context->call(), idx, "Wrong number of arguments.");
+    return;
+  }
+  const size_t num_keys = (command.size() - 1) / args_per_key;
+
+  // Parse all keys before applying any of them, so invalid command is not partially executed.
+  std::vector<std::shared_ptr<Op>> ops;
+  ops.reserve(num_keys);
+  RedisClientCommand key_args;
+  for (size_t i = 0; i != num_keys; ++i) {
+    const auto begin = command.begin() + 1 + i * args_per_key;
+    key_args.clear();
+    key_args.push_back(command[0]);
+    key_args.insert(key_args.end(), begin, begin + args_per_key);
+    auto op = std::make_shared<Op>(table_);
+    Status s = parser(op.get(), key_args);
+    if (!s.ok()) {
+      RespondWithFailure(context->call(), idx, s.message().ToBuffer());
+      return;
+    }
+    SetReadConsistency(op.get());
+    ops.push_back(std::move(op));
+  }
+
+  auto response = std::make_shared<MultiKeyResponse>(
+      context->call(), idx, num_keys, std::is_same<Op, YBRedisReadOp>::value, info.metrics);
+  for (size_t i = 0; i != num_keys; ++i) {
+    context->Apply(idx, std::move(ops[i]), info.metrics, response, i);
+  }
+}
+
 void RedisServiceImpl::Impl::TruncateCommand(
     const RedisCommandInfo& info,
     size_t idx,
@@ -975,6 +1323,24 @@ void RedisServiceImpl::Impl::TruncateCommand(
   VLOG(4) << "Done responding to " << command[0].ToBuffer();
 }
 
+void RedisServiceImpl::Impl::ScanCommand(
+    const RedisCommandInfo& info,
+    size_t idx,
+    Parser<YBRedisReadOp> parser,
+    BatchContext* context) {
+  VLOG(1) << "Processing " << info.name << ".";
+
+  auto op = std::make_shared<YBRedisReadOp>(table_);
+  Status s = parser(op.get(), context->command(idx));
+  if (!s.ok()) {
+    RespondWithFailure(context->call(), idx, s.message().ToBuffer());
+    return;
+  }
+  auto scan_context = make_scoped_refptr(new ScanContext(
+      client_, table_, &session_pool_, context->call(), idx, info.metrics, std::move(op)));
+  scan_context->Start();
+}
+
 void RedisServiceImpl::Impl::RespondWithFailure(
     std::shared_ptr<RedisInboundCall> call,
     size_t idx,
@@ -1004,5 +1370,9 @@ void RedisServiceImpl::Handle(yb::rpc::InboundCallPtr call) {
   impl_->Handle(std::move(call));
 }
 
+bool RedisServiceImpl::CanHandleOnReactor(const yb::rpc::InboundCall& call) const {
+  return impl_->CanHandleOnReactor();
+}
+
 }  // namespace redisserver
 }  // namespace yb
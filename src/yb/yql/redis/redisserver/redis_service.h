@@ -31,6 +31,8 @@ class RedisServiceImpl : public RedisServerServiceIf {
 
   void Handle(yb::rpc::InboundCallPtr call) override;
 
+  bool CanHandleOnReactor(const yb::rpc::InboundCall& call) const override;
+
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
@@ -14,6 +14,7 @@
 #include <chrono>
 #include <memory>
 #include <random>
+#include <set>
 #include <string>
 #include <thread>
 #include <vector>
@@ -39,9 +40,11 @@
 DECLARE_uint64(redis_max_concurrent_commands);
 DECLARE_uint64(redis_max_batch);
 DECLARE_bool(redis_safe_batch);
+DECLARE_bool(redis_coalesce_pipelined_commands);
 DECLARE_bool(emulate_redis_responses);
 DECLARE_int32(redis_max_value_size);
 DECLARE_int32(redis_max_command_size);
+DECLARE_int32(redis_scan_batch_size);
 DECLARE_int32(rpc_max_message_size);
 DECLARE_int32(consensus_max_batch_size_bytes);
 
@@ -193,6 +196,29 @@ class TestRedisService : public RedisTableTestBase {
     );
   }
 
+  // Runs SCAN with the given arguments from the start, following the returned cursors to the end,
+  // and adds the returned keys to keys.
+  void ScanAll(int line, const std::vector<std::string>& args, std::multiset<std::string>* keys) {
+    std::string cursor = "0";
+    do {
+      std::vector<std::string> command = {"SCAN", cursor};
+      command.insert(command.end(), args.begin(), args.end());
+      cursor.clear();
+      DoRedisTest(line, command, cpp_redis::reply::type::array,
+          [line, &cursor, keys](const RedisReply& reply) {
+            const auto& replies = reply.as_array();
+            ASSERT_EQ(2, replies.size()) << "Originator: " << __FILE__ << ":" << line;
+            cursor = replies[0].as_string();
+            for (const auto& key : replies[1].as_array()) {
+              keys->insert(key.as_string());
+            }
+          }
+      );
+      SyncClient();
+    } while (!cursor.empty() && cursor != "0");
+    ASSERT_EQ("0", cursor) << "Originator: " << __FILE__ << ":" << line;
+  }
+
   void SyncClient() { client().sync_commit(); }
 
   void VerifyCallbacks();
@@ -792,6 +818,36 @@ TEST_F_EX(TestRedisService, SafeBatchPipeline, TestRedisServiceSafeBatch) {
   LOG(INFO) << yb::Format("Safe set: $0ms, get: $1ms", set_time.count(), get_time.count());
 }
 
+class TestRedisServiceCoalescedPipeline : public TestRedisServiceSafeBatch {
+ public:
+  void SetUp() override {
+    FLAGS_redis_coalesce_pipelined_commands = true;
+    TestRedisServiceSafeBatch::SetUp();
+  }
+};
+
+TEST_F_EX(TestRedisService, CoalescedPipeline, TestRedisServiceCoalescedPipeline) {
+  auto start = std::chrono::steady_clock::now();
+  SendCommandAndExpectResponse(__LINE__, PipelineSetCommand(), PipelineSetResponse());
+  auto mid = std::chrono::steady_clock::now();
+  SendCommandAndExpectResponse(__LINE__, PipelineGetCommand(), PipelineGetResponse());
+  auto end = std::chrono::steady_clock::now();
+  auto set_time = std::chrono::duration_cast<std::chrono::milliseconds>(mid - start);
+  auto get_time = std::chrono::duration_cast<std::chrono::milliseconds>(end - mid);
+  LOG(INFO) << yb::Format("Coalesced set: $0ms, get: $1ms", set_time.count(), get_time.count());
+}
+
+TEST_F_EX(TestRedisService, CoalescedPipelinePartial, TestRedisServiceCoalescedPipeline) {
+  SendCommandAndExpectResponse(__LINE__,
+                               PipelineSetCommand(),
+                               PipelineSetResponse(),
+                               true /* partial */);
+  SendCommandAndExpectResponse(__LINE__,
+                               PipelineGetCommand(),
+                               PipelineGetResponse(),
+                               true /* partial */);
+}
+
 TEST_F(TestRedisService, BatchedCommandMulti) {
   SendCommandAndExpectResponse(
       __LINE__,
@@ -1261,6 +1317,62 @@ TEST_F(TestRedisService, TestSortedSets) {
   VerifyCallbacks();
 }
 
+TEST_F(TestRedisService, TestSortedSetRanks) {
+  DoRedisTestExpectError(__LINE__, {"ZRANGE", "z_key", "0"});
+  DoRedisTestExpectError(__LINE__, {"ZRANGE", "z_key", "a", "1"});
+  DoRedisTestExpectError(__LINE__, {"ZREVRANGE", "z_key", "0", "1", "WITHSCORES", "abc"});
+  DoRedisTestExpectError(__LINE__, {"ZRANK", "z_key"});
+
+  DoRedisTestInt(__LINE__, {"ZADD", "z_key", "1", "v1", "2", "v2", "3", "v3", "4", "v4", "5", "v5",
+      "6", "v6"}, 6);
+  SyncClient();
+  // Changes the score of v1 and removes v4, which leaves overwritten and deleted entries behind.
+  DoRedisTestInt(__LINE__, {"ZADD", "z_key", "2.5", "v1"}, 0);
+  SyncClient();
+  DoRedisTestInt(__LINE__, {"ZREM", "z_key", "v4"}, 1);
+  SyncClient();
+
+  DoRedisTestArray(__LINE__, {"ZRANGE", "z_key", "0", "-1"}, {"v2", "v1", "v3", "v5", "v6"});
+  DoRedisTestArray(__LINE__, {"ZRANGE", "z_key", "1", "2"}, {"v1", "v3"});
+  DoRedisTestArray(__LINE__, {"ZRANGE", "z_key", "-2", "100"}, {"v5", "v6"});
+  DoRedisTestArray(__LINE__, {"ZRANGE", "z_key", "3", "1"}, {});
+  DoRedisTestArray(__LINE__, {"ZRANGE", "z_key", "5", "10"}, {});
+  DoRedisTestArray(__LINE__, {"ZREVRANGE", "z_key", "0", "-1"}, {"v6", "v5", "v3", "v1", "v2"});
+  DoRedisTestArray(__LINE__, {"ZREVRANGE", "z_key", "0", "1"}, {"v6", "v5"});
+  DoRedisTestArray(__LINE__, {"ZREVRANGE", "z_key", "-100", "-4"}, {"v6", "v5"});
+  DoRedisTestArray(__LINE__, {"ZREVRANGE", "z_key", "3", "4"}, {"v1", "v2"});
+  DoRedisTestScoreValueArray(__LINE__, {"ZRANGE", "z_key", "0", "1", "WITHSCORES"},
+                             {2.0, 2.5}, {"v2", "v1"});
+  DoRedisTestScoreValueArray(__LINE__, {"ZREVRANGE", "z_key", "0", "1", "withscores"},
+                             {6.0, 5.0}, {"v6", "v5"});
+
+  DoRedisTestInt(__LINE__, {"ZRANK", "z_key", "v2"}, 0);
+  DoRedisTestInt(__LINE__, {"ZRANK", "z_key", "v1"}, 1);
+  DoRedisTestInt(__LINE__, {"ZRANK", "z_key", "v3"}, 2);
+  DoRedisTestInt(__LINE__, {"ZRANK", "z_key", "v5"}, 3);
+  DoRedisTestInt(__LINE__, {"ZRANK", "z_key", "v6"}, 4);
+  DoRedisTestNull(__LINE__, {"ZRANK", "z_key", "v4"});
+  DoRedisTestNull(__LINE__, {"ZRANK", "z_none", "v1"});
+  DoRedisTestArray(__LINE__, {"ZRANGE", "z_none", "0", "-1"}, {});
+
+  // The members of a deleted sorted set are not visible once it is recreated.
+  DoRedisTestInt(__LINE__, {"DEL", "z_key"}, 1);
+  SyncClient();
+  DoRedisTestInt(__LINE__, {"ZADD", "z_key", "10", "v10"}, 1);
+  SyncClient();
+  DoRedisTestArray(__LINE__, {"ZRANGE", "z_key", "0", "-1"}, {"v10"});
+  DoRedisTestArray(__LINE__, {"ZREVRANGE", "z_key", "0", "-1"}, {"v10"});
+  DoRedisTestInt(__LINE__, {"ZRANK", "z_key", "v10"}, 0);
+
+  DoRedisTestOk(__LINE__, {"SET", "s_key", "v"});
+  SyncClient();
+  DoRedisTestExpectError(__LINE__, {"ZRANGE", "s_key", "0", "-1"});
+  DoRedisTestExpectError(__LINE__, {"ZRANK", "s_key", "v"});
+
+  SyncClient();
+  VerifyCallbacks();
+}
+
 TEST_F(TestRedisService, TestTimeSeriesTTL) {
   int64_t ttl_sec = 5;
   TestTSTtl("EXPIRE_IN", ttl_sec, ttl_sec, "test_expire_in");
@@ -1447,6 +1559,52 @@ TEST_F(TestRedisService, TestTimeSeriesTTL) {
   VerifyCallbacks();
 }
 
+TEST_F(TestRedisService, TestTsRangeByTimeAggregation) {
+  DoRedisTestOk(__LINE__, {"TSADD", "ts_agg",
+      "-12", "4",
+      "-7", "2",
+      "1", "1.5",
+      "3", "-1",
+      "9", "8",
+      "10", "5",
+      "12", "7",
+  });
+  SyncClient();
+
+  // Buckets are aligned to multiples of the bucket size, negative timestamps included.
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_agg", "-inf", "+inf", "AGGREGATION", "COUNT",
+      "5"}, {"-15", "1", "-10", "1", "0", "2", "5", "1", "10", "2"});
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_agg", "-inf", "+inf", "AGGREGATION", "min",
+      "10"}, {"-20", "4", "-10", "2", "0", "-1", "10", "5"});
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_agg", "-inf", "+inf", "AGGREGATION", "MAX",
+      "10"}, {"-20", "4", "-10", "2", "0", "8", "10", "7"});
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_agg", "0", "(12", "AGGREGATION", "SUM",
+      "100"}, {"0", "13.5"});
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_agg", "-10", "3", "AGGREGATION", "AVG",
+      "5"}, {"-10", "2", "0", "0.25"});
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_agg", "20", "30", "AGGREGATION", "COUNT",
+      "10"}, {});
+
+  DoRedisTestExpectError(__LINE__, {"TSRANGEBYTIME", "ts_agg", "0", "10", "AGGREGATION", "COUNT"});
+  DoRedisTestExpectError(__LINE__, {"TSRANGEBYTIME", "ts_agg", "0", "10", "AGGREGATION", "MEDIAN",
+      "10"});
+  DoRedisTestExpectError(__LINE__, {"TSRANGEBYTIME", "ts_agg", "0", "10", "AGGREGATION", "COUNT",
+      "0"});
+  DoRedisTestExpectError(__LINE__, {"TSRANGEBYTIME", "ts_agg", "0", "10", "BUCKETS", "COUNT",
+      "10"});
+
+  // Only COUNT accepts values that are not numbers.
+  DoRedisTestOk(__LINE__, {"TSADD", "ts_agg", "11", "abc"});
+  SyncClient();
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_agg", "10", "12", "AGGREGATION", "COUNT",
+      "10"}, {"10", "3"});
+  DoRedisTestExpectError(__LINE__, {"TSRANGEBYTIME", "ts_agg", "10", "12", "AGGREGATION", "SUM",
+      "10"});
+
+  SyncClient();
+  VerifyCallbacks();
+}
+
 TEST_F(TestRedisService, TestTsRem) {
 
   // Try some deletes before inserting any data.
@@ -1575,6 +1733,9 @@ TEST_F(TestRedisService, TestAdditionalCommands) {
 
   DoRedisTestArray(__LINE__, {"HMGET", "map_key", "subkey1", "subkey3", "subkey2"},
       {"41", "", "12"});
+  // Repeated and unordered fields are returned in the requested order.
+  DoRedisTestArray(__LINE__, {"HMGET", "map_key", "subkey2", "subkey1", "subkey2"},
+      {"12", "41", "12"});
 
   DoRedisTestArray(__LINE__, {"HGETALL", "map_key"}, {"subkey1", "41", "subkey2", "12"});
 
@@ -1735,6 +1896,26 @@ TEST_F(TestRedisService, TestAdditionalCommands) {
   VerifyCallbacks();
 }
 
+TEST_F(TestRedisService, TestMGetMSet) {
+  DoRedisTestOk(__LINE__, {"MSET", "key1", "value1", "key2", "value2", "key3", "value3"});
+  DoRedisTestOk(__LINE__, {"HSET", "map_key", "subkey", "value"});
+  SyncClient();
+
+  DoRedisTestArray(__LINE__, {"MGET", "key1", "non_existent", "key3", "map_key", "key2"},
+      {"value1", "", "value3", "", "value2"});
+  DoRedisTestBulkString(__LINE__, {"GET", "key2"}, "value2");
+
+  DoRedisTestOk(__LINE__, {"MSET", "key1", "new_value1", "key4", "value4"});
+  SyncClient();
+
+  DoRedisTestArray(__LINE__, {"MGET", "key1", "key4"}, {"new_value1", "value4"});
+
+  DoRedisTestExpectError(__LINE__, {"MSET", "key1", "value1", "key2"});
+  DoRedisTestExpectError(__LINE__, {"MGET", "key1", ""});
+  SyncClient();
+  VerifyCallbacks();
+}
+
 TEST_F(TestRedisService, TestDel) {
   // The default value is true, but we explicitly set this here for clarity.
   FLAGS_emulate_redis_responses = true;
@@ -1820,6 +2001,55 @@ TEST_F(TestRedisService, TestQuit) {
   DoRedisTestExpectError(__LINE__, {"SET", "key", "value"});
 }
 
+TEST_F(TestRedisService, TestScan) {
+  constexpr int kNumKeys = 100;
+  std::multiset<std::string> expected;
+  std::multiset<std::string> expected_matching;
+  for (int i = 0; i != kNumKeys; ++i) {
+    const std::string key = Substitute("k$0", i);
+    if (i % 10 == 3) {
+      DoRedisTestInt(__LINE__, {"HSET", key, "subkey", "value"}, 1);
+    } else {
+      DoRedisTestOk(__LINE__, {"SET", key, "value"});
+    }
+    // Deleted keys are not returned.
+    if (i % 10 != 7) {
+      expected.insert(key);
+      if (key.size() == 3 && key[1] == '1') {
+        expected_matching.insert(key);
+      }
+    }
+  }
+  SyncClient();
+  for (int i = 7; i < kNumKeys; i += 10) {
+    DoRedisTestInt(__LINE__, {"DEL", Substitute("k$0", i)}, 1);
+  }
+  SyncClient();
+
+  // Each key is returned exactly once, whether the tablets are scanned one by one in small
+  // batches or in parallel.
+  FLAGS_redis_scan_batch_size = 3;
+  for (const auto& count : {"1", "7", "1000"}) {
+    std::multiset<std::string> keys;
+    ScanAll(__LINE__, {"COUNT", count}, &keys);
+    ASSERT_EQ(expected, keys) << "COUNT " << count;
+  }
+
+  std::multiset<std::string> keys;
+  ScanAll(__LINE__, {"MATCH", "k1?", "COUNT", "5"}, &keys);
+  ASSERT_EQ(expected_matching, keys);
+
+  keys.clear();
+  ScanAll(__LINE__, {}, &keys);
+  ASSERT_EQ(expected, keys);
+
+  DoRedisTestExpectError(__LINE__, {"SCAN", "12"});
+  DoRedisTestExpectError(__LINE__, {"SCAN", "0", "COUNT", "0"});
+  DoRedisTestExpectError(__LINE__, {"SCAN", "0", "MATCH"});
+  SyncClient();
+  VerifyCallbacks();
+}
+
 TEST_F(TestRedisService, TestFlushAll) {
   TestFlush("FLUSHALL");
 }